@@ -102,6 +102,14 @@ let package = Package(
                  */
                 .define("OPENSSL_NO_THREADS_CORRUPT_MEMORY_AND_LEAK_SECRETS_IF_THREADED", .when(platforms: [Platform.wasi])),
                 .define("OPENSSL_NO_ASM", .when(platforms: [Platform.wasi])),
+                /*
+                 * BoringSSL looks for its allocator hooks under the unprefixed OPENSSL_memory_*
+                 * names, which every other copy of BoringSSL in the process looks for too. Give
+                 * ours the CCryptoBoringSSL prefix so that the shims' hooks only apply here.
+                 */
+                .define("OPENSSL_memory_alloc", to: "CCryptoBoringSSL_OPENSSL_memory_alloc"),
+                .define("OPENSSL_memory_free", to: "CCryptoBoringSSL_OPENSSL_memory_free"),
+                .define("OPENSSL_memory_get_size", to: "CCryptoBoringSSL_OPENSSL_memory_get_size"),
             ]
         ),
         .target(
@@ -158,7 +166,9 @@ let package = Package(
                 .copy("PrivacyInfo.xcprivacy"),
             ]
         ),
-        .executableTarget(name: "crypto-shasum", dependencies: ["Crypto"]),
+        .executableTarget(name: "crypto-shasum", dependencies: ["Crypto", "_CryptoExtras"]),
+        .target(name: "CCryptoBenchmarkAllocations"),
+        .executableTarget(name: "crypto-benchmarks", dependencies: ["Crypto", "_CryptoExtras", "CCryptoBoringSSL", "CCryptoBoringSSLShims", "CCryptoBenchmarkAllocations"]),
         .testTarget(
             name: "CryptoTests",
             dependencies: ["Crypto"],
@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#include <CCryptoBenchmarkAllocations.h>
+
+#if defined(__linux__) && defined(__GLIBC__)
+#include <errno.h>
+#include <stddef.h>
+
+// glibc exports its allocator under these names as well, so the wrappers can
+// forward to it without looking it up with dlsym, which itself allocates.
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void *__libc_memalign(size_t alignment, size_t size);
+extern void __libc_free(void *ptr);
+
+static uint64_t CCryptoBenchmarkAllocations_allocations = 0;
+
+static void CCryptoBenchmarkAllocations_count_one(void) {
+    __atomic_fetch_add(&CCryptoBenchmarkAllocations_allocations, 1, __ATOMIC_RELAXED);
+}
+
+void *malloc(size_t size) {
+    CCryptoBenchmarkAllocations_count_one();
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+    CCryptoBenchmarkAllocations_count_one();
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    CCryptoBenchmarkAllocations_count_one();
+    return __libc_realloc(ptr, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size) {
+    CCryptoBenchmarkAllocations_count_one();
+    return __libc_memalign(alignment, size);
+}
+
+void *memalign(size_t alignment, size_t size) {
+    CCryptoBenchmarkAllocations_count_one();
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **out, size_t alignment, size_t size) {
+    if (alignment < sizeof(void *) || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    CCryptoBenchmarkAllocations_count_one();
+    void *ptr = __libc_memalign(alignment, size);
+    if (ptr == NULL) {
+        return ENOMEM;
+    }
+    *out = ptr;
+    return 0;
+}
+
+void free(void *ptr) {
+    __libc_free(ptr);
+}
+
+int CCryptoBenchmarkAllocations_enabled(void) {
+    return 1;
+}
+
+uint64_t CCryptoBenchmarkAllocations_count(void) {
+    return __atomic_load_n(&CCryptoBenchmarkAllocations_allocations, __ATOMIC_RELAXED);
+}
+
+#else
+
+int CCryptoBenchmarkAllocations_enabled(void) {
+    return 0;
+}
+
+uint64_t CCryptoBenchmarkAllocations_count(void) {
+    return 0;
+}
+
+#endif
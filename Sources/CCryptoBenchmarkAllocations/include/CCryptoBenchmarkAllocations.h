@@ -0,0 +1,38 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#ifndef C_CRYPTO_BENCHMARK_ALLOCATIONS_H
+#define C_CRYPTO_BENCHMARK_ALLOCATIONS_H
+
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+// On Linux with glibc, linking this into an executable replaces malloc and its
+// relatives with wrappers that count every heap allocation in the process,
+// whether it's made by Swift, Foundation or BoringSSL. Elsewhere nothing is
+// counted.
+
+// Returns 1 if allocations are counted, and 0 otherwise.
+int CCryptoBenchmarkAllocations_enabled(void);
+
+// The number of allocations made so far. Reallocations count as one allocation.
+uint64_t CCryptoBenchmarkAllocations_count(void);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif  // C_CRYPTO_BENCHMARK_ALLOCATIONS_H
@@ -68,6 +68,85 @@ int CCryptoBoringSSLShims_EVP_AEAD_CTX_open(const EVP_AEAD_CTX *ctx, void *out,
                                             const void *in, size_t in_len,
                                             const void *ad, size_t ad_len);
 
+void CCryptoBoringSSLShims_EVP_DigestUpdate(EVP_MD_CTX *ctx, const void *data, size_t len);
+
+// Counts a digest update of |len| bytes made directly through one of the
+// low-level MD5/SHA*_Update functions, as CCryptoBoringSSLShims_EVP_DigestUpdate
+// counts its own. Without instrumentation it is an empty inline function, so
+// the digests' update path makes no call across the module boundary.
+#if defined(CRYPTO_BORINGSSL_INSTRUMENTATION)
+void CCryptoBoringSSLShims_count_digest_update(size_t len);
+#else
+static inline void CCryptoBoringSSLShims_count_digest_update(size_t len) {
+    (void)len;
+}
+#endif
+
+// MARK:- Batch shims
+// These shims run a series of AEAD operations against a single EVP_AEAD_CTX
+// without returning to Swift between them. Each operation is described by a
+// CCryptoBoringSSLShims_AEAD_batch_op, and the outcome of each is written to its
+// `result` field. Every operation in the batch is attempted, even if an earlier
+// one fails.
+typedef struct {
+    const void *nonce;
+    size_t nonce_len;
+    const void *in;
+    size_t in_len;
+    const void *ad;
+    size_t ad_len;
+    // For sealing, `out` receives `in_len` bytes of ciphertext and `tag` receives
+    // up to `tag_len` bytes of tag, with `tag_len` updated to the written length.
+    // For opening, `out` receives `in_len` bytes of plaintext and `tag` holds the
+    // `tag_len` byte tag to check.
+    void *out;
+    void *tag;
+    size_t tag_len;
+    int result;
+} CCryptoBoringSSLShims_AEAD_batch_op;
+
+// Returns the number of operations in the batch that failed.
+size_t CCryptoBoringSSLShims_EVP_AEAD_CTX_seal_batch(const EVP_AEAD_CTX *ctx,
+                                                     CCryptoBoringSSLShims_AEAD_batch_op *ops,
+                                                     size_t ops_count);
+
+// Returns the number of operations in the batch that failed.
+size_t CCryptoBoringSSLShims_EVP_AEAD_CTX_open_batch(const EVP_AEAD_CTX *ctx,
+                                                     CCryptoBoringSSLShims_AEAD_batch_op *ops,
+                                                     size_t ops_count);
+
+// A single message in a batch of one-shot hash operations. `out` must have room
+// for the digest of the hash function in use.
+typedef struct {
+    const void *in;
+    size_t in_len;
+    void *out;
+} CCryptoBoringSSLShims_hash_batch_op;
+
+void CCryptoBoringSSLShims_SHA256_batch(const CCryptoBoringSSLShims_hash_batch_op *ops,
+                                        size_t ops_count);
+
+// A single message in a batch of HMAC operations. `out` must have room for the
+// digest of the hash function in use.
+typedef struct {
+    const void *key;
+    size_t key_len;
+    const void *in;
+    size_t in_len;
+    void *out;
+} CCryptoBoringSSLShims_HMAC_batch_op;
+
+// Computes HMAC-SHA256 for every operation in the batch. The pad states are
+// only recomputed when an operation's key differs from the previous one, so
+// runs of messages under the same key cost no more than hashing the messages.
+// Returns 1 on success and 0 on failure.
+int CCryptoBoringSSLShims_HMAC_SHA256_batch(const CCryptoBoringSSLShims_HMAC_batch_op *ops,
+                                            size_t ops_count);
+
+int CCryptoBoringSSLShims_HKDF(void *out_key, size_t out_len, const EVP_MD *digest,
+                               const void *secret, size_t secret_len,
+                               const void *salt, size_t salt_len,
+                               const void *info, size_t info_len);
 
 void CCryptoBoringSSLShims_ED25519_keypair(void *out_public_key, void *out_private_key);
 
@@ -81,6 +160,25 @@ ECDSA_SIG *CCryptoBoringSSLShims_ECDSA_do_sign(const void *digest, size_t digest
 int CCryptoBoringSSLShims_ECDSA_do_verify(const void *digest, size_t digest_len,
                                           const ECDSA_SIG *sig, const EC_KEY *eckey);
 
+// A single signature in a batch of ECDSA verifications against one key. The
+// signature is in raw form: the big-endian r followed by the big-endian s, each
+// padded to `signature_len / 2` bytes.
+typedef struct {
+    const void *digest;
+    size_t digest_len;
+    const void *signature;
+    size_t signature_len;
+} CCryptoBoringSSLShims_ECDSA_verify_batch_op;
+
+// Verifies each operation against `eckey`, writing 1 to `results[i]` if
+// operation `i` is valid and 0 otherwise. Signatures are raw (IEEE P1363), as
+// for `CCryptoBoringSSLShims_ECDSA_verify_raw`, and the s values of up to 32 at
+// a time share one inversion. Returns the number of valid signatures.
+// Verification failures never touch the error queue.
+size_t CCryptoBoringSSLShims_ECDSA_verify_batch(const EC_KEY *eckey,
+                                                const CCryptoBoringSSLShims_ECDSA_verify_batch_op *ops,
+                                                size_t ops_count, int *results);
+
 void CCryptoBoringSSLShims_X25519_keypair(void *out_public_value, void *out_private_key);
 
 void CCryptoBoringSSLShims_X25519_public_from_private(void *out_public_value,
@@ -89,6 +187,14 @@ void CCryptoBoringSSLShims_X25519_public_from_private(void *out_public_value,
 int CCryptoBoringSSLShims_X25519(void *out_shared_key, const void *private_key,
                                  const void *peer_public_value);
 
+// Computes X25519 between one private key and each of `peers_count` 32-byte peer
+// public values stored contiguously in `peer_public_values`. The shared keys are
+// written contiguously to `out_shared_keys`, which must have room for
+// `32 * peers_count` bytes. A peer of small order yields the all-zero key, as
+// with the single-shot call.
+void CCryptoBoringSSLShims_X25519_batch(void *out_shared_keys, const void *private_key,
+                                        const void *peer_public_values, size_t peers_count);
+
 ECDSA_SIG *CCryptoBoringSSLShims_ECDSA_SIG_from_bytes(const void *in, size_t in_len);
 
 int CCryptoBoringSSLShims_ED25519_verify(const void *message, size_t message_len,
@@ -97,6 +203,20 @@ int CCryptoBoringSSLShims_ED25519_verify(const void *message, size_t message_len
 int CCryptoBoringSSLShims_ED25519_sign(void *out_sig, const void *message,
                                        size_t message_len, const void *private_key);
 
+// A single signature in a batch of Ed25519 verifications. `signature` must point
+// to 64 bytes and `public_key` to 32 bytes.
+typedef struct {
+    const void *message;
+    size_t message_len;
+    const void *signature;
+    const void *public_key;
+} CCryptoBoringSSLShims_ED25519_verify_batch_op;
+
+// Verifies each operation in turn, writing 1 to `results[i]` if operation `i` is
+// valid and 0 otherwise. Returns the number of valid signatures.
+size_t CCryptoBoringSSLShims_ED25519_verify_batch(const CCryptoBoringSSLShims_ED25519_verify_batch_op *ops,
+                                                  size_t ops_count, int *results);
+
 BIGNUM *CCryptoBoringSSLShims_BN_bin2bn(const void *in, size_t len, BIGNUM *ret);
 
 size_t CCryptoBoringSSLShims_BN_bn2bin(const BIGNUM *in, void *out);
@@ -132,6 +252,1801 @@ int CCryptoBoringSSLShims_EVP_PKEY_decrypt(EVP_PKEY_CTX *ctx, void *out,
                                            size_t *out_len, const void *in,
                                            size_t in_len);
 
+// MARK:- Buffered random bytes
+// Small requests for random bytes can optionally be served from a per-thread
+// buffer that is refilled from RAND_bytes 4 KiB at a time. This amortises the
+// DRBG setup across many nonces and keys. Buffering is off by default. It is
+// only used where BoringSSL can detect forks, and the buffer is discarded
+// whenever the fork generation changes.
+
+// Enables or disables buffering for all threads.
+void CCryptoBoringSSLShims_RAND_set_buffering_enabled(int enabled);
+
+// Returns 1 if buffering has been enabled, and 0 otherwise.
+int CCryptoBoringSSLShims_RAND_buffering_enabled(void);
+
+// Fills `out` with `len` random bytes, using the per-thread buffer if
+// buffering is enabled and the request is small enough.
+void CCryptoBoringSSLShims_RAND_bytes(void *out, size_t len);
+
+// MARK:- Implementation reporting
+// These report which code path BoringSSL's CPU dispatch selects on the running
+// machine, as a short static string such as "sha-ni", "armv8-sha512", "avx",
+// "neon" or "c". They mirror the dispatch in crypto/fipsmodule and must be kept
+// in sync with it when BoringSSL is updated.
+
+const char *CCryptoBoringSSLShims_SHA256_implementation(void);
+
+const char *CCryptoBoringSSLShims_SHA512_implementation(void);
+
+const char *CCryptoBoringSSLShims_AES_implementation(void);
+
+// Returns "nistz256" when P-256 uses the assembly implementation and its
+// 150 KB fixed-base table, or "fiat" when it uses the portable one with a
+// 2 KB table, as it does when BoringSSL is built with OPENSSL_SMALL. Unlike the
+// others, this reads the choice BoringSSL made rather than mirroring it.
+const char *CCryptoBoringSSLShims_P256_implementation(void);
+
+// "avx" or "clmul" for the carry-less multiply kernels, "armv8-pmull",
+// "ssse3", "neon", or "c".
+const char *CCryptoBoringSSLShims_GHASH_implementation(void);
+
+// The kernel used for messages longer than 192 bytes: "avx2", "ssse3-4x",
+// "neon", or "c". Shorter messages may use a narrower one.
+const char *CCryptoBoringSSLShims_ChaCha20_implementation(void);
+
+// "sse4.1" or "neon" for the stitched ChaCha20-Poly1305 assembly, or "c" when
+// ChaCha20 and Poly1305 run separately.
+const char *CCryptoBoringSSLShims_ChaCha20Poly1305_implementation(void);
+
+// "adx" for the BMI2 and ADX field arithmetic, "neon", or "fiat".
+const char *CCryptoBoringSSLShims_X25519_implementation(void);
+
+// MARK:- CPU capabilities
+// The instruction set extensions BoringSSL's dispatch looks at, as a bit set.
+// Bits that don't belong to the running architecture are never set. The values
+// are part of the Swift API and must not be renumbered.
+
+#define CCryptoBoringSSLShims_CPU_SSSE3 (1ull << 0)
+#define CCryptoBoringSSLShims_CPU_SSE4_1 (1ull << 1)
+#define CCryptoBoringSSLShims_CPU_PCLMUL (1ull << 2)
+#define CCryptoBoringSSLShims_CPU_MOVBE (1ull << 3)
+#define CCryptoBoringSSLShims_CPU_AESNI (1ull << 4)
+#define CCryptoBoringSSLShims_CPU_AVX (1ull << 5)
+#define CCryptoBoringSSLShims_CPU_AVX2 (1ull << 6)
+#define CCryptoBoringSSLShims_CPU_BMI1 (1ull << 7)
+#define CCryptoBoringSSLShims_CPU_BMI2 (1ull << 8)
+#define CCryptoBoringSSLShims_CPU_ADX (1ull << 9)
+#define CCryptoBoringSSLShims_CPU_SHA (1ull << 10)
+#define CCryptoBoringSSLShims_CPU_AVX512F (1ull << 11)
+#define CCryptoBoringSSLShims_CPU_AVX512IFMA (1ull << 12)
+#define CCryptoBoringSSLShims_CPU_NEON (1ull << 32)
+#define CCryptoBoringSSLShims_CPU_ARMV8_AES (1ull << 33)
+#define CCryptoBoringSSLShims_CPU_ARMV8_PMULL (1ull << 34)
+#define CCryptoBoringSSLShims_CPU_ARMV8_SHA1 (1ull << 35)
+#define CCryptoBoringSSLShims_CPU_ARMV8_SHA256 (1ull << 36)
+#define CCryptoBoringSSLShims_CPU_ARMV8_SHA512 (1ull << 37)
+
+// Returns the capabilities BoringSSL will use, initializing the library if
+// needed. Capabilities the compiler was told to assume, for example with
+// -mavx2 or on Apple silicon, are always included.
+uint64_t CCryptoBoringSSLShims_cpu_capabilities(void);
+
+// Stops BoringSSL from using the capabilities in |disabled|, and returns the
+// capabilities it will use from now on. Capabilities the compiler was told to
+// assume cannot be disabled and remain in the result.
+//
+// This must be called before any other use of the library, and before any other
+// thread might use it: keys and contexts already set up keep the kernels they
+// chose, and the capability words are not written atomically.
+uint64_t CCryptoBoringSSLShims_cpu_restrict_capabilities(uint64_t disabled);
+
+// Writes the CPU's model name, NUL-terminated and truncated to fit, or an empty
+// string if it isn't known.
+void CCryptoBoringSSLShims_cpu_model(char *out, size_t out_len);
+
+// MARK:- Kernel autotuning
+
+#define CCryptoBoringSSLShims_AUTOTUNE_PRIMITIVES 4
+
+typedef struct {
+    // "aes-gcm", "chacha20-poly1305", "sha256" or "montgomery".
+    const char *primitive;
+    // The capabilities whose removal made this primitive fastest, or zero.
+    uint64_t removed;
+    // The time per operation with every capability, and with |removed| removed.
+    uint64_t default_ns;
+    uint64_t tuned_ns;
+} CCryptoBoringSSLShims_autotune_result;
+
+// Times the kernels BoringSSL could use for each primitive, by removing
+// capabilities one candidate at a time, and sets |*out_removed| to the
+// capabilities to remove with CCryptoBoringSSLShims_cpu_restrict_capabilities.
+// The detected capabilities are left as they were. Returns the number of
+// results written, which is zero where there is nothing to tune (currently
+// everywhere but x86-64).
+//
+// Takes a few tens of milliseconds. The same rules as restricting apply: call it
+// before any other use of the library and before other threads start using it.
+size_t CCryptoBoringSSLShims_cpu_autotune(CCryptoBoringSSLShims_autotune_result results[CCryptoBoringSSLShims_AUTOTUNE_PRIMITIVES],
+                                          uint64_t *out_removed);
+
+// MARK:- Keccak
+// SHA-3 and SHAKE over BoringSSL's internal Keccak implementation in
+// crypto/keccak. BoringSSL only supports incremental hashing for the SHAKE
+// functions, so these shims also set up incremental SHA-3.
+typedef enum {
+    CCryptoBoringSSLShims_keccak_sha3_256 = 0,
+    CCryptoBoringSSLShims_keccak_sha3_512,
+    CCryptoBoringSSLShims_keccak_shake128,
+    CCryptoBoringSSLShims_keccak_shake256,
+} CCryptoBoringSSLShims_keccak_function;
+
+// Storage for a struct BORINGSSL_keccak_st, which is declared in a header that
+// is not public. It holds no pointers and may be copied freely.
+typedef struct {
+    uint64_t opaque[30];
+} CCryptoBoringSSLShims_keccak_ctx;
+
+void CCryptoBoringSSLShims_keccak_init(CCryptoBoringSSLShims_keccak_ctx *ctx,
+                                       CCryptoBoringSSLShims_keccak_function function);
+
+// Must not be called after CCryptoBoringSSLShims_keccak_squeeze.
+void CCryptoBoringSSLShims_keccak_absorb(CCryptoBoringSSLShims_keccak_ctx *ctx,
+                                         const void *in, size_t in_len);
+
+// For the SHA-3 functions, `out_len` must be the digest length and this may
+// only be called once.
+void CCryptoBoringSSLShims_keccak_squeeze(CCryptoBoringSSLShims_keccak_ctx *ctx,
+                                          void *out, size_t out_len);
+
+// MARK:- Kyber
+// Kyber768 from BoringSSL's experimental API, which is not part of the umbrella
+// header. Keys are held in caller-allocated storage of the sizes returned
+// below, aligned to 16 bytes. A parsed public key keeps its expanded matrix,
+// so encapsulating to it again skips the matrix expansion.
+#define CCryptoBoringSSLShims_KYBER_PUBLIC_KEY_BYTES 1184
+#define CCryptoBoringSSLShims_KYBER_PRIVATE_KEY_BYTES 2400
+#define CCryptoBoringSSLShims_KYBER_CIPHERTEXT_BYTES 1088
+#define CCryptoBoringSSLShims_KYBER_SHARED_SECRET_BYTES 32
+
+size_t CCryptoBoringSSLShims_kyber_public_key_size(void);
+
+size_t CCryptoBoringSSLShims_kyber_private_key_size(void);
+
+// Writes the encoded public key to `out_encoded_public_key`.
+void CCryptoBoringSSLShims_kyber_generate_key(void *out_encoded_public_key, void *out_private_key);
+
+void CCryptoBoringSSLShims_kyber_public_from_private(void *out_public_key, const void *private_key);
+
+// These return one on success and zero if `in` is not a valid encoded key.
+int CCryptoBoringSSLShims_kyber_parse_public_key(void *out_public_key, const void *in, size_t in_len);
+
+int CCryptoBoringSSLShims_kyber_parse_private_key(void *out_private_key, const void *in, size_t in_len);
+
+// These write exactly the encoded key length to `out`, and return one on success.
+int CCryptoBoringSSLShims_kyber_marshal_public_key(void *out, const void *public_key);
+
+int CCryptoBoringSSLShims_kyber_marshal_private_key(void *out, const void *private_key);
+
+void CCryptoBoringSSLShims_kyber_encap(void *out_ciphertext, void *out_shared_secret, const void *public_key);
+
+void CCryptoBoringSSLShims_kyber_decap(void *out_shared_secret, const void *ciphertext, const void *private_key);
+
+// MARK:- SPHINCS+
+// SPHINCS+-SHA2-128s from BoringSSL's experimental API.
+#define CCryptoBoringSSLShims_SPX_PUBLIC_KEY_BYTES 32
+#define CCryptoBoringSSLShims_SPX_SECRET_KEY_BYTES 64
+#define CCryptoBoringSSLShims_SPX_SIGNATURE_BYTES 7856
+
+void CCryptoBoringSSLShims_spx_generate_key(void *out_public_key, void *out_secret_key);
+
+void CCryptoBoringSSLShims_spx_public_from_secret(void *out_public_key, const void *secret_key);
+
+void CCryptoBoringSSLShims_spx_sign(void *out_signature, const void *secret_key,
+                                    const void *msg, size_t msg_len, int randomized);
+
+int CCryptoBoringSSLShims_spx_verify(const void *signature, const void *public_key,
+                                     const void *msg, size_t msg_len);
+
+// A SPHINCS+ signature split into independent steps, so they can be run
+// concurrently. Call `_spx_sign_begin`, then `_spx_sign_task` once for every
+// index below `_spx_sign_task_count()` in any order and on any threads, then
+// `_spx_sign_finish`. The tasks write to disjoint parts of the signature. The
+// result is the same signature `_spx_sign` would produce.
+typedef struct {
+    uint64_t idx_tree;
+    uint32_t idx_leaf;
+    uint8_t fors_digest[21];
+} CCryptoBoringSSLShims_spx_signing_state;
+
+size_t CCryptoBoringSSLShims_spx_sign_task_count(void);
+
+void CCryptoBoringSSLShims_spx_sign_begin(CCryptoBoringSSLShims_spx_signing_state *state,
+                                          void *out_signature, const void *secret_key,
+                                          const void *msg, size_t msg_len, int randomized);
+
+void CCryptoBoringSSLShims_spx_sign_task(const CCryptoBoringSSLShims_spx_signing_state *state,
+                                         void *out_signature, const void *secret_key, size_t task);
+
+void CCryptoBoringSSLShims_spx_sign_finish(const CCryptoBoringSSLShims_spx_signing_state *state,
+                                           void *out_signature, const void *secret_key);
+
+// MARK:- AES
+// Applies the AES block function to each of the `len / 16` blocks of `in`,
+// writing to `out`, with a key schedule from `AES_set_encrypt_key` (`enc` = 1)
+// or `AES_set_decrypt_key` (`enc` = 0). `len` must be a multiple of 16 and
+// `in` may equal `out`. Uses the pipelined hardware ECB kernel where there is
+// one.
+void CCryptoBoringSSLShims_AES_ecb_encrypt_blocks(const void *in, void *out, size_t len,
+                                                  const AES_KEY *key, int enc);
+
+// MARK:- P-256
+#define CCryptoBoringSSLShims_P256_SCALAR_BYTES 32
+#define CCryptoBoringSSLShims_P256_UNCOMPRESSED_POINT_BYTES 65
+
+// Computes the x-coordinate of `private_scalar` times `peer_point`, with the
+// scalar as 32 big-endian bytes and the peer point in 65-byte uncompressed
+// form. The peer point is checked to be on the curve. Everything is done on
+// the stack, without `EC_KEY`, `EC_POINT` or `BIGNUM`. Returns one on success
+// and zero if either input is invalid.
+int CCryptoBoringSSLShims_p256_ecdh(void *out_secret, const void *private_scalar, const void *peer_point);
+
+// MARK:- Multi-buffer P-256 ECDH
+// Computes `count` independent shared secrets, as `CCryptoBoringSSLShims_p256_ecdh`
+// does for each pair of a scalar in `private_scalars` and a point in
+// `peer_points`, both packed back to back. With AVX-512 IFMA, eight pairs are
+// multiplied at once. Returns one if every pair was valid, and otherwise zero
+// with all of `out_secrets` cleared.
+int CCryptoBoringSSLShims_p256_ecdh_batch(void *out_secrets, const void *private_scalars, const void *peer_points,
+                                          size_t count);
+
+// MARK:- Fixed-width ECDSA
+// Signs `digest` with `eckey`, writing the signature in raw (IEEE P1363) form:
+// r || s, each big-endian and as wide as the group order. No `ECDSA_SIG` or
+// `BIGNUM` is allocated. Nonces are generated as `ECDSA_do_sign` generates
+// them. Returns one on success and zero on error.
+int CCryptoBoringSSLShims_ECDSA_sign_raw(void *out_signature, size_t *out_signature_len, size_t max_out,
+                                         const void *digest, size_t digest_len, const EC_KEY *eckey);
+
+// Verifies a raw (IEEE P1363) signature over `digest` against `eckey`, with
+// the same checks as `ECDSA_do_verify`. Returns one if the signature is valid
+// and zero otherwise. Verification failures never touch the error queue.
+int CCryptoBoringSSLShims_ECDSA_verify_raw(const void *digest, size_t digest_len,
+                                           const void *signature, size_t signature_len, const EC_KEY *eckey);
+
+// Returns one if `point`, the raw coordinates x || y each as wide as the
+// field, is on the curve named by `curve_nid`.
+int CCryptoBoringSSLShims_EC_raw_point_is_valid(int curve_nid, const void *point, size_t point_len);
+
+// Verifies a raw signature as `CCryptoBoringSSLShims_ECDSA_verify_raw` does,
+// against a public key given as raw coordinates x || y on the curve named by
+// `curve_nid`. The point is decoded onto the stack, so a key can be kept as
+// its bytes alone, with no `EC_KEY` or `EC_POINT`.
+int CCryptoBoringSSLShims_ECDSA_verify_raw_point(int curve_nid, const void *point, size_t point_len,
+                                                 const void *digest, size_t digest_len,
+                                                 const void *signature, size_t signature_len);
+
+// The message-independent half of an ECDSA signature: r = x(k·G) mod n and
+// k⁻¹, for a fresh random nonce k. A presignature must be used for at most one
+// signature; signing twice with one reveals the private key.
+typedef struct {
+    uint64_t opaque[18];
+} CCryptoBoringSSLShims_ecdsa_presignature;
+
+// Generates a presignature on the curve named by `curve_nid`. The private key
+// is mixed into the nonce generation as a hedge against RNG failure, as
+// `ECDSA_do_sign` does. Returns one on success and zero on error.
+int CCryptoBoringSSLShims_ecdsa_presign(CCryptoBoringSSLShims_ecdsa_presignature *out, int curve_nid,
+                                        const void *private_key, size_t private_key_len);
+
+// Completes a signature over `digest` from a presignature, writing r || s as
+// two big-endian values of the order's width to `out_signature`, which must
+// hold twice that. The presignature is wiped. Returns one on success and zero
+// on error, including the negligible case of s = 0, after which the caller
+// should retry with another presignature.
+int CCryptoBoringSSLShims_ecdsa_sign_presigned(void *out_signature, size_t *out_signature_len, int curve_nid,
+                                               const void *private_key, size_t private_key_len,
+                                               const void *digest, size_t digest_len,
+                                               CCryptoBoringSSLShims_ecdsa_presignature *presignature);
+
+// Returns BoringSSL's fork generation, which changes in a child process after
+// `fork`, or zero where forks can't be detected. Presignatures made under one
+// generation must not be used under another, or the parent and the child would
+// sign with the same nonces.
+uint64_t CCryptoBoringSSLShims_fork_generation(void);
+
+// MARK:- Batch ECDSA signing
+// Signs `count` digests of `digest_len` bytes each, laid out back to back in
+// `digests`, with one private key on P-256, P-384 or P-521. Signatures are
+// written back to back to `out_signatures` in raw r || s form, each twice the
+// width of the order. Every signature has its own independently drawn nonce;
+// the nonce inversions and the affine conversions of k·G are shared across a
+// chunk of signatures. Returns one on success and zero on error.
+int CCryptoBoringSSLShims_ecdsa_sign_batch(void *out_signatures, int curve_nid,
+                                           const void *private_key, size_t private_key_len,
+                                           const void *digests, size_t digest_len, size_t count);
+
+// MARK:- Batch key generation
+#define CCryptoBoringSSLShims_ED25519_SEED_BYTES 32
+
+// Generates `count` P-256 key pairs, writing each private scalar as 32
+// big-endian bytes to `out_private_keys` and each public key as a 65-byte
+// uncompressed point to `out_public_keys`, back to back. All the public points
+// in a chunk share one field inversion when converted to affine coordinates.
+// Returns one on success and zero on failure, in which case the private key
+// buffer is wiped.
+int CCryptoBoringSSLShims_p256_generate_keys(void *out_private_keys, void *out_public_keys, size_t count);
+
+// Generates `count` Ed25519 key pairs, writing each 32-byte seed to
+// `out_seeds` and each 32-byte public key to `out_public_keys`, back to back.
+void CCryptoBoringSSLShims_ED25519_generate_keys(void *out_seeds, void *out_public_keys, size_t count);
+
+// MARK:- Wide Ed25519 base-point table
+// Verification can compute [s]B from a table of the 64 odd multiples B..127B,
+// built on first use, instead of BoringSSL's 8. That takes about a third of the
+// additions for [s]B out of every verification made through these shims, for
+// 7.5 KiB of memory. The signatures accepted are exactly those `ED25519_verify`
+// accepts. It is off by default, and only available on 64-bit targets with
+// 128-bit integers; elsewhere enabling it does nothing.
+
+void CCryptoBoringSSLShims_ED25519_set_wide_base_table_enabled(int enabled);
+
+// Returns 1 if verification uses the wide table, and 0 otherwise.
+int CCryptoBoringSSLShims_ED25519_wide_base_table_enabled(void);
+
+// MARK:- Expanded Ed25519 keys
+#define CCryptoBoringSSLShims_ED25519_EXPANDED_KEY_BYTES 64
+
+// Hashes an Ed25519 seed into the 64-byte expanded form used by
+// `CCryptoBoringSSLShims_ED25519_sign_expanded`: the clamped secret scalar,
+// reduced modulo the group order, followed by the 32-byte nonce prefix.
+void CCryptoBoringSSLShims_ED25519_expand(void *out_expanded_key, const void *seed);
+
+// Produces the same signature as `ED25519_sign`, but from a key expanded with
+// `CCryptoBoringSSLShims_ED25519_expand` and its 32-byte public key, so that
+// the seed isn't hashed again on every call.
+void CCryptoBoringSSLShims_ED25519_sign_expanded(void *out_sig, const void *message, size_t message_len,
+                                                 const void *expanded_key, const void *public_key);
+
+// Signs the 64-byte SHA-512 `prehash` of a message with Ed25519ph (RFC 8032,
+// section 5.1), using a key expanded with `CCryptoBoringSSLShims_ED25519_expand`
+// and its 32-byte public key. `context` may be up to 255 bytes. Returns one on
+// success and zero if `context` is too long.
+int CCryptoBoringSSLShims_ED25519ph_sign(void *out_sig, const void *prehash, const void *context, size_t context_len,
+                                         const void *expanded_key, const void *public_key);
+
+// Checks a 64-byte Ed25519ph `signature` over the 64-byte SHA-512 `prehash` of a
+// message, with the same `context` used to sign. Returns one if the signature
+// is valid and zero otherwise.
+int CCryptoBoringSSLShims_ED25519ph_verify(const void *prehash, const void *context, size_t context_len,
+                                           const void *signature, const void *public_key);
+
+// The state of an Ed25519 signature over a message that arrives in pieces.
+// Signing hashes the message twice: feed it once between `_init` and
+// `_commit`, and again between `_commit` and `_final`. The result is the same
+// as `CCryptoBoringSSLShims_ED25519_sign_expanded` over the concatenation.
+typedef struct {
+    SHA512_CTX hash;
+    uint8_t nonce[64];
+    uint8_t R[32];
+} CCryptoBoringSSLShims_ED25519_SIGN_CTX;
+
+void CCryptoBoringSSLShims_ED25519_sign_init(CCryptoBoringSSLShims_ED25519_SIGN_CTX *ctx, const void *expanded_key);
+void CCryptoBoringSSLShims_ED25519_sign_update(CCryptoBoringSSLShims_ED25519_SIGN_CTX *ctx, const void *data,
+                                               size_t len);
+void CCryptoBoringSSLShims_ED25519_sign_commit(CCryptoBoringSSLShims_ED25519_SIGN_CTX *ctx, const void *public_key);
+// Writes the 64-byte signature and clears `ctx`.
+void CCryptoBoringSSLShims_ED25519_sign_final(CCryptoBoringSSLShims_ED25519_SIGN_CTX *ctx, void *out_sig,
+                                              const void *expanded_key);
+
+// The state of an Ed25519 verification over a message that arrives in pieces.
+// The message is hashed once, between `_init` and `_final`. The final check
+// cannot use the double scalar multiplication inside `ED25519_verify`, which
+// is private to curve25519.c, so it costs about twice as much; it only pays
+// off when the message is large enough that copying it costs more. With the
+// wide base-point table enabled it costs the same as a one-shot verification.
+typedef struct {
+    SHA512_CTX hash;
+    uint8_t sig[64];
+    uint8_t public_key[32];
+    int valid;
+} CCryptoBoringSSLShims_ED25519_VERIFY_CTX;
+
+void CCryptoBoringSSLShims_ED25519_verify_init(CCryptoBoringSSLShims_ED25519_VERIFY_CTX *ctx, const void *signature,
+                                               const void *public_key);
+void CCryptoBoringSSLShims_ED25519_verify_update(CCryptoBoringSSLShims_ED25519_VERIFY_CTX *ctx, const void *data,
+                                                 size_t len);
+// Returns one if the signature is valid for everything passed to `_update`.
+int CCryptoBoringSSLShims_ED25519_verify_final(CCryptoBoringSSLShims_ED25519_VERIFY_CTX *ctx);
+
+// MARK:- Prepared public keys
+// The per-key state that verification builds before its first use, in a form
+// with no pointers, so that it can be computed once, stored in a file, and
+// used in place from memory that file is mapped into.
+//
+// For Ed25519 that is the decoded public key point, as the table of its odd
+// multiples that verification otherwise rebuilds every time. Its layout
+// depends on the field arithmetic in use, which
+// `CCryptoBoringSSLShims_ED25519_prepared_layout` names; a table must only be
+// used with the layout it was written with.
+#define CCryptoBoringSSLShims_ED25519_PREPARED_BYTES 1280
+
+// Returns the layout of prepared Ed25519 keys, or zero if this platform has
+// none.
+uint32_t CCryptoBoringSSLShims_ED25519_prepared_layout(void);
+
+// Writes the prepared form of `public_key` to `out_prepared`, which must have
+// space for `CCryptoBoringSSLShims_ED25519_PREPARED_BYTES`. Returns zero if
+// the key is not a valid point or the platform has no prepared layout.
+int CCryptoBoringSSLShims_ED25519_prepare(void *out_prepared, const void *public_key);
+
+// Returns one if `signature` is valid for `message` under `public_key`, as
+// `ED25519_verify` does, using the prepared form of the same key. Where there
+// is no prepared layout, `prepared` is ignored.
+int CCryptoBoringSSLShims_ED25519_verify_prepared(const void *message, size_t message_len, const void *signature,
+                                                  const void *public_key, const void *prepared);
+
+// For RSA it is R^2 mod n, the Montgomery constant whose computation
+// dominates setting up a public key. R is a power of two that depends on the
+// word size, so it is stored along with its number of bits.
+//
+// Writes R^2 mod n for `rsa`, setting up its Montgomery context if needed, to
+// `out` as `out_len` big-endian bytes, and sets `*out_r_bits`. Returns zero
+// if `out_len` is too small.
+int CCryptoBoringSSLShims_RSA_montgomery_rr(RSA *rsa, uint8_t *out, size_t out_len, uint32_t *out_r_bits);
+
+// Sets up the Montgomery context of `rsa`, a new key not yet used or shared,
+// from a value `CCryptoBoringSSLShims_RSA_montgomery_rr` returned for the same
+// modulus. Returns zero, leaving `rsa` unchanged, if `r_bits` doesn't match
+// this platform or `rr` is out of range.
+int CCryptoBoringSSLShims_RSA_set_montgomery_rr(RSA *rsa, const uint8_t *rr, size_t rr_len, uint32_t r_bits);
+
+// MARK:- Batch Ed25519 signing
+// One signature in a batch: `seed` and `public_key` point to 32 bytes each.
+typedef struct {
+    const void *message;
+    size_t message_len;
+    const void *seed;
+    const void *public_key;
+} CCryptoBoringSSLShims_ED25519_sign_batch_op;
+
+// Writes the 64-byte signature of each operation to `out_signatures`, back to
+// back. Each is the signature `ED25519_sign` produces. On x86-64 with AVX2 or
+// AVX-512, the SHA-512s of different operations run side by side in SIMD
+// lanes, and the nonce commitments of up to 32 operations share one field
+// inversion.
+void CCryptoBoringSSLShims_ED25519_sign_batch(void *out_signatures, const CCryptoBoringSSLShims_ED25519_sign_batch_op *ops,
+                                              size_t ops_count);
+
+// MARK:- Compressed points
+// Sets the public key of `key` from a compressed X9.62 point (0x02 or 0x03
+// followed by x), recovering y with fixed-width field arithmetic rather than
+// `BIGNUM`s. Returns one on success and zero if the encoding is invalid or x is
+// not on the curve.
+int CCryptoBoringSSLShims_EC_KEY_set_public_key_compressed(EC_KEY *key, const void *in, size_t in_len);
+
+// Sets the public key of `key` from its compact representation, which is x
+// alone, taking whichever of y and p - y is smaller as in
+// draft-jivsov-ecc-compact-05. Returns one on success and zero if x is not on
+// the curve.
+int CCryptoBoringSSLShims_EC_KEY_set_public_key_compact(EC_KEY *key, const void *in, size_t in_len);
+
+// Decompresses `count` back-to-back compressed points on the curve `curve_nid`
+// into back-to-back uncompressed points in `out`. Returns the number of points
+// decompressed, stopping at the first invalid one.
+size_t CCryptoBoringSSLShims_EC_points_decompress(int curve_nid, void *out, const void *in, size_t count);
+
+// MARK:- Hash to curve
+// Hashes `msg` to a point on `curve_nid` as RFC 9380 specifies, with the suite
+// P256_XMD:SHA-256_SSWU_RO_ for P-256 or P384_XMD:SHA-384_SSWU_RO_ for P-384,
+// and writes it to `out` as an uncompressed point. `dst` is the domain
+// separation tag, which must not be empty. Returns one on success and zero on
+// error, including for any other curve.
+int CCryptoBoringSSLShims_EC_hash_to_curve(int curve_nid, void *out, const void *dst, size_t dst_len,
+                                           const void *msg, size_t msg_len);
+
+// Like `CCryptoBoringSSLShims_EC_hash_to_curve`, for `count` messages, writing
+// back-to-back uncompressed points to `out`. The points share field
+// inversions. Returns the number of messages hashed, stopping at the first
+// error.
+size_t CCryptoBoringSSLShims_EC_hash_to_curve_batch(int curve_nid, void *out, const void *dst, size_t dst_len,
+                                                    const uint8_t *const *msgs, const size_t *msg_lens,
+                                                    size_t count);
+
+// MARK:- Multi-scalar multiplication
+// Computes the sum of `scalars[i]` times `points[i]` on `curve_nid`, which must
+// be P-256 or P-384, using Pippenger's method in variable time. `scalars` holds
+// `count` back-to-back big-endian scalars, each less than the group order and
+// as wide as it, and `points` holds `count` back-to-back uncompressed points.
+// The windows are spread over up to `max_threads` threads, including the
+// calling one. On success, returns one and either writes the sum to `out` as an
+// uncompressed point, or sets `*out_is_infinity` if it is the point at
+// infinity. Returns zero if any input is invalid or memory runs out.
+int CCryptoBoringSSLShims_EC_multi_scalar_mul(int curve_nid, void *out, int *out_is_infinity, const void *scalars,
+                                              const void *points, size_t count, size_t max_threads);
+
+// MARK:- FFDHE
+#define CCryptoBoringSSLShims_FFDHE2048_BYTES 256
+
+// Generates a key pair in the ffdhe2048 group of RFC 7919, writing the private
+// exponent and the public value as 256 big-endian bytes each. The exponent is
+// drawn as `DH_generate_key` draws it, but the public value comes from a
+// fixed-base table for the generator that is built on first use. Returns one
+// on success and zero on failure.
+int CCryptoBoringSSLShims_FFDHE2048_generate_key(void *out_private_key, void *out_public_key);
+
+// Writes the public value for a 256-byte private exponent, which must be in
+// [1, q - 1]. Returns one on success and zero if the exponent is out of range.
+int CCryptoBoringSSLShims_FFDHE2048_public_key(void *out_public_key, const void *private_key);
+
+// Returns one if `public_key` is a valid 256-byte ffdhe2048 public value, by the
+// checks of `DH_check_pub_key`, and zero otherwise.
+int CCryptoBoringSSLShims_FFDHE2048_check_public_key(const void *public_key, size_t public_key_len);
+
+// Writes the 256-byte shared secret `DH_compute_key_padded` would compute for
+// the private exponent and the peer's public value, reusing the group's
+// Montgomery context. Returns one on success and zero if either input is
+// invalid, in which case `out` is cleared.
+int CCryptoBoringSSLShims_FFDHE2048_compute_key(void *out, const void *private_key, const void *peer_public_key,
+                                                size_t peer_public_key_len);
+
+// MARK:- Parallel RSA CRT
+// Like `CCryptoBoringSSLShims_RSA_sign` and
+// `CCryptoBoringSSLShims_RSA_sign_pss_mgf1`, but the private key operation
+// runs the exponentiations modulo p and modulo q on two threads at once. This
+// roughly halves the latency of a single signature at the cost of a thread per
+// operation, so it only pays off for large keys on otherwise idle cores. The
+// first signature with a key always takes the ordinary path.
+int CCryptoBoringSSLShims_RSA_sign_parallel_crt(int hash_nid, const void *in,
+                                                unsigned int in_len, void *out,
+                                                unsigned int *out_len, RSA *rsa);
+
+int CCryptoBoringSSLShims_RSA_sign_pss_mgf1_parallel_crt(RSA *rsa, size_t *out_len, void *out,
+                                                         size_t max_out, const void *in,
+                                                         size_t in_len, const EVP_MD *md,
+                                                         const EVP_MD *mgf1_md, int salt_len);
+
+// MARK:- MGF1 padding
+// PKCS #1 padding built on an MGF1 that hashes its seed once and continues
+// from a copy of that state for each counter block, and that masks in place
+// rather than through a separate buffer.
+
+// Writes `len` bytes of the MGF1 mask of `seed`, over `md`, to `out`.
+int CCryptoBoringSSLShims_PKCS1_MGF1(void *out, size_t len, const void *seed, size_t seed_len, const EVP_MD *md);
+
+// Like `RSA_padding_add_PKCS1_PSS_mgf1`: writes `RSA_size(rsa)` bytes of
+// EMSA-PSS encoding of `digest` to `out`.
+int CCryptoBoringSSLShims_RSA_padding_add_PKCS1_PSS_mgf1(const RSA *rsa, void *out, const void *digest,
+                                                         const EVP_MD *md, const EVP_MD *mgf1_md,
+                                                         int salt_len);
+
+// RSAES-OAEP with an empty label, using `md` for both the label hash and
+// MGF1. These are equivalent to `EVP_PKEY_encrypt` and `EVP_PKEY_decrypt`
+// with `RSA_PKCS1_OAEP_PADDING` and `EVP_PKEY_CTX_set_rsa_oaep_md`, but need
+// no `EVP_PKEY_CTX` and never hash the label. An invalid padding leaves
+// nothing on the error queue. Both return one on success and zero on failure.
+int CCryptoBoringSSLShims_RSA_encrypt_oaep(RSA *rsa, size_t *out_len, void *out, size_t max_out,
+                                           const void *in, size_t in_len, const EVP_MD *md);
+
+int CCryptoBoringSSLShims_RSA_decrypt_oaep(RSA *rsa, size_t *out_len, void *out, size_t max_out,
+                                           const void *in, size_t in_len, const EVP_MD *md);
+
+// MARK:- Batch RSA verification
+// Verifies `count` RSA signatures against one public key. `signatures` holds
+// the signatures back to back, each exactly `RSA_size(rsa)` bytes, and
+// `digests` the matching digests, each `digest_len` bytes. PSS signatures, with
+// MGF1 and a digest-length salt, are checked when `pss_md` is non-NULL, and
+// PKCS#1 v1.5 signatures using `hash_nid` otherwise. Writes one to
+// `out_valid[i]` for each valid signature and zero for the rest. Invalid
+// signatures never touch the error queue.
+void CCryptoBoringSSLShims_RSA_verify_batch(RSA *rsa, int hash_nid, const EVP_MD *pss_md,
+                                            const void *digests, size_t digest_len,
+                                            const void *signatures, size_t count, uint8_t *out_valid);
+
+// Verifies a single signature as `CCryptoBoringSSLShims_RSA_verify_batch`
+// does. Returns one if it is valid and zero otherwise, without touching the
+// error queue.
+int CCryptoBoringSSLShims_RSA_verify_quiet(RSA *rsa, int hash_nid, const EVP_MD *pss_md,
+                                           const void *digest, size_t digest_len,
+                                           const void *signature, size_t signature_len);
+
+// MARK:- SHA-2 midstate
+// The largest midstate either function below handles: a SHA-512 chaining
+// value, a 128-bit length and a partial block.
+#define CCryptoBoringSSLShims_SHA2_MIDSTATE_MAX_BYTES (64 + 16 + 127)
+
+// Serializes the running state of `ctx`, a `SHA256_CTX` for `NID_sha256` or a
+// `SHA512_CTX` for `NID_sha384` and `NID_sha512`, as the big-endian chaining
+// value, the big-endian message length in bits (64 bits for SHA-256, 128 for
+// the others) and the buffered partial block. Returns the number of bytes
+// written, or zero if `max_out` is too small or `nid` is unsupported.
+size_t CCryptoBoringSSLShims_SHA2_export_midstate(int nid, const void *ctx, void *out, size_t max_out);
+
+// Restores `ctx` from a midstate written by
+// `CCryptoBoringSSLShims_SHA2_export_midstate` for the same `nid`. Returns one
+// on success and zero if the midstate is malformed.
+int CCryptoBoringSSLShims_SHA2_import_midstate(int nid, void *ctx, const void *in, size_t in_len);
+
+// MARK:- SHA-512/224
+// SHA-512/224 (FIPS 180-4, section 6.7), which BoringSSL doesn't provide. It is
+// SHA-512 with its own initial hash value, truncated to 28 bytes, so the
+// context is updated with `SHA512_Update`.
+#define CCryptoBoringSSLShims_SHA512_224_DIGEST_LENGTH 28
+
+void CCryptoBoringSSLShims_SHA512_224_Init(SHA512_CTX *sha);
+
+// Writes the 28-byte digest to `out` and clears `sha`.
+void CCryptoBoringSSLShims_SHA512_224_Final(void *out, SHA512_CTX *sha);
+
+// MARK:- ANSI X9.63 KDF
+// Writes `out_len` bytes of ANSI X9.63 (SEC 1, section 3.6.1) key derivation
+// output over `secret` and `shared_info` to `out`. `secret` is hashed once
+// rather than once per output block. Returns one on success and zero if
+// `out_len` is too large for `digest`. On failure the contents of `out` are
+// unspecified.
+int CCryptoBoringSSLShims_X963_KDF(void *out_key, size_t out_len, const EVP_MD *digest,
+                                   const void *secret, size_t secret_len,
+                                   const void *shared_info, size_t shared_info_len);
+
+// MARK:- BLAKE2b
+// BLAKE2b (RFC 7693) with any digest length from 1 to 64 bytes and an optional
+// key of up to 64 bytes. BoringSSL only has an unkeyed, 32-byte BLAKE2b and no
+// vectorized compression function; this uses AVX2 or NEON where available.
+#define CCryptoBoringSSLShims_BLAKE2B_BLOCK_BYTES 128
+#define CCryptoBoringSSLShims_BLAKE2B_MAX_BYTES 64
+
+// Holds no pointers and may be copied freely.
+typedef struct {
+    uint64_t h[8];
+    uint64_t t[2];
+    uint8_t block[CCryptoBoringSSLShims_BLAKE2B_BLOCK_BYTES];
+    size_t block_used;
+    size_t out_len;
+} CCryptoBoringSSLShims_blake2b_ctx;
+
+// Returns one on success and zero if `out_len` or `key_len` is out of range.
+int CCryptoBoringSSLShims_blake2b_init(CCryptoBoringSSLShims_blake2b_ctx *ctx, size_t out_len,
+                                       const void *key, size_t key_len);
+
+void CCryptoBoringSSLShims_blake2b_update(CCryptoBoringSSLShims_blake2b_ctx *ctx, const void *in, size_t in_len);
+
+// Writes the `out_len` bytes chosen at initialization to `out` and cleanses
+// `ctx`, which must not be used again.
+void CCryptoBoringSSLShims_blake2b_final(CCryptoBoringSSLShims_blake2b_ctx *ctx, void *out);
+
+// MARK:- SipHash batch
+// Computes SipHash-2-4 of `count` short inputs under one key, writing one
+// output per input. The key words are those `SIPHASH_24` takes. With AVX2, the
+// inputs are hashed four at a time in SIMD lanes.
+void CCryptoBoringSSLShims_SIPHASH_24_batch(const uint64_t key[2], const uint8_t *const *inputs,
+                                            const size_t *input_lens, size_t count, uint64_t *out);
+
+// MARK:- PBKDF2
+// PBKDF2-HMAC-SHA256 (RFC 8018) with the HMAC pad states computed once per
+// password, so that each iteration costs two SHA-256 compressions and nothing
+// else. Returns one on success and zero if `iterations` is zero or `key_len` is
+// too long.
+int CCryptoBoringSSLShims_PBKDF2_HMAC_SHA256(const void *password, size_t password_len, const void *salt,
+                                             size_t salt_len, uint32_t iterations, void *out_key, size_t key_len);
+
+// A single password in a batch of PBKDF2 derivations. `out_key` must have room
+// for the batch's `key_len` bytes.
+typedef struct {
+    const void *password;
+    size_t password_len;
+    const void *salt;
+    size_t salt_len;
+    void *out_key;
+} CCryptoBoringSSLShims_PBKDF2_batch_op;
+
+// Derives a key for every operation in the batch with the same iteration count
+// and key length. On x86-64 CPUs with AVX2 but without the SHA extensions, the
+// iterations of eight output blocks run side by side in SIMD lanes. Returns one
+// on success and zero on failure.
+int CCryptoBoringSSLShims_PBKDF2_HMAC_SHA256_batch(const CCryptoBoringSSLShims_PBKDF2_batch_op *ops, size_t ops_count,
+                                                   uint32_t iterations, size_t key_len);
+
+// MARK:- Cancellation
+// A flag that one thread sets to ask a long-running operation on another
+// thread to stop early. Operations that take one check it at intervals and
+// fail as soon as they see it set. It must be zero-initialized.
+typedef struct {
+    uint32_t value;
+} CCryptoBoringSSLShims_CANCEL_FLAG;
+
+void CCryptoBoringSSLShims_CANCEL_FLAG_set(CCryptoBoringSSLShims_CANCEL_FLAG *flag);
+
+// Returns one if `flag` has been set. `flag` may be NULL, which is never set.
+int CCryptoBoringSSLShims_CANCEL_FLAG_is_set(const CCryptoBoringSSLShims_CANCEL_FLAG *flag);
+
+// MARK:- scrypt
+// scrypt (RFC 7914), computing the `p` independent ROMix lanes on up to
+// `max_threads` threads with vectorized Salsa20/8. The lanes' scratch space is
+// allocated as one region holding a separate V array per thread, and
+// `use_huge_pages` asks the kernel to back it with transparent huge pages where
+// that is supported. Every thread needs its own N scrypt blocks, so fewer
+// threads are used if `max_mem` can't accommodate them all; zero means
+// `CCryptoBoringSSLShims_SCRYPT_DEFAULT_MAX_MEM`, the same default as
+// EVP_PBE_scrypt. `cancel`, which may be NULL, is checked every few hundred
+// ROMix iterations. Returns one on success and zero if the parameters are
+// invalid, the memory limit is too small for one thread, allocation fails, or
+// `cancel` was set.
+#define CCryptoBoringSSLShims_SCRYPT_DEFAULT_MAX_MEM (1024 * 1024 * 32)
+#define CCryptoBoringSSLShims_SCRYPT_MAX_THREADS 64
+
+int CCryptoBoringSSLShims_scrypt(const void *password, size_t password_len, const void *salt, size_t salt_len,
+                                 uint64_t N, uint64_t r, uint64_t p, size_t max_mem, size_t max_threads,
+                                 int use_huge_pages, void *out_key, size_t key_len,
+                                 const CCryptoBoringSSLShims_CANCEL_FLAG *cancel);
+
+// MARK:- Batch AES key wrap
+// A single key in a batch of RFC 3394 key wraps or unwraps under one key
+// encryption key, using the default IV. For wrapping, `in` is the `in_len`-byte
+// key and `out` receives `in_len + 8` bytes. For unwrapping, `in` is the
+// `in_len`-byte wrapped key and `out` receives `in_len - 8` bytes. `result` is
+// set to 1 on success and 0 on failure.
+typedef struct {
+    const void *in;
+    size_t in_len;
+    void *out;
+    int result;
+} CCryptoBoringSSLShims_AES_wrap_batch_op;
+
+// Wraps every key in the batch with a key schedule from `AES_set_encrypt_key`.
+// The steps of many wraps are interleaved so that the block function sees
+// many independent blocks at once. The output is identical to `AES_wrap_key`.
+// Returns the number of operations that failed; every operation is attempted.
+size_t CCryptoBoringSSLShims_AES_wrap_key_batch(const AES_KEY *key, CCryptoBoringSSLShims_AES_wrap_batch_op *ops,
+                                                size_t ops_count);
+
+// Unwraps every key in the batch, as `CCryptoBoringSSLShims_AES_wrap_key_batch`
+// wraps them, with a key schedule from `AES_set_decrypt_key`. A key that fails
+// the integrity check has its output cleared. Returns the number of operations
+// that failed; every operation is attempted.
+size_t CCryptoBoringSSLShims_AES_unwrap_key_batch(const AES_KEY *key, CCryptoBoringSSLShims_AES_wrap_batch_op *ops,
+                                                  size_t ops_count);
+
+// MARK:- Parallel trust token issuance
+// The most threads `CCryptoBoringSSLShims_TRUST_TOKEN_ISSUER_issue_batch` uses.
+#define CCryptoBoringSSLShims_TRUST_TOKEN_MAX_THREADS 64
+
+// A single client request in a batch of trust token issuances. On return,
+// `result` is the return value of `TRUST_TOKEN_ISSUER_issue` and, on success,
+// `out` holds the response, which the caller must release with `OPENSSL_free`.
+typedef struct {
+    const uint8_t *request;
+    size_t request_len;
+    uint8_t *out;
+    size_t out_len;
+    size_t tokens_issued;
+    int result;
+} CCryptoBoringSSLShims_TRUST_TOKEN_issue_op;
+
+// Answers many independent issuance requests with `TRUST_TOKEN_ISSUER_issue`,
+// spread across up to `max_threads` threads, including the calling one. Each
+// response is exactly what a call to `TRUST_TOKEN_ISSUER_issue` would have
+// produced. The issuer's keys, and the precomputed tables they carry, are
+// shared by every thread. Returns the number of requests that failed; every
+// request is attempted.
+size_t CCryptoBoringSSLShims_TRUST_TOKEN_ISSUER_issue_batch(const TRUST_TOKEN_ISSUER *issuer,
+                                                            CCryptoBoringSSLShims_TRUST_TOKEN_issue_op *ops,
+                                                            size_t ops_count, uint32_t public_metadata,
+                                                            uint8_t private_metadata, size_t max_issuance,
+                                                            size_t max_threads);
+
+// MARK:- GMAC and POLYVAL
+// A GMAC or POLYVAL key with its table of powers of H precomputed for the
+// platform's GHASH kernel. Keys are only read after creation, so one may be
+// shared between threads.
+typedef struct CCryptoBoringSSLShims_GHASH_KEY_st CCryptoBoringSSLShims_GHASH_KEY;
+
+// The state of one GMAC or POLYVAL computation. It holds no pointers, so it
+// may be copied to fork a computation.
+typedef struct {
+    uint8_t Xi[16];
+    uint8_t partial[16];
+    size_t partial_len;
+    uint64_t len;
+    uint8_t EK0[16];
+} CCryptoBoringSSLShims_GHASH_CTX;
+
+// Returns a new AES-GMAC key for a 16, 24 or 32-byte AES key, or NULL.
+CCryptoBoringSSLShims_GHASH_KEY *CCryptoBoringSSLShims_GMAC_KEY_new(const uint8_t *key, size_t key_len);
+
+// Returns a new POLYVAL key, as defined in RFC 8452, or NULL.
+CCryptoBoringSSLShims_GHASH_KEY *CCryptoBoringSSLShims_POLYVAL_KEY_new(const uint8_t key[16]);
+
+// Clears and frees `key`. `key` may be NULL.
+void CCryptoBoringSSLShims_GHASH_KEY_free(CCryptoBoringSSLShims_GHASH_KEY *key);
+
+// Starts a GMAC computation with `nonce`, which may be any non-zero length.
+// GMAC is AES-GCM with no plaintext, so the result equals the tag AES-GCM
+// computes over the same additional data. Returns one on success.
+int CCryptoBoringSSLShims_GMAC_init(CCryptoBoringSSLShims_GHASH_CTX *ctx, const CCryptoBoringSSLShims_GHASH_KEY *key,
+                                    const uint8_t *nonce, size_t nonce_len);
+
+// Authenticates `len` more bytes. Returns zero if the total exceeds the
+// 2^61-byte limit GCM places on additional data.
+int CCryptoBoringSSLShims_GMAC_update(CCryptoBoringSSLShims_GHASH_CTX *ctx, const CCryptoBoringSSLShims_GHASH_KEY *key,
+                                      const void *in, size_t len);
+
+// Writes the 16-byte tag to `out` and clears `ctx`.
+void CCryptoBoringSSLShims_GMAC_final(CCryptoBoringSSLShims_GHASH_CTX *ctx, const CCryptoBoringSSLShims_GHASH_KEY *key,
+                                      uint8_t out[16]);
+
+// Starts a POLYVAL computation.
+void CCryptoBoringSSLShims_POLYVAL_init(CCryptoBoringSSLShims_GHASH_CTX *ctx);
+
+// Hashes `len` more bytes. The input is split into 16-byte blocks regardless
+// of how it is divided between calls. Returns zero past 2^61 bytes.
+int CCryptoBoringSSLShims_POLYVAL_update(CCryptoBoringSSLShims_GHASH_CTX *ctx,
+                                         const CCryptoBoringSSLShims_GHASH_KEY *key, const void *in, size_t len);
+
+// Zero-pads a trailing partial block, writes the 16-byte POLYVAL value to
+// `out`, and clears `ctx`.
+void CCryptoBoringSSLShims_POLYVAL_final(CCryptoBoringSSLShims_GHASH_CTX *ctx,
+                                         const CCryptoBoringSSLShims_GHASH_KEY *key, uint8_t out[16]);
+
+// MARK:- AES-CMAC
+// An AES-CMAC key: the AES key schedule and the K1 and K2 subkeys of RFC 4493.
+// Keys are only read after `CCryptoBoringSSLShims_CMAC_KEY_init`, so one may
+// be shared between threads.
+typedef struct {
+    AES_KEY key;
+    uint8_t k1[16];
+    uint8_t k2[16];
+} CCryptoBoringSSLShims_CMAC_KEY;
+
+// The state of one AES-CMAC computation. It holds no pointers, so it may be
+// copied to fork a computation.
+typedef struct {
+    uint8_t X[16];
+    uint8_t block[16];
+    size_t block_used;
+} CCryptoBoringSSLShims_CMAC_CTX;
+
+// Expands a 16, 24 or 32-byte AES key and derives its subkeys. Returns one on
+// success and zero if the key length is invalid.
+int CCryptoBoringSSLShims_CMAC_KEY_init(CCryptoBoringSSLShims_CMAC_KEY *key, const uint8_t *aes_key, size_t aes_key_len);
+
+// Starts an AES-CMAC computation.
+void CCryptoBoringSSLShims_CMAC_init(CCryptoBoringSSLShims_CMAC_CTX *ctx);
+
+// Authenticates `len` more bytes. Runs of whole blocks go through
+// `AES_cbc_encrypt`, and so through the hardware CBC kernel where there is one.
+void CCryptoBoringSSLShims_CMAC_update(CCryptoBoringSSLShims_CMAC_CTX *ctx, const CCryptoBoringSSLShims_CMAC_KEY *key,
+                                       const void *in, size_t len);
+
+// Writes the 16-byte tag to `out` and clears `ctx`.
+void CCryptoBoringSSLShims_CMAC_final(CCryptoBoringSSLShims_CMAC_CTX *ctx, const CCryptoBoringSSLShims_CMAC_KEY *key,
+                                      uint8_t out[16]);
+
+// MARK:- AES-CCM
+// An AES-CCM key. `rounds` is kept separately because the hardware key
+// schedules store their round count in different forms.
+typedef struct {
+    AES_KEY key;
+    unsigned rounds;
+} CCryptoBoringSSLShims_CCM_KEY;
+
+// Expands a 16, 24 or 32-byte AES key for CCM. Returns one on success and zero
+// if the key length is invalid.
+int CCryptoBoringSSLShims_CCM_KEY_init(CCryptoBoringSSLShims_CCM_KEY *key, const uint8_t *aes_key, size_t aes_key_len);
+
+// Seals `in_len` bytes from `in` to `out` with AES-CCM (RFC 3610, NIST SP
+// 800-38C) and writes a `tag_len`-byte tag to `out_tag`. The nonce is 7 to 13
+// bytes, which leaves a length field of 15 - `nonce_len` bytes, and the tag is
+// an even number of bytes from 4 to 16. `in` and `out` may be equal. Returns
+// one on success and zero if a length is out of range.
+//
+// Where the CPU has AES instructions, the CBC-MAC block and the CTR keystream
+// block for each 16 bytes go through the rounds together in one loop.
+int CCryptoBoringSSLShims_AES_CCM_seal(const CCryptoBoringSSLShims_CCM_KEY *key, const uint8_t *nonce, size_t nonce_len,
+                                       const uint8_t *ad, size_t ad_len, const uint8_t *in, size_t in_len,
+                                       uint8_t *out, uint8_t *out_tag, size_t tag_len);
+
+// Opens `in_len` bytes from `in` to `out`, checking them against the
+// `tag_len`-byte tag at `in_tag`. Returns one if the tag is valid. Otherwise
+// returns zero and clears `out`.
+int CCryptoBoringSSLShims_AES_CCM_open(const CCryptoBoringSSLShims_CCM_KEY *key, const uint8_t *nonce, size_t nonce_len,
+                                       const uint8_t *ad, size_t ad_len, const uint8_t *in, size_t in_len,
+                                       const uint8_t *in_tag, size_t tag_len, uint8_t *out);
+
+// MARK:- AES-XTS
+// An AES-XTS key: the data key expanded in both directions, and the tweak key.
+typedef struct {
+    AES_KEY encrypt;
+    AES_KEY decrypt;
+    AES_KEY tweak;
+    unsigned rounds;
+} CCryptoBoringSSLShims_XTS_KEY;
+
+// Expands a 32 or 64-byte AES-XTS key, the data key followed by the tweak key,
+// for AES-128-XTS or AES-256-XTS. Returns one on success and zero if the
+// length is invalid or the two halves are equal, which IEEE 1619 forbids.
+int CCryptoBoringSSLShims_XTS_KEY_init(CCryptoBoringSSLShims_XTS_KEY *key, const uint8_t *xts_key, size_t xts_key_len);
+
+// Encrypts (`enc` is one) or decrypts `len` bytes from `in` to `out` as one
+// AES-XTS data unit (IEEE 1619, NIST SP 800-38E) whose 16-byte tweak is
+// `tweak`. A length that isn't a multiple of 16 uses ciphertext stealing. The
+// length is from 16 bytes to 2^20 blocks. `in` and `out` may be equal. Returns
+// one on success and zero if the length is out of range.
+int CCryptoBoringSSLShims_AES_XTS_crypt(const CCryptoBoringSSLShims_XTS_KEY *key, const uint8_t tweak[16],
+                                        const uint8_t *in, uint8_t *out, size_t len, int enc);
+
+// Encrypts or decrypts `sector_count` consecutive `sector_len`-byte data units
+// from `in` to `out`. The tweak of each is its sector number, starting at
+// `first_sector`, as a 16-byte little-endian integer, as dm-crypt's plain64 IV
+// and the IEEE 1619 test vectors use. Returns zero if `sector_len` is out of
+// range or the sector numbers would pass 2^64 - 1.
+//
+// Where the CPU has AES instructions, eight blocks go through the rounds at
+// once, or sixteen in 256-bit registers where it also has VAES.
+int CCryptoBoringSSLShims_AES_XTS_crypt_sectors(const CCryptoBoringSSLShims_XTS_KEY *key, uint64_t first_sector,
+                                                const uint8_t *in, uint8_t *out, size_t sector_len,
+                                                size_t sector_count, int enc);
+
+// "vaes", "aes-ni", "armv8-aes" or "c": the kernel AES-XTS uses on runs of
+// whole blocks.
+const char *CCryptoBoringSSLShims_XTS_implementation(void);
+
+// MARK:- Compact AES-GCM key pool
+// A pool of AES-GCM session keys held in compact form: the raw key and the
+// GHASH key H, 56 bytes per session instead of the AES key schedule and
+// 16-entry H table of an initialised EVP_AEAD_CTX. A fixed number of fully
+// expanded slots act as an LRU cache in front of them. Using a session
+// promotes it into the least recently used slot, so hot sessions stay expanded
+// while cold ones cost only their compact entry. When every slot is in use by
+// another thread, the key is expanded on the stack for that one operation.
+// The pool is internally locked and may be used from any thread; the lock is
+// not held while data is encrypted.
+typedef struct CCryptoBoringSSLShims_GCM_POOL_st CCryptoBoringSSLShims_GCM_POOL;
+
+typedef struct {
+    // Live sessions, and the bytes of compact entries allocated for them.
+    size_t sessions;
+    size_t compact_bytes;
+    // Expanded slots and the bytes allocated for them.
+    size_t hot_capacity;
+    size_t hot_bytes;
+    // Operations that found their session already expanded.
+    uint64_t hits;
+    // Operations that expanded their session into a slot, and how many of
+    // those pushed another session out.
+    uint64_t promotions;
+    uint64_t evictions;
+    // Operations that expanded their session on the stack because no slot
+    // was free.
+    uint64_t transient_expansions;
+} CCryptoBoringSSLShims_GCM_POOL_statistics;
+
+// Creates a pool with `hot_capacity` expanded slots, which may be zero.
+// Returns NULL on allocation failure.
+CCryptoBoringSSLShims_GCM_POOL *CCryptoBoringSSLShims_GCM_POOL_new(size_t hot_capacity);
+
+// Frees `pool` and clears every key it holds.
+void CCryptoBoringSSLShims_GCM_POOL_free(CCryptoBoringSSLShims_GCM_POOL *pool);
+
+// Adds a session for a 16, 24 or 32-byte AES key and writes its handle to
+// `out_handle`. Returns one on success and zero if the key length is invalid
+// or memory is exhausted.
+int CCryptoBoringSSLShims_GCM_POOL_add(CCryptoBoringSSLShims_GCM_POOL *pool, const uint8_t *key, size_t key_len,
+                                       uint32_t *out_handle);
+
+// Removes a session and clears its key. The handle may be reused for a later
+// session, so it must not be used again.
+void CCryptoBoringSSLShims_GCM_POOL_remove(CCryptoBoringSSLShims_GCM_POOL *pool, uint32_t handle);
+
+// Seals `in_len` bytes with a session's key, writing the ciphertext to `out`
+// and the 16-byte tag to `out_tag`. `in` and `out` may be equal. Returns one
+// on success and zero otherwise.
+int CCryptoBoringSSLShims_GCM_POOL_seal(CCryptoBoringSSLShims_GCM_POOL *pool, uint32_t handle,
+                                        const uint8_t *nonce, size_t nonce_len, const uint8_t *ad, size_t ad_len,
+                                        const uint8_t *in, size_t in_len, uint8_t *out, uint8_t out_tag[16]);
+
+// Opens `in_len` bytes with a session's key, checking them against the
+// 16-byte tag at `in_tag`. Returns one if the tag is valid. Otherwise returns
+// zero and clears `out`.
+int CCryptoBoringSSLShims_GCM_POOL_open(CCryptoBoringSSLShims_GCM_POOL *pool, uint32_t handle,
+                                        const uint8_t *nonce, size_t nonce_len, const uint8_t *ad, size_t ad_len,
+                                        const uint8_t *in, size_t in_len, const uint8_t in_tag[16], uint8_t *out);
+
+// Fills `out` with a snapshot of the pool's counters.
+void CCryptoBoringSSLShims_GCM_POOL_get_statistics(CCryptoBoringSSLShims_GCM_POOL *pool,
+                                                   CCryptoBoringSSLShims_GCM_POOL_statistics *out);
+
+// MARK:- ChaCha20 and Poly1305
+// As `CRYPTO_chacha_20`, but runs sixteen blocks at a time with AVX-512 on
+// x86_64 processors that have it, for inputs of at least 1 KiB. Shorter
+// inputs, tails and other processors go to `CRYPTO_chacha_20`.
+void CCryptoBoringSSLShims_chacha_20(uint8_t *out, const uint8_t *in, size_t in_len, const uint8_t key[32],
+                                     const uint8_t nonce[12], uint32_t counter);
+
+// A one-time Poly1305 authenticator, as `poly1305_state`. On x86_64
+// processors with AVX2 and on AArch64 processors with NEON long updates run
+// four blocks at a time; elsewhere this is `CRYPTO_poly1305_*`.
+typedef struct {
+    uint64_t opaque[66];
+} CCryptoBoringSSLShims_POLY1305_STATE;
+
+void CCryptoBoringSSLShims_poly1305_init(CCryptoBoringSSLShims_POLY1305_STATE *state, const uint8_t key[32]);
+
+void CCryptoBoringSSLShims_poly1305_update(CCryptoBoringSSLShims_POLY1305_STATE *state, const uint8_t *in,
+                                           size_t in_len);
+
+// Writes the tag and wipes the state.
+void CCryptoBoringSSLShims_poly1305_finish(CCryptoBoringSSLShims_POLY1305_STATE *state, uint8_t mac[16]);
+
+// MARK:- Streaming AEAD
+// The state of a single AES-GCM or ChaCha20-Poly1305 seal or open whose
+// authenticated data and message arrive in pieces, so that inputs which are
+// not contiguous in memory don't have to be copied together first. The
+// ciphertext and tag match `EVP_AEAD_CTX_seal_scatter` over the concatenated
+// pieces. The stream points into the `EVP_AEAD_CTX` it was started from,
+// which it only reads and which must outlive it.
+typedef struct {
+    uint64_t opaque[96];
+} CCryptoBoringSSLShims_AEAD_STREAM;
+
+// Returns one if `ctx` uses an AEAD that can be streamed: AES-128-GCM,
+// AES-192-GCM, AES-256-GCM or ChaCha20-Poly1305.
+int CCryptoBoringSSLShims_AEAD_STREAM_supported(const EVP_AEAD_CTX *ctx);
+
+// Starts sealing (`encrypt` is one) or opening (`encrypt` is zero) with
+// `nonce`. Returns zero if the AEAD is not supported or the nonce is invalid.
+int CCryptoBoringSSLShims_AEAD_STREAM_init(CCryptoBoringSSLShims_AEAD_STREAM *stream, const EVP_AEAD_CTX *ctx,
+                                           const void *nonce, size_t nonce_len, int encrypt);
+
+// Adds authenticated data. All of it must be added before any message bytes.
+// Returns zero if that order is broken or the data is too long.
+int CCryptoBoringSSLShims_AEAD_STREAM_update_ad(CCryptoBoringSSLShims_AEAD_STREAM *stream, const void *ad,
+                                                size_t ad_len);
+
+// Encrypts or decrypts the next `len` message bytes from `in` to `out`, which
+// may be equal but must not otherwise overlap. Returns zero if the message is
+// too long.
+int CCryptoBoringSSLShims_AEAD_STREAM_update(CCryptoBoringSSLShims_AEAD_STREAM *stream, const void *in, void *out,
+                                             size_t len);
+
+// Finishes a seal, writing the tag to `out_tag` and its length to
+// `out_tag_len`. Returns zero if `max_out_tag_len` is too small. The stream
+// is cleared either way.
+int CCryptoBoringSSLShims_AEAD_STREAM_seal_final(CCryptoBoringSSLShims_AEAD_STREAM *stream, void *out_tag,
+                                                 size_t *out_tag_len, size_t max_out_tag_len);
+
+// Finishes an open, returning one if `in_tag` authenticates everything that
+// was fed in. The stream is cleared either way; on failure the caller must
+// discard, and should clear, the plaintext already written.
+int CCryptoBoringSSLShims_AEAD_STREAM_open_final(CCryptoBoringSSLShims_AEAD_STREAM *stream, const void *in_tag,
+                                                 size_t in_tag_len);
+
+// As `_update`, and also feeds the plaintext into `sha256`: `in` when sealing,
+// `out` when opening. The message is processed a cache-sized chunk at a time,
+// hashing and encrypting each chunk together, so it is read from memory once
+// instead of twice. Returns zero if the message is too long.
+int CCryptoBoringSSLShims_AEAD_STREAM_update_sha256(CCryptoBoringSSLShims_AEAD_STREAM *stream, SHA256_CTX *sha256,
+                                                    const void *in, void *out, size_t len);
+
+// MARK:- Parallel AES-GCM
+// Seals or opens one large AES-GCM message across several threads. The
+// message is cut into segments of `segment_len` bytes, a multiple of 16, each
+// of which starts at a known counter block and so can be processed on its
+// own. Every segment also yields the GHASH of its ciphertext alone, and
+// finishing folds those into the hash of the authenticated data with powers
+// of H. The ciphertext and tag match a serial seal byte for byte.
+//
+// Call `_init`, then `_segment` once for every index below `_segment_count`
+// in any order and on any threads, then `_seal_finish` or `_open_finish`. The
+// state points into the `EVP_AEAD_CTX`, which must outlive it.
+typedef struct {
+    uint64_t opaque[96];
+} CCryptoBoringSSLShims_GCM_PARALLEL;
+
+// Returns one if `ctx` uses AES-128-GCM, AES-192-GCM or AES-256-GCM.
+int CCryptoBoringSSLShims_GCM_PARALLEL_supported(const EVP_AEAD_CTX *ctx);
+
+// Starts sealing (`encrypt` is one) or opening (`encrypt` is zero) an
+// `in_len`-byte message. Returns zero if the AEAD is not supported, the nonce
+// is empty, `segment_len` is not a positive multiple of 16, or the message
+// or authenticated data is too long for GCM.
+int CCryptoBoringSSLShims_GCM_PARALLEL_init(CCryptoBoringSSLShims_GCM_PARALLEL *state, const EVP_AEAD_CTX *ctx,
+                                            const void *nonce, size_t nonce_len, const void *ad, size_t ad_len,
+                                            size_t in_len, size_t segment_len, int encrypt);
+
+// Returns the number of segments, which is zero for an empty message.
+size_t CCryptoBoringSSLShims_GCM_PARALLEL_segment_count(const CCryptoBoringSSLShims_GCM_PARALLEL *state);
+
+// Encrypts or decrypts segment `index` of the message at `in` into the same
+// offset of `out`, and writes the segment's GHASH to `out_ghash`. `in` and
+// `out` point at the start of the whole message, and may be equal but must
+// not otherwise overlap.
+void CCryptoBoringSSLShims_GCM_PARALLEL_segment(const CCryptoBoringSSLShims_GCM_PARALLEL *state, size_t index,
+                                                const void *in, void *out, uint8_t out_ghash[16]);
+
+// Combines the segments' GHASH values, `16 * segment_count` bytes in index
+// order, and writes the tag to `out_tag`. Returns zero if `max_out_tag_len`
+// is too small. The state is cleared either way.
+int CCryptoBoringSSLShims_GCM_PARALLEL_seal_finish(CCryptoBoringSSLShims_GCM_PARALLEL *state, const uint8_t *ghashes,
+                                                   void *out_tag, size_t *out_tag_len, size_t max_out_tag_len);
+
+// Combines the segments' GHASH values and returns one if `in_tag`
+// authenticates the message. The state is cleared either way; on failure the
+// caller must discard, and should clear, the plaintext.
+int CCryptoBoringSSLShims_GCM_PARALLEL_open_finish(CCryptoBoringSSLShims_GCM_PARALLEL *state, const uint8_t *ghashes,
+                                                   const void *in_tag, size_t in_tag_len);
+
+// MARK:- NUMA topology
+// Read-only key material that many threads use at once can be replicated so
+// each NUMA node works on its own copy. These report where the calling thread
+// is running. Where the topology can't be read, the machine is treated as a
+// single node.
+
+// Returns the number of NUMA nodes, which is at least one.
+size_t CCryptoBoringSSLShims_numa_node_count(void);
+
+// Returns the node of the CPU the calling thread is running on, which is below
+// `numa_node_count()`. The thread may migrate at any time, so this is a hint.
+size_t CCryptoBoringSSLShims_numa_current_node(void);
+
+// Acquire-loads `*slot`.
+void *CCryptoBoringSSLShims_atomic_load_pointer(void *const *slot);
+
+// Stores `desired` in `*slot` if it holds `expected`, with acquire-release
+// ordering. Returns one if it did, and zero otherwise.
+int CCryptoBoringSSLShims_atomic_compare_exchange_pointer(void **slot, void *expected, void *desired);
+
+// MARK:- Fixed-buffer key marshalling
+// RSA keys marshalled through a BIO are built in a growing `CBB`, copied
+// into the BIO, and copied again into the caller's buffer. These compute the
+// exact DER size from the key's integers up front, so the caller can allocate
+// the final buffer once and have the key written straight into it over
+// `CBB_init_fixed`.
+
+// Returns the size of the PKCS #1 RSAPublicKey encoding of `rsa`.
+size_t CCryptoBoringSSLShims_RSA_public_key_der_size(const RSA *rsa);
+
+// Returns the size of the SubjectPublicKeyInfo encoding of `rsa`.
+size_t CCryptoBoringSSLShims_RSA_spki_der_size(const RSA *rsa);
+
+// Returns the size of the PKCS #1 RSAPrivateKey encoding of `rsa`, or zero if
+// it lacks the CRT parameters that encoding needs.
+size_t CCryptoBoringSSLShims_RSA_private_key_der_size(const RSA *rsa);
+
+// Each writes its encoding of `rsa` into `out`, and returns one if it
+// filled exactly `out_len` bytes and zero otherwise.
+int CCryptoBoringSSLShims_RSA_marshal_public_key_fixed(uint8_t *out, size_t out_len, const RSA *rsa);
+
+int CCryptoBoringSSLShims_RSA_marshal_spki_fixed(uint8_t *out, size_t out_len, const EVP_PKEY *pkey);
+
+int CCryptoBoringSSLShims_RSA_marshal_private_key_fixed(uint8_t *out, size_t out_len, const RSA *rsa);
+
+// MARK:- Buffer key parsing
+// The `d2i_*_bio` functions wrap the caller's bytes in a memory BIO and read
+// them back out into a fresh buffer before parsing. These parse RSA keys over
+// a `CBS` pointing straight at the caller's bytes instead. Like the `d2i`
+// functions they read a single element, so any bytes after it are ignored.
+//
+// Each returns a new reference to the parsed key, or NULL if `der` does not
+// hold a key of that form.
+
+// Parses a SubjectPublicKeyInfo holding an RSA key.
+RSA *CCryptoBoringSSLShims_RSA_parse_spki_buffer(const uint8_t *der, size_t der_len);
+
+// Parses a PKCS #1 RSAPublicKey.
+RSA *CCryptoBoringSSLShims_RSA_parse_public_key_buffer(const uint8_t *der, size_t der_len);
+
+// Parses a PKCS #8 PrivateKeyInfo holding an RSA key.
+RSA *CCryptoBoringSSLShims_RSA_parse_pkcs8_buffer(const uint8_t *der, size_t der_len);
+
+// Parses a PKCS #1 RSAPrivateKey.
+RSA *CCryptoBoringSSLShims_RSA_parse_private_key_buffer(const uint8_t *der, size_t der_len);
+
+// MARK:- Instrumentation
+// When built with CRYPTO_BORINGSSL_INSTRUMENTATION defined on a platform with
+// pthreads, the shims count the events below. Each thread keeps its own
+// counters, which only it writes, and process-wide totals are summed on demand.
+// Allocations and frees are counted through CCryptoBoringSSL's prefixed
+// OPENSSL_memory_alloc hooks, so they are only available on ELF platforms. Random bytes, AEAD
+// operations and digest updates are counted as they pass through the shims.
+typedef enum {
+    CCryptoBoringSSLShims_event_allocations = 0,
+    CCryptoBoringSSLShims_event_allocated_bytes,
+    CCryptoBoringSSLShims_event_frees,
+    // Requests for random bytes, and the number of bytes requested.
+    CCryptoBoringSSLShims_event_random_requests,
+    CCryptoBoringSSLShims_event_random_bytes,
+    // Calls into RAND_bytes, which each draw from the DRBG. With buffering
+    // enabled this is lower than the number of requests.
+    CCryptoBoringSSLShims_event_random_generations,
+    CCryptoBoringSSLShims_event_aead_seals,
+    CCryptoBoringSSLShims_event_aead_sealed_bytes,
+    CCryptoBoringSSLShims_event_aead_opens,
+    CCryptoBoringSSLShims_event_aead_opened_bytes,
+    CCryptoBoringSSLShims_event_aead_open_failures,
+    CCryptoBoringSSLShims_event_digest_updates,
+    CCryptoBoringSSLShims_event_digested_bytes,
+    CCryptoBoringSSLShims_event_count,
+} CCryptoBoringSSLShims_event;
+
+// Returns 1 if instrumentation is compiled in, and 0 otherwise.
+int CCryptoBoringSSLShims_instrumentation_enabled(void);
+
+// Writes the first `count` counters for the calling thread to `out`, indexed
+// by CCryptoBoringSSLShims_event. Counters are zero if instrumentation is not
+// compiled in.
+void CCryptoBoringSSLShims_instrumentation_thread_counters(uint64_t *out, size_t count);
+
+// As CCryptoBoringSSLShims_instrumentation_thread_counters, but summed over
+// every thread, including those that have exited.
+void CCryptoBoringSSLShims_instrumentation_process_counters(uint64_t *out, size_t count);
+
+// MARK:- Lock contention
+// The locks taken inside the shims. With instrumentation compiled in, each site
+// counts the acquisitions that found its lock held, how many of those went to
+// sleep rather than spinning until it was released, and the total time they
+// waited. Uncontended acquisitions aren't counted, and cost nothing extra.
+typedef enum {
+    // The compact AES-GCM key pool.
+    CCryptoBoringSSLShims_lock_site_gcm_key_pool = 0,
+    // The slab allocator's shared free lists.
+    CCryptoBoringSSLShims_lock_site_slab_allocator,
+    CCryptoBoringSSLShims_lock_site_count,
+} CCryptoBoringSSLShims_lock_site;
+
+typedef struct {
+    uint64_t contended;
+    uint64_t sleeps;
+    uint64_t wait_ns;
+} CCryptoBoringSSLShims_lock_statistics;
+
+// Returns 1 if lock contention is measured, which it is when instrumentation is
+// compiled in, and 0 otherwise.
+int CCryptoBoringSSLShims_lock_statistics_enabled(void);
+
+// Fills `out` with the totals for `site` since the process started. They are
+// zero if contention isn't measured.
+void CCryptoBoringSSLShims_lock_site_statistics(CCryptoBoringSSLShims_lock_site site,
+                                                CCryptoBoringSSLShims_lock_statistics *out);
+
+// MARK:- Tracepoints
+// When built with CRYPTO_BORINGSSL_TRACEPOINTS defined on a platform with
+// pthreads, the shims mark the start and end of the operations below. On Linux,
+// when <sys/sdt.h> is available at build time, each mark is also a USDT probe
+// in the `swift_crypto` provider, named `<operation>_entry` and
+// `<operation>_return`. Entry probes take the algorithm, the key size in bits
+// and the byte count, and return probes add the result. A probe nobody is
+// attached to costs a NOP.
+typedef enum {
+    // The algorithm is the AEAD's NID, or NID_undef if it has none.
+    CCryptoBoringSSLShims_trace_aead_seal = 0,
+    CCryptoBoringSSLShims_trace_aead_open,
+    // The algorithm is the curve's NID.
+    CCryptoBoringSSLShims_trace_ecdsa_sign,
+    CCryptoBoringSSLShims_trace_ecdsa_verify,
+    // The algorithm is the digest's NID.
+    CCryptoBoringSSLShims_trace_rsa_sign,
+    CCryptoBoringSSLShims_trace_rsa_verify,
+    CCryptoBoringSSLShims_trace_ed25519_sign,
+    CCryptoBoringSSLShims_trace_ed25519_verify,
+    CCryptoBoringSSLShims_trace_x25519,
+    // Draws from BoringSSL's DRBG made by the shims, any of which may reseed it.
+    CCryptoBoringSSLShims_trace_random_generate,
+    CCryptoBoringSSLShims_trace_operation_count,
+} CCryptoBoringSSLShims_trace_operation;
+
+// Called with `is_return` 0 when an operation starts, and 1 when it finishes.
+// `result` is 1 if the operation succeeded, and is always 0 on entry. The hook
+// runs on the thread doing the operation and must not call back into the shims.
+typedef void (*CCryptoBoringSSLShims_trace_hook)(CCryptoBoringSSLShims_trace_operation operation, int is_return,
+                                                 int algorithm, int key_bits, uint64_t byte_count, int result);
+
+// Returns 1 if tracepoints are compiled in, and 0 otherwise.
+int CCryptoBoringSSLShims_tracepoints_enabled(void);
+
+// Installs `hook`, or removes the current hook if it's NULL. Does nothing if
+// tracepoints are not compiled in.
+void CCryptoBoringSSLShims_set_trace_hook(CCryptoBoringSSLShims_trace_hook hook);
+
+// MARK:- Latency histograms
+// When instrumentation is compiled in, the traced operations above can also be
+// timed. Once a sample interval is set, every `interval`th operation on each
+// thread is timed with the monotonic clock and counted in a per-thread
+// histogram for its operation, algorithm and key size. AEAD operations are
+// further split by message size. Histograms are merged across threads on read,
+// and those of exited threads are kept.
+//
+// Each histogram has CCryptoBoringSSLShims_LATENCY_BUCKET_COUNT log-linear
+// buckets of nanoseconds, with eight buckets per power of two, so a bucket's
+// upper bound is within 12.5% of any value in it. Times of 2^36ns or more are
+// counted in the last bucket.
+#define CCryptoBoringSSLShims_LATENCY_BUCKET_COUNT 272
+
+typedef struct {
+    CCryptoBoringSSLShims_trace_operation operation;
+    // As passed to the trace hook.
+    int algorithm;
+    int key_bits;
+    // For AEAD operations, the largest message in this series: 64, 1024, 16384
+    // or UINT64_MAX. Zero for every other operation.
+    uint64_t max_bytes;
+} CCryptoBoringSSLShims_latency_series_key;
+
+// Samples one in every `interval` operations on each thread, or stops sampling
+// if it's zero, which is the default. Does nothing if instrumentation is not
+// compiled in.
+void CCryptoBoringSSLShims_latency_set_sample_interval(uint32_t interval);
+
+uint32_t CCryptoBoringSSLShims_latency_sample_interval(void);
+
+// The largest number of nanoseconds counted in `bucket`.
+uint64_t CCryptoBoringSSLShims_latency_bucket_upper_bound(size_t bucket);
+
+// Writes up to `max_series` keys to `out_keys`, and the buckets of each to
+// `out_counts`, which has room for `max_series` times
+// CCryptoBoringSSLShims_LATENCY_BUCKET_COUNT counts. Returns the number of
+// series written plus the number that didn't fit, which may overcount; if it is
+// larger than `max_series`, call again with room for that many.
+size_t CCryptoBoringSSLShims_latency_histograms(CCryptoBoringSSLShims_latency_series_key *out_keys,
+                                                uint64_t *out_counts, size_t max_series);
+
+// MARK:- Slab allocator
+// When built with CRYPTO_BORINGSSL_SLAB_ALLOCATOR defined, the shims provide
+// CCryptoBoringSSL's prefixed OPENSSL_memory_alloc hooks. Allocations of up to
+// 1 KiB are then served from per-size-class slabs with a small per-thread cache
+// in front of them, and only the bytes that were requested are cleansed on
+// free. The hooks are weak symbols, so this only takes effect on ELF platforms. It replaces the
+// allocator for CCryptoBoringSSL only, not for other copies of BoringSSL in the
+// process, and slab memory is never returned to the system.
+
+// Statistics for a single size class. The final row describes allocations too
+// large for any class, which go straight to malloc, and has a block_size of 0.
+// Counters are updated independently, so a snapshot taken while other threads
+// allocate may be slightly inconsistent.
+typedef struct {
+    size_t block_size;
+    uint64_t allocations;
+    uint64_t frees;
+    // Allocations served from a thread cache without taking a lock.
+    uint64_t cached_allocations;
+    uint64_t requested_bytes;
+    uint64_t slabs;
+} CCryptoBoringSSLShims_slab_statistics;
+
+// Returns 1 if the slab allocator is compiled in, and 0 otherwise.
+int CCryptoBoringSSLShims_slab_allocator_enabled(void);
+
+// Returns the number of statistics rows, including the oversize row, or zero if
+// the slab allocator is not compiled in.
+size_t CCryptoBoringSSLShims_slab_allocator_class_count(void);
+
+// Fills `out` with the statistics for row `index`. Returns 0 if `index` is out
+// of range.
+int CCryptoBoringSSLShims_slab_allocator_statistics(size_t index,
+                                                    CCryptoBoringSSLShims_slab_statistics *out);
+
+// MARK:- Request arenas
+// When built with CRYPTO_BORINGSSL_ARENAS defined, the shims provide
+// CCryptoBoringSSL's prefixed OPENSSL_memory_alloc hooks, so this only takes
+// effect on ELF platforms. A thread can then install an arena, and every
+// BoringSSL allocation it makes until the arena is removed is bumped from the
+// arena's regions instead of going to the heap. Frees inside the scope cost
+// nothing. When the arena is removed, its regions are cleansed and freed
+// together. Allocations that are still live at that point, such as objects the
+// scope returns, stay valid and keep the regions alive until they are freed, on
+// any thread. Allocations made outside an arena go to the slab allocator if it
+// is compiled in, and to malloc otherwise, with a 16-byte header of their own.
+
+typedef struct {
+    uint64_t allocations;
+    uint64_t allocated_bytes;
+    // Allocations from the arena that are not freed yet.
+    uint64_t live_allocations;
+    uint64_t regions;
+    // The bytes in those regions.
+    uint64_t reserved_bytes;
+} CCryptoBoringSSLShims_arena_statistics;
+
+// Returns 1 if arenas are compiled in, and 0 otherwise.
+int CCryptoBoringSSLShims_arena_enabled(void);
+
+// Installs a new arena on the calling thread, nested inside any arena already
+// installed there, and returns it. Regions are `region_size` bytes, or larger
+// for allocations that need it. Returns NULL if arenas are not compiled in or
+// the arena cannot be allocated, in which case allocations carry on as usual.
+void *CCryptoBoringSSLShims_arena_push(size_t region_size);
+
+// Removes `arena`, which must be the innermost arena installed on the calling
+// thread, and releases it. Does nothing if `arena` is NULL.
+void CCryptoBoringSSLShims_arena_pop(void *arena);
+
+// Fills `out` with the statistics of the innermost arena installed on the
+// calling thread. Returns 0 if there is none.
+int CCryptoBoringSSLShims_arena_current_statistics(CCryptoBoringSSLShims_arena_statistics *out);
+
+// MARK:- Bulk trust store loading
+// The most threads `CCryptoBoringSSLShims_X509_STORE_load_bundle` uses.
+#define CCryptoBoringSSLShims_X509_BUNDLE_MAX_THREADS 64
+
+// What a bundle load did, and how long it took.
+typedef struct {
+    // The size of the bundle.
+    size_t bytes;
+    // The certificates decoded and parsed.
+    size_t objects_parsed;
+    // PEM blocks of other types, such as CRLs or keys, which are ignored.
+    size_t objects_skipped;
+    // The certificates that were new to the store.
+    size_t certificates_added;
+    // The certificates that were already in the store, or repeated in the bundle.
+    size_t duplicates;
+    // The threads that parsed certificates, including the calling one.
+    size_t threads;
+    // On failure, the offset of the object that could not be split or parsed.
+    size_t failed_offset;
+    // The time spent splitting and parsing the bundle, and then in inserting
+    // the certificates. Zero where no monotonic clock is available.
+    uint64_t parse_ns;
+    uint64_t insert_ns;
+} CCryptoBoringSSLShims_X509_bundle_statistics;
+
+// Adds every certificate in a CA bundle to `store`. The bundle is either PEM,
+// with text between the blocks ignored as in most CA files, or back-to-back DER
+// certificates. "CERTIFICATE", "X509 CERTIFICATE" and "TRUSTED CERTIFICATE"
+// blocks are loaded and any other block is skipped.
+//
+// The bundle is split at its object boundaries on the calling thread, and the
+// certificates are decoded and parsed on up to `max_threads` threads. They then
+// go into the store under a single acquisition of its lock, with duplicates
+// ignored as `X509_STORE_add_cert` would ignore them.
+//
+// Returns 1 on success. If any object is malformed, returns 0 and adds nothing.
+// `out_statistics`, if not NULL, is filled in either way.
+int CCryptoBoringSSLShims_X509_STORE_load_bundle(X509_STORE *store, const void *bundle, size_t bundle_len,
+                                                 size_t max_threads,
+                                                 CCryptoBoringSSLShims_X509_bundle_statistics *out_statistics);
+
+// Returns the number of certificates in `store`, taking its lock to count them.
+// Certificates in a snapshot added with
+// `CCryptoBoringSSLShims_X509_STORE_add_snapshot` are counted whether or not
+// they have been parsed yet.
+size_t CCryptoBoringSSLShims_X509_STORE_certificate_count(X509_STORE *store);
+
+// MARK:- Trust store snapshots
+
+// Serializes every certificate in `store`, including any from its snapshot that
+// have not been parsed and any from its directory that have not been loaded,
+// into a snapshot: their DER encodings with their
+// canonical subject names, subject name hashes and subject key identifiers, and
+// indexes over the names and identifiers. On success returns 1 and sets `*out`
+// to a buffer the caller frees with `OPENSSL_free`.
+int CCryptoBoringSSLShims_X509_STORE_write_snapshot(X509_STORE *store, uint8_t **out, size_t *out_len);
+
+// Makes the certificates in a snapshot available to `store` without parsing
+// them. The certificates with a given subject are parsed and added to the store
+// the first time a chain build or lookup asks for that subject. `snapshot` is not
+// copied, and must stay valid and unchanged until `store` is freed.
+//
+// Returns 1 on success, or 0 if the snapshot is malformed, fails its SHA-256
+// check when `verify_integrity` is set, or `store` already has a snapshot.
+int CCryptoBoringSSLShims_X509_STORE_add_snapshot(X509_STORE *store, const void *snapshot, size_t len,
+                                                  int verify_integrity);
+
+// Returns the number of certificates from the snapshot of `store` that have
+// been parsed so far, or zero if it has no snapshot.
+size_t CCryptoBoringSSLShims_X509_STORE_snapshot_parsed_count(X509_STORE *store);
+
+// Looks up a trusted issuer of the DER certificate `der`, as a chain build
+// would. Returns 1 and sets `*out_der` to the issuer's DER encoding, which the
+// caller frees with `OPENSSL_free`, 0 if there is none, or -1 if `der` is not a
+// certificate or on allocation failure.
+int CCryptoBoringSSLShims_X509_STORE_find_issuer(X509_STORE *store, const uint8_t *der, size_t der_len,
+                                                 uint8_t **out_der, size_t *out_der_len);
+
+// Looks up a certificate in `store` by its subject key identifier, using the
+// snapshot's index and without parsing when it holds one. Returns as
+// `CCryptoBoringSSLShims_X509_STORE_find_issuer` does.
+int CCryptoBoringSSLShims_X509_STORE_find_by_key_id(X509_STORE *store, const uint8_t *key_id, size_t key_id_len,
+                                                    uint8_t **out_der, size_t *out_der_len);
+
+// MARK:- Indexed certificate directories
+
+// Makes the certificates in `path`, a directory of files named by subject name
+// hash as `openssl rehash` and `c_rehash` write them, available to `store`. The
+// names are read into an index once, and a lookup opens only the files with its
+// subject's hash, the first time that hash is asked for. A hash the directory
+// doesn't hold is answered without touching the filesystem.
+//
+// The directory's modification time is checked at most once every `refresh_ns`
+// nanoseconds, and when it has changed the names are read again. New and
+// replaced files are loaded when their hash is next asked for. Certificates
+// from files that were removed stay in the store, as with the by_dir lookup.
+//
+// Returns 1 on success, or 0 if `path` can't be read, on allocation failure,
+// or if `store` already has a directory. Always returns 0 on Windows.
+int CCryptoBoringSSLShims_X509_STORE_add_directory(X509_STORE *store, const char *path, uint64_t refresh_ns);
+
+typedef struct {
+    // The certificate files in the directory's index.
+    size_t files_indexed;
+    // The files that lookups have opened so far.
+    size_t files_loaded;
+    // The times the directory's names have been read, including the first.
+    size_t scans;
+} CCryptoBoringSSLShims_X509_directory_statistics;
+
+// Fills `out_statistics` for the directory of `store`, or with zeros if it has
+// none.
+void CCryptoBoringSSLShims_X509_STORE_directory_statistics(
+    X509_STORE *store, CCryptoBoringSSLShims_X509_directory_statistics *out_statistics);
+
+// MARK:- HPKE contexts
+
+// The HPKE contexts are only available through these shims, as the HPKE header
+// is not part of CCryptoBoringSSL's umbrella header. They cover DHKEM(X25519)
+// with HKDF-SHA256, and the AEADs are named by their RFC 9180 identifiers:
+// 0x0001 (AES-128-GCM), 0x0002 (AES-256-GCM) and 0x0003 (ChaCha20-Poly1305).
+
+EVP_HPKE_CTX *CCryptoBoringSSLShims_EVP_HPKE_CTX_new(void);
+
+void CCryptoBoringSSLShims_EVP_HPKE_CTX_free(EVP_HPKE_CTX *ctx);
+
+// Replaces `dst` with a copy of the set-up context `src`, which then seal or
+// open independently. Returns 0 if `src` is not set up with one of the AEADs
+// above.
+int CCryptoBoringSSLShims_EVP_HPKE_CTX_copy(EVP_HPKE_CTX *dst, const EVP_HPKE_CTX *src);
+
+// Sets up `ctx` as a sender to the 32-byte `peer_public_key`, writing the
+// 32-byte encapsulated key to `out_enc`. If `auth_private_key` is not NULL,
+// this uses the auth mode with it and its 32-byte `auth_public_key`.
+int CCryptoBoringSSLShims_EVP_HPKE_CTX_setup_x25519_sender(EVP_HPKE_CTX *ctx, uint16_t aead_id, uint8_t *out_enc,
+                                                           const uint8_t *peer_public_key,
+                                                           const uint8_t *auth_private_key,
+                                                           const uint8_t *auth_public_key, const void *info,
+                                                           size_t info_len);
+
+// Sets up `ctx` as the recipient of `enc` with the 32-byte key pair. If
+// `auth_public_key` is not NULL, this uses the auth mode with that sender key.
+int CCryptoBoringSSLShims_EVP_HPKE_CTX_setup_x25519_recipient(EVP_HPKE_CTX *ctx, uint16_t aead_id,
+                                                              const uint8_t *private_key, const uint8_t *public_key,
+                                                              const uint8_t *enc, size_t enc_len,
+                                                              const uint8_t *auth_public_key, const void *info,
+                                                              size_t info_len);
+
+int CCryptoBoringSSLShims_EVP_HPKE_CTX_seal(EVP_HPKE_CTX *ctx, void *out, size_t *out_len, size_t max_out_len,
+                                            const void *in, size_t in_len, const void *ad, size_t ad_len);
+
+int CCryptoBoringSSLShims_EVP_HPKE_CTX_open(EVP_HPKE_CTX *ctx, void *out, size_t *out_len, size_t max_out_len,
+                                            const void *in, size_t in_len, const void *ad, size_t ad_len);
+
+// Writes the exporter secret to `out` and returns its length, or returns 0 if
+// it does not fit in `max_out_len` bytes.
+size_t CCryptoBoringSSLShims_EVP_HPKE_CTX_exporter_secret(const EVP_HPKE_CTX *ctx, void *out, size_t max_out_len);
+
+// Returns the number of messages sealed or opened so far.
+uint64_t CCryptoBoringSSLShims_EVP_HPKE_CTX_sequence(const EVP_HPKE_CTX *ctx);
+
+// MARK:- Fused key agreement and AEAD setup
+
+#define CCRYPTOBORINGSSLSHIMS_KEY_AGREEMENT_X25519 1
+#define CCRYPTOBORINGSSLSHIMS_KEY_AGREEMENT_P256 2
+
+// Agrees a shared secret between `private_key` and `peer_public_key`, derives
+// an `aead` key from it with HKDF using `md`, `salt` and `info`, and
+// initialises the `EVP_AEAD_CTX` at `ctx` with that key and the default tag
+// length. For X25519 both keys are 32 bytes. For P-256 the private key is the
+// 32-byte big-endian scalar and the peer key is a 65-byte uncompressed point,
+// which is checked to be on the curve. The shared secret and the derived key
+// only ever live on the stack, and are wiped before returning. Returns one on
+// success and zero on failure, in which case `ctx` is left uninitialised.
+int CCryptoBoringSSLShims_EVP_AEAD_CTX_init_with_key_agreement(void *ctx, const EVP_AEAD *aead, int key_agreement,
+                                                               const void *private_key, const void *peer_public_key,
+                                                               const EVP_MD *md, const void *salt, size_t salt_len,
+                                                               const void *info, size_t info_len);
+
+// MARK:- secp256k1
+
+// ECDSA over secp256k1. Private keys are 32-byte big-endian scalars, public
+// keys the 64-byte concatenation of their affine coordinates, and signatures
+// the 64-byte concatenation of r and s. Each function returns one on success
+// and zero on failure.
+
+int CCryptoBoringSSLShims_secp256k1_generate_key(void *out_private_key);
+
+// Fails if `private_key` is zero or not below the group order.
+int CCryptoBoringSSLShims_secp256k1_public_key(void *out_public_key, const void *private_key);
+
+int CCryptoBoringSSLShims_secp256k1_public_key_is_valid(const void *public_key);
+
+// Decodes a 33-byte SEC 1 compressed point into the 64-byte form.
+int CCryptoBoringSSLShims_secp256k1_decompress(void *out_public_key, const void *compressed_public_key);
+
+// Signs with a random nonce in constant time. The signature always has the
+// low s required by Bitcoin and Ethereum.
+int CCryptoBoringSSLShims_secp256k1_sign(void *out_signature, const void *private_key,
+                                         const void *digest, size_t digest_len);
+
+// Accepts both low and high s, as ECDSA does.
+int CCryptoBoringSSLShims_secp256k1_verify(const void *public_key, const void *digest, size_t digest_len,
+                                           const void *signature, size_t signature_len);
+
+// Verifies every op against one public key, precomputing its multiples once.
+// Writes one or zero to `results` for each op and returns how many verified.
+size_t CCryptoBoringSSLShims_secp256k1_verify_batch(const void *public_key,
+                                                    const CCryptoBoringSSLShims_ECDSA_verify_batch_op *ops,
+                                                    size_t ops_count, int *results);
+
+// Like `CCryptoBoringSSLShims_secp256k1_verify`, but on BoringSSL's generic
+// curve arithmetic.
+int CCryptoBoringSSLShims_secp256k1_verify_generic(const void *public_key, const void *digest,
+                                                   size_t digest_len, const void *signature, size_t signature_len);
+
+// Converts between the raw r || s form of an ECDSA signature and DER. The DER
+// parser is strict, and fails if r or s is longer than `scalar_len` bytes.
+int CCryptoBoringSSLShims_ECDSA_raw_signature_to_der(void *out, size_t *out_len, size_t max_out,
+                                                     const void *signature, size_t signature_len);
+
+int CCryptoBoringSSLShims_ECDSA_der_signature_to_raw(void *out, size_t scalar_len, const void *der,
+                                                     size_t der_len);
+
+// MARK:- Pinned trust anchors
+
+// An immutable copy of the certificates in a store, for issuer lookups from
+// many threads at once. A lookup through an `X509_STORE` takes and drops
+// references to the store and to the issuer, and takes the locks that guard
+// the store and each certificate's cached extensions, so every lookup writes
+// to the same few cache lines. A pinned set holds only the bytes
+// `X509_check_issued` compares, copied out once, and lookups only read it.
+typedef struct CCryptoBoringSSLShims_X509_pinned_anchors_st CCryptoBoringSSLShims_X509_pinned_anchors;
+
+// Copies every certificate in `store`, including any in its snapshot that have
+// not been parsed yet, and any in its directory that have not been loaded. Later changes to `store` are not seen. Returns NULL on
+// allocation failure.
+CCryptoBoringSSLShims_X509_pinned_anchors *CCryptoBoringSSLShims_X509_STORE_pin_anchors(X509_STORE *store);
+
+void CCryptoBoringSSLShims_X509_pinned_anchors_free(CCryptoBoringSSLShims_X509_pinned_anchors *pinned);
+
+size_t CCryptoBoringSSLShims_X509_pinned_anchors_count(const CCryptoBoringSSLShims_X509_pinned_anchors *pinned);
+
+// Looks up an issuer of the DER certificate `der` with the checks
+// `CCryptoBoringSSLShims_X509_STORE_find_issuer` makes, and returns as it does.
+int CCryptoBoringSSLShims_X509_pinned_anchors_find_issuer(const CCryptoBoringSSLShims_X509_pinned_anchors *pinned,
+                                                          const uint8_t *der, size_t der_len, uint8_t **out_der,
+                                                          size_t *out_der_len);
+
+// MARK:- Ristretto255
+
+// The prime-order group ristretto255 of RFC 9496, on the Edwards25519
+// arithmetic of Ed25519. A point is an internal representative of its group
+// element, `CCryptoBoringSSLShims_RISTRETTO255_POINT_BYTES` long; an element is
+// encoded in 32 bytes. Scalars are 32-byte little-endian integers below the
+// group order, and every function taking one expects it reduced.
+#define CCryptoBoringSSLShims_RISTRETTO255_POINT_BYTES 160
+#define CCryptoBoringSSLShims_RISTRETTO255_ELEMENT_BYTES 32
+#define CCryptoBoringSSLShims_RISTRETTO255_SCALAR_BYTES 32
+
+// Decodes a canonical encoding, returning zero if `in` is not one.
+int CCryptoBoringSSLShims_ristretto255_decode(void *out_point, const void *in);
+
+void CCryptoBoringSSLShims_ristretto255_encode(void *out, const void *point);
+
+// Returns one if the points represent the same element, in constant time.
+int CCryptoBoringSSLShims_ristretto255_equal(const void *a, const void *b);
+
+void CCryptoBoringSSLShims_ristretto255_identity(void *out_point);
+
+// The element derivation of RFC 9496, section 4.3.4, from 64 uniformly random
+// bytes.
+void CCryptoBoringSSLShims_ristretto255_from_uniform_bytes(void *out_point, const void *in);
+
+// hash_to_ristretto255 of RFC 9380, appendix B, with expand_message_xmd and
+// SHA-512. Returns zero if `dst` is empty.
+int CCryptoBoringSSLShims_ristretto255_hash_to_group(void *out_point, const void *msg, size_t msg_len,
+                                                     const void *dst, size_t dst_len);
+
+void CCryptoBoringSSLShims_ristretto255_add(void *out_point, const void *a, const void *b);
+
+void CCryptoBoringSSLShims_ristretto255_sub(void *out_point, const void *a, const void *b);
+
+void CCryptoBoringSSLShims_ristretto255_neg(void *out_point, const void *a);
+
+// Constant-time multiplication of the generator and of a point.
+void CCryptoBoringSSLShims_ristretto255_scalarmult_base(void *out_point, const void *scalar);
+
+void CCryptoBoringSSLShims_ristretto255_scalarmult(void *out_point, const void *scalar, const void *point);
+
+// Writes the encodings of twice each of `count` points. Encoding a point needs
+// an inverse square root of its own, but the encodings of doubles share one
+// inversion for every few dozen points.
+void CCryptoBoringSSLShims_ristretto255_encode_doubled_batch(void *out, const void *points, size_t count);
+
+// Writes the encodings of `scalar` times each of `count` points, in constant
+// time, through `CCryptoBoringSSLShims_ristretto255_encode_doubled_batch`.
+void CCryptoBoringSSLShims_ristretto255_scalarmult_encode_batch(void *out, const void *scalar, const void *points,
+                                                                size_t count);
+
+// Writes the encodings of the generator times each of `count` scalars, in
+// constant time, as above.
+void CCryptoBoringSSLShims_ristretto255_scalarmult_base_encode_batch(void *out, const void *scalars, size_t count);
+
+// Sets `out_point` to the sum of scalars[i] times points[i], in variable time,
+// with Pippenger's bucket method. Returns zero on allocation failure.
+int CCryptoBoringSSLShims_ristretto255_multi_scalar_mul(void *out_point, const void *scalars, const void *points,
+                                                        size_t count);
+
+// Returns one if `scalar` is below the group order, in constant time.
+int CCryptoBoringSSLShims_ristretto255_scalar_is_canonical(const void *scalar);
+
+// Reduces a 64-byte little-endian integer modulo the group order.
+void CCryptoBoringSSLShims_ristretto255_scalar_reduce(void *out, const void *in);
+
+// A uniformly random scalar. Returns zero if the random number generator fails.
+int CCryptoBoringSSLShims_ristretto255_scalar_random(void *out);
+
+void CCryptoBoringSSLShims_ristretto255_scalar_add(void *out, const void *a, const void *b);
+
+void CCryptoBoringSSLShims_ristretto255_scalar_sub(void *out, const void *a, const void *b);
+
+void CCryptoBoringSSLShims_ristretto255_scalar_neg(void *out, const void *a);
+
+void CCryptoBoringSSLShims_ristretto255_scalar_mul(void *out, const void *a, const void *b);
+
+// The multiplicative inverse, in constant time. Zero maps to zero.
+void CCryptoBoringSSLShims_ristretto255_scalar_invert(void *out, const void *a);
+
+// MARK:- SP 800-185
+// cSHAKE, KMAC and ParallelHash from NIST SP 800-185 over the Keccak contexts
+// above. `function` selects the 128-bit (shake128) or 256-bit (shake256)
+// variant. Contexts set up here are squeezed with
+// CCryptoBoringSSLShims_keccak_cshake_squeeze, any number of times. Like the
+// other Keccak contexts they hold no pointers and may be copied freely.
+
+// cSHAKE with the function name `name` and customization string `custom`.
+// When both are empty this is SHAKE.
+void CCryptoBoringSSLShims_keccak_cshake_init(CCryptoBoringSSLShims_keccak_ctx *ctx,
+                                              CCryptoBoringSSLShims_keccak_function function, const void *name,
+                                              size_t name_len, const void *custom, size_t custom_len);
+
+// KMAC up to its message: the caller absorbs the message, then the
+// right_encode of the output length in bits (zero for KMACXOF), and squeezes.
+void CCryptoBoringSSLShims_keccak_kmac_init(CCryptoBoringSSLShims_keccak_ctx *ctx,
+                                            CCryptoBoringSSLShims_keccak_function function, const void *key,
+                                            size_t key_len, const void *custom, size_t custom_len);
+
+// Absorbs the right_encode of `value`.
+void CCryptoBoringSSLShims_keccak_absorb_right_encode(CCryptoBoringSSLShims_keccak_ctx *ctx, uint64_t value);
+
+void CCryptoBoringSSLShims_keccak_cshake_squeeze(CCryptoBoringSSLShims_keccak_ctx *ctx, void *out, size_t out_len);
+
+// ParallelHash up to its first block. The caller hashes every block with
+// CCryptoBoringSSLShims_keccak_parallel_hash_absorb_blocks, the last of which
+// may be short, then absorbs the right_encode of the number of blocks and of
+// the output length in bits (zero for ParallelHashXOF), and squeezes.
+void CCryptoBoringSSLShims_keccak_parallel_hash_init(CCryptoBoringSSLShims_keccak_ctx *ctx,
+                                                     CCryptoBoringSSLShims_keccak_function function,
+                                                     size_t block_size, const void *custom, size_t custom_len);
+
+// Hashes `count` consecutive blocks of `block_size` bytes and absorbs their
+// chaining values in order. On x86_64 processors with AVX2 four blocks are
+// hashed at once, and on AArch64 two. Inputs of at least a few hundred
+// kilobytes are spread over up to `max_threads` threads, including the calling
+// one. Returns zero if `block_size` is zero or memory runs out.
+int CCryptoBoringSSLShims_keccak_parallel_hash_absorb_blocks(CCryptoBoringSSLShims_keccak_ctx *ctx, const void *in,
+                                                             size_t block_size, size_t count, size_t max_threads);
+
+// MARK:- Warm-up
+// BoringSSL defers some set-up to first use: CPU feature detection, opening
+// the entropy source, the fork detection state, the built-in EC groups, and on
+// each thread the DRBG state, which is instantiated and seeded by that
+// thread's first request for random bytes. These do that work ahead of time.
+
+// Does the process-wide set-up. Safe to call concurrently and repeatedly.
+void CCryptoBoringSSLShims_warm_up_process(void);
+
+// Instantiates and seeds the calling thread's DRBG, and fills its buffer of
+// random bytes if buffering is enabled.
+void CCryptoBoringSSLShims_warm_up_thread(void);
+
 #if defined(__cplusplus)
 }
 #endif // defined(__cplusplus)
@@ -12,8 +12,854 @@
 //
 //===----------------------------------------------------------------------===//
 #include <CCryptoBoringSSLShims.h>
+#include <limits.h>
+#include <string.h>
+
+// Not public headers, so they are included by path.
+#include "../CCryptoBoringSSL/crypto/curve25519/internal.h"
+#include "../CCryptoBoringSSL/crypto/fipsmodule/aes/internal.h"
+#include "../CCryptoBoringSSL/crypto/fipsmodule/bn/internal.h"
+#include "../CCryptoBoringSSL/crypto/fipsmodule/cipher/internal.h"
+#include "../CCryptoBoringSSL/crypto/fipsmodule/ec/internal.h"
+#include "../CCryptoBoringSSL/crypto/fipsmodule/modes/internal.h"
+#include "../CCryptoBoringSSL/crypto/fipsmodule/rsa/internal.h"
+#include "../CCryptoBoringSSL/crypto/internal.h"
+#include "../CCryptoBoringSSL/crypto/keccak/internal.h"
+#include <experimental/CCryptoBoringSSL_kyber.h>
+#include <experimental/CCryptoBoringSSL_spx.h>
+#include "../CCryptoBoringSSL/crypto/spx/address.h"
+#include "../CCryptoBoringSSL/crypto/spx/fors.h"
+#include "../CCryptoBoringSSL/crypto/spx/merkle.h"
+#include "../CCryptoBoringSSL/crypto/spx/params.h"
+#include "../CCryptoBoringSSL/crypto/spx/spx_util.h"
+#include "../CCryptoBoringSSL/crypto/spx/thash.h"
+#include "../CCryptoBoringSSL/crypto/spx/wots.h"
+
+// MARK:- Instrumentation
+
+#if defined(CRYPTO_BORINGSSL_INSTRUMENTATION) && !defined(_WIN32) && \
+    !defined(OPENSSL_NO_THREADS_CORRUPT_MEMORY_AND_LEAK_SECRETS_IF_THREADED)
+#define CCRYPTOBORINGSSLSHIMS_INSTRUMENTATION 1
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+
+enum {
+    CCryptoBoringSSLShims_counters_unregistered = 0,
+    CCryptoBoringSSLShims_counters_registered,
+    // The thread is exiting and its counters have been folded into the retired
+    // totals. Anything counted by later thread destructors goes there directly.
+    CCryptoBoringSSLShims_counters_torn_down,
+};
+
+// The most latency series a thread, or the retired totals, keep. Samples for
+// any further series are dropped.
+#define CCRYPTOBORINGSSLSHIMS_LATENCY_MAX_SERIES 64
+
+struct CCryptoBoringSSLShims_latency_series {
+    CCryptoBoringSSLShims_latency_series_key key;
+    uint64_t buckets[CCryptoBoringSSLShims_LATENCY_BUCKET_COUNT];
+};
+
+// Series are only ever appended, by the owning thread, and published with a
+// release store of `count`, so readers see each series' key before its buckets.
+struct CCryptoBoringSSLShims_latency_table {
+    size_t count;
+    struct CCryptoBoringSSLShims_latency_series *series[CCRYPTOBORINGSSLSHIMS_LATENCY_MAX_SERIES];
+};
+
+struct CCryptoBoringSSLShims_thread_counters {
+    // Only the owning thread writes these, so updates need no read-modify-write,
+    // but they are accessed atomically because other threads read them.
+    uint64_t counts[CCryptoBoringSSLShims_event_count];
+    // Allocated on the thread's first sampled operation, and freed under the
+    // lock when the thread exits.
+    struct CCryptoBoringSSLShims_latency_table *latency;
+    // Operations not sampled since the last sample.
+    uint32_t latency_skipped;
+    struct CCryptoBoringSSLShims_thread_counters *prev;
+    struct CCryptoBoringSSLShims_thread_counters *next;
+    int state;
+};
+
+static _Thread_local struct CCryptoBoringSSLShims_thread_counters CCryptoBoringSSLShims_thread_counters;
+static pthread_mutex_t CCryptoBoringSSLShims_counters_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct CCryptoBoringSSLShims_thread_counters *CCryptoBoringSSLShims_counters_registry = NULL;
+static uint64_t CCryptoBoringSSLShims_retired_counts[CCryptoBoringSSLShims_event_count];
+static pthread_once_t CCryptoBoringSSLShims_counters_once = PTHREAD_ONCE_INIT;
+static pthread_key_t CCryptoBoringSSLShims_counters_key;
+static int CCryptoBoringSSLShims_counters_key_valid = 0;
+static struct CCryptoBoringSSLShims_latency_table CCryptoBoringSSLShims_retired_latency;
+static uint32_t CCryptoBoringSSLShims_latency_interval = 0;
+
+static void CCryptoBoringSSLShims_latency_merge(struct CCryptoBoringSSLShims_latency_table *into,
+                                                const struct CCryptoBoringSSLShims_latency_table *from);
+static void CCryptoBoringSSLShims_latency_free(struct CCryptoBoringSSLShims_latency_table *table);
+
+static void CCryptoBoringSSLShims_counters_thread_exit(void *arg) {
+    struct CCryptoBoringSSLShims_thread_counters *counters = arg;
+    pthread_mutex_lock(&CCryptoBoringSSLShims_counters_lock);
+    for (size_t i = 0; i < CCryptoBoringSSLShims_event_count; i++) {
+        CCryptoBoringSSLShims_retired_counts[i] += counters->counts[i];
+    }
+    if (counters->latency != NULL) {
+        CCryptoBoringSSLShims_latency_merge(&CCryptoBoringSSLShims_retired_latency, counters->latency);
+        CCryptoBoringSSLShims_latency_free(counters->latency);
+        __atomic_store_n(&counters->latency, NULL, __ATOMIC_RELAXED);
+    }
+    if (counters->prev != NULL) {
+        counters->prev->next = counters->next;
+    } else {
+        CCryptoBoringSSLShims_counters_registry = counters->next;
+    }
+    if (counters->next != NULL) {
+        counters->next->prev = counters->prev;
+    }
+    counters->state = CCryptoBoringSSLShims_counters_torn_down;
+    pthread_mutex_unlock(&CCryptoBoringSSLShims_counters_lock);
+}
+
+static void CCryptoBoringSSLShims_counters_fork_prepare(void) {
+    pthread_mutex_lock(&CCryptoBoringSSLShims_counters_lock);
+}
+
+static void CCryptoBoringSSLShims_counters_fork_finish(void) {
+    pthread_mutex_unlock(&CCryptoBoringSSLShims_counters_lock);
+}
+
+static void CCryptoBoringSSLShims_counters_init(void) {
+    CCryptoBoringSSLShims_counters_key_valid =
+        pthread_key_create(&CCryptoBoringSSLShims_counters_key, CCryptoBoringSSLShims_counters_thread_exit) == 0;
+    pthread_atfork(CCryptoBoringSSLShims_counters_fork_prepare,
+                   CCryptoBoringSSLShims_counters_fork_finish,
+                   CCryptoBoringSSLShims_counters_fork_finish);
+}
+
+// Returns the calling thread's counters, registering them on first use.
+static struct CCryptoBoringSSLShims_thread_counters *CCryptoBoringSSLShims_counters_register(void) {
+    struct CCryptoBoringSSLShims_thread_counters *counters = &CCryptoBoringSSLShims_thread_counters;
+    if (counters->state == CCryptoBoringSSLShims_counters_unregistered) {
+        pthread_once(&CCryptoBoringSSLShims_counters_once, CCryptoBoringSSLShims_counters_init);
+        pthread_mutex_lock(&CCryptoBoringSSLShims_counters_lock);
+        if (CCryptoBoringSSLShims_counters_key_valid &&
+            pthread_setspecific(CCryptoBoringSSLShims_counters_key, counters) == 0) {
+            counters->next = CCryptoBoringSSLShims_counters_registry;
+            if (counters->next != NULL) {
+                counters->next->prev = counters;
+            }
+            CCryptoBoringSSLShims_counters_registry = counters;
+            counters->state = CCryptoBoringSSLShims_counters_registered;
+        } else {
+            counters->state = CCryptoBoringSSLShims_counters_torn_down;
+        }
+        pthread_mutex_unlock(&CCryptoBoringSSLShims_counters_lock);
+    }
+    return counters;
+}
+
+// This may be called from BoringSSL's allocation hooks, so it must not call
+// into BoringSSL.
+static void CCryptoBoringSSLShims_instrument(CCryptoBoringSSLShims_event event, uint64_t value) {
+    struct CCryptoBoringSSLShims_thread_counters *counters = CCryptoBoringSSLShims_counters_register();
+    if (counters->state == CCryptoBoringSSLShims_counters_registered) {
+        uint64_t current = __atomic_load_n(&counters->counts[event], __ATOMIC_RELAXED);
+        __atomic_store_n(&counters->counts[event], current + value, __ATOMIC_RELAXED);
+    } else {
+        __atomic_fetch_add(&CCryptoBoringSSLShims_retired_counts[event], value, __ATOMIC_RELAXED);
+    }
+}
+
+int CCryptoBoringSSLShims_instrumentation_enabled(void) {
+    return 1;
+}
+
+void CCryptoBoringSSLShims_instrumentation_thread_counters(uint64_t *out, size_t count) {
+    const struct CCryptoBoringSSLShims_thread_counters *counters = &CCryptoBoringSSLShims_thread_counters;
+    for (size_t i = 0; i < count; i++) {
+        out[i] = i < CCryptoBoringSSLShims_event_count ? counters->counts[i] : 0;
+    }
+}
+
+void CCryptoBoringSSLShims_instrumentation_process_counters(uint64_t *out, size_t count) {
+    uint64_t totals[CCryptoBoringSSLShims_event_count];
+    pthread_mutex_lock(&CCryptoBoringSSLShims_counters_lock);
+    for (size_t i = 0; i < CCryptoBoringSSLShims_event_count; i++) {
+        totals[i] = __atomic_load_n(&CCryptoBoringSSLShims_retired_counts[i], __ATOMIC_RELAXED);
+    }
+    for (const struct CCryptoBoringSSLShims_thread_counters *counters = CCryptoBoringSSLShims_counters_registry;
+         counters != NULL; counters = counters->next) {
+        for (size_t i = 0; i < CCryptoBoringSSLShims_event_count; i++) {
+            totals[i] += __atomic_load_n(&counters->counts[i], __ATOMIC_RELAXED);
+        }
+    }
+    pthread_mutex_unlock(&CCryptoBoringSSLShims_counters_lock);
+
+    for (size_t i = 0; i < count; i++) {
+        out[i] = i < CCryptoBoringSSLShims_event_count ? totals[i] : 0;
+    }
+}
+
+static uint64_t CCryptoBoringSSLShims_latency_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+}
+
+// Returns the time a sampled operation starts, or zero if it isn't sampled.
+static uint64_t CCryptoBoringSSLShims_latency_begin(void) {
+    uint32_t interval = __atomic_load_n(&CCryptoBoringSSLShims_latency_interval, __ATOMIC_RELAXED);
+    if (interval == 0) {
+        return 0;
+    }
+    struct CCryptoBoringSSLShims_thread_counters *counters = &CCryptoBoringSSLShims_thread_counters;
+    if (++counters->latency_skipped < interval) {
+        return 0;
+    }
+    counters->latency_skipped = 0;
+    uint64_t now = CCryptoBoringSSLShims_latency_now();
+    return now == 0 ? 1 : now;
+}
+
+static size_t CCryptoBoringSSLShims_latency_bucket(uint64_t nanoseconds) {
+    if (nanoseconds < 8) {
+        return (size_t)nanoseconds;
+    }
+    if ((nanoseconds >> 36) != 0) {
+        return CCryptoBoringSSLShims_LATENCY_BUCKET_COUNT - 1;
+    }
+    // The top four bits of the value pick the bucket within its power of two.
+    unsigned shift = 60 - (unsigned)__builtin_clzll(nanoseconds);
+    return ((size_t)(shift + 1) << 3) + (size_t)((nanoseconds >> shift) & 7);
+}
+
+static uint64_t CCryptoBoringSSLShims_latency_max_bytes(CCryptoBoringSSLShims_trace_operation operation,
+                                                        uint64_t byte_count) {
+    if (operation != CCryptoBoringSSLShims_trace_aead_seal && operation != CCryptoBoringSSLShims_trace_aead_open) {
+        return 0;
+    }
+    if (byte_count <= 64) {
+        return 64;
+    }
+    if (byte_count <= 1024) {
+        return 1024;
+    }
+    if (byte_count <= 16384) {
+        return 16384;
+    }
+    return UINT64_MAX;
+}
+
+static int CCryptoBoringSSLShims_latency_key_equal(const CCryptoBoringSSLShims_latency_series_key *a,
+                                                   const CCryptoBoringSSLShims_latency_series_key *b) {
+    return a->operation == b->operation && a->algorithm == b->algorithm && a->key_bits == b->key_bits &&
+           a->max_bytes == b->max_bytes;
+}
+
+// Called by the table's owning thread, or with the lock held for the retired
+// table. Returns NULL if the table is full or the allocation fails.
+static struct CCryptoBoringSSLShims_latency_series *CCryptoBoringSSLShims_latency_series_for(
+    struct CCryptoBoringSSLShims_latency_table *table, const CCryptoBoringSSLShims_latency_series_key *key) {
+    size_t count = __atomic_load_n(&table->count, __ATOMIC_RELAXED);
+    for (size_t i = 0; i < count; i++) {
+        if (CCryptoBoringSSLShims_latency_key_equal(&table->series[i]->key, key)) {
+            return table->series[i];
+        }
+    }
+    if (count == CCRYPTOBORINGSSLSHIMS_LATENCY_MAX_SERIES) {
+        return NULL;
+    }
+    struct CCryptoBoringSSLShims_latency_series *series = calloc(1, sizeof(*series));
+    if (series == NULL) {
+        return NULL;
+    }
+    series->key = *key;
+    table->series[count] = series;
+    __atomic_store_n(&table->count, count + 1, __ATOMIC_RELEASE);
+    return series;
+}
+
+// Called with the lock held.
+static void CCryptoBoringSSLShims_latency_merge(struct CCryptoBoringSSLShims_latency_table *into,
+                                                const struct CCryptoBoringSSLShims_latency_table *from) {
+    size_t count = __atomic_load_n(&from->count, __ATOMIC_ACQUIRE);
+    for (size_t i = 0; i < count; i++) {
+        struct CCryptoBoringSSLShims_latency_series *series =
+            CCryptoBoringSSLShims_latency_series_for(into, &from->series[i]->key);
+        if (series == NULL) {
+            continue;
+        }
+        for (size_t j = 0; j < CCryptoBoringSSLShims_LATENCY_BUCKET_COUNT; j++) {
+            series->buckets[j] += __atomic_load_n(&from->series[i]->buckets[j], __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static void CCryptoBoringSSLShims_latency_free(struct CCryptoBoringSSLShims_latency_table *table) {
+    for (size_t i = 0; i < table->count; i++) {
+        free(table->series[i]);
+    }
+    free(table);
+}
+
+static void CCryptoBoringSSLShims_latency_end(CCryptoBoringSSLShims_trace_operation operation, int algorithm,
+                                              int key_bits, uint64_t byte_count, uint64_t start) {
+    if (start == 0) {
+        return;
+    }
+    size_t bucket = CCryptoBoringSSLShims_latency_bucket(CCryptoBoringSSLShims_latency_now() - start);
+    CCryptoBoringSSLShims_latency_series_key key = {
+        operation, algorithm, key_bits, CCryptoBoringSSLShims_latency_max_bytes(operation, byte_count),
+    };
+
+    struct CCryptoBoringSSLShims_thread_counters *counters = CCryptoBoringSSLShims_counters_register();
+    if (counters->state != CCryptoBoringSSLShims_counters_registered) {
+        pthread_mutex_lock(&CCryptoBoringSSLShims_counters_lock);
+        struct CCryptoBoringSSLShims_latency_series *series =
+            CCryptoBoringSSLShims_latency_series_for(&CCryptoBoringSSLShims_retired_latency, &key);
+        if (series != NULL) {
+            series->buckets[bucket]++;
+        }
+        pthread_mutex_unlock(&CCryptoBoringSSLShims_counters_lock);
+        return;
+    }
+
+    struct CCryptoBoringSSLShims_latency_table *table = counters->latency;
+    if (table == NULL) {
+        table = calloc(1, sizeof(*table));
+        if (table == NULL) {
+            return;
+        }
+        __atomic_store_n(&counters->latency, table, __ATOMIC_RELEASE);
+    }
+    struct CCryptoBoringSSLShims_latency_series *series = CCryptoBoringSSLShims_latency_series_for(table, &key);
+    if (series != NULL) {
+        uint64_t current = __atomic_load_n(&series->buckets[bucket], __ATOMIC_RELAXED);
+        __atomic_store_n(&series->buckets[bucket], current + 1, __ATOMIC_RELAXED);
+    }
+}
+
+void CCryptoBoringSSLShims_latency_set_sample_interval(uint32_t interval) {
+    __atomic_store_n(&CCryptoBoringSSLShims_latency_interval, interval, __ATOMIC_RELAXED);
+}
+
+uint32_t CCryptoBoringSSLShims_latency_sample_interval(void) {
+    return __atomic_load_n(&CCryptoBoringSSLShims_latency_interval, __ATOMIC_RELAXED);
+}
+
+// Adds the series in `table` to the `*written` series already in the output,
+// counting those that don't fit in `*missing`. Called with the lock held.
+static void CCryptoBoringSSLShims_latency_read(const struct CCryptoBoringSSLShims_latency_table *table,
+                                               CCryptoBoringSSLShims_latency_series_key *out_keys,
+                                               uint64_t *out_counts, size_t max_series, size_t *written,
+                                               size_t *missing) {
+    size_t count = __atomic_load_n(&table->count, __ATOMIC_ACQUIRE);
+    for (size_t i = 0; i < count; i++) {
+        const struct CCryptoBoringSSLShims_latency_series *series = table->series[i];
+        size_t index = 0;
+        while (index < *written && !CCryptoBoringSSLShims_latency_key_equal(&out_keys[index], &series->key)) {
+            index++;
+        }
+        if (index == *written) {
+            if (*written == max_series) {
+                (*missing)++;
+                continue;
+            }
+            out_keys[index] = series->key;
+            memset(&out_counts[index * CCryptoBoringSSLShims_LATENCY_BUCKET_COUNT], 0,
+                   CCryptoBoringSSLShims_LATENCY_BUCKET_COUNT * sizeof(uint64_t));
+            (*written)++;
+        }
+        uint64_t *counts = &out_counts[index * CCryptoBoringSSLShims_LATENCY_BUCKET_COUNT];
+        for (size_t j = 0; j < CCryptoBoringSSLShims_LATENCY_BUCKET_COUNT; j++) {
+            counts[j] += __atomic_load_n(&series->buckets[j], __ATOMIC_RELAXED);
+        }
+    }
+}
+
+size_t CCryptoBoringSSLShims_latency_histograms(CCryptoBoringSSLShims_latency_series_key *out_keys,
+                                                uint64_t *out_counts, size_t max_series) {
+    size_t written = 0;
+    size_t missing = 0;
+    pthread_mutex_lock(&CCryptoBoringSSLShims_counters_lock);
+    CCryptoBoringSSLShims_latency_read(&CCryptoBoringSSLShims_retired_latency, out_keys, out_counts, max_series,
+                                       &written, &missing);
+    for (const struct CCryptoBoringSSLShims_thread_counters *counters = CCryptoBoringSSLShims_counters_registry;
+         counters != NULL; counters = counters->next) {
+        const struct CCryptoBoringSSLShims_latency_table *table =
+            __atomic_load_n(&counters->latency, __ATOMIC_ACQUIRE);
+        if (table != NULL) {
+            CCryptoBoringSSLShims_latency_read(table, out_keys, out_counts, max_series, &written, &missing);
+        }
+    }
+    pthread_mutex_unlock(&CCryptoBoringSSLShims_counters_lock);
+    return written + missing;
+}
+
+#else
+
+#define CCryptoBoringSSLShims_instrument(event, value) ((void)(event), (void)(value))
+
+int CCryptoBoringSSLShims_instrumentation_enabled(void) {
+    return 0;
+}
+
+void CCryptoBoringSSLShims_instrumentation_thread_counters(uint64_t *out, size_t count) {
+    memset(out, 0, count * sizeof(uint64_t));
+}
+
+void CCryptoBoringSSLShims_instrumentation_process_counters(uint64_t *out, size_t count) {
+    memset(out, 0, count * sizeof(uint64_t));
+}
+
+static inline uint64_t CCryptoBoringSSLShims_latency_begin(void) {
+    return 0;
+}
+
+static inline void CCryptoBoringSSLShims_latency_end(CCryptoBoringSSLShims_trace_operation operation, int algorithm,
+                                                     int key_bits, uint64_t byte_count, uint64_t start) {
+    (void)operation;
+    (void)algorithm;
+    (void)key_bits;
+    (void)byte_count;
+    (void)start;
+}
+
+void CCryptoBoringSSLShims_latency_set_sample_interval(uint32_t interval) {
+    (void)interval;
+}
+
+uint32_t CCryptoBoringSSLShims_latency_sample_interval(void) {
+    return 0;
+}
+
+size_t CCryptoBoringSSLShims_latency_histograms(CCryptoBoringSSLShims_latency_series_key *out_keys,
+                                                uint64_t *out_counts, size_t max_series) {
+    (void)out_keys;
+    (void)out_counts;
+    (void)max_series;
+    return 0;
+}
+
+#endif
+
+uint64_t CCryptoBoringSSLShims_latency_bucket_upper_bound(size_t bucket) {
+    if (bucket < 8) {
+        return bucket;
+    }
+    if (bucket >= CCryptoBoringSSLShims_LATENCY_BUCKET_COUNT) {
+        bucket = CCryptoBoringSSLShims_LATENCY_BUCKET_COUNT - 1;
+    }
+    unsigned shift = (unsigned)(bucket >> 3) - 1;
+    uint64_t mantissa = (bucket & 7) | 8;
+    return ((mantissa + 1) << shift) - 1;
+}
+
+// MARK:- Lightweight locks
+//
+// The locks the shims themselves take. Their critical sections are a handful of
+// pointer updates, where the cost of a pthread_rwlock_t is mostly its own
+// bookkeeping. On Linux this is a single futex word: an uncontended acquisition
+// is one compare-and-swap, and a waiter spins briefly before it sleeps.
+// Elsewhere it is the platform's reader/writer lock. Readers aren't held back
+// for a waiting writer, so read sections must stay short too.
+//
+// With instrumentation compiled in, each lock site counts the acquisitions that
+// had to wait, how many of those slept, and the time spent waiting.
+
+#if defined(__linux__) && !defined(OPENSSL_NO_THREADS_CORRUPT_MEMORY_AND_LEAK_SECRETS_IF_THREADED)
+#define CCRYPTOBORINGSSLSHIMS_FUTEX_LOCK 1
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// The low bits count readers. The writer bit is set while the lock is held for
+// writing, and the sleepers bit while any thread may be asleep on the word;
+// whoever clears it wakes them all.
+#define CCRYPTOBORINGSSLSHIMS_LOCK_WRITER 0x40000000u
+#define CCRYPTOBORINGSSLSHIMS_LOCK_SLEEPERS 0x80000000u
+#define CCRYPTOBORINGSSLSHIMS_LOCK_READERS 0x3fffffffu
+#define CCRYPTOBORINGSSLSHIMS_LOCK_SPINS 100
+
+typedef struct {
+    uint32_t state;
+} CCryptoBoringSSLShims_lock;
+
+#define CCRYPTOBORINGSSLSHIMS_LOCK_INIT { 0 }
+#elif !defined(_WIN32) && !defined(OPENSSL_NO_THREADS_CORRUPT_MEMORY_AND_LEAK_SECRETS_IF_THREADED)
+#include <pthread.h>
+
+typedef struct {
+    pthread_rwlock_t lock;
+} CCryptoBoringSSLShims_lock;
+
+#define CCRYPTOBORINGSSLSHIMS_LOCK_INIT { PTHREAD_RWLOCK_INITIALIZER }
+#else
+typedef struct {
+    CRYPTO_MUTEX lock;
+} CCryptoBoringSSLShims_lock;
+
+#define CCRYPTOBORINGSSLSHIMS_LOCK_INIT { CRYPTO_MUTEX_INIT }
+#endif
+
+#if defined(CCRYPTOBORINGSSLSHIMS_INSTRUMENTATION)
+static CCryptoBoringSSLShims_lock_statistics CCryptoBoringSSLShims_lock_sites[CCryptoBoringSSLShims_lock_site_count];
+
+static uint64_t CCryptoBoringSSLShims_lock_wait_begin(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+}
+
+static void CCryptoBoringSSLShims_lock_wait_end(CCryptoBoringSSLShims_lock_site site, uint64_t start, int slept) {
+    CCryptoBoringSSLShims_lock_statistics *statistics = &CCryptoBoringSSLShims_lock_sites[site];
+    __atomic_fetch_add(&statistics->contended, 1, __ATOMIC_RELAXED);
+    if (slept) {
+        __atomic_fetch_add(&statistics->sleeps, 1, __ATOMIC_RELAXED);
+    }
+    __atomic_fetch_add(&statistics->wait_ns, CCryptoBoringSSLShims_lock_wait_begin() - start, __ATOMIC_RELAXED);
+}
+
+int CCryptoBoringSSLShims_lock_statistics_enabled(void) {
+    return 1;
+}
+
+void CCryptoBoringSSLShims_lock_site_statistics(CCryptoBoringSSLShims_lock_site site,
+                                                CCryptoBoringSSLShims_lock_statistics *out) {
+    memset(out, 0, sizeof(*out));
+    if ((size_t)site >= CCryptoBoringSSLShims_lock_site_count) {
+        return;
+    }
+    const CCryptoBoringSSLShims_lock_statistics *statistics = &CCryptoBoringSSLShims_lock_sites[site];
+    out->contended = __atomic_load_n(&statistics->contended, __ATOMIC_RELAXED);
+    out->sleeps = __atomic_load_n(&statistics->sleeps, __ATOMIC_RELAXED);
+    out->wait_ns = __atomic_load_n(&statistics->wait_ns, __ATOMIC_RELAXED);
+}
+#else
+static inline uint64_t CCryptoBoringSSLShims_lock_wait_begin(void) {
+    return 0;
+}
+
+static inline void CCryptoBoringSSLShims_lock_wait_end(CCryptoBoringSSLShims_lock_site site, uint64_t start,
+                                                       int slept) {
+    (void)site;
+    (void)start;
+    (void)slept;
+}
+
+int CCryptoBoringSSLShims_lock_statistics_enabled(void) {
+    return 0;
+}
+
+void CCryptoBoringSSLShims_lock_site_statistics(CCryptoBoringSSLShims_lock_site site,
+                                                CCryptoBoringSSLShims_lock_statistics *out) {
+    (void)site;
+    memset(out, 0, sizeof(*out));
+}
+#endif
+
+#if defined(CCRYPTOBORINGSSLSHIMS_FUTEX_LOCK)
+static inline void CCryptoBoringSSLShims_lock_pause(void) {
+#if defined(OPENSSL_X86_64) || defined(OPENSSL_X86)
+    __builtin_ia32_pause();
+#elif defined(OPENSSL_AARCH64)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+static void CCryptoBoringSSLShims_lock_wake_all(CCryptoBoringSSLShims_lock *lock) {
+    syscall(SYS_futex, &lock->state, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
+
+// Waits until |lock| can be taken, reading when |write| is zero and writing
+// otherwise.
+static void CCryptoBoringSSLShims_lock_slow(CCryptoBoringSSLShims_lock *lock, int write,
+                                            CCryptoBoringSSLShims_lock_site site) {
+    uint64_t start = CCryptoBoringSSLShims_lock_wait_begin();
+    int slept = 0;
+    unsigned spins = 0;
+    for (;;) {
+        uint32_t state = __atomic_load_n(&lock->state, __ATOMIC_RELAXED);
+        int available = write ? (state & ~CCRYPTOBORINGSSLSHIMS_LOCK_SLEEPERS) == 0
+                              : (state & CCRYPTOBORINGSSLSHIMS_LOCK_WRITER) == 0;
+        if (available) {
+            uint32_t desired = write ? state | CCRYPTOBORINGSSLSHIMS_LOCK_WRITER : state + 1;
+            if (__atomic_compare_exchange_n(&lock->state, &state, desired, 1, __ATOMIC_ACQUIRE,
+                                            __ATOMIC_RELAXED)) {
+                CCryptoBoringSSLShims_lock_wait_end(site, start, slept);
+                return;
+            }
+            continue;
+        }
+        if (spins < CCRYPTOBORINGSSLSHIMS_LOCK_SPINS) {
+            spins++;
+            CCryptoBoringSSLShims_lock_pause();
+            continue;
+        }
+        // Announce the sleep before taking it, so that the holder's release
+        // either sees the bit or changes the word first and the wait returns.
+        if ((state & CCRYPTOBORINGSSLSHIMS_LOCK_SLEEPERS) == 0 &&
+            !__atomic_compare_exchange_n(&lock->state, &state, state | CCRYPTOBORINGSSLSHIMS_LOCK_SLEEPERS, 0,
+                                         __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            continue;
+        }
+        syscall(SYS_futex, &lock->state, FUTEX_WAIT_PRIVATE, state | CCRYPTOBORINGSSLSHIMS_LOCK_SLEEPERS, NULL,
+                NULL, 0);
+        slept = 1;
+    }
+}
+
+static inline void CCryptoBoringSSLShims_lock_read(CCryptoBoringSSLShims_lock *lock,
+                                                   CCryptoBoringSSLShims_lock_site site) {
+    uint32_t state = __atomic_load_n(&lock->state, __ATOMIC_RELAXED);
+    if ((state & CCRYPTOBORINGSSLSHIMS_LOCK_WRITER) != 0 ||
+        !__atomic_compare_exchange_n(&lock->state, &state, state + 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+        CCryptoBoringSSLShims_lock_slow(lock, 0, site);
+    }
+}
+
+static inline void CCryptoBoringSSLShims_unlock_read(CCryptoBoringSSLShims_lock *lock) {
+    uint32_t state = __atomic_sub_fetch(&lock->state, 1, __ATOMIC_RELEASE);
+    // The last reader out wakes any sleepers. If someone takes the lock first,
+    // the bit stays set and their release wakes them instead.
+    if (state == CCRYPTOBORINGSSLSHIMS_LOCK_SLEEPERS &&
+        __atomic_compare_exchange_n(&lock->state, &state, 0, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        CCryptoBoringSSLShims_lock_wake_all(lock);
+    }
+}
+
+static inline void CCryptoBoringSSLShims_lock_write(CCryptoBoringSSLShims_lock *lock,
+                                                    CCryptoBoringSSLShims_lock_site site) {
+    uint32_t state = 0;
+    if (!__atomic_compare_exchange_n(&lock->state, &state, CCRYPTOBORINGSSLSHIMS_LOCK_WRITER, 0, __ATOMIC_ACQUIRE,
+                                     __ATOMIC_RELAXED)) {
+        CCryptoBoringSSLShims_lock_slow(lock, 1, site);
+    }
+}
+
+static inline void CCryptoBoringSSLShims_unlock_write(CCryptoBoringSSLShims_lock *lock) {
+    if ((__atomic_exchange_n(&lock->state, 0, __ATOMIC_RELEASE) & CCRYPTOBORINGSSLSHIMS_LOCK_SLEEPERS) != 0) {
+        CCryptoBoringSSLShims_lock_wake_all(lock);
+    }
+}
+
+static inline void CCryptoBoringSSLShims_lock_init(CCryptoBoringSSLShims_lock *lock) {
+    lock->state = 0;
+}
+
+static inline void CCryptoBoringSSLShims_lock_cleanup(CCryptoBoringSSLShims_lock *lock) {
+    (void)lock;
+}
+#elif !defined(_WIN32) && !defined(OPENSSL_NO_THREADS_CORRUPT_MEMORY_AND_LEAK_SECRETS_IF_THREADED)
+static inline void CCryptoBoringSSLShims_lock_read(CCryptoBoringSSLShims_lock *lock,
+                                                   CCryptoBoringSSLShims_lock_site site) {
+    if (pthread_rwlock_tryrdlock(&lock->lock) != 0) {
+        uint64_t start = CCryptoBoringSSLShims_lock_wait_begin();
+        pthread_rwlock_rdlock(&lock->lock);
+        CCryptoBoringSSLShims_lock_wait_end(site, start, 1);
+    }
+}
+
+static inline void CCryptoBoringSSLShims_unlock_read(CCryptoBoringSSLShims_lock *lock) {
+    pthread_rwlock_unlock(&lock->lock);
+}
+
+static inline void CCryptoBoringSSLShims_lock_write(CCryptoBoringSSLShims_lock *lock,
+                                                    CCryptoBoringSSLShims_lock_site site) {
+    if (pthread_rwlock_trywrlock(&lock->lock) != 0) {
+        uint64_t start = CCryptoBoringSSLShims_lock_wait_begin();
+        pthread_rwlock_wrlock(&lock->lock);
+        CCryptoBoringSSLShims_lock_wait_end(site, start, 1);
+    }
+}
+
+static inline void CCryptoBoringSSLShims_unlock_write(CCryptoBoringSSLShims_lock *lock) {
+    pthread_rwlock_unlock(&lock->lock);
+}
+
+static inline void CCryptoBoringSSLShims_lock_init(CCryptoBoringSSLShims_lock *lock) {
+    pthread_rwlock_init(&lock->lock, NULL);
+}
+
+static inline void CCryptoBoringSSLShims_lock_cleanup(CCryptoBoringSSLShims_lock *lock) {
+    pthread_rwlock_destroy(&lock->lock);
+}
+#else
+// Contention isn't measured here: instrumentation needs pthreads.
+static inline void CCryptoBoringSSLShims_lock_read(CCryptoBoringSSLShims_lock *lock,
+                                                   CCryptoBoringSSLShims_lock_site site) {
+    (void)site;
+    CRYPTO_MUTEX_lock_read(&lock->lock);
+}
+
+static inline void CCryptoBoringSSLShims_unlock_read(CCryptoBoringSSLShims_lock *lock) {
+    CRYPTO_MUTEX_unlock_read(&lock->lock);
+}
+
+static inline void CCryptoBoringSSLShims_lock_write(CCryptoBoringSSLShims_lock *lock,
+                                                    CCryptoBoringSSLShims_lock_site site) {
+    (void)site;
+    CRYPTO_MUTEX_lock_write(&lock->lock);
+}
+
+static inline void CCryptoBoringSSLShims_unlock_write(CCryptoBoringSSLShims_lock *lock) {
+    CRYPTO_MUTEX_unlock_write(&lock->lock);
+}
+
+static inline void CCryptoBoringSSLShims_lock_init(CCryptoBoringSSLShims_lock *lock) {
+    CRYPTO_MUTEX_init(&lock->lock);
+}
+
+static inline void CCryptoBoringSSLShims_lock_cleanup(CCryptoBoringSSLShims_lock *lock) {
+    CRYPTO_MUTEX_cleanup(&lock->lock);
+}
+#endif
+
+// MARK:- Tracepoints
+
+#if defined(CRYPTO_BORINGSSL_TRACEPOINTS) && !defined(_WIN32) && \
+    !defined(OPENSSL_NO_THREADS_CORRUPT_MEMORY_AND_LEAK_SECRETS_IF_THREADED)
+#define CCRYPTOBORINGSSLSHIMS_TRACEPOINTS 1
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define CCRYPTOBORINGSSLSHIMS_USDT 1
+#endif
+#endif
+
+#if defined(CCRYPTOBORINGSSLSHIMS_USDT)
+#define CCRYPTOBORINGSSLSHIMS_PROBE_ENTRY(name, algorithm, key_bits, byte_count) \
+    DTRACE_PROBE3(swift_crypto, name##_entry, algorithm, key_bits, byte_count)
+#define CCRYPTOBORINGSSLSHIMS_PROBE_RETURN(name, algorithm, key_bits, byte_count, result) \
+    DTRACE_PROBE4(swift_crypto, name##_return, algorithm, key_bits, byte_count, result)
+#else
+#define CCRYPTOBORINGSSLSHIMS_PROBE_ENTRY(name, algorithm, key_bits, byte_count) ((void)0)
+#define CCRYPTOBORINGSSLSHIMS_PROBE_RETURN(name, algorithm, key_bits, byte_count, result) ((void)0)
+#endif
+
+static CCryptoBoringSSLShims_trace_hook CCryptoBoringSSLShims_trace_hook_function = NULL;
+
+static void CCryptoBoringSSLShims_trace(CCryptoBoringSSLShims_trace_operation operation, int is_return,
+                                        int algorithm, int key_bits, uint64_t byte_count, int result) {
+    CCryptoBoringSSLShims_trace_hook hook =
+        __atomic_load_n(&CCryptoBoringSSLShims_trace_hook_function, __ATOMIC_ACQUIRE);
+    if (hook != NULL) {
+        hook(operation, is_return, algorithm, key_bits, byte_count, result);
+    }
+}
+
+int CCryptoBoringSSLShims_tracepoints_enabled(void) {
+    return 1;
+}
+
+void CCryptoBoringSSLShims_set_trace_hook(CCryptoBoringSSLShims_trace_hook hook) {
+    __atomic_store_n(&CCryptoBoringSSLShims_trace_hook_function, hook, __ATOMIC_RELEASE);
+}
+
+#else
+
+#define CCRYPTOBORINGSSLSHIMS_PROBE_ENTRY(name, algorithm, key_bits, byte_count) ((void)0)
+#define CCRYPTOBORINGSSLSHIMS_PROBE_RETURN(name, algorithm, key_bits, byte_count, result) ((void)0)
+
+static inline void CCryptoBoringSSLShims_trace(CCryptoBoringSSLShims_trace_operation operation, int is_return,
+                                               int algorithm, int key_bits, uint64_t byte_count, int result) {
+    (void)operation;
+    (void)is_return;
+    (void)algorithm;
+    (void)key_bits;
+    (void)byte_count;
+    (void)result;
+}
+
+int CCryptoBoringSSLShims_tracepoints_enabled(void) {
+    return 0;
+}
+
+void CCryptoBoringSSLShims_set_trace_hook(CCryptoBoringSSLShims_trace_hook hook) {
+    (void)hook;
+}
+
+#endif
+
+// The trace sites below feed both the tracepoints and the latency histograms,
+// so they are compiled in when either is.
+#if defined(CCRYPTOBORINGSSLSHIMS_TRACEPOINTS) || defined(CCRYPTOBORINGSSLSHIMS_INSTRUMENTATION)
+
+// TRACE_ENTRY declares the operation's start time, so it must be a statement of
+// its own at the top of the block that contains the matching TRACE_RETURN.
+#define CCRYPTOBORINGSSLSHIMS_TRACE_ENTRY(name, algorithm, key_bits, byte_count)                                   \
+    uint64_t CCryptoBoringSSLShims_trace_start = CCryptoBoringSSLShims_latency_begin();                            \
+    do {                                                                                                           \
+        int CCryptoBoringSSLShims_trace_algorithm = (int)(algorithm);                                              \
+        int CCryptoBoringSSLShims_trace_key_bits = (int)(key_bits);                                                \
+        uint64_t CCryptoBoringSSLShims_trace_byte_count = (uint64_t)(byte_count);                                  \
+        CCRYPTOBORINGSSLSHIMS_PROBE_ENTRY(name, CCryptoBoringSSLShims_trace_algorithm,                             \
+                                          CCryptoBoringSSLShims_trace_key_bits,                                    \
+                                          CCryptoBoringSSLShims_trace_byte_count);                                 \
+        CCryptoBoringSSLShims_trace(CCryptoBoringSSLShims_trace_##name, 0, CCryptoBoringSSLShims_trace_algorithm,  \
+                                    CCryptoBoringSSLShims_trace_key_bits,                                          \
+                                    CCryptoBoringSSLShims_trace_byte_count, 0);                                    \
+    } while (0)
+#define CCRYPTOBORINGSSLSHIMS_TRACE_RETURN(name, algorithm, key_bits, byte_count, result)                          \
+    do {                                                                                                           \
+        int CCryptoBoringSSLShims_trace_algorithm = (int)(algorithm);                                              \
+        int CCryptoBoringSSLShims_trace_key_bits = (int)(key_bits);                                                \
+        uint64_t CCryptoBoringSSLShims_trace_byte_count = (uint64_t)(byte_count);                                  \
+        int CCryptoBoringSSLShims_trace_result = (int)(result);                                                    \
+        CCryptoBoringSSLShims_latency_end(CCryptoBoringSSLShims_trace_##name, CCryptoBoringSSLShims_trace_algorithm, \
+                                          CCryptoBoringSSLShims_trace_key_bits,                                    \
+                                          CCryptoBoringSSLShims_trace_byte_count,                                  \
+                                          CCryptoBoringSSLShims_trace_start);                                      \
+        CCRYPTOBORINGSSLSHIMS_PROBE_RETURN(name, CCryptoBoringSSLShims_trace_algorithm,                            \
+                                           CCryptoBoringSSLShims_trace_key_bits,                                   \
+                                           CCryptoBoringSSLShims_trace_byte_count,                                 \
+                                           CCryptoBoringSSLShims_trace_result);                                    \
+        CCryptoBoringSSLShims_trace(CCryptoBoringSSLShims_trace_##name, 1, CCryptoBoringSSLShims_trace_algorithm,  \
+                                    CCryptoBoringSSLShims_trace_key_bits,                                          \
+                                    CCryptoBoringSSLShims_trace_byte_count, CCryptoBoringSSLShims_trace_result);   \
+    } while (0)
+
+// The algorithm reported for an AEAD operation.
+static int CCryptoBoringSSLShims_trace_aead_nid(const EVP_AEAD_CTX *ctx) {
+    const EVP_AEAD *aead = ctx->aead;
+    if (aead == CCryptoBoringSSL_EVP_aead_aes_128_gcm()) {
+        return NID_aes_128_gcm;
+    }
+    if (aead == CCryptoBoringSSL_EVP_aead_aes_192_gcm()) {
+        return NID_aes_192_gcm;
+    }
+    if (aead == CCryptoBoringSSL_EVP_aead_aes_256_gcm()) {
+        return NID_aes_256_gcm;
+    }
+    if (aead == CCryptoBoringSSL_EVP_aead_chacha20_poly1305()) {
+        return NID_chacha20_poly1305;
+    }
+    return NID_undef;
+}
+
+static int CCryptoBoringSSLShims_trace_aead_key_bits(const EVP_AEAD_CTX *ctx) {
+    return (int)(8 * CCryptoBoringSSL_EVP_AEAD_key_length(ctx->aead));
+}
+
+static int CCryptoBoringSSLShims_trace_ec_key_nid(const EC_KEY *key) {
+    return CCryptoBoringSSL_EC_GROUP_get_curve_name(CCryptoBoringSSL_EC_KEY_get0_group(key));
+}
+
+static int CCryptoBoringSSLShims_trace_ec_key_bits(const EC_KEY *key) {
+    return (int)CCryptoBoringSSL_EC_GROUP_get_degree(CCryptoBoringSSL_EC_KEY_get0_group(key));
+}
+
+#else
+
+#define CCRYPTOBORINGSSLSHIMS_TRACE_ENTRY(name, algorithm, key_bits, byte_count) ((void)0)
+#define CCRYPTOBORINGSSLSHIMS_TRACE_RETURN(name, algorithm, key_bits, byte_count, result) ((void)0)
+
+#endif
 
 // MARK:- Pointer type shims
+// Defined with the mirror of e_aes.c's context, under "Streaming AEAD".
+static void CCryptoBoringSSLShims_aead_aes_gcm_use_shim_ctr(EVP_AEAD_CTX *ctx, const void *key, size_t key_len);
+
 // This section of the code handles shims that change uint8_t* pointers to
 // void *s. This is done because Swift does not have the rule that C does, that
 // pointers to uint8_t can safely alias any other pointer. That means that Swift
@@ -27,7 +873,19 @@
 int CCryptoBoringSSLShims_EVP_AEAD_CTX_init(EVP_AEAD_CTX *ctx, const EVP_AEAD *aead,
                                             const void *key, size_t key_len, size_t tag_len,
                                             ENGINE *impl) {
-    return CCryptoBoringSSL_EVP_AEAD_CTX_init(ctx, aead, key, key_len, tag_len, impl);
+    if (!CCryptoBoringSSL_EVP_AEAD_CTX_init(ctx, aead, key, key_len, tag_len, impl)) {
+        return 0;
+    }
+    CCryptoBoringSSLShims_aead_aes_gcm_use_shim_ctr(ctx, key, key_len);
+    return 1;
+}
+
+static void CCryptoBoringSSLShims_instrument_open(int result, size_t in_len) {
+    CCryptoBoringSSLShims_instrument(CCryptoBoringSSLShims_event_aead_opens, 1);
+    CCryptoBoringSSLShims_instrument(CCryptoBoringSSLShims_event_aead_opened_bytes, in_len);
+    if (result != 1) {
+        CCryptoBoringSSLShims_instrument(CCryptoBoringSSLShims_event_aead_open_failures, 1);
+    }
 }
 
 int CCryptoBoringSSLShims_EVP_AEAD_CTX_seal_scatter(
@@ -44,7 +902,14 @@ int CCryptoBoringSSLShims_EVP_AEAD_CTX_seal_scatter(
     size_t extra_in_len,
     const void *ad,
     size_t ad_len) {
-    return CCryptoBoringSSL_EVP_AEAD_CTX_seal_scatter(ctx, out, out_tag, out_tag_len, max_out_tag_len, nonce, nonce_len, in, in_len, extra_in, extra_in_len, ad, ad_len);
+    CCryptoBoringSSLShims_instrument(CCryptoBoringSSLShims_event_aead_seals, 1);
+    CCryptoBoringSSLShims_instrument(CCryptoBoringSSLShims_event_aead_sealed_bytes, in_len + extra_in_len);
+    CCRYPTOBORINGSSLSHIMS_TRACE_ENTRY(aead_seal, CCryptoBoringSSLShims_trace_aead_nid(ctx),
+                                      CCryptoBoringSSLShims_trace_aead_key_bits(ctx), in_len + extra_in_len);
+    int result = CCryptoBoringSSL_EVP_AEAD_CTX_seal_scatter(ctx, out, out_tag, out_tag_len, max_out_tag_len, nonce, nonce_len, in, in_len, extra_in, extra_in_len, ad, ad_len);
+    CCRYPTOBORINGSSLSHIMS_TRACE_RETURN(aead_seal, CCryptoBoringSSLShims_trace_aead_nid(ctx),
+                                       CCryptoBoringSSLShims_trace_aead_key_bits(ctx), in_len + extra_in_len, result);
+    return result;
 }
 
 int CCryptoBoringSSLShims_EVP_AEAD_CTX_open_gather(const EVP_AEAD_CTX *ctx, void *out,
@@ -52,62 +917,211 @@ int CCryptoBoringSSLShims_EVP_AEAD_CTX_open_gather(const EVP_AEAD_CTX *ctx, void
                                                    const void *in, size_t in_len,
                                                    const void *in_tag, size_t in_tag_len,
                                                    const void *ad, size_t ad_len) {
-    return CCryptoBoringSSL_EVP_AEAD_CTX_open_gather(ctx, out, nonce, nonce_len, in, in_len, in_tag, in_tag_len, ad, ad_len);
+    CCRYPTOBORINGSSLSHIMS_TRACE_ENTRY(aead_open, CCryptoBoringSSLShims_trace_aead_nid(ctx),
+                                      CCryptoBoringSSLShims_trace_aead_key_bits(ctx), in_len);
+    int result = CCryptoBoringSSL_EVP_AEAD_CTX_open_gather(ctx, out, nonce, nonce_len, in, in_len, in_tag, in_tag_len, ad, ad_len);
+    CCRYPTOBORINGSSLSHIMS_TRACE_RETURN(aead_open, CCryptoBoringSSLShims_trace_aead_nid(ctx),
+                                       CCryptoBoringSSLShims_trace_aead_key_bits(ctx), in_len, result);
+    CCryptoBoringSSLShims_instrument_open(result, in_len);
+    return result;
 }
 
 int CCryptoBoringSSLShims_EVP_AEAD_CTX_open(const EVP_AEAD_CTX *ctx, void *out, size_t *out_len, size_t max_out_len,
                                                    const void *nonce, size_t nonce_len,
                                                    const void *in, size_t in_len,
                                                    const void *ad, size_t ad_len) {
-    return CCryptoBoringSSL_EVP_AEAD_CTX_open(ctx, out, out_len, max_out_len, nonce, nonce_len, in, in_len, ad, ad_len);
+    CCRYPTOBORINGSSLSHIMS_TRACE_ENTRY(aead_open, CCryptoBoringSSLShims_trace_aead_nid(ctx),
+                                      CCryptoBoringSSLShims_trace_aead_key_bits(ctx), in_len);
+    int result = CCryptoBoringSSL_EVP_AEAD_CTX_open(ctx, out, out_len, max_out_len, nonce, nonce_len, in, in_len, ad, ad_len);
+    CCRYPTOBORINGSSLSHIMS_TRACE_RETURN(aead_open, CCryptoBoringSSLShims_trace_aead_nid(ctx),
+                                       CCryptoBoringSSLShims_trace_aead_key_bits(ctx), in_len, result);
+    CCryptoBoringSSLShims_instrument_open(result, in_len);
+    return result;
+}
+
+void CCryptoBoringSSLShims_EVP_DigestUpdate(EVP_MD_CTX *ctx, const void *data, size_t len) {
+    CCryptoBoringSSLShims_instrument(CCryptoBoringSSLShims_event_digest_updates, 1);
+    CCryptoBoringSSLShims_instrument(CCryptoBoringSSLShims_event_digested_bytes, len);
+    CCryptoBoringSSL_EVP_DigestUpdate(ctx, data, len);
+}
+
+#if defined(CRYPTO_BORINGSSL_INSTRUMENTATION)
+void CCryptoBoringSSLShims_count_digest_update(size_t len) {
+    CCryptoBoringSSLShims_instrument(CCryptoBoringSSLShims_event_digest_updates, 1);
+    CCryptoBoringSSLShims_instrument(CCryptoBoringSSLShims_event_digested_bytes, len);
 }
+#endif
+
+size_t CCryptoBoringSSLShims_EVP_AEAD_CTX_seal_batch(const EVP_AEAD_CTX *ctx,
+                                                     CCryptoBoringSSLShims_AEAD_batch_op *ops,
+                                                     size_t ops_count) {
+    size_t failures = 0;
+    for (size_t i = 0; i < ops_count; i++) {
+        CCryptoBoringSSLShims_AEAD_batch_op *op = &ops[i];
+        size_t max_tag_len = op->tag_len;
+        CCryptoBoringSSLShims_instrument(CCryptoBoringSSLShims_event_aead_seals, 1);
+        CCryptoBoringSSLShims_instrument(CCryptoBoringSSLShims_event_aead_sealed_bytes, op->in_len);
+        CCRYPTOBORINGSSLSHIMS_TRACE_ENTRY(aead_seal, CCryptoBoringSSLShims_trace_aead_nid(ctx),
+                                          CCryptoBoringSSLShims_trace_aead_key_bits(ctx), op->in_len);
+        op->result = CCryptoBoringSSL_EVP_AEAD_CTX_seal_scatter(ctx, op->out, op->tag, &op->tag_len, max_tag_len,
+                                                                op->nonce, op->nonce_len, op->in, op->in_len,
+                                                                NULL, 0, op->ad, op->ad_len);
+        CCRYPTOBORINGSSLSHIMS_TRACE_RETURN(aead_seal, CCryptoBoringSSLShims_trace_aead_nid(ctx),
+                                           CCryptoBoringSSLShims_trace_aead_key_bits(ctx), op->in_len, op->result);
+        if (op->result != 1) {
+            failures++;
+        }
+    }
+    return failures;
+}
+
+size_t CCryptoBoringSSLShims_EVP_AEAD_CTX_open_batch(const EVP_AEAD_CTX *ctx,
+                                                     CCryptoBoringSSLShims_AEAD_batch_op *ops,
+                                                     size_t ops_count) {
+    size_t failures = 0;
+    for (size_t i = 0; i < ops_count; i++) {
+        CCryptoBoringSSLShims_AEAD_batch_op *op = &ops[i];
+        CCRYPTOBORINGSSLSHIMS_TRACE_ENTRY(aead_open, CCryptoBoringSSLShims_trace_aead_nid(ctx),
+                                          CCryptoBoringSSLShims_trace_aead_key_bits(ctx), op->in_len);
+        op->result = CCryptoBoringSSL_EVP_AEAD_CTX_open_gather(ctx, op->out, op->nonce, op->nonce_len,
+                                                               op->in, op->in_len, op->tag, op->tag_len,
+                                                               op->ad, op->ad_len);
+        CCRYPTOBORINGSSLSHIMS_TRACE_RETURN(aead_open, CCryptoBoringSSLShims_trace_aead_nid(ctx),
+                                           CCryptoBoringSSLShims_trace_aead_key_bits(ctx), op->in_len, op->result);
+        CCryptoBoringSSLShims_instrument_open(op->result, op->in_len);
+        if (op->result != 1) {
+            failures++;
+        }
+    }
+    return failures;
+}
+
+int CCryptoBoringSSLShims_HKDF(void *out_key, size_t out_len, const EVP_MD *digest,
+                               const void *secret, size_t secret_len,
+                               const void *salt, size_t salt_len,
+                               const void *info, size_t info_len) {
+    return CCryptoBoringSSL_HKDF(out_key, out_len, digest, secret, secret_len, salt, salt_len, info, info_len);
+}
+
+// Defined under "Fixed-base Ed25519 multiplication".
+static void CCryptoBoringSSLShims_ed25519_scalarmult_base(ge_p3 *h, const uint8_t a[32]);
+static void CCryptoBoringSSLShims_x25519_public_from_private(uint8_t out[32], const uint8_t private_key[32]);
 
 void CCryptoBoringSSLShims_ED25519_keypair(void *out_public_key, void *out_private_key) {
-    CCryptoBoringSSL_ED25519_keypair(out_public_key, out_private_key);
+    uint8_t seed[32];
+    CCryptoBoringSSL_RAND_bytes(seed, sizeof(seed));
+    CCryptoBoringSSLShims_ED25519_keypair_from_seed(out_public_key, out_private_key, seed);
+    CCryptoBoringSSL_OPENSSL_cleanse(seed, sizeof(seed));
 }
 
+// ED25519_keypair_from_seed, with the fixed-base multiplication of the shims.
 void CCryptoBoringSSLShims_ED25519_keypair_from_seed(void *out_public_key,
                                                      void *out_private_key,
                                                      const void *seed) {
-    CCryptoBoringSSL_ED25519_keypair_from_seed(out_public_key, out_private_key, seed);
+    uint8_t az[SHA512_DIGEST_LENGTH];
+    CCryptoBoringSSL_SHA512(seed, 32, az);
+    az[0] &= 248;
+    az[31] &= 127;
+    az[31] |= 64;
+
+    ge_p3 A;
+    ge_p2 A_projective;
+    CCryptoBoringSSLShims_ed25519_scalarmult_base(&A, az);
+    CCryptoBoringSSL_OPENSSL_cleanse(az, sizeof(az));
+    memcpy(&A_projective, &A, sizeof(A_projective));
+    CCryptoBoringSSL_x25519_ge_tobytes(out_public_key, &A_projective);
+    // The public key is derived from the private key, but it is public.
+    CONSTTIME_DECLASSIFY(out_public_key, 32);
+
+    memcpy(out_private_key, seed, 32);
+    memcpy((uint8_t *)out_private_key + 32, out_public_key, 32);
 }
 
 ECDSA_SIG *CCryptoBoringSSLShims_ECDSA_do_sign(const void *digest, size_t digest_len,
                                                const EC_KEY *eckey) {
-    return CCryptoBoringSSL_ECDSA_do_sign(digest, digest_len, eckey);
+    CCRYPTOBORINGSSLSHIMS_TRACE_ENTRY(ecdsa_sign, CCryptoBoringSSLShims_trace_ec_key_nid(eckey),
+                                      CCryptoBoringSSLShims_trace_ec_key_bits(eckey), digest_len);
+    ECDSA_SIG *sig = CCryptoBoringSSL_ECDSA_do_sign(digest, digest_len, eckey);
+    CCRYPTOBORINGSSLSHIMS_TRACE_RETURN(ecdsa_sign, CCryptoBoringSSLShims_trace_ec_key_nid(eckey),
+                                       CCryptoBoringSSLShims_trace_ec_key_bits(eckey), digest_len, sig != NULL);
+    return sig;
 }
 
 int CCryptoBoringSSLShims_ECDSA_do_verify(const void *digest, size_t digest_len,
                                           const ECDSA_SIG *sig, const EC_KEY *eckey) {
-    return CCryptoBoringSSL_ECDSA_do_verify(digest, digest_len, sig, eckey);
+    CCRYPTOBORINGSSLSHIMS_TRACE_ENTRY(ecdsa_verify, CCryptoBoringSSLShims_trace_ec_key_nid(eckey),
+                                      CCryptoBoringSSLShims_trace_ec_key_bits(eckey), digest_len);
+    int result = CCryptoBoringSSL_ECDSA_do_verify(digest, digest_len, sig, eckey);
+    CCRYPTOBORINGSSLSHIMS_TRACE_RETURN(ecdsa_verify, CCryptoBoringSSLShims_trace_ec_key_nid(eckey),
+                                       CCryptoBoringSSLShims_trace_ec_key_bits(eckey), digest_len, result);
+    return result;
 }
 
+// X25519_keypair, with the fixed-base multiplication of the shims.
 void CCryptoBoringSSLShims_X25519_keypair(void *out_public_value, void *out_private_key) {
-    CCryptoBoringSSL_X25519_keypair(out_public_value, out_private_key);
+    uint8_t *private_key = out_private_key;
+    CCryptoBoringSSL_RAND_bytes(private_key, 32);
+    // The opposite of the clamping, as BoringSSL does, so that peers which
+    // don't clamp fail deterministically.
+    private_key[0] |= ~248;
+    private_key[31] &= ~64;
+    private_key[31] |= ~127;
+    CCryptoBoringSSLShims_x25519_public_from_private(out_public_value, private_key);
 }
 
 void CCryptoBoringSSLShims_X25519_public_from_private(void *out_public_value,
                                                       const void *private_key) {
-    CCryptoBoringSSL_X25519_public_from_private(out_public_value, private_key);
+    CCryptoBoringSSLShims_x25519_public_from_private(out_public_value, private_key);
 }
 
 int CCryptoBoringSSLShims_X25519(void *out_shared_key, const void *private_key,
                                  const void *peer_public_value) {
-    return CCryptoBoringSSL_X25519(out_shared_key, private_key, peer_public_value);
+    CCRYPTOBORINGSSLSHIMS_TRACE_ENTRY(x25519, NID_X25519, 256, 32);
+    int result = CCryptoBoringSSL_X25519(out_shared_key, private_key, peer_public_value);
+    CCRYPTOBORINGSSLSHIMS_TRACE_RETURN(x25519, NID_X25519, 256, 32, result);
+    return result;
 }
 
 ECDSA_SIG *CCryptoBoringSSLShims_ECDSA_SIG_from_bytes(const void *in, size_t in_len) {
     return CCryptoBoringSSL_ECDSA_SIG_from_bytes(in, in_len);
 }
 
+static int CCryptoBoringSSLShims_ed25519_wide_table_enabled(void);
+
 int CCryptoBoringSSLShims_ED25519_verify(const void *message, size_t message_len,
                                          const void *signature, const void *public_key) {
-    return CCryptoBoringSSL_ED25519_verify(message, message_len, signature, public_key);
+    CCRYPTOBORINGSSLSHIMS_TRACE_ENTRY(ed25519_verify, NID_ED25519, 256, message_len);
+    int result;
+    if (CCryptoBoringSSLShims_ed25519_wide_table_enabled()) {
+        // The same checks as |ED25519_verify|, ending with the wide table.
+        CCryptoBoringSSLShims_ED25519_VERIFY_CTX ctx;
+        CCryptoBoringSSLShims_ED25519_verify_init(&ctx, signature, public_key);
+        CCryptoBoringSSLShims_ED25519_verify_update(&ctx, message, message_len);
+        result = CCryptoBoringSSLShims_ED25519_verify_final(&ctx);
+    } else {
+        result = CCryptoBoringSSL_ED25519_verify(message, message_len, signature, public_key);
+    }
+    CCRYPTOBORINGSSLSHIMS_TRACE_RETURN(ed25519_verify, NID_ED25519, 256, message_len, result);
+    return result;
 }
 
 int CCryptoBoringSSLShims_ED25519_sign(void *out_sig, const void *message,
                                        size_t message_len, const void *private_key) {
-    return CCryptoBoringSSL_ED25519_sign(out_sig, message, message_len, private_key);
+    CCRYPTOBORINGSSLSHIMS_TRACE_ENTRY(ed25519_sign, NID_ED25519, 256, message_len);
+    int result = CCryptoBoringSSL_ED25519_sign(out_sig, message, message_len, private_key);
+    CCRYPTOBORINGSSLSHIMS_TRACE_RETURN(ed25519_sign, NID_ED25519, 256, message_len, result);
+    return result;
+}
+
+size_t CCryptoBoringSSLShims_ED25519_verify_batch(const CCryptoBoringSSLShims_ED25519_verify_batch_op *ops,
+                                                  size_t ops_count, int *results) {
+    size_t valid = 0;
+    for (size_t i = 0; i < ops_count; i++) {
+        results[i] = CCryptoBoringSSLShims_ED25519_verify(ops[i].message, ops[i].message_len,
+                                                          ops[i].signature, ops[i].public_key);
+        valid += (size_t)results[i];
+    }
+    return valid;
 }
 
 BIGNUM *CCryptoBoringSSLShims_BN_bin2bn(const void *in, size_t len, BIGNUM *ret) {
@@ -120,27 +1134,48 @@ size_t CCryptoBoringSSLShims_BN_bn2bin(const BIGNUM *in, void *out) {
 
 int CCryptoBoringSSLShims_RSA_verify(int hash_nid, const void *msg, size_t msg_len,
                                      const void *sig, size_t sig_len, RSA *rsa) {
-    return CCryptoBoringSSL_RSA_verify(hash_nid, msg, msg_len, sig, sig_len, rsa);
+    CCRYPTOBORINGSSLSHIMS_TRACE_ENTRY(rsa_verify, hash_nid, CCryptoBoringSSL_RSA_bits(rsa), msg_len);
+    int result = CCryptoBoringSSL_RSA_verify(hash_nid, msg, msg_len, sig, sig_len, rsa);
+    CCRYPTOBORINGSSLSHIMS_TRACE_RETURN(rsa_verify, hash_nid, CCryptoBoringSSL_RSA_bits(rsa), msg_len, result);
+    return result;
 }
 
 int CCryptoBoringSSLShims_RSA_verify_pss_mgf1(RSA *rsa, const void *msg,
                                               size_t msg_len, const EVP_MD *md,
                                               const EVP_MD *mgf1_md, int salt_len,
                                               const void *sig, size_t sig_len) {
-    return CCryptoBoringSSL_RSA_verify_pss_mgf1(rsa, msg, msg_len, md, mgf1_md, salt_len, sig, sig_len);
+    CCRYPTOBORINGSSLSHIMS_TRACE_ENTRY(rsa_verify, CCryptoBoringSSL_EVP_MD_type(md),
+                                      CCryptoBoringSSL_RSA_bits(rsa), msg_len);
+    int result = CCryptoBoringSSL_RSA_verify_pss_mgf1(rsa, msg, msg_len, md, mgf1_md, salt_len, sig, sig_len);
+    CCRYPTOBORINGSSLSHIMS_TRACE_RETURN(rsa_verify, CCryptoBoringSSL_EVP_MD_type(md),
+                                       CCryptoBoringSSL_RSA_bits(rsa), msg_len, result);
+    return result;
 }
 
 int CCryptoBoringSSLShims_RSA_sign(int hash_nid, const void *in,
                                    unsigned int in_len, void *out,
                                    unsigned int *out_len, RSA *rsa) {
-    return CCryptoBoringSSL_RSA_sign(hash_nid, in, in_len, out, out_len, rsa);
+    CCRYPTOBORINGSSLSHIMS_TRACE_ENTRY(rsa_sign, hash_nid, CCryptoBoringSSL_RSA_bits(rsa), in_len);
+    int result = CCryptoBoringSSL_RSA_sign(hash_nid, in, in_len, out, out_len, rsa);
+    CCRYPTOBORINGSSLSHIMS_TRACE_RETURN(rsa_sign, hash_nid, CCryptoBoringSSL_RSA_bits(rsa), in_len, result);
+    return result;
 }
 
 int CCryptoBoringSSLShims_RSA_sign_pss_mgf1(RSA *rsa, size_t *out_len, void *out,
                                             size_t max_out, const void *in,
                                             size_t in_len, const EVP_MD *md,
                                             const EVP_MD *mgf1_md, int salt_len) {
-    return CCryptoBoringSSL_RSA_sign_pss_mgf1(rsa, out_len, out, max_out, in, in_len, md, mgf1_md, salt_len);
+    CCRYPTOBORINGSSLSHIMS_TRACE_ENTRY(rsa_sign, CCryptoBoringSSL_EVP_MD_type(md),
+                                      CCryptoBoringSSL_RSA_bits(rsa), in_len);
+    const size_t rsa_size = CCryptoBoringSSL_RSA_size(rsa);
+    uint8_t *padded = in_len == CCryptoBoringSSL_EVP_MD_size(md) ? OPENSSL_malloc(rsa_size) : NULL;
+    int result = padded != NULL &&
+                 CCryptoBoringSSLShims_RSA_padding_add_PKCS1_PSS_mgf1(rsa, padded, in, md, mgf1_md, salt_len) &&
+                 CCryptoBoringSSL_RSA_sign_raw(rsa, out_len, out, max_out, padded, rsa_size, RSA_NO_PADDING);
+    OPENSSL_free(padded);
+    CCRYPTOBORINGSSLSHIMS_TRACE_RETURN(rsa_sign, CCryptoBoringSSL_EVP_MD_type(md),
+                                       CCryptoBoringSSL_RSA_bits(rsa), in_len, result);
+    return result;
 }
 
 int CCryptoBoringSSLShims_RSA_public_encrypt(int flen, const void *from, void *to,
@@ -164,3 +1199,15881 @@ int CCryptoBoringSSLShims_EVP_PKEY_decrypt(EVP_PKEY_CTX *ctx, void *out,
                                            size_t in_len) {
     return CCryptoBoringSSL_EVP_PKEY_decrypt(ctx, out, out_len, in, in_len);
 }
+
+// MARK:- Buffered random bytes
+
+#if defined(__linux__) && !defined(OPENSSL_NO_THREADS_CORRUPT_MEMORY_AND_LEAK_SECRETS_IF_THREADED)
+#define CCRYPTOBORINGSSLSHIMS_RAND_NODE_LOCAL 1
+#include <pthread.h>
+#include <sys/mman.h>
+#endif
+
+#define CCRYPTOBORINGSSLSHIMS_RAND_BUFFER_SIZE 4096
+#define CCRYPTOBORINGSSLSHIMS_RAND_BUFFER_MAX_REQUEST 256
+
+// Declared in crypto/fipsmodule/rand/fork_detect.h, which is not a public
+// header. It returns zero when fork detection is unavailable.
+uint64_t CCryptoBoringSSL_CRYPTO_get_fork_generation(void);
+
+struct CCryptoBoringSSLShims_rand_buffer {
+#if defined(CCRYPTOBORINGSSLSHIMS_RAND_NODE_LOCAL)
+    // Static TLS is set up by the thread that creates this one, so on a NUMA
+    // machine it may sit on another node. The bytes are instead mapped by the
+    // owning thread on first use, which under the default first-touch policy
+    // places them on that thread's node.
+    uint8_t *bytes;
+#else
+    uint8_t bytes[CCRYPTOBORINGSSLSHIMS_RAND_BUFFER_SIZE];
+#endif
+    size_t offset;
+    uint64_t fork_generation;
+};
+
+static int CCryptoBoringSSLShims_rand_buffering = 0;
+
+// Starts out empty, so the first request on each thread fills it.
+static _Thread_local struct CCryptoBoringSSLShims_rand_buffer CCryptoBoringSSLShims_thread_rand_buffer = {
+    .offset = CCRYPTOBORINGSSLSHIMS_RAND_BUFFER_SIZE,
+};
+
+#if defined(CCRYPTOBORINGSSLSHIMS_RAND_NODE_LOCAL)
+static pthread_once_t CCryptoBoringSSLShims_rand_buffer_once = PTHREAD_ONCE_INIT;
+static pthread_key_t CCryptoBoringSSLShims_rand_buffer_key;
+static int CCryptoBoringSSLShims_rand_buffer_key_valid = 0;
+
+static void CCryptoBoringSSLShims_rand_buffer_thread_exit(void *bytes) {
+    CCryptoBoringSSL_OPENSSL_cleanse(bytes, CCRYPTOBORINGSSLSHIMS_RAND_BUFFER_SIZE);
+    munmap(bytes, CCRYPTOBORINGSSLSHIMS_RAND_BUFFER_SIZE);
+    // Later thread destructors that ask for random bytes map a fresh buffer.
+    CCryptoBoringSSLShims_thread_rand_buffer.bytes = NULL;
+    CCryptoBoringSSLShims_thread_rand_buffer.offset = CCRYPTOBORINGSSLSHIMS_RAND_BUFFER_SIZE;
+}
+
+static void CCryptoBoringSSLShims_rand_buffer_init(void) {
+    CCryptoBoringSSLShims_rand_buffer_key_valid =
+        pthread_key_create(&CCryptoBoringSSLShims_rand_buffer_key, CCryptoBoringSSLShims_rand_buffer_thread_exit) == 0;
+}
+#endif
+
+// Returns the calling thread's buffer bytes, or NULL if they can't be allocated.
+static uint8_t *CCryptoBoringSSLShims_rand_buffer_bytes(struct CCryptoBoringSSLShims_rand_buffer *buffer) {
+#if defined(CCRYPTOBORINGSSLSHIMS_RAND_NODE_LOCAL)
+    if (buffer->bytes == NULL) {
+        pthread_once(&CCryptoBoringSSLShims_rand_buffer_once, CCryptoBoringSSLShims_rand_buffer_init);
+        if (!CCryptoBoringSSLShims_rand_buffer_key_valid) {
+            return NULL;
+        }
+        void *bytes = mmap(NULL, CCRYPTOBORINGSSLSHIMS_RAND_BUFFER_SIZE, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (bytes == MAP_FAILED) {
+            return NULL;
+        }
+        if (pthread_setspecific(CCryptoBoringSSLShims_rand_buffer_key, bytes) != 0) {
+            munmap(bytes, CCRYPTOBORINGSSLSHIMS_RAND_BUFFER_SIZE);
+            return NULL;
+        }
+        buffer->bytes = bytes;
+        buffer->offset = CCRYPTOBORINGSSLSHIMS_RAND_BUFFER_SIZE;
+    }
+#endif
+    return buffer->bytes;
+}
+
+void CCryptoBoringSSLShims_RAND_set_buffering_enabled(int enabled) {
+    __atomic_store_n(&CCryptoBoringSSLShims_rand_buffering, enabled != 0, __ATOMIC_RELAXED);
+}
+
+int CCryptoBoringSSLShims_RAND_buffering_enabled(void) {
+    return __atomic_load_n(&CCryptoBoringSSLShims_rand_buffering, __ATOMIC_RELAXED);
+}
+
+static void CCryptoBoringSSLShims_rand_generate(void *out, size_t len) {
+    CCryptoBoringSSLShims_instrument(CCryptoBoringSSLShims_event_random_generations, 1);
+    CCRYPTOBORINGSSLSHIMS_TRACE_ENTRY(random_generate, NID_undef, 0, len);
+    CCryptoBoringSSL_RAND_bytes(out, len);
+    CCRYPTOBORINGSSLSHIMS_TRACE_RETURN(random_generate, NID_undef, 0, len, 1);
+}
+
+void CCryptoBoringSSLShims_RAND_bytes(void *out, size_t len) {
+    CCryptoBoringSSLShims_instrument(CCryptoBoringSSLShims_event_random_requests, 1);
+    CCryptoBoringSSLShims_instrument(CCryptoBoringSSLShims_event_random_bytes, len);
+    uint64_t fork_generation = 0;
+    if (!CCryptoBoringSSLShims_RAND_buffering_enabled() ||
+        len > CCRYPTOBORINGSSLSHIMS_RAND_BUFFER_MAX_REQUEST ||
+        (fork_generation = CCryptoBoringSSL_CRYPTO_get_fork_generation()) == 0) {
+        CCryptoBoringSSLShims_rand_generate(out, len);
+        return;
+    }
+
+    struct CCryptoBoringSSLShims_rand_buffer *buffer = &CCryptoBoringSSLShims_thread_rand_buffer;
+    uint8_t *bytes = CCryptoBoringSSLShims_rand_buffer_bytes(buffer);
+    if (bytes == NULL) {
+        CCryptoBoringSSLShims_rand_generate(out, len);
+        return;
+    }
+    if (buffer->fork_generation != fork_generation ||
+        CCRYPTOBORINGSSLSHIMS_RAND_BUFFER_SIZE - buffer->offset < len) {
+        CCryptoBoringSSLShims_rand_generate(bytes, CCRYPTOBORINGSSLSHIMS_RAND_BUFFER_SIZE);
+        buffer->offset = 0;
+        buffer->fork_generation = fork_generation;
+    }
+
+    // Bytes are wiped as they are handed out, so the buffer never holds a copy of
+    // anything that has already been used.
+    memcpy(out, bytes + buffer->offset, len);
+    CCryptoBoringSSL_OPENSSL_cleanse(bytes + buffer->offset, len);
+    buffer->offset += len;
+}
+
+// Declared in crypto/internal.h, which is not a public header. Each initializes
+// the library if needed before returning the detected capabilities.
+#if !defined(OPENSSL_NO_ASM) && defined(OPENSSL_X86_64)
+uint32_t CCryptoBoringSSL_OPENSSL_get_ia32cap(int idx);
+
+static int CCryptoBoringSSLShims_ia32cap(int idx, int bit) {
+    return (CCryptoBoringSSL_OPENSSL_get_ia32cap(idx) & (1u << bit)) != 0;
+}
+#elif !defined(OPENSSL_NO_ASM) && defined(OPENSSL_AARCH64)
+uint32_t CCryptoBoringSSL_OPENSSL_get_armcap(void);
+#endif
+
+const char *CCryptoBoringSSLShims_SHA256_implementation(void) {
+#if !defined(OPENSSL_NO_ASM) && defined(OPENSSL_X86_64)
+    if (CCryptoBoringSSLShims_ia32cap(2, 29) && CCryptoBoringSSLShims_ia32cap(1, 9)) {
+        return "sha-ni";
+    }
+    if (CCryptoBoringSSLShims_ia32cap(1, 28) && CCryptoBoringSSLShims_ia32cap(0, 30)) {
+        return "avx";
+    }
+    if (CCryptoBoringSSLShims_ia32cap(1, 9)) {
+        return "ssse3";
+    }
+    return "x86_64";
+#elif !defined(OPENSSL_NO_ASM) && defined(OPENSSL_AARCH64)
+    if (CCryptoBoringSSL_OPENSSL_get_armcap() & ARMV8_SHA256) {
+        return "armv8-sha256";
+    }
+    return "aarch64";
+#elif !defined(OPENSSL_NO_ASM)
+    return "assembly";
+#else
+    return "c";
+#endif
+}
+
+const char *CCryptoBoringSSLShims_SHA512_implementation(void) {
+#if !defined(OPENSSL_NO_ASM) && defined(OPENSSL_X86_64)
+    if (CCryptoBoringSSLShims_ia32cap(1, 28) && CCryptoBoringSSLShims_ia32cap(0, 30)) {
+        return "avx";
+    }
+    return "x86_64";
+#elif !defined(OPENSSL_NO_ASM) && defined(OPENSSL_AARCH64)
+    if (CCryptoBoringSSL_OPENSSL_get_armcap() & ARMV8_SHA512) {
+        return "armv8-sha512";
+    }
+    return "aarch64";
+#elif !defined(OPENSSL_NO_ASM)
+    return "assembly";
+#else
+    return "c";
+#endif
+}
+
+const char *CCryptoBoringSSLShims_AES_implementation(void) {
+#if !defined(OPENSSL_NO_ASM) && defined(OPENSSL_X86_64)
+    if (CCryptoBoringSSLShims_ia32cap(1, 25)) {
+        return "aes-ni";
+    }
+    if (CCryptoBoringSSLShims_ia32cap(1, 9)) {
+        return "vpaes-ssse3";
+    }
+    return "c";
+#elif !defined(OPENSSL_NO_ASM) && defined(OPENSSL_AARCH64)
+    if (CCryptoBoringSSL_OPENSSL_get_armcap() & ARMV8_AES) {
+        return "armv8-aes";
+    }
+    if (CCryptoBoringSSL_OPENSSL_get_armcap() & ARMV7_NEON) {
+#if defined(CRYPTO_BORINGSSL_ARM_KERNELS) && defined(__ARM_NEON)
+        // AES-GCM uses the bitsliced counter mode below; other modes use vpaes.
+        return "bsaes-neon";
+#else
+        return "vpaes-neon";
+#endif
+    }
+    return "c";
+#elif !defined(OPENSSL_NO_ASM)
+    return "assembly";
+#else
+    return "c";
+#endif
+}
+
+const char *CCryptoBoringSSLShims_P256_implementation(void) {
+    if (CCryptoBoringSSL_EC_group_p256()->meth == CCryptoBoringSSL_EC_GFp_nistp256_method()) {
+        return "fiat";
+    }
+    return "nistz256";
+}
+
+const char *CCryptoBoringSSLShims_GHASH_implementation(void) {
+#if defined(GHASH_ASM_X86_64)
+    if (CCryptoBoringSSL_crypto_gcm_clmul_enabled()) {
+        return CRYPTO_is_AVX_capable() && CRYPTO_is_MOVBE_capable() ? "avx" : "clmul";
+    }
+    if (CRYPTO_is_SSSE3_capable()) {
+        return "ssse3";
+    }
+#elif defined(GHASH_ASM_ARM)
+    if (gcm_pmull_capable()) {
+        return "armv8-pmull";
+    }
+    if (gcm_neon_capable()) {
+        return "neon";
+    }
+#endif
+    return "c";
+}
+
+const char *CCryptoBoringSSLShims_ChaCha20_implementation(void) {
+#if !defined(OPENSSL_NO_ASM) && defined(OPENSSL_X86_64)
+    if (CRYPTO_is_AVX2_capable()) {
+        return "avx2";
+    }
+    if (CRYPTO_is_SSSE3_capable()) {
+        return "ssse3-4x";
+    }
+    return "x86_64";
+#elif !defined(OPENSSL_NO_ASM) && defined(OPENSSL_AARCH64)
+    if (CRYPTO_is_NEON_capable()) {
+        return "neon";
+    }
+    return "aarch64";
+#else
+    return "c";
+#endif
+}
+
+const char *CCryptoBoringSSLShims_ChaCha20Poly1305_implementation(void) {
+#if !defined(OPENSSL_NO_ASM) && defined(OPENSSL_X86_64)
+    if (CRYPTO_is_SSE4_1_capable()) {
+        return "sse4.1";
+    }
+#elif !defined(OPENSSL_NO_ASM) && defined(OPENSSL_AARCH64)
+    if (CRYPTO_is_NEON_capable()) {
+        return "neon";
+    }
+#endif
+    return "c";
+}
+
+const char *CCryptoBoringSSLShims_X25519_implementation(void) {
+#if defined(BORINGSSL_X25519_NEON)
+    if (CRYPTO_is_NEON_capable()) {
+        return "neon";
+    }
+#elif defined(BORINGSSL_FE25519_ADX)
+    if (CRYPTO_is_BMI1_capable() && CRYPTO_is_BMI2_capable() && CRYPTO_is_ADX_capable()) {
+        return "adx";
+    }
+#endif
+    return "fiat";
+}
+
+// MARK:- CPU capabilities
+
+#if !defined(OPENSSL_NO_ASM) && defined(OPENSSL_X86_64)
+// Where each capability lives in OPENSSL_ia32cap_P. See crypto/internal.h.
+static const struct {
+    uint64_t capability;
+    int word;
+    int bit;
+} CCryptoBoringSSLShims_ia32cap_bits[] = {
+    {CCryptoBoringSSLShims_CPU_SSSE3, 1, 9},
+    {CCryptoBoringSSLShims_CPU_SSE4_1, 1, 19},
+    {CCryptoBoringSSLShims_CPU_PCLMUL, 1, 1},
+    {CCryptoBoringSSLShims_CPU_MOVBE, 1, 22},
+    {CCryptoBoringSSLShims_CPU_AESNI, 1, 25},
+    {CCryptoBoringSSLShims_CPU_AVX, 1, 28},
+    {CCryptoBoringSSLShims_CPU_AVX2, 2, 5},
+    {CCryptoBoringSSLShims_CPU_BMI1, 2, 3},
+    {CCryptoBoringSSLShims_CPU_BMI2, 2, 8},
+    {CCryptoBoringSSLShims_CPU_ADX, 2, 19},
+    {CCryptoBoringSSLShims_CPU_SHA, 2, 29},
+    {CCryptoBoringSSLShims_CPU_AVX512F, 2, 16},
+    {CCryptoBoringSSLShims_CPU_AVX512IFMA, 2, 21},
+};
+#endif
+
+uint64_t CCryptoBoringSSLShims_cpu_capabilities(void) {
+    uint64_t capabilities = 0;
+#if !defined(OPENSSL_NO_ASM) && defined(OPENSSL_X86_64)
+    // The CRYPTO_is_*_capable helpers, rather than the raw words, so that
+    // capabilities assumed at compile time are reported too.
+    capabilities |= CRYPTO_is_SSSE3_capable() ? CCryptoBoringSSLShims_CPU_SSSE3 : 0;
+    capabilities |= CRYPTO_is_SSE4_1_capable() ? CCryptoBoringSSLShims_CPU_SSE4_1 : 0;
+    capabilities |= CRYPTO_is_PCLMUL_capable() ? CCryptoBoringSSLShims_CPU_PCLMUL : 0;
+    capabilities |= CRYPTO_is_MOVBE_capable() ? CCryptoBoringSSLShims_CPU_MOVBE : 0;
+    capabilities |= CRYPTO_is_AESNI_capable() ? CCryptoBoringSSLShims_CPU_AESNI : 0;
+    capabilities |= CRYPTO_is_AVX_capable() ? CCryptoBoringSSLShims_CPU_AVX : 0;
+    capabilities |= CRYPTO_is_AVX2_capable() ? CCryptoBoringSSLShims_CPU_AVX2 : 0;
+    capabilities |= CRYPTO_is_BMI1_capable() ? CCryptoBoringSSLShims_CPU_BMI1 : 0;
+    capabilities |= CRYPTO_is_BMI2_capable() ? CCryptoBoringSSLShims_CPU_BMI2 : 0;
+    capabilities |= CRYPTO_is_ADX_capable() ? CCryptoBoringSSLShims_CPU_ADX : 0;
+    capabilities |= CRYPTO_is_x86_SHA_capable() ? CCryptoBoringSSLShims_CPU_SHA : 0;
+    // BoringSSL has no AVX-512 kernels and so no helpers; report the raw bits.
+    capabilities |= CCryptoBoringSSLShims_ia32cap(2, 16) ? CCryptoBoringSSLShims_CPU_AVX512F : 0;
+    capabilities |= CCryptoBoringSSLShims_ia32cap(2, 21) ? CCryptoBoringSSLShims_CPU_AVX512IFMA : 0;
+#elif !defined(OPENSSL_NO_ASM) && defined(OPENSSL_AARCH64)
+    capabilities |= CRYPTO_is_NEON_capable() ? CCryptoBoringSSLShims_CPU_NEON : 0;
+    capabilities |= CRYPTO_is_ARMv8_AES_capable() ? CCryptoBoringSSLShims_CPU_ARMV8_AES : 0;
+    capabilities |= CRYPTO_is_ARMv8_PMULL_capable() ? CCryptoBoringSSLShims_CPU_ARMV8_PMULL : 0;
+    capabilities |= CRYPTO_is_ARMv8_SHA1_capable() ? CCryptoBoringSSLShims_CPU_ARMV8_SHA1 : 0;
+    capabilities |= CRYPTO_is_ARMv8_SHA256_capable() ? CCryptoBoringSSLShims_CPU_ARMV8_SHA256 : 0;
+    capabilities |= CRYPTO_is_ARMv8_SHA512_capable() ? CCryptoBoringSSLShims_CPU_ARMV8_SHA512 : 0;
+#endif
+    return capabilities;
+}
+
+#if !defined(OPENSSL_NO_ASM) && defined(OPENSSL_X86_64)
+static void CCryptoBoringSSLShims_ia32cap_clear(uint64_t disabled) {
+    for (size_t i = 0; i < sizeof(CCryptoBoringSSLShims_ia32cap_bits) / sizeof(CCryptoBoringSSLShims_ia32cap_bits[0]); i++) {
+        if (disabled & CCryptoBoringSSLShims_ia32cap_bits[i].capability) {
+            CCryptoBoringSSL_OPENSSL_ia32cap_P[CCryptoBoringSSLShims_ia32cap_bits[i].word] &= ~(1u << CCryptoBoringSSLShims_ia32cap_bits[i].bit);
+        }
+    }
+    // AVX2 and AVX-512 are only meaningful with AVX, and the assembly assumes as
+    // much, so disabling AVX disables them too.
+    if (disabled & CCryptoBoringSSLShims_CPU_AVX) {
+        CCryptoBoringSSL_OPENSSL_ia32cap_P[2] &= ~((1u << 5) | (1u << 16) | (1u << 21));
+    }
+}
+#endif
+
+uint64_t CCryptoBoringSSLShims_cpu_restrict_capabilities(uint64_t disabled) {
+#if !defined(OPENSSL_NO_ASM) && defined(OPENSSL_X86_64)
+    // Run detection first, so that it cannot overwrite the restriction later.
+    (void)CCryptoBoringSSL_OPENSSL_get_ia32cap(0);
+    CCryptoBoringSSLShims_ia32cap_clear(disabled);
+#elif !defined(OPENSSL_NO_ASM) && defined(OPENSSL_AARCH64)
+    (void)CCryptoBoringSSL_OPENSSL_get_armcap();
+    uint32_t armcap_bits = 0;
+    armcap_bits |= (disabled & CCryptoBoringSSLShims_CPU_NEON) ? ARMV7_NEON : 0;
+    armcap_bits |= (disabled & CCryptoBoringSSLShims_CPU_ARMV8_AES) ? ARMV8_AES : 0;
+    armcap_bits |= (disabled & CCryptoBoringSSLShims_CPU_ARMV8_PMULL) ? ARMV8_PMULL : 0;
+    armcap_bits |= (disabled & CCryptoBoringSSLShims_CPU_ARMV8_SHA1) ? ARMV8_SHA1 : 0;
+    armcap_bits |= (disabled & CCryptoBoringSSLShims_CPU_ARMV8_SHA256) ? ARMV8_SHA256 : 0;
+    armcap_bits |= (disabled & CCryptoBoringSSLShims_CPU_ARMV8_SHA512) ? ARMV8_SHA512 : 0;
+    CCryptoBoringSSL_OPENSSL_armcap_P &= ~armcap_bits;
+#else
+    (void)disabled;
+#endif
+    return CCryptoBoringSSLShims_cpu_capabilities();
+}
+
+#if (defined(OPENSSL_X86_64) || defined(OPENSSL_X86)) && defined(__GNUC__)
+#define CCRYPTOBORINGSSLSHIMS_CPUID_BRAND 1
+#include <cpuid.h>
+#endif
+
+void CCryptoBoringSSLShims_cpu_model(char *out, size_t out_len) {
+    if (out_len == 0) {
+        return;
+    }
+    out[0] = 0;
+#if defined(CCRYPTOBORINGSSLSHIMS_CPUID_BRAND)
+    unsigned int brand[12];
+    if (__get_cpuid_max(0x80000000, NULL) < 0x80000004) {
+        return;
+    }
+    for (unsigned int leaf = 0; leaf < 3; leaf++) {
+        __get_cpuid(0x80000002 + leaf, &brand[leaf * 4], &brand[leaf * 4 + 1], &brand[leaf * 4 + 2], &brand[leaf * 4 + 3]);
+    }
+    // The brand string is NUL padded and often starts with spaces.
+    const char *model = (const char *)brand;
+    size_t len = strnlen(model, sizeof(brand));
+    while (len > 0 && *model == ' ') {
+        model++;
+        len--;
+    }
+    if (len >= out_len) {
+        len = out_len - 1;
+    }
+    memcpy(out, model, len);
+    out[len] = 0;
+#endif
+}
+
+// MARK:- Kernel autotuning
+
+#if !defined(OPENSSL_NO_ASM) && defined(OPENSSL_X86_64) && !defined(_WIN32)
+#define CCRYPTOBORINGSSLSHIMS_AUTOTUNE 1
+#include <time.h>
+#endif
+
+#if defined(CCRYPTOBORINGSSLSHIMS_AUTOTUNE)
+// Each primitive's probe, and the capabilities whose removal selects a different
+// kernel for it. The removals don't overlap, so the winners can be combined.
+enum {
+    CCryptoBoringSSLShims_autotune_message_len = 1024,
+    CCryptoBoringSSLShims_autotune_rounds = 5,
+    // A round is sized to take at least this long with every capability.
+    CCryptoBoringSSLShims_autotune_round_ns = 200000,
+    CCryptoBoringSSLShims_autotune_max_candidates = 3,
+};
+
+typedef struct {
+    const EVP_AEAD *aead;
+    EVP_AEAD_CTX ctx;
+    BIGNUM *a, *b, *r;
+    BN_MONT_CTX *mont;
+    BN_CTX *bn_ctx;
+    uint8_t message[CCryptoBoringSSLShims_autotune_message_len + 16];
+} CCryptoBoringSSLShims_autotune_state;
+
+typedef int (*CCryptoBoringSSLShims_autotune_setup_fn)(CCryptoBoringSSLShims_autotune_state *state);
+typedef void (*CCryptoBoringSSLShims_autotune_op_fn)(CCryptoBoringSSLShims_autotune_state *state);
+typedef void (*CCryptoBoringSSLShims_autotune_teardown_fn)(CCryptoBoringSSLShims_autotune_state *state);
+
+static int CCryptoBoringSSLShims_autotune_aead_setup(CCryptoBoringSSLShims_autotune_state *state) {
+    static const uint8_t key[32] = {0};
+    // The context is set up again for every candidate, because AES-GCM picks its
+    // GHASH and counter-mode kernels when the key is set.
+    return CCryptoBoringSSL_EVP_AEAD_CTX_init(&state->ctx, state->aead, key, CCryptoBoringSSL_EVP_AEAD_key_length(state->aead),
+                                              EVP_AEAD_DEFAULT_TAG_LENGTH, NULL);
+}
+
+static void CCryptoBoringSSLShims_autotune_aead_op(CCryptoBoringSSLShims_autotune_state *state) {
+    static const uint8_t nonce[12] = {0};
+    size_t out_len;
+    (void)CCryptoBoringSSL_EVP_AEAD_CTX_seal(&state->ctx, state->message, &out_len, sizeof(state->message), nonce, sizeof(nonce),
+                                             state->message, CCryptoBoringSSLShims_autotune_message_len, NULL, 0);
+}
+
+static void CCryptoBoringSSLShims_autotune_aead_teardown(CCryptoBoringSSLShims_autotune_state *state) {
+    CCryptoBoringSSL_EVP_AEAD_CTX_cleanup(&state->ctx);
+}
+
+static int CCryptoBoringSSLShims_autotune_none_setup(CCryptoBoringSSLShims_autotune_state *state) {
+    (void)state;
+    return 1;
+}
+
+static void CCryptoBoringSSLShims_autotune_none_teardown(CCryptoBoringSSLShims_autotune_state *state) {
+    (void)state;
+}
+
+static void CCryptoBoringSSLShims_autotune_sha256_op(CCryptoBoringSSLShims_autotune_state *state) {
+    CCryptoBoringSSL_SHA256(state->message, CCryptoBoringSSLShims_autotune_message_len, state->message);
+}
+
+static void CCryptoBoringSSLShims_autotune_mont_op(CCryptoBoringSSLShims_autotune_state *state) {
+    (void)CCryptoBoringSSL_BN_mod_mul_montgomery(state->r, state->a, state->b, state->mont, state->bn_ctx);
+}
+
+static const struct {
+    const char *primitive;
+    CCryptoBoringSSLShims_autotune_setup_fn setup;
+    CCryptoBoringSSLShims_autotune_op_fn op;
+    CCryptoBoringSSLShims_autotune_teardown_fn teardown;
+    int uses_gcm;
+    int uses_chacha;
+    uint64_t candidates[CCryptoBoringSSLShims_autotune_max_candidates];
+} CCryptoBoringSSLShims_autotune_probes[CCryptoBoringSSLShims_AUTOTUNE_PRIMITIVES] = {
+    // Without MOVBE, AES-GCM runs AES-NI counter mode and CLMUL GHASH separately
+    // rather than the stitched AVX kernel.
+    {"aes-gcm", CCryptoBoringSSLShims_autotune_aead_setup, CCryptoBoringSSLShims_autotune_aead_op,
+     CCryptoBoringSSLShims_autotune_aead_teardown, 1, 0, {0, CCryptoBoringSSLShims_CPU_MOVBE}},
+    // Without AVX2 the combined assembly stays on 128-bit vectors; without SSE4.1
+    // ChaCha20 and Poly1305 run separately.
+    {"chacha20-poly1305", CCryptoBoringSSLShims_autotune_aead_setup, CCryptoBoringSSLShims_autotune_aead_op,
+     CCryptoBoringSSLShims_autotune_aead_teardown, 0, 1, {0, CCryptoBoringSSLShims_CPU_AVX2, CCryptoBoringSSLShims_CPU_SSE4_1}},
+    // Without the SHA extensions, SHA-256 uses the AVX or SSSE3 kernels.
+    {"sha256", CCryptoBoringSSLShims_autotune_none_setup, CCryptoBoringSSLShims_autotune_sha256_op,
+     CCryptoBoringSSLShims_autotune_none_teardown, 0, 0, {0, CCryptoBoringSSLShims_CPU_SHA}},
+    // Without ADX, Montgomery multiplication uses MUL rather than MULX and ADCX.
+    // This also moves P-256 and X25519 off their ADX kernels.
+    {"montgomery", CCryptoBoringSSLShims_autotune_none_setup, CCryptoBoringSSLShims_autotune_mont_op,
+     CCryptoBoringSSLShims_autotune_none_teardown, 0, 0, {0, CCryptoBoringSSLShims_CPU_ADX}},
+};
+
+static uint64_t CCryptoBoringSSLShims_autotune_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+// Runs |iterations| operations with |removed| cleared from the detected
+// capabilities, and returns the time taken, or UINT64_MAX if setup failed.
+static uint64_t CCryptoBoringSSLShims_autotune_time(size_t probe, CCryptoBoringSSLShims_autotune_state *state, const uint32_t detected[4],
+                                                    uint64_t removed, size_t iterations) {
+    memcpy(CCryptoBoringSSL_OPENSSL_ia32cap_P, detected, sizeof(CCryptoBoringSSL_OPENSSL_ia32cap_P));
+    CCryptoBoringSSLShims_ia32cap_clear(removed);
+    if (!CCryptoBoringSSLShims_autotune_probes[probe].setup(state)) {
+        return UINT64_MAX;
+    }
+    uint64_t start = CCryptoBoringSSLShims_autotune_now();
+    for (size_t i = 0; i < iterations; i++) {
+        CCryptoBoringSSLShims_autotune_probes[probe].op(state);
+    }
+    uint64_t elapsed = CCryptoBoringSSLShims_autotune_now() - start;
+    CCryptoBoringSSLShims_autotune_probes[probe].teardown(state);
+    return elapsed;
+}
+
+static int CCryptoBoringSSLShims_autotune_mont_init(CCryptoBoringSSLShims_autotune_state *state) {
+    BIGNUM *modulus = CCryptoBoringSSL_BN_new();
+    state->a = CCryptoBoringSSL_BN_new();
+    state->b = CCryptoBoringSSL_BN_new();
+    state->r = CCryptoBoringSSL_BN_new();
+    state->bn_ctx = CCryptoBoringSSL_BN_CTX_new();
+    int ok = modulus != NULL && state->a != NULL && state->b != NULL && state->r != NULL && state->bn_ctx != NULL &&
+             // An odd 2048-bit modulus, the size of an RSA-4096 CRT prime or an RSA-2048 modulus.
+             CCryptoBoringSSL_BN_rand(modulus, 2048, BN_RAND_TOP_ONE, BN_RAND_BOTTOM_ODD) &&
+             (state->mont = CCryptoBoringSSL_BN_MONT_CTX_new_for_modulus(modulus, state->bn_ctx)) != NULL &&
+             CCryptoBoringSSL_BN_rand_range(state->a, modulus) && CCryptoBoringSSL_BN_rand_range(state->b, modulus);
+    CCryptoBoringSSL_BN_free(modulus);
+    return ok;
+}
+
+static void CCryptoBoringSSLShims_autotune_mont_free(CCryptoBoringSSLShims_autotune_state *state) {
+    CCryptoBoringSSL_BN_free(state->a);
+    CCryptoBoringSSL_BN_free(state->b);
+    CCryptoBoringSSL_BN_free(state->r);
+    CCryptoBoringSSL_BN_MONT_CTX_free(state->mont);
+    CCryptoBoringSSL_BN_CTX_free(state->bn_ctx);
+}
+#endif
+
+size_t CCryptoBoringSSLShims_cpu_autotune(CCryptoBoringSSLShims_autotune_result results[CCryptoBoringSSLShims_AUTOTUNE_PRIMITIVES],
+                                          uint64_t *out_removed) {
+    *out_removed = 0;
+#if defined(CCRYPTOBORINGSSLSHIMS_AUTOTUNE)
+    uint32_t detected[4];
+    (void)CCryptoBoringSSL_OPENSSL_get_ia32cap(0);
+    memcpy(detected, CCryptoBoringSSL_OPENSSL_ia32cap_P, sizeof(detected));
+    uint64_t available = CCryptoBoringSSLShims_cpu_capabilities();
+
+    CCryptoBoringSSLShims_autotune_state state;
+    OPENSSL_memset(&state, 0, sizeof(state));
+    if (!CCryptoBoringSSLShims_autotune_mont_init(&state)) {
+        CCryptoBoringSSLShims_autotune_mont_free(&state);
+        return 0;
+    }
+
+    size_t written = 0;
+    for (size_t probe = 0; probe < CCryptoBoringSSLShims_AUTOTUNE_PRIMITIVES; probe++) {
+        state.aead = CCryptoBoringSSLShims_autotune_probes[probe].uses_chacha ? CCryptoBoringSSL_EVP_aead_chacha20_poly1305()
+                                                                               : CCryptoBoringSSL_EVP_aead_aes_128_gcm();
+        const uint64_t *candidates = CCryptoBoringSSLShims_autotune_probes[probe].candidates;
+
+        // Size the round with every capability, warming it up at the same time.
+        size_t iterations = 1;
+        while (iterations < (1u << 20) &&
+               CCryptoBoringSSLShims_autotune_time(probe, &state, detected, 0, iterations) < CCryptoBoringSSLShims_autotune_round_ns) {
+            iterations *= 2;
+        }
+
+        // Alternate the candidates between rounds, so that frequency changes
+        // during the probe affect them all alike, and keep each one's best round.
+        uint64_t best[CCryptoBoringSSLShims_autotune_max_candidates];
+        for (size_t c = 0; c < CCryptoBoringSSLShims_autotune_max_candidates; c++) {
+            best[c] = UINT64_MAX;
+        }
+        for (int round = 0; round < CCryptoBoringSSLShims_autotune_rounds; round++) {
+            for (size_t c = 0; c < CCryptoBoringSSLShims_autotune_max_candidates; c++) {
+                // Skip empty slots, and removals that change nothing here.
+                if ((c > 0 && candidates[c] == 0) || (c > 0 && (candidates[c] & available) == 0)) {
+                    continue;
+                }
+                uint64_t elapsed = CCryptoBoringSSLShims_autotune_time(probe, &state, detected, candidates[c], iterations);
+                if (elapsed < best[c]) {
+                    best[c] = elapsed;
+                }
+            }
+        }
+
+        // A removal must win by 5% to be chosen, so that noise doesn't flip the
+        // decision between runs.
+        size_t winner = 0;
+        for (size_t c = 1; c < CCryptoBoringSSLShims_autotune_max_candidates; c++) {
+            if (best[c] != UINT64_MAX && best[c] < best[winner] - best[winner] / 20) {
+                winner = c;
+            }
+        }
+        *out_removed |= candidates[winner];
+
+        results[written].primitive = CCryptoBoringSSLShims_autotune_probes[probe].primitive;
+        results[written].removed = candidates[winner];
+        results[written].default_ns = best[0] / iterations;
+        results[written].tuned_ns = best[winner] / iterations;
+        written++;
+    }
+
+    CCryptoBoringSSLShims_autotune_mont_free(&state);
+    memcpy(CCryptoBoringSSL_OPENSSL_ia32cap_P, detected, sizeof(detected));
+    return written;
+#else
+    (void)results;
+    return 0;
+#endif
+}
+
+// MARK:- Keccak
+
+_Static_assert(sizeof(struct BORINGSSL_keccak_st) <= sizeof(CCryptoBoringSSLShims_keccak_ctx),
+               "CCryptoBoringSSLShims_keccak_ctx is too small");
+_Static_assert(_Alignof(struct BORINGSSL_keccak_st) <= _Alignof(CCryptoBoringSSLShims_keccak_ctx),
+               "CCryptoBoringSSLShims_keccak_ctx is not aligned enough");
+
+void CCryptoBoringSSLShims_keccak_init(CCryptoBoringSSLShims_keccak_ctx *ctx,
+                                       CCryptoBoringSSLShims_keccak_function function) {
+    struct BORINGSSL_keccak_st *keccak = (struct BORINGSSL_keccak_st *)ctx;
+    switch (function) {
+    case CCryptoBoringSSLShims_keccak_shake128:
+        CCryptoBoringSSL_BORINGSSL_keccak_init(keccak, boringssl_shake128);
+        return;
+    case CCryptoBoringSSLShims_keccak_shake256:
+        CCryptoBoringSSL_BORINGSSL_keccak_init(keccak, boringssl_shake256);
+        return;
+    case CCryptoBoringSSLShims_keccak_sha3_256:
+    case CCryptoBoringSSLShims_keccak_sha3_512:
+        break;
+    }
+
+    // BORINGSSL_keccak_init refuses the fixed-length functions, so this does
+    // what its keccak_init helper would: the capacity is twice the digest size.
+    int is_256 = function == CCryptoBoringSSLShims_keccak_sha3_256;
+    memset(keccak, 0, sizeof(*keccak));
+    keccak->config = is_256 ? boringssl_sha3_256 : boringssl_sha3_512;
+    keccak->phase = boringssl_keccak_phase_absorb;
+    keccak->rate_bytes = 200 - 2 * (is_256 ? 32 : 64);
+}
+
+void CCryptoBoringSSLShims_keccak_absorb(CCryptoBoringSSLShims_keccak_ctx *ctx,
+                                         const void *in, size_t in_len) {
+    CCryptoBoringSSL_BORINGSSL_keccak_absorb((struct BORINGSSL_keccak_st *)ctx, in, in_len);
+}
+
+void CCryptoBoringSSLShims_keccak_squeeze(CCryptoBoringSSLShims_keccak_ctx *ctx,
+                                          void *out, size_t out_len) {
+    CCryptoBoringSSL_BORINGSSL_keccak_squeeze((struct BORINGSSL_keccak_st *)ctx, out, out_len);
+}
+
+// MARK:- Kyber
+
+_Static_assert(CCryptoBoringSSLShims_KYBER_PUBLIC_KEY_BYTES == KYBER_PUBLIC_KEY_BYTES, "Kyber public key size");
+_Static_assert(CCryptoBoringSSLShims_KYBER_PRIVATE_KEY_BYTES == KYBER_PRIVATE_KEY_BYTES, "Kyber private key size");
+_Static_assert(CCryptoBoringSSLShims_KYBER_CIPHERTEXT_BYTES == KYBER_CIPHERTEXT_BYTES, "Kyber ciphertext size");
+_Static_assert(CCryptoBoringSSLShims_KYBER_SHARED_SECRET_BYTES == KYBER_SHARED_SECRET_BYTES, "Kyber shared secret size");
+
+size_t CCryptoBoringSSLShims_kyber_public_key_size(void) {
+    return sizeof(struct KYBER_public_key);
+}
+
+size_t CCryptoBoringSSLShims_kyber_private_key_size(void) {
+    return sizeof(struct KYBER_private_key);
+}
+
+void CCryptoBoringSSLShims_kyber_generate_key(void *out_encoded_public_key, void *out_private_key) {
+    CCryptoBoringSSL_KYBER_generate_key(out_encoded_public_key, out_private_key);
+}
+
+void CCryptoBoringSSLShims_kyber_public_from_private(void *out_public_key, const void *private_key) {
+    CCryptoBoringSSL_KYBER_public_from_private(out_public_key, private_key);
+}
+
+int CCryptoBoringSSLShims_kyber_parse_public_key(void *out_public_key, const void *in, size_t in_len) {
+    CBS cbs;
+    CBS_init(&cbs, in, in_len);
+    return CCryptoBoringSSL_KYBER_parse_public_key(out_public_key, &cbs);
+}
+
+int CCryptoBoringSSLShims_kyber_parse_private_key(void *out_private_key, const void *in, size_t in_len) {
+    CBS cbs;
+    CBS_init(&cbs, in, in_len);
+    return CCryptoBoringSSL_KYBER_parse_private_key(out_private_key, &cbs);
+}
+
+int CCryptoBoringSSLShims_kyber_marshal_public_key(void *out, const void *public_key) {
+    CBB cbb;
+    size_t written;
+    if (!CCryptoBoringSSL_CBB_init_fixed(&cbb, out, KYBER_PUBLIC_KEY_BYTES) ||
+        !CCryptoBoringSSL_KYBER_marshal_public_key(&cbb, public_key) ||
+        !CCryptoBoringSSL_CBB_finish(&cbb, NULL, &written)) {
+        return 0;
+    }
+    return written == KYBER_PUBLIC_KEY_BYTES;
+}
+
+int CCryptoBoringSSLShims_kyber_marshal_private_key(void *out, const void *private_key) {
+    CBB cbb;
+    size_t written;
+    if (!CCryptoBoringSSL_CBB_init_fixed(&cbb, out, KYBER_PRIVATE_KEY_BYTES) ||
+        !CCryptoBoringSSL_KYBER_marshal_private_key(&cbb, private_key) ||
+        !CCryptoBoringSSL_CBB_finish(&cbb, NULL, &written)) {
+        return 0;
+    }
+    return written == KYBER_PRIVATE_KEY_BYTES;
+}
+
+void CCryptoBoringSSLShims_kyber_encap(void *out_ciphertext, void *out_shared_secret, const void *public_key) {
+    CCryptoBoringSSL_KYBER_encap(out_ciphertext, out_shared_secret, public_key);
+}
+
+void CCryptoBoringSSLShims_kyber_decap(void *out_shared_secret, const void *ciphertext, const void *private_key) {
+    CCryptoBoringSSL_KYBER_decap(out_shared_secret, ciphertext, private_key);
+}
+
+// MARK:- SPHINCS+
+
+_Static_assert(CCryptoBoringSSLShims_SPX_PUBLIC_KEY_BYTES == SPX_PUBLIC_KEY_BYTES, "SPHINCS+ public key size");
+_Static_assert(CCryptoBoringSSLShims_SPX_SECRET_KEY_BYTES == SPX_SECRET_KEY_BYTES, "SPHINCS+ secret key size");
+_Static_assert(CCryptoBoringSSLShims_SPX_SIGNATURE_BYTES == SPX_SIGNATURE_BYTES, "SPHINCS+ signature size");
+_Static_assert(sizeof(((CCryptoBoringSSLShims_spx_signing_state *)NULL)->fors_digest) == SPX_FORS_MSG_BYTES,
+               "SPHINCS+ FORS message size");
+
+void CCryptoBoringSSLShims_spx_generate_key(void *out_public_key, void *out_secret_key) {
+    CCryptoBoringSSL_spx_generate_key(out_public_key, out_secret_key);
+}
+
+void CCryptoBoringSSLShims_spx_public_from_secret(void *out_public_key, const void *secret_key) {
+    // The secret key is SK.seed || SK.prf || PK.seed || PK.root.
+    memcpy(out_public_key, (const uint8_t *)secret_key + 2 * SPX_N, SPX_PUBLIC_KEY_BYTES);
+}
+
+void CCryptoBoringSSLShims_spx_sign(void *out_signature, const void *secret_key,
+                                    const void *msg, size_t msg_len, int randomized) {
+    CCryptoBoringSSL_spx_sign(out_signature, secret_key, msg, msg_len, randomized);
+}
+
+int CCryptoBoringSSLShims_spx_verify(const void *signature, const void *public_key,
+                                     const void *msg, size_t msg_len) {
+    return CCryptoBoringSSL_spx_verify(signature, public_key, msg, msg_len);
+}
+
+// Signing is dominated by building the authentication paths: one node per
+// height for each of the SPX_D hypertree layers, and a FORS path for each
+// FORS tree. None of these depend on each other or on the message beyond its
+// digest, because every node is a function of the secret seed and its address.
+// Only the WOTS+ signatures chain from one layer to the next, and those are
+// cheap, so `_spx_sign_finish` computes them serially.
+//
+// Tasks are numbered with the tallest, most expensive, subtrees first.
+#define CCryptoBoringSSLShims_SPX_HT_TASKS (SPX_D * SPX_TREE_HEIGHT)
+
+size_t CCryptoBoringSSLShims_spx_sign_task_count(void) {
+    return CCryptoBoringSSLShims_SPX_HT_TASKS + SPX_FORS_TREES;
+}
+
+// The tree and leaf index of the signing path within hypertree `layer`.
+static void CCryptoBoringSSLShims_spx_layer_position(const CCryptoBoringSSLShims_spx_signing_state *state,
+                                                     uint32_t layer, uint64_t *out_idx_tree,
+                                                     uint32_t *out_idx_leaf) {
+    uint64_t idx_tree = state->idx_tree;
+    uint32_t idx_leaf = state->idx_leaf;
+    for (uint32_t j = 0; j < layer; j++) {
+        idx_leaf = (uint32_t)(idx_tree % (1 << SPX_TREE_HEIGHT));
+        idx_tree = idx_tree >> SPX_TREE_HEIGHT;
+    }
+    *out_idx_tree = idx_tree;
+    *out_idx_leaf = idx_leaf;
+}
+
+static void CCryptoBoringSSLShims_spx_fors_addr(const CCryptoBoringSSLShims_spx_signing_state *state,
+                                                uint8_t addr[32]) {
+    memset(addr, 0, 32);
+    CCryptoBoringSSL_spx_set_tree_addr(addr, state->idx_tree);
+    CCryptoBoringSSL_spx_set_type(addr, SPX_ADDR_TYPE_FORSTREE);
+    CCryptoBoringSSL_spx_set_keypair_addr(addr, state->idx_leaf);
+}
+
+static uint8_t *CCryptoBoringSSLShims_spx_layer_signature(void *out_signature, uint32_t layer) {
+    return (uint8_t *)out_signature + SPX_N + SPX_FORS_BYTES + layer * SPX_XMSS_BYTES;
+}
+
+void CCryptoBoringSSLShims_spx_sign_begin(CCryptoBoringSSLShims_spx_signing_state *state,
+                                          void *out_signature, const void *secret_key,
+                                          const void *msg, size_t msg_len, int randomized) {
+    // This follows the start of spx_sign.
+    const uint8_t *sk_prf = (const uint8_t *)secret_key + SPX_N;
+    const uint8_t *pk_seed = (const uint8_t *)secret_key + 2 * SPX_N;
+    const uint8_t *pk_root = (const uint8_t *)secret_key + 3 * SPX_N;
+
+    uint8_t opt_rand[SPX_N];
+    if (randomized) {
+        CCryptoBoringSSL_RAND_bytes(opt_rand, SPX_N);
+    } else {
+        memcpy(opt_rand, pk_seed, SPX_N);
+    }
+
+    uint8_t *r = out_signature;
+    CCryptoBoringSSL_spx_thash_prfmsg(r, sk_prf, opt_rand, msg, msg_len);
+
+    uint8_t digest[SPX_DIGEST_SIZE];
+    CCryptoBoringSSL_spx_thash_hmsg(digest, r, pk_seed, pk_root, msg, msg_len);
+    memcpy(state->fors_digest, digest, SPX_FORS_MSG_BYTES);
+
+    state->idx_tree = CCryptoBoringSSL_spx_to_uint64(digest + SPX_FORS_MSG_BYTES, SPX_TREE_BYTES);
+    state->idx_tree &= (~(uint64_t)0) >> (64 - SPX_TREE_BITS);
+    state->idx_leaf = (uint32_t)CCryptoBoringSSL_spx_to_uint64(digest + SPX_FORS_MSG_BYTES + SPX_TREE_BYTES,
+                                                               SPX_LEAF_BYTES);
+    state->idx_leaf &= (~(uint32_t)0) >> (32 - SPX_LEAF_BITS);
+}
+
+void CCryptoBoringSSLShims_spx_sign_task(const CCryptoBoringSSLShims_spx_signing_state *state,
+                                         void *out_signature, const void *secret_key, size_t task) {
+    const uint8_t *sk_seed = secret_key;
+    const uint8_t *pk_seed = (const uint8_t *)secret_key + 2 * SPX_N;
+    uint8_t addr[32];
+
+    if (task < CCryptoBoringSSLShims_SPX_HT_TASKS) {
+        // One node of a hypertree authentication path, as spx_xmss_sign computes it.
+        uint32_t height = SPX_TREE_HEIGHT - 1 - (uint32_t)(task / SPX_D);
+        uint32_t layer = (uint32_t)(task % SPX_D);
+        uint64_t idx_tree;
+        uint32_t idx_leaf;
+        CCryptoBoringSSLShims_spx_layer_position(state, layer, &idx_tree, &idx_leaf);
+
+        memset(addr, 0, sizeof(addr));
+        CCryptoBoringSSL_spx_set_layer_addr(addr, layer);
+        CCryptoBoringSSL_spx_set_tree_addr(addr, idx_tree);
+        uint8_t *node = CCryptoBoringSSLShims_spx_layer_signature(out_signature, layer) + SPX_WOTS_BYTES +
+                        height * SPX_N;
+        CCryptoBoringSSL_spx_treehash(node, sk_seed, (idx_leaf >> height) ^ 1, height, pk_seed, addr);
+        return;
+    }
+
+    // One FORS tree's secret element and authentication path, as spx_fors_sign computes them.
+    size_t tree = task - CCryptoBoringSSLShims_SPX_HT_TASKS;
+    if (tree >= SPX_FORS_TREES) {
+        abort();
+    }
+    uint32_t indices[SPX_FORS_TREES];
+    CCryptoBoringSSL_spx_base_b(indices, SPX_FORS_TREES, state->fors_digest, SPX_FORS_HEIGHT);
+
+    CCryptoBoringSSLShims_spx_fors_addr(state, addr);
+    uint8_t *fors_signature = (uint8_t *)out_signature + SPX_N + tree * SPX_N * (SPX_FORS_HEIGHT + 1);
+    CCryptoBoringSSL_spx_set_tree_height(addr, 0);
+    CCryptoBoringSSL_spx_fors_sk_gen(fors_signature, (uint32_t)(tree * (1 << SPX_FORS_HEIGHT) + indices[tree]),
+                                     sk_seed, pk_seed, addr);
+    for (uint32_t j = 0; j < SPX_FORS_HEIGHT; j++) {
+        uint32_t sibling = (indices[tree] >> j) ^ 1;
+        CCryptoBoringSSL_spx_fors_treehash(fors_signature + SPX_N * (j + 1), sk_seed,
+                                           (uint32_t)(tree * (1ULL << (SPX_FORS_HEIGHT - j)) + sibling), j,
+                                           pk_seed, addr);
+    }
+}
+
+void CCryptoBoringSSLShims_spx_sign_finish(const CCryptoBoringSSLShims_spx_signing_state *state,
+                                           void *out_signature, const void *secret_key) {
+    // This follows the end of spx_sign and spx_ht_sign, with the authentication paths already in place.
+    const uint8_t *sk_seed = secret_key;
+    const uint8_t *pk_seed = (const uint8_t *)secret_key + 2 * SPX_N;
+    uint8_t addr[32];
+
+    uint8_t root[SPX_N];
+    CCryptoBoringSSLShims_spx_fors_addr(state, addr);
+    CCryptoBoringSSL_spx_fors_pk_from_sig(root, (const uint8_t *)out_signature + SPX_N, state->fors_digest,
+                                          pk_seed, addr);
+
+    for (uint32_t layer = 0; layer < SPX_D; layer++) {
+        uint64_t idx_tree;
+        uint32_t idx_leaf;
+        CCryptoBoringSSLShims_spx_layer_position(state, layer, &idx_tree, &idx_leaf);
+        uint8_t *layer_signature = CCryptoBoringSSLShims_spx_layer_signature(out_signature, layer);
+
+        memset(addr, 0, sizeof(addr));
+        CCryptoBoringSSL_spx_set_layer_addr(addr, layer);
+        CCryptoBoringSSL_spx_set_tree_addr(addr, idx_tree);
+        CCryptoBoringSSL_spx_set_type(addr, SPX_ADDR_TYPE_WOTS);
+        CCryptoBoringSSL_spx_set_keypair_addr(addr, idx_leaf);
+        CCryptoBoringSSL_spx_wots_sign(layer_signature, root, sk_seed, pk_seed, addr);
+
+        if (layer < SPX_D - 1) {
+            CCryptoBoringSSL_spx_xmss_pk_from_sig(root, layer_signature, idx_leaf, root, pk_seed, addr);
+        }
+    }
+}
+
+// MARK:- AES
+
+void CCryptoBoringSSLShims_AES_ecb_encrypt_blocks(const void *in, void *out, size_t len,
+                                                  const AES_KEY *key, int enc) {
+#if defined(HWAES_ECB)
+    if (hwaes_capable()) {
+        CCryptoBoringSSL_aes_hw_ecb_encrypt(in, out, len, key, enc);
+        return;
+    }
+#endif
+    const uint8_t *in_bytes = in;
+    uint8_t *out_bytes = out;
+    for (size_t offset = 0; offset < len; offset += AES_BLOCK_SIZE) {
+        if (enc) {
+            CCryptoBoringSSL_AES_encrypt(in_bytes + offset, out_bytes + offset, key);
+        } else {
+            CCryptoBoringSSL_AES_decrypt(in_bytes + offset, out_bytes + offset, key);
+        }
+    }
+}
+
+// MARK:- Bitsliced AES for AArch64
+
+// AArch64 cores without the ARMv8 crypto extensions, such as some Cortex-A53
+// and A55 parts, otherwise run AES-GCM's counter mode through vpaes one block
+// at a time. This encrypts eight blocks at once in the bitsliced form that
+// bsaes-armv7 uses on 32-bit ARM: register |b| holds bit |b| of every byte of
+// the eight blocks, with block |k| in bit |k| of each byte. SubBytes is then
+// the Boyar-Peralta circuit over whole registers, ShiftRows and MixColumns are
+// byte shuffles, and nothing depends on the key or data but the values.
+// GHASH stays with BoringSSL's NEON kernel, through CRYPTO_gcm128_*_ctr32.
+//
+// The AES_KEY holds the round keys in FIPS 197 byte order, which vpaes and
+// aes_nohw don't, so a key set up here must only be used with the functions
+// here.
+//
+// This kernel has not yet been run on AArch64 in CI, so it is only built when
+// CRYPTO_BORINGSSL_ARM_KERNELS is defined. Otherwise AES-GCM keeps BoringSSL's
+// vpaes.
+
+#if defined(CRYPTO_BORINGSSL_ARM_KERNELS) && defined(OPENSSL_AARCH64) && defined(__ARM_NEON)
+#define CCRYPTOBORINGSSLSHIMS_BSAES_NEON 1
+#include <arm_neon.h>
+
+// Swaps the bits of |a| that |m| << |n| selects with the bits of |b| that |m|
+// selects.
+#define CCRYPTOBORINGSSLSHIMS_BSAES_SWAPMOVE(a, b, n, m)                                           \
+    do {                                                                                           \
+        uint8x16_t t_ = vandq_u8(veorq_u8(vshrq_n_u8((a), (n)), (b)), vdupq_n_u8(m));              \
+        (b) = veorq_u8((b), t_);                                                                   \
+        (a) = veorq_u8((a), vshlq_n_u8(t_, (n)));                                                  \
+    } while (0)
+
+// Transposes each byte position's 8x8 bit matrix, which converts eight blocks
+// to bitsliced form and back.
+static void CCryptoBoringSSLShims_bsaes_neon_transpose(uint8x16_t x[8]) {
+    CCRYPTOBORINGSSLSHIMS_BSAES_SWAPMOVE(x[0], x[1], 1, 0x55);
+    CCRYPTOBORINGSSLSHIMS_BSAES_SWAPMOVE(x[2], x[3], 1, 0x55);
+    CCRYPTOBORINGSSLSHIMS_BSAES_SWAPMOVE(x[4], x[5], 1, 0x55);
+    CCRYPTOBORINGSSLSHIMS_BSAES_SWAPMOVE(x[6], x[7], 1, 0x55);
+    CCRYPTOBORINGSSLSHIMS_BSAES_SWAPMOVE(x[0], x[2], 2, 0x33);
+    CCRYPTOBORINGSSLSHIMS_BSAES_SWAPMOVE(x[1], x[3], 2, 0x33);
+    CCRYPTOBORINGSSLSHIMS_BSAES_SWAPMOVE(x[4], x[6], 2, 0x33);
+    CCRYPTOBORINGSSLSHIMS_BSAES_SWAPMOVE(x[5], x[7], 2, 0x33);
+    CCRYPTOBORINGSSLSHIMS_BSAES_SWAPMOVE(x[0], x[4], 4, 0x0f);
+    CCRYPTOBORINGSSLSHIMS_BSAES_SWAPMOVE(x[1], x[5], 4, 0x0f);
+    CCRYPTOBORINGSSLSHIMS_BSAES_SWAPMOVE(x[2], x[6], 4, 0x0f);
+    CCRYPTOBORINGSSLSHIMS_BSAES_SWAPMOVE(x[3], x[7], 4, 0x0f);
+}
+
+#undef CCRYPTOBORINGSSLSHIMS_BSAES_SWAPMOVE
+
+// The S-box circuit of Boyar and Peralta, "A new combinational logic
+// minimization technique with applications to cryptology", without its four
+// NOT gates. Those XOR 0x63 into every output byte, which passes unchanged
+// through ShiftRows and MixColumns, so the round keys carry it instead.
+static void CCryptoBoringSSLShims_bsaes_neon_sub_bytes(uint8x16_t q[8]) {
+    const uint8x16_t x0 = q[7], x1 = q[6], x2 = q[5], x3 = q[4], x4 = q[3], x5 = q[2], x6 = q[1], x7 = q[0];
+
+    // Top linear transformation.
+    const uint8x16_t y14 = veorq_u8(x3, x5);
+    const uint8x16_t y13 = veorq_u8(x0, x6);
+    const uint8x16_t y9 = veorq_u8(x0, x3);
+    const uint8x16_t y8 = veorq_u8(x0, x5);
+    const uint8x16_t t0 = veorq_u8(x1, x2);
+    const uint8x16_t y1 = veorq_u8(t0, x7);
+    const uint8x16_t y4 = veorq_u8(y1, x3);
+    const uint8x16_t y12 = veorq_u8(y13, y14);
+    const uint8x16_t y2 = veorq_u8(y1, x0);
+    const uint8x16_t y5 = veorq_u8(y1, x6);
+    const uint8x16_t y3 = veorq_u8(y5, y8);
+    const uint8x16_t t1 = veorq_u8(x4, y12);
+    const uint8x16_t y15 = veorq_u8(t1, x5);
+    const uint8x16_t y20 = veorq_u8(t1, x1);
+    const uint8x16_t y6 = veorq_u8(y15, x7);
+    const uint8x16_t y10 = veorq_u8(y15, t0);
+    const uint8x16_t y11 = veorq_u8(y20, y9);
+    const uint8x16_t y7 = veorq_u8(x7, y11);
+    const uint8x16_t y17 = veorq_u8(y10, y11);
+    const uint8x16_t y19 = veorq_u8(y10, y8);
+    const uint8x16_t y16 = veorq_u8(t0, y11);
+    const uint8x16_t y21 = veorq_u8(y13, y16);
+    const uint8x16_t y18 = veorq_u8(x0, y16);
+
+    // Non-linear section.
+    const uint8x16_t t2 = vandq_u8(y12, y15);
+    const uint8x16_t t3 = vandq_u8(y3, y6);
+    const uint8x16_t t4 = veorq_u8(t3, t2);
+    const uint8x16_t t5 = vandq_u8(y4, x7);
+    const uint8x16_t t6 = veorq_u8(t5, t2);
+    const uint8x16_t t7 = vandq_u8(y13, y16);
+    const uint8x16_t t8 = vandq_u8(y5, y1);
+    const uint8x16_t t9 = veorq_u8(t8, t7);
+    const uint8x16_t t10 = vandq_u8(y2, y7);
+    const uint8x16_t t11 = veorq_u8(t10, t7);
+    const uint8x16_t t12 = vandq_u8(y9, y11);
+    const uint8x16_t t13 = vandq_u8(y14, y17);
+    const uint8x16_t t14 = veorq_u8(t13, t12);
+    const uint8x16_t t15 = vandq_u8(y8, y10);
+    const uint8x16_t t16 = veorq_u8(t15, t12);
+    const uint8x16_t t17 = veorq_u8(t4, t14);
+    const uint8x16_t t18 = veorq_u8(t6, t16);
+    const uint8x16_t t19 = veorq_u8(t9, t14);
+    const uint8x16_t t20 = veorq_u8(t11, t16);
+    const uint8x16_t t21 = veorq_u8(t17, y20);
+    const uint8x16_t t22 = veorq_u8(t18, y19);
+    const uint8x16_t t23 = veorq_u8(t19, y21);
+    const uint8x16_t t24 = veorq_u8(t20, y18);
+
+    const uint8x16_t t25 = veorq_u8(t21, t22);
+    const uint8x16_t t26 = vandq_u8(t21, t23);
+    const uint8x16_t t27 = veorq_u8(t24, t26);
+    const uint8x16_t t28 = vandq_u8(t25, t27);
+    const uint8x16_t t29 = veorq_u8(t28, t22);
+    const uint8x16_t t30 = veorq_u8(t23, t24);
+    const uint8x16_t t31 = veorq_u8(t22, t26);
+    const uint8x16_t t32 = vandq_u8(t31, t30);
+    const uint8x16_t t33 = veorq_u8(t32, t24);
+    const uint8x16_t t34 = veorq_u8(t23, t33);
+    const uint8x16_t t35 = veorq_u8(t27, t33);
+    const uint8x16_t t36 = vandq_u8(t24, t35);
+    const uint8x16_t t37 = veorq_u8(t36, t34);
+    const uint8x16_t t38 = veorq_u8(t27, t36);
+    const uint8x16_t t39 = vandq_u8(t29, t38);
+    const uint8x16_t t40 = veorq_u8(t25, t39);
+
+    const uint8x16_t t41 = veorq_u8(t40, t37);
+    const uint8x16_t t42 = veorq_u8(t29, t33);
+    const uint8x16_t t43 = veorq_u8(t29, t40);
+    const uint8x16_t t44 = veorq_u8(t33, t37);
+    const uint8x16_t t45 = veorq_u8(t42, t41);
+    const uint8x16_t z0 = vandq_u8(t44, y15);
+    const uint8x16_t z1 = vandq_u8(t37, y6);
+    const uint8x16_t z2 = vandq_u8(t33, x7);
+    const uint8x16_t z3 = vandq_u8(t43, y16);
+    const uint8x16_t z4 = vandq_u8(t40, y1);
+    const uint8x16_t z5 = vandq_u8(t29, y7);
+    const uint8x16_t z6 = vandq_u8(t42, y11);
+    const uint8x16_t z7 = vandq_u8(t45, y17);
+    const uint8x16_t z8 = vandq_u8(t41, y10);
+    const uint8x16_t z9 = vandq_u8(t44, y12);
+    const uint8x16_t z10 = vandq_u8(t37, y3);
+    const uint8x16_t z11 = vandq_u8(t33, y4);
+    const uint8x16_t z12 = vandq_u8(t43, y13);
+    const uint8x16_t z13 = vandq_u8(t40, y5);
+    const uint8x16_t z14 = vandq_u8(t29, y2);
+    const uint8x16_t z15 = vandq_u8(t42, y9);
+    const uint8x16_t z16 = vandq_u8(t45, y14);
+    const uint8x16_t z17 = vandq_u8(t41, y8);
+
+    // Bottom linear transformation.
+    const uint8x16_t t46 = veorq_u8(z15, z16);
+    const uint8x16_t t47 = veorq_u8(z10, z11);
+    const uint8x16_t t48 = veorq_u8(z5, z13);
+    const uint8x16_t t49 = veorq_u8(z9, z10);
+    const uint8x16_t t50 = veorq_u8(z2, z12);
+    const uint8x16_t t51 = veorq_u8(z2, z5);
+    const uint8x16_t t52 = veorq_u8(z7, z8);
+    const uint8x16_t t53 = veorq_u8(z0, z3);
+    const uint8x16_t t54 = veorq_u8(z6, z7);
+    const uint8x16_t t55 = veorq_u8(z16, z17);
+    const uint8x16_t t56 = veorq_u8(z12, t48);
+    const uint8x16_t t57 = veorq_u8(t50, t53);
+    const uint8x16_t t58 = veorq_u8(z4, t46);
+    const uint8x16_t t59 = veorq_u8(z3, t54);
+    const uint8x16_t t60 = veorq_u8(t46, t57);
+    const uint8x16_t t61 = veorq_u8(z14, t57);
+    const uint8x16_t t62 = veorq_u8(t52, t58);
+    const uint8x16_t t63 = veorq_u8(t49, t58);
+    const uint8x16_t t64 = veorq_u8(z4, t59);
+    const uint8x16_t t65 = veorq_u8(t61, t62);
+    const uint8x16_t t66 = veorq_u8(z1, t63);
+    const uint8x16_t t67 = veorq_u8(t64, t65);
+
+    const uint8x16_t s3 = veorq_u8(t53, t66);
+    q[7] = veorq_u8(t59, t63);
+    q[6] = veorq_u8(t64, s3);
+    q[5] = veorq_u8(t55, t67);
+    q[4] = s3;
+    q[3] = veorq_u8(t51, t66);
+    q[2] = veorq_u8(t47, t65);
+    q[1] = veorq_u8(t56, t62);
+    q[0] = veorq_u8(t48, t60);
+}
+
+static const uint8_t CCryptoBoringSSLShims_bsaes_neon_shift_rows[16] = {0, 5, 10, 15, 4, 9, 14, 3,
+                                                                         8, 13, 2, 7, 12, 1, 6, 11};
+// Each byte of a column takes the next row's byte, then the row after next.
+static const uint8_t CCryptoBoringSSLShims_bsaes_neon_rotate_rows[16] = {1, 2, 3, 0, 5, 6, 7, 4,
+                                                                          9, 10, 11, 8, 13, 14, 15, 12};
+static const uint8_t CCryptoBoringSSLShims_bsaes_neon_rotate_rows2[16] = {2, 3, 0, 1, 6, 7, 4, 5,
+                                                                           10, 11, 8, 9, 14, 15, 12, 13};
+
+// Encrypts eight bitsliced blocks with the bitsliced round keys |rk|.
+static void CCryptoBoringSSLShims_bsaes_neon_encrypt8(uint8x16_t x[8], const uint8x16_t *rk, unsigned rounds) {
+    const uint8x16_t shift_rows = vld1q_u8(CCryptoBoringSSLShims_bsaes_neon_shift_rows);
+    const uint8x16_t rotate_rows = vld1q_u8(CCryptoBoringSSLShims_bsaes_neon_rotate_rows);
+    const uint8x16_t rotate_rows2 = vld1q_u8(CCryptoBoringSSLShims_bsaes_neon_rotate_rows2);
+
+    for (unsigned b = 0; b < 8; b++) {
+        x[b] = veorq_u8(x[b], rk[b]);
+    }
+    for (unsigned round = 1; round <= rounds; round++) {
+        rk += 8;
+        CCryptoBoringSSLShims_bsaes_neon_sub_bytes(x);
+        for (unsigned b = 0; b < 8; b++) {
+            x[b] = vqtbl1q_u8(x[b], shift_rows);
+        }
+        if (round == rounds) {
+            for (unsigned b = 0; b < 8; b++) {
+                x[b] = veorq_u8(x[b], rk[b]);
+            }
+            break;
+        }
+
+        // MixColumns: with r the column rotated by a row and t = x ^ r, each
+        // column becomes 2t ^ r ^ (t rotated by two rows).
+        uint8x16_t r[8], t[8];
+        for (unsigned b = 0; b < 8; b++) {
+            r[b] = vqtbl1q_u8(x[b], rotate_rows);
+            t[b] = veorq_u8(x[b], r[b]);
+        }
+        // Doubling shifts each bit up a register and reduces bit 7 by 0x1b.
+        const uint8x16_t doubled[8] = {t[7], veorq_u8(t[0], t[7]), t[1], veorq_u8(t[2], t[7]),
+                                       veorq_u8(t[3], t[7]), t[4], t[5], t[6]};
+        for (unsigned b = 0; b < 8; b++) {
+            x[b] = veorq_u8(veorq_u8(doubled[b], r[b]), veorq_u8(vqtbl1q_u8(t[b], rotate_rows2), rk[b]));
+        }
+    }
+}
+
+// Bitslices the round keys of |key|, folding in the constant that
+// CCryptoBoringSSLShims_bsaes_neon_sub_bytes leaves out, and returns the
+// number of rounds.
+static unsigned CCryptoBoringSSLShims_bsaes_neon_slice_key(uint8x16_t rk[15 * 8], const AES_KEY *key) {
+    const uint8_t *round_keys = (const uint8_t *)key->rd_key;
+    for (unsigned round = 0; round <= key->rounds; round++) {
+        uint8x16_t k = vld1q_u8(round_keys + 16 * round);
+        if (round != 0) {
+            k = veorq_u8(k, vdupq_n_u8(0x63));
+        }
+        for (unsigned b = 0; b < 8; b++) {
+            rk[8 * round + b] = vtstq_u8(k, vdupq_n_u8((uint8_t)(1 << b)));
+        }
+    }
+    return key->rounds;
+}
+
+static void CCryptoBoringSSLShims_bsaes_neon_ctr32_encrypt_blocks(const uint8_t *in, uint8_t *out, size_t blocks,
+                                                                  const AES_KEY *key, const uint8_t ivec[16]) {
+    uint8x16_t rk[15 * 8];
+    const unsigned rounds = CCryptoBoringSSLShims_bsaes_neon_slice_key(rk, key);
+    uint8_t counters[8 * 16];
+    for (unsigned k = 0; k < 8; k++) {
+        memcpy(counters + 16 * k, ivec, 12);
+    }
+    uint32_t counter = CRYPTO_load_u32_be(ivec + 12);
+
+    while (blocks > 0) {
+        uint8x16_t x[8];
+        for (unsigned k = 0; k < 8; k++) {
+            CRYPTO_store_u32_be(counters + 16 * k + 12, counter + k);
+            x[k] = vld1q_u8(counters + 16 * k);
+        }
+        CCryptoBoringSSLShims_bsaes_neon_transpose(x);
+        CCryptoBoringSSLShims_bsaes_neon_encrypt8(x, rk, rounds);
+        CCryptoBoringSSLShims_bsaes_neon_transpose(x);
+
+        const size_t todo = blocks < 8 ? blocks : 8;
+        for (size_t k = 0; k < todo; k++) {
+            vst1q_u8(out + 16 * k, veorq_u8(vld1q_u8(in + 16 * k), x[k]));
+        }
+        in += 16 * todo;
+        out += 16 * todo;
+        blocks -= todo;
+        counter += 8;
+    }
+    CCryptoBoringSSL_OPENSSL_cleanse(rk, sizeof(rk[0]) * 8 * (rounds + 1));
+}
+
+// GCM only needs the odd single block, for the tag mask and a final partial
+// block, so this pays for eight.
+static void CCryptoBoringSSLShims_bsaes_neon_encrypt(const uint8_t in[16], uint8_t out[16], const AES_KEY *key) {
+    uint8x16_t rk[15 * 8];
+    const unsigned rounds = CCryptoBoringSSLShims_bsaes_neon_slice_key(rk, key);
+    uint8x16_t x[8] = {vld1q_u8(in)};
+    for (unsigned k = 1; k < 8; k++) {
+        x[k] = vdupq_n_u8(0);
+    }
+    CCryptoBoringSSLShims_bsaes_neon_transpose(x);
+    CCryptoBoringSSLShims_bsaes_neon_encrypt8(x, rk, rounds);
+    CCryptoBoringSSLShims_bsaes_neon_transpose(x);
+    vst1q_u8(out, x[0]);
+    CCryptoBoringSSL_OPENSSL_cleanse(rk, sizeof(rk[0]) * 8 * (rounds + 1));
+}
+
+static void CCryptoBoringSSLShims_bsaes_neon_sub_word(uint8_t word[4]) {
+    uint8_t block[16] = {0};
+    memcpy(block, word, 4);
+    uint8x16_t x[8] = {vld1q_u8(block)};
+    for (unsigned k = 1; k < 8; k++) {
+        x[k] = vdupq_n_u8(0);
+    }
+    CCryptoBoringSSLShims_bsaes_neon_transpose(x);
+    CCryptoBoringSSLShims_bsaes_neon_sub_bytes(x);
+    CCryptoBoringSSLShims_bsaes_neon_transpose(x);
+    vst1q_u8(block, x[0]);
+    for (unsigned i = 0; i < 4; i++) {
+        word[i] = block[i] ^ 0x63;
+    }
+    CCryptoBoringSSL_OPENSSL_cleanse(block, sizeof(block));
+}
+
+// The key expansion of FIPS 197, section 5.2, with SubWord done by the same
+// circuit as the rounds so that it too takes constant time.
+static void CCryptoBoringSSLShims_bsaes_neon_set_encrypt_key(AES_KEY *aes_key, const uint8_t *key, size_t key_len) {
+    static const uint8_t rcon[10] = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36};
+    const size_t nk = key_len / 4;
+    aes_key->rounds = (unsigned)nk + 6;
+    uint8_t *w = (uint8_t *)aes_key->rd_key;
+    memcpy(w, key, key_len);
+    for (size_t i = nk; i < 4 * (aes_key->rounds + 1); i++) {
+        uint8_t temp[4];
+        memcpy(temp, w + 4 * (i - 1), 4);
+        if (i % nk == 0) {
+            const uint8_t first = temp[0];
+            temp[0] = temp[1];
+            temp[1] = temp[2];
+            temp[2] = temp[3];
+            temp[3] = first;
+            CCryptoBoringSSLShims_bsaes_neon_sub_word(temp);
+            temp[0] ^= rcon[i / nk - 1];
+        } else if (nk > 6 && i % nk == 4) {
+            CCryptoBoringSSLShims_bsaes_neon_sub_word(temp);
+        }
+        for (unsigned j = 0; j < 4; j++) {
+            w[4 * i + j] = w[4 * (i - nk) + j] ^ temp[j];
+        }
+        CCryptoBoringSSL_OPENSSL_cleanse(temp, sizeof(temp));
+    }
+}
+
+#endif  // CRYPTO_BORINGSSL_ARM_KERNELS && OPENSSL_AARCH64 && __ARM_NEON
+
+// MARK:- VAES counter mode
+
+// On x86-64, BoringSSL's AES-GCM runs the stitched AES-NI/PCLMULQDQ assembly
+// in aesni-gcm-x86_64, which encrypts one block per instruction. With VAES,
+// counter mode alone runs sixteen blocks a pass, two per instruction, at about
+// 1.5 times the speed of aes_hw_ctr32_encrypt_blocks. Even with GHASH then
+// run separately, through BoringSSL's own PCLMULQDQ code, AES-GCM gets 15 to
+// 20 percent faster for messages of 512 bytes and up. Shorter runs go straight
+// to aes_hw_ctr32_encrypt_blocks, as they would without the shims, but the
+// stitched code is still lost from 288 bytes, where it starts, to 512, which
+// costs up to 13 percent there. A VPCLMULQDQ GHASH would need more powers of H
+// than the GCM128_KEY inside an EVP_AEAD_CTX has room for.
+//
+// The key schedule is the one aes_hw_set_encrypt_key writes.
+
+#if defined(HWAES) && defined(OPENSSL_X86_64) && (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 8))
+#define CCRYPTOBORINGSSLSHIMS_GCM_VAES 1
+#include <immintrin.h>
+
+// The eight-register loops must be unrolled for the blocks to stay in
+// registers, which GCC doesn't do at -O2 by itself.
+#define CCRYPTOBORINGSSLSHIMS_GCM_VAES_UNROLL _Pragma("GCC unroll 8")
+
+// A ctr128_f, so only the low 32 bits of the counter in |ivec| are
+// incremented, and they wrap.
+__attribute__((target("vaes,avx2")))
+static void CCryptoBoringSSLShims_vaes_ctr32_encrypt_blocks(const uint8_t *in, uint8_t *out, size_t blocks,
+                                                            const AES_KEY *key, const uint8_t ivec[16]) {
+    // Below one full pass, broadcasting the key schedule and cleansing it
+    // afterwards costs more than the AES-NI loop takes.
+    if (blocks < 16) {
+        aes_hw_ctr32_encrypt_blocks(in, out, blocks, key, ivec);
+        return;
+    }
+    // aes_hw_set_encrypt_key stores one less than the number of rounds.
+    const unsigned rounds = key->rounds + 1;
+    __m256i rk[15];
+    for (unsigned r = 0; r <= rounds; r++) {
+        rk[r] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)key->rd_key + r));
+    }
+    uint32_t counter = CRYPTO_load_u32_be(ivec + 12);
+    // Counter blocks are kept byte-reversed, which puts the big-endian counter
+    // in the low 32-bit word of each lane, where it can be added to directly.
+    const __m256i reverse = _mm256_broadcastsi128_si256(
+        _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+    __m256i ctr = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)ivec)), reverse);
+    ctr = _mm256_blend_epi32(ctr, _mm256_set_epi32(0, 0, 0, (int)(counter + 1), 0, 0, 0, (int)counter), 0x11);
+    const __m256i two = _mm256_set_epi32(0, 0, 0, 2, 0, 0, 0, 2);
+    for (; blocks >= 16; blocks -= 16, in += 256, out += 256, counter += 16) {
+        __m256i x[8];
+        CCRYPTOBORINGSSLSHIMS_GCM_VAES_UNROLL
+        for (size_t i = 0; i < 8; i++) {
+            x[i] = _mm256_xor_si256(_mm256_shuffle_epi8(ctr, reverse), rk[0]);
+            ctr = _mm256_add_epi32(ctr, two);
+        }
+        for (unsigned r = 1; r < rounds; r++) {
+            CCRYPTOBORINGSSLSHIMS_GCM_VAES_UNROLL
+            for (size_t i = 0; i < 8; i++) {
+                x[i] = _mm256_aesenc_epi128(x[i], rk[r]);
+            }
+        }
+        CCRYPTOBORINGSSLSHIMS_GCM_VAES_UNROLL
+        for (size_t i = 0; i < 8; i++) {
+            x[i] = _mm256_aesenclast_epi128(x[i], rk[rounds]);
+            _mm256_storeu_si256((__m256i *)out + i, _mm256_xor_si256(x[i], _mm256_loadu_si256((const __m256i *)in + i)));
+        }
+    }
+    // Leave the upper halves clean for the AES-NI code that follows.
+    _mm256_zeroupper();
+    CCryptoBoringSSL_OPENSSL_cleanse(rk, sizeof(rk));
+    if (blocks > 0) {
+        uint8_t tail_ivec[16];
+        OPENSSL_memcpy(tail_ivec, ivec, 12);
+        CRYPTO_store_u32_be(tail_ivec + 12, counter);
+        aes_hw_ctr32_encrypt_blocks(in, out, blocks, key, tail_ivec);
+    }
+}
+
+static int CCryptoBoringSSLShims_gcm_vaes_capable(void) {
+    return hwaes_capable() && CRYPTO_is_AVX2_capable() && CCryptoBoringSSLShims_ia32cap(3, 9);
+}
+#endif  // HWAES && OPENSSL_X86_64
+
+// MARK:- Wide AArch64 counter mode
+
+// BoringSSL's AArch64 AES-GCM, aesv8-gcm-armv8, stitches four AES blocks
+// with PMULL GHASH. Wide cores such as Neoverse V1, V2 and V3, the Cortex-X
+// line and Apple's have four AES pipes, and keep eight blocks in flight only
+// if eight are independent. This runs counter mode eight blocks a pass on
+// those cores. As with VAES, the ctr128_f can't be stitched with GHASH from
+// the shims, so GHASH runs separately through BoringSSL's four-block PMULL
+// kernel, and AES-GCM gives up aesv8-gcm-armv8 for the key; runs shorter than
+// one pass go to aes_hw_ctr32_encrypt_blocks. The EOR3 reduction the request
+// mentions would live in that GHASH kernel, which isn't the shims'.
+//
+// The key schedule is the one aes_hw_set_encrypt_key writes. This kernel has
+// not yet been run on AArch64 in CI, so it is only built when
+// CRYPTO_BORINGSSL_ARM_KERNELS is defined; compare the AES-GCM entries of
+// crypto-benchmarks, with --cpu-ghz, between builds with and without it.
+
+#if defined(CRYPTO_BORINGSSL_ARM_KERNELS) && defined(HWAES) && defined(OPENSSL_AARCH64) && \
+    defined(__ARM_FEATURE_AES)
+#define CCRYPTOBORINGSSLSHIMS_GCM_AES8_ARMV8 1
+#include <arm_neon.h>
+#if defined(__linux__)
+#include <sys/auxv.h>
+#endif
+
+// The eight-block loops must be unrolled for the blocks to stay in registers,
+// which GCC doesn't do at -O2 by itself.
+#define CCRYPTOBORINGSSLSHIMS_GCM_AES8_UNROLL _Pragma("GCC unroll 8")
+
+// A ctr128_f, so only the low 32 bits of the counter in |ivec| are
+// incremented, and they wrap.
+static void CCryptoBoringSSLShims_aes8_armv8_ctr32_encrypt_blocks(const uint8_t *in, uint8_t *out, size_t blocks,
+                                                                  const AES_KEY *key, const uint8_t ivec[16]) {
+    if (blocks < 8) {
+        aes_hw_ctr32_encrypt_blocks(in, out, blocks, key, ivec);
+        return;
+    }
+    // On AArch64, aes_hw_set_encrypt_key stores the number of rounds itself.
+    const unsigned rounds = key->rounds;
+    uint8x16_t rk[15];
+    for (unsigned r = 0; r <= rounds; r++) {
+        rk[r] = vld1q_u8((const uint8_t *)key->rd_key + 16 * r);
+    }
+    const uint32x4_t iv = vreinterpretq_u32_u8(vld1q_u8(ivec));
+    uint32_t counter = CRYPTO_load_u32_be(ivec + 12);
+    for (; blocks >= 8; blocks -= 8, in += 128, out += 128, counter += 8) {
+        uint8x16_t x[8];
+        CCRYPTOBORINGSSLSHIMS_GCM_AES8_UNROLL
+        for (size_t i = 0; i < 8; i++) {
+            // The last word of the block is the big-endian counter.
+            x[i] = vreinterpretq_u8_u32(vsetq_lane_u32(CRYPTO_bswap4(counter + (uint32_t)i), iv, 3));
+        }
+        for (unsigned r = 0; r < rounds - 1; r++) {
+            CCRYPTOBORINGSSLSHIMS_GCM_AES8_UNROLL
+            for (size_t i = 0; i < 8; i++) {
+                x[i] = vaesmcq_u8(vaeseq_u8(x[i], rk[r]));
+            }
+        }
+        CCRYPTOBORINGSSLSHIMS_GCM_AES8_UNROLL
+        for (size_t i = 0; i < 8; i++) {
+            x[i] = veorq_u8(vaeseq_u8(x[i], rk[rounds - 1]), rk[rounds]);
+            vst1q_u8(out + 16 * i, veorq_u8(x[i], vld1q_u8(in + 16 * i)));
+        }
+    }
+    CCryptoBoringSSL_OPENSSL_cleanse(rk, sizeof(rk));
+    if (blocks > 0) {
+        uint8_t tail_ivec[16];
+        OPENSSL_memcpy(tail_ivec, ivec, 12);
+        CRYPTO_store_u32_be(tail_ivec + 12, counter);
+        aes_hw_ctr32_encrypt_blocks(in, out, blocks, key, tail_ivec);
+    }
+}
+
+static int CCryptoBoringSSLShims_gcm_aes8_wide_core;
+static CRYPTO_once_t CCryptoBoringSSLShims_gcm_aes8_wide_core_once = CRYPTO_ONCE_INIT;
+
+// Reads the core the detecting thread runs on. Servers have one kind of core;
+// on a big.LITTLE part this follows whichever the thread was scheduled on.
+static void CCryptoBoringSSLShims_gcm_aes8_detect(void) {
+#if defined(__APPLE__)
+    // Apple's arm64 cores are all of the wide kind.
+    CCryptoBoringSSLShims_gcm_aes8_wide_core = 1;
+#elif defined(__linux__) && defined(HWCAP_CPUID)
+    // With HWCAP_CPUID the kernel emulates reads of the ID registers.
+    if ((getauxval(AT_HWCAP) & HWCAP_CPUID) == 0) {
+        return;
+    }
+    uint64_t midr;
+    __asm__ volatile("mrs %0, MIDR_EL1" : "=r"(midr));
+    const unsigned implementer = (unsigned)(midr >> 24) & 0xff;
+    const unsigned part = (unsigned)(midr >> 4) & 0xfff;
+    if (implementer == 0x61) {
+        // Apple, under Asahi Linux.
+        CCryptoBoringSSLShims_gcm_aes8_wide_core = 1;
+    } else if (implementer == 0x41) {
+        switch (part) {
+            case 0xd40:  // Neoverse V1
+            case 0xd4f:  // Neoverse V2
+            case 0xd84:  // Neoverse V3
+            case 0xd44:  // Cortex-X1
+            case 0xd48:  // Cortex-X2
+            case 0xd4e:  // Cortex-X3
+                CCryptoBoringSSLShims_gcm_aes8_wide_core = 1;
+                break;
+            default:
+                break;
+        }
+    }
+#endif
+}
+
+static int CCryptoBoringSSLShims_gcm_aes8_capable(void) {
+    if (!hwaes_capable() || !gcm_pmull_capable()) {
+        return 0;
+    }
+    CRYPTO_once(&CCryptoBoringSSLShims_gcm_aes8_wide_core_once, CCryptoBoringSSLShims_gcm_aes8_detect);
+    return CCryptoBoringSSLShims_gcm_aes8_wide_core;
+}
+#endif  // CRYPTO_BORINGSSL_ARM_KERNELS && HWAES && OPENSSL_AARCH64 && __ARM_FEATURE_AES
+
+// If AES-GCM's counter mode should use one of the kernels above, rekeys
+// |aes_key| for it where that's needed, sets |*out_block| to match, and
+// returns its ctr128_f. The GCM key must then not use the stitched assembly.
+// Otherwise returns NULL and leaves the key as aes_ctr_set_key left it.
+static ctr128_f CCryptoBoringSSLShims_gcm_ctr_set_key(AES_KEY *aes_key, block128_f *out_block, const uint8_t *key,
+                                                      size_t key_len) {
+#if defined(CCRYPTOBORINGSSLSHIMS_BSAES_NEON)
+    if (!hwaes_capable() && (key_len == 16 || key_len == 24 || key_len == 32)) {
+        CCryptoBoringSSLShims_bsaes_neon_set_encrypt_key(aes_key, key, key_len);
+        *out_block = CCryptoBoringSSLShims_bsaes_neon_encrypt;
+        return CCryptoBoringSSLShims_bsaes_neon_ctr32_encrypt_blocks;
+    }
+#endif
+#if defined(CCRYPTOBORINGSSLSHIMS_GCM_AES8_ARMV8)
+    // aes_ctr_set_key has already set up the ARMv8 key schedule.
+    if (CCryptoBoringSSLShims_gcm_aes8_capable() && (key_len == 16 || key_len == 24 || key_len == 32)) {
+        *out_block = aes_hw_encrypt;
+        return CCryptoBoringSSLShims_aes8_armv8_ctr32_encrypt_blocks;
+    }
+#endif
+#if defined(CCRYPTOBORINGSSLSHIMS_GCM_VAES)
+    // aes_ctr_set_key has already set up the AES-NI key schedule.
+    if (CCryptoBoringSSLShims_gcm_vaes_capable() && (key_len == 16 || key_len == 24 || key_len == 32)) {
+        *out_block = aes_hw_encrypt;
+        return CCryptoBoringSSLShims_vaes_ctr32_encrypt_blocks;
+    }
+#endif
+    (void)aes_key;
+    (void)out_block;
+    (void)key;
+    (void)key_len;
+    return NULL;
+}
+
+// MARK:- P-256
+
+int CCryptoBoringSSLShims_p256_ecdh(void *out_secret, const void *private_scalar, const void *peer_point) {
+    const EC_GROUP *group = CCryptoBoringSSL_EC_group_p256();
+    EC_SCALAR scalar;
+    EC_AFFINE peer;
+    EC_JACOBIAN peer_jacobian, shared;
+    size_t secret_len;
+    int ok = 0;
+
+    if (!CCryptoBoringSSL_ec_scalar_from_bytes(group, &scalar, private_scalar,
+                                               CCryptoBoringSSLShims_P256_SCALAR_BYTES) ||
+        CCryptoBoringSSL_ec_scalar_is_zero(group, &scalar) ||
+        !CCryptoBoringSSL_ec_point_from_uncompressed(group, &peer, peer_point,
+                                                     CCryptoBoringSSLShims_P256_UNCOMPRESSED_POINT_BYTES)) {
+        goto out;
+    }
+
+    CCryptoBoringSSL_ec_affine_to_jacobian(group, &peer_jacobian, &peer);
+    if (!CCryptoBoringSSL_ec_point_mul_scalar(group, &shared, &peer_jacobian, &scalar) ||
+        !CCryptoBoringSSL_ec_get_x_coordinate_as_bytes(group, out_secret, &secret_len,
+                                                       CCryptoBoringSSLShims_P256_SCALAR_BYTES, &shared)) {
+        goto out;
+    }
+    ok = secret_len == CCryptoBoringSSLShims_P256_SCALAR_BYTES;
+
+out:
+    CCryptoBoringSSL_OPENSSL_cleanse(&scalar, sizeof(scalar));
+    CCryptoBoringSSL_OPENSSL_cleanse(&shared, sizeof(shared));
+    return ok;
+}
+
+// MARK:- Multi-buffer P-256 ECDH
+
+// BoringSSL computes each P-256 shared secret on its own, with 64-bit limbs.
+// With AVX-512 IFMA, eight independent multiplications can instead share the
+// 64-bit lanes of a ZMM register: each field element is five 52-bit limbs,
+// which vpmadd52luq and vpmadd52huq multiply directly, and every lane has its
+// own scalar and point. The ladder is that of ec_GFp_nistp256_point_mul, a
+// signed 5-bit window over a 17-entry table of each lane's point, selected in
+// constant time. Field elements are in the Montgomery domain with R = 2^260,
+// and are kept below 2p rather than fully reduced; since p = -1 mod 2^52,
+// each reduction digit is just the low limb.
+#if !defined(OPENSSL_NO_ASM) && defined(OPENSSL_X86_64) && (defined(__GNUC__) || defined(__clang__))
+#define CCRYPTOBORINGSSLSHIMS_P256_IFMA 1
+#include <immintrin.h>
+#endif
+
+#if defined(CCRYPTOBORINGSSLSHIMS_P256_IFMA)
+#define CCRYPTOBORINGSSLSHIMS_P256X8_LANES 8
+#define CCRYPTOBORINGSSLSHIMS_P256X8_TARGET __attribute__((target("avx512f,avx512ifma")))
+// The limb loops must be unrolled for the limbs to stay in registers, which
+// GCC doesn't do at -O2 by itself. Clang accepts the same pragma.
+#define CCRYPTOBORINGSSLSHIMS_P256X8_UNROLL _Pragma("GCC unroll 25")
+
+typedef __m512i CCryptoBoringSSLShims_p256x8_felem[5];
+
+static const uint64_t CCryptoBoringSSLShims_p256x8_p[5] = {
+    0xfffffffffffff, 0xfffffffffff, 0, 0x1000000000, 0xffffffff0000,
+};
+
+static const uint64_t CCryptoBoringSSLShims_p256x8_2p[5] = {
+    0xffffffffffffe, 0x1fffffffffff, 0, 0x2000000000, 0x1fffffffe0000,
+};
+
+// 2^520 mod p, which moves a value into the Montgomery domain.
+static const uint64_t CCryptoBoringSSLShims_p256x8_rr[5] = {
+    0x300, 0xffffffff00000, 0xffffefffffffb, 0xfdfffffffffff, 0x4ffffff,
+};
+
+// 2^260 mod p, which is one in the Montgomery domain.
+static const uint64_t CCryptoBoringSSLShims_p256x8_one[5] = {
+    0x10, 0xf000000000000, 0xfffffffffffff, 0xffeffffffffff, 0xfffff,
+};
+
+// As for the AVX-512 ChaCha20, cpu_intel.c clears AVX512F (but not IFMA)
+// unless the OS saves the ZMM registers, so both bits are needed.
+static int CCryptoBoringSSLShims_is_AVX512IFMA_capable(void) {
+    return CCryptoBoringSSLShims_ia32cap(2, 16) && CCryptoBoringSSLShims_ia32cap(2, 21);
+}
+
+CCRYPTOBORINGSSLSHIMS_P256X8_TARGET
+static inline void CCryptoBoringSSLShims_p256x8_broadcast(CCryptoBoringSSLShims_p256x8_felem out,
+                                                          const uint64_t in[5]) {
+    CCRYPTOBORINGSSLSHIMS_P256X8_UNROLL
+    for (size_t i = 0; i < 5; i++) {
+        out[i] = _mm512_set1_epi64((long long)in[i]);
+    }
+}
+
+// Subtracts |m| from |r|, whose limbs must be carried, unless that would go
+// negative.
+CCRYPTOBORINGSSLSHIMS_P256X8_TARGET
+static inline void CCryptoBoringSSLShims_p256x8_reduce_once(CCryptoBoringSSLShims_p256x8_felem r,
+                                                            const uint64_t m[5]) {
+    const __m512i mask = _mm512_set1_epi64(0xfffffffffffff);
+    __m512i d[5], carry = _mm512_setzero_si512();
+    CCRYPTOBORINGSSLSHIMS_P256X8_UNROLL
+    for (size_t i = 0; i < 5; i++) {
+        d[i] = _mm512_add_epi64(_mm512_sub_epi64(r[i], _mm512_set1_epi64((long long)m[i])), carry);
+        carry = _mm512_srai_epi64(d[i], 52);
+        d[i] = _mm512_and_si512(d[i], mask);
+    }
+    const __mmask8 borrow = _mm512_cmplt_epi64_mask(carry, _mm512_setzero_si512());
+    CCRYPTOBORINGSSLSHIMS_P256X8_UNROLL
+    for (size_t i = 0; i < 5; i++) {
+        r[i] = _mm512_mask_blend_epi64(borrow, d[i], r[i]);
+    }
+}
+
+CCRYPTOBORINGSSLSHIMS_P256X8_TARGET
+static inline void CCryptoBoringSSLShims_p256x8_carry(CCryptoBoringSSLShims_p256x8_felem r) {
+    const __m512i mask = _mm512_set1_epi64(0xfffffffffffff);
+    CCRYPTOBORINGSSLSHIMS_P256X8_UNROLL
+    for (size_t i = 0; i < 4; i++) {
+        r[i + 1] = _mm512_add_epi64(r[i + 1], _mm512_srli_epi64(r[i], 52));
+        r[i] = _mm512_and_si512(r[i], mask);
+    }
+}
+
+// Sets |out| to t/2^260 mod p, below 2p, for the ten-limb product |t|. The
+// low and high halves are accumulated separately to keep dependency chains
+// short. Each limb stays well below 2^64, so carries can wait until a limb is
+// about to be cleared. The third limb of p is zero.
+CCRYPTOBORINGSSLSHIMS_P256X8_TARGET
+static inline void CCryptoBoringSSLShims_p256x8_mont_reduce(CCryptoBoringSSLShims_p256x8_felem out, __m512i t[10]) {
+    const __m512i mask = _mm512_set1_epi64(0xfffffffffffff);
+    CCRYPTOBORINGSSLSHIMS_P256X8_UNROLL
+    for (size_t i = 0; i < 5; i++) {
+        const __m512i m = _mm512_and_si512(t[i], mask);
+        CCRYPTOBORINGSSLSHIMS_P256X8_UNROLL
+        for (size_t j = 0; j < 5; j++) {
+            if (j == 2) {
+                continue;
+            }
+            const __m512i p_j = _mm512_set1_epi64((long long)CCryptoBoringSSLShims_p256x8_p[j]);
+            t[i + j] = _mm512_madd52lo_epu64(t[i + j], m, p_j);
+            t[i + j + 1] = _mm512_madd52hi_epu64(t[i + j + 1], m, p_j);
+        }
+        t[i + 1] = _mm512_add_epi64(t[i + 1], _mm512_srli_epi64(t[i], 52));
+    }
+    // For inputs below 2p, the result is below t/2^260 + p < 1.25p.
+    CCRYPTOBORINGSSLSHIMS_P256X8_UNROLL
+    for (size_t i = 0; i < 5; i++) {
+        out[i] = t[5 + i];
+    }
+    CCryptoBoringSSLShims_p256x8_carry(out);
+}
+
+// Sets |out| to a*b/2^260 mod p. |out| may alias either input.
+CCRYPTOBORINGSSLSHIMS_P256X8_TARGET
+static inline void CCryptoBoringSSLShims_p256x8_mul(CCryptoBoringSSLShims_p256x8_felem out,
+                                                    const CCryptoBoringSSLShims_p256x8_felem a,
+                                                    const CCryptoBoringSSLShims_p256x8_felem b) {
+    __m512i lo[10], hi[10];
+    CCRYPTOBORINGSSLSHIMS_P256X8_UNROLL
+    for (size_t i = 0; i < 10; i++) {
+        lo[i] = _mm512_setzero_si512();
+        hi[i] = _mm512_setzero_si512();
+    }
+    CCRYPTOBORINGSSLSHIMS_P256X8_UNROLL
+    for (size_t i = 0; i < 5; i++) {
+        CCRYPTOBORINGSSLSHIMS_P256X8_UNROLL
+        for (size_t j = 0; j < 5; j++) {
+            lo[i + j] = _mm512_madd52lo_epu64(lo[i + j], a[i], b[j]);
+            hi[i + j + 1] = _mm512_madd52hi_epu64(hi[i + j + 1], a[i], b[j]);
+        }
+    }
+    CCRYPTOBORINGSSLSHIMS_P256X8_UNROLL
+    for (size_t i = 0; i < 10; i++) {
+        lo[i] = _mm512_add_epi64(lo[i], hi[i]);
+    }
+    CCryptoBoringSSLShims_p256x8_mont_reduce(out, lo);
+}
+
+// As |CCryptoBoringSSLShims_p256x8_mul| for a*a, multiplying each pair of
+// distinct limbs once and doubling.
+CCRYPTOBORINGSSLSHIMS_P256X8_TARGET
+static inline void CCryptoBoringSSLShims_p256x8_sqr(CCryptoBoringSSLShims_p256x8_felem out,
+                                                    const CCryptoBoringSSLShims_p256x8_felem a) {
+    __m512i cross[10], t[10];
+    CCRYPTOBORINGSSLSHIMS_P256X8_UNROLL
+    for (size_t i = 0; i < 10; i++) {
+        cross[i] = _mm512_setzero_si512();
+        t[i] = _mm512_setzero_si512();
+    }
+    CCRYPTOBORINGSSLSHIMS_P256X8_UNROLL
+    for (size_t i = 0; i < 5; i++) {
+        CCRYPTOBORINGSSLSHIMS_P256X8_UNROLL
+        for (size_t j = i + 1; j < 5; j++) {
+            cross[i + j] = _mm512_madd52lo_epu64(cross[i + j], a[i], a[j]);
+            cross[i + j + 1] = _mm512_madd52hi_epu64(cross[i + j + 1], a[i], a[j]);
+        }
+    }
+    CCRYPTOBORINGSSLSHIMS_P256X8_UNROLL
+    for (size_t i = 0; i < 5; i++) {
+        t[2 * i] = _mm512_madd52lo_epu64(_mm512_add_epi64(cross[2 * i], cross[2 * i]), a[i], a[i]);
+        t[2 * i + 1] = _mm512_madd52hi_epu64(_mm512_add_epi64(cross[2 * i + 1], cross[2 * i + 1]), a[i], a[i]);
+    }
+    CCryptoBoringSSLShims_p256x8_mont_reduce(out, t);
+}
+
+CCRYPTOBORINGSSLSHIMS_P256X8_TARGET
+static inline void CCryptoBoringSSLShims_p256x8_add(CCryptoBoringSSLShims_p256x8_felem out,
+                                                    const CCryptoBoringSSLShims_p256x8_felem a,
+                                                    const CCryptoBoringSSLShims_p256x8_felem b) {
+    CCRYPTOBORINGSSLSHIMS_P256X8_UNROLL
+    for (size_t i = 0; i < 5; i++) {
+        out[i] = _mm512_add_epi64(a[i], b[i]);
+    }
+    CCryptoBoringSSLShims_p256x8_carry(out);
+    CCryptoBoringSSLShims_p256x8_reduce_once(out, CCryptoBoringSSLShims_p256x8_2p);
+}
+
+CCRYPTOBORINGSSLSHIMS_P256X8_TARGET
+static inline void CCryptoBoringSSLShims_p256x8_sub(CCryptoBoringSSLShims_p256x8_felem out,
+                                                    const CCryptoBoringSSLShims_p256x8_felem a,
+                                                    const CCryptoBoringSSLShims_p256x8_felem b) {
+    const __m512i mask = _mm512_set1_epi64(0xfffffffffffff);
+    __m512i d[5], e[5], carry = _mm512_setzero_si512();
+    CCRYPTOBORINGSSLSHIMS_P256X8_UNROLL
+    for (size_t i = 0; i < 5; i++) {
+        d[i] = _mm512_add_epi64(_mm512_sub_epi64(a[i], b[i]), carry);
+        carry = _mm512_srai_epi64(d[i], 52);
+        d[i] = _mm512_and_si512(d[i], mask);
+    }
+    const __mmask8 borrow = _mm512_cmplt_epi64_mask(carry, _mm512_setzero_si512());
+    // Where a < b, d is a - b + 2^260, and adding 2p and dropping the carry
+    // out of the top limb gives a - b + 2p.
+    carry = _mm512_setzero_si512();
+    CCRYPTOBORINGSSLSHIMS_P256X8_UNROLL
+    for (size_t i = 0; i < 5; i++) {
+        e[i] = _mm512_add_epi64(_mm512_add_epi64(d[i], _mm512_set1_epi64((long long)CCryptoBoringSSLShims_p256x8_2p[i])), carry);
+        carry = _mm512_srli_epi64(e[i], 52);
+        e[i] = _mm512_and_si512(e[i], mask);
+    }
+    CCRYPTOBORINGSSLSHIMS_P256X8_UNROLL
+    for (size_t i = 0; i < 5; i++) {
+        out[i] = _mm512_mask_blend_epi64(borrow, d[i], e[i]);
+    }
+}
+
+// Returns the lanes in which |a|, which is below 2p, is not zero mod p.
+CCRYPTOBORINGSSLSHIMS_P256X8_TARGET
+static inline __mmask8 CCryptoBoringSSLShims_p256x8_nz(const CCryptoBoringSSLShims_p256x8_felem a) {
+    __m512i acc = a[0];
+    __m512i diff = _mm512_xor_si512(a[0], _mm512_set1_epi64((long long)CCryptoBoringSSLShims_p256x8_p[0]));
+    CCRYPTOBORINGSSLSHIMS_P256X8_UNROLL
+    for (size_t i = 1; i < 5; i++) {
+        acc = _mm512_or_si512(acc, a[i]);
+        diff = _mm512_or_si512(diff, _mm512_xor_si512(a[i], _mm512_set1_epi64((long long)CCryptoBoringSSLShims_p256x8_p[i])));
+    }
+    return _mm512_test_epi64_mask(acc, acc) & _mm512_test_epi64_mask(diff, diff);
+}
+
+// Sets |out| to |b| in the lanes of |select| and to |a| in the others.
+CCRYPTOBORINGSSLSHIMS_P256X8_TARGET
+static inline void CCryptoBoringSSLShims_p256x8_blend(CCryptoBoringSSLShims_p256x8_felem out, __mmask8 select,
+                                                      const CCryptoBoringSSLShims_p256x8_felem a,
+                                                      const CCryptoBoringSSLShims_p256x8_felem b) {
+    CCRYPTOBORINGSSLSHIMS_P256X8_UNROLL
+    for (size_t i = 0; i < 5; i++) {
+        out[i] = _mm512_mask_blend_epi64(select, a[i], b[i]);
+    }
+}
+
+// Sets |out| to |in|^-2 with the addition chain of fiat_p256_inv_square.
+CCRYPTOBORINGSSLSHIMS_P256X8_TARGET
+static void CCryptoBoringSSLShims_p256x8_inv_square(CCryptoBoringSSLShims_p256x8_felem out,
+                                                    const CCryptoBoringSSLShims_p256x8_felem in) {
+    CCryptoBoringSSLShims_p256x8_felem x2, x3, x6, x12, x15, x30, x32, ret;
+    CCryptoBoringSSLShims_p256x8_sqr(x2, in);
+    CCryptoBoringSSLShims_p256x8_mul(x2, x2, in);
+    CCryptoBoringSSLShims_p256x8_sqr(x3, x2);
+    CCryptoBoringSSLShims_p256x8_mul(x3, x3, in);
+    CCryptoBoringSSLShims_p256x8_sqr(x6, x3);
+    for (int i = 1; i < 3; i++) {
+        CCryptoBoringSSLShims_p256x8_sqr(x6, x6);
+    }
+    CCryptoBoringSSLShims_p256x8_mul(x6, x6, x3);
+    CCryptoBoringSSLShims_p256x8_sqr(x12, x6);
+    for (int i = 1; i < 6; i++) {
+        CCryptoBoringSSLShims_p256x8_sqr(x12, x12);
+    }
+    CCryptoBoringSSLShims_p256x8_mul(x12, x12, x6);
+    CCryptoBoringSSLShims_p256x8_sqr(x15, x12);
+    for (int i = 1; i < 3; i++) {
+        CCryptoBoringSSLShims_p256x8_sqr(x15, x15);
+    }
+    CCryptoBoringSSLShims_p256x8_mul(x15, x15, x3);
+    CCryptoBoringSSLShims_p256x8_sqr(x30, x15);
+    for (int i = 1; i < 15; i++) {
+        CCryptoBoringSSLShims_p256x8_sqr(x30, x30);
+    }
+    CCryptoBoringSSLShims_p256x8_mul(x30, x30, x15);
+    CCryptoBoringSSLShims_p256x8_sqr(x32, x30);
+    CCryptoBoringSSLShims_p256x8_sqr(x32, x32);
+    CCryptoBoringSSLShims_p256x8_mul(x32, x32, x2);
+
+    CCryptoBoringSSLShims_p256x8_sqr(ret, x32);
+    for (int i = 1; i < 31 + 1; i++) {
+        CCryptoBoringSSLShims_p256x8_sqr(ret, ret);
+    }
+    CCryptoBoringSSLShims_p256x8_mul(ret, ret, in);
+    for (int i = 0; i < 96 + 32; i++) {
+        CCryptoBoringSSLShims_p256x8_sqr(ret, ret);
+    }
+    CCryptoBoringSSLShims_p256x8_mul(ret, ret, x32);
+    for (int i = 0; i < 32; i++) {
+        CCryptoBoringSSLShims_p256x8_sqr(ret, ret);
+    }
+    CCryptoBoringSSLShims_p256x8_mul(ret, ret, x32);
+    for (int i = 0; i < 30; i++) {
+        CCryptoBoringSSLShims_p256x8_sqr(ret, ret);
+    }
+    CCryptoBoringSSLShims_p256x8_mul(ret, ret, x30);
+    CCryptoBoringSSLShims_p256x8_sqr(ret, ret);
+    CCryptoBoringSSLShims_p256x8_sqr(out, ret);
+}
+
+// fiat_p256_point_double, lane by lane. The output may alias the input.
+CCRYPTOBORINGSSLSHIMS_P256X8_TARGET
+static void CCryptoBoringSSLShims_p256x8_point_double(CCryptoBoringSSLShims_p256x8_felem x_out,
+                                                      CCryptoBoringSSLShims_p256x8_felem y_out,
+                                                      CCryptoBoringSSLShims_p256x8_felem z_out,
+                                                      const CCryptoBoringSSLShims_p256x8_felem x_in,
+                                                      const CCryptoBoringSSLShims_p256x8_felem y_in,
+                                                      const CCryptoBoringSSLShims_p256x8_felem z_in) {
+    CCryptoBoringSSLShims_p256x8_felem delta, gamma, beta, ftmp, ftmp2, tmptmp, alpha, fourbeta;
+    CCryptoBoringSSLShims_p256x8_sqr(delta, z_in);
+    CCryptoBoringSSLShims_p256x8_sqr(gamma, y_in);
+    CCryptoBoringSSLShims_p256x8_mul(beta, x_in, gamma);
+
+    CCryptoBoringSSLShims_p256x8_sub(ftmp, x_in, delta);
+    CCryptoBoringSSLShims_p256x8_add(ftmp2, x_in, delta);
+    CCryptoBoringSSLShims_p256x8_add(tmptmp, ftmp2, ftmp2);
+    CCryptoBoringSSLShims_p256x8_add(ftmp2, ftmp2, tmptmp);
+    CCryptoBoringSSLShims_p256x8_mul(alpha, ftmp, ftmp2);
+
+    CCryptoBoringSSLShims_p256x8_add(ftmp, y_in, z_in);
+
+    CCryptoBoringSSLShims_p256x8_sqr(x_out, alpha);
+    CCryptoBoringSSLShims_p256x8_add(fourbeta, beta, beta);
+    CCryptoBoringSSLShims_p256x8_add(fourbeta, fourbeta, fourbeta);
+    CCryptoBoringSSLShims_p256x8_add(tmptmp, fourbeta, fourbeta);
+    CCryptoBoringSSLShims_p256x8_sub(x_out, x_out, tmptmp);
+
+    CCryptoBoringSSLShims_p256x8_add(delta, gamma, delta);
+    CCryptoBoringSSLShims_p256x8_sqr(z_out, ftmp);
+    CCryptoBoringSSLShims_p256x8_sub(z_out, z_out, delta);
+
+    CCryptoBoringSSLShims_p256x8_sub(y_out, fourbeta, x_out);
+    CCryptoBoringSSLShims_p256x8_add(gamma, gamma, gamma);
+    CCryptoBoringSSLShims_p256x8_sqr(gamma, gamma);
+    CCryptoBoringSSLShims_p256x8_mul(y_out, alpha, y_out);
+    CCryptoBoringSSLShims_p256x8_add(gamma, gamma, gamma);
+    CCryptoBoringSSLShims_p256x8_sub(y_out, y_out, gamma);
+}
+
+// fiat_p256_point_add without the mixed case, lane by lane. As there, the
+// lanes that add a point to itself are doubled instead, behind a branch that
+// single point multiplication never takes. The output may alias either input.
+CCRYPTOBORINGSSLSHIMS_P256X8_TARGET
+static void CCryptoBoringSSLShims_p256x8_point_add(CCryptoBoringSSLShims_p256x8_felem x3,
+                                                   CCryptoBoringSSLShims_p256x8_felem y3,
+                                                   CCryptoBoringSSLShims_p256x8_felem z3,
+                                                   const CCryptoBoringSSLShims_p256x8_felem x1,
+                                                   const CCryptoBoringSSLShims_p256x8_felem y1,
+                                                   const CCryptoBoringSSLShims_p256x8_felem z1,
+                                                   const CCryptoBoringSSLShims_p256x8_felem x2,
+                                                   const CCryptoBoringSSLShims_p256x8_felem y2,
+                                                   const CCryptoBoringSSLShims_p256x8_felem z2) {
+    CCryptoBoringSSLShims_p256x8_felem x_out, y_out, z_out;
+    const __mmask8 z1nz = CCryptoBoringSSLShims_p256x8_nz(z1);
+    const __mmask8 z2nz = CCryptoBoringSSLShims_p256x8_nz(z2);
+
+    CCryptoBoringSSLShims_p256x8_felem z1z1, z2z2, u1, s1, two_z1z2;
+    CCryptoBoringSSLShims_p256x8_sqr(z1z1, z1);
+    CCryptoBoringSSLShims_p256x8_sqr(z2z2, z2);
+    CCryptoBoringSSLShims_p256x8_mul(u1, x1, z2z2);
+    CCryptoBoringSSLShims_p256x8_add(two_z1z2, z1, z2);
+    CCryptoBoringSSLShims_p256x8_sqr(two_z1z2, two_z1z2);
+    CCryptoBoringSSLShims_p256x8_sub(two_z1z2, two_z1z2, z1z1);
+    CCryptoBoringSSLShims_p256x8_sub(two_z1z2, two_z1z2, z2z2);
+    CCryptoBoringSSLShims_p256x8_mul(s1, z2, z2z2);
+    CCryptoBoringSSLShims_p256x8_mul(s1, s1, y1);
+
+    CCryptoBoringSSLShims_p256x8_felem u2, h;
+    CCryptoBoringSSLShims_p256x8_mul(u2, x2, z1z1);
+    CCryptoBoringSSLShims_p256x8_sub(h, u2, u1);
+    const __mmask8 xneq = CCryptoBoringSSLShims_p256x8_nz(h);
+    CCryptoBoringSSLShims_p256x8_mul(z_out, h, two_z1z2);
+
+    CCryptoBoringSSLShims_p256x8_felem z1z1z1, s2, r;
+    CCryptoBoringSSLShims_p256x8_mul(z1z1z1, z1, z1z1);
+    CCryptoBoringSSLShims_p256x8_mul(s2, y2, z1z1z1);
+    CCryptoBoringSSLShims_p256x8_sub(r, s2, s1);
+    CCryptoBoringSSLShims_p256x8_add(r, r, r);
+    const __mmask8 yneq = CCryptoBoringSSLShims_p256x8_nz(r);
+
+    const __mmask8 is_nontrivial_double = (__mmask8)(~(xneq | yneq) & z1nz & z2nz);
+
+    CCryptoBoringSSLShims_p256x8_felem i, j, v, s1j;
+    CCryptoBoringSSLShims_p256x8_add(i, h, h);
+    CCryptoBoringSSLShims_p256x8_sqr(i, i);
+    CCryptoBoringSSLShims_p256x8_mul(j, h, i);
+    CCryptoBoringSSLShims_p256x8_mul(v, u1, i);
+
+    CCryptoBoringSSLShims_p256x8_sqr(x_out, r);
+    CCryptoBoringSSLShims_p256x8_sub(x_out, x_out, j);
+    CCryptoBoringSSLShims_p256x8_sub(x_out, x_out, v);
+    CCryptoBoringSSLShims_p256x8_sub(x_out, x_out, v);
+
+    CCryptoBoringSSLShims_p256x8_sub(y_out, v, x_out);
+    CCryptoBoringSSLShims_p256x8_mul(y_out, y_out, r);
+    CCryptoBoringSSLShims_p256x8_mul(s1j, s1, j);
+    CCryptoBoringSSLShims_p256x8_sub(y_out, y_out, s1j);
+    CCryptoBoringSSLShims_p256x8_sub(y_out, y_out, s1j);
+
+    if (constant_time_declassify_w(is_nontrivial_double)) {
+        CCryptoBoringSSLShims_p256x8_felem x_double, y_double, z_double;
+        CCryptoBoringSSLShims_p256x8_point_double(x_double, y_double, z_double, x1, y1, z1);
+        CCryptoBoringSSLShims_p256x8_blend(x_out, is_nontrivial_double, x_out, x_double);
+        CCryptoBoringSSLShims_p256x8_blend(y_out, is_nontrivial_double, y_out, y_double);
+        CCryptoBoringSSLShims_p256x8_blend(z_out, is_nontrivial_double, z_out, z_double);
+    }
+
+    // Where z1 is zero the sum is the second point, and where z2 is zero it is
+    // the first.
+    CCryptoBoringSSLShims_p256x8_blend(x_out, (__mmask8)~z1nz, x_out, x2);
+    CCryptoBoringSSLShims_p256x8_blend(y_out, (__mmask8)~z1nz, y_out, y2);
+    CCryptoBoringSSLShims_p256x8_blend(z_out, (__mmask8)~z1nz, z_out, z2);
+    CCryptoBoringSSLShims_p256x8_blend(x3, (__mmask8)~z2nz, x_out, x1);
+    CCryptoBoringSSLShims_p256x8_blend(y3, (__mmask8)~z2nz, y_out, y1);
+    CCryptoBoringSSLShims_p256x8_blend(z3, (__mmask8)~z2nz, z_out, z1);
+}
+
+// Converts 32 big-endian bytes per lane into limbs.
+CCRYPTOBORINGSSLSHIMS_P256X8_TARGET
+static void CCryptoBoringSSLShims_p256x8_from_bytes(CCryptoBoringSSLShims_p256x8_felem out,
+                                                    const uint8_t in[CCRYPTOBORINGSSLSHIMS_P256X8_LANES][32]) {
+    uint64_t limbs[5][CCRYPTOBORINGSSLSHIMS_P256X8_LANES];
+    for (size_t l = 0; l < CCRYPTOBORINGSSLSHIMS_P256X8_LANES; l++) {
+        const uint64_t w0 = CRYPTO_load_u64_be(in[l] + 24);
+        const uint64_t w1 = CRYPTO_load_u64_be(in[l] + 16);
+        const uint64_t w2 = CRYPTO_load_u64_be(in[l] + 8);
+        const uint64_t w3 = CRYPTO_load_u64_be(in[l]);
+        limbs[0][l] = w0 & 0xfffffffffffff;
+        limbs[1][l] = ((w0 >> 52) | (w1 << 12)) & 0xfffffffffffff;
+        limbs[2][l] = ((w1 >> 40) | (w2 << 24)) & 0xfffffffffffff;
+        limbs[3][l] = ((w2 >> 28) | (w3 << 36)) & 0xfffffffffffff;
+        limbs[4][l] = w3 >> 16;
+    }
+    for (size_t i = 0; i < 5; i++) {
+        out[i] = _mm512_loadu_si512(limbs[i]);
+    }
+    CCryptoBoringSSL_OPENSSL_cleanse(limbs, sizeof(limbs));
+}
+
+CCRYPTOBORINGSSLSHIMS_P256X8_TARGET
+static void CCryptoBoringSSLShims_p256x8_to_bytes(uint8_t out[CCRYPTOBORINGSSLSHIMS_P256X8_LANES][32],
+                                                  const CCryptoBoringSSLShims_p256x8_felem in) {
+    uint64_t limbs[5][CCRYPTOBORINGSSLSHIMS_P256X8_LANES];
+    for (size_t i = 0; i < 5; i++) {
+        _mm512_storeu_si512(limbs[i], in[i]);
+    }
+    for (size_t l = 0; l < CCRYPTOBORINGSSLSHIMS_P256X8_LANES; l++) {
+        CRYPTO_store_u64_be(out[l] + 24, limbs[0][l] | (limbs[1][l] << 52));
+        CRYPTO_store_u64_be(out[l] + 16, (limbs[1][l] >> 12) | (limbs[2][l] << 40));
+        CRYPTO_store_u64_be(out[l] + 8, (limbs[2][l] >> 24) | (limbs[3][l] << 28));
+        CRYPTO_store_u64_be(out[l], (limbs[3][l] >> 36) | (limbs[4][l] << 16));
+    }
+    CCryptoBoringSSL_OPENSSL_cleanse(limbs, sizeof(limbs));
+}
+
+static crypto_word_t CCryptoBoringSSLShims_p256x8_get_bit(const EC_SCALAR *in, int i) {
+    if (i < 0 || i >= 256) {
+        return 0;
+    }
+    return (in->words[i / BN_BITS2] >> (i % BN_BITS2)) & 1;
+}
+
+// Computes the x-coordinate of scalars[l] * (x[l], y[l]) into out[l], for
+// affine coordinates as 32 big-endian bytes, and returns the lanes in which
+// the product is not the point at infinity.
+CCRYPTOBORINGSSLSHIMS_P256X8_TARGET
+static __mmask8 CCryptoBoringSSLShims_p256x8_ecdh(uint8_t out[CCRYPTOBORINGSSLSHIMS_P256X8_LANES][32],
+                                                  const EC_SCALAR scalars[CCRYPTOBORINGSSLSHIMS_P256X8_LANES],
+                                                  const uint8_t x[CCRYPTOBORINGSSLSHIMS_P256X8_LANES][32],
+                                                  const uint8_t y[CCRYPTOBORINGSSLSHIMS_P256X8_LANES][32]) {
+    CCryptoBoringSSLShims_p256x8_felem rr, p_pre_comp[17][3];
+    OPENSSL_memset(p_pre_comp, 0, sizeof(p_pre_comp));
+    CCryptoBoringSSLShims_p256x8_broadcast(rr, CCryptoBoringSSLShims_p256x8_rr);
+    CCryptoBoringSSLShims_p256x8_from_bytes(p_pre_comp[1][0], x);
+    CCryptoBoringSSLShims_p256x8_from_bytes(p_pre_comp[1][1], y);
+    CCryptoBoringSSLShims_p256x8_mul(p_pre_comp[1][0], p_pre_comp[1][0], rr);
+    CCryptoBoringSSLShims_p256x8_mul(p_pre_comp[1][1], p_pre_comp[1][1], rr);
+    CCryptoBoringSSLShims_p256x8_broadcast(p_pre_comp[1][2], CCryptoBoringSSLShims_p256x8_one);
+    for (size_t j = 2; j <= 16; ++j) {
+        if (j & 1) {
+            CCryptoBoringSSLShims_p256x8_point_add(p_pre_comp[j][0], p_pre_comp[j][1], p_pre_comp[j][2],
+                                                   p_pre_comp[1][0], p_pre_comp[1][1], p_pre_comp[1][2],
+                                                   p_pre_comp[j - 1][0], p_pre_comp[j - 1][1],
+                                                   p_pre_comp[j - 1][2]);
+        } else {
+            CCryptoBoringSSLShims_p256x8_point_double(p_pre_comp[j][0], p_pre_comp[j][1], p_pre_comp[j][2],
+                                                      p_pre_comp[j / 2][0], p_pre_comp[j / 2][1],
+                                                      p_pre_comp[j / 2][2]);
+        }
+    }
+
+    CCryptoBoringSSLShims_p256x8_felem nq[3], tmp[3], ftmp, zero;
+    OPENSSL_memset(nq, 0, sizeof(nq));
+    OPENSSL_memset(zero, 0, sizeof(zero));
+    int skip = 1;
+    for (int i = 255; i >= 0; i--) {
+        if (!skip) {
+            CCryptoBoringSSLShims_p256x8_point_double(nq[0], nq[1], nq[2], nq[0], nq[1], nq[2]);
+        }
+        if (i % 5 != 0) {
+            continue;
+        }
+
+        // Each lane recodes its own window, then takes its entry of the
+        // table with masked moves over every entry.
+        uint64_t digits[CCRYPTOBORINGSSLSHIMS_P256X8_LANES], signs[CCRYPTOBORINGSSLSHIMS_P256X8_LANES];
+        for (size_t l = 0; l < CCRYPTOBORINGSSLSHIMS_P256X8_LANES; l++) {
+            crypto_word_t bits = CCryptoBoringSSLShims_p256x8_get_bit(&scalars[l], i + 4) << 5;
+            bits |= CCryptoBoringSSLShims_p256x8_get_bit(&scalars[l], i + 3) << 4;
+            bits |= CCryptoBoringSSLShims_p256x8_get_bit(&scalars[l], i + 2) << 3;
+            bits |= CCryptoBoringSSLShims_p256x8_get_bit(&scalars[l], i + 1) << 2;
+            bits |= CCryptoBoringSSLShims_p256x8_get_bit(&scalars[l], i) << 1;
+            bits |= CCryptoBoringSSLShims_p256x8_get_bit(&scalars[l], i - 1);
+            crypto_word_t sign, digit;
+            CCryptoBoringSSL_ec_GFp_nistp_recode_scalar_bits(&sign, &digit, bits);
+            digits[l] = digit;
+            signs[l] = sign;
+        }
+        const __m512i digit = _mm512_loadu_si512(digits);
+        const __mmask8 negate = _mm512_test_epi64_mask(_mm512_loadu_si512(signs), _mm512_loadu_si512(signs));
+        OPENSSL_memset(tmp, 0, sizeof(tmp));
+        for (size_t e = 0; e < 17; e++) {
+            const __mmask8 match = _mm512_cmpeq_epi64_mask(digit, _mm512_set1_epi64((long long)e));
+            for (size_t c = 0; c < 3; c++) {
+                CCryptoBoringSSLShims_p256x8_blend(tmp[c], match, tmp[c], p_pre_comp[e][c]);
+            }
+        }
+        CCryptoBoringSSLShims_p256x8_sub(ftmp, zero, tmp[1]);
+        CCryptoBoringSSLShims_p256x8_blend(tmp[1], negate, tmp[1], ftmp);
+
+        if (!skip) {
+            CCryptoBoringSSLShims_p256x8_point_add(nq[0], nq[1], nq[2], nq[0], nq[1], nq[2], tmp[0], tmp[1],
+                                                   tmp[2]);
+        } else {
+            OPENSSL_memcpy(nq, tmp, sizeof(nq));
+            skip = 0;
+        }
+        CCryptoBoringSSL_OPENSSL_cleanse(digits, sizeof(digits));
+        CCryptoBoringSSL_OPENSSL_cleanse(signs, sizeof(signs));
+    }
+
+    // x = X/Z^2, then out of the Montgomery domain by multiplying by one.
+    const __mmask8 finite = CCryptoBoringSSLShims_p256x8_nz(nq[2]);
+    CCryptoBoringSSLShims_p256x8_inv_square(ftmp, nq[2]);
+    CCryptoBoringSSLShims_p256x8_mul(ftmp, nq[0], ftmp);
+    const uint64_t one[5] = {1, 0, 0, 0, 0};
+    CCryptoBoringSSLShims_p256x8_broadcast(tmp[0], one);
+    CCryptoBoringSSLShims_p256x8_mul(ftmp, ftmp, tmp[0]);
+    CCryptoBoringSSLShims_p256x8_reduce_once(ftmp, CCryptoBoringSSLShims_p256x8_p);
+    CCryptoBoringSSLShims_p256x8_to_bytes(out, ftmp);
+
+    CCryptoBoringSSL_OPENSSL_cleanse(p_pre_comp, sizeof(p_pre_comp));
+    CCryptoBoringSSL_OPENSSL_cleanse(nq, sizeof(nq));
+    CCryptoBoringSSL_OPENSSL_cleanse(tmp, sizeof(tmp));
+    CCryptoBoringSSL_OPENSSL_cleanse(ftmp, sizeof(ftmp));
+    return finite;
+}
+#endif  // CCRYPTOBORINGSSLSHIMS_P256_IFMA
+
+int CCryptoBoringSSLShims_p256_ecdh_batch(void *out_secrets, const void *private_scalars, const void *peer_points,
+                                          size_t count) {
+    uint8_t *out = out_secrets;
+    const uint8_t *scalars_in = private_scalars;
+    const uint8_t *points_in = peer_points;
+    int ok = 1;
+
+#if defined(CCRYPTOBORINGSSLSHIMS_P256_IFMA)
+    if (count > 1 && CCryptoBoringSSLShims_is_AVX512IFMA_capable()) {
+        const EC_GROUP *group = CCryptoBoringSSL_EC_group_p256();
+        for (size_t i = 0; i < count; i += CCRYPTOBORINGSSLSHIMS_P256X8_LANES) {
+            const size_t n = count - i < CCRYPTOBORINGSSLSHIMS_P256X8_LANES ? count - i
+                                                                            : CCRYPTOBORINGSSLSHIMS_P256X8_LANES;
+            EC_SCALAR scalars[CCRYPTOBORINGSSLSHIMS_P256X8_LANES];
+            uint8_t x[CCRYPTOBORINGSSLSHIMS_P256X8_LANES][32], y[CCRYPTOBORINGSSLSHIMS_P256X8_LANES][32];
+            uint8_t secrets[CCRYPTOBORINGSSLSHIMS_P256X8_LANES][32];
+            // Unused and invalid lanes multiply (0, 0) by zero, and their
+            // output is dropped.
+            OPENSSL_memset(scalars, 0, sizeof(scalars));
+            OPENSSL_memset(x, 0, sizeof(x));
+            OPENSSL_memset(y, 0, sizeof(y));
+            for (size_t l = 0; l < n; l++) {
+                const uint8_t *point = points_in + CCryptoBoringSSLShims_P256_UNCOMPRESSED_POINT_BYTES * (i + l);
+                EC_AFFINE peer;
+                if (!CCryptoBoringSSL_ec_scalar_from_bytes(group, &scalars[l],
+                                                           scalars_in + CCryptoBoringSSLShims_P256_SCALAR_BYTES * (i + l),
+                                                           CCryptoBoringSSLShims_P256_SCALAR_BYTES) ||
+                    CCryptoBoringSSL_ec_scalar_is_zero(group, &scalars[l]) ||
+                    !CCryptoBoringSSL_ec_point_from_uncompressed(group, &peer, point,
+                                                                 CCryptoBoringSSLShims_P256_UNCOMPRESSED_POINT_BYTES)) {
+                    OPENSSL_memset(&scalars[l], 0, sizeof(scalars[l]));
+                    ok = 0;
+                    continue;
+                }
+                OPENSSL_memcpy(x[l], point + 1, 32);
+                OPENSSL_memcpy(y[l], point + 33, 32);
+            }
+
+            const __mmask8 finite = CCryptoBoringSSLShims_p256x8_ecdh(secrets, scalars, x, y);
+            if ((finite & ((1u << n) - 1)) != ((1u << n) - 1)) {
+                ok = 0;
+            }
+            OPENSSL_memcpy(out + CCryptoBoringSSLShims_P256_SCALAR_BYTES * i, secrets,
+                           CCryptoBoringSSLShims_P256_SCALAR_BYTES * n);
+            CCryptoBoringSSL_OPENSSL_cleanse(scalars, sizeof(scalars));
+            CCryptoBoringSSL_OPENSSL_cleanse(secrets, sizeof(secrets));
+        }
+        goto out;
+    }
+#endif
+
+    for (size_t i = 0; i < count; i++) {
+        ok &= CCryptoBoringSSLShims_p256_ecdh(out + CCryptoBoringSSLShims_P256_SCALAR_BYTES * i,
+                                              scalars_in + CCryptoBoringSSLShims_P256_SCALAR_BYTES * i,
+                                              points_in + CCryptoBoringSSLShims_P256_UNCOMPRESSED_POINT_BYTES * i);
+    }
+
+#if defined(CCRYPTOBORINGSSLSHIMS_P256_IFMA)
+out:
+#endif
+    if (!ok) {
+        CCryptoBoringSSL_OPENSSL_cleanse(out, CCryptoBoringSSLShims_P256_SCALAR_BYTES * count);
+    }
+    return ok;
+}
+
+// MARK:- safegcd inversion
+
+#if defined(BORINGSSL_HAS_UINT128) && defined(OPENSSL_64_BIT)
+
+// Constant-time modular inversion with Bernstein and Yang's divsteps, in the
+// form libsecp256k1 uses. Numbers are held as signed 62-bit limbs. Each
+// iteration runs 62 divsteps on the low limbs of f and g alone, then applies
+// the 2×2 transition matrix they produce to the full-width f, g, d and e. The
+// number of iterations depends only on the size of the modulus, and is the
+// bound from section 11 of the paper.
+//
+// BoringSSL inverts mod the P-384 and P-521 fields and orders, and mod the
+// P-256 order outside the nistz256 assembly, by Fermat exponentiation: one
+// Montgomery squaring per bit of the modulus, plus the multiplications. This
+// costs a fraction of that.
+
+#define SAFEGCD_MAX_LIMBS 10
+#define SAFEGCD_M62 (UINT64_MAX >> 2)
+
+typedef struct {
+    // All limbs but the last are in [0, 2⁶²). The last is signed.
+    int64_t v[SAFEGCD_MAX_LIMBS];
+} safegcd_signed62;
+
+typedef struct {
+    safegcd_signed62 modulus;
+    // modulus⁻¹ mod 2⁶².
+    uint64_t modulus_inv62;
+    size_t limbs;
+    size_t iterations;
+} safegcd_modinfo;
+
+typedef struct {
+    int64_t u, v, q, r;
+} safegcd_trans2x2;
+
+static void safegcd_from_words(safegcd_signed62 *out, const BN_ULONG *words, size_t width, size_t limbs) {
+    for (size_t i = 0; i < limbs; i++) {
+        size_t word = (62 * i) / 64, shift = (62 * i) % 64;
+        uint64_t limb = 0;
+        if (word < width) {
+            limb = words[word] >> shift;
+        }
+        if (shift > 2 && word + 1 < width) {
+            limb |= words[word + 1] << (64 - shift);
+        }
+        out->v[i] = (int64_t)(limb & SAFEGCD_M62);
+    }
+}
+
+// |in| must be normalized, so that every limb is in [0, 2⁶²).
+static void safegcd_to_words(BN_ULONG *words, size_t width, const safegcd_signed62 *in, size_t limbs) {
+    OPENSSL_memset(words, 0, width * sizeof(BN_ULONG));
+    for (size_t i = 0; i < limbs; i++) {
+        size_t word = (62 * i) / 64, shift = (62 * i) % 64;
+        uint64_t limb = (uint64_t)in->v[i];
+        if (word < width) {
+            words[word] |= limb << shift;
+        }
+        if (shift > 2 && word + 1 < width) {
+            words[word + 1] |= limb >> (64 - shift);
+        }
+    }
+}
+
+// Sets |info| up for the odd modulus of |mont|. Returns zero if the modulus is
+// too small for the divstep bound used here or too large for the limbs.
+static int safegcd_modinfo_init(safegcd_modinfo *info, const BN_MONT_CTX *mont) {
+    const BIGNUM *modulus = &mont->N;
+    size_t bits = CCryptoBoringSSL_BN_num_bits(modulus);
+    if (bits < 46 || bits / 62 + 1 > SAFEGCD_MAX_LIMBS) {
+        return 0;
+    }
+    info->limbs = bits / 62 + 1;
+    // Theorem 11.2: (49d + 57) / 17 divsteps suffice for inputs of d ≥ 46 bits.
+    info->iterations = ((49 * bits + 57) / 17 + 61) / 62;
+    OPENSSL_memset(&info->modulus, 0, sizeof(info->modulus));
+    safegcd_from_words(&info->modulus, modulus->d, modulus->width, info->limbs);
+
+    // Newton's iteration doubles the number of correct low bits each time,
+    // starting from the three that any odd number has as its own inverse.
+    uint64_t m = modulus->d[0], inv = m;
+    for (int i = 0; i < 5; i++) {
+        inv *= 2 - m * inv;
+    }
+    info->modulus_inv62 = inv & SAFEGCD_M62;
+    return 1;
+}
+
+// Runs 62 divsteps on the low bits of f and g, with eta = -delta, and records
+// their effect in |t|, scaled so that 2⁶²·f' = u·f + v·g and
+// 2⁶²·g' = q·f + r·g. Returns the new eta.
+static int64_t safegcd_divsteps_62(int64_t eta, uint64_t f, uint64_t g, safegcd_trans2x2 *t) {
+    uint64_t u = 1, v = 0, q = 0, r = 1;
+    for (int i = 0; i < 62; i++) {
+        // c1 is all ones if delta > 0, and c2 if g is odd.
+        uint64_t c1 = (uint64_t)(eta >> 63);
+        uint64_t c2 = -(g & 1);
+        uint64_t x = (f ^ c1) - c1;
+        uint64_t y = (u ^ c1) - c1;
+        uint64_t z = (v ^ c1) - c1;
+        g += x & c2;
+        q += y & c2;
+        r += z & c2;
+        // When both hold, swap: f takes the old g and delta becomes 1 - delta.
+        c1 &= c2;
+        eta = (eta ^ (int64_t)c1) - ((int64_t)c1 + 1);
+        f += g & c1;
+        u += q & c1;
+        v += r & c1;
+        g >>= 1;
+        u <<= 1;
+        v <<= 1;
+    }
+    t->u = (int64_t)u;
+    t->v = (int64_t)v;
+    t->q = (int64_t)q;
+    t->r = (int64_t)r;
+    return eta;
+}
+
+// Applies |t| to d and e mod the modulus, adding the multiple of the modulus
+// that makes the low 62 bits vanish before dividing by 2⁶². d and e stay in
+// (-2·modulus, modulus).
+static void safegcd_update_de(safegcd_signed62 *d, safegcd_signed62 *e, const safegcd_trans2x2 *t,
+                              const safegcd_modinfo *info) {
+    const size_t n = info->limbs;
+    const int64_t u = t->u, v = t->v, q = t->q, r = t->r;
+    int64_t sd = d->v[n - 1] >> 63, se = e->v[n - 1] >> 63;
+    int64_t md = (u & sd) + (v & se);
+    int64_t me = (q & sd) + (r & se);
+    int128_t cd = (int128_t)u * d->v[0] + (int128_t)v * e->v[0];
+    int128_t ce = (int128_t)q * d->v[0] + (int128_t)r * e->v[0];
+    md -= (int64_t)((info->modulus_inv62 * (uint64_t)cd + (uint64_t)md) & SAFEGCD_M62);
+    me -= (int64_t)((info->modulus_inv62 * (uint64_t)ce + (uint64_t)me) & SAFEGCD_M62);
+    cd += (int128_t)info->modulus.v[0] * md;
+    ce += (int128_t)info->modulus.v[0] * me;
+    cd >>= 62;
+    ce >>= 62;
+    for (size_t i = 1; i < n; i++) {
+        cd += (int128_t)u * d->v[i] + (int128_t)v * e->v[i] + (int128_t)info->modulus.v[i] * md;
+        ce += (int128_t)q * d->v[i] + (int128_t)r * e->v[i] + (int128_t)info->modulus.v[i] * me;
+        d->v[i - 1] = (int64_t)((uint64_t)cd & SAFEGCD_M62);
+        e->v[i - 1] = (int64_t)((uint64_t)ce & SAFEGCD_M62);
+        cd >>= 62;
+        ce >>= 62;
+    }
+    d->v[n - 1] = (int64_t)cd;
+    e->v[n - 1] = (int64_t)ce;
+}
+
+// Applies |t| to f and g, whose low 62 bits it leaves zero, and divides by 2⁶².
+static void safegcd_update_fg(safegcd_signed62 *f, safegcd_signed62 *g, const safegcd_trans2x2 *t, size_t n) {
+    const int64_t u = t->u, v = t->v, q = t->q, r = t->r;
+    int128_t cf = (int128_t)u * f->v[0] + (int128_t)v * g->v[0];
+    int128_t cg = (int128_t)q * f->v[0] + (int128_t)r * g->v[0];
+    cf >>= 62;
+    cg >>= 62;
+    for (size_t i = 1; i < n; i++) {
+        cf += (int128_t)u * f->v[i] + (int128_t)v * g->v[i];
+        cg += (int128_t)q * f->v[i] + (int128_t)r * g->v[i];
+        f->v[i - 1] = (int64_t)((uint64_t)cf & SAFEGCD_M62);
+        g->v[i - 1] = (int64_t)((uint64_t)cg & SAFEGCD_M62);
+        cf >>= 62;
+        cg >>= 62;
+    }
+    f->v[n - 1] = (int64_t)cf;
+    g->v[n - 1] = (int64_t)cg;
+}
+
+static void safegcd_propagate(safegcd_signed62 *r, size_t n) {
+    for (size_t i = 0; i + 1 < n; i++) {
+        r->v[i + 1] += r->v[i] >> 62;
+        r->v[i] &= (int64_t)SAFEGCD_M62;
+    }
+}
+
+// Takes r from (-2·modulus, modulus) to [0, modulus), negating it first if
+// |sign| is negative.
+static void safegcd_normalize(safegcd_signed62 *r, int64_t sign, const safegcd_modinfo *info) {
+    const size_t n = info->limbs;
+    int64_t cond_add = r->v[n - 1] >> 63;
+    for (size_t i = 0; i < n; i++) {
+        r->v[i] += info->modulus.v[i] & cond_add;
+    }
+    int64_t cond_negate = sign >> 63;
+    for (size_t i = 0; i < n; i++) {
+        r->v[i] = (r->v[i] ^ cond_negate) - cond_negate;
+    }
+    safegcd_propagate(r, n);
+
+    cond_add = r->v[n - 1] >> 63;
+    for (size_t i = 0; i < n; i++) {
+        r->v[i] += info->modulus.v[i] & cond_add;
+    }
+    safegcd_propagate(r, n);
+}
+
+// Sets |out| to a⁻¹ mod the modulus, or to zero if |a| is zero. |a| must be
+// fully reduced, and both are |width| words. |out| and |a| may alias.
+static void safegcd_inverse(BN_ULONG *out, const BN_ULONG *a, size_t width, const safegcd_modinfo *info) {
+    safegcd_signed62 d = {{0}}, e = {{1}}, f = info->modulus, g = {{0}};
+    safegcd_trans2x2 t;
+    safegcd_from_words(&g, a, width, info->limbs);
+    int64_t eta = -1;
+    for (size_t i = 0; i < info->iterations; i++) {
+        eta = safegcd_divsteps_62(eta, (uint64_t)f.v[0], (uint64_t)g.v[0], &t);
+        safegcd_update_de(&d, &e, &t, info);
+        safegcd_update_fg(&f, &g, &t, info->limbs);
+    }
+    // g is now zero and f is ±gcd(modulus, a), which is ±1 unless a is zero.
+    safegcd_normalize(&d, f.v[info->limbs - 1], info);
+    safegcd_to_words(out, width, &d, info->limbs);
+
+    CCryptoBoringSSL_OPENSSL_cleanse(&d, sizeof(d));
+    CCryptoBoringSSL_OPENSSL_cleanse(&e, sizeof(e));
+    CCryptoBoringSSL_OPENSSL_cleanse(&f, sizeof(f));
+    CCryptoBoringSSL_OPENSSL_cleanse(&g, sizeof(g));
+    CCryptoBoringSSL_OPENSSL_cleanse(&t, sizeof(t));
+}
+
+#endif  // BORINGSSL_HAS_UINT128 && OPENSSL_64_BIT
+
+// Sets |out| to the Montgomery form of a⁻¹ mod the order, for a plain |a|, or
+// to zero if |a| is zero. Curves whose scalar inversion is the generic Fermat
+// one use safegcd. The nistz256 P-256 order inversion is already a tuned
+// assembly addition chain, so it is kept.
+static void CCryptoBoringSSLShims_ec_scalar_inv0_to_montgomery(const EC_GROUP *group, EC_SCALAR *out,
+                                                               const EC_SCALAR *a) {
+#if defined(BORINGSSL_HAS_UINT128) && defined(OPENSSL_64_BIT)
+    safegcd_modinfo info;
+    if (group->meth->scalar_inv0_montgomery == CCryptoBoringSSL_ec_simple_scalar_inv0_montgomery &&
+        safegcd_modinfo_init(&info, &group->order)) {
+        safegcd_inverse(out->words, a->words, group->order.N.width, &info);
+        CCryptoBoringSSL_ec_scalar_to_montgomery(group, out, out);
+        return;
+    }
+#endif
+    // Inverting and then leaving the Montgomery domain leaves a⁻¹·R, as in
+    // |ecdsa_sign_impl|.
+    CCryptoBoringSSL_ec_scalar_inv0_montgomery(group, out, a);
+    CCryptoBoringSSL_ec_scalar_from_montgomery(group, out, out);
+}
+
+// As |ec_get_x_coordinate_as_scalar|. Groups on the generic Montgomery method,
+// P-384 and P-521, invert Z with safegcd. The P-256 methods have their own
+// tuned field inversions.
+static int CCryptoBoringSSLShims_ec_get_x_coordinate_as_scalar(const EC_GROUP *group, EC_SCALAR *out,
+                                                               const EC_JACOBIAN *p) {
+#if defined(BORINGSSL_HAS_UINT128) && defined(OPENSSL_64_BIT)
+    safegcd_modinfo info;
+    if (group->meth == CCryptoBoringSSL_EC_GFp_mont_method() &&
+        !constant_time_declassify_int(CCryptoBoringSSL_ec_GFp_simple_is_at_infinity(group, p)) &&
+        safegcd_modinfo_init(&info, &group->field)) {
+        // Z is z·R. Its plain inverse is z⁻¹·R⁻¹, which two conversions take
+        // to z⁻¹·R, the Montgomery form of z⁻¹.
+        const size_t width = group->field.N.width;
+        EC_FELEM zinv, x;
+        safegcd_inverse(zinv.words, p->Z.words, width, &info);
+        CCryptoBoringSSL_bn_to_montgomery_small(zinv.words, zinv.words, width, &group->field);
+        CCryptoBoringSSL_bn_to_montgomery_small(zinv.words, zinv.words, width, &group->field);
+        CCryptoBoringSSL_ec_GFp_mont_felem_sqr(group, &zinv, &zinv);
+        CCryptoBoringSSL_ec_GFp_mont_felem_mul(group, &x, &p->X, &zinv);
+
+        // Reduce mod the order, which is more than half of p, as
+        // |ec_get_x_coordinate_as_scalar| does.
+        uint8_t bytes[EC_MAX_BYTES];
+        size_t len;
+        CCryptoBoringSSL_ec_GFp_mont_felem_to_bytes(group, bytes, &len, &x);
+        const BIGNUM *order = CCryptoBoringSSL_EC_GROUP_get0_order(group);
+        BN_ULONG words[EC_MAX_WORDS + 1] = {0};
+        CCryptoBoringSSL_bn_big_endian_to_words(words, order->width + 1, bytes, len);
+        CCryptoBoringSSL_bn_reduce_once(out->words, words, words[order->width], order->d, order->width);
+        return 1;
+    }
+#endif
+    return CCryptoBoringSSL_ec_get_x_coordinate_as_scalar(group, out, p);
+}
+
+// MARK:- Fixed-width ECDSA
+
+typedef struct {
+    EC_SCALAR r;
+    // k⁻¹ in the Montgomery domain.
+    EC_SCALAR k_inv_mont;
+} CCryptoBoringSSLShims_ecdsa_presignature_st;
+
+_Static_assert(sizeof(CCryptoBoringSSLShims_ecdsa_presignature_st) <= sizeof(CCryptoBoringSSLShims_ecdsa_presignature),
+               "ECDSA presignature size");
+
+// Mirrors |digest_to_scalar| in ecdsa.c, which is static.
+static void CCryptoBoringSSLShims_ecdsa_digest_to_scalar(const EC_GROUP *group, EC_SCALAR *out,
+                                                         const uint8_t *digest, size_t digest_len) {
+    const BIGNUM *order = CCryptoBoringSSL_EC_GROUP_get0_order(group);
+    size_t num_bits = CCryptoBoringSSL_BN_num_bits(order);
+    size_t num_bytes = (num_bits + 7) / 8;
+    if (digest_len > num_bytes) {
+        digest_len = num_bytes;
+    }
+    CCryptoBoringSSL_bn_big_endian_to_words(out->words, order->width, digest, digest_len);
+    if (8 * digest_len > num_bits) {
+        CCryptoBoringSSL_bn_rshift_words(out->words, out->words, 8 - (num_bits & 0x7), order->width);
+    }
+    BN_ULONG tmp[EC_MAX_WORDS];
+    CCryptoBoringSSL_bn_reduce_once_in_place(out->words, 0, order->d, tmp, order->width);
+}
+
+// Draws a nonce k with |additional_data| mixed into the RNG and computes the
+// message-independent half of a signature.
+static int CCryptoBoringSSLShims_ecdsa_presign_impl(const EC_GROUP *group,
+                                                    CCryptoBoringSSLShims_ecdsa_presignature_st *out,
+                                                    const uint8_t additional_data[SHA512_DIGEST_LENGTH]) {
+    EC_SCALAR k;
+    EC_JACOBIAN point;
+    int ok = 0;
+    for (;;) {
+        if (!CCryptoBoringSSL_ec_random_nonzero_scalar(group, &k, additional_data) ||
+            !CCryptoBoringSSL_ec_point_mul_scalar_base(group, &point, &k) ||
+            !CCryptoBoringSSLShims_ec_get_x_coordinate_as_scalar(group, &out->r, &point)) {
+            goto out;
+        }
+        if (!CCryptoBoringSSL_ec_scalar_is_zero(group, &out->r)) {
+            break;
+        }
+    }
+
+    CCryptoBoringSSLShims_ec_scalar_inv0_to_montgomery(group, &out->k_inv_mont, &k);
+    ok = 1;
+
+out:
+    CCryptoBoringSSL_OPENSSL_cleanse(&k, sizeof(k));
+    return ok;
+}
+
+// Computes s = k⁻¹ · (m + priv_key · r), with the same Montgomery bookkeeping
+// as |ecdsa_sign_impl|, and writes r || s to |out_signature|.
+static int CCryptoBoringSSLShims_ecdsa_sign_impl(const EC_GROUP *group, uint8_t *out_signature,
+                                                 size_t *out_signature_len, const EC_SCALAR *priv_key,
+                                                 const uint8_t *digest, size_t digest_len,
+                                                 const CCryptoBoringSSLShims_ecdsa_presignature_st *presignature) {
+    EC_SCALAR s, m;
+    CCryptoBoringSSL_ec_scalar_to_montgomery(group, &s, &presignature->r);
+    CCryptoBoringSSL_ec_scalar_mul_montgomery(group, &s, priv_key, &s);
+    CCryptoBoringSSLShims_ecdsa_digest_to_scalar(group, &m, digest, digest_len);
+    CCryptoBoringSSL_ec_scalar_add(group, &s, &s, &m);
+    CCryptoBoringSSL_ec_scalar_mul_montgomery(group, &s, &s, &presignature->k_inv_mont);
+
+    int ok = !CCryptoBoringSSL_ec_scalar_is_zero(group, &s);
+    if (ok) {
+        size_t r_len, s_len;
+        CCryptoBoringSSL_ec_scalar_to_bytes(group, out_signature, &r_len, &presignature->r);
+        CCryptoBoringSSL_ec_scalar_to_bytes(group, out_signature + r_len, &s_len, &s);
+        *out_signature_len = r_len + s_len;
+    }
+    CCryptoBoringSSL_OPENSSL_cleanse(&s, sizeof(s));
+    return ok;
+}
+
+int CCryptoBoringSSLShims_ecdsa_presign(CCryptoBoringSSLShims_ecdsa_presignature *out, int curve_nid,
+                                        const void *private_key, size_t private_key_len) {
+    const EC_GROUP *group = CCryptoBoringSSL_EC_GROUP_new_by_curve_name(curve_nid);
+    if (group == NULL) {
+        return 0;
+    }
+
+    uint8_t additional_data[SHA512_DIGEST_LENGTH];
+    CCryptoBoringSSL_SHA512(private_key, private_key_len, additional_data);
+    int ok = CCryptoBoringSSLShims_ecdsa_presign_impl(group, (CCryptoBoringSSLShims_ecdsa_presignature_st *)out,
+                                                      additional_data);
+    CCryptoBoringSSL_OPENSSL_cleanse(additional_data, sizeof(additional_data));
+    return ok;
+}
+
+int CCryptoBoringSSLShims_ecdsa_sign_presigned(void *out_signature, size_t *out_signature_len, int curve_nid,
+                                               const void *private_key, size_t private_key_len,
+                                               const void *digest, size_t digest_len,
+                                               CCryptoBoringSSLShims_ecdsa_presignature *presignature) {
+    const EC_GROUP *group = CCryptoBoringSSL_EC_GROUP_new_by_curve_name(curve_nid);
+    EC_SCALAR priv_key;
+    int ok = group != NULL &&
+             CCryptoBoringSSL_ec_scalar_from_bytes(group, &priv_key, private_key, private_key_len) &&
+             CCryptoBoringSSLShims_ecdsa_sign_impl(group, out_signature, out_signature_len, &priv_key,
+                                                    digest, digest_len,
+                                                    (const CCryptoBoringSSLShims_ecdsa_presignature_st *)presignature);
+    CCryptoBoringSSL_OPENSSL_cleanse(&priv_key, sizeof(priv_key));
+    CCryptoBoringSSL_OPENSSL_cleanse(presignature, sizeof(*presignature));
+    return ok;
+}
+
+// As in |ECDSA_do_sign|, the private key and digest are mixed into the RNG as a
+// hedge against entropy failure.
+static void CCryptoBoringSSLShims_ecdsa_additional_data(const EC_GROUP *group,
+                                                        uint8_t out[SHA512_DIGEST_LENGTH],
+                                                        const EC_SCALAR *priv_key,
+                                                        const uint8_t *digest, size_t digest_len) {
+    SHA512_CTX sha;
+    CCryptoBoringSSL_SHA512_Init(&sha);
+    CCryptoBoringSSL_SHA512_Update(&sha, priv_key->words, CCryptoBoringSSL_EC_GROUP_get0_order(group)->width * sizeof(BN_ULONG));
+    CCryptoBoringSSL_SHA512_Update(&sha, digest, digest_len);
+    CCryptoBoringSSL_SHA512_Final(out, &sha);
+    CCryptoBoringSSL_OPENSSL_cleanse(&sha, sizeof(sha));
+}
+
+// Signs |digest| with a fresh nonce, drawing another in the unlikely event
+// that s comes out as zero.
+static int CCryptoBoringSSLShims_ecdsa_sign_fresh(const EC_GROUP *group, uint8_t *out_signature,
+                                                  size_t *out_signature_len, const EC_SCALAR *priv_key,
+                                                  const uint8_t *digest, size_t digest_len) {
+    uint8_t additional_data[SHA512_DIGEST_LENGTH];
+    CCryptoBoringSSLShims_ecdsa_additional_data(group, additional_data, priv_key, digest, digest_len);
+
+    CCryptoBoringSSLShims_ecdsa_presignature_st presignature;
+    int ok = 0;
+    for (;;) {
+        if (!CCryptoBoringSSLShims_ecdsa_presign_impl(group, &presignature, additional_data)) {
+            break;
+        }
+        if (CCryptoBoringSSLShims_ecdsa_sign_impl(group, out_signature, out_signature_len, priv_key,
+                                                  digest, digest_len, &presignature)) {
+            ok = 1;
+            break;
+        }
+    }
+
+    CCryptoBoringSSL_OPENSSL_cleanse(&presignature, sizeof(presignature));
+    CCryptoBoringSSL_OPENSSL_cleanse(additional_data, sizeof(additional_data));
+    return ok;
+}
+
+int CCryptoBoringSSLShims_ECDSA_sign_raw(void *out_signature, size_t *out_signature_len, size_t max_out,
+                                         const void *digest, size_t digest_len, const EC_KEY *eckey) {
+    const EC_GROUP *group = CCryptoBoringSSL_EC_KEY_get0_group(eckey);
+    if (group == NULL || eckey->priv_key == NULL ||
+        max_out < 2 * CCryptoBoringSSL_BN_num_bytes(CCryptoBoringSSL_EC_GROUP_get0_order(group))) {
+        return 0;
+    }
+    CCRYPTOBORINGSSLSHIMS_TRACE_ENTRY(ecdsa_sign, CCryptoBoringSSL_EC_GROUP_get_curve_name(group),
+                                      CCryptoBoringSSL_EC_GROUP_get_degree(group), digest_len);
+    int ok = CCryptoBoringSSLShims_ecdsa_sign_fresh(group, out_signature, out_signature_len,
+                                                    &eckey->priv_key->scalar, digest, digest_len);
+    CCRYPTOBORINGSSLSHIMS_TRACE_RETURN(ecdsa_sign, CCryptoBoringSSL_EC_GROUP_get_curve_name(group),
+                                       CCryptoBoringSSL_EC_GROUP_get_degree(group), digest_len, ok);
+    return ok;
+}
+
+// Like |ec_scalar_from_bytes|, but a scalar out of range is reported only
+// through the return value. Verifiers see attacker-chosen signatures, and an
+// error queue entry costs more than the rejection itself.
+static int CCryptoBoringSSLShims_ec_scalar_from_bytes_quiet(const EC_GROUP *group, EC_SCALAR *out,
+                                                            const uint8_t *in, size_t len) {
+    const BIGNUM *order = &group->order.N;
+    if (len != CCryptoBoringSSL_BN_num_bytes(order)) {
+        return 0;
+    }
+    CCryptoBoringSSL_bn_big_endian_to_words(out->words, order->width, in, len);
+    return CCryptoBoringSSL_bn_less_than_words(out->words, order->d, order->width);
+}
+
+static int CCryptoBoringSSLShims_ecdsa_verify_raw(const EC_GROUP *group, const EC_JACOBIAN *pub_key,
+                                                  const void *digest, size_t digest_len,
+                                                  const void *signature, size_t signature_len) {
+
+    // Mirrors |ecdsa_do_verify_no_self_test|, but parses r and s straight into
+    // scalars. Each must be exactly the width of the order.
+    size_t half = CCryptoBoringSSL_BN_num_bytes(CCryptoBoringSSL_EC_GROUP_get0_order(group));
+    const uint8_t *signature_bytes = signature;
+    EC_SCALAR r, s, u1, u2, s_inv_mont, m;
+    if (signature_len != 2 * half ||
+        !CCryptoBoringSSLShims_ec_scalar_from_bytes_quiet(group, &r, signature_bytes, half) ||
+        CCryptoBoringSSL_ec_scalar_is_zero(group, &r) ||
+        !CCryptoBoringSSLShims_ec_scalar_from_bytes_quiet(group, &s, signature_bytes + half, half) ||
+        CCryptoBoringSSL_ec_scalar_is_zero(group, &s) ||
+        !CCryptoBoringSSL_ec_scalar_to_montgomery_inv_vartime(group, &s_inv_mont, &s)) {
+        return 0;
+    }
+
+    CCryptoBoringSSLShims_ecdsa_digest_to_scalar(group, &m, digest, digest_len);
+    CCryptoBoringSSL_ec_scalar_mul_montgomery(group, &u1, &m, &s_inv_mont);
+    CCryptoBoringSSL_ec_scalar_mul_montgomery(group, &u2, &r, &s_inv_mont);
+
+    EC_JACOBIAN point;
+    return CCryptoBoringSSL_ec_point_mul_scalar_public(group, &point, &u1, pub_key, &u2) &&
+           CCryptoBoringSSL_ec_cmp_x_coordinate(group, &point, &r);
+}
+
+int CCryptoBoringSSLShims_ECDSA_verify_raw(const void *digest, size_t digest_len,
+                                           const void *signature, size_t signature_len, const EC_KEY *eckey) {
+    const EC_GROUP *group = CCryptoBoringSSL_EC_KEY_get0_group(eckey);
+    const EC_POINT *pub_key = CCryptoBoringSSL_EC_KEY_get0_public_key(eckey);
+    if (group == NULL || pub_key == NULL) {
+        return 0;
+    }
+    CCRYPTOBORINGSSLSHIMS_TRACE_ENTRY(ecdsa_verify, CCryptoBoringSSL_EC_GROUP_get_curve_name(group),
+                                      CCryptoBoringSSL_EC_GROUP_get_degree(group), digest_len);
+    int valid = CCryptoBoringSSLShims_ecdsa_verify_raw(group, &pub_key->raw, digest, digest_len, signature, signature_len);
+    CCRYPTOBORINGSSLSHIMS_TRACE_RETURN(ecdsa_verify, CCryptoBoringSSL_EC_GROUP_get_curve_name(group),
+                                       CCryptoBoringSSL_EC_GROUP_get_degree(group), digest_len, valid);
+    return valid;
+}
+
+// Signatures whose s^-1 share one inversion in |CCryptoBoringSSLShims_ECDSA_verify_batch|.
+#define CCRYPTOBORINGSSLSHIMS_ECDSA_VERIFY_CHUNK 32
+
+// Verifies as |CCryptoBoringSSLShims_ecdsa_verify_raw| does, but inverts the s
+// of a whole chunk at once by Montgomery's trick. Each signature still gets its
+// own |ec_point_mul_scalar_public|: |ec_point_mul_scalar_public_batch| sums its
+// terms into one point, which only helps schemes that can check a random
+// combination of signatures, and ECDSA's R is not known in full. The final x
+// comparison is already projective, so no affine conversion is left to share.
+size_t CCryptoBoringSSLShims_ECDSA_verify_batch(const EC_KEY *eckey,
+                                                const CCryptoBoringSSLShims_ECDSA_verify_batch_op *ops,
+                                                size_t ops_count, int *results) {
+    const EC_GROUP *group = CCryptoBoringSSL_EC_KEY_get0_group(eckey);
+    const EC_POINT *pub_key = CCryptoBoringSSL_EC_KEY_get0_public_key(eckey);
+    OPENSSL_memset(results, 0, ops_count * sizeof(int));
+    if (group == NULL || pub_key == NULL) {
+        return 0;
+    }
+    const size_t half = CCryptoBoringSSL_BN_num_bytes(CCryptoBoringSSL_EC_GROUP_get0_order(group));
+
+    size_t valid = 0;
+    for (size_t first = 0; first < ops_count; first += CCRYPTOBORINGSSLSHIMS_ECDSA_VERIFY_CHUNK) {
+        const size_t remaining = ops_count - first;
+        const size_t count = remaining < CCRYPTOBORINGSSLSHIMS_ECDSA_VERIFY_CHUNK ? remaining
+                                                                                 : CCRYPTOBORINGSSLSHIMS_ECDSA_VERIFY_CHUNK;
+
+        // The well-formed signatures of the chunk, with s in Montgomery form
+        // and the running products of those s.
+        EC_SCALAR r[CCRYPTOBORINGSSLSHIMS_ECDSA_VERIFY_CHUNK], s_mont[CCRYPTOBORINGSSLSHIMS_ECDSA_VERIFY_CHUNK];
+        EC_SCALAR products[CCRYPTOBORINGSSLSHIMS_ECDSA_VERIFY_CHUNK];
+        size_t index[CCRYPTOBORINGSSLSHIMS_ECDSA_VERIFY_CHUNK];
+        size_t parsed = 0;
+        for (size_t i = 0; i < count; i++) {
+            const CCryptoBoringSSLShims_ECDSA_verify_batch_op *op = &ops[first + i];
+            const uint8_t *signature_bytes = op->signature;
+            EC_SCALAR s;
+            if (op->signature_len != 2 * half ||
+                !CCryptoBoringSSLShims_ec_scalar_from_bytes_quiet(group, &r[parsed], signature_bytes, half) ||
+                CCryptoBoringSSL_ec_scalar_is_zero(group, &r[parsed]) ||
+                !CCryptoBoringSSLShims_ec_scalar_from_bytes_quiet(group, &s, signature_bytes + half, half) ||
+                CCryptoBoringSSL_ec_scalar_is_zero(group, &s)) {
+                continue;
+            }
+            CCryptoBoringSSL_ec_scalar_to_montgomery(group, &s_mont[parsed], &s);
+            if (parsed == 0) {
+                products[0] = s_mont[0];
+            } else {
+                CCryptoBoringSSL_ec_scalar_mul_montgomery(group, &products[parsed], &products[parsed - 1],
+                                                          &s_mont[parsed]);
+            }
+            index[parsed++] = first + i;
+        }
+        if (parsed == 0) {
+            continue;
+        }
+
+        // The order is prime and no s is zero, so the product is invertible.
+        EC_SCALAR product, inverse;
+        CCryptoBoringSSL_ec_scalar_from_montgomery(group, &product, &products[parsed - 1]);
+        if (!CCryptoBoringSSL_ec_scalar_to_montgomery_inv_vartime(group, &inverse, &product)) {
+            continue;
+        }
+
+        for (size_t j = parsed; j-- > 0;) {
+            // |inverse| is the inverse of products[j], so multiplying by
+            // products[j - 1] leaves the inverse of s_j alone.
+            EC_SCALAR s_inv_mont;
+            if (j > 0) {
+                CCryptoBoringSSL_ec_scalar_mul_montgomery(group, &s_inv_mont, &inverse, &products[j - 1]);
+                CCryptoBoringSSL_ec_scalar_mul_montgomery(group, &inverse, &inverse, &s_mont[j]);
+            } else {
+                s_inv_mont = inverse;
+            }
+
+            const CCryptoBoringSSLShims_ECDSA_verify_batch_op *op = &ops[index[j]];
+            CCRYPTOBORINGSSLSHIMS_TRACE_ENTRY(ecdsa_verify, CCryptoBoringSSL_EC_GROUP_get_curve_name(group),
+                                              CCryptoBoringSSL_EC_GROUP_get_degree(group), op->digest_len);
+            EC_SCALAR m, u1, u2;
+            CCryptoBoringSSLShims_ecdsa_digest_to_scalar(group, &m, op->digest, op->digest_len);
+            CCryptoBoringSSL_ec_scalar_mul_montgomery(group, &u1, &m, &s_inv_mont);
+            CCryptoBoringSSL_ec_scalar_mul_montgomery(group, &u2, &r[j], &s_inv_mont);
+
+            EC_JACOBIAN point;
+            results[index[j]] = CCryptoBoringSSL_ec_point_mul_scalar_public(group, &point, &u1, &pub_key->raw, &u2) &&
+                                CCryptoBoringSSL_ec_cmp_x_coordinate(group, &point, &r[j]);
+            CCRYPTOBORINGSSLSHIMS_TRACE_RETURN(ecdsa_verify, CCryptoBoringSSL_EC_GROUP_get_curve_name(group),
+                                               CCryptoBoringSSL_EC_GROUP_get_degree(group), op->digest_len,
+                                               results[index[j]]);
+            valid += (size_t)results[index[j]];
+        }
+    }
+    return valid;
+}
+
+// Decodes x || y into Jacobian coordinates, checking that the point is on the
+// curve. Like |ec_point_from_uncompressed| without the leading 0x04.
+static int CCryptoBoringSSLShims_ec_jacobian_from_raw_point(const EC_GROUP *group, EC_JACOBIAN *out,
+                                                            const uint8_t *point, size_t point_len) {
+    const size_t field_len = CCryptoBoringSSL_BN_num_bytes(&group->field.N);
+    EC_FELEM x, y;
+    EC_AFFINE affine;
+    if (point_len != 2 * field_len ||
+        !CCryptoBoringSSL_ec_felem_from_bytes(group, &x, point, field_len) ||
+        !CCryptoBoringSSL_ec_felem_from_bytes(group, &y, point + field_len, field_len) ||
+        !CCryptoBoringSSL_ec_point_set_affine_coordinates(group, &affine, &x, &y)) {
+        return 0;
+    }
+    CCryptoBoringSSL_ec_affine_to_jacobian(group, out, &affine);
+    return 1;
+}
+
+int CCryptoBoringSSLShims_EC_raw_point_is_valid(int curve_nid, const void *point, size_t point_len) {
+    const EC_GROUP *group = CCryptoBoringSSL_EC_GROUP_new_by_curve_name(curve_nid);
+    EC_JACOBIAN pub_key;
+    return group != NULL && CCryptoBoringSSLShims_ec_jacobian_from_raw_point(group, &pub_key, point, point_len);
+}
+
+int CCryptoBoringSSLShims_ECDSA_verify_raw_point(int curve_nid, const void *point, size_t point_len,
+                                                 const void *digest, size_t digest_len,
+                                                 const void *signature, size_t signature_len) {
+    const EC_GROUP *group = CCryptoBoringSSL_EC_GROUP_new_by_curve_name(curve_nid);
+    EC_JACOBIAN pub_key;
+    if (group == NULL || !CCryptoBoringSSLShims_ec_jacobian_from_raw_point(group, &pub_key, point, point_len)) {
+        return 0;
+    }
+    CCRYPTOBORINGSSLSHIMS_TRACE_ENTRY(ecdsa_verify, curve_nid, CCryptoBoringSSL_EC_GROUP_get_degree(group), digest_len);
+    int valid = CCryptoBoringSSLShims_ecdsa_verify_raw(group, &pub_key, digest, digest_len, signature, signature_len);
+    CCRYPTOBORINGSSLSHIMS_TRACE_RETURN(ecdsa_verify, curve_nid, CCryptoBoringSSL_EC_GROUP_get_degree(group),
+                                       digest_len, valid);
+    return valid;
+}
+
+uint64_t CCryptoBoringSSLShims_fork_generation(void) {
+    return CCryptoBoringSSL_CRYPTO_get_fork_generation();
+}
+
+// MARK:- Batch ECDSA signing
+
+// The number of signatures whose nonces share one inversion mod the order and
+// whose points share one field inversion. Bounds the stack use of
+// |CCryptoBoringSSLShims_ecdsa_sign_batch|.
+#define CCryptoBoringSSLShims_ECDSA_SIGN_CHUNK 32
+
+// Inverts a field element in the Montgomery domain. As in
+// |CCryptoBoringSSLShims_ec_get_x_coordinate_as_scalar|, the generic
+// Montgomery method uses safegcd and the P-256 methods use Fermat's little
+// theorem.
+static void CCryptoBoringSSLShims_ec_felem_inv0_mont(const EC_GROUP *group, EC_FELEM *out, const EC_FELEM *a) {
+    const size_t width = group->field.N.width;
+#if defined(BORINGSSL_HAS_UINT128) && defined(OPENSSL_64_BIT)
+    safegcd_modinfo info;
+    if (group->meth == CCryptoBoringSSL_EC_GFp_mont_method() && safegcd_modinfo_init(&info, &group->field)) {
+        safegcd_inverse(out->words, a->words, width, &info);
+        CCryptoBoringSSL_bn_to_montgomery_small(out->words, out->words, width, &group->field);
+        CCryptoBoringSSL_bn_to_montgomery_small(out->words, out->words, width, &group->field);
+        return;
+    }
+#endif
+    CCryptoBoringSSL_bn_mod_inverse0_prime_mont_small(out->words, a->words, width, &group->field);
+}
+
+// Sets each |out[i]| to the x-coordinate of |in[i]| reduced mod the order, as
+// |ec_get_x_coordinate_as_scalar| does, with one field inversion for all of
+// them. Like |CCryptoBoringSSLShims_p256_jacobian_to_affine_batch|, this
+// relies on the field elements being in Montgomery form, which holds for both
+// P-256 methods and the generic Montgomery one. |scratch| holds |num|
+// elements. Returns zero if any point is at infinity.
+static int CCryptoBoringSSLShims_ec_x_coordinates_as_scalars(const EC_GROUP *group, EC_SCALAR *out,
+                                                             const EC_JACOBIAN *in, EC_FELEM *scratch,
+                                                             size_t num) {
+    scratch[0] = in[0].Z;
+    for (size_t i = 1; i < num; i++) {
+        CCryptoBoringSSL_ec_GFp_mont_felem_mul(group, &scratch[i], &scratch[i - 1], &in[i].Z);
+    }
+    if (CCryptoBoringSSL_ec_felem_non_zero_mask(group, &scratch[num - 1]) == 0) {
+        return 0;
+    }
+
+    const BIGNUM *order = CCryptoBoringSSL_EC_GROUP_get0_order(group);
+    EC_FELEM zinvprod;
+    CCryptoBoringSSLShims_ec_felem_inv0_mont(group, &zinvprod, &scratch[num - 1]);
+    for (size_t i = num - 1; i < num; i--) {
+        EC_FELEM zinv, x;
+        if (i == 0) {
+            zinv = zinvprod;
+        } else {
+            CCryptoBoringSSL_ec_GFp_mont_felem_mul(group, &zinv, &zinvprod, &scratch[i - 1]);
+            CCryptoBoringSSL_ec_GFp_mont_felem_mul(group, &zinvprod, &zinvprod, &in[i].Z);
+        }
+        CCryptoBoringSSL_ec_GFp_mont_felem_sqr(group, &zinv, &zinv);
+        CCryptoBoringSSL_ec_GFp_mont_felem_mul(group, &x, &in[i].X, &zinv);
+
+        uint8_t bytes[EC_MAX_BYTES];
+        size_t len;
+        CCryptoBoringSSL_ec_GFp_mont_felem_to_bytes(group, bytes, &len, &x);
+        BN_ULONG words[EC_MAX_WORDS + 1] = {0};
+        CCryptoBoringSSL_bn_big_endian_to_words(words, order->width + 1, bytes, len);
+        CCryptoBoringSSL_bn_reduce_once(out[i].words, words, words[order->width], order->d, order->width);
+    }
+    return 1;
+}
+
+// Fills |out| with presignatures for |num| nonces, one per digest, inverting
+// all of the nonces at once with Montgomery's trick.
+static int CCryptoBoringSSLShims_ecdsa_presign_batch(const EC_GROUP *group,
+                                                     CCryptoBoringSSLShims_ecdsa_presignature_st *out,
+                                                     const EC_SCALAR *priv_key,
+                                                     const uint8_t *digests, size_t digest_len, size_t num) {
+    EC_SCALAR k[CCryptoBoringSSLShims_ECDSA_SIGN_CHUNK];
+    EC_SCALAR prefix[CCryptoBoringSSLShims_ECDSA_SIGN_CHUNK];
+    EC_SCALAR r[CCryptoBoringSSLShims_ECDSA_SIGN_CHUNK];
+    EC_JACOBIAN points[CCryptoBoringSSLShims_ECDSA_SIGN_CHUNK];
+    EC_FELEM scratch[CCryptoBoringSSLShims_ECDSA_SIGN_CHUNK];
+    EC_SCALAR inv;
+    uint8_t additional_data[SHA512_DIGEST_LENGTH];
+    int ok = 0;
+
+    // Every nonce is drawn on its own, with its own digest mixed into the RNG,
+    // exactly as a single signature would draw it. Only the inversions below
+    // are shared.
+    for (size_t i = 0; i < num; i++) {
+        CCryptoBoringSSLShims_ecdsa_additional_data(group, additional_data, priv_key,
+                                                    digests + i * digest_len, digest_len);
+        if (!CCryptoBoringSSL_ec_random_nonzero_scalar(group, &k[i], additional_data) ||
+            !CCryptoBoringSSL_ec_point_mul_scalar_base(group, &points[i], &k[i])) {
+            goto out;
+        }
+    }
+
+    // No point is at infinity, as every nonce is non-zero and below the order.
+    if (!CCryptoBoringSSLShims_ec_x_coordinates_as_scalars(group, r, points, scratch, num)) {
+        goto out;
+    }
+
+    // Prefix products of the nonces, in the Montgomery domain.
+    for (size_t i = 0; i < num; i++) {
+        CCryptoBoringSSL_ec_scalar_to_montgomery(group, &k[i], &k[i]);
+        if (i == 0) {
+            prefix[0] = k[0];
+        } else {
+            CCryptoBoringSSL_ec_scalar_mul_montgomery(group, &prefix[i], &prefix[i - 1], &k[i]);
+        }
+    }
+    CCryptoBoringSSL_ec_scalar_from_montgomery(group, &inv, &prefix[num - 1]);
+    CCryptoBoringSSLShims_ec_scalar_inv0_to_montgomery(group, &inv, &inv);
+
+    // Walking back, |inv| is the inverse of the first i + 1 nonces' product,
+    // and multiplying it by the first i nonces' product leaves kᵢ⁻¹.
+    for (size_t i = num - 1; i < num; i--) {
+        out[i].r = r[i];
+        if (i == 0) {
+            out[0].k_inv_mont = inv;
+        } else {
+            CCryptoBoringSSL_ec_scalar_mul_montgomery(group, &out[i].k_inv_mont, &inv, &prefix[i - 1]);
+            CCryptoBoringSSL_ec_scalar_mul_montgomery(group, &inv, &inv, &k[i]);
+        }
+    }
+    ok = 1;
+
+out:
+    CCryptoBoringSSL_OPENSSL_cleanse(k, sizeof(k));
+    CCryptoBoringSSL_OPENSSL_cleanse(prefix, sizeof(prefix));
+    CCryptoBoringSSL_OPENSSL_cleanse(&inv, sizeof(inv));
+    CCryptoBoringSSL_OPENSSL_cleanse(additional_data, sizeof(additional_data));
+    return ok;
+}
+
+int CCryptoBoringSSLShims_ecdsa_sign_batch(void *out_signatures, int curve_nid,
+                                           const void *private_key, size_t private_key_len,
+                                           const void *digests, size_t digest_len, size_t count) {
+    if (curve_nid != NID_X9_62_prime256v1 && curve_nid != NID_secp384r1 && curve_nid != NID_secp521r1) {
+        return 0;
+    }
+    const EC_GROUP *group = CCryptoBoringSSL_EC_GROUP_new_by_curve_name(curve_nid);
+    const size_t signature_len = 2 * CCryptoBoringSSL_BN_num_bytes(CCryptoBoringSSL_EC_GROUP_get0_order(group));
+    const uint8_t *digest_bytes = digests;
+    uint8_t *signatures = out_signatures;
+    CCryptoBoringSSLShims_ecdsa_presignature_st presignatures[CCryptoBoringSSLShims_ECDSA_SIGN_CHUNK];
+    EC_SCALAR priv_key;
+    int ok = 0;
+
+    if (!CCryptoBoringSSL_ec_scalar_from_bytes(group, &priv_key, private_key, private_key_len)) {
+        goto out;
+    }
+
+    for (size_t done = 0; done < count;) {
+        size_t chunk = count - done;
+        if (chunk > CCryptoBoringSSLShims_ECDSA_SIGN_CHUNK) {
+            chunk = CCryptoBoringSSLShims_ECDSA_SIGN_CHUNK;
+        }
+        if (!CCryptoBoringSSLShims_ecdsa_presign_batch(group, presignatures, &priv_key,
+                                                        digest_bytes + done * digest_len, digest_len, chunk)) {
+            goto out;
+        }
+
+        for (size_t i = 0; i < chunk; i++) {
+            const uint8_t *digest = digest_bytes + (done + i) * digest_len;
+            uint8_t *signature = signatures + (done + i) * signature_len;
+            size_t written;
+            // r or s is zero with negligible probability. If either is, that
+            // one signature is redone on its own with a fresh nonce.
+            if (CCryptoBoringSSL_ec_scalar_is_zero(group, &presignatures[i].r) ||
+                !CCryptoBoringSSLShims_ecdsa_sign_impl(group, signature, &written, &priv_key,
+                                                       digest, digest_len, &presignatures[i])) {
+                if (!CCryptoBoringSSLShims_ecdsa_sign_fresh(group, signature, &written, &priv_key,
+                                                            digest, digest_len)) {
+                    goto out;
+                }
+            }
+        }
+        done += chunk;
+    }
+    ok = 1;
+
+out:
+    CCryptoBoringSSL_OPENSSL_cleanse(presignatures, sizeof(presignatures));
+    CCryptoBoringSSL_OPENSSL_cleanse(&priv_key, sizeof(priv_key));
+    return ok;
+}
+
+// MARK:- Batch key generation
+
+// The number of points converted to affine coordinates with a single field
+// inversion. Bounds the stack use of |CCryptoBoringSSLShims_p256_generate_keys|.
+#define CCryptoBoringSSLShims_P256_KEYGEN_CHUNK 32
+
+// Mirrors |ec_GFp_mont_jacobian_to_affine_batch| in ec_montgomery.c, which is
+// static and not wired into the P-256 methods. Both P-256 methods keep field
+// elements in Montgomery form, so the generic Montgomery arithmetic applies.
+static int CCryptoBoringSSLShims_p256_jacobian_to_affine_batch(const EC_GROUP *group, EC_AFFINE *out,
+                                                               const EC_JACOBIAN *in, size_t num) {
+    // Compute prefix products of all Zs, using |out[i].X| as scratch space.
+    out[0].X = in[0].Z;
+    for (size_t i = 1; i < num; i++) {
+        CCryptoBoringSSL_ec_GFp_mont_felem_mul(group, &out[i].X, &out[i - 1].X, &in[i].Z);
+    }
+
+    if (CCryptoBoringSSL_ec_felem_non_zero_mask(group, &out[num - 1].X) == 0) {
+        return 0;
+    }
+
+    EC_FELEM zinvprod;
+    CCryptoBoringSSL_bn_mod_inverse0_prime_mont_small(zinvprod.words, out[num - 1].X.words,
+                                                      group->field.N.width, &group->field);
+    for (size_t i = num - 1; i < num; i--) {
+        EC_FELEM zinv, zinv2;
+        if (i == 0) {
+            zinv = zinvprod;
+        } else {
+            CCryptoBoringSSL_ec_GFp_mont_felem_mul(group, &zinv, &zinvprod, &out[i - 1].X);
+            CCryptoBoringSSL_ec_GFp_mont_felem_mul(group, &zinvprod, &zinvprod, &in[i].Z);
+        }
+
+        CCryptoBoringSSL_ec_GFp_mont_felem_sqr(group, &zinv2, &zinv);
+        CCryptoBoringSSL_ec_GFp_mont_felem_mul(group, &out[i].X, &in[i].X, &zinv2);
+        CCryptoBoringSSL_ec_GFp_mont_felem_mul(group, &out[i].Y, &in[i].Y, &zinv2);
+        CCryptoBoringSSL_ec_GFp_mont_felem_mul(group, &out[i].Y, &out[i].Y, &zinv);
+    }
+
+    return 1;
+}
+
+int CCryptoBoringSSLShims_p256_generate_keys(void *out_private_keys, void *out_public_keys, size_t count) {
+    static const uint8_t kDefaultAdditionalData[32] = {0};
+    const EC_GROUP *group = CCryptoBoringSSL_EC_group_p256();
+    EC_SCALAR scalars[CCryptoBoringSSLShims_P256_KEYGEN_CHUNK];
+    EC_JACOBIAN points[CCryptoBoringSSLShims_P256_KEYGEN_CHUNK];
+    EC_AFFINE affine[CCryptoBoringSSLShims_P256_KEYGEN_CHUNK];
+    uint8_t *private_keys = out_private_keys;
+    uint8_t *public_keys = out_public_keys;
+    int ok = 0;
+
+    for (size_t done = 0; done < count;) {
+        size_t chunk = count - done;
+        if (chunk > CCryptoBoringSSLShims_P256_KEYGEN_CHUNK) {
+            chunk = CCryptoBoringSSLShims_P256_KEYGEN_CHUNK;
+        }
+
+        for (size_t i = 0; i < chunk; i++) {
+            if (!CCryptoBoringSSL_ec_random_nonzero_scalar(group, &scalars[i], kDefaultAdditionalData) ||
+                !CCryptoBoringSSL_ec_point_mul_scalar_base(group, &points[i], &scalars[i])) {
+                goto out;
+            }
+        }
+
+        // None of the points can be infinity, as every scalar is non-zero and
+        // smaller than the group order.
+        if (!CCryptoBoringSSLShims_p256_jacobian_to_affine_batch(group, affine, points, chunk)) {
+            goto out;
+        }
+
+        for (size_t i = 0; i < chunk; i++) {
+            size_t scalar_len;
+            CCryptoBoringSSL_ec_scalar_to_bytes(group, private_keys, &scalar_len, &scalars[i]);
+            if (scalar_len != CCryptoBoringSSLShims_P256_SCALAR_BYTES ||
+                CCryptoBoringSSL_ec_point_to_bytes(group, &affine[i], POINT_CONVERSION_UNCOMPRESSED, public_keys,
+                                                   CCryptoBoringSSLShims_P256_UNCOMPRESSED_POINT_BYTES) !=
+                    CCryptoBoringSSLShims_P256_UNCOMPRESSED_POINT_BYTES) {
+                goto out;
+            }
+            private_keys += CCryptoBoringSSLShims_P256_SCALAR_BYTES;
+            public_keys += CCryptoBoringSSLShims_P256_UNCOMPRESSED_POINT_BYTES;
+        }
+
+        done += chunk;
+    }
+    ok = 1;
+
+out:
+    CCryptoBoringSSL_OPENSSL_cleanse(scalars, sizeof(scalars));
+    CCryptoBoringSSL_OPENSSL_cleanse(points, sizeof(points));
+    if (!ok) {
+        CCryptoBoringSSL_OPENSSL_cleanse(out_private_keys, count * CCryptoBoringSSLShims_P256_SCALAR_BYTES);
+    }
+    return ok;
+}
+
+void CCryptoBoringSSLShims_ED25519_generate_keys(void *out_seeds, void *out_public_keys, size_t count) {
+    uint8_t *seeds = out_seeds;
+    uint8_t *public_keys = out_public_keys;
+    uint8_t private_key[ED25519_PRIVATE_KEY_LEN];
+
+    for (size_t i = 0; i < count; i++) {
+        CCryptoBoringSSL_ED25519_keypair(public_keys, private_key);
+        // The private key is the seed followed by the public key.
+        memcpy(seeds, private_key, CCryptoBoringSSLShims_ED25519_SEED_BYTES);
+        seeds += CCryptoBoringSSLShims_ED25519_SEED_BYTES;
+        public_keys += ED25519_PUBLIC_KEY_LEN;
+    }
+
+    CCryptoBoringSSL_OPENSSL_cleanse(private_key, sizeof(private_key));
+}
+
+// MARK:- Interleaved X25519
+
+// Outside x86_64 with ADX, BoringSSL computes X25519 with the portable fiat
+// ladder one key at a time. A batch shares its scalar, so the conditional
+// swaps follow the same bits in every lane and several ladders can step
+// together: each field operation is issued for all lanes back to back, which
+// gives a wide core (such as the Neoverse and M-series ones) independent
+// multiply chains to overlap. The final inversion is also shared across the
+// batch with Montgomery's trick.
+#if defined(BORINGSSL_HAS_UINT128)
+#include "../CCryptoBoringSSL/third_party/fiat/curve25519_64.h"
+
+#define CCRYPTOBORINGSSLSHIMS_X25519_LANES 4
+#define CCRYPTOBORINGSSLSHIMS_X25519_CHUNK 32
+
+#if !defined(OPENSSL_NO_ASM) && !defined(OPENSSL_SMALL) && \
+    defined(__GNUC__) && defined(__x86_64__) && !defined(OPENSSL_WINDOWS)
+#define CCRYPTOBORINGSSLSHIMS_X25519_ADX
+#endif
+
+typedef uint64_t CCryptoBoringSSLShims_fe25519[5];
+
+static void CCryptoBoringSSLShims_fe25519_cswap(CCryptoBoringSSLShims_fe25519 f,
+                                                CCryptoBoringSSLShims_fe25519 g,
+                                                uint64_t mask) {
+    for (size_t i = 0; i < 5; i++) {
+        uint64_t x = (f[i] ^ g[i]) & mask;
+        f[i] ^= x;
+        g[i] ^= x;
+    }
+}
+
+static void CCryptoBoringSSLShims_fe25519_sqn(CCryptoBoringSSLShims_fe25519 out,
+                                              const CCryptoBoringSSLShims_fe25519 in, int n) {
+    fiat_25519_carry_square(out, in);
+    for (int i = 1; i < n; i++) {
+        fiat_25519_carry_square(out, out);
+    }
+}
+
+// Computes z^(p-2) with the same addition chain as BoringSSL's fe_invert, so
+// zero maps to zero.
+static void CCryptoBoringSSLShims_fe25519_invert(CCryptoBoringSSLShims_fe25519 out,
+                                                 const CCryptoBoringSSLShims_fe25519 z) {
+    CCryptoBoringSSLShims_fe25519 t0, t1, t2, t3;
+    fiat_25519_carry_square(t0, z);
+    CCryptoBoringSSLShims_fe25519_sqn(t1, t0, 2);
+    fiat_25519_carry_mul(t1, z, t1);
+    fiat_25519_carry_mul(t0, t0, t1);
+    fiat_25519_carry_square(t2, t0);
+    fiat_25519_carry_mul(t1, t1, t2);
+    CCryptoBoringSSLShims_fe25519_sqn(t2, t1, 5);
+    fiat_25519_carry_mul(t1, t2, t1);
+    CCryptoBoringSSLShims_fe25519_sqn(t2, t1, 10);
+    fiat_25519_carry_mul(t2, t2, t1);
+    CCryptoBoringSSLShims_fe25519_sqn(t3, t2, 20);
+    fiat_25519_carry_mul(t2, t3, t2);
+    CCryptoBoringSSLShims_fe25519_sqn(t2, t2, 10);
+    fiat_25519_carry_mul(t1, t2, t1);
+    CCryptoBoringSSLShims_fe25519_sqn(t2, t1, 50);
+    fiat_25519_carry_mul(t2, t2, t1);
+    CCryptoBoringSSLShims_fe25519_sqn(t3, t2, 100);
+    fiat_25519_carry_mul(t2, t3, t2);
+    CCryptoBoringSSLShims_fe25519_sqn(t2, t2, 50);
+    fiat_25519_carry_mul(t1, t2, t1);
+    CCryptoBoringSSLShims_fe25519_sqn(t1, t1, 5);
+    fiat_25519_carry_mul(out, t1, t0);
+}
+
+#define CCRYPTOBORINGSSLSHIMS_X25519_EACH_LANE(l) \
+    for (size_t l = 0; l < CCRYPTOBORINGSSLSHIMS_X25519_LANES; l++)
+
+// Runs the ladder of x25519_scalar_mult_generic on LANES points at once,
+// leaving the projective result of lane l in (out_x[l], out_z[l]). The
+// formulas and their order are the vendored ones, with each step repeated
+// across the lanes.
+static void CCryptoBoringSSLShims_x25519_ladder_lanes(
+    CCryptoBoringSSLShims_fe25519 out_x[CCRYPTOBORINGSSLSHIMS_X25519_LANES],
+    CCryptoBoringSSLShims_fe25519 out_z[CCRYPTOBORINGSSLSHIMS_X25519_LANES],
+    const uint8_t e[32], const uint8_t *points) {
+    CCryptoBoringSSLShims_fe25519 x1[CCRYPTOBORINGSSLSHIMS_X25519_LANES];
+    CCryptoBoringSSLShims_fe25519 x2[CCRYPTOBORINGSSLSHIMS_X25519_LANES];
+    CCryptoBoringSSLShims_fe25519 z2[CCRYPTOBORINGSSLSHIMS_X25519_LANES];
+    CCryptoBoringSSLShims_fe25519 x3[CCRYPTOBORINGSSLSHIMS_X25519_LANES];
+    CCryptoBoringSSLShims_fe25519 z3[CCRYPTOBORINGSSLSHIMS_X25519_LANES];
+    CCryptoBoringSSLShims_fe25519 tmp0[CCRYPTOBORINGSSLSHIMS_X25519_LANES];
+    CCryptoBoringSSLShims_fe25519 tmp1[CCRYPTOBORINGSSLSHIMS_X25519_LANES];
+    CCryptoBoringSSLShims_fe25519 x2l[CCRYPTOBORINGSSLSHIMS_X25519_LANES];
+    CCryptoBoringSSLShims_fe25519 z2l[CCRYPTOBORINGSSLSHIMS_X25519_LANES];
+    CCryptoBoringSSLShims_fe25519 x3l[CCRYPTOBORINGSSLSHIMS_X25519_LANES];
+    CCryptoBoringSSLShims_fe25519 tmp0l[CCRYPTOBORINGSSLSHIMS_X25519_LANES];
+    CCryptoBoringSSLShims_fe25519 tmp1l[CCRYPTOBORINGSSLSHIMS_X25519_LANES];
+
+    CCRYPTOBORINGSSLSHIMS_X25519_EACH_LANE(l) {
+        uint8_t point[32];
+        OPENSSL_memcpy(point, points + 32 * l, 32);
+        point[31] &= 127;
+        fiat_25519_from_bytes(x1[l], point);
+        OPENSSL_memset(x2[l], 0, sizeof(x2[l]));
+        x2[l][0] = 1;
+        OPENSSL_memset(z2[l], 0, sizeof(z2[l]));
+        OPENSSL_memcpy(x3[l], x1[l], sizeof(x3[l]));
+        OPENSSL_memset(z3[l], 0, sizeof(z3[l]));
+        z3[l][0] = 1;
+    }
+
+    uint64_t swap = 0;
+    for (int pos = 254; pos >= 0; --pos) {
+        uint64_t b = 1 & (e[pos / 8] >> (pos & 7));
+        swap ^= b;
+        CCRYPTOBORINGSSLSHIMS_X25519_EACH_LANE(l) {
+            CCryptoBoringSSLShims_fe25519_cswap(x2[l], x3[l], 0 - swap);
+            CCryptoBoringSSLShims_fe25519_cswap(z2[l], z3[l], 0 - swap);
+        }
+        swap = b;
+
+        CCRYPTOBORINGSSLSHIMS_X25519_EACH_LANE(l) {
+            fiat_25519_sub(tmp0l[l], x3[l], z3[l]);
+            fiat_25519_sub(tmp1l[l], x2[l], z2[l]);
+            fiat_25519_add(x2l[l], x2[l], z2[l]);
+            fiat_25519_add(z2l[l], x3[l], z3[l]);
+        }
+        CCRYPTOBORINGSSLSHIMS_X25519_EACH_LANE(l) {
+            fiat_25519_carry_mul(z3[l], tmp0l[l], x2l[l]);
+        }
+        CCRYPTOBORINGSSLSHIMS_X25519_EACH_LANE(l) {
+            fiat_25519_carry_mul(z2[l], z2l[l], tmp1l[l]);
+        }
+        CCRYPTOBORINGSSLSHIMS_X25519_EACH_LANE(l) {
+            fiat_25519_carry_square(tmp0[l], tmp1l[l]);
+        }
+        CCRYPTOBORINGSSLSHIMS_X25519_EACH_LANE(l) {
+            fiat_25519_carry_square(tmp1[l], x2l[l]);
+        }
+        CCRYPTOBORINGSSLSHIMS_X25519_EACH_LANE(l) {
+            fiat_25519_add(x3l[l], z3[l], z2[l]);
+            fiat_25519_sub(z2l[l], z3[l], z2[l]);
+        }
+        CCRYPTOBORINGSSLSHIMS_X25519_EACH_LANE(l) {
+            fiat_25519_carry_mul(x2[l], tmp1[l], tmp0[l]);
+        }
+        CCRYPTOBORINGSSLSHIMS_X25519_EACH_LANE(l) {
+            fiat_25519_sub(tmp1l[l], tmp1[l], tmp0[l]);
+            fiat_25519_carry_square(z2[l], z2l[l]);
+        }
+        CCRYPTOBORINGSSLSHIMS_X25519_EACH_LANE(l) {
+            fiat_25519_carry_scmul_121666(z3[l], tmp1l[l]);
+            fiat_25519_carry_square(x3[l], x3l[l]);
+        }
+        CCRYPTOBORINGSSLSHIMS_X25519_EACH_LANE(l) {
+            fiat_25519_add(tmp0l[l], tmp0[l], z3[l]);
+            fiat_25519_carry_mul(z3[l], x1[l], z2[l]);
+        }
+        CCRYPTOBORINGSSLSHIMS_X25519_EACH_LANE(l) {
+            fiat_25519_carry_mul(z2[l], tmp1l[l], tmp0l[l]);
+        }
+    }
+
+    CCRYPTOBORINGSSLSHIMS_X25519_EACH_LANE(l) {
+        CCryptoBoringSSLShims_fe25519_cswap(x2[l], x3[l], 0 - swap);
+        CCryptoBoringSSLShims_fe25519_cswap(z2[l], z3[l], 0 - swap);
+        OPENSSL_memcpy(out_x[l], x2[l], sizeof(out_x[l]));
+        OPENSSL_memcpy(out_z[l], z2[l], sizeof(out_z[l]));
+    }
+}
+
+// Computes up to CHUNK shared keys. The ladders run LANES at a time, with
+// a short final group padded by repeating the last point, then every Z
+// coordinate is inverted at once.
+static void CCryptoBoringSSLShims_x25519_batch_chunk(uint8_t *out, const uint8_t e[32],
+                                                     const uint8_t *points, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    CCryptoBoringSSLShims_fe25519 x[CCRYPTOBORINGSSLSHIMS_X25519_CHUNK];
+    CCryptoBoringSSLShims_fe25519 z[CCRYPTOBORINGSSLSHIMS_X25519_CHUNK];
+    CCryptoBoringSSLShims_fe25519 prefix[CCRYPTOBORINGSSLSHIMS_X25519_CHUNK];
+    uint64_t is_zero[CCRYPTOBORINGSSLSHIMS_X25519_CHUNK];
+
+    for (size_t i = 0; i < count; i += CCRYPTOBORINGSSLSHIMS_X25519_LANES) {
+        uint8_t group[32 * CCRYPTOBORINGSSLSHIMS_X25519_LANES];
+        CCryptoBoringSSLShims_fe25519 group_x[CCRYPTOBORINGSSLSHIMS_X25519_LANES];
+        CCryptoBoringSSLShims_fe25519 group_z[CCRYPTOBORINGSSLSHIMS_X25519_LANES];
+        size_t n = count - i < CCRYPTOBORINGSSLSHIMS_X25519_LANES ? count - i
+                                                                  : CCRYPTOBORINGSSLSHIMS_X25519_LANES;
+        for (size_t l = 0; l < CCRYPTOBORINGSSLSHIMS_X25519_LANES; l++) {
+            OPENSSL_memcpy(group + 32 * l, points + 32 * (i + (l < n ? l : n - 1)), 32);
+        }
+        CCryptoBoringSSLShims_x25519_ladder_lanes(group_x, group_z, e, group);
+        OPENSSL_memcpy(x + i, group_x, n * sizeof(x[0]));
+        OPENSSL_memcpy(z + i, group_z, n * sizeof(z[0]));
+    }
+
+    // Low-order peers leave Z = 0, which fe_invert maps to 0 and so produces
+    // the all-zero key. Substitute 1 so the shared inversion stays defined,
+    // and clear those outputs afterwards, without branching on the secret.
+    for (size_t i = 0; i < count; i++) {
+        uint8_t bytes[32];
+        uint8_t acc = 0;
+        fiat_25519_to_bytes(bytes, z[i]);
+        for (size_t j = 0; j < 32; j++) {
+            acc |= bytes[j];
+        }
+        is_zero[i] = constant_time_is_zero_w(acc);
+        for (size_t j = 0; j < 5; j++) {
+            z[i][j] &= ~is_zero[i];
+        }
+        z[i][0] |= is_zero[i] & 1;
+    }
+
+    OPENSSL_memcpy(prefix[0], z[0], sizeof(prefix[0]));
+    for (size_t i = 1; i < count; i++) {
+        fiat_25519_carry_mul(prefix[i], prefix[i - 1], z[i]);
+    }
+    CCryptoBoringSSLShims_fe25519 inv;
+    CCryptoBoringSSLShims_fe25519_invert(inv, prefix[count - 1]);
+    for (size_t i = count - 1; i > 0; i--) {
+        CCryptoBoringSSLShims_fe25519 z_inv;
+        fiat_25519_carry_mul(z_inv, inv, prefix[i - 1]);
+        fiat_25519_carry_mul(inv, inv, z[i]);
+        fiat_25519_carry_mul(x[i], x[i], z_inv);
+    }
+    fiat_25519_carry_mul(x[0], x[0], inv);
+
+    for (size_t i = 0; i < count; i++) {
+        uint8_t bytes[32];
+        fiat_25519_to_bytes(bytes, x[i]);
+        for (size_t j = 0; j < 32; j++) {
+            out[32 * i + j] = bytes[j] & (uint8_t)~is_zero[i];
+        }
+    }
+}
+#endif  // BORINGSSL_HAS_UINT128
+
+void CCryptoBoringSSLShims_X25519_batch(void *out_shared_keys, const void *private_key,
+                                        const void *peer_public_values, size_t peers_count) {
+    CCRYPTOBORINGSSLSHIMS_TRACE_ENTRY(x25519, NID_X25519, 256, 32 * peers_count);
+#if defined(BORINGSSL_HAS_UINT128)
+    int interleave = 1;
+#if defined(CCRYPTOBORINGSSLSHIMS_X25519_ADX)
+    // Keep the vendored ADX field arithmetic where the CPU has it.
+    interleave = !(CRYPTO_is_BMI1_capable() && CRYPTO_is_BMI2_capable() && CRYPTO_is_ADX_capable());
+#endif
+    if (interleave && peers_count > 1) {
+        uint8_t e[32];
+        OPENSSL_memcpy(e, private_key, 32);
+        e[0] &= 248;
+        e[31] &= 127;
+        e[31] |= 64;
+        for (size_t i = 0; i < peers_count; i += CCRYPTOBORINGSSLSHIMS_X25519_CHUNK) {
+            size_t n = peers_count - i < CCRYPTOBORINGSSLSHIMS_X25519_CHUNK ? peers_count - i
+                                                                            : CCRYPTOBORINGSSLSHIMS_X25519_CHUNK;
+            CCryptoBoringSSLShims_x25519_batch_chunk((uint8_t *)out_shared_keys + 32 * i, e,
+                                                     (const uint8_t *)peer_public_values + 32 * i, n);
+        }
+        CCryptoBoringSSL_OPENSSL_cleanse(e, sizeof(e));
+        CCRYPTOBORINGSSLSHIMS_TRACE_RETURN(x25519, NID_X25519, 256, 32 * peers_count, 1);
+        return;
+    }
+#endif
+
+    for (size_t i = 0; i < peers_count; i++) {
+        // As with the single-shot call, the all-zero output is deliberately not rejected here.
+        (void)CCryptoBoringSSL_X25519((uint8_t *)out_shared_keys + 32 * i, private_key,
+                                      (const uint8_t *)peer_public_values + 32 * i);
+    }
+    CCRYPTOBORINGSSLSHIMS_TRACE_RETURN(x25519, NID_X25519, 256, 32 * peers_count, 1);
+}
+
+// MARK:- Wide Ed25519 base-point table
+
+// |ge_double_scalarmult_vartime| computes [s]B with the same sliding window as
+// [h]A: digits up to ±15 from a table of the eight odd multiples B..15B. [s]B
+// shares its doublings with [h]A, so what a bigger table saves is additions:
+// width-8 digits up to ±127, from the 64 odd multiples B..127B, need about 28
+// additions instead of about 43. The table is 7.5 KiB, built on first use.
+//
+// Point arithmetic mirrors curve25519.c, whose helpers are static.
+#if defined(BORINGSSL_HAS_UINT128) && defined(OPENSSL_64_BIT)
+#define CCRYPTOBORINGSSLSHIMS_ED25519_WIDE_TABLE 1
+
+#define CCRYPTOBORINGSSLSHIMS_ED25519_A_LIMIT 15
+#define CCRYPTOBORINGSSLSHIMS_ED25519_B_LIMIT 127
+
+static int CCryptoBoringSSLShims_ed25519_wide_table_requested = 0;
+static CRYPTO_once_t CCryptoBoringSSLShims_ed25519_wide_table_once = CRYPTO_ONCE_INIT;
+static ge_precomp CCryptoBoringSSLShims_ed25519_wide_table[(CCRYPTOBORINGSSLSHIMS_ED25519_B_LIMIT + 1) / 2];
+
+// The slide() of curve25519.c with the largest digit as a parameter: writes a
+// signed-digit form of |a| into |r| in which every nonzero digit is odd, at
+// most |limit| in magnitude, and followed by enough zeros to keep the windows
+// apart.
+static void CCryptoBoringSSLShims_ed25519_slide(signed char r[256], const uint8_t a[32], int limit) {
+    for (int i = 0; i < 256; ++i) {
+        r[i] = 1 & (a[i >> 3] >> (i & 7));
+    }
+
+    for (int i = 0; i < 256; ++i) {
+        if (!r[i]) {
+            continue;
+        }
+        for (int b = 1; i + b < 256; ++b) {
+            if (!r[i + b]) {
+                continue;
+            }
+            if (r[i] + (r[i + b] << b) <= limit) {
+                r[i] += r[i + b] << b;
+                r[i + b] = 0;
+            } else if (r[i] - (r[i + b] << b) >= -limit) {
+                r[i] -= r[i + b] << b;
+                for (int k = i + b; k < 256; ++k) {
+                    if (!r[k]) {
+                        r[k] = 1;
+                        break;
+                    }
+                    r[k] = 0;
+                }
+            } else {
+                break;
+            }
+        }
+    }
+}
+
+// r = 2 * p
+static void CCryptoBoringSSLShims_ed25519_p2_dbl(ge_p1p1 *r, const ge_p2 *p) {
+    fe trX, trZ, trT, t0;
+    fe_loose tmp;
+
+    fiat_25519_carry_square(trX.v, p->X.v);
+    fiat_25519_carry_square(trZ.v, p->Y.v);
+    fiat_25519_carry_square(trT.v, p->Z.v);
+    fiat_25519_add(tmp.v, trT.v, trT.v);
+    fiat_25519_carry(trT.v, tmp.v);
+    fiat_25519_add(r->Y.v, p->X.v, p->Y.v);
+    fiat_25519_carry_square(t0.v, r->Y.v);
+
+    fiat_25519_add(r->Y.v, trZ.v, trX.v);
+    fiat_25519_sub(r->Z.v, trZ.v, trX.v);
+    fiat_25519_carry(trZ.v, r->Y.v);
+    fiat_25519_sub(r->X.v, t0.v, trZ.v);
+    fiat_25519_carry(trZ.v, r->Z.v);
+    fiat_25519_sub(r->T.v, trT.v, trZ.v);
+}
+
+// r = p + q, or p - q if |subtract| is set.
+static void CCryptoBoringSSLShims_ed25519_madd(ge_p1p1 *r, const ge_p3 *p, const ge_precomp *q, int subtract) {
+    fe trY, trZ, trT;
+
+    fiat_25519_add(r->X.v, p->Y.v, p->X.v);
+    fiat_25519_sub(r->Y.v, p->Y.v, p->X.v);
+    fiat_25519_carry_mul(trZ.v, r->X.v, subtract ? q->yminusx.v : q->yplusx.v);
+    fiat_25519_carry_mul(trY.v, r->Y.v, subtract ? q->yplusx.v : q->yminusx.v);
+    fiat_25519_carry_mul(trT.v, q->xy2d.v, p->T.v);
+    fiat_25519_add(r->T.v, p->Z.v, p->Z.v);
+    fiat_25519_sub(r->X.v, trZ.v, trY.v);
+    fiat_25519_add(r->Y.v, trZ.v, trY.v);
+    fiat_25519_carry(trZ.v, r->T.v);
+    if (subtract) {
+        fiat_25519_sub(r->Z.v, trZ.v, trT.v);
+        fiat_25519_add(r->T.v, trZ.v, trT.v);
+    } else {
+        fiat_25519_add(r->Z.v, trZ.v, trT.v);
+        fiat_25519_sub(r->T.v, trZ.v, trT.v);
+    }
+}
+
+static void CCryptoBoringSSLShims_ed25519_build_wide_table(void) {
+    // The encoding of the base point, (x, 4/5) with x positive.
+    static const uint8_t kBasePoint[32] = {
+        0x58, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66,
+        0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66,
+    };
+    enum { kCount = (CCRYPTOBORINGSSLSHIMS_ED25519_B_LIMIT + 1) / 2 };
+    ge_p3 multiples[kCount], B2;
+    ge_cached B2_cached;
+    ge_p1p1 t;
+    ge_p2 p2;
+
+    // The base point always decodes.
+    (void)CCryptoBoringSSL_x25519_ge_frombytes_vartime(&multiples[0], kBasePoint);
+    memcpy(&p2, &multiples[0], sizeof(p2));
+    CCryptoBoringSSLShims_ed25519_p2_dbl(&t, &p2);
+    CCryptoBoringSSL_x25519_ge_p1p1_to_p3(&B2, &t);
+    CCryptoBoringSSL_x25519_ge_p3_to_cached(&B2_cached, &B2);
+    for (size_t i = 1; i < kCount; i++) {
+        CCryptoBoringSSL_x25519_ge_add(&t, &multiples[i - 1], &B2_cached);
+        CCryptoBoringSSL_x25519_ge_p1p1_to_p3(&multiples[i], &t);
+    }
+
+    // Make every multiple affine with a single inversion: |prefix[i]| is the
+    // product of the first i + 1 Z coordinates.
+    CCryptoBoringSSLShims_fe25519 prefix[kCount], inverse, z_inverse, x, y;
+    memcpy(prefix[0], multiples[0].Z.v, sizeof(prefix[0]));
+    for (size_t i = 1; i < kCount; i++) {
+        fiat_25519_carry_mul(prefix[i], prefix[i - 1], multiples[i].Z.v);
+    }
+    CCryptoBoringSSLShims_fe25519_invert(inverse, prefix[kCount - 1]);
+
+    // 2d = 2 * -121665/121666.
+    CCryptoBoringSSLShims_fe25519 d2, numerator = {121665}, denominator = {121666};
+    fe_loose loose;
+    fiat_25519_opp(loose.v, numerator);
+    fiat_25519_carry(numerator, loose.v);
+    CCryptoBoringSSLShims_fe25519_invert(denominator, denominator);
+    fiat_25519_carry_mul(d2, numerator, denominator);
+    fiat_25519_add(loose.v, d2, d2);
+    fiat_25519_carry(d2, loose.v);
+
+    for (size_t i = kCount; i-- > 0;) {
+        if (i > 0) {
+            fiat_25519_carry_mul(z_inverse, inverse, prefix[i - 1]);
+            fiat_25519_carry_mul(inverse, inverse, multiples[i].Z.v);
+        } else {
+            memcpy(z_inverse, inverse, sizeof(z_inverse));
+        }
+        ge_precomp *entry = &CCryptoBoringSSLShims_ed25519_wide_table[i];
+        fiat_25519_carry_mul(x, multiples[i].X.v, z_inverse);
+        fiat_25519_carry_mul(y, multiples[i].Y.v, z_inverse);
+        fiat_25519_add(entry->yplusx.v, y, x);
+        fiat_25519_sub(entry->yminusx.v, y, x);
+        fiat_25519_carry_mul(x, x, y);
+        fiat_25519_carry_mul(entry->xy2d.v, x, d2);
+    }
+}
+
+static int CCryptoBoringSSLShims_ed25519_wide_table_enabled(void) {
+    return __atomic_load_n(&CCryptoBoringSSLShims_ed25519_wide_table_requested, __ATOMIC_RELAXED);
+}
+
+#define CCRYPTOBORINGSSLSHIMS_ED25519_A_MULTIPLES ((CCRYPTOBORINGSSLSHIMS_ED25519_A_LIMIT + 1) / 2)
+
+// Writes A, 3A, 5A, ..., 15A to |Ai|.
+static void CCryptoBoringSSLShims_ed25519_odd_multiples(ge_cached Ai[CCRYPTOBORINGSSLSHIMS_ED25519_A_MULTIPLES],
+                                                        const ge_p3 *A) {
+    ge_p1p1 t;
+    ge_p3 u, A2;
+    ge_p2 p2;
+    CCryptoBoringSSL_x25519_ge_p3_to_cached(&Ai[0], A);
+    memcpy(&p2, A, sizeof(p2));
+    CCryptoBoringSSLShims_ed25519_p2_dbl(&t, &p2);
+    CCryptoBoringSSL_x25519_ge_p1p1_to_p3(&A2, &t);
+    for (size_t i = 1; i < CCRYPTOBORINGSSLSHIMS_ED25519_A_MULTIPLES; i++) {
+        CCryptoBoringSSL_x25519_ge_add(&t, &A2, &Ai[i - 1]);
+        CCryptoBoringSSL_x25519_ge_p1p1_to_p3(&u, &t);
+        CCryptoBoringSSL_x25519_ge_p3_to_cached(&Ai[i], &u);
+    }
+}
+
+// r = a * A + b * B, as |ge_double_scalarmult_vartime| computes it but with
+// the wide table for B, given the odd multiples of A.
+static void CCryptoBoringSSLShims_ed25519_double_scalarmult_vartime_multiples(
+    ge_p2 *r, const uint8_t a[32], const ge_cached Ai[CCRYPTOBORINGSSLSHIMS_ED25519_A_MULTIPLES],
+    const uint8_t b[32]) {
+    CRYPTO_once(&CCryptoBoringSSLShims_ed25519_wide_table_once, CCryptoBoringSSLShims_ed25519_build_wide_table);
+    const ge_precomp *Bi = CCryptoBoringSSLShims_ed25519_wide_table;
+
+    signed char aslide[256], bslide[256];
+    CCryptoBoringSSLShims_ed25519_slide(aslide, a, CCRYPTOBORINGSSLSHIMS_ED25519_A_LIMIT);
+    CCryptoBoringSSLShims_ed25519_slide(bslide, b, CCRYPTOBORINGSSLSHIMS_ED25519_B_LIMIT);
+
+    ge_p1p1 t;
+    ge_p3 u;
+
+    // The identity.
+    OPENSSL_memset(r, 0, sizeof(*r));
+    r->Y.v[0] = 1;
+    r->Z.v[0] = 1;
+
+    int i;
+    for (i = 255; i >= 0; --i) {
+        if (aslide[i] || bslide[i]) {
+            break;
+        }
+    }
+
+    for (; i >= 0; --i) {
+        CCryptoBoringSSLShims_ed25519_p2_dbl(&t, r);
+
+        if (aslide[i] > 0) {
+            CCryptoBoringSSL_x25519_ge_p1p1_to_p3(&u, &t);
+            CCryptoBoringSSL_x25519_ge_add(&t, &u, &Ai[aslide[i] / 2]);
+        } else if (aslide[i] < 0) {
+            CCryptoBoringSSL_x25519_ge_p1p1_to_p3(&u, &t);
+            CCryptoBoringSSL_x25519_ge_sub(&t, &u, &Ai[(-aslide[i]) / 2]);
+        }
+
+        if (bslide[i] > 0) {
+            CCryptoBoringSSL_x25519_ge_p1p1_to_p3(&u, &t);
+            CCryptoBoringSSLShims_ed25519_madd(&t, &u, &Bi[bslide[i] / 2], 0);
+        } else if (bslide[i] < 0) {
+            CCryptoBoringSSL_x25519_ge_p1p1_to_p3(&u, &t);
+            CCryptoBoringSSLShims_ed25519_madd(&t, &u, &Bi[(-bslide[i]) / 2], 1);
+        }
+
+        CCryptoBoringSSL_x25519_ge_p1p1_to_p2(r, &t);
+    }
+}
+
+// r = a * A + b * B, as |ge_double_scalarmult_vartime| computes it but with
+// the wide table for B.
+static void CCryptoBoringSSLShims_ed25519_double_scalarmult_vartime(ge_p2 *r, const uint8_t a[32], const ge_p3 *A,
+                                                                    const uint8_t b[32]) {
+    ge_cached Ai[CCRYPTOBORINGSSLSHIMS_ED25519_A_MULTIPLES];
+    CCryptoBoringSSLShims_ed25519_odd_multiples(Ai, A);
+    CCryptoBoringSSLShims_ed25519_double_scalarmult_vartime_multiples(r, a, Ai, b);
+}
+
+// Negates |A| in place.
+static void CCryptoBoringSSLShims_ed25519_negate(ge_p3 *A) {
+    fe_loose t;
+    fiat_25519_opp(t.v, A->X.v);
+    fiat_25519_carry(A->X.v, t.v);
+    fiat_25519_opp(t.v, A->T.v);
+    fiat_25519_carry(A->T.v, t.v);
+}
+
+// The final step of verification: checks that R = [s]B - [h]A, with |h|
+// already reduced.
+static int CCryptoBoringSSLShims_ed25519_verify_wide(const uint8_t sig[64], const uint8_t public_key[32],
+                                                     const uint8_t h[32]) {
+    ge_p3 A;
+    if (!CCryptoBoringSSL_x25519_ge_frombytes_vartime(&A, public_key)) {
+        return 0;
+    }
+    CCryptoBoringSSLShims_ed25519_negate(&A);
+
+    ge_p2 R;
+    uint8_t rcheck[32];
+    CCryptoBoringSSLShims_ed25519_double_scalarmult_vartime(&R, h, &A, sig + 32);
+    CCryptoBoringSSL_x25519_ge_tobytes(rcheck, &R);
+    return CRYPTO_memcmp(rcheck, sig, sizeof(rcheck)) == 0;
+}
+
+#else
+static int CCryptoBoringSSLShims_ed25519_wide_table_enabled(void) {
+    return 0;
+}
+
+static int CCryptoBoringSSLShims_ed25519_verify_wide(const uint8_t sig[64], const uint8_t public_key[32],
+                                                     const uint8_t h[32]) {
+    abort();
+}
+#endif  // BORINGSSL_HAS_UINT128 && OPENSSL_64_BIT
+
+void CCryptoBoringSSLShims_ED25519_set_wide_base_table_enabled(int enabled) {
+#if defined(CCRYPTOBORINGSSLSHIMS_ED25519_WIDE_TABLE)
+    __atomic_store_n(&CCryptoBoringSSLShims_ed25519_wide_table_requested, enabled != 0, __ATOMIC_RELAXED);
+#else
+    (void)enabled;
+#endif
+}
+
+int CCryptoBoringSSLShims_ED25519_wide_base_table_enabled(void) {
+    return CCryptoBoringSSLShims_ed25519_wide_table_enabled();
+}
+
+// MARK:- Fixed-base Ed25519 multiplication
+
+// x25519_ge_scalarmult_base takes 64 signed 4-bit windows of the scalar, and
+// for each reads one of eight multiples of the base point from a table row in
+// constant time, by xoring every entry into the result under a mask one byte
+// at a time. Here an entry is read with three 32-byte loads under an AVX2
+// compare mask, as ecp_nistz256_select_w7 does for P-256. The rest of the
+// multiplication mirrors curve25519.c. BoringSSL's ADX variant also selects a
+// byte at a time, so this is used on every processor with AVX2.
+//
+// Everywhere else, including OPENSSL_SMALL builds, which have no
+// k25519Precomp, BoringSSL's own multiplication is used.
+#if defined(CCRYPTOBORINGSSLSHIMS_ED25519_WIDE_TABLE) && !defined(OPENSSL_SMALL) && \
+    !defined(OPENSSL_NO_ASM) && defined(OPENSSL_X86_64) && (defined(__GNUC__) || defined(__clang__))
+#define CCRYPTOBORINGSSLSHIMS_ED25519_SELECT_AVX2 1
+#include <immintrin.h>
+
+// Ors the entry of |row| at |index| - 1 into |out|, or nothing if |index| is
+// zero.
+__attribute__((target("avx2")))
+static void CCryptoBoringSSLShims_ed25519_select_avx2(uint8_t out[3][32], const uint8_t row[8][3][32], uint8_t index) {
+    const __m256i wanted = _mm256_set1_epi32(index);
+    __m256i yplusx = _mm256_setzero_si256();
+    __m256i yminusx = _mm256_setzero_si256();
+    __m256i xy2d = _mm256_setzero_si256();
+    for (int i = 0; i < 8; i++) {
+        const __m256i mask = _mm256_cmpeq_epi32(wanted, _mm256_set1_epi32(i + 1));
+        yplusx = _mm256_or_si256(yplusx, _mm256_and_si256(mask, _mm256_loadu_si256((const __m256i *)row[i][0])));
+        yminusx = _mm256_or_si256(yminusx, _mm256_and_si256(mask, _mm256_loadu_si256((const __m256i *)row[i][1])));
+        xy2d = _mm256_or_si256(xy2d, _mm256_and_si256(mask, _mm256_loadu_si256((const __m256i *)row[i][2])));
+    }
+    _mm256_storeu_si256((__m256i *)out[0], _mm256_or_si256(yplusx, _mm256_loadu_si256((const __m256i *)out[0])));
+    _mm256_storeu_si256((__m256i *)out[1], _mm256_or_si256(yminusx, _mm256_loadu_si256((const __m256i *)out[1])));
+    _mm256_storeu_si256((__m256i *)out[2], _mm256_or_si256(xy2d, _mm256_loadu_si256((const __m256i *)out[2])));
+}
+
+// The table_select() of curve25519.c: sets |t| to |b| times the multiple of
+// the base point that row |pos| of k25519Precomp is built on, for -8 <= b <= 8.
+// The processor must support AVX2.
+__attribute__((target("avx2")))
+static void CCryptoBoringSSLShims_ed25519_table_select(ge_precomp *t, int pos, signed char b) {
+    const uint8_t bnegative = constant_time_msb_w(b);
+    const uint8_t babs = b - ((bnegative & b) << 1);
+
+    // Zero selects the identity, (1, 1, 0).
+    uint8_t bytes[3][32] = {{constant_time_is_zero_w(babs) & 1}, {constant_time_is_zero_w(babs) & 1}, {0}};
+    CCryptoBoringSSLShims_ed25519_select_avx2(bytes, k25519Precomp[pos], babs);
+
+    fiat_25519_from_bytes(t->yplusx.v, bytes[0]);
+    fiat_25519_from_bytes(t->yminusx.v, bytes[1]);
+    fiat_25519_from_bytes(t->xy2d.v, bytes[2]);
+
+    // Negating a precomputed point swaps y+x with y-x and negates 2dxy.
+    fe_loose loose;
+    fe_loose yplusx = t->yplusx;
+    fe minus_xy2d;
+    fiat_25519_opp(loose.v, t->xy2d.v);
+    fiat_25519_carry(minus_xy2d.v, loose.v);
+    const fiat_25519_uint1 negate = bnegative >> 7;
+    fiat_25519_selectznz(t->yplusx.v, negate, t->yplusx.v, t->yminusx.v);
+    fiat_25519_selectznz(t->yminusx.v, negate, t->yminusx.v, yplusx.v);
+    fiat_25519_selectznz(t->xy2d.v, negate, t->xy2d.v, minus_xy2d.v);
+}
+
+// The x25519_ge_scalarmult_base() of curve25519.c: h = a * B, for a[31] <= 127.
+static void CCryptoBoringSSLShims_ed25519_scalarmult_base(ge_p3 *h, const uint8_t a[32]) {
+    if (!CRYPTO_is_AVX2_capable()) {
+        CCryptoBoringSSL_x25519_ge_scalarmult_base(h, a);
+        return;
+    }
+    signed char e[64];
+    for (int i = 0; i < 32; ++i) {
+        e[2 * i + 0] = (a[i] >> 0) & 15;
+        e[2 * i + 1] = (a[i] >> 4) & 15;
+    }
+    // Recenter every digit into [-8, 8].
+    signed char carry = 0;
+    for (int i = 0; i < 63; ++i) {
+        e[i] += carry;
+        carry = e[i] + 8;
+        carry >>= 4;
+        e[i] -= carry << 4;
+    }
+    e[63] += carry;
+
+    ge_p1p1 r;
+    ge_p2 s;
+    ge_precomp t;
+    OPENSSL_memset(h, 0, sizeof(*h));
+    h->Y.v[0] = 1;
+    h->Z.v[0] = 1;
+    for (int i = 1; i < 64; i += 2) {
+        CCryptoBoringSSLShims_ed25519_table_select(&t, i / 2, e[i]);
+        CCryptoBoringSSLShims_ed25519_madd(&r, h, &t, 0);
+        CCryptoBoringSSL_x25519_ge_p1p1_to_p3(h, &r);
+    }
+
+    // Multiply by 16.
+    memcpy(&s, h, sizeof(s));
+    for (int i = 0; i < 3; i++) {
+        CCryptoBoringSSLShims_ed25519_p2_dbl(&r, &s);
+        CCryptoBoringSSL_x25519_ge_p1p1_to_p2(&s, &r);
+    }
+    CCryptoBoringSSLShims_ed25519_p2_dbl(&r, &s);
+    CCryptoBoringSSL_x25519_ge_p1p1_to_p3(h, &r);
+
+    for (int i = 0; i < 64; i += 2) {
+        CCryptoBoringSSLShims_ed25519_table_select(&t, i / 2, e[i]);
+        CCryptoBoringSSLShims_ed25519_madd(&r, h, &t, 0);
+        CCryptoBoringSSL_x25519_ge_p1p1_to_p3(h, &r);
+    }
+    CCryptoBoringSSL_OPENSSL_cleanse(e, sizeof(e));
+}
+
+// The X25519_public_from_private() of curve25519.c, with the multiplication
+// above.
+static void CCryptoBoringSSLShims_x25519_public_from_private(uint8_t out[32], const uint8_t private_key[32]) {
+    if (!CRYPTO_is_AVX2_capable()) {
+        CCryptoBoringSSL_X25519_public_from_private(out, private_key);
+        return;
+    }
+    uint8_t e[32];
+    memcpy(e, private_key, 32);
+    e[0] &= 248;
+    e[31] &= 127;
+    e[31] |= 64;
+
+    ge_p3 A;
+    CCryptoBoringSSLShims_ed25519_scalarmult_base(&A, e);
+    CCryptoBoringSSL_OPENSSL_cleanse(e, sizeof(e));
+
+    // u = (Z + Y) / (Z - Y).
+    fe_loose loose;
+    CCryptoBoringSSLShims_fe25519 zplusy, zminusy, u;
+    fiat_25519_add(loose.v, A.Z.v, A.Y.v);
+    fiat_25519_carry(zplusy, loose.v);
+    fiat_25519_sub(loose.v, A.Z.v, A.Y.v);
+    fiat_25519_carry(zminusy, loose.v);
+    CCryptoBoringSSLShims_fe25519_invert(u, zminusy);
+    fiat_25519_carry_mul(u, zplusy, u);
+    fiat_25519_to_bytes(out, u);
+    CONSTTIME_DECLASSIFY(out, 32);
+}
+#else
+static void CCryptoBoringSSLShims_ed25519_scalarmult_base(ge_p3 *h, const uint8_t a[32]) {
+    CCryptoBoringSSL_x25519_ge_scalarmult_base(h, a);
+}
+
+static void CCryptoBoringSSLShims_x25519_public_from_private(uint8_t out[32], const uint8_t private_key[32]) {
+    CCryptoBoringSSL_X25519_public_from_private(out, private_key);
+}
+#endif  // CCRYPTOBORINGSSLSHIMS_ED25519_SELECT_AVX2
+
+// MARK:- Expanded Ed25519 keys
+
+void CCryptoBoringSSLShims_ED25519_expand(void *out_expanded_key, const void *seed) {
+    uint8_t az[SHA512_DIGEST_LENGTH];
+    uint8_t wide[64] = {0};
+    uint8_t *out = out_expanded_key;
+
+    CCryptoBoringSSL_SHA512(seed, CCryptoBoringSSLShims_ED25519_SEED_BYTES, az);
+    az[0] &= 248;
+    az[31] &= 63;
+    az[31] |= 64;
+
+    // Signing only ever uses the scalar modulo the group order, so store it
+    // reduced. That keeps every input to the multiply-add below under 2^253.
+    memcpy(wide, az, 32);
+    CCryptoBoringSSL_x25519_sc_reduce(wide);
+    memcpy(out, wide, 32);
+    memcpy(out + 32, az + 32, 32);
+
+    CCryptoBoringSSL_OPENSSL_cleanse(az, sizeof(az));
+    CCryptoBoringSSL_OPENSSL_cleanse(wide, sizeof(wide));
+}
+
+// Sets |s| to |a| * |b| + |c| mod l, where all values are little-endian and
+// |a|, |b| and |c| are already reduced. |sc_muladd| in curve25519.c does this
+// but is static, so this computes the full 512-bit value with 32-bit limbs and
+// hands it to |x25519_sc_reduce|. It is constant-time.
+static void CCryptoBoringSSLShims_ed25519_sc_muladd(uint8_t s[32], const uint8_t a[32], const uint8_t b[32],
+                                                    const uint8_t c[32]) {
+    uint32_t a_limbs[8], b_limbs[8], product[16] = {0};
+    uint8_t wide[64];
+
+    for (size_t i = 0; i < 8; i++) {
+        a_limbs[i] = CRYPTO_load_u32_le(a + 4 * i);
+        b_limbs[i] = CRYPTO_load_u32_le(b + 4 * i);
+        product[i] = CRYPTO_load_u32_le(c + 4 * i);
+    }
+
+    for (size_t i = 0; i < 8; i++) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < 8; j++) {
+            uint64_t t = (uint64_t)a_limbs[i] * b_limbs[j] + product[i + j] + carry;
+            product[i + j] = (uint32_t)t;
+            carry = t >> 32;
+        }
+        // Nothing has been written above limb i + 7 yet, so the carry lands in
+        // an empty limb.
+        product[i + 8] = (uint32_t)carry;
+    }
+
+    for (size_t i = 0; i < 16; i++) {
+        CRYPTO_store_u32_le(wide + 4 * i, product[i]);
+    }
+    CCryptoBoringSSL_x25519_sc_reduce(wide);
+    memcpy(s, wide, 32);
+
+    CCryptoBoringSSL_OPENSSL_cleanse(a_limbs, sizeof(a_limbs));
+    CCryptoBoringSSL_OPENSSL_cleanse(product, sizeof(product));
+    CCryptoBoringSSL_OPENSSL_cleanse(wide, sizeof(wide));
+}
+
+// Signing, as in RFC 8032, section 5.1.6, is split into two passes over the
+// message so that it can be fed in pieces. |dom| (which may be empty) is
+// hashed in front of both the nonce and challenge inputs.
+static void CCryptoBoringSSLShims_ed25519_sign_init_dom(CCryptoBoringSSLShims_ED25519_SIGN_CTX *ctx,
+                                                        const uint8_t *dom, size_t dom_len,
+                                                        const uint8_t expanded_key[64]) {
+    CCryptoBoringSSL_SHA512_Init(&ctx->hash);
+    CCryptoBoringSSL_SHA512_Update(&ctx->hash, dom, dom_len);
+    CCryptoBoringSSL_SHA512_Update(&ctx->hash, expanded_key + 32, 32);
+}
+
+void CCryptoBoringSSLShims_ED25519_sign_init(CCryptoBoringSSLShims_ED25519_SIGN_CTX *ctx, const void *expanded_key) {
+    CCryptoBoringSSLShims_ed25519_sign_init_dom(ctx, NULL, 0, expanded_key);
+}
+
+void CCryptoBoringSSLShims_ED25519_sign_update(CCryptoBoringSSLShims_ED25519_SIGN_CTX *ctx, const void *data,
+                                               size_t len) {
+    CCryptoBoringSSL_SHA512_Update(&ctx->hash, data, len);
+}
+
+static void CCryptoBoringSSLShims_ed25519_sign_commit_dom(CCryptoBoringSSLShims_ED25519_SIGN_CTX *ctx,
+                                                          const uint8_t *dom, size_t dom_len,
+                                                          const uint8_t public_key[32]) {
+    CCryptoBoringSSL_SHA512_Final(ctx->nonce, &ctx->hash);
+    CCryptoBoringSSL_x25519_sc_reduce(ctx->nonce);
+    ge_p3 R;
+    CCryptoBoringSSLShims_ed25519_scalarmult_base(&R, ctx->nonce);
+    ge_p2 R_projective;
+    R_projective.X = R.X;
+    R_projective.Y = R.Y;
+    R_projective.Z = R.Z;
+    CCryptoBoringSSL_x25519_ge_tobytes(ctx->R, &R_projective);
+
+    CCryptoBoringSSL_SHA512_Init(&ctx->hash);
+    CCryptoBoringSSL_SHA512_Update(&ctx->hash, dom, dom_len);
+    CCryptoBoringSSL_SHA512_Update(&ctx->hash, ctx->R, 32);
+    CCryptoBoringSSL_SHA512_Update(&ctx->hash, public_key, 32);
+
+    CCryptoBoringSSL_OPENSSL_cleanse(&R, sizeof(R));
+    CCryptoBoringSSL_OPENSSL_cleanse(&R_projective, sizeof(R_projective));
+}
+
+void CCryptoBoringSSLShims_ED25519_sign_commit(CCryptoBoringSSLShims_ED25519_SIGN_CTX *ctx, const void *public_key) {
+    CCryptoBoringSSLShims_ed25519_sign_commit_dom(ctx, NULL, 0, public_key);
+}
+
+void CCryptoBoringSSLShims_ED25519_sign_final(CCryptoBoringSSLShims_ED25519_SIGN_CTX *ctx, void *out_sig,
+                                              const void *expanded_key) {
+    uint8_t *sig = out_sig;
+    uint8_t hram[SHA512_DIGEST_LENGTH];
+    CCryptoBoringSSL_SHA512_Final(hram, &ctx->hash);
+    CCryptoBoringSSL_x25519_sc_reduce(hram);
+    memcpy(sig, ctx->R, 32);
+    CCryptoBoringSSLShims_ed25519_sc_muladd(sig + 32, hram, expanded_key, ctx->nonce);
+    CCryptoBoringSSL_OPENSSL_cleanse(ctx, sizeof(*ctx));
+}
+
+static void CCryptoBoringSSLShims_ed25519_sign_impl(uint8_t sig[64], const uint8_t *dom, size_t dom_len,
+                                                    const uint8_t *message, size_t message_len,
+                                                    const uint8_t expanded_key[64], const uint8_t public_key[32]) {
+    CCryptoBoringSSLShims_ED25519_SIGN_CTX ctx;
+    CCryptoBoringSSLShims_ed25519_sign_init_dom(&ctx, dom, dom_len, expanded_key);
+    CCryptoBoringSSL_SHA512_Update(&ctx.hash, message, message_len);
+    CCryptoBoringSSLShims_ed25519_sign_commit_dom(&ctx, dom, dom_len, public_key);
+    CCryptoBoringSSL_SHA512_Update(&ctx.hash, message, message_len);
+    CCryptoBoringSSLShims_ED25519_sign_final(&ctx, sig, expanded_key);
+}
+
+void CCryptoBoringSSLShims_ED25519_sign_expanded(void *out_sig, const void *message, size_t message_len,
+                                                 const void *expanded_key, const void *public_key) {
+    CCRYPTOBORINGSSLSHIMS_TRACE_ENTRY(ed25519_sign, NID_ED25519, 256, message_len);
+    CCryptoBoringSSLShims_ed25519_sign_impl(out_sig, NULL, 0, message, message_len, expanded_key, public_key);
+    CCRYPTOBORINGSSLSHIMS_TRACE_RETURN(ed25519_sign, NID_ED25519, 256, message_len, 1);
+}
+
+// Writes dom2(1, |context|) from RFC 8032, section 2, to |out|, which must have
+// room for |CCryptoBoringSSLShims_ED25519PH_MAX_DOM_BYTES|. Returns its length,
+// or zero if |context| is too long.
+#define CCryptoBoringSSLShims_ED25519PH_MAX_DOM_BYTES (32 + 2 + 255)
+static size_t CCryptoBoringSSLShims_ed25519ph_dom(uint8_t *out, const uint8_t *context, size_t context_len) {
+    static const char kDomPrefix[] = "SigEd25519 no Ed25519 collisions";
+    if (context_len > 255) {
+        return 0;
+    }
+    memcpy(out, kDomPrefix, 32);
+    out[32] = 1;
+    out[33] = (uint8_t)context_len;
+    if (context_len > 0) {
+        memcpy(out + 34, context, context_len);
+    }
+    return 34 + context_len;
+}
+
+int CCryptoBoringSSLShims_ED25519ph_sign(void *out_sig, const void *prehash, const void *context, size_t context_len,
+                                         const void *expanded_key, const void *public_key) {
+    uint8_t dom[CCryptoBoringSSLShims_ED25519PH_MAX_DOM_BYTES];
+    size_t dom_len = CCryptoBoringSSLShims_ed25519ph_dom(dom, context, context_len);
+    if (dom_len == 0) {
+        return 0;
+    }
+    CCryptoBoringSSLShims_ed25519_sign_impl(out_sig, dom, dom_len, prehash, SHA512_DIGEST_LENGTH, expanded_key,
+                                            public_key);
+    return 1;
+}
+
+// As in |ED25519_verify|, s must be in the range [0, order).
+static int CCryptoBoringSSLShims_ed25519_s_is_reduced(const uint8_t sig[64]) {
+    static const uint64_t kOrder[4] = {
+        UINT64_C(0x5812631a5cf5d3ed),
+        UINT64_C(0x14def9dea2f79cd6),
+        0,
+        UINT64_C(0x1000000000000000),
+    };
+    if ((sig[63] & 224) != 0) {
+        return 0;
+    }
+    for (size_t i = 3;; i--) {
+        uint64_t word = CRYPTO_load_u64_le(sig + 32 + i * 8);
+        if (word > kOrder[i]) {
+            return 0;
+        } else if (word < kOrder[i]) {
+            return 1;
+        } else if (i == 0) {
+            return 0;
+        }
+    }
+}
+
+// Checks the parts of a signature that don't depend on the message and starts
+// hashing dom || R || A. A signature that fails here leaves |ctx->valid| zero.
+static void CCryptoBoringSSLShims_ed25519_verify_init_dom(CCryptoBoringSSLShims_ED25519_VERIFY_CTX *ctx,
+                                                          const uint8_t *dom, size_t dom_len,
+                                                          const uint8_t sig[64], const uint8_t public_key[32]) {
+    memcpy(ctx->sig, sig, 64);
+    memcpy(ctx->public_key, public_key, 32);
+    ctx->valid = 0;
+    CCryptoBoringSSL_SHA512_Init(&ctx->hash);
+
+    ge_p3 A;
+    if (!CCryptoBoringSSLShims_ed25519_s_is_reduced(sig) ||
+        !CCryptoBoringSSL_x25519_ge_frombytes_vartime(&A, public_key)) {
+        return;
+    }
+
+    CCryptoBoringSSL_SHA512_Update(&ctx->hash, dom, dom_len);
+    CCryptoBoringSSL_SHA512_Update(&ctx->hash, sig, 32);
+    CCryptoBoringSSL_SHA512_Update(&ctx->hash, public_key, 32);
+    ctx->valid = 1;
+}
+
+void CCryptoBoringSSLShims_ED25519_verify_init(CCryptoBoringSSLShims_ED25519_VERIFY_CTX *ctx, const void *signature,
+                                               const void *public_key) {
+    CCryptoBoringSSLShims_ed25519_verify_init_dom(ctx, NULL, 0, signature, public_key);
+}
+
+void CCryptoBoringSSLShims_ED25519_verify_update(CCryptoBoringSSLShims_ED25519_VERIFY_CTX *ctx, const void *data,
+                                                 size_t len) {
+    CCryptoBoringSSL_SHA512_Update(&ctx->hash, data, len);
+}
+
+int CCryptoBoringSSLShims_ED25519_verify_final(CCryptoBoringSSLShims_ED25519_VERIFY_CTX *ctx) {
+    uint8_t h[SHA512_DIGEST_LENGTH];
+    CCryptoBoringSSL_SHA512_Final(h, &ctx->hash);
+    if (!ctx->valid) {
+        return 0;
+    }
+    CCryptoBoringSSL_x25519_sc_reduce(h);
+    if (CCryptoBoringSSLShims_ed25519_wide_table_enabled()) {
+        return CCryptoBoringSSLShims_ed25519_verify_wide(ctx->sig, ctx->public_key, h);
+    }
+
+    ge_p3 A;
+    if (!CCryptoBoringSSL_x25519_ge_frombytes_vartime(&A, ctx->public_key)) {
+        return 0;
+    }
+
+    // |ge_double_scalarmult_vartime| and the field arithmetic needed to negate
+    // A are static in curve25519.c. Instead, compute [h]A in projective form,
+    // round-trip it through its encoding to get extended coordinates, and
+    // subtract it from [s]B. Everything here is public, so the extra decoding
+    // costs time but leaks nothing.
+    ge_p2 hA;
+    uint8_t hA_bytes[32];
+    ge_p3 hA_extended;
+    CCryptoBoringSSL_x25519_ge_scalarmult(&hA, h, &A);
+    CCryptoBoringSSL_x25519_ge_tobytes(hA_bytes, &hA);
+    if (!CCryptoBoringSSL_x25519_ge_frombytes_vartime(&hA_extended, hA_bytes)) {
+        return 0;
+    }
+
+    ge_p3 sB;
+    ge_cached hA_cached;
+    ge_p1p1 difference;
+    ge_p2 R;
+    uint8_t rcheck[32];
+    CCryptoBoringSSLShims_ed25519_scalarmult_base(&sB, ctx->sig + 32);
+    CCryptoBoringSSL_x25519_ge_p3_to_cached(&hA_cached, &hA_extended);
+    CCryptoBoringSSL_x25519_ge_sub(&difference, &sB, &hA_cached);
+    CCryptoBoringSSL_x25519_ge_p1p1_to_p2(&R, &difference);
+    CCryptoBoringSSL_x25519_ge_tobytes(rcheck, &R);
+
+    return CRYPTO_memcmp(rcheck, ctx->sig, sizeof(rcheck)) == 0;
+}
+
+int CCryptoBoringSSLShims_ED25519ph_verify(const void *prehash, const void *context, size_t context_len,
+                                           const void *signature, const void *public_key) {
+    uint8_t dom[CCryptoBoringSSLShims_ED25519PH_MAX_DOM_BYTES];
+    size_t dom_len = CCryptoBoringSSLShims_ed25519ph_dom(dom, context, context_len);
+    if (dom_len == 0) {
+        return 0;
+    }
+    CCryptoBoringSSLShims_ED25519_VERIFY_CTX ctx;
+    CCryptoBoringSSLShims_ed25519_verify_init_dom(&ctx, dom, dom_len, signature, public_key);
+    CCryptoBoringSSL_SHA512_Update(&ctx.hash, prehash, SHA512_DIGEST_LENGTH);
+    return CCryptoBoringSSLShims_ED25519_verify_final(&ctx);
+}
+
+// MARK:- Prepared public keys
+
+#if defined(CCRYPTOBORINGSSLSHIMS_ED25519_WIDE_TABLE)
+static_assert(sizeof(ge_cached) * CCRYPTOBORINGSSLSHIMS_ED25519_A_MULTIPLES == CCryptoBoringSSLShims_ED25519_PREPARED_BYTES,
+              "CCryptoBoringSSLShims_ED25519_PREPARED_BYTES is wrong");
+#endif
+
+uint32_t CCryptoBoringSSLShims_ED25519_prepared_layout(void) {
+#if defined(CCRYPTOBORINGSSLSHIMS_ED25519_WIDE_TABLE)
+    // Five 51-bit limbs per field element, as fiat_25519_64 stores them.
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+int CCryptoBoringSSLShims_ED25519_prepare(void *out_prepared, const void *public_key) {
+#if defined(CCRYPTOBORINGSSLSHIMS_ED25519_WIDE_TABLE)
+    ge_p3 A;
+    if (!CCryptoBoringSSL_x25519_ge_frombytes_vartime(&A, public_key)) {
+        return 0;
+    }
+    // Verification subtracts [h]A, so the table holds the multiples of -A.
+    CCryptoBoringSSLShims_ed25519_negate(&A);
+    ge_cached Ai[CCRYPTOBORINGSSLSHIMS_ED25519_A_MULTIPLES];
+    CCryptoBoringSSLShims_ed25519_odd_multiples(Ai, &A);
+    memcpy(out_prepared, Ai, sizeof(Ai));
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+int CCryptoBoringSSLShims_ED25519_verify_prepared(const void *message, size_t message_len, const void *signature,
+                                                  const void *public_key, const void *prepared) {
+#if defined(CCRYPTOBORINGSSLSHIMS_ED25519_WIDE_TABLE)
+    const uint8_t *sig = signature;
+    if (!CCryptoBoringSSLShims_ed25519_s_is_reduced(sig)) {
+        return 0;
+    }
+
+    SHA512_CTX hash;
+    uint8_t h[SHA512_DIGEST_LENGTH];
+    CCryptoBoringSSL_SHA512_Init(&hash);
+    CCryptoBoringSSL_SHA512_Update(&hash, sig, 32);
+    CCryptoBoringSSL_SHA512_Update(&hash, public_key, 32);
+    CCryptoBoringSSL_SHA512_Update(&hash, message, message_len);
+    CCryptoBoringSSL_SHA512_Final(h, &hash);
+    CCryptoBoringSSL_x25519_sc_reduce(h);
+
+    // The table may come from a mapped file with no particular alignment.
+    ge_cached Ai[CCRYPTOBORINGSSLSHIMS_ED25519_A_MULTIPLES];
+    memcpy(Ai, prepared, sizeof(Ai));
+    ge_p2 R;
+    uint8_t rcheck[32];
+    CCryptoBoringSSLShims_ed25519_double_scalarmult_vartime_multiples(&R, h, Ai, sig + 32);
+    CCryptoBoringSSL_x25519_ge_tobytes(rcheck, &R);
+    return CRYPTO_memcmp(rcheck, sig, sizeof(rcheck)) == 0;
+#else
+    return CCryptoBoringSSL_ED25519_verify(message, message_len, signature, public_key);
+#endif
+}
+
+int CCryptoBoringSSLShims_RSA_montgomery_rr(RSA *rsa, uint8_t *out, size_t out_len, uint32_t *out_r_bits) {
+    if (!CCryptoBoringSSL_BN_MONT_CTX_set_locked(&rsa->mont_n, &rsa->lock, rsa->n, NULL)) {
+        return 0;
+    }
+    *out_r_bits = (uint32_t)(rsa->mont_n->N.width * BN_BITS2);
+    return CCryptoBoringSSL_BN_bn2bin_padded(out, out_len, &rsa->mont_n->RR);
+}
+
+int CCryptoBoringSSLShims_RSA_set_montgomery_rr(RSA *rsa, const uint8_t *rr, size_t rr_len, uint32_t r_bits) {
+    BN_MONT_CTX *mont = CCryptoBoringSSL_BN_MONT_CTX_new();
+    if (mont == NULL) {
+        return 0;
+    }
+    // As bn_mont_ctx_set_N_and_n0 and BN_MONT_CTX_set do, but taking RR as
+    // given. RR only depends on n and the word size, which |r_bits| records.
+    int ok = CCryptoBoringSSL_BN_is_odd(rsa->n) && !CCryptoBoringSSL_BN_is_negative(rsa->n) &&
+             CCryptoBoringSSL_BN_copy(&mont->N, rsa->n);
+    if (ok) {
+        CCryptoBoringSSL_bn_set_minimal_width(&mont->N);
+        size_t width = (size_t)mont->N.width;
+        ok = width <= BN_MONTGOMERY_MAX_WORDS && r_bits == width * BN_BITS2 &&
+             CCryptoBoringSSL_BN_bin2bn(rr, rr_len, &mont->RR) != NULL &&
+             CCryptoBoringSSL_BN_ucmp(&mont->RR, &mont->N) < 0 &&
+             CCryptoBoringSSL_bn_resize_words(&mont->RR, mont->N.width);
+    }
+    if (ok) {
+        uint64_t n0 = CCryptoBoringSSL_bn_mont_n0(&mont->N);
+        mont->n0[0] = (BN_ULONG)n0;
+#if BN_MONT_CTX_N0_LIMBS == 2
+        mont->n0[1] = (BN_ULONG)(n0 >> BN_BITS2);
+#else
+        mont->n0[1] = 0;
+#endif
+    }
+    if (!ok || rsa->mont_n != NULL) {
+        CCryptoBoringSSL_BN_MONT_CTX_free(mont);
+        return ok;
+    }
+    rsa->mont_n = mont;
+    return 1;
+}
+
+// MARK:- Batch Ed25519 signing
+
+// Every signature, with its own key, costs three SHA-512s: of the seed, for
+// the nonce and for the challenge. Messages are usually short, so each is a
+// block or two, and running them in SIMD lanes (eight with AVX-512, four with
+// AVX2) is several times faster than one at a time. Each lane takes its next
+// message as soon as it finishes one, so different lengths share the lanes.
+// The nonce commitments R are then encoded with one field inversion per
+// chunk, by Montgomery's trick, instead of one each. The fixed-base
+// multiplications stay with BoringSSL's constant-time one, per signature.
+
+#define CCRYPTOBORINGSSLSHIMS_ED25519_SIGN_CHUNK 32
+
+// One message for |CCryptoBoringSSLShims_sha512_multi|: |head| (at most 64
+// bytes) followed by |body|.
+typedef struct {
+    const uint8_t *head;
+    size_t head_len;
+    const uint8_t *body;
+    size_t body_len;
+    uint8_t *out;
+} CCryptoBoringSSLShims_sha512_job;
+
+#if !defined(OPENSSL_NO_ASM) && defined(OPENSSL_X86_64) && (defined(__GNUC__) || defined(__clang__))
+#define CCRYPTOBORINGSSLSHIMS_SHA512_MULTI 1
+#include <immintrin.h>
+
+#define CCRYPTOBORINGSSLSHIMS_SHA512_MAX_LANES 8
+
+static const uint64_t CCryptoBoringSSLShims_sha512_k[80] = {
+    UINT64_C(0x428a2f98d728ae22), UINT64_C(0x7137449123ef65cd), UINT64_C(0xb5c0fbcfec4d3b2f),
+    UINT64_C(0xe9b5dba58189dbbc), UINT64_C(0x3956c25bf348b538), UINT64_C(0x59f111f1b605d019),
+    UINT64_C(0x923f82a4af194f9b), UINT64_C(0xab1c5ed5da6d8118), UINT64_C(0xd807aa98a3030242),
+    UINT64_C(0x12835b0145706fbe), UINT64_C(0x243185be4ee4b28c), UINT64_C(0x550c7dc3d5ffb4e2),
+    UINT64_C(0x72be5d74f27b896f), UINT64_C(0x80deb1fe3b1696b1), UINT64_C(0x9bdc06a725c71235),
+    UINT64_C(0xc19bf174cf692694), UINT64_C(0xe49b69c19ef14ad2), UINT64_C(0xefbe4786384f25e3),
+    UINT64_C(0x0fc19dc68b8cd5b5), UINT64_C(0x240ca1cc77ac9c65), UINT64_C(0x2de92c6f592b0275),
+    UINT64_C(0x4a7484aa6ea6e483), UINT64_C(0x5cb0a9dcbd41fbd4), UINT64_C(0x76f988da831153b5),
+    UINT64_C(0x983e5152ee66dfab), UINT64_C(0xa831c66d2db43210), UINT64_C(0xb00327c898fb213f),
+    UINT64_C(0xbf597fc7beef0ee4), UINT64_C(0xc6e00bf33da88fc2), UINT64_C(0xd5a79147930aa725),
+    UINT64_C(0x06ca6351e003826f), UINT64_C(0x142929670a0e6e70), UINT64_C(0x27b70a8546d22ffc),
+    UINT64_C(0x2e1b21385c26c926), UINT64_C(0x4d2c6dfc5ac42aed), UINT64_C(0x53380d139d95b3df),
+    UINT64_C(0x650a73548baf63de), UINT64_C(0x766a0abb3c77b2a8), UINT64_C(0x81c2c92e47edaee6),
+    UINT64_C(0x92722c851482353b), UINT64_C(0xa2bfe8a14cf10364), UINT64_C(0xa81a664bbc423001),
+    UINT64_C(0xc24b8b70d0f89791), UINT64_C(0xc76c51a30654be30), UINT64_C(0xd192e819d6ef5218),
+    UINT64_C(0xd69906245565a910), UINT64_C(0xf40e35855771202a), UINT64_C(0x106aa07032bbd1b8),
+    UINT64_C(0x19a4c116b8d2d0c8), UINT64_C(0x1e376c085141ab53), UINT64_C(0x2748774cdf8eeb99),
+    UINT64_C(0x34b0bcb5e19b48a8), UINT64_C(0x391c0cb3c5c95a63), UINT64_C(0x4ed8aa4ae3418acb),
+    UINT64_C(0x5b9cca4f7763e373), UINT64_C(0x682e6ff3d6b2b8a3), UINT64_C(0x748f82ee5defb2fc),
+    UINT64_C(0x78a5636f43172f60), UINT64_C(0x84c87814a1f0ab72), UINT64_C(0x8cc702081a6439ec),
+    UINT64_C(0x90befffa23631e28), UINT64_C(0xa4506cebde82bde9), UINT64_C(0xbef9a3f7b2c67915),
+    UINT64_C(0xc67178f2e372532b), UINT64_C(0xca273eceea26619c), UINT64_C(0xd186b8c721c0c207),
+    UINT64_C(0xeada7dd6cde0eb1e), UINT64_C(0xf57d4f7fee6ed178), UINT64_C(0x06f067aa72176fba),
+    UINT64_C(0x0a637dc5a2c898a6), UINT64_C(0x113f9804bef90dae), UINT64_C(0x1b710b35131c471b),
+    UINT64_C(0x28db77f523047d84), UINT64_C(0x32caab7b40c72493), UINT64_C(0x3c9ebe0a15c9bebc),
+    UINT64_C(0x431d67c49c100d4c), UINT64_C(0x4cc5d4becb3e42b6), UINT64_C(0x597f299cfc657e2a),
+    UINT64_C(0x5fcb6fab3ad6faec), UINT64_C(0x6c44198c4a475817),
+};
+
+static const uint64_t CCryptoBoringSSLShims_sha512_iv[8] = {
+    UINT64_C(0x6a09e667f3bcc908), UINT64_C(0xbb67ae8584caa73b), UINT64_C(0x3c6ef372fe94f82b),
+    UINT64_C(0xa54ff53a5f1d36f1), UINT64_C(0x510e527fade682d1), UINT64_C(0x9b05688c2b3e6c1f),
+    UINT64_C(0x1f83d9abfb41bd6b), UINT64_C(0x5be0cd19137e2179),
+};
+
+// Runs the SHA-512 compression function on independent states, one per 64-bit
+// lane of |state[k]|, with each lane's sixteen message words in |w[k]|. The
+// AVX-512 kernel fills all eight lanes and the AVX2 one the first four.
+typedef void (*CCryptoBoringSSLShims_sha512_multi_compress_f)(uint64_t state[8][CCRYPTOBORINGSSLSHIMS_SHA512_MAX_LANES],
+                                                              const uint64_t w[16][CCRYPTOBORINGSSLSHIMS_SHA512_MAX_LANES]);
+
+__attribute__((target("avx512f")))
+static void CCryptoBoringSSLShims_sha512_compress8_avx512(uint64_t state_words[8][CCRYPTOBORINGSSLSHIMS_SHA512_MAX_LANES],
+                                                          const uint64_t w_words[16][CCRYPTOBORINGSSLSHIMS_SHA512_MAX_LANES]) {
+    __m512i state[8], w[16];
+    for (size_t k = 0; k < 8; k++) {
+        state[k] = _mm512_loadu_si512(state_words[k]);
+    }
+    for (size_t k = 0; k < 16; k++) {
+        w[k] = _mm512_loadu_si512(w_words[k]);
+    }
+    __m512i a = state[0], b = state[1], c = state[2], d = state[3];
+    __m512i e = state[4], f = state[5], g = state[6], h = state[7];
+
+    for (size_t i = 0; i < 80; i++) {
+        if (i >= 16) {
+            const __m512i w15 = w[(i - 15) & 15], w2 = w[(i - 2) & 15];
+            const __m512i s0 = _mm512_ternarylogic_epi64(_mm512_ror_epi64(w15, 1), _mm512_ror_epi64(w15, 8),
+                                                         _mm512_srli_epi64(w15, 7), 0x96);
+            const __m512i s1 = _mm512_ternarylogic_epi64(_mm512_ror_epi64(w2, 19), _mm512_ror_epi64(w2, 61),
+                                                         _mm512_srli_epi64(w2, 6), 0x96);
+            w[i & 15] = _mm512_add_epi64(_mm512_add_epi64(w[i & 15], s0), _mm512_add_epi64(w[(i - 7) & 15], s1));
+        }
+
+        const __m512i sigma1 = _mm512_ternarylogic_epi64(_mm512_ror_epi64(e, 14), _mm512_ror_epi64(e, 18),
+                                                         _mm512_ror_epi64(e, 41), 0x96);
+        const __m512i ch = _mm512_ternarylogic_epi64(e, f, g, 0xca);
+        const __m512i t1 = _mm512_add_epi64(
+            _mm512_add_epi64(_mm512_add_epi64(h, sigma1), _mm512_add_epi64(ch, w[i & 15])),
+            _mm512_set1_epi64((long long)CCryptoBoringSSLShims_sha512_k[i]));
+        const __m512i sigma0 = _mm512_ternarylogic_epi64(_mm512_ror_epi64(a, 28), _mm512_ror_epi64(a, 34),
+                                                         _mm512_ror_epi64(a, 39), 0x96);
+        const __m512i maj = _mm512_ternarylogic_epi64(a, b, c, 0xe8);
+        const __m512i t2 = _mm512_add_epi64(sigma0, maj);
+
+        h = g;
+        g = f;
+        f = e;
+        e = _mm512_add_epi64(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = _mm512_add_epi64(t1, t2);
+    }
+
+    const __m512i out[8] = {a, b, c, d, e, f, g, h};
+    for (size_t k = 0; k < 8; k++) {
+        _mm512_storeu_si512(state_words[k], _mm512_add_epi64(state[k], out[k]));
+    }
+}
+
+__attribute__((target("avx2")))
+static inline __m256i CCryptoBoringSSLShims_sha512_rotr_avx2(__m256i x, int n) {
+    return _mm256_or_si256(_mm256_srli_epi64(x, n), _mm256_slli_epi64(x, 64 - n));
+}
+
+__attribute__((target("avx2")))
+static void CCryptoBoringSSLShims_sha512_compress4_avx2(uint64_t state_words[8][CCRYPTOBORINGSSLSHIMS_SHA512_MAX_LANES],
+                                                        const uint64_t w_words[16][CCRYPTOBORINGSSLSHIMS_SHA512_MAX_LANES]) {
+    __m256i state[8], w[16];
+    for (size_t k = 0; k < 8; k++) {
+        state[k] = _mm256_loadu_si256((const __m256i *)state_words[k]);
+    }
+    for (size_t k = 0; k < 16; k++) {
+        w[k] = _mm256_loadu_si256((const __m256i *)w_words[k]);
+    }
+    __m256i a = state[0], b = state[1], c = state[2], d = state[3];
+    __m256i e = state[4], f = state[5], g = state[6], h = state[7];
+
+    for (size_t i = 0; i < 80; i++) {
+        if (i >= 16) {
+            const __m256i w15 = w[(i - 15) & 15], w2 = w[(i - 2) & 15];
+            const __m256i s0 = _mm256_xor_si256(
+                _mm256_xor_si256(CCryptoBoringSSLShims_sha512_rotr_avx2(w15, 1), CCryptoBoringSSLShims_sha512_rotr_avx2(w15, 8)),
+                _mm256_srli_epi64(w15, 7));
+            const __m256i s1 = _mm256_xor_si256(
+                _mm256_xor_si256(CCryptoBoringSSLShims_sha512_rotr_avx2(w2, 19), CCryptoBoringSSLShims_sha512_rotr_avx2(w2, 61)),
+                _mm256_srli_epi64(w2, 6));
+            w[i & 15] = _mm256_add_epi64(_mm256_add_epi64(w[i & 15], s0), _mm256_add_epi64(w[(i - 7) & 15], s1));
+        }
+
+        const __m256i sigma1 = _mm256_xor_si256(
+            _mm256_xor_si256(CCryptoBoringSSLShims_sha512_rotr_avx2(e, 14), CCryptoBoringSSLShims_sha512_rotr_avx2(e, 18)),
+            CCryptoBoringSSLShims_sha512_rotr_avx2(e, 41));
+        const __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        const __m256i t1 = _mm256_add_epi64(
+            _mm256_add_epi64(_mm256_add_epi64(h, sigma1), _mm256_add_epi64(ch, w[i & 15])),
+            _mm256_set1_epi64x((long long)CCryptoBoringSSLShims_sha512_k[i]));
+        const __m256i sigma0 = _mm256_xor_si256(
+            _mm256_xor_si256(CCryptoBoringSSLShims_sha512_rotr_avx2(a, 28), CCryptoBoringSSLShims_sha512_rotr_avx2(a, 34)),
+            CCryptoBoringSSLShims_sha512_rotr_avx2(a, 39));
+        const __m256i maj = _mm256_xor_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_xor_si256(a, b)));
+        const __m256i t2 = _mm256_add_epi64(sigma0, maj);
+
+        h = g;
+        g = f;
+        f = e;
+        e = _mm256_add_epi64(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = _mm256_add_epi64(t1, t2);
+    }
+
+    const __m256i out[8] = {a, b, c, d, e, f, g, h};
+    for (size_t k = 0; k < 8; k++) {
+        _mm256_storeu_si256((__m256i *)state_words[k], _mm256_add_epi64(state[k], out[k]));
+    }
+}
+
+static size_t CCryptoBoringSSLShims_sha512_job_blocks(const CCryptoBoringSSLShims_sha512_job *job) {
+    // The padding takes at least seventeen bytes: 0x80 and a 128-bit length.
+    return (job->head_len + job->body_len + 17 + SHA512_CBLOCK - 1) / SHA512_CBLOCK;
+}
+
+// Writes block |index| of the padded message of |job| to |out|.
+static void CCryptoBoringSSLShims_sha512_job_block(const CCryptoBoringSSLShims_sha512_job *job, size_t index,
+                                                   uint8_t out[SHA512_CBLOCK]) {
+    const size_t len = job->head_len + job->body_len;
+    const size_t start = index * SHA512_CBLOCK;
+    size_t done = 0;
+    if (start < job->head_len) {
+        done = job->head_len - start < SHA512_CBLOCK ? job->head_len - start : SHA512_CBLOCK;
+        memcpy(out, job->head + start, done);
+    }
+    if (done < SHA512_CBLOCK && start + done < len) {
+        const size_t body_start = start + done - job->head_len;
+        size_t todo = job->body_len - body_start;
+        todo = todo < SHA512_CBLOCK - done ? todo : SHA512_CBLOCK - done;
+        memcpy(out + done, job->body + body_start, todo);
+        done += todo;
+    }
+    if (done < SHA512_CBLOCK) {
+        memset(out + done, 0, SHA512_CBLOCK - done);
+        if (start + done == len) {
+            out[done] = 0x80;
+        }
+    }
+    if (index + 1 == CCryptoBoringSSLShims_sha512_job_blocks(job)) {
+        CRYPTO_store_u64_be(out + SHA512_CBLOCK - 8, (uint64_t)len * 8);
+    }
+}
+
+// Hashes every job with |lanes| lanes of |compress|. A lane that finishes its
+// job writes the digest and takes the next job; a lane with nothing left to
+// do compresses zeros that are thrown away.
+static void CCryptoBoringSSLShims_sha512_multi_lanes(const CCryptoBoringSSLShims_sha512_job *jobs, size_t count,
+                                                     CCryptoBoringSSLShims_sha512_multi_compress_f compress,
+                                                     size_t lanes) {
+    uint64_t state[8][CCRYPTOBORINGSSLSHIMS_SHA512_MAX_LANES] = {{0}};
+    uint64_t w[16][CCRYPTOBORINGSSLSHIMS_SHA512_MAX_LANES];
+    const CCryptoBoringSSLShims_sha512_job *lane_job[CCRYPTOBORINGSSLSHIMS_SHA512_MAX_LANES] = {NULL};
+    size_t lane_block[CCRYPTOBORINGSSLSHIMS_SHA512_MAX_LANES] = {0};
+    size_t next = 0;
+    uint8_t block[SHA512_CBLOCK];
+
+    for (;;) {
+        size_t active = 0;
+        for (size_t lane = 0; lane < lanes; lane++) {
+            if (lane_job[lane] == NULL && next < count) {
+                lane_job[lane] = &jobs[next++];
+                lane_block[lane] = 0;
+                for (size_t k = 0; k < 8; k++) {
+                    state[k][lane] = CCryptoBoringSSLShims_sha512_iv[k];
+                }
+            }
+            if (lane_job[lane] == NULL) {
+                for (size_t k = 0; k < 16; k++) {
+                    w[k][lane] = 0;
+                }
+                continue;
+            }
+            active++;
+            CCryptoBoringSSLShims_sha512_job_block(lane_job[lane], lane_block[lane], block);
+            for (size_t k = 0; k < 16; k++) {
+                w[k][lane] = CRYPTO_load_u64_be(block + 8 * k);
+            }
+        }
+        if (active == 0) {
+            break;
+        }
+
+        compress(state, w);
+
+        for (size_t lane = 0; lane < lanes; lane++) {
+            if (lane_job[lane] == NULL) {
+                continue;
+            }
+            if (++lane_block[lane] == CCryptoBoringSSLShims_sha512_job_blocks(lane_job[lane])) {
+                for (size_t k = 0; k < 8; k++) {
+                    CRYPTO_store_u64_be(lane_job[lane]->out + 8 * k, state[k][lane]);
+                }
+                lane_job[lane] = NULL;
+            }
+        }
+    }
+
+    CCryptoBoringSSL_OPENSSL_cleanse(state, sizeof(state));
+    CCryptoBoringSSL_OPENSSL_cleanse(w, sizeof(w));
+    CCryptoBoringSSL_OPENSSL_cleanse(block, sizeof(block));
+}
+#endif  // CCRYPTOBORINGSSLSHIMS_SHA512_MULTI
+
+static void CCryptoBoringSSLShims_sha512_multi(const CCryptoBoringSSLShims_sha512_job *jobs, size_t count) {
+#if defined(CCRYPTOBORINGSSLSHIMS_SHA512_MULTI)
+    if (count > 1 && CCryptoBoringSSLShims_ia32cap(2, 16)) {
+        CCryptoBoringSSLShims_sha512_multi_lanes(jobs, count, CCryptoBoringSSLShims_sha512_compress8_avx512, 8);
+        return;
+    }
+    if (count > 1 && CRYPTO_is_AVX2_capable()) {
+        CCryptoBoringSSLShims_sha512_multi_lanes(jobs, count, CCryptoBoringSSLShims_sha512_compress4_avx2, 4);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < count; i++) {
+        SHA512_CTX ctx;
+        CCryptoBoringSSL_SHA512_Init(&ctx);
+        CCryptoBoringSSL_SHA512_Update(&ctx, jobs[i].head, jobs[i].head_len);
+        CCryptoBoringSSL_SHA512_Update(&ctx, jobs[i].body, jobs[i].body_len);
+        CCryptoBoringSSL_SHA512_Final(jobs[i].out, &ctx);
+    }
+}
+
+// Encodes |count| points as x25519_ge_tobytes would, sharing one inversion.
+static void CCryptoBoringSSLShims_ed25519_encode_batch(uint8_t *out, const ge_p3 *points, size_t count) {
+    if (count == 0) {
+        return;
+    }
+#if defined(BORINGSSL_HAS_UINT128) && defined(OPENSSL_64_BIT)
+    // No Z is zero, so Montgomery's trick applies without special cases.
+    CCryptoBoringSSLShims_fe25519 prefix[CCRYPTOBORINGSSLSHIMS_ED25519_SIGN_CHUNK], inverse, z_inverse, x, y;
+    memcpy(prefix[0], points[0].Z.v, sizeof(prefix[0]));
+    for (size_t i = 1; i < count; i++) {
+        fiat_25519_carry_mul(prefix[i], prefix[i - 1], points[i].Z.v);
+    }
+    CCryptoBoringSSLShims_fe25519_invert(inverse, prefix[count - 1]);
+    for (size_t i = count; i-- > 0;) {
+        if (i > 0) {
+            fiat_25519_carry_mul(z_inverse, inverse, prefix[i - 1]);
+            fiat_25519_carry_mul(inverse, inverse, points[i].Z.v);
+        } else {
+            memcpy(z_inverse, inverse, sizeof(z_inverse));
+        }
+        uint8_t x_bytes[32];
+        fiat_25519_carry_mul(x, points[i].X.v, z_inverse);
+        fiat_25519_carry_mul(y, points[i].Y.v, z_inverse);
+        fiat_25519_to_bytes(out + 32 * i, y);
+        fiat_25519_to_bytes(x_bytes, x);
+        out[32 * i + 31] ^= (x_bytes[0] & 1) << 7;
+    }
+    CCryptoBoringSSL_OPENSSL_cleanse(prefix, sizeof(prefix));
+    CCryptoBoringSSL_OPENSSL_cleanse(inverse, sizeof(inverse));
+    CCryptoBoringSSL_OPENSSL_cleanse(z_inverse, sizeof(z_inverse));
+    CCryptoBoringSSL_OPENSSL_cleanse(x, sizeof(x));
+    CCryptoBoringSSL_OPENSSL_cleanse(y, sizeof(y));
+#else
+    for (size_t i = 0; i < count; i++) {
+        ge_p2 projective;
+        projective.X = points[i].X;
+        projective.Y = points[i].Y;
+        projective.Z = points[i].Z;
+        CCryptoBoringSSL_x25519_ge_tobytes(out + 32 * i, &projective);
+        CCryptoBoringSSL_OPENSSL_cleanse(&projective, sizeof(projective));
+    }
+#endif
+}
+
+static void CCryptoBoringSSLShims_ed25519_sign_chunk(uint8_t *out, const CCryptoBoringSSLShims_ED25519_sign_batch_op *ops,
+                                                     size_t count) {
+    uint8_t expanded[CCRYPTOBORINGSSLSHIMS_ED25519_SIGN_CHUNK][SHA512_DIGEST_LENGTH];
+    uint8_t nonce[CCRYPTOBORINGSSLSHIMS_ED25519_SIGN_CHUNK][SHA512_DIGEST_LENGTH];
+    uint8_t hram[CCRYPTOBORINGSSLSHIMS_ED25519_SIGN_CHUNK][SHA512_DIGEST_LENGTH];
+    uint8_t R_and_A[CCRYPTOBORINGSSLSHIMS_ED25519_SIGN_CHUNK][64];
+    ge_p3 R[CCRYPTOBORINGSSLSHIMS_ED25519_SIGN_CHUNK];
+    CCryptoBoringSSLShims_sha512_job jobs[CCRYPTOBORINGSSLSHIMS_ED25519_SIGN_CHUNK];
+
+    // The expanded keys, as CCryptoBoringSSLShims_ED25519_expand computes them.
+    for (size_t i = 0; i < count; i++) {
+        jobs[i] = (CCryptoBoringSSLShims_sha512_job){ops[i].seed, CCryptoBoringSSLShims_ED25519_SEED_BYTES, NULL, 0,
+                                                     expanded[i]};
+    }
+    CCryptoBoringSSLShims_sha512_multi(jobs, count);
+    for (size_t i = 0; i < count; i++) {
+        uint8_t wide[64] = {0};
+        expanded[i][0] &= 248;
+        expanded[i][31] &= 63;
+        expanded[i][31] |= 64;
+        memcpy(wide, expanded[i], 32);
+        CCryptoBoringSSL_x25519_sc_reduce(wide);
+        memcpy(expanded[i], wide, 32);
+        CCryptoBoringSSL_OPENSSL_cleanse(wide, sizeof(wide));
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        jobs[i] = (CCryptoBoringSSLShims_sha512_job){expanded[i] + 32, 32, ops[i].message, ops[i].message_len,
+                                                     nonce[i]};
+    }
+    CCryptoBoringSSLShims_sha512_multi(jobs, count);
+    for (size_t i = 0; i < count; i++) {
+        CCryptoBoringSSL_x25519_sc_reduce(nonce[i]);
+        CCryptoBoringSSLShims_ed25519_scalarmult_base(&R[i], nonce[i]);
+    }
+    uint8_t encoded[CCRYPTOBORINGSSLSHIMS_ED25519_SIGN_CHUNK * 32];
+    CCryptoBoringSSLShims_ed25519_encode_batch(encoded, R, count);
+
+    for (size_t i = 0; i < count; i++) {
+        memcpy(R_and_A[i], encoded + 32 * i, 32);
+        memcpy(R_and_A[i] + 32, ops[i].public_key, 32);
+        jobs[i] = (CCryptoBoringSSLShims_sha512_job){R_and_A[i], 64, ops[i].message, ops[i].message_len, hram[i]};
+    }
+    CCryptoBoringSSLShims_sha512_multi(jobs, count);
+    for (size_t i = 0; i < count; i++) {
+        uint8_t *sig = out + 64 * i;
+        CCryptoBoringSSL_x25519_sc_reduce(hram[i]);
+        memcpy(sig, R_and_A[i], 32);
+        CCryptoBoringSSLShims_ed25519_sc_muladd(sig + 32, hram[i], expanded[i], nonce[i]);
+    }
+
+    CCryptoBoringSSL_OPENSSL_cleanse(expanded, sizeof(expanded));
+    CCryptoBoringSSL_OPENSSL_cleanse(nonce, sizeof(nonce));
+    CCryptoBoringSSL_OPENSSL_cleanse(R, sizeof(R));
+}
+
+void CCryptoBoringSSLShims_ED25519_sign_batch(void *out_signatures, const CCryptoBoringSSLShims_ED25519_sign_batch_op *ops,
+                                              size_t ops_count) {
+    uint8_t *out = out_signatures;
+    size_t message_bytes = 0;
+    for (size_t i = 0; i < ops_count; i++) {
+        message_bytes += ops[i].message_len;
+    }
+    CCRYPTOBORINGSSLSHIMS_TRACE_ENTRY(ed25519_sign, NID_ED25519, 256, message_bytes);
+    for (size_t i = 0; i < ops_count; i += CCRYPTOBORINGSSLSHIMS_ED25519_SIGN_CHUNK) {
+        const size_t n = ops_count - i < CCRYPTOBORINGSSLSHIMS_ED25519_SIGN_CHUNK ? ops_count - i
+                                                                                  : CCRYPTOBORINGSSLSHIMS_ED25519_SIGN_CHUNK;
+        CCryptoBoringSSLShims_ed25519_sign_chunk(out + 64 * i, ops + i, n);
+    }
+    CCRYPTOBORINGSSLSHIMS_TRACE_RETURN(ed25519_sign, NID_ED25519, 256, message_bytes, 1);
+}
+
+// MARK:- Compressed points
+
+// Decodes a compressed point, recovering y from y² = x³ + ax + b with fixed-width
+// field arithmetic instead of |BN_mod_sqrt|. Every curve we support has
+// p ≡ 3 (mod 4), so the square root is a single exponentiation by (p + 1) / 4.
+static int CCryptoBoringSSLShims_ec_point_from_compressed(const EC_GROUP *group, EC_AFFINE *out,
+                                                          const uint8_t *in, size_t len) {
+    const BIGNUM *p = &group->field.N;
+    const size_t field_len = CCryptoBoringSSL_BN_num_bytes(p);
+    if (len != 1 + field_len || (in[0] != 0x02 && in[0] != 0x03) || (p->d[0] & 3) != 3) {
+        return 0;
+    }
+
+    EC_FELEM x, rhs, y, check;
+    if (!CCryptoBoringSSL_ec_felem_from_bytes(group, &x, in + 1, field_len)) {
+        return 0;
+    }
+    group->meth->felem_sqr(group, &rhs, &x);
+    CCryptoBoringSSL_ec_felem_add(group, &rhs, &rhs, &group->a);
+    group->meth->felem_mul(group, &rhs, &rhs, &x);
+    CCryptoBoringSSL_ec_felem_add(group, &rhs, &rhs, &group->b);
+
+    // (p + 1) / 4. p is odd and not all ones, so adding one can't carry out of
+    // its width.
+    BN_ULONG exponent[EC_MAX_WORDS];
+    BN_ULONG carry = 1;
+    for (int i = 0; i < p->width; i++) {
+        exponent[i] = p->d[i] + carry;
+        carry = exponent[i] < carry;
+    }
+    for (int i = 0; i < p->width; i++) {
+        BN_ULONG high = i + 1 < p->width ? exponent[i + 1] : 0;
+        exponent[i] = (exponent[i] >> 2) | (high << (BN_BITS2 - 2));
+    }
+    group->meth->felem_exp(group, &y, &rhs, exponent, p->width);
+
+    // x is not on the curve if x³ + ax + b is not a square.
+    group->meth->felem_sqr(group, &check, &y);
+    if (!CCryptoBoringSSL_ec_felem_equal(group, &check, &rhs)) {
+        return 0;
+    }
+
+    uint8_t y_bytes[EC_MAX_BYTES];
+    size_t y_len;
+    CCryptoBoringSSL_ec_felem_to_bytes(group, y_bytes, &y_len, &y);
+    if ((y_bytes[y_len - 1] & 1) != (in[0] & 1)) {
+        // There is no odd y when y is zero.
+        if (CCryptoBoringSSL_ec_felem_non_zero_mask(group, &y) == 0) {
+            return 0;
+        }
+        CCryptoBoringSSL_ec_felem_neg(group, &y, &y);
+    }
+
+    out->X = x;
+    out->Y = y;
+    return 1;
+}
+
+int CCryptoBoringSSLShims_EC_KEY_set_public_key_compressed(EC_KEY *key, const void *in, size_t in_len) {
+    const EC_GROUP *group = CCryptoBoringSSL_EC_KEY_get0_group(key);
+    EC_AFFINE affine;
+    if (group == NULL || !CCryptoBoringSSLShims_ec_point_from_compressed(group, &affine, in, in_len)) {
+        return 0;
+    }
+
+    EC_POINT *point = CCryptoBoringSSL_EC_POINT_new(group);
+    if (point == NULL) {
+        return 0;
+    }
+    CCryptoBoringSSL_ec_affine_to_jacobian(group, &point->raw, &affine);
+    int ok = CCryptoBoringSSL_EC_KEY_set_public_key(key, point);
+    CCryptoBoringSSL_EC_POINT_free(point);
+    return ok;
+}
+
+int CCryptoBoringSSLShims_EC_KEY_set_public_key_compact(EC_KEY *key, const void *in, size_t in_len) {
+    const EC_GROUP *group = CCryptoBoringSSL_EC_KEY_get0_group(key);
+    uint8_t compressed[EC_MAX_COMPRESSED];
+    EC_AFFINE affine;
+    if (group == NULL || in_len > EC_MAX_BYTES) {
+        return 0;
+    }
+    compressed[0] = 0x02;
+    memcpy(compressed + 1, in, in_len);
+    if (!CCryptoBoringSSLShims_ec_point_from_compressed(group, &affine, compressed, 1 + in_len)) {
+        return 0;
+    }
+
+    // The compact representation always uses the smaller of y and p - y. The
+    // key is public, so this needn't be constant-time.
+    EC_FELEM negated_y;
+    uint8_t y_bytes[EC_MAX_BYTES], negated_y_bytes[EC_MAX_BYTES];
+    size_t y_len, negated_y_len;
+    CCryptoBoringSSL_ec_felem_neg(group, &negated_y, &affine.Y);
+    CCryptoBoringSSL_ec_felem_to_bytes(group, y_bytes, &y_len, &affine.Y);
+    CCryptoBoringSSL_ec_felem_to_bytes(group, negated_y_bytes, &negated_y_len, &negated_y);
+    if (memcmp(negated_y_bytes, y_bytes, y_len) < 0) {
+        affine.Y = negated_y;
+    }
+
+    EC_POINT *point = CCryptoBoringSSL_EC_POINT_new(group);
+    if (point == NULL) {
+        return 0;
+    }
+    CCryptoBoringSSL_ec_affine_to_jacobian(group, &point->raw, &affine);
+    int ok = CCryptoBoringSSL_EC_KEY_set_public_key(key, point);
+    CCryptoBoringSSL_EC_POINT_free(point);
+    return ok;
+}
+
+size_t CCryptoBoringSSLShims_EC_points_decompress(int curve_nid, void *out, const void *in, size_t count) {
+    const EC_GROUP *group = CCryptoBoringSSL_EC_GROUP_new_by_curve_name(curve_nid);
+    if (group == NULL) {
+        return 0;
+    }
+
+    const size_t field_len = CCryptoBoringSSL_BN_num_bytes(&group->field.N);
+    const uint8_t *compressed = in;
+    uint8_t *uncompressed = out;
+    for (size_t i = 0; i < count; i++) {
+        EC_AFFINE affine;
+        if (!CCryptoBoringSSLShims_ec_point_from_compressed(group, &affine, compressed, 1 + field_len) ||
+            CCryptoBoringSSL_ec_point_to_bytes(group, &affine, POINT_CONVERSION_UNCOMPRESSED, uncompressed,
+                                               1 + 2 * field_len) != 1 + 2 * field_len) {
+            return i;
+        }
+        compressed += 1 + field_len;
+        uncompressed += 1 + 2 * field_len;
+    }
+    return count;
+}
+
+// MARK:- Hash to curve
+
+// RFC 9380 hashing to P-256 (P256_XMD:SHA-256_SSWU_RO_) and P-384
+// (P384_XMD:SHA-384_SSWU_RO_). This follows crypto/ec_extra/hash_to_curve.c
+// step for step, but the square root in sqrt_ratio raises to (p - 3) / 4 with a
+// fixed addition chain for each prime rather than the generic |felem_exp|, and
+// a batch of outputs shares one field inversion to reach affine coordinates.
+
+typedef void (*CCryptoBoringSSLShims_ec_felem_mul_func)(const EC_GROUP *group, EC_FELEM *r, const EC_FELEM *a,
+                                                        const EC_FELEM *b);
+typedef void (*CCryptoBoringSSLShims_ec_felem_sqr_func)(const EC_GROUP *group, EC_FELEM *r, const EC_FELEM *a);
+
+#if !defined(OPENSSL_NO_ASM) && (defined(OPENSSL_X86_64) || defined(OPENSSL_AARCH64)) && \
+    !defined(OPENSSL_SMALL)
+// Declared in p256-nistz.h, under the same conditions. The nistz256 method
+// keeps field elements in the same Montgomery form as these, but its
+// |felem_mul| and |felem_sqr| are the generic ones.
+void CCryptoBoringSSL_ecp_nistz256_mul_mont(BN_ULONG res[4], const BN_ULONG a[4], const BN_ULONG b[4]);
+void CCryptoBoringSSL_ecp_nistz256_sqr_mont(BN_ULONG res[4], const BN_ULONG a[4]);
+
+static void CCryptoBoringSSLShims_nistz256_felem_mul(const EC_GROUP *group, EC_FELEM *r, const EC_FELEM *a,
+                                                     const EC_FELEM *b) {
+    (void)group;
+    CCryptoBoringSSL_ecp_nistz256_mul_mont(r->words, a->words, b->words);
+}
+
+static void CCryptoBoringSSLShims_nistz256_felem_sqr(const EC_GROUP *group, EC_FELEM *r, const EC_FELEM *a) {
+    (void)group;
+    CCryptoBoringSSL_ecp_nistz256_sqr_mont(r->words, a->words);
+}
+#endif
+
+// Sets |*out_mul| and |*out_sqr| to the fastest field multiplication and
+// squaring for |group|, which are the method's own except for nistz256.
+static void CCryptoBoringSSLShims_ec_felem_mul_sqr(const EC_GROUP *group, CCryptoBoringSSLShims_ec_felem_mul_func *out_mul,
+                                                   CCryptoBoringSSLShims_ec_felem_sqr_func *out_sqr) {
+    *out_mul = group->meth->felem_mul;
+    *out_sqr = group->meth->felem_sqr;
+#if !defined(OPENSSL_NO_ASM) && (defined(OPENSSL_X86_64) || defined(OPENSSL_AARCH64)) && \
+    !defined(OPENSSL_SMALL)
+    if (group->meth == CCryptoBoringSSL_EC_GFp_nistz256_method()) {
+        *out_mul = CCryptoBoringSSLShims_nistz256_felem_mul;
+        *out_sqr = CCryptoBoringSSLShims_nistz256_felem_sqr;
+    }
+#endif
+}
+
+typedef struct CCryptoBoringSSLShims_h2c_suite_st {
+    const EC_GROUP *group;
+    // From |CCryptoBoringSSLShims_ec_felem_mul_sqr|.
+    CCryptoBoringSSLShims_ec_felem_mul_func felem_mul;
+    CCryptoBoringSSLShims_ec_felem_sqr_func felem_sqr;
+    const EVP_MD *md;
+    // The security parameter k, in bits.
+    unsigned k;
+    EC_FELEM Z;
+    // sqrt(-Z).
+    EC_FELEM c2;
+    // Sets |out| to |in|^((p - 3) / 4).
+    void (*exp_c1)(const struct CCryptoBoringSSLShims_h2c_suite_st *suite, EC_FELEM *out, const EC_FELEM *in);
+} CCryptoBoringSSLShims_h2c_suite;
+
+static void CCryptoBoringSSLShims_h2c_sqr_n(const CCryptoBoringSSLShims_h2c_suite *suite, EC_FELEM *out,
+                                            const EC_FELEM *in, int n) {
+    *out = *in;
+    for (int i = 0; i < n; i++) {
+        suite->felem_sqr(suite->group, out, out);
+    }
+}
+
+// (p - 3) / 4 for P-256 is 2^254 - 2^222 + 2^190 + 2^94 - 1: from the top, 32
+// ones, 31 zeros, a one, 96 zeros and 94 ones. This takes 253 squarings and 12
+// multiplications.
+static void CCryptoBoringSSLShims_h2c_p256_exp_c1(const CCryptoBoringSSLShims_h2c_suite *suite, EC_FELEM *out,
+                                                  const EC_FELEM *in) {
+    const EC_GROUP *group = suite->group;
+    const CCryptoBoringSSLShims_ec_felem_mul_func felem_mul = suite->felem_mul;
+    // xN = in^(2^N - 1), N ones.
+    EC_FELEM x2, x4, x8, x16, x32, t;
+    suite->felem_sqr(group, &x2, in);
+    felem_mul(group, &x2, &x2, in);
+    CCryptoBoringSSLShims_h2c_sqr_n(suite, &x4, &x2, 2);
+    felem_mul(group, &x4, &x4, &x2);
+    CCryptoBoringSSLShims_h2c_sqr_n(suite, &x8, &x4, 4);
+    felem_mul(group, &x8, &x8, &x4);
+    CCryptoBoringSSLShims_h2c_sqr_n(suite, &x16, &x8, 8);
+    felem_mul(group, &x16, &x16, &x8);
+    CCryptoBoringSSLShims_h2c_sqr_n(suite, &x32, &x16, 16);
+    felem_mul(group, &x32, &x32, &x16);
+
+    CCryptoBoringSSLShims_h2c_sqr_n(suite, &t, &x32, 32);
+    felem_mul(group, &t, &t, in);
+    // The trailing 94 ones, as 32 + 32 + 16 + 8 + 4 + 2.
+    CCryptoBoringSSLShims_h2c_sqr_n(suite, &t, &t, 96 + 32);
+    felem_mul(group, &t, &t, &x32);
+    CCryptoBoringSSLShims_h2c_sqr_n(suite, &t, &t, 32);
+    felem_mul(group, &t, &t, &x32);
+    CCryptoBoringSSLShims_h2c_sqr_n(suite, &t, &t, 16);
+    felem_mul(group, &t, &t, &x16);
+    CCryptoBoringSSLShims_h2c_sqr_n(suite, &t, &t, 8);
+    felem_mul(group, &t, &t, &x8);
+    CCryptoBoringSSLShims_h2c_sqr_n(suite, &t, &t, 4);
+    felem_mul(group, &t, &t, &x4);
+    CCryptoBoringSSLShims_h2c_sqr_n(suite, &t, &t, 2);
+    felem_mul(group, out, &t, &x2);
+}
+
+// (p - 3) / 4 for P-384 is 2^382 - 2^126 - 2^94 + 2^30 - 1: from the top, 255
+// ones, a zero, 32 ones, 64 zeros and 30 ones. This takes 383 squarings and 13
+// multiplications.
+static void CCryptoBoringSSLShims_h2c_p384_exp_c1(const CCryptoBoringSSLShims_h2c_suite *suite, EC_FELEM *out,
+                                                  const EC_FELEM *in) {
+    const EC_GROUP *group = suite->group;
+    const CCryptoBoringSSLShims_ec_felem_mul_func felem_mul = suite->felem_mul;
+    // xN = in^(2^N - 1), N ones.
+    EC_FELEM x2, x3, x6, x12, x15, x30, x32, x60, x120, t;
+    suite->felem_sqr(group, &x2, in);
+    felem_mul(group, &x2, &x2, in);
+    suite->felem_sqr(group, &x3, &x2);
+    felem_mul(group, &x3, &x3, in);
+    CCryptoBoringSSLShims_h2c_sqr_n(suite, &x6, &x3, 3);
+    felem_mul(group, &x6, &x6, &x3);
+    CCryptoBoringSSLShims_h2c_sqr_n(suite, &x12, &x6, 6);
+    felem_mul(group, &x12, &x12, &x6);
+    CCryptoBoringSSLShims_h2c_sqr_n(suite, &x15, &x12, 3);
+    felem_mul(group, &x15, &x15, &x3);
+    CCryptoBoringSSLShims_h2c_sqr_n(suite, &x30, &x15, 15);
+    felem_mul(group, &x30, &x30, &x15);
+    CCryptoBoringSSLShims_h2c_sqr_n(suite, &x32, &x30, 2);
+    felem_mul(group, &x32, &x32, &x2);
+    CCryptoBoringSSLShims_h2c_sqr_n(suite, &x60, &x30, 30);
+    felem_mul(group, &x60, &x60, &x30);
+    CCryptoBoringSSLShims_h2c_sqr_n(suite, &x120, &x60, 60);
+    felem_mul(group, &x120, &x120, &x60);
+
+    // 255 ones, as 120 + 120 + 15.
+    CCryptoBoringSSLShims_h2c_sqr_n(suite, &t, &x120, 120);
+    felem_mul(group, &t, &t, &x120);
+    CCryptoBoringSSLShims_h2c_sqr_n(suite, &t, &t, 15);
+    felem_mul(group, &t, &t, &x15);
+    CCryptoBoringSSLShims_h2c_sqr_n(suite, &t, &t, 1 + 32);
+    felem_mul(group, &t, &t, &x32);
+    CCryptoBoringSSLShims_h2c_sqr_n(suite, &t, &t, 64 + 30);
+    felem_mul(group, out, &t, &x30);
+}
+
+// sqrt(10) in P-256's field and sqrt(12) in P-384's, as in hash_to_curve.c.
+static const uint8_t CCryptoBoringSSLShims_h2c_p256_sqrt10[32] = {
+    0xda, 0x53, 0x8e, 0x3b, 0xe1, 0xd8, 0x9b, 0x99, 0xc9, 0x78, 0xfc,
+    0x67, 0x51, 0x80, 0xaa, 0xb2, 0x7b, 0x8d, 0x1f, 0xf8, 0x4c, 0x55,
+    0xd5, 0xb6, 0x2c, 0xcd, 0x34, 0x27, 0xe4, 0x33, 0xc4, 0x7f};
+static const uint8_t CCryptoBoringSSLShims_h2c_p384_sqrt12[48] = {
+    0x2a, 0xcc, 0xb4, 0xa6, 0x56, 0xb0, 0x24, 0x9c, 0x71, 0xf0, 0x50, 0x0e,
+    0x83, 0xda, 0x2f, 0xdd, 0x7f, 0x98, 0xe3, 0x83, 0xd6, 0x8b, 0x53, 0x87,
+    0x1f, 0x87, 0x2f, 0xcb, 0x9c, 0xcb, 0x80, 0xc5, 0x3c, 0x0d, 0xe1, 0xf8,
+    0xa8, 0x0f, 0x7e, 0x19, 0x14, 0xe2, 0xec, 0x69, 0xf5, 0xa6, 0x26, 0xb3};
+
+static int CCryptoBoringSSLShims_h2c_suite_init(CCryptoBoringSSLShims_h2c_suite *suite, int curve_nid) {
+    uint8_t minus_z[EC_MAX_BYTES] = {0};
+    const uint8_t *c2;
+    switch (curve_nid) {
+    case NID_X9_62_prime256v1:
+        suite->group = CCryptoBoringSSL_EC_group_p256();
+        suite->md = CCryptoBoringSSL_EVP_sha256();
+        suite->k = 128;
+        suite->exp_c1 = CCryptoBoringSSLShims_h2c_p256_exp_c1;
+        c2 = CCryptoBoringSSLShims_h2c_p256_sqrt10;
+        minus_z[31] = 10;
+        break;
+    case NID_secp384r1:
+        suite->group = CCryptoBoringSSL_EC_group_p384();
+        suite->md = CCryptoBoringSSL_EVP_sha384();
+        suite->k = 192;
+        suite->exp_c1 = CCryptoBoringSSLShims_h2c_p384_exp_c1;
+        c2 = CCryptoBoringSSLShims_h2c_p384_sqrt12;
+        minus_z[47] = 12;
+        break;
+    default:
+        return 0;
+    }
+
+    CCryptoBoringSSLShims_ec_felem_mul_sqr(suite->group, &suite->felem_mul, &suite->felem_sqr);
+
+    const size_t field_len = CCryptoBoringSSL_BN_num_bytes(&suite->group->field.N);
+    if (!CCryptoBoringSSL_ec_felem_from_bytes(suite->group, &suite->Z, minus_z, field_len) ||
+        !CCryptoBoringSSL_ec_felem_from_bytes(suite->group, &suite->c2, c2, field_len)) {
+        return 0;
+    }
+    CCryptoBoringSSL_ec_felem_neg(suite->group, &suite->Z, &suite->Z);
+    return 1;
+}
+
+// expand_message_xmd from section 5.3.1 of RFC 9380, for at most 255 hash
+// blocks of output.
+static int CCryptoBoringSSLShims_h2c_expand_message_xmd(const EVP_MD *md, uint8_t *out, size_t out_len,
+                                                        const uint8_t *msg, size_t msg_len, const uint8_t *dst,
+                                                        size_t dst_len) {
+    if (dst_len == 0) {
+        return 0;
+    }
+
+    int ret = 0;
+    const size_t block_size = CCryptoBoringSSL_EVP_MD_block_size(md);
+    const size_t md_size = CCryptoBoringSSL_EVP_MD_size(md);
+    EVP_MD_CTX ctx;
+    CCryptoBoringSSL_EVP_MD_CTX_init(&ctx);
+
+    // Long DSTs are hashed down to size. See section 5.3.3.
+    uint8_t dst_buf[EVP_MAX_MD_SIZE];
+    if (dst_len >= 256) {
+        static const char kPrefix[] = "H2C-OVERSIZE-DST-";
+        if (!CCryptoBoringSSL_EVP_DigestInit_ex(&ctx, md, NULL) ||
+            !CCryptoBoringSSL_EVP_DigestUpdate(&ctx, kPrefix, sizeof(kPrefix) - 1) ||
+            !CCryptoBoringSSL_EVP_DigestUpdate(&ctx, dst, dst_len) ||
+            !CCryptoBoringSSL_EVP_DigestFinal_ex(&ctx, dst_buf, NULL)) {
+            goto err;
+        }
+        dst = dst_buf;
+        dst_len = md_size;
+    }
+    const uint8_t dst_len_u8 = (uint8_t)dst_len;
+
+    static const uint8_t kZeros[EVP_MAX_MD_BLOCK_SIZE] = {0};
+    const uint8_t l_i_b_str_zero[3] = {(uint8_t)(out_len >> 8), (uint8_t)out_len, 0};
+    uint8_t b_0[EVP_MAX_MD_SIZE];
+    if (!CCryptoBoringSSL_EVP_DigestInit_ex(&ctx, md, NULL) ||
+        !CCryptoBoringSSL_EVP_DigestUpdate(&ctx, kZeros, block_size) ||
+        !CCryptoBoringSSL_EVP_DigestUpdate(&ctx, msg, msg_len) ||
+        !CCryptoBoringSSL_EVP_DigestUpdate(&ctx, l_i_b_str_zero, sizeof(l_i_b_str_zero)) ||
+        !CCryptoBoringSSL_EVP_DigestUpdate(&ctx, dst, dst_len) ||
+        !CCryptoBoringSSL_EVP_DigestUpdate(&ctx, &dst_len_u8, 1) ||
+        !CCryptoBoringSSL_EVP_DigestFinal_ex(&ctx, b_0, NULL)) {
+        goto err;
+    }
+
+    uint8_t b_i[EVP_MAX_MD_SIZE];
+    for (uint8_t i = 1; out_len > 0; i++) {
+        if (i == 0) {
+            goto err;
+        }
+        for (size_t j = 0; j < md_size; j++) {
+            b_i[j] = i > 1 ? b_i[j] ^ b_0[j] : b_0[j];
+        }
+        if (!CCryptoBoringSSL_EVP_DigestInit_ex(&ctx, md, NULL) ||
+            !CCryptoBoringSSL_EVP_DigestUpdate(&ctx, b_i, md_size) ||
+            !CCryptoBoringSSL_EVP_DigestUpdate(&ctx, &i, 1) ||
+            !CCryptoBoringSSL_EVP_DigestUpdate(&ctx, dst, dst_len) ||
+            !CCryptoBoringSSL_EVP_DigestUpdate(&ctx, &dst_len_u8, 1) ||
+            !CCryptoBoringSSL_EVP_DigestFinal_ex(&ctx, b_i, NULL)) {
+            goto err;
+        }
+        const size_t todo = out_len >= md_size ? md_size : out_len;
+        memcpy(out, b_i, todo);
+        out += todo;
+        out_len -= todo;
+    }
+    ret = 1;
+
+err:
+    CCryptoBoringSSL_EVP_MD_CTX_cleanup(&ctx);
+    return ret;
+}
+
+// hash_to_field from section 5.2 of RFC 9380, with count = 2.
+static int CCryptoBoringSSLShims_h2c_hash_to_field2(const CCryptoBoringSSLShims_h2c_suite *suite, EC_FELEM *out1,
+                                                    EC_FELEM *out2, const uint8_t *dst, size_t dst_len,
+                                                    const uint8_t *msg, size_t msg_len) {
+    const EC_GROUP *group = suite->group;
+    const size_t L = (CCryptoBoringSSL_BN_num_bits(&group->field.N) + suite->k + 7) / 8;
+    uint8_t buf[4 * EC_MAX_BYTES];
+    if (!CCryptoBoringSSLShims_h2c_expand_message_xmd(suite->md, buf, 2 * L, msg, msg_len, dst, dst_len)) {
+        return 0;
+    }
+
+    BN_ULONG words[2 * EC_MAX_WORDS];
+    const size_t num_words = 2 * group->field.N.width;
+    EC_FELEM *outs[2] = {out1, out2};
+    for (int n = 0; n < 2; n++) {
+        // Decode the big-endian L bytes into little-endian words.
+        memset(words, 0, sizeof(words));
+        uint8_t *words_u8 = (uint8_t *)words;
+        for (size_t i = 0; i < L; i++) {
+            words_u8[L - 1 - i] = buf[n * L + i];
+        }
+        group->meth->felem_reduce(group, outs[n], words, num_words);
+    }
+    return 1;
+}
+
+// Sets |out| to -3 * |in|. Both curves have A = -3.
+static void CCryptoBoringSSLShims_h2c_mul_A(const EC_GROUP *group, EC_FELEM *out, const EC_FELEM *in) {
+    EC_FELEM tmp;
+    CCryptoBoringSSL_ec_felem_add(group, &tmp, in, in);
+    CCryptoBoringSSL_ec_felem_add(group, &tmp, &tmp, &tmp);
+    CCryptoBoringSSL_ec_felem_sub(group, out, in, &tmp);
+}
+
+static BN_ULONG CCryptoBoringSSLShims_h2c_sgn0(const EC_GROUP *group, const EC_FELEM *a) {
+    uint8_t buf[EC_MAX_BYTES];
+    size_t len;
+    CCryptoBoringSSL_ec_felem_to_bytes(group, buf, &len, a);
+    return buf[len - 1] & 1;
+}
+
+// sqrt_ratio from appendix F.2.1.2 of RFC 9380, for p = 3 (mod 4).
+static BN_ULONG CCryptoBoringSSLShims_h2c_sqrt_ratio(const CCryptoBoringSSLShims_h2c_suite *suite, EC_FELEM *out_y,
+                                                     const EC_FELEM *u, const EC_FELEM *v) {
+    const EC_GROUP *group = suite->group;
+    EC_FELEM tv1, tv2, tv3, y1, y2;
+    suite->felem_sqr(group, &tv1, v);                     // 1. tv1 = v^2
+    suite->felem_mul(group, &tv2, u, v);                  // 2. tv2 = u * v
+    suite->felem_mul(group, &tv1, &tv1, &tv2);            // 3. tv1 = tv1 * tv2
+    suite->exp_c1(suite, &y1, &tv1);                      // 4. y1 = tv1^c1
+    suite->felem_mul(group, &y1, &y1, &tv2);              // 5. y1 = y1 * tv2
+    suite->felem_mul(group, &y2, &y1, &suite->c2);        // 6. y2 = y1 * c2
+    suite->felem_sqr(group, &tv3, &y1);                   // 7. tv3 = y1^2
+    suite->felem_mul(group, &tv3, &tv3, v);               // 8. tv3 = tv3 * v
+
+    // 9. isQR = tv3 == u; 10. y = CMOV(y2, y1, isQR)
+    CCryptoBoringSSL_ec_felem_sub(group, &tv1, &tv3, u);
+    const BN_ULONG is_qr = ~CCryptoBoringSSL_ec_felem_non_zero_mask(group, &tv1);
+    CCryptoBoringSSL_ec_felem_select(group, out_y, is_qr, &y1, &y2);
+    return is_qr;
+}
+
+// map_to_curve_simple_swu from section 6.6.2 of RFC 9380, using the
+// straight-line implementation in appendix F.2. The output is (x * tv4, y *
+// tv4^3, tv4) rather than (x / tv4, y), to avoid an inversion.
+static void CCryptoBoringSSLShims_h2c_map_to_curve(const CCryptoBoringSSLShims_h2c_suite *suite, EC_JACOBIAN *out,
+                                                   const EC_FELEM *u) {
+    const EC_GROUP *group = suite->group;
+    const CCryptoBoringSSLShims_ec_felem_mul_func felem_mul = suite->felem_mul;
+    const CCryptoBoringSSLShims_ec_felem_sqr_func felem_sqr = suite->felem_sqr;
+
+    EC_FELEM tv1, tv2, tv3, tv4, tv5, tv6, x, y, y1;
+    felem_sqr(group, &tv1, u);                                                 // 1. tv1 = u^2
+    felem_mul(group, &tv1, &suite->Z, &tv1);                                   // 2. tv1 = Z * tv1
+    felem_sqr(group, &tv2, &tv1);                                              // 3. tv2 = tv1^2
+    CCryptoBoringSSL_ec_felem_add(group, &tv2, &tv2, &tv1);                    // 4. tv2 = tv2 + tv1
+    CCryptoBoringSSL_ec_felem_add(group, &tv3, &tv2, CCryptoBoringSSL_ec_felem_one(group));  // 5. tv3 = tv2 + 1
+    felem_mul(group, &tv3, &group->b, &tv3);                                   // 6. tv3 = B * tv3
+
+    // 7. tv4 = CMOV(Z, -tv2, tv2 != 0)
+    const BN_ULONG tv2_non_zero = CCryptoBoringSSL_ec_felem_non_zero_mask(group, &tv2);
+    CCryptoBoringSSL_ec_felem_neg(group, &tv4, &tv2);
+    CCryptoBoringSSL_ec_felem_select(group, &tv4, tv2_non_zero, &tv4, &suite->Z);
+
+    CCryptoBoringSSLShims_h2c_mul_A(group, &tv4, &tv4);      // 8. tv4 = A * tv4
+    felem_sqr(group, &tv2, &tv3);                            // 9. tv2 = tv3^2
+    felem_sqr(group, &tv6, &tv4);                            // 10. tv6 = tv4^2
+    CCryptoBoringSSLShims_h2c_mul_A(group, &tv5, &tv6);      // 11. tv5 = A * tv6
+    CCryptoBoringSSL_ec_felem_add(group, &tv2, &tv2, &tv5);  // 12. tv2 = tv2 + tv5
+    felem_mul(group, &tv2, &tv2, &tv3);                      // 13. tv2 = tv2 * tv3
+    felem_mul(group, &tv6, &tv6, &tv4);                      // 14. tv6 = tv6 * tv4
+    felem_mul(group, &tv5, &group->b, &tv6);                 // 15. tv5 = B * tv6
+    CCryptoBoringSSL_ec_felem_add(group, &tv2, &tv2, &tv5);  // 16. tv2 = tv2 + tv5
+    felem_mul(group, &x, &tv1, &tv3);                        // 17. x = tv1 * tv3
+
+    // 18. (is_gx1_square, y1) = sqrt_ratio(tv2, tv6)
+    const BN_ULONG is_gx1_square = CCryptoBoringSSLShims_h2c_sqrt_ratio(suite, &y1, &tv2, &tv6);
+
+    felem_mul(group, &y, &tv1, u);   // 19. y = tv1 * u
+    felem_mul(group, &y, &y, &y1);   // 20. y = y * y1
+    CCryptoBoringSSL_ec_felem_select(group, &x, is_gx1_square, &tv3, &x);  // 21. x = CMOV(x, tv3, is_gx1_square)
+    CCryptoBoringSSL_ec_felem_select(group, &y, is_gx1_square, &y1, &y);   // 22. y = CMOV(y, y1, is_gx1_square)
+
+    // 23. e1 = sgn0(u) == sgn0(y); 24. y = CMOV(-y, y, e1)
+    const BN_ULONG not_e1 = ((BN_ULONG)0) - (CCryptoBoringSSLShims_h2c_sgn0(group, u) ^
+                                             CCryptoBoringSSLShims_h2c_sgn0(group, &y));
+    CCryptoBoringSSL_ec_felem_neg(group, &tv1, &y);
+    CCryptoBoringSSL_ec_felem_select(group, &y, not_e1, &tv1, &y);
+
+    // 25. x = x / tv4
+    felem_mul(group, &out->X, &x, &tv4);
+    felem_mul(group, &out->Y, &y, &tv6);
+    out->Z = tv4;
+}
+
+static int CCryptoBoringSSLShims_h2c_hash_to_curve(const CCryptoBoringSSLShims_h2c_suite *suite, EC_JACOBIAN *out,
+                                                   const uint8_t *dst, size_t dst_len, const uint8_t *msg,
+                                                   size_t msg_len) {
+    EC_FELEM u0, u1;
+    EC_JACOBIAN Q0, Q1;
+    if (!CCryptoBoringSSLShims_h2c_hash_to_field2(suite, &u0, &u1, dst, dst_len, msg, msg_len)) {
+        return 0;
+    }
+    CCryptoBoringSSLShims_h2c_map_to_curve(suite, &Q0, &u0);
+    CCryptoBoringSSLShims_h2c_map_to_curve(suite, &Q1, &u1);
+    // Both curves have cofactor one, so there is no cofactor to clear.
+    suite->group->meth->add(suite->group, out, &Q0, &Q1);
+    return 1;
+}
+
+// The batch converts this many points to affine coordinates at once.
+#define CCryptoBoringSSLShims_H2C_BATCH 32
+
+size_t CCryptoBoringSSLShims_EC_hash_to_curve_batch(int curve_nid, void *out, const void *dst, size_t dst_len,
+                                                    const uint8_t *const *msgs, const size_t *msg_lens,
+                                                    size_t count) {
+    CCryptoBoringSSLShims_h2c_suite suite;
+    if (!CCryptoBoringSSLShims_h2c_suite_init(&suite, curve_nid)) {
+        return 0;
+    }
+    const EC_GROUP *group = suite.group;
+    const size_t point_len = 1 + 2 * CCryptoBoringSSL_BN_num_bytes(&group->field.N);
+
+    EC_JACOBIAN jacobian[CCryptoBoringSSLShims_H2C_BATCH];
+    EC_AFFINE affine[CCryptoBoringSSLShims_H2C_BATCH];
+    uint8_t *out_u8 = out;
+    for (size_t done = 0; done < count;) {
+        const size_t todo =
+            count - done < CCryptoBoringSSLShims_H2C_BATCH ? count - done : CCryptoBoringSSLShims_H2C_BATCH;
+        for (size_t i = 0; i < todo; i++) {
+            if (!CCryptoBoringSSLShims_h2c_hash_to_curve(&suite, &jacobian[i], dst, dst_len, msgs[done + i],
+                                                         msg_lens[done + i])) {
+                return done;
+            }
+        }
+
+        // P-384 uses the generic Montgomery method, so the P-256 batch
+        // conversion applies to both curves. A lone point is better served by
+        // the method's own inversion, which for P-256 is specialised. The
+        // batch fails if any point is the identity, which happens with
+        // negligible probability; then convert one at a time to find it.
+        if (todo == 1 || !CCryptoBoringSSLShims_p256_jacobian_to_affine_batch(group, affine, jacobian, todo)) {
+            for (size_t i = 0; i < todo; i++) {
+                if (!group->meth->point_get_affine_coordinates(group, &jacobian[i], &affine[i].X, &affine[i].Y)) {
+                    return done + i;
+                }
+            }
+        }
+        for (size_t i = 0; i < todo; i++) {
+            if (CCryptoBoringSSL_ec_point_to_bytes(group, &affine[i], POINT_CONVERSION_UNCOMPRESSED, out_u8,
+                                                   point_len) != point_len) {
+                return done + i;
+            }
+            out_u8 += point_len;
+        }
+        done += todo;
+    }
+    return count;
+}
+
+int CCryptoBoringSSLShims_EC_hash_to_curve(int curve_nid, void *out, const void *dst, size_t dst_len,
+                                           const void *msg, size_t msg_len) {
+    const uint8_t *msgs[1] = {msg};
+    return CCryptoBoringSSLShims_EC_hash_to_curve_batch(curve_nid, out, dst, dst_len, msgs, &msg_len, 1) == 1;
+}
+
+// MARK:- Multi-scalar multiplication
+
+// Computes the sum of scalars[i] * points[i] with Pippenger's bucket method, in
+// variable time. Each scalar is recoded into signed c-bit digits. For each
+// window, every point goes into the bucket for the magnitude of its digit,
+// negated if the digit is negative, and the buckets are then combined as
+// sum(k * bucket[k]) with two additions each.
+//
+// Buckets are summed in affine coordinates. Each round adds at most one
+// pending point to each bucket, and all the additions of a round share one
+// field inversion, which makes one about six multiplications. A point whose x
+// matches its bucket's, and whatever is left once rounds get small, goes into
+// a Jacobian accumulator for the bucket instead.
+//
+// Windows are independent, so they are dealt out over threads.
+
+#if !defined(_WIN32) && !defined(OPENSSL_NO_THREADS_CORRUPT_MEMORY_AND_LEAK_SECRETS_IF_THREADED)
+#define CCRYPTOBORINGSSLSHIMS_PARALLEL_MSM 1
+#include <pthread.h>
+#endif
+
+#define CCryptoBoringSSLShims_MSM_MAX_WINDOW_BITS 14
+#define CCryptoBoringSSLShims_MSM_MAX_THREADS 64
+// Once a round would add fewer points than this, the rest of the window goes to
+// the Jacobian accumulators. Below it, the shared inversion costs more than
+// the Jacobian additions would.
+#define CCryptoBoringSSLShims_MSM_MIN_ROUND 64
+
+typedef struct {
+    const EC_GROUP *group;
+    // The hash-to-curve parameters of the curve, for the field arithmetic.
+    const CCryptoBoringSSLShims_h2c_suite *field;
+    const EC_AFFINE *points;
+    // |num_windows| digits for each point, window by window.
+    const int16_t *digits;
+    size_t count;
+    int window_bits;
+    size_t num_windows;
+    EC_JACOBIAN *window_sums;
+    size_t worker;
+    size_t workers;
+    int ok;
+} CCryptoBoringSSLShims_msm_worker;
+
+// Picks the window that minimises the estimated cost: an affine addition per
+// point and two Jacobian additions, about 32 multiplications, per bucket.
+static int CCryptoBoringSSLShims_msm_window_bits(size_t count, size_t bits) {
+    int best = 2;
+    double best_cost = 0;
+    for (int c = 2; c <= CCryptoBoringSSLShims_MSM_MAX_WINDOW_BITS; c++) {
+        const double cost = (double)(bits / c + 1) * ((double)count * 6 + (double)((size_t)1 << (c - 1)) * 32);
+        if (c == 2 || cost < best_cost) {
+            best = c;
+            best_cost = cost;
+        }
+    }
+    return best;
+}
+
+// Inverts |a|, which must be non-zero. a^-1 = a^(p - 2) = (a^((p - 3) / 4))^4 * a,
+// which reuses the hash-to-curve addition chain, except that the generic
+// Montgomery method has safegcd, which is faster still.
+static void CCryptoBoringSSLShims_msm_felem_inv(const CCryptoBoringSSLShims_h2c_suite *field, EC_FELEM *out,
+                                                const EC_FELEM *a) {
+    if (field->group->meth == CCryptoBoringSSL_EC_GFp_mont_method()) {
+        CCryptoBoringSSLShims_ec_felem_inv0_mont(field->group, out, a);
+        return;
+    }
+    EC_FELEM t;
+    field->exp_c1(field, &t, a);
+    field->felem_sqr(field->group, &t, &t);
+    field->felem_sqr(field->group, &t, &t);
+    field->felem_mul(field->group, out, &t, a);
+}
+
+static unsigned CCryptoBoringSSLShims_msm_scalar_bits(const EC_SCALAR *scalar, size_t width, size_t bit, int c) {
+    const size_t word = bit / BN_BITS2, shift = bit % BN_BITS2;
+    if (word >= width) {
+        return 0;
+    }
+    BN_ULONG v = scalar->words[word] >> shift;
+    if (shift + c > BN_BITS2 && word + 1 < width) {
+        v |= scalar->words[word + 1] << (BN_BITS2 - shift);
+    }
+    return (unsigned)(v & (((BN_ULONG)1 << c) - 1));
+}
+
+// The scratch space of |CCryptoBoringSSLShims_msm_window|, one entry per bucket
+// except where noted.
+typedef struct {
+    EC_AFFINE *buckets;
+    EC_JACOBIAN *overflow;
+    // One more than the buckets: bucket b's points are sorted[start[b]] up to
+    // sorted[start[b + 1]].
+    size_t *start;
+    size_t *active;
+    size_t *batch;
+    EC_FELEM *prefix;
+    // One per point: the index shifted left by one, with the low bit set if the
+    // point is negated.
+    size_t *sorted;
+} CCryptoBoringSSLShims_msm_scratch;
+
+static void CCryptoBoringSSLShims_msm_point(const CCryptoBoringSSLShims_msm_worker *worker, EC_AFFINE *out,
+                                            size_t entry) {
+    *out = worker->points[entry >> 1];
+    if (entry & 1) {
+        CCryptoBoringSSL_ec_felem_neg(worker->group, &out->Y, &out->Y);
+    }
+}
+
+static void CCryptoBoringSSLShims_msm_jacobian_add_affine(const EC_GROUP *group, EC_JACOBIAN *acc,
+                                                          const EC_AFFINE *point) {
+    EC_JACOBIAN jacobian, sum;
+    CCryptoBoringSSL_ec_affine_to_jacobian(group, &jacobian, point);
+    group->meth->add(group, &sum, acc, &jacobian);
+    *acc = sum;
+}
+
+// Sums one window into |*out|.
+static void CCryptoBoringSSLShims_msm_window(const CCryptoBoringSSLShims_msm_worker *worker, size_t window,
+                                             EC_JACOBIAN *out, const CCryptoBoringSSLShims_msm_scratch *scratch) {
+    const EC_GROUP *group = worker->group;
+    const size_t num_buckets = (size_t)1 << (worker->window_bits - 1);
+    const int16_t *digits = worker->digits + window * worker->count;
+    EC_AFFINE *buckets = scratch->buckets;
+    EC_JACOBIAN *overflow = scratch->overflow;
+    size_t *start = scratch->start, *active = scratch->active, *batch = scratch->batch;
+
+    // Sort the points by bucket, with |active| as the cursors.
+    memset(start, 0, (num_buckets + 1) * sizeof(size_t));
+    for (size_t i = 0; i < worker->count; i++) {
+        if (digits[i] != 0) {
+            start[digits[i] < 0 ? -digits[i] : digits[i]]++;
+        }
+    }
+    for (size_t b = 0; b < num_buckets; b++) {
+        start[b + 1] += start[b];
+        active[b] = start[b];
+    }
+    for (size_t i = 0; i < worker->count; i++) {
+        if (digits[i] != 0) {
+            const size_t b = (size_t)(digits[i] < 0 ? -digits[i] : digits[i]) - 1;
+            scratch->sorted[active[b]++] = (i << 1) | (digits[i] < 0);
+        }
+    }
+
+    // Each bucket starts as its first point. Round r then adds the r-th point
+    // of every bucket that has one.
+    memset(overflow, 0, num_buckets * sizeof(EC_JACOBIAN));
+    size_t num_active = 0;
+    for (size_t b = 0; b < num_buckets; b++) {
+        if (start[b] < start[b + 1]) {
+            CCryptoBoringSSLShims_msm_point(worker, &buckets[b], scratch->sorted[start[b]]);
+        }
+        if (start[b + 1] - start[b] > 1) {
+            active[num_active++] = b;
+        }
+    }
+
+    for (size_t r = 1; num_active > 0; r++) {
+        if (num_active < CCryptoBoringSSLShims_MSM_MIN_ROUND) {
+            for (size_t j = 0; j < num_active; j++) {
+                const size_t b = active[j];
+                for (size_t k = start[b] + r; k < start[b + 1]; k++) {
+                    EC_AFFINE point;
+                    CCryptoBoringSSLShims_msm_point(worker, &point, scratch->sorted[k]);
+                    CCryptoBoringSSLShims_msm_jacobian_add_affine(group, &overflow[b], &point);
+                }
+            }
+            break;
+        }
+
+        // Invert every x2 - x1 of the round at once.
+        size_t num_batch = 0;
+        EC_FELEM denominator, inverse;
+        for (size_t j = 0; j < num_active; j++) {
+            const size_t b = active[j];
+            const EC_AFFINE *point = &worker->points[scratch->sorted[start[b] + r] >> 1];
+            if (memcmp(buckets[b].X.words, point->X.words, group->field.N.width * sizeof(BN_ULONG)) == 0) {
+                // A doubling or a cancellation, which the affine formula can't do.
+                EC_AFFINE negated;
+                CCryptoBoringSSLShims_msm_point(worker, &negated, scratch->sorted[start[b] + r]);
+                CCryptoBoringSSLShims_msm_jacobian_add_affine(group, &overflow[b], &negated);
+                continue;
+            }
+            CCryptoBoringSSL_ec_felem_sub(group, &denominator, &point->X, &buckets[b].X);
+            if (num_batch == 0) {
+                scratch->prefix[0] = denominator;
+            } else {
+                worker->field->felem_mul(group, &scratch->prefix[num_batch], &scratch->prefix[num_batch - 1], &denominator);
+            }
+            batch[num_batch++] = b;
+        }
+
+        if (num_batch > 0) {
+            CCryptoBoringSSLShims_msm_felem_inv(worker->field, &inverse, &scratch->prefix[num_batch - 1]);
+        }
+        for (size_t k = num_batch - 1; k < num_batch; k--) {
+            EC_AFFINE *bucket = &buckets[batch[k]];
+            EC_AFFINE point;
+            CCryptoBoringSSLShims_msm_point(worker, &point, scratch->sorted[start[batch[k]] + r]);
+
+            EC_FELEM lambda, x3, t;
+            if (k > 0) {
+                CCryptoBoringSSL_ec_felem_sub(group, &denominator, &point.X, &bucket->X);
+                worker->field->felem_mul(group, &t, &inverse, &scratch->prefix[k - 1]);
+                worker->field->felem_mul(group, &inverse, &inverse, &denominator);
+            } else {
+                t = inverse;
+            }
+
+            // lambda = (y2 - y1) / (x2 - x1), x3 = lambda^2 - x1 - x2,
+            // y3 = lambda * (x1 - x3) - y1.
+            CCryptoBoringSSL_ec_felem_sub(group, &lambda, &point.Y, &bucket->Y);
+            worker->field->felem_mul(group, &lambda, &lambda, &t);
+            worker->field->felem_sqr(group, &x3, &lambda);
+            CCryptoBoringSSL_ec_felem_sub(group, &x3, &x3, &bucket->X);
+            CCryptoBoringSSL_ec_felem_sub(group, &x3, &x3, &point.X);
+            CCryptoBoringSSL_ec_felem_sub(group, &t, &bucket->X, &x3);
+            worker->field->felem_mul(group, &t, &lambda, &t);
+            CCryptoBoringSSL_ec_felem_sub(group, &bucket->Y, &t, &bucket->Y);
+            bucket->X = x3;
+        }
+
+        // Keep the buckets that have points left.
+        size_t still_active = 0;
+        for (size_t j = 0; j < num_active; j++) {
+            if (start[active[j]] + r + 1 < start[active[j] + 1]) {
+                active[still_active++] = active[j];
+            }
+        }
+        num_active = still_active;
+    }
+
+    // sum(k * bucket[k - 1]) as a running sum from the top bucket down.
+    EC_JACOBIAN running, sum, tmp;
+    memset(&running, 0, sizeof(running));
+    memset(&sum, 0, sizeof(sum));
+    int started = 0;
+    for (size_t b = num_buckets - 1; b < num_buckets; b--) {
+        if (start[b] < start[b + 1]) {
+            CCryptoBoringSSLShims_msm_jacobian_add_affine(group, &running, &buckets[b]);
+            started = 1;
+        }
+        if (CCryptoBoringSSL_ec_felem_non_zero_mask(group, &overflow[b].Z) != 0) {
+            group->meth->add(group, &tmp, &running, &overflow[b]);
+            running = tmp;
+        }
+        if (started) {
+            group->meth->add(group, &tmp, &sum, &running);
+            sum = tmp;
+        }
+    }
+    *out = sum;
+}
+
+static void *CCryptoBoringSSLShims_msm_worker_run(void *arg) {
+    CCryptoBoringSSLShims_msm_worker *worker = arg;
+    const size_t num_buckets = (size_t)1 << (worker->window_bits - 1);
+    CCryptoBoringSSLShims_msm_scratch scratch = {
+        OPENSSL_malloc(num_buckets * sizeof(EC_AFFINE)),
+        OPENSSL_malloc(num_buckets * sizeof(EC_JACOBIAN)),
+        OPENSSL_malloc((num_buckets + 1) * sizeof(size_t)),
+        OPENSSL_malloc(num_buckets * sizeof(size_t)),
+        OPENSSL_malloc(num_buckets * sizeof(size_t)),
+        OPENSSL_malloc(num_buckets * sizeof(EC_FELEM)),
+        OPENSSL_malloc(worker->count * sizeof(size_t)),
+    };
+
+    worker->ok = scratch.buckets != NULL && scratch.overflow != NULL && scratch.start != NULL &&
+                 scratch.active != NULL && scratch.batch != NULL && scratch.prefix != NULL && scratch.sorted != NULL;
+    // Windows are dealt out round-robin.
+    for (size_t w = worker->worker; worker->ok && w < worker->num_windows; w += worker->workers) {
+        CCryptoBoringSSLShims_msm_window(worker, w, &worker->window_sums[w], &scratch);
+    }
+
+    OPENSSL_free(scratch.buckets);
+    OPENSSL_free(scratch.overflow);
+    OPENSSL_free(scratch.start);
+    OPENSSL_free(scratch.active);
+    OPENSSL_free(scratch.batch);
+    OPENSSL_free(scratch.prefix);
+    OPENSSL_free(scratch.sorted);
+    // Each thread has its own error queue, so leave nothing on it.
+    CCryptoBoringSSL_ERR_clear_error();
+    return NULL;
+}
+
+int CCryptoBoringSSLShims_EC_multi_scalar_mul(int curve_nid, void *out, int *out_is_infinity, const void *scalars,
+                                              const void *points, size_t count, size_t max_threads) {
+    CCryptoBoringSSLShims_h2c_suite field;
+    if (!CCryptoBoringSSLShims_h2c_suite_init(&field, curve_nid)) {
+        return 0;
+    }
+    const EC_GROUP *group = field.group;
+    const size_t field_len = CCryptoBoringSSL_BN_num_bytes(&group->field.N);
+    const size_t point_len = 1 + 2 * field_len;
+    const size_t scalar_len = CCryptoBoringSSL_BN_num_bytes(&group->order.N);
+    const size_t bits = CCryptoBoringSSL_BN_num_bits(&group->order.N);
+    const int c = CCryptoBoringSSLShims_msm_window_bits(count, bits);
+    const size_t num_windows = bits / c + 1;
+    if (count > SIZE_MAX / (num_windows * sizeof(int16_t)) || count > SIZE_MAX / sizeof(EC_AFFINE)) {
+        return 0;
+    }
+    if (count == 0) {
+        *out_is_infinity = 1;
+        memset(out, 0, point_len);
+        return 1;
+    }
+
+    int ok = 0;
+    EC_AFFINE *affine = OPENSSL_malloc(count * sizeof(EC_AFFINE));
+    int16_t *digits = OPENSSL_malloc(count * num_windows * sizeof(int16_t));
+    EC_JACOBIAN *window_sums = OPENSSL_malloc(num_windows * sizeof(EC_JACOBIAN));
+    if (affine == NULL || digits == NULL || window_sums == NULL) {
+        goto out;
+    }
+
+    // Decode each point and recode each scalar into signed digits in
+    // [-2^(c-1), 2^(c-1)]. The top window always absorbs the final carry.
+    const uint8_t *scalar_bytes = scalars;
+    const uint8_t *point_bytes = points;
+    for (size_t i = 0; i < count; i++) {
+        EC_SCALAR scalar;
+        if (!CCryptoBoringSSL_ec_point_from_uncompressed(group, &affine[i], point_bytes + i * point_len, point_len) ||
+            !CCryptoBoringSSL_ec_scalar_from_bytes(group, &scalar, scalar_bytes + i * scalar_len, scalar_len)) {
+            goto out;
+        }
+        unsigned carry = 0;
+        for (size_t w = 0; w < num_windows; w++) {
+            const unsigned v =
+                CCryptoBoringSSLShims_msm_scalar_bits(&scalar, group->order.N.width, w * c, c) + carry;
+            carry = v > (1u << (c - 1));
+            digits[w * count + i] = (int16_t)((int)v - (int)(carry << c));
+        }
+    }
+
+    size_t workers = max_threads == 0 ? 1 : max_threads;
+    if (workers > CCryptoBoringSSLShims_MSM_MAX_THREADS) {
+        workers = CCryptoBoringSSLShims_MSM_MAX_THREADS;
+    }
+    if (workers > num_windows) {
+        workers = num_windows;
+    }
+    // Small sums aren't worth a thread.
+    if (count < 256) {
+        workers = 1;
+    }
+#if !defined(CCRYPTOBORINGSSLSHIMS_PARALLEL_MSM)
+    workers = 1;
+#endif
+
+    CCryptoBoringSSLShims_msm_worker worker_state[CCryptoBoringSSLShims_MSM_MAX_THREADS];
+    for (size_t w = 0; w < workers; w++) {
+        worker_state[w] = (CCryptoBoringSSLShims_msm_worker){
+            group, &field, affine, digits, count, c, num_windows, window_sums, w, workers, 0,
+        };
+    }
+
+#if defined(CCRYPTOBORINGSSLSHIMS_PARALLEL_MSM)
+    pthread_t threads[CCryptoBoringSSLShims_MSM_MAX_THREADS];
+    int started[CCryptoBoringSSLShims_MSM_MAX_THREADS] = {0};
+    for (size_t w = 1; w < workers; w++) {
+        started[w] = pthread_create(&threads[w], NULL, CCryptoBoringSSLShims_msm_worker_run, &worker_state[w]) == 0;
+    }
+#endif
+    CCryptoBoringSSLShims_msm_worker_run(&worker_state[0]);
+    ok = worker_state[0].ok;
+    for (size_t w = 1; w < workers; w++) {
+#if defined(CCRYPTOBORINGSSLSHIMS_PARALLEL_MSM)
+        if (started[w]) {
+            pthread_join(threads[w], NULL);
+            ok &= worker_state[w].ok;
+            continue;
+        }
+#endif
+        // The thread could not be started, so its windows are summed here instead.
+        CCryptoBoringSSLShims_msm_worker_run(&worker_state[w]);
+        ok &= worker_state[w].ok;
+    }
+    if (!ok) {
+        goto out;
+    }
+
+    // Combine the windows from the top, doubling c times between them.
+    EC_JACOBIAN result = window_sums[num_windows - 1], tmp;
+    for (size_t w = num_windows - 2; w < num_windows; w--) {
+        for (int i = 0; i < c; i++) {
+            group->meth->dbl(group, &tmp, &result);
+            result = tmp;
+        }
+        group->meth->add(group, &tmp, &result, &window_sums[w]);
+        result = tmp;
+    }
+
+    *out_is_infinity = CCryptoBoringSSL_ec_felem_non_zero_mask(group, &result.Z) == 0;
+    if (*out_is_infinity) {
+        memset(out, 0, point_len);
+    } else {
+        EC_AFFINE result_affine;
+        ok = CCryptoBoringSSL_ec_jacobian_to_affine(group, &result_affine, &result) &&
+             CCryptoBoringSSL_ec_point_to_bytes(group, &result_affine, POINT_CONVERSION_UNCOMPRESSED, out,
+                                                point_len) == point_len;
+    }
+
+out:
+    OPENSSL_free(affine);
+    OPENSSL_free(digits);
+    OPENSSL_free(window_sums);
+    return ok;
+}
+
+// MARK:- FFDHE
+
+// Key generation in the RFC 7919 ffdhe2048 group raises the generator 2 to a
+// secret exponent of about 2047 bits. |DH_generate_key| does that with a
+// windowed exponentiation, about 2047 squarings and 410 multiplications, and
+// sets up a fresh |BN_MONT_CTX| for every |DH|. Here the group, its
+// Montgomery context and a Lim-Lee comb for the generator are built once.
+//
+// The comb splits the exponent into |TEETH| rows of |ROW| bits, and each row
+// into |BLOCKS| blocks of |COLUMNS| bits. Table |k| holds, for every subset of
+// the rows, the product of the generator powers that bit |k * COLUMNS| of
+// those rows stands for. Bit |j| of every block is then handled by one lookup
+// and multiplication per block, after one squaring shared by all of them:
+// |COLUMNS - 1| squarings and |BLOCKS * COLUMNS| multiplications in all, about
+// a fifth of the work, for 32 KiB of tables. Lookups scan a whole table, so
+// the access pattern does not depend on the exponent.
+#define CCRYPTOBORINGSSLSHIMS_FFDHE_BITS 2048
+#define CCRYPTOBORINGSSLSHIMS_FFDHE_TEETH 5
+#define CCRYPTOBORINGSSLSHIMS_FFDHE_BLOCKS 4
+#define CCRYPTOBORINGSSLSHIMS_FFDHE_ROW \
+    ((CCRYPTOBORINGSSLSHIMS_FFDHE_BITS + CCRYPTOBORINGSSLSHIMS_FFDHE_TEETH - 1) / CCRYPTOBORINGSSLSHIMS_FFDHE_TEETH)
+#define CCRYPTOBORINGSSLSHIMS_FFDHE_COLUMNS \
+    ((CCRYPTOBORINGSSLSHIMS_FFDHE_ROW + CCRYPTOBORINGSSLSHIMS_FFDHE_BLOCKS - 1) / CCRYPTOBORINGSSLSHIMS_FFDHE_BLOCKS)
+#define CCRYPTOBORINGSSLSHIMS_FFDHE_WORDS (CCRYPTOBORINGSSLSHIMS_FFDHE_BITS / BN_BITS2)
+
+static_assert(CCryptoBoringSSLShims_FFDHE2048_BYTES * 8 == CCRYPTOBORINGSSLSHIMS_FFDHE_BITS,
+              "FFDHE key size mismatch");
+
+typedef struct {
+    DH *dh;
+    BN_MONT_CTX *mont;
+    // |BLOCKS| tables of |1 << TEETH| entries, in the Montgomery domain.
+    BN_ULONG table[CCRYPTOBORINGSSLSHIMS_FFDHE_BLOCKS][1 << CCRYPTOBORINGSSLSHIMS_FFDHE_TEETH]
+                  [CCRYPTOBORINGSSLSHIMS_FFDHE_WORDS];
+} CCryptoBoringSSLShims_ffdhe_group;
+
+static CCryptoBoringSSLShims_ffdhe_group *CCryptoBoringSSLShims_ffdhe2048 = NULL;
+static CRYPTO_once_t CCryptoBoringSSLShims_ffdhe2048_once = CRYPTO_ONCE_INIT;
+
+static void CCryptoBoringSSLShims_ffdhe2048_build(void) {
+    CCryptoBoringSSLShims_ffdhe_group *group = CCryptoBoringSSL_OPENSSL_zalloc(sizeof(*group));
+    BN_CTX *ctx = CCryptoBoringSSL_BN_CTX_new();
+    BIGNUM *power = CCryptoBoringSSL_BN_new();
+    BIGNUM *entry = CCryptoBoringSSL_BN_new();
+    // The generator raised to 2^(i * ROW + k * COLUMNS) for row |i| and block |k|.
+    BIGNUM *bases[CCRYPTOBORINGSSLSHIMS_FFDHE_TEETH] = {NULL};
+    int ok = group != NULL && ctx != NULL && power != NULL && entry != NULL &&
+             (group->dh = CCryptoBoringSSL_DH_get_rfc7919_2048()) != NULL &&
+             (group->mont = CCryptoBoringSSL_BN_MONT_CTX_new_for_modulus(CCryptoBoringSSL_DH_get0_p(group->dh), ctx)) != NULL &&
+             group->mont->N.width == CCRYPTOBORINGSSLSHIMS_FFDHE_WORDS &&
+             CCryptoBoringSSL_BN_to_montgomery(power, CCryptoBoringSSL_DH_get0_g(group->dh), group->mont, ctx) &&
+             CCryptoBoringSSL_bn_resize_words(power, CCRYPTOBORINGSSLSHIMS_FFDHE_WORDS);
+    for (size_t i = 0; ok && i < CCRYPTOBORINGSSLSHIMS_FFDHE_TEETH; i++) {
+        ok = (bases[i] = CCryptoBoringSSL_BN_new()) != NULL;
+    }
+
+    for (size_t k = 0; ok && k < CCRYPTOBORINGSSLSHIMS_FFDHE_BLOCKS; k++) {
+        // |power| is the generator raised to 2^(k * COLUMNS) here. Step it
+        // along the rows to get this block's bases, and then on to the next
+        // block's start.
+        BIGNUM *walk = entry;
+        ok = CCryptoBoringSSL_BN_copy(walk, power) != NULL;
+        for (size_t i = 0; ok && i < CCRYPTOBORINGSSLSHIMS_FFDHE_TEETH; i++) {
+            ok = CCryptoBoringSSL_BN_copy(bases[i], walk) != NULL;
+            for (size_t s = 0; ok && i + 1 < CCRYPTOBORINGSSLSHIMS_FFDHE_TEETH && s < CCRYPTOBORINGSSLSHIMS_FFDHE_ROW; s++) {
+                ok = CCryptoBoringSSL_BN_mod_mul_montgomery(walk, walk, walk, group->mont, ctx);
+            }
+        }
+        for (size_t s = 0; ok && s < CCRYPTOBORINGSSLSHIMS_FFDHE_COLUMNS; s++) {
+            ok = CCryptoBoringSSL_BN_mod_mul_montgomery(power, power, power, group->mont, ctx);
+        }
+
+        // Entry |v| is the product of the bases of the rows set in |v|, built
+        // from the entry without its top row.
+        ok = ok && CCryptoBoringSSL_BN_set_word(entry, 1) &&
+             CCryptoBoringSSL_BN_to_montgomery(entry, entry, group->mont, ctx) &&
+             CCryptoBoringSSL_bn_copy_words(group->table[k][0], CCRYPTOBORINGSSLSHIMS_FFDHE_WORDS, entry);
+        for (size_t v = 1; ok && v < (1u << CCRYPTOBORINGSSLSHIMS_FFDHE_TEETH); v++) {
+            size_t top = CCryptoBoringSSL_BN_num_bits_word(v) - 1;
+            ok = CCryptoBoringSSL_bn_set_words(entry, group->table[k][v & ~((size_t)1 << top)], CCRYPTOBORINGSSLSHIMS_FFDHE_WORDS) &&
+                 CCryptoBoringSSL_BN_mod_mul_montgomery(entry, entry, bases[top], group->mont, ctx) &&
+                 CCryptoBoringSSL_bn_copy_words(group->table[k][v], CCRYPTOBORINGSSLSHIMS_FFDHE_WORDS, entry);
+        }
+    }
+
+    for (size_t i = 0; i < CCRYPTOBORINGSSLSHIMS_FFDHE_TEETH; i++) {
+        CCryptoBoringSSL_BN_free(bases[i]);
+    }
+    CCryptoBoringSSL_BN_free(power);
+    CCryptoBoringSSL_BN_free(entry);
+    CCryptoBoringSSL_BN_CTX_free(ctx);
+    if (!ok && group != NULL) {
+        CCryptoBoringSSL_DH_free(group->dh);
+        CCryptoBoringSSL_BN_MONT_CTX_free(group->mont);
+        CCryptoBoringSSL_OPENSSL_free(group);
+        group = NULL;
+    }
+    CCryptoBoringSSLShims_ffdhe2048 = group;
+}
+
+static const CCryptoBoringSSLShims_ffdhe_group *CCryptoBoringSSLShims_ffdhe2048_get(void) {
+    CRYPTO_once(&CCryptoBoringSSLShims_ffdhe2048_once, CCryptoBoringSSLShims_ffdhe2048_build);
+    return CCryptoBoringSSLShims_ffdhe2048;
+}
+
+// Sets |out| to the generator raised to |exponent|, which must be less than
+// 2^BITS, using the comb. |out| is left in the ordinary domain.
+static int CCryptoBoringSSLShims_ffdhe_exp_base(const CCryptoBoringSSLShims_ffdhe_group *group, BIGNUM *out,
+                                               const BIGNUM *exponent, BN_CTX *ctx) {
+    BN_ULONG e[CCRYPTOBORINGSSLSHIMS_FFDHE_WORDS];
+    if (!CCryptoBoringSSL_bn_copy_words(e, CCRYPTOBORINGSSLSHIMS_FFDHE_WORDS, exponent)) {
+        return 0;
+    }
+
+    int ok = 0;
+    CCryptoBoringSSL_BN_CTX_start(ctx);
+    BIGNUM *entry = CCryptoBoringSSL_BN_CTX_get(ctx);
+    if (entry == NULL || !CCryptoBoringSSL_bn_wexpand(entry, CCRYPTOBORINGSSLSHIMS_FFDHE_WORDS) ||
+        !CCryptoBoringSSL_bn_set_words(out, group->table[0][0], CCRYPTOBORINGSSLSHIMS_FFDHE_WORDS)) {
+        goto err;
+    }
+    entry->width = CCRYPTOBORINGSSLSHIMS_FFDHE_WORDS;
+
+    for (size_t j = CCRYPTOBORINGSSLSHIMS_FFDHE_COLUMNS; j-- > 0;) {
+        if (j + 1 < CCRYPTOBORINGSSLSHIMS_FFDHE_COLUMNS &&
+            !CCryptoBoringSSL_BN_mod_mul_montgomery(out, out, out, group->mont, ctx)) {
+            goto err;
+        }
+        for (size_t k = 0; k < CCRYPTOBORINGSSLSHIMS_FFDHE_BLOCKS; k++) {
+            // Gather bit |k * COLUMNS + j| of every row. Bits past the end of
+            // a row or of the exponent are zero.
+            size_t column = k * CCRYPTOBORINGSSLSHIMS_FFDHE_COLUMNS + j;
+            BN_ULONG index = 0;
+            for (size_t i = 0; column < CCRYPTOBORINGSSLSHIMS_FFDHE_ROW && i < CCRYPTOBORINGSSLSHIMS_FFDHE_TEETH; i++) {
+                size_t bit = i * CCRYPTOBORINGSSLSHIMS_FFDHE_ROW + column;
+                if (bit < CCRYPTOBORINGSSLSHIMS_FFDHE_BITS) {
+                    index |= ((e[bit / BN_BITS2] >> (bit % BN_BITS2)) & 1) << i;
+                }
+            }
+            OPENSSL_memset(entry->d, 0, CCRYPTOBORINGSSLSHIMS_FFDHE_WORDS * sizeof(BN_ULONG));
+            for (size_t v = 0; v < (1u << CCRYPTOBORINGSSLSHIMS_FFDHE_TEETH); v++) {
+                BN_ULONG mask = constant_time_eq_w(index, v);
+                for (size_t w = 0; w < CCRYPTOBORINGSSLSHIMS_FFDHE_WORDS; w++) {
+                    entry->d[w] |= group->table[k][v][w] & mask;
+                }
+            }
+            if (!CCryptoBoringSSL_BN_mod_mul_montgomery(out, out, entry, group->mont, ctx)) {
+                goto err;
+            }
+        }
+    }
+    ok = CCryptoBoringSSL_BN_from_montgomery(out, out, group->mont, ctx);
+
+err:
+    if (entry != NULL) {
+        CCryptoBoringSSL_BN_clear(entry);
+    }
+    CCryptoBoringSSL_BN_CTX_end(ctx);
+    CCryptoBoringSSL_OPENSSL_cleanse(e, sizeof(e));
+    return ok;
+}
+
+// Parses a private exponent, which must be in [1, q - 1] like the ones
+// |DH_generate_key| draws.
+static int CCryptoBoringSSLShims_ffdhe_parse_private(const CCryptoBoringSSLShims_ffdhe_group *group, BIGNUM *out,
+                                                    const uint8_t *in) {
+    return CCryptoBoringSSL_BN_bin2bn(in, CCryptoBoringSSLShims_FFDHE2048_BYTES, out) != NULL &&
+           !CCryptoBoringSSL_BN_is_zero(out) && CCryptoBoringSSL_BN_cmp(out, CCryptoBoringSSL_DH_get0_q(group->dh)) < 0;
+}
+
+static int CCryptoBoringSSLShims_FFDHE2048_public(const CCryptoBoringSSLShims_ffdhe_group *group, uint8_t *out_public_key,
+                                                 const BIGNUM *private_key, BN_CTX *ctx) {
+    CCryptoBoringSSL_BN_CTX_start(ctx);
+    BIGNUM *public_key = CCryptoBoringSSL_BN_CTX_get(ctx);
+    int ok = public_key != NULL && CCryptoBoringSSLShims_ffdhe_exp_base(group, public_key, private_key, ctx) &&
+             CCryptoBoringSSL_BN_bn2bin_padded(out_public_key, CCryptoBoringSSLShims_FFDHE2048_BYTES, public_key);
+    CCryptoBoringSSL_BN_CTX_end(ctx);
+    return ok;
+}
+
+int CCryptoBoringSSLShims_FFDHE2048_generate_key(void *out_private_key, void *out_public_key) {
+    const CCryptoBoringSSLShims_ffdhe_group *group = CCryptoBoringSSLShims_ffdhe2048_get();
+    BN_CTX *ctx = CCryptoBoringSSL_BN_CTX_new();
+    if (group == NULL || ctx == NULL) {
+        CCryptoBoringSSL_BN_CTX_free(ctx);
+        return 0;
+    }
+    CCryptoBoringSSL_BN_CTX_start(ctx);
+    BIGNUM *private_key = CCryptoBoringSSL_BN_CTX_get(ctx);
+    // As |DH_generate_key| does when q is known: uniform in [1, q - 1].
+    int ok = private_key != NULL &&
+             CCryptoBoringSSL_BN_rand_range_ex(private_key, 1, CCryptoBoringSSL_DH_get0_q(group->dh)) &&
+             CCryptoBoringSSLShims_FFDHE2048_public(group, out_public_key, private_key, ctx) &&
+             CCryptoBoringSSL_BN_bn2bin_padded(out_private_key, CCryptoBoringSSLShims_FFDHE2048_BYTES, private_key);
+    if (private_key != NULL) {
+        CCryptoBoringSSL_BN_clear(private_key);
+    }
+    if (!ok) {
+        CCryptoBoringSSL_OPENSSL_cleanse(out_private_key, CCryptoBoringSSLShims_FFDHE2048_BYTES);
+    }
+    CCryptoBoringSSL_BN_CTX_end(ctx);
+    CCryptoBoringSSL_BN_CTX_free(ctx);
+    return ok;
+}
+
+int CCryptoBoringSSLShims_FFDHE2048_public_key(void *out_public_key, const void *private_key) {
+    const CCryptoBoringSSLShims_ffdhe_group *group = CCryptoBoringSSLShims_ffdhe2048_get();
+    BN_CTX *ctx = CCryptoBoringSSL_BN_CTX_new();
+    if (group == NULL || ctx == NULL) {
+        CCryptoBoringSSL_BN_CTX_free(ctx);
+        return 0;
+    }
+    CCryptoBoringSSL_BN_CTX_start(ctx);
+    BIGNUM *x = CCryptoBoringSSL_BN_CTX_get(ctx);
+    int ok = x != NULL && CCryptoBoringSSLShims_ffdhe_parse_private(group, x, private_key) &&
+             CCryptoBoringSSLShims_FFDHE2048_public(group, out_public_key, x, ctx);
+    if (x != NULL) {
+        CCryptoBoringSSL_BN_clear(x);
+    }
+    CCryptoBoringSSL_BN_CTX_end(ctx);
+    CCryptoBoringSSL_BN_CTX_free(ctx);
+    return ok;
+}
+
+int CCryptoBoringSSLShims_FFDHE2048_check_public_key(const void *public_key, size_t public_key_len) {
+    const CCryptoBoringSSLShims_ffdhe_group *group = CCryptoBoringSSLShims_ffdhe2048_get();
+    BN_CTX *ctx = CCryptoBoringSSL_BN_CTX_new();
+    if (group == NULL || ctx == NULL || public_key_len != CCryptoBoringSSLShims_FFDHE2048_BYTES) {
+        CCryptoBoringSSL_BN_CTX_free(ctx);
+        return 0;
+    }
+    CCryptoBoringSSL_BN_CTX_start(ctx);
+    BIGNUM *y = CCryptoBoringSSL_BN_CTX_get(ctx);
+    BIGNUM *tmp = CCryptoBoringSSL_BN_CTX_get(ctx);
+    // The checks of |DH_check_pub_key|: 1 < y < p - 1 and y^q = 1, but with the
+    // shared Montgomery context.
+    int ok = y != NULL && tmp != NULL && CCryptoBoringSSL_BN_bin2bn(public_key, public_key_len, y) != NULL &&
+             CCryptoBoringSSL_BN_cmp_word(y, 1) > 0 && CCryptoBoringSSL_BN_copy(tmp, &group->mont->N) != NULL &&
+             CCryptoBoringSSL_BN_sub_word(tmp, 1) && CCryptoBoringSSL_BN_cmp(y, tmp) < 0 &&
+             CCryptoBoringSSL_BN_mod_exp_mont(tmp, y, CCryptoBoringSSL_DH_get0_q(group->dh), &group->mont->N, ctx,
+                                              group->mont) &&
+             CCryptoBoringSSL_BN_is_one(tmp);
+    CCryptoBoringSSL_BN_CTX_end(ctx);
+    CCryptoBoringSSL_BN_CTX_free(ctx);
+    return ok;
+}
+
+int CCryptoBoringSSLShims_FFDHE2048_compute_key(void *out, const void *private_key, const void *peer_public_key,
+                                                size_t peer_public_key_len) {
+    if (!CCryptoBoringSSLShims_FFDHE2048_check_public_key(peer_public_key, peer_public_key_len)) {
+        return 0;
+    }
+    const CCryptoBoringSSLShims_ffdhe_group *group = CCryptoBoringSSLShims_ffdhe2048_get();
+    BN_CTX *ctx = CCryptoBoringSSL_BN_CTX_new();
+    if (ctx == NULL) {
+        return 0;
+    }
+    CCryptoBoringSSL_BN_CTX_start(ctx);
+    BIGNUM *x = CCryptoBoringSSL_BN_CTX_get(ctx);
+    BIGNUM *y = CCryptoBoringSSL_BN_CTX_get(ctx);
+    BIGNUM *shared = CCryptoBoringSSL_BN_CTX_get(ctx);
+    BIGNUM *p_minus_1 = CCryptoBoringSSL_BN_CTX_get(ctx);
+    int ok = p_minus_1 != NULL && CCryptoBoringSSLShims_ffdhe_parse_private(group, x, private_key) &&
+             CCryptoBoringSSL_BN_bin2bn(peer_public_key, peer_public_key_len, y) != NULL &&
+             CCryptoBoringSSL_BN_mod_exp_mont_consttime(shared, y, x, &group->mont->N, ctx, group->mont) &&
+             CCryptoBoringSSL_BN_copy(p_minus_1, &group->mont->N) != NULL && CCryptoBoringSSL_BN_sub_word(p_minus_1, 1) &&
+             // The check of SP 800-56Ar3 section 5.7.1.1 that |DH_compute_key_padded| makes.
+             CCryptoBoringSSL_BN_cmp_word(shared, 1) > 0 && CCryptoBoringSSL_BN_cmp(shared, p_minus_1) != 0 &&
+             CCryptoBoringSSL_BN_bn2bin_padded(out, CCryptoBoringSSLShims_FFDHE2048_BYTES, shared);
+    if (x != NULL) {
+        CCryptoBoringSSL_BN_clear(x);
+    }
+    if (shared != NULL) {
+        CCryptoBoringSSL_BN_clear(shared);
+    }
+    if (!ok) {
+        CCryptoBoringSSL_OPENSSL_cleanse(out, CCryptoBoringSSLShims_FFDHE2048_BYTES);
+    }
+    CCryptoBoringSSL_BN_CTX_end(ctx);
+    CCryptoBoringSSL_BN_CTX_free(ctx);
+    return ok;
+}
+
+// MARK:- Parallel RSA CRT
+
+#if !defined(_WIN32) && !defined(OPENSSL_NO_THREADS_CORRUPT_MEMORY_AND_LEAK_SECRETS_IF_THREADED)
+#define CCRYPTOBORINGSSLSHIMS_PARALLEL_CRT 1
+#include <pthread.h>
+#endif
+
+// Mirrors |mod_montgomery| in rsa_impl.c: reduces |I| < p * q modulo |p| in
+// constant time.
+static int CCryptoBoringSSLShims_rsa_mod_montgomery(BIGNUM *r, const BIGNUM *I, const BN_MONT_CTX *mont_p,
+                                                    const BIGNUM *q, BN_CTX *ctx) {
+    if (!CCryptoBoringSSL_bn_less_than_montgomery_R(q, mont_p)) {
+        return 0;
+    }
+    return CCryptoBoringSSL_BN_from_montgomery(r, I, mont_p, ctx) &&
+           CCryptoBoringSSL_BN_to_montgomery(r, r, mont_p, ctx);
+}
+
+// One modulus's half of the CRT: out = (I mod p)^d mod p.
+typedef struct {
+    BIGNUM *out;
+    const BIGNUM *I;
+    const BIGNUM *d;
+    const BN_MONT_CTX *mont;
+    const BIGNUM *other;
+    int ok;
+} CCryptoBoringSSLShims_rsa_crt_half;
+
+static void *CCryptoBoringSSLShims_rsa_crt_half_run(void *arg) {
+    CCryptoBoringSSLShims_rsa_crt_half *half = arg;
+    half->ok = 0;
+    BN_CTX *ctx = CCryptoBoringSSL_BN_CTX_new();
+    if (ctx == NULL) {
+        return NULL;
+    }
+    CCryptoBoringSSL_BN_CTX_start(ctx);
+    BIGNUM *reduced = CCryptoBoringSSL_BN_CTX_get(ctx);
+    half->ok = reduced != NULL &&
+               CCryptoBoringSSLShims_rsa_mod_montgomery(reduced, half->I, half->mont, half->other, ctx) &&
+               CCryptoBoringSSL_BN_mod_exp_mont_consttime(half->out, reduced, half->d, &half->mont->N, ctx,
+                                                          half->mont);
+    CCryptoBoringSSL_BN_CTX_end(ctx);
+    CCryptoBoringSSL_BN_CTX_free(ctx);
+    return NULL;
+}
+
+// Whether |rsa| can take the parallel path. It must already have been frozen
+// by an ordinary private key operation, because freezing is internal to
+// rsa_impl.c, and it must have everything blinding, CRT and the fault check
+// need.
+static int CCryptoBoringSSLShims_rsa_parallel_crt_usable(RSA *rsa) {
+    CCryptoBoringSSL_CRYPTO_MUTEX_lock_read(&rsa->lock);
+    int frozen = rsa->private_key_frozen;
+    CCryptoBoringSSL_CRYPTO_MUTEX_unlock_read(&rsa->lock);
+    return frozen && rsa->meth->private_transform == NULL &&
+           (rsa->flags & (RSA_FLAG_NO_BLINDING | RSA_FLAG_NO_PUBLIC_EXPONENT)) == 0 && rsa->e != NULL &&
+           rsa->p != NULL && rsa->q != NULL && rsa->dmp1 != NULL && rsa->dmq1 != NULL && rsa->iqmp != NULL &&
+           CCryptoBoringSSL_bn_less_than_montgomery_R(rsa->q, rsa->mont_p) &&
+           CCryptoBoringSSL_bn_less_than_montgomery_R(rsa->p, rsa->mont_q);
+}
+
+// The RSA private transform of |rsa_default_private_transform|, except that
+// the exponentiations modulo q and modulo p run on two threads at once. The
+// blinding factor is fresh for every call rather than taken from the key's
+// cache, so callers pay one extra modular inversion in exchange for never
+// touching the key's lock on the critical path.
+static int CCryptoBoringSSLShims_rsa_private_transform_parallel(RSA *rsa, uint8_t *out, const uint8_t *in,
+                                                                size_t len) {
+    if (!CCryptoBoringSSLShims_rsa_parallel_crt_usable(rsa)) {
+        return CCryptoBoringSSL_rsa_default_private_transform(rsa, out, in, len);
+    }
+
+    int ret = 0;
+    BN_BLINDING *blinding = NULL;
+    BIGNUM *m1 = NULL;
+    BN_CTX *ctx = CCryptoBoringSSL_BN_CTX_new();
+    if (ctx == NULL) {
+        return 0;
+    }
+    CCryptoBoringSSL_BN_CTX_start(ctx);
+    BIGNUM *f = CCryptoBoringSSL_BN_CTX_get(ctx);
+    BIGNUM *r0 = CCryptoBoringSSL_BN_CTX_get(ctx);
+    BIGNUM *r1 = CCryptoBoringSSL_BN_CTX_get(ctx);
+    BIGNUM *vrfy = CCryptoBoringSSL_BN_CTX_get(ctx);
+    m1 = CCryptoBoringSSL_BN_new();
+    blinding = CCryptoBoringSSL_BN_BLINDING_new();
+    if (vrfy == NULL || m1 == NULL || blinding == NULL ||
+        CCryptoBoringSSL_BN_bin2bn(in, len, f) == NULL ||
+        constant_time_declassify_int(CCryptoBoringSSL_BN_ucmp(f, rsa->n) >= 0) ||
+        !CCryptoBoringSSL_BN_BLINDING_convert(f, blinding, rsa->e, rsa->mont_n, ctx)) {
+        goto err;
+    }
+
+    const BIGNUM *n = &rsa->mont_n->N;
+    const BIGNUM *p = &rsa->mont_p->N;
+    const BIGNUM *q = &rsa->mont_q->N;
+    CCryptoBoringSSLShims_rsa_crt_half q_half = {m1, f, rsa->dmq1_fixed, rsa->mont_q, p, 0};
+    CCryptoBoringSSLShims_rsa_crt_half p_half = {r0, f, rsa->dmp1_fixed, rsa->mont_p, q, 0};
+
+#if defined(CCRYPTOBORINGSSLSHIMS_PARALLEL_CRT)
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, CCryptoBoringSSLShims_rsa_crt_half_run, &q_half) == 0) {
+        CCryptoBoringSSLShims_rsa_crt_half_run(&p_half);
+        pthread_join(thread, NULL);
+    } else
+#endif
+    {
+        CCryptoBoringSSLShims_rsa_crt_half_run(&q_half);
+        CCryptoBoringSSLShims_rsa_crt_half_run(&p_half);
+    }
+
+    // Recombine exactly as |mod_exp| does: r0 = ((r0 - m1) * iqmp mod p) * q + m1.
+    if (!q_half.ok || !p_half.ok ||
+        !CCryptoBoringSSLShims_rsa_mod_montgomery(r1, m1, rsa->mont_p, q, ctx) ||
+        !CCryptoBoringSSL_bn_mod_sub_consttime(r0, r0, r1, p, ctx) ||
+        !CCryptoBoringSSL_BN_mod_mul_montgomery(r0, r0, rsa->iqmp_mont, rsa->mont_p, ctx) ||
+        !CCryptoBoringSSL_bn_mul_consttime(r0, r0, q, ctx) ||
+        !CCryptoBoringSSL_bn_uadd_consttime(r0, r0, m1) ||
+        !CCryptoBoringSSL_bn_resize_words(r0, n->width)) {
+        goto err;
+    }
+
+    // The same fault check as |rsa_default_private_transform|.
+    if (!CCryptoBoringSSL_BN_mod_exp_mont(vrfy, r0, rsa->e, rsa->n, ctx, rsa->mont_n) ||
+        !constant_time_declassify_int(CCryptoBoringSSL_BN_equal_consttime(vrfy, f))) {
+        OPENSSL_PUT_ERROR(RSA, ERR_R_INTERNAL_ERROR);
+        goto err;
+    }
+
+    if (!CCryptoBoringSSL_BN_BLINDING_invert(r0, blinding, rsa->mont_n, ctx) ||
+        !CCryptoBoringSSL_BN_bn2bin_padded(out, len, r0)) {
+        goto err;
+    }
+    ret = 1;
+
+err:
+    CCryptoBoringSSL_BN_BLINDING_free(blinding);
+    CCryptoBoringSSL_BN_clear_free(m1);
+    CCryptoBoringSSL_BN_CTX_end(ctx);
+    CCryptoBoringSSL_BN_CTX_free(ctx);
+    return ret;
+}
+
+int CCryptoBoringSSLShims_RSA_sign_parallel_crt(int hash_nid, const void *in,
+                                                unsigned int in_len, void *out,
+                                                unsigned int *out_len, RSA *rsa) {
+    const size_t rsa_size = CCryptoBoringSSL_RSA_size(rsa);
+    uint8_t *signed_msg = NULL;
+    size_t signed_msg_len = 0;
+    int signed_msg_is_alloced = 0;
+    int ret = 0;
+
+    CCRYPTOBORINGSSLSHIMS_TRACE_ENTRY(rsa_sign, hash_nid, CCryptoBoringSSL_RSA_bits(rsa), in_len);
+    uint8_t *padded = OPENSSL_malloc(rsa_size);
+    if (padded == NULL ||
+        !CCryptoBoringSSL_RSA_add_pkcs1_prefix(&signed_msg, &signed_msg_len, &signed_msg_is_alloced, hash_nid,
+                                               in, in_len) ||
+        !CCryptoBoringSSL_RSA_padding_add_PKCS1_type_1(padded, rsa_size, signed_msg, signed_msg_len) ||
+        !CCryptoBoringSSLShims_rsa_private_transform_parallel(rsa, out, padded, rsa_size)) {
+        goto err;
+    }
+    *out_len = (unsigned int)rsa_size;
+    ret = 1;
+
+err:
+    if (signed_msg_is_alloced) {
+        OPENSSL_free(signed_msg);
+    }
+    OPENSSL_free(padded);
+    CCRYPTOBORINGSSLSHIMS_TRACE_RETURN(rsa_sign, hash_nid, CCryptoBoringSSL_RSA_bits(rsa), in_len, ret);
+    return ret;
+}
+
+int CCryptoBoringSSLShims_RSA_sign_pss_mgf1_parallel_crt(RSA *rsa, size_t *out_len, void *out,
+                                                         size_t max_out, const void *in,
+                                                         size_t in_len, const EVP_MD *md,
+                                                         const EVP_MD *mgf1_md, int salt_len) {
+    const size_t rsa_size = CCryptoBoringSSL_RSA_size(rsa);
+    if (in_len != CCryptoBoringSSL_EVP_MD_size(md) || max_out < rsa_size) {
+        return 0;
+    }
+
+    CCRYPTOBORINGSSLSHIMS_TRACE_ENTRY(rsa_sign, CCryptoBoringSSL_EVP_MD_type(md),
+                                      CCryptoBoringSSL_RSA_bits(rsa), in_len);
+    uint8_t *padded = OPENSSL_malloc(rsa_size);
+    int ret = padded != NULL &&
+              CCryptoBoringSSLShims_RSA_padding_add_PKCS1_PSS_mgf1(rsa, padded, in, md, mgf1_md, salt_len) &&
+              CCryptoBoringSSLShims_rsa_private_transform_parallel(rsa, out, padded, rsa_size);
+    if (ret) {
+        *out_len = rsa_size;
+    }
+    OPENSSL_free(padded);
+    CCRYPTOBORINGSSLSHIMS_TRACE_RETURN(rsa_sign, CCryptoBoringSSL_EVP_MD_type(md),
+                                       CCryptoBoringSSL_RSA_bits(rsa), in_len, ret);
+    return ret;
+}
+
+// MARK:- MGF1 padding
+
+// One MGF1 loop over a SHA-1 or SHA-2 context type. The contexts are plain
+// structs, so the state after the seed is copied by assignment.
+#define CCRYPTOBORINGSSLSHIMS_MGF1_XOR(CTX, INIT, UPDATE, FINAL, MD_LEN)                                      \
+    do {                                                                                                    \
+        CTX base, block;                                                                                    \
+        INIT(&base);                                                                                        \
+        UPDATE(&base, seed, seed_len);                                                                      \
+        for (uint32_t counter = 0; len > 0; counter++) {                                                    \
+            uint8_t counter_bytes[4] = {(uint8_t)(counter >> 24), (uint8_t)(counter >> 16),                 \
+                                        (uint8_t)(counter >> 8), (uint8_t)counter};                         \
+            block = base;                                                                                   \
+            UPDATE(&block, counter_bytes, sizeof(counter_bytes));                                           \
+            FINAL(mask, &block);                                                                            \
+            const size_t todo = len < (MD_LEN) ? len : (MD_LEN);                                            \
+            for (size_t i = 0; i < todo; i++) {                                                             \
+                out[i] ^= mask[i];                                                                          \
+            }                                                                                               \
+            out += todo;                                                                                    \
+            len -= todo;                                                                                    \
+        }                                                                                                   \
+        CCryptoBoringSSL_OPENSSL_cleanse(&base, sizeof(base));                                              \
+        CCryptoBoringSSL_OPENSSL_cleanse(&block, sizeof(block));                                            \
+    } while (0)
+
+// XORs `len` bytes of the MGF1 mask of `seed` into `out`. The seed is hashed
+// once, and every counter block continues from a copy of that state, so a seed
+// longer than the digest's block is only compressed once. `out` must not
+// overlap `seed`.
+static int CCryptoBoringSSLShims_mgf1_xor(uint8_t *out, size_t len, const uint8_t *seed, size_t seed_len,
+                                          const EVP_MD *md) {
+    uint8_t mask[EVP_MAX_MD_SIZE];
+    int ok = 1;
+    switch (CCryptoBoringSSL_EVP_MD_type(md)) {
+    case NID_sha1:
+        CCRYPTOBORINGSSLSHIMS_MGF1_XOR(SHA_CTX, CCryptoBoringSSL_SHA1_Init, CCryptoBoringSSL_SHA1_Update,
+                                       CCryptoBoringSSL_SHA1_Final, SHA_DIGEST_LENGTH);
+        break;
+    case NID_sha256:
+        CCRYPTOBORINGSSLSHIMS_MGF1_XOR(SHA256_CTX, CCryptoBoringSSL_SHA256_Init, CCryptoBoringSSL_SHA256_Update,
+                                       CCryptoBoringSSL_SHA256_Final, SHA256_DIGEST_LENGTH);
+        break;
+    case NID_sha384:
+        CCRYPTOBORINGSSLSHIMS_MGF1_XOR(SHA512_CTX, CCryptoBoringSSL_SHA384_Init, CCryptoBoringSSL_SHA384_Update,
+                                       CCryptoBoringSSL_SHA384_Final, SHA384_DIGEST_LENGTH);
+        break;
+    case NID_sha512:
+        CCRYPTOBORINGSSLSHIMS_MGF1_XOR(SHA512_CTX, CCryptoBoringSSL_SHA512_Init, CCryptoBoringSSL_SHA512_Update,
+                                       CCryptoBoringSSL_SHA512_Final, SHA512_DIGEST_LENGTH);
+        break;
+    default: {
+        // Anything else goes through |EVP_MD_CTX|, still cloning the state after the seed.
+        const size_t md_len = CCryptoBoringSSL_EVP_MD_size(md);
+        EVP_MD_CTX base, block;
+        CCryptoBoringSSL_EVP_MD_CTX_init(&base);
+        CCryptoBoringSSL_EVP_MD_CTX_init(&block);
+        ok = CCryptoBoringSSL_EVP_DigestInit_ex(&base, md, NULL) &&
+             CCryptoBoringSSL_EVP_DigestUpdate(&base, seed, seed_len);
+        for (uint32_t counter = 0; ok && len > 0; counter++) {
+            uint8_t counter_bytes[4] = {(uint8_t)(counter >> 24), (uint8_t)(counter >> 16), (uint8_t)(counter >> 8),
+                                        (uint8_t)counter};
+            ok = CCryptoBoringSSL_EVP_MD_CTX_copy_ex(&block, &base) &&
+                 CCryptoBoringSSL_EVP_DigestUpdate(&block, counter_bytes, sizeof(counter_bytes)) &&
+                 CCryptoBoringSSL_EVP_DigestFinal_ex(&block, mask, NULL);
+            const size_t todo = len < md_len ? len : md_len;
+            for (size_t i = 0; ok && i < todo; i++) {
+                out[i] ^= mask[i];
+            }
+            out += todo;
+            len -= todo;
+        }
+        CCryptoBoringSSL_EVP_MD_CTX_cleanup(&block);
+        CCryptoBoringSSL_EVP_MD_CTX_cleanup(&base);
+        break;
+    }
+    }
+    CCryptoBoringSSL_OPENSSL_cleanse(mask, sizeof(mask));
+    return ok;
+}
+
+int CCryptoBoringSSLShims_PKCS1_MGF1(void *out, size_t len, const void *seed, size_t seed_len, const EVP_MD *md) {
+    memset(out, 0, len);
+    return CCryptoBoringSSLShims_mgf1_xor(out, len, seed, seed_len, md);
+}
+
+int CCryptoBoringSSLShims_RSA_padding_add_PKCS1_PSS_mgf1(const RSA *rsa, void *out, const void *digest,
+                                                         const EVP_MD *md, const EVP_MD *mgf1_md,
+                                                         int salt_len_requested) {
+    static const uint8_t zeroes[8] = {0};
+    if (mgf1_md == NULL) {
+        mgf1_md = md;
+    }
+    if (CCryptoBoringSSL_BN_is_zero(rsa->n)) {
+        return 0;
+    }
+
+    const size_t digest_len = CCryptoBoringSSL_EVP_MD_size(md);
+    const unsigned msbits = (CCryptoBoringSSL_BN_num_bits(rsa->n) - 1) & 0x7;
+    uint8_t *em = out;
+    size_t em_len = CCryptoBoringSSL_RSA_size(rsa);
+    if (msbits == 0) {
+        *em++ = 0;
+        em_len--;
+    }
+    if (em_len < digest_len + 2) {
+        return 0;
+    }
+
+    // As for |RSA_padding_add_PKCS1_PSS_mgf1|, -1 asks for a digest-length
+    // salt and -2 for the longest that fits.
+    size_t salt_len;
+    if (salt_len_requested == -1) {
+        salt_len = digest_len;
+    } else if (salt_len_requested == -2) {
+        salt_len = em_len - digest_len - 2;
+    } else if (salt_len_requested < 0) {
+        return 0;
+    } else {
+        salt_len = (size_t)salt_len_requested;
+    }
+    if (em_len - digest_len - 2 < salt_len) {
+        return 0;
+    }
+
+    // DB is zeros, a one and the salt, followed by H and 0xbc. The salt is
+    // generated in its final place, so DB can be masked in place without a
+    // separate mask buffer.
+    const size_t masked_db_len = em_len - digest_len - 1;
+    uint8_t *salt = em + masked_db_len - salt_len;
+    uint8_t *h = em + masked_db_len;
+    memset(em, 0, masked_db_len - salt_len - 1);
+    em[masked_db_len - salt_len - 1] = 0x01;
+    if (salt_len > 0 && !CCryptoBoringSSL_RAND_bytes(salt, salt_len)) {
+        return 0;
+    }
+
+    EVP_MD_CTX ctx;
+    CCryptoBoringSSL_EVP_MD_CTX_init(&ctx);
+    int ok = CCryptoBoringSSL_EVP_DigestInit_ex(&ctx, md, NULL) &&
+             CCryptoBoringSSL_EVP_DigestUpdate(&ctx, zeroes, sizeof(zeroes)) &&
+             CCryptoBoringSSL_EVP_DigestUpdate(&ctx, digest, digest_len) &&
+             CCryptoBoringSSL_EVP_DigestUpdate(&ctx, salt, salt_len) &&
+             CCryptoBoringSSL_EVP_DigestFinal_ex(&ctx, h, NULL) &&
+             CCryptoBoringSSLShims_mgf1_xor(em, masked_db_len, h, digest_len, mgf1_md);
+    CCryptoBoringSSL_EVP_MD_CTX_cleanup(&ctx);
+    if (!ok) {
+        return 0;
+    }
+
+    if (msbits) {
+        em[0] &= 0xff >> (8 - msbits);
+    }
+    em[em_len - 1] = 0xbc;
+    return 1;
+}
+
+// Writes the hash of the empty OAEP label, which is all this module uses.
+// SHA-1 and SHA-256, the digests Swift offers for OAEP, are precomputed.
+static int CCryptoBoringSSLShims_oaep_empty_label_hash(const EVP_MD *md, uint8_t *out) {
+    static const uint8_t kSHA1Empty[SHA_DIGEST_LENGTH] = {
+        0xda, 0x39, 0xa3, 0xee, 0x5e, 0x6b, 0x4b, 0x0d, 0x32, 0x55,
+        0xbf, 0xef, 0x95, 0x60, 0x18, 0x90, 0xaf, 0xd8, 0x07, 0x09,
+    };
+    static const uint8_t kSHA256Empty[SHA256_DIGEST_LENGTH] = {
+        0xe3, 0xb0, 0xc4, 0x42, 0x98, 0xfc, 0x1c, 0x14, 0x9a, 0xfb, 0xf4, 0xc8, 0x99, 0x6f, 0xb9, 0x24,
+        0x27, 0xae, 0x41, 0xe4, 0x64, 0x9b, 0x93, 0x4c, 0xa4, 0x95, 0x99, 0x1b, 0x78, 0x52, 0xb8, 0x55,
+    };
+    switch (CCryptoBoringSSL_EVP_MD_type(md)) {
+    case NID_sha1:
+        memcpy(out, kSHA1Empty, sizeof(kSHA1Empty));
+        return 1;
+    case NID_sha256:
+        memcpy(out, kSHA256Empty, sizeof(kSHA256Empty));
+        return 1;
+    default:
+        return CCryptoBoringSSL_EVP_Digest(NULL, 0, out, NULL, md, NULL);
+    }
+}
+
+// |RSA_padding_add_PKCS1_OAEP_mgf1| with an empty label and MGF1 over |md|,
+// masking in place.
+static int CCryptoBoringSSLShims_rsa_padding_add_oaep(uint8_t *to, size_t to_len, const uint8_t *from,
+                                                      size_t from_len, const EVP_MD *md) {
+    const size_t md_len = CCryptoBoringSSL_EVP_MD_size(md);
+    if (to_len < 2 * md_len + 2) {
+        return 0;
+    }
+    const size_t em_len = to_len - 1;
+    if (from_len > em_len - 2 * md_len - 1) {
+        return 0;
+    }
+
+    to[0] = 0;
+    uint8_t *seed = to + 1;
+    uint8_t *db = to + md_len + 1;
+    const size_t db_len = em_len - md_len;
+    if (!CCryptoBoringSSLShims_oaep_empty_label_hash(md, db)) {
+        return 0;
+    }
+    memset(db + md_len, 0, em_len - from_len - 2 * md_len - 1);
+    db[em_len - from_len - md_len - 1] = 0x01;
+    memcpy(db + em_len - from_len - md_len, from, from_len);
+    return CCryptoBoringSSL_RAND_bytes(seed, md_len) &&
+           CCryptoBoringSSLShims_mgf1_xor(db, db_len, seed, md_len, md) &&
+           CCryptoBoringSSLShims_mgf1_xor(seed, md_len, db, db_len, md);
+}
+
+// |RSA_padding_check_PKCS1_OAEP_mgf1| with an empty label and MGF1 over |md|.
+// |from| is unmasked in place rather than copied. As there, which check failed
+// is never revealed, and only the validity of the padding as a whole and then
+// the message length are declassified.
+static int CCryptoBoringSSLShims_rsa_padding_check_oaep(uint8_t *out, size_t *out_len, size_t max_out,
+                                                        uint8_t *from, size_t from_len, const EVP_MD *md) {
+    const size_t md_len = CCryptoBoringSSL_EVP_MD_size(md);
+    if (from_len < 2 * md_len + 2) {
+        return 0;
+    }
+
+    const size_t db_len = from_len - md_len - 1;
+    uint8_t *seed = from + 1;
+    uint8_t *db = from + 1 + md_len;
+    uint8_t label_hash[EVP_MAX_MD_SIZE];
+    if (!CCryptoBoringSSLShims_mgf1_xor(seed, md_len, db, db_len, md) ||
+        !CCryptoBoringSSLShims_mgf1_xor(db, db_len, seed, md_len, md) ||
+        !CCryptoBoringSSLShims_oaep_empty_label_hash(md, label_hash)) {
+        return 0;
+    }
+
+    crypto_word_t bad = ~constant_time_is_zero_w(CCryptoBoringSSL_CRYPTO_memcmp(db, label_hash, md_len));
+    bad |= ~constant_time_is_zero_w(from[0]);
+
+    crypto_word_t looking_for_one_byte = CONSTTIME_TRUE_W;
+    size_t one_index = 0;
+    for (size_t i = md_len; i < db_len; i++) {
+        crypto_word_t equals1 = constant_time_eq_w(db[i], 1);
+        crypto_word_t equals0 = constant_time_eq_w(db[i], 0);
+        one_index = constant_time_select_w(looking_for_one_byte & equals1, i, one_index);
+        looking_for_one_byte = constant_time_select_w(equals1, 0, looking_for_one_byte);
+        bad |= looking_for_one_byte & ~equals0;
+    }
+    bad |= looking_for_one_byte;
+
+    if (constant_time_declassify_w(bad)) {
+        return 0;
+    }
+
+    one_index = constant_time_declassify_w(one_index) + 1;
+    const size_t message_len = db_len - one_index;
+    if (max_out < message_len) {
+        return 0;
+    }
+    memcpy(out, db + one_index, message_len);
+    *out_len = message_len;
+    return 1;
+}
+
+int CCryptoBoringSSLShims_RSA_encrypt_oaep(RSA *rsa, size_t *out_len, void *out, size_t max_out,
+                                           const void *in, size_t in_len, const EVP_MD *md) {
+    const size_t rsa_size = CCryptoBoringSSL_RSA_size(rsa);
+    uint8_t *padded = OPENSSL_malloc(rsa_size);
+    int ret = padded != NULL &&
+              CCryptoBoringSSLShims_rsa_padding_add_oaep(padded, rsa_size, in, in_len, md) &&
+              CCryptoBoringSSL_RSA_encrypt(rsa, out_len, out, max_out, padded, rsa_size, RSA_NO_PADDING);
+    OPENSSL_free(padded);
+    return ret;
+}
+
+int CCryptoBoringSSLShims_RSA_decrypt_oaep(RSA *rsa, size_t *out_len, void *out, size_t max_out,
+                                           const void *in, size_t in_len, const EVP_MD *md) {
+    const size_t rsa_size = CCryptoBoringSSL_RSA_size(rsa);
+    uint8_t *padded = OPENSSL_malloc(rsa_size);
+    size_t padded_len;
+    int ret = padded != NULL &&
+              CCryptoBoringSSL_RSA_decrypt(rsa, &padded_len, padded, rsa_size, in, in_len, RSA_NO_PADDING) &&
+              CCryptoBoringSSLShims_rsa_padding_check_oaep(out, out_len, max_out, padded, padded_len, md);
+    OPENSSL_free(padded);
+    return ret;
+}
+
+// MARK:- Batch RSA verification
+
+// Computes out = in^65537 mod n as sixteen Montgomery squarings and one
+// multiplication. The final multiplication by the non-Montgomery |in| also
+// takes the result out of Montgomery form, so no conversion is needed.
+static int CCryptoBoringSSLShims_rsa_pow_f4(BIGNUM *out, const BIGNUM *in, const BN_MONT_CTX *mont,
+                                            BN_CTX *ctx) {
+    if (!CCryptoBoringSSL_BN_to_montgomery(out, in, mont, ctx)) {
+        return 0;
+    }
+    for (int i = 0; i < 16; i++) {
+        if (!CCryptoBoringSSL_BN_mod_mul_montgomery(out, out, out, mont, ctx)) {
+            return 0;
+        }
+    }
+    return CCryptoBoringSSL_BN_mod_mul_montgomery(out, out, in, mont, ctx);
+}
+
+// The EMSA-PSS-VERIFY steps of |RSA_verify_PKCS1_PSS_mgf1|, specialised to
+// MGF1 with |md| and a digest-length salt, with rejections reported only
+// through the return value. |db| is scratch space of at least |em_len| bytes.
+static int CCryptoBoringSSLShims_rsa_pss_verify_quiet(const RSA *rsa, const uint8_t *digest, const EVP_MD *md,
+                                                      const uint8_t *em, size_t em_len, uint8_t *db) {
+    static const uint8_t zeroes[8] = {0};
+    const size_t digest_len = CCryptoBoringSSL_EVP_MD_size(md);
+    const unsigned msbits = (CCryptoBoringSSL_BN_num_bits(rsa->n) - 1) & 0x7;
+    if (em[0] & (0xff << msbits)) {
+        return 0;
+    }
+    if (msbits == 0) {
+        em++;
+        em_len--;
+    }
+    if (em_len < 2 * digest_len + 2 || em[em_len - 1] != 0xbc) {
+        return 0;
+    }
+
+    const size_t masked_db_len = em_len - digest_len - 1;
+    const uint8_t *h = em + masked_db_len;
+    memcpy(db, em, masked_db_len);
+    if (!CCryptoBoringSSLShims_mgf1_xor(db, masked_db_len, h, digest_len, md)) {
+        return 0;
+    }
+    if (msbits) {
+        db[0] &= 0xff >> (8 - msbits);
+    }
+
+    // DB must be zeros, a one, then exactly |digest_len| bytes of salt.
+    const size_t salt_start = masked_db_len - digest_len;
+    for (size_t i = 0; i < salt_start - 1; i++) {
+        if (db[i] != 0) {
+            return 0;
+        }
+    }
+    if (db[salt_start - 1] != 0x01) {
+        return 0;
+    }
+
+    uint8_t expected[EVP_MAX_MD_SIZE];
+    EVP_MD_CTX ctx;
+    CCryptoBoringSSL_EVP_MD_CTX_init(&ctx);
+    int ok = CCryptoBoringSSL_EVP_DigestInit_ex(&ctx, md, NULL) &&
+             CCryptoBoringSSL_EVP_DigestUpdate(&ctx, zeroes, sizeof(zeroes)) &&
+             CCryptoBoringSSL_EVP_DigestUpdate(&ctx, digest, digest_len) &&
+             CCryptoBoringSSL_EVP_DigestUpdate(&ctx, db + salt_start, digest_len) &&
+             CCryptoBoringSSL_EVP_DigestFinal_ex(&ctx, expected, NULL) &&
+             CCryptoBoringSSL_CRYPTO_memcmp(expected, h, digest_len) == 0;
+    CCryptoBoringSSL_EVP_MD_CTX_cleanup(&ctx);
+    return ok;
+}
+
+void CCryptoBoringSSLShims_RSA_verify_batch(RSA *rsa, int hash_nid, const EVP_MD *pss_md,
+                                            const void *digests, size_t digest_len,
+                                            const void *signatures, size_t count, uint8_t *out_valid) {
+    memset(out_valid, 0, count);
+    if (count == 0) {
+        return;
+    }
+    const size_t rsa_size = CCryptoBoringSSL_RSA_size(rsa);
+    uint8_t *encoded = OPENSSL_malloc(rsa_size);
+    uint8_t *expected = OPENSSL_malloc(rsa_size);
+    BN_CTX *ctx = CCryptoBoringSSL_BN_CTX_new();
+    if (encoded == NULL || expected == NULL || ctx == NULL || !CCryptoBoringSSL_rsa_check_public_key(rsa) ||
+        !CCryptoBoringSSL_BN_MONT_CTX_set_locked(&rsa->mont_n, &rsa->lock, rsa->n, ctx)) {
+        goto err;
+    }
+    CCryptoBoringSSL_BN_CTX_start(ctx);
+    BIGNUM *s = CCryptoBoringSSL_BN_CTX_get(ctx);
+    BIGNUM *m = CCryptoBoringSSL_BN_CTX_get(ctx);
+    if (m == NULL) {
+        CCryptoBoringSSL_BN_CTX_end(ctx);
+        goto err;
+    }
+
+    // The key and the padding are shared by the whole batch, so only the
+    // exponentiation and the final comparison are done per signature.
+    const int f4 = CCryptoBoringSSL_BN_is_word(rsa->e, RSA_F4);
+    const uint8_t *digest = digests;
+    const uint8_t *signature = signatures;
+    for (size_t i = 0; i < count; i++, digest += digest_len, signature += rsa_size) {
+        if (CCryptoBoringSSL_BN_bin2bn(signature, rsa_size, s) == NULL ||
+            CCryptoBoringSSL_BN_ucmp(s, rsa->n) >= 0 ||
+            !(f4 ? CCryptoBoringSSLShims_rsa_pow_f4(m, s, rsa->mont_n, ctx)
+                 : CCryptoBoringSSL_BN_mod_exp_mont(m, s, rsa->e, &rsa->mont_n->N, ctx, rsa->mont_n)) ||
+            !CCryptoBoringSSL_BN_bn2bin_padded(encoded, rsa_size, m)) {
+            continue;
+        }
+
+        if (pss_md != NULL) {
+            out_valid[i] = digest_len == CCryptoBoringSSL_EVP_MD_size(pss_md) &&
+                           CCryptoBoringSSLShims_rsa_pss_verify_quiet(rsa, digest, pss_md, encoded, rsa_size,
+                                                                      expected);
+        } else {
+            uint8_t *signed_msg = NULL;
+            size_t signed_msg_len = 0;
+            int signed_msg_is_alloced = 0;
+            if (CCryptoBoringSSL_RSA_add_pkcs1_prefix(&signed_msg, &signed_msg_len, &signed_msg_is_alloced,
+                                                      hash_nid, digest, digest_len) &&
+                CCryptoBoringSSL_RSA_padding_add_PKCS1_type_1(expected, rsa_size, signed_msg, signed_msg_len)) {
+                out_valid[i] = CCryptoBoringSSL_CRYPTO_memcmp(expected, encoded, rsa_size) == 0;
+            }
+            if (signed_msg_is_alloced) {
+                OPENSSL_free(signed_msg);
+            }
+        }
+    }
+    CCryptoBoringSSL_BN_CTX_end(ctx);
+
+err:
+    CCryptoBoringSSL_BN_CTX_free(ctx);
+    OPENSSL_free(expected);
+    OPENSSL_free(encoded);
+}
+
+int CCryptoBoringSSLShims_RSA_verify_quiet(RSA *rsa, int hash_nid, const EVP_MD *pss_md,
+                                           const void *digest, size_t digest_len,
+                                           const void *signature, size_t signature_len) {
+    if (signature_len != CCryptoBoringSSL_RSA_size(rsa)) {
+        return 0;
+    }
+    uint8_t valid;
+    CCRYPTOBORINGSSLSHIMS_TRACE_ENTRY(rsa_verify, pss_md != NULL ? CCryptoBoringSSL_EVP_MD_type(pss_md) : hash_nid,
+                                      CCryptoBoringSSL_RSA_bits(rsa), digest_len);
+    CCryptoBoringSSLShims_RSA_verify_batch(rsa, hash_nid, pss_md, digest, digest_len, signature, 1, &valid);
+    CCRYPTOBORINGSSLSHIMS_TRACE_RETURN(rsa_verify, pss_md != NULL ? CCryptoBoringSSL_EVP_MD_type(pss_md) : hash_nid,
+                                       CCryptoBoringSSL_RSA_bits(rsa), digest_len, valid);
+    return valid;
+}
+
+// MARK:- SHA-2 midstate
+
+_Static_assert(sizeof(SHA512_CTX) <= 27 * sizeof(uint64_t), "SHA-2 state does not fit the Swift state storage");
+
+static void CCryptoBoringSSLShims_store_be(uint8_t *out, uint64_t value, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        out[len - 1 - i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static uint64_t CCryptoBoringSSLShims_load_be(const uint8_t *in, size_t len) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < len; i++) {
+        value = (value << 8) | in[i];
+    }
+    return value;
+}
+
+size_t CCryptoBoringSSLShims_SHA2_export_midstate(int nid, const void *ctx, void *out, size_t max_out) {
+    uint8_t *bytes = out;
+    if (nid == NID_sha256) {
+        const SHA256_CTX *sha = ctx;
+        size_t len = 32 + 8 + sha->num;
+        if (max_out < len) {
+            return 0;
+        }
+        for (size_t i = 0; i < 8; i++) {
+            CCryptoBoringSSLShims_store_be(bytes + 4 * i, sha->h[i], 4);
+        }
+        CCryptoBoringSSLShims_store_be(bytes + 32, ((uint64_t)sha->Nh << 32) | sha->Nl, 8);
+        memcpy(bytes + 40, sha->data, sha->num);
+        return len;
+    }
+    if (nid == NID_sha384 || nid == NID_sha512) {
+        const SHA512_CTX *sha = ctx;
+        size_t len = 64 + 16 + sha->num;
+        if (max_out < len) {
+            return 0;
+        }
+        for (size_t i = 0; i < 8; i++) {
+            CCryptoBoringSSLShims_store_be(bytes + 8 * i, sha->h[i], 8);
+        }
+        CCryptoBoringSSLShims_store_be(bytes + 64, sha->Nh, 8);
+        CCryptoBoringSSLShims_store_be(bytes + 72, sha->Nl, 8);
+        memcpy(bytes + 80, sha->p, sha->num);
+        return len;
+    }
+    return 0;
+}
+
+int CCryptoBoringSSLShims_SHA2_import_midstate(int nid, void *ctx, const void *in, size_t in_len) {
+    const uint8_t *bytes = in;
+    if (nid == NID_sha256) {
+        if (in_len < 40 || in_len - 40 >= SHA256_CBLOCK) {
+            return 0;
+        }
+        uint64_t bits = CCryptoBoringSSLShims_load_be(bytes + 32, 8);
+        size_t num = in_len - 40;
+        // The buffered bytes must be exactly the tail of the input counted so far.
+        if (bits % 8 != 0 || (bits / 8) % SHA256_CBLOCK != num) {
+            return 0;
+        }
+        SHA256_CTX *sha = ctx;
+        CCryptoBoringSSL_SHA256_Init(sha);
+        for (size_t i = 0; i < 8; i++) {
+            sha->h[i] = (uint32_t)CCryptoBoringSSLShims_load_be(bytes + 4 * i, 4);
+        }
+        sha->Nh = (uint32_t)(bits >> 32);
+        sha->Nl = (uint32_t)bits;
+        memcpy(sha->data, bytes + 40, num);
+        sha->num = (unsigned)num;
+        return 1;
+    }
+    if (nid == NID_sha384 || nid == NID_sha512) {
+        if (in_len < 80 || in_len - 80 >= SHA512_CBLOCK) {
+            return 0;
+        }
+        uint64_t bits_high = CCryptoBoringSSLShims_load_be(bytes + 64, 8);
+        uint64_t bits_low = CCryptoBoringSSLShims_load_be(bytes + 72, 8);
+        size_t num = in_len - 80;
+        if (bits_low % 8 != 0 || (bits_low / 8) % SHA512_CBLOCK != num) {
+            return 0;
+        }
+        SHA512_CTX *sha = ctx;
+        if (nid == NID_sha384) {
+            CCryptoBoringSSL_SHA384_Init(sha);
+        } else {
+            CCryptoBoringSSL_SHA512_Init(sha);
+        }
+        for (size_t i = 0; i < 8; i++) {
+            sha->h[i] = CCryptoBoringSSLShims_load_be(bytes + 8 * i, 8);
+        }
+        sha->Nh = bits_high;
+        sha->Nl = bits_low;
+        memcpy(sha->p, bytes + 80, num);
+        sha->num = (unsigned)num;
+        return 1;
+    }
+    return 0;
+}
+
+// MARK:- SHA-512/224
+
+void CCryptoBoringSSLShims_SHA512_224_Init(SHA512_CTX *sha) {
+    // Set up SHA-512 for its length and block bookkeeping, which the truncated
+    // variants share, and then swap in the SHA-512/224 initial hash value.
+    CCryptoBoringSSL_SHA512_Init(sha);
+    static const uint64_t kInitialHash[8] = {
+        UINT64_C(0x8c3d37c819544da2), UINT64_C(0x73e1996689dcd4d6), UINT64_C(0x1dfab7ae32ff9c82),
+        UINT64_C(0x679dd514582f9fcf), UINT64_C(0x0f6d2b697bd44da8), UINT64_C(0x77e36f7304c48942),
+        UINT64_C(0x3f9d85a86a1d36c8), UINT64_C(0x1112e6ad91d692a1),
+    };
+    OPENSSL_memcpy(sha->h, kInitialHash, sizeof(kInitialHash));
+}
+
+void CCryptoBoringSSLShims_SHA512_224_Final(void *out, SHA512_CTX *sha) {
+    // |SHA512_Final| only writes whole words, so finish into a full-size buffer.
+    uint8_t digest[SHA512_DIGEST_LENGTH];
+    CCryptoBoringSSL_SHA512_Final(digest, sha);
+    OPENSSL_memcpy(out, digest, CCryptoBoringSSLShims_SHA512_224_DIGEST_LENGTH);
+    CCryptoBoringSSL_OPENSSL_cleanse(digest, sizeof(digest));
+    CCryptoBoringSSL_OPENSSL_cleanse(sha, sizeof(*sha));
+}
+
+// MARK:- ANSI X9.63 KDF
+
+int CCryptoBoringSSLShims_X963_KDF(void *out, size_t out_len, const EVP_MD *md,
+                                   const void *secret, size_t secret_len,
+                                   const void *shared_info, size_t shared_info_len) {
+    size_t md_len = CCryptoBoringSSL_EVP_MD_size(md);
+    // SEC 1 requires keydatalen < hashlen × (2³² − 1).
+    if ((uint64_t)out_len >= (uint64_t)md_len * UINT32_MAX) {
+        return 0;
+    }
+
+    // Every block hashes Z first, so Z is absorbed once. Whole blocks of it are compressed here and only the
+    // remainder is buffered; each counter then starts from a copy of this state.
+    EVP_MD_CTX base, block;
+    CCryptoBoringSSL_EVP_MD_CTX_init(&base);
+    CCryptoBoringSSL_EVP_MD_CTX_init(&block);
+    uint8_t partial[EVP_MAX_MD_SIZE];
+    int ok = CCryptoBoringSSL_EVP_DigestInit_ex(&base, md, NULL) &&
+             CCryptoBoringSSL_EVP_DigestUpdate(&base, secret, secret_len);
+
+    uint8_t *bytes = out;
+    for (uint32_t counter = 1; ok && out_len > 0; counter++) {
+        uint8_t counter_bytes[4] = {(uint8_t)(counter >> 24), (uint8_t)(counter >> 16), (uint8_t)(counter >> 8), (uint8_t)counter};
+        // Whole digests go straight to the output; only a trailing partial one needs the temporary.
+        uint8_t *digest = out_len >= md_len ? bytes : partial;
+        ok = CCryptoBoringSSL_EVP_MD_CTX_copy_ex(&block, &base) &&
+             CCryptoBoringSSL_EVP_DigestUpdate(&block, counter_bytes, sizeof(counter_bytes)) &&
+             CCryptoBoringSSL_EVP_DigestUpdate(&block, shared_info, shared_info_len) &&
+             CCryptoBoringSSL_EVP_DigestFinal_ex(&block, digest, NULL);
+        size_t todo = out_len < md_len ? out_len : md_len;
+        if (ok && digest == partial) {
+            memcpy(bytes, partial, todo);
+        }
+        bytes += todo;
+        out_len -= todo;
+    }
+
+    CCryptoBoringSSL_OPENSSL_cleanse(partial, sizeof(partial));
+    CCryptoBoringSSL_EVP_MD_CTX_cleanup(&block);
+    CCryptoBoringSSL_EVP_MD_CTX_cleanup(&base);
+    return ok;
+}
+
+// MARK:- BLAKE2b
+
+#if defined(OPENSSL_X86_64) && (defined(__GNUC__) || defined(__clang__))
+#define CCRYPTOBORINGSSLSHIMS_BLAKE2B_AVX2 1
+#include <immintrin.h>
+#elif defined(CRYPTO_BORINGSSL_ARM_KERNELS) && defined(OPENSSL_AARCH64) && defined(__ARM_NEON)
+// Not yet run on AArch64 in CI, so opt-in; the portable compression is used
+// otherwise.
+#define CCRYPTOBORINGSSLSHIMS_BLAKE2B_NEON 1
+#include <arm_neon.h>
+#endif
+
+// https://tools.ietf.org/html/rfc7693#section-2.6
+static const uint64_t CCryptoBoringSSLShims_blake2b_iv[8] = {
+    UINT64_C(0x6a09e667f3bcc908), UINT64_C(0xbb67ae8584caa73b),
+    UINT64_C(0x3c6ef372fe94f82b), UINT64_C(0xa54ff53a5f1d36f1),
+    UINT64_C(0x510e527fade682d1), UINT64_C(0x9b05688c2b3e6c1f),
+    UINT64_C(0x1f83d9abfb41bd6b), UINT64_C(0x5be0cd19137e2179),
+};
+
+// https://tools.ietf.org/html/rfc7693#section-2.7
+static const uint8_t CCryptoBoringSSLShims_blake2b_sigma[10][16] = {
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+    {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3},
+    {11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4},
+    {7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8},
+    {9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13},
+    {2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9},
+    {12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11},
+    {13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10},
+    {6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5},
+    {10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0},
+};
+
+#define CCRYPTOBORINGSSLSHIMS_BLAKE2B_G(a, b, c, d, x, y) \
+    do {                                                  \
+        v[a] = v[a] + v[b] + (x);                         \
+        v[d] = CRYPTO_rotr_u64(v[d] ^ v[a], 32);          \
+        v[c] = v[c] + v[d];                               \
+        v[b] = CRYPTO_rotr_u64(v[b] ^ v[c], 24);          \
+        v[a] = v[a] + v[b] + (y);                         \
+        v[d] = CRYPTO_rotr_u64(v[d] ^ v[a], 16);          \
+        v[c] = v[c] + v[d];                               \
+        v[b] = CRYPTO_rotr_u64(v[b] ^ v[c], 63);          \
+    } while (0)
+
+// The compression function F of RFC 7693, section 3.2, one word at a time.
+// |flags| holds the counter and finalization words t0, t1 and f0.
+static void CCryptoBoringSSLShims_blake2b_compress_scalar(uint64_t h[8], const uint64_t m[16],
+                                                          const uint64_t flags[3]) {
+    uint64_t v[16];
+    memcpy(v, h, 8 * sizeof(uint64_t));
+    memcpy(v + 8, CCryptoBoringSSLShims_blake2b_iv, sizeof(CCryptoBoringSSLShims_blake2b_iv));
+    v[12] ^= flags[0];
+    v[13] ^= flags[1];
+    v[14] ^= flags[2];
+
+    for (int round = 0; round < 12; round++) {
+        const uint8_t *s = CCryptoBoringSSLShims_blake2b_sigma[round % 10];
+        CCRYPTOBORINGSSLSHIMS_BLAKE2B_G(0, 4, 8, 12, m[s[0]], m[s[1]]);
+        CCRYPTOBORINGSSLSHIMS_BLAKE2B_G(1, 5, 9, 13, m[s[2]], m[s[3]]);
+        CCRYPTOBORINGSSLSHIMS_BLAKE2B_G(2, 6, 10, 14, m[s[4]], m[s[5]]);
+        CCRYPTOBORINGSSLSHIMS_BLAKE2B_G(3, 7, 11, 15, m[s[6]], m[s[7]]);
+        CCRYPTOBORINGSSLSHIMS_BLAKE2B_G(0, 5, 10, 15, m[s[8]], m[s[9]]);
+        CCRYPTOBORINGSSLSHIMS_BLAKE2B_G(1, 6, 11, 12, m[s[10]], m[s[11]]);
+        CCRYPTOBORINGSSLSHIMS_BLAKE2B_G(2, 7, 8, 13, m[s[12]], m[s[13]]);
+        CCRYPTOBORINGSSLSHIMS_BLAKE2B_G(3, 4, 9, 14, m[s[14]], m[s[15]]);
+    }
+
+    for (size_t i = 0; i < 8; i++) {
+        h[i] ^= v[i] ^ v[i + 8];
+    }
+}
+
+#if defined(CCRYPTOBORINGSSLSHIMS_BLAKE2B_AVX2)
+// The same compression with each row of the 4x4 state in one 256-bit
+// register, so every step of G runs on four columns (or diagonals) at once.
+__attribute__((target("avx2")))
+static void CCryptoBoringSSLShims_blake2b_compress_avx2(uint64_t h[8], const uint64_t m[16],
+                                                        const uint64_t flags[3]) {
+    const __m256i rotr24 = _mm256_setr_epi8(3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10,
+                                            3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10);
+    const __m256i rotr16 = _mm256_setr_epi8(2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9,
+                                            2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9);
+    const __m256i h0 = _mm256_loadu_si256((const __m256i *)h);
+    const __m256i h1 = _mm256_loadu_si256((const __m256i *)(h + 4));
+    __m256i row1 = h0;
+    __m256i row2 = h1;
+    __m256i row3 = _mm256_loadu_si256((const __m256i *)CCryptoBoringSSLShims_blake2b_iv);
+    __m256i row4 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(CCryptoBoringSSLShims_blake2b_iv + 4)),
+                                    _mm256_setr_epi64x((long long)flags[0], (long long)flags[1],
+                                                       (long long)flags[2], 0));
+
+#define CCRYPTOBORINGSSLSHIMS_BLAKE2B_G_AVX2(x, y)                                                      \
+    do {                                                                                                \
+        row1 = _mm256_add_epi64(_mm256_add_epi64(row1, row2), (x));                                     \
+        row4 = _mm256_shuffle_epi32(_mm256_xor_si256(row4, row1), _MM_SHUFFLE(2, 3, 0, 1));             \
+        row3 = _mm256_add_epi64(row3, row4);                                                            \
+        row2 = _mm256_shuffle_epi8(_mm256_xor_si256(row2, row3), rotr24);                               \
+        row1 = _mm256_add_epi64(_mm256_add_epi64(row1, row2), (y));                                     \
+        row4 = _mm256_shuffle_epi8(_mm256_xor_si256(row4, row1), rotr16);                               \
+        row3 = _mm256_add_epi64(row3, row4);                                                            \
+        row2 = _mm256_xor_si256(row2, row3);                                                            \
+        row2 = _mm256_or_si256(_mm256_srli_epi64(row2, 63), _mm256_add_epi64(row2, row2));              \
+    } while (0)
+#define CCRYPTOBORINGSSLSHIMS_BLAKE2B_LOAD_AVX2(i0, i1, i2, i3) \
+    _mm256_setr_epi64x((long long)m[s[i0]], (long long)m[s[i1]], (long long)m[s[i2]], (long long)m[s[i3]])
+
+    for (int round = 0; round < 12; round++) {
+        const uint8_t *s = CCryptoBoringSSLShims_blake2b_sigma[round % 10];
+        // Columns.
+        CCRYPTOBORINGSSLSHIMS_BLAKE2B_G_AVX2(CCRYPTOBORINGSSLSHIMS_BLAKE2B_LOAD_AVX2(0, 2, 4, 6),
+                                             CCRYPTOBORINGSSLSHIMS_BLAKE2B_LOAD_AVX2(1, 3, 5, 7));
+        // Rotate rows 2-4 so that the diagonals line up as columns.
+        row2 = _mm256_permute4x64_epi64(row2, _MM_SHUFFLE(0, 3, 2, 1));
+        row3 = _mm256_permute4x64_epi64(row3, _MM_SHUFFLE(1, 0, 3, 2));
+        row4 = _mm256_permute4x64_epi64(row4, _MM_SHUFFLE(2, 1, 0, 3));
+        CCRYPTOBORINGSSLSHIMS_BLAKE2B_G_AVX2(CCRYPTOBORINGSSLSHIMS_BLAKE2B_LOAD_AVX2(8, 10, 12, 14),
+                                             CCRYPTOBORINGSSLSHIMS_BLAKE2B_LOAD_AVX2(9, 11, 13, 15));
+        row2 = _mm256_permute4x64_epi64(row2, _MM_SHUFFLE(2, 1, 0, 3));
+        row3 = _mm256_permute4x64_epi64(row3, _MM_SHUFFLE(1, 0, 3, 2));
+        row4 = _mm256_permute4x64_epi64(row4, _MM_SHUFFLE(0, 3, 2, 1));
+    }
+
+#undef CCRYPTOBORINGSSLSHIMS_BLAKE2B_LOAD_AVX2
+#undef CCRYPTOBORINGSSLSHIMS_BLAKE2B_G_AVX2
+
+    _mm256_storeu_si256((__m256i *)h, _mm256_xor_si256(h0, _mm256_xor_si256(row1, row3)));
+    _mm256_storeu_si256((__m256i *)(h + 4), _mm256_xor_si256(h1, _mm256_xor_si256(row2, row4)));
+}
+#endif
+
+#if defined(CCRYPTOBORINGSSLSHIMS_BLAKE2B_NEON)
+#define CCRYPTOBORINGSSLSHIMS_BLAKE2B_ROTR_NEON(x, n) vorrq_u64(vshrq_n_u64((x), (n)), vshlq_n_u64((x), 64 - (n)))
+
+// The same compression with each row of the 4x4 state split across two
+// 128-bit registers.
+static void CCryptoBoringSSLShims_blake2b_compress_neon(uint64_t h[8], const uint64_t m[16],
+                                                        const uint64_t flags[3]) {
+    const uint64_t counter[4] = {flags[0], flags[1], flags[2], 0};
+    uint64x2_t row1l = vld1q_u64(h), row1h = vld1q_u64(h + 2);
+    uint64x2_t row2l = vld1q_u64(h + 4), row2h = vld1q_u64(h + 6);
+    uint64x2_t row3l = vld1q_u64(CCryptoBoringSSLShims_blake2b_iv);
+    uint64x2_t row3h = vld1q_u64(CCryptoBoringSSLShims_blake2b_iv + 2);
+    uint64x2_t row4l = veorq_u64(vld1q_u64(CCryptoBoringSSLShims_blake2b_iv + 4), vld1q_u64(counter));
+    uint64x2_t row4h = veorq_u64(vld1q_u64(CCryptoBoringSSLShims_blake2b_iv + 6), vld1q_u64(counter + 2));
+    uint64x2_t t0, t1;
+
+#define CCRYPTOBORINGSSLSHIMS_BLAKE2B_HALF_NEON(xl, xh, r1, r2)                                          \
+    do {                                                                                                \
+        row1l = vaddq_u64(vaddq_u64(row1l, row2l), (xl));                                               \
+        row1h = vaddq_u64(vaddq_u64(row1h, row2h), (xh));                                               \
+        row4l = CCRYPTOBORINGSSLSHIMS_BLAKE2B_ROTR_NEON(veorq_u64(row4l, row1l), r1);                   \
+        row4h = CCRYPTOBORINGSSLSHIMS_BLAKE2B_ROTR_NEON(veorq_u64(row4h, row1h), r1);                   \
+        row3l = vaddq_u64(row3l, row4l);                                                                \
+        row3h = vaddq_u64(row3h, row4h);                                                                \
+        row2l = CCRYPTOBORINGSSLSHIMS_BLAKE2B_ROTR_NEON(veorq_u64(row2l, row3l), r2);                   \
+        row2h = CCRYPTOBORINGSSLSHIMS_BLAKE2B_ROTR_NEON(veorq_u64(row2h, row3h), r2);                   \
+    } while (0)
+#define CCRYPTOBORINGSSLSHIMS_BLAKE2B_LOAD_NEON(i0, i1) vcombine_u64(vcreate_u64(m[s[i0]]), vcreate_u64(m[s[i1]]))
+
+    for (int round = 0; round < 12; round++) {
+        const uint8_t *s = CCryptoBoringSSLShims_blake2b_sigma[round % 10];
+        CCRYPTOBORINGSSLSHIMS_BLAKE2B_HALF_NEON(CCRYPTOBORINGSSLSHIMS_BLAKE2B_LOAD_NEON(0, 2),
+                                                CCRYPTOBORINGSSLSHIMS_BLAKE2B_LOAD_NEON(4, 6), 32, 24);
+        CCRYPTOBORINGSSLSHIMS_BLAKE2B_HALF_NEON(CCRYPTOBORINGSSLSHIMS_BLAKE2B_LOAD_NEON(1, 3),
+                                                CCRYPTOBORINGSSLSHIMS_BLAKE2B_LOAD_NEON(5, 7), 16, 63);
+        // Rotate rows 2-4 so that the diagonals line up as columns.
+        t0 = vextq_u64(row2l, row2h, 1);
+        t1 = vextq_u64(row2h, row2l, 1);
+        row2l = t0;
+        row2h = t1;
+        t0 = row3l;
+        row3l = row3h;
+        row3h = t0;
+        t0 = vextq_u64(row4h, row4l, 1);
+        t1 = vextq_u64(row4l, row4h, 1);
+        row4l = t0;
+        row4h = t1;
+        CCRYPTOBORINGSSLSHIMS_BLAKE2B_HALF_NEON(CCRYPTOBORINGSSLSHIMS_BLAKE2B_LOAD_NEON(8, 10),
+                                                CCRYPTOBORINGSSLSHIMS_BLAKE2B_LOAD_NEON(12, 14), 32, 24);
+        CCRYPTOBORINGSSLSHIMS_BLAKE2B_HALF_NEON(CCRYPTOBORINGSSLSHIMS_BLAKE2B_LOAD_NEON(9, 11),
+                                                CCRYPTOBORINGSSLSHIMS_BLAKE2B_LOAD_NEON(13, 15), 16, 63);
+        t0 = vextq_u64(row2h, row2l, 1);
+        t1 = vextq_u64(row2l, row2h, 1);
+        row2l = t0;
+        row2h = t1;
+        t0 = row3l;
+        row3l = row3h;
+        row3h = t0;
+        t0 = vextq_u64(row4l, row4h, 1);
+        t1 = vextq_u64(row4h, row4l, 1);
+        row4l = t0;
+        row4h = t1;
+    }
+
+#undef CCRYPTOBORINGSSLSHIMS_BLAKE2B_LOAD_NEON
+#undef CCRYPTOBORINGSSLSHIMS_BLAKE2B_HALF_NEON
+
+    vst1q_u64(h, veorq_u64(vld1q_u64(h), veorq_u64(row1l, row3l)));
+    vst1q_u64(h + 2, veorq_u64(vld1q_u64(h + 2), veorq_u64(row1h, row3h)));
+    vst1q_u64(h + 4, veorq_u64(vld1q_u64(h + 4), veorq_u64(row2l, row4l)));
+    vst1q_u64(h + 6, veorq_u64(vld1q_u64(h + 6), veorq_u64(row2h, row4h)));
+}
+#undef CCRYPTOBORINGSSLSHIMS_BLAKE2B_ROTR_NEON
+#endif
+
+static void CCryptoBoringSSLShims_blake2b_compress(CCryptoBoringSSLShims_blake2b_ctx *ctx, const uint8_t *block,
+                                                   size_t num_bytes, int is_final_block) {
+    ctx->t[0] += num_bytes;
+    if (ctx->t[0] < num_bytes) {
+        ctx->t[1]++;
+    }
+    const uint64_t flags[3] = {ctx->t[0], ctx->t[1], is_final_block ? ~UINT64_C(0) : 0};
+
+    uint64_t m[16];
+    for (size_t i = 0; i < 16; i++) {
+        m[i] = CRYPTO_load_u64_le(block + 8 * i);
+    }
+
+#if defined(CCRYPTOBORINGSSLSHIMS_BLAKE2B_AVX2)
+    if (CRYPTO_is_AVX2_capable()) {
+        CCryptoBoringSSLShims_blake2b_compress_avx2(ctx->h, m, flags);
+        return;
+    }
+#elif defined(CCRYPTOBORINGSSLSHIMS_BLAKE2B_NEON)
+    CCryptoBoringSSLShims_blake2b_compress_neon(ctx->h, m, flags);
+    return;
+#endif
+    CCryptoBoringSSLShims_blake2b_compress_scalar(ctx->h, m, flags);
+}
+
+int CCryptoBoringSSLShims_blake2b_init(CCryptoBoringSSLShims_blake2b_ctx *ctx, size_t out_len,
+                                       const void *key, size_t key_len) {
+    if (out_len == 0 || out_len > CCryptoBoringSSLShims_BLAKE2B_MAX_BYTES ||
+        key_len > CCryptoBoringSSLShims_BLAKE2B_MAX_BYTES) {
+        return 0;
+    }
+
+    memset(ctx, 0, sizeof(*ctx));
+    memcpy(ctx->h, CCryptoBoringSSLShims_blake2b_iv, sizeof(ctx->h));
+    // https://tools.ietf.org/html/rfc7693#section-2.5: fanout and depth of
+    // one, the key length and the digest length.
+    ctx->h[0] ^= 0x01010000 | ((uint64_t)key_len << 8) | out_len;
+    ctx->out_len = out_len;
+
+    // A key is absorbed as a full block of its own.
+    if (key_len > 0) {
+        memcpy(ctx->block, key, key_len);
+        ctx->block_used = CCryptoBoringSSLShims_BLAKE2B_BLOCK_BYTES;
+    }
+    return 1;
+}
+
+void CCryptoBoringSSLShims_blake2b_update(CCryptoBoringSSLShims_blake2b_ctx *ctx, const void *in, size_t in_len) {
+    const uint8_t *data = in;
+    // The last block must be held back until finalization, since it is
+    // compressed with the final-block flag, so only compress a full buffer once
+    // more input arrives.
+    while (in_len > 0) {
+        if (ctx->block_used == CCryptoBoringSSLShims_BLAKE2B_BLOCK_BYTES) {
+            CCryptoBoringSSLShims_blake2b_compress(ctx, ctx->block, CCryptoBoringSSLShims_BLAKE2B_BLOCK_BYTES, 0);
+            ctx->block_used = 0;
+        }
+        if (ctx->block_used == 0) {
+            while (in_len > CCryptoBoringSSLShims_BLAKE2B_BLOCK_BYTES) {
+                CCryptoBoringSSLShims_blake2b_compress(ctx, data, CCryptoBoringSSLShims_BLAKE2B_BLOCK_BYTES, 0);
+                data += CCryptoBoringSSLShims_BLAKE2B_BLOCK_BYTES;
+                in_len -= CCryptoBoringSSLShims_BLAKE2B_BLOCK_BYTES;
+            }
+        }
+
+        size_t todo = CCryptoBoringSSLShims_BLAKE2B_BLOCK_BYTES - ctx->block_used;
+        if (todo > in_len) {
+            todo = in_len;
+        }
+        memcpy(ctx->block + ctx->block_used, data, todo);
+        ctx->block_used += todo;
+        data += todo;
+        in_len -= todo;
+    }
+}
+
+void CCryptoBoringSSLShims_blake2b_final(CCryptoBoringSSLShims_blake2b_ctx *ctx, void *out) {
+    memset(ctx->block + ctx->block_used, 0, CCryptoBoringSSLShims_BLAKE2B_BLOCK_BYTES - ctx->block_used);
+    CCryptoBoringSSLShims_blake2b_compress(ctx, ctx->block, ctx->block_used, 1);
+
+    uint8_t digest[CCryptoBoringSSLShims_BLAKE2B_MAX_BYTES];
+    for (size_t i = 0; i < 8; i++) {
+        CRYPTO_store_u64_le(digest + 8 * i, ctx->h[i]);
+    }
+    memcpy(out, digest, ctx->out_len);
+    CCryptoBoringSSL_OPENSSL_cleanse(digest, sizeof(digest));
+    CCryptoBoringSSL_OPENSSL_cleanse(ctx, sizeof(*ctx));
+}
+
+// MARK:- SipHash batch
+
+#if defined(OPENSSL_X86_64) && (defined(__GNUC__) || defined(__clang__))
+#define CCRYPTOBORINGSSLSHIMS_SIPHASH_AVX2 1
+#include <immintrin.h>
+#endif
+
+typedef struct {
+    uint64_t v[4];
+} CCryptoBoringSSLShims_siphash_state;
+
+static void CCryptoBoringSSLShims_siphash_round(uint64_t v[4]) {
+    v[0] += v[1];
+    v[1] = CRYPTO_rotl_u64(v[1], 13);
+    v[1] ^= v[0];
+    v[0] = CRYPTO_rotl_u64(v[0], 32);
+    v[2] += v[3];
+    v[3] = CRYPTO_rotl_u64(v[3], 16);
+    v[3] ^= v[2];
+    v[0] += v[3];
+    v[3] = CRYPTO_rotl_u64(v[3], 21);
+    v[3] ^= v[0];
+    v[2] += v[1];
+    v[1] = CRYPTO_rotl_u64(v[1], 17);
+    v[1] ^= v[2];
+    v[2] = CRYPTO_rotl_u64(v[2], 32);
+}
+
+static void CCryptoBoringSSLShims_siphash_init(CCryptoBoringSSLShims_siphash_state *s, const uint64_t key[2]) {
+    s->v[0] = key[0] ^ UINT64_C(0x736f6d6570736575);
+    s->v[1] = key[1] ^ UINT64_C(0x646f72616e646f6d);
+    s->v[2] = key[0] ^ UINT64_C(0x6c7967656e657261);
+    s->v[3] = key[1] ^ UINT64_C(0x7465646279746573);
+}
+
+static void CCryptoBoringSSLShims_siphash_compress(CCryptoBoringSSLShims_siphash_state *s, uint64_t m) {
+    s->v[3] ^= m;
+    CCryptoBoringSSLShims_siphash_round(s->v);
+    CCryptoBoringSSLShims_siphash_round(s->v);
+    s->v[0] ^= m;
+}
+
+// Absorbs `in` from word `first_word` onwards, plus the length block, and
+// returns the SipHash-2-4 output. The state must already hold the words before
+// `first_word`.
+static uint64_t CCryptoBoringSSLShims_siphash_finish(CCryptoBoringSSLShims_siphash_state *s, const uint8_t *in,
+                                                     size_t in_len, size_t first_word) {
+    const size_t words = in_len / 8;
+    for (size_t i = first_word; i < words; i++) {
+        CCryptoBoringSSLShims_siphash_compress(s, CRYPTO_load_u64_le(in + 8 * i));
+    }
+
+    uint8_t last[8] = {0};
+    if (in_len % 8 != 0) {
+        memcpy(last, in + 8 * words, in_len % 8);
+    }
+    last[7] = (uint8_t)in_len;
+    CCryptoBoringSSLShims_siphash_compress(s, CRYPTO_load_u64_le(last));
+
+    s->v[2] ^= 0xff;
+    for (int i = 0; i < 4; i++) {
+        CCryptoBoringSSLShims_siphash_round(s->v);
+    }
+    return s->v[0] ^ s->v[1] ^ s->v[2] ^ s->v[3];
+}
+
+#if defined(CCRYPTOBORINGSSLSHIMS_SIPHASH_AVX2)
+__attribute__((target("avx2")))
+static inline __m256i CCryptoBoringSSLShims_siphash_rotl_avx2(__m256i x, int n) {
+    return _mm256_or_si256(_mm256_slli_epi64(x, n), _mm256_srli_epi64(x, 64 - n));
+}
+
+#define CCRYPTOBORINGSSLSHIMS_SIPHASH_ROUND_AVX2()                                         \
+    do {                                                                                   \
+        v0 = _mm256_add_epi64(v0, v1);                                                     \
+        v1 = _mm256_xor_si256(CCryptoBoringSSLShims_siphash_rotl_avx2(v1, 13), v0);        \
+        v0 = _mm256_shuffle_epi32(v0, _MM_SHUFFLE(2, 3, 0, 1));                            \
+        v2 = _mm256_add_epi64(v2, v3);                                                     \
+        v3 = _mm256_xor_si256(CCryptoBoringSSLShims_siphash_rotl_avx2(v3, 16), v2);        \
+        v0 = _mm256_add_epi64(v0, v3);                                                     \
+        v3 = _mm256_xor_si256(CCryptoBoringSSLShims_siphash_rotl_avx2(v3, 21), v0);        \
+        v2 = _mm256_add_epi64(v2, v1);                                                     \
+        v1 = _mm256_xor_si256(CCryptoBoringSSLShims_siphash_rotl_avx2(v1, 17), v2);        \
+        v2 = _mm256_shuffle_epi32(v2, _MM_SHUFFLE(2, 3, 0, 1));                            \
+    } while (0)
+
+#define CCRYPTOBORINGSSLSHIMS_SIPHASH_COMPRESS_AVX2(m)    \
+    do {                                                  \
+        v3 = _mm256_xor_si256(v3, (m));                   \
+        CCRYPTOBORINGSSLSHIMS_SIPHASH_ROUND_AVX2();       \
+        CCRYPTOBORINGSSLSHIMS_SIPHASH_ROUND_AVX2();       \
+        v0 = _mm256_xor_si256(v0, (m));                   \
+    } while (0)
+
+// Runs four inputs through SipHash in the lanes of 256-bit registers. When all
+// four have the same number of whole words, which is the common case of
+// equal-length keys, the length blocks and finalization run in the lanes too.
+// Otherwise the lanes cover the words all four have and each input's tail is
+// finished by the scalar code.
+__attribute__((target("avx2")))
+static void CCryptoBoringSSLShims_siphash_batch4_avx2(const uint64_t key[2], const uint8_t *const *inputs,
+                                                      const size_t *input_lens, uint64_t *out) {
+    size_t common_words = input_lens[0] / 8;
+    int same_words = 1;
+    for (size_t lane = 1; lane < 4; lane++) {
+        if (input_lens[lane] / 8 != common_words) {
+            same_words = 0;
+        }
+        if (input_lens[lane] / 8 < common_words) {
+            common_words = input_lens[lane] / 8;
+        }
+    }
+
+    CCryptoBoringSSLShims_siphash_state states[4];
+    CCryptoBoringSSLShims_siphash_init(&states[0], key);
+    __m256i v0 = _mm256_set1_epi64x((long long)states[0].v[0]);
+    __m256i v1 = _mm256_set1_epi64x((long long)states[0].v[1]);
+    __m256i v2 = _mm256_set1_epi64x((long long)states[0].v[2]);
+    __m256i v3 = _mm256_set1_epi64x((long long)states[0].v[3]);
+
+    for (size_t i = 0; i < common_words; i++) {
+        const __m256i m = _mm256_setr_epi64x(
+            (long long)CRYPTO_load_u64_le(inputs[0] + 8 * i), (long long)CRYPTO_load_u64_le(inputs[1] + 8 * i),
+            (long long)CRYPTO_load_u64_le(inputs[2] + 8 * i), (long long)CRYPTO_load_u64_le(inputs[3] + 8 * i));
+        CCRYPTOBORINGSSLSHIMS_SIPHASH_COMPRESS_AVX2(m);
+    }
+
+    if (same_words) {
+        uint64_t last[4];
+        for (size_t lane = 0; lane < 4; lane++) {
+            uint8_t block[8] = {0};
+            if (input_lens[lane] % 8 != 0) {
+                memcpy(block, inputs[lane] + 8 * common_words, input_lens[lane] % 8);
+            }
+            block[7] = (uint8_t)input_lens[lane];
+            last[lane] = CRYPTO_load_u64_le(block);
+        }
+        const __m256i m = _mm256_loadu_si256((const __m256i *)last);
+        CCRYPTOBORINGSSLSHIMS_SIPHASH_COMPRESS_AVX2(m);
+        v2 = _mm256_xor_si256(v2, _mm256_set1_epi64x(0xff));
+        for (int round = 0; round < 4; round++) {
+            CCRYPTOBORINGSSLSHIMS_SIPHASH_ROUND_AVX2();
+        }
+        _mm256_storeu_si256((__m256i *)out,
+                            _mm256_xor_si256(_mm256_xor_si256(v0, v1), _mm256_xor_si256(v2, v3)));
+        return;
+    }
+
+    uint64_t lanes[4][4];
+    _mm256_storeu_si256((__m256i *)lanes[0], v0);
+    _mm256_storeu_si256((__m256i *)lanes[1], v1);
+    _mm256_storeu_si256((__m256i *)lanes[2], v2);
+    _mm256_storeu_si256((__m256i *)lanes[3], v3);
+    for (size_t lane = 0; lane < 4; lane++) {
+        for (size_t word = 0; word < 4; word++) {
+            states[lane].v[word] = lanes[word][lane];
+        }
+        out[lane] = CCryptoBoringSSLShims_siphash_finish(&states[lane], inputs[lane], input_lens[lane], common_words);
+    }
+}
+
+#undef CCRYPTOBORINGSSLSHIMS_SIPHASH_COMPRESS_AVX2
+#undef CCRYPTOBORINGSSLSHIMS_SIPHASH_ROUND_AVX2
+#endif
+
+void CCryptoBoringSSLShims_SIPHASH_24_batch(const uint64_t key[2], const uint8_t *const *inputs,
+                                            const size_t *input_lens, size_t count, uint64_t *out) {
+    size_t i = 0;
+#if defined(CCRYPTOBORINGSSLSHIMS_SIPHASH_AVX2)
+    if (CRYPTO_is_AVX2_capable()) {
+        for (; i + 4 <= count; i += 4) {
+            CCryptoBoringSSLShims_siphash_batch4_avx2(key, inputs + i, input_lens + i, out + i);
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        CCryptoBoringSSLShims_siphash_state state;
+        CCryptoBoringSSLShims_siphash_init(&state, key);
+        out[i] = CCryptoBoringSSLShims_siphash_finish(&state, inputs[i], input_lens[i], 0);
+    }
+}
+
+// MARK:- PBKDF2
+
+#if defined(OPENSSL_X86_64) && (defined(__GNUC__) || defined(__clang__))
+#define CCRYPTOBORINGSSLSHIMS_PBKDF2_AVX2 1
+#include <immintrin.h>
+#endif
+
+// The SHA-256 states after absorbing the HMAC inner and outer pad blocks.
+typedef struct {
+    SHA256_CTX inner;
+    SHA256_CTX outer;
+} CCryptoBoringSSLShims_pbkdf2_pads;
+
+static void CCryptoBoringSSLShims_pbkdf2_pads_init(CCryptoBoringSSLShims_pbkdf2_pads *pads, const void *password,
+                                                   size_t password_len) {
+    uint8_t key[SHA256_CBLOCK] = {0};
+    if (password_len > SHA256_CBLOCK) {
+        CCryptoBoringSSL_SHA256(password, password_len, key);
+    } else if (password_len > 0) {
+        memcpy(key, password, password_len);
+    }
+
+    uint8_t pad[SHA256_CBLOCK];
+    for (size_t i = 0; i < SHA256_CBLOCK; i++) {
+        pad[i] = key[i] ^ 0x36;
+    }
+    CCryptoBoringSSL_SHA256_Init(&pads->inner);
+    CCryptoBoringSSL_SHA256_Update(&pads->inner, pad, SHA256_CBLOCK);
+    for (size_t i = 0; i < SHA256_CBLOCK; i++) {
+        pad[i] = key[i] ^ 0x5c;
+    }
+    CCryptoBoringSSL_SHA256_Init(&pads->outer);
+    CCryptoBoringSSL_SHA256_Update(&pads->outer, pad, SHA256_CBLOCK);
+
+    CCryptoBoringSSL_OPENSSL_cleanse(key, sizeof(key));
+    CCryptoBoringSSL_OPENSSL_cleanse(pad, sizeof(pad));
+}
+
+// Computes U_1 = HMAC(password, salt || INT(block_index)) for one output block.
+static void CCryptoBoringSSLShims_pbkdf2_first(const CCryptoBoringSSLShims_pbkdf2_pads *pads, const void *salt,
+                                               size_t salt_len, uint32_t block_index,
+                                               uint8_t out[SHA256_DIGEST_LENGTH]) {
+    uint8_t index[4];
+    CRYPTO_store_u32_be(index, block_index);
+
+    SHA256_CTX ctx = pads->inner;
+    CCryptoBoringSSL_SHA256_Update(&ctx, salt, salt_len);
+    CCryptoBoringSSL_SHA256_Update(&ctx, index, sizeof(index));
+    CCryptoBoringSSL_SHA256_Final(out, &ctx);
+
+    ctx = pads->outer;
+    CCryptoBoringSSL_SHA256_Update(&ctx, out, SHA256_DIGEST_LENGTH);
+    CCryptoBoringSSL_SHA256_Final(out, &ctx);
+}
+
+// Every later U_j is the HMAC of a 32-byte message, whose inner and outer
+// hashes are each a single padded block after the pad states. The blocks are
+// laid out once and only the message words are rewritten per iteration, so an
+// iteration is exactly two compression function calls.
+static void CCryptoBoringSSLShims_pbkdf2_iterate(const CCryptoBoringSSLShims_pbkdf2_pads *pads, uint32_t iterations,
+                                                 uint8_t u[SHA256_DIGEST_LENGTH],
+                                                 uint8_t acc[SHA256_DIGEST_LENGTH]) {
+    uint8_t block[SHA256_CBLOCK] = {0};
+    block[SHA256_DIGEST_LENGTH] = 0x80;
+    // The message follows a full pad block: (64 + 32) * 8 bits.
+    CRYPTO_store_u32_be(block + SHA256_CBLOCK - 4, (SHA256_CBLOCK + SHA256_DIGEST_LENGTH) * 8);
+
+    memcpy(block, u, SHA256_DIGEST_LENGTH);
+    for (uint32_t j = 1; j < iterations; j++) {
+        uint32_t state[8];
+        memcpy(state, pads->inner.h, sizeof(state));
+        CCryptoBoringSSL_SHA256_TransformBlocks(state, block, 1);
+        for (size_t k = 0; k < 8; k++) {
+            CRYPTO_store_u32_be(block + 4 * k, state[k]);
+        }
+        memcpy(state, pads->outer.h, sizeof(state));
+        CCryptoBoringSSL_SHA256_TransformBlocks(state, block, 1);
+        for (size_t k = 0; k < 8; k++) {
+            CRYPTO_store_u32_be(block + 4 * k, state[k]);
+        }
+        for (size_t k = 0; k < SHA256_DIGEST_LENGTH; k++) {
+            acc[k] ^= block[k];
+        }
+    }
+    CCryptoBoringSSL_OPENSSL_cleanse(block, sizeof(block));
+}
+
+static void CCryptoBoringSSLShims_pbkdf2_derive(const CCryptoBoringSSLShims_pbkdf2_pads *pads, const void *salt,
+                                                size_t salt_len, uint32_t iterations, uint8_t *out_key,
+                                                size_t key_len) {
+    uint8_t u[SHA256_DIGEST_LENGTH], acc[SHA256_DIGEST_LENGTH];
+    for (uint32_t block_index = 1; key_len > 0; block_index++) {
+        const size_t todo = key_len < SHA256_DIGEST_LENGTH ? key_len : SHA256_DIGEST_LENGTH;
+        CCryptoBoringSSLShims_pbkdf2_first(pads, salt, salt_len, block_index, u);
+        memcpy(acc, u, SHA256_DIGEST_LENGTH);
+        CCryptoBoringSSLShims_pbkdf2_iterate(pads, iterations, u, acc);
+        memcpy(out_key, acc, todo);
+        out_key += todo;
+        key_len -= todo;
+    }
+    CCryptoBoringSSL_OPENSSL_cleanse(u, sizeof(u));
+    CCryptoBoringSSL_OPENSSL_cleanse(acc, sizeof(acc));
+}
+
+int CCryptoBoringSSLShims_PBKDF2_HMAC_SHA256(const void *password, size_t password_len, const void *salt,
+                                             size_t salt_len, uint32_t iterations, void *out_key, size_t key_len) {
+    if (iterations == 0 || key_len / SHA256_DIGEST_LENGTH >= UINT32_MAX) {
+        return 0;
+    }
+    CCryptoBoringSSLShims_pbkdf2_pads pads;
+    CCryptoBoringSSLShims_pbkdf2_pads_init(&pads, password, password_len);
+    CCryptoBoringSSLShims_pbkdf2_derive(&pads, salt, salt_len, iterations, out_key, key_len);
+    CCryptoBoringSSL_OPENSSL_cleanse(&pads, sizeof(pads));
+    return 1;
+}
+
+#if defined(CCRYPTOBORINGSSLSHIMS_PBKDF2_AVX2)
+static const uint32_t CCryptoBoringSSLShims_sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+#define CCRYPTOBORINGSSLSHIMS_PBKDF2_LANES 8
+
+__attribute__((target("avx2")))
+static inline __m256i CCryptoBoringSSLShims_sha256_rotr_avx2(__m256i x, int n) {
+    return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n));
+}
+
+// Runs the SHA-256 compression function on eight independent states at once,
+// one per 32-bit lane. `w` holds the sixteen message words of each lane's
+// block and is overwritten.
+__attribute__((target("avx2")))
+static void CCryptoBoringSSLShims_sha256_compress8_avx2(__m256i state[8], __m256i w[16]) {
+    __m256i a = state[0], b = state[1], c = state[2], d = state[3];
+    __m256i e = state[4], f = state[5], g = state[6], h = state[7];
+
+    for (size_t i = 0; i < 64; i++) {
+        if (i >= 16) {
+            const __m256i w15 = w[(i - 15) & 15], w2 = w[(i - 2) & 15];
+            const __m256i s0 = _mm256_xor_si256(
+                _mm256_xor_si256(CCryptoBoringSSLShims_sha256_rotr_avx2(w15, 7), CCryptoBoringSSLShims_sha256_rotr_avx2(w15, 18)),
+                _mm256_srli_epi32(w15, 3));
+            const __m256i s1 = _mm256_xor_si256(
+                _mm256_xor_si256(CCryptoBoringSSLShims_sha256_rotr_avx2(w2, 17), CCryptoBoringSSLShims_sha256_rotr_avx2(w2, 19)),
+                _mm256_srli_epi32(w2, 10));
+            w[i & 15] = _mm256_add_epi32(_mm256_add_epi32(w[i & 15], s0), _mm256_add_epi32(w[(i - 7) & 15], s1));
+        }
+
+        const __m256i sigma1 = _mm256_xor_si256(
+            _mm256_xor_si256(CCryptoBoringSSLShims_sha256_rotr_avx2(e, 6), CCryptoBoringSSLShims_sha256_rotr_avx2(e, 11)),
+            CCryptoBoringSSLShims_sha256_rotr_avx2(e, 25));
+        const __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        const __m256i t1 = _mm256_add_epi32(
+            _mm256_add_epi32(_mm256_add_epi32(h, sigma1), _mm256_add_epi32(ch, w[i & 15])),
+            _mm256_set1_epi32((int)CCryptoBoringSSLShims_sha256_k[i]));
+        const __m256i sigma0 = _mm256_xor_si256(
+            _mm256_xor_si256(CCryptoBoringSSLShims_sha256_rotr_avx2(a, 2), CCryptoBoringSSLShims_sha256_rotr_avx2(a, 13)),
+            CCryptoBoringSSLShims_sha256_rotr_avx2(a, 22));
+        const __m256i maj = _mm256_xor_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_xor_si256(a, b)));
+        const __m256i t2 = _mm256_add_epi32(sigma0, maj);
+
+        h = g;
+        g = f;
+        f = e;
+        e = _mm256_add_epi32(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = _mm256_add_epi32(t1, t2);
+    }
+
+    state[0] = _mm256_add_epi32(state[0], a);
+    state[1] = _mm256_add_epi32(state[1], b);
+    state[2] = _mm256_add_epi32(state[2], c);
+    state[3] = _mm256_add_epi32(state[3], d);
+    state[4] = _mm256_add_epi32(state[4], e);
+    state[5] = _mm256_add_epi32(state[5], f);
+    state[6] = _mm256_add_epi32(state[6], g);
+    state[7] = _mm256_add_epi32(state[7], h);
+}
+
+// One PBKDF2 output block in flight: the pad states of its password, its
+// latest U_j and the running XOR of the U_j, all as big-endian words.
+typedef struct {
+    const CCryptoBoringSSLShims_pbkdf2_pads *pads;
+    uint32_t u[8];
+    uint32_t acc[8];
+} CCryptoBoringSSLShims_pbkdf2_chain;
+
+// Runs the remaining `iterations - 1` iterations of up to eight chains in
+// lockstep, one per lane. Unused lanes repeat the first chain.
+__attribute__((target("avx2")))
+static void CCryptoBoringSSLShims_pbkdf2_iterate8_avx2(CCryptoBoringSSLShims_pbkdf2_chain *const *chains,
+                                                       uint32_t iterations) {
+    __m256i inner[8], outer[8], u[8], acc[8];
+    for (size_t k = 0; k < 8; k++) {
+        uint32_t in_words[CCRYPTOBORINGSSLSHIMS_PBKDF2_LANES], out_words[CCRYPTOBORINGSSLSHIMS_PBKDF2_LANES];
+        uint32_t u_words[CCRYPTOBORINGSSLSHIMS_PBKDF2_LANES];
+        for (size_t lane = 0; lane < CCRYPTOBORINGSSLSHIMS_PBKDF2_LANES; lane++) {
+            in_words[lane] = chains[lane]->pads->inner.h[k];
+            out_words[lane] = chains[lane]->pads->outer.h[k];
+            u_words[lane] = chains[lane]->u[k];
+        }
+        inner[k] = _mm256_loadu_si256((const __m256i *)in_words);
+        outer[k] = _mm256_loadu_si256((const __m256i *)out_words);
+        u[k] = _mm256_loadu_si256((const __m256i *)u_words);
+        acc[k] = u[k];
+    }
+
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i padding = _mm256_set1_epi32((int)0x80000000);
+    const __m256i length = _mm256_set1_epi32((SHA256_CBLOCK + SHA256_DIGEST_LENGTH) * 8);
+    for (uint32_t j = 1; j < iterations; j++) {
+        __m256i w[16], state[8];
+        for (size_t k = 0; k < 8; k++) {
+            w[k] = u[k];
+            state[k] = inner[k];
+        }
+        w[8] = padding;
+        for (size_t k = 9; k < 15; k++) {
+            w[k] = zero;
+        }
+        w[15] = length;
+        CCryptoBoringSSLShims_sha256_compress8_avx2(state, w);
+
+        for (size_t k = 0; k < 8; k++) {
+            w[k] = state[k];
+            u[k] = outer[k];
+        }
+        w[8] = padding;
+        for (size_t k = 9; k < 15; k++) {
+            w[k] = zero;
+        }
+        w[15] = length;
+        CCryptoBoringSSLShims_sha256_compress8_avx2(u, w);
+
+        for (size_t k = 0; k < 8; k++) {
+            acc[k] = _mm256_xor_si256(acc[k], u[k]);
+        }
+    }
+
+    for (size_t k = 0; k < 8; k++) {
+        uint32_t acc_words[CCRYPTOBORINGSSLSHIMS_PBKDF2_LANES];
+        _mm256_storeu_si256((__m256i *)acc_words, acc[k]);
+        for (size_t lane = 0; lane < CCRYPTOBORINGSSLSHIMS_PBKDF2_LANES; lane++) {
+            chains[lane]->acc[k] = acc_words[lane];
+        }
+    }
+}
+#endif
+
+int CCryptoBoringSSLShims_PBKDF2_HMAC_SHA256_batch(const CCryptoBoringSSLShims_PBKDF2_batch_op *ops, size_t ops_count,
+                                                   uint32_t iterations, size_t key_len) {
+    if (iterations == 0 || key_len / SHA256_DIGEST_LENGTH >= UINT32_MAX) {
+        return 0;
+    }
+
+#if defined(CCRYPTOBORINGSSLSHIMS_PBKDF2_AVX2)
+    // CPUs with the SHA extensions compute one chain about as fast as AVX2
+    // computes eight, so the lanes only pay off without them.
+    const size_t blocks_per_key = (key_len + SHA256_DIGEST_LENGTH - 1) / SHA256_DIGEST_LENGTH;
+    if (CRYPTO_is_AVX2_capable() && !CRYPTO_is_x86_SHA_capable() && ops_count > 0 && blocks_per_key > 0 &&
+        ops_count <= SIZE_MAX / blocks_per_key / sizeof(CCryptoBoringSSLShims_pbkdf2_chain)) {
+        const size_t chains_count = ops_count * blocks_per_key;
+        CCryptoBoringSSLShims_pbkdf2_pads *pads = CCryptoBoringSSL_OPENSSL_malloc(ops_count * sizeof(*pads));
+        CCryptoBoringSSLShims_pbkdf2_chain *chains = CCryptoBoringSSL_OPENSSL_malloc(chains_count * sizeof(*chains));
+        if (pads == NULL || chains == NULL) {
+            CCryptoBoringSSL_OPENSSL_free(pads);
+            CCryptoBoringSSL_OPENSSL_free(chains);
+            return 0;
+        }
+
+        for (size_t i = 0; i < ops_count; i++) {
+            CCryptoBoringSSLShims_pbkdf2_pads_init(&pads[i], ops[i].password, ops[i].password_len);
+            for (size_t block = 0; block < blocks_per_key; block++) {
+                CCryptoBoringSSLShims_pbkdf2_chain *chain = &chains[i * blocks_per_key + block];
+                uint8_t u[SHA256_DIGEST_LENGTH];
+                chain->pads = &pads[i];
+                CCryptoBoringSSLShims_pbkdf2_first(&pads[i], ops[i].salt, ops[i].salt_len, (uint32_t)block + 1, u);
+                for (size_t k = 0; k < 8; k++) {
+                    chain->u[k] = CRYPTO_load_u32_be(u + 4 * k);
+                }
+                CCryptoBoringSSL_OPENSSL_cleanse(u, sizeof(u));
+            }
+        }
+
+        for (size_t first = 0; first < chains_count; first += CCRYPTOBORINGSSLSHIMS_PBKDF2_LANES) {
+            CCryptoBoringSSLShims_pbkdf2_chain *lanes[CCRYPTOBORINGSSLSHIMS_PBKDF2_LANES];
+            for (size_t lane = 0; lane < CCRYPTOBORINGSSLSHIMS_PBKDF2_LANES; lane++) {
+                lanes[lane] = &chains[first + lane < chains_count ? first + lane : first];
+            }
+            CCryptoBoringSSLShims_pbkdf2_iterate8_avx2(lanes, iterations);
+        }
+
+        for (size_t i = 0; i < ops_count; i++) {
+            uint8_t *out = ops[i].out_key;
+            size_t remaining = key_len;
+            for (size_t block = 0; block < blocks_per_key; block++) {
+                uint8_t acc[SHA256_DIGEST_LENGTH];
+                for (size_t k = 0; k < 8; k++) {
+                    CRYPTO_store_u32_be(acc + 4 * k, chains[i * blocks_per_key + block].acc[k]);
+                }
+                const size_t todo = remaining < SHA256_DIGEST_LENGTH ? remaining : SHA256_DIGEST_LENGTH;
+                memcpy(out, acc, todo);
+                CCryptoBoringSSL_OPENSSL_cleanse(acc, sizeof(acc));
+                out += todo;
+                remaining -= todo;
+            }
+        }
+
+        CCryptoBoringSSL_OPENSSL_cleanse(pads, ops_count * sizeof(*pads));
+        CCryptoBoringSSL_OPENSSL_cleanse(chains, chains_count * sizeof(*chains));
+        CCryptoBoringSSL_OPENSSL_free(pads);
+        CCryptoBoringSSL_OPENSSL_free(chains);
+        return 1;
+    }
+#endif
+
+    for (size_t i = 0; i < ops_count; i++) {
+        CCryptoBoringSSLShims_PBKDF2_HMAC_SHA256(ops[i].password, ops[i].password_len, ops[i].salt, ops[i].salt_len,
+                                                 iterations, ops[i].out_key, key_len);
+    }
+    return 1;
+}
+
+// MARK:- Multi-buffer SHA-256
+
+// Without the SHA extensions, the eight-lane kernel under "PBKDF2" hashes
+// eight short messages in about the time BoringSSL hashes two, so batches of
+// independent messages are spread over its lanes. With the SHA extensions a
+// single message is as fast as the lanes, and batches stay serial.
+
+#define CCRYPTOBORINGSSLSHIMS_SHA256_MULTI_CHUNK 64
+
+// One message for |CCryptoBoringSSLShims_sha256_multi|: |head| (at most 64
+// bytes) followed by |body|, hashed on from |start| if it is not NULL. |start|
+// must hold no partial block, as after the HMAC pad block.
+typedef struct {
+    const SHA256_CTX *start;
+    const uint8_t *head;
+    size_t head_len;
+    const uint8_t *body;
+    size_t body_len;
+    uint8_t *out;
+} CCryptoBoringSSLShims_sha256_job;
+
+#if defined(CCRYPTOBORINGSSLSHIMS_PBKDF2_AVX2)
+static const uint32_t CCryptoBoringSSLShims_sha256_iv[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+static size_t CCryptoBoringSSLShims_sha256_job_blocks(const CCryptoBoringSSLShims_sha256_job *job) {
+    // The padding takes at least nine bytes: 0x80 and a 64-bit length.
+    return (job->head_len + job->body_len + 9 + SHA256_CBLOCK - 1) / SHA256_CBLOCK;
+}
+
+// The number of bits |job->start| has already absorbed.
+static uint64_t CCryptoBoringSSLShims_sha256_job_start_bits(const CCryptoBoringSSLShims_sha256_job *job) {
+    return job->start == NULL ? 0 : ((uint64_t)job->start->Nh << 32) | job->start->Nl;
+}
+
+// Writes block |index| of the padded message of |job| to |out|.
+static void CCryptoBoringSSLShims_sha256_job_block(const CCryptoBoringSSLShims_sha256_job *job, size_t index,
+                                                   uint8_t out[SHA256_CBLOCK]) {
+    const size_t len = job->head_len + job->body_len;
+    const size_t start = index * SHA256_CBLOCK;
+    size_t done = 0;
+    if (start < job->head_len) {
+        done = job->head_len - start < SHA256_CBLOCK ? job->head_len - start : SHA256_CBLOCK;
+        memcpy(out, job->head + start, done);
+    }
+    if (done < SHA256_CBLOCK && start + done < len) {
+        const size_t body_start = start + done - job->head_len;
+        size_t todo = job->body_len - body_start;
+        todo = todo < SHA256_CBLOCK - done ? todo : SHA256_CBLOCK - done;
+        memcpy(out + done, job->body + body_start, todo);
+        done += todo;
+    }
+    if (done < SHA256_CBLOCK) {
+        memset(out + done, 0, SHA256_CBLOCK - done);
+        if (start + done == len) {
+            out[done] = 0x80;
+        }
+    }
+    if (index + 1 == CCryptoBoringSSLShims_sha256_job_blocks(job)) {
+        CRYPTO_store_u64_be(out + SHA256_CBLOCK - 8,
+                            CCryptoBoringSSLShims_sha256_job_start_bits(job) + (uint64_t)len * 8);
+    }
+}
+
+__attribute__((target("avx2")))
+static void CCryptoBoringSSLShims_sha256_compress8_words_avx2(uint32_t state_words[8][CCRYPTOBORINGSSLSHIMS_PBKDF2_LANES],
+                                                              const uint32_t w_words[16][CCRYPTOBORINGSSLSHIMS_PBKDF2_LANES]) {
+    __m256i state[8], w[16];
+    for (size_t k = 0; k < 8; k++) {
+        state[k] = _mm256_loadu_si256((const __m256i *)state_words[k]);
+    }
+    for (size_t k = 0; k < 16; k++) {
+        w[k] = _mm256_loadu_si256((const __m256i *)w_words[k]);
+    }
+    CCryptoBoringSSLShims_sha256_compress8_avx2(state, w);
+    for (size_t k = 0; k < 8; k++) {
+        _mm256_storeu_si256((__m256i *)state_words[k], state[k]);
+    }
+}
+
+// Hashes every job with the eight lanes of the AVX2 kernel. A lane that
+// finishes its job writes the digest and takes the next job; a lane with
+// nothing left to do compresses zeros that are thrown away.
+static void CCryptoBoringSSLShims_sha256_multi_lanes(const CCryptoBoringSSLShims_sha256_job *jobs, size_t count) {
+    uint32_t state[8][CCRYPTOBORINGSSLSHIMS_PBKDF2_LANES] = {{0}};
+    uint32_t w[16][CCRYPTOBORINGSSLSHIMS_PBKDF2_LANES];
+    const CCryptoBoringSSLShims_sha256_job *lane_job[CCRYPTOBORINGSSLSHIMS_PBKDF2_LANES] = {NULL};
+    size_t lane_block[CCRYPTOBORINGSSLSHIMS_PBKDF2_LANES] = {0};
+    size_t next = 0;
+    uint8_t block[SHA256_CBLOCK];
+
+    for (;;) {
+        size_t active = 0;
+        for (size_t lane = 0; lane < CCRYPTOBORINGSSLSHIMS_PBKDF2_LANES; lane++) {
+            if (lane_job[lane] == NULL && next < count) {
+                lane_job[lane] = &jobs[next++];
+                lane_block[lane] = 0;
+                const uint32_t *start = lane_job[lane]->start != NULL ? lane_job[lane]->start->h
+                                                                      : CCryptoBoringSSLShims_sha256_iv;
+                for (size_t k = 0; k < 8; k++) {
+                    state[k][lane] = start[k];
+                }
+            }
+            if (lane_job[lane] == NULL) {
+                for (size_t k = 0; k < 16; k++) {
+                    w[k][lane] = 0;
+                }
+                continue;
+            }
+            active++;
+            CCryptoBoringSSLShims_sha256_job_block(lane_job[lane], lane_block[lane], block);
+            for (size_t k = 0; k < 16; k++) {
+                w[k][lane] = CRYPTO_load_u32_be(block + 4 * k);
+            }
+        }
+        if (active == 0) {
+            break;
+        }
+
+        CCryptoBoringSSLShims_sha256_compress8_words_avx2(state, w);
+
+        for (size_t lane = 0; lane < CCRYPTOBORINGSSLSHIMS_PBKDF2_LANES; lane++) {
+            if (lane_job[lane] == NULL) {
+                continue;
+            }
+            if (++lane_block[lane] == CCryptoBoringSSLShims_sha256_job_blocks(lane_job[lane])) {
+                for (size_t k = 0; k < 8; k++) {
+                    CRYPTO_store_u32_be(lane_job[lane]->out + 4 * k, state[k][lane]);
+                }
+                lane_job[lane] = NULL;
+            }
+        }
+    }
+
+    CCryptoBoringSSL_OPENSSL_cleanse(state, sizeof(state));
+    CCryptoBoringSSL_OPENSSL_cleanse(w, sizeof(w));
+    CCryptoBoringSSL_OPENSSL_cleanse(block, sizeof(block));
+}
+#endif  // CCRYPTOBORINGSSLSHIMS_PBKDF2_AVX2
+
+static void CCryptoBoringSSLShims_sha256_multi(const CCryptoBoringSSLShims_sha256_job *jobs, size_t count) {
+#if defined(CCRYPTOBORINGSSLSHIMS_PBKDF2_AVX2)
+    if (count > 1 && CRYPTO_is_AVX2_capable() && !CRYPTO_is_x86_SHA_capable()) {
+        CCryptoBoringSSLShims_sha256_multi_lanes(jobs, count);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < count; i++) {
+        SHA256_CTX ctx;
+        if (jobs[i].start != NULL) {
+            ctx = *jobs[i].start;
+        } else {
+            CCryptoBoringSSL_SHA256_Init(&ctx);
+        }
+        CCryptoBoringSSL_SHA256_Update(&ctx, jobs[i].head, jobs[i].head_len);
+        CCryptoBoringSSL_SHA256_Update(&ctx, jobs[i].body, jobs[i].body_len);
+        CCryptoBoringSSL_SHA256_Final(jobs[i].out, &ctx);
+    }
+}
+
+void CCryptoBoringSSLShims_SHA256_batch(const CCryptoBoringSSLShims_hash_batch_op *ops,
+                                        size_t ops_count) {
+    CCryptoBoringSSLShims_sha256_job jobs[CCRYPTOBORINGSSLSHIMS_SHA256_MULTI_CHUNK];
+    for (size_t first = 0; first < ops_count; first += CCRYPTOBORINGSSLSHIMS_SHA256_MULTI_CHUNK) {
+        const size_t remaining = ops_count - first;
+        const size_t count = remaining < CCRYPTOBORINGSSLSHIMS_SHA256_MULTI_CHUNK ? remaining
+                                                                                  : CCRYPTOBORINGSSLSHIMS_SHA256_MULTI_CHUNK;
+        for (size_t i = 0; i < count; i++) {
+            const CCryptoBoringSSLShims_hash_batch_op *op = &ops[first + i];
+            jobs[i] = (CCryptoBoringSSLShims_sha256_job){NULL, NULL, 0, op->in, op->in_len, op->out};
+        }
+        CCryptoBoringSSLShims_sha256_multi(jobs, count);
+    }
+}
+
+// The inner hashes of a chunk go through the lanes together, then the outer
+// ones. Pad states are shared by runs of operations under the same key.
+int CCryptoBoringSSLShims_HMAC_SHA256_batch(const CCryptoBoringSSLShims_HMAC_batch_op *ops,
+                                            size_t ops_count) {
+    // One more than a chunk, for the pad states carried over from the last one.
+    CCryptoBoringSSLShims_pbkdf2_pads pads[CCRYPTOBORINGSSLSHIMS_SHA256_MULTI_CHUNK + 1];
+    const CCryptoBoringSSLShims_pbkdf2_pads *op_pads[CCRYPTOBORINGSSLSHIMS_SHA256_MULTI_CHUNK];
+    uint8_t inner[CCRYPTOBORINGSSLSHIMS_SHA256_MULTI_CHUNK][SHA256_DIGEST_LENGTH];
+    CCryptoBoringSSLShims_sha256_job jobs[CCRYPTOBORINGSSLSHIMS_SHA256_MULTI_CHUNK];
+    size_t pads_count = 0;
+
+    for (size_t first = 0; first < ops_count; first += CCRYPTOBORINGSSLSHIMS_SHA256_MULTI_CHUNK) {
+        const size_t remaining = ops_count - first;
+        const size_t count = remaining < CCRYPTOBORINGSSLSHIMS_SHA256_MULTI_CHUNK ? remaining
+                                                                                  : CCRYPTOBORINGSSLSHIMS_SHA256_MULTI_CHUNK;
+        if (pads_count > 0) {
+            pads[0] = pads[pads_count - 1];
+            pads_count = 1;
+        }
+        for (size_t i = 0; i < count; i++) {
+            const size_t index = first + i;
+            const CCryptoBoringSSLShims_HMAC_batch_op *op = &ops[index];
+            const int same_key = index > 0 && op->key == ops[index - 1].key && op->key_len == ops[index - 1].key_len;
+            if (!same_key) {
+                CCryptoBoringSSLShims_pbkdf2_pads_init(&pads[pads_count++], op->key, op->key_len);
+            }
+            op_pads[i] = &pads[pads_count - 1];
+            jobs[i] = (CCryptoBoringSSLShims_sha256_job){&op_pads[i]->inner, NULL, 0, op->in, op->in_len, inner[i]};
+        }
+        CCryptoBoringSSLShims_sha256_multi(jobs, count);
+
+        for (size_t i = 0; i < count; i++) {
+            jobs[i] = (CCryptoBoringSSLShims_sha256_job){&op_pads[i]->outer, inner[i], SHA256_DIGEST_LENGTH, NULL, 0,
+                                                         ops[first + i].out};
+        }
+        CCryptoBoringSSLShims_sha256_multi(jobs, count);
+    }
+
+    CCryptoBoringSSL_OPENSSL_cleanse(pads, sizeof(pads));
+    CCryptoBoringSSL_OPENSSL_cleanse(inner, sizeof(inner));
+    return 1;
+}
+
+// MARK:- Cancellation
+
+void CCryptoBoringSSLShims_CANCEL_FLAG_set(CCryptoBoringSSLShims_CANCEL_FLAG *flag) {
+    CRYPTO_atomic_store_u32((CRYPTO_atomic_u32 *)&flag->value, 1);
+}
+
+int CCryptoBoringSSLShims_CANCEL_FLAG_is_set(const CCryptoBoringSSLShims_CANCEL_FLAG *flag) {
+    return flag != NULL && CRYPTO_atomic_load_u32((CRYPTO_atomic_u32 *)&flag->value) != 0;
+}
+
+// MARK:- scrypt
+
+#if !defined(_WIN32) && !defined(OPENSSL_NO_THREADS_CORRUPT_MEMORY_AND_LEAK_SECRETS_IF_THREADED)
+#define CCRYPTOBORINGSSLSHIMS_PARALLEL_SCRYPT 1
+#include <pthread.h>
+#endif
+
+#if !defined(_WIN32)
+#define CCRYPTOBORINGSSLSHIMS_SCRYPT_MMAP 1
+#include <sys/mman.h>
+#endif
+
+#if defined(OPENSSL_X86_64) || defined(OPENSSL_X86)
+#define CCRYPTOBORINGSSLSHIMS_SCRYPT_SSE2 1
+#include <emmintrin.h>
+#elif defined(CRYPTO_BORINGSSL_ARM_KERNELS) && defined(OPENSSL_AARCH64) && defined(__ARM_NEON)
+// Not yet run on AArch64 in CI, so opt-in; the portable Salsa20/8 is used
+// otherwise.
+#define CCRYPTOBORINGSSLSHIMS_SCRYPT_NEON 1
+#include <arm_neon.h>
+#endif
+
+// A Salsa20 block, as in scrypt.c. scryptBlockMix works in units of 2 * r of
+// these.
+typedef struct {
+    uint32_t words[16];
+} CCryptoBoringSSLShims_salsa_block;
+
+#if defined(CCRYPTOBORINGSSLSHIMS_SCRYPT_SSE2) || defined(CCRYPTOBORINGSSLSHIMS_SCRYPT_NEON)
+// The vector Salsa20/8 keeps each diagonal of the 4x4 state in one register,
+// so blocks are stored with word i of the vector layout holding word
+// 5 * i mod 16 of the specification's layout. The whole ROMix runs in this
+// layout; only the input and output are converted.
+static void CCryptoBoringSSLShims_salsa_to_vector_layout(CCryptoBoringSSLShims_salsa_block *blocks, size_t count) {
+    for (size_t b = 0; b < count; b++) {
+        CCryptoBoringSSLShims_salsa_block tmp;
+        for (size_t i = 0; i < 16; i++) {
+            tmp.words[i] = blocks[b].words[(5 * i) % 16];
+        }
+        blocks[b] = tmp;
+    }
+}
+
+static void CCryptoBoringSSLShims_salsa_from_vector_layout(CCryptoBoringSSLShims_salsa_block *blocks, size_t count) {
+    for (size_t b = 0; b < count; b++) {
+        CCryptoBoringSSLShims_salsa_block tmp;
+        for (size_t i = 0; i < 16; i++) {
+            tmp.words[(5 * i) % 16] = blocks[b].words[i];
+        }
+        blocks[b] = tmp;
+    }
+}
+#endif
+
+#if defined(CCRYPTOBORINGSSLSHIMS_SCRYPT_SSE2)
+#define CCRYPTOBORINGSSLSHIMS_SALSA_ROTL_XOR(x, t, n) \
+    _mm_xor_si128(_mm_xor_si128((x), _mm_slli_epi32((t), (n))), _mm_srli_epi32((t), 32 - (n)))
+
+// Salsa20/8 on a block in the vector layout.
+static void CCryptoBoringSSLShims_salsa208(CCryptoBoringSSLShims_salsa_block *inout) {
+    __m128i *b = (__m128i *)inout->words;
+    const __m128i in0 = _mm_loadu_si128(&b[0]), in1 = _mm_loadu_si128(&b[1]);
+    const __m128i in2 = _mm_loadu_si128(&b[2]), in3 = _mm_loadu_si128(&b[3]);
+    __m128i x0 = in0, x1 = in1, x2 = in2, x3 = in3, t;
+
+    for (int i = 0; i < 8; i += 2) {
+        // Columns.
+        t = _mm_add_epi32(x0, x3);
+        x1 = CCRYPTOBORINGSSLSHIMS_SALSA_ROTL_XOR(x1, t, 7);
+        t = _mm_add_epi32(x1, x0);
+        x2 = CCRYPTOBORINGSSLSHIMS_SALSA_ROTL_XOR(x2, t, 9);
+        t = _mm_add_epi32(x2, x1);
+        x3 = CCRYPTOBORINGSSLSHIMS_SALSA_ROTL_XOR(x3, t, 13);
+        t = _mm_add_epi32(x3, x2);
+        x0 = CCRYPTOBORINGSSLSHIMS_SALSA_ROTL_XOR(x0, t, 18);
+        x1 = _mm_shuffle_epi32(x1, 0x93);
+        x2 = _mm_shuffle_epi32(x2, 0x4e);
+        x3 = _mm_shuffle_epi32(x3, 0x39);
+        // Rows.
+        t = _mm_add_epi32(x0, x1);
+        x3 = CCRYPTOBORINGSSLSHIMS_SALSA_ROTL_XOR(x3, t, 7);
+        t = _mm_add_epi32(x3, x0);
+        x2 = CCRYPTOBORINGSSLSHIMS_SALSA_ROTL_XOR(x2, t, 9);
+        t = _mm_add_epi32(x2, x3);
+        x1 = CCRYPTOBORINGSSLSHIMS_SALSA_ROTL_XOR(x1, t, 13);
+        t = _mm_add_epi32(x1, x2);
+        x0 = CCRYPTOBORINGSSLSHIMS_SALSA_ROTL_XOR(x0, t, 18);
+        x1 = _mm_shuffle_epi32(x1, 0x39);
+        x2 = _mm_shuffle_epi32(x2, 0x4e);
+        x3 = _mm_shuffle_epi32(x3, 0x93);
+    }
+
+    _mm_storeu_si128(&b[0], _mm_add_epi32(in0, x0));
+    _mm_storeu_si128(&b[1], _mm_add_epi32(in1, x1));
+    _mm_storeu_si128(&b[2], _mm_add_epi32(in2, x2));
+    _mm_storeu_si128(&b[3], _mm_add_epi32(in3, x3));
+}
+#undef CCRYPTOBORINGSSLSHIMS_SALSA_ROTL_XOR
+#elif defined(CCRYPTOBORINGSSLSHIMS_SCRYPT_NEON)
+#define CCRYPTOBORINGSSLSHIMS_SALSA_ROTL_XOR(x, t, n) veorq_u32((x), vsriq_n_u32(vshlq_n_u32((t), (n)), (t), 32 - (n)))
+
+// Salsa20/8 on a block in the vector layout.
+static void CCryptoBoringSSLShims_salsa208(CCryptoBoringSSLShims_salsa_block *inout) {
+    const uint32x4_t in0 = vld1q_u32(inout->words), in1 = vld1q_u32(inout->words + 4);
+    const uint32x4_t in2 = vld1q_u32(inout->words + 8), in3 = vld1q_u32(inout->words + 12);
+    uint32x4_t x0 = in0, x1 = in1, x2 = in2, x3 = in3, t;
+
+    for (int i = 0; i < 8; i += 2) {
+        // Columns.
+        t = vaddq_u32(x0, x3);
+        x1 = CCRYPTOBORINGSSLSHIMS_SALSA_ROTL_XOR(x1, t, 7);
+        t = vaddq_u32(x1, x0);
+        x2 = CCRYPTOBORINGSSLSHIMS_SALSA_ROTL_XOR(x2, t, 9);
+        t = vaddq_u32(x2, x1);
+        x3 = CCRYPTOBORINGSSLSHIMS_SALSA_ROTL_XOR(x3, t, 13);
+        t = vaddq_u32(x3, x2);
+        x0 = CCRYPTOBORINGSSLSHIMS_SALSA_ROTL_XOR(x0, t, 18);
+        x1 = vextq_u32(x1, x1, 3);
+        x2 = vextq_u32(x2, x2, 2);
+        x3 = vextq_u32(x3, x3, 1);
+        // Rows.
+        t = vaddq_u32(x0, x1);
+        x3 = CCRYPTOBORINGSSLSHIMS_SALSA_ROTL_XOR(x3, t, 7);
+        t = vaddq_u32(x3, x0);
+        x2 = CCRYPTOBORINGSSLSHIMS_SALSA_ROTL_XOR(x2, t, 9);
+        t = vaddq_u32(x2, x3);
+        x1 = CCRYPTOBORINGSSLSHIMS_SALSA_ROTL_XOR(x1, t, 13);
+        t = vaddq_u32(x1, x2);
+        x0 = CCRYPTOBORINGSSLSHIMS_SALSA_ROTL_XOR(x0, t, 18);
+        x1 = vextq_u32(x1, x1, 1);
+        x2 = vextq_u32(x2, x2, 2);
+        x3 = vextq_u32(x3, x3, 3);
+    }
+
+    vst1q_u32(inout->words, vaddq_u32(in0, x0));
+    vst1q_u32(inout->words + 4, vaddq_u32(in1, x1));
+    vst1q_u32(inout->words + 8, vaddq_u32(in2, x2));
+    vst1q_u32(inout->words + 12, vaddq_u32(in3, x3));
+}
+#undef CCRYPTOBORINGSSLSHIMS_SALSA_ROTL_XOR
+#else
+#define CCRYPTOBORINGSSLSHIMS_SALSA_QUARTER(a, b, c, d)     \
+    do {                                                    \
+        x[b] ^= CRYPTO_rotl_u32(x[a] + x[d], 7);            \
+        x[c] ^= CRYPTO_rotl_u32(x[b] + x[a], 9);            \
+        x[d] ^= CRYPTO_rotl_u32(x[c] + x[b], 13);           \
+        x[a] ^= CRYPTO_rotl_u32(x[d] + x[c], 18);           \
+    } while (0)
+
+// Salsa20/8 in the specification's layout, as in scrypt.c.
+static void CCryptoBoringSSLShims_salsa208(CCryptoBoringSSLShims_salsa_block *inout) {
+    uint32_t x[16];
+    memcpy(x, inout->words, sizeof(x));
+    for (int i = 0; i < 8; i += 2) {
+        CCRYPTOBORINGSSLSHIMS_SALSA_QUARTER(0, 4, 8, 12);
+        CCRYPTOBORINGSSLSHIMS_SALSA_QUARTER(5, 9, 13, 1);
+        CCRYPTOBORINGSSLSHIMS_SALSA_QUARTER(10, 14, 2, 6);
+        CCRYPTOBORINGSSLSHIMS_SALSA_QUARTER(15, 3, 7, 11);
+        CCRYPTOBORINGSSLSHIMS_SALSA_QUARTER(0, 1, 2, 3);
+        CCRYPTOBORINGSSLSHIMS_SALSA_QUARTER(5, 6, 7, 4);
+        CCRYPTOBORINGSSLSHIMS_SALSA_QUARTER(10, 11, 8, 9);
+        CCRYPTOBORINGSSLSHIMS_SALSA_QUARTER(15, 12, 13, 14);
+    }
+    for (size_t i = 0; i < 16; i++) {
+        inout->words[i] += x[i];
+    }
+}
+#undef CCRYPTOBORINGSSLSHIMS_SALSA_QUARTER
+#endif
+
+static void CCryptoBoringSSLShims_salsa_xor(CCryptoBoringSSLShims_salsa_block *out,
+                                            const CCryptoBoringSSLShims_salsa_block *a,
+                                            const CCryptoBoringSSLShims_salsa_block *b) {
+    for (size_t i = 0; i < 16; i++) {
+        out->words[i] = a->words[i] ^ b->words[i];
+    }
+}
+
+// scryptBlockMix, RFC 7914, section 4. Both layouts permute words the same way
+// in every block, so this is layout-independent.
+static void CCryptoBoringSSLShims_scrypt_block_mix(CCryptoBoringSSLShims_salsa_block *out,
+                                                   const CCryptoBoringSSLShims_salsa_block *in, uint64_t r) {
+    CCryptoBoringSSLShims_salsa_block x = in[2 * r - 1];
+    for (uint64_t i = 0; i < 2 * r; i++) {
+        CCryptoBoringSSLShims_salsa_xor(&x, &x, &in[i]);
+        CCryptoBoringSSLShims_salsa208(&x);
+        out[i / 2 + (i & 1) * r] = x;
+    }
+}
+
+// How many ROMix iterations run between checks of the cancellation flag. Each
+// one is 2 * r Salsa20/8 calls, so this is well under a millisecond for
+// typical r.
+#define CCRYPTOBORINGSSLSHIMS_SCRYPT_CANCEL_INTERVAL 256
+
+// scryptROMix, RFC 7914, section 5, on the scrypt block |b| in place. |t| is
+// one scrypt block and |v| is |n| scrypt blocks of scratch space. Returns zero,
+// leaving |b| unfinished, if |cancel| is set. |*v_written| is raised to the
+// number of scrypt blocks of |v| that have been written.
+static int CCryptoBoringSSLShims_scrypt_romix(CCryptoBoringSSLShims_salsa_block *b, uint64_t r, uint64_t n,
+                                              CCryptoBoringSSLShims_salsa_block *t,
+                                              CCryptoBoringSSLShims_salsa_block *v,
+                                              const CCryptoBoringSSLShims_CANCEL_FLAG *cancel,
+                                              uint64_t *v_written) {
+#if defined(CCRYPTOBORINGSSLSHIMS_SCRYPT_SSE2) || defined(CCRYPTOBORINGSSLSHIMS_SCRYPT_NEON)
+    CCryptoBoringSSLShims_salsa_to_vector_layout(b, 2 * r);
+#endif
+
+    memcpy(v, b, 2 * r * sizeof(*b));
+    for (uint64_t i = 1; i < n; i++) {
+        if (i % CCRYPTOBORINGSSLSHIMS_SCRYPT_CANCEL_INTERVAL == 0 && CCryptoBoringSSLShims_CANCEL_FLAG_is_set(cancel)) {
+            if (*v_written < i) {
+                *v_written = i;
+            }
+            return 0;
+        }
+        CCryptoBoringSSLShims_scrypt_block_mix(&v[2 * r * i], &v[2 * r * (i - 1)], r);
+    }
+    *v_written = n;
+    CCryptoBoringSSLShims_scrypt_block_mix(b, &v[2 * r * (n - 1)], r);
+
+    for (uint64_t i = 0; i < n; i++) {
+        if (i % CCRYPTOBORINGSSLSHIMS_SCRYPT_CANCEL_INTERVAL == 0 && CCryptoBoringSSLShims_CANCEL_FLAG_is_set(cancel)) {
+            return 0;
+        }
+        // Integerify reads word 0 of the last Salsa20 block, which is word 0 in
+        // both layouts.
+        const uint64_t j = b[2 * r - 1].words[0] & (n - 1);
+        for (size_t k = 0; k < 2 * r; k++) {
+            CCryptoBoringSSLShims_salsa_xor(&t[k], &b[k], &v[2 * r * j + k]);
+        }
+        CCryptoBoringSSLShims_scrypt_block_mix(b, t, r);
+    }
+
+#if defined(CCRYPTOBORINGSSLSHIMS_SCRYPT_SSE2) || defined(CCRYPTOBORINGSSLSHIMS_SCRYPT_NEON)
+    CCryptoBoringSSLShims_salsa_from_vector_layout(b, 2 * r);
+#endif
+    return 1;
+}
+
+// One thread's share of the p lanes: lanes |first|, |first| + |stride|, ... of
+// |b|, all using the same scratch space.
+typedef struct {
+    CCryptoBoringSSLShims_salsa_block *b;
+    uint64_t r;
+    uint64_t n;
+    uint64_t p;
+    uint64_t first;
+    uint64_t stride;
+    CCryptoBoringSSLShims_salsa_block *t;
+    CCryptoBoringSSLShims_salsa_block *v;
+    const CCryptoBoringSSLShims_CANCEL_FLAG *cancel;
+    // Set by the worker if it stopped because of |cancel|, along with how much
+    // of |v| it had written by then.
+    int cancelled;
+    uint64_t v_written;
+} CCryptoBoringSSLShims_scrypt_worker;
+
+static void *CCryptoBoringSSLShims_scrypt_worker_run(void *arg) {
+    CCryptoBoringSSLShims_scrypt_worker *worker = arg;
+    for (uint64_t lane = worker->first; lane < worker->p; lane += worker->stride) {
+        if (!CCryptoBoringSSLShims_scrypt_romix(worker->b + 2 * worker->r * lane, worker->r, worker->n, worker->t,
+                                                worker->v, worker->cancel, &worker->v_written)) {
+            worker->cancelled = 1;
+            break;
+        }
+    }
+    return NULL;
+}
+
+// Allocates the scratch space for every worker as one zeroed region, which is
+// page-aligned when mapped directly.
+static void *CCryptoBoringSSLShims_scrypt_alloc(size_t len, int use_huge_pages) {
+#if defined(CCRYPTOBORINGSSLSHIMS_SCRYPT_MMAP)
+    void *region = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED) {
+        return NULL;
+    }
+#if defined(MADV_HUGEPAGE)
+    if (use_huge_pages) {
+        // Only advice: without transparent huge pages this fails harmlessly.
+        madvise(region, len, MADV_HUGEPAGE);
+    }
+#else
+    (void)use_huge_pages;
+#endif
+    return region;
+#else
+    (void)use_huge_pages;
+    return CCryptoBoringSSL_OPENSSL_zalloc(len);
+#endif
+}
+
+// Releases the scratch region without clearing it.
+static void CCryptoBoringSSLShims_scrypt_unmap(void *region, size_t len) {
+#if defined(CCRYPTOBORINGSSLSHIMS_SCRYPT_MMAP)
+    munmap(region, len);
+#else
+    CCryptoBoringSSL_OPENSSL_free(region);
+#endif
+}
+
+static void CCryptoBoringSSLShims_scrypt_free(void *region, size_t len) {
+    CCryptoBoringSSL_OPENSSL_cleanse(region, len);
+    CCryptoBoringSSLShims_scrypt_unmap(region, len);
+}
+
+int CCryptoBoringSSLShims_scrypt(const void *password, size_t password_len, const void *salt, size_t salt_len,
+                                 uint64_t N, uint64_t r, uint64_t p, size_t max_mem, size_t max_threads,
+                                 int use_huge_pages, void *out_key, size_t key_len,
+                                 const CCryptoBoringSSLShims_CANCEL_FLAG *cancel) {
+    // The same parameter limits as EVP_PBE_scrypt, including p * r < 2^30.
+    if (r == 0 || p == 0 || p > ((1 << 30) - 1) / r || N < 2 || (N & (N - 1)) || N > UINT64_C(1) << 32 ||
+        (16 * r <= 63 && N >= UINT64_C(1) << (16 * r))) {
+        return 0;
+    }
+    if (max_mem == 0) {
+        max_mem = CCryptoBoringSSLShims_SCRYPT_DEFAULT_MAX_MEM;
+    }
+
+    // B is p scrypt blocks, and each worker needs one scrypt block for T and N
+    // for V. Use as many workers as fit in |max_mem|, up to |max_threads| and p.
+    const size_t scrypt_block_bytes = 2 * r * sizeof(CCryptoBoringSSLShims_salsa_block);
+    const size_t max_scrypt_blocks = max_mem / scrypt_block_bytes;
+    if (max_scrypt_blocks < p || max_scrypt_blocks - p < N + 1) {
+        return 0;
+    }
+    uint64_t workers = (max_scrypt_blocks - p) / (N + 1);
+    if (max_threads == 0) {
+        max_threads = 1;
+    }
+    if (max_threads > CCryptoBoringSSLShims_SCRYPT_MAX_THREADS) {
+        max_threads = CCryptoBoringSSLShims_SCRYPT_MAX_THREADS;
+    }
+#if !defined(CCRYPTOBORINGSSLSHIMS_PARALLEL_SCRYPT)
+    max_threads = 1;
+#endif
+    if (workers > max_threads) {
+        workers = max_threads;
+    }
+    if (workers > p) {
+        workers = p;
+    }
+
+    const size_t b_bytes = p * scrypt_block_bytes;
+    const size_t scratch_bytes = (N + 1) * scrypt_block_bytes;
+    const size_t region_bytes = b_bytes + workers * scratch_bytes;
+    uint8_t *region = CCryptoBoringSSLShims_scrypt_alloc(region_bytes, use_huge_pages);
+    if (region == NULL) {
+        return 0;
+    }
+    CCryptoBoringSSLShims_salsa_block *b = (CCryptoBoringSSLShims_salsa_block *)region;
+
+    // The PBKDF2 output is the little-endian serialization of B, as in
+    // scrypt.c, which assumes a little-endian target.
+    if (!CCryptoBoringSSLShims_PBKDF2_HMAC_SHA256(password, password_len, salt, salt_len, 1, b, b_bytes)) {
+        CCryptoBoringSSLShims_scrypt_free(region, region_bytes);
+        return 0;
+    }
+
+    CCryptoBoringSSLShims_scrypt_worker worker_state[CCryptoBoringSSLShims_SCRYPT_MAX_THREADS];
+    for (uint64_t w = 0; w < workers; w++) {
+        CCryptoBoringSSLShims_salsa_block *scratch =
+            (CCryptoBoringSSLShims_salsa_block *)(region + b_bytes + w * scratch_bytes);
+        worker_state[w] = (CCryptoBoringSSLShims_scrypt_worker){b, r, N, p, w, workers, scratch, scratch + 2 * r, cancel, 0, 0};
+    }
+
+#if defined(CCRYPTOBORINGSSLSHIMS_PARALLEL_SCRYPT)
+    pthread_t threads[CCryptoBoringSSLShims_SCRYPT_MAX_THREADS];
+    int started[CCryptoBoringSSLShims_SCRYPT_MAX_THREADS] = {0};
+    for (uint64_t w = 1; w < workers; w++) {
+        started[w] = pthread_create(&threads[w], NULL, CCryptoBoringSSLShims_scrypt_worker_run, &worker_state[w]) == 0;
+    }
+#endif
+    CCryptoBoringSSLShims_scrypt_worker_run(&worker_state[0]);
+    for (uint64_t w = 1; w < workers; w++) {
+#if defined(CCRYPTOBORINGSSLSHIMS_PARALLEL_SCRYPT)
+        if (started[w]) {
+            pthread_join(threads[w], NULL);
+            continue;
+        }
+#endif
+        // The thread could not be started, so its lanes run here instead.
+        CCryptoBoringSSLShims_scrypt_worker_run(&worker_state[w]);
+    }
+    int cancelled = 0;
+    for (uint64_t w = 0; w < workers; w++) {
+        cancelled |= worker_state[w].cancelled;
+    }
+    if (cancelled) {
+        // Clearing all of a large region would fault in pages that were never
+        // touched, which can take longer than the work that was cancelled. Only
+        // B and each worker's T and the written part of V hold anything.
+        CCryptoBoringSSL_OPENSSL_cleanse(region, b_bytes);
+        for (uint64_t w = 0; w < workers; w++) {
+            CCryptoBoringSSL_OPENSSL_cleanse(region + b_bytes + w * scratch_bytes,
+                                             (1 + worker_state[w].v_written) * scrypt_block_bytes);
+        }
+        CCryptoBoringSSLShims_scrypt_unmap(region, region_bytes);
+        return 0;
+    }
+
+    const int ret = CCryptoBoringSSLShims_PBKDF2_HMAC_SHA256(password, password_len, b, b_bytes, 1, out_key, key_len);
+    CCryptoBoringSSLShims_scrypt_free(region, region_bytes);
+    return ret;
+}
+
+// MARK:- Batch AES key wrap
+
+// The default IV of RFC 3394, section 2.2.3.1.
+static const uint8_t CCryptoBoringSSLShims_aes_wrap_default_iv[8] = {
+    0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6,
+};
+
+// The number of keys whose blocks are sent to the block function together.
+// Each step of a wrap depends on the previous one, so this is what fills the
+// pipelined ECB kernel.
+#define CCRYPTOBORINGSSLSHIMS_AES_WRAP_LANES 32
+
+static void CCryptoBoringSSLShims_aes_wrap_xor_t(uint8_t a[8], uint32_t t) {
+    a[7] ^= t & 0xff;
+    a[6] ^= (t >> 8) & 0xff;
+    a[5] ^= (t >> 16) & 0xff;
+    a[4] ^= (t >> 24) & 0xff;
+}
+
+// Runs up to CCRYPTOBORINGSSLSHIMS_AES_WRAP_LANES wraps or unwraps in
+// lockstep: step s of every key that still has one goes through the block
+// function in a single call. |a| holds each key's integrity register and |r|
+// points at its n 8-byte registers.
+static void CCryptoBoringSSLShims_aes_wrap_lanes(const AES_KEY *key, int enc, size_t count,
+                                                 uint8_t a[][8], uint8_t *const *r, const size_t *n) {
+    uint8_t blocks[CCRYPTOBORINGSSLSHIMS_AES_WRAP_LANES * AES_BLOCK_SIZE];
+    size_t lanes[CCRYPTOBORINGSSLSHIMS_AES_WRAP_LANES];
+
+    size_t max_steps = 0;
+    for (size_t k = 0; k < count; k++) {
+        if (6 * n[k] > max_steps) {
+            max_steps = 6 * n[k];
+        }
+    }
+
+    for (size_t s = 0; s < max_steps; s++) {
+        size_t active = 0;
+        for (size_t k = 0; k < count; k++) {
+            const size_t steps = 6 * n[k];
+            if (s >= steps) {
+                continue;
+            }
+            // Wrapping walks j = 0..5, i = 1..n forwards; unwrapping walks the
+            // same sequence backwards. Either way step number L has t = L + 1.
+            const size_t step = enc ? s : steps - 1 - s;
+            uint8_t *block = blocks + active * AES_BLOCK_SIZE;
+            memcpy(block, a[k], 8);
+            if (!enc) {
+                CCryptoBoringSSLShims_aes_wrap_xor_t(block, (uint32_t)(step + 1));
+            }
+            memcpy(block + 8, r[k] + 8 * (step % n[k]), 8);
+            lanes[active++] = k;
+        }
+
+        CCryptoBoringSSLShims_AES_ecb_encrypt_blocks(blocks, blocks, active * AES_BLOCK_SIZE, key, enc);
+
+        for (size_t lane = 0; lane < active; lane++) {
+            const size_t k = lanes[lane];
+            const size_t step = enc ? s : 6 * n[k] - 1 - s;
+            const uint8_t *block = blocks + lane * AES_BLOCK_SIZE;
+            memcpy(a[k], block, 8);
+            if (enc) {
+                CCryptoBoringSSLShims_aes_wrap_xor_t(a[k], (uint32_t)(step + 1));
+            }
+            memcpy(r[k] + 8 * (step % n[k]), block + 8, 8);
+        }
+    }
+    CCryptoBoringSSL_OPENSSL_cleanse(blocks, sizeof(blocks));
+}
+
+size_t CCryptoBoringSSLShims_AES_wrap_key_batch(const AES_KEY *key, CCryptoBoringSSLShims_AES_wrap_batch_op *ops,
+                                                size_t ops_count) {
+    size_t failures = 0;
+    for (size_t first = 0; first < ops_count; first += CCRYPTOBORINGSSLSHIMS_AES_WRAP_LANES) {
+        uint8_t a[CCRYPTOBORINGSSLSHIMS_AES_WRAP_LANES][8];
+        uint8_t *r[CCRYPTOBORINGSSLSHIMS_AES_WRAP_LANES];
+        size_t n[CCRYPTOBORINGSSLSHIMS_AES_WRAP_LANES];
+        CCryptoBoringSSLShims_AES_wrap_batch_op *chunk[CCRYPTOBORINGSSLSHIMS_AES_WRAP_LANES];
+        size_t count = 0;
+
+        for (size_t i = first; i < ops_count && i < first + CCRYPTOBORINGSSLSHIMS_AES_WRAP_LANES; i++) {
+            CCryptoBoringSSLShims_AES_wrap_batch_op *op = &ops[i];
+            // The same limits as AES_wrap_key.
+            if (op->in_len > INT_MAX - 8 || op->in_len < 16 || op->in_len % 8 != 0) {
+                op->result = 0;
+                failures++;
+                continue;
+            }
+            memmove((uint8_t *)op->out + 8, op->in, op->in_len);
+            memcpy(a[count], CCryptoBoringSSLShims_aes_wrap_default_iv, 8);
+            r[count] = (uint8_t *)op->out + 8;
+            n[count] = op->in_len / 8;
+            chunk[count++] = op;
+        }
+
+        CCryptoBoringSSLShims_aes_wrap_lanes(key, 1, count, a, r, n);
+
+        for (size_t k = 0; k < count; k++) {
+            memcpy(chunk[k]->out, a[k], 8);
+            chunk[k]->result = 1;
+        }
+    }
+    return failures;
+}
+
+size_t CCryptoBoringSSLShims_AES_unwrap_key_batch(const AES_KEY *key, CCryptoBoringSSLShims_AES_wrap_batch_op *ops,
+                                                  size_t ops_count) {
+    size_t failures = 0;
+    for (size_t first = 0; first < ops_count; first += CCRYPTOBORINGSSLSHIMS_AES_WRAP_LANES) {
+        uint8_t a[CCRYPTOBORINGSSLSHIMS_AES_WRAP_LANES][8];
+        uint8_t *r[CCRYPTOBORINGSSLSHIMS_AES_WRAP_LANES];
+        size_t n[CCRYPTOBORINGSSLSHIMS_AES_WRAP_LANES];
+        CCryptoBoringSSLShims_AES_wrap_batch_op *chunk[CCRYPTOBORINGSSLSHIMS_AES_WRAP_LANES];
+        size_t count = 0;
+
+        for (size_t i = first; i < ops_count && i < first + CCRYPTOBORINGSSLSHIMS_AES_WRAP_LANES; i++) {
+            CCryptoBoringSSLShims_AES_wrap_batch_op *op = &ops[i];
+            // The same limits as AES_unwrap_key.
+            if (op->in_len > INT_MAX || op->in_len < 24 || op->in_len % 8 != 0) {
+                op->result = 0;
+                failures++;
+                continue;
+            }
+            memcpy(a[count], op->in, 8);
+            memmove(op->out, (const uint8_t *)op->in + 8, op->in_len - 8);
+            r[count] = op->out;
+            n[count] = op->in_len / 8 - 1;
+            chunk[count++] = op;
+        }
+
+        CCryptoBoringSSLShims_aes_wrap_lanes(key, 0, count, a, r, n);
+
+        for (size_t k = 0; k < count; k++) {
+            chunk[k]->result = CRYPTO_memcmp(a[k], CCryptoBoringSSLShims_aes_wrap_default_iv, 8) == 0;
+            if (!chunk[k]->result) {
+                // Never hand back the output of a failed integrity check.
+                CCryptoBoringSSL_OPENSSL_cleanse(chunk[k]->out, 8 * n[k]);
+                failures++;
+            }
+        }
+    }
+    return failures;
+}
+
+// MARK:- Parallel trust token issuance
+
+#if !defined(_WIN32) && !defined(OPENSSL_NO_THREADS_CORRUPT_MEMORY_AND_LEAK_SECRETS_IF_THREADED)
+#define CCRYPTOBORINGSSLSHIMS_PARALLEL_TRUST_TOKEN 1
+#include <pthread.h>
+#endif
+
+typedef struct {
+    const TRUST_TOKEN_ISSUER *issuer;
+    CCryptoBoringSSLShims_TRUST_TOKEN_issue_op *ops;
+    size_t ops_count;
+    uint32_t public_metadata;
+    uint8_t private_metadata;
+    size_t max_issuance;
+    size_t worker;
+    size_t workers;
+    size_t failures;
+} CCryptoBoringSSLShims_trust_token_worker;
+
+static void *CCryptoBoringSSLShims_trust_token_worker_run(void *arg) {
+    CCryptoBoringSSLShims_trust_token_worker *worker = arg;
+    // Requests are dealt out round-robin, which keeps the split even when
+    // neighbouring requests ask for similar numbers of tokens.
+    for (size_t i = worker->worker; i < worker->ops_count; i += worker->workers) {
+        CCryptoBoringSSLShims_TRUST_TOKEN_issue_op *op = &worker->ops[i];
+        op->out = NULL;
+        op->out_len = 0;
+        op->tokens_issued = 0;
+        op->result = CCryptoBoringSSL_TRUST_TOKEN_ISSUER_issue(worker->issuer, &op->out, &op->out_len,
+                                                               &op->tokens_issued, op->request, op->request_len,
+                                                               worker->public_metadata, worker->private_metadata,
+                                                               worker->max_issuance);
+        if (!op->result) {
+            worker->failures++;
+        }
+    }
+    // Each thread has its own error queue, so leave nothing on it.
+    CCryptoBoringSSL_ERR_clear_error();
+    return NULL;
+}
+
+size_t CCryptoBoringSSLShims_TRUST_TOKEN_ISSUER_issue_batch(const TRUST_TOKEN_ISSUER *issuer,
+                                                            CCryptoBoringSSLShims_TRUST_TOKEN_issue_op *ops,
+                                                            size_t ops_count, uint32_t public_metadata,
+                                                            uint8_t private_metadata, size_t max_issuance,
+                                                            size_t max_threads) {
+    size_t workers = max_threads;
+    if (workers == 0) {
+        workers = 1;
+    }
+    if (workers > CCryptoBoringSSLShims_TRUST_TOKEN_MAX_THREADS) {
+        workers = CCryptoBoringSSLShims_TRUST_TOKEN_MAX_THREADS;
+    }
+#if !defined(CCRYPTOBORINGSSLSHIMS_PARALLEL_TRUST_TOKEN)
+    workers = 1;
+#endif
+    if (workers > ops_count) {
+        workers = ops_count;
+    }
+    if (workers == 0) {
+        return 0;
+    }
+
+    CCryptoBoringSSLShims_trust_token_worker worker_state[CCryptoBoringSSLShims_TRUST_TOKEN_MAX_THREADS];
+    for (size_t w = 0; w < workers; w++) {
+        worker_state[w] = (CCryptoBoringSSLShims_trust_token_worker){
+            issuer, ops, ops_count, public_metadata, private_metadata, max_issuance, w, workers, 0,
+        };
+    }
+
+#if defined(CCRYPTOBORINGSSLSHIMS_PARALLEL_TRUST_TOKEN)
+    pthread_t threads[CCryptoBoringSSLShims_TRUST_TOKEN_MAX_THREADS];
+    int started[CCryptoBoringSSLShims_TRUST_TOKEN_MAX_THREADS] = {0};
+    for (size_t w = 1; w < workers; w++) {
+        started[w] =
+            pthread_create(&threads[w], NULL, CCryptoBoringSSLShims_trust_token_worker_run, &worker_state[w]) == 0;
+    }
+#endif
+    CCryptoBoringSSLShims_trust_token_worker_run(&worker_state[0]);
+    size_t failures = worker_state[0].failures;
+    for (size_t w = 1; w < workers; w++) {
+#if defined(CCRYPTOBORINGSSLSHIMS_PARALLEL_TRUST_TOKEN)
+        if (started[w]) {
+            pthread_join(threads[w], NULL);
+            failures += worker_state[w].failures;
+            continue;
+        }
+#endif
+        // The thread could not be started, so its requests are issued here instead.
+        CCryptoBoringSSLShims_trust_token_worker_run(&worker_state[w]);
+        failures += worker_state[w].failures;
+    }
+    return failures;
+}
+
+// MARK:- GMAC and POLYVAL
+
+struct CCryptoBoringSSLShims_GHASH_KEY_st {
+    // The GHASH kernels that use SSSE3 need |Htable| to be 16-byte aligned.
+    alignas(16) u128 Htable[16];
+    gmult_func gmult;
+    ghash_func ghash;
+    // Only used by GMAC, to encrypt the pre-counter block.
+    AES_KEY aes;
+    // The allocation this key was carved out of, so that it can be aligned.
+    void *allocation;
+};
+
+static CCryptoBoringSSLShims_GHASH_KEY *CCryptoBoringSSLShims_GHASH_KEY_alloc(void) {
+    void *allocation = CCryptoBoringSSL_OPENSSL_zalloc(sizeof(CCryptoBoringSSLShims_GHASH_KEY) + 15);
+    if (allocation == NULL) {
+        return NULL;
+    }
+    CCryptoBoringSSLShims_GHASH_KEY *key =
+        (CCryptoBoringSSLShims_GHASH_KEY *)(((uintptr_t)allocation + 15) & ~(uintptr_t)15);
+    key->allocation = allocation;
+    return key;
+}
+
+CCryptoBoringSSLShims_GHASH_KEY *CCryptoBoringSSLShims_GMAC_KEY_new(const uint8_t *key, size_t key_len) {
+    if (key_len != 16 && key_len != 24 && key_len != 32) {
+        return NULL;
+    }
+    CCryptoBoringSSLShims_GHASH_KEY *out = CCryptoBoringSSLShims_GHASH_KEY_alloc();
+    if (out == NULL) {
+        return NULL;
+    }
+    if (CCryptoBoringSSL_AES_set_encrypt_key(key, (unsigned)key_len * 8, &out->aes) != 0) {
+        CCryptoBoringSSLShims_GHASH_KEY_free(out);
+        return NULL;
+    }
+
+    uint8_t h[16] = {0};
+    CCryptoBoringSSL_AES_encrypt(h, h, &out->aes);
+    int is_avx;
+    CRYPTO_ghash_init(&out->gmult, &out->ghash, out->Htable, &is_avx, h);
+    CCryptoBoringSSL_OPENSSL_cleanse(h, sizeof(h));
+    return out;
+}
+
+// The POLYVAL key transform from polyval.c: POLYVAL(H, X_1, ..., X_n) is
+// ByteReverse(GHASH(mulX_GHASH(ByteReverse(H)), ByteReverse(X_1), ...)).
+static void CCryptoBoringSSLShims_polyval_byte_reverse(uint8_t b[16]) {
+    uint64_t hi = CRYPTO_load_u64_le(b);
+    uint64_t lo = CRYPTO_load_u64_le(b + 8);
+    CRYPTO_store_u64_le(b, CRYPTO_bswap8(lo));
+    CRYPTO_store_u64_le(b + 8, CRYPTO_bswap8(hi));
+}
+
+CCryptoBoringSSLShims_GHASH_KEY *CCryptoBoringSSLShims_POLYVAL_KEY_new(const uint8_t key[16]) {
+    CCryptoBoringSSLShims_GHASH_KEY *out = CCryptoBoringSSLShims_GHASH_KEY_alloc();
+    if (out == NULL) {
+        return NULL;
+    }
+
+    // reverse_and_mulX_ghash from polyval.c.
+    uint64_t hi = CRYPTO_load_u64_le(key);
+    uint64_t lo = CRYPTO_load_u64_le(key + 8);
+    const crypto_word_t carry = constant_time_eq_w(hi & 1, 1);
+    hi >>= 1;
+    hi |= lo << 63;
+    lo >>= 1;
+    lo ^= ((uint64_t)constant_time_select_w(carry, 0xe1, 0)) << 56;
+    uint8_t h[16];
+    CRYPTO_store_u64_le(h, CRYPTO_bswap8(lo));
+    CRYPTO_store_u64_le(h + 8, CRYPTO_bswap8(hi));
+
+    int is_avx;
+    CRYPTO_ghash_init(&out->gmult, &out->ghash, out->Htable, &is_avx, h);
+    CCryptoBoringSSL_OPENSSL_cleanse(h, sizeof(h));
+    return out;
+}
+
+void CCryptoBoringSSLShims_GHASH_KEY_free(CCryptoBoringSSLShims_GHASH_KEY *key) {
+    if (key == NULL) {
+        return;
+    }
+    void *allocation = key->allocation;
+    CCryptoBoringSSL_OPENSSL_cleanse(key, sizeof(*key));
+    CCryptoBoringSSL_OPENSSL_free(allocation);
+}
+
+// Hashes whole blocks into |ctx->Xi|. POLYVAL's blocks are byte-reversed on
+// the way in, through a stack buffer; GHASH reads the input directly.
+static void CCryptoBoringSSLShims_ghash_blocks(CCryptoBoringSSLShims_GHASH_CTX *ctx,
+                                               const CCryptoBoringSSLShims_GHASH_KEY *key, const uint8_t *in,
+                                               size_t len, int polyval) {
+    if (!polyval) {
+        key->ghash(ctx->Xi, key->Htable, in, len);
+        return;
+    }
+
+    alignas(16) uint8_t buf[32 * 16];
+    while (len > 0) {
+        size_t todo = len < sizeof(buf) ? len : sizeof(buf);
+        memcpy(buf, in, todo);
+        for (size_t i = 0; i < todo; i += 16) {
+            CCryptoBoringSSLShims_polyval_byte_reverse(buf + i);
+        }
+        key->ghash(ctx->Xi, key->Htable, buf, todo);
+        in += todo;
+        len -= todo;
+    }
+}
+
+static int CCryptoBoringSSLShims_ghash_update(CCryptoBoringSSLShims_GHASH_CTX *ctx,
+                                              const CCryptoBoringSSLShims_GHASH_KEY *key, const void *in_void,
+                                              size_t len, int polyval) {
+    const uint8_t *in = in_void;
+    // GCM limits the additional data to 2^61 bytes, so that its bit length
+    // fits the length block.
+    if (len > (UINT64_C(1) << 61) - ctx->len) {
+        return 0;
+    }
+    ctx->len += len;
+
+    if (ctx->partial_len > 0) {
+        size_t todo = 16 - ctx->partial_len;
+        if (todo > len) {
+            todo = len;
+        }
+        memcpy(ctx->partial + ctx->partial_len, in, todo);
+        ctx->partial_len += todo;
+        in += todo;
+        len -= todo;
+        if (ctx->partial_len < 16) {
+            return 1;
+        }
+        CCryptoBoringSSLShims_ghash_blocks(ctx, key, ctx->partial, 16, polyval);
+        ctx->partial_len = 0;
+    }
+
+    const size_t whole = len & ~(size_t)15;
+    if (whole > 0) {
+        CCryptoBoringSSLShims_ghash_blocks(ctx, key, in, whole, polyval);
+        in += whole;
+        len -= whole;
+    }
+    if (len > 0) {
+        memcpy(ctx->partial, in, len);
+        ctx->partial_len = len;
+    }
+    return 1;
+}
+
+// Zero-pads and hashes any buffered partial block.
+static void CCryptoBoringSSLShims_ghash_flush(CCryptoBoringSSLShims_GHASH_CTX *ctx,
+                                              const CCryptoBoringSSLShims_GHASH_KEY *key, int polyval) {
+    if (ctx->partial_len > 0) {
+        memset(ctx->partial + ctx->partial_len, 0, 16 - ctx->partial_len);
+        CCryptoBoringSSLShims_ghash_blocks(ctx, key, ctx->partial, 16, polyval);
+        ctx->partial_len = 0;
+    }
+}
+
+int CCryptoBoringSSLShims_GMAC_init(CCryptoBoringSSLShims_GHASH_CTX *ctx, const CCryptoBoringSSLShims_GHASH_KEY *key,
+                                    const uint8_t *nonce, size_t nonce_len) {
+    if (nonce_len == 0) {
+        return 0;
+    }
+    memset(ctx, 0, sizeof(*ctx));
+
+    // The pre-counter block J0, as in CRYPTO_gcm128_setiv.
+    uint8_t j0[16];
+    if (nonce_len == 12) {
+        memcpy(j0, nonce, 12);
+        memset(j0 + 12, 0, 3);
+        j0[15] = 1;
+    } else {
+        if (!CCryptoBoringSSLShims_ghash_update(ctx, key, nonce, nonce_len, 0)) {
+            return 0;
+        }
+        CCryptoBoringSSLShims_ghash_flush(ctx, key, 0);
+        uint8_t len_block[16] = {0};
+        CRYPTO_store_u64_be(len_block + 8, (uint64_t)nonce_len * 8);
+        CCryptoBoringSSLShims_ghash_blocks(ctx, key, len_block, 16, 0);
+        memcpy(j0, ctx->Xi, 16);
+        memset(ctx, 0, sizeof(*ctx));
+    }
+    CCryptoBoringSSL_AES_encrypt(j0, ctx->EK0, &key->aes);
+    return 1;
+}
+
+int CCryptoBoringSSLShims_GMAC_update(CCryptoBoringSSLShims_GHASH_CTX *ctx, const CCryptoBoringSSLShims_GHASH_KEY *key,
+                                      const void *in, size_t len) {
+    return CCryptoBoringSSLShims_ghash_update(ctx, key, in, len, 0);
+}
+
+void CCryptoBoringSSLShims_GMAC_final(CCryptoBoringSSLShims_GHASH_CTX *ctx, const CCryptoBoringSSLShims_GHASH_KEY *key,
+                                      uint8_t out[16]) {
+    CCryptoBoringSSLShims_ghash_flush(ctx, key, 0);
+    // len(A) || len(C), with no ciphertext.
+    uint8_t len_block[16] = {0};
+    CRYPTO_store_u64_be(len_block, ctx->len * 8);
+    CCryptoBoringSSLShims_ghash_blocks(ctx, key, len_block, 16, 0);
+    for (size_t i = 0; i < 16; i++) {
+        out[i] = ctx->Xi[i] ^ ctx->EK0[i];
+    }
+    CCryptoBoringSSL_OPENSSL_cleanse(ctx, sizeof(*ctx));
+}
+
+void CCryptoBoringSSLShims_POLYVAL_init(CCryptoBoringSSLShims_GHASH_CTX *ctx) {
+    memset(ctx, 0, sizeof(*ctx));
+}
+
+int CCryptoBoringSSLShims_POLYVAL_update(CCryptoBoringSSLShims_GHASH_CTX *ctx,
+                                         const CCryptoBoringSSLShims_GHASH_KEY *key, const void *in, size_t len) {
+    return CCryptoBoringSSLShims_ghash_update(ctx, key, in, len, 1);
+}
+
+void CCryptoBoringSSLShims_POLYVAL_final(CCryptoBoringSSLShims_GHASH_CTX *ctx,
+                                         const CCryptoBoringSSLShims_GHASH_KEY *key, uint8_t out[16]) {
+    CCryptoBoringSSLShims_ghash_flush(ctx, key, 1);
+    memcpy(out, ctx->Xi, 16);
+    CCryptoBoringSSLShims_polyval_byte_reverse(out);
+    CCryptoBoringSSL_OPENSSL_cleanse(ctx, sizeof(*ctx));
+}
+
+// MARK:- AES-CMAC
+
+// Doubles |in| in GF(2^128) with the CMAC polynomial, as in RFC 4493 section
+// 2.3, without branching on the secret top bit.
+static void CCryptoBoringSSLShims_cmac_double(uint8_t out[16], const uint8_t in[16]) {
+    const uint64_t hi = CRYPTO_load_u64_be(in);
+    const uint64_t lo = CRYPTO_load_u64_be(in + 8);
+    const uint64_t carry = 0u - (hi >> 63);
+    CRYPTO_store_u64_be(out, (hi << 1) | (lo >> 63));
+    CRYPTO_store_u64_be(out + 8, (lo << 1) ^ (carry & 0x87));
+}
+
+int CCryptoBoringSSLShims_CMAC_KEY_init(CCryptoBoringSSLShims_CMAC_KEY *key, const uint8_t *aes_key, size_t aes_key_len) {
+    if ((aes_key_len != 16 && aes_key_len != 24 && aes_key_len != 32) ||
+        CCryptoBoringSSL_AES_set_encrypt_key(aes_key, (unsigned)aes_key_len * 8, &key->key) != 0) {
+        return 0;
+    }
+    uint8_t l[16] = {0};
+    CCryptoBoringSSL_AES_encrypt(l, l, &key->key);
+    CCryptoBoringSSLShims_cmac_double(key->k1, l);
+    CCryptoBoringSSLShims_cmac_double(key->k2, key->k1);
+    CCryptoBoringSSL_OPENSSL_cleanse(l, sizeof(l));
+    return 1;
+}
+
+void CCryptoBoringSSLShims_CMAC_init(CCryptoBoringSSLShims_CMAC_CTX *ctx) {
+    memset(ctx, 0, sizeof(*ctx));
+}
+
+// Runs whole blocks through the CBC-MAC chain. AES_cbc_encrypt uses the
+// pipelined aes_hw_cbc_encrypt kernel when the CPU has AES instructions; the
+// ciphertext itself is discarded.
+static void CCryptoBoringSSLShims_cmac_blocks(CCryptoBoringSSLShims_CMAC_CTX *ctx, const CCryptoBoringSSLShims_CMAC_KEY *key,
+                                              const uint8_t *in, size_t len) {
+    uint8_t scratch[32 * 16];
+    while (len > 0) {
+        const size_t todo = len < sizeof(scratch) ? len : sizeof(scratch);
+        CCryptoBoringSSL_AES_cbc_encrypt(in, scratch, todo, &key->key, ctx->X, AES_ENCRYPT);
+        in += todo;
+        len -= todo;
+    }
+    CCryptoBoringSSL_OPENSSL_cleanse(scratch, sizeof(scratch));
+}
+
+void CCryptoBoringSSLShims_CMAC_update(CCryptoBoringSSLShims_CMAC_CTX *ctx, const CCryptoBoringSSLShims_CMAC_KEY *key,
+                                       const void *in_void, size_t len) {
+    const uint8_t *in = in_void;
+    if (len == 0) {
+        return;
+    }
+
+    // The final block is treated differently, so a full block is only
+    // processed once more input is known to follow it.
+    if (ctx->block_used > 0) {
+        size_t todo = AES_BLOCK_SIZE - ctx->block_used;
+        if (todo > len) {
+            todo = len;
+        }
+        memcpy(ctx->block + ctx->block_used, in, todo);
+        ctx->block_used += todo;
+        in += todo;
+        len -= todo;
+        if (len == 0) {
+            return;
+        }
+        CCryptoBoringSSLShims_cmac_blocks(ctx, key, ctx->block, AES_BLOCK_SIZE);
+        ctx->block_used = 0;
+    }
+
+    // Keep between 1 and 16 bytes back for the final block.
+    const size_t bulk = (len - 1) & ~(size_t)(AES_BLOCK_SIZE - 1);
+    CCryptoBoringSSLShims_cmac_blocks(ctx, key, in, bulk);
+    memcpy(ctx->block, in + bulk, len - bulk);
+    ctx->block_used = len - bulk;
+}
+
+void CCryptoBoringSSLShims_CMAC_final(CCryptoBoringSSLShims_CMAC_CTX *ctx, const CCryptoBoringSSLShims_CMAC_KEY *key,
+                                      uint8_t out[16]) {
+    const uint8_t *subkey = key->k1;
+    if (ctx->block_used < AES_BLOCK_SIZE) {
+        ctx->block[ctx->block_used] = 0x80;
+        memset(ctx->block + ctx->block_used + 1, 0, AES_BLOCK_SIZE - ctx->block_used - 1);
+        subkey = key->k2;
+    }
+    for (size_t i = 0; i < AES_BLOCK_SIZE; i++) {
+        ctx->X[i] ^= ctx->block[i] ^ subkey[i];
+    }
+    CCryptoBoringSSL_AES_encrypt(ctx->X, out, &key->key);
+    CCryptoBoringSSL_OPENSSL_cleanse(ctx, sizeof(*ctx));
+}
+
+// MARK:- AES-CCM
+
+#if defined(HWAES) && defined(OPENSSL_X86_64) && (defined(__GNUC__) || defined(__clang__))
+#define CCRYPTOBORINGSSLSHIMS_CCM_AESNI 1
+#include <wmmintrin.h>
+#elif defined(CRYPTO_BORINGSSL_ARM_KERNELS) && defined(HWAES) && defined(OPENSSL_AARCH64) && defined(__ARM_FEATURE_AES)
+// Not yet run on AArch64 in CI, so opt-in; BoringSSL's block function is used
+// otherwise.
+#define CCRYPTOBORINGSSLSHIMS_CCM_ARMV8 1
+#include <arm_neon.h>
+#endif
+
+int CCryptoBoringSSLShims_CCM_KEY_init(CCryptoBoringSSLShims_CCM_KEY *key, const uint8_t *aes_key, size_t aes_key_len) {
+    if ((aes_key_len != 16 && aes_key_len != 24 && aes_key_len != 32) ||
+        CCryptoBoringSSL_AES_set_encrypt_key(aes_key, (unsigned)aes_key_len * 8, &key->key) != 0) {
+        return 0;
+    }
+    key->rounds = 6 + (unsigned)aes_key_len / 4;
+    return 1;
+}
+
+// Adds one to the counter block. The counter field is at least two bytes and
+// the message length check keeps it from wrapping, so a 64-bit add on the low
+// half never carries into the nonce.
+static void CCryptoBoringSSLShims_ccm_next_counter(uint8_t ctr[16]) {
+    CRYPTO_store_u64_be(ctr + 8, CRYPTO_load_u64_be(ctr + 8) + 1);
+}
+
+#if defined(CCRYPTOBORINGSSLSHIMS_CCM_AESNI)
+// Both block streams go through the rounds side by side: the CBC-MAC block
+// depends on the previous one, but the counter block does not, so its rounds
+// fill the gaps in the MAC's dependency chain. AES_set_encrypt_key used
+// aes_hw_set_encrypt_key, whose round keys are laid out as the instructions
+// expect.
+__attribute__((target("aes")))
+static void CCryptoBoringSSLShims_ccm_seal_blocks_aesni(const CCryptoBoringSSLShims_CCM_KEY *key, uint8_t mac[16],
+                                                        uint8_t ctr[16], const uint8_t *in, uint8_t *out,
+                                                        size_t blocks) {
+    __m128i rk[15];
+    for (unsigned r = 0; r <= key->rounds; r++) {
+        rk[r] = _mm_loadu_si128((const __m128i *)key->key.rd_key + r);
+    }
+    __m128i x = _mm_loadu_si128((const __m128i *)mac);
+    for (size_t i = 0; i < blocks; i++) {
+        const __m128i p = _mm_loadu_si128((const __m128i *)(in + 16 * i));
+        __m128i a = _mm_xor_si128(_mm_xor_si128(x, p), rk[0]);
+        __m128i b = _mm_xor_si128(_mm_loadu_si128((const __m128i *)ctr), rk[0]);
+        for (unsigned r = 1; r < key->rounds; r++) {
+            a = _mm_aesenc_si128(a, rk[r]);
+            b = _mm_aesenc_si128(b, rk[r]);
+        }
+        x = _mm_aesenclast_si128(a, rk[key->rounds]);
+        b = _mm_aesenclast_si128(b, rk[key->rounds]);
+        _mm_storeu_si128((__m128i *)(out + 16 * i), _mm_xor_si128(p, b));
+        CCryptoBoringSSLShims_ccm_next_counter(ctr);
+    }
+    _mm_storeu_si128((__m128i *)mac, x);
+}
+
+// Decryption needs the keystream before the plaintext can be MACed, so block
+// i's MAC runs alongside block i + 1's keystream.
+__attribute__((target("aes")))
+static void CCryptoBoringSSLShims_ccm_open_blocks_aesni(const CCryptoBoringSSLShims_CCM_KEY *key, uint8_t mac[16],
+                                                        uint8_t ctr[16], const uint8_t *in, uint8_t *out,
+                                                        size_t blocks) {
+    __m128i rk[15];
+    for (unsigned r = 0; r <= key->rounds; r++) {
+        rk[r] = _mm_loadu_si128((const __m128i *)key->key.rd_key + r);
+    }
+    __m128i x = _mm_loadu_si128((const __m128i *)mac);
+    __m128i s = _mm_xor_si128(_mm_loadu_si128((const __m128i *)ctr), rk[0]);
+    for (unsigned r = 1; r < key->rounds; r++) {
+        s = _mm_aesenc_si128(s, rk[r]);
+    }
+    s = _mm_aesenclast_si128(s, rk[key->rounds]);
+    CCryptoBoringSSLShims_ccm_next_counter(ctr);
+    for (size_t i = 0; i < blocks; i++) {
+        const __m128i p = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(in + 16 * i)), s);
+        _mm_storeu_si128((__m128i *)(out + 16 * i), p);
+        __m128i a = _mm_xor_si128(_mm_xor_si128(x, p), rk[0]);
+        if (i + 1 == blocks) {
+            for (unsigned r = 1; r < key->rounds; r++) {
+                a = _mm_aesenc_si128(a, rk[r]);
+            }
+            x = _mm_aesenclast_si128(a, rk[key->rounds]);
+            break;
+        }
+        __m128i b = _mm_xor_si128(_mm_loadu_si128((const __m128i *)ctr), rk[0]);
+        for (unsigned r = 1; r < key->rounds; r++) {
+            a = _mm_aesenc_si128(a, rk[r]);
+            b = _mm_aesenc_si128(b, rk[r]);
+        }
+        x = _mm_aesenclast_si128(a, rk[key->rounds]);
+        s = _mm_aesenclast_si128(b, rk[key->rounds]);
+        CCryptoBoringSSLShims_ccm_next_counter(ctr);
+    }
+    _mm_storeu_si128((__m128i *)mac, x);
+}
+#endif
+
+#if defined(CCRYPTOBORINGSSLSHIMS_CCM_ARMV8)
+// The ARMv8 version of the AES-NI kernels above. AESE adds the round key
+// before substituting, so the last round key is added on its own.
+static void CCryptoBoringSSLShims_ccm_seal_blocks_armv8(const CCryptoBoringSSLShims_CCM_KEY *key, uint8_t mac[16],
+                                                        uint8_t ctr[16], const uint8_t *in, uint8_t *out,
+                                                        size_t blocks) {
+    const unsigned rounds = key->rounds;
+    uint8x16_t rk[15];
+    for (unsigned r = 0; r <= rounds; r++) {
+        rk[r] = vld1q_u8((const uint8_t *)key->key.rd_key + 16 * r);
+    }
+    uint8x16_t x = vld1q_u8(mac);
+    for (size_t i = 0; i < blocks; i++) {
+        const uint8x16_t p = vld1q_u8(in + 16 * i);
+        uint8x16_t a = veorq_u8(x, p);
+        uint8x16_t b = vld1q_u8(ctr);
+        for (unsigned r = 0; r < rounds - 1; r++) {
+            a = vaesmcq_u8(vaeseq_u8(a, rk[r]));
+            b = vaesmcq_u8(vaeseq_u8(b, rk[r]));
+        }
+        x = veorq_u8(vaeseq_u8(a, rk[rounds - 1]), rk[rounds]);
+        b = veorq_u8(vaeseq_u8(b, rk[rounds - 1]), rk[rounds]);
+        vst1q_u8(out + 16 * i, veorq_u8(p, b));
+        CCryptoBoringSSLShims_ccm_next_counter(ctr);
+    }
+    vst1q_u8(mac, x);
+}
+
+static void CCryptoBoringSSLShims_ccm_open_blocks_armv8(const CCryptoBoringSSLShims_CCM_KEY *key, uint8_t mac[16],
+                                                        uint8_t ctr[16], const uint8_t *in, uint8_t *out,
+                                                        size_t blocks) {
+    const unsigned rounds = key->rounds;
+    uint8x16_t rk[15];
+    for (unsigned r = 0; r <= rounds; r++) {
+        rk[r] = vld1q_u8((const uint8_t *)key->key.rd_key + 16 * r);
+    }
+    uint8x16_t x = vld1q_u8(mac);
+    uint8x16_t s = vld1q_u8(ctr);
+    for (unsigned r = 0; r < rounds - 1; r++) {
+        s = vaesmcq_u8(vaeseq_u8(s, rk[r]));
+    }
+    s = veorq_u8(vaeseq_u8(s, rk[rounds - 1]), rk[rounds]);
+    CCryptoBoringSSLShims_ccm_next_counter(ctr);
+    for (size_t i = 0; i < blocks; i++) {
+        const uint8x16_t p = veorq_u8(vld1q_u8(in + 16 * i), s);
+        vst1q_u8(out + 16 * i, p);
+        uint8x16_t a = veorq_u8(x, p);
+        if (i + 1 == blocks) {
+            for (unsigned r = 0; r < rounds - 1; r++) {
+                a = vaesmcq_u8(vaeseq_u8(a, rk[r]));
+            }
+            x = veorq_u8(vaeseq_u8(a, rk[rounds - 1]), rk[rounds]);
+            break;
+        }
+        uint8x16_t b = vld1q_u8(ctr);
+        for (unsigned r = 0; r < rounds - 1; r++) {
+            a = vaesmcq_u8(vaeseq_u8(a, rk[r]));
+            b = vaesmcq_u8(vaeseq_u8(b, rk[r]));
+        }
+        x = veorq_u8(vaeseq_u8(a, rk[rounds - 1]), rk[rounds]);
+        s = veorq_u8(vaeseq_u8(b, rk[rounds - 1]), rk[rounds]);
+        CCryptoBoringSSLShims_ccm_next_counter(ctr);
+    }
+    vst1q_u8(mac, x);
+}
+#endif
+
+// Processes whole blocks of the payload, updating the CBC-MAC state `mac` and
+// advancing the counter block `ctr` past the blocks used.
+static void CCryptoBoringSSLShims_ccm_blocks(const CCryptoBoringSSLShims_CCM_KEY *key, uint8_t mac[16], uint8_t ctr[16],
+                                             const uint8_t *in, uint8_t *out, size_t blocks, int enc) {
+    if (blocks == 0) {
+        return;
+    }
+#if defined(CCRYPTOBORINGSSLSHIMS_CCM_AESNI)
+    if (hwaes_capable()) {
+        if (enc) {
+            CCryptoBoringSSLShims_ccm_seal_blocks_aesni(key, mac, ctr, in, out, blocks);
+        } else {
+            CCryptoBoringSSLShims_ccm_open_blocks_aesni(key, mac, ctr, in, out, blocks);
+        }
+        return;
+    }
+#elif defined(CCRYPTOBORINGSSLSHIMS_CCM_ARMV8)
+    if (hwaes_capable()) {
+        if (enc) {
+            CCryptoBoringSSLShims_ccm_seal_blocks_armv8(key, mac, ctr, in, out, blocks);
+        } else {
+            CCryptoBoringSSLShims_ccm_open_blocks_armv8(key, mac, ctr, in, out, blocks);
+        }
+        return;
+    }
+#endif
+    uint8_t pt[16], ks[16];
+    for (size_t i = 0; i < blocks; i++) {
+        CCryptoBoringSSL_AES_encrypt(ctr, ks, &key->key);
+        CCryptoBoringSSLShims_ccm_next_counter(ctr);
+        for (size_t j = 0; j < 16; j++) {
+            const uint8_t c = in[16 * i + j] ^ ks[j];
+            pt[j] = enc ? in[16 * i + j] : c;
+            out[16 * i + j] = c;
+        }
+        for (size_t j = 0; j < 16; j++) {
+            mac[j] ^= pt[j];
+        }
+        CCryptoBoringSSL_AES_encrypt(mac, mac, &key->key);
+    }
+    CCryptoBoringSSL_OPENSSL_cleanse(pt, sizeof(pt));
+    CCryptoBoringSSL_OPENSSL_cleanse(ks, sizeof(ks));
+}
+
+// XORs `len` bytes into the CBC-MAC state, encrypting it each time a block is
+// filled. `*used` counts the bytes of the current block.
+static void CCryptoBoringSSLShims_ccm_mac_absorb(const CCryptoBoringSSLShims_CCM_KEY *key, uint8_t mac[16],
+                                                 size_t *used, const uint8_t *in, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        mac[(*used)++] ^= in[i];
+        if (*used == 16) {
+            CCryptoBoringSSL_AES_encrypt(mac, mac, &key->key);
+            *used = 0;
+        }
+    }
+}
+
+// Runs one CCM operation in either direction and writes the full 16-byte
+// encrypted tag to `tag`.
+static int CCryptoBoringSSLShims_ccm_crypt(const CCryptoBoringSSLShims_CCM_KEY *key, const uint8_t *nonce,
+                                           size_t nonce_len, const uint8_t *ad, size_t ad_len, const uint8_t *in,
+                                           size_t in_len, uint8_t *out, size_t tag_len, uint8_t tag[16], int enc) {
+    if (nonce_len < 7 || nonce_len > 13 || tag_len < 4 || tag_len > 16 || (tag_len & 1) != 0) {
+        return 0;
+    }
+    const size_t l = 15 - nonce_len;
+    if (l < sizeof(uint64_t) && (uint64_t)in_len >> (8 * l) != 0) {
+        return 0;
+    }
+
+    // B_0 = flags || nonce || message length.
+    uint8_t mac[16];
+    mac[0] = (uint8_t)((ad_len > 0 ? 0x40 : 0) | (((tag_len - 2) / 2) << 3) | (l - 1));
+    memcpy(mac + 1, nonce, nonce_len);
+    uint64_t length = in_len;
+    for (size_t i = 0; i < l; i++) {
+        mac[15 - i] = (uint8_t)length;
+        length >>= 8;
+    }
+    CCryptoBoringSSL_AES_encrypt(mac, mac, &key->key);
+
+    if (ad_len > 0) {
+        uint8_t encoded[10];
+        size_t encoded_len;
+        if ((uint64_t)ad_len < 0xff00) {
+            encoded[0] = (uint8_t)(ad_len >> 8);
+            encoded[1] = (uint8_t)ad_len;
+            encoded_len = 2;
+        } else if ((uint64_t)ad_len <= 0xffffffff) {
+            encoded[0] = 0xff;
+            encoded[1] = 0xfe;
+            CRYPTO_store_u32_be(encoded + 2, (uint32_t)ad_len);
+            encoded_len = 6;
+        } else {
+            encoded[0] = 0xff;
+            encoded[1] = 0xff;
+            CRYPTO_store_u64_be(encoded + 2, (uint64_t)ad_len);
+            encoded_len = 10;
+        }
+        size_t used = 0;
+        CCryptoBoringSSLShims_ccm_mac_absorb(key, mac, &used, encoded, encoded_len);
+        CCryptoBoringSSLShims_ccm_mac_absorb(key, mac, &used, ad, ad_len);
+        if (used > 0) {
+            CCryptoBoringSSL_AES_encrypt(mac, mac, &key->key);
+        }
+    }
+
+    // A_i = flags || nonce || i. A_0 encrypts the tag and the payload starts
+    // at A_1.
+    uint8_t ctr0[16] = {0}, ctr[16];
+    ctr0[0] = (uint8_t)(l - 1);
+    memcpy(ctr0 + 1, nonce, nonce_len);
+    memcpy(ctr, ctr0, sizeof(ctr));
+    ctr[15] = 1;
+
+    const size_t blocks = in_len / 16;
+    CCryptoBoringSSLShims_ccm_blocks(key, mac, ctr, in, out, blocks, enc);
+
+    const size_t tail = in_len % 16;
+    uint8_t ks[16];
+    if (tail > 0) {
+        CCryptoBoringSSL_AES_encrypt(ctr, ks, &key->key);
+        for (size_t i = 0; i < tail; i++) {
+            const uint8_t c = in[16 * blocks + i] ^ ks[i];
+            mac[i] ^= enc ? in[16 * blocks + i] : c;
+            out[16 * blocks + i] = c;
+        }
+        CCryptoBoringSSL_AES_encrypt(mac, mac, &key->key);
+    }
+
+    CCryptoBoringSSL_AES_encrypt(ctr0, ks, &key->key);
+    for (size_t i = 0; i < 16; i++) {
+        tag[i] = mac[i] ^ ks[i];
+    }
+    CCryptoBoringSSL_OPENSSL_cleanse(mac, sizeof(mac));
+    CCryptoBoringSSL_OPENSSL_cleanse(ks, sizeof(ks));
+    return 1;
+}
+
+int CCryptoBoringSSLShims_AES_CCM_seal(const CCryptoBoringSSLShims_CCM_KEY *key, const uint8_t *nonce, size_t nonce_len,
+                                       const uint8_t *ad, size_t ad_len, const uint8_t *in, size_t in_len,
+                                       uint8_t *out, uint8_t *out_tag, size_t tag_len) {
+    uint8_t tag[16];
+    if (!CCryptoBoringSSLShims_ccm_crypt(key, nonce, nonce_len, ad, ad_len, in, in_len, out, tag_len, tag, 1)) {
+        return 0;
+    }
+    memcpy(out_tag, tag, tag_len);
+    return 1;
+}
+
+int CCryptoBoringSSLShims_AES_CCM_open(const CCryptoBoringSSLShims_CCM_KEY *key, const uint8_t *nonce, size_t nonce_len,
+                                       const uint8_t *ad, size_t ad_len, const uint8_t *in, size_t in_len,
+                                       const uint8_t *in_tag, size_t tag_len, uint8_t *out) {
+    uint8_t tag[16];
+    if (!CCryptoBoringSSLShims_ccm_crypt(key, nonce, nonce_len, ad, ad_len, in, in_len, out, tag_len, tag, 0)) {
+        return 0;
+    }
+    if (CCryptoBoringSSL_CRYPTO_memcmp(tag, in_tag, tag_len) != 0) {
+        CCryptoBoringSSL_OPENSSL_cleanse(out, in_len);
+        return 0;
+    }
+    return 1;
+}
+
+// MARK:- AES-XTS
+
+#if defined(HWAES) && defined(OPENSSL_X86_64) && (defined(__GNUC__) || defined(__clang__))
+#define CCRYPTOBORINGSSLSHIMS_XTS_AESNI 1
+#include <immintrin.h>
+#if defined(__clang__) || __GNUC__ >= 8
+// The 256-bit AES intrinsics need GCC 8 or a clang of the same age.
+#define CCRYPTOBORINGSSLSHIMS_XTS_VAES 1
+#endif
+#elif defined(CRYPTO_BORINGSSL_ARM_KERNELS) && defined(HWAES) && defined(OPENSSL_AARCH64) && defined(__ARM_FEATURE_AES)
+// Not yet run on AArch64 in CI, so opt-in; BoringSSL's block function is used
+// otherwise.
+#define CCRYPTOBORINGSSLSHIMS_XTS_ARMV8 1
+#include <arm_neon.h>
+#endif
+
+// The eight-block loops must be unrolled for the blocks to stay in registers,
+// which GCC doesn't do at -O2 by itself.
+#define CCRYPTOBORINGSSLSHIMS_XTS_UNROLL _Pragma("GCC unroll 8")
+
+// IEEE 1619 caps a data unit at 2^20 blocks.
+#define CCRYPTOBORINGSSLSHIMS_XTS_MAX_LEN ((size_t)1 << 24)
+
+int CCryptoBoringSSLShims_XTS_KEY_init(CCryptoBoringSSLShims_XTS_KEY *key, const uint8_t *xts_key, size_t xts_key_len) {
+    if (xts_key_len != 32 && xts_key_len != 64) {
+        return 0;
+    }
+    const size_t half = xts_key_len / 2;
+    if (CRYPTO_memcmp(xts_key, xts_key + half, half) == 0) {
+        return 0;
+    }
+    const unsigned bits = (unsigned)half * 8;
+    if (CCryptoBoringSSL_AES_set_encrypt_key(xts_key, bits, &key->encrypt) != 0 ||
+        CCryptoBoringSSL_AES_set_decrypt_key(xts_key, bits, &key->decrypt) != 0 ||
+        CCryptoBoringSSL_AES_set_encrypt_key(xts_key + half, bits, &key->tweak) != 0) {
+        return 0;
+    }
+    key->rounds = 6 + (unsigned)half / 4;
+    return 1;
+}
+
+// Multiplies the tweak by the primitive element α of GF(2^128), in the
+// little-endian convention of IEEE 1619.
+static void CCryptoBoringSSLShims_xts_mul_alpha(uint8_t t[16]) {
+    uint64_t lo = CRYPTO_load_u64_le(t), hi = CRYPTO_load_u64_le(t + 8);
+    const uint64_t carry = 0u - (hi >> 63);
+    hi = (hi << 1) | (lo >> 63);
+    lo = (lo << 1) ^ (carry & 0x87);
+    CRYPTO_store_u64_le(t, lo);
+    CRYPTO_store_u64_le(t + 8, hi);
+}
+
+// Encrypts or decrypts one block under tweak `t` with the portable AES calls,
+// which accept whichever key schedule AES_set_*_key chose.
+static void CCryptoBoringSSLShims_xts_block(const CCryptoBoringSSLShims_XTS_KEY *key, const uint8_t t[16],
+                                            const uint8_t in[16], uint8_t out[16], int enc) {
+    uint8_t x[16];
+    for (size_t i = 0; i < 16; i++) {
+        x[i] = in[i] ^ t[i];
+    }
+    if (enc) {
+        CCryptoBoringSSL_AES_encrypt(x, x, &key->encrypt);
+    } else {
+        CCryptoBoringSSL_AES_decrypt(x, x, &key->decrypt);
+    }
+    for (size_t i = 0; i < 16; i++) {
+        out[i] = x[i] ^ t[i];
+    }
+    CCryptoBoringSSL_OPENSSL_cleanse(x, sizeof(x));
+}
+
+#if defined(CCRYPTOBORINGSSLSHIMS_XTS_AESNI)
+// The SSE form of CCryptoBoringSSLShims_xts_mul_alpha: each 64-bit half is
+// doubled, the top bit of the low half carries into the high half, and the top
+// bit of the high half folds back into the low byte as 0x87.
+__attribute__((target("sse2")))
+static inline __m128i CCryptoBoringSSLShims_xts_mul_alpha_sse(__m128i t) {
+    const __m128i poly = _mm_set_epi32(0, 1, 0, 0x87);
+    const __m128i carry = _mm_and_si128(_mm_srai_epi32(_mm_shuffle_epi32(t, 0x13), 31), poly);
+    return _mm_xor_si128(_mm_add_epi64(t, t), carry);
+}
+
+// Runs eight blocks through the rounds at once, so that each AESENC or AESDEC
+// has seven independent ones to hide its latency behind. AES_set_*_key used
+// aes_hw_set_*_key, whose round keys are laid out as the instructions expect:
+// the decryption schedule is reversed and already passed through AESIMC.
+__attribute__((target("aes")))
+static void CCryptoBoringSSLShims_xts_blocks_aesni(const CCryptoBoringSSLShims_XTS_KEY *key, uint8_t t[16],
+                                                   const uint8_t *in, uint8_t *out, size_t blocks, int enc) {
+    const unsigned rounds = key->rounds;
+    const AES_KEY *schedule = enc ? &key->encrypt : &key->decrypt;
+    __m128i rk[15];
+    for (unsigned r = 0; r <= rounds; r++) {
+        rk[r] = _mm_loadu_si128((const __m128i *)schedule->rd_key + r);
+    }
+    __m128i tweak = _mm_loadu_si128((const __m128i *)t);
+    for (; blocks >= 8; blocks -= 8, in += 128, out += 128) {
+        __m128i tw[8], x[8];
+        CCRYPTOBORINGSSLSHIMS_XTS_UNROLL
+        for (size_t i = 0; i < 8; i++) {
+            tw[i] = tweak;
+            tweak = CCryptoBoringSSLShims_xts_mul_alpha_sse(tweak);
+            x[i] = _mm_xor_si128(_mm_xor_si128(_mm_loadu_si128((const __m128i *)in + i), tw[i]), rk[0]);
+        }
+        if (enc) {
+            for (unsigned r = 1; r < rounds; r++) {
+                CCRYPTOBORINGSSLSHIMS_XTS_UNROLL
+                for (size_t i = 0; i < 8; i++) {
+                    x[i] = _mm_aesenc_si128(x[i], rk[r]);
+                }
+            }
+            CCRYPTOBORINGSSLSHIMS_XTS_UNROLL
+            for (size_t i = 0; i < 8; i++) {
+                x[i] = _mm_aesenclast_si128(x[i], rk[rounds]);
+            }
+        } else {
+            for (unsigned r = 1; r < rounds; r++) {
+                CCRYPTOBORINGSSLSHIMS_XTS_UNROLL
+                for (size_t i = 0; i < 8; i++) {
+                    x[i] = _mm_aesdec_si128(x[i], rk[r]);
+                }
+            }
+            CCRYPTOBORINGSSLSHIMS_XTS_UNROLL
+            for (size_t i = 0; i < 8; i++) {
+                x[i] = _mm_aesdeclast_si128(x[i], rk[rounds]);
+            }
+        }
+        CCRYPTOBORINGSSLSHIMS_XTS_UNROLL
+        for (size_t i = 0; i < 8; i++) {
+            _mm_storeu_si128((__m128i *)out + i, _mm_xor_si128(x[i], tw[i]));
+        }
+    }
+    for (; blocks > 0; blocks--, in += 16, out += 16) {
+        __m128i x = _mm_xor_si128(_mm_xor_si128(_mm_loadu_si128((const __m128i *)in), tweak), rk[0]);
+        if (enc) {
+            for (unsigned r = 1; r < rounds; r++) {
+                x = _mm_aesenc_si128(x, rk[r]);
+            }
+            x = _mm_aesenclast_si128(x, rk[rounds]);
+        } else {
+            for (unsigned r = 1; r < rounds; r++) {
+                x = _mm_aesdec_si128(x, rk[r]);
+            }
+            x = _mm_aesdeclast_si128(x, rk[rounds]);
+        }
+        _mm_storeu_si128((__m128i *)out, _mm_xor_si128(x, tweak));
+        tweak = CCryptoBoringSSLShims_xts_mul_alpha_sse(tweak);
+    }
+    _mm_storeu_si128((__m128i *)t, tweak);
+}
+#endif
+
+#if defined(CCRYPTOBORINGSSLSHIMS_XTS_VAES)
+// The shuffle, shift and add of the SSE version all work within 128-bit lanes,
+// so this multiplies the two tweaks in `t` by α independently.
+__attribute__((target("avx2")))
+static inline __m256i CCryptoBoringSSLShims_xts_mul_alpha_avx2(__m256i t) {
+    const __m256i poly = _mm256_set_epi32(0, 1, 0, 0x87, 0, 1, 0, 0x87);
+    const __m256i carry = _mm256_and_si256(_mm256_srai_epi32(_mm256_shuffle_epi32(t, 0x13), 31), poly);
+    return _mm256_xor_si256(_mm256_add_epi64(t, t), carry);
+}
+
+// Sixteen blocks at a time in eight 256-bit registers. Register k holds blocks
+// 2k and 2k + 1, and its tweaks are those of register k - 1 times α^2. Only
+// handles multiples of sixteen blocks; the AES-NI kernel takes the rest.
+__attribute__((target("vaes,avx2")))
+static void CCryptoBoringSSLShims_xts_blocks_vaes(const CCryptoBoringSSLShims_XTS_KEY *key, uint8_t t[16],
+                                                  const uint8_t *in, uint8_t *out, size_t blocks, int enc) {
+    const unsigned rounds = key->rounds;
+    const AES_KEY *schedule = enc ? &key->encrypt : &key->decrypt;
+    __m256i rk[15];
+    for (unsigned r = 0; r <= rounds; r++) {
+        rk[r] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)schedule->rd_key + r));
+    }
+    const __m128i t0 = _mm_loadu_si128((const __m128i *)t);
+    __m256i tweak = _mm256_inserti128_si256(_mm256_castsi128_si256(t0),
+                                            CCryptoBoringSSLShims_xts_mul_alpha_sse(t0), 1);
+    for (; blocks >= 16; blocks -= 16, in += 256, out += 256) {
+        __m256i tw[8], x[8];
+        CCRYPTOBORINGSSLSHIMS_XTS_UNROLL
+        for (size_t i = 0; i < 8; i++) {
+            tw[i] = tweak;
+            tweak = CCryptoBoringSSLShims_xts_mul_alpha_avx2(CCryptoBoringSSLShims_xts_mul_alpha_avx2(tweak));
+            x[i] = _mm256_xor_si256(_mm256_xor_si256(_mm256_loadu_si256((const __m256i *)in + i), tw[i]), rk[0]);
+        }
+        if (enc) {
+            for (unsigned r = 1; r < rounds; r++) {
+                CCRYPTOBORINGSSLSHIMS_XTS_UNROLL
+                for (size_t i = 0; i < 8; i++) {
+                    x[i] = _mm256_aesenc_epi128(x[i], rk[r]);
+                }
+            }
+            CCRYPTOBORINGSSLSHIMS_XTS_UNROLL
+            for (size_t i = 0; i < 8; i++) {
+                x[i] = _mm256_aesenclast_epi128(x[i], rk[rounds]);
+            }
+        } else {
+            for (unsigned r = 1; r < rounds; r++) {
+                CCRYPTOBORINGSSLSHIMS_XTS_UNROLL
+                for (size_t i = 0; i < 8; i++) {
+                    x[i] = _mm256_aesdec_epi128(x[i], rk[r]);
+                }
+            }
+            CCRYPTOBORINGSSLSHIMS_XTS_UNROLL
+            for (size_t i = 0; i < 8; i++) {
+                x[i] = _mm256_aesdeclast_epi128(x[i], rk[rounds]);
+            }
+        }
+        CCRYPTOBORINGSSLSHIMS_XTS_UNROLL
+        for (size_t i = 0; i < 8; i++) {
+            _mm256_storeu_si256((__m256i *)out + i, _mm256_xor_si256(x[i], tw[i]));
+        }
+    }
+    _mm_storeu_si128((__m128i *)t, _mm256_castsi256_si128(tweak));
+    // Leave the upper halves clean for any SSE code that follows.
+    _mm256_zeroupper();
+}
+
+static int CCryptoBoringSSLShims_xts_vaes_capable(void) {
+    return CRYPTO_is_AVX2_capable() && CCryptoBoringSSLShims_ia32cap(3, 9);
+}
+#endif
+
+#if defined(CCRYPTOBORINGSSLSHIMS_XTS_ARMV8)
+static inline uint8x16_t CCryptoBoringSSLShims_xts_mul_alpha_neon(uint8x16_t t) {
+    const int64x2_t halves = vreinterpretq_s64_u8(t);
+    // The top bit of each half, moved to the other half and turned into 0x87 or 1.
+    const int64x2_t poly = vcombine_s64(vcreate_s64(0x87), vcreate_s64(1));
+    const int64x2_t carry = vandq_s64(vshrq_n_s64(vextq_s64(halves, halves, 1), 63), poly);
+    return vreinterpretq_u8_s64(veorq_s64(vshlq_n_s64(halves, 1), carry));
+}
+
+// The ARMv8 version of the AES-NI kernel. AESE and AESD add the round key
+// before substituting, so the last round key is added on its own.
+static void CCryptoBoringSSLShims_xts_blocks_armv8(const CCryptoBoringSSLShims_XTS_KEY *key, uint8_t t[16],
+                                                   const uint8_t *in, uint8_t *out, size_t blocks, int enc) {
+    const unsigned rounds = key->rounds;
+    const AES_KEY *schedule = enc ? &key->encrypt : &key->decrypt;
+    uint8x16_t rk[15];
+    for (unsigned r = 0; r <= rounds; r++) {
+        rk[r] = vld1q_u8((const uint8_t *)schedule->rd_key + 16 * r);
+    }
+    uint8x16_t tweak = vld1q_u8(t);
+    for (; blocks >= 8; blocks -= 8, in += 128, out += 128) {
+        uint8x16_t tw[8], x[8];
+        CCRYPTOBORINGSSLSHIMS_XTS_UNROLL
+        for (size_t i = 0; i < 8; i++) {
+            tw[i] = tweak;
+            tweak = CCryptoBoringSSLShims_xts_mul_alpha_neon(tweak);
+            x[i] = veorq_u8(vld1q_u8(in + 16 * i), tw[i]);
+        }
+        if (enc) {
+            for (unsigned r = 0; r < rounds - 1; r++) {
+                CCRYPTOBORINGSSLSHIMS_XTS_UNROLL
+                for (size_t i = 0; i < 8; i++) {
+                    x[i] = vaesmcq_u8(vaeseq_u8(x[i], rk[r]));
+                }
+            }
+            CCRYPTOBORINGSSLSHIMS_XTS_UNROLL
+            for (size_t i = 0; i < 8; i++) {
+                x[i] = veorq_u8(vaeseq_u8(x[i], rk[rounds - 1]), rk[rounds]);
+            }
+        } else {
+            for (unsigned r = 0; r < rounds - 1; r++) {
+                CCRYPTOBORINGSSLSHIMS_XTS_UNROLL
+                for (size_t i = 0; i < 8; i++) {
+                    x[i] = vaesimcq_u8(vaesdq_u8(x[i], rk[r]));
+                }
+            }
+            CCRYPTOBORINGSSLSHIMS_XTS_UNROLL
+            for (size_t i = 0; i < 8; i++) {
+                x[i] = veorq_u8(vaesdq_u8(x[i], rk[rounds - 1]), rk[rounds]);
+            }
+        }
+        CCRYPTOBORINGSSLSHIMS_XTS_UNROLL
+        for (size_t i = 0; i < 8; i++) {
+            vst1q_u8(out + 16 * i, veorq_u8(x[i], tw[i]));
+        }
+    }
+    for (; blocks > 0; blocks--, in += 16, out += 16) {
+        uint8x16_t x = veorq_u8(vld1q_u8(in), tweak);
+        if (enc) {
+            for (unsigned r = 0; r < rounds - 1; r++) {
+                x = vaesmcq_u8(vaeseq_u8(x, rk[r]));
+            }
+            x = veorq_u8(vaeseq_u8(x, rk[rounds - 1]), rk[rounds]);
+        } else {
+            for (unsigned r = 0; r < rounds - 1; r++) {
+                x = vaesimcq_u8(vaesdq_u8(x, rk[r]));
+            }
+            x = veorq_u8(vaesdq_u8(x, rk[rounds - 1]), rk[rounds]);
+        }
+        vst1q_u8(out, veorq_u8(x, tweak));
+        tweak = CCryptoBoringSSLShims_xts_mul_alpha_neon(tweak);
+    }
+    vst1q_u8(t, tweak);
+}
+#endif
+
+// Processes whole blocks under consecutive tweaks starting at `t`, and leaves
+// `t` at the tweak of the block after them.
+static void CCryptoBoringSSLShims_xts_blocks(const CCryptoBoringSSLShims_XTS_KEY *key, uint8_t t[16],
+                                             const uint8_t *in, uint8_t *out, size_t blocks, int enc) {
+    if (blocks == 0) {
+        return;
+    }
+#if defined(CCRYPTOBORINGSSLSHIMS_XTS_AESNI)
+    if (hwaes_capable()) {
+#if defined(CCRYPTOBORINGSSLSHIMS_XTS_VAES)
+        if (blocks >= 16 && CCryptoBoringSSLShims_xts_vaes_capable()) {
+            const size_t wide = blocks & ~(size_t)15;
+            CCryptoBoringSSLShims_xts_blocks_vaes(key, t, in, out, wide, enc);
+            in += 16 * wide;
+            out += 16 * wide;
+            blocks -= wide;
+        }
+#endif
+        CCryptoBoringSSLShims_xts_blocks_aesni(key, t, in, out, blocks, enc);
+        return;
+    }
+#elif defined(CCRYPTOBORINGSSLSHIMS_XTS_ARMV8)
+    if (hwaes_capable()) {
+        CCryptoBoringSSLShims_xts_blocks_armv8(key, t, in, out, blocks, enc);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < blocks; i++) {
+        CCryptoBoringSSLShims_xts_block(key, t, in + 16 * i, out + 16 * i, enc);
+        CCryptoBoringSSLShims_xts_mul_alpha(t);
+    }
+}
+
+// Processes one data unit whose encrypted tweak is `t`, which is clobbered. The
+// length has been checked.
+static void CCryptoBoringSSLShims_xts_data_unit(const CCryptoBoringSSLShims_XTS_KEY *key, uint8_t t[16],
+                                                const uint8_t *in, uint8_t *out, size_t len, int enc) {
+    const size_t tail = len % 16;
+    if (tail == 0) {
+        CCryptoBoringSSLShims_xts_blocks(key, t, in, out, len / 16, enc);
+        return;
+    }
+
+    // Ciphertext stealing. The last full block is processed with the final
+    // tweak when decrypting and the one before it when encrypting, and it
+    // lends the partial block the bytes it is short.
+    const size_t blocks = len / 16 - 1;
+    CCryptoBoringSSLShims_xts_blocks(key, t, in, out, blocks, enc);
+    in += 16 * blocks;
+    out += 16 * blocks;
+
+    uint8_t t_last[16], block[16], partial[16];
+    memcpy(t_last, t, 16);
+    CCryptoBoringSSLShims_xts_mul_alpha(t_last);
+    // Read the partial block before anything is written, as `in` may be `out`.
+    memcpy(partial, in + 16, tail);
+    CCryptoBoringSSLShims_xts_block(key, enc ? t : t_last, in, block, enc);
+    memcpy(partial + tail, block + tail, 16 - tail);
+    memcpy(out + 16, block, tail);
+    CCryptoBoringSSLShims_xts_block(key, enc ? t_last : t, partial, out, enc);
+    CCryptoBoringSSL_OPENSSL_cleanse(block, sizeof(block));
+    CCryptoBoringSSL_OPENSSL_cleanse(partial, sizeof(partial));
+    CCryptoBoringSSL_OPENSSL_cleanse(t_last, sizeof(t_last));
+}
+
+int CCryptoBoringSSLShims_AES_XTS_crypt(const CCryptoBoringSSLShims_XTS_KEY *key, const uint8_t tweak[16],
+                                        const uint8_t *in, uint8_t *out, size_t len, int enc) {
+    if (len < 16 || len > CCRYPTOBORINGSSLSHIMS_XTS_MAX_LEN) {
+        return 0;
+    }
+    uint8_t t[16];
+    CCryptoBoringSSL_AES_encrypt(tweak, t, &key->tweak);
+    CCryptoBoringSSLShims_xts_data_unit(key, t, in, out, len, enc);
+    CCryptoBoringSSL_OPENSSL_cleanse(t, sizeof(t));
+    return 1;
+}
+
+int CCryptoBoringSSLShims_AES_XTS_crypt_sectors(const CCryptoBoringSSLShims_XTS_KEY *key, uint64_t first_sector,
+                                                const uint8_t *in, uint8_t *out, size_t sector_len,
+                                                size_t sector_count, int enc) {
+    if (sector_len < 16 || sector_len > CCRYPTOBORINGSSLSHIMS_XTS_MAX_LEN) {
+        return 0;
+    }
+    if (sector_count > 0 && (uint64_t)(sector_count - 1) > UINT64_MAX - first_sector) {
+        return 0;
+    }
+    uint8_t t[16];
+    for (size_t i = 0; i < sector_count; i++) {
+        uint8_t sector[16] = {0};
+        CRYPTO_store_u64_le(sector, first_sector + i);
+        CCryptoBoringSSL_AES_encrypt(sector, t, &key->tweak);
+        CCryptoBoringSSLShims_xts_data_unit(key, t, in + i * sector_len, out + i * sector_len, sector_len, enc);
+    }
+    CCryptoBoringSSL_OPENSSL_cleanse(t, sizeof(t));
+    return 1;
+}
+
+const char *CCryptoBoringSSLShims_XTS_implementation(void) {
+#if defined(CCRYPTOBORINGSSLSHIMS_XTS_AESNI)
+    if (hwaes_capable()) {
+#if defined(CCRYPTOBORINGSSLSHIMS_XTS_VAES)
+        if (CCryptoBoringSSLShims_xts_vaes_capable()) {
+            return "vaes";
+        }
+#endif
+        return "aes-ni";
+    }
+#elif defined(CCRYPTOBORINGSSLSHIMS_XTS_ARMV8)
+    if (hwaes_capable()) {
+        return "armv8-aes";
+    }
+#endif
+    return "c";
+}
+
+// MARK:- Compact AES-GCM key pool
+
+#define CCRYPTOBORINGSSLSHIMS_GCM_POOL_NONE UINT32_MAX
+// Compact entries are allocated this many at a time, so that handles index
+// stable memory and no session costs an allocation of its own.
+#define CCRYPTOBORINGSSLSHIMS_GCM_POOL_CHUNK 4096
+
+typedef struct {
+    uint8_t key[32];
+    uint8_t h[16];
+    uint8_t key_len;
+    uint8_t live;
+    // The expanded slot holding this session, or the next free entry when
+    // the entry is not live.
+    uint32_t link;
+} CCryptoBoringSSLShims_gcm_compact_key;
+
+// What aead_aes_gcm_init_impl in e_aes.c keeps for a key.
+typedef struct {
+    // The GHASH kernels that use SSSE3 need |Htable| to be 16-byte aligned.
+    alignas(16) GCM128_KEY gcm;
+    AES_KEY aes;
+    ctr128_f ctr;
+} CCryptoBoringSSLShims_gcm_expanded_key;
+
+typedef struct {
+    CCryptoBoringSSLShims_gcm_expanded_key key;
+    uint32_t owner;
+    // Neighbours in the LRU list, which runs from least to most recently used.
+    uint32_t prev, next;
+    // Operations currently using this slot outside the lock. A pinned slot is
+    // never evicted.
+    uint32_t pins;
+} CCryptoBoringSSLShims_gcm_hot_slot;
+
+struct CCryptoBoringSSLShims_GCM_POOL_st {
+    CCryptoBoringSSLShims_lock lock;
+    CCryptoBoringSSLShims_gcm_compact_key **chunks;
+    size_t chunk_count;
+    uint32_t free_list;
+    size_t sessions;
+
+    CCryptoBoringSSLShims_gcm_hot_slot *slots;
+    void *slot_allocation;
+    uint32_t slot_count;
+    uint32_t lru_head, lru_tail;
+
+    uint64_t hits, promotions, evictions, transient_expansions;
+};
+
+static CCryptoBoringSSLShims_gcm_compact_key *CCryptoBoringSSLShims_gcm_pool_entry(
+    const CCryptoBoringSSLShims_GCM_POOL *pool, uint32_t handle) {
+    return &pool->chunks[handle / CCRYPTOBORINGSSLSHIMS_GCM_POOL_CHUNK][handle % CCRYPTOBORINGSSLSHIMS_GCM_POOL_CHUNK];
+}
+
+static void CCryptoBoringSSLShims_gcm_lru_unlink(CCryptoBoringSSLShims_GCM_POOL *pool, uint32_t i) {
+    CCryptoBoringSSLShims_gcm_hot_slot *slot = &pool->slots[i];
+    if (slot->prev != CCRYPTOBORINGSSLSHIMS_GCM_POOL_NONE) {
+        pool->slots[slot->prev].next = slot->next;
+    } else {
+        pool->lru_head = slot->next;
+    }
+    if (slot->next != CCRYPTOBORINGSSLSHIMS_GCM_POOL_NONE) {
+        pool->slots[slot->next].prev = slot->prev;
+    } else {
+        pool->lru_tail = slot->prev;
+    }
+}
+
+static void CCryptoBoringSSLShims_gcm_lru_push_back(CCryptoBoringSSLShims_GCM_POOL *pool, uint32_t i) {
+    CCryptoBoringSSLShims_gcm_hot_slot *slot = &pool->slots[i];
+    slot->prev = pool->lru_tail;
+    slot->next = CCRYPTOBORINGSSLSHIMS_GCM_POOL_NONE;
+    if (pool->lru_tail != CCRYPTOBORINGSSLSHIMS_GCM_POOL_NONE) {
+        pool->slots[pool->lru_tail].next = i;
+    } else {
+        pool->lru_head = i;
+    }
+    pool->lru_tail = i;
+}
+
+static void CCryptoBoringSSLShims_gcm_lru_push_front(CCryptoBoringSSLShims_GCM_POOL *pool, uint32_t i) {
+    CCryptoBoringSSLShims_gcm_hot_slot *slot = &pool->slots[i];
+    slot->prev = CCRYPTOBORINGSSLSHIMS_GCM_POOL_NONE;
+    slot->next = pool->lru_head;
+    if (pool->lru_head != CCRYPTOBORINGSSLSHIMS_GCM_POOL_NONE) {
+        pool->slots[pool->lru_head].prev = i;
+    } else {
+        pool->lru_tail = i;
+    }
+    pool->lru_head = i;
+}
+
+// Expands a compact key. The GHASH table is built from the stored H, which
+// saves the block encryption that CRYPTO_gcm128_init_key would do; otherwise
+// this matches aes_ctr_set_key.
+static void CCryptoBoringSSLShims_gcm_expand(CCryptoBoringSSLShims_gcm_expanded_key *out,
+                                             const CCryptoBoringSSLShims_gcm_compact_key *compact) {
+    block128_f block;
+    out->ctr = aes_ctr_set_key(&out->aes, NULL, &block, compact->key, compact->key_len);
+    ctr128_f shim_ctr = CCryptoBoringSSLShims_gcm_ctr_set_key(&out->aes, &block, compact->key, compact->key_len);
+    if (shim_ctr != NULL) {
+        out->ctr = shim_ctr;
+    }
+    memset(&out->gcm, 0, sizeof(out->gcm));
+    out->gcm.block = block;
+    int is_avx;
+    CRYPTO_ghash_init(&out->gcm.gmult, &out->gcm.ghash, out->gcm.Htable, &is_avx, compact->h);
+    const int block_is_hwaes = hwaes_capable();
+#if defined(OPENSSL_AARCH64) && !defined(OPENSSL_NO_ASM)
+    out->gcm.use_hw_gcm_crypt = (gcm_pmull_capable() && block_is_hwaes) ? 1 : 0;
+#else
+    out->gcm.use_hw_gcm_crypt = (is_avx && block_is_hwaes) ? 1 : 0;
+#endif
+    if (shim_ctr != NULL) {
+        out->gcm.use_hw_gcm_crypt = 0;
+    }
+}
+
+// Seals or opens as aead_aes_gcm_seal_scatter_impl and aead_aes_gcm_open_gather_impl do.
+static int CCryptoBoringSSLShims_gcm_crypt(const CCryptoBoringSSLShims_gcm_expanded_key *key, const uint8_t *nonce,
+                                           size_t nonce_len, const uint8_t *ad, size_t ad_len, const uint8_t *in,
+                                           size_t in_len, uint8_t *out, uint8_t *tag, int enc) {
+    if (nonce_len == 0) {
+        return 0;
+    }
+    GCM128_CONTEXT gcm;
+    memset(&gcm, 0, sizeof(gcm));
+    memcpy(&gcm.gcm_key, &key->gcm, sizeof(gcm.gcm_key));
+    CRYPTO_gcm128_setiv(&gcm, &key->aes, nonce, nonce_len);
+
+    int ok = ad_len == 0 || CRYPTO_gcm128_aad(&gcm, ad, ad_len);
+    if (ok) {
+        if (key->ctr != NULL) {
+            ok = enc ? CRYPTO_gcm128_encrypt_ctr32(&gcm, &key->aes, in, out, in_len, key->ctr)
+                     : CRYPTO_gcm128_decrypt_ctr32(&gcm, &key->aes, in, out, in_len, key->ctr);
+        } else {
+            ok = enc ? CRYPTO_gcm128_encrypt(&gcm, &key->aes, in, out, in_len)
+                     : CRYPTO_gcm128_decrypt(&gcm, &key->aes, in, out, in_len);
+        }
+    }
+    if (ok) {
+        if (enc) {
+            CRYPTO_gcm128_tag(&gcm, tag, 16);
+        } else {
+            ok = CRYPTO_gcm128_finish(&gcm, tag, 16);
+        }
+    }
+    CCryptoBoringSSL_OPENSSL_cleanse(&gcm, sizeof(gcm));
+    if (!ok && !enc) {
+        CCryptoBoringSSL_OPENSSL_cleanse(out, in_len);
+    }
+    return ok;
+}
+
+CCryptoBoringSSLShims_GCM_POOL *CCryptoBoringSSLShims_GCM_POOL_new(size_t hot_capacity) {
+    if (hot_capacity >= CCRYPTOBORINGSSLSHIMS_GCM_POOL_NONE) {
+        return NULL;
+    }
+    CCryptoBoringSSLShims_GCM_POOL *pool = CCryptoBoringSSL_OPENSSL_zalloc(sizeof(*pool));
+    if (pool == NULL) {
+        return NULL;
+    }
+    CCryptoBoringSSLShims_lock_init(&pool->lock);
+    pool->free_list = CCRYPTOBORINGSSLSHIMS_GCM_POOL_NONE;
+    pool->lru_head = pool->lru_tail = CCRYPTOBORINGSSLSHIMS_GCM_POOL_NONE;
+
+    if (hot_capacity > 0) {
+        pool->slot_allocation = CCryptoBoringSSL_OPENSSL_zalloc(hot_capacity * sizeof(CCryptoBoringSSLShims_gcm_hot_slot) + 15);
+        if (pool->slot_allocation == NULL) {
+            CCryptoBoringSSLShims_GCM_POOL_free(pool);
+            return NULL;
+        }
+        pool->slots = (CCryptoBoringSSLShims_gcm_hot_slot *)(((uintptr_t)pool->slot_allocation + 15) & ~(uintptr_t)15);
+        pool->slot_count = (uint32_t)hot_capacity;
+        for (uint32_t i = 0; i < pool->slot_count; i++) {
+            pool->slots[i].owner = CCRYPTOBORINGSSLSHIMS_GCM_POOL_NONE;
+            CCryptoBoringSSLShims_gcm_lru_push_back(pool, i);
+        }
+    }
+    return pool;
+}
+
+void CCryptoBoringSSLShims_GCM_POOL_free(CCryptoBoringSSLShims_GCM_POOL *pool) {
+    if (pool == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < pool->chunk_count; i++) {
+        CCryptoBoringSSL_OPENSSL_cleanse(pool->chunks[i], CCRYPTOBORINGSSLSHIMS_GCM_POOL_CHUNK * sizeof(CCryptoBoringSSLShims_gcm_compact_key));
+        CCryptoBoringSSL_OPENSSL_free(pool->chunks[i]);
+    }
+    CCryptoBoringSSL_OPENSSL_free(pool->chunks);
+    if (pool->slots != NULL) {
+        CCryptoBoringSSL_OPENSSL_cleanse(pool->slots, pool->slot_count * sizeof(CCryptoBoringSSLShims_gcm_hot_slot));
+    }
+    CCryptoBoringSSL_OPENSSL_free(pool->slot_allocation);
+    CCryptoBoringSSLShims_lock_cleanup(&pool->lock);
+    CCryptoBoringSSL_OPENSSL_free(pool);
+}
+
+int CCryptoBoringSSLShims_GCM_POOL_add(CCryptoBoringSSLShims_GCM_POOL *pool, const uint8_t *key, size_t key_len,
+                                       uint32_t *out_handle) {
+    if (key_len != 16 && key_len != 24 && key_len != 32) {
+        return 0;
+    }
+
+    // H is computed outside the lock.
+    CCryptoBoringSSLShims_gcm_compact_key compact;
+    memset(&compact, 0, sizeof(compact));
+    memcpy(compact.key, key, key_len);
+    compact.key_len = (uint8_t)key_len;
+    compact.live = 1;
+    compact.link = CCRYPTOBORINGSSLSHIMS_GCM_POOL_NONE;
+    AES_KEY aes;
+    if (CCryptoBoringSSL_AES_set_encrypt_key(key, (unsigned)key_len * 8, &aes) != 0) {
+        return 0;
+    }
+    CCryptoBoringSSL_AES_encrypt(compact.h, compact.h, &aes);
+    CCryptoBoringSSL_OPENSSL_cleanse(&aes, sizeof(aes));
+
+    int ok = 0;
+    CCryptoBoringSSLShims_lock_write(&pool->lock, CCryptoBoringSSLShims_lock_site_gcm_key_pool);
+    if (pool->free_list == CCRYPTOBORINGSSLSHIMS_GCM_POOL_NONE) {
+        const size_t first = pool->chunk_count * CCRYPTOBORINGSSLSHIMS_GCM_POOL_CHUNK;
+        if (first + CCRYPTOBORINGSSLSHIMS_GCM_POOL_CHUNK > CCRYPTOBORINGSSLSHIMS_GCM_POOL_NONE) {
+            goto out;
+        }
+        CCryptoBoringSSLShims_gcm_compact_key **chunks =
+            CCryptoBoringSSL_OPENSSL_realloc(pool->chunks, (pool->chunk_count + 1) * sizeof(*chunks));
+        if (chunks == NULL) {
+            goto out;
+        }
+        pool->chunks = chunks;
+        CCryptoBoringSSLShims_gcm_compact_key *chunk =
+            CCryptoBoringSSL_OPENSSL_zalloc(CCRYPTOBORINGSSLSHIMS_GCM_POOL_CHUNK * sizeof(*chunk));
+        if (chunk == NULL) {
+            goto out;
+        }
+        pool->chunks[pool->chunk_count++] = chunk;
+        // Thread the new entries onto the free list in ascending order.
+        for (size_t i = CCRYPTOBORINGSSLSHIMS_GCM_POOL_CHUNK; i-- > 0;) {
+            chunk[i].link = pool->free_list;
+            pool->free_list = (uint32_t)(first + i);
+        }
+    }
+
+    const uint32_t handle = pool->free_list;
+    CCryptoBoringSSLShims_gcm_compact_key *entry = CCryptoBoringSSLShims_gcm_pool_entry(pool, handle);
+    pool->free_list = entry->link;
+    *entry = compact;
+    pool->sessions++;
+    *out_handle = handle;
+    ok = 1;
+
+out:
+    CCryptoBoringSSLShims_unlock_write(&pool->lock);
+    CCryptoBoringSSL_OPENSSL_cleanse(&compact, sizeof(compact));
+    return ok;
+}
+
+void CCryptoBoringSSLShims_GCM_POOL_remove(CCryptoBoringSSLShims_GCM_POOL *pool, uint32_t handle) {
+    CCryptoBoringSSLShims_lock_write(&pool->lock, CCryptoBoringSSLShims_lock_site_gcm_key_pool);
+    CCryptoBoringSSLShims_gcm_compact_key *entry = CCryptoBoringSSLShims_gcm_pool_entry(pool, handle);
+    if (entry->live) {
+        if (entry->link != CCRYPTOBORINGSSLSHIMS_GCM_POOL_NONE) {
+            // Hand the slot back as the next to be reused.
+            CCryptoBoringSSLShims_gcm_hot_slot *slot = &pool->slots[entry->link];
+            slot->owner = CCRYPTOBORINGSSLSHIMS_GCM_POOL_NONE;
+            if (slot->pins == 0) {
+                CCryptoBoringSSL_OPENSSL_cleanse(&slot->key, sizeof(slot->key));
+            }
+            CCryptoBoringSSLShims_gcm_lru_unlink(pool, entry->link);
+            CCryptoBoringSSLShims_gcm_lru_push_front(pool, entry->link);
+        }
+        CCryptoBoringSSL_OPENSSL_cleanse(entry, sizeof(*entry));
+        entry->link = pool->free_list;
+        pool->free_list = handle;
+        pool->sessions--;
+    }
+    CCryptoBoringSSLShims_unlock_write(&pool->lock);
+}
+
+// Finds or makes an expanded slot for a session and pins it. Returns NONE if
+// every slot is pinned, in which case `*compact` receives a copy of the
+// compact key to expand privately.
+static uint32_t CCryptoBoringSSLShims_gcm_pool_acquire(CCryptoBoringSSLShims_GCM_POOL *pool, uint32_t handle,
+                                                       CCryptoBoringSSLShims_gcm_compact_key *compact) {
+    CCryptoBoringSSLShims_lock_write(&pool->lock, CCryptoBoringSSLShims_lock_site_gcm_key_pool);
+    CCryptoBoringSSLShims_gcm_compact_key *entry = CCryptoBoringSSLShims_gcm_pool_entry(pool, handle);
+    uint32_t i = entry->link;
+    if (i != CCRYPTOBORINGSSLSHIMS_GCM_POOL_NONE) {
+        pool->hits++;
+    } else {
+        // The least recently used unpinned slot.
+        i = pool->lru_head;
+        while (i != CCRYPTOBORINGSSLSHIMS_GCM_POOL_NONE && pool->slots[i].pins != 0) {
+            i = pool->slots[i].next;
+        }
+        if (i == CCRYPTOBORINGSSLSHIMS_GCM_POOL_NONE) {
+            pool->transient_expansions++;
+            *compact = *entry;
+            CCryptoBoringSSLShims_unlock_write(&pool->lock);
+            return CCRYPTOBORINGSSLSHIMS_GCM_POOL_NONE;
+        }
+        CCryptoBoringSSLShims_gcm_hot_slot *slot = &pool->slots[i];
+        if (slot->owner != CCRYPTOBORINGSSLSHIMS_GCM_POOL_NONE) {
+            CCryptoBoringSSLShims_gcm_pool_entry(pool, slot->owner)->link = CCRYPTOBORINGSSLSHIMS_GCM_POOL_NONE;
+            pool->evictions++;
+        }
+        // Expanding the key is cheap next to taking the lock again, so it is
+        // done here rather than outside the critical section.
+        CCryptoBoringSSLShims_gcm_expand(&slot->key, entry);
+        slot->owner = handle;
+        entry->link = i;
+        pool->promotions++;
+    }
+    CCryptoBoringSSLShims_gcm_lru_unlink(pool, i);
+    CCryptoBoringSSLShims_gcm_lru_push_back(pool, i);
+    pool->slots[i].pins++;
+    CCryptoBoringSSLShims_unlock_write(&pool->lock);
+    return i;
+}
+
+static void CCryptoBoringSSLShims_gcm_pool_release(CCryptoBoringSSLShims_GCM_POOL *pool, uint32_t i) {
+    CCryptoBoringSSLShims_lock_write(&pool->lock, CCryptoBoringSSLShims_lock_site_gcm_key_pool);
+    CCryptoBoringSSLShims_gcm_hot_slot *slot = &pool->slots[i];
+    slot->pins--;
+    if (slot->pins == 0 && slot->owner == CCRYPTOBORINGSSLSHIMS_GCM_POOL_NONE) {
+        CCryptoBoringSSL_OPENSSL_cleanse(&slot->key, sizeof(slot->key));
+    }
+    CCryptoBoringSSLShims_unlock_write(&pool->lock);
+}
+
+static int CCryptoBoringSSLShims_gcm_pool_crypt(CCryptoBoringSSLShims_GCM_POOL *pool, uint32_t handle,
+                                                const uint8_t *nonce, size_t nonce_len, const uint8_t *ad,
+                                                size_t ad_len, const uint8_t *in, size_t in_len, uint8_t *out,
+                                                uint8_t *tag, int enc) {
+    CCryptoBoringSSLShims_gcm_compact_key compact;
+    const uint32_t i = CCryptoBoringSSLShims_gcm_pool_acquire(pool, handle, &compact);
+    if (i != CCRYPTOBORINGSSLSHIMS_GCM_POOL_NONE) {
+        const int ok = CCryptoBoringSSLShims_gcm_crypt(&pool->slots[i].key, nonce, nonce_len, ad, ad_len, in, in_len,
+                                                       out, tag, enc);
+        CCryptoBoringSSLShims_gcm_pool_release(pool, i);
+        return ok;
+    }
+
+    CCryptoBoringSSLShims_gcm_expanded_key expanded;
+    CCryptoBoringSSLShims_gcm_expand(&expanded, &compact);
+    const int ok = CCryptoBoringSSLShims_gcm_crypt(&expanded, nonce, nonce_len, ad, ad_len, in, in_len, out, tag, enc);
+    CCryptoBoringSSL_OPENSSL_cleanse(&expanded, sizeof(expanded));
+    CCryptoBoringSSL_OPENSSL_cleanse(&compact, sizeof(compact));
+    return ok;
+}
+
+int CCryptoBoringSSLShims_GCM_POOL_seal(CCryptoBoringSSLShims_GCM_POOL *pool, uint32_t handle,
+                                        const uint8_t *nonce, size_t nonce_len, const uint8_t *ad, size_t ad_len,
+                                        const uint8_t *in, size_t in_len, uint8_t *out, uint8_t out_tag[16]) {
+    return CCryptoBoringSSLShims_gcm_pool_crypt(pool, handle, nonce, nonce_len, ad, ad_len, in, in_len, out, out_tag, 1);
+}
+
+int CCryptoBoringSSLShims_GCM_POOL_open(CCryptoBoringSSLShims_GCM_POOL *pool, uint32_t handle,
+                                        const uint8_t *nonce, size_t nonce_len, const uint8_t *ad, size_t ad_len,
+                                        const uint8_t *in, size_t in_len, const uint8_t in_tag[16], uint8_t *out) {
+    return CCryptoBoringSSLShims_gcm_pool_crypt(pool, handle, nonce, nonce_len, ad, ad_len, in, in_len, out,
+                                                (uint8_t *)in_tag, 0);
+}
+
+void CCryptoBoringSSLShims_GCM_POOL_get_statistics(CCryptoBoringSSLShims_GCM_POOL *pool,
+                                                   CCryptoBoringSSLShims_GCM_POOL_statistics *out) {
+    CCryptoBoringSSLShims_lock_write(&pool->lock, CCryptoBoringSSLShims_lock_site_gcm_key_pool);
+    out->sessions = pool->sessions;
+    out->compact_bytes = pool->chunk_count * CCRYPTOBORINGSSLSHIMS_GCM_POOL_CHUNK * sizeof(CCryptoBoringSSLShims_gcm_compact_key);
+    out->hot_capacity = pool->slot_count;
+    out->hot_bytes = pool->slot_count * sizeof(CCryptoBoringSSLShims_gcm_hot_slot);
+    out->hits = pool->hits;
+    out->promotions = pool->promotions;
+    out->evictions = pool->evictions;
+    out->transient_expansions = pool->transient_expansions;
+    CCryptoBoringSSLShims_unlock_write(&pool->lock);
+}
+
+// MARK:- ChaCha20 and Poly1305
+
+#if defined(OPENSSL_X86_64) && (defined(__GNUC__) || defined(__clang__))
+#define CCRYPTOBORINGSSLSHIMS_CHACHA_POLY_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(CCRYPTOBORINGSSLSHIMS_CHACHA_POLY_X86)
+// cpu_intel.c already clears AVX512F unless the OS saves the ZMM and opmask
+// registers, so the CPUID bit alone is enough.
+static int CCryptoBoringSSLShims_is_AVX512F_capable(void) {
+    return (OPENSSL_get_ia32cap(2) & (1u << 16)) != 0;
+}
+
+#define CCRYPTOBORINGSSLSHIMS_CHACHA_QR_AVX512(a, b, c, d)       \
+    do {                                                         \
+        a = _mm512_add_epi32(a, b);                              \
+        d = _mm512_rol_epi32(_mm512_xor_si512(d, a), 16);        \
+        c = _mm512_add_epi32(c, d);                              \
+        b = _mm512_rol_epi32(_mm512_xor_si512(b, c), 12);        \
+        a = _mm512_add_epi32(a, b);                              \
+        d = _mm512_rol_epi32(_mm512_xor_si512(d, a), 8);         \
+        c = _mm512_add_epi32(c, d);                              \
+        b = _mm512_rol_epi32(_mm512_xor_si512(b, c), 7);         \
+    } while (0)
+
+// Runs sixteen ChaCha20 blocks at once, one per 32-bit lane, for each of
+// |chunks| 1024-byte chunks. The counter wraps modulo 2^32 in each lane, as
+// |CRYPTO_chacha_20| continues from zero.
+__attribute__((target("avx512f")))
+static void CCryptoBoringSSLShims_chacha20_blocks16_avx512(uint8_t *out, const uint8_t *in, size_t chunks,
+                                                           const uint8_t key[32], const uint8_t nonce[12],
+                                                           uint32_t counter) {
+    __m512i input[16];
+    input[0] = _mm512_set1_epi32(0x61707865);
+    input[1] = _mm512_set1_epi32(0x3320646e);
+    input[2] = _mm512_set1_epi32(0x79622d32);
+    input[3] = _mm512_set1_epi32(0x6b206574);
+    for (size_t i = 0; i < 8; i++) {
+        input[4 + i] = _mm512_set1_epi32((int)CRYPTO_load_u32_le(key + 4 * i));
+    }
+    input[12] = _mm512_add_epi32(_mm512_set1_epi32((int)counter),
+                                 _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+    for (size_t i = 0; i < 3; i++) {
+        input[13 + i] = _mm512_set1_epi32((int)CRYPTO_load_u32_le(nonce + 4 * i));
+    }
+
+    for (; chunks > 0; chunks--) {
+        __m512i x[16];
+        for (size_t i = 0; i < 16; i++) {
+            x[i] = input[i];
+        }
+        for (int i = 0; i < 10; i++) {
+            CCRYPTOBORINGSSLSHIMS_CHACHA_QR_AVX512(x[0], x[4], x[8], x[12]);
+            CCRYPTOBORINGSSLSHIMS_CHACHA_QR_AVX512(x[1], x[5], x[9], x[13]);
+            CCRYPTOBORINGSSLSHIMS_CHACHA_QR_AVX512(x[2], x[6], x[10], x[14]);
+            CCRYPTOBORINGSSLSHIMS_CHACHA_QR_AVX512(x[3], x[7], x[11], x[15]);
+            CCRYPTOBORINGSSLSHIMS_CHACHA_QR_AVX512(x[0], x[5], x[10], x[15]);
+            CCRYPTOBORINGSSLSHIMS_CHACHA_QR_AVX512(x[1], x[6], x[11], x[12]);
+            CCRYPTOBORINGSSLSHIMS_CHACHA_QR_AVX512(x[2], x[7], x[8], x[13]);
+            CCRYPTOBORINGSSLSHIMS_CHACHA_QR_AVX512(x[3], x[4], x[9], x[14]);
+        }
+        for (size_t i = 0; i < 16; i++) {
+            x[i] = _mm512_add_epi32(x[i], input[i]);
+        }
+
+        // |x[j]| holds word j of all sixteen blocks. Transpose so that each
+        // register holds one whole block: interleave 32-bit and then 64-bit
+        // words, which gathers four words of one block in each 128-bit lane,
+        // and then gather the lanes.
+        __m512i a[16], b[16];
+        for (size_t i = 0; i < 16; i += 2) {
+            a[i] = _mm512_unpacklo_epi32(x[i], x[i + 1]);
+            a[i + 1] = _mm512_unpackhi_epi32(x[i], x[i + 1]);
+        }
+        for (size_t i = 0; i < 16; i += 4) {
+            b[i] = _mm512_unpacklo_epi64(a[i], a[i + 2]);
+            b[i + 1] = _mm512_unpackhi_epi64(a[i], a[i + 2]);
+            b[i + 2] = _mm512_unpacklo_epi64(a[i + 1], a[i + 3]);
+            b[i + 3] = _mm512_unpackhi_epi64(a[i + 1], a[i + 3]);
+        }
+        // Lane l of |b[4 * g + j]| now holds words 4g to 4g + 3 of block 4l + j.
+        for (size_t j = 0; j < 4; j++) {
+            const __m512i c0 = _mm512_shuffle_i32x4(b[j], b[4 + j], 0x44);
+            const __m512i c1 = _mm512_shuffle_i32x4(b[j], b[4 + j], 0xee);
+            const __m512i c2 = _mm512_shuffle_i32x4(b[8 + j], b[12 + j], 0x44);
+            const __m512i c3 = _mm512_shuffle_i32x4(b[8 + j], b[12 + j], 0xee);
+            const __m512i blocks[4] = {
+                _mm512_shuffle_i32x4(c0, c2, 0x88),
+                _mm512_shuffle_i32x4(c0, c2, 0xdd),
+                _mm512_shuffle_i32x4(c1, c3, 0x88),
+                _mm512_shuffle_i32x4(c1, c3, 0xdd),
+            };
+            for (size_t l = 0; l < 4; l++) {
+                const size_t offset = 64 * (4 * l + j);
+                const __m512i m = _mm512_loadu_si512((const void *)(in + offset));
+                _mm512_storeu_si512((void *)(out + offset), _mm512_xor_si512(m, blocks[l]));
+            }
+        }
+
+        in += 1024;
+        out += 1024;
+        input[12] = _mm512_add_epi32(input[12], _mm512_set1_epi32(16));
+    }
+}
+
+#undef CCRYPTOBORINGSSLSHIMS_CHACHA_QR_AVX512
+#endif
+
+void CCryptoBoringSSLShims_chacha_20(uint8_t *out, const uint8_t *in, size_t in_len, const uint8_t key[32],
+                                     const uint8_t nonce[12], uint32_t counter) {
+#if defined(CCRYPTOBORINGSSLSHIMS_CHACHA_POLY_X86)
+    if (in_len >= 1024 && CCryptoBoringSSLShims_is_AVX512F_capable()) {
+        const size_t chunks = in_len / 1024;
+        CCryptoBoringSSLShims_chacha20_blocks16_avx512(out, in, chunks, key, nonce, counter);
+        out += chunks * 1024;
+        in += chunks * 1024;
+        in_len -= chunks * 1024;
+        counter += (uint32_t)(chunks * 16);
+    }
+#endif
+    if (in_len > 0) {
+        CCryptoBoringSSL_CRYPTO_chacha_20(out, in, in_len, key, nonce, counter);
+    }
+}
+
+#if defined(CCRYPTOBORINGSSLSHIMS_CHACHA_POLY_X86) && defined(BORINGSSL_HAS_UINT128)
+#define CCRYPTOBORINGSSLSHIMS_POLY1305_AVX2 1
+#define CCRYPTOBORINGSSLSHIMS_POLY1305_WIDE 1
+#elif defined(CRYPTO_BORINGSSL_ARM_KERNELS) && defined(OPENSSL_AARCH64) && defined(__ARM_NEON) && \
+    defined(BORINGSSL_HAS_UINT128)
+// BoringSSL's only NEON Poly1305 is for 32-bit ARM, so on AArch64 updates
+// outside the stitched ChaCha20-Poly1305 assembly run the portable 32-bit code.
+// This kernel has not yet been run on AArch64 in CI, so without
+// CRYPTO_BORINGSSL_ARM_KERNELS those updates stay on BoringSSL's code.
+#define CCRYPTOBORINGSSLSHIMS_POLY1305_NEON 1
+#define CCRYPTOBORINGSSLSHIMS_POLY1305_WIDE 1
+#include <arm_neon.h>
+#endif
+
+#if defined(CCRYPTOBORINGSSLSHIMS_POLY1305_WIDE)
+// Poly1305 with the accumulator in three 44-bit limbs between long updates,
+// as poly1305-donna-64 keeps it, and in five 26-bit limbs inside them, so that
+// four blocks can run side by side, in the 64-bit lanes of AVX2 or of two NEON
+// registers.
+typedef struct {
+    uint64_t h[3];
+    uint64_t r[3];
+    uint64_t pad[2];
+    // r, r², r³ and r⁴ in 26-bit limbs, computed by the first long update.
+    uint32_t r26[4][5];
+    int have_powers;
+    uint8_t buf[16];
+    size_t buf_used;
+} CCryptoBoringSSLShims_poly1305_wide_state;
+
+typedef struct {
+    int wide;
+    union {
+        poly1305_state vendored;
+        CCryptoBoringSSLShims_poly1305_wide_state wide;
+    } u;
+} CCryptoBoringSSLShims_poly1305_state;
+
+#define CCRYPTOBORINGSSLSHIMS_POLY1305_MASK44 UINT64_C(0xfffffffffff)
+#define CCRYPTOBORINGSSLSHIMS_POLY1305_MASK42 UINT64_C(0x3ffffffffff)
+
+// Absorbs whole 16-byte blocks one at a time, with |hibit| as 2^128 in the
+// top limb, or zero for the padded final block.
+static void CCryptoBoringSSLShims_poly1305_blocks44(CCryptoBoringSSLShims_poly1305_wide_state *st,
+                                                    const uint8_t *in, size_t in_len, uint64_t hibit) {
+    const uint64_t r0 = st->r[0], r1 = st->r[1], r2 = st->r[2];
+    const uint64_t s1 = r1 * (5 << 2), s2 = r2 * (5 << 2);
+    uint64_t h0 = st->h[0], h1 = st->h[1], h2 = st->h[2];
+
+    for (; in_len >= 16; in += 16, in_len -= 16) {
+        const uint64_t t0 = CRYPTO_load_u64_le(in), t1 = CRYPTO_load_u64_le(in + 8);
+        h0 += t0 & CCRYPTOBORINGSSLSHIMS_POLY1305_MASK44;
+        h1 += ((t0 >> 44) | (t1 << 20)) & CCRYPTOBORINGSSLSHIMS_POLY1305_MASK44;
+        h2 += ((t1 >> 24) & CCRYPTOBORINGSSLSHIMS_POLY1305_MASK42) | hibit;
+
+        const uint128_t d0 = (uint128_t)h0 * r0 + (uint128_t)h1 * s2 + (uint128_t)h2 * s1;
+        uint128_t d1 = (uint128_t)h0 * r1 + (uint128_t)h1 * r0 + (uint128_t)h2 * s2;
+        uint128_t d2 = (uint128_t)h0 * r2 + (uint128_t)h1 * r1 + (uint128_t)h2 * r0;
+
+        h0 = (uint64_t)d0 & CCRYPTOBORINGSSLSHIMS_POLY1305_MASK44;
+        d1 += (uint64_t)(d0 >> 44);
+        h1 = (uint64_t)d1 & CCRYPTOBORINGSSLSHIMS_POLY1305_MASK44;
+        d2 += (uint64_t)(d1 >> 44);
+        h2 = (uint64_t)d2 & CCRYPTOBORINGSSLSHIMS_POLY1305_MASK42;
+        h0 += (uint64_t)(d2 >> 42) * 5;
+        h1 += h0 >> 44;
+        h0 &= CCRYPTOBORINGSSLSHIMS_POLY1305_MASK44;
+    }
+
+    st->h[0] = h0;
+    st->h[1] = h1;
+    st->h[2] = h2;
+}
+
+// Sets |out| to |a| · |b| in 26-bit limbs, carried but not fully reduced.
+static void CCryptoBoringSSLShims_poly1305_mul26(uint32_t out[5], const uint32_t a[5], const uint32_t b[5]) {
+    const uint32_t s1 = b[1] * 5, s2 = b[2] * 5, s3 = b[3] * 5, s4 = b[4] * 5;
+    uint64_t d0 = (uint64_t)a[0] * b[0] + (uint64_t)a[1] * s4 + (uint64_t)a[2] * s3 + (uint64_t)a[3] * s2 +
+                  (uint64_t)a[4] * s1;
+    uint64_t d1 = (uint64_t)a[0] * b[1] + (uint64_t)a[1] * b[0] + (uint64_t)a[2] * s4 + (uint64_t)a[3] * s3 +
+                  (uint64_t)a[4] * s2;
+    uint64_t d2 = (uint64_t)a[0] * b[2] + (uint64_t)a[1] * b[1] + (uint64_t)a[2] * b[0] + (uint64_t)a[3] * s4 +
+                  (uint64_t)a[4] * s3;
+    uint64_t d3 = (uint64_t)a[0] * b[3] + (uint64_t)a[1] * b[2] + (uint64_t)a[2] * b[1] + (uint64_t)a[3] * b[0] +
+                  (uint64_t)a[4] * s4;
+    uint64_t d4 = (uint64_t)a[0] * b[4] + (uint64_t)a[1] * b[3] + (uint64_t)a[2] * b[2] + (uint64_t)a[3] * b[1] +
+                  (uint64_t)a[4] * b[0];
+
+    d1 += d0 >> 26;
+    d2 += d1 >> 26;
+    d3 += d2 >> 26;
+    d4 += d3 >> 26;
+    uint32_t h0 = ((uint32_t)d0 & 0x3ffffff) + (uint32_t)(d4 >> 26) * 5;
+    out[1] = ((uint32_t)d1 & 0x3ffffff) + (h0 >> 26);
+    out[0] = h0 & 0x3ffffff;
+    out[2] = (uint32_t)d2 & 0x3ffffff;
+    out[3] = (uint32_t)d3 & 0x3ffffff;
+    out[4] = (uint32_t)d4 & 0x3ffffff;
+}
+
+// Splits a value of up to 131 bits in 44-bit limbs into 26-bit limbs.
+static void CCryptoBoringSSLShims_poly1305_44_to_26(uint32_t out[5], const uint64_t in[3]) {
+    out[0] = (uint32_t)in[0] & 0x3ffffff;
+    out[1] = (uint32_t)((in[0] >> 26) | (in[1] << 18)) & 0x3ffffff;
+    out[2] = (uint32_t)(in[1] >> 8) & 0x3ffffff;
+    out[3] = (uint32_t)((in[1] >> 34) | (in[2] << 10)) & 0x3ffffff;
+    out[4] = (uint32_t)(in[2] >> 16);
+}
+
+// Computes r, r², r³ and r⁴ in 26-bit limbs, the first time they're needed.
+static void CCryptoBoringSSLShims_poly1305_powers(CCryptoBoringSSLShims_poly1305_wide_state *st) {
+    if (!st->have_powers) {
+        CCryptoBoringSSLShims_poly1305_44_to_26(st->r26[0], st->r);
+        for (size_t i = 1; i < 4; i++) {
+            CCryptoBoringSSLShims_poly1305_mul26(st->r26[i], st->r26[i - 1], st->r26[0]);
+        }
+        st->have_powers = 1;
+    }
+}
+
+#if defined(CCRYPTOBORINGSSLSHIMS_POLY1305_AVX2)
+#define CCRYPTOBORINGSSLSHIMS_POLY1305_MUL_AVX2(d, a, r, s)                                                      \
+    do {                                                                                                          \
+        d[0] = _mm256_add_epi64(                                                                                  \
+            _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32(a[0], r[0]), _mm256_mul_epu32(a[1], s[4])),        \
+                             _mm256_add_epi64(_mm256_mul_epu32(a[2], s[3]), _mm256_mul_epu32(a[3], s[2]))),       \
+            _mm256_mul_epu32(a[4], s[1]));                                                                        \
+        d[1] = _mm256_add_epi64(                                                                                  \
+            _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32(a[0], r[1]), _mm256_mul_epu32(a[1], r[0])),        \
+                             _mm256_add_epi64(_mm256_mul_epu32(a[2], s[4]), _mm256_mul_epu32(a[3], s[3]))),       \
+            _mm256_mul_epu32(a[4], s[2]));                                                                        \
+        d[2] = _mm256_add_epi64(                                                                                  \
+            _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32(a[0], r[2]), _mm256_mul_epu32(a[1], r[1])),        \
+                             _mm256_add_epi64(_mm256_mul_epu32(a[2], r[0]), _mm256_mul_epu32(a[3], s[4]))),       \
+            _mm256_mul_epu32(a[4], s[3]));                                                                        \
+        d[3] = _mm256_add_epi64(                                                                                  \
+            _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32(a[0], r[3]), _mm256_mul_epu32(a[1], r[2])),        \
+                             _mm256_add_epi64(_mm256_mul_epu32(a[2], r[1]), _mm256_mul_epu32(a[3], r[0]))),       \
+            _mm256_mul_epu32(a[4], s[4]));                                                                        \
+        d[4] = _mm256_add_epi64(                                                                                  \
+            _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32(a[0], r[4]), _mm256_mul_epu32(a[1], r[3])),        \
+                             _mm256_add_epi64(_mm256_mul_epu32(a[2], r[2]), _mm256_mul_epu32(a[3], r[1]))),       \
+            _mm256_mul_epu32(a[4], r[0]));                                                                        \
+    } while (0)
+
+// Carries each lane of |d| back down to limbs of about 26 bits. The carries
+// run as two interleaved chains, from d0 and from d3, to shorten the
+// dependency chain.
+__attribute__((target("avx2")))
+static void CCryptoBoringSSLShims_poly1305_carry_avx2(__m256i d[5]) {
+    const __m256i mask = _mm256_set1_epi64x(0x3ffffff);
+    __m256i c0, c3;
+    c0 = _mm256_srli_epi64(d[0], 26);
+    c3 = _mm256_srli_epi64(d[3], 26);
+    d[0] = _mm256_and_si256(d[0], mask);
+    d[3] = _mm256_and_si256(d[3], mask);
+    d[1] = _mm256_add_epi64(d[1], c0);
+    d[4] = _mm256_add_epi64(d[4], c3);
+
+    c0 = _mm256_srli_epi64(d[1], 26);
+    c3 = _mm256_srli_epi64(d[4], 26);
+    d[1] = _mm256_and_si256(d[1], mask);
+    d[4] = _mm256_and_si256(d[4], mask);
+    d[2] = _mm256_add_epi64(d[2], c0);
+    d[0] = _mm256_add_epi64(d[0], _mm256_add_epi64(c3, _mm256_slli_epi64(c3, 2)));
+
+    c0 = _mm256_srli_epi64(d[2], 26);
+    c3 = _mm256_srli_epi64(d[0], 26);
+    d[2] = _mm256_and_si256(d[2], mask);
+    d[0] = _mm256_and_si256(d[0], mask);
+    d[3] = _mm256_add_epi64(d[3], c0);
+    d[1] = _mm256_add_epi64(d[1], c3);
+
+    c0 = _mm256_srli_epi64(d[3], 26);
+    d[3] = _mm256_and_si256(d[3], mask);
+    d[4] = _mm256_add_epi64(d[4], c0);
+}
+
+// Absorbs |chunks| 64-byte chunks, four blocks at a time. Lane j accumulates
+// blocks j, j + 4, j + 8, ..., each step multiplying by r⁴, and the last step
+// multiplies the lanes by r⁴, r³, r² and r so that their sum is the serial
+// result.
+__attribute__((target("avx2")))
+static void CCryptoBoringSSLShims_poly1305_blocks_avx2(CCryptoBoringSSLShims_poly1305_wide_state *st,
+                                                       const uint8_t *in, size_t chunks) {
+    CCryptoBoringSSLShims_poly1305_powers(st);
+
+    const __m256i mask = _mm256_set1_epi64x(0x3ffffff);
+    const __m256i hibit = _mm256_set1_epi64x(1 << 24);
+    uint32_t h26[5];
+    CCryptoBoringSSLShims_poly1305_44_to_26(h26, st->h);
+    __m256i r4[5], s4[5], rl[5], sl[5], h[5], d[5];
+    for (size_t i = 0; i < 5; i++) {
+        const uint32_t(*r)[5] = st->r26;
+        r4[i] = _mm256_set1_epi64x(r[3][i]);
+        s4[i] = _mm256_set1_epi64x((uint64_t)r[3][i] * 5);
+        rl[i] = _mm256_setr_epi64x(r[3][i], r[2][i], r[1][i], r[0][i]);
+        sl[i] = _mm256_setr_epi64x((uint64_t)r[3][i] * 5, (uint64_t)r[2][i] * 5, (uint64_t)r[1][i] * 5,
+                                   (uint64_t)r[0][i] * 5);
+        h[i] = _mm256_setr_epi64x(h26[i], 0, 0, 0);
+    }
+
+    for (;;) {
+        // Split the four blocks into their low and high 64-bit halves, and
+        // those into limbs.
+        const __m256i x = _mm256_loadu_si256((const __m256i *)in);
+        const __m256i y = _mm256_loadu_si256((const __m256i *)(in + 32));
+        const __m256i lo = _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(x, y), 0xd8);
+        const __m256i hi = _mm256_permute4x64_epi64(_mm256_unpackhi_epi64(x, y), 0xd8);
+        h[0] = _mm256_add_epi64(h[0], _mm256_and_si256(lo, mask));
+        h[1] = _mm256_add_epi64(h[1], _mm256_and_si256(_mm256_srli_epi64(lo, 26), mask));
+        h[2] = _mm256_add_epi64(
+            h[2], _mm256_and_si256(_mm256_or_si256(_mm256_srli_epi64(lo, 52), _mm256_slli_epi64(hi, 12)), mask));
+        h[3] = _mm256_add_epi64(h[3], _mm256_and_si256(_mm256_srli_epi64(hi, 14), mask));
+        h[4] = _mm256_add_epi64(h[4], _mm256_or_si256(_mm256_srli_epi64(hi, 40), hibit));
+        in += 64;
+
+        if (--chunks == 0) {
+            break;
+        }
+        CCRYPTOBORINGSSLSHIMS_POLY1305_MUL_AVX2(d, h, r4, s4);
+        CCryptoBoringSSLShims_poly1305_carry_avx2(d);
+        for (size_t i = 0; i < 5; i++) {
+            h[i] = d[i];
+        }
+    }
+
+    CCRYPTOBORINGSSLSHIMS_POLY1305_MUL_AVX2(d, h, rl, sl);
+    CCryptoBoringSSLShims_poly1305_carry_avx2(d);
+
+    // Sum the lanes, each limb of which is a little over 26 bits at most, and
+    // repack the sum into 44-bit limbs.
+    uint64_t sum[5];
+    for (size_t i = 0; i < 5; i++) {
+        const __m128i pair = _mm_add_epi64(_mm256_castsi256_si128(d[i]), _mm256_extracti128_si256(d[i], 1));
+        sum[i] = (uint64_t)_mm_cvtsi128_si64(pair) + (uint64_t)_mm_extract_epi64(pair, 1);
+    }
+    const uint64_t v0 = sum[0] + (sum[1] << 26);
+    const uint64_t v1 = (v0 >> 44) + (sum[2] << 8) + (sum[3] << 34);
+    st->h[0] = v0 & CCRYPTOBORINGSSLSHIMS_POLY1305_MASK44;
+    st->h[1] = v1 & CCRYPTOBORINGSSLSHIMS_POLY1305_MASK44;
+    st->h[2] = (v1 >> 44) + (sum[4] << 16);
+}
+
+#undef CCRYPTOBORINGSSLSHIMS_POLY1305_MUL_AVX2
+#define CCryptoBoringSSLShims_poly1305_blocks_wide CCryptoBoringSSLShims_poly1305_blocks_avx2
+#endif  // CCRYPTOBORINGSSLSHIMS_POLY1305_AVX2
+
+#if defined(CCRYPTOBORINGSSLSHIMS_POLY1305_NEON)
+// Sets |d| to |a| · (|r|, |s|) in each lane, where |s| holds |r| · 5.
+#define CCRYPTOBORINGSSLSHIMS_POLY1305_MUL_NEON(d, a, r, s)                                                          \
+    do {                                                                                                          \
+        d[0] = vmlal_u32(vmlal_u32(vmlal_u32(vmlal_u32(vmull_u32(a[0], r[0]), a[1], s[4]), a[2], s[3]), a[3], s[2]), \
+                         a[4], s[1]);                                                                             \
+        d[1] = vmlal_u32(vmlal_u32(vmlal_u32(vmlal_u32(vmull_u32(a[0], r[1]), a[1], r[0]), a[2], s[4]), a[3], s[3]), \
+                         a[4], s[2]);                                                                             \
+        d[2] = vmlal_u32(vmlal_u32(vmlal_u32(vmlal_u32(vmull_u32(a[0], r[2]), a[1], r[1]), a[2], r[0]), a[3], s[4]), \
+                         a[4], s[3]);                                                                             \
+        d[3] = vmlal_u32(vmlal_u32(vmlal_u32(vmlal_u32(vmull_u32(a[0], r[3]), a[1], r[2]), a[2], r[1]), a[3], r[0]), \
+                         a[4], s[4]);                                                                             \
+        d[4] = vmlal_u32(vmlal_u32(vmlal_u32(vmlal_u32(vmull_u32(a[0], r[4]), a[1], r[3]), a[2], r[2]), a[3], r[1]), \
+                         a[4], r[0]);                                                                             \
+    } while (0)
+
+// Carries each lane of |d| back down to limbs of about 26 bits, in the same
+// two interleaved chains as the AVX2 code.
+static void CCryptoBoringSSLShims_poly1305_carry_neon(uint64x2_t d[5]) {
+    const uint64x2_t mask = vdupq_n_u64(0x3ffffff);
+    uint64x2_t c0, c3;
+    c0 = vshrq_n_u64(d[0], 26);
+    c3 = vshrq_n_u64(d[3], 26);
+    d[0] = vandq_u64(d[0], mask);
+    d[3] = vandq_u64(d[3], mask);
+    d[1] = vaddq_u64(d[1], c0);
+    d[4] = vaddq_u64(d[4], c3);
+
+    c0 = vshrq_n_u64(d[1], 26);
+    c3 = vshrq_n_u64(d[4], 26);
+    d[1] = vandq_u64(d[1], mask);
+    d[4] = vandq_u64(d[4], mask);
+    d[2] = vaddq_u64(d[2], c0);
+    d[0] = vaddq_u64(d[0], vaddq_u64(c3, vshlq_n_u64(c3, 2)));
+
+    c0 = vshrq_n_u64(d[2], 26);
+    c3 = vshrq_n_u64(d[0], 26);
+    d[2] = vandq_u64(d[2], mask);
+    d[0] = vandq_u64(d[0], mask);
+    d[3] = vaddq_u64(d[3], c0);
+    d[1] = vaddq_u64(d[1], c3);
+
+    c0 = vshrq_n_u64(d[3], 26);
+    d[3] = vandq_u64(d[3], mask);
+    d[4] = vaddq_u64(d[4], c0);
+}
+
+// Splits two blocks, loaded as their low and high 64-bit halves, into limbs
+// and adds them to |h|.
+static void CCryptoBoringSSLShims_poly1305_absorb_neon(uint64x2_t h[5], uint64x2x2_t x) {
+    const uint64x2_t mask = vdupq_n_u64(0x3ffffff);
+    const uint64x2_t lo = x.val[0], hi = x.val[1];
+    h[0] = vaddq_u64(h[0], vandq_u64(lo, mask));
+    h[1] = vaddq_u64(h[1], vandq_u64(vshrq_n_u64(lo, 26), mask));
+    h[2] = vaddq_u64(h[2], vandq_u64(vorrq_u64(vshrq_n_u64(lo, 52), vshlq_n_u64(hi, 12)), mask));
+    h[3] = vaddq_u64(h[3], vandq_u64(vshrq_n_u64(hi, 14), mask));
+    h[4] = vaddq_u64(h[4], vorrq_u64(vshrq_n_u64(hi, 40), vdupq_n_u64(1 << 24)));
+}
+
+// Absorbs |chunks| 64-byte chunks, four blocks at a time, like the AVX2 code.
+// NEON multiplies two 32-bit lanes at a time, so lanes A hold blocks 0 and 1
+// of each chunk and lanes B blocks 2 and 3, and the last step multiplies them
+// by (r⁴, r³) and (r², r).
+static void CCryptoBoringSSLShims_poly1305_blocks_neon(CCryptoBoringSSLShims_poly1305_wide_state *st,
+                                                       const uint8_t *in, size_t chunks) {
+    CCryptoBoringSSLShims_poly1305_powers(st);
+
+    const uint32_t(*r)[5] = st->r26;
+    uint32_t h26[5];
+    CCryptoBoringSSLShims_poly1305_44_to_26(h26, st->h);
+    uint32x2_t r4[5], s4[5], a[5], b[5];
+    uint64x2_t hA[5], hB[5], dA[5], dB[5];
+    for (size_t i = 0; i < 5; i++) {
+        r4[i] = vdup_n_u32(r[3][i]);
+        s4[i] = vdup_n_u32(r[3][i] * 5);
+        hA[i] = vcombine_u64(vcreate_u64(h26[i]), vcreate_u64(0));
+        hB[i] = vdupq_n_u64(0);
+    }
+
+    for (;;) {
+        CCryptoBoringSSLShims_poly1305_absorb_neon(hA, vld2q_u64((const uint64_t *)in));
+        CCryptoBoringSSLShims_poly1305_absorb_neon(hB, vld2q_u64((const uint64_t *)(in + 32)));
+        in += 64;
+
+        if (--chunks == 0) {
+            break;
+        }
+        for (size_t i = 0; i < 5; i++) {
+            a[i] = vmovn_u64(hA[i]);
+            b[i] = vmovn_u64(hB[i]);
+        }
+        CCRYPTOBORINGSSLSHIMS_POLY1305_MUL_NEON(dA, a, r4, s4);
+        CCRYPTOBORINGSSLSHIMS_POLY1305_MUL_NEON(dB, b, r4, s4);
+        CCryptoBoringSSLShims_poly1305_carry_neon(dA);
+        CCryptoBoringSSLShims_poly1305_carry_neon(dB);
+        for (size_t i = 0; i < 5; i++) {
+            hA[i] = dA[i];
+            hB[i] = dB[i];
+        }
+    }
+
+    uint32x2_t rA[5], sA[5], rB[5], sB[5];
+    for (size_t i = 0; i < 5; i++) {
+        const uint32_t ra[2] = {r[3][i], r[2][i]}, rb[2] = {r[1][i], r[0][i]};
+        const uint32_t sa[2] = {r[3][i] * 5, r[2][i] * 5}, sb[2] = {r[1][i] * 5, r[0][i] * 5};
+        rA[i] = vld1_u32(ra);
+        rB[i] = vld1_u32(rb);
+        sA[i] = vld1_u32(sa);
+        sB[i] = vld1_u32(sb);
+        a[i] = vmovn_u64(hA[i]);
+        b[i] = vmovn_u64(hB[i]);
+    }
+    CCRYPTOBORINGSSLSHIMS_POLY1305_MUL_NEON(dA, a, rA, sA);
+    CCRYPTOBORINGSSLSHIMS_POLY1305_MUL_NEON(dB, b, rB, sB);
+    CCryptoBoringSSLShims_poly1305_carry_neon(dA);
+    CCryptoBoringSSLShims_poly1305_carry_neon(dB);
+
+    // Sum the lanes and repack the sum into 44-bit limbs.
+    uint64_t sum[5];
+    for (size_t i = 0; i < 5; i++) {
+        sum[i] = vaddvq_u64(vaddq_u64(dA[i], dB[i]));
+    }
+    const uint64_t v0 = sum[0] + (sum[1] << 26);
+    const uint64_t v1 = (v0 >> 44) + (sum[2] << 8) + (sum[3] << 34);
+    st->h[0] = v0 & CCRYPTOBORINGSSLSHIMS_POLY1305_MASK44;
+    st->h[1] = v1 & CCRYPTOBORINGSSLSHIMS_POLY1305_MASK44;
+    st->h[2] = (v1 >> 44) + (sum[4] << 16);
+}
+
+#undef CCRYPTOBORINGSSLSHIMS_POLY1305_MUL_NEON
+#define CCryptoBoringSSLShims_poly1305_blocks_wide CCryptoBoringSSLShims_poly1305_blocks_neon
+#endif  // CCRYPTOBORINGSSLSHIMS_POLY1305_NEON
+
+static void CCryptoBoringSSLShims_poly1305_wide_init(CCryptoBoringSSLShims_poly1305_wide_state *st,
+                                                     const uint8_t key[32]) {
+    // r &= 0xffffffc0ffffffc0ffffffc0fffffff
+    const uint64_t t0 = CRYPTO_load_u64_le(key), t1 = CRYPTO_load_u64_le(key + 8);
+    st->r[0] = t0 & UINT64_C(0xffc0fffffff);
+    st->r[1] = ((t0 >> 44) | (t1 << 20)) & UINT64_C(0xfffffc0ffff);
+    st->r[2] = (t1 >> 24) & UINT64_C(0x00ffffffc0f);
+    st->pad[0] = CRYPTO_load_u64_le(key + 16);
+    st->pad[1] = CRYPTO_load_u64_le(key + 24);
+    OPENSSL_memset(st->h, 0, sizeof(st->h));
+    st->have_powers = 0;
+    st->buf_used = 0;
+}
+
+// Below this many bytes, the final multiplication and lane sum cost more than
+// running the blocks serially.
+#define CCRYPTOBORINGSSLSHIMS_POLY1305_WIDE_MIN 256
+
+static void CCryptoBoringSSLShims_poly1305_wide_update(CCryptoBoringSSLShims_poly1305_wide_state *st,
+                                                       const uint8_t *in, size_t in_len) {
+    if (st->buf_used > 0) {
+        size_t todo = 16 - st->buf_used;
+        if (todo > in_len) {
+            todo = in_len;
+        }
+        OPENSSL_memcpy(st->buf + st->buf_used, in, todo);
+        st->buf_used += todo;
+        in += todo;
+        in_len -= todo;
+        if (st->buf_used < 16) {
+            return;
+        }
+        CCryptoBoringSSLShims_poly1305_blocks44(st, st->buf, 16, UINT64_C(1) << 40);
+        st->buf_used = 0;
+    }
+
+    if (in_len >= CCRYPTOBORINGSSLSHIMS_POLY1305_WIDE_MIN) {
+        const size_t chunks = in_len / 64;
+        CCryptoBoringSSLShims_poly1305_blocks_wide(st, in, chunks);
+        in += chunks * 64;
+        in_len -= chunks * 64;
+    }
+    const size_t whole = in_len & ~(size_t)15;
+    CCryptoBoringSSLShims_poly1305_blocks44(st, in, whole, UINT64_C(1) << 40);
+    in += whole;
+    in_len -= whole;
+    if (in_len > 0) {
+        OPENSSL_memcpy(st->buf, in, in_len);
+        st->buf_used = in_len;
+    }
+}
+
+// As poly1305-donna-64's finish.
+static void CCryptoBoringSSLShims_poly1305_wide_finish(CCryptoBoringSSLShims_poly1305_wide_state *st,
+                                                       uint8_t mac[16]) {
+    if (st->buf_used > 0) {
+        st->buf[st->buf_used] = 1;
+        OPENSSL_memset(st->buf + st->buf_used + 1, 0, 16 - st->buf_used - 1);
+        CCryptoBoringSSLShims_poly1305_blocks44(st, st->buf, 16, 0);
+    }
+
+    const uint64_t mask44 = CCRYPTOBORINGSSLSHIMS_POLY1305_MASK44, mask42 = CCRYPTOBORINGSSLSHIMS_POLY1305_MASK42;
+    uint64_t h0 = st->h[0], h1 = st->h[1], h2 = st->h[2], c;
+    c = h1 >> 44;
+    h1 &= mask44;
+    h2 += c;
+    c = h2 >> 42;
+    h2 &= mask42;
+    h0 += c * 5;
+    c = h0 >> 44;
+    h0 &= mask44;
+    h1 += c;
+    c = h1 >> 44;
+    h1 &= mask44;
+    h2 += c;
+    c = h2 >> 42;
+    h2 &= mask42;
+    h0 += c * 5;
+    c = h0 >> 44;
+    h0 &= mask44;
+    h1 += c;
+
+    // Compute h - p and keep it if it did not borrow.
+    uint64_t g0 = h0 + 5;
+    c = g0 >> 44;
+    g0 &= mask44;
+    uint64_t g1 = h1 + c;
+    c = g1 >> 44;
+    g1 &= mask44;
+    uint64_t g2 = h2 + c - (UINT64_C(1) << 42);
+    c = (g2 >> 63) - 1;
+    h0 = (h0 & ~c) | (g0 & c);
+    h1 = (h1 & ~c) | (g1 & c);
+    h2 = (h2 & ~c) | (g2 & c);
+
+    // h + pad mod 2^128.
+    const uint64_t t0 = st->pad[0], t1 = st->pad[1];
+    h0 += t0 & mask44;
+    c = h0 >> 44;
+    h0 &= mask44;
+    h1 += (((t0 >> 44) | (t1 << 20)) & mask44) + c;
+    c = h1 >> 44;
+    h1 &= mask44;
+    h2 += ((t1 >> 24) & mask42) + c;
+    h2 &= mask42;
+    CRYPTO_store_u64_le(mac, h0 | (h1 << 44));
+    CRYPTO_store_u64_le(mac + 8, (h1 >> 20) | (h2 << 24));
+
+    CCryptoBoringSSL_OPENSSL_cleanse(st, sizeof(*st));
+}
+
+#undef CCRYPTOBORINGSSLSHIMS_POLY1305_MASK44
+#undef CCRYPTOBORINGSSLSHIMS_POLY1305_MASK42
+#else
+typedef struct {
+    poly1305_state vendored;
+} CCryptoBoringSSLShims_poly1305_state;
+#endif
+
+static_assert(sizeof(CCryptoBoringSSLShims_poly1305_state) <= sizeof(CCryptoBoringSSLShims_POLY1305_STATE),
+              "CCryptoBoringSSLShims_POLY1305_STATE is too small");
+
+void CCryptoBoringSSLShims_poly1305_init(CCryptoBoringSSLShims_POLY1305_STATE *state, const uint8_t key[32]) {
+    CCryptoBoringSSLShims_poly1305_state *st = (CCryptoBoringSSLShims_poly1305_state *)state;
+#if defined(CCRYPTOBORINGSSLSHIMS_POLY1305_WIDE)
+#if defined(CCRYPTOBORINGSSLSHIMS_POLY1305_AVX2)
+    st->wide = CRYPTO_is_AVX2_capable();
+#else
+    st->wide = CRYPTO_is_NEON_capable();
+#endif
+    if (st->wide) {
+        CCryptoBoringSSLShims_poly1305_wide_init(&st->u.wide, key);
+        return;
+    }
+    CCryptoBoringSSL_CRYPTO_poly1305_init(&st->u.vendored, key);
+#else
+    CCryptoBoringSSL_CRYPTO_poly1305_init(&st->vendored, key);
+#endif
+}
+
+void CCryptoBoringSSLShims_poly1305_update(CCryptoBoringSSLShims_POLY1305_STATE *state, const uint8_t *in,
+                                           size_t in_len) {
+    CCryptoBoringSSLShims_poly1305_state *st = (CCryptoBoringSSLShims_poly1305_state *)state;
+#if defined(CCRYPTOBORINGSSLSHIMS_POLY1305_WIDE)
+    if (st->wide) {
+        CCryptoBoringSSLShims_poly1305_wide_update(&st->u.wide, in, in_len);
+        return;
+    }
+    CCryptoBoringSSL_CRYPTO_poly1305_update(&st->u.vendored, in, in_len);
+#else
+    CCryptoBoringSSL_CRYPTO_poly1305_update(&st->vendored, in, in_len);
+#endif
+}
+
+void CCryptoBoringSSLShims_poly1305_finish(CCryptoBoringSSLShims_POLY1305_STATE *state, uint8_t mac[16]) {
+    CCryptoBoringSSLShims_poly1305_state *st = (CCryptoBoringSSLShims_poly1305_state *)state;
+#if defined(CCRYPTOBORINGSSLSHIMS_POLY1305_WIDE)
+    if (st->wide) {
+        CCryptoBoringSSLShims_poly1305_wide_finish(&st->u.wide, mac);
+        return;
+    }
+    CCryptoBoringSSL_CRYPTO_poly1305_finish(&st->u.vendored, mac);
+#else
+    CCryptoBoringSSL_CRYPTO_poly1305_finish(&st->vendored, mac);
+#endif
+}
+
+// MARK:- Streaming AEAD
+
+// Mirrors struct aead_aes_gcm_ctx in e_aes.c, which is what EVP_AEAD_CTX holds
+// for the AES-GCM AEADs.
+typedef struct {
+    union {
+        double align;
+        AES_KEY ks;
+    } ks;
+    GCM128_KEY gcm_key;
+    ctr128_f ctr;
+} CCryptoBoringSSLShims_aead_aes_gcm_ctx;
+
+// struct aead_aes_gcm_ctx is private to e_aes.c, so these can only hold the
+// mirror to the types it is built from: it must fit the state as e_aes.c's own
+// asserts require, and each member must follow the last with no more than
+// alignment padding, as in e_aes.c.
+static_assert(sizeof(((EVP_AEAD_CTX *)NULL)->state) >= sizeof(CCryptoBoringSSLShims_aead_aes_gcm_ctx),
+              "AEAD state is too small for the AES-GCM context");
+static_assert(_Alignof(union evp_aead_ctx_st_state) >= _Alignof(CCryptoBoringSSLShims_aead_aes_gcm_ctx),
+              "AEAD state has insufficient alignment for the AES-GCM context");
+static_assert(offsetof(CCryptoBoringSSLShims_aead_aes_gcm_ctx, gcm_key) ==
+                  (sizeof(AES_KEY) + _Alignof(GCM128_KEY) - 1) / _Alignof(GCM128_KEY) * _Alignof(GCM128_KEY),
+              "gcm_key must directly follow the AES key");
+static_assert(offsetof(CCryptoBoringSSLShims_aead_aes_gcm_ctx, ctr) ==
+                  offsetof(CCryptoBoringSSLShims_aead_aes_gcm_ctx, gcm_key) + sizeof(GCM128_KEY),
+              "ctr must directly follow gcm_key");
+
+// Whether e_aes.c still lays its context out as above is checked once, against
+// the vendored code itself: a context that EVP_AEAD_CTX_init set up for a fixed
+// key must hold, at the mirrored positions, what aes_ctr_set_key produces for
+// that key, use_hw_gcm_crypt included. Until the check has passed, the shims
+// neither read nor write any AES-GCM EVP_AEAD_CTX state.
+static CRYPTO_once_t CCryptoBoringSSLShims_aead_aes_gcm_layout_once = CRYPTO_ONCE_INIT;
+static int CCryptoBoringSSLShims_aead_aes_gcm_layout_ok;
+
+static void CCryptoBoringSSLShims_aead_aes_gcm_check_layout(void) {
+    // An AES-128 key schedule is 11 round keys long; the rest of rd_key is
+    // left as it was.
+    static const uint8_t key[16] = {0};
+    EVP_AEAD_CTX ctx;
+    if (!CCryptoBoringSSL_EVP_AEAD_CTX_init(&ctx, CCryptoBoringSSL_EVP_aead_aes_128_gcm(), key, sizeof(key),
+                                            EVP_AEAD_DEFAULT_TAG_LENGTH, NULL)) {
+        CCryptoBoringSSL_ERR_clear_error();
+        return;
+    }
+    AES_KEY aes_key;
+    GCM128_KEY gcm_key;
+    OPENSSL_memset(&gcm_key, 0, sizeof(gcm_key));
+    ctr128_f ctr = aes_ctr_set_key(&aes_key, &gcm_key, NULL, key, sizeof(key));
+    const CCryptoBoringSSLShims_aead_aes_gcm_ctx *gcm_ctx = (const CCryptoBoringSSLShims_aead_aes_gcm_ctx *)&ctx.state;
+    CCryptoBoringSSLShims_aead_aes_gcm_layout_ok =
+        gcm_ctx->ks.ks.rounds == aes_key.rounds &&
+        OPENSSL_memcmp(gcm_ctx->ks.ks.rd_key, aes_key.rd_key, 4 * 11 * sizeof(aes_key.rd_key[0])) == 0 &&
+        OPENSSL_memcmp(gcm_ctx->gcm_key.Htable, gcm_key.Htable, sizeof(gcm_key.Htable)) == 0 &&
+        gcm_ctx->gcm_key.gmult == gcm_key.gmult && gcm_ctx->gcm_key.ghash == gcm_key.ghash &&
+        gcm_ctx->gcm_key.block == gcm_key.block && gcm_ctx->gcm_key.use_hw_gcm_crypt == gcm_key.use_hw_gcm_crypt &&
+        gcm_ctx->ctr == ctr;
+    CCryptoBoringSSL_EVP_AEAD_CTX_cleanup(&ctx);
+}
+
+static int CCryptoBoringSSLShims_aead_aes_gcm_layout_matches(void) {
+    CRYPTO_once(&CCryptoBoringSSLShims_aead_aes_gcm_layout_once, CCryptoBoringSSLShims_aead_aes_gcm_check_layout);
+    return CCryptoBoringSSLShims_aead_aes_gcm_layout_ok;
+}
+
+// Moves an AES-GCM context that EVP_AEAD_CTX_init set up onto the shims'
+// counter mode, where that is used. The GHASH key doesn't depend on the AES
+// implementation, so only the AES key and functions change.
+static void CCryptoBoringSSLShims_aead_aes_gcm_use_shim_ctr(EVP_AEAD_CTX *ctx, const void *key, size_t key_len) {
+    if (ctx->aead != CCryptoBoringSSL_EVP_aead_aes_128_gcm() && ctx->aead != CCryptoBoringSSL_EVP_aead_aes_192_gcm() &&
+        ctx->aead != CCryptoBoringSSL_EVP_aead_aes_256_gcm()) {
+        return;
+    }
+    if (!CCryptoBoringSSLShims_aead_aes_gcm_layout_matches()) {
+        return;
+    }
+    CCryptoBoringSSLShims_aead_aes_gcm_ctx *gcm_ctx = (CCryptoBoringSSLShims_aead_aes_gcm_ctx *)&ctx->state;
+    block128_f block;
+    ctr128_f ctr = CCryptoBoringSSLShims_gcm_ctr_set_key(&gcm_ctx->ks.ks, &block, key, key_len);
+    if (ctr != NULL) {
+        gcm_ctx->ctr = ctr;
+        gcm_ctx->gcm_key.block = block;
+        gcm_ctx->gcm_key.use_hw_gcm_crypt = 0;
+    }
+}
+
+// Mirrors struct aead_chacha20_poly1305_ctx in e_chacha20poly1305.c.
+typedef struct {
+    uint8_t key[32];
+} CCryptoBoringSSLShims_aead_chacha20_poly1305_ctx;
+
+#define CCRYPTOBORINGSSLSHIMS_AEAD_STREAM_GCM 1
+#define CCRYPTOBORINGSSLSHIMS_AEAD_STREAM_CHACHA 2
+
+typedef struct {
+    unsigned kind;
+    int encrypt;
+    size_t tag_len;
+    union {
+        struct {
+            GCM128_CONTEXT gcm;
+            const AES_KEY *key;
+            ctr128_f ctr;
+        } gcm;
+        struct {
+            CCryptoBoringSSLShims_POLY1305_STATE poly1305;
+            const uint8_t *key;
+            uint8_t nonce[12];
+            // The keystream block that the message has reached, of which the
+            // first |keystream_used| bytes have been consumed, and the counter
+            // of the block after it.
+            uint8_t keystream[64];
+            size_t keystream_used;
+            uint32_t counter;
+            int in_message;
+            uint64_t ad_len, in_len;
+        } chacha;
+    } state;
+} CCryptoBoringSSLShims_aead_stream;
+
+static_assert(sizeof(CCryptoBoringSSLShims_aead_stream) + 15 <= sizeof(CCryptoBoringSSLShims_AEAD_STREAM),
+              "CCryptoBoringSSLShims_AEAD_STREAM is too small");
+
+// The public type has only 8-byte alignment, but the GCM context needs 16.
+static CCryptoBoringSSLShims_aead_stream *CCryptoBoringSSLShims_aead_stream_get(
+    CCryptoBoringSSLShims_AEAD_STREAM *stream) {
+    return (CCryptoBoringSSLShims_aead_stream *)(((uintptr_t)stream->opaque + 15) & ~(uintptr_t)15);
+}
+
+static unsigned CCryptoBoringSSLShims_aead_stream_kind(const EVP_AEAD *aead) {
+    if (aead == CCryptoBoringSSL_EVP_aead_aes_128_gcm() || aead == CCryptoBoringSSL_EVP_aead_aes_192_gcm() ||
+        aead == CCryptoBoringSSL_EVP_aead_aes_256_gcm()) {
+        return CCryptoBoringSSLShims_aead_aes_gcm_layout_matches() ? CCRYPTOBORINGSSLSHIMS_AEAD_STREAM_GCM : 0;
+    }
+    if (aead == CCryptoBoringSSL_EVP_aead_chacha20_poly1305()) {
+        return CCRYPTOBORINGSSLSHIMS_AEAD_STREAM_CHACHA;
+    }
+    return 0;
+}
+
+int CCryptoBoringSSLShims_AEAD_STREAM_supported(const EVP_AEAD_CTX *ctx) {
+    return CCryptoBoringSSLShims_aead_stream_kind(ctx->aead) != 0;
+}
+
+int CCryptoBoringSSLShims_AEAD_STREAM_init(CCryptoBoringSSLShims_AEAD_STREAM *stream, const EVP_AEAD_CTX *ctx,
+                                           const void *nonce, size_t nonce_len, int encrypt) {
+    CCryptoBoringSSLShims_aead_stream *s = CCryptoBoringSSLShims_aead_stream_get(stream);
+    memset(s, 0, sizeof(*s));
+    s->kind = CCryptoBoringSSLShims_aead_stream_kind(ctx->aead);
+    s->encrypt = encrypt;
+    s->tag_len = ctx->tag_len;
+
+    switch (s->kind) {
+    case CCRYPTOBORINGSSLSHIMS_AEAD_STREAM_GCM: {
+        const CCryptoBoringSSLShims_aead_aes_gcm_ctx *gcm_ctx = (const CCryptoBoringSSLShims_aead_aes_gcm_ctx *)&ctx->state;
+        if (nonce_len == 0) {
+            return 0;
+        }
+        s->state.gcm.key = &gcm_ctx->ks.ks;
+        s->state.gcm.ctr = gcm_ctx->ctr;
+        memcpy(&s->state.gcm.gcm.gcm_key, &gcm_ctx->gcm_key, sizeof(s->state.gcm.gcm.gcm_key));
+        CRYPTO_gcm128_setiv(&s->state.gcm.gcm, s->state.gcm.key, nonce, nonce_len);
+        return 1;
+    }
+    case CCRYPTOBORINGSSLSHIMS_AEAD_STREAM_CHACHA: {
+        const CCryptoBoringSSLShims_aead_chacha20_poly1305_ctx *c20_ctx =
+            (const CCryptoBoringSSLShims_aead_chacha20_poly1305_ctx *)&ctx->state;
+        if (nonce_len != sizeof(s->state.chacha.nonce)) {
+            return 0;
+        }
+        s->state.chacha.key = c20_ctx->key;
+        memcpy(s->state.chacha.nonce, nonce, nonce_len);
+
+        // As in calc_tag, the Poly1305 key is the first half of block zero and
+        // the message starts at block one.
+        alignas(16) uint8_t poly1305_key[32];
+        memset(poly1305_key, 0, sizeof(poly1305_key));
+        CCryptoBoringSSL_CRYPTO_chacha_20(poly1305_key, poly1305_key, sizeof(poly1305_key), s->state.chacha.key,
+                                          s->state.chacha.nonce, 0);
+        CCryptoBoringSSLShims_poly1305_init(&s->state.chacha.poly1305, poly1305_key);
+        CCryptoBoringSSL_OPENSSL_cleanse(poly1305_key, sizeof(poly1305_key));
+        s->state.chacha.keystream_used = sizeof(s->state.chacha.keystream);
+        s->state.chacha.counter = 1;
+        return 1;
+    }
+    default:
+        return 0;
+    }
+}
+
+static const uint8_t kCCryptoBoringSSLShimsPoly1305Padding[16] = {0};
+
+// Pads the authenticated data to a block boundary once the message starts.
+static void CCryptoBoringSSLShims_aead_stream_chacha_begin_message(CCryptoBoringSSLShims_aead_stream *s) {
+    if (s->state.chacha.in_message) {
+        return;
+    }
+    s->state.chacha.in_message = 1;
+    if (s->state.chacha.ad_len % 16 != 0) {
+        CCryptoBoringSSLShims_poly1305_update(&s->state.chacha.poly1305, kCCryptoBoringSSLShimsPoly1305Padding,
+                                              16 - (s->state.chacha.ad_len % 16));
+    }
+}
+
+int CCryptoBoringSSLShims_AEAD_STREAM_update_ad(CCryptoBoringSSLShims_AEAD_STREAM *stream, const void *ad,
+                                                size_t ad_len) {
+    CCryptoBoringSSLShims_aead_stream *s = CCryptoBoringSSLShims_aead_stream_get(stream);
+    if (ad_len == 0) {
+        return 1;
+    }
+    switch (s->kind) {
+    case CCRYPTOBORINGSSLSHIMS_AEAD_STREAM_GCM:
+        return CRYPTO_gcm128_aad(&s->state.gcm.gcm, ad, ad_len);
+    case CCRYPTOBORINGSSLSHIMS_AEAD_STREAM_CHACHA:
+        if (s->state.chacha.in_message) {
+            return 0;
+        }
+        CCryptoBoringSSLShims_poly1305_update(&s->state.chacha.poly1305, ad, ad_len);
+        s->state.chacha.ad_len += ad_len;
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+// Applies the ChaCha20 keystream to |len| bytes, carrying a partly used block
+// over to the next call so that piece boundaries don't have to fall on blocks.
+static void CCryptoBoringSSLShims_aead_stream_chacha_xor(CCryptoBoringSSLShims_aead_stream *s, const uint8_t *in,
+                                                         uint8_t *out, size_t len) {
+    uint8_t *keystream = s->state.chacha.keystream;
+    size_t done = 0;
+    while (s->state.chacha.keystream_used < 64 && done < len) {
+        out[done] = in[done] ^ keystream[s->state.chacha.keystream_used++];
+        done++;
+    }
+
+    size_t whole = (len - done) & ~(size_t)63;
+    if (whole > 0) {
+        CCryptoBoringSSLShims_chacha_20(out + done, in + done, whole, s->state.chacha.key, s->state.chacha.nonce,
+                                        s->state.chacha.counter);
+        s->state.chacha.counter += (uint32_t)(whole / 64);
+        done += whole;
+    }
+
+    if (done < len) {
+        memset(keystream, 0, 64);
+        CCryptoBoringSSL_CRYPTO_chacha_20(keystream, keystream, 64, s->state.chacha.key, s->state.chacha.nonce,
+                                          s->state.chacha.counter);
+        s->state.chacha.counter++;
+        s->state.chacha.keystream_used = 0;
+        while (done < len) {
+            out[done] = in[done] ^ keystream[s->state.chacha.keystream_used++];
+            done++;
+        }
+    }
+}
+
+int CCryptoBoringSSLShims_AEAD_STREAM_update(CCryptoBoringSSLShims_AEAD_STREAM *stream, const void *in, void *out,
+                                             size_t len) {
+    CCryptoBoringSSLShims_aead_stream *s = CCryptoBoringSSLShims_aead_stream_get(stream);
+    if (len == 0) {
+        return 1;
+    }
+    switch (s->kind) {
+    case CCRYPTOBORINGSSLSHIMS_AEAD_STREAM_GCM: {
+        GCM128_CONTEXT *gcm = &s->state.gcm.gcm;
+        const AES_KEY *key = s->state.gcm.key;
+        if (s->state.gcm.ctr != NULL) {
+            return s->encrypt ? CRYPTO_gcm128_encrypt_ctr32(gcm, key, in, out, len, s->state.gcm.ctr)
+                              : CRYPTO_gcm128_decrypt_ctr32(gcm, key, in, out, len, s->state.gcm.ctr);
+        }
+        return s->encrypt ? CRYPTO_gcm128_encrypt(gcm, key, in, out, len)
+                          : CRYPTO_gcm128_decrypt(gcm, key, in, out, len);
+    }
+    case CCRYPTOBORINGSSLSHIMS_AEAD_STREAM_CHACHA: {
+        // As in chacha20_poly1305_seal_scatter, the 32-bit block counter
+        // limits a message to just under 256GB.
+        const uint64_t limit = (UINT64_C(1) << 32) * 64 - 64;
+        const uint64_t len_64 = len;
+        if (len_64 >= limit || s->state.chacha.in_len >= limit - len_64) {
+            return 0;
+        }
+        CCryptoBoringSSLShims_aead_stream_chacha_begin_message(s);
+        // The tag covers the ciphertext, which when opening is the input and
+        // may be overwritten by the output.
+        if (!s->encrypt) {
+            CCryptoBoringSSLShims_poly1305_update(&s->state.chacha.poly1305, in, len);
+        }
+        CCryptoBoringSSLShims_aead_stream_chacha_xor(s, in, out, len);
+        if (s->encrypt) {
+            CCryptoBoringSSLShims_poly1305_update(&s->state.chacha.poly1305, out, len);
+        }
+        s->state.chacha.in_len += len;
+        return 1;
+    }
+    default:
+        return 0;
+    }
+}
+
+static void CCryptoBoringSSLShims_poly1305_update_length(CCryptoBoringSSLShims_POLY1305_STATE *poly1305, uint64_t len) {
+    uint8_t length_bytes[8];
+    CRYPTO_store_u64_le(length_bytes, len);
+    CCryptoBoringSSLShims_poly1305_update(poly1305, length_bytes, sizeof(length_bytes));
+}
+
+// Computes the full tag for everything fed into the stream and clears it.
+static int CCryptoBoringSSLShims_aead_stream_tag(CCryptoBoringSSLShims_aead_stream *s, uint8_t tag[16]) {
+    int ok = 1;
+    switch (s->kind) {
+    case CCRYPTOBORINGSSLSHIMS_AEAD_STREAM_GCM:
+        CRYPTO_gcm128_tag(&s->state.gcm.gcm, tag, 16);
+        break;
+    case CCRYPTOBORINGSSLSHIMS_AEAD_STREAM_CHACHA:
+        CCryptoBoringSSLShims_aead_stream_chacha_begin_message(s);
+        if (s->state.chacha.in_len % 16 != 0) {
+            CCryptoBoringSSLShims_poly1305_update(&s->state.chacha.poly1305, kCCryptoBoringSSLShimsPoly1305Padding,
+                                                  16 - (s->state.chacha.in_len % 16));
+        }
+        CCryptoBoringSSLShims_poly1305_update_length(&s->state.chacha.poly1305, s->state.chacha.ad_len);
+        CCryptoBoringSSLShims_poly1305_update_length(&s->state.chacha.poly1305, s->state.chacha.in_len);
+        CCryptoBoringSSLShims_poly1305_finish(&s->state.chacha.poly1305, tag);
+        break;
+    default:
+        ok = 0;
+        break;
+    }
+    CCryptoBoringSSL_OPENSSL_cleanse(s, sizeof(*s));
+    return ok;
+}
+
+int CCryptoBoringSSLShims_AEAD_STREAM_seal_final(CCryptoBoringSSLShims_AEAD_STREAM *stream, void *out_tag,
+                                                 size_t *out_tag_len, size_t max_out_tag_len) {
+    CCryptoBoringSSLShims_aead_stream *s = CCryptoBoringSSLShims_aead_stream_get(stream);
+    const size_t tag_len = s->tag_len;
+    uint8_t tag[16];
+    if (!s->encrypt || !CCryptoBoringSSLShims_aead_stream_tag(s, tag) || max_out_tag_len < tag_len) {
+        CCryptoBoringSSL_OPENSSL_cleanse(s, sizeof(*s));
+        return 0;
+    }
+    memcpy(out_tag, tag, tag_len);
+    *out_tag_len = tag_len;
+    return 1;
+}
+
+int CCryptoBoringSSLShims_AEAD_STREAM_open_final(CCryptoBoringSSLShims_AEAD_STREAM *stream, const void *in_tag,
+                                                 size_t in_tag_len) {
+    CCryptoBoringSSLShims_aead_stream *s = CCryptoBoringSSLShims_aead_stream_get(stream);
+    const size_t tag_len = s->tag_len;
+    uint8_t tag[16];
+    if (s->encrypt || !CCryptoBoringSSLShims_aead_stream_tag(s, tag) || in_tag_len != tag_len) {
+        CCryptoBoringSSL_OPENSSL_cleanse(s, sizeof(*s));
+        return 0;
+    }
+    int ok = CRYPTO_memcmp(tag, in_tag, tag_len) == 0;
+    CCryptoBoringSSL_OPENSSL_cleanse(tag, sizeof(tag));
+    return ok;
+}
+
+// Each chunk is hashed and encrypted back to back, so the second pass reads
+// it from L1 rather than memory. Input and output together stay well within
+// a 32 KiB L1 data cache.
+#define CCRYPTOBORINGSSLSHIMS_AEAD_STREAM_HASH_CHUNK 8192
+
+int CCryptoBoringSSLShims_AEAD_STREAM_update_sha256(CCryptoBoringSSLShims_AEAD_STREAM *stream, SHA256_CTX *sha256,
+                                                    const void *in, void *out, size_t len) {
+    const int encrypt = CCryptoBoringSSLShims_aead_stream_get(stream)->encrypt;
+    const uint8_t *chunk_in = in;
+    uint8_t *chunk_out = out;
+    while (len > 0) {
+        const size_t todo =
+            len < CCRYPTOBORINGSSLSHIMS_AEAD_STREAM_HASH_CHUNK ? len : CCRYPTOBORINGSSLSHIMS_AEAD_STREAM_HASH_CHUNK;
+        // The plaintext is the input when sealing and the output when
+        // opening. Hashing it first when sealing also keeps this correct in
+        // place.
+        if (encrypt) {
+            CCryptoBoringSSL_SHA256_Update(sha256, chunk_in, todo);
+        }
+        if (!CCryptoBoringSSLShims_AEAD_STREAM_update(stream, chunk_in, chunk_out, todo)) {
+            return 0;
+        }
+        if (!encrypt) {
+            CCryptoBoringSSL_SHA256_Update(sha256, chunk_out, todo);
+        }
+        chunk_in += todo;
+        chunk_out += todo;
+        len -= todo;
+    }
+    return 1;
+}
+
+// MARK:- Parallel AES-GCM
+
+typedef struct {
+    // Holds the context after the nonce and authenticated data, with the
+    // authenticated data's last partial block already multiplied in. Its Yi
+    // is the counter block of the message's first block.
+    GCM128_CONTEXT gcm;
+    const AES_KEY *key;
+    ctr128_f ctr;
+    size_t tag_len;
+    uint64_t in_len;
+    size_t segment_len;
+    int encrypt;
+} CCryptoBoringSSLShims_gcm_parallel;
+
+static_assert(sizeof(CCryptoBoringSSLShims_gcm_parallel) + 15 <= sizeof(CCryptoBoringSSLShims_GCM_PARALLEL),
+              "CCryptoBoringSSLShims_GCM_PARALLEL is too small");
+
+// The public type has only 8-byte alignment, but the GCM context needs 16.
+static CCryptoBoringSSLShims_gcm_parallel *CCryptoBoringSSLShims_gcm_parallel_get(
+    const CCryptoBoringSSLShims_GCM_PARALLEL *state) {
+    return (CCryptoBoringSSLShims_gcm_parallel *)(((uintptr_t)state->opaque + 15) & ~(uintptr_t)15);
+}
+
+// Multiplies |x| by |y| in GCM's bit order, as in algorithm 1 of SP 800-38D.
+// This is slow but only runs a few times per segment, to raise H to the
+// segment length. It takes time independent of both inputs.
+static void CCryptoBoringSSLShims_gf128_mul(uint8_t out[16], const uint8_t x[16], const uint8_t y[16]) {
+    uint64_t z_hi = 0, z_lo = 0;
+    uint64_t v_hi = CRYPTO_load_u64_be(y), v_lo = CRYPTO_load_u64_be(y + 8);
+    for (unsigned i = 0; i < 128; i++) {
+        uint64_t bit = 0 - (uint64_t)((x[i / 8] >> (7 - i % 8)) & 1);
+        z_hi ^= v_hi & bit;
+        z_lo ^= v_lo & bit;
+        uint64_t carry = 0 - (v_lo & 1);
+        v_lo = (v_lo >> 1) | (v_hi << 63);
+        v_hi = (v_hi >> 1) ^ (UINT64_C(0xe100000000000000) & carry);
+    }
+    CRYPTO_store_u64_be(out, z_hi);
+    CRYPTO_store_u64_be(out + 8, z_lo);
+}
+
+static void CCryptoBoringSSLShims_gf128_pow(uint8_t out[16], const uint8_t h[16], uint64_t exponent) {
+    // One is the polynomial x^0, which is the top bit of the first byte.
+    uint8_t result[16] = {0x80}, base[16];
+    memcpy(base, h, 16);
+    for (; exponent != 0; exponent >>= 1) {
+        if (exponent & 1) {
+            CCryptoBoringSSLShims_gf128_mul(result, result, base);
+        }
+        CCryptoBoringSSLShims_gf128_mul(base, base, base);
+    }
+    memcpy(out, result, 16);
+    CCryptoBoringSSL_OPENSSL_cleanse(base, sizeof(base));
+    CCryptoBoringSSL_OPENSSL_cleanse(result, sizeof(result));
+}
+
+int CCryptoBoringSSLShims_GCM_PARALLEL_supported(const EVP_AEAD_CTX *ctx) {
+    return CCryptoBoringSSLShims_aead_stream_kind(ctx->aead) == CCRYPTOBORINGSSLSHIMS_AEAD_STREAM_GCM;
+}
+
+int CCryptoBoringSSLShims_GCM_PARALLEL_init(CCryptoBoringSSLShims_GCM_PARALLEL *state, const EVP_AEAD_CTX *ctx,
+                                            const void *nonce, size_t nonce_len, const void *ad, size_t ad_len,
+                                            size_t in_len, size_t segment_len, int encrypt) {
+    CCryptoBoringSSLShims_gcm_parallel *s = CCryptoBoringSSLShims_gcm_parallel_get(state);
+    memset(s, 0, sizeof(*s));
+    if (!CCryptoBoringSSLShims_GCM_PARALLEL_supported(ctx) || nonce_len == 0 || segment_len == 0 ||
+        segment_len % 16 != 0 || (uint64_t)in_len > (UINT64_C(1) << 36) - 32) {
+        return 0;
+    }
+
+    const CCryptoBoringSSLShims_aead_aes_gcm_ctx *gcm_ctx = (const CCryptoBoringSSLShims_aead_aes_gcm_ctx *)&ctx->state;
+    s->key = &gcm_ctx->ks.ks;
+    s->ctr = gcm_ctx->ctr;
+    s->tag_len = ctx->tag_len;
+    s->in_len = in_len;
+    s->segment_len = segment_len;
+    s->encrypt = encrypt;
+    memcpy(&s->gcm.gcm_key, &gcm_ctx->gcm_key, sizeof(s->gcm.gcm_key));
+    CRYPTO_gcm128_setiv(&s->gcm, s->key, nonce, nonce_len);
+    if (ad_len != 0 && !CRYPTO_gcm128_aad(&s->gcm, ad, ad_len)) {
+        return 0;
+    }
+    // As the first call to encrypt or decrypt would.
+    if (s->gcm.ares) {
+        s->gcm.gcm_key.gmult(s->gcm.Xi, s->gcm.gcm_key.Htable);
+        s->gcm.ares = 0;
+    }
+    return 1;
+}
+
+size_t CCryptoBoringSSLShims_GCM_PARALLEL_segment_count(const CCryptoBoringSSLShims_GCM_PARALLEL *state) {
+    const CCryptoBoringSSLShims_gcm_parallel *s = CCryptoBoringSSLShims_gcm_parallel_get(state);
+    return s->segment_len == 0 ? 0 : (size_t)((s->in_len + s->segment_len - 1) / s->segment_len);
+}
+
+void CCryptoBoringSSLShims_GCM_PARALLEL_segment(const CCryptoBoringSSLShims_GCM_PARALLEL *state, size_t index,
+                                                const void *in, void *out, uint8_t out_ghash[16]) {
+    const CCryptoBoringSSLShims_gcm_parallel *s = CCryptoBoringSSLShims_gcm_parallel_get(state);
+    const size_t offset = index * s->segment_len;
+    const size_t remaining = (size_t)s->in_len - offset;
+    const size_t len = remaining < s->segment_len ? remaining : s->segment_len;
+
+    GCM128_CONTEXT gcm;
+    memset(&gcm, 0, sizeof(gcm));
+    memcpy(&gcm.gcm_key, &s->gcm.gcm_key, sizeof(gcm.gcm_key));
+    // The counter is 32 bits and wraps, as inc32 does in a serial pass.
+    memcpy(gcm.Yi, s->gcm.Yi, 16);
+    CRYPTO_store_u32_be(gcm.Yi + 12, CRYPTO_load_u32_be(gcm.Yi + 12) + (uint32_t)(offset / 16));
+
+    const uint8_t *segment_in = (const uint8_t *)in + offset;
+    uint8_t *segment_out = (uint8_t *)out + offset;
+    // Neither can fail: each segment is far below GCM's length limit.
+    if (s->ctr != NULL) {
+        s->encrypt ? CRYPTO_gcm128_encrypt_ctr32(&gcm, s->key, segment_in, segment_out, len, s->ctr)
+                   : CRYPTO_gcm128_decrypt_ctr32(&gcm, s->key, segment_in, segment_out, len, s->ctr);
+    } else {
+        s->encrypt ? CRYPTO_gcm128_encrypt(&gcm, s->key, segment_in, segment_out, len)
+                   : CRYPTO_gcm128_decrypt(&gcm, s->key, segment_in, segment_out, len);
+    }
+    // A trailing partial block counts as a whole, zero-padded one.
+    if (gcm.mres) {
+        gcm.gcm_key.gmult(gcm.Xi, gcm.gcm_key.Htable);
+    }
+    memcpy(out_ghash, gcm.Xi, 16);
+    CCryptoBoringSSL_OPENSSL_cleanse(&gcm, sizeof(gcm));
+}
+
+// Folds the segments into the hash of the authenticated data, leaving the
+// context as a serial pass over the whole message would before the tag.
+static void CCryptoBoringSSLShims_gcm_parallel_combine(CCryptoBoringSSLShims_gcm_parallel *s, const uint8_t *ghashes) {
+    const size_t count = s->segment_len == 0 ? 0 : (size_t)((s->in_len + s->segment_len - 1) / s->segment_len);
+    if (count > 0) {
+        static const uint8_t kZero[16] = {0};
+        uint8_t h[16], h_segment[16], h_last[16];
+        s->gcm.gcm_key.block(kZero, h, s->key);
+        const uint64_t segment_blocks = s->segment_len / 16;
+        const uint64_t last_blocks = (s->in_len - (uint64_t)(count - 1) * s->segment_len + 15) / 16;
+        CCryptoBoringSSLShims_gf128_pow(h_segment, h, segment_blocks);
+        CCryptoBoringSSLShims_gf128_pow(h_last, h, last_blocks);
+
+        // X' = X * H^m + S for a segment of m blocks whose own GHASH is S.
+        for (size_t i = 0; i < count; i++) {
+            CCryptoBoringSSLShims_gf128_mul(s->gcm.Xi, s->gcm.Xi, i + 1 == count ? h_last : h_segment);
+            CRYPTO_xor16(s->gcm.Xi, s->gcm.Xi, ghashes + 16 * i);
+        }
+        CCryptoBoringSSL_OPENSSL_cleanse(h, sizeof(h));
+        CCryptoBoringSSL_OPENSSL_cleanse(h_segment, sizeof(h_segment));
+        CCryptoBoringSSL_OPENSSL_cleanse(h_last, sizeof(h_last));
+    }
+    s->gcm.len.msg = s->in_len;
+    s->gcm.mres = 0;
+}
+
+int CCryptoBoringSSLShims_GCM_PARALLEL_seal_finish(CCryptoBoringSSLShims_GCM_PARALLEL *state, const uint8_t *ghashes,
+                                                   void *out_tag, size_t *out_tag_len, size_t max_out_tag_len) {
+    CCryptoBoringSSLShims_gcm_parallel *s = CCryptoBoringSSLShims_gcm_parallel_get(state);
+    int ok = s->encrypt && max_out_tag_len >= s->tag_len;
+    if (ok) {
+        CCryptoBoringSSLShims_gcm_parallel_combine(s, ghashes);
+        CRYPTO_gcm128_tag(&s->gcm, out_tag, s->tag_len);
+        *out_tag_len = s->tag_len;
+    }
+    CCryptoBoringSSL_OPENSSL_cleanse(s, sizeof(*s));
+    return ok;
+}
+
+int CCryptoBoringSSLShims_GCM_PARALLEL_open_finish(CCryptoBoringSSLShims_GCM_PARALLEL *state, const uint8_t *ghashes,
+                                                   const void *in_tag, size_t in_tag_len) {
+    CCryptoBoringSSLShims_gcm_parallel *s = CCryptoBoringSSLShims_gcm_parallel_get(state);
+    int ok = !s->encrypt && in_tag_len == s->tag_len;
+    if (ok) {
+        CCryptoBoringSSLShims_gcm_parallel_combine(s, ghashes);
+        ok = CRYPTO_gcm128_finish(&s->gcm, in_tag, in_tag_len);
+    }
+    CCryptoBoringSSL_OPENSSL_cleanse(s, sizeof(*s));
+    return ok;
+}
+
+// MARK:- NUMA topology
+
+#if defined(__linux__) && !defined(OPENSSL_NO_THREADS_CORRUPT_MEMORY_AND_LEAK_SECRETS_IF_THREADED)
+#define CCRYPTOBORINGSSLSHIMS_NUMA 1
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Declared by <sched.h> only under _GNU_SOURCE. Both glibc and musl provide it.
+int sched_getcpu(void);
+
+#define CCRYPTOBORINGSSLSHIMS_NUMA_MAX_CPUS 4096
+#define CCRYPTOBORINGSSLSHIMS_NUMA_MAX_NODES 64
+
+static pthread_once_t CCryptoBoringSSLShims_numa_once = PTHREAD_ONCE_INIT;
+static size_t CCryptoBoringSSLShims_numa_nodes = 1;
+static uint8_t CCryptoBoringSSLShims_numa_cpu_to_node[CCRYPTOBORINGSSLSHIMS_NUMA_MAX_CPUS];
+
+// Reads a sysfs list such as "0-3,8-11" and calls |visit| for every range.
+// Returns zero if the file can't be read or parsed.
+static int CCryptoBoringSSLShims_numa_read_list(const char *path, void (*visit)(unsigned, unsigned, void *),
+                                                void *arg) {
+    FILE *file = fopen(path, "re");
+    if (file == NULL) {
+        return 0;
+    }
+    char line[4096];
+    int ok = fgets(line, sizeof(line), file) != NULL;
+    fclose(file);
+    if (!ok) {
+        return 0;
+    }
+
+    const char *p = line;
+    while (*p != '\0' && *p != '\n') {
+        char *end;
+        unsigned long first = strtoul(p, &end, 10), last = first;
+        if (end == p) {
+            return 0;
+        }
+        p = end;
+        if (*p == '-') {
+            last = strtoul(p + 1, &end, 10);
+            if (end == p + 1 || last < first) {
+                return 0;
+            }
+            p = end;
+        }
+        visit((unsigned)first, (unsigned)last, arg);
+        if (*p == ',') {
+            p++;
+        }
+    }
+    return 1;
+}
+
+static void CCryptoBoringSSLShims_numa_visit_nodes(unsigned first, unsigned last, void *arg) {
+    (void)first;
+    unsigned *max_node = arg;
+    if (last > *max_node) {
+        *max_node = last;
+    }
+}
+
+static void CCryptoBoringSSLShims_numa_visit_cpus(unsigned first, unsigned last, void *arg) {
+    uint8_t node = (uint8_t)(uintptr_t)arg;
+    for (unsigned cpu = first; cpu <= last && cpu < CCRYPTOBORINGSSLSHIMS_NUMA_MAX_CPUS; cpu++) {
+        CCryptoBoringSSLShims_numa_cpu_to_node[cpu] = node;
+    }
+}
+
+static void CCryptoBoringSSLShims_numa_init(void) {
+    unsigned max_node = 0;
+    if (!CCryptoBoringSSLShims_numa_read_list("/sys/devices/system/node/possible",
+                                              CCryptoBoringSSLShims_numa_visit_nodes, &max_node) ||
+        max_node == 0 || max_node >= CCRYPTOBORINGSSLSHIMS_NUMA_MAX_NODES) {
+        return;
+    }
+    for (unsigned node = 0; node <= max_node; node++) {
+        char path[64];
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%u/cpulist", node);
+        // Possible but absent nodes have no cpulist, and so no CPUs map to them.
+        CCryptoBoringSSLShims_numa_read_list(path, CCryptoBoringSSLShims_numa_visit_cpus, (void *)(uintptr_t)node);
+    }
+    CCryptoBoringSSLShims_numa_nodes = max_node + 1;
+}
+#endif
+
+size_t CCryptoBoringSSLShims_numa_node_count(void) {
+#if defined(CCRYPTOBORINGSSLSHIMS_NUMA)
+    pthread_once(&CCryptoBoringSSLShims_numa_once, CCryptoBoringSSLShims_numa_init);
+    return CCryptoBoringSSLShims_numa_nodes;
+#else
+    return 1;
+#endif
+}
+
+size_t CCryptoBoringSSLShims_numa_current_node(void) {
+#if defined(CCRYPTOBORINGSSLSHIMS_NUMA)
+    if (CCryptoBoringSSLShims_numa_node_count() == 1) {
+        return 0;
+    }
+    // sched_getcpu is served from the vDSO or rseq area, so this is cheap
+    // enough to call per operation.
+    int cpu = sched_getcpu();
+    if (cpu < 0 || cpu >= CCRYPTOBORINGSSLSHIMS_NUMA_MAX_CPUS) {
+        return 0;
+    }
+    return CCryptoBoringSSLShims_numa_cpu_to_node[cpu];
+#else
+    return 0;
+#endif
+}
+
+void *CCryptoBoringSSLShims_atomic_load_pointer(void *const *slot) {
+    return __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+}
+
+int CCryptoBoringSSLShims_atomic_compare_exchange_pointer(void **slot, void *expected, void *desired) {
+    return __atomic_compare_exchange_n(slot, &expected, desired, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+// MARK:- Fixed-buffer key marshalling
+
+// The size of a DER element with `content_len` bytes of content.
+static size_t der_element_size(size_t content_len) {
+    size_t header_len = 2;
+    if (content_len >= 0x80) {
+        for (size_t len = content_len; len != 0; len >>= 8) {
+            header_len++;
+        }
+    }
+    return header_len + content_len;
+}
+
+// The size of a DER INTEGER holding the non-negative `bn`. A leading zero
+// byte is needed when the top bit of the first byte is set.
+static size_t der_integer_size(const BIGNUM *bn) {
+    size_t content_len = CCryptoBoringSSL_BN_num_bytes(bn);
+    if (content_len == 0 || CCryptoBoringSSL_BN_num_bits(bn) % 8 == 0) {
+        content_len++;
+    }
+    return der_element_size(content_len);
+}
+
+size_t CCryptoBoringSSLShims_RSA_public_key_der_size(const RSA *rsa) {
+    return der_element_size(der_integer_size(CCryptoBoringSSL_RSA_get0_n(rsa)) +
+                            der_integer_size(CCryptoBoringSSL_RSA_get0_e(rsa)));
+}
+
+size_t CCryptoBoringSSLShims_RSA_spki_der_size(const RSA *rsa) {
+    // SEQUENCE { OBJECT IDENTIFIER rsaEncryption, NULL } is always 15 bytes.
+    static const size_t algorithm_len = 15;
+    // The BIT STRING starts with a zero count of unused bits.
+    size_t key_len = der_element_size(1 + CCryptoBoringSSLShims_RSA_public_key_der_size(rsa));
+    return der_element_size(algorithm_len + key_len);
+}
+
+size_t CCryptoBoringSSLShims_RSA_private_key_der_size(const RSA *rsa) {
+    const BIGNUM *n, *e, *d, *p, *q, *dmp1, *dmq1, *iqmp;
+    CCryptoBoringSSL_RSA_get0_key(rsa, &n, &e, &d);
+    CCryptoBoringSSL_RSA_get0_factors(rsa, &p, &q);
+    CCryptoBoringSSL_RSA_get0_crt_params(rsa, &dmp1, &dmq1, &iqmp);
+    if (n == NULL || e == NULL || d == NULL || p == NULL || q == NULL || dmp1 == NULL || dmq1 == NULL ||
+        iqmp == NULL) {
+        return 0;
+    }
+    // The version is INTEGER 0, three bytes.
+    return der_element_size(3 + der_integer_size(n) + der_integer_size(e) + der_integer_size(d) +
+                            der_integer_size(p) + der_integer_size(q) + der_integer_size(dmp1) +
+                            der_integer_size(dmq1) + der_integer_size(iqmp));
+}
+
+int CCryptoBoringSSLShims_RSA_marshal_public_key_fixed(uint8_t *out, size_t out_len, const RSA *rsa) {
+    CBB cbb;
+    size_t written;
+    if (!CCryptoBoringSSL_CBB_init_fixed(&cbb, out, out_len) ||
+        !CCryptoBoringSSL_RSA_marshal_public_key(&cbb, rsa) ||
+        !CCryptoBoringSSL_CBB_finish(&cbb, NULL, &written)) {
+        return 0;
+    }
+    return written == out_len;
+}
+
+int CCryptoBoringSSLShims_RSA_marshal_spki_fixed(uint8_t *out, size_t out_len, const EVP_PKEY *pkey) {
+    CBB cbb;
+    size_t written;
+    if (!CCryptoBoringSSL_CBB_init_fixed(&cbb, out, out_len) ||
+        !CCryptoBoringSSL_EVP_marshal_public_key(&cbb, pkey) ||
+        !CCryptoBoringSSL_CBB_finish(&cbb, NULL, &written)) {
+        return 0;
+    }
+    return written == out_len;
+}
+
+int CCryptoBoringSSLShims_RSA_marshal_private_key_fixed(uint8_t *out, size_t out_len, const RSA *rsa) {
+    CBB cbb;
+    size_t written;
+    if (!CCryptoBoringSSL_CBB_init_fixed(&cbb, out, out_len) ||
+        !CCryptoBoringSSL_RSA_marshal_private_key(&cbb, rsa) ||
+        !CCryptoBoringSSL_CBB_finish(&cbb, NULL, &written)) {
+        return 0;
+    }
+    return written == out_len;
+}
+
+// MARK:- Buffer key parsing
+
+RSA *CCryptoBoringSSLShims_RSA_parse_spki_buffer(const uint8_t *der, size_t der_len) {
+    CBS cbs;
+    CBS_init(&cbs, der, der_len);
+    EVP_PKEY *pkey = CCryptoBoringSSL_EVP_parse_public_key(&cbs);
+    if (pkey == NULL) {
+        return NULL;
+    }
+    RSA *rsa = CCryptoBoringSSL_EVP_PKEY_get1_RSA(pkey);
+    CCryptoBoringSSL_EVP_PKEY_free(pkey);
+    return rsa;
+}
+
+RSA *CCryptoBoringSSLShims_RSA_parse_public_key_buffer(const uint8_t *der, size_t der_len) {
+    CBS cbs;
+    CBS_init(&cbs, der, der_len);
+    return CCryptoBoringSSL_RSA_parse_public_key(&cbs);
+}
+
+RSA *CCryptoBoringSSLShims_RSA_parse_pkcs8_buffer(const uint8_t *der, size_t der_len) {
+    CBS cbs;
+    CBS_init(&cbs, der, der_len);
+    EVP_PKEY *pkey = CCryptoBoringSSL_EVP_parse_private_key(&cbs);
+    if (pkey == NULL) {
+        return NULL;
+    }
+    RSA *rsa = CCryptoBoringSSL_EVP_PKEY_get1_RSA(pkey);
+    CCryptoBoringSSL_EVP_PKEY_free(pkey);
+    return rsa;
+}
+
+RSA *CCryptoBoringSSLShims_RSA_parse_private_key_buffer(const uint8_t *der, size_t der_len) {
+    CBS cbs;
+    CBS_init(&cbs, der, der_len);
+    return CCryptoBoringSSL_RSA_parse_private_key(&cbs);
+}
+
+// MARK:- Slab allocator
+
+// BoringSSL's build renames its weak OPENSSL_memory_* hooks into the
+// CCryptoBoringSSL namespace, so defining these leaves any other copy of
+// BoringSSL in the process, such as CNIOBoringSSL, on its own allocator.
+#define CCRYPTOBORINGSSLSHIMS_MEMORY_HOOK(name) CCryptoBoringSSL_OPENSSL_memory_##name
+
+// With request arenas compiled in, the arena hooks further down own BoringSSL's
+// memory hooks, and hand every allocation made outside an arena to the
+// CCryptoBoringSSLShims_heap_* functions defined here.
+#if defined(CRYPTO_BORINGSSL_ARENAS) && defined(__ELF__) && defined(__GNUC__)
+#define CCRYPTOBORINGSSLSHIMS_ARENAS 1
+#define CCRYPTOBORINGSSLSHIMS_HEAP_HOOK(name) CCryptoBoringSSLShims_heap_##name
+#else
+#define CCRYPTOBORINGSSLSHIMS_HEAP_HOOK(name) CCRYPTOBORINGSSLSHIMS_MEMORY_HOOK(name)
+#endif
+
+#if defined(CRYPTO_BORINGSSL_SLAB_ALLOCATOR) && defined(__ELF__) && defined(__GNUC__) && \
+    !defined(OPENSSL_NO_THREADS_CORRUPT_MEMORY_AND_LEAK_SECRETS_IF_THREADED)
+#define CCRYPTOBORINGSSLSHIMS_HEAP_HOOKS 1
+#include <pthread.h>
+#include <stdlib.h>
+
+#define CCRYPTOBORINGSSLSHIMS_SLAB_CLASS_COUNT 6
+#define CCRYPTOBORINGSSLSHIMS_SLAB_OVERSIZE CCRYPTOBORINGSSLSHIMS_SLAB_CLASS_COUNT
+#define CCRYPTOBORINGSSLSHIMS_SLAB_SIZE (64 * 1024)
+#define CCRYPTOBORINGSSLSHIMS_SLAB_THREAD_CACHE_MAX 64
+#define CCRYPTOBORINGSSLSHIMS_SLAB_REFILL 16
+
+static const size_t CCryptoBoringSSLShims_slab_block_sizes[CCRYPTOBORINGSSLSHIMS_SLAB_CLASS_COUNT] = {
+    32, 64, 128, 256, 512, 1024,
+};
+
+// Every allocation is preceded by this header. It is 16 bytes on all targets so
+// that the pointers handed out keep malloc's alignment.
+struct CCryptoBoringSSLShims_slab_header {
+    _Alignas(16) size_t size;
+    size_t size_class;
+};
+
+// While a block is free, its header is reused as a free list link.
+struct CCryptoBoringSSLShims_slab_free_block {
+    struct CCryptoBoringSSLShims_slab_free_block *next;
+};
+
+struct CCryptoBoringSSLShims_slab_class {
+    CCryptoBoringSSLShims_lock lock;
+    struct CCryptoBoringSSLShims_slab_free_block *free_list;
+    // Updated with relaxed atomics, outside the lock.
+    uint64_t allocations;
+    uint64_t frees;
+    uint64_t cached_allocations;
+    uint64_t requested_bytes;
+    uint64_t slabs;
+};
+
+#define CCRYPTOBORINGSSLSHIMS_SLAB_CLASS_INIT { .lock = CCRYPTOBORINGSSLSHIMS_LOCK_INIT }
+
+// The extra class at the end only carries statistics for oversize allocations.
+static struct CCryptoBoringSSLShims_slab_class
+    CCryptoBoringSSLShims_slab_classes[CCRYPTOBORINGSSLSHIMS_SLAB_CLASS_COUNT + 1] = {
+    CCRYPTOBORINGSSLSHIMS_SLAB_CLASS_INIT, CCRYPTOBORINGSSLSHIMS_SLAB_CLASS_INIT,
+    CCRYPTOBORINGSSLSHIMS_SLAB_CLASS_INIT, CCRYPTOBORINGSSLSHIMS_SLAB_CLASS_INIT,
+    CCRYPTOBORINGSSLSHIMS_SLAB_CLASS_INIT, CCRYPTOBORINGSSLSHIMS_SLAB_CLASS_INIT,
+    CCRYPTOBORINGSSLSHIMS_SLAB_CLASS_INIT,
+};
+
+enum {
+    CCryptoBoringSSLShims_slab_cache_unregistered = 0,
+    CCryptoBoringSSLShims_slab_cache_registered,
+    // The thread is exiting and its cache has been flushed. Any allocations made
+    // by later thread destructors go straight to the shared lists.
+    CCryptoBoringSSLShims_slab_cache_torn_down,
+};
+
+struct CCryptoBoringSSLShims_slab_thread_cache {
+    struct CCryptoBoringSSLShims_slab_free_block *free_list[CCRYPTOBORINGSSLSHIMS_SLAB_CLASS_COUNT];
+    size_t count[CCRYPTOBORINGSSLSHIMS_SLAB_CLASS_COUNT];
+    int state;
+};
+
+static _Thread_local struct CCryptoBoringSSLShims_slab_thread_cache CCryptoBoringSSLShims_slab_thread_cache;
+static pthread_once_t CCryptoBoringSSLShims_slab_once = PTHREAD_ONCE_INIT;
+static pthread_key_t CCryptoBoringSSLShims_slab_key;
+static int CCryptoBoringSSLShims_slab_key_valid = 0;
+
+// These hooks may not call into BoringSSL, so this stands in for
+// OPENSSL_cleanse.
+static void CCryptoBoringSSLShims_slab_cleanse(void *ptr, size_t len) {
+    memset(ptr, 0, len);
+    __asm__ __volatile__("" : : "r"(ptr) : "memory");
+}
+
+static void CCryptoBoringSSLShims_slab_count(uint64_t *counter, uint64_t value) {
+    __atomic_fetch_add(counter, value, __ATOMIC_RELAXED);
+}
+
+// Pushes the chain from `head` to `tail` onto the shared list for `size_class`.
+static void CCryptoBoringSSLShims_slab_release(size_t size_class,
+                                               struct CCryptoBoringSSLShims_slab_free_block *head,
+                                               struct CCryptoBoringSSLShims_slab_free_block *tail) {
+    struct CCryptoBoringSSLShims_slab_class *class = &CCryptoBoringSSLShims_slab_classes[size_class];
+    CCryptoBoringSSLShims_lock_write(&class->lock, CCryptoBoringSSLShims_lock_site_slab_allocator);
+    tail->next = class->free_list;
+    class->free_list = head;
+    CCryptoBoringSSLShims_unlock_write(&class->lock);
+}
+
+static void CCryptoBoringSSLShims_slab_thread_exit(void *arg) {
+    struct CCryptoBoringSSLShims_slab_thread_cache *cache = arg;
+    for (size_t i = 0; i < CCRYPTOBORINGSSLSHIMS_SLAB_CLASS_COUNT; i++) {
+        struct CCryptoBoringSSLShims_slab_free_block *head = cache->free_list[i];
+        if (head == NULL) {
+            continue;
+        }
+        struct CCryptoBoringSSLShims_slab_free_block *tail = head;
+        while (tail->next != NULL) {
+            tail = tail->next;
+        }
+        CCryptoBoringSSLShims_slab_release(i, head, tail);
+        cache->free_list[i] = NULL;
+        cache->count[i] = 0;
+    }
+    cache->state = CCryptoBoringSSLShims_slab_cache_torn_down;
+}
+
+// The shared lists must not be locked across a fork, or the child could never
+// allocate again.
+static void CCryptoBoringSSLShims_slab_fork_prepare(void) {
+    for (size_t i = 0; i < CCRYPTOBORINGSSLSHIMS_SLAB_CLASS_COUNT; i++) {
+        CCryptoBoringSSLShims_lock_write(&CCryptoBoringSSLShims_slab_classes[i].lock,
+                                         CCryptoBoringSSLShims_lock_site_slab_allocator);
+    }
+}
+
+static void CCryptoBoringSSLShims_slab_fork_finish(void) {
+    for (size_t i = CCRYPTOBORINGSSLSHIMS_SLAB_CLASS_COUNT; i > 0; i--) {
+        CCryptoBoringSSLShims_unlock_write(&CCryptoBoringSSLShims_slab_classes[i - 1].lock);
+    }
+}
+
+static void CCryptoBoringSSLShims_slab_init(void) {
+    CCryptoBoringSSLShims_slab_key_valid =
+        pthread_key_create(&CCryptoBoringSSLShims_slab_key, CCryptoBoringSSLShims_slab_thread_exit) == 0;
+    pthread_atfork(CCryptoBoringSSLShims_slab_fork_prepare,
+                   CCryptoBoringSSLShims_slab_fork_finish,
+                   CCryptoBoringSSLShims_slab_fork_finish);
+}
+
+// Returns this thread's cache, or NULL if it cannot have one. A cache is only
+// used once a thread destructor is registered to flush it, so that blocks are
+// not stranded when the thread exits.
+static struct CCryptoBoringSSLShims_slab_thread_cache *CCryptoBoringSSLShims_slab_get_thread_cache(void) {
+    struct CCryptoBoringSSLShims_slab_thread_cache *cache = &CCryptoBoringSSLShims_slab_thread_cache;
+    if (cache->state == CCryptoBoringSSLShims_slab_cache_unregistered) {
+        pthread_once(&CCryptoBoringSSLShims_slab_once, CCryptoBoringSSLShims_slab_init);
+        if (CCryptoBoringSSLShims_slab_key_valid &&
+            pthread_setspecific(CCryptoBoringSSLShims_slab_key, cache) == 0) {
+            cache->state = CCryptoBoringSSLShims_slab_cache_registered;
+        } else {
+            cache->state = CCryptoBoringSSLShims_slab_cache_torn_down;
+        }
+    }
+    return cache->state == CCryptoBoringSSLShims_slab_cache_registered ? cache : NULL;
+}
+
+static size_t CCryptoBoringSSLShims_slab_class_for(size_t size) {
+    for (size_t i = 0; i < CCRYPTOBORINGSSLSHIMS_SLAB_CLASS_COUNT; i++) {
+        if (size <= CCryptoBoringSSLShims_slab_block_sizes[i]) {
+            return i;
+        }
+    }
+    return CCRYPTOBORINGSSLSHIMS_SLAB_OVERSIZE;
+}
+
+// Carves a new slab into blocks for `size_class`. Must be called with its lock
+// held.
+static int CCryptoBoringSSLShims_slab_grow(size_t size_class) {
+    struct CCryptoBoringSSLShims_slab_class *class = &CCryptoBoringSSLShims_slab_classes[size_class];
+    size_t stride = sizeof(struct CCryptoBoringSSLShims_slab_header) + CCryptoBoringSSLShims_slab_block_sizes[size_class];
+    uint8_t *slab = malloc(CCRYPTOBORINGSSLSHIMS_SLAB_SIZE);
+    if (slab == NULL) {
+        return 0;
+    }
+    for (size_t offset = 0; offset + stride <= CCRYPTOBORINGSSLSHIMS_SLAB_SIZE; offset += stride) {
+        struct CCryptoBoringSSLShims_slab_free_block *block = (struct CCryptoBoringSSLShims_slab_free_block *)(slab + offset);
+        block->next = class->free_list;
+        class->free_list = block;
+    }
+    CCryptoBoringSSLShims_slab_count(&class->slabs, 1);
+    return 1;
+}
+
+// Takes a block from the shared list for `size_class`, moving a batch of
+// further blocks into `cache` if there is one.
+static struct CCryptoBoringSSLShims_slab_header *CCryptoBoringSSLShims_slab_refill(
+    size_t size_class, struct CCryptoBoringSSLShims_slab_thread_cache *cache) {
+    struct CCryptoBoringSSLShims_slab_class *class = &CCryptoBoringSSLShims_slab_classes[size_class];
+    CCryptoBoringSSLShims_lock_write(&class->lock, CCryptoBoringSSLShims_lock_site_slab_allocator);
+    if (class->free_list == NULL && !CCryptoBoringSSLShims_slab_grow(size_class)) {
+        CCryptoBoringSSLShims_unlock_write(&class->lock);
+        return NULL;
+    }
+    struct CCryptoBoringSSLShims_slab_free_block *block = class->free_list;
+    class->free_list = block->next;
+    if (cache != NULL) {
+        for (size_t i = 1; i < CCRYPTOBORINGSSLSHIMS_SLAB_REFILL && class->free_list != NULL; i++) {
+            struct CCryptoBoringSSLShims_slab_free_block *next = class->free_list;
+            class->free_list = next->next;
+            next->next = cache->free_list[size_class];
+            cache->free_list[size_class] = next;
+            cache->count[size_class]++;
+        }
+    }
+    CCryptoBoringSSLShims_unlock_write(&class->lock);
+    return (struct CCryptoBoringSSLShims_slab_header *)block;
+}
+
+void *CCRYPTOBORINGSSLSHIMS_HEAP_HOOK(alloc)(size_t size) {
+    size_t size_class = CCryptoBoringSSLShims_slab_class_for(size);
+    struct CCryptoBoringSSLShims_slab_header *header;
+    if (size_class == CCRYPTOBORINGSSLSHIMS_SLAB_OVERSIZE) {
+        if (size > SIZE_MAX - sizeof(*header)) {
+            return NULL;
+        }
+        header = malloc(sizeof(*header) + size);
+    } else {
+        struct CCryptoBoringSSLShims_slab_thread_cache *cache = CCryptoBoringSSLShims_slab_get_thread_cache();
+        if (cache != NULL && cache->free_list[size_class] != NULL) {
+            struct CCryptoBoringSSLShims_slab_free_block *block = cache->free_list[size_class];
+            cache->free_list[size_class] = block->next;
+            cache->count[size_class]--;
+            header = (struct CCryptoBoringSSLShims_slab_header *)block;
+            CCryptoBoringSSLShims_slab_count(&CCryptoBoringSSLShims_slab_classes[size_class].cached_allocations, 1);
+        } else {
+            header = CCryptoBoringSSLShims_slab_refill(size_class, cache);
+        }
+    }
+    if (header == NULL) {
+        return NULL;
+    }
+
+    header->size = size;
+    header->size_class = size_class;
+    CCryptoBoringSSLShims_slab_count(&CCryptoBoringSSLShims_slab_classes[size_class].allocations, 1);
+    CCryptoBoringSSLShims_slab_count(&CCryptoBoringSSLShims_slab_classes[size_class].requested_bytes, size);
+    CCryptoBoringSSLShims_instrument(CCryptoBoringSSLShims_event_allocations, 1);
+    CCryptoBoringSSLShims_instrument(CCryptoBoringSSLShims_event_allocated_bytes, size);
+    return header + 1;
+}
+
+void CCRYPTOBORINGSSLSHIMS_HEAP_HOOK(free)(void *ptr) {
+    struct CCryptoBoringSSLShims_slab_header *header = (struct CCryptoBoringSSLShims_slab_header *)ptr - 1;
+    size_t size_class = header->size_class;
+
+    // Nothing beyond the requested size can have been written, so that is all
+    // that needs wiping.
+    CCryptoBoringSSLShims_slab_cleanse(ptr, header->size);
+    CCryptoBoringSSLShims_slab_count(&CCryptoBoringSSLShims_slab_classes[size_class].frees, 1);
+    CCryptoBoringSSLShims_instrument(CCryptoBoringSSLShims_event_frees, 1);
+
+    if (size_class == CCRYPTOBORINGSSLSHIMS_SLAB_OVERSIZE) {
+        free(header);
+        return;
+    }
+
+    struct CCryptoBoringSSLShims_slab_free_block *block = (struct CCryptoBoringSSLShims_slab_free_block *)header;
+    struct CCryptoBoringSSLShims_slab_thread_cache *cache = CCryptoBoringSSLShims_slab_get_thread_cache();
+    if (cache == NULL) {
+        CCryptoBoringSSLShims_slab_release(size_class, block, block);
+        return;
+    }
+
+    block->next = cache->free_list[size_class];
+    cache->free_list[size_class] = block;
+    if (++cache->count[size_class] > CCRYPTOBORINGSSLSHIMS_SLAB_THREAD_CACHE_MAX) {
+        // Hand half of the cache back, so that a thread which only frees cannot
+        // hoard blocks other threads are waiting for.
+        struct CCryptoBoringSSLShims_slab_free_block *tail = block;
+        for (size_t i = 1; i < CCRYPTOBORINGSSLSHIMS_SLAB_THREAD_CACHE_MAX / 2; i++) {
+            tail = tail->next;
+        }
+        cache->free_list[size_class] = tail->next;
+        cache->count[size_class] -= CCRYPTOBORINGSSLSHIMS_SLAB_THREAD_CACHE_MAX / 2;
+        CCryptoBoringSSLShims_slab_release(size_class, block, tail);
+    }
+}
+
+size_t CCRYPTOBORINGSSLSHIMS_HEAP_HOOK(get_size)(void *ptr) {
+    return ((struct CCryptoBoringSSLShims_slab_header *)ptr - 1)->size;
+}
+
+int CCryptoBoringSSLShims_slab_allocator_enabled(void) {
+    return 1;
+}
+
+size_t CCryptoBoringSSLShims_slab_allocator_class_count(void) {
+    return CCRYPTOBORINGSSLSHIMS_SLAB_CLASS_COUNT + 1;
+}
+
+int CCryptoBoringSSLShims_slab_allocator_statistics(size_t index,
+                                                    CCryptoBoringSSLShims_slab_statistics *out) {
+    if (index > CCRYPTOBORINGSSLSHIMS_SLAB_CLASS_COUNT) {
+        return 0;
+    }
+    struct CCryptoBoringSSLShims_slab_class *class = &CCryptoBoringSSLShims_slab_classes[index];
+    out->block_size = index < CCRYPTOBORINGSSLSHIMS_SLAB_CLASS_COUNT ? CCryptoBoringSSLShims_slab_block_sizes[index] : 0;
+    out->allocations = __atomic_load_n(&class->allocations, __ATOMIC_RELAXED);
+    out->frees = __atomic_load_n(&class->frees, __ATOMIC_RELAXED);
+    out->cached_allocations = __atomic_load_n(&class->cached_allocations, __ATOMIC_RELAXED);
+    out->requested_bytes = __atomic_load_n(&class->requested_bytes, __ATOMIC_RELAXED);
+    out->slabs = __atomic_load_n(&class->slabs, __ATOMIC_RELAXED);
+    return 1;
+}
+
+#else
+
+#if defined(CCRYPTOBORINGSSLSHIMS_INSTRUMENTATION) && defined(__ELF__) && defined(__GNUC__)
+#define CCRYPTOBORINGSSLSHIMS_HEAP_HOOKS 1
+#include <stdlib.h>
+
+// Without the slab allocator, allocations are still counted by hooks that
+// behave like BoringSSL's own: a size prefix on top of malloc, and a cleanse of
+// the whole allocation on free.
+struct CCryptoBoringSSLShims_counted_header {
+    _Alignas(16) size_t size;
+};
+
+static void CCryptoBoringSSLShims_counted_cleanse(void *ptr, size_t len) {
+    memset(ptr, 0, len);
+    __asm__ __volatile__("" : : "r"(ptr) : "memory");
+}
+
+void *CCRYPTOBORINGSSLSHIMS_HEAP_HOOK(alloc)(size_t size) {
+    if (size > SIZE_MAX - sizeof(struct CCryptoBoringSSLShims_counted_header)) {
+        return NULL;
+    }
+    struct CCryptoBoringSSLShims_counted_header *header = malloc(sizeof(*header) + size);
+    if (header == NULL) {
+        return NULL;
+    }
+    header->size = size;
+    CCryptoBoringSSLShims_instrument(CCryptoBoringSSLShims_event_allocations, 1);
+    CCryptoBoringSSLShims_instrument(CCryptoBoringSSLShims_event_allocated_bytes, size);
+    return header + 1;
+}
+
+void CCRYPTOBORINGSSLSHIMS_HEAP_HOOK(free)(void *ptr) {
+    struct CCryptoBoringSSLShims_counted_header *header = (struct CCryptoBoringSSLShims_counted_header *)ptr - 1;
+    CCryptoBoringSSLShims_counted_cleanse(header, sizeof(*header) + header->size);
+    CCryptoBoringSSLShims_instrument(CCryptoBoringSSLShims_event_frees, 1);
+    free(header);
+}
+
+size_t CCRYPTOBORINGSSLSHIMS_HEAP_HOOK(get_size)(void *ptr) {
+    return ((struct CCryptoBoringSSLShims_counted_header *)ptr - 1)->size;
+}
+#endif
+
+int CCryptoBoringSSLShims_slab_allocator_enabled(void) {
+    return 0;
+}
+
+size_t CCryptoBoringSSLShims_slab_allocator_class_count(void) {
+    return 0;
+}
+
+int CCryptoBoringSSLShims_slab_allocator_statistics(size_t index,
+                                                    CCryptoBoringSSLShims_slab_statistics *out) {
+    (void)index;
+    (void)out;
+    return 0;
+}
+
+#endif
+
+// MARK:- Request arenas
+
+#if defined(CCRYPTOBORINGSSLSHIMS_ARENAS)
+#include <stdlib.h>
+
+#if !defined(CCRYPTOBORINGSSLSHIMS_HEAP_HOOKS)
+// Nothing else replaces BoringSSL's allocator, so allocations outside an arena
+// go straight to malloc, and are cleansed here on free.
+static void *CCryptoBoringSSLShims_heap_alloc(size_t size) {
+    return malloc(size);
+}
+
+static void CCryptoBoringSSLShims_heap_free(void *ptr) {
+    free(ptr);
+}
+#define CCRYPTOBORINGSSLSHIMS_ARENA_HEAP_CLEANSES 0
+#else
+#define CCRYPTOBORINGSSLSHIMS_ARENA_HEAP_CLEANSES 1
+#endif
+
+struct CCryptoBoringSSLShims_arena;
+
+// Every allocation is preceded by this header, whether or not it came from an
+// arena. It is 16 bytes on all targets so that the pointers handed out keep
+// malloc's alignment.
+struct CCryptoBoringSSLShims_arena_header {
+    _Alignas(16) size_t size;
+    // NULL for allocations made outside an arena.
+    struct CCryptoBoringSSLShims_arena *arena;
+};
+
+// Set on the size of an arena allocation that was freed by the arena's own
+// thread while the arena was installed, and is waiting to be cleansed with the
+// rest of the arena.
+#define CCRYPTOBORINGSSLSHIMS_ARENA_DEFERRED (((size_t)1) << (sizeof(size_t) * 8 - 1))
+
+struct CCryptoBoringSSLShims_arena_region {
+    _Alignas(16) struct CCryptoBoringSSLShims_arena_region *next;
+    size_t capacity;
+    size_t used;
+};
+
+struct CCryptoBoringSSLShims_arena {
+    // The most recent region, which allocations are bumped from.
+    struct CCryptoBoringSSLShims_arena_region *regions;
+    // The arena installed on the thread before this one.
+    struct CCryptoBoringSSLShims_arena *previous;
+    // The address of the owning thread's CCryptoBoringSSLShims_arena_current.
+    void *owner;
+    size_t region_size;
+    int installed;
+    // The live allocations, plus one while the arena is installed. Whoever
+    // drops this to zero frees the arena. Updated atomically, as allocations
+    // may be freed on any thread.
+    size_t references;
+    // Only written by the owning thread.
+    uint64_t allocations;
+    uint64_t allocated_bytes;
+    uint64_t region_count;
+    uint64_t reserved_bytes;
+};
+
+static _Thread_local struct CCryptoBoringSSLShims_arena *CCryptoBoringSSLShims_arena_current;
+
+// These hooks may not call into BoringSSL, so this stands in for
+// OPENSSL_cleanse.
+static void CCryptoBoringSSLShims_arena_cleanse(void *ptr, size_t len) {
+    memset(ptr, 0, len);
+    __asm__ __volatile__("" : : "r"(ptr) : "memory");
+}
+
+static size_t CCryptoBoringSSLShims_arena_stride(size_t size) {
+    return (sizeof(struct CCryptoBoringSSLShims_arena_header) + size + 15) & ~(size_t)15;
+}
+
+static uint8_t *CCryptoBoringSSLShims_arena_region_data(struct CCryptoBoringSSLShims_arena_region *region) {
+    return (uint8_t *)(region + 1);
+}
+
+static void CCryptoBoringSSLShims_arena_destroy(struct CCryptoBoringSSLShims_arena *arena) {
+    struct CCryptoBoringSSLShims_arena_region *region = arena->regions;
+    while (region != NULL) {
+        struct CCryptoBoringSSLShims_arena_region *next = region->next;
+        free(region);
+        region = next;
+    }
+    free(arena);
+}
+
+static void CCryptoBoringSSLShims_arena_release(struct CCryptoBoringSSLShims_arena *arena) {
+    if (__atomic_sub_fetch(&arena->references, 1, __ATOMIC_ACQ_REL) == 0) {
+        CCryptoBoringSSLShims_arena_destroy(arena);
+    }
+}
+
+static void *CCryptoBoringSSLShims_arena_alloc(struct CCryptoBoringSSLShims_arena *arena, size_t size) {
+    if (size > (SIZE_MAX >> 1) - sizeof(struct CCryptoBoringSSLShims_arena_header) - 15) {
+        return NULL;
+    }
+    size_t stride = CCryptoBoringSSLShims_arena_stride(size);
+    struct CCryptoBoringSSLShims_arena_region *region = arena->regions;
+    if (region == NULL || region->capacity - region->used < stride) {
+        size_t capacity = stride > arena->region_size ? stride : arena->region_size;
+        region = malloc(sizeof(*region) + capacity);
+        if (region == NULL) {
+            return NULL;
+        }
+        region->next = arena->regions;
+        region->capacity = capacity;
+        region->used = 0;
+        arena->regions = region;
+        arena->region_count++;
+        arena->reserved_bytes += capacity;
+    }
+
+    struct CCryptoBoringSSLShims_arena_header *header =
+        (struct CCryptoBoringSSLShims_arena_header *)(CCryptoBoringSSLShims_arena_region_data(region) + region->used);
+    region->used += stride;
+    header->size = size;
+    header->arena = arena;
+    __atomic_fetch_add(&arena->references, 1, __ATOMIC_RELAXED);
+    arena->allocations++;
+    arena->allocated_bytes += size;
+    CCryptoBoringSSLShims_instrument(CCryptoBoringSSLShims_event_allocations, 1);
+    CCryptoBoringSSLShims_instrument(CCryptoBoringSSLShims_event_allocated_bytes, size);
+    return header + 1;
+}
+
+void *CCRYPTOBORINGSSLSHIMS_MEMORY_HOOK(alloc)(size_t size) {
+    struct CCryptoBoringSSLShims_arena *arena = CCryptoBoringSSLShims_arena_current;
+    if (arena != NULL) {
+        return CCryptoBoringSSLShims_arena_alloc(arena, size);
+    }
+
+    if (size > SIZE_MAX - sizeof(struct CCryptoBoringSSLShims_arena_header)) {
+        return NULL;
+    }
+    struct CCryptoBoringSSLShims_arena_header *header =
+        CCryptoBoringSSLShims_heap_alloc(sizeof(struct CCryptoBoringSSLShims_arena_header) + size);
+    if (header == NULL) {
+        return NULL;
+    }
+    header->size = size;
+    header->arena = NULL;
+    return header + 1;
+}
+
+void CCRYPTOBORINGSSLSHIMS_MEMORY_HOOK(free)(void *ptr) {
+    struct CCryptoBoringSSLShims_arena_header *header = (struct CCryptoBoringSSLShims_arena_header *)ptr - 1;
+    struct CCryptoBoringSSLShims_arena *arena = header->arena;
+    if (arena == NULL) {
+        if (!CCRYPTOBORINGSSLSHIMS_ARENA_HEAP_CLEANSES) {
+            CCryptoBoringSSLShims_arena_cleanse(header, sizeof(*header) + header->size);
+        }
+        CCryptoBoringSSLShims_heap_free(header);
+        return;
+    }
+
+    CCryptoBoringSSLShims_instrument(CCryptoBoringSSLShims_event_frees, 1);
+    // `installed` is only written by the owning thread, so only that thread may
+    // read it here. Other threads, and the owner once the scope is over, cleanse
+    // what they free straight away.
+    if (arena->owner == (void *)&CCryptoBoringSSLShims_arena_current && arena->installed) {
+        header->size |= CCRYPTOBORINGSSLSHIMS_ARENA_DEFERRED;
+    } else {
+        CCryptoBoringSSLShims_arena_cleanse(ptr, header->size);
+    }
+    CCryptoBoringSSLShims_arena_release(arena);
+}
+
+size_t CCRYPTOBORINGSSLSHIMS_MEMORY_HOOK(get_size)(void *ptr) {
+    return ((struct CCryptoBoringSSLShims_arena_header *)ptr - 1)->size;
+}
+
+int CCryptoBoringSSLShims_arena_enabled(void) {
+    return 1;
+}
+
+void *CCryptoBoringSSLShims_arena_push(size_t region_size) {
+    struct CCryptoBoringSSLShims_arena *arena = malloc(sizeof(*arena));
+    if (arena == NULL) {
+        return NULL;
+    }
+    memset(arena, 0, sizeof(*arena));
+    arena->previous = CCryptoBoringSSLShims_arena_current;
+    arena->owner = (void *)&CCryptoBoringSSLShims_arena_current;
+    arena->region_size = region_size < 256 ? 256 : region_size;
+    arena->installed = 1;
+    arena->references = 1;
+    CCryptoBoringSSLShims_arena_current = arena;
+    return arena;
+}
+
+void CCryptoBoringSSLShims_arena_pop(void *opaque) {
+    struct CCryptoBoringSSLShims_arena *arena = opaque;
+    if (arena == NULL) {
+        return;
+    }
+    CCryptoBoringSSLShims_arena_current = arena->previous;
+    arena->installed = 0;
+
+    if (__atomic_load_n(&arena->references, __ATOMIC_ACQUIRE) == 1) {
+        // Nothing escaped the scope, and no other thread can reach the arena any
+        // more, so everything is cleansed in one pass per region.
+        for (struct CCryptoBoringSSLShims_arena_region *region = arena->regions; region != NULL;
+             region = region->next) {
+            CCryptoBoringSSLShims_arena_cleanse(CCryptoBoringSSLShims_arena_region_data(region), region->used);
+        }
+        CCryptoBoringSSLShims_arena_destroy(arena);
+        return;
+    }
+
+    // Some allocations outlive the scope, and keep the regions alive until they
+    // are freed. Only the bytes of those freed already are cleansed now; the
+    // rest are cleansed as they are freed.
+    for (struct CCryptoBoringSSLShims_arena_region *region = arena->regions; region != NULL; region = region->next) {
+        uint8_t *data = CCryptoBoringSSLShims_arena_region_data(region);
+        size_t offset = 0;
+        while (offset < region->used) {
+            struct CCryptoBoringSSLShims_arena_header *header = (struct CCryptoBoringSSLShims_arena_header *)(data + offset);
+            size_t size = header->size & ~CCRYPTOBORINGSSLSHIMS_ARENA_DEFERRED;
+            if (header->size & CCRYPTOBORINGSSLSHIMS_ARENA_DEFERRED) {
+                CCryptoBoringSSLShims_arena_cleanse(header + 1, size);
+            }
+            offset += CCryptoBoringSSLShims_arena_stride(size);
+        }
+    }
+    CCryptoBoringSSLShims_arena_release(arena);
+}
+
+int CCryptoBoringSSLShims_arena_current_statistics(CCryptoBoringSSLShims_arena_statistics *out) {
+    struct CCryptoBoringSSLShims_arena *arena = CCryptoBoringSSLShims_arena_current;
+    if (arena == NULL) {
+        return 0;
+    }
+    out->allocations = arena->allocations;
+    out->allocated_bytes = arena->allocated_bytes;
+    out->live_allocations = __atomic_load_n(&arena->references, __ATOMIC_RELAXED) - 1;
+    out->regions = arena->region_count;
+    out->reserved_bytes = arena->reserved_bytes;
+    return 1;
+}
+
+#else
+
+int CCryptoBoringSSLShims_arena_enabled(void) {
+    return 0;
+}
+
+void *CCryptoBoringSSLShims_arena_push(size_t region_size) {
+    (void)region_size;
+    return NULL;
+}
+
+void CCryptoBoringSSLShims_arena_pop(void *arena) {
+    (void)arena;
+}
+
+int CCryptoBoringSSLShims_arena_current_statistics(CCryptoBoringSSLShims_arena_statistics *out) {
+    (void)out;
+    return 0;
+}
+
+#endif
+
+// MARK:- Bulk trust store loading
+
+#if !defined(_WIN32) && !defined(OPENSSL_NO_THREADS_CORRUPT_MEMORY_AND_LEAK_SECRETS_IF_THREADED)
+#define CCRYPTOBORINGSSLSHIMS_PARALLEL_BUNDLE 1
+#include <pthread.h>
+#endif
+
+#if !defined(_WIN32)
+#include <time.h>
+#endif
+
+#include "../CCryptoBoringSSL/crypto/x509/internal.h"
+
+enum {
+    CCryptoBoringSSLShims_bundle_der = 0,
+    CCryptoBoringSSLShims_bundle_pem_certificate,
+    CCryptoBoringSSLShims_bundle_pem_trusted_certificate,
+};
+
+// One object found in the bundle. `data` is the DER encoding, or the base64
+// body of a PEM block.
+typedef struct {
+    const uint8_t *data;
+    size_t len;
+    size_t offset;
+    int kind;
+    X509 *x509;
+} CCryptoBoringSSLShims_bundle_object;
+
+typedef struct {
+    CCryptoBoringSSLShims_bundle_object *objects;
+    size_t objects_count;
+    size_t worker;
+    size_t workers;
+    size_t failures;
+} CCryptoBoringSSLShims_bundle_worker;
+
+static uint64_t CCryptoBoringSSLShims_bundle_now(void) {
+#if !defined(_WIN32)
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+#else
+    return 0;
+#endif
+}
+
+static const uint8_t *CCryptoBoringSSLShims_bundle_find(const uint8_t *data, size_t len, const char *needle) {
+    size_t needle_len = strlen(needle);
+    while (len >= needle_len) {
+        const uint8_t *hit = memchr(data, needle[0], len - needle_len + 1);
+        if (hit == NULL) {
+            return NULL;
+        }
+        if (memcmp(hit, needle, needle_len) == 0) {
+            return hit;
+        }
+        len -= (size_t)(hit - data) + 1;
+        data = hit + 1;
+    }
+    return NULL;
+}
+
+static int CCryptoBoringSSLShims_bundle_push(CCryptoBoringSSLShims_bundle_object **objects, size_t *count,
+                                             size_t *capacity, CCryptoBoringSSLShims_bundle_object object) {
+    if (*count == *capacity) {
+        size_t new_capacity = *capacity == 0 ? 256 : *capacity * 2;
+        CCryptoBoringSSLShims_bundle_object *grown =
+            CCryptoBoringSSL_OPENSSL_realloc(*objects, new_capacity * sizeof(**objects));
+        if (grown == NULL) {
+            return 0;
+        }
+        *objects = grown;
+        *capacity = new_capacity;
+    }
+    (*objects)[(*count)++] = object;
+    return 1;
+}
+
+// Splits a PEM bundle at its BEGIN and END lines, without decoding anything.
+// Blocks of types other than certificates are counted in |skipped|. Returns
+// zero on allocation failure or an unterminated block, with the block's offset
+// in |failed_offset|.
+static int CCryptoBoringSSLShims_bundle_split_pem(const uint8_t *bundle, size_t len,
+                                                  CCryptoBoringSSLShims_bundle_object **objects, size_t *count,
+                                                  size_t *capacity, size_t *skipped, size_t *failed_offset) {
+    static const char kBegin[] = "-----BEGIN ";
+    static const char kEnd[] = "-----END ";
+    static const char kDashes[] = "-----";
+
+    const uint8_t *p = bundle, *end = bundle + len;
+    for (;;) {
+        const uint8_t *begin = CCryptoBoringSSLShims_bundle_find(p, (size_t)(end - p), kBegin);
+        if (begin == NULL) {
+            return 1;
+        }
+        *failed_offset = (size_t)(begin - bundle);
+        const uint8_t *label = begin + strlen(kBegin);
+        const uint8_t *label_end = CCryptoBoringSSLShims_bundle_find(label, (size_t)(end - label), kDashes);
+        if (label_end == NULL) {
+            return 0;
+        }
+        size_t label_len = (size_t)(label_end - label);
+        const uint8_t *body = label_end + strlen(kDashes);
+
+        // The matching END line must carry the same label.
+        const uint8_t *q = body, *footer = NULL;
+        while ((footer = CCryptoBoringSSLShims_bundle_find(q, (size_t)(end - q), kEnd)) != NULL) {
+            const uint8_t *footer_label = footer + strlen(kEnd);
+            if ((size_t)(end - footer_label) >= label_len + strlen(kDashes) &&
+                memcmp(footer_label, label, label_len) == 0 &&
+                memcmp(footer_label + label_len, kDashes, strlen(kDashes)) == 0) {
+                break;
+            }
+            q = footer_label;
+        }
+        if (footer == NULL) {
+            return 0;
+        }
+        p = footer + strlen(kEnd) + label_len + strlen(kDashes);
+
+        int kind;
+        if ((label_len == 11 && memcmp(label, "CERTIFICATE", 11) == 0) ||
+            (label_len == 16 && memcmp(label, "X509 CERTIFICATE", 16) == 0)) {
+            kind = CCryptoBoringSSLShims_bundle_pem_certificate;
+        } else if (label_len == 19 && memcmp(label, "TRUSTED CERTIFICATE", 19) == 0) {
+            kind = CCryptoBoringSSLShims_bundle_pem_trusted_certificate;
+        } else {
+            (*skipped)++;
+            continue;
+        }
+        CCryptoBoringSSLShims_bundle_object object = {body, (size_t)(footer - body), (size_t)(begin - bundle), kind,
+                                                      NULL};
+        if (!CCryptoBoringSSLShims_bundle_push(objects, count, capacity, object)) {
+            return 0;
+        }
+    }
+}
+
+// Splits concatenated DER certificates at their outer SEQUENCE lengths.
+static int CCryptoBoringSSLShims_bundle_split_der(const uint8_t *bundle, size_t len,
+                                                  CCryptoBoringSSLShims_bundle_object **objects, size_t *count,
+                                                  size_t *capacity, size_t *failed_offset) {
+    CBS cbs;
+    CBS_init(&cbs, bundle, len);
+    while (CBS_len(&cbs) > 0) {
+        *failed_offset = len - CBS_len(&cbs);
+        CBS element;
+        if (!CBS_get_asn1_element(&cbs, &element, CBS_ASN1_SEQUENCE)) {
+            return 0;
+        }
+        CCryptoBoringSSLShims_bundle_object object = {CBS_data(&element), CBS_len(&element), *failed_offset,
+                                                      CCryptoBoringSSLShims_bundle_der, NULL};
+        if (!CCryptoBoringSSLShims_bundle_push(objects, count, capacity, object)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static X509 *CCryptoBoringSSLShims_bundle_parse(const CCryptoBoringSSLShims_bundle_object *object) {
+    if (object->kind == CCryptoBoringSSLShims_bundle_der) {
+        const uint8_t *der = object->data;
+        X509 *x509 = CCryptoBoringSSL_d2i_X509(NULL, &der, (long)object->len);
+        if (x509 != NULL && der != object->data + object->len) {
+            CCryptoBoringSSL_X509_free(x509);
+            return NULL;
+        }
+        return x509;
+    }
+
+    // Base64 is never longer than the bytes it encodes, and EVP_DecodeUpdate
+    // skips the line breaks.
+    uint8_t *der = CCryptoBoringSSL_OPENSSL_malloc(object->len + 3);
+    if (der == NULL) {
+        return NULL;
+    }
+    EVP_ENCODE_CTX ctx;
+    CCryptoBoringSSL_EVP_DecodeInit(&ctx);
+    int update_len = 0, final_len = 0;
+    X509 *x509 = NULL;
+    if (object->len <= INT_MAX &&
+        CCryptoBoringSSL_EVP_DecodeUpdate(&ctx, der, &update_len, object->data, (int)object->len) >= 0 &&
+        CCryptoBoringSSL_EVP_DecodeFinal(&ctx, der + update_len, &final_len) >= 0) {
+        size_t der_len = (size_t)update_len + (size_t)final_len;
+        const uint8_t *inp = der;
+        x509 = object->kind == CCryptoBoringSSLShims_bundle_pem_trusted_certificate
+                   ? CCryptoBoringSSL_d2i_X509_AUX(NULL, &inp, (long)der_len)
+                   : CCryptoBoringSSL_d2i_X509(NULL, &inp, (long)der_len);
+        if (x509 != NULL && inp != der + der_len) {
+            CCryptoBoringSSL_X509_free(x509);
+            x509 = NULL;
+        }
+    }
+    CCryptoBoringSSL_OPENSSL_free(der);
+    return x509;
+}
+
+static void *CCryptoBoringSSLShims_bundle_worker_run(void *arg) {
+    CCryptoBoringSSLShims_bundle_worker *worker = arg;
+    // CA bundles hold certificates of similar size, so a round-robin split is
+    // even enough.
+    for (size_t i = worker->worker; i < worker->objects_count; i += worker->workers) {
+        X509 *x509 = CCryptoBoringSSLShims_bundle_parse(&worker->objects[i]);
+        worker->objects[i].x509 = x509;
+        if (x509 == NULL) {
+            worker->failures++;
+            continue;
+        }
+        // Cache the extensions and the certificate hash here, in parallel. Both
+        // the sort below and every later chain build need them, and otherwise
+        // the first to ask computes them under the certificate's write lock.
+        // A certificate with bad extensions is still loaded, as
+        // X509_STORE_add_cert would load it, and verification rejects it.
+        CCryptoBoringSSL_x509v3_cache_extensions(x509);
+    }
+    CCryptoBoringSSL_ERR_clear_error();
+    return NULL;
+}
+
+static int CCryptoBoringSSLShims_bundle_object_cmp(const void *a, const void *b) {
+    const CCryptoBoringSSLShims_bundle_object *lhs = a, *rhs = b;
+    return CCryptoBoringSSL_X509_cmp(lhs->x509, rhs->x509);
+}
+
+// Whether the sorted |objs| already holds the certificate in |object|. This is
+// the check X509_STORE_add_cert makes, which orders the stack by subject.
+static int CCryptoBoringSSLShims_bundle_store_contains(STACK_OF(X509_OBJECT) *objs, X509_OBJECT *object) {
+    size_t idx;
+    if (!sk_X509_OBJECT_find(objs, &idx, object)) {
+        return 0;
+    }
+    for (; idx < sk_X509_OBJECT_num(objs); idx++) {
+        X509_OBJECT *candidate = sk_X509_OBJECT_value(objs, idx);
+        if (candidate->type != X509_LU_X509 ||
+            CCryptoBoringSSL_X509_subject_name_cmp(candidate->data.x509, object->data.x509) != 0) {
+            return 0;
+        }
+        if (CCryptoBoringSSL_X509_cmp(candidate->data.x509, object->data.x509) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int CCryptoBoringSSLShims_X509_STORE_load_bundle(X509_STORE *store, const void *bundle, size_t bundle_len,
+                                                 size_t max_threads,
+                                                 CCryptoBoringSSLShims_X509_bundle_statistics *out_statistics) {
+    CCryptoBoringSSLShims_X509_bundle_statistics statistics = {0};
+    statistics.bytes = bundle_len;
+    uint64_t start = CCryptoBoringSSLShims_bundle_now();
+
+    const uint8_t *bytes = bundle;
+    size_t offset = 0;
+    while (offset < bundle_len &&
+           (bytes[offset] == ' ' || bytes[offset] == '\t' || bytes[offset] == '\r' || bytes[offset] == '\n')) {
+        offset++;
+    }
+
+    // A DER bundle starts with the tag of a certificate's outer SEQUENCE, which
+    // can't begin a PEM file.
+    int is_der = offset < bundle_len && bytes[offset] == 0x30;
+
+    CCryptoBoringSSLShims_bundle_object *objects = NULL;
+    size_t count = 0, capacity = 0;
+    int ok = is_der ? CCryptoBoringSSLShims_bundle_split_der(bytes + offset, bundle_len - offset, &objects, &count,
+                                                             &capacity, &statistics.failed_offset)
+                    : CCryptoBoringSSLShims_bundle_split_pem(bytes, bundle_len, &objects, &count, &capacity,
+                                                             &statistics.objects_skipped, &statistics.failed_offset);
+    if (is_der) {
+        for (size_t i = 0; i < count; i++) {
+            objects[i].offset += offset;
+        }
+        statistics.failed_offset += offset;
+    }
+
+    size_t workers = max_threads == 0 ? 1 : max_threads;
+    if (workers > CCryptoBoringSSLShims_X509_BUNDLE_MAX_THREADS) {
+        workers = CCryptoBoringSSLShims_X509_BUNDLE_MAX_THREADS;
+    }
+#if !defined(CCRYPTOBORINGSSLSHIMS_PARALLEL_BUNDLE)
+    workers = 1;
+#endif
+    // Below a few dozen certificates a thread costs more than it saves.
+    if (workers > count / 16) {
+        workers = count / 16 > 0 ? count / 16 : 1;
+    }
+
+    size_t failures = 0;
+    if (ok && count > 0) {
+        CCryptoBoringSSLShims_bundle_worker worker_state[CCryptoBoringSSLShims_X509_BUNDLE_MAX_THREADS];
+        for (size_t w = 0; w < workers; w++) {
+            worker_state[w] = (CCryptoBoringSSLShims_bundle_worker){objects, count, w, workers, 0};
+        }
+#if defined(CCRYPTOBORINGSSLSHIMS_PARALLEL_BUNDLE)
+        pthread_t threads[CCryptoBoringSSLShims_X509_BUNDLE_MAX_THREADS];
+        int started[CCryptoBoringSSLShims_X509_BUNDLE_MAX_THREADS] = {0};
+        for (size_t w = 1; w < workers; w++) {
+            started[w] =
+                pthread_create(&threads[w], NULL, CCryptoBoringSSLShims_bundle_worker_run, &worker_state[w]) == 0;
+        }
+#endif
+        CCryptoBoringSSLShims_bundle_worker_run(&worker_state[0]);
+        failures = worker_state[0].failures;
+        for (size_t w = 1; w < workers; w++) {
+#if defined(CCRYPTOBORINGSSLSHIMS_PARALLEL_BUNDLE)
+            if (started[w]) {
+                pthread_join(threads[w], NULL);
+                failures += worker_state[w].failures;
+                continue;
+            }
+#endif
+            // The thread could not be started, so its share is parsed here.
+            CCryptoBoringSSLShims_bundle_worker_run(&worker_state[w]);
+            failures += worker_state[w].failures;
+        }
+        statistics.threads = workers;
+    }
+    if (ok && failures > 0) {
+        ok = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (objects[i].x509 == NULL) {
+                statistics.failed_offset = objects[i].offset;
+                break;
+            }
+        }
+    }
+    statistics.objects_parsed = ok ? count : 0;
+    uint64_t parsed = CCryptoBoringSSLShims_bundle_now();
+    statistics.parse_ns = parsed - start;
+
+    // Sorting the batch makes repeats within it adjacent. Nothing is pushed
+    // until every certificate has been checked against the store, so its
+    // object stack stays sorted for the lookups and is sorted once more, lazily,
+    // by the next one after the batch.
+    X509_OBJECT **added = NULL;
+    if (ok && count > 0) {
+        qsort(objects, count, sizeof(*objects), CCryptoBoringSSLShims_bundle_object_cmp);
+        added = CCryptoBoringSSL_OPENSSL_calloc(count, sizeof(*added));
+        ok = added != NULL;
+    }
+    size_t added_count = 0;
+    for (size_t i = 0; ok && i < count; i++) {
+        if (i > 0 && CCryptoBoringSSL_X509_cmp(objects[i - 1].x509, objects[i].x509) == 0) {
+            continue;
+        }
+        X509_OBJECT *object = CCryptoBoringSSL_X509_OBJECT_new();
+        if (object == NULL) {
+            ok = 0;
+            break;
+        }
+        object->type = X509_LU_X509;
+        object->data.x509 = objects[i].x509;
+        CCryptoBoringSSL_X509_up_ref(objects[i].x509);
+        added[added_count++] = object;
+    }
+
+    if (ok && added_count > 0) {
+        CCryptoBoringSSL_CRYPTO_MUTEX_lock_write(&store->objs_lock);
+        sk_X509_OBJECT_sort(store->objs);
+        size_t fresh = 0;
+        for (size_t i = 0; i < added_count; i++) {
+            if (!CCryptoBoringSSLShims_bundle_store_contains(store->objs, added[i])) {
+                added[fresh++] = added[i];
+            } else {
+                CCryptoBoringSSL_X509_OBJECT_free(added[i]);
+            }
+        }
+        added_count = fresh;
+        // If the stack can't grow, the batch is taken out again: it goes in
+        // whole or not at all.
+        size_t existing = sk_X509_OBJECT_num(store->objs);
+        for (size_t i = 0; ok && i < added_count; i++) {
+            ok = sk_X509_OBJECT_push(store->objs, added[i]) != 0;
+        }
+        if (!ok) {
+            while (sk_X509_OBJECT_num(store->objs) > existing) {
+                sk_X509_OBJECT_pop(store->objs);
+            }
+        }
+        CCryptoBoringSSL_CRYPTO_MUTEX_unlock_write(&store->objs_lock);
+    }
+    if (ok) {
+        statistics.certificates_added = added_count;
+        statistics.duplicates = count - added_count;
+    } else {
+        for (size_t i = 0; i < added_count; i++) {
+            CCryptoBoringSSL_X509_OBJECT_free(added[i]);
+        }
+    }
+    statistics.insert_ns = CCryptoBoringSSLShims_bundle_now() - parsed;
+
+    CCryptoBoringSSL_OPENSSL_free(added);
+    for (size_t i = 0; i < count; i++) {
+        CCryptoBoringSSL_X509_free(objects[i].x509);
+    }
+    CCryptoBoringSSL_OPENSSL_free(objects);
+    if (ok) {
+        statistics.failed_offset = 0;
+    }
+    if (out_statistics != NULL) {
+        *out_statistics = statistics;
+    }
+    return ok;
+}
+
+static size_t CCryptoBoringSSLShims_snapshot_unparsed_count(X509_STORE *store);
+static void CCryptoBoringSSLShims_directory_load_all(X509_STORE *store);
+
+size_t CCryptoBoringSSLShims_X509_STORE_certificate_count(X509_STORE *store) {
+    size_t count = CCryptoBoringSSLShims_snapshot_unparsed_count(store);
+    CCryptoBoringSSL_CRYPTO_MUTEX_lock_read(&store->objs_lock);
+    for (size_t i = 0; i < sk_X509_OBJECT_num(store->objs); i++) {
+        if (sk_X509_OBJECT_value(store->objs, i)->type == X509_LU_X509) {
+            count++;
+        }
+    }
+    CCryptoBoringSSL_CRYPTO_MUTEX_unlock_read(&store->objs_lock);
+    return count;
+}
+
+// MARK:- Trust store snapshots
+
+// A snapshot is a 32-byte header, a table of 32-byte entries sorted by subject
+// name hash, the indices of the entries with a subject key identifier sorted by
+// that identifier, the certificate records, and a SHA-256 digest of everything
+// before it. All integers are little-endian.
+//
+//   header: "SCX5STOR", u32 version, u32 count, u32 key_id_count, u32 zero,
+//           u64 total length
+//   entry:  u32 X509_NAME_hash of the subject, u32 canonical subject length,
+//           u32 DER length, u32 key identifier length, u64 record offset,
+//           u64 zero
+//   record: canonical subject encoding, DER (with any trust settings, as
+//           written by i2d_X509_AUX), subject key identifier; 16-byte aligned
+//
+// The canonical subject is the encoding X509_NAME_cmp compares, so a lookup
+// matches exactly the certificates the store's own lookups would.
+
+#define CCRYPTOBORINGSSLSHIMS_SNAPSHOT_HEADER 32
+#define CCRYPTOBORINGSSLSHIMS_SNAPSHOT_ENTRY 32
+#define CCRYPTOBORINGSSLSHIMS_SNAPSHOT_VERSION 1
+
+static const uint8_t kCCryptoBoringSSLShimsSnapshotMagic[8] = {'S', 'C', 'X', '5', 'S', 'T', 'O', 'R'};
+
+typedef struct {
+    const uint8_t *bytes;
+    size_t len;
+    size_t count;
+    size_t key_id_count;
+    const uint8_t *entries;
+    const uint8_t *key_id_index;
+    // Protects `parsed` and `parsed_count`, and is held while parsed
+    // certificates go into the store so that a lookup never sees an entry
+    // marked parsed before its certificate can be found.
+    CRYPTO_MUTEX lock;
+    uint8_t *parsed;
+    size_t parsed_count;
+} CCryptoBoringSSLShims_snapshot;
+
+typedef struct {
+    uint32_t name_hash;
+    const uint8_t *canon;
+    size_t canon_len;
+    const uint8_t *der;
+    size_t der_len;
+    const uint8_t *key_id;
+    size_t key_id_len;
+} CCryptoBoringSSLShims_snapshot_record;
+
+static CCryptoBoringSSLShims_snapshot_record CCryptoBoringSSLShims_snapshot_entry(
+    const CCryptoBoringSSLShims_snapshot *snapshot, size_t index) {
+    const uint8_t *entry = snapshot->entries + index * CCRYPTOBORINGSSLSHIMS_SNAPSHOT_ENTRY;
+    CCryptoBoringSSLShims_snapshot_record record;
+    record.name_hash = CRYPTO_load_u32_le(entry);
+    record.canon_len = CRYPTO_load_u32_le(entry + 4);
+    record.der_len = CRYPTO_load_u32_le(entry + 8);
+    record.key_id_len = CRYPTO_load_u32_le(entry + 12);
+    record.canon = snapshot->bytes + CRYPTO_load_u64_le(entry + 16);
+    record.der = record.canon + record.canon_len;
+    record.key_id = record.der + record.der_len;
+    return record;
+}
+
+static int CCryptoBoringSSLShims_snapshot_record_cmp(const void *a, const void *b) {
+    const CCryptoBoringSSLShims_snapshot_record *lhs = a, *rhs = b;
+    if (lhs->name_hash != rhs->name_hash) {
+        return lhs->name_hash < rhs->name_hash ? -1 : 1;
+    }
+    if (lhs->canon_len != rhs->canon_len) {
+        return lhs->canon_len < rhs->canon_len ? -1 : 1;
+    }
+    int ret = lhs->canon_len == 0 ? 0 : memcmp(lhs->canon, rhs->canon, lhs->canon_len);
+    if (ret != 0) {
+        return ret;
+    }
+    if (lhs->der_len != rhs->der_len) {
+        return lhs->der_len < rhs->der_len ? -1 : 1;
+    }
+    return memcmp(lhs->der, rhs->der, lhs->der_len);
+}
+
+static int CCryptoBoringSSLShims_snapshot_key_id_cmp(const uint8_t *a, size_t a_len, const uint8_t *b,
+                                                     size_t b_len) {
+    size_t len = a_len < b_len ? a_len : b_len;
+    int ret = len == 0 ? 0 : memcmp(a, b, len);
+    if (ret != 0) {
+        return ret;
+    }
+    return a_len == b_len ? 0 : (a_len < b_len ? -1 : 1);
+}
+
+static int CCryptoBoringSSLShims_snapshot_key_id_record_cmp(const void *a, const void *b) {
+    const CCryptoBoringSSLShims_snapshot_record *lhs = a, *rhs = b;
+    return CCryptoBoringSSLShims_snapshot_key_id_cmp(lhs->key_id, lhs->key_id_len, rhs->key_id, rhs->key_id_len);
+}
+
+static int CCryptoBoringSSLShims_snapshot_get_by_subject(X509_LOOKUP *lookup, int type, X509_NAME *name,
+                                                         X509_OBJECT *ret);
+static int CCryptoBoringSSLShims_X509_STORE_retrieve_cached(X509_STORE *store, X509_NAME *name, X509_OBJECT *ret);
+
+static void CCryptoBoringSSLShims_snapshot_free(X509_LOOKUP *lookup) {
+    CCryptoBoringSSLShims_snapshot *snapshot = lookup->method_data;
+    if (snapshot == NULL) {
+        return;
+    }
+    CRYPTO_MUTEX_cleanup(&snapshot->lock);
+    CCryptoBoringSSL_OPENSSL_free(snapshot->parsed);
+    CCryptoBoringSSL_OPENSSL_free(snapshot);
+}
+
+static const X509_LOOKUP_METHOD kCCryptoBoringSSLShimsSnapshotMethod = {
+    NULL,                                           // new_item
+    CCryptoBoringSSLShims_snapshot_free,            // free
+    NULL,                                           // ctrl
+    CCryptoBoringSSLShims_snapshot_get_by_subject,  // get_by_subject
+};
+
+static CCryptoBoringSSLShims_snapshot *CCryptoBoringSSLShims_X509_STORE_get_snapshot(X509_STORE *store) {
+    for (size_t i = 0; i < sk_X509_LOOKUP_num(store->get_cert_methods); i++) {
+        X509_LOOKUP *lookup = sk_X509_LOOKUP_value(store->get_cert_methods, i);
+        if (lookup->method == &kCCryptoBoringSSLShimsSnapshotMethod) {
+            return lookup->method_data;
+        }
+    }
+    return NULL;
+}
+
+static size_t CCryptoBoringSSLShims_snapshot_unparsed_count(X509_STORE *store) {
+    CCryptoBoringSSLShims_snapshot *snapshot = CCryptoBoringSSLShims_X509_STORE_get_snapshot(store);
+    if (snapshot == NULL) {
+        return 0;
+    }
+    CRYPTO_MUTEX_lock_read(&snapshot->lock);
+    size_t unparsed = snapshot->count - snapshot->parsed_count;
+    CRYPTO_MUTEX_unlock_read(&snapshot->lock);
+    return unparsed;
+}
+
+// Parses every snapshot certificate with the subject `name` that hasn't been
+// parsed yet and adds it to the store, then hands back the first of them from
+// the store's cache, as the by_dir lookup does.
+static int CCryptoBoringSSLShims_snapshot_get_by_subject(X509_LOOKUP *lookup, int type, X509_NAME *name,
+                                                         X509_OBJECT *ret) {
+    CCryptoBoringSSLShims_snapshot *snapshot = lookup->method_data;
+    if (type != X509_LU_X509 || snapshot == NULL || snapshot->count == 0) {
+        return 0;
+    }
+    // X509_NAME_hash leaves the canonical encoding cached in `name`.
+    uint32_t hash = CCryptoBoringSSL_X509_NAME_hash(name);
+    if (name->modified || name->canon_enclen < 0) {
+        return 0;
+    }
+    size_t canon_len = (size_t)name->canon_enclen;
+
+    size_t lo = 0, hi = snapshot->count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (CRYPTO_load_u32_le(snapshot->entries + mid * CCRYPTOBORINGSSLSHIMS_SNAPSHOT_ENTRY) < hash) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    int added = 0;
+    CRYPTO_MUTEX_lock_write(&snapshot->lock);
+    for (size_t i = lo; i < snapshot->count; i++) {
+        CCryptoBoringSSLShims_snapshot_record record = CCryptoBoringSSLShims_snapshot_entry(snapshot, i);
+        if (record.name_hash != hash) {
+            break;
+        }
+        if (record.canon_len != canon_len || (canon_len > 0 && memcmp(record.canon, name->canon_enc, canon_len) != 0)) {
+            continue;
+        }
+        if (snapshot->parsed[i]) {
+            added = 1;
+            continue;
+        }
+        const uint8_t *der = record.der;
+        X509 *x509 = CCryptoBoringSSL_d2i_X509_AUX(NULL, &der, (long)record.der_len);
+        // A certificate that no longer parses is left out, as a malformed file
+        // is by the by_dir lookup.
+        if (x509 != NULL && der == record.der + record.der_len) {
+            CCryptoBoringSSL_x509v3_cache_extensions(x509);
+            added |= CCryptoBoringSSL_X509_STORE_add_cert(lookup->store_ctx, x509);
+        }
+        CCryptoBoringSSL_X509_free(x509);
+        snapshot->parsed[i] = 1;
+        snapshot->parsed_count++;
+    }
+    CRYPTO_MUTEX_unlock_write(&snapshot->lock);
+    CCryptoBoringSSL_ERR_clear_error();
+    if (!added) {
+        return 0;
+    }
+    return CCryptoBoringSSLShims_X509_STORE_retrieve_cached(lookup->store_ctx, name, ret);
+}
+
+// Hands back the first certificate with the subject `name` from the store's
+// cache, for a lookup that has just added its certificates there.
+static int CCryptoBoringSSLShims_X509_STORE_retrieve_cached(X509_STORE *store, X509_NAME *name, X509_OBJECT *ret) {
+    // As in X509_OBJECT_retrieve_by_subject, a stand-in certificate with only
+    // a subject finds the first match in the sorted cache.
+    X509_CINF cinf_s = {0};
+    X509 x509_s = {0};
+    X509_OBJECT stmp = {0}, *found = NULL;
+    cinf_s.subject = name;
+    x509_s.cert_info = &cinf_s;
+    stmp.type = X509_LU_X509;
+    stmp.data.x509 = &x509_s;
+    size_t idx;
+    CRYPTO_MUTEX_lock_write(&store->objs_lock);
+    sk_X509_OBJECT_sort(store->objs);
+    if (sk_X509_OBJECT_find(store->objs, &idx, &stmp)) {
+        found = sk_X509_OBJECT_value(store->objs, idx);
+    }
+    CRYPTO_MUTEX_unlock_write(&store->objs_lock);
+    if (found == NULL) {
+        return 0;
+    }
+    // Like every X509_LOOKUP, this leaves taking a reference to the caller.
+    ret->type = found->type;
+    ret->data = found->data;
+    return 1;
+}
+
+int CCryptoBoringSSLShims_X509_STORE_add_snapshot(X509_STORE *store, const void *snapshot_bytes, size_t len,
+                                                  int verify_integrity) {
+    const uint8_t *bytes = snapshot_bytes;
+    if (len < CCRYPTOBORINGSSLSHIMS_SNAPSHOT_HEADER + SHA256_DIGEST_LENGTH ||
+        memcmp(bytes, kCCryptoBoringSSLShimsSnapshotMagic, sizeof(kCCryptoBoringSSLShimsSnapshotMagic)) != 0 ||
+        CRYPTO_load_u32_le(bytes + 8) != CCRYPTOBORINGSSLSHIMS_SNAPSHOT_VERSION ||
+        CRYPTO_load_u64_le(bytes + 24) != (uint64_t)len) {
+        return 0;
+    }
+    size_t body_len = len - SHA256_DIGEST_LENGTH;
+    size_t count = CRYPTO_load_u32_le(bytes + 12);
+    size_t key_id_count = CRYPTO_load_u32_le(bytes + 16);
+    // Both tables fit in the body, so neither product can overflow.
+    if (count > (body_len - CCRYPTOBORINGSSLSHIMS_SNAPSHOT_HEADER) / CCRYPTOBORINGSSLSHIMS_SNAPSHOT_ENTRY ||
+        key_id_count > count ||
+        key_id_count * 4 >
+            body_len - CCRYPTOBORINGSSLSHIMS_SNAPSHOT_HEADER - count * CCRYPTOBORINGSSLSHIMS_SNAPSHOT_ENTRY) {
+        return 0;
+    }
+    if (verify_integrity) {
+        uint8_t digest[SHA256_DIGEST_LENGTH];
+        CCryptoBoringSSL_SHA256(bytes, body_len, digest);
+        if (CCryptoBoringSSL_CRYPTO_memcmp(digest, bytes + body_len, sizeof(digest)) != 0) {
+            return 0;
+        }
+    }
+
+    CCryptoBoringSSLShims_snapshot candidate = {0};
+    candidate.bytes = bytes;
+    candidate.len = len;
+    candidate.count = count;
+    candidate.key_id_count = key_id_count;
+    candidate.entries = bytes + CCRYPTOBORINGSSLSHIMS_SNAPSHOT_HEADER;
+    candidate.key_id_index = candidate.entries + count * CCRYPTOBORINGSSLSHIMS_SNAPSHOT_ENTRY;
+
+    // Every record must lie in the body, and both tables must be sorted for
+    // the binary searches.
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t *entry = candidate.entries + i * CCRYPTOBORINGSSLSHIMS_SNAPSHOT_ENTRY;
+        uint64_t offset = CRYPTO_load_u64_le(entry + 16);
+        uint64_t record_len = (uint64_t)CRYPTO_load_u32_le(entry + 4) + CRYPTO_load_u32_le(entry + 8) +
+                              CRYPTO_load_u32_le(entry + 12);
+        if (offset > body_len || record_len > body_len - offset || CRYPTO_load_u64_le(entry + 24) != 0 ||
+            (i > 0 && CRYPTO_load_u32_le(entry - CCRYPTOBORINGSSLSHIMS_SNAPSHOT_ENTRY) > CRYPTO_load_u32_le(entry))) {
+            return 0;
+        }
+    }
+    for (size_t i = 0; i < key_id_count; i++) {
+        size_t index = CRYPTO_load_u32_le(candidate.key_id_index + 4 * i);
+        if (index >= count) {
+            return 0;
+        }
+        CCryptoBoringSSLShims_snapshot_record record = CCryptoBoringSSLShims_snapshot_entry(&candidate, index);
+        if (record.key_id_len == 0) {
+            return 0;
+        }
+        if (i > 0) {
+            CCryptoBoringSSLShims_snapshot_record previous = CCryptoBoringSSLShims_snapshot_entry(
+                &candidate, CRYPTO_load_u32_le(candidate.key_id_index + 4 * (i - 1)));
+            if (CCryptoBoringSSLShims_snapshot_key_id_record_cmp(&previous, &record) > 0) {
+                return 0;
+            }
+        }
+    }
+
+    if (CCryptoBoringSSLShims_X509_STORE_get_snapshot(store) != NULL) {
+        return 0;
+    }
+    CCryptoBoringSSLShims_snapshot *snapshot = CCryptoBoringSSL_OPENSSL_malloc(sizeof(*snapshot));
+    if (snapshot == NULL) {
+        return 0;
+    }
+    *snapshot = candidate;
+    snapshot->parsed = CCryptoBoringSSL_OPENSSL_zalloc(count > 0 ? count : 1);
+    if (snapshot->parsed == NULL) {
+        CCryptoBoringSSL_OPENSSL_free(snapshot);
+        return 0;
+    }
+    CRYPTO_MUTEX_init(&snapshot->lock);
+    X509_LOOKUP *lookup = CCryptoBoringSSL_X509_STORE_add_lookup(store, &kCCryptoBoringSSLShimsSnapshotMethod);
+    if (lookup == NULL) {
+        CRYPTO_MUTEX_cleanup(&snapshot->lock);
+        CCryptoBoringSSL_OPENSSL_free(snapshot->parsed);
+        CCryptoBoringSSL_OPENSSL_free(snapshot);
+        return 0;
+    }
+    lookup->method_data = snapshot;
+    return 1;
+}
+
+size_t CCryptoBoringSSLShims_X509_STORE_snapshot_parsed_count(X509_STORE *store) {
+    CCryptoBoringSSLShims_snapshot *snapshot = CCryptoBoringSSLShims_X509_STORE_get_snapshot(store);
+    if (snapshot == NULL) {
+        return 0;
+    }
+    CRYPTO_MUTEX_lock_read(&snapshot->lock);
+    size_t parsed = snapshot->parsed_count;
+    CRYPTO_MUTEX_unlock_read(&snapshot->lock);
+    return parsed;
+}
+
+int CCryptoBoringSSLShims_X509_STORE_write_snapshot(X509_STORE *store, uint8_t **out, size_t *out_len) {
+    *out = NULL;
+    *out_len = 0;
+    CCryptoBoringSSLShims_directory_load_all(store);
+    CCryptoBoringSSLShims_snapshot *snapshot = CCryptoBoringSSLShims_X509_STORE_get_snapshot(store);
+
+    // The store's own certificates are encoded into `owned`, held until the
+    // snapshot is written. Any snapshot entries are copied as they are. The
+    // snapshot's lock is taken first, as a lookup takes it before the store's.
+    if (snapshot != NULL) {
+        CRYPTO_MUTEX_lock_read(&snapshot->lock);
+    }
+    CRYPTO_MUTEX_lock_read(&store->objs_lock);
+    size_t objects = sk_X509_OBJECT_num(store->objs);
+    size_t capacity = objects + (snapshot != NULL ? snapshot->count : 0);
+    CCryptoBoringSSLShims_snapshot_record *records =
+        CCryptoBoringSSL_OPENSSL_calloc(capacity > 0 ? capacity : 1, sizeof(*records));
+    uint8_t **owned = CCryptoBoringSSL_OPENSSL_calloc(objects > 0 ? objects : 1, sizeof(*owned));
+    size_t count = 0, owned_count = 0;
+    int ok = records != NULL && owned != NULL;
+    for (size_t i = 0; ok && i < objects; i++) {
+        X509_OBJECT *object = sk_X509_OBJECT_value(store->objs, i);
+        if (object->type != X509_LU_X509) {
+            continue;
+        }
+        X509 *x509 = object->data.x509;
+        X509_NAME *subject = CCryptoBoringSSL_X509_get_subject_name(x509);
+        CCryptoBoringSSLShims_snapshot_record record = {0};
+        record.name_hash = CCryptoBoringSSL_X509_NAME_hash(subject);
+        uint8_t *der = NULL;
+        int der_len = CCryptoBoringSSL_i2d_X509_AUX(x509, &der);
+        if (der_len <= 0 || subject->canon_enclen < 0) {
+            CCryptoBoringSSL_OPENSSL_free(der);
+            ok = 0;
+            break;
+        }
+        owned[owned_count++] = der;
+        record.canon = subject->canon_enc;
+        record.canon_len = (size_t)subject->canon_enclen;
+        record.der = der;
+        record.der_len = (size_t)der_len;
+        const ASN1_OCTET_STRING *key_id = CCryptoBoringSSL_X509_get0_subject_key_id(x509);
+        if (key_id != NULL) {
+            record.key_id = CCryptoBoringSSL_ASN1_STRING_get0_data(key_id);
+            record.key_id_len = (size_t)CCryptoBoringSSL_ASN1_STRING_length(key_id);
+        }
+        records[count++] = record;
+    }
+    for (size_t i = 0; ok && snapshot != NULL && i < snapshot->count; i++) {
+        // Parsed entries are already among the store's certificates.
+        if (!snapshot->parsed[i]) {
+            records[count++] = CCryptoBoringSSLShims_snapshot_entry(snapshot, i);
+        }
+    }
+
+    size_t unique = 0;
+    if (ok) {
+        qsort(records, count, sizeof(*records), CCryptoBoringSSLShims_snapshot_record_cmp);
+        for (size_t i = 0; i < count; i++) {
+            if (unique == 0 || CCryptoBoringSSLShims_snapshot_record_cmp(&records[unique - 1], &records[i]) != 0) {
+                records[unique++] = records[i];
+            }
+        }
+        ok = unique <= UINT32_MAX;
+    }
+
+    // The key identifier index is built from a copy sorted by identifier, with
+    // each copy's position in `records` kept in `name_hash`.
+    CCryptoBoringSSLShims_snapshot_record *by_key_id = NULL;
+    size_t key_id_count = 0;
+    if (ok) {
+        by_key_id = CCryptoBoringSSL_OPENSSL_calloc(unique > 0 ? unique : 1, sizeof(*by_key_id));
+        ok = by_key_id != NULL;
+    }
+    for (size_t i = 0; ok && i < unique; i++) {
+        if (records[i].key_id_len > 0) {
+            by_key_id[key_id_count] = records[i];
+            by_key_id[key_id_count++].name_hash = (uint32_t)i;
+        }
+    }
+    if (ok) {
+        qsort(by_key_id, key_id_count, sizeof(*by_key_id), CCryptoBoringSSLShims_snapshot_key_id_record_cmp);
+    }
+
+    CBB cbb;
+    CBB_zero(&cbb);
+    if (ok) {
+        size_t tables = CCRYPTOBORINGSSLSHIMS_SNAPSHOT_HEADER + unique * CCRYPTOBORINGSSLSHIMS_SNAPSHOT_ENTRY +
+                        key_id_count * 4;
+        size_t offset = (tables + 15) & ~(size_t)15;
+        size_t total = offset;
+        for (size_t i = 0; i < unique; i++) {
+            total += (records[i].canon_len + records[i].der_len + records[i].key_id_len + 15) & ~(size_t)15;
+        }
+        total += SHA256_DIGEST_LENGTH;
+
+        ok = CBB_init(&cbb, total) &&
+             CBB_add_bytes(&cbb, kCCryptoBoringSSLShimsSnapshotMagic, sizeof(kCCryptoBoringSSLShimsSnapshotMagic)) &&
+             CBB_add_u32le(&cbb, CCRYPTOBORINGSSLSHIMS_SNAPSHOT_VERSION) && CBB_add_u32le(&cbb, (uint32_t)unique) &&
+             CBB_add_u32le(&cbb, (uint32_t)key_id_count) && CBB_add_u32le(&cbb, 0) &&
+             CBB_add_u64le(&cbb, (uint64_t)total);
+        for (size_t i = 0; ok && i < unique; i++) {
+            ok = CBB_add_u32le(&cbb, records[i].name_hash) && CBB_add_u32le(&cbb, (uint32_t)records[i].canon_len) &&
+                 CBB_add_u32le(&cbb, (uint32_t)records[i].der_len) &&
+                 CBB_add_u32le(&cbb, (uint32_t)records[i].key_id_len) && CBB_add_u64le(&cbb, (uint64_t)offset) &&
+                 CBB_add_u64le(&cbb, 0);
+            offset += (records[i].canon_len + records[i].der_len + records[i].key_id_len + 15) & ~(size_t)15;
+        }
+        for (size_t i = 0; ok && i < key_id_count; i++) {
+            ok = CBB_add_u32le(&cbb, by_key_id[i].name_hash);
+        }
+        ok = ok && CBB_add_zeros(&cbb, ((tables + 15) & ~(size_t)15) - tables);
+        for (size_t i = 0; ok && i < unique; i++) {
+            size_t record_len = records[i].canon_len + records[i].der_len + records[i].key_id_len;
+            ok = (records[i].canon_len == 0 || CBB_add_bytes(&cbb, records[i].canon, records[i].canon_len)) &&
+                 CBB_add_bytes(&cbb, records[i].der, records[i].der_len) &&
+                 (records[i].key_id_len == 0 || CBB_add_bytes(&cbb, records[i].key_id, records[i].key_id_len)) &&
+                 CBB_add_zeros(&cbb, ((record_len + 15) & ~(size_t)15) - record_len);
+        }
+        uint8_t *digest = NULL;
+        ok = ok && CBB_len(&cbb) == total - SHA256_DIGEST_LENGTH &&
+             CBB_add_space(&cbb, &digest, SHA256_DIGEST_LENGTH);
+        if (ok) {
+            CCryptoBoringSSL_SHA256(CBB_data(&cbb), total - SHA256_DIGEST_LENGTH, digest);
+            ok = CBB_finish(&cbb, out, out_len);
+        }
+    }
+    CRYPTO_MUTEX_unlock_read(&store->objs_lock);
+    if (snapshot != NULL) {
+        CRYPTO_MUTEX_unlock_read(&snapshot->lock);
+    }
+
+    CBB_cleanup(&cbb);
+    CCryptoBoringSSL_OPENSSL_free(by_key_id);
+    CCryptoBoringSSL_OPENSSL_free(records);
+    for (size_t i = 0; i < owned_count; i++) {
+        CCryptoBoringSSL_OPENSSL_free(owned[i]);
+    }
+    CCryptoBoringSSL_OPENSSL_free(owned);
+    return ok;
+}
+
+static int CCryptoBoringSSLShims_X509_copy_der(X509 *x509, uint8_t **out_der, size_t *out_der_len) {
+    uint8_t *der = NULL;
+    int der_len = CCryptoBoringSSL_i2d_X509(x509, &der);
+    if (der_len <= 0) {
+        return -1;
+    }
+    *out_der = der;
+    *out_der_len = (size_t)der_len;
+    return 1;
+}
+
+int CCryptoBoringSSLShims_X509_STORE_find_issuer(X509_STORE *store, const uint8_t *der, size_t der_len,
+                                                 uint8_t **out_der, size_t *out_der_len) {
+    *out_der = NULL;
+    *out_der_len = 0;
+    const uint8_t *inp = der;
+    X509 *x509 = der_len <= LONG_MAX ? CCryptoBoringSSL_d2i_X509(NULL, &inp, (long)der_len) : NULL;
+    if (x509 == NULL || inp != der + der_len) {
+        CCryptoBoringSSL_X509_free(x509);
+        CCryptoBoringSSL_ERR_clear_error();
+        return -1;
+    }
+    int ret = -1;
+    X509_STORE_CTX *ctx = CCryptoBoringSSL_X509_STORE_CTX_new();
+    if (ctx != NULL && CCryptoBoringSSL_X509_STORE_CTX_init(ctx, store, x509, NULL)) {
+        X509 *issuer = NULL;
+        ret = CCryptoBoringSSL_X509_STORE_CTX_get1_issuer(&issuer, ctx, x509) > 0;
+        if (ret) {
+            ret = CCryptoBoringSSLShims_X509_copy_der(issuer, out_der, out_der_len);
+        }
+        CCryptoBoringSSL_X509_free(issuer);
+    }
+    CCryptoBoringSSL_X509_STORE_CTX_free(ctx);
+    CCryptoBoringSSL_X509_free(x509);
+    CCryptoBoringSSL_ERR_clear_error();
+    return ret;
+}
+
+int CCryptoBoringSSLShims_X509_STORE_find_by_key_id(X509_STORE *store, const uint8_t *key_id, size_t key_id_len,
+                                                    uint8_t **out_der, size_t *out_der_len) {
+    *out_der = NULL;
+    *out_der_len = 0;
+    CCryptoBoringSSLShims_snapshot *snapshot = CCryptoBoringSSLShims_X509_STORE_get_snapshot(store);
+    if (snapshot != NULL) {
+        size_t lo = 0, hi = snapshot->key_id_count;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            CCryptoBoringSSLShims_snapshot_record record = CCryptoBoringSSLShims_snapshot_entry(
+                snapshot, CRYPTO_load_u32_le(snapshot->key_id_index + 4 * mid));
+            if (CCryptoBoringSSLShims_snapshot_key_id_cmp(record.key_id, record.key_id_len, key_id, key_id_len) < 0) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        if (lo < snapshot->key_id_count) {
+            CCryptoBoringSSLShims_snapshot_record record = CCryptoBoringSSLShims_snapshot_entry(
+                snapshot, CRYPTO_load_u32_le(snapshot->key_id_index + 4 * lo));
+            if (CCryptoBoringSSLShims_snapshot_key_id_cmp(record.key_id, record.key_id_len, key_id, key_id_len) == 0) {
+                // The snapshot's DER is handed back without parsing it, less
+                // any trust settings after the certificate itself.
+                CBS cbs, certificate;
+                CBS_init(&cbs, record.der, record.der_len);
+                if (!CBS_get_asn1_element(&cbs, &certificate, CBS_ASN1_SEQUENCE) ||
+                    !CBS_stow(&certificate, out_der, out_der_len)) {
+                    return -1;
+                }
+                return 1;
+            }
+        }
+    }
+
+    int ret = 0;
+    CRYPTO_MUTEX_lock_read(&store->objs_lock);
+    for (size_t i = 0; i < sk_X509_OBJECT_num(store->objs); i++) {
+        X509_OBJECT *object = sk_X509_OBJECT_value(store->objs, i);
+        if (object->type != X509_LU_X509) {
+            continue;
+        }
+        const ASN1_OCTET_STRING *candidate = CCryptoBoringSSL_X509_get0_subject_key_id(object->data.x509);
+        if (candidate != NULL &&
+            CCryptoBoringSSLShims_snapshot_key_id_cmp(CCryptoBoringSSL_ASN1_STRING_get0_data(candidate),
+                                                      (size_t)CCryptoBoringSSL_ASN1_STRING_length(candidate), key_id,
+                                                      key_id_len) == 0) {
+            ret = CCryptoBoringSSLShims_X509_copy_der(object->data.x509, out_der, out_der_len);
+            break;
+        }
+    }
+    CRYPTO_MUTEX_unlock_read(&store->objs_lock);
+    return ret;
+}
+
+// MARK:- Indexed certificate directories
+
+// The by_dir lookup finds a subject's certificates by opening <hash>.0,
+// <hash>.1, ... until one is missing, so every lookup the store's cache can't
+// answer costs an open, including each one for an issuer the directory
+// doesn't hold. This lookup reads the directory's names once into a table
+// sorted by hash, opens a file only the first time its hash is asked for, and
+// rereads the names only when the directory's modification time changes.
+
+#if !defined(_WIN32)
+#include <dirent.h>
+#include <inttypes.h>
+#include <sys/stat.h>
+
+typedef struct {
+    uint32_t name_hash;
+    uint32_t suffix;
+    // A file that is replaced, as `openssl rehash` replaces its links, gets a
+    // new inode and is loaded again.
+    uint64_t inode;
+    int loaded;
+} CCryptoBoringSSLShims_directory_entry;
+
+typedef struct {
+    char *path;
+    uint64_t refresh_ns;
+    // Protects everything below, and is held while loaded certificates go into
+    // the store, as the snapshot's lock is.
+    CRYPTO_MUTEX lock;
+    CCryptoBoringSSLShims_directory_entry *entries;
+    size_t count;
+    int64_t mtime_sec;
+    int64_t mtime_nsec;
+    uint64_t checked_at;
+    size_t files_loaded;
+    size_t scans;
+} CCryptoBoringSSLShims_directory;
+
+static int CCryptoBoringSSLShims_directory_entry_cmp(const void *a, const void *b) {
+    const CCryptoBoringSSLShims_directory_entry *lhs = a, *rhs = b;
+    if (lhs->name_hash != rhs->name_hash) {
+        return lhs->name_hash < rhs->name_hash ? -1 : 1;
+    }
+    if (lhs->suffix != rhs->suffix) {
+        return lhs->suffix < rhs->suffix ? -1 : 1;
+    }
+    return 0;
+}
+
+// Parses a name of the form by_dir looks for: eight hex digits, a dot, and a
+// decimal suffix. CRLs, whose suffixes start with "r", are not indexed.
+static int CCryptoBoringSSLShims_directory_parse_name(const char *name, uint32_t *out_hash, uint32_t *out_suffix) {
+    uint32_t hash = 0;
+    for (size_t i = 0; i < 8; i++) {
+        char c = name[i];
+        uint32_t digit;
+        if (c >= '0' && c <= '9') {
+            digit = (uint32_t)(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            digit = (uint32_t)(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            digit = (uint32_t)(c - 'A' + 10);
+        } else {
+            return 0;
+        }
+        hash = (hash << 4) | digit;
+    }
+    if (name[8] != '.' || name[9] == '\0') {
+        return 0;
+    }
+    uint64_t suffix = 0;
+    for (const char *p = name + 9; *p != '\0'; p++) {
+        if (*p < '0' || *p > '9' || suffix > UINT32_MAX / 10) {
+            return 0;
+        }
+        suffix = suffix * 10 + (uint64_t)(*p - '0');
+    }
+    if (suffix > UINT32_MAX) {
+        return 0;
+    }
+    *out_hash = hash;
+    *out_suffix = (uint32_t)suffix;
+    return 1;
+}
+
+static void CCryptoBoringSSLShims_directory_mtime(const struct stat *st, int64_t *out_sec, int64_t *out_nsec) {
+    *out_sec = (int64_t)st->st_mtime;
+#if defined(__APPLE__)
+    *out_nsec = (int64_t)st->st_mtimespec.tv_nsec;
+#elif defined(__linux__)
+    *out_nsec = (int64_t)st->st_mtim.tv_nsec;
+#else
+    *out_nsec = 0;
+#endif
+}
+
+// Reads the directory's names into a new table. Files that were already
+// loaded, and are still there under the same inode, stay marked loaded.
+// Returns 0, leaving the table as it was, if the directory can't be read.
+static int CCryptoBoringSSLShims_directory_scan(CCryptoBoringSSLShims_directory *directory) {
+    struct stat st;
+    if (stat(directory->path, &st) != 0 || !S_ISDIR(st.st_mode)) {
+        return 0;
+    }
+    DIR *dir = opendir(directory->path);
+    if (dir == NULL) {
+        return 0;
+    }
+    CCryptoBoringSSLShims_directory_entry *entries = NULL;
+    size_t count = 0, capacity = 0;
+    int ok = 1;
+    struct dirent *dirent;
+    while (ok && (dirent = readdir(dir)) != NULL) {
+        CCryptoBoringSSLShims_directory_entry entry = {0};
+        if (!CCryptoBoringSSLShims_directory_parse_name(dirent->d_name, &entry.name_hash, &entry.suffix)) {
+            continue;
+        }
+        entry.inode = (uint64_t)dirent->d_ino;
+        if (count == capacity) {
+            size_t new_capacity = capacity == 0 ? 256 : capacity * 2;
+            CCryptoBoringSSLShims_directory_entry *grown =
+                CCryptoBoringSSL_OPENSSL_realloc(entries, new_capacity * sizeof(*entries));
+            if (grown == NULL) {
+                ok = 0;
+                break;
+            }
+            entries = grown;
+            capacity = new_capacity;
+        }
+        entries[count++] = entry;
+    }
+    closedir(dir);
+    if (!ok) {
+        CCryptoBoringSSL_OPENSSL_free(entries);
+        return 0;
+    }
+    qsort(entries, count, sizeof(*entries), CCryptoBoringSSLShims_directory_entry_cmp);
+
+    // Both tables are sorted, so the loaded marks carry over in one pass.
+    size_t old = 0;
+    for (size_t i = 0; i < count; i++) {
+        while (old < directory->count &&
+               CCryptoBoringSSLShims_directory_entry_cmp(&directory->entries[old], &entries[i]) < 0) {
+            old++;
+        }
+        if (old < directory->count &&
+            CCryptoBoringSSLShims_directory_entry_cmp(&directory->entries[old], &entries[i]) == 0 &&
+            directory->entries[old].inode == entries[i].inode) {
+            entries[i].loaded = directory->entries[old].loaded;
+        }
+    }
+    CCryptoBoringSSL_OPENSSL_free(directory->entries);
+    directory->entries = entries;
+    directory->count = count;
+    CCryptoBoringSSLShims_directory_mtime(&st, &directory->mtime_sec, &directory->mtime_nsec);
+    directory->scans++;
+    return 1;
+}
+
+// Rereads the names if the refresh interval has passed and the directory's
+// modification time has changed since they were last read.
+static void CCryptoBoringSSLShims_directory_refresh(CCryptoBoringSSLShims_directory *directory) {
+    uint64_t now = CCryptoBoringSSLShims_bundle_now();
+    if (now - directory->checked_at < directory->refresh_ns) {
+        return;
+    }
+    directory->checked_at = now;
+    struct stat st;
+    if (stat(directory->path, &st) != 0) {
+        return;
+    }
+    int64_t sec, nsec;
+    CCryptoBoringSSLShims_directory_mtime(&st, &sec, &nsec);
+    if (sec != directory->mtime_sec || nsec != directory->mtime_nsec) {
+        CCryptoBoringSSLShims_directory_scan(directory);
+    }
+}
+
+// Loads the file for `entry` into the store, once. A file that doesn't parse
+// is left out, as it is by the by_dir lookup. Returns whether it added any
+// certificate.
+static int CCryptoBoringSSLShims_directory_load(X509_LOOKUP *lookup, CCryptoBoringSSLShims_directory *directory,
+                                                CCryptoBoringSSLShims_directory_entry *entry) {
+    if (entry->loaded) {
+        return 0;
+    }
+    entry->loaded = 1;
+    directory->files_loaded++;
+    size_t len = strlen(directory->path) + 1 + 8 + 1 + 10 + 1;
+    char *file = CCryptoBoringSSL_OPENSSL_malloc(len);
+    if (file == NULL) {
+        return 0;
+    }
+    snprintf(file, len, "%s/%08" PRIx32 ".%" PRIu32, directory->path, entry->name_hash, entry->suffix);
+    int added = CCryptoBoringSSL_X509_load_cert_file(lookup, file, X509_FILETYPE_PEM) > 0;
+    CCryptoBoringSSL_OPENSSL_free(file);
+    return added;
+}
+
+static void CCryptoBoringSSLShims_directory_release(CCryptoBoringSSLShims_directory *directory) {
+    CRYPTO_MUTEX_cleanup(&directory->lock);
+    CCryptoBoringSSL_OPENSSL_free(directory->entries);
+    CCryptoBoringSSL_OPENSSL_free(directory->path);
+    CCryptoBoringSSL_OPENSSL_free(directory);
+}
+
+static void CCryptoBoringSSLShims_directory_free(X509_LOOKUP *lookup) {
+    if (lookup->method_data != NULL) {
+        CCryptoBoringSSLShims_directory_release(lookup->method_data);
+    }
+}
+
+// Loads every file with the subject's hash, under either of the hashes by_dir
+// tries, that hasn't been loaded yet, then hands back the first match from the
+// store's cache.
+static int CCryptoBoringSSLShims_directory_get_by_subject(X509_LOOKUP *lookup, int type, X509_NAME *name,
+                                                          X509_OBJECT *ret) {
+    CCryptoBoringSSLShims_directory *directory = lookup->method_data;
+    if (type != X509_LU_X509 || directory == NULL) {
+        return 0;
+    }
+    uint32_t hashes[2] = {CCryptoBoringSSL_X509_NAME_hash(name), CCryptoBoringSSL_X509_NAME_hash_old(name)};
+
+    int added = 0;
+    CRYPTO_MUTEX_lock_write(&directory->lock);
+    CCryptoBoringSSLShims_directory_refresh(directory);
+    for (size_t h = 0; h < 2; h++) {
+        size_t lo = 0, hi = directory->count;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (directory->entries[mid].name_hash < hashes[h]) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        for (size_t i = lo; i < directory->count && directory->entries[i].name_hash == hashes[h]; i++) {
+            added |= CCryptoBoringSSLShims_directory_load(lookup, directory, &directory->entries[i]);
+        }
+    }
+    CRYPTO_MUTEX_unlock_write(&directory->lock);
+    CCryptoBoringSSL_ERR_clear_error();
+    if (!added) {
+        return 0;
+    }
+    return CCryptoBoringSSLShims_X509_STORE_retrieve_cached(lookup->store_ctx, name, ret);
+}
+
+static const X509_LOOKUP_METHOD kCCryptoBoringSSLShimsDirectoryMethod = {
+    NULL,                                            // new_item
+    CCryptoBoringSSLShims_directory_free,            // free
+    NULL,                                            // ctrl
+    CCryptoBoringSSLShims_directory_get_by_subject,  // get_by_subject
+};
+
+static CCryptoBoringSSLShims_directory *CCryptoBoringSSLShims_X509_STORE_get_directory(X509_STORE *store) {
+    for (size_t i = 0; i < sk_X509_LOOKUP_num(store->get_cert_methods); i++) {
+        X509_LOOKUP *lookup = sk_X509_LOOKUP_value(store->get_cert_methods, i);
+        if (lookup->method == &kCCryptoBoringSSLShimsDirectoryMethod) {
+            return lookup->method_data;
+        }
+    }
+    return NULL;
+}
+
+int CCryptoBoringSSLShims_X509_STORE_add_directory(X509_STORE *store, const char *path, uint64_t refresh_ns) {
+    if (CCryptoBoringSSLShims_X509_STORE_get_directory(store) != NULL) {
+        return 0;
+    }
+    CCryptoBoringSSLShims_directory *directory = CCryptoBoringSSL_OPENSSL_zalloc(sizeof(*directory));
+    if (directory == NULL) {
+        return 0;
+    }
+    CRYPTO_MUTEX_init(&directory->lock);
+    directory->path = CCryptoBoringSSL_OPENSSL_strdup(path);
+    directory->refresh_ns = refresh_ns;
+    directory->checked_at = CCryptoBoringSSLShims_bundle_now();
+    X509_LOOKUP *lookup = NULL;
+    if (directory->path != NULL && CCryptoBoringSSLShims_directory_scan(directory)) {
+        lookup = CCryptoBoringSSL_X509_STORE_add_lookup(store, &kCCryptoBoringSSLShimsDirectoryMethod);
+    }
+    if (lookup == NULL) {
+        CCryptoBoringSSLShims_directory_release(directory);
+        CCryptoBoringSSL_ERR_clear_error();
+        return 0;
+    }
+    lookup->method_data = directory;
+    return 1;
+}
+
+// Loads every file in the store's directory that hasn't been loaded yet, for
+// the operations that copy out all of a store's certificates.
+static void CCryptoBoringSSLShims_directory_load_all(X509_STORE *store) {
+    for (size_t i = 0; i < sk_X509_LOOKUP_num(store->get_cert_methods); i++) {
+        X509_LOOKUP *lookup = sk_X509_LOOKUP_value(store->get_cert_methods, i);
+        CCryptoBoringSSLShims_directory *directory = lookup->method_data;
+        if (lookup->method != &kCCryptoBoringSSLShimsDirectoryMethod || directory == NULL) {
+            continue;
+        }
+        CRYPTO_MUTEX_lock_write(&directory->lock);
+        CCryptoBoringSSLShims_directory_refresh(directory);
+        for (size_t j = 0; j < directory->count; j++) {
+            CCryptoBoringSSLShims_directory_load(lookup, directory, &directory->entries[j]);
+        }
+        CRYPTO_MUTEX_unlock_write(&directory->lock);
+        CCryptoBoringSSL_ERR_clear_error();
+    }
+}
+
+void CCryptoBoringSSLShims_X509_STORE_directory_statistics(
+    X509_STORE *store, CCryptoBoringSSLShims_X509_directory_statistics *out_statistics) {
+    CCryptoBoringSSLShims_X509_directory_statistics statistics = {0};
+    CCryptoBoringSSLShims_directory *directory = CCryptoBoringSSLShims_X509_STORE_get_directory(store);
+    if (directory != NULL) {
+        CRYPTO_MUTEX_lock_read(&directory->lock);
+        statistics.files_indexed = directory->count;
+        statistics.files_loaded = directory->files_loaded;
+        statistics.scans = directory->scans;
+        CRYPTO_MUTEX_unlock_read(&directory->lock);
+    }
+    *out_statistics = statistics;
+}
+#else
+int CCryptoBoringSSLShims_X509_STORE_add_directory(X509_STORE *store, const char *path, uint64_t refresh_ns) {
+    (void)store;
+    (void)path;
+    (void)refresh_ns;
+    return 0;
+}
+
+static void CCryptoBoringSSLShims_directory_load_all(X509_STORE *store) {
+    (void)store;
+}
+
+void CCryptoBoringSSLShims_X509_STORE_directory_statistics(
+    X509_STORE *store, CCryptoBoringSSLShims_X509_directory_statistics *out_statistics) {
+    (void)store;
+    *out_statistics = (CCryptoBoringSSLShims_X509_directory_statistics){0};
+}
+#endif
+
+// MARK:- HPKE contexts
+
+#include <CCryptoBoringSSL_hpke.h>
+
+static const EVP_HPKE_AEAD *CCryptoBoringSSLShims_hpke_aead(uint16_t aead_id) {
+    switch (aead_id) {
+    case EVP_HPKE_AES_128_GCM:
+        return CCryptoBoringSSL_EVP_hpke_aes_128_gcm();
+    case EVP_HPKE_AES_256_GCM:
+        return CCryptoBoringSSL_EVP_hpke_aes_256_gcm();
+    case EVP_HPKE_CHACHA20_POLY1305:
+        return CCryptoBoringSSL_EVP_hpke_chacha20_poly1305();
+    default:
+        return NULL;
+    }
+}
+
+EVP_HPKE_CTX *CCryptoBoringSSLShims_EVP_HPKE_CTX_new(void) {
+    return CCryptoBoringSSL_EVP_HPKE_CTX_new();
+}
+
+void CCryptoBoringSSLShims_EVP_HPKE_CTX_free(EVP_HPKE_CTX *ctx) {
+    CCryptoBoringSSL_EVP_HPKE_CTX_free(ctx);
+}
+
+int CCryptoBoringSSLShims_EVP_HPKE_CTX_copy(EVP_HPKE_CTX *dst, const EVP_HPKE_CTX *src) {
+    // The AEAD contexts of the supported AEADs keep their whole state inline,
+    // with no pointers into themselves or to the heap, so a byte copy is a deep
+    // copy. Refuse anything else rather than alias it.
+    if (src->aead != CCryptoBoringSSL_EVP_hpke_aes_128_gcm() && src->aead != CCryptoBoringSSL_EVP_hpke_aes_256_gcm() &&
+        src->aead != CCryptoBoringSSL_EVP_hpke_chacha20_poly1305()) {
+        return 0;
+    }
+    CCryptoBoringSSL_EVP_HPKE_CTX_cleanup(dst);
+    memcpy(dst, src, sizeof(*dst));
+    return 1;
+}
+
+int CCryptoBoringSSLShims_EVP_HPKE_CTX_setup_x25519_sender(EVP_HPKE_CTX *ctx, uint16_t aead_id, uint8_t *out_enc,
+                                                           const uint8_t *peer_public_key,
+                                                           const uint8_t *auth_private_key,
+                                                           const uint8_t *auth_public_key, const void *info,
+                                                           size_t info_len) {
+    const EVP_HPKE_AEAD *aead = CCryptoBoringSSLShims_hpke_aead(aead_id);
+    if (aead == NULL) {
+        return 0;
+    }
+    size_t enc_len;
+    if (auth_private_key == NULL) {
+        return CCryptoBoringSSL_EVP_HPKE_CTX_setup_sender(
+            ctx, out_enc, &enc_len, X25519_PUBLIC_VALUE_LEN, CCryptoBoringSSL_EVP_hpke_x25519_hkdf_sha256(),
+            CCryptoBoringSSL_EVP_hpke_hkdf_sha256(), aead, peer_public_key, X25519_PUBLIC_VALUE_LEN, info, info_len);
+    }
+
+    // Fill in the key directly: EVP_HPKE_KEY_init would recompute the public
+    // key, which the caller already has.
+    EVP_HPKE_KEY key;
+    key.kem = CCryptoBoringSSL_EVP_hpke_x25519_hkdf_sha256();
+    memcpy(key.private_key, auth_private_key, X25519_PRIVATE_KEY_LEN);
+    memcpy(key.public_key, auth_public_key, X25519_PUBLIC_VALUE_LEN);
+    int ok = CCryptoBoringSSL_EVP_HPKE_CTX_setup_auth_sender(ctx, out_enc, &enc_len, X25519_PUBLIC_VALUE_LEN, &key,
+                                                             CCryptoBoringSSL_EVP_hpke_hkdf_sha256(), aead,
+                                                             peer_public_key, X25519_PUBLIC_VALUE_LEN, info, info_len);
+    CCryptoBoringSSL_OPENSSL_cleanse(&key, sizeof(key));
+    return ok;
+}
+
+int CCryptoBoringSSLShims_EVP_HPKE_CTX_setup_x25519_recipient(EVP_HPKE_CTX *ctx, uint16_t aead_id,
+                                                              const uint8_t *private_key, const uint8_t *public_key,
+                                                              const uint8_t *enc, size_t enc_len,
+                                                              const uint8_t *auth_public_key, const void *info,
+                                                              size_t info_len) {
+    const EVP_HPKE_AEAD *aead = CCryptoBoringSSLShims_hpke_aead(aead_id);
+    if (aead == NULL) {
+        return 0;
+    }
+    EVP_HPKE_KEY key;
+    key.kem = CCryptoBoringSSL_EVP_hpke_x25519_hkdf_sha256();
+    memcpy(key.private_key, private_key, X25519_PRIVATE_KEY_LEN);
+    memcpy(key.public_key, public_key, X25519_PUBLIC_VALUE_LEN);
+    int ok;
+    if (auth_public_key == NULL) {
+        ok = CCryptoBoringSSL_EVP_HPKE_CTX_setup_recipient(ctx, &key, CCryptoBoringSSL_EVP_hpke_hkdf_sha256(), aead,
+                                                           enc, enc_len, info, info_len);
+    } else {
+        ok = CCryptoBoringSSL_EVP_HPKE_CTX_setup_auth_recipient(ctx, &key, CCryptoBoringSSL_EVP_hpke_hkdf_sha256(),
+                                                                aead, enc, enc_len, info, info_len, auth_public_key,
+                                                                X25519_PUBLIC_VALUE_LEN);
+    }
+    CCryptoBoringSSL_OPENSSL_cleanse(&key, sizeof(key));
+    return ok;
+}
+
+int CCryptoBoringSSLShims_EVP_HPKE_CTX_seal(EVP_HPKE_CTX *ctx, void *out, size_t *out_len, size_t max_out_len,
+                                            const void *in, size_t in_len, const void *ad, size_t ad_len) {
+    return CCryptoBoringSSL_EVP_HPKE_CTX_seal(ctx, out, out_len, max_out_len, in, in_len, ad, ad_len);
+}
+
+int CCryptoBoringSSLShims_EVP_HPKE_CTX_open(EVP_HPKE_CTX *ctx, void *out, size_t *out_len, size_t max_out_len,
+                                            const void *in, size_t in_len, const void *ad, size_t ad_len) {
+    return CCryptoBoringSSL_EVP_HPKE_CTX_open(ctx, out, out_len, max_out_len, in, in_len, ad, ad_len);
+}
+
+size_t CCryptoBoringSSLShims_EVP_HPKE_CTX_exporter_secret(const EVP_HPKE_CTX *ctx, void *out, size_t max_out_len) {
+    size_t len = CCryptoBoringSSL_EVP_MD_size(CCryptoBoringSSL_EVP_HPKE_KDF_hkdf_md(ctx->kdf));
+    if (len > max_out_len) {
+        return 0;
+    }
+    OPENSSL_memcpy(out, ctx->exporter_secret, len);
+    return len;
+}
+
+uint64_t CCryptoBoringSSLShims_EVP_HPKE_CTX_sequence(const EVP_HPKE_CTX *ctx) {
+    return ctx->seq;
+}
+
+// MARK:- Fused key agreement and AEAD setup
+
+int CCryptoBoringSSLShims_EVP_AEAD_CTX_init_with_key_agreement(void *ctx, const EVP_AEAD *aead, int key_agreement,
+                                                               const void *private_key, const void *peer_public_key,
+                                                               const EVP_MD *md, const void *salt, size_t salt_len,
+                                                               const void *info, size_t info_len) {
+    uint8_t shared_secret[32];
+    uint8_t key[EVP_AEAD_MAX_KEY_LENGTH];
+    size_t key_len = CCryptoBoringSSL_EVP_AEAD_key_length(aead);
+    int ok = 0;
+
+    switch (key_agreement) {
+    case CCRYPTOBORINGSSLSHIMS_KEY_AGREEMENT_X25519:
+        // As in the Swift X25519 implementation, the all-zero secret is not rejected.
+        (void)CCryptoBoringSSL_X25519(shared_secret, private_key, peer_public_key);
+        break;
+    case CCRYPTOBORINGSSLSHIMS_KEY_AGREEMENT_P256:
+        if (!CCryptoBoringSSLShims_p256_ecdh(shared_secret, private_key, peer_public_key)) {
+            goto out;
+        }
+        break;
+    default:
+        goto out;
+    }
+
+    ok = key_len <= sizeof(key) &&
+         CCryptoBoringSSL_HKDF(key, key_len, md, shared_secret, sizeof(shared_secret), salt, salt_len, info,
+                               info_len) &&
+         CCryptoBoringSSL_EVP_AEAD_CTX_init(ctx, aead, key, key_len, EVP_AEAD_DEFAULT_TAG_LENGTH, NULL);
+
+out:
+    CCryptoBoringSSL_OPENSSL_cleanse(shared_secret, sizeof(shared_secret));
+    CCryptoBoringSSL_OPENSSL_cleanse(key, sizeof(key));
+    return ok;
+}
+
+// MARK:- secp256k1
+
+// BoringSSL has no built-in secp256k1, so the group is built once with
+// EC_GROUP_new_curve_GFp. Key generation and signing use its generic
+// constant-time Montgomery arithmetic. Verification handles only public values,
+// and on 64-bit targets takes a dedicated variable-time path: field arithmetic
+// specialised to p = 2^256 - 2^32 - 977, and the GLV endomorphism
+// λ·(x, y) = (β·x, y), which splits each 256-bit scalar into two of about 128
+// bits so that u1·G + u2·Q needs half the doublings.
+
+static const uint8_t CCryptoBoringSSLShims_secp256k1_p[32] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe, 0xff, 0xff, 0xfc, 0x2f,
+};
+
+static const uint8_t CCryptoBoringSSLShims_secp256k1_n[32] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe,
+    0xba, 0xae, 0xdc, 0xe6, 0xaf, 0x48, 0xa0, 0x3b, 0xbf, 0xd2, 0x5e, 0x8c, 0xd0, 0x36, 0x41, 0x41,
+};
+
+// ⌊n / 2⌋, the largest s of a low-S signature.
+static const uint8_t CCryptoBoringSSLShims_secp256k1_half_n[32] = {
+    0x7f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0x5d, 0x57, 0x6e, 0x73, 0x57, 0xa4, 0x50, 0x1d, 0xdf, 0xe9, 0x2f, 0x46, 0x68, 0x1b, 0x20, 0xa0,
+};
+
+static const uint8_t CCryptoBoringSSLShims_secp256k1_g[64] = {
+    0x79, 0xbe, 0x66, 0x7e, 0xf9, 0xdc, 0xbb, 0xac, 0x55, 0xa0, 0x62, 0x95, 0xce, 0x87, 0x0b, 0x07,
+    0x02, 0x9b, 0xfc, 0xdb, 0x2d, 0xce, 0x28, 0xd9, 0x59, 0xf2, 0x81, 0x5b, 0x16, 0xf8, 0x17, 0x98,
+    0x48, 0x3a, 0xda, 0x77, 0x26, 0xa3, 0xc4, 0x65, 0x5d, 0xa4, 0xfb, 0xfc, 0x0e, 0x11, 0x08, 0xa8,
+    0xfd, 0x17, 0xb4, 0x48, 0xa6, 0x85, 0x54, 0x19, 0x9c, 0x47, 0xd0, 0x8f, 0xfb, 0x10, 0xd4, 0xb8,
+};
+
+static EC_GROUP *CCryptoBoringSSLShims_secp256k1_group_storage = NULL;
+static CRYPTO_once_t CCryptoBoringSSLShims_secp256k1_group_once = CRYPTO_ONCE_INIT;
+
+static void CCryptoBoringSSLShims_secp256k1_group_init(void) {
+    BIGNUM *p = CCryptoBoringSSL_BN_bin2bn(CCryptoBoringSSLShims_secp256k1_p, 32, NULL);
+    BIGNUM *a = CCryptoBoringSSL_BN_new();
+    BIGNUM *b = CCryptoBoringSSL_BN_new();
+    BIGNUM *n = CCryptoBoringSSL_BN_bin2bn(CCryptoBoringSSLShims_secp256k1_n, 32, NULL);
+    BIGNUM *x = CCryptoBoringSSL_BN_bin2bn(CCryptoBoringSSLShims_secp256k1_g, 32, NULL);
+    BIGNUM *y = CCryptoBoringSSL_BN_bin2bn(CCryptoBoringSSLShims_secp256k1_g + 32, 32, NULL);
+    EC_GROUP *group = NULL;
+    EC_POINT *generator = NULL;
+    if (p == NULL || a == NULL || b == NULL || n == NULL || x == NULL || y == NULL ||
+        !CCryptoBoringSSL_BN_set_word(b, 7) ||
+        (group = CCryptoBoringSSL_EC_GROUP_new_curve_GFp(p, a, b, NULL)) == NULL ||
+        (generator = CCryptoBoringSSL_EC_POINT_new(group)) == NULL ||
+        !CCryptoBoringSSL_EC_POINT_set_affine_coordinates_GFp(group, generator, x, y, NULL) ||
+        !CCryptoBoringSSL_EC_GROUP_set_generator(group, generator, n, CCryptoBoringSSL_BN_value_one())) {
+        CCryptoBoringSSL_EC_GROUP_free(group);
+        group = NULL;
+    }
+    CCryptoBoringSSL_EC_POINT_free(generator);
+    CCryptoBoringSSL_BN_free(p);
+    CCryptoBoringSSL_BN_free(a);
+    CCryptoBoringSSL_BN_free(b);
+    CCryptoBoringSSL_BN_free(n);
+    CCryptoBoringSSL_BN_free(x);
+    CCryptoBoringSSL_BN_free(y);
+    CCryptoBoringSSLShims_secp256k1_group_storage = group;
+}
+
+// The group is created on first use and never freed.
+static const EC_GROUP *CCryptoBoringSSLShims_secp256k1_group(void) {
+    CRYPTO_once(&CCryptoBoringSSLShims_secp256k1_group_once, CCryptoBoringSSLShims_secp256k1_group_init);
+    return CCryptoBoringSSLShims_secp256k1_group_storage;
+}
+
+int CCryptoBoringSSLShims_secp256k1_generate_key(void *out_private_key) {
+    static const uint8_t kDefaultAdditionalData[32] = {0};
+    const EC_GROUP *group = CCryptoBoringSSLShims_secp256k1_group();
+    EC_SCALAR scalar;
+    size_t len;
+    if (group == NULL || !CCryptoBoringSSL_ec_random_nonzero_scalar(group, &scalar, kDefaultAdditionalData)) {
+        return 0;
+    }
+    CCryptoBoringSSL_ec_scalar_to_bytes(group, out_private_key, &len, &scalar);
+    CCryptoBoringSSL_OPENSSL_cleanse(&scalar, sizeof(scalar));
+    return 1;
+}
+
+// Parses a private key, which must be in [1, n - 1].
+static int CCryptoBoringSSLShims_secp256k1_private_scalar(const EC_GROUP *group, EC_SCALAR *out,
+                                                          const uint8_t private_key[32]) {
+    return CCryptoBoringSSLShims_ec_scalar_from_bytes_quiet(group, out, private_key, 32) &&
+           !CCryptoBoringSSL_ec_scalar_is_zero(group, out);
+}
+
+int CCryptoBoringSSLShims_secp256k1_public_key(void *out_public_key, const void *private_key) {
+    const EC_GROUP *group = CCryptoBoringSSLShims_secp256k1_group();
+    EC_SCALAR scalar;
+    EC_JACOBIAN point;
+    EC_AFFINE affine;
+    size_t len;
+    int ok = group != NULL &&
+             CCryptoBoringSSLShims_secp256k1_private_scalar(group, &scalar, private_key) &&
+             CCryptoBoringSSL_ec_point_mul_scalar_base(group, &point, &scalar) &&
+             CCryptoBoringSSL_ec_jacobian_to_affine(group, &affine, &point);
+    if (ok) {
+        CCryptoBoringSSL_ec_felem_to_bytes(group, out_public_key, &len, &affine.X);
+        CCryptoBoringSSL_ec_felem_to_bytes(group, (uint8_t *)out_public_key + 32, &len, &affine.Y);
+    }
+    CCryptoBoringSSL_OPENSSL_cleanse(&scalar, sizeof(scalar));
+    return ok;
+}
+
+int CCryptoBoringSSLShims_secp256k1_sign(void *out_signature, const void *private_key,
+                                         const void *digest, size_t digest_len) {
+    const EC_GROUP *group = CCryptoBoringSSLShims_secp256k1_group();
+    uint8_t *signature = out_signature;
+    EC_SCALAR scalar, s;
+    size_t len;
+    int ok = group != NULL &&
+             CCryptoBoringSSLShims_secp256k1_private_scalar(group, &scalar, private_key) &&
+             CCryptoBoringSSLShims_ecdsa_sign_fresh(group, signature, &len, &scalar, digest, digest_len) &&
+             len == 64;
+    // Both s and n - s verify. Only the low one is accepted by Bitcoin's consensus
+    // rules and by Ethereum, so that is the one returned.
+    if (ok && memcmp(signature + 32, CCryptoBoringSSLShims_secp256k1_half_n, 32) > 0) {
+        CCryptoBoringSSL_ec_scalar_from_bytes(group, &s, signature + 32, 32);
+        CCryptoBoringSSL_ec_scalar_neg(group, &s, &s);
+        CCryptoBoringSSL_ec_scalar_to_bytes(group, signature + 32, &len, &s);
+    }
+    CCryptoBoringSSL_OPENSSL_cleanse(&scalar, sizeof(scalar));
+    return ok;
+}
+
+#if defined(BORINGSSL_HAS_UINT128) && defined(OPENSSL_64_BIT)
+#define CCRYPTOBORINGSSLSHIMS_SECP256K1_GLV 1
+
+// Field elements are four little-endian 64-bit limbs, always fully reduced.
+typedef struct {
+    uint64_t v[4];
+} CCryptoBoringSSLShims_k1_fe;
+
+typedef struct {
+    CCryptoBoringSSLShims_k1_fe x, y;
+} CCryptoBoringSSLShims_k1_affine;
+
+// Jacobian coordinates; Z = 0 is the point at infinity.
+typedef struct {
+    CCryptoBoringSSLShims_k1_fe X, Y, Z;
+} CCryptoBoringSSLShims_k1_jacobian;
+
+// 2^256 mod p.
+#define CCRYPTOBORINGSSLSHIMS_K1_C UINT64_C(0x1000003d1)
+
+// Window widths of the signed digits: the multiples of G and λG are computed once
+// and kept in affine form, so they can afford a much wider window than Q.
+#define CCRYPTOBORINGSSLSHIMS_K1_G_WINDOW 8
+#define CCRYPTOBORINGSSLSHIMS_K1_Q_WINDOW 5
+#define CCRYPTOBORINGSSLSHIMS_K1_G_TABLE (1 << (CCRYPTOBORINGSSLSHIMS_K1_G_WINDOW - 2))
+#define CCRYPTOBORINGSSLSHIMS_K1_Q_TABLE (1 << (CCRYPTOBORINGSSLSHIMS_K1_Q_WINDOW - 2))
+
+// Digits of a split scalar, which is below 2^129.
+#define CCRYPTOBORINGSSLSHIMS_K1_MAX_DIGITS 131
+
+static const CCryptoBoringSSLShims_k1_fe CCryptoBoringSSLShims_k1_beta = {{
+    UINT64_C(0xc1396c28719501ee), UINT64_C(0x9cf0497512f58995),
+    UINT64_C(0x6e64479eac3434e9), UINT64_C(0x7ae96a2b657c0710),
+}};
+
+// The constants of the GLV decomposition, as in libsecp256k1: g1 and g2 are
+// round(2^384 · b2 / n) and round(2^384 · -b1 / n) for the short lattice basis
+// (a1, b1), (a2, b2) of {(x, y) : x + y·λ = 0 mod n}.
+static const uint64_t CCryptoBoringSSLShims_k1_g1[4] = {
+    UINT64_C(0xe893209a45dbb031), UINT64_C(0x3daa8a1471e8ca7f),
+    UINT64_C(0xe86c90e49284eb15), UINT64_C(0x3086d221a7d46bcd),
+};
+static const uint64_t CCryptoBoringSSLShims_k1_g2[4] = {
+    UINT64_C(0x1571b4ae8ac47f71), UINT64_C(0x221208ac9df506c6),
+    UINT64_C(0x6f547fa90abfe4c4), UINT64_C(0xe4437ed6010e8828),
+};
+static const uint64_t CCryptoBoringSSLShims_k1_minus_b1[4] = {
+    UINT64_C(0x6f547fa90abfe4c3), UINT64_C(0xe4437ed6010e8828), 0, 0,
+};
+static const uint64_t CCryptoBoringSSLShims_k1_minus_b2[4] = {
+    UINT64_C(0xd765cda83db1562c), UINT64_C(0x8a280ac50774346d),
+    UINT64_C(0xfffffffffffffffe), UINT64_C(0xffffffffffffffff),
+};
+static const uint64_t CCryptoBoringSSLShims_k1_minus_lambda[4] = {
+    UINT64_C(0xe0cfc810b51283cf), UINT64_C(0xa880b9fc8ec739c2),
+    UINT64_C(0x5ad9e3fd77ed9ba4), UINT64_C(0xac9c52b33fa3cf1f),
+};
+
+static void CCryptoBoringSSLShims_k1_fe_reduce_once(CCryptoBoringSSLShims_k1_fe *r) {
+    // r ≥ p exactly when r + (2^256 - p) carries out of 256 bits, and then the
+    // truncated sum is r - p.
+    uint64_t t[4];
+    unsigned __int128 acc = (unsigned __int128)r->v[0] + CCRYPTOBORINGSSLSHIMS_K1_C;
+    t[0] = (uint64_t)acc;
+    for (int i = 1; i < 4; i++) {
+        acc = (unsigned __int128)r->v[i] + (uint64_t)(acc >> 64);
+        t[i] = (uint64_t)acc;
+    }
+    if (acc >> 64) {
+        memcpy(r->v, t, sizeof(t));
+    }
+}
+
+static void CCryptoBoringSSLShims_k1_fe_add(CCryptoBoringSSLShims_k1_fe *r, const CCryptoBoringSSLShims_k1_fe *a,
+                                            const CCryptoBoringSSLShims_k1_fe *b) {
+    unsigned __int128 acc = 0;
+    for (int i = 0; i < 4; i++) {
+        acc = (unsigned __int128)a->v[i] + b->v[i] + (uint64_t)(acc >> 64);
+        r->v[i] = (uint64_t)acc;
+    }
+    if (acc >> 64) {
+        // The sum is below 2p, so folding 2^256 back in as C cannot reach p.
+        acc = (unsigned __int128)r->v[0] + CCRYPTOBORINGSSLSHIMS_K1_C;
+        r->v[0] = (uint64_t)acc;
+        for (int i = 1; i < 4; i++) {
+            acc = (unsigned __int128)r->v[i] + (uint64_t)(acc >> 64);
+            r->v[i] = (uint64_t)acc;
+        }
+    } else {
+        CCryptoBoringSSLShims_k1_fe_reduce_once(r);
+    }
+}
+
+static void CCryptoBoringSSLShims_k1_fe_sub(CCryptoBoringSSLShims_k1_fe *r, const CCryptoBoringSSLShims_k1_fe *a,
+                                            const CCryptoBoringSSLShims_k1_fe *b) {
+    uint64_t borrow = 0;
+    for (int i = 0; i < 4; i++) {
+        unsigned __int128 d = (unsigned __int128)a->v[i] - b->v[i] - borrow;
+        r->v[i] = (uint64_t)d;
+        borrow = (uint64_t)(d >> 64) & 1;
+    }
+    if (borrow) {
+        // Adding p is subtracting C from the wrapped difference, which is above C.
+        borrow = CCRYPTOBORINGSSLSHIMS_K1_C;
+        for (int i = 0; i < 4; i++) {
+            unsigned __int128 d = (unsigned __int128)r->v[i] - borrow;
+            r->v[i] = (uint64_t)d;
+            borrow = (uint64_t)(d >> 64) & 1;
+        }
+    }
+}
+
+static void CCryptoBoringSSLShims_k1_fe_neg(CCryptoBoringSSLShims_k1_fe *r, const CCryptoBoringSSLShims_k1_fe *a) {
+    static const CCryptoBoringSSLShims_k1_fe zero = {{0, 0, 0, 0}};
+    CCryptoBoringSSLShims_k1_fe_sub(r, &zero, a);
+}
+
+static void CCryptoBoringSSLShims_k1_fe_mul(CCryptoBoringSSLShims_k1_fe *r, const CCryptoBoringSSLShims_k1_fe *a,
+                                            const CCryptoBoringSSLShims_k1_fe *b) {
+    uint64_t t[8] = {0};
+    for (int i = 0; i < 4; i++) {
+        unsigned __int128 acc = 0;
+        for (int j = 0; j < 4; j++) {
+            acc = (unsigned __int128)a->v[i] * b->v[j] + t[i + j] + (uint64_t)(acc >> 64);
+            t[i + j] = (uint64_t)acc;
+        }
+        t[i + 4] = (uint64_t)(acc >> 64);
+    }
+
+    // t = lo + 2^256·hi = lo + C·hi (mod p). The first fold leaves a carry of
+    // at most 34 bits, and the second at most one bit.
+    unsigned __int128 acc = 0;
+    for (int i = 0; i < 4; i++) {
+        acc = (unsigned __int128)t[i + 4] * CCRYPTOBORINGSSLSHIMS_K1_C + t[i] + (uint64_t)(acc >> 64);
+        r->v[i] = (uint64_t)acc;
+    }
+    uint64_t carry = (uint64_t)(acc >> 64);
+    acc = (unsigned __int128)carry * CCRYPTOBORINGSSLSHIMS_K1_C + r->v[0];
+    r->v[0] = (uint64_t)acc;
+    for (int i = 1; i < 4; i++) {
+        acc = (unsigned __int128)r->v[i] + (uint64_t)(acc >> 64);
+        r->v[i] = (uint64_t)acc;
+    }
+    if (acc >> 64) {
+        acc = (unsigned __int128)r->v[0] + CCRYPTOBORINGSSLSHIMS_K1_C;
+        r->v[0] = (uint64_t)acc;
+        for (int i = 1; i < 4; i++) {
+            acc = (unsigned __int128)r->v[i] + (uint64_t)(acc >> 64);
+            r->v[i] = (uint64_t)acc;
+        }
+    }
+    CCryptoBoringSSLShims_k1_fe_reduce_once(r);
+}
+
+static void CCryptoBoringSSLShims_k1_fe_sqr(CCryptoBoringSSLShims_k1_fe *r, const CCryptoBoringSSLShims_k1_fe *a) {
+    CCryptoBoringSSLShims_k1_fe_mul(r, a, a);
+}
+
+static int CCryptoBoringSSLShims_k1_fe_is_zero(const CCryptoBoringSSLShims_k1_fe *a) {
+    return (a->v[0] | a->v[1] | a->v[2] | a->v[3]) == 0;
+}
+
+static int CCryptoBoringSSLShims_k1_fe_equal(const CCryptoBoringSSLShims_k1_fe *a,
+                                             const CCryptoBoringSSLShims_k1_fe *b) {
+    return memcmp(a->v, b->v, sizeof(a->v)) == 0;
+}
+
+// Parses 32 big-endian bytes, which must be below p.
+static int CCryptoBoringSSLShims_k1_fe_from_bytes(CCryptoBoringSSLShims_k1_fe *r, const uint8_t in[32]) {
+    for (int i = 0; i < 4; i++) {
+        r->v[i] = CRYPTO_load_u64_be(in + 8 * (3 - i));
+    }
+    CCryptoBoringSSLShims_k1_fe t = *r;
+    CCryptoBoringSSLShims_k1_fe_reduce_once(&t);
+    return CCryptoBoringSSLShims_k1_fe_equal(&t, r);
+}
+
+static void CCryptoBoringSSLShims_k1_fe_to_bytes(uint8_t out[32], const CCryptoBoringSSLShims_k1_fe *a) {
+    for (int i = 0; i < 4; i++) {
+        CRYPTO_store_u64_be(out + 8 * (3 - i), a->v[i]);
+    }
+}
+
+// Raises |a| to the power of the big-endian |exponent|.
+static void CCryptoBoringSSLShims_k1_fe_pow(CCryptoBoringSSLShims_k1_fe *r, const CCryptoBoringSSLShims_k1_fe *a,
+                                            const uint8_t exponent[32]) {
+    CCryptoBoringSSLShims_k1_fe acc = {{1, 0, 0, 0}};
+    for (int i = 0; i < 256; i++) {
+        CCryptoBoringSSLShims_k1_fe_sqr(&acc, &acc);
+        if ((exponent[i / 8] >> (7 - i % 8)) & 1) {
+            CCryptoBoringSSLShims_k1_fe_mul(&acc, &acc, a);
+        }
+    }
+    *r = acc;
+}
+
+static void CCryptoBoringSSLShims_k1_fe_inv(CCryptoBoringSSLShims_k1_fe *r, const CCryptoBoringSSLShims_k1_fe *a) {
+    uint8_t exponent[32];
+    memcpy(exponent, CCryptoBoringSSLShims_secp256k1_p, 32);
+    exponent[31] -= 2;
+    CCryptoBoringSSLShims_k1_fe_pow(r, a, exponent);
+}
+
+// Returns whether (|x|, |y|) satisfies y² = x³ + 7.
+static int CCryptoBoringSSLShims_k1_is_on_curve(const CCryptoBoringSSLShims_k1_affine *p) {
+    static const CCryptoBoringSSLShims_k1_fe seven = {{7, 0, 0, 0}};
+    CCryptoBoringSSLShims_k1_fe lhs, rhs;
+    CCryptoBoringSSLShims_k1_fe_sqr(&lhs, &p->y);
+    CCryptoBoringSSLShims_k1_fe_sqr(&rhs, &p->x);
+    CCryptoBoringSSLShims_k1_fe_mul(&rhs, &rhs, &p->x);
+    CCryptoBoringSSLShims_k1_fe_add(&rhs, &rhs, &seven);
+    return CCryptoBoringSSLShims_k1_fe_equal(&lhs, &rhs);
+}
+
+static int CCryptoBoringSSLShims_k1_affine_from_bytes(CCryptoBoringSSLShims_k1_affine *r, const uint8_t in[64]) {
+    return CCryptoBoringSSLShims_k1_fe_from_bytes(&r->x, in) &&
+           CCryptoBoringSSLShims_k1_fe_from_bytes(&r->y, in + 32) &&
+           CCryptoBoringSSLShims_k1_is_on_curve(r);
+}
+
+// dbl-2009-l, for a = 0. |r| may alias |a|.
+static void CCryptoBoringSSLShims_k1_dbl(CCryptoBoringSSLShims_k1_jacobian *r,
+                                         const CCryptoBoringSSLShims_k1_jacobian *a) {
+    CCryptoBoringSSLShims_k1_fe A, B, C, D, E, F, t;
+    CCryptoBoringSSLShims_k1_fe_sqr(&A, &a->X);
+    CCryptoBoringSSLShims_k1_fe_sqr(&B, &a->Y);
+    CCryptoBoringSSLShims_k1_fe_sqr(&C, &B);
+    CCryptoBoringSSLShims_k1_fe_add(&t, &a->X, &B);
+    CCryptoBoringSSLShims_k1_fe_sqr(&t, &t);
+    CCryptoBoringSSLShims_k1_fe_sub(&t, &t, &A);
+    CCryptoBoringSSLShims_k1_fe_sub(&t, &t, &C);
+    CCryptoBoringSSLShims_k1_fe_add(&D, &t, &t);
+    CCryptoBoringSSLShims_k1_fe_add(&E, &A, &A);
+    CCryptoBoringSSLShims_k1_fe_add(&E, &E, &A);
+    CCryptoBoringSSLShims_k1_fe_sqr(&F, &E);
+
+    // Z3 = 2·Y1·Z1, before Y1 is overwritten.
+    CCryptoBoringSSLShims_k1_fe_mul(&r->Z, &a->Y, &a->Z);
+    CCryptoBoringSSLShims_k1_fe_add(&r->Z, &r->Z, &r->Z);
+
+    CCryptoBoringSSLShims_k1_fe_sub(&r->X, &F, &D);
+    CCryptoBoringSSLShims_k1_fe_sub(&r->X, &r->X, &D);
+    CCryptoBoringSSLShims_k1_fe_sub(&t, &D, &r->X);
+    CCryptoBoringSSLShims_k1_fe_mul(&t, &E, &t);
+    CCryptoBoringSSLShims_k1_fe_add(&C, &C, &C);
+    CCryptoBoringSSLShims_k1_fe_add(&C, &C, &C);
+    CCryptoBoringSSLShims_k1_fe_add(&C, &C, &C);
+    CCryptoBoringSSLShims_k1_fe_sub(&r->Y, &t, &C);
+}
+
+// add-2007-bl, falling back to doubling when the points are equal. If |b_z| is
+// NULL, |b| is affine (Z = 1), which saves five multiplications. |r| may alias
+// |a|.
+static void CCryptoBoringSSLShims_k1_add(CCryptoBoringSSLShims_k1_jacobian *r,
+                                         const CCryptoBoringSSLShims_k1_jacobian *a,
+                                         const CCryptoBoringSSLShims_k1_fe *b_x, const CCryptoBoringSSLShims_k1_fe *b_y,
+                                         const CCryptoBoringSSLShims_k1_fe *b_z) {
+    if (b_z != NULL && CCryptoBoringSSLShims_k1_fe_is_zero(b_z)) {
+        *r = *a;
+        return;
+    }
+    if (CCryptoBoringSSLShims_k1_fe_is_zero(&a->Z)) {
+        r->X = *b_x;
+        r->Y = *b_y;
+        if (b_z != NULL) {
+            r->Z = *b_z;
+        } else {
+            memset(&r->Z, 0, sizeof(r->Z));
+            r->Z.v[0] = 1;
+        }
+        return;
+    }
+
+    CCryptoBoringSSLShims_k1_fe z1z1, z2z2, u1, u2, s1, s2, h, i, j, rr, v, t;
+    CCryptoBoringSSLShims_k1_fe_sqr(&z1z1, &a->Z);
+    CCryptoBoringSSLShims_k1_fe_mul(&u2, b_x, &z1z1);
+    CCryptoBoringSSLShims_k1_fe_mul(&s2, b_y, &a->Z);
+    CCryptoBoringSSLShims_k1_fe_mul(&s2, &s2, &z1z1);
+    if (b_z != NULL) {
+        CCryptoBoringSSLShims_k1_fe_sqr(&z2z2, b_z);
+        CCryptoBoringSSLShims_k1_fe_mul(&u1, &a->X, &z2z2);
+        CCryptoBoringSSLShims_k1_fe_mul(&s1, &a->Y, b_z);
+        CCryptoBoringSSLShims_k1_fe_mul(&s1, &s1, &z2z2);
+    } else {
+        u1 = a->X;
+        s1 = a->Y;
+    }
+
+    CCryptoBoringSSLShims_k1_fe_sub(&h, &u2, &u1);
+    CCryptoBoringSSLShims_k1_fe_sub(&rr, &s2, &s1);
+    if (CCryptoBoringSSLShims_k1_fe_is_zero(&h)) {
+        if (CCryptoBoringSSLShims_k1_fe_is_zero(&rr)) {
+            CCryptoBoringSSLShims_k1_dbl(r, a);
+        } else {
+            memset(r, 0, sizeof(*r));
+        }
+        return;
+    }
+    CCryptoBoringSSLShims_k1_fe_add(&rr, &rr, &rr);
+
+    CCryptoBoringSSLShims_k1_fe_add(&i, &h, &h);
+    CCryptoBoringSSLShims_k1_fe_sqr(&i, &i);
+    CCryptoBoringSSLShims_k1_fe_mul(&j, &h, &i);
+    CCryptoBoringSSLShims_k1_fe_mul(&v, &u1, &i);
+
+    // Z3 = ((Z1 + Z2)² - Z1Z1 - Z2Z2)·H, which is 2·Z1·H when Z2 = 1.
+    if (b_z != NULL) {
+        CCryptoBoringSSLShims_k1_fe_add(&t, &a->Z, b_z);
+        CCryptoBoringSSLShims_k1_fe_sqr(&t, &t);
+        CCryptoBoringSSLShims_k1_fe_sub(&t, &t, &z1z1);
+        CCryptoBoringSSLShims_k1_fe_sub(&t, &t, &z2z2);
+    } else {
+        CCryptoBoringSSLShims_k1_fe_add(&t, &a->Z, &a->Z);
+    }
+    CCryptoBoringSSLShims_k1_fe_mul(&r->Z, &t, &h);
+
+    CCryptoBoringSSLShims_k1_fe_sqr(&r->X, &rr);
+    CCryptoBoringSSLShims_k1_fe_sub(&r->X, &r->X, &j);
+    CCryptoBoringSSLShims_k1_fe_sub(&r->X, &r->X, &v);
+    CCryptoBoringSSLShims_k1_fe_sub(&r->X, &r->X, &v);
+    CCryptoBoringSSLShims_k1_fe_sub(&t, &v, &r->X);
+    CCryptoBoringSSLShims_k1_fe_mul(&t, &rr, &t);
+    CCryptoBoringSSLShims_k1_fe_mul(&s1, &s1, &j);
+    CCryptoBoringSSLShims_k1_fe_add(&s1, &s1, &s1);
+    CCryptoBoringSSLShims_k1_fe_sub(&r->Y, &t, &s1);
+}
+
+// Fills |table| with P, 3P, 5P, ..., (2·count - 1)P.
+static void CCryptoBoringSSLShims_k1_odd_multiples(CCryptoBoringSSLShims_k1_jacobian *table, size_t count,
+                                                   const CCryptoBoringSSLShims_k1_jacobian *p) {
+    CCryptoBoringSSLShims_k1_jacobian p2;
+    CCryptoBoringSSLShims_k1_dbl(&p2, p);
+    table[0] = *p;
+    for (size_t i = 1; i < count; i++) {
+        CCryptoBoringSSLShims_k1_add(&table[i], &table[i - 1], &p2.X, &p2.Y, &p2.Z);
+    }
+}
+
+// The odd multiples of G and of λG = (β·x, y) in affine form.
+static CCryptoBoringSSLShims_k1_affine CCryptoBoringSSLShims_k1_g_table[CCRYPTOBORINGSSLSHIMS_K1_G_TABLE];
+static CCryptoBoringSSLShims_k1_affine CCryptoBoringSSLShims_k1_lambda_g_table[CCRYPTOBORINGSSLSHIMS_K1_G_TABLE];
+static CRYPTO_once_t CCryptoBoringSSLShims_k1_g_table_once = CRYPTO_ONCE_INIT;
+
+static void CCryptoBoringSSLShims_k1_g_table_init(void) {
+    CCryptoBoringSSLShims_k1_jacobian g, table[CCRYPTOBORINGSSLSHIMS_K1_G_TABLE];
+    CCryptoBoringSSLShims_k1_fe_from_bytes(&g.X, CCryptoBoringSSLShims_secp256k1_g);
+    CCryptoBoringSSLShims_k1_fe_from_bytes(&g.Y, CCryptoBoringSSLShims_secp256k1_g + 32);
+    memset(&g.Z, 0, sizeof(g.Z));
+    g.Z.v[0] = 1;
+    CCryptoBoringSSLShims_k1_odd_multiples(table, CCRYPTOBORINGSSLSHIMS_K1_G_TABLE, &g);
+
+    // One inversion for the whole table: prefix products, then peel them off.
+    CCryptoBoringSSLShims_k1_fe prefix[CCRYPTOBORINGSSLSHIMS_K1_G_TABLE], inv, z_inv, z_inv2;
+    prefix[0] = table[0].Z;
+    for (size_t i = 1; i < CCRYPTOBORINGSSLSHIMS_K1_G_TABLE; i++) {
+        CCryptoBoringSSLShims_k1_fe_mul(&prefix[i], &prefix[i - 1], &table[i].Z);
+    }
+    CCryptoBoringSSLShims_k1_fe_inv(&inv, &prefix[CCRYPTOBORINGSSLSHIMS_K1_G_TABLE - 1]);
+    for (size_t i = CCRYPTOBORINGSSLSHIMS_K1_G_TABLE; i-- > 0;) {
+        if (i > 0) {
+            CCryptoBoringSSLShims_k1_fe_mul(&z_inv, &inv, &prefix[i - 1]);
+            CCryptoBoringSSLShims_k1_fe_mul(&inv, &inv, &table[i].Z);
+        } else {
+            z_inv = inv;
+        }
+        CCryptoBoringSSLShims_k1_fe_sqr(&z_inv2, &z_inv);
+        CCryptoBoringSSLShims_k1_fe_mul(&CCryptoBoringSSLShims_k1_g_table[i].x, &table[i].X, &z_inv2);
+        CCryptoBoringSSLShims_k1_fe_mul(&z_inv2, &z_inv2, &z_inv);
+        CCryptoBoringSSLShims_k1_fe_mul(&CCryptoBoringSSLShims_k1_g_table[i].y, &table[i].Y, &z_inv2);
+        CCryptoBoringSSLShims_k1_fe_mul(&CCryptoBoringSSLShims_k1_lambda_g_table[i].x,
+                                        &CCryptoBoringSSLShims_k1_g_table[i].x, &CCryptoBoringSSLShims_k1_beta);
+        CCryptoBoringSSLShims_k1_lambda_g_table[i].y = CCryptoBoringSSLShims_k1_g_table[i].y;
+    }
+}
+
+// A scalar below 2^129 as signed digits, each zero or odd and below
+// 2^(w - 1) in magnitude, least significant first. Returns the number of digits.
+static size_t CCryptoBoringSSLShims_k1_wnaf(int8_t out[CCRYPTOBORINGSSLSHIMS_K1_MAX_DIGITS], const uint64_t scalar[3],
+                                            int w) {
+    uint64_t k[3] = {scalar[0], scalar[1], scalar[2]};
+    size_t len = 0;
+    memset(out, 0, CCRYPTOBORINGSSLSHIMS_K1_MAX_DIGITS);
+    while ((k[0] | k[1] | k[2]) != 0) {
+        int digit = 0;
+        if (k[0] & 1) {
+            digit = (int)(k[0] & ((UINT64_C(1) << w) - 1));
+            if (digit >= 1 << (w - 1)) {
+                digit -= 1 << w;
+            }
+            // k -= digit, which leaves k divisible by 2^w.
+            unsigned __int128 acc;
+            if (digit > 0) {
+                uint64_t borrow = (uint64_t)digit;
+                for (int i = 0; i < 3; i++) {
+                    acc = (unsigned __int128)k[i] - borrow;
+                    k[i] = (uint64_t)acc;
+                    borrow = (uint64_t)(acc >> 64) & 1;
+                }
+            } else {
+                acc = (unsigned __int128)k[0] + (uint64_t)(-digit);
+                k[0] = (uint64_t)acc;
+                for (int i = 1; i < 3; i++) {
+                    acc = (unsigned __int128)k[i] + (uint64_t)(acc >> 64);
+                    k[i] = (uint64_t)acc;
+                }
+            }
+        }
+        out[len++] = (int8_t)digit;
+        k[0] = (k[0] >> 1) | (k[1] << 63);
+        k[1] = (k[1] >> 1) | (k[2] << 63);
+        k[2] >>= 1;
+    }
+    return len;
+}
+
+// Loads a scalar's words, which are 64-bit on every target this path runs on.
+static void CCryptoBoringSSLShims_k1_scalar_words(uint64_t out[4], const EC_SCALAR *a) {
+    for (int i = 0; i < 4; i++) {
+        out[i] = a->words[i];
+    }
+}
+
+// round(k · g / 2^384) for 256-bit k and g; the result is below 2^128.
+static void CCryptoBoringSSLShims_k1_mul_shift_384(EC_SCALAR *out, const uint64_t k[4], const uint64_t g[4]) {
+    uint64_t t[8] = {0};
+    for (int i = 0; i < 4; i++) {
+        unsigned __int128 acc = 0;
+        for (int j = 0; j < 4; j++) {
+            acc = (unsigned __int128)k[i] * g[j] + t[i + j] + (uint64_t)(acc >> 64);
+            t[i + j] = (uint64_t)acc;
+        }
+        t[i + 4] = (uint64_t)(acc >> 64);
+    }
+    unsigned __int128 acc = (unsigned __int128)t[6] + (t[5] >> 63);
+    OPENSSL_memset(out, 0, sizeof(*out));
+    out->words[0] = (BN_ULONG)acc;
+    out->words[1] = (BN_ULONG)(t[7] + (uint64_t)(acc >> 64));
+}
+
+typedef struct {
+    // |k| as k1 + k2·λ, with |k1| and |k2| below 2^129 and their signs apart.
+    uint64_t k1[3], k2[3];
+    int k1_negative, k2_negative;
+} CCryptoBoringSSLShims_k1_split_scalar;
+
+// The Montgomery forms of -b1, -b2 and -λ mod n.
+typedef struct {
+    EC_SCALAR minus_b1, minus_b2, minus_lambda;
+} CCryptoBoringSSLShims_k1_split_constants;
+
+static void CCryptoBoringSSLShims_k1_load_split_constants(const EC_GROUP *group,
+                                                          CCryptoBoringSSLShims_k1_split_constants *out) {
+    EC_SCALAR *targets[3] = {&out->minus_b1, &out->minus_b2, &out->minus_lambda};
+    const uint64_t *values[3] = {CCryptoBoringSSLShims_k1_minus_b1, CCryptoBoringSSLShims_k1_minus_b2,
+                                 CCryptoBoringSSLShims_k1_minus_lambda};
+    for (int i = 0; i < 3; i++) {
+        EC_SCALAR plain;
+        OPENSSL_memset(&plain, 0, sizeof(plain));
+        for (int j = 0; j < 4; j++) {
+            plain.words[j] = (BN_ULONG)values[i][j];
+        }
+        CCryptoBoringSSL_ec_scalar_to_montgomery(group, targets[i], &plain);
+    }
+}
+
+// Takes a scalar mod n that is either small or close to n to its magnitude and sign.
+static void CCryptoBoringSSLShims_k1_signed_scalar(const EC_GROUP *group, uint64_t out[3], int *out_negative,
+                                                   const EC_SCALAR *a) {
+    EC_SCALAR magnitude = *a;
+    *out_negative = a->words[2] != 0 || a->words[3] != 0;
+    if (*out_negative) {
+        CCryptoBoringSSL_ec_scalar_neg(group, &magnitude, a);
+    }
+    out[0] = magnitude.words[0];
+    out[1] = magnitude.words[1];
+    out[2] = magnitude.words[2];
+}
+
+static void CCryptoBoringSSLShims_k1_split(const EC_GROUP *group, const CCryptoBoringSSLShims_k1_split_constants *c,
+                                           CCryptoBoringSSLShims_k1_split_scalar *out, const EC_SCALAR *k) {
+    // As in libsecp256k1: c1 = round(k·g1 / 2^384), c2 = round(k·g2 / 2^384),
+    // k2 = -(c1·b1 + c2·b2) and k1 = k - k2·λ.
+    uint64_t words[4];
+    EC_SCALAR c1, c2, k1, k2;
+    CCryptoBoringSSLShims_k1_scalar_words(words, k);
+    CCryptoBoringSSLShims_k1_mul_shift_384(&c1, words, CCryptoBoringSSLShims_k1_g1);
+    CCryptoBoringSSLShims_k1_mul_shift_384(&c2, words, CCryptoBoringSSLShims_k1_g2);
+    CCryptoBoringSSL_ec_scalar_mul_montgomery(group, &c1, &c1, &c->minus_b1);
+    CCryptoBoringSSL_ec_scalar_mul_montgomery(group, &c2, &c2, &c->minus_b2);
+    CCryptoBoringSSL_ec_scalar_add(group, &k2, &c1, &c2);
+    CCryptoBoringSSL_ec_scalar_mul_montgomery(group, &k1, &k2, &c->minus_lambda);
+    CCryptoBoringSSL_ec_scalar_add(group, &k1, &k1, k);
+    CCryptoBoringSSLShims_k1_signed_scalar(group, out->k1, &out->k1_negative, &k1);
+    CCryptoBoringSSLShims_k1_signed_scalar(group, out->k2, &out->k2_negative, &k2);
+}
+
+// The odd multiples of a public key and of its image under the endomorphism.
+typedef struct {
+    CCryptoBoringSSLShims_k1_jacobian q[CCRYPTOBORINGSSLSHIMS_K1_Q_TABLE];
+    CCryptoBoringSSLShims_k1_jacobian lambda_q[CCRYPTOBORINGSSLSHIMS_K1_Q_TABLE];
+} CCryptoBoringSSLShims_k1_public_key_table;
+
+static void CCryptoBoringSSLShims_k1_public_key_table_init(CCryptoBoringSSLShims_k1_public_key_table *table,
+                                                           const CCryptoBoringSSLShims_k1_affine *q) {
+    CCryptoBoringSSLShims_k1_jacobian p;
+    p.X = q->x;
+    p.Y = q->y;
+    memset(&p.Z, 0, sizeof(p.Z));
+    p.Z.v[0] = 1;
+    CCryptoBoringSSLShims_k1_odd_multiples(table->q, CCRYPTOBORINGSSLSHIMS_K1_Q_TABLE, &p);
+    for (size_t i = 0; i < CCRYPTOBORINGSSLSHIMS_K1_Q_TABLE; i++) {
+        // λ·(X : Y : Z) = (β·X : Y : Z).
+        table->lambda_q[i] = table->q[i];
+        CCryptoBoringSSLShims_k1_fe_mul(&table->lambda_q[i].X, &table->q[i].X, &CCryptoBoringSSLShims_k1_beta);
+    }
+}
+
+// Computes u1·G + u2·Q by Straus' method over the four half-length scalars.
+static void CCryptoBoringSSLShims_k1_mul_public(const EC_GROUP *group, const CCryptoBoringSSLShims_k1_split_constants *c,
+                                                CCryptoBoringSSLShims_k1_jacobian *r, const EC_SCALAR *u1,
+                                                const CCryptoBoringSSLShims_k1_public_key_table *table,
+                                                const EC_SCALAR *u2) {
+    CCryptoBoringSSLShims_k1_split_scalar s1, s2;
+    CCryptoBoringSSLShims_k1_split(group, c, &s1, u1);
+    CCryptoBoringSSLShims_k1_split(group, c, &s2, u2);
+
+    int8_t digits[4][CCRYPTOBORINGSSLSHIMS_K1_MAX_DIGITS];
+    size_t len = 0, n;
+    n = CCryptoBoringSSLShims_k1_wnaf(digits[0], s1.k1, CCRYPTOBORINGSSLSHIMS_K1_G_WINDOW);
+    len = n > len ? n : len;
+    n = CCryptoBoringSSLShims_k1_wnaf(digits[1], s1.k2, CCRYPTOBORINGSSLSHIMS_K1_G_WINDOW);
+    len = n > len ? n : len;
+    n = CCryptoBoringSSLShims_k1_wnaf(digits[2], s2.k1, CCRYPTOBORINGSSLSHIMS_K1_Q_WINDOW);
+    len = n > len ? n : len;
+    n = CCryptoBoringSSLShims_k1_wnaf(digits[3], s2.k2, CCRYPTOBORINGSSLSHIMS_K1_Q_WINDOW);
+    len = n > len ? n : len;
+    const int negative[4] = {s1.k1_negative, s1.k2_negative, s2.k1_negative, s2.k2_negative};
+
+    memset(r, 0, sizeof(*r));
+    for (size_t i = len; i-- > 0;) {
+        if (!CCryptoBoringSSLShims_k1_fe_is_zero(&r->Z)) {
+            CCryptoBoringSSLShims_k1_dbl(r, r);
+        }
+        for (int term = 0; term < 4; term++) {
+            int digit = digits[term][i];
+            if (digit == 0) {
+                continue;
+            }
+            int subtract = (digit < 0) != negative[term];
+            size_t index = (size_t)(digit < 0 ? -digit : digit) >> 1;
+            CCryptoBoringSSLShims_k1_fe y;
+            if (term < 2) {
+                const CCryptoBoringSSLShims_k1_affine *p =
+                    term == 0 ? &CCryptoBoringSSLShims_k1_g_table[index] : &CCryptoBoringSSLShims_k1_lambda_g_table[index];
+                y = p->y;
+                if (subtract) {
+                    CCryptoBoringSSLShims_k1_fe_neg(&y, &y);
+                }
+                CCryptoBoringSSLShims_k1_add(r, r, &p->x, &y, NULL);
+            } else {
+                const CCryptoBoringSSLShims_k1_jacobian *p =
+                    term == 2 ? &table->q[index] : &table->lambda_q[index];
+                y = p->Y;
+                if (subtract) {
+                    CCryptoBoringSSLShims_k1_fe_neg(&y, &y);
+                }
+                CCryptoBoringSSLShims_k1_add(r, r, &p->X, &y, &p->Z);
+            }
+        }
+    }
+}
+
+// Returns whether the x-coordinate of |p|, reduced mod n, is |r|.
+static int CCryptoBoringSSLShims_k1_x_equals_scalar(const CCryptoBoringSSLShims_k1_jacobian *p, const EC_SCALAR *r) {
+    static const CCryptoBoringSSLShims_k1_fe n = {{
+        UINT64_C(0xbfd25e8cd0364141), UINT64_C(0xbaaedce6af48a03b),
+        UINT64_C(0xfffffffffffffffe), UINT64_C(0xffffffffffffffff),
+    }};
+    if (CCryptoBoringSSLShims_k1_fe_is_zero(&p->Z)) {
+        return 0;
+    }
+    // x = X / Z², so compare X with r·Z², and with (r + n)·Z² if r + n < p.
+    CCryptoBoringSSLShims_k1_fe z2, candidate, t;
+    uint64_t words[4];
+    CCryptoBoringSSLShims_k1_scalar_words(words, r);
+    memcpy(candidate.v, words, sizeof(words));
+    CCryptoBoringSSLShims_k1_fe_sqr(&z2, &p->Z);
+    CCryptoBoringSSLShims_k1_fe_mul(&t, &candidate, &z2);
+    if (CCryptoBoringSSLShims_k1_fe_equal(&t, &p->X)) {
+        return 1;
+    }
+    // p - n is just over 2^128, so this second candidate is rare but possible.
+    static const uint64_t p_minus_n[4] = {UINT64_C(0x402da1722fc9baee), UINT64_C(0x4551231950b75fc4), 1, 0};
+    for (int i = 3; i >= 0; i--) {
+        if (candidate.v[i] != p_minus_n[i]) {
+            if (candidate.v[i] > p_minus_n[i]) {
+                return 0;
+            }
+            break;
+        }
+        if (i == 0) {
+            return 0;
+        }
+    }
+    CCryptoBoringSSLShims_k1_fe_add(&t, &candidate, &n);
+    CCryptoBoringSSLShims_k1_fe_mul(&t, &t, &z2);
+    return CCryptoBoringSSLShims_k1_fe_equal(&t, &p->X);
+}
+#endif  // BORINGSSL_HAS_UINT128 && OPENSSL_64_BIT
+
+int CCryptoBoringSSLShims_secp256k1_public_key_is_valid(const void *public_key) {
+    const EC_GROUP *group = CCryptoBoringSSLShims_secp256k1_group();
+    EC_JACOBIAN point;
+    return group != NULL && CCryptoBoringSSLShims_ec_jacobian_from_raw_point(group, &point, public_key, 64);
+}
+
+size_t CCryptoBoringSSLShims_secp256k1_verify_batch(const void *public_key,
+                                                    const CCryptoBoringSSLShims_ECDSA_verify_batch_op *ops,
+                                                    size_t ops_count, int *results) {
+    const EC_GROUP *group = CCryptoBoringSSLShims_secp256k1_group();
+    size_t valid = 0;
+    OPENSSL_memset(results, 0, ops_count * sizeof(int));
+    if (group == NULL) {
+        return 0;
+    }
+
+#if defined(CCRYPTOBORINGSSLSHIMS_SECP256K1_GLV)
+    CCryptoBoringSSLShims_k1_affine q;
+    if (!CCryptoBoringSSLShims_k1_affine_from_bytes(&q, public_key)) {
+        return 0;
+    }
+    CRYPTO_once(&CCryptoBoringSSLShims_k1_g_table_once, CCryptoBoringSSLShims_k1_g_table_init);
+    CCryptoBoringSSLShims_k1_split_constants constants;
+    CCryptoBoringSSLShims_k1_load_split_constants(group, &constants);
+    // The multiples of the key are shared by every signature in the batch.
+    CCryptoBoringSSLShims_k1_public_key_table table;
+    CCryptoBoringSSLShims_k1_public_key_table_init(&table, &q);
+
+    for (size_t i = 0; i < ops_count; i++) {
+        // Mirrors |CCryptoBoringSSLShims_ecdsa_verify_raw| up to the multiplication.
+        const CCryptoBoringSSLShims_ECDSA_verify_batch_op *op = &ops[i];
+        const uint8_t *signature = op->signature;
+        EC_SCALAR r, s, u1, u2, s_inv_mont, m;
+        if (op->signature_len != 64 ||
+            !CCryptoBoringSSLShims_ec_scalar_from_bytes_quiet(group, &r, signature, 32) ||
+            CCryptoBoringSSL_ec_scalar_is_zero(group, &r) ||
+            !CCryptoBoringSSLShims_ec_scalar_from_bytes_quiet(group, &s, signature + 32, 32) ||
+            CCryptoBoringSSL_ec_scalar_is_zero(group, &s) ||
+            !CCryptoBoringSSL_ec_scalar_to_montgomery_inv_vartime(group, &s_inv_mont, &s)) {
+            continue;
+        }
+        CCryptoBoringSSLShims_ecdsa_digest_to_scalar(group, &m, op->digest, op->digest_len);
+        CCryptoBoringSSL_ec_scalar_mul_montgomery(group, &u1, &m, &s_inv_mont);
+        CCryptoBoringSSL_ec_scalar_mul_montgomery(group, &u2, &r, &s_inv_mont);
+
+        CCryptoBoringSSLShims_k1_jacobian point;
+        CCryptoBoringSSLShims_k1_mul_public(group, &constants, &point, &u1, &table, &u2);
+        results[i] = CCryptoBoringSSLShims_k1_x_equals_scalar(&point, &r);
+        valid += (size_t)results[i];
+    }
+#else
+    EC_JACOBIAN point;
+    if (!CCryptoBoringSSLShims_ec_jacobian_from_raw_point(group, &point, public_key, 64)) {
+        return 0;
+    }
+    for (size_t i = 0; i < ops_count; i++) {
+        results[i] = CCryptoBoringSSLShims_ecdsa_verify_raw(group, &point, ops[i].digest, ops[i].digest_len,
+                                                            ops[i].signature, ops[i].signature_len);
+        valid += (size_t)results[i];
+    }
+#endif
+    return valid;
+}
+
+int CCryptoBoringSSLShims_secp256k1_verify(const void *public_key, const void *digest, size_t digest_len,
+                                           const void *signature, size_t signature_len) {
+    CCryptoBoringSSLShims_ECDSA_verify_batch_op op = {
+        .digest = digest,
+        .digest_len = digest_len,
+        .signature = signature,
+        .signature_len = signature_len,
+    };
+    int result;
+    return (int)CCryptoBoringSSLShims_secp256k1_verify_batch(public_key, &op, 1, &result);
+}
+
+// Verifies with BoringSSL's generic arithmetic on the same group, for testing
+// the dedicated path against.
+int CCryptoBoringSSLShims_secp256k1_verify_generic(const void *public_key, const void *digest,
+                                                   size_t digest_len, const void *signature, size_t signature_len) {
+    const EC_GROUP *group = CCryptoBoringSSLShims_secp256k1_group();
+    EC_JACOBIAN point;
+    return group != NULL && CCryptoBoringSSLShims_ec_jacobian_from_raw_point(group, &point, public_key, 64) &&
+           CCryptoBoringSSLShims_ecdsa_verify_raw(group, &point, digest, digest_len, signature, signature_len);
+}
+
+int CCryptoBoringSSLShims_secp256k1_decompress(void *out_public_key, const void *compressed_public_key) {
+    const uint8_t *compressed = compressed_public_key;
+    // y = ±(x³ + 7)^((p + 1) / 4), as p = 3 mod 4.
+    static const uint8_t kSqrtExponent[32] = {
+        0x3f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xbf, 0xff, 0xff, 0x0c,
+    };
+    if (compressed[0] != 0x02 && compressed[0] != 0x03) {
+        return 0;
+    }
+#if defined(CCRYPTOBORINGSSLSHIMS_SECP256K1_GLV)
+    static const CCryptoBoringSSLShims_k1_fe seven = {{7, 0, 0, 0}};
+    CCryptoBoringSSLShims_k1_affine point;
+    CCryptoBoringSSLShims_k1_fe rhs;
+    if (!CCryptoBoringSSLShims_k1_fe_from_bytes(&point.x, compressed + 1)) {
+        return 0;
+    }
+    CCryptoBoringSSLShims_k1_fe_sqr(&rhs, &point.x);
+    CCryptoBoringSSLShims_k1_fe_mul(&rhs, &rhs, &point.x);
+    CCryptoBoringSSLShims_k1_fe_add(&rhs, &rhs, &seven);
+    CCryptoBoringSSLShims_k1_fe_pow(&point.y, &rhs, kSqrtExponent);
+    if ((point.y.v[0] & 1) != (compressed[0] & 1)) {
+        CCryptoBoringSSLShims_k1_fe_neg(&point.y, &point.y);
+    }
+    if (!CCryptoBoringSSLShims_k1_is_on_curve(&point)) {
+        return 0;
+    }
+    CCryptoBoringSSLShims_k1_fe_to_bytes(out_public_key, &point.x);
+    CCryptoBoringSSLShims_k1_fe_to_bytes((uint8_t *)out_public_key + 32, &point.y);
+    return 1;
+#else
+    const EC_GROUP *group = CCryptoBoringSSLShims_secp256k1_group();
+    EC_POINT *point = group == NULL ? NULL : CCryptoBoringSSL_EC_POINT_new(group);
+    uint8_t uncompressed[65];
+    int ok = point != NULL &&
+             CCryptoBoringSSL_EC_POINT_oct2point(group, point, compressed, 33, NULL) &&
+             CCryptoBoringSSL_EC_POINT_point2oct(group, point, POINT_CONVERSION_UNCOMPRESSED, uncompressed,
+                                                 sizeof(uncompressed), NULL) == sizeof(uncompressed);
+    if (ok) {
+        memcpy(out_public_key, uncompressed + 1, 64);
+    }
+    CCryptoBoringSSL_EC_POINT_free(point);
+    (void)kSqrtExponent;
+    return ok;
+#endif
+}
+
+int CCryptoBoringSSLShims_ECDSA_raw_signature_to_der(void *out, size_t *out_len, size_t max_out,
+                                                     const void *signature, size_t signature_len) {
+    ECDSA_SIG *sig = CCryptoBoringSSL_ECDSA_SIG_new();
+    uint8_t *der = NULL;
+    size_t der_len = 0;
+    size_t half = signature_len / 2;
+    int ok = sig != NULL && signature_len % 2 == 0 &&
+             CCryptoBoringSSL_BN_bin2bn(signature, half, sig->r) != NULL &&
+             CCryptoBoringSSL_BN_bin2bn((const uint8_t *)signature + half, half, sig->s) != NULL &&
+             CCryptoBoringSSL_ECDSA_SIG_to_bytes(&der, &der_len, sig) && der_len <= max_out;
+    if (ok) {
+        memcpy(out, der, der_len);
+        *out_len = der_len;
+    }
+    CCryptoBoringSSL_OPENSSL_free(der);
+    CCryptoBoringSSL_ECDSA_SIG_free(sig);
+    return ok;
+}
+
+int CCryptoBoringSSLShims_ECDSA_der_signature_to_raw(void *out, size_t scalar_len, const void *der,
+                                                     size_t der_len) {
+    ECDSA_SIG *sig = CCryptoBoringSSL_ECDSA_SIG_from_bytes(der, der_len);
+    int ok = sig != NULL &&
+             CCryptoBoringSSL_BN_bn2bin_padded(out, scalar_len, sig->r) &&
+             CCryptoBoringSSL_BN_bn2bin_padded((uint8_t *)out + scalar_len, scalar_len, sig->s);
+    CCryptoBoringSSL_ECDSA_SIG_free(sig);
+    if (sig == NULL) {
+        CCryptoBoringSSL_ERR_clear_error();
+    }
+    return ok;
+}
+
+// MARK:- Pinned trust anchors
+
+// A lookup through an X509_STORE writes to memory every thread shares: the
+// store's reference count and lock, the issuer's reference count, and the lock
+// that guards each certificate's cached extensions. A pinned set copies out, once,
+// everything X509_check_issued reads from an issuer, and holds no objects that
+// lookups take references to. A lookup then writes only to the certificate it
+// parsed itself.
+typedef struct {
+    uint8_t *subject;
+    size_t subject_len;
+    uint8_t *issuer;
+    size_t issuer_len;
+    uint8_t *key_id;
+    size_t key_id_len;
+    int has_key_id;
+    ASN1_INTEGER *serial;
+    int rejects_cert_sign;
+    uint8_t *der;
+    size_t der_len;
+} CCryptoBoringSSLShims_pinned_anchor;
+
+struct CCryptoBoringSSLShims_X509_pinned_anchors_st {
+    // Sorted by canonical subject, then DER.
+    CCryptoBoringSSLShims_pinned_anchor *anchors;
+    size_t count;
+};
+
+static void CCryptoBoringSSLShims_pinned_anchor_cleanup(CCryptoBoringSSLShims_pinned_anchor *anchor) {
+    CCryptoBoringSSL_OPENSSL_free(anchor->subject);
+    CCryptoBoringSSL_OPENSSL_free(anchor->issuer);
+    CCryptoBoringSSL_OPENSSL_free(anchor->key_id);
+    CCryptoBoringSSL_ASN1_INTEGER_free(anchor->serial);
+    CCryptoBoringSSL_OPENSSL_free(anchor->der);
+    OPENSSL_memset(anchor, 0, sizeof(*anchor));
+}
+
+// Copies the canonical encoding of `name`, which an empty name doesn't have.
+static int CCryptoBoringSSLShims_pinned_copy_name(X509_NAME *name, uint8_t **out, size_t *out_len) {
+    if (CCryptoBoringSSL_i2d_X509_NAME(name, NULL) < 0 || name->canon_enclen < 0) {
+        return 0;
+    }
+    *out_len = (size_t)name->canon_enclen;
+    *out = CCryptoBoringSSL_OPENSSL_memdup(name->canon_enc == NULL ? (const uint8_t *)"" : name->canon_enc,
+                                          *out_len == 0 ? 1 : *out_len);
+    return *out != NULL;
+}
+
+// Fills `anchor` from `x509`. Returns 0 on allocation failure, and -1 for a
+// certificate X509_check_issued would never accept as an issuer.
+static int CCryptoBoringSSLShims_pinned_anchor_init(CCryptoBoringSSLShims_pinned_anchor *anchor, X509 *x509) {
+    OPENSSL_memset(anchor, 0, sizeof(*anchor));
+    if (!CCryptoBoringSSL_x509v3_cache_extensions(x509)) {
+        CCryptoBoringSSL_ERR_clear_error();
+        return -1;
+    }
+    uint8_t *der = NULL;
+    int der_len = CCryptoBoringSSL_i2d_X509(x509, &der);
+    if (der_len <= 0) {
+        return 0;
+    }
+    anchor->der = der;
+    anchor->der_len = (size_t)der_len;
+    if (!CCryptoBoringSSLShims_pinned_copy_name(CCryptoBoringSSL_X509_get_subject_name(x509), &anchor->subject,
+                                                &anchor->subject_len) ||
+        !CCryptoBoringSSLShims_pinned_copy_name(CCryptoBoringSSL_X509_get_issuer_name(x509), &anchor->issuer,
+                                                &anchor->issuer_len) ||
+        (anchor->serial = CCryptoBoringSSL_ASN1_INTEGER_dup(CCryptoBoringSSL_X509_get0_serialNumber(x509))) == NULL) {
+        CCryptoBoringSSLShims_pinned_anchor_cleanup(anchor);
+        return 0;
+    }
+    if (x509->skid != NULL) {
+        anchor->has_key_id = 1;
+        anchor->key_id_len = (size_t)x509->skid->length;
+        anchor->key_id = CCryptoBoringSSL_OPENSSL_memdup(x509->skid->data, anchor->key_id_len == 0 ? 1 : anchor->key_id_len);
+        if (anchor->key_id == NULL) {
+            CCryptoBoringSSLShims_pinned_anchor_cleanup(anchor);
+            return 0;
+        }
+    }
+    // As ku_reject in X509_check_issued.
+    anchor->rejects_cert_sign = (x509->ex_flags & EXFLAG_KUSAGE) && !(x509->ex_kusage & X509v3_KU_KEY_CERT_SIGN);
+    return 1;
+}
+
+static int CCryptoBoringSSLShims_pinned_bytes_cmp(const uint8_t *a, size_t a_len, const uint8_t *b, size_t b_len) {
+    if (a_len != b_len) {
+        return a_len < b_len ? -1 : 1;
+    }
+    return a_len == 0 ? 0 : memcmp(a, b, a_len);
+}
+
+static int CCryptoBoringSSLShims_pinned_anchor_cmp(const void *a, const void *b) {
+    const CCryptoBoringSSLShims_pinned_anchor *lhs = a, *rhs = b;
+    int ret = CCryptoBoringSSLShims_pinned_bytes_cmp(lhs->subject, lhs->subject_len, rhs->subject, rhs->subject_len);
+    return ret != 0 ? ret : CCryptoBoringSSLShims_pinned_bytes_cmp(lhs->der, lhs->der_len, rhs->der, rhs->der_len);
+}
+
+void CCryptoBoringSSLShims_X509_pinned_anchors_free(CCryptoBoringSSLShims_X509_pinned_anchors *pinned) {
+    if (pinned == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < pinned->count; i++) {
+        CCryptoBoringSSLShims_pinned_anchor_cleanup(&pinned->anchors[i]);
+    }
+    CCryptoBoringSSL_OPENSSL_free(pinned->anchors);
+    CCryptoBoringSSL_OPENSSL_free(pinned);
+}
+
+// Adds `x509` to `anchors`, which has room. Returns 0 on allocation failure.
+static int CCryptoBoringSSLShims_pinned_add(CCryptoBoringSSLShims_pinned_anchor *anchors, size_t *count, X509 *x509) {
+    int ret = CCryptoBoringSSLShims_pinned_anchor_init(&anchors[*count], x509);
+    if (ret == 1) {
+        (*count)++;
+    }
+    return ret != 0;
+}
+
+CCryptoBoringSSLShims_X509_pinned_anchors *CCryptoBoringSSLShims_X509_STORE_pin_anchors(X509_STORE *store) {
+    CCryptoBoringSSLShims_X509_pinned_anchors *pinned = CCryptoBoringSSL_OPENSSL_zalloc(sizeof(*pinned));
+    if (pinned == NULL) {
+        return NULL;
+    }
+    CCryptoBoringSSLShims_directory_load_all(store);
+    CCryptoBoringSSLShims_snapshot *snapshot = CCryptoBoringSSLShims_X509_STORE_get_snapshot(store);
+    size_t snapshot_count = snapshot == NULL ? 0 : snapshot->count;
+
+    // The certificates parsed from the snapshot are in both places, and the
+    // repeats are dropped after sorting.
+    CCryptoBoringSSL_CRYPTO_MUTEX_lock_read(&store->objs_lock);
+    size_t capacity = sk_X509_OBJECT_num(store->objs) + snapshot_count;
+    pinned->anchors = CCryptoBoringSSL_OPENSSL_calloc(capacity == 0 ? 1 : capacity, sizeof(*pinned->anchors));
+    int ok = pinned->anchors != NULL;
+    for (size_t i = 0; ok && i < sk_X509_OBJECT_num(store->objs); i++) {
+        X509_OBJECT *object = sk_X509_OBJECT_value(store->objs, i);
+        if (object->type == X509_LU_X509) {
+            ok = CCryptoBoringSSLShims_pinned_add(pinned->anchors, &pinned->count, object->data.x509);
+        }
+    }
+    CCryptoBoringSSL_CRYPTO_MUTEX_unlock_read(&store->objs_lock);
+
+    for (size_t i = 0; ok && i < snapshot_count; i++) {
+        CCryptoBoringSSLShims_snapshot_record record = CCryptoBoringSSLShims_snapshot_entry(snapshot, i);
+        const uint8_t *der = record.der;
+        X509 *x509 = CCryptoBoringSSL_d2i_X509_AUX(NULL, &der, (long)record.der_len);
+        // As in the snapshot's lookup, a certificate that doesn't parse is left out.
+        if (x509 != NULL && der == record.der + record.der_len) {
+            ok = CCryptoBoringSSLShims_pinned_add(pinned->anchors, &pinned->count, x509);
+        }
+        CCryptoBoringSSL_X509_free(x509);
+    }
+    CCryptoBoringSSL_ERR_clear_error();
+    if (!ok) {
+        CCryptoBoringSSLShims_X509_pinned_anchors_free(pinned);
+        return NULL;
+    }
+
+    qsort(pinned->anchors, pinned->count, sizeof(*pinned->anchors), CCryptoBoringSSLShims_pinned_anchor_cmp);
+    size_t unique = 0;
+    for (size_t i = 0; i < pinned->count; i++) {
+        if (unique > 0 && CCryptoBoringSSLShims_pinned_anchor_cmp(&pinned->anchors[unique - 1], &pinned->anchors[i]) == 0) {
+            CCryptoBoringSSLShims_pinned_anchor_cleanup(&pinned->anchors[i]);
+            continue;
+        }
+        pinned->anchors[unique++] = pinned->anchors[i];
+    }
+    pinned->count = unique;
+    return pinned;
+}
+
+size_t CCryptoBoringSSLShims_X509_pinned_anchors_count(const CCryptoBoringSSLShims_X509_pinned_anchors *pinned) {
+    return pinned->count;
+}
+
+// X509_check_issued(anchor, subject) == X509_V_OK, from the copied fields.
+// `subject` has had its extensions cached and its issuer name encoded.
+static int CCryptoBoringSSLShims_pinned_anchor_issued(const CCryptoBoringSSLShims_pinned_anchor *anchor, X509 *subject) {
+    const AUTHORITY_KEYID *akid = subject->akid;
+    if (akid != NULL) {
+        if (akid->keyid != NULL && anchor->has_key_id &&
+            CCryptoBoringSSLShims_pinned_bytes_cmp(akid->keyid->data, (size_t)akid->keyid->length, anchor->key_id,
+                                                   anchor->key_id_len) != 0) {
+            return 0;
+        }
+        if (akid->serial != NULL && CCryptoBoringSSL_ASN1_INTEGER_cmp(anchor->serial, akid->serial) != 0) {
+            return 0;
+        }
+        if (akid->issuer != NULL) {
+            // Only the first directory name counts, as in X509_check_akid.
+            for (size_t i = 0; i < sk_GENERAL_NAME_num(akid->issuer); i++) {
+                GENERAL_NAME *gen = sk_GENERAL_NAME_value(akid->issuer, i);
+                if (gen->type != GEN_DIRNAME) {
+                    continue;
+                }
+                X509_NAME *name = gen->d.dirn;
+                if (CCryptoBoringSSL_i2d_X509_NAME(name, NULL) < 0 || name->canon_enclen < 0 ||
+                    CCryptoBoringSSLShims_pinned_bytes_cmp(name->canon_enc, (size_t)name->canon_enclen, anchor->issuer,
+                                                           anchor->issuer_len) != 0) {
+                    return 0;
+                }
+                break;
+            }
+        }
+    }
+    return !anchor->rejects_cert_sign;
+}
+
+int CCryptoBoringSSLShims_X509_pinned_anchors_find_issuer(const CCryptoBoringSSLShims_X509_pinned_anchors *pinned,
+                                                          const uint8_t *der, size_t der_len, uint8_t **out_der,
+                                                          size_t *out_der_len) {
+    *out_der = NULL;
+    *out_der_len = 0;
+    const uint8_t *inp = der;
+    X509 *x509 = der_len <= LONG_MAX ? CCryptoBoringSSL_d2i_X509(NULL, &inp, (long)der_len) : NULL;
+    if (x509 == NULL || inp != der + der_len) {
+        CCryptoBoringSSL_X509_free(x509);
+        CCryptoBoringSSL_ERR_clear_error();
+        return -1;
+    }
+    X509_NAME *name = CCryptoBoringSSL_X509_get_issuer_name(x509);
+    int ret = 0;
+    if (CCryptoBoringSSL_x509v3_cache_extensions(x509) && CCryptoBoringSSL_i2d_X509_NAME(name, NULL) >= 0 &&
+        name->canon_enclen >= 0) {
+        size_t name_len = (size_t)name->canon_enclen;
+        size_t lo = 0, hi = pinned->count;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            const CCryptoBoringSSLShims_pinned_anchor *anchor = &pinned->anchors[mid];
+            if (CCryptoBoringSSLShims_pinned_bytes_cmp(anchor->subject, anchor->subject_len, name->canon_enc, name_len) < 0) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        // As in X509_STORE_CTX_get1_issuer, the first with the subject that
+        // passes the checks is the issuer.
+        for (size_t i = lo; ret == 0 && i < pinned->count; i++) {
+            const CCryptoBoringSSLShims_pinned_anchor *anchor = &pinned->anchors[i];
+            if (CCryptoBoringSSLShims_pinned_bytes_cmp(anchor->subject, anchor->subject_len, name->canon_enc, name_len) != 0) {
+                break;
+            }
+            if (CCryptoBoringSSLShims_pinned_anchor_issued(anchor, x509)) {
+                *out_der = CCryptoBoringSSL_OPENSSL_memdup(anchor->der, anchor->der_len);
+                *out_der_len = anchor->der_len;
+                ret = *out_der != NULL ? 1 : -1;
+            }
+        }
+    }
+    CCryptoBoringSSL_X509_free(x509);
+    CCryptoBoringSSL_ERR_clear_error();
+    return ret;
+}
+
+// MARK:- Ristretto255
+
+// The prime-order group ristretto255 of RFC 9496, built on the Edwards25519
+// arithmetic of curve25519.c. A point is kept as a |ge_p3| representative of
+// its class, so that group operations are the vendored ones, and the RFC's
+// encoding, decoding and Elligator map run on the fiat field arithmetic that
+// curve25519.c uses, whose own helpers are static.
+//
+// Encoding needs an inverse square root, which can't be shared. The encodings
+// of doubled points can instead be computed with one inversion, after
+// curve25519-dalek's double_and_compress_batch, and a batch that multiplies
+// by a scalar multiplies by half of it and then encodes the doubles.
+#if defined(BORINGSSL_HAS_UINT128)
+// curve25519_64.h is included above, for the interleaved X25519 ladder.
+#elif defined(OPENSSL_64_BIT)
+#include "../CCryptoBoringSSL/third_party/fiat/curve25519_64_msvc.h"
+#else
+#include "../CCryptoBoringSSL/third_party/fiat/curve25519_32.h"
+#endif
+
+static_assert(sizeof(ge_p3) == CCryptoBoringSSLShims_RISTRETTO255_POINT_BYTES,
+              "CCryptoBoringSSLShims_RISTRETTO255_POINT_BYTES is not the size of ge_p3");
+
+static const uint8_t kCCryptoBoringSSLShimsRistretto255SqrtM1[32] = {
+    0xb0, 0xa0, 0x0e, 0x4a, 0x27, 0x1b, 0xee, 0xc4, 0x78, 0xe4, 0x2f, 0xad,
+    0x06, 0x18, 0x43, 0x2f, 0xa7, 0xd7, 0xfb, 0x3d, 0x99, 0x00, 0x4d, 0x2b,
+    0x0b, 0xdf, 0xc1, 0x4f, 0x80, 0x24, 0x83, 0x2b,
+};
+static const uint8_t kCCryptoBoringSSLShimsRistretto255D[32] = {
+    0xa3, 0x78, 0x59, 0x13, 0xca, 0x4d, 0xeb, 0x75, 0xab, 0xd8, 0x41, 0x41,
+    0x4d, 0x0a, 0x70, 0x00, 0x98, 0xe8, 0x79, 0x77, 0x79, 0x40, 0xc7, 0x8c,
+    0x73, 0xfe, 0x6f, 0x2b, 0xee, 0x6c, 0x03, 0x52,
+};
+static const uint8_t kCCryptoBoringSSLShimsRistretto255InvSqrtAMinusD[32] = {
+    0xea, 0x40, 0x5d, 0x80, 0xaa, 0xfd, 0xc8, 0x99, 0xbe, 0x72, 0x41, 0x5a,
+    0x17, 0x16, 0x2f, 0x9d, 0x40, 0xd8, 0x01, 0xfe, 0x91, 0x7b, 0xc2, 0x16,
+    0xa2, 0xfc, 0xaf, 0xcf, 0x05, 0x89, 0x6c, 0x78,
+};
+static const uint8_t kCCryptoBoringSSLShimsRistretto255SqrtADMinusOne[32] = {
+    0x1b, 0x2e, 0x7b, 0x49, 0xa0, 0xf6, 0x97, 0x7e, 0xbd, 0x54, 0x78, 0x1b,
+    0x0c, 0x8e, 0x9d, 0xaf, 0xfd, 0xd1, 0xf5, 0x31, 0xc9, 0xfc, 0x3c, 0x0f,
+    0xac, 0x48, 0x83, 0x2b, 0xbf, 0x31, 0x69, 0x37,
+};
+static const uint8_t kCCryptoBoringSSLShimsRistretto255OneMinusDSq[32] = {
+    0x76, 0xc1, 0x5f, 0x94, 0xc1, 0x09, 0x7c, 0xe2, 0x0f, 0x35, 0x5e, 0xcd,
+    0x38, 0xa1, 0x81, 0x2c, 0xe4, 0xdf, 0x70, 0xbe, 0xdd, 0xab, 0x94, 0x99,
+    0xd7, 0xe0, 0xb3, 0xb2, 0xa8, 0x72, 0x90, 0x02,
+};
+static const uint8_t kCCryptoBoringSSLShimsRistretto255DMinusOneSq[32] = {
+    0x20, 0x4d, 0xed, 0x44, 0xaa, 0x5a, 0xad, 0x31, 0x99, 0x19, 0x1e, 0xb0,
+    0x2c, 0x4a, 0x9e, 0xd2, 0xeb, 0x4e, 0x9b, 0x52, 0x2f, 0xd3, 0xdc, 0x4c,
+    0x41, 0x22, 0x6c, 0xf6, 0x7a, 0xb3, 0x68, 0x59,
+};
+static const uint8_t kCCryptoBoringSSLShimsRistretto255Order[32] = {
+    0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7, 0xa2,
+    0xde, 0xf9, 0xde, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10,
+};
+static const uint8_t kCCryptoBoringSSLShimsRistretto255Half[32] = {
+    0xf7, 0xe9, 0x7a, 0x2e, 0x8d, 0x31, 0x09, 0x2c, 0x6b, 0xce, 0x7b, 0x51,
+    0xef, 0x7c, 0x6f, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08,
+};
+
+// The number of points whose doubles share one inversion when encoded.
+#define CCRYPTOBORINGSSLSHIMS_RISTRETTO255_CHUNK 64
+
+static void CCryptoBoringSSLShims_r255_fe_frombytes(fe *h, const uint8_t s[32]) {
+    uint8_t t[32];
+    OPENSSL_memcpy(t, s, 32);
+    t[31] &= 0x7f;
+    fiat_25519_from_bytes(h->v, t);
+}
+
+static void CCryptoBoringSSLShims_r255_fe_1(fe *h) {
+    static const uint8_t kOne[32] = {1};
+    fiat_25519_from_bytes(h->v, kOne);
+}
+
+static void CCryptoBoringSSLShims_r255_fe_mul(fe *h, const fe *f, const fe *g) {
+    fiat_25519_carry_mul(h->v, f->v, g->v);
+}
+
+static void CCryptoBoringSSLShims_r255_fe_mul_const(fe *h, const fe *f, const uint8_t c[32]) {
+    fe g;
+    fiat_25519_from_bytes(g.v, c);
+    fiat_25519_carry_mul(h->v, f->v, g.v);
+}
+
+static void CCryptoBoringSSLShims_r255_fe_sq(fe *h, const fe *f) {
+    fiat_25519_carry_square(h->v, f->v);
+}
+
+static void CCryptoBoringSSLShims_r255_fe_add(fe *h, const fe *f, const fe *g) {
+    fe_loose t;
+    fiat_25519_add(t.v, f->v, g->v);
+    fiat_25519_carry(h->v, t.v);
+}
+
+static void CCryptoBoringSSLShims_r255_fe_sub(fe *h, const fe *f, const fe *g) {
+    fe_loose t;
+    fiat_25519_sub(t.v, f->v, g->v);
+    fiat_25519_carry(h->v, t.v);
+}
+
+static void CCryptoBoringSSLShims_r255_fe_neg(fe *h, const fe *f) {
+    fe_loose t;
+    fiat_25519_opp(t.v, f->v);
+    fiat_25519_carry(h->v, t.v);
+}
+
+// Sets |f| to |g| if |b| is one, and leaves it alone if it is zero.
+static void CCryptoBoringSSLShims_r255_fe_cmov(fe *f, const fe *g, crypto_word_t b) {
+    fe t;
+    fiat_25519_selectznz(t.v, (fiat_25519_uint1)b, f->v, g->v);
+    *f = t;
+}
+
+static crypto_word_t CCryptoBoringSSLShims_r255_fe_isnegative(const fe *f) {
+    uint8_t s[32];
+    fiat_25519_to_bytes(s, f->v);
+    return s[0] & 1;
+}
+
+static crypto_word_t CCryptoBoringSSLShims_r255_fe_iszero(const fe *f) {
+    static const uint8_t kZero[32] = {0};
+    uint8_t s[32];
+    fiat_25519_to_bytes(s, f->v);
+    return constant_time_is_zero_w((crypto_word_t)CRYPTO_memcmp(s, kZero, 32)) & 1;
+}
+
+static crypto_word_t CCryptoBoringSSLShims_r255_fe_equal(const fe *f, const fe *g) {
+    fe t;
+    CCryptoBoringSSLShims_r255_fe_sub(&t, f, g);
+    return CCryptoBoringSSLShims_r255_fe_iszero(&t);
+}
+
+static void CCryptoBoringSSLShims_r255_fe_abs(fe *h, const fe *f) {
+    fe negated;
+    CCryptoBoringSSLShims_r255_fe_neg(&negated, f);
+    *h = *f;
+    CCryptoBoringSSLShims_r255_fe_cmov(h, &negated, CCryptoBoringSSLShims_r255_fe_isnegative(f));
+}
+
+static void CCryptoBoringSSLShims_r255_fe_sqn(fe *h, const fe *f, int n) {
+    CCryptoBoringSSLShims_r255_fe_sq(h, f);
+    for (int i = 1; i < n; i++) {
+        CCryptoBoringSSLShims_r255_fe_sq(h, h);
+    }
+}
+
+// z^(2^252 - 3), with the addition chain of curve25519.c's fe_pow22523.
+static void CCryptoBoringSSLShims_r255_fe_pow22523(fe *out, const fe *z) {
+    fe t0, t1, t2;
+    CCryptoBoringSSLShims_r255_fe_sq(&t0, z);
+    CCryptoBoringSSLShims_r255_fe_sqn(&t1, &t0, 2);
+    CCryptoBoringSSLShims_r255_fe_mul(&t1, z, &t1);
+    CCryptoBoringSSLShims_r255_fe_mul(&t0, &t0, &t1);
+    CCryptoBoringSSLShims_r255_fe_sq(&t0, &t0);
+    CCryptoBoringSSLShims_r255_fe_mul(&t0, &t1, &t0);
+    CCryptoBoringSSLShims_r255_fe_sqn(&t1, &t0, 5);
+    CCryptoBoringSSLShims_r255_fe_mul(&t0, &t1, &t0);
+    CCryptoBoringSSLShims_r255_fe_sqn(&t1, &t0, 10);
+    CCryptoBoringSSLShims_r255_fe_mul(&t1, &t1, &t0);
+    CCryptoBoringSSLShims_r255_fe_sqn(&t2, &t1, 20);
+    CCryptoBoringSSLShims_r255_fe_mul(&t1, &t2, &t1);
+    CCryptoBoringSSLShims_r255_fe_sqn(&t1, &t1, 10);
+    CCryptoBoringSSLShims_r255_fe_mul(&t0, &t1, &t0);
+    CCryptoBoringSSLShims_r255_fe_sqn(&t1, &t0, 50);
+    CCryptoBoringSSLShims_r255_fe_mul(&t1, &t1, &t0);
+    CCryptoBoringSSLShims_r255_fe_sqn(&t2, &t1, 100);
+    CCryptoBoringSSLShims_r255_fe_mul(&t1, &t2, &t1);
+    CCryptoBoringSSLShims_r255_fe_sqn(&t1, &t1, 50);
+    CCryptoBoringSSLShims_r255_fe_mul(&t0, &t1, &t0);
+    CCryptoBoringSSLShims_r255_fe_sqn(&t0, &t0, 2);
+    CCryptoBoringSSLShims_r255_fe_mul(out, &t0, z);
+}
+
+// z^(p - 2), which is zero for zero: z^(2^252 - 3)^8 · z^3.
+static void CCryptoBoringSSLShims_r255_fe_invert(fe *out, const fe *z) {
+    fe t, z3;
+    CCryptoBoringSSLShims_r255_fe_pow22523(&t, z);
+    CCryptoBoringSSLShims_r255_fe_sqn(&t, &t, 3);
+    CCryptoBoringSSLShims_r255_fe_sq(&z3, z);
+    CCryptoBoringSSLShims_r255_fe_mul(&z3, &z3, z);
+    CCryptoBoringSSLShims_r255_fe_mul(out, &t, &z3);
+}
+
+// SQRT_RATIO_M1 of RFC 9496, section 4.2: sets |out| to the non-negative
+// square root of u/v, or of i·u/v if u/v is not a square, and returns whether
+// u/v was a square.
+static crypto_word_t CCryptoBoringSSLShims_r255_sqrt_ratio_m1(fe *out, const fe *u, const fe *v) {
+    fe v3, v7, r, check, t, neg_u, neg_u_i;
+    CCryptoBoringSSLShims_r255_fe_sq(&v3, v);
+    CCryptoBoringSSLShims_r255_fe_mul(&v3, &v3, v);
+    CCryptoBoringSSLShims_r255_fe_sq(&v7, &v3);
+    CCryptoBoringSSLShims_r255_fe_mul(&v7, &v7, v);
+    CCryptoBoringSSLShims_r255_fe_mul(&t, u, &v7);
+    CCryptoBoringSSLShims_r255_fe_pow22523(&t, &t);
+    CCryptoBoringSSLShims_r255_fe_mul(&r, u, &v3);
+    CCryptoBoringSSLShims_r255_fe_mul(&r, &r, &t);
+
+    CCryptoBoringSSLShims_r255_fe_sq(&check, &r);
+    CCryptoBoringSSLShims_r255_fe_mul(&check, &check, v);
+    CCryptoBoringSSLShims_r255_fe_neg(&neg_u, u);
+    CCryptoBoringSSLShims_r255_fe_mul_const(&neg_u_i, &neg_u, kCCryptoBoringSSLShimsRistretto255SqrtM1);
+    const crypto_word_t correct_sign = CCryptoBoringSSLShims_r255_fe_equal(&check, u);
+    const crypto_word_t flipped_sign = CCryptoBoringSSLShims_r255_fe_equal(&check, &neg_u);
+    const crypto_word_t flipped_sign_i = CCryptoBoringSSLShims_r255_fe_equal(&check, &neg_u_i);
+
+    CCryptoBoringSSLShims_r255_fe_mul_const(&t, &r, kCCryptoBoringSSLShimsRistretto255SqrtM1);
+    CCryptoBoringSSLShims_r255_fe_cmov(&r, &t, flipped_sign | flipped_sign_i);
+    CCryptoBoringSSLShims_r255_fe_abs(out, &r);
+    return correct_sign | flipped_sign;
+}
+
+static void CCryptoBoringSSLShims_r255_load(ge_p3 *p, const void *in) {
+    OPENSSL_memcpy(p, in, sizeof(*p));
+}
+
+static void CCryptoBoringSSLShims_r255_store(void *out, const ge_p3 *p) {
+    OPENSSL_memcpy(out, p, sizeof(*p));
+}
+
+static void CCryptoBoringSSLShims_r255_identity(ge_p3 *p) {
+    static const uint8_t kZero[32] = {0};
+    fiat_25519_from_bytes(p->X.v, kZero);
+    CCryptoBoringSSLShims_r255_fe_1(&p->Y);
+    CCryptoBoringSSLShims_r255_fe_1(&p->Z);
+    fiat_25519_from_bytes(p->T.v, kZero);
+}
+
+static void CCryptoBoringSSLShims_r255_add(ge_p3 *r, const ge_p3 *p, const ge_p3 *q) {
+    ge_cached cached;
+    ge_p1p1 sum;
+    CCryptoBoringSSL_x25519_ge_p3_to_cached(&cached, q);
+    CCryptoBoringSSL_x25519_ge_add(&sum, p, &cached);
+    CCryptoBoringSSL_x25519_ge_p1p1_to_p3(r, &sum);
+}
+
+// Extends a projective point (X : Y : Z) to (XZ : YZ : Z² : XY).
+static void CCryptoBoringSSLShims_r255_p2_to_p3(ge_p3 *r, const ge_p2 *p) {
+    CCryptoBoringSSLShims_r255_fe_mul(&r->X, &p->X, &p->Z);
+    CCryptoBoringSSLShims_r255_fe_mul(&r->Y, &p->Y, &p->Z);
+    CCryptoBoringSSLShims_r255_fe_sq(&r->Z, &p->Z);
+    CCryptoBoringSSLShims_r255_fe_mul(&r->T, &p->X, &p->Y);
+}
+
+// ENCODE of RFC 9496, section 4.3.2.
+static void CCryptoBoringSSLShims_r255_encode(uint8_t out[32], const ge_p3 *p) {
+    fe u1, u2, t, invsqrt, den1, den2, z_inv, ix0, iy0, enchanted, x, y, den_inv, s;
+    CCryptoBoringSSLShims_r255_fe_add(&t, &p->Z, &p->Y);
+    CCryptoBoringSSLShims_r255_fe_sub(&u1, &p->Z, &p->Y);
+    CCryptoBoringSSLShims_r255_fe_mul(&u1, &t, &u1);
+    CCryptoBoringSSLShims_r255_fe_mul(&u2, &p->X, &p->Y);
+
+    fe one;
+    CCryptoBoringSSLShims_r255_fe_1(&one);
+    CCryptoBoringSSLShims_r255_fe_sq(&t, &u2);
+    CCryptoBoringSSLShims_r255_fe_mul(&t, &t, &u1);
+    (void)CCryptoBoringSSLShims_r255_sqrt_ratio_m1(&invsqrt, &one, &t);
+
+    CCryptoBoringSSLShims_r255_fe_mul(&den1, &invsqrt, &u1);
+    CCryptoBoringSSLShims_r255_fe_mul(&den2, &invsqrt, &u2);
+    CCryptoBoringSSLShims_r255_fe_mul(&z_inv, &den1, &den2);
+    CCryptoBoringSSLShims_r255_fe_mul(&z_inv, &z_inv, &p->T);
+    CCryptoBoringSSLShims_r255_fe_mul_const(&ix0, &p->X, kCCryptoBoringSSLShimsRistretto255SqrtM1);
+    CCryptoBoringSSLShims_r255_fe_mul_const(&iy0, &p->Y, kCCryptoBoringSSLShimsRistretto255SqrtM1);
+    CCryptoBoringSSLShims_r255_fe_mul_const(&enchanted, &den1, kCCryptoBoringSSLShimsRistretto255InvSqrtAMinusD);
+
+    CCryptoBoringSSLShims_r255_fe_mul(&t, &p->T, &z_inv);
+    const crypto_word_t rotate = CCryptoBoringSSLShims_r255_fe_isnegative(&t);
+    x = p->X;
+    y = p->Y;
+    den_inv = den2;
+    CCryptoBoringSSLShims_r255_fe_cmov(&x, &iy0, rotate);
+    CCryptoBoringSSLShims_r255_fe_cmov(&y, &ix0, rotate);
+    CCryptoBoringSSLShims_r255_fe_cmov(&den_inv, &enchanted, rotate);
+
+    CCryptoBoringSSLShims_r255_fe_mul(&t, &x, &z_inv);
+    CCryptoBoringSSLShims_r255_fe_neg(&s, &y);
+    CCryptoBoringSSLShims_r255_fe_cmov(&y, &s, CCryptoBoringSSLShims_r255_fe_isnegative(&t));
+
+    CCryptoBoringSSLShims_r255_fe_sub(&s, &p->Z, &y);
+    CCryptoBoringSSLShims_r255_fe_mul(&s, &den_inv, &s);
+    CCryptoBoringSSLShims_r255_fe_abs(&s, &s);
+    fiat_25519_to_bytes(out, s.v);
+}
+
+// DECODE of RFC 9496, section 4.3.1. Encodings are public, so this returns
+// early for non-canonical ones.
+static int CCryptoBoringSSLShims_r255_decode(ge_p3 *p, const uint8_t in[32]) {
+    fe s;
+    uint8_t canonical[32];
+    CCryptoBoringSSLShims_r255_fe_frombytes(&s, in);
+    fiat_25519_to_bytes(canonical, s.v);
+    if (CRYPTO_memcmp(canonical, in, 32) != 0 || CCryptoBoringSSLShims_r255_fe_isnegative(&s)) {
+        return 0;
+    }
+
+    fe one, ss, u1, u2, u2_sqr, v, t, invsqrt, den_x, den_y;
+    CCryptoBoringSSLShims_r255_fe_1(&one);
+    CCryptoBoringSSLShims_r255_fe_sq(&ss, &s);
+    CCryptoBoringSSLShims_r255_fe_sub(&u1, &one, &ss);
+    CCryptoBoringSSLShims_r255_fe_add(&u2, &one, &ss);
+    CCryptoBoringSSLShims_r255_fe_sq(&u2_sqr, &u2);
+
+    // v = -(D · u1²) - u2²
+    CCryptoBoringSSLShims_r255_fe_sq(&t, &u1);
+    CCryptoBoringSSLShims_r255_fe_mul_const(&t, &t, kCCryptoBoringSSLShimsRistretto255D);
+    CCryptoBoringSSLShims_r255_fe_neg(&t, &t);
+    CCryptoBoringSSLShims_r255_fe_sub(&v, &t, &u2_sqr);
+
+    CCryptoBoringSSLShims_r255_fe_mul(&t, &v, &u2_sqr);
+    const crypto_word_t was_square = CCryptoBoringSSLShims_r255_sqrt_ratio_m1(&invsqrt, &one, &t);
+    CCryptoBoringSSLShims_r255_fe_mul(&den_x, &invsqrt, &u2);
+    CCryptoBoringSSLShims_r255_fe_mul(&den_y, &invsqrt, &den_x);
+    CCryptoBoringSSLShims_r255_fe_mul(&den_y, &den_y, &v);
+
+    CCryptoBoringSSLShims_r255_fe_add(&t, &s, &s);
+    CCryptoBoringSSLShims_r255_fe_mul(&t, &t, &den_x);
+    CCryptoBoringSSLShims_r255_fe_abs(&p->X, &t);
+    CCryptoBoringSSLShims_r255_fe_mul(&p->Y, &u1, &den_y);
+    CCryptoBoringSSLShims_r255_fe_1(&p->Z);
+    CCryptoBoringSSLShims_r255_fe_mul(&p->T, &p->X, &p->Y);
+
+    return was_square && !CCryptoBoringSSLShims_r255_fe_isnegative(&p->T) &&
+           !CCryptoBoringSSLShims_r255_fe_iszero(&p->Y);
+}
+
+// MAP of RFC 9496, section 4.3.4: the Elligator map of a field element to a
+// point.
+static void CCryptoBoringSSLShims_r255_map(ge_p3 *p, const fe *t) {
+    fe one, r, u, v, s, s_prime, c, n, w0, w1, w2, w3, tmp;
+    CCryptoBoringSSLShims_r255_fe_1(&one);
+    CCryptoBoringSSLShims_r255_fe_sq(&r, t);
+    CCryptoBoringSSLShims_r255_fe_mul_const(&r, &r, kCCryptoBoringSSLShimsRistretto255SqrtM1);
+
+    CCryptoBoringSSLShims_r255_fe_add(&u, &r, &one);
+    CCryptoBoringSSLShims_r255_fe_mul_const(&u, &u, kCCryptoBoringSSLShimsRistretto255OneMinusDSq);
+
+    // v = (-1 - r · D) · (r + D)
+    fe d;
+    fiat_25519_from_bytes(d.v, kCCryptoBoringSSLShimsRistretto255D);
+    CCryptoBoringSSLShims_r255_fe_mul(&tmp, &r, &d);
+    CCryptoBoringSSLShims_r255_fe_add(&tmp, &tmp, &one);
+    CCryptoBoringSSLShims_r255_fe_neg(&tmp, &tmp);
+    CCryptoBoringSSLShims_r255_fe_add(&v, &r, &d);
+    CCryptoBoringSSLShims_r255_fe_mul(&v, &tmp, &v);
+
+    const crypto_word_t was_square = CCryptoBoringSSLShims_r255_sqrt_ratio_m1(&s, &u, &v);
+    CCryptoBoringSSLShims_r255_fe_mul(&s_prime, &s, t);
+    CCryptoBoringSSLShims_r255_fe_abs(&s_prime, &s_prime);
+    CCryptoBoringSSLShims_r255_fe_neg(&s_prime, &s_prime);
+    CCryptoBoringSSLShims_r255_fe_cmov(&s, &s_prime, was_square ^ 1);
+    CCryptoBoringSSLShims_r255_fe_neg(&c, &one);
+    CCryptoBoringSSLShims_r255_fe_cmov(&c, &r, was_square ^ 1);
+
+    // N = c · (r - 1) · D_MINUS_ONE_SQ - v
+    CCryptoBoringSSLShims_r255_fe_sub(&tmp, &r, &one);
+    CCryptoBoringSSLShims_r255_fe_mul(&n, &c, &tmp);
+    CCryptoBoringSSLShims_r255_fe_mul_const(&n, &n, kCCryptoBoringSSLShimsRistretto255DMinusOneSq);
+    CCryptoBoringSSLShims_r255_fe_sub(&n, &n, &v);
+
+    CCryptoBoringSSLShims_r255_fe_add(&w0, &s, &s);
+    CCryptoBoringSSLShims_r255_fe_mul(&w0, &w0, &v);
+    CCryptoBoringSSLShims_r255_fe_mul_const(&w1, &n, kCCryptoBoringSSLShimsRistretto255SqrtADMinusOne);
+    CCryptoBoringSSLShims_r255_fe_sq(&tmp, &s);
+    CCryptoBoringSSLShims_r255_fe_sub(&w2, &one, &tmp);
+    CCryptoBoringSSLShims_r255_fe_add(&w3, &one, &tmp);
+
+    CCryptoBoringSSLShims_r255_fe_mul(&p->X, &w0, &w3);
+    CCryptoBoringSSLShims_r255_fe_mul(&p->Y, &w2, &w1);
+    CCryptoBoringSSLShims_r255_fe_mul(&p->Z, &w1, &w3);
+    CCryptoBoringSSLShims_r255_fe_mul(&p->T, &w0, &w2);
+}
+
+static void CCryptoBoringSSLShims_r255_from_uniform_bytes(ge_p3 *p, const uint8_t in[64]) {
+    fe t;
+    ge_p3 q;
+    CCryptoBoringSSLShims_r255_fe_frombytes(&t, in);
+    CCryptoBoringSSLShims_r255_map(p, &t);
+    CCryptoBoringSSLShims_r255_fe_frombytes(&t, in + 32);
+    CCryptoBoringSSLShims_r255_map(&q, &t);
+    CCryptoBoringSSLShims_r255_add(p, p, &q);
+}
+
+// Writes the encodings of [2]points[i] for |count| points, at most CHUNK, with
+// one shared inversion.
+static void CCryptoBoringSSLShims_r255_encode_doubled_chunk(uint8_t *out, const ge_p3 *points, size_t count) {
+    fe e[CCRYPTOBORINGSSLSHIMS_RISTRETTO255_CHUNK], f[CCRYPTOBORINGSSLSHIMS_RISTRETTO255_CHUNK];
+    fe g[CCRYPTOBORINGSSLSHIMS_RISTRETTO255_CHUNK], h[CCRYPTOBORINGSSLSHIMS_RISTRETTO255_CHUNK];
+    fe eg[CCRYPTOBORINGSSLSHIMS_RISTRETTO255_CHUNK], fh[CCRYPTOBORINGSSLSHIMS_RISTRETTO255_CHUNK];
+    fe prefix[CCRYPTOBORINGSSLSHIMS_RISTRETTO255_CHUNK];
+    crypto_word_t is_zero[CCRYPTOBORINGSSLSHIMS_RISTRETTO255_CHUNK];
+    static const uint8_t kZero[32] = {0};
+    fe zero, one, sqrt_m1, acc, t;
+    fiat_25519_from_bytes(zero.v, kZero);
+    CCryptoBoringSSLShims_r255_fe_1(&one);
+    fiat_25519_from_bytes(sqrt_m1.v, kCCryptoBoringSSLShimsRistretto255SqrtM1);
+    acc = one;
+
+    for (size_t i = 0; i < count; i++) {
+        const ge_p3 *p = &points[i];
+        fe xx, yy, zz, dtt;
+        CCryptoBoringSSLShims_r255_fe_sq(&xx, &p->X);
+        CCryptoBoringSSLShims_r255_fe_sq(&yy, &p->Y);
+        CCryptoBoringSSLShims_r255_fe_sq(&zz, &p->Z);
+        CCryptoBoringSSLShims_r255_fe_sq(&dtt, &p->T);
+        CCryptoBoringSSLShims_r255_fe_mul_const(&dtt, &dtt, kCCryptoBoringSSLShimsRistretto255D);
+        CCryptoBoringSSLShims_r255_fe_add(&t, &p->Y, &p->Y);
+        CCryptoBoringSSLShims_r255_fe_mul(&e[i], &p->X, &t);
+        CCryptoBoringSSLShims_r255_fe_add(&f[i], &zz, &dtt);
+        CCryptoBoringSSLShims_r255_fe_add(&g[i], &yy, &xx);
+        CCryptoBoringSSLShims_r255_fe_sub(&h[i], &zz, &dtt);
+        CCryptoBoringSSLShims_r255_fe_mul(&eg[i], &e[i], &g[i]);
+        CCryptoBoringSSLShims_r255_fe_mul(&fh[i], &f[i], &h[i]);
+
+        // Points equivalent to the identity have a zero product, which would
+        // zero every inverse of the batch. Invert one in its place, and zero
+        // its inverse afterwards as inverting zero would.
+        CCryptoBoringSSLShims_r255_fe_mul(&t, &eg[i], &fh[i]);
+        is_zero[i] = CCryptoBoringSSLShims_r255_fe_iszero(&t);
+        CCryptoBoringSSLShims_r255_fe_cmov(&t, &one, is_zero[i]);
+        prefix[i] = acc;
+        CCryptoBoringSSLShims_r255_fe_mul(&acc, &acc, &t);
+    }
+
+    CCryptoBoringSSLShims_r255_fe_invert(&acc, &acc);
+
+    for (size_t i = count; i-- > 0;) {
+        fe inv, z_inv, t_inv, magic, minus_e, f_sqrt_a, s;
+        CCryptoBoringSSLShims_r255_fe_mul(&inv, &acc, &prefix[i]);
+        CCryptoBoringSSLShims_r255_fe_mul(&t, &eg[i], &fh[i]);
+        CCryptoBoringSSLShims_r255_fe_cmov(&t, &one, is_zero[i]);
+        CCryptoBoringSSLShims_r255_fe_mul(&acc, &acc, &t);
+        CCryptoBoringSSLShims_r255_fe_cmov(&inv, &zero, is_zero[i]);
+
+        CCryptoBoringSSLShims_r255_fe_mul(&z_inv, &eg[i], &inv);
+        CCryptoBoringSSLShims_r255_fe_mul(&t_inv, &fh[i], &inv);
+
+        fiat_25519_from_bytes(magic.v, kCCryptoBoringSSLShimsRistretto255InvSqrtAMinusD);
+        CCryptoBoringSSLShims_r255_fe_mul(&t, &eg[i], &z_inv);
+        const crypto_word_t rotate = CCryptoBoringSSLShims_r255_fe_isnegative(&t);
+        CCryptoBoringSSLShims_r255_fe_neg(&minus_e, &e[i]);
+        CCryptoBoringSSLShims_r255_fe_mul(&f_sqrt_a, &f[i], &sqrt_m1);
+        fe ei = e[i], gi = g[i], hi = h[i];
+        CCryptoBoringSSLShims_r255_fe_cmov(&ei, &g[i], rotate);
+        CCryptoBoringSSLShims_r255_fe_cmov(&gi, &minus_e, rotate);
+        CCryptoBoringSSLShims_r255_fe_cmov(&hi, &f_sqrt_a, rotate);
+        CCryptoBoringSSLShims_r255_fe_cmov(&magic, &sqrt_m1, rotate);
+
+        CCryptoBoringSSLShims_r255_fe_mul(&t, &hi, &ei);
+        CCryptoBoringSSLShims_r255_fe_mul(&t, &t, &z_inv);
+        CCryptoBoringSSLShims_r255_fe_neg(&s, &gi);
+        CCryptoBoringSSLShims_r255_fe_cmov(&gi, &s, CCryptoBoringSSLShims_r255_fe_isnegative(&t));
+
+        // s = (h - g) · magic · g · t_inv
+        CCryptoBoringSSLShims_r255_fe_mul(&t, &gi, &t_inv);
+        CCryptoBoringSSLShims_r255_fe_mul(&t, &magic, &t);
+        CCryptoBoringSSLShims_r255_fe_sub(&s, &hi, &gi);
+        CCryptoBoringSSLShims_r255_fe_mul(&s, &s, &t);
+        CCryptoBoringSSLShims_r255_fe_abs(&s, &s);
+        fiat_25519_to_bytes(out + 32 * i, s.v);
+    }
+}
+
+// Scalars are 32-byte little-endian integers modulo the group order l. Products
+// and sums are reduced with x25519_sc_reduce, which is constant-time.
+static void CCryptoBoringSSLShims_r255_sc_reduce_into(uint8_t out[32], uint8_t wide[64]) {
+    CCryptoBoringSSL_x25519_sc_reduce(wide);
+    OPENSSL_memcpy(out, wide, 32);
+    CCryptoBoringSSL_OPENSSL_cleanse(wide, 64);
+}
+
+static void CCryptoBoringSSLShims_r255_sc_mul(uint8_t out[32], const uint8_t a[32], const uint8_t b[32]) {
+    uint32_t x[8], y[8];
+    uint64_t product[16] = {0};
+    for (size_t i = 0; i < 8; i++) {
+        x[i] = CRYPTO_load_u32_le(a + 4 * i);
+        y[i] = CRYPTO_load_u32_le(b + 4 * i);
+    }
+    for (size_t i = 0; i < 8; i++) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < 8; j++) {
+            const uint64_t t = (uint64_t)x[i] * y[j] + product[i + j] + carry;
+            product[i + j] = (uint32_t)t;
+            carry = t >> 32;
+        }
+        product[i + 8] = carry;
+    }
+    uint8_t wide[64];
+    for (size_t i = 0; i < 16; i++) {
+        CRYPTO_store_u32_le(wide + 4 * i, (uint32_t)product[i]);
+    }
+    CCryptoBoringSSL_OPENSSL_cleanse(x, sizeof(x));
+    CCryptoBoringSSL_OPENSSL_cleanse(y, sizeof(y));
+    CCryptoBoringSSL_OPENSSL_cleanse(product, sizeof(product));
+    CCryptoBoringSSLShims_r255_sc_reduce_into(out, wide);
+}
+
+// The reduced a + b, for a and b below 2^255.
+static void CCryptoBoringSSLShims_r255_sc_add(uint8_t out[32], const uint8_t a[32], const uint8_t b[32]) {
+    uint8_t wide[64] = {0};
+    uint32_t carry = 0;
+    for (size_t i = 0; i < 32; i++) {
+        carry += (uint32_t)a[i] + b[i];
+        wide[i] = (uint8_t)carry;
+        carry >>= 8;
+    }
+    wide[32] = (uint8_t)carry;
+    CCryptoBoringSSLShims_r255_sc_reduce_into(out, wide);
+}
+
+static void CCryptoBoringSSLShims_r255_sc_neg(uint8_t out[32], const uint8_t a[32]) {
+    // l - a lies in [1, l] for a reduced |a|, and reducing maps l to zero.
+    uint8_t wide[64] = {0};
+    int32_t borrow = 0;
+    for (size_t i = 0; i < 32; i++) {
+        const int32_t t = (int32_t)kCCryptoBoringSSLShimsRistretto255Order[i] - a[i] - borrow;
+        wide[i] = (uint8_t)t;
+        borrow = (t >> 8) & 1;
+    }
+    CCryptoBoringSSLShims_r255_sc_reduce_into(out, wide);
+}
+
+static crypto_word_t CCryptoBoringSSLShims_r255_sc_is_canonical(const uint8_t a[32]) {
+    // a < l exactly when a - l borrows.
+    int32_t borrow = 0;
+    for (size_t i = 0; i < 32; i++) {
+        const int32_t t = (int32_t)a[i] - kCCryptoBoringSSLShimsRistretto255Order[i] - borrow;
+        borrow = (t >> 8) & 1;
+    }
+    return (crypto_word_t)borrow;
+}
+
+#define CCRYPTOBORINGSSLSHIMS_RISTRETTO255_MSM_MAX_WINDOW 12
+
+// The signed digits of a reduced scalar in windows of |c| bits, each in
+// [-2^(c-1), 2^(c-1)).
+static void CCryptoBoringSSLShims_r255_msm_recode(int16_t *digits, size_t num_windows, const uint8_t scalar[32],
+                                                  int c) {
+    int carry = 0;
+    for (size_t w = 0; w < num_windows; w++) {
+        int value = 0;
+        for (int b = 0; b < c; b++) {
+            const size_t bit = w * c + b;
+            if (bit < 256) {
+                value |= ((scalar[bit >> 3] >> (bit & 7)) & 1) << b;
+            }
+        }
+        value += carry;
+        carry = value >= (1 << (c - 1));
+        digits[w] = (int16_t)(value - (carry << c));
+    }
+}
+
+// The window that minimises the point additions: one per point and two per
+// bucket in each window.
+static int CCryptoBoringSSLShims_r255_msm_window_bits(size_t count) {
+    int best = 1;
+    double best_cost = 0;
+    for (int c = 1; c <= CCRYPTOBORINGSSLSHIMS_RISTRETTO255_MSM_MAX_WINDOW; c++) {
+        const double cost = (double)((256 + c - 1) / c) * ((double)count + 2 * (double)((size_t)1 << (c - 1)));
+        if (c == 1 || cost < best_cost) {
+            best = c;
+            best_cost = cost;
+        }
+    }
+    return best;
+}
+
+int CCryptoBoringSSLShims_ristretto255_decode(void *out_point, const void *in) {
+    ge_p3 p;
+    if (!CCryptoBoringSSLShims_r255_decode(&p, in)) {
+        return 0;
+    }
+    CCryptoBoringSSLShims_r255_store(out_point, &p);
+    return 1;
+}
+
+void CCryptoBoringSSLShims_ristretto255_encode(void *out, const void *point) {
+    ge_p3 p;
+    CCryptoBoringSSLShims_r255_load(&p, point);
+    CCryptoBoringSSLShims_r255_encode(out, &p);
+}
+
+int CCryptoBoringSSLShims_ristretto255_equal(const void *a, const void *b) {
+    // EQUALS of RFC 9496, section 4.3.3.
+    ge_p3 p, q;
+    fe l, r;
+    CCryptoBoringSSLShims_r255_load(&p, a);
+    CCryptoBoringSSLShims_r255_load(&q, b);
+    CCryptoBoringSSLShims_r255_fe_mul(&l, &p.X, &q.Y);
+    CCryptoBoringSSLShims_r255_fe_mul(&r, &p.Y, &q.X);
+    const crypto_word_t same_x_y = CCryptoBoringSSLShims_r255_fe_equal(&l, &r);
+    CCryptoBoringSSLShims_r255_fe_mul(&l, &p.Y, &q.Y);
+    CCryptoBoringSSLShims_r255_fe_mul(&r, &p.X, &q.X);
+    return (int)(same_x_y | CCryptoBoringSSLShims_r255_fe_equal(&l, &r));
+}
+
+void CCryptoBoringSSLShims_ristretto255_identity(void *out_point) {
+    ge_p3 p;
+    CCryptoBoringSSLShims_r255_identity(&p);
+    CCryptoBoringSSLShims_r255_store(out_point, &p);
+}
+
+void CCryptoBoringSSLShims_ristretto255_from_uniform_bytes(void *out_point, const void *in) {
+    ge_p3 p;
+    CCryptoBoringSSLShims_r255_from_uniform_bytes(&p, in);
+    CCryptoBoringSSLShims_r255_store(out_point, &p);
+}
+
+int CCryptoBoringSSLShims_ristretto255_hash_to_group(void *out_point, const void *msg, size_t msg_len,
+                                                     const void *dst, size_t dst_len) {
+    uint8_t uniform[64];
+    if (!CCryptoBoringSSLShims_h2c_expand_message_xmd(CCryptoBoringSSL_EVP_sha512(), uniform, sizeof(uniform), msg,
+                                                      msg_len, dst, dst_len)) {
+        return 0;
+    }
+    CCryptoBoringSSLShims_ristretto255_from_uniform_bytes(out_point, uniform);
+    return 1;
+}
+
+void CCryptoBoringSSLShims_ristretto255_add(void *out_point, const void *a, const void *b) {
+    ge_p3 p, q;
+    CCryptoBoringSSLShims_r255_load(&p, a);
+    CCryptoBoringSSLShims_r255_load(&q, b);
+    CCryptoBoringSSLShims_r255_add(&p, &p, &q);
+    CCryptoBoringSSLShims_r255_store(out_point, &p);
+}
+
+void CCryptoBoringSSLShims_ristretto255_sub(void *out_point, const void *a, const void *b) {
+    ge_p3 p, q;
+    ge_cached cached;
+    ge_p1p1 difference;
+    CCryptoBoringSSLShims_r255_load(&p, a);
+    CCryptoBoringSSLShims_r255_load(&q, b);
+    CCryptoBoringSSL_x25519_ge_p3_to_cached(&cached, &q);
+    CCryptoBoringSSL_x25519_ge_sub(&difference, &p, &cached);
+    CCryptoBoringSSL_x25519_ge_p1p1_to_p3(&p, &difference);
+    CCryptoBoringSSLShims_r255_store(out_point, &p);
+}
+
+void CCryptoBoringSSLShims_ristretto255_neg(void *out_point, const void *a) {
+    ge_p3 p;
+    CCryptoBoringSSLShims_r255_load(&p, a);
+    CCryptoBoringSSLShims_r255_fe_neg(&p.X, &p.X);
+    CCryptoBoringSSLShims_r255_fe_neg(&p.T, &p.T);
+    CCryptoBoringSSLShims_r255_store(out_point, &p);
+}
+
+void CCryptoBoringSSLShims_ristretto255_scalarmult_base(void *out_point, const void *scalar) {
+    ge_p3 p;
+    CCryptoBoringSSLShims_ed25519_scalarmult_base(&p, scalar);
+    CCryptoBoringSSLShims_r255_store(out_point, &p);
+}
+
+void CCryptoBoringSSLShims_ristretto255_scalarmult(void *out_point, const void *scalar, const void *point) {
+    ge_p3 p;
+    ge_p2 product;
+    CCryptoBoringSSLShims_r255_load(&p, point);
+    CCryptoBoringSSL_x25519_ge_scalarmult(&product, scalar, &p);
+    CCryptoBoringSSLShims_r255_p2_to_p3(&p, &product);
+    CCryptoBoringSSLShims_r255_store(out_point, &p);
+}
+
+void CCryptoBoringSSLShims_ristretto255_encode_doubled_batch(void *out, const void *points, size_t count) {
+    ge_p3 chunk[CCRYPTOBORINGSSLSHIMS_RISTRETTO255_CHUNK];
+    const uint8_t *in = points;
+    uint8_t *encodings = out;
+    while (count > 0) {
+        const size_t todo = count < CCRYPTOBORINGSSLSHIMS_RISTRETTO255_CHUNK ? count : CCRYPTOBORINGSSLSHIMS_RISTRETTO255_CHUNK;
+        OPENSSL_memcpy(chunk, in, todo * sizeof(ge_p3));
+        CCryptoBoringSSLShims_r255_encode_doubled_chunk(encodings, chunk, todo);
+        in += todo * sizeof(ge_p3);
+        encodings += todo * 32;
+        count -= todo;
+    }
+}
+
+void CCryptoBoringSSLShims_ristretto255_scalarmult_encode_batch(void *out, const void *scalar, const void *points,
+                                                                size_t count) {
+    ge_p3 chunk[CCRYPTOBORINGSSLSHIMS_RISTRETTO255_CHUNK];
+    uint8_t half[32];
+    CCryptoBoringSSLShims_r255_sc_mul(half, scalar, kCCryptoBoringSSLShimsRistretto255Half);
+    const uint8_t *in = points;
+    uint8_t *encodings = out;
+    while (count > 0) {
+        const size_t todo = count < CCRYPTOBORINGSSLSHIMS_RISTRETTO255_CHUNK ? count : CCRYPTOBORINGSSLSHIMS_RISTRETTO255_CHUNK;
+        for (size_t i = 0; i < todo; i++) {
+            ge_p3 p;
+            ge_p2 product;
+            CCryptoBoringSSLShims_r255_load(&p, in + i * sizeof(ge_p3));
+            CCryptoBoringSSL_x25519_ge_scalarmult(&product, half, &p);
+            CCryptoBoringSSLShims_r255_p2_to_p3(&chunk[i], &product);
+        }
+        CCryptoBoringSSLShims_r255_encode_doubled_chunk(encodings, chunk, todo);
+        in += todo * sizeof(ge_p3);
+        encodings += todo * 32;
+        count -= todo;
+    }
+    CCryptoBoringSSL_OPENSSL_cleanse(half, sizeof(half));
+}
+
+void CCryptoBoringSSLShims_ristretto255_scalarmult_base_encode_batch(void *out, const void *scalars, size_t count) {
+    ge_p3 chunk[CCRYPTOBORINGSSLSHIMS_RISTRETTO255_CHUNK];
+    uint8_t half[32];
+    const uint8_t *in = scalars;
+    uint8_t *encodings = out;
+    while (count > 0) {
+        const size_t todo = count < CCRYPTOBORINGSSLSHIMS_RISTRETTO255_CHUNK ? count : CCRYPTOBORINGSSLSHIMS_RISTRETTO255_CHUNK;
+        for (size_t i = 0; i < todo; i++) {
+            CCryptoBoringSSLShims_r255_sc_mul(half, in + 32 * i, kCCryptoBoringSSLShimsRistretto255Half);
+            CCryptoBoringSSLShims_ed25519_scalarmult_base(&chunk[i], half);
+        }
+        CCryptoBoringSSLShims_r255_encode_doubled_chunk(encodings, chunk, todo);
+        in += todo * 32;
+        encodings += todo * 32;
+        count -= todo;
+    }
+    CCryptoBoringSSL_OPENSSL_cleanse(half, sizeof(half));
+}
+
+int CCryptoBoringSSLShims_ristretto255_multi_scalar_mul(void *out_point, const void *scalars, const void *points,
+                                                        size_t count) {
+    ge_p3 result;
+    CCryptoBoringSSLShims_r255_identity(&result);
+    if (count == 0) {
+        CCryptoBoringSSLShims_r255_store(out_point, &result);
+        return 1;
+    }
+
+    const int c = CCryptoBoringSSLShims_r255_msm_window_bits(count);
+    const size_t num_windows = (256 + c - 1) / c;
+    const size_t num_buckets = (size_t)1 << (c - 1);
+    int ret = 0;
+    ge_cached *cached = OPENSSL_calloc(count, sizeof(ge_cached));
+    int16_t *digits = OPENSSL_calloc(count, num_windows * sizeof(int16_t));
+    ge_p3 *buckets = OPENSSL_calloc(num_buckets, sizeof(ge_p3));
+    uint8_t *occupied = OPENSSL_calloc(num_buckets, 1);
+    if (cached == NULL || digits == NULL || buckets == NULL || occupied == NULL) {
+        goto err;
+    }
+
+    const uint8_t *scalar_bytes = scalars, *point_bytes = points;
+    for (size_t i = 0; i < count; i++) {
+        ge_p3 p;
+        CCryptoBoringSSLShims_r255_load(&p, point_bytes + i * sizeof(ge_p3));
+        CCryptoBoringSSL_x25519_ge_p3_to_cached(&cached[i], &p);
+        CCryptoBoringSSLShims_r255_msm_recode(digits + i * num_windows, num_windows, scalar_bytes + 32 * i, c);
+    }
+
+    for (size_t w = num_windows; w-- > 0;) {
+        for (int b = 0; b < c; b++) {
+            CCryptoBoringSSLShims_r255_add(&result, &result, &result);
+        }
+
+        OPENSSL_memset(occupied, 0, num_buckets);
+        for (size_t i = 0; i < count; i++) {
+            const int digit = digits[i * num_windows + w];
+            if (digit == 0) {
+                continue;
+            }
+            const size_t bucket = (size_t)(digit < 0 ? -digit : digit) - 1;
+            ge_p1p1 sum;
+            if (!occupied[bucket]) {
+                CCryptoBoringSSLShims_r255_identity(&buckets[bucket]);
+                occupied[bucket] = 1;
+            }
+            if (digit > 0) {
+                CCryptoBoringSSL_x25519_ge_add(&sum, &buckets[bucket], &cached[i]);
+            } else {
+                CCryptoBoringSSL_x25519_ge_sub(&sum, &buckets[bucket], &cached[i]);
+            }
+            CCryptoBoringSSL_x25519_ge_p1p1_to_p3(&buckets[bucket], &sum);
+        }
+
+        // Σ k · bucket[k - 1], as a running sum of the buckets from the top.
+        ge_p3 running, window_sum;
+        int have_running = 0;
+        CCryptoBoringSSLShims_r255_identity(&running);
+        CCryptoBoringSSLShims_r255_identity(&window_sum);
+        for (size_t k = num_buckets; k-- > 0;) {
+            if (occupied[k]) {
+                CCryptoBoringSSLShims_r255_add(&running, &running, &buckets[k]);
+                have_running = 1;
+            }
+            if (have_running) {
+                CCryptoBoringSSLShims_r255_add(&window_sum, &window_sum, &running);
+            }
+        }
+        CCryptoBoringSSLShims_r255_add(&result, &result, &window_sum);
+    }
+
+    CCryptoBoringSSLShims_r255_store(out_point, &result);
+    ret = 1;
+
+err:
+    OPENSSL_free(cached);
+    OPENSSL_free(digits);
+    OPENSSL_free(buckets);
+    OPENSSL_free(occupied);
+    return ret;
+}
+
+int CCryptoBoringSSLShims_ristretto255_scalar_is_canonical(const void *scalar) {
+    return (int)CCryptoBoringSSLShims_r255_sc_is_canonical(scalar);
+}
+
+void CCryptoBoringSSLShims_ristretto255_scalar_reduce(void *out, const void *in) {
+    uint8_t wide[64];
+    OPENSSL_memcpy(wide, in, 64);
+    CCryptoBoringSSLShims_r255_sc_reduce_into(out, wide);
+}
+
+int CCryptoBoringSSLShims_ristretto255_scalar_random(void *out) {
+    uint8_t wide[64];
+    if (!CCryptoBoringSSL_RAND_bytes(wide, sizeof(wide))) {
+        return 0;
+    }
+    CCryptoBoringSSLShims_r255_sc_reduce_into(out, wide);
+    return 1;
+}
+
+void CCryptoBoringSSLShims_ristretto255_scalar_add(void *out, const void *a, const void *b) {
+    CCryptoBoringSSLShims_r255_sc_add(out, a, b);
+}
+
+void CCryptoBoringSSLShims_ristretto255_scalar_sub(void *out, const void *a, const void *b) {
+    uint8_t negated[32];
+    CCryptoBoringSSLShims_r255_sc_neg(negated, b);
+    CCryptoBoringSSLShims_r255_sc_add(out, a, negated);
+    CCryptoBoringSSL_OPENSSL_cleanse(negated, sizeof(negated));
+}
+
+void CCryptoBoringSSLShims_ristretto255_scalar_neg(void *out, const void *a) {
+    CCryptoBoringSSLShims_r255_sc_neg(out, a);
+}
+
+void CCryptoBoringSSLShims_ristretto255_scalar_mul(void *out, const void *a, const void *b) {
+    CCryptoBoringSSLShims_r255_sc_mul(out, a, b);
+}
+
+void CCryptoBoringSSLShims_ristretto255_scalar_invert(void *out, const void *a) {
+    // a^(l - 2), scanning the public exponent from the top bit. l - 2 differs
+    // from l only in its lowest byte.
+    uint8_t exponent[32], result[32] = {1};
+    OPENSSL_memcpy(exponent, kCCryptoBoringSSLShimsRistretto255Order, 32);
+    exponent[0] -= 2;
+    for (int bit = 252; bit >= 0; bit--) {
+        CCryptoBoringSSLShims_r255_sc_mul(result, result, result);
+        if ((exponent[bit >> 3] >> (bit & 7)) & 1) {
+            CCryptoBoringSSLShims_r255_sc_mul(result, result, a);
+        }
+    }
+    OPENSSL_memcpy(out, result, 32);
+    CCryptoBoringSSL_OPENSSL_cleanse(result, sizeof(result));
+}
+
+// MARK:- SP 800-185
+
+#if defined(OPENSSL_X86_64) && (defined(__GNUC__) || defined(__clang__))
+#define CCRYPTOBORINGSSLSHIMS_KECCAK_AVX2 1
+#include <immintrin.h>
+#elif defined(CRYPTO_BORINGSSL_ARM_KERNELS) && defined(OPENSSL_AARCH64) && defined(__ARM_NEON)
+// Not yet run on AArch64 in CI, so opt-in; the one-lane permutation is used
+// otherwise.
+#define CCRYPTOBORINGSSLSHIMS_KECCAK_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if !defined(_WIN32) && !defined(OPENSSL_NO_THREADS_CORRUPT_MEMORY_AND_LEAK_SECRETS_IF_THREADED)
+#define CCRYPTOBORINGSSLSHIMS_PARALLEL_HASH 1
+#include <pthread.h>
+#endif
+
+#define CCryptoBoringSSLShims_PARALLEL_HASH_MAX_THREADS 64
+// Leaves are hashed this many at a time, which bounds the chaining values
+// held at once.
+#define CCRYPTOBORINGSSLSHIMS_PARALLEL_HASH_CHUNK 4096
+// Smaller shares of a chunk aren't worth a thread.
+#define CCRYPTOBORINGSSLSHIMS_PARALLEL_HASH_MIN_BYTES_PER_THREAD (256 * 1024)
+
+// A Keccak context that remembers whether it is customized cSHAKE, which pads
+// differently from SHAKE.
+struct CCryptoBoringSSLShims_cshake_st {
+    struct BORINGSSL_keccak_st keccak;
+    uint64_t customized;
+};
+
+_Static_assert(sizeof(struct CCryptoBoringSSLShims_cshake_st) <= sizeof(CCryptoBoringSSLShims_keccak_ctx),
+               "CCryptoBoringSSLShims_keccak_ctx is too small for cSHAKE");
+
+static enum boringssl_keccak_config_t CCryptoBoringSSLShims_sp800_185_config(
+    CCryptoBoringSSLShims_keccak_function function) {
+    return function == CCryptoBoringSSLShims_keccak_shake128 ? boringssl_shake128 : boringssl_shake256;
+}
+
+// left_encode and right_encode from SP 800-185, section 2.3.1. Both write at
+// most nine bytes.
+static size_t CCryptoBoringSSLShims_sp800_185_left_encode(uint8_t out[9], uint64_t x) {
+    size_t n = 1;
+    while (n < 8 && (x >> (8 * n)) != 0) {
+        n++;
+    }
+    out[0] = (uint8_t)n;
+    for (size_t i = 0; i < n; i++) {
+        out[1 + i] = (uint8_t)(x >> (8 * (n - 1 - i)));
+    }
+    return n + 1;
+}
+
+static size_t CCryptoBoringSSLShims_sp800_185_right_encode(uint8_t out[9], uint64_t x) {
+    size_t n = 1;
+    while (n < 8 && (x >> (8 * n)) != 0) {
+        n++;
+    }
+    for (size_t i = 0; i < n; i++) {
+        out[i] = (uint8_t)(x >> (8 * (n - 1 - i)));
+    }
+    out[n] = (uint8_t)n;
+    return n + 1;
+}
+
+// Absorbs encode_string(s) and returns the number of bytes absorbed.
+static size_t CCryptoBoringSSLShims_sp800_185_absorb_string(struct BORINGSSL_keccak_st *keccak, const void *s,
+                                                            size_t len) {
+    uint8_t encoded[9];
+    const size_t encoded_len = CCryptoBoringSSLShims_sp800_185_left_encode(encoded, (uint64_t)len * 8);
+    CCryptoBoringSSL_BORINGSSL_keccak_absorb(keccak, encoded, encoded_len);
+    CCryptoBoringSSL_BORINGSSL_keccak_absorb(keccak, s, len);
+    return encoded_len + len;
+}
+
+// Absorbs left_encode of the rate, the start of every bytepad, and returns the
+// number of bytes absorbed.
+static size_t CCryptoBoringSSLShims_sp800_185_absorb_bytepad_start(struct BORINGSSL_keccak_st *keccak) {
+    uint8_t encoded[9];
+    const size_t encoded_len = CCryptoBoringSSLShims_sp800_185_left_encode(encoded, keccak->rate_bytes);
+    CCryptoBoringSSL_BORINGSSL_keccak_absorb(keccak, encoded, encoded_len);
+    return encoded_len;
+}
+
+// Completes a bytepad of |absorbed| bytes with zeros up to a multiple of the
+// rate.
+static void CCryptoBoringSSLShims_sp800_185_absorb_bytepad_end(struct BORINGSSL_keccak_st *keccak, size_t absorbed) {
+    static const uint8_t kZeros[168] = {0};
+    const size_t remainder = absorbed % keccak->rate_bytes;
+    if (remainder != 0) {
+        CCryptoBoringSSL_BORINGSSL_keccak_absorb(keccak, kZeros, keccak->rate_bytes - remainder);
+    }
+}
+
+static void CCryptoBoringSSLShims_cshake_setup(struct CCryptoBoringSSLShims_cshake_st *cshake,
+                                               CCryptoBoringSSLShims_keccak_function function, const void *name,
+                                               size_t name_len, const void *custom, size_t custom_len) {
+    CCryptoBoringSSL_BORINGSSL_keccak_init(&cshake->keccak, CCryptoBoringSSLShims_sp800_185_config(function));
+    // With an empty name and customization string cSHAKE is SHAKE.
+    cshake->customized = name_len != 0 || custom_len != 0;
+    if (!cshake->customized) {
+        return;
+    }
+    size_t absorbed = CCryptoBoringSSLShims_sp800_185_absorb_bytepad_start(&cshake->keccak);
+    absorbed += CCryptoBoringSSLShims_sp800_185_absorb_string(&cshake->keccak, name, name_len);
+    absorbed += CCryptoBoringSSLShims_sp800_185_absorb_string(&cshake->keccak, custom, custom_len);
+    CCryptoBoringSSLShims_sp800_185_absorb_bytepad_end(&cshake->keccak, absorbed);
+}
+
+void CCryptoBoringSSLShims_keccak_cshake_init(CCryptoBoringSSLShims_keccak_ctx *ctx,
+                                              CCryptoBoringSSLShims_keccak_function function, const void *name,
+                                              size_t name_len, const void *custom, size_t custom_len) {
+    CCryptoBoringSSLShims_cshake_setup((struct CCryptoBoringSSLShims_cshake_st *)ctx, function, name, name_len, custom,
+                                       custom_len);
+}
+
+void CCryptoBoringSSLShims_keccak_kmac_init(CCryptoBoringSSLShims_keccak_ctx *ctx,
+                                            CCryptoBoringSSLShims_keccak_function function, const void *key,
+                                            size_t key_len, const void *custom, size_t custom_len) {
+    struct CCryptoBoringSSLShims_cshake_st *cshake = (struct CCryptoBoringSSLShims_cshake_st *)ctx;
+    CCryptoBoringSSLShims_cshake_setup(cshake, function, "KMAC", 4, custom, custom_len);
+    size_t absorbed = CCryptoBoringSSLShims_sp800_185_absorb_bytepad_start(&cshake->keccak);
+    absorbed += CCryptoBoringSSLShims_sp800_185_absorb_string(&cshake->keccak, key, key_len);
+    CCryptoBoringSSLShims_sp800_185_absorb_bytepad_end(&cshake->keccak, absorbed);
+}
+
+void CCryptoBoringSSLShims_keccak_absorb_right_encode(CCryptoBoringSSLShims_keccak_ctx *ctx, uint64_t value) {
+    uint8_t encoded[9];
+    const size_t encoded_len = CCryptoBoringSSLShims_sp800_185_right_encode(encoded, value);
+    CCryptoBoringSSL_BORINGSSL_keccak_absorb((struct BORINGSSL_keccak_st *)ctx, encoded, encoded_len);
+}
+
+void CCryptoBoringSSLShims_keccak_cshake_squeeze(CCryptoBoringSSLShims_keccak_ctx *ctx, void *out, size_t out_len) {
+    struct CCryptoBoringSSLShims_cshake_st *cshake = (struct CCryptoBoringSSLShims_cshake_st *)ctx;
+    struct BORINGSSL_keccak_st *keccak = &cshake->keccak;
+    if (cshake->customized && keccak->phase == boringssl_keccak_phase_absorb) {
+        // BORINGSSL_keccak_squeeze only knows SHAKE's padding, so pad here and
+        // leave the squeeze offset at the end of the block, which makes it
+        // permute before reading.
+        uint8_t *state_bytes = (uint8_t *)keccak->state;
+        state_bytes[keccak->absorb_offset] ^= 0x04;
+        state_bytes[keccak->rate_bytes - 1] ^= 0x80;
+        keccak->phase = boringssl_keccak_phase_squeeze;
+        keccak->squeeze_offset = keccak->rate_bytes;
+    }
+    CCryptoBoringSSL_BORINGSSL_keccak_squeeze(keccak, out, out_len);
+}
+
+void CCryptoBoringSSLShims_keccak_parallel_hash_init(CCryptoBoringSSLShims_keccak_ctx *ctx,
+                                                     CCryptoBoringSSLShims_keccak_function function,
+                                                     size_t block_size, const void *custom, size_t custom_len) {
+    CCryptoBoringSSLShims_cshake_setup((struct CCryptoBoringSSLShims_cshake_st *)ctx, function, "ParallelHash", 12,
+                                       custom, custom_len);
+    uint8_t encoded[9];
+    const size_t encoded_len = CCryptoBoringSSLShims_sp800_185_left_encode(encoded, block_size);
+    CCryptoBoringSSL_BORINGSSL_keccak_absorb((struct BORINGSSL_keccak_st *)ctx, encoded, encoded_len);
+}
+
+// The leaves of ParallelHash are SHAKE with a 256-bit output for
+// ParallelHash128 and a 512-bit one for ParallelHash256, which are the same as
+// cSHAKE with empty strings. Several leaves of the same length are hashed at
+// once, one per vector lane, by a Keccak-f[1600] written once over lane-wise
+// XOR, AND-NOT and rotate operations. ANDN(a, b) is ~a & b.
+
+static const uint64_t kCCryptoBoringSSLShimsKeccakRoundConstants[24] = {
+    UINT64_C(0x0000000000000001), UINT64_C(0x0000000000008082), UINT64_C(0x800000000000808a),
+    UINT64_C(0x8000000080008000), UINT64_C(0x000000000000808b), UINT64_C(0x0000000080000001),
+    UINT64_C(0x8000000080008081), UINT64_C(0x8000000000008009), UINT64_C(0x000000000000008a),
+    UINT64_C(0x0000000000000088), UINT64_C(0x0000000080008009), UINT64_C(0x000000008000000a),
+    UINT64_C(0x000000008000808b), UINT64_C(0x800000000000008b), UINT64_C(0x8000000000008089),
+    UINT64_C(0x8000000000008003), UINT64_C(0x8000000000008002), UINT64_C(0x8000000000000080),
+    UINT64_C(0x000000000000800a), UINT64_C(0x800000008000000a), UINT64_C(0x8000000080008081),
+    UINT64_C(0x8000000000008080), UINT64_C(0x0000000080000001), UINT64_C(0x8000000080008008),
+};
+
+// One step of the combined rho and pi permutations, which walk the lanes in a
+// single cycle starting from lane 1.
+#define CCRYPTOBORINGSSLSHIMS_KECCAK_RHO_PI(V, s, t, j, r, ROL) \
+    do {                                                        \
+        V next_ = s[j];                                         \
+        s[j] = ROL(t, r);                                       \
+        t = next_;                                              \
+    } while (0)
+
+// Theta for column x, and chi for the row starting at lane y. Spelling every
+// lane out keeps the state in registers, which loops over the lanes only
+// manage at -O3.
+#define CCRYPTOBORINGSSLSHIMS_KECCAK_THETA(V, s, bc, x, XOR, ROL)                                      \
+    do {                                                                                               \
+        const V d_ = XOR(bc[((x) + 4) % 5], ROL(bc[((x) + 1) % 5], 1));                                \
+        s[(x)] = XOR(s[(x)], d_);                                                                      \
+        s[(x) + 5] = XOR(s[(x) + 5], d_);                                                              \
+        s[(x) + 10] = XOR(s[(x) + 10], d_);                                                            \
+        s[(x) + 15] = XOR(s[(x) + 15], d_);                                                            \
+        s[(x) + 20] = XOR(s[(x) + 20], d_);                                                            \
+    } while (0)
+
+#define CCRYPTOBORINGSSLSHIMS_KECCAK_CHI(V, s, y, XOR, ANDN)                                           \
+    do {                                                                                               \
+        const V a0_ = s[(y)], a1_ = s[(y) + 1], a2_ = s[(y) + 2], a3_ = s[(y) + 3], a4_ = s[(y) + 4];  \
+        s[(y)] = XOR(a0_, ANDN(a1_, a2_));                                                             \
+        s[(y) + 1] = XOR(a1_, ANDN(a2_, a3_));                                                         \
+        s[(y) + 2] = XOR(a2_, ANDN(a3_, a4_));                                                         \
+        s[(y) + 3] = XOR(a3_, ANDN(a4_, a0_));                                                         \
+        s[(y) + 4] = XOR(a4_, ANDN(a0_, a1_));                                                         \
+    } while (0)
+
+#define CCRYPTOBORINGSSLSHIMS_KECCAK_COLUMN(s, x, XOR)                                                 \
+    XOR(XOR(XOR(s[(x)], s[(x) + 5]), XOR(s[(x) + 10], s[(x) + 15])), s[(x) + 20])
+
+#define CCRYPTOBORINGSSLSHIMS_KECCAK_PERMUTE(V, s, XOR, ANDN, ROL, SET1)                               \
+    for (size_t round_ = 0; round_ < 24; round_++) {                                                   \
+        const V bc_[5] = {                                                                             \
+            CCRYPTOBORINGSSLSHIMS_KECCAK_COLUMN(s, 0, XOR),                                            \
+            CCRYPTOBORINGSSLSHIMS_KECCAK_COLUMN(s, 1, XOR),                                            \
+            CCRYPTOBORINGSSLSHIMS_KECCAK_COLUMN(s, 2, XOR),                                            \
+            CCRYPTOBORINGSSLSHIMS_KECCAK_COLUMN(s, 3, XOR),                                            \
+            CCRYPTOBORINGSSLSHIMS_KECCAK_COLUMN(s, 4, XOR),                                            \
+        };                                                                                             \
+        V t_;                                                                                          \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_THETA(V, s, bc_, 0, XOR, ROL);                                    \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_THETA(V, s, bc_, 1, XOR, ROL);                                    \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_THETA(V, s, bc_, 2, XOR, ROL);                                    \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_THETA(V, s, bc_, 3, XOR, ROL);                                    \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_THETA(V, s, bc_, 4, XOR, ROL);                                    \
+        t_ = s[1];                                                                                     \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_RHO_PI(V, s, t_, 10, 1, ROL);                                     \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_RHO_PI(V, s, t_, 7, 3, ROL);                                      \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_RHO_PI(V, s, t_, 11, 6, ROL);                                     \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_RHO_PI(V, s, t_, 17, 10, ROL);                                    \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_RHO_PI(V, s, t_, 18, 15, ROL);                                    \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_RHO_PI(V, s, t_, 3, 21, ROL);                                     \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_RHO_PI(V, s, t_, 5, 28, ROL);                                     \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_RHO_PI(V, s, t_, 16, 36, ROL);                                    \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_RHO_PI(V, s, t_, 8, 45, ROL);                                     \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_RHO_PI(V, s, t_, 21, 55, ROL);                                    \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_RHO_PI(V, s, t_, 24, 2, ROL);                                     \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_RHO_PI(V, s, t_, 4, 14, ROL);                                     \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_RHO_PI(V, s, t_, 15, 27, ROL);                                    \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_RHO_PI(V, s, t_, 23, 41, ROL);                                    \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_RHO_PI(V, s, t_, 19, 56, ROL);                                    \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_RHO_PI(V, s, t_, 13, 8, ROL);                                     \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_RHO_PI(V, s, t_, 12, 25, ROL);                                    \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_RHO_PI(V, s, t_, 2, 43, ROL);                                     \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_RHO_PI(V, s, t_, 20, 62, ROL);                                    \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_RHO_PI(V, s, t_, 14, 18, ROL);                                    \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_RHO_PI(V, s, t_, 22, 39, ROL);                                    \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_RHO_PI(V, s, t_, 9, 61, ROL);                                     \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_RHO_PI(V, s, t_, 6, 20, ROL);                                     \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_RHO_PI(V, s, t_, 1, 44, ROL);                                     \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_CHI(V, s, 0, XOR, ANDN);                                          \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_CHI(V, s, 5, XOR, ANDN);                                          \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_CHI(V, s, 10, XOR, ANDN);                                         \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_CHI(V, s, 15, XOR, ANDN);                                         \
+        CCRYPTOBORINGSSLSHIMS_KECCAK_CHI(V, s, 20, XOR, ANDN);                                         \
+        s[0] = XOR(s[0], SET1(kCCryptoBoringSSLShimsKeccakRoundConstants[round_]));                    \
+    }
+
+// Builds the final, padded block of each leaf in |last|, |rate| bytes apart.
+static void CCryptoBoringSSLShims_shake_last_blocks(uint8_t *last, const uint8_t *in, size_t stride, size_t len,
+                                                    size_t rate, size_t lanes) {
+    const size_t full = len - len % rate;
+    OPENSSL_memset(last, 0, lanes * rate);
+    for (size_t lane = 0; lane < lanes; lane++) {
+        uint8_t *block = last + lane * rate;
+        OPENSSL_memcpy(block, in + lane * stride + full, len - full);
+        block[len - full] ^= 0x1f;
+        block[rate - 1] ^= 0x80;
+    }
+}
+
+#if defined(CCRYPTOBORINGSSLSHIMS_KECCAK_AVX2)
+#define CCRYPTOBORINGSSLSHIMS_KECCAK_AVX2_XOR(a, b) _mm256_xor_si256(a, b)
+#define CCRYPTOBORINGSSLSHIMS_KECCAK_AVX2_ANDN(a, b) _mm256_andnot_si256(a, b)
+#define CCRYPTOBORINGSSLSHIMS_KECCAK_AVX2_ROL(a, r) \
+    _mm256_or_si256(_mm256_slli_epi64(a, r), _mm256_srli_epi64(a, 64 - (r)))
+#define CCRYPTOBORINGSSLSHIMS_KECCAK_AVX2_SET1(c) _mm256_set1_epi64x((long long)(c))
+
+__attribute__((target("avx2")))
+static void CCryptoBoringSSLShims_keccak_absorb_x4(__m256i s[25], const uint8_t *in, size_t stride, size_t rate) {
+    for (size_t i = 0; i < rate / 8; i++) {
+        const __m256i words = _mm256_set_epi64x(
+            (long long)CRYPTO_load_u64_le(in + 3 * stride + 8 * i), (long long)CRYPTO_load_u64_le(in + 2 * stride + 8 * i),
+            (long long)CRYPTO_load_u64_le(in + stride + 8 * i), (long long)CRYPTO_load_u64_le(in + 8 * i));
+        s[i] = _mm256_xor_si256(s[i], words);
+    }
+    CCRYPTOBORINGSSLSHIMS_KECCAK_PERMUTE(__m256i, s, CCRYPTOBORINGSSLSHIMS_KECCAK_AVX2_XOR,
+                                         CCRYPTOBORINGSSLSHIMS_KECCAK_AVX2_ANDN, CCRYPTOBORINGSSLSHIMS_KECCAK_AVX2_ROL,
+                                         CCRYPTOBORINGSSLSHIMS_KECCAK_AVX2_SET1)
+}
+
+// Hashes four leaves of |len| bytes, |stride| bytes apart, writing |out_len|
+// bytes of each, which is at most the rate, |out_len| bytes apart.
+__attribute__((target("avx2")))
+static void CCryptoBoringSSLShims_shake_x4(const uint8_t *in, size_t stride, size_t len, size_t rate, uint8_t *out,
+                                           size_t out_len) {
+    __m256i s[25];
+    for (size_t i = 0; i < 25; i++) {
+        s[i] = _mm256_setzero_si256();
+    }
+    size_t offset = 0;
+    for (; offset + rate <= len; offset += rate) {
+        CCryptoBoringSSLShims_keccak_absorb_x4(s, in + offset, stride, rate);
+    }
+    uint8_t last[4 * 168];
+    CCryptoBoringSSLShims_shake_last_blocks(last, in, stride, len, rate, 4);
+    CCryptoBoringSSLShims_keccak_absorb_x4(s, last, rate, rate);
+
+    for (size_t i = 0; i < out_len / 8; i++) {
+        uint64_t words[4];
+        _mm256_storeu_si256((__m256i *)words, s[i]);
+        for (size_t lane = 0; lane < 4; lane++) {
+            CRYPTO_store_u64_le(out + lane * out_len + 8 * i, words[lane]);
+        }
+    }
+}
+#endif  // CCRYPTOBORINGSSLSHIMS_KECCAK_AVX2
+
+#if defined(CCRYPTOBORINGSSLSHIMS_KECCAK_NEON)
+#define CCRYPTOBORINGSSLSHIMS_KECCAK_NEON_XOR(a, b) veorq_u64(a, b)
+#define CCRYPTOBORINGSSLSHIMS_KECCAK_NEON_ANDN(a, b) vbicq_u64(b, a)
+#define CCRYPTOBORINGSSLSHIMS_KECCAK_NEON_ROL(a, r) vsriq_n_u64(vshlq_n_u64(a, r), a, 64 - (r))
+#define CCRYPTOBORINGSSLSHIMS_KECCAK_NEON_SET1(c) vdupq_n_u64(c)
+
+static void CCryptoBoringSSLShims_keccak_absorb_x2(uint64x2_t s[25], const uint8_t *in, size_t stride, size_t rate) {
+    for (size_t i = 0; i < rate / 8; i++) {
+        const uint64x2_t words = vcombine_u64(vcreate_u64(CRYPTO_load_u64_le(in + 8 * i)),
+                                              vcreate_u64(CRYPTO_load_u64_le(in + stride + 8 * i)));
+        s[i] = veorq_u64(s[i], words);
+    }
+    CCRYPTOBORINGSSLSHIMS_KECCAK_PERMUTE(uint64x2_t, s, CCRYPTOBORINGSSLSHIMS_KECCAK_NEON_XOR,
+                                         CCRYPTOBORINGSSLSHIMS_KECCAK_NEON_ANDN, CCRYPTOBORINGSSLSHIMS_KECCAK_NEON_ROL,
+                                         CCRYPTOBORINGSSLSHIMS_KECCAK_NEON_SET1)
+}
+
+// The two-lane counterpart of CCryptoBoringSSLShims_shake_x4.
+static void CCryptoBoringSSLShims_shake_x2(const uint8_t *in, size_t stride, size_t len, size_t rate, uint8_t *out,
+                                           size_t out_len) {
+    uint64x2_t s[25];
+    for (size_t i = 0; i < 25; i++) {
+        s[i] = vdupq_n_u64(0);
+    }
+    size_t offset = 0;
+    for (; offset + rate <= len; offset += rate) {
+        CCryptoBoringSSLShims_keccak_absorb_x2(s, in + offset, stride, rate);
+    }
+    uint8_t last[2 * 168];
+    CCryptoBoringSSLShims_shake_last_blocks(last, in, stride, len, rate, 2);
+    CCryptoBoringSSLShims_keccak_absorb_x2(s, last, rate, rate);
+
+    for (size_t i = 0; i < out_len / 8; i++) {
+        CRYPTO_store_u64_le(out + 8 * i, vgetq_lane_u64(s[i], 0));
+        CRYPTO_store_u64_le(out + out_len + 8 * i, vgetq_lane_u64(s[i], 1));
+    }
+}
+#endif  // CCRYPTOBORINGSSLSHIMS_KECCAK_NEON
+
+typedef struct {
+    const uint8_t *in;
+    size_t block_size;
+    size_t count;
+    enum boringssl_keccak_config_t config;
+    uint8_t *out;
+    size_t out_len;
+} CCryptoBoringSSLShims_parallel_hash_worker;
+
+static void *CCryptoBoringSSLShims_parallel_hash_worker_run(void *arg) {
+    CCryptoBoringSSLShims_parallel_hash_worker *worker = arg;
+    const size_t rate = worker->config == boringssl_shake128 ? 168 : 136;
+    size_t i = 0;
+#if defined(CCRYPTOBORINGSSLSHIMS_KECCAK_AVX2)
+    if (CRYPTO_is_AVX2_capable()) {
+        for (; i + 4 <= worker->count; i += 4) {
+            CCryptoBoringSSLShims_shake_x4(worker->in + i * worker->block_size, worker->block_size, worker->block_size,
+                                           rate, worker->out + i * worker->out_len, worker->out_len);
+        }
+    }
+#elif defined(CCRYPTOBORINGSSLSHIMS_KECCAK_NEON)
+    for (; i + 2 <= worker->count; i += 2) {
+        CCryptoBoringSSLShims_shake_x2(worker->in + i * worker->block_size, worker->block_size, worker->block_size,
+                                       rate, worker->out + i * worker->out_len, worker->out_len);
+    }
+#else
+    (void)rate;
+#endif
+    for (; i < worker->count; i++) {
+        CCryptoBoringSSL_BORINGSSL_keccak(worker->out + i * worker->out_len, worker->out_len,
+                                          worker->in + i * worker->block_size, worker->block_size, worker->config);
+    }
+    return NULL;
+}
+
+int CCryptoBoringSSLShims_keccak_parallel_hash_absorb_blocks(CCryptoBoringSSLShims_keccak_ctx *ctx, const void *in,
+                                                             size_t block_size, size_t count, size_t max_threads) {
+    struct BORINGSSL_keccak_st *keccak = (struct BORINGSSL_keccak_st *)ctx;
+    if (count == 0) {
+        return 1;
+    }
+    if (block_size == 0) {
+        return 0;
+    }
+    const size_t out_len = keccak->config == boringssl_shake128 ? 32 : 64;
+    const size_t chunk = count < CCRYPTOBORINGSSLSHIMS_PARALLEL_HASH_CHUNK ? count : CCRYPTOBORINGSSLSHIMS_PARALLEL_HASH_CHUNK;
+    uint8_t *chaining = OPENSSL_malloc(chunk * out_len);
+    if (chaining == NULL) {
+        return 0;
+    }
+    if (max_threads == 0) {
+        max_threads = 1;
+    }
+    if (max_threads > CCryptoBoringSSLShims_PARALLEL_HASH_MAX_THREADS) {
+        max_threads = CCryptoBoringSSLShims_PARALLEL_HASH_MAX_THREADS;
+    }
+#if !defined(CCRYPTOBORINGSSLSHIMS_PARALLEL_HASH)
+    max_threads = 1;
+#endif
+
+    const uint8_t *bytes = in;
+    for (size_t done = 0; done < count;) {
+        const size_t n = count - done < chunk ? count - done : chunk;
+        size_t workers = max_threads;
+        const size_t by_size = n * block_size / CCRYPTOBORINGSSLSHIMS_PARALLEL_HASH_MIN_BYTES_PER_THREAD;
+        if (workers > by_size) {
+            workers = by_size == 0 ? 1 : by_size;
+        }
+        // Deal the leaves out in multiples of four so that every worker's
+        // vector lanes stay full.
+        size_t share = (n + workers - 1) / workers;
+        share = (share + 3) & ~(size_t)3;
+
+        CCryptoBoringSSLShims_parallel_hash_worker worker_state[CCryptoBoringSSLShims_PARALLEL_HASH_MAX_THREADS];
+        size_t used = 0;
+        for (size_t first = 0; first < n; first += share, used++) {
+            const size_t share_count = n - first < share ? n - first : share;
+            worker_state[used] = (CCryptoBoringSSLShims_parallel_hash_worker){
+                bytes + (done + first) * block_size, block_size, share_count, keccak->config,
+                chaining + first * out_len, out_len,
+            };
+        }
+
+#if defined(CCRYPTOBORINGSSLSHIMS_PARALLEL_HASH)
+        pthread_t threads[CCryptoBoringSSLShims_PARALLEL_HASH_MAX_THREADS];
+        int started[CCryptoBoringSSLShims_PARALLEL_HASH_MAX_THREADS] = {0};
+        for (size_t w = 1; w < used; w++) {
+            started[w] =
+                pthread_create(&threads[w], NULL, CCryptoBoringSSLShims_parallel_hash_worker_run, &worker_state[w]) == 0;
+        }
+#endif
+        CCryptoBoringSSLShims_parallel_hash_worker_run(&worker_state[0]);
+        for (size_t w = 1; w < used; w++) {
+#if defined(CCRYPTOBORINGSSLSHIMS_PARALLEL_HASH)
+            if (started[w]) {
+                pthread_join(threads[w], NULL);
+                continue;
+            }
+#endif
+            // The thread could not be started, so its leaves are hashed here
+            // instead.
+            CCryptoBoringSSLShims_parallel_hash_worker_run(&worker_state[w]);
+        }
+
+        CCryptoBoringSSL_BORINGSSL_keccak_absorb(keccak, chaining, n * out_len);
+        done += n;
+    }
+    OPENSSL_free(chaining);
+    return 1;
+}
+
+// MARK:- Warm-up
+
+void CCryptoBoringSSLShims_warm_up_process(void) {
+    CCryptoBoringSSL_CRYPTO_pre_sandbox_init();
+    // Each group is set up by a CRYPTO_once on first use.
+    (void)CCryptoBoringSSL_EC_group_p224();
+    (void)CCryptoBoringSSL_EC_group_p256();
+    (void)CCryptoBoringSSL_EC_group_p384();
+    (void)CCryptoBoringSSL_EC_group_p521();
+}
+
+void CCryptoBoringSSLShims_warm_up_thread(void) {
+    uint8_t bytes[32];
+    CCryptoBoringSSLShims_RAND_bytes(bytes, sizeof(bytes));
+    CCryptoBoringSSL_OPENSSL_cleanse(bytes, sizeof(bytes));
+}
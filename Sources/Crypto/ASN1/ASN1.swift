@@ -121,6 +121,9 @@ extension ASN1 {
 
         /// The data bytes for this node, if it is primitive.
         var dataBytes: ArraySlice<UInt8>?
+
+        /// The complete encoding of this node, including its identifier and length, as a slice of the parsed bytes.
+        var encodedBytes: ArraySlice<UInt8>
     }
 }
 
@@ -293,6 +296,8 @@ extension ASN1 {
                 throw CryptoKitASN1Error.invalidASN1Object
             }
 
+            let originalData = data
+
             guard let rawIdentifier = data.popFirst() else {
                 throw CryptoKitASN1Error.truncatedASN1Field
             }
@@ -314,13 +319,15 @@ extension ASN1 {
                 throw CryptoKitASN1Error.truncatedASN1Field
             }
 
+            let encodedBytes = originalData[..<data.startIndex]
+
             if identifier.constructed {
-                nodes.append(ASN1ParserNode(identifier: identifier, depth: depth, dataBytes: nil))
+                nodes.append(ASN1ParserNode(identifier: identifier, depth: depth, dataBytes: nil, encodedBytes: encodedBytes))
                 while subData.count > 0 {
                     try parseNode(from: &subData, depth: depth + 1, into: &nodes)
                 }
             } else {
-                nodes.append(ASN1ParserNode(identifier: identifier, depth: depth, dataBytes: subData))
+                nodes.append(ASN1ParserNode(identifier: identifier, depth: depth, dataBytes: subData, encodedBytes: encodedBytes))
             }
         }
     }
@@ -344,9 +351,13 @@ extension ASN1 {
             // We need to feed it the next set of nodes.
             let nodeCollection = result.nodes.prefix { $0.depth > firstNode.depth }
             result.nodes = result.nodes.dropFirst(nodeCollection.count)
-            rootNode = ASN1.ASN1Node(identifier: firstNode.identifier, content: .constructed(.init(nodes: nodeCollection, depth: firstNode.depth)))
+            rootNode = ASN1.ASN1Node(
+                identifier: firstNode.identifier,
+                content: .constructed(.init(nodes: nodeCollection, depth: firstNode.depth)),
+                encodedBytes: firstNode.encodedBytes
+            )
         } else {
-            rootNode = ASN1.ASN1Node(identifier: firstNode.identifier, content: .primitive(firstNode.dataBytes!))
+            rootNode = ASN1.ASN1Node(identifier: firstNode.identifier, content: .primitive(firstNode.dataBytes!), encodedBytes: firstNode.encodedBytes)
         }
 
         precondition(result.nodes.count == 0, "ASN1ParseResult unexpectedly allowed multiple root nodes")
@@ -398,10 +409,14 @@ extension ASN1.ASN1NodeCollection: Sequence {
                 // We need to feed it the next set of nodes.
                 let nodeCollection = self.nodes.prefix { $0.depth > nextNode.depth }
                 self.nodes = self.nodes.dropFirst(nodeCollection.count)
-                return ASN1.ASN1Node(identifier: nextNode.identifier, content: .constructed(.init(nodes: nodeCollection, depth: nextNode.depth)))
+                return ASN1.ASN1Node(
+                    identifier: nextNode.identifier,
+                    content: .constructed(.init(nodes: nodeCollection, depth: nextNode.depth)),
+                    encodedBytes: nextNode.encodedBytes
+                )
             } else {
                 // There must be data bytes here, even if they're empty.
-                return ASN1.ASN1Node(identifier: nextNode.identifier, content: .primitive(nextNode.dataBytes!))
+                return ASN1.ASN1Node(identifier: nextNode.identifier, content: .primitive(nextNode.dataBytes!), encodedBytes: nextNode.encodedBytes)
             }
         }
     }
@@ -425,6 +440,11 @@ extension ASN1 {
         internal var identifier: ASN1Identifier
 
         internal var content: Content
+
+        /// The complete encoding of this node, including its identifier and length.
+        ///
+        /// This is a slice of the bytes that were parsed, so it can be used to re-emit the node without serializing it again.
+        internal var encodedBytes: ArraySlice<UInt8>
     }
 }
 
@@ -442,16 +462,92 @@ extension ASN1 {
     struct Serializer {
         var serializedBytes: [UInt8]
 
+        private var mode: Mode
+
+        // The content length of every node, in the order the nodes are opened. Recorded when measuring,
+        // consumed when writing.
+        private var contentLengths: [Int]
+
+        private var nextContentLength = 0
+
+        // When measuring, the number of bytes that would have been written so far.
+        private var measuredByteCount = 0
+
+        private enum Mode {
+            /// Write each node's length after its content, moving the content whenever the length needs more than one byte.
+            case appending
+            /// Only work out how long each node and the whole encoding are.
+            case measuring
+            /// Write each node's length, already measured, before its content.
+            case writing
+        }
+
         init() {
             // We allocate a 1kB array because that should cover us most of the time.
             self.serializedBytes = []
             self.serializedBytes.reserveCapacity(1024)
+            self.mode = .appending
+            self.contentLengths = []
+        }
+
+        private init(measuring: ()) {
+            self.serializedBytes = []
+            self.mode = .measuring
+            self.contentLengths = []
+        }
+
+        private init(writing measurer: Serializer) {
+            self.serializedBytes = []
+            self.serializedBytes.reserveCapacity(measurer.measuredByteCount)
+            self.mode = .writing
+            self.contentLengths = measurer.contentLengths
+        }
+
+        /// Serializes in two passes: the first works out the exact length of every node, and the second writes each
+        /// node straight into a buffer of exactly the right size, so no content is ever moved to make room for a length.
+        ///
+        /// `body` is called once per pass, and must serialize the same nodes both times.
+        static func serialize(_ body: (inout Serializer) throws -> Void) rethrows -> [UInt8] {
+            var measurer = Serializer(measuring: ())
+            try body(&measurer)
+
+            var writer = Serializer(writing: measurer)
+            try body(&writer)
+            assert(writer.serializedBytes.count == measurer.measuredByteCount)
+            assert(writer.nextContentLength == writer.contentLengths.count)
+            return writer.serializedBytes
+        }
+
+        /// Serializes a node in two passes, as `serialize(_:)` does.
+        static func serializedBytes<T: ASN1Serializable>(of node: T) throws -> [UInt8] {
+            try Serializer.serialize { try $0.serialize(node) }
         }
 
         /// Appends a single, non-constructed node to the content.
         mutating func appendPrimitiveNode(identifier: ASN1.ASN1Identifier, _ contentWriter: (inout [UInt8]) throws -> Void) rethrows {
             assert(identifier.primitive)
-            try self._appendNode(identifier: identifier) { try contentWriter(&$0.serializedBytes) }
+            try self._appendNode(identifier: identifier) { coder in
+                try contentWriter(&coder.serializedBytes)
+                coder.discardMeasuredBytes()
+            }
+        }
+
+        /// Appends bytes that are already DER, such as a complete encoded node, to the content.
+        mutating func appendEncodedBytes<Bytes: Collection>(_ bytes: Bytes) where Bytes.Element == UInt8 {
+            if case .measuring = self.mode {
+                self.measuredByteCount += bytes.count
+            } else {
+                self.serializedBytes.append(contentsOf: bytes)
+            }
+        }
+
+        /// When measuring, primitive content is written to a scratch buffer so that it can be counted. This counts
+        /// and clears it, keeping the storage for the next one.
+        private mutating func discardMeasuredBytes() {
+            if case .measuring = self.mode {
+                self.measuredByteCount += self.serializedBytes.count
+                self.serializedBytes.removeAll(keepingCapacity: true)
+            }
         }
 
         mutating func appendConstructedNode(identifier: ASN1.ASN1Identifier, _ contentWriter: (inout Serializer) throws -> Void) rethrows {
@@ -493,7 +589,7 @@ extension ASN1 {
                         coder.serialize(node)
                     }
                 case .primitive(let baseData):
-                    coder.serializedBytes.append(contentsOf: baseData)
+                    coder.appendEncodedBytes(baseData)
                 }
             }
         }
@@ -501,6 +597,31 @@ extension ASN1 {
         // This is the base logical function that all other append methods are built on. This one has most of the logic, and doesn't
         // police what we expect to happen in the content writer.
         private mutating func _appendNode(identifier: ASN1.ASN1Identifier, _ contentWriter: (inout Serializer) throws -> Void) rethrows {
+            switch self.mode {
+            case .appending:
+                try self._appendNodeMovingContent(identifier: identifier, contentWriter)
+
+            case .measuring:
+                let lengthIndex = self.contentLengths.endIndex
+                self.contentLengths.append(0)
+                let contentStart = self.measuredByteCount
+                try contentWriter(&self)
+                let contentLength = self.measuredByteCount - contentStart
+                self.contentLengths[lengthIndex] = contentLength
+                self.measuredByteCount += 1 + contentLength.bytesNeededToEncode
+
+            case .writing:
+                let contentLength = self.contentLengths[self.nextContentLength]
+                self.nextContentLength += 1
+                self.serializedBytes.writeIdentifier(identifier)
+                self.serializedBytes.writeLength(contentLength)
+                let contentStart = self.serializedBytes.endIndex
+                try contentWriter(&self)
+                precondition(self.serializedBytes.endIndex - contentStart == contentLength, "Node serialized differently when measured")
+            }
+        }
+
+        private mutating func _appendNodeMovingContent(identifier: ASN1.ASN1Identifier, _ contentWriter: (inout Serializer) throws -> Void) rethrows {
             // This is a tricky game to play. We want to write the identifier and the length, but we don't know what the
             // length is here. To get around that, we _assume_ the length will be one byte, and let the writer write their content.
             // If it turns out to have been longer, we recalculate how many bytes we need and shuffle them in the buffer,
@@ -680,6 +801,19 @@ extension Array where Element == UInt8 {
         self.append(identifier.baseTag)
     }
 
+    fileprivate mutating func writeLength(_ length: Int) {
+        let lengthBytesNeeded = length.bytesNeededToEncode
+        if lengthBytesNeeded == 1 {
+            self.append(UInt8(length))
+            return
+        }
+
+        self.append(0x80 | UInt8(lengthBytesNeeded - 1))
+        for shift in (0..<(lengthBytesNeeded - 1)).reversed() {
+            self.append(UInt8(truncatingIfNeeded: length >> (shift * 8)))
+        }
+    }
+
     fileprivate mutating func moveRange(offset: Int, range: Range<Index>) {
         // We only bothered to implement this for positive offsets for now, the algorithm
         // generalises.
@@ -28,29 +28,20 @@ extension ASN1 {
         fileprivate var serializedBytes: ArraySlice<UInt8>
 
         init<ASN1Type: ASN1Serializable>(erasing: ASN1Type) throws {
-            var serializer = ASN1.Serializer()
-            try erasing.serialize(into: &serializer)
-            self.serializedBytes = ArraySlice(serializer.serializedBytes)
+            self.serializedBytes = ArraySlice(try ASN1.Serializer.serializedBytes(of: erasing))
         }
 
         init<ASN1Type: ASN1ImplicitlyTaggable>(erasing: ASN1Type, withIdentifier identifier: ASN1.ASN1Identifier) throws {
-            var serializer = ASN1.Serializer()
-            try erasing.serialize(into: &serializer, withIdentifier: identifier)
-            self.serializedBytes = ArraySlice(serializer.serializedBytes)
+            self.serializedBytes = ArraySlice(try ASN1.Serializer.serialize { try erasing.serialize(into: &$0, withIdentifier: identifier) })
         }
 
         init(asn1Encoded rootNode: ASN1.ASN1Node) {
-            // This is a bit sad: we just re-serialize this data. In an ideal world
-            // we'd update the parse representation so that all nodes can point at their
-            // complete backing storage, but for now this is better.
-            var serializer = ASN1.Serializer()
-            serializer.serialize(rootNode)
-            self.serializedBytes = ArraySlice(serializer.serializedBytes)
+            // Parsed nodes point at their complete backing storage, so there is no need to re-serialize them.
+            self.serializedBytes = rootNode.encodedBytes
         }
 
         func serialize(into coder: inout ASN1.Serializer) throws {
-            // Dangerous to just reach in there like this, but it's the right way to serialize this.
-            coder.serializedBytes.append(contentsOf: self.serializedBytes)
+            coder.appendEncodedBytes(self.serializedBytes)
         }
     }
 }
@@ -22,12 +22,35 @@ extension ASN1 {
     /// It represents a node in an OID hierarchy, and is usually represented as an ordered sequence of numbers.
     ///
     /// We mostly don't care about the semantics of the thing, we just care about being able to store and compare them.
+    ///
+    /// The OIDs this module knows by name are interned: parsing one matches its encoded bytes against a table and
+    /// stores only its index, so it is never decoded into components, allocates nothing and compares as an integer.
     struct ASN1ObjectIdentifier: ASN1ImplicitlyTaggable {
         static var defaultIdentifier: ASN1.ASN1Identifier {
             .objectIdentifier
         }
 
-        private var oidComponents: [UInt]
+        private enum Storage: Hashable {
+            /// An index into ``InternedObjectIdentifiers``.
+            case interned(Int)
+
+            /// Any other OID. This never holds the components of an interned OID, so that each OID has only one
+            /// representation and the synthesized equality and hashing are correct.
+            case components([UInt])
+        }
+
+        private var storage: Storage
+
+        private init(components: [UInt]) {
+            self.storage = Self.storage(for: components)
+        }
+
+        private static func storage(for components: [UInt]) -> Storage {
+            if let index = InternedObjectIdentifiers.components.firstIndex(of: components) {
+                return .interned(index)
+            }
+            return .components(components)
+        }
 
         init(asn1Encoded node: ASN1.ASN1Node, withIdentifier identifier: ASN1.ASN1Identifier) throws {
             guard node.identifier == identifier else {
@@ -38,6 +61,11 @@ extension ASN1 {
                 preconditionFailure("ASN.1 parser generated primitive node with constructed content")
             }
 
+            if let index = InternedObjectIdentifiers.index(ofEncoding: content) {
+                self.storage = .interned(index)
+                return
+            }
+
             // We have to parse the content. From the spec:
             //
             // > Each subidentifier is represented as a series of (one or more) octets. Bit 8 of each octet indicates whether it
@@ -59,50 +87,66 @@ extension ASN1 {
             // Yeah, this is a bit bananas, but basically there are only 3 first OID components (0, 1, 2) and there are no more than 39 children
             // of nodes 0 or 1. In my view this is too clever by half, but the ITU.T didn't ask for my opinion when they were coming up with this
             // scheme, likely because I was in middle school at the time.
-            var subcomponents = [UInt]()
-            while content.count > 0 {
-                subcomponents.append(try content.readOIDSubidentifier())
-            }
+            //
+            // Each subidentifier takes at least one byte, so the content length (plus one for the split first
+            // subidentifier) bounds the number of components, and we can decode straight into a single allocation.
+            var oidComponents = [UInt]()
+            oidComponents.reserveCapacity(content.count + 1)
 
-            guard subcomponents.count >= 2 else {
+            guard content.count > 0 else {
                 throw CryptoKitASN1Error.invalidObjectIdentifier
             }
 
-            // Now we need to expand the subcomponents out. This means we need to undo the step above. The first component will be in the range 0..<40
+            // Now we need to expand the first subcomponent out. This means we need to undo the step above. The first component will be in the range 0..<40
             // when the first oidComponent is 0, 40..<80 when the first oidComponent is 1, and 80+ when the first oidComponent is 2.
-            var oidComponents = [UInt]()
-            oidComponents.reserveCapacity(subcomponents.count + 1)
-
-            switch subcomponents.first! {
+            let firstSubcomponent = try content.readOIDSubidentifier()
+            switch firstSubcomponent {
             case ..<40:
                 oidComponents.append(0)
-                oidComponents.append(subcomponents.first!)
+                oidComponents.append(firstSubcomponent)
             case 40 ..< 80:
                 oidComponents.append(1)
-                oidComponents.append(subcomponents.first! - 40)
+                oidComponents.append(firstSubcomponent - 40)
             default:
                 oidComponents.append(2)
-                oidComponents.append(subcomponents.first! - 80)
+                oidComponents.append(firstSubcomponent - 80)
+            }
+
+            while content.count > 0 {
+                oidComponents.append(try content.readOIDSubidentifier())
             }
 
-            oidComponents.append(contentsOf: subcomponents.dropFirst())
+            // We require at least two subidentifiers, which expand to at least three components.
+            guard oidComponents.count >= 3 else {
+                throw CryptoKitASN1Error.invalidObjectIdentifier
+            }
 
-            self.oidComponents = oidComponents
+            // A non-minimal encoding of an interned OID ends up here, and must still be interned.
+            self.storage = Self.storage(for: oidComponents)
         }
 
         func serialize(into coder: inout ASN1.Serializer, withIdentifier identifier: ASN1.ASN1Identifier) throws {
             coder.appendPrimitiveNode(identifier: identifier) { bytes in
-                var components = self.oidComponents[...]
-                guard let firstComponent = components.popFirst(), let secondComponent = components.popFirst() else {
-                    preconditionFailure("Invalid number of OID components: must be at least two!")
+                switch self.storage {
+                case .interned(let index):
+                    bytes.append(contentsOf: InternedObjectIdentifiers.encodings[index])
+                case .components(let components):
+                    ASN1ObjectIdentifier.writeOIDComponents(components, into: &bytes)
                 }
+            }
+        }
 
-                let serializedFirstComponent = (firstComponent * 40) + secondComponent
-                ASN1ObjectIdentifier.writeOIDSubidentifier(serializedFirstComponent, into: &bytes)
+        fileprivate static func writeOIDComponents(_ components: [UInt], into bytes: inout [UInt8]) {
+            var components = components[...]
+            guard let firstComponent = components.popFirst(), let secondComponent = components.popFirst() else {
+                preconditionFailure("Invalid number of OID components: must be at least two!")
+            }
 
-                while let component = components.popFirst() {
-                    ASN1ObjectIdentifier.writeOIDSubidentifier(component, into: &bytes)
-                }
+            let serializedFirstComponent = (firstComponent * 40) + secondComponent
+            ASN1ObjectIdentifier.writeOIDSubidentifier(serializedFirstComponent, into: &bytes)
+
+            while let component = components.popFirst() {
+                ASN1ObjectIdentifier.writeOIDSubidentifier(component, into: &bytes)
             }
         }
 
@@ -135,7 +179,7 @@ extension ASN1.ASN1ObjectIdentifier: Hashable {}
 
 extension ASN1.ASN1ObjectIdentifier: ExpressibleByArrayLiteral {
         init(arrayLiteral elements: UInt...) {
-            self.oidComponents = elements
+            self.init(components: elements)
         }
     }
 
@@ -180,6 +224,53 @@ extension ASN1.ASN1ObjectIdentifier {
 
 }
 
+/// The OIDs named in ``ASN1/ASN1ObjectIdentifier``'s extensions, which parse without allocating. Keep this in step
+/// with those names; an OID missing here still works, it just isn't interned.
+private enum InternedObjectIdentifiers {
+    static let components: [[UInt]] = [
+        // Named curves.
+        [1, 2, 840, 10_045, 3, 1, 7],
+        [1, 3, 132, 0, 34],
+        [1, 3, 132, 0, 35],
+        // Hash functions.
+        [2, 16, 840, 1, 101, 3, 4, 2, 1],
+        [2, 16, 840, 1, 101, 3, 4, 2, 2],
+        [2, 16, 840, 1, 101, 3, 4, 2, 3],
+        // Algorithm identifiers.
+        [1, 2, 840, 10_045, 2, 1],
+        // Name attributes.
+        [2, 5, 4, 41],
+        [2, 5, 4, 4],
+        [2, 5, 4, 42],
+        [2, 5, 4, 43],
+        [2, 5, 4, 44],
+        [2, 5, 4, 3],
+        [2, 5, 4, 7],
+        [2, 5, 4, 8],
+        [2, 5, 4, 10],
+        [2, 5, 4, 11],
+        [2, 5, 4, 12],
+        [2, 5, 4, 46],
+        [2, 5, 4, 6],
+        [2, 5, 4, 5],
+        [2, 5, 4, 65],
+        [0, 9, 2342, 19_200_300, 100, 1, 25],
+        [1, 2, 840, 113_549, 1, 9, 1],
+    ]
+
+    /// The DER content octets of each of ``components``.
+    static let encodings: [[UInt8]] = components.map { components in
+        var bytes: [UInt8] = []
+        ASN1.ASN1ObjectIdentifier.writeOIDComponents(components, into: &bytes)
+        return bytes
+    }
+
+    static func index(ofEncoding content: ArraySlice<UInt8>) -> Int? {
+        // Short enough that a linear scan, mostly rejecting on length or the first byte, beats hashing the slice.
+        encodings.firstIndex { $0.count == content.count && $0.first == content.first && $0.elementsEqual(content) }
+    }
+}
+
 extension ArraySlice where Element == UInt8 {
     mutating fileprivate func readOIDSubidentifier() throws -> UInt {
         // In principle OID subidentifiers can be too large to fit into a UInt. We are choosing to not care about that
@@ -52,7 +52,7 @@ extension ASN1 {
                 throw CryptoKitASN1Error.invalidPEMDocument
             }
 
-            guard let derBytes = Data(base64Encoded: lines.joined()) else {
+            guard let derBytes = Data(pemBase64Lines: lines) else {
                 throw CryptoKitASN1Error.invalidPEMDocument
             }
 
@@ -86,6 +86,136 @@ extension ASN1 {
     }
 }
 
+// MARK: - Base64 decoding
+
+extension Data {
+    /// Decodes the base64 body of a PEM document, given as its individual lines.
+    ///
+    /// This accepts exactly what `Data(base64Encoded:)` accepts for the joined lines, but decodes each line
+    /// straight from its UTF-8 storage into a single output buffer, without joining the lines into an intermediate
+    /// string first. Each line other than the last must be a whole number of 4-character groups, which holds for
+    /// the 64-character lines that PEM requires.
+    init?<Lines: BidirectionalCollection>(pemBase64Lines lines: Lines) where Lines.Element == Substring {
+        let characterCount = lines.reduce(0) { $0 + $1.utf8.count }
+        guard characterCount % 4 == 0 else {
+            return nil
+        }
+
+        var output = Data(count: (characterCount / 4) * 3)
+        let writtenCount: Int? = output.withUnsafeMutableBytes { outputPointer in
+            var written = 0
+            var lineIndex = lines.startIndex
+            while lineIndex != lines.endIndex {
+                let line = lines[lineIndex]
+                lines.formIndex(after: &lineIndex)
+                let isLastLine = lineIndex == lines.endIndex
+
+                let lineWritten: Int? = line.utf8.withContiguousStorageIfAvailable { linePointer in
+                    Base64.decode(linePointer, allowingPadding: isLastLine, into: outputPointer, at: written)
+                } ?? Array(line.utf8).withUnsafeBufferPointer { linePointer in
+                    Base64.decode(linePointer, allowingPadding: isLastLine, into: outputPointer, at: written)
+                }
+
+                guard let lineWritten = lineWritten else {
+                    return nil
+                }
+                written += lineWritten
+            }
+            return written
+        }
+
+        guard let writtenCount = writtenCount else {
+            return nil
+        }
+        output.removeSubrange(writtenCount...)
+        self = output
+    }
+}
+
+enum Base64 {
+    /// Maps each ASCII byte to its 6-bit value, or to 0xFF if it is not part of the base64 alphabet.
+    private static let decodingTable: [UInt8] = {
+        var table = [UInt8](repeating: 0xFF, count: 256)
+        for (value, character) in "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/".utf8.enumerated() {
+            table[Int(character)] = UInt8(value)
+        }
+        return table
+    }()
+
+    /// Decodes `input`, which must be a whole number of 4-character groups, into `output` starting at `offset`.
+    ///
+    /// Padding is only accepted in the final group, and only if `allowingPadding` is set. Returns the number of bytes
+    /// written, or `nil` if the input is not valid base64.
+    static func decode(
+        _ input: UnsafeBufferPointer<UInt8>,
+        allowingPadding: Bool,
+        into output: UnsafeMutableRawBufferPointer,
+        at offset: Int
+    ) -> Int? {
+        guard input.count % 4 == 0 else {
+            return nil
+        }
+        guard input.count > 0 else {
+            return 0
+        }
+
+        return Self.decodingTable.withUnsafeBufferPointer { table in
+            var written = offset
+            var index = 0
+
+            // Every group but the last is unpadded. Invalid characters map to 0xFF, so a single check of the top
+            // bit of all four lookups rejects them.
+            let unpaddedCount = input.count - 4
+            while index < unpaddedCount {
+                let a = table[Int(input[index])]
+                let b = table[Int(input[index + 1])]
+                let c = table[Int(input[index + 2])]
+                let d = table[Int(input[index + 3])]
+                guard (a | b | c | d) & 0x80 == 0 else {
+                    return nil
+                }
+
+                let word = UInt32(a) << 18 | UInt32(b) << 12 | UInt32(c) << 6 | UInt32(d)
+                output[written] = UInt8(truncatingIfNeeded: word >> 16)
+                output[written + 1] = UInt8(truncatingIfNeeded: word >> 8)
+                output[written + 2] = UInt8(truncatingIfNeeded: word)
+                written += 3
+                index += 4
+            }
+
+            // The last group may end in "=" or "==".
+            let padding: Int
+            if allowingPadding && input[index + 3] == UInt8(ascii: "=") {
+                padding = input[index + 2] == UInt8(ascii: "=") ? 2 : 1
+            } else {
+                padding = 0
+            }
+
+            let a = table[Int(input[index])]
+            let b = table[Int(input[index + 1])]
+            let c = padding >= 2 ? 0 : table[Int(input[index + 2])]
+            let d = padding >= 1 ? 0 : table[Int(input[index + 3])]
+            guard (a | b | c | d) & 0x80 == 0 else {
+                return nil
+            }
+
+            let word = UInt32(a) << 18 | UInt32(b) << 12 | UInt32(c) << 6 | UInt32(d)
+            output[written] = UInt8(truncatingIfNeeded: word >> 16)
+            written += 1
+            if padding < 2 {
+                output[written] = UInt8(truncatingIfNeeded: word >> 8)
+                written += 1
+            }
+            if padding < 1 {
+                output[written] = UInt8(truncatingIfNeeded: word)
+                written += 1
+            }
+
+            return written - offset
+        }
+    }
+}
+
 extension Substring {
     fileprivate var pemStartDiscriminator: String? {
         return self.pemDiscriminator(expectedPrefix: "-----BEGIN ", expectedSuffix: "-----")
@@ -90,9 +90,7 @@ extension ASN1 {
                 try coder.serialize(self.algorithm)
 
                 // Here's a weird one: we recursively serialize the private key, and then turn the bytes into an octet string.
-                var subCoder = ASN1.Serializer()
-                try subCoder.serialize(self.privateKey)
-                let serializedKey = ASN1.ASN1OctetString(contentBytes: subCoder.serializedBytes[...])
+                let serializedKey = ASN1.ASN1OctetString(contentBytes: try ASN1.Serializer.serializedBytes(of: self.privateKey)[...])
 
                 try coder.serialize(serializedKey)
             }
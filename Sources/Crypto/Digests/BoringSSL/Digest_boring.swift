@@ -15,133 +15,132 @@
 @_exported import CryptoKit
 #else
 @_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
 
 protocol HashFunctionImplementationDetails: HashFunction where Digest: DigestPrivate {}
 
+/// A hash function whose state is a plain BoringSSL context struct, driven through its low-level
+/// `Init`/`Update`/`Final` functions rather than through `EVP_MD_CTX`.
 protocol BoringSSLBackedHashFunction: HashFunctionImplementationDetails {
-    static var digestType: DigestContext.DigestType { get }
+    associatedtype Context
+
+    static func initialize(_ context: UnsafeMutablePointer<Context>)
+
+    static func update(_ context: UnsafeMutablePointer<Context>, _ data: UnsafeRawBufferPointer)
+
+    static func finalize(_ context: UnsafeMutablePointer<Context>, into digest: UnsafeMutablePointer<UInt8>)
 }
 
 extension Insecure.MD5: BoringSSLBackedHashFunction {
-    static var digestType: DigestContext.DigestType {
-        .md5
+    static func initialize(_ context: UnsafeMutablePointer<MD5_CTX>) {
+        CCryptoBoringSSL_MD5_Init(context)
     }
-}
 
-extension Insecure.SHA1: BoringSSLBackedHashFunction {
-    static var digestType: DigestContext.DigestType {
-        .sha1
+    static func update(_ context: UnsafeMutablePointer<MD5_CTX>, _ data: UnsafeRawBufferPointer) {
+        CCryptoBoringSSL_MD5_Update(context, data.baseAddress, data.count)
     }
-}
 
-extension SHA256: BoringSSLBackedHashFunction {
-    static var digestType: DigestContext.DigestType {
-        .sha256
+    static func finalize(_ context: UnsafeMutablePointer<MD5_CTX>, into digest: UnsafeMutablePointer<UInt8>) {
+        CCryptoBoringSSL_MD5_Final(digest, context)
     }
 }
 
-extension SHA384: BoringSSLBackedHashFunction {
-    static var digestType: DigestContext.DigestType {
-        .sha384
+extension Insecure.SHA1: BoringSSLBackedHashFunction {
+    static func initialize(_ context: UnsafeMutablePointer<SHA_CTX>) {
+        CCryptoBoringSSL_SHA1_Init(context)
     }
-}
 
-extension SHA512: BoringSSLBackedHashFunction {
-    static var digestType: DigestContext.DigestType {
-        .sha512
+    static func update(_ context: UnsafeMutablePointer<SHA_CTX>, _ data: UnsafeRawBufferPointer) {
+        CCryptoBoringSSL_SHA1_Update(context, data.baseAddress, data.count)
     }
-}
 
-struct OpenSSLDigestImpl<H: BoringSSLBackedHashFunction> {
-    private var context: DigestContext
+    static func finalize(_ context: UnsafeMutablePointer<SHA_CTX>, into digest: UnsafeMutablePointer<UInt8>) {
+        CCryptoBoringSSL_SHA1_Final(digest, context)
+    }
+}
 
-    init() {
-        self.context = DigestContext(digest: H.digestType)
+extension SHA256: BoringSSLBackedHashFunction {
+    static func initialize(_ context: UnsafeMutablePointer<SHA256_CTX>) {
+        CCryptoBoringSSL_SHA256_Init(context)
     }
 
-    internal mutating func update(data: UnsafeRawBufferPointer) {
-        if !isKnownUniquelyReferenced(&self.context) {
-            self.context = DigestContext(copying: self.context)
-        }
-        self.context.update(data: data)
+    static func update(_ context: UnsafeMutablePointer<SHA256_CTX>, _ data: UnsafeRawBufferPointer) {
+        CCryptoBoringSSL_SHA256_Update(context, data.baseAddress, data.count)
     }
 
-    internal func finalize() -> H.Digest {
-        // To have a non-destructive finalize operation we must allocate.
-        let copyContext = DigestContext(copying: self.context)
-        let digestBytes = copyContext.finalize()
-        return digestBytes.withUnsafeBytes {
-            // We force unwrap here because if the digest size is wrong it's an internal error.
-            H.Digest(bufferPointer: $0)!
-        }
+    static func finalize(_ context: UnsafeMutablePointer<SHA256_CTX>, into digest: UnsafeMutablePointer<UInt8>) {
+        CCryptoBoringSSL_SHA256_Final(digest, context)
     }
 }
 
-class DigestContext {
-    private var contextPointer: UnsafeMutablePointer<EVP_MD_CTX>
-
-    init(digest: DigestType) {
-        // We force unwrap because we cannot recover from allocation failure.
-        self.contextPointer = CCryptoBoringSSL_EVP_MD_CTX_new()!
-        guard CCryptoBoringSSL_EVP_DigestInit(self.contextPointer, digest.dispatchTable) != 0 else {
-            // We can't do much but crash here.
-            fatalError("Unable to initialize digest state: \(CCryptoBoringSSL_ERR_get_error())")
-        }
+extension SHA384: BoringSSLBackedHashFunction {
+    static func initialize(_ context: UnsafeMutablePointer<SHA512_CTX>) {
+        CCryptoBoringSSL_SHA384_Init(context)
     }
 
-    init(copying original: DigestContext) {
-        // We force unwrap because we cannot recover from allocation failure.
-        self.contextPointer = CCryptoBoringSSL_EVP_MD_CTX_new()!
-        guard CCryptoBoringSSL_EVP_MD_CTX_copy(self.contextPointer, original.contextPointer) != 0 else {
-            // We can't do much but crash here.
-            fatalError("Unable to copy digest state: \(CCryptoBoringSSL_ERR_get_error())")
-        }
+    static func update(_ context: UnsafeMutablePointer<SHA512_CTX>, _ data: UnsafeRawBufferPointer) {
+        CCryptoBoringSSL_SHA384_Update(context, data.baseAddress, data.count)
     }
 
-    func update(data: UnsafeRawBufferPointer) {
-        guard let baseAddress = data.baseAddress else {
-            return
-        }
-
-        CCryptoBoringSSL_EVP_DigestUpdate(self.contextPointer, baseAddress, data.count)
+    static func finalize(_ context: UnsafeMutablePointer<SHA512_CTX>, into digest: UnsafeMutablePointer<UInt8>) {
+        CCryptoBoringSSL_SHA384_Final(digest, context)
     }
+}
 
-    // This finalize function is _destructive_: do not call it if you want to reuse the object!
-    func finalize() -> [UInt8] {
-        let digestSize = CCryptoBoringSSL_EVP_MD_size(self.contextPointer.pointee.digest)
-        var digestBytes = Array(repeating: UInt8(0), count: digestSize)
-        var count = UInt32(digestSize)
-
-        digestBytes.withUnsafeMutableBufferPointer { digestPointer in
-            assert(digestPointer.count == count)
-            CCryptoBoringSSL_EVP_DigestFinal(self.contextPointer, digestPointer.baseAddress, &count)
-        }
+extension SHA512: BoringSSLBackedHashFunction {
+    static func initialize(_ context: UnsafeMutablePointer<SHA512_CTX>) {
+        CCryptoBoringSSL_SHA512_Init(context)
+    }
 
-        return digestBytes
+    static func update(_ context: UnsafeMutablePointer<SHA512_CTX>, _ data: UnsafeRawBufferPointer) {
+        CCryptoBoringSSL_SHA512_Update(context, data.baseAddress, data.count)
     }
 
-    deinit {
-        CCryptoBoringSSL_EVP_MD_CTX_free(self.contextPointer)
+    static func finalize(_ context: UnsafeMutablePointer<SHA512_CTX>, into digest: UnsafeMutablePointer<UInt8>) {
+        CCryptoBoringSSL_SHA512_Final(digest, context)
     }
 }
 
-extension DigestContext {
-    struct DigestType {
-        var dispatchTable: OpaquePointer
-
-        private init(_ dispatchTable: OpaquePointer) {
-            self.dispatchTable = dispatchTable
-        }
+/// Hash state stored inline, so hashers are plain values: creating, copying and finalizing one never allocates.
+struct OpenSSLDigestImpl<H: BoringSSLBackedHashFunction> {
+    // Raw storage for an `H.Context`, sized for the largest of them, `SHA512_CTX`. It is only ever read and
+    // written by BoringSSL.
+    private var state: (UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64) = (0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0)
 
-        static let md5 = DigestType(CCryptoBoringSSL_EVP_md5())
+    init() {
+        self.withContext { H.initialize($0) }
+    }
 
-        static let sha1 = DigestType(CCryptoBoringSSL_EVP_sha1())
+    internal mutating func update(data: UnsafeRawBufferPointer) {
+        guard data.baseAddress != nil else {
+            return
+        }
+        CCryptoBoringSSLShims_count_digest_update(data.count)
+        self.withContext { H.update($0, data) }
+    }
 
-        static let sha256 = DigestType(CCryptoBoringSSL_EVP_sha256())
+    internal func finalize() -> H.Digest {
+        // Finalizing is destructive, so work on a copy; being a value, the copy costs nothing but stack space.
+        var copy = self
+        defer {
+            copy.withContext { CCryptoBoringSSL_OPENSSL_cleanse($0, MemoryLayout<H.Context>.size) }
+        }
 
-        static let sha384 = DigestType(CCryptoBoringSSL_EVP_sha384())
+        var digestBytes = (UInt64(0), UInt64(0), UInt64(0), UInt64(0), UInt64(0), UInt64(0), UInt64(0), UInt64(0))
+        return withUnsafeMutableBytes(of: &digestBytes) { digestPointer in
+            copy.withContext { H.finalize($0, into: digestPointer.baseAddress!.assumingMemoryBound(to: UInt8.self)) }
+            // We force unwrap here because if the digest size is wrong it's an internal error.
+            return H.Digest(bufferPointer: UnsafeRawBufferPointer(rebasing: digestPointer.prefix(H.Digest.byteCount)))!
+        }
+    }
 
-        static let sha512 = DigestType(CCryptoBoringSSL_EVP_sha512())
+    private mutating func withContext<ReturnValue>(
+        _ body: (UnsafeMutablePointer<H.Context>) -> ReturnValue
+    ) -> ReturnValue {
+        withUnsafeMutableBytes(of: &self.state) { statePointer in
+            precondition(MemoryLayout<H.Context>.size <= statePointer.count, "Digest state storage is too small")
+            return body(statePointer.baseAddress!.assumingMemoryBound(to: H.Context.self))
+        }
     }
 }
 #endif // CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
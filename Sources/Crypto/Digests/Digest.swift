@@ -81,7 +81,7 @@ extension Digest {
     }
 
     public var description: String {
-        return "\(Self.self): \(Array(self).hexString)"
+        return "\(Self.self): \(self.withUnsafeBytes { $0.hexString })"
     }
 }
 #endif // Linux or !SwiftPM
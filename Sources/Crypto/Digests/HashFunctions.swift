@@ -147,6 +147,10 @@ extension HashFunction {
     /// instances.
     @inlinable
     public mutating func update<D: DataProtocol>(data: D) {
+        // Contiguous inputs, like `Data` and `[UInt8]`, skip the walk over `regions` once the caller specializes `D`.
+        if data.withContiguousStorageIfAvailable({ self.update(bufferPointer: UnsafeRawBufferPointer($0)) }) != nil {
+            return
+        }
         data.regions.forEach { (regionData) in
             regionData.withUnsafeBytes({ (dataPtr) in
                 self.update(bufferPointer: dataPtr)
@@ -0,0 +1,209 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+@_exported import CryptoKit
+#else
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+import Foundation
+
+extension HPKE {
+    /// An HPKE context set up and driven by BoringSSL's `EVP_HPKE_CTX`, which keeps the AEAD key expanded between
+    /// messages and derives each nonce in place.
+    ///
+    /// BoringSSL implements DHKEM(X25519) with HKDF-SHA256 in the base and auth modes, for the AES-GCM and
+    /// ChaCha20-Poly1305 AEADs. Every other suite and mode uses ``KeySchedule``.
+    final class BoringSSLContext {
+        private let ctx: OpaquePointer
+
+        private let aead: HPKE.AEAD
+
+        private init(aead: HPKE.AEAD) {
+            self.ctx = CCryptoBoringSSLShims_EVP_HPKE_CTX_new()!
+            self.aead = aead
+        }
+
+        deinit {
+            CCryptoBoringSSLShims_EVP_HPKE_CTX_free(self.ctx)
+        }
+
+        /// Whether BoringSSL implements this cipher suite and mode.
+        static func supports(_ ciphersuite: Ciphersuite, mode: Mode) -> Bool {
+            guard ciphersuite.kem == .Curve25519_HKDF_SHA256, ciphersuite.kdf == .HKDF_SHA256 else {
+                return false
+            }
+            switch (ciphersuite.aead, mode) {
+            case (.AES_GCM_128, .base), (.AES_GCM_256, .base), (.chaChaPoly, .base),
+                 (.AES_GCM_128, .auth), (.AES_GCM_256, .auth), (.chaChaPoly, .auth):
+                return true
+            default:
+                return false
+            }
+        }
+
+        /// Sets up a sender, or returns `nil` if BoringSSL refuses to, in which case the caller should use
+        /// ``KeySchedule`` instead. That happens only for a low-order recipient key, whose all-zero shared secret
+        /// BoringSSL rejects but this package deliberately accepts.
+        static func sender(
+            ciphersuite: Ciphersuite, recipientKey: Curve25519.KeyAgreement.PublicKey,
+            authenticationKey: Curve25519.KeyAgreement.PrivateKey?, info: Data
+        ) -> (context: BoringSSLContext, encapsulated: Data)? {
+            let context = BoringSSLContext(aead: ciphersuite.aead)
+            var encapsulated = Data(repeating: 0, count: Curve25519.KeyAgreement.keySizeBytes)
+            let authenticationPublicKey = authenticationKey?.publicKey.keyBytes
+
+            let rc = encapsulated.withUnsafeMutableBytes { encapsulated in
+                info.withUnsafeBytes { info in
+                    Self.withOptionalBytes(authenticationKey?.key) { authenticationPrivateKey in
+                        Self.withOptionalBytes(authenticationPublicKey) { authenticationPublicKey in
+                            CCryptoBoringSSLShims_EVP_HPKE_CTX_setup_x25519_sender(
+                                context.ctx, ciphersuite.aead.value,
+                                encapsulated.baseAddress?.assumingMemoryBound(to: UInt8.self),
+                                recipientKey.keyBytes,
+                                authenticationPrivateKey?.baseAddress?.assumingMemoryBound(to: UInt8.self),
+                                authenticationPublicKey?.baseAddress?.assumingMemoryBound(to: UInt8.self),
+                                info.baseAddress, info.count
+                            )
+                        }
+                    }
+                }
+            }
+            guard rc == 1 else {
+                return nil
+            }
+            return (context, encapsulated)
+        }
+
+        /// Sets up a recipient, or returns `nil` if BoringSSL refuses to, in which case the caller should use
+        /// ``KeySchedule`` instead, as for ``sender(ciphersuite:recipientKey:authenticationKey:info:)``.
+        static func recipient(
+            ciphersuite: Ciphersuite, privateKey: Curve25519.KeyAgreement.PrivateKey, encapsulated: Data,
+            authenticationKey: Curve25519.KeyAgreement.PublicKey?, info: Data
+        ) throws -> BoringSSLContext? {
+            // Reject a malformed encapsulated key the way the key schedule does.
+            guard encapsulated.count == Curve25519.KeyAgreement.keySizeBytes else {
+                throw CryptoKitError.incorrectKeySize
+            }
+            let context = BoringSSLContext(aead: ciphersuite.aead)
+            let publicKey = privateKey.publicKey.keyBytes
+
+            let rc = privateKey.key.withUnsafeBytes { privateKey in
+                encapsulated.withUnsafeBytes { encapsulated in
+                    info.withUnsafeBytes { info in
+                        Self.withOptionalBytes(authenticationKey?.keyBytes) { authenticationKey in
+                            CCryptoBoringSSLShims_EVP_HPKE_CTX_setup_x25519_recipient(
+                                context.ctx, ciphersuite.aead.value,
+                                privateKey.baseAddress?.assumingMemoryBound(to: UInt8.self), publicKey,
+                                encapsulated.baseAddress?.assumingMemoryBound(to: UInt8.self), encapsulated.count,
+                                authenticationKey?.baseAddress?.assumingMemoryBound(to: UInt8.self),
+                                info.baseAddress, info.count
+                            )
+                        }
+                    }
+                }
+            }
+            guard rc == 1 else {
+                return nil
+            }
+            return context
+        }
+
+        /// A context in the same state as this one, that seals or opens independently of it.
+        func copy() -> BoringSSLContext {
+            let copy = BoringSSLContext(aead: self.aead)
+            // Only fails for AEADs this type never sets up.
+            precondition(CCryptoBoringSSLShims_EVP_HPKE_CTX_copy(copy.ctx, self.ctx) == 1)
+            return copy
+        }
+
+        var exporterSecret: SymmetricKey {
+            let secret = SymmetricKey(unsafeUninitializedCapacity: Int(EVP_MAX_MD_SIZE)) { secret, count in
+                count = CCryptoBoringSSLShims_EVP_HPKE_CTX_exporter_secret(self.ctx, secret.baseAddress, secret.count)
+            }
+            precondition(secret.byteCount > 0)
+            return secret
+        }
+
+        /// Matches the sequence number limit of ``KeySchedule``, which is far below BoringSSL's.
+        private func checkSequenceNumber() throws {
+            if CCryptoBoringSSLShims_EVP_HPKE_CTX_sequence(self.ctx) >= ((1 << (self.aead.nonceByteCount)) - 1) {
+                throw HPKE.Errors.outOfRangeSequenceNumber
+            }
+        }
+
+        func seal<M: DataProtocol, AD: DataProtocol>(_ message: M, authenticating aad: AD) throws -> Data {
+            try self.checkSequenceNumber()
+
+            let message: ContiguousBytes = message.regions.count == 1 ? message.regions.first! : Array(message)
+            let aad: ContiguousBytes = aad.regions.count == 1 ? aad.regions.first! : Array(aad)
+            return try message.withUnsafeBytes { message in
+                try aad.withUnsafeBytes { aad in
+                    let maxCount = message.count + self.aead.tagByteCount
+                    var ciphertext = Data(count: maxCount)
+                    var count = 0
+                    let rc = ciphertext.withUnsafeMutableBytes { ciphertext in
+                        CCryptoBoringSSLShims_EVP_HPKE_CTX_seal(
+                            self.ctx, ciphertext.baseAddress, &count, maxCount,
+                            message.baseAddress, message.count, aad.baseAddress, aad.count
+                        )
+                    }
+                    guard rc == 1 else {
+                        throw CryptoKitError.internalBoringSSLError()
+                    }
+                    precondition(count == maxCount)
+                    return ciphertext
+                }
+            }
+        }
+
+        func open<C: DataProtocol, AD: DataProtocol>(_ ciphertext: C, authenticating aad: AD) throws -> Data {
+            try self.checkSequenceNumber()
+            guard ciphertext.count >= self.aead.tagByteCount else {
+                throw HPKE.Errors.expectedPSK
+            }
+
+            let ciphertext: ContiguousBytes = ciphertext.regions.count == 1 ? ciphertext.regions.first! : Array(ciphertext)
+            let aad: ContiguousBytes = aad.regions.count == 1 ? aad.regions.first! : Array(aad)
+            return try ciphertext.withUnsafeBytes { ciphertext in
+                try aad.withUnsafeBytes { aad in
+                    let maxCount = ciphertext.count - self.aead.tagByteCount
+                    var plaintext = Data(count: maxCount)
+                    var count = 0
+                    let rc = plaintext.withUnsafeMutableBytes { plaintext in
+                        CCryptoBoringSSLShims_EVP_HPKE_CTX_open(
+                            self.ctx, plaintext.baseAddress, &count, maxCount,
+                            ciphertext.baseAddress, ciphertext.count, aad.baseAddress, aad.count
+                        )
+                    }
+                    guard rc == 1 else {
+                        throw CryptoKitError.authenticationFailure
+                    }
+                    precondition(count == maxCount)
+                    return plaintext
+                }
+            }
+        }
+
+        private static func withOptionalBytes<Bytes: ContiguousBytes, Result>(
+            _ bytes: Bytes?, _ body: (UnsafeRawBufferPointer?) throws -> Result
+        ) rethrows -> Result {
+            guard let bytes = bytes else {
+                return try body(nil)
+            }
+            return try bytes.withUnsafeBytes(body)
+        }
+    }
+}
+
+#endif // Linux or !SwiftPM
@@ -57,15 +57,20 @@ extension HPKE {
             self.kem = kem
             self.kdf = kdf
             self.aead = aead
-        }
-        
-        internal var identifier: Data {
+
             var identifier = Ciphersuite.ciphersuiteLabel
             identifier.append(kem.identifier)
             identifier.append(kdf.identifier)
             identifier.append(aead.identifier)
-            return identifier
+            self.identifier = identifier
+            self.keyScheduleConstants = HPKE.KeySchedule.SuiteConstants(suiteID: identifier, kdf: kdf)
         }
+
+        /// The encoded suite ID, computed once per cipher suite as it is used by every labeled KDF call.
+        internal let identifier: Data
+
+        /// The parts of the key schedule that depend only on the cipher suite.
+        internal let keyScheduleConstants: HPKE.KeySchedule.SuiteConstants
     }
 }
 
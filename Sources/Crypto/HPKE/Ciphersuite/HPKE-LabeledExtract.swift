@@ -50,6 +50,56 @@ internal func LabeledExpand<Info: DataProtocol>(prk: SymmetricKey, label: Data,
     return kdf.expand(prk: prk, info: labeled_info, outputByteCount: Int(outputByteCount))
 }
 
+/// A `LabeledExtract` with an empty salt and a fixed label, with the label prefix already absorbed into the HMAC state.
+///
+/// Extracting then only needs to hash the input keying material, rather than rebuilding the labeled input and
+/// keying a new HMAC each time.
+internal struct PreparedNonSecretLabeledExtract {
+    private enum State {
+        case sha256(HMAC<SHA256>)
+        case sha384(HMAC<SHA384>)
+        case sha512(HMAC<SHA512>)
+    }
+
+    private let state: State
+
+    init(label: Data, suiteID: Data, kdf: HPKE.KDF) {
+        var prefix = protocolLabel
+        prefix.append(suiteID)
+        prefix.append(label)
+
+        let emptySalt = SymmetricKey(data: Data())
+        switch kdf {
+        case .HKDF_SHA256:
+            var hmac = HMAC<SHA256>(key: emptySalt)
+            hmac.update(data: prefix)
+            self.state = .sha256(hmac)
+        case .HKDF_SHA384:
+            var hmac = HMAC<SHA384>(key: emptySalt)
+            hmac.update(data: prefix)
+            self.state = .sha384(hmac)
+        case .HKDF_SHA512:
+            var hmac = HMAC<SHA512>(key: emptySalt)
+            hmac.update(data: prefix)
+            self.state = .sha512(hmac)
+        }
+    }
+
+    func extract<IKM: DataProtocol>(ikm: IKM) -> Data {
+        switch self.state {
+        case .sha256(var hmac):
+            hmac.update(data: ikm)
+            return Data(hmac.finalize())
+        case .sha384(var hmac):
+            hmac.update(data: ikm)
+            return Data(hmac.finalize())
+        case .sha512(var hmac):
+            hmac.update(data: ikm)
+            return Data(hmac.finalize())
+        }
+    }
+}
+
 internal func NonSecretOutputLabeledExtract(salt: Data?, label: Data, ikm: ContiguousBytes?, suiteID: Data, kdf: HPKE.KDF) -> Data {
     return Data(unsafeFromContiguousBytes: LabeledExtract(salt: salt, label: label, ikm: ikm, suiteID: suiteID, kdf: kdf))
 }
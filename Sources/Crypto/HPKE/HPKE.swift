@@ -63,7 +63,7 @@ extension HPKE {
 
         /// The exporter secret.
         internal var exporterSecret: SymmetricKey {
-            return context.keySchedule.exporterSecret
+            return context.exporterSecret
         }
         
         /// Exports a secret given domain-separation context and the desired output length.
@@ -77,8 +77,8 @@ extension HPKE {
                                  label: Data("sec".utf8),
                                  info: context,
                                  outputByteCount: UInt16(outputByteCount),
-                                 suiteID: self.context.keySchedule.ciphersuite.identifier,
-                                 kdf: self.context.keySchedule.ciphersuite.kdf)
+                                 suiteID: self.context.ciphersuite.identifier,
+                                 kdf: self.context.ciphersuite.kdf)
         }
 
         /// Creates a sender in base mode.
@@ -165,7 +165,7 @@ extension HPKE {
         /// - Note: The system throws errors from ``CryptoKit/HPKE/Errors`` when it encounters them.
         /// - Returns: The ciphertext for the recipient to decrypt.
         public mutating func seal<M: DataProtocol, AD: DataProtocol>(_ msg: M, authenticating aad: AD) throws -> Data {
-            return try context.keySchedule.seal(msg, authenticating: aad)
+            return try context.seal(msg, authenticating: aad)
         }
         
         /// Encrypts the given cleartext message.
@@ -179,7 +179,7 @@ extension HPKE {
         /// - Note: The system throws errors from ``CryptoKit/HPKE/Errors`` when it encounters them.
         /// - Returns: The ciphertext for the recipient to decrypt.
         public mutating func seal<M: DataProtocol>(_ msg: M) throws -> Data {
-            return try context.keySchedule.seal(msg, authenticating: Data())
+            return try context.seal(msg, authenticating: Data())
         }
     }
     
@@ -199,7 +199,7 @@ extension HPKE {
 
         /// The exporter secret.
         internal var exporterSecret: SymmetricKey {
-            return context.keySchedule.exporterSecret
+            return context.exporterSecret
         }
 
         /// Exports a secret given domain-separation context and the desired output length.
@@ -213,8 +213,8 @@ extension HPKE {
                                  label: Data("sec".utf8),
                                  info: context,
                                  outputByteCount: UInt16(outputByteCount),
-                                 suiteID: self.context.keySchedule.ciphersuite.identifier,
-                                 kdf: self.context.keySchedule.ciphersuite.kdf)
+                                 suiteID: self.context.ciphersuite.identifier,
+                                 kdf: self.context.ciphersuite.kdf)
         }
 
         /// Creates a recipient in base mode.
@@ -298,7 +298,7 @@ extension HPKE {
         /// - Note: The system throws errors from ``CryptoKit/HPKE/Errors`` when it encounters them.
         /// - Returns: The resulting cleartext message if the message is authentic.
         public mutating func open<C: DataProtocol, AD: DataProtocol>(_ ciphertext: C, authenticating aad: AD) throws -> Data {
-            return try context.keySchedule.open(ciphertext, authenticating: aad)
+            return try context.open(ciphertext, authenticating: aad)
         }
         
         /// Decrypts a message, if the ciphertext is valid.
@@ -312,7 +312,7 @@ extension HPKE {
         /// - Note: The system throws errors from ``CryptoKit/HPKE/Errors`` when it encounters them.
         /// - Returns: The resulting cleartext message if the message is authentic.
         public mutating func open<C: DataProtocol>(_ ciphertext: C) throws -> Data {
-            return try context.keySchedule.open(ciphertext, authenticating: Data())
+            return try context.open(ciphertext, authenticating: Data())
         }
     }
 }
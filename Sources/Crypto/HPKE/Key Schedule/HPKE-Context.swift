@@ -18,30 +18,59 @@ import Foundation
 
 extension HPKE {
     struct Context {
-        var keySchedule: KeySchedule
+        /// Exactly one of `keySchedule` and `boringSSL` is set. Supported suites use BoringSSL's context, which is
+        /// copied before it is first modified through a shared reference, to keep the value semantics of the key
+        /// schedule.
+        private var keySchedule: KeySchedule?
+        private var boringSSL: BoringSSLContext?
+        let ciphersuite: Ciphersuite
+        let exporterSecret: SymmetricKey
         var encapsulated: Data
         
         init<PublicKey: HPKEDiffieHellmanPublicKey>(senderRoleWithCiphersuite ciphersuite: Ciphersuite, mode: Mode, psk: SymmetricKey?, pskID: Data?, pkR: PublicKey, info: Data) throws {
+            if psk == nil, pskID == nil, BoringSSLContext.supports(ciphersuite, mode: mode),
+               let pkR = pkR as? Curve25519.KeyAgreement.PublicKey,
+               let sender = BoringSSLContext.sender(ciphersuite: ciphersuite, recipientKey: pkR, authenticationKey: nil, info: info) {
+                self.init(boringSSL: sender.context, ciphersuite: ciphersuite, encapsulated: sender.encapsulated)
+                return
+            }
+
             let pkRKEM = try HPKE.DHKEM.PublicKey(pkR, kem: ciphersuite.kem)
             
             let encapsulationResult = try pkRKEM.encapsulate()
-            encapsulated = encapsulationResult.encapsulated
-            self.keySchedule = try KeySchedule(mode: mode,
-                                               sharedSecret: encapsulationResult.sharedSecret, info: info, psk: psk, pskID: pskID, ciphersuite: ciphersuite)
+            let keySchedule = try KeySchedule(mode: mode,
+                                              sharedSecret: encapsulationResult.sharedSecret, info: info, psk: psk, pskID: pskID, ciphersuite: ciphersuite)
+            self.init(keySchedule: keySchedule, encapsulated: encapsulationResult.encapsulated)
         }
         
         init<SK: HPKEDiffieHellmanPrivateKey>(senderRoleWithCiphersuite ciphersuite: Ciphersuite, mode: Mode, psk: SymmetricKey?, pskID: Data?, pkR: SK.PublicKey, info: Data, skS: SK) throws {
+            if psk == nil, pskID == nil, BoringSSLContext.supports(ciphersuite, mode: mode),
+               let pkR = pkR as? Curve25519.KeyAgreement.PublicKey, let skS = skS as? Curve25519.KeyAgreement.PrivateKey,
+               let sender = BoringSSLContext.sender(ciphersuite: ciphersuite, recipientKey: pkR, authenticationKey: skS, info: info) {
+                self.init(boringSSL: sender.context, ciphersuite: ciphersuite, encapsulated: sender.encapsulated)
+                return
+            }
 
             let skSKEM = try HPKE.DHKEM.PrivateKey(skS, kem: ciphersuite.kem)
             let pkRKEM = try HPKE.DHKEM.PublicKey(pkR, kem: ciphersuite.kem)
             
             let encapsulationResult = try skSKEM.authenticateAndEncapsulateTo(pkRKEM)
             
-            encapsulated = encapsulationResult.encapsulated
-            self.keySchedule = try KeySchedule(mode: mode, sharedSecret: encapsulationResult.sharedSecret, info: info, psk: psk, pskID: pskID, ciphersuite: ciphersuite)
+            let keySchedule = try KeySchedule(mode: mode, sharedSecret: encapsulationResult.sharedSecret, info: info, psk: psk, pskID: pskID, ciphersuite: ciphersuite)
+            self.init(keySchedule: keySchedule, encapsulated: encapsulationResult.encapsulated)
         }
         
         init<PrivateKey: HPKEDiffieHellmanPrivateKey>(recipientRoleWithCiphersuite ciphersuite: Ciphersuite, mode: Mode, enc: Data, psk: SymmetricKey?, pskID: Data?, skR: PrivateKey, info: Data, pkS: PrivateKey.PublicKey?) throws {
+            if psk == nil, pskID == nil, BoringSSLContext.supports(ciphersuite, mode: mode),
+               let skR = skR as? Curve25519.KeyAgreement.PrivateKey {
+                let pkSCurve25519 = pkS.flatMap { $0 as? Curve25519.KeyAgreement.PublicKey }
+                if (pkSCurve25519 == nil) == (pkS == nil),
+                   let context = try BoringSSLContext.recipient(ciphersuite: ciphersuite, privateKey: skR, encapsulated: enc, authenticationKey: pkSCurve25519, info: info) {
+                    self.init(boringSSL: context, ciphersuite: ciphersuite, encapsulated: enc)
+                    return
+                }
+            }
+
             let skRKEM = try HPKE.DHKEM.PrivateKey(skR, kem: ciphersuite.kem)
             
             let sharedSecret: SymmetricKey
@@ -51,10 +80,46 @@ extension HPKE {
                 sharedSecret = try skRKEM.decapsulate(enc)
             }
             
-            self.encapsulated = enc
-            self.keySchedule = try KeySchedule(mode: mode, sharedSecret: sharedSecret, info: info, psk: psk, pskID: pskID, ciphersuite: ciphersuite)
+            let keySchedule = try KeySchedule(mode: mode, sharedSecret: sharedSecret, info: info, psk: psk, pskID: pskID, ciphersuite: ciphersuite)
+            self.init(keySchedule: keySchedule, encapsulated: enc)
+        }
+
+        private init(keySchedule: KeySchedule, encapsulated: Data) {
+            self.keySchedule = keySchedule
+            self.boringSSL = nil
+            self.ciphersuite = keySchedule.ciphersuite
+            self.exporterSecret = keySchedule.exporterSecret
+            self.encapsulated = encapsulated
+        }
+
+        private init(boringSSL: BoringSSLContext, ciphersuite: Ciphersuite, encapsulated: Data) {
+            self.keySchedule = nil
+            self.boringSSL = boringSSL
+            self.ciphersuite = ciphersuite
+            self.exporterSecret = boringSSL.exporterSecret
+            self.encapsulated = encapsulated
+        }
+
+        mutating func seal<M: DataProtocol, AD: DataProtocol>(_ msg: M, authenticating aad: AD) throws -> Data {
+            if self.boringSSL != nil {
+                return try self.uniqueBoringSSLContext().seal(msg, authenticating: aad)
+            }
+            return try self.keySchedule!.seal(msg, authenticating: aad)
+        }
+
+        mutating func open<C: DataProtocol, AD: DataProtocol>(_ ciphertext: C, authenticating aad: AD) throws -> Data {
+            if self.boringSSL != nil {
+                return try self.uniqueBoringSSLContext().open(ciphertext, authenticating: aad)
+            }
+            return try self.keySchedule!.open(ciphertext, authenticating: aad)
+        }
+
+        private mutating func uniqueBoringSSLContext() -> BoringSSLContext {
+            if !isKnownUniquelyReferenced(&self.boringSSL) {
+                self.boringSSL = self.boringSSL!.copy()
+            }
+            return self.boringSSL!
         }
-        
     }
 }
 
@@ -51,17 +51,9 @@ extension HPKE {
         init(mode: HPKE.Mode, sharedSecret: ContiguousBytes, info: Data, psk: SymmetricKey?, pskID: Data?, ciphersuite: Ciphersuite) throws {
             try HPKE.KeySchedule.verifyPSKInputs(mode: mode, psk: psk, pskID: pskID)
             
-            let pskIDHash = NonSecretOutputLabeledExtract(salt: nil,
-                                                          label: HPKE.KeySchedule.pksIDHashLabel,
-                                                          ikm: pskID.map { SymmetricKey(data: $0) },
-                                                          suiteID: ciphersuite.identifier,
-                                                          kdf: ciphersuite.kdf)
-            
-            let infoHash = NonSecretOutputLabeledExtract(salt: nil,
-                                                         label: HPKE.KeySchedule.infoHashLabel,
-                                                         ikm: SymmetricKey(data: info),
-                                                         suiteID: ciphersuite.identifier,
-                                                         kdf: ciphersuite.kdf)
+            let constants = ciphersuite.keyScheduleConstants
+            let pskIDHash = pskID.map { constants.pskIDHashExtract.extract(ikm: $0) } ?? constants.defaultPSKIDHash
+            let infoHash = constants.infoHashExtract.extract(ikm: info)
             
             var keyScheduleContext = Data()
             keyScheduleContext.append(mode.value)
@@ -101,6 +93,20 @@ extension HPKE {
             self.ciphersuite = ciphersuite
         }
         
+        /// The key schedule inputs that depend only on the cipher suite, computed once per suite.
+        struct SuiteConstants {
+            /// The `psk_id_hash` used by the modes that do not take a PSK.
+            let defaultPSKIDHash: Data
+            let pskIDHashExtract: PreparedNonSecretLabeledExtract
+            let infoHashExtract: PreparedNonSecretLabeledExtract
+
+            init(suiteID: Data, kdf: HPKE.KDF) {
+                self.pskIDHashExtract = PreparedNonSecretLabeledExtract(label: HPKE.KeySchedule.pksIDHashLabel, suiteID: suiteID, kdf: kdf)
+                self.infoHashExtract = PreparedNonSecretLabeledExtract(label: HPKE.KeySchedule.infoHashLabel, suiteID: suiteID, kdf: kdf)
+                self.defaultPSKIDHash = self.pskIDHashExtract.extract(ikm: Data())
+            }
+        }
+        
         mutating func incrementSequenceNumber() throws {
             if self.sequenceNumber >= ((1 << (self.ciphersuite.aead.nonceByteCount)) - 1) {
                 throw HPKE.Errors.outOfRangeSequenceNumber
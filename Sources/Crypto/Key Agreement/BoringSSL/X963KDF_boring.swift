@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+@_exported import CryptoKit
+#else
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+import Foundation
+
+extension SharedSecret {
+    /// Derives an X9.63 key in BoringSSL, hashing the shared secret once and writing each block straight into the key.
+    ///
+    /// Returns `nil` if BoringSSL doesn't implement `H`, in which case the caller should fall back to the generic
+    /// implementation.
+    internal func openSSLX963DerivedSymmetricKey<H: HashFunction, SI: DataProtocol>(using hashFunction: H.Type, sharedInfo: SI, outputByteCount: Int) -> SymmetricKey? {
+        guard let digest = Self.digest(H.self) else {
+            return nil
+        }
+
+        let contiguousSharedInfo: ContiguousBytes = sharedInfo.regions.count == 1 ? sharedInfo.regions.first! : Array(sharedInfo)
+        return SymmetricKey(unsafeUninitializedCapacity: outputByteCount) { keyBytes, initializedCount in
+            let result = self.withUnsafeBytes { secret in
+                contiguousSharedInfo.withUnsafeBytes { sharedInfo in
+                    CCryptoBoringSSLShims_X963_KDF(
+                        keyBytes.baseAddress, outputByteCount, digest,
+                        secret.baseAddress, secret.count,
+                        sharedInfo.baseAddress, sharedInfo.count
+                    )
+                }
+            }
+            // The caller has already checked the output length, so this can only be an allocation failure.
+            precondition(result == 1, "X9.63 key derivation failed")
+            initializedCount = outputByteCount
+        }
+    }
+
+    private static func digest<H: HashFunction>(_: H.Type) -> OpaquePointer? {
+        switch H.self {
+        case is SHA256.Type:
+            return CCryptoBoringSSL_EVP_sha256()
+        case is SHA384.Type:
+            return CCryptoBoringSSL_EVP_sha384()
+        case is SHA512.Type:
+            return CCryptoBoringSSL_EVP_sha512()
+        case is Insecure.SHA1.Type:
+            return CCryptoBoringSSL_EVP_sha1()
+        case is Insecure.MD5.Type:
+            return CCryptoBoringSSL_EVP_md5()
+        default:
+            return nil
+        }
+    }
+}
+#endif // CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
@@ -95,7 +95,15 @@ public struct SharedSecret: ContiguousBytes {
         guard UInt64(outputByteCount) < (UInt64(H.Digest.byteCount) * UInt64(UInt32.max)) else {
             fatalError("Invalid parameter size")
         }
-        
+
+        if let key = self.openSSLX963DerivedSymmetricKey(using: H.self, sharedInfo: sharedInfo, outputByteCount: outputByteCount) {
+            return key
+        }
+
+        // Every block starts by hashing Z, so hash it once and copy that state for each block.
+        var secretHasher = H()
+        secretHasher.update(self)
+
         var key = SecureBytes()
         key.reserveCapacity(outputByteCount)
         
@@ -104,8 +112,7 @@ public struct SharedSecret: ContiguousBytes {
         
         while remainingBytes > 0 {
             // 1. Compute: Ki = Hash(Z || Counter || [SharedInfo]).
-            var hasher = H()
-            hasher.update(self)
+            var hasher = secretHasher
             hasher.update(counter.bigEndian)
             hasher.update(data: sharedInfo)
             let digest = hasher.finalize()
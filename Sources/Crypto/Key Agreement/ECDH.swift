@@ -120,11 +120,8 @@ extension P256 {
             /// A Distinguished Encoding Rules (DER) encoded representation of the public key.
             public var derRepresentation: Data {
                 let spki = ASN1.SubjectPublicKeyInfo(algorithmIdentifier: .ecdsaP256, key: Array(self.x963Representation))
-                var serializer = ASN1.Serializer()
-
                 // Serializing these keys can't throw
-                try! serializer.serialize(spki)
-                return Data(serializer.serializedBytes)
+                return Data(try! ASN1.Serializer.serializedBytes(of: spki))
             }
 
             /// A Privacy-Enhanced Mail (PEM) representation of the public key.
@@ -227,11 +224,8 @@ extension P256 {
             /// A Distinguished Encoding Rules (DER) encoded representation of the private key.
             public var derRepresentation: Data {
                 let pkey = ASN1.PKCS8PrivateKey(algorithm: .ecdsaP256, privateKey: Array(self.rawRepresentation), publicKey: Array(self.publicKey.x963Representation))
-                var serializer = ASN1.Serializer()
-
                 // Serializing these keys can't throw
-                try! serializer.serialize(pkey)
-                return Data(serializer.serializedBytes)
+                return Data(try! ASN1.Serializer.serializedBytes(of: pkey))
             }
 
             /// A Privacy-Enhanced Mail (PEM) representation of the private key.
@@ -335,11 +329,8 @@ extension P256 {
             /// A Distinguished Encoding Rules (DER) encoded representation of the public key.
             public var derRepresentation: Data {
                 let spki = ASN1.SubjectPublicKeyInfo(algorithmIdentifier: .ecdsaP256, key: Array(self.x963Representation))
-                var serializer = ASN1.Serializer()
-
                 // Serializing these keys can't throw
-                try! serializer.serialize(spki)
-                return Data(serializer.serializedBytes)
+                return Data(try! ASN1.Serializer.serializedBytes(of: spki))
             }
 
             /// A Privacy-Enhanced Mail (PEM) representation of the public key.
@@ -442,11 +433,8 @@ extension P256 {
             /// A Distinguished Encoding Rules (DER) encoded representation of the private key.
             public var derRepresentation: Data {
                 let pkey = ASN1.PKCS8PrivateKey(algorithm: .ecdsaP256, privateKey: Array(self.rawRepresentation), publicKey: Array(self.publicKey.x963Representation))
-                var serializer = ASN1.Serializer()
-
                 // Serializing these keys can't throw
-                try! serializer.serialize(pkey)
-                return Data(serializer.serializedBytes)
+                return Data(try! ASN1.Serializer.serializedBytes(of: pkey))
             }
 
             /// A Privacy-Enhanced Mail (PEM) representation of the private key.
@@ -549,11 +537,8 @@ extension P384 {
             /// A Distinguished Encoding Rules (DER) encoded representation of the public key.
             public var derRepresentation: Data {
                 let spki = ASN1.SubjectPublicKeyInfo(algorithmIdentifier: .ecdsaP384, key: Array(self.x963Representation))
-                var serializer = ASN1.Serializer()
-
                 // Serializing these keys can't throw
-                try! serializer.serialize(spki)
-                return Data(serializer.serializedBytes)
+                return Data(try! ASN1.Serializer.serializedBytes(of: spki))
             }
 
             /// A Privacy-Enhanced Mail (PEM) representation of the public key.
@@ -656,11 +641,8 @@ extension P384 {
             /// A Distinguished Encoding Rules (DER) encoded representation of the private key.
             public var derRepresentation: Data {
                 let pkey = ASN1.PKCS8PrivateKey(algorithm: .ecdsaP384, privateKey: Array(self.rawRepresentation), publicKey: Array(self.publicKey.x963Representation))
-                var serializer = ASN1.Serializer()
-
                 // Serializing these keys can't throw
-                try! serializer.serialize(pkey)
-                return Data(serializer.serializedBytes)
+                return Data(try! ASN1.Serializer.serializedBytes(of: pkey))
             }
 
             /// A Privacy-Enhanced Mail (PEM) representation of the private key.
@@ -764,11 +746,8 @@ extension P384 {
             /// A Distinguished Encoding Rules (DER) encoded representation of the public key.
             public var derRepresentation: Data {
                 let spki = ASN1.SubjectPublicKeyInfo(algorithmIdentifier: .ecdsaP384, key: Array(self.x963Representation))
-                var serializer = ASN1.Serializer()
-
                 // Serializing these keys can't throw
-                try! serializer.serialize(spki)
-                return Data(serializer.serializedBytes)
+                return Data(try! ASN1.Serializer.serializedBytes(of: spki))
             }
 
             /// A Privacy-Enhanced Mail (PEM) representation of the public key.
@@ -871,11 +850,8 @@ extension P384 {
             /// A Distinguished Encoding Rules (DER) encoded representation of the private key.
             public var derRepresentation: Data {
                 let pkey = ASN1.PKCS8PrivateKey(algorithm: .ecdsaP384, privateKey: Array(self.rawRepresentation), publicKey: Array(self.publicKey.x963Representation))
-                var serializer = ASN1.Serializer()
-
                 // Serializing these keys can't throw
-                try! serializer.serialize(pkey)
-                return Data(serializer.serializedBytes)
+                return Data(try! ASN1.Serializer.serializedBytes(of: pkey))
             }
 
             /// A Privacy-Enhanced Mail (PEM) representation of the private key.
@@ -978,11 +954,8 @@ extension P521 {
             /// A Distinguished Encoding Rules (DER) encoded representation of the public key.
             public var derRepresentation: Data {
                 let spki = ASN1.SubjectPublicKeyInfo(algorithmIdentifier: .ecdsaP521, key: Array(self.x963Representation))
-                var serializer = ASN1.Serializer()
-
                 // Serializing these keys can't throw
-                try! serializer.serialize(spki)
-                return Data(serializer.serializedBytes)
+                return Data(try! ASN1.Serializer.serializedBytes(of: spki))
             }
 
             /// A Privacy-Enhanced Mail (PEM) representation of the public key.
@@ -1085,11 +1058,8 @@ extension P521 {
             /// A Distinguished Encoding Rules (DER) encoded representation of the private key.
             public var derRepresentation: Data {
                 let pkey = ASN1.PKCS8PrivateKey(algorithm: .ecdsaP521, privateKey: Array(self.rawRepresentation), publicKey: Array(self.publicKey.x963Representation))
-                var serializer = ASN1.Serializer()
-
                 // Serializing these keys can't throw
-                try! serializer.serialize(pkey)
-                return Data(serializer.serializedBytes)
+                return Data(try! ASN1.Serializer.serializedBytes(of: pkey))
             }
 
             /// A Privacy-Enhanced Mail (PEM) representation of the private key.
@@ -1193,11 +1163,8 @@ extension P521 {
             /// A Distinguished Encoding Rules (DER) encoded representation of the public key.
             public var derRepresentation: Data {
                 let spki = ASN1.SubjectPublicKeyInfo(algorithmIdentifier: .ecdsaP521, key: Array(self.x963Representation))
-                var serializer = ASN1.Serializer()
-
                 // Serializing these keys can't throw
-                try! serializer.serialize(spki)
-                return Data(serializer.serializedBytes)
+                return Data(try! ASN1.Serializer.serializedBytes(of: spki))
             }
 
             /// A Privacy-Enhanced Mail (PEM) representation of the public key.
@@ -1300,11 +1267,8 @@ extension P521 {
             /// A Distinguished Encoding Rules (DER) encoded representation of the private key.
             public var derRepresentation: Data {
                 let pkey = ASN1.PKCS8PrivateKey(algorithm: .ecdsaP521, privateKey: Array(self.rawRepresentation), publicKey: Array(self.publicKey.x963Representation))
-                var serializer = ASN1.Serializer()
-
                 // Serializing these keys can't throw
-                try! serializer.serialize(pkey)
-                return Data(serializer.serializedBytes)
+                return Data(try! ASN1.Serializer.serializedBytes(of: pkey))
             }
 
             /// A Privacy-Enhanced Mail (PEM) representation of the private key.
@@ -24,6 +24,8 @@ extension Curve25519.Signing {
     struct OpenSSLCurve25519PrivateKeyImpl {
         /* private but @usableFromInline */ var _privateKey: SecureBytes
         /* private but @usableFromInline */ @usableFromInline var _publicKey: [UInt8]
+        // The secret scalar and nonce prefix, hashed from the seed once here so that signing doesn't redo it.
+        /* private but @usableFromInline */ var _expandedKey: SecureBytes
 
         @usableFromInline
         init() {
@@ -39,6 +41,7 @@ extension Curve25519.Signing {
 
             self._privateKey = privateKey
             self._publicKey = publicKey
+            self._expandedKey = Self.expandedKey(privateKey)
         }
 
         @usableFromInline
@@ -50,6 +53,20 @@ extension Curve25519.Signing {
             self._privateKey
         }
 
+        var expandedKey: SecureBytes {
+            self._expandedKey
+        }
+
+        private static func expandedKey(_ privateKey: SecureBytes) -> SecureBytes {
+            let expandedKeyByteCount = Int(CCryptoBoringSSLShims_ED25519_EXPANDED_KEY_BYTES)
+            return SecureBytes(unsafeUninitializedCapacity: expandedKeyByteCount) { expandedKeyPtr, expandedKeyBytes in
+                expandedKeyBytes = expandedKeyByteCount
+                privateKey.withUnsafeBytes { privateKeyPtr in
+                    CCryptoBoringSSLShims_ED25519_expand(expandedKeyPtr.baseAddress, privateKeyPtr.baseAddress)
+                }
+            }
+        }
+
         init<D: ContiguousBytes>(rawRepresentation data: D) throws {
             // What this calls "rawRepresentation" BoringSSL calls the "seed". Otherwise, this is
             // the same as the above initializer.
@@ -71,6 +88,7 @@ extension Curve25519.Signing {
 
             self._privateKey = privateKey
             self._publicKey = publicKey
+            self._expandedKey = Self.expandedKey(privateKey)
         }
 
         @usableFromInline
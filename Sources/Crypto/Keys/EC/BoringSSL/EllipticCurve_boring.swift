@@ -18,9 +18,21 @@
 
 /// A wrapper around BoringSSL's EC_GROUP object that handles reference counting and
 /// liveness.
+///
+/// Groups are immutable once created, so the process-wide instances for each curve
+/// (``p256``, ``p384``, ``p521``) can be shared freely instead of constructing new ones.
 @usableFromInline
-class BoringSSLEllipticCurveGroup {
-    /* private but usableFromInline */ @usableFromInline var _group: OpaquePointer
+final class BoringSSLEllipticCurveGroup {
+    /* private but usableFromInline */ @usableFromInline let _group: OpaquePointer
+
+    /// The order of the group. Computed once, as it is needed on many key operations.
+    @usableFromInline
+    let order: ArbitraryPrecisionInteger
+
+    /// An elliptic curve can be represented in a Weierstrass form: `y² = x³ + ax + b`. This
+    /// property provides the values of a and b on the curve, along with the size of the field.
+    @usableFromInline
+    let weierstrassCoefficients: (field: ArbitraryPrecisionInteger, a: ArbitraryPrecisionInteger, b: ArbitraryPrecisionInteger)
 
     @usableFromInline
     init(_ curve: CurveName) throws {
@@ -29,6 +41,8 @@ class BoringSSLEllipticCurveGroup {
         }
 
         self._group = group
+        self.order = Self.order(of: group)
+        self.weierstrassCoefficients = Self.weierstrassCoefficients(of: group)
     }
 
     deinit {
@@ -68,17 +82,13 @@ extension BoringSSLEllipticCurveGroup {
         try body(self._group)
     }
 
-    @usableFromInline
-    var order: ArbitraryPrecisionInteger {
+    private static func order(of group: OpaquePointer) -> ArbitraryPrecisionInteger {
         // Groups must have an order.
-        let baseOrder = CCryptoBoringSSL_EC_GROUP_get0_order(self._group)!
+        let baseOrder = CCryptoBoringSSL_EC_GROUP_get0_order(group)!
         return try! ArbitraryPrecisionInteger(copying: baseOrder)
     }
 
-    /// An elliptic curve can be represented in a Weierstrass form: `y² = x³ + ax + b`. This
-    /// property provides the values of a and b on the curve.
-    @usableFromInline
-    var weierstrassCoefficients: (field: ArbitraryPrecisionInteger, a: ArbitraryPrecisionInteger, b: ArbitraryPrecisionInteger) {
+    private static func weierstrassCoefficients(of group: OpaquePointer) -> (field: ArbitraryPrecisionInteger, a: ArbitraryPrecisionInteger, b: ArbitraryPrecisionInteger) {
         var field = ArbitraryPrecisionInteger()
         var a = ArbitraryPrecisionInteger()
         var b = ArbitraryPrecisionInteger()
@@ -86,7 +96,7 @@ extension BoringSSLEllipticCurveGroup {
         let rc = field.withUnsafeMutableBignumPointer { fieldPtr in
             a.withUnsafeMutableBignumPointer { aPtr in
                 b.withUnsafeMutableBignumPointer { bPtr in
-                    CCryptoBoringSSL_EC_GROUP_get_curve_GFp(self._group, fieldPtr, aPtr, bPtr, nil)
+                    CCryptoBoringSSL_EC_GROUP_get_curve_GFp(group, fieldPtr, aPtr, bPtr, nil)
                 }
             }
         }
@@ -96,6 +106,20 @@ extension BoringSSLEllipticCurveGroup {
     }
 }
 
+// MARK: - Shared groups
+
+extension BoringSSLEllipticCurveGroup {
+    // Creating these can only fail on allocation failure, from which we cannot recover.
+    @usableFromInline
+    static let p256 = try! BoringSSLEllipticCurveGroup(.p256)
+
+    @usableFromInline
+    static let p384 = try! BoringSSLEllipticCurveGroup(.p384)
+
+    @usableFromInline
+    static let p521 = try! BoringSSLEllipticCurveGroup(.p521)
+}
+
 // MARK: - CurveName
 
 extension BoringSSLEllipticCurveGroup {
@@ -34,21 +34,21 @@ extension OpenSSLSupportedNISTCurve {
 extension P256: OpenSSLSupportedNISTCurve {
     @inlinable
     static var group: BoringSSLEllipticCurveGroup {
-        try! BoringSSLEllipticCurveGroup(.p256)
+        BoringSSLEllipticCurveGroup.p256
     }
 }
 
 extension P384: OpenSSLSupportedNISTCurve {
     @inlinable
     static var group: BoringSSLEllipticCurveGroup {
-        try! BoringSSLEllipticCurveGroup(.p384)
+        BoringSSLEllipticCurveGroup.p384
     }
 }
 
 extension P521: OpenSSLSupportedNISTCurve {
     @inlinable
     static var group: BoringSSLEllipticCurveGroup {
-        try! BoringSSLEllipticCurveGroup(.p521)
+        BoringSSLEllipticCurveGroup.p521
     }
 }
 
@@ -299,15 +299,21 @@ class BoringSSLECPrivateKeyWrapper<Curve: OpenSSLSupportedNISTCurve> {
         }
     }
 
-    func sign<D: Digest>(digest: D) throws -> ECDSASignature {
-        let optionalRawSignature: UnsafeMutablePointer<ECDSA_SIG>? = digest.withUnsafeBytes { digestPtr in
-            CCryptoBoringSSLShims_ECDSA_do_sign(digestPtr.baseAddress, digestPtr.count, self.key)
-        }
-        guard let rawSignature = optionalRawSignature else {
-            throw CryptoKitError.internalBoringSSLError()
+    /// Signs `digest`, producing the raw r || s form directly, without going through an `ECDSA_SIG`.
+    func signRaw<D: Digest>(digest: D) throws -> Data {
+        var signature = Data(repeating: 0, count: 2 * Curve.coordinateByteCount)
+        let signatureByteCount: Int = try signature.withUnsafeMutableBytes { signaturePtr in
+            try digest.withUnsafeBytes { digestPtr in
+                var signatureByteCount = 0
+                guard CCryptoBoringSSLShims_ECDSA_sign_raw(signaturePtr.baseAddress, &signatureByteCount, signaturePtr.count,
+                                                           digestPtr.baseAddress, digestPtr.count, self.key) == 1 else {
+                    throw CryptoKitError.internalBoringSSLError()
+                }
+                return signatureByteCount
+            }
         }
-
-        return ECDSASignature(takingOwnershipOf: rawSignature)
+        precondition(signatureByteCount == signature.count, "Unexpectedly short signature.")
+        return signature
     }
 
     deinit {
@@ -335,26 +341,16 @@ class BoringSSLECPublicKeyWrapper<Curve: OpenSSLSupportedNISTCurve> {
 
         self.key = try group.makeUnsafeOwnedECKey()
 
-        // The compact representation is simply the X coordinate: deserializing then requires us to do a little math,
-        // as discussed in https://datatracker.ietf.org/doc/html/draft-jivsov-ecc-compact-05#section-4.1
-        var x = try ArbitraryPrecisionInteger(bytes: bytes)
-
-        // We now need to solve the curve equation in Weierstrass form. This form is y² = x³ + ax + b. We need a and b.
-        // We also need a finite field context, which means we need the order of the underlying prime field. We call that
-        // p, for later.
-        let (p, a, b) = group.weierstrassCoefficients
-        let context = try FiniteFieldArithmeticContext(fieldSize: p)
-        let xCubed = try (context.multiply(context.square(x), x))
-        let ax = try context.multiply(a, x)
-        let ySquared = try context.add(context.add(xCubed, ax), b)
-
-        // We want the positive square root value of y, which conveniently is what we can get. We will call this yPrime.
-        // We then need to calculate y = min(yPrime, p-yPrime) where p is the order of the underlying finite field.
-        let yPrime = try context.positiveSquareRoot(ySquared)
-        var y = min(yPrime, try context.subtract(yPrime, from: p))
-
-        // This is the full set of coordinates. We're done.
-        try self.setPublicKey(x: &x, y: &y)
+        // The compact representation is simply the X coordinate: deserializing then requires solving the curve
+        // equation for y and taking the smaller root, as discussed in
+        // https://datatracker.ietf.org/doc/html/draft-jivsov-ecc-compact-05#section-4.1. The shim does this with
+        // fixed-width field elements rather than BIGNUMs.
+        let rc = bytes.withUnsafeBytes { bytesPtr in
+            CCryptoBoringSSLShims_EC_KEY_set_public_key_compact(self.key, bytesPtr.baseAddress, bytesPtr.count)
+        }
+        guard rc == 1 else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
     }
 
     init<Bytes: ContiguousBytes>(x963Representation bytes: Bytes) throws {
@@ -381,9 +377,15 @@ class BoringSSLECPublicKeyWrapper<Curve: OpenSSLSupportedNISTCurve> {
 
         switch length {
         case group.coordinateByteCount + 1:
-            var (x, yBit) = try bytes.readx963CompressedPublicNumbers()
+            // The x9.63 compressed public key format is a discriminator byte (0x2 or 0x3) that signals which
+            // of the possible two Y values is being used, concatenated with the X point of the key.
+            try bytes.withUnsafeBytes { bytesPtr in
+                guard bytesPtr.first == 0x02 || bytesPtr.first == 0x03 else {
+                    throw CryptoKitError.incorrectKeySize // This is the same error CryptoKit throws on Apple platforms.
+                }
+            }
             self.key = try group.makeUnsafeOwnedECKey()
-            try self.setPublicKey(x: &x, yBit: yBit)
+            try self.setPublicKey(compressedRepresentation: bytes)
 
         default:
             throw CryptoKitError.incorrectParameterSize
@@ -470,15 +472,25 @@ class BoringSSLECPublicKeyWrapper<Curve: OpenSSLSupportedNISTCurve> {
         return bytes
     }
 
-    @inlinable
+    @usableFromInline
     var compressedRepresentation: Data {
-        // The x963 representation is the X coordinate, prefixed by the byte 0x02 or 0x03 depending on whether the Y coordinate is odd or even.
-        // We calculate this by playing games with the x963Representation. We can safely assume that this Data is zero-indexed, because
-        // we just created it above.
-        var bytes = self.x963Representation
-        let yMask = bytes.last! & 0x1
-        bytes[0] = 0x2 | yMask
-        return bytes.dropLast(Curve.group.coordinateByteCount)
+        // The compressed representation is the X coordinate, prefixed by the byte 0x02 or 0x03 depending on whether the
+        // Y coordinate is even or odd. BoringSSL writes this straight from its field elements, without BIGNUMs.
+        let group = Curve.group
+        var bytes = Data(repeating: 0, count: group.coordinateByteCount + 1)
+        let written = bytes.withUnsafeMutableBytes { bytesPtr in
+            group.withUnsafeGroupPointer { groupPtr in
+                CCryptoBoringSSL_EC_POINT_point2oct(groupPtr,
+                                                    CCryptoBoringSSL_EC_KEY_get0_public_key(self.key),
+                                                    POINT_CONVERSION_COMPRESSED,
+                                                    bytesPtr.baseAddress,
+                                                    bytesPtr.count,
+                                                    nil)
+            }
+        }
+        // This should only fire on internal consistency errors.
+        precondition(written == bytes.count)
+        return bytes
     }
 
     deinit {
@@ -502,33 +514,21 @@ class BoringSSLECPublicKeyWrapper<Curve: OpenSSLSupportedNISTCurve> {
         }
     }
 
-    func setPublicKey(x: inout ArbitraryPrecisionInteger, yBit: Bool) throws {
-        try x.withUnsafeMutableBignumPointer { xPointer in
-            // We cannot handle allocation errors.
-            let point = try Curve.group.makeUnsafeOwnedECPoint()
-            defer {
-                // We either error, or EC_KEY_set_public_key dups the key,
-                // so we must always free.
-                CCryptoBoringSSL_EC_POINT_free(point)
-            }
-            let rc = Curve.group.withUnsafeGroupPointer { groupPtr in
-                CCryptoBoringSSL_EC_POINT_set_compressed_coordinates_GFp(groupPtr, point, xPointer, yBit ? 1 : 0, nil)
-            }
-
-            guard rc == 1 else {
-                throw CryptoKitError.internalBoringSSLError()
-            }
-
-            guard CCryptoBoringSSL_EC_KEY_set_public_key(self.key, point) == 1 else {
-                throw CryptoKitError.internalBoringSSLError()
-            }
+    func setPublicKey<Bytes: ContiguousBytes>(compressedRepresentation bytes: Bytes) throws {
+        let rc = bytes.withUnsafeBytes { bytesPtr in
+            CCryptoBoringSSLShims_EC_KEY_set_public_key_compressed(self.key, bytesPtr.baseAddress, bytesPtr.count)
+        }
+        guard rc == 1 else {
+            throw CryptoKitError.internalBoringSSLError()
         }
     }
 
-    func isValidSignature<D: Digest>(_ signature: ECDSASignature, for digest: D) -> Bool {
-        let rc: CInt = signature.withUnsafeSignaturePointer { signaturePointer in
+    /// Verifies a raw r || s signature directly, without going through an `ECDSA_SIG`.
+    func isValidRawSignature<D: Digest>(_ rawSignature: Data, for digest: D) -> Bool {
+        let rc: CInt = rawSignature.withUnsafeBytes { signaturePointer in
             digest.withUnsafeBytes { digestPointer in
-                CCryptoBoringSSLShims_ECDSA_do_verify(digestPointer.baseAddress, digestPointer.count, signaturePointer, self.key)
+                CCryptoBoringSSLShims_ECDSA_verify_raw(digestPointer.baseAddress, digestPointer.count,
+                                                       signaturePointer.baseAddress, signaturePointer.count, self.key)
             }
         }
 
@@ -573,29 +573,6 @@ extension ContiguousBytes {
             return try readRawPublicNumbers(copyingBytes: UnsafeRawBufferPointer(rebasing: bytesPtr[1...]))
         }
     }
-
-    @inlinable
-    func readx963CompressedPublicNumbers() throws -> (x: ArbitraryPrecisionInteger, yBit: Bool) {
-        // The x9.63 compressed public key format is a discriminator byte (0x2 or 0x3) that signals which
-        // of the possible two Y values is being used, concatenated with the X point of the key.
-        return try self.withUnsafeBytes { bytesPtr in
-            let yBit: Bool
-
-            switch bytesPtr.first {
-            case 0x03:
-                yBit = true
-            case 0x02:
-                yBit = false
-            default:
-                throw CryptoKitError.incorrectKeySize // This is the same error CryptoKit throws on Apple platforms.
-            }
-
-            let xBytes = UnsafeRawBufferPointer(rebasing: bytesPtr.dropFirst())
-            let x = try ArbitraryPrecisionInteger(bytes: xBytes)
-
-            return (x: x, yBit: yBit)
-        }
-    }
 }
 
 @usableFromInline
@@ -67,6 +67,10 @@ extension Curve25519 {
             var key: SecureBytes {
                 return self.baseKey.key
             }
+
+            var expandedKey: SecureBytes {
+                return self.baseKey.expandedKey
+            }
         }
 
         /// A Curve25519 public key used to verify cryptographic signatures.
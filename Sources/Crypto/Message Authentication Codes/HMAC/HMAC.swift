@@ -49,7 +49,7 @@ public struct HMAC<H: HashFunction>: MACAlgorithm {
     /// - Returns: A Boolean value that’s `true` if the message authentication
     /// code is valid for the data within the specified buffer.
     public static func isValidAuthenticationCode(_ mac: MAC, authenticating bufferPointer: UnsafeRawBufferPointer, using key: SymmetricKey) -> Bool {
-        return isValidAuthenticationCode(authenticationCodeBytes: mac, authenticatedData: bufferPointer, key: key)
+        return safeCompare(mac, Self.authenticationCode(bufferPointer: bufferPointer, using: key))
     }
     
     /// Creates a message authentication code generator.
@@ -60,42 +60,35 @@ public struct HMAC<H: HashFunction>: MACAlgorithm {
         #if os(iOS) && (arch(arm) || arch(i386))
         fatalError("Unsupported architecture")
         #else
-        var K: ContiguousBytes
-        
-        if key.byteCount == H.blockByteCount {
-            K = key
-        } else if key.byteCount > H.blockByteCount {
-            var array = Array(repeating: UInt8(0), count: H.blockByteCount)
-            
-            K = key.withUnsafeBytes { (keyBytes)  in
-                let hash = H.hash(bufferPointer: keyBytes)
-                
-                return hash.withUnsafeBytes({ (hashBytes) in
-                    memcpy(&array, hashBytes.baseAddress!, hashBytes.count)
-                    return array
-                })
+        // The padded key is built in one stack buffer, XORed with the inner pad, and then flipped to the outer
+        // pad in place, rather than materialised as three arrays.
+        (self.innerHasher, self.outerHasher) = withUnsafeTemporaryAllocation(byteCount: H.blockByteCount, alignment: 1) { pad -> (H, H) in
+            pad.initializeMemory(as: UInt8.self, repeating: 0)
+            defer {
+                pad.zeroize()
             }
-        } else {
-            var keyArray = Array(repeating: UInt8(0), count: H.blockByteCount)
-            key.withUnsafeBytes { keyArray.replaceSubrange(0..<$0.count, with: $0) }
-            K = keyArray
-        }
-        
-        self.innerHasher = H()
-        let innerKey = K.withUnsafeBytes {
-            return $0.map({ (keyByte) in
-                keyByte ^ 0x36
-            })
-        }
-        innerHasher.update(data: innerKey)
-        
-        self.outerHasher = H()
-        let outerKey = K.withUnsafeBytes {
-            return $0.map({ (keyByte) in
-                keyByte ^ 0x5c
-            })
+
+            key.withUnsafeBytes { keyBytes in
+                if keyBytes.count > H.blockByteCount {
+                    H.hash(bufferPointer: keyBytes).withUnsafeBytes { pad.copyMemory(from: $0) }
+                } else {
+                    pad.copyMemory(from: keyBytes)
+                }
+            }
+
+            for index in pad.indices {
+                pad[index] ^= 0x36
+            }
+            var innerHasher = H()
+            innerHasher.update(bufferPointer: UnsafeRawBufferPointer(pad))
+
+            for index in pad.indices {
+                pad[index] ^= 0x36 ^ 0x5c
+            }
+            var outerHasher = H()
+            outerHasher.update(bufferPointer: UnsafeRawBufferPointer(pad))
+            return (innerHasher, outerHasher)
         }
-        outerHasher.update(data: outerKey)
         #endif
     }
     
@@ -106,11 +99,30 @@ public struct HMAC<H: HashFunction>: MACAlgorithm {
     ///   - key: The symmetric key used to secure the computation.
     ///
     /// - Returns: The message authentication code.
+    @inlinable
     public static func authenticationCode<D: DataProtocol>(for data: D, using key: SymmetricKey) -> MAC {
+        // Contiguous inputs, like `Data` and `[UInt8]`, take the concrete path once the caller specializes `D`.
+        if let mac = data.withContiguousStorageIfAvailable({ Self.authenticationCode(bufferPointer: UnsafeRawBufferPointer($0), using: key) }) {
+            return mac
+        }
         var authenticator = Self(key: key)
         authenticator.update(data: data)
         return authenticator.finalize()
     }
+
+    /// Computes a message authentication code for the data in a buffer.
+    ///
+    /// This is the concrete entry point the generic overloads reach for contiguous data. It is pre-specialized for
+    /// the SHA-2 hash functions, so callers in other modules don't go through `HashFunction` witnesses.
+    @usableFromInline
+    @_specialize(where H == SHA256)
+    @_specialize(where H == SHA384)
+    @_specialize(where H == SHA512)
+    static func authenticationCode(bufferPointer: UnsafeRawBufferPointer, using key: SymmetricKey) -> MAC {
+        var authenticator = Self(key: key)
+        authenticator.update(bufferPointer: bufferPointer)
+        return authenticator.finalize()
+    }
     
     /// Returns a Boolean value indicating whether the given message
     /// authentication code is valid for a block of data.
@@ -122,8 +134,9 @@ public struct HMAC<H: HashFunction>: MACAlgorithm {
     ///
     /// - Returns: A Boolean value that’s `true` if the message authentication
     /// code is valid for the specified block of data.
+    @inlinable
     public static func isValidAuthenticationCode<D: DataProtocol>(_ authenticationCode: MAC, authenticating authenticatedData: D, using key: SymmetricKey) -> Bool {
-        return isValidAuthenticationCode(authenticationCodeBytes: authenticationCode, authenticatedData: authenticatedData, key: key)
+        return Self._isValidAuthenticationCode(authenticationCode, computedMac: Self.authenticationCode(for: authenticatedData, using: key))
     }
     
     /// Returns a Boolean value indicating whether the given message
@@ -140,7 +153,7 @@ public struct HMAC<H: HashFunction>: MACAlgorithm {
     public static func isValidAuthenticationCode<C: ContiguousBytes, D: DataProtocol>(_ authenticationCode: C,
                                                                                       authenticating authenticatedData: D,
                                                                                       using key: SymmetricKey) -> Bool {
-        return isValidAuthenticationCode(authenticationCodeBytes: authenticationCode, authenticatedData: authenticatedData, key: key)
+        return safeCompare(authenticationCode, Self.authenticationCode(for: authenticatedData, using: key))
     }
     
     /// Updates the message authentication code computation with a block of
@@ -149,6 +162,9 @@ public struct HMAC<H: HashFunction>: MACAlgorithm {
     /// - Parameters:
     ///   - data: The data for which to compute the authentication code.
     public mutating func update<D: DataProtocol>(data: D) {
+        if data.withContiguousStorageIfAvailable({ self.update(bufferPointer: UnsafeRawBufferPointer($0)) }) != nil {
+            return
+        }
         data.regions.forEach { (memoryRegion) in
             memoryRegion.withUnsafeBytes({ (bp) in
                 self.update(bufferPointer: bp)
@@ -181,14 +197,11 @@ public struct HMAC<H: HashFunction>: MACAlgorithm {
         innerHasher.update(bufferPointer: bufferPointer)
     }
 
-    /// A common implementation of isValidAuthenticationCode shared by the various entry points.
-    private static func isValidAuthenticationCode<C: ContiguousBytes, D: DataProtocol>(authenticationCodeBytes: C,
-                                                                                       authenticatedData: D,
-                                                                                       key: SymmetricKey) -> Bool {
-        var authenticator = Self(key: key)
-        authenticator.update(data: authenticatedData)
-        let computedMac = authenticator.finalize()
-        return safeCompare(authenticationCodeBytes, computedMac)
+    /// Compares a computed code in constant time. `safeCompare` isn't usable from inlinable code, so the inlinable
+    /// entry points come through here.
+    @usableFromInline
+    static func _isValidAuthenticationCode(_ mac: MAC, computedMac: MAC) -> Bool {
+        return safeCompare(mac, computedMac)
     }
 }
 
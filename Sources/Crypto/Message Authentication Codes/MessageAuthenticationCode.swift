@@ -61,7 +61,7 @@ extension MessageAuthenticationCode {
     }
 
     public var description: String {
-        return "\(Self.self): \(Array(self).hexString)"
+        return "\(Self.self): \(self.withUnsafeBytes { $0.hexString })"
     }
 }
 #endif // Linux or !SwiftPM
@@ -61,19 +61,13 @@ extension P256.Signing.ECDSASignature {
 
 extension P256.Signing.PrivateKey {
     func openSSLSignature<D: Digest>(for digest: D) throws -> P256.Signing.ECDSASignature {
-        let baseSignature = try self.impl.key.sign(digest: digest)
-        return try .init(rawRepresentation: Data(rawSignature: baseSignature, over: P256.self))
+        try .init(rawRepresentation: self.impl.key.signRaw(digest: digest))
     }
 }
 
 extension P256.Signing.PublicKey {
     func openSSLIsValidSignature<D: Digest>(_ signature: P256.Signing.ECDSASignature, for digest: D) -> Bool {
-        guard let baseSignature = try? ECDSASignature(rawRepresentation: signature.rawRepresentation) else {
-            // If we can't create a signature, it's not valid.
-            return false
-        }
-
-        return self.impl.key.isValidSignature(baseSignature, for: digest)
+        self.impl.key.isValidRawSignature(signature.rawRepresentation, for: digest)
     }
 }
 
@@ -89,19 +83,13 @@ extension P384.Signing.ECDSASignature {
 
 extension P384.Signing.PrivateKey {
     func openSSLSignature<D: Digest>(for digest: D) throws -> P384.Signing.ECDSASignature {
-        let baseSignature = try self.impl.key.sign(digest: digest)
-        return try .init(rawRepresentation: Data(rawSignature: baseSignature, over: P384.self))
+        try .init(rawRepresentation: self.impl.key.signRaw(digest: digest))
     }
 }
 
 extension P384.Signing.PublicKey {
     func openSSLIsValidSignature<D: Digest>(_ signature: P384.Signing.ECDSASignature, for digest: D) -> Bool {
-        guard let baseSignature = try? ECDSASignature(rawRepresentation: signature.rawRepresentation) else {
-            // If we can't create a signature, it's not valid.
-            return false
-        }
-
-        return self.impl.key.isValidSignature(baseSignature, for: digest)
+        self.impl.key.isValidRawSignature(signature.rawRepresentation, for: digest)
     }
 }
 
@@ -117,19 +105,13 @@ extension P521.Signing.ECDSASignature {
 
 extension P521.Signing.PrivateKey {
     func openSSLSignature<D: Digest>(for digest: D) throws -> P521.Signing.ECDSASignature {
-        let baseSignature = try self.impl.key.sign(digest: digest)
-        return try .init(rawRepresentation: Data(rawSignature: baseSignature, over: P521.self))
+        try .init(rawRepresentation: self.impl.key.signRaw(digest: digest))
     }
 }
 
 extension P521.Signing.PublicKey {
     func openSSLIsValidSignature<D: Digest>(_ signature: P521.Signing.ECDSASignature, for digest: D) -> Bool {
-        guard let baseSignature = try? ECDSASignature(rawRepresentation: signature.rawRepresentation) else {
-            // If we can't create a signature, it's not valid.
-            return false
-        }
-
-        return self.impl.key.isValidSignature(baseSignature, for: digest)
+        self.impl.key.isValidRawSignature(signature.rawRepresentation, for: digest)
     }
 }
 #endif // CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
@@ -23,6 +23,11 @@ extension Curve25519.Signing.PublicKey {
     @usableFromInline
     static let signatureByteCount = Curve25519.Signing.signatureByteCount
 
+    // Verifying a discontiguous message region by region can't use the double scalar multiplication inside `ED25519_verify`,
+    // and costs roughly one more scalar multiplication. Below this size copying the message together is cheaper.
+    @usableFromInline
+    static let discontiguousVerificationThreshold = 1 << 20
+
     @inlinable
     func openSSLIsValidSignature<S: DataProtocol, D: DataProtocol>(_ signature: S, for data: D) -> Bool {
         if signature.count != Curve25519.Signing.PublicKey.signatureByteCount {
@@ -34,12 +39,18 @@ extension Curve25519.Signing.PublicKey {
         case (1, 1):
             // Both data protocols are secretly contiguous.
             return self.openSSLIsValidSignature(contiguousSignature: signature.regions.first!, contiguousData: data.regions.first!)
+        case (1, _) where data.count >= Curve25519.Signing.PublicKey.discontiguousVerificationThreshold:
+            // The data is large enough to be worth hashing where it lies.
+            return self.openSSLIsValidSignature(contiguousSignature: signature.regions.first!, discontiguousData: data)
         case (1, _):
             // The data isn't contiguous: we make it so.
             return self.openSSLIsValidSignature(contiguousSignature: signature.regions.first!, contiguousData: Array(data))
         case (_, 1):
             // The signature isn't contiguous, make it so.
             return self.openSSLIsValidSignature(contiguousSignature: Array(signature), contiguousData: data.regions.first!)
+        case (_, _) where data.count >= Curve25519.Signing.PublicKey.discontiguousVerificationThreshold:
+            // Only the signature is small enough to be worth flattening.
+            return self.openSSLIsValidSignature(contiguousSignature: Array(signature), discontiguousData: data)
         case (_, _):
             // Neither are contiguous.
             return self.openSSLIsValidSignature(contiguousSignature: Array(signature), contiguousData: Array(data))
@@ -69,6 +80,26 @@ extension Curve25519.Signing.PublicKey {
 
         return rc == 1
     }
+
+    @usableFromInline
+    func openSSLIsValidSignature<S: ContiguousBytes, D: DataProtocol>(contiguousSignature signature: S, discontiguousData data: D) -> Bool {
+        precondition(self.keyBytes.count == 32)
+        var context = CCryptoBoringSSLShims_ED25519_VERIFY_CTX()
+
+        signature.withUnsafeBytes { signaturePointer in
+            self.keyBytes.withUnsafeBytes { keyBytesPtr in
+                precondition(signaturePointer.count == Curve25519.Signing.PublicKey.signatureByteCount)
+                CCryptoBoringSSLShims_ED25519_verify_init(&context, signaturePointer.baseAddress, keyBytesPtr.baseAddress)
+            }
+        }
+        for region in data.regions {
+            region.withUnsafeBytes { regionPointer in
+                CCryptoBoringSSLShims_ED25519_verify_update(&context, regionPointer.baseAddress, regionPointer.count)
+            }
+        }
+
+        return CCryptoBoringSSLShims_ED25519_verify_final(&context) == 1
+    }
 }
 
 extension Curve25519.Signing.PrivateKey {
@@ -77,7 +108,7 @@ extension Curve25519.Signing.PrivateKey {
         if data.regions.count == 1 {
             return try self.openSSLSignature(forContiguousData: data.regions.first!)
         } else {
-            return try self.openSSLSignature(forContiguousData: Array(data))
+            return self.openSSLSignature(forDiscontiguousData: data)
         }
     }
 
@@ -91,18 +122,59 @@ extension Curve25519.Signing.PrivateKey {
     @usableFromInline
     func openSSLSignature(forDataPointer dataPointer: UnsafeRawBufferPointer) throws -> Data {
         var signature = Data(repeating: 0, count: Curve25519.Signing.PublicKey.signatureByteCount)
+        let publicKey = self.publicKey.keyBytes
 
-        let rc: CInt = signature.withUnsafeMutableBytes { signaturePointer in
-            self.key.withUnsafeBytes { keyPointer in
-                precondition(signaturePointer.count == Curve25519.Signing.PublicKey.signatureByteCount)
-                precondition(keyPointer.count == ED25519_PRIVATE_KEY_LEN)
+        // The expanded key saves rehashing the seed, which is what `ED25519_sign` would do.
+        signature.withUnsafeMutableBytes { signaturePointer in
+            self.expandedKey.withUnsafeBytes { expandedKeyPointer in
+                publicKey.withUnsafeBytes { publicKeyPointer in
+                    precondition(signaturePointer.count == Curve25519.Signing.PublicKey.signatureByteCount)
+                    precondition(expandedKeyPointer.count == CCryptoBoringSSLShims_ED25519_EXPANDED_KEY_BYTES)
+                    precondition(publicKeyPointer.count == ED25519_PUBLIC_KEY_LEN)
 
-                return CCryptoBoringSSLShims_ED25519_sign(signaturePointer.baseAddress, dataPointer.baseAddress, dataPointer.count, keyPointer.baseAddress)
+                    CCryptoBoringSSLShims_ED25519_sign_expanded(signaturePointer.baseAddress,
+                                                                dataPointer.baseAddress,
+                                                                dataPointer.count,
+                                                                expandedKeyPointer.baseAddress,
+                                                                publicKeyPointer.baseAddress)
+                }
             }
         }
 
-        if rc != 1 {
-            throw CryptoKitError.internalBoringSSLError()
+        return signature
+    }
+
+    // Ed25519 hashes the message twice, once for the nonce and once for the challenge, so we walk the regions twice rather than
+    // copying them together.
+    @usableFromInline
+    func openSSLSignature<D: DataProtocol>(forDiscontiguousData data: D) -> Data {
+        var signature = Data(repeating: 0, count: Curve25519.Signing.PublicKey.signatureByteCount)
+        let publicKey = self.publicKey.keyBytes
+        var context = CCryptoBoringSSLShims_ED25519_SIGN_CTX()
+
+        signature.withUnsafeMutableBytes { signaturePointer in
+            self.expandedKey.withUnsafeBytes { expandedKeyPointer in
+                publicKey.withUnsafeBytes { publicKeyPointer in
+                    precondition(signaturePointer.count == Curve25519.Signing.PublicKey.signatureByteCount)
+                    precondition(expandedKeyPointer.count == CCryptoBoringSSLShims_ED25519_EXPANDED_KEY_BYTES)
+                    precondition(publicKeyPointer.count == ED25519_PUBLIC_KEY_LEN)
+
+                    CCryptoBoringSSLShims_ED25519_sign_init(&context, expandedKeyPointer.baseAddress)
+                    for region in data.regions {
+                        region.withUnsafeBytes { regionPointer in
+                            CCryptoBoringSSLShims_ED25519_sign_update(&context, regionPointer.baseAddress, regionPointer.count)
+                        }
+                    }
+                    CCryptoBoringSSLShims_ED25519_sign_commit(&context, publicKeyPointer.baseAddress)
+                    for region in data.regions {
+                        region.withUnsafeBytes { regionPointer in
+                            CCryptoBoringSSLShims_ED25519_sign_update(&context, regionPointer.baseAddress, regionPointer.count)
+                        }
+                    }
+                    // This also clears the context.
+                    CCryptoBoringSSLShims_ED25519_sign_final(&context, signaturePointer.baseAddress, expandedKeyPointer.baseAddress)
+                }
+            }
         }
 
         return signature
@@ -119,9 +119,7 @@ extension P256.Signing {
             let s = Array(raw.suffix(from: half))[...]
 
             let sig = ASN1.ECDSASignature(r: r, s: s)
-            var serializer = ASN1.Serializer()
-            try! serializer.serialize(sig)
-            return Data(serializer.serializedBytes)
+            return Data(try! ASN1.Serializer.serializedBytes(of: sig))
             #endif
         }
     }
@@ -282,9 +280,7 @@ extension P384.Signing {
             let s = Array(raw.suffix(from: half))[...]
 
             let sig = ASN1.ECDSASignature(r: r, s: s)
-            var serializer = ASN1.Serializer()
-            try! serializer.serialize(sig)
-            return Data(serializer.serializedBytes)
+            return Data(try! ASN1.Serializer.serializedBytes(of: sig))
             #endif
         }
     }
@@ -445,9 +441,7 @@ extension P521.Signing {
             let s = Array(raw.suffix(from: half))[...]
 
             let sig = ASN1.ECDSASignature(r: r, s: s)
-            var serializer = ASN1.Serializer()
-            try! serializer.serialize(sig)
-            return Data(serializer.serializedBytes)
+            return Data(try! ASN1.Serializer.serializedBytes(of: sig))
             #endif
         }
     }
@@ -33,6 +33,9 @@ class FiniteFieldArithmeticContext {
     private var fieldSize: ArbitraryPrecisionInteger
     private var bnCtx: OpaquePointer
 
+    /// The `BN_MONT_CTX` for `fieldSize`, created the first time a Montgomery-domain operation is performed.
+    private var _montgomeryContext: OpaquePointer?
+
     @usableFromInline
     init(fieldSize: ArbitraryPrecisionInteger) throws {
         self.fieldSize = fieldSize
@@ -44,6 +47,9 @@ class FiniteFieldArithmeticContext {
     }
 
     deinit {
+        if let montgomeryContext = self._montgomeryContext {
+            CCryptoBoringSSL_BN_MONT_CTX_free(montgomeryContext)
+        }
         CCryptoBoringSSL_BN_CTX_end(self.bnCtx)
         CCryptoBoringSSL_BN_CTX_free(self.bnCtx)
     }
@@ -156,4 +162,125 @@ extension FiniteFieldArithmeticContext {
         return try ArbitraryPrecisionInteger(copying: actualOutputPointer)
     }
 }
+
+// MARK: - Montgomery-domain operations
+
+/// An element of a finite field, held in the Montgomery domain of a `FiniteFieldArithmeticContext`.
+///
+/// Values in this form can only be combined using the context that produced them. Multiplication and squaring in the
+/// Montgomery domain avoid the division-based reduction of `BN_mod_mul`, and the operations below mutate their
+/// first operand in place, so a chain of field operations does not allocate a new integer per step.
+@usableFromInline
+struct MontgomeryFieldElement {
+    fileprivate var value: ArbitraryPrecisionInteger
+}
+
+extension FiniteFieldArithmeticContext {
+    private func montgomeryContext() throws -> OpaquePointer {
+        if let montgomeryContext = self._montgomeryContext {
+            return montgomeryContext
+        }
+
+        let montgomeryContext = self.fieldSize.withUnsafeBignumPointer { fieldSizePointer in
+            CCryptoBoringSSL_BN_MONT_CTX_new_for_modulus(fieldSizePointer, self.bnCtx)
+        }
+        guard let montgomeryContext = montgomeryContext else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+        self._montgomeryContext = montgomeryContext
+        return montgomeryContext
+    }
+
+    /// Converts `x` into the Montgomery domain, reducing it into the field first.
+    @usableFromInline
+    func montgomeryElement(_ x: ArbitraryPrecisionInteger) throws -> MontgomeryFieldElement {
+        let montgomeryContext = try self.montgomeryContext()
+        var output = ArbitraryPrecisionInteger()
+
+        let rc = x.withUnsafeBignumPointer { xPointer in
+            self.fieldSize.withUnsafeBignumPointer { fieldSizePointer in
+                output.withUnsafeMutableBignumPointer { outputPointer in
+                    guard CCryptoBoringSSL_BN_nnmod(outputPointer, xPointer, fieldSizePointer, self.bnCtx) == 1 else {
+                        return CInt(0)
+                    }
+                    return CCryptoBoringSSL_BN_to_montgomery(outputPointer, outputPointer, montgomeryContext, self.bnCtx)
+                }
+            }
+        }
+
+        guard rc == 1 else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+
+        return MontgomeryFieldElement(value: output)
+    }
+
+    /// Converts `x` out of the Montgomery domain.
+    @usableFromInline
+    func integer(from x: MontgomeryFieldElement) throws -> ArbitraryPrecisionInteger {
+        let montgomeryContext = try self.montgomeryContext()
+        var output = ArbitraryPrecisionInteger()
+
+        let rc = x.value.withUnsafeBignumPointer { xPointer in
+            output.withUnsafeMutableBignumPointer { outputPointer in
+                CCryptoBoringSSL_BN_from_montgomery(outputPointer, xPointer, montgomeryContext, self.bnCtx)
+            }
+        }
+
+        guard rc == 1 else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+
+        return output
+    }
+
+    /// Sets `x` to `x * y`.
+    @usableFromInline
+    func multiply(_ x: inout MontgomeryFieldElement, by y: MontgomeryFieldElement) throws {
+        let montgomeryContext = try self.montgomeryContext()
+
+        let rc = y.value.withUnsafeBignumPointer { yPointer in
+            x.value.withUnsafeMutableBignumPointer { xPointer in
+                CCryptoBoringSSL_BN_mod_mul_montgomery(xPointer, xPointer, yPointer, montgomeryContext, self.bnCtx)
+            }
+        }
+
+        guard rc == 1 else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+    }
+
+    /// Sets `x` to `x * x`.
+    @usableFromInline
+    func square(_ x: inout MontgomeryFieldElement) throws {
+        let montgomeryContext = try self.montgomeryContext()
+
+        let rc = x.value.withUnsafeMutableBignumPointer { xPointer in
+            CCryptoBoringSSL_BN_mod_mul_montgomery(xPointer, xPointer, xPointer, montgomeryContext, self.bnCtx)
+        }
+
+        guard rc == 1 else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+    }
+
+    /// Sets `x` to `x + y`.
+    ///
+    /// Addition is the same in and out of the Montgomery domain. Both operands are already fully reduced,
+    /// so this can use the cheaper quick form.
+    @usableFromInline
+    func add(_ x: inout MontgomeryFieldElement, _ y: MontgomeryFieldElement) throws {
+        let rc = y.value.withUnsafeBignumPointer { yPointer in
+            self.fieldSize.withUnsafeBignumPointer { fieldSizePointer in
+                x.value.withUnsafeMutableBignumPointer { xPointer in
+                    CCryptoBoringSSL_BN_mod_add_quick(xPointer, xPointer, yPointer, fieldSizePointer)
+                }
+            }
+        }
+
+        guard rc == 1 else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+    }
+}
 #endif // CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
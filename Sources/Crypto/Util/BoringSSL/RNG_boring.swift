@@ -14,6 +14,7 @@
 #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
 @_exported import CryptoKit
 #else
+@_implementationOnly import CCryptoBoringSSLShims
 
 extension UnsafeMutableRawBufferPointer {
     func initializeWithRandomBytes(count: Int) {
@@ -22,6 +23,13 @@ extension UnsafeMutableRawBufferPointer {
         }
 
         precondition(count <= self.count)
+
+        // Buffering is opt-in via _CryptoExtras, and draws on BoringSSL's DRBG rather than the system generator.
+        if CCryptoBoringSSLShims_RAND_buffering_enabled() != 0 {
+            CCryptoBoringSSLShims_RAND_bytes(self.baseAddress, count)
+            return
+        }
+
         var rng = SystemRandomNumberGenerator()
 
         // We store bytes 64-bits at a time until we can't anymore.
@@ -25,32 +25,71 @@ private func itoh(_ value: UInt8) -> UInt8 {
     return (value > 9) ? (charA + value - 10) : (char0 + value)
 }
 
-private func htoi(_ value: UInt8) throws -> UInt8 {
+private func htoi(_ value: UInt8, allowingUppercase: Bool) throws -> UInt8 {
     switch value {
     case char0...char0 + 9:
         return value - char0
     case charA...charA + 5:
         return value - charA + 10
+    case (charA - 0x20)...(charA - 0x20 + 5) where allowingUppercase:
+        return value - (charA - 0x20) + 10
     default:
         throw ByteHexEncodingErrors.incorrectHexValue
     }
 }
 
+extension UnsafeRawBufferPointer {
+    /// Writes the lowercase hex encoding of these bytes into `output`, which must be exactly twice as long.
+    ///
+    /// Four bytes are encoded per step, as a 64-bit word: each byte is placed in its own 16-bit lane, split into its
+    /// two nibbles, and all eight nibbles are turned into ASCII at once. No lane carries into the next.
+    func hexEncode(into output: UnsafeMutableRawBufferPointer) {
+        precondition(output.count == self.count * 2)
+        let nibbleMask: UInt64 = 0x000F_000F_000F_000F
+        var index = 0
+        while index + 4 <= self.count {
+            let spread = UInt64(self[index]) | UInt64(self[index + 1]) << 16 | UInt64(self[index + 2]) << 32 | UInt64(self[index + 3]) << 48
+            // The high nibble of each byte goes first, so into the lower byte of its lane.
+            let nibbles = ((spread >> 4) & nibbleMask) | ((spread & nibbleMask) << 8)
+            // Nibbles above 9 overflow into bit 4 when 6 is added, and need 0x27 more to reach "a".
+            let letters = ((nibbles &+ 0x0606_0606_0606_0606) >> 4) & 0x0101_0101_0101_0101
+            let ascii = nibbles &+ 0x3030_3030_3030_3030 &+ letters &* 0x27
+            output.storeBytes(of: ascii.littleEndian, toByteOffset: index * 2, as: UInt64.self)
+            index += 4
+        }
+        while index < self.count {
+            output[index * 2] = itoh(self[index] >> 4)
+            output[index * 2 + 1] = itoh(self[index] & 0xF)
+            index += 1
+        }
+    }
+
+    /// Decodes the hex characters in this buffer into `output`, which must be exactly half as long.
+    func hexDecode(into output: UnsafeMutableRawBufferPointer, allowingUppercase: Bool) throws {
+        precondition(self.count == output.count * 2)
+        for index in 0..<output.count {
+            let high = try htoi(self[index * 2], allowingUppercase: allowingUppercase)
+            let low = try htoi(self[index * 2 + 1], allowingUppercase: allowingUppercase)
+            output[index] = high << 4 | low
+        }
+    }
+}
+
 extension DataProtocol {
     var hexString: String {
-        let hexLen = self.count * 2
-        var hexChars = [UInt8](repeating: 0, count: hexLen)
-        var offset = 0
-        
-        self.regions.forEach { (_) in
-            for i in self {
-                hexChars[Int(offset * 2)] = itoh((i >> 4) & 0xF)
-                hexChars[Int(offset * 2 + 1)] = itoh(i & 0xF)
-                offset += 1
+        let hexChars = [UInt8](unsafeUninitializedCapacity: self.count * 2) { hexChars, initializedCount in
+            let output = UnsafeMutableRawBufferPointer(hexChars)
+            var offset = 0
+            for region in self.regions {
+                region.withUnsafeBytes { region in
+                    region.hexEncode(into: UnsafeMutableRawBufferPointer(rebasing: output[(offset * 2)..<((offset + region.count) * 2)]))
+                    offset += region.count
+                }
             }
+            initializedCount = hexChars.count
         }
-        
-        return String(bytes: hexChars, encoding: .utf8)!
+
+        return String(decoding: hexChars, as: UTF8.self)
     }
 }
 
@@ -60,41 +99,36 @@ extension MutableDataProtocol {
     }
 }
 
-extension Data {
-    init(hexString: String) throws {
-        self.init()
-
-        if hexString.count % 2 != 0 || hexString.count == 0 {
+extension String {
+    /// Decodes this string's hex characters, which must be a non-empty, even number of them.
+    fileprivate func hexDecoded(allowingUppercase: Bool) throws -> [UInt8] {
+        guard self.utf8.count.isMultiple(of: 2), !self.utf8.isEmpty else {
             throw ByteHexEncodingErrors.incorrectString
         }
 
-        let stringBytes: [UInt8] = Array(hexString.lowercased().data(using: String.Encoding.utf8)!)
-
-        for i in stride(from: stringBytes.startIndex, to: stringBytes.endIndex - 1, by: 2) {
-            let char1 = stringBytes[i]
-            let char2 = stringBytes[i + 1]
+        func decode(_ characters: UnsafeBufferPointer<UInt8>) throws -> [UInt8] {
+            try [UInt8](unsafeUninitializedCapacity: characters.count / 2) { bytes, initializedCount in
+                try UnsafeRawBufferPointer(characters).hexDecode(into: UnsafeMutableRawBufferPointer(bytes), allowingUppercase: allowingUppercase)
+                initializedCount = bytes.count
+            }
+        }
 
-            try self.append(htoi(char1) << 4 + htoi(char2))
+        // Native strings are stored as UTF-8 and can be read in place; bridged ones may not be.
+        if let bytes = try self.utf8.withContiguousStorageIfAvailable(decode) {
+            return bytes
         }
+        return try Array(self.utf8).withUnsafeBufferPointer(decode)
     }
 }
 
-extension Array where Element == UInt8 {
+extension Data {
     init(hexString: String) throws {
-        self.init()
-        
-        guard hexString.count.isMultiple(of: 2), !hexString.isEmpty else {
-            throw ByteHexEncodingErrors.incorrectString
-        }
-
-        let stringBytes: [UInt8] = Array(hexString.data(using: String.Encoding.utf8)!)
-
-        for i in stride(from: stringBytes.startIndex, to: stringBytes.endIndex - 1, by: 2) {
-            let char1 = stringBytes[i]
-            let char2 = stringBytes[i + 1]
-
-            try self.append(htoi(char1) << 4 + htoi(char2))
-        }
+        self.init(try hexString.hexDecoded(allowingUppercase: true))
     }
+}
 
+extension Array where Element == UInt8 {
+    init(hexString: String) throws {
+        self = try hexString.hexDecoded(allowingUppercase: false)
+    }
 }
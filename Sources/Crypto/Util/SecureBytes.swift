@@ -251,13 +251,17 @@ extension SecureBytes {
 
         @usableFromInline
         class func createEmpty() -> Backing {
-            return Backing.create(minimumCapacity: 0, makingHeaderWith: { _ in BackingHeader(count: 0, capacity: 0) }) as! Backing
+            let buffer = Backing.create(minimumCapacity: 0, makingHeaderWith: { _ in BackingHeader(count: 0, capacity: 0) })
+            return unsafeDowncast(buffer, to: Backing.self)
         }
 
         @usableFromInline
         class func create(capacity: Int) -> Backing {
             let capacity = Int(UInt32(capacity).nextPowerOf2ClampedToMax())
-            return Backing.create(minimumCapacity: capacity, makingHeaderWith: { _ in BackingHeader(count: 0, capacity: capacity) }) as! Backing
+            let buffer = Backing.create(minimumCapacity: capacity, makingHeaderWith: { _ in BackingHeader(count: 0, capacity: capacity) })
+            // ManagedBuffer.create always returns an instance of the class it is called on, so the checked
+            // cast is pure overhead on every key creation.
+            return unsafeDowncast(buffer, to: Backing.self)
         }
 
         @usableFromInline
@@ -48,9 +48,29 @@ extension BoringSSLAEAD {
             }
         }
 
+        /// Creates a context that `initialize` sets up, for callers that derive the key in the same C call that
+        /// initialises the context, so that the key never reaches Swift.
+        ///
+        /// `initialize` is passed the `EVP_AEAD` for `cipher` and the `EVP_AEAD_CTX` to initialise, and returns
+        /// whether it succeeded.
+        public init(cipher: BoringSSLAEAD, initializingWith initialize: (_ aead: OpaquePointer, _ context: UnsafeMutableRawPointer) -> Bool) throws {
+            self.context = EVP_AEAD_CTX()
+
+            // A context that failed to initialise is left empty, and cleaning it up in deinit does nothing.
+            let initialized = withUnsafeMutablePointer(to: &self.context) { contextPointer in
+                initialize(cipher.boringSSLCipher, UnsafeMutableRawPointer(contextPointer))
+            }
+
+            guard initialized else {
+                throw CryptoBoringWrapperError.internalBoringSSLError()
+            }
+        }
+
         deinit {
             withUnsafeMutablePointer(to: &self.context) { contextPointer in
                 CCryptoBoringSSL_EVP_AEAD_CTX_cleanup(contextPointer)
+                // The AES-GCM cleanup is a no-op, which would leave the key schedule in freed memory.
+                CCryptoBoringSSL_OPENSSL_cleanse(contextPointer, MemoryLayout<EVP_AEAD_CTX>.size)
             }
         }
     }
@@ -65,12 +85,16 @@ extension BoringSSLAEAD.AEADContext {
         // initializer that gives us access to its uninitialized memory, so the cost of creating this Data is the cost of allocating the data + the cost of initializing
         // it. For smaller plaintexts this isn't too big a deal, but for larger ones the initialization cost can really get hairy.
         //
-        // We can avoid this by using Data(bytesNoCopy:deallocator:), so that's what we do. In principle we can do slightly better in the case where we have a discontiguous Plaintext
-        // type, but it's honestly not worth it enough to justify the code complexity.
+        // We can avoid this by using Data(bytesNoCopy:deallocator:), so that's what we do. Discontiguous inputs are fed to BoringSSL a region at a time where the
+        // AEAD allows it, and only copied together where it doesn't.
         switch (message.regions.count, authenticatedData.regions.count) {
         case (1, 1):
             // We can use a nice fast-path here.
             return try self._sealContiguous(message: message.regions.first!, nonce: nonce, authenticatedData: authenticatedData.regions.first!)
+        case _ where self._supportsDiscontiguous:
+            return try nonce.withUnsafeBytes { noncePointer in
+                try self._sealDiscontiguous(message: message, noncePointer: noncePointer, authenticatedData: authenticatedData)
+            }
         case (1, _):
             let contiguousAD = Array(authenticatedData)
             return try self._sealContiguous(message: message.regions.first!, nonce: nonce, authenticatedData: contiguousAD)
@@ -128,6 +152,60 @@ extension BoringSSLAEAD.AEADContext {
         let tag = Data(bytesNoCopy: tagBuffer.baseAddress!, count: actualTagSize, deallocator: .free)
         return (ciphertext: output, tag: tag)
     }
+
+    /// An entry point for sealing data into a caller-provided buffer, avoiding any allocation.
+    ///
+    /// The ciphertext is written to the front of `output`, immediately followed by the tag, so `output` must be exactly
+    /// `message.count` plus the tag size. `message` may be the prefix of `output`, in which case the data is sealed in place.
+    @inlinable
+    public func seal<Nonce: ContiguousBytes, AuthenticatedData: DataProtocol>(message: UnsafeRawBufferPointer, nonce: Nonce, authenticatedData: AuthenticatedData, into output: UnsafeMutableRawBufferPointer) throws {
+        if authenticatedData.regions.count == 1 {
+            // We can use a nice fast-path here.
+            try self._sealContiguous(message: message, nonce: nonce, authenticatedData: authenticatedData.regions.first!, into: output)
+        } else if self._supportsDiscontiguous {
+            try nonce.withUnsafeBytes { noncePointer in
+                try self._sealDiscontiguous(message: message, noncePointer: noncePointer, authenticatedData: authenticatedData, into: output)
+            }
+        } else {
+            let contiguousAD = Array(authenticatedData)
+            try self._sealContiguous(message: message, nonce: nonce, authenticatedData: contiguousAD, into: output)
+        }
+    }
+
+    /// A fast-path for sealing contiguous data into a caller-provided buffer. Also inlinable to gain specialization information.
+    @inlinable
+    func _sealContiguous<Nonce: ContiguousBytes, AuthenticatedData: ContiguousBytes>(message: UnsafeRawBufferPointer, nonce: Nonce, authenticatedData: AuthenticatedData, into output: UnsafeMutableRawBufferPointer) throws {
+        try nonce.withUnsafeBytes { noncePointer in
+            try authenticatedData.withUnsafeBytes { authenticatedDataPointer in
+                try self._sealContiguous(plaintext: message, noncePointer: noncePointer, authenticatedData: authenticatedDataPointer, into: output)
+            }
+        }
+    }
+
+    /// The unsafe base call: not inlinable so that it can touch private variables.
+    @usableFromInline
+    func _sealContiguous(plaintext: UnsafeRawBufferPointer, noncePointer: UnsafeRawBufferPointer, authenticatedData: UnsafeRawBufferPointer, into output: UnsafeMutableRawBufferPointer) throws {
+        let tagByteCount = CCryptoBoringSSL_EVP_AEAD_max_overhead(self.context.aead)
+        precondition(output.count == plaintext.count + tagByteCount)
+
+        let tagBuffer = UnsafeMutableRawBufferPointer(rebasing: output[(output.count - tagByteCount)...])
+        var actualTagSize = tagBuffer.count
+
+        let rc = withUnsafeMutablePointer(to: &self.context) { contextPointer in
+            CCryptoBoringSSLShims_EVP_AEAD_CTX_seal_scatter(contextPointer,
+                                                            output.baseAddress,
+                                                            tagBuffer.baseAddress, &actualTagSize, tagBuffer.count,
+                                                            noncePointer.baseAddress, noncePointer.count,
+                                                            plaintext.baseAddress, plaintext.count,
+                                                            nil, 0,
+                                                            authenticatedData.baseAddress, authenticatedData.count)
+        }
+
+        guard rc == 1 else {
+            throw CryptoBoringWrapperError.internalBoringSSLError()
+        }
+        precondition(actualTagSize == tagByteCount)
+    }
 }
 
 // MARK: - Opening
@@ -140,11 +218,13 @@ extension BoringSSLAEAD.AEADContext {
         // initializer that gives us access to its uninitialized memory, so the cost of creating this Data is the cost of allocating the data + the cost of initializing
         // it. For smaller plaintexts this isn't too big a deal, but for larger ones the initialization cost can really get hairy.
         //
-        // We can avoid this by using Data(bytesNoCopy:deallocator:), so that's what we do. In principle we can do slightly better in the case where we have a discontiguous Plaintext
-        // type, but it's honestly not worth it enough to justify the code complexity.
+        // We can avoid this by using Data(bytesNoCopy:deallocator:), so that's what we do. Discontiguous authenticated data is fed to BoringSSL a region at a time
+        // where the AEAD allows it, and only copied together where it doesn't.
         if authenticatedData.regions.count == 1 {
             // We can use a nice fast-path here.
             return try self._openContiguous(ciphertext: ciphertext, nonce: nonce, tag: tag, authenticatedData: authenticatedData.regions.first!)
+        } else if self._supportsDiscontiguous {
+            return try self._openDiscontiguous(ciphertext: ciphertext, nonce: nonce, tag: tag, authenticatedData: authenticatedData)
         } else {
             let contiguousAD = Array(authenticatedData)
             return try self._openContiguous(ciphertext: ciphertext, nonce: nonce, tag: tag, authenticatedData: contiguousAD)
@@ -198,11 +278,13 @@ extension BoringSSLAEAD.AEADContext {
         // initializer that gives us access to its uninitialized memory, so the cost of creating this Data is the cost of allocating the data + the cost of initializing
         // it. For smaller plaintexts this isn't too big a deal, but for larger ones the initialization cost can really get hairy.
         //
-        // We can avoid this by using Data(bytesNoCopy:deallocator:), so that's what we do. In principle we can do slightly better in the case where we have a discontiguous Plaintext
-        // type, but it's honestly not worth it enough to justify the code complexity.
+        // We can avoid this by using Data(bytesNoCopy:deallocator:), so that's what we do. Discontiguous authenticated data is fed to BoringSSL a region at a time
+        // where the AEAD allows it, and only copied together where it doesn't.
         if authenticatedData.regions.count == 1 {
             // We can use a nice fast-path here.
             return try self._openContiguous(combinedCiphertextAndTag: combinedCiphertextAndTag, nonce: nonce, authenticatedData: authenticatedData.regions.first!)
+        } else if self._supportsDiscontiguous {
+            return try self._openDiscontiguous(combinedCiphertextAndTag: combinedCiphertextAndTag, nonce: nonce, authenticatedData: authenticatedData)
         } else {
             let contiguousAD = Array(authenticatedData)
             return try self._openContiguous(combinedCiphertextAndTag: combinedCiphertextAndTag, nonce: nonce, authenticatedData: contiguousAD)
@@ -247,6 +329,520 @@ extension BoringSSLAEAD.AEADContext {
         return output
     }
 
+    /// An entry point for opening data in place in a caller-provided buffer, avoiding any allocation.
+    ///
+    /// `buffer` must hold the ciphertext immediately followed by the tag. On success the plaintext overwrites the ciphertext
+    /// and the number of plaintext bytes is returned. On failure the ciphertext portion of `buffer` is zeroed.
+    @inlinable
+    public func open<Nonce: ContiguousBytes, AuthenticatedData: DataProtocol>(inPlace buffer: UnsafeMutableRawBufferPointer, nonce: Nonce, authenticatedData: AuthenticatedData) throws -> Int {
+        if authenticatedData.regions.count == 1 {
+            // We can use a nice fast-path here.
+            return try self._openContiguous(inPlace: buffer, nonce: nonce, authenticatedData: authenticatedData.regions.first!)
+        } else if self._supportsDiscontiguous {
+            return try nonce.withUnsafeBytes { nonceBytes in
+                try self._openDiscontiguous(inPlace: buffer, nonceBytes: nonceBytes, authenticatedData: authenticatedData)
+            }
+        } else {
+            let contiguousAD = Array(authenticatedData)
+            return try self._openContiguous(inPlace: buffer, nonce: nonce, authenticatedData: contiguousAD)
+        }
+    }
+
+    /// A fast-path for opening contiguous data in place. Also inlinable to gain specialization information.
+    @inlinable
+    func _openContiguous<Nonce: ContiguousBytes, AuthenticatedData: ContiguousBytes>(inPlace buffer: UnsafeMutableRawBufferPointer, nonce: Nonce, authenticatedData: AuthenticatedData) throws -> Int {
+        try nonce.withUnsafeBytes { nonceBytes in
+            try authenticatedData.withUnsafeBytes { authenticatedDataBytes in
+                try self._openContiguous(inPlace: buffer, nonceBytes: nonceBytes, authenticatedData: authenticatedDataBytes)
+            }
+        }
+    }
+
+    /// The unsafe base call: not inlinable so that it can touch private variables.
+    @usableFromInline
+    func _openContiguous(inPlace buffer: UnsafeMutableRawBufferPointer, nonceBytes: UnsafeRawBufferPointer, authenticatedData: UnsafeRawBufferPointer) throws -> Int {
+        let tagByteCount = CCryptoBoringSSL_EVP_AEAD_max_overhead(self.context.aead)
+        precondition(buffer.count >= tagByteCount)
+        let ciphertextByteCount = buffer.count - tagByteCount
+
+        let rc = withUnsafePointer(to: &self.context) { contextPointer in
+            return CCryptoBoringSSLShims_EVP_AEAD_CTX_open_gather(contextPointer,
+                                                           buffer.baseAddress,
+                                                           nonceBytes.baseAddress, nonceBytes.count,
+                                                           buffer.baseAddress, ciphertextByteCount,
+                                                           buffer.baseAddress.map { $0 + ciphertextByteCount }, tagByteCount,
+                                                           authenticatedData.baseAddress, authenticatedData.count)
+        }
+
+        guard rc == 1 else {
+            throw CryptoBoringWrapperError.internalBoringSSLError()
+        }
+
+        return ciphertextByteCount
+    }
+
+}
+
+// MARK: - Discontiguous data
+
+extension BoringSSLAEAD.AEADContext {
+    /// Whether this context's AEAD can be fed discontiguous data a region at a time, rather than having it copied together first.
+    @usableFromInline
+    var _supportsDiscontiguous: Bool {
+        withUnsafePointer(to: &self.context) { contextPointer in
+            CCryptoBoringSSLShims_AEAD_STREAM_supported(contextPointer) == 1
+        }
+    }
+
+    /// Seals a message and authenticated data of any shape by feeding each of their regions to BoringSSL in turn.
+    @usableFromInline
+    func _sealDiscontiguous<Plaintext: DataProtocol, AuthenticatedData: DataProtocol>(message: Plaintext, noncePointer: UnsafeRawBufferPointer, authenticatedData: AuthenticatedData) throws -> (ciphertext: Data, tag: Data) {
+        let tagByteCount = CCryptoBoringSSL_EVP_AEAD_max_overhead(self.context.aead)
+
+        // We use malloc here because we are going to call free later. We force unwrap to trigger crashes if the allocation
+        // fails.
+        let outputBuffer = UnsafeMutableRawBufferPointer(start: malloc(message.count)!, count: message.count)
+        let tagBuffer = UnsafeMutableRawBufferPointer(start: malloc(tagByteCount)!, count: tagByteCount)
+
+        guard let actualTagSize = self._sealDiscontiguous(message: message, noncePointer: noncePointer, authenticatedData: authenticatedData, output: outputBuffer, tag: tagBuffer) else {
+            // Ooops, error. Free the memory we allocated before we throw.
+            free(outputBuffer.baseAddress)
+            free(tagBuffer.baseAddress)
+            throw CryptoBoringWrapperError.internalBoringSSLError()
+        }
+
+        let output = Data(bytesNoCopy: outputBuffer.baseAddress!, count: outputBuffer.count, deallocator: .free)
+        let tag = Data(bytesNoCopy: tagBuffer.baseAddress!, count: actualTagSize, deallocator: .free)
+        return (ciphertext: output, tag: tag)
+    }
+
+    /// Seals a message into a caller-provided buffer with authenticated data of any shape. The layout of `output` is as for
+    /// ``seal(message:nonce:authenticatedData:into:)``.
+    @usableFromInline
+    func _sealDiscontiguous<AuthenticatedData: DataProtocol>(message: UnsafeRawBufferPointer, noncePointer: UnsafeRawBufferPointer, authenticatedData: AuthenticatedData, into output: UnsafeMutableRawBufferPointer) throws {
+        let tagByteCount = CCryptoBoringSSL_EVP_AEAD_max_overhead(self.context.aead)
+        precondition(output.count == message.count + tagByteCount)
+
+        let tagBuffer = UnsafeMutableRawBufferPointer(rebasing: output[(output.count - tagByteCount)...])
+        guard let actualTagSize = self._sealDiscontiguous(message: message, noncePointer: noncePointer, authenticatedData: authenticatedData, output: output, tag: tagBuffer) else {
+            throw CryptoBoringWrapperError.internalBoringSSLError()
+        }
+        precondition(actualTagSize == tagByteCount)
+    }
+
+    /// Opens a ciphertext with authenticated data of any shape.
+    @usableFromInline
+    func _openDiscontiguous<Nonce: ContiguousBytes, AuthenticatedData: DataProtocol>(ciphertext: Data, nonce: Nonce, tag: Data, authenticatedData: AuthenticatedData) throws -> Data {
+        // We use malloc here because we are going to call free later. We force unwrap to trigger crashes if the allocation
+        // fails.
+        let outputBuffer = UnsafeMutableRawBufferPointer(start: malloc(ciphertext.count)!, count: ciphertext.count)
+
+        let opened = ciphertext.withUnsafeBytes { ciphertextPointer in
+            nonce.withUnsafeBytes { nonceBytes in
+                tag.withUnsafeBytes { tagBytes in
+                    self._openDiscontiguous(ciphertext: ciphertextPointer, nonceBytes: nonceBytes, tagBytes: tagBytes, authenticatedData: authenticatedData, output: outputBuffer)
+                }
+            }
+        }
+
+        guard opened else {
+            // Ooops, error. Free the memory we allocated before we throw.
+            free(outputBuffer.baseAddress)
+            throw CryptoBoringWrapperError.internalBoringSSLError()
+        }
+
+        return Data(bytesNoCopy: outputBuffer.baseAddress!, count: outputBuffer.count, deallocator: .free)
+    }
+
+    /// Opens a combined ciphertext and tag with authenticated data of any shape.
+    @usableFromInline
+    func _openDiscontiguous<Nonce: ContiguousBytes, AuthenticatedData: DataProtocol>(combinedCiphertextAndTag: Data, nonce: Nonce, authenticatedData: AuthenticatedData) throws -> Data {
+        let tagByteCount = CCryptoBoringSSL_EVP_AEAD_max_overhead(self.context.aead)
+        guard combinedCiphertextAndTag.count >= tagByteCount else {
+            throw CryptoBoringWrapperError.internalBoringSSLError()
+        }
+        let ciphertextByteCount = combinedCiphertextAndTag.count - tagByteCount
+
+        // We use malloc here because we are going to call free later. We force unwrap to trigger crashes if the allocation
+        // fails.
+        let outputBuffer = UnsafeMutableRawBufferPointer(start: malloc(ciphertextByteCount)!, count: ciphertextByteCount)
+
+        let opened = combinedCiphertextAndTag.withUnsafeBytes { combinedPointer in
+            nonce.withUnsafeBytes { nonceBytes in
+                self._openDiscontiguous(ciphertext: UnsafeRawBufferPointer(rebasing: combinedPointer.prefix(ciphertextByteCount)),
+                                        nonceBytes: nonceBytes,
+                                        tagBytes: UnsafeRawBufferPointer(rebasing: combinedPointer.suffix(tagByteCount)),
+                                        authenticatedData: authenticatedData,
+                                        output: outputBuffer)
+            }
+        }
+
+        guard opened else {
+            // Ooops, error. Free the memory we allocated before we throw.
+            free(outputBuffer.baseAddress)
+            throw CryptoBoringWrapperError.internalBoringSSLError()
+        }
+
+        return Data(bytesNoCopy: outputBuffer.baseAddress!, count: outputBuffer.count, deallocator: .free)
+    }
+
+    /// Opens a ciphertext in place with authenticated data of any shape. The layout of `buffer` is as for
+    /// ``open(inPlace:nonce:authenticatedData:)``.
+    @usableFromInline
+    func _openDiscontiguous<AuthenticatedData: DataProtocol>(inPlace buffer: UnsafeMutableRawBufferPointer, nonceBytes: UnsafeRawBufferPointer, authenticatedData: AuthenticatedData) throws -> Int {
+        let tagByteCount = CCryptoBoringSSL_EVP_AEAD_max_overhead(self.context.aead)
+        precondition(buffer.count >= tagByteCount)
+        let ciphertextByteCount = buffer.count - tagByteCount
+
+        let opened = self._openDiscontiguous(ciphertext: UnsafeRawBufferPointer(rebasing: buffer[..<ciphertextByteCount]),
+                                             nonceBytes: nonceBytes,
+                                             tagBytes: UnsafeRawBufferPointer(rebasing: buffer[ciphertextByteCount...]),
+                                             authenticatedData: authenticatedData,
+                                             output: UnsafeMutableRawBufferPointer(rebasing: buffer[..<ciphertextByteCount]))
+
+        guard opened else {
+            throw CryptoBoringWrapperError.internalBoringSSLError()
+        }
+
+        return ciphertextByteCount
+    }
+
+    /// Seals `message` region by region into the front of `output`, returning the size of the tag written to `tag`, or `nil` on failure.
+    private func _sealDiscontiguous<Plaintext: DataProtocol, AuthenticatedData: DataProtocol>(message: Plaintext, noncePointer: UnsafeRawBufferPointer, authenticatedData: AuthenticatedData, output: UnsafeMutableRawBufferPointer, tag: UnsafeMutableRawBufferPointer) -> Int? {
+        var actualTagSize = tag.count
+        let rc = self._withStream(noncePointer: noncePointer, encrypt: true) { stream in
+            guard stream.update(authenticatedData: authenticatedData) else {
+                return 0
+            }
+
+            var offset = 0
+            for region in message.regions {
+                let rc = region.withUnsafeBytes { regionPointer -> CInt in
+                    let rc = CCryptoBoringSSLShims_AEAD_STREAM_update(stream, regionPointer.baseAddress, output.baseAddress.map { $0 + offset }, regionPointer.count)
+                    offset += regionPointer.count
+                    return rc
+                }
+                guard rc == 1 else {
+                    return 0
+                }
+            }
+
+            return CCryptoBoringSSLShims_AEAD_STREAM_seal_final(stream, tag.baseAddress, &actualTagSize, tag.count)
+        }
+
+        return rc == 1 ? actualTagSize : nil
+    }
+
+    /// Opens `ciphertext` into `output`, which may be the same memory. As `EVP_AEAD_CTX_open_gather` does, `output` is zeroed
+    /// on failure so that no unauthenticated plaintext is left behind.
+    private func _openDiscontiguous<AuthenticatedData: DataProtocol>(ciphertext: UnsafeRawBufferPointer, nonceBytes: UnsafeRawBufferPointer, tagBytes: UnsafeRawBufferPointer, authenticatedData: AuthenticatedData, output: UnsafeMutableRawBufferPointer) -> Bool {
+        let rc = self._withStream(noncePointer: nonceBytes, encrypt: false) { stream in
+            guard stream.update(authenticatedData: authenticatedData),
+                  CCryptoBoringSSLShims_AEAD_STREAM_update(stream, ciphertext.baseAddress, output.baseAddress, ciphertext.count) == 1 else {
+                return 0
+            }
+            return CCryptoBoringSSLShims_AEAD_STREAM_open_final(stream, tagBytes.baseAddress, tagBytes.count)
+        }
+
+        guard rc == 1 else {
+            if let outputPointer = output.baseAddress {
+                memset(outputPointer, 0, ciphertext.count)
+            }
+            return false
+        }
+        return true
+    }
+
+    private func _withStream(noncePointer: UnsafeRawBufferPointer, encrypt: Bool, _ body: (UnsafeMutablePointer<CCryptoBoringSSLShims_AEAD_STREAM>) -> CInt) -> CInt {
+        var stream = CCryptoBoringSSLShims_AEAD_STREAM()
+        defer {
+            withUnsafeMutableBytes(of: &stream) { streamBytes in
+                CCryptoBoringSSL_OPENSSL_cleanse(streamBytes.baseAddress, streamBytes.count)
+            }
+        }
+
+        // The stream reads the key from the context, so everything has to happen while we hold a pointer to it.
+        return withUnsafePointer(to: &self.context) { contextPointer in
+            withUnsafeMutablePointer(to: &stream) { streamPointer in
+                guard CCryptoBoringSSLShims_AEAD_STREAM_init(streamPointer, contextPointer, noncePointer.baseAddress, noncePointer.count, encrypt ? 1 : 0) == 1 else {
+                    return 0
+                }
+                return body(streamPointer)
+            }
+        }
+    }
+}
+
+extension UnsafeMutablePointer where Pointee == CCryptoBoringSSLShims_AEAD_STREAM {
+    fileprivate func update<AuthenticatedData: DataProtocol>(authenticatedData: AuthenticatedData) -> Bool {
+        for region in authenticatedData.regions {
+            let rc = region.withUnsafeBytes { regionPointer in
+                CCryptoBoringSSLShims_AEAD_STREAM_update_ad(self, regionPointer.baseAddress, regionPointer.count)
+            }
+            guard rc == 1 else {
+                return false
+            }
+        }
+        return true
+    }
+}
+
+// MARK: - Hashing the plaintext
+
+extension BoringSSLAEAD.AEADContext {
+    /// Seals a message into a caller-provided buffer as ``seal(message:nonce:authenticatedData:into:)`` does, and writes the
+    /// SHA-256 digest of the message into `digest`, which must be 32 bytes.
+    ///
+    /// The message is read from memory once: each cache-sized chunk is hashed and then encrypted while it is still in cache.
+    /// Only the streamable AEADs are supported.
+    public func sealHashingPlaintext<Nonce: ContiguousBytes, AuthenticatedData: DataProtocol>(message: UnsafeRawBufferPointer, nonce: Nonce, authenticatedData: AuthenticatedData, into output: UnsafeMutableRawBufferPointer, digest: UnsafeMutableRawBufferPointer) throws {
+        let tagByteCount = CCryptoBoringSSL_EVP_AEAD_max_overhead(self.context.aead)
+        precondition(output.count == message.count + tagByteCount)
+        precondition(digest.count == Int(SHA256_DIGEST_LENGTH))
+        guard self._supportsDiscontiguous else {
+            throw CryptoBoringWrapperError.internalBoringSSLError()
+        }
+
+        let tag = UnsafeMutableRawBufferPointer(rebasing: output[(output.count - tagByteCount)...])
+        var actualTagSize = tag.count
+        let rc = nonce.withUnsafeBytes { noncePointer in
+            self._withStream(noncePointer: noncePointer, encrypt: true) { stream in
+                self._withSHA256(into: digest) { sha256 in
+                    guard stream.update(authenticatedData: authenticatedData),
+                          CCryptoBoringSSLShims_AEAD_STREAM_update_sha256(stream, sha256, message.baseAddress, output.baseAddress, message.count) == 1 else {
+                        return 0
+                    }
+                    return CCryptoBoringSSLShims_AEAD_STREAM_seal_final(stream, tag.baseAddress, &actualTagSize, tag.count)
+                }
+            }
+        }
+        guard rc == 1 else {
+            throw CryptoBoringWrapperError.internalBoringSSLError()
+        }
+        precondition(actualTagSize == tagByteCount)
+    }
+
+    /// Opens a ciphertext in place as ``open(inPlace:nonce:authenticatedData:)`` does, and writes the SHA-256 digest of the
+    /// plaintext into `digest`, which must be 32 bytes.
+    ///
+    /// Each cache-sized chunk is decrypted and then hashed while it is still in cache. On failure both the ciphertext portion
+    /// of `buffer` and `digest` are zeroed. Only the streamable AEADs are supported.
+    public func openHashingPlaintext<Nonce: ContiguousBytes, AuthenticatedData: DataProtocol>(inPlace buffer: UnsafeMutableRawBufferPointer, nonce: Nonce, authenticatedData: AuthenticatedData, digest: UnsafeMutableRawBufferPointer) throws -> Int {
+        let tagByteCount = CCryptoBoringSSL_EVP_AEAD_max_overhead(self.context.aead)
+        precondition(buffer.count >= tagByteCount)
+        precondition(digest.count == Int(SHA256_DIGEST_LENGTH))
+        guard self._supportsDiscontiguous else {
+            throw CryptoBoringWrapperError.internalBoringSSLError()
+        }
+        let ciphertextByteCount = buffer.count - tagByteCount
+
+        let rc = nonce.withUnsafeBytes { noncePointer in
+            self._withStream(noncePointer: noncePointer, encrypt: false) { stream in
+                self._withSHA256(into: digest) { sha256 in
+                    guard stream.update(authenticatedData: authenticatedData),
+                          CCryptoBoringSSLShims_AEAD_STREAM_update_sha256(stream, sha256, buffer.baseAddress, buffer.baseAddress, ciphertextByteCount) == 1 else {
+                        return 0
+                    }
+                    return CCryptoBoringSSLShims_AEAD_STREAM_open_final(stream, buffer.baseAddress.map { $0 + ciphertextByteCount }, tagByteCount)
+                }
+            }
+        }
+        guard rc == 1 else {
+            // Neither the plaintext nor its digest may be used unauthenticated.
+            if let bufferPointer = buffer.baseAddress {
+                memset(bufferPointer, 0, ciphertextByteCount)
+            }
+            memset(digest.baseAddress!, 0, digest.count)
+            throw CryptoBoringWrapperError.internalBoringSSLError()
+        }
+        return ciphertextByteCount
+    }
+
+    private func _withSHA256(into digest: UnsafeMutableRawBufferPointer, _ body: (UnsafeMutablePointer<SHA256_CTX>) -> CInt) -> CInt {
+        var sha256 = SHA256_CTX()
+        defer {
+            withUnsafeMutableBytes(of: &sha256) { sha256Bytes in
+                CCryptoBoringSSL_OPENSSL_cleanse(sha256Bytes.baseAddress, sha256Bytes.count)
+            }
+        }
+        CCryptoBoringSSL_SHA256_Init(&sha256)
+        let rc = body(&sha256)
+        CCryptoBoringSSL_SHA256_Final(digest.baseAddress!.assumingMemoryBound(to: UInt8.self), &sha256)
+        return rc
+    }
+}
+
+// MARK: - Incremental streams
+
+extension BoringSSLAEAD {
+    /// A single seal or open whose message arrives a piece at a time, across calls, with one tag at the end.
+    ///
+    /// The stream owns its own `EVP_AEAD_CTX`, on the heap so that it doesn't move while the streaming state points into
+    /// it. Only the streamable AEADs are supported. A stream is not safe to use from several threads at once.
+    public final class AEADStream {
+        private let context: UnsafeMutablePointer<EVP_AEAD_CTX>
+
+        private let stream: UnsafeMutablePointer<CCryptoBoringSSLShims_AEAD_STREAM>
+
+        private var finished = false
+
+        /// Starts a seal (`encrypt` is `true`) or an open, authenticating `authenticatedData` first.
+        public init<Key: ContiguousBytes, Nonce: ContiguousBytes, AuthenticatedData: DataProtocol>(cipher: BoringSSLAEAD, key: Key, nonce: Nonce, authenticatedData: AuthenticatedData, encrypt: Bool) throws {
+            self.context = .allocate(capacity: 1)
+            self.context.initialize(to: EVP_AEAD_CTX())
+            self.stream = .allocate(capacity: 1)
+            self.stream.initialize(to: CCryptoBoringSSLShims_AEAD_STREAM())
+
+            let rc: CInt = key.withUnsafeBytes { keyPointer in
+                CCryptoBoringSSLShims_EVP_AEAD_CTX_init(self.context, cipher.boringSSLCipher, keyPointer.baseAddress, keyPointer.count, 0, nil)
+            }
+            // Every stored property is set by now, so deinit cleans up after either failure below. A context that failed to
+            // initialise is left empty, and cleaning it up does nothing.
+            guard rc == 1 else {
+                throw CryptoBoringWrapperError.internalBoringSSLError()
+            }
+
+            let started = nonce.withUnsafeBytes { noncePointer in
+                CCryptoBoringSSLShims_AEAD_STREAM_supported(self.context) == 1 &&
+                    CCryptoBoringSSLShims_AEAD_STREAM_init(self.stream, self.context, noncePointer.baseAddress, noncePointer.count, encrypt ? 1 : 0) == 1 &&
+                    self.stream.update(authenticatedData: authenticatedData)
+            }
+            guard started else {
+                throw CryptoBoringWrapperError.internalBoringSSLError()
+            }
+        }
+
+        deinit {
+            CCryptoBoringSSL_OPENSSL_cleanse(self.stream, MemoryLayout<CCryptoBoringSSLShims_AEAD_STREAM>.size)
+            self.stream.deallocate()
+            CCryptoBoringSSL_EVP_AEAD_CTX_cleanup(self.context)
+            // The AES-GCM cleanup is a no-op, which would leave the key schedule in freed memory.
+            CCryptoBoringSSL_OPENSSL_cleanse(self.context, MemoryLayout<EVP_AEAD_CTX>.size)
+            self.context.deallocate()
+        }
+
+        /// The size of the tag the stream produces or checks.
+        public var tagByteCount: Int {
+            CCryptoBoringSSL_EVP_AEAD_max_overhead(self.context.pointee.aead)
+        }
+
+        /// Encrypts or decrypts the next piece of the message from `input` into `output`, which must be the same size and
+        /// may be the same memory.
+        public func update(_ input: UnsafeRawBufferPointer, into output: UnsafeMutableRawBufferPointer) throws {
+            precondition(input.count == output.count)
+            guard !self.finished,
+                  CCryptoBoringSSLShims_AEAD_STREAM_update(self.stream, input.baseAddress, output.baseAddress, input.count) == 1 else {
+                throw CryptoBoringWrapperError.internalBoringSSLError()
+            }
+        }
+
+        /// Finishes a seal, returning the tag.
+        public func sealFinal() throws -> Data {
+            guard !self.finished else {
+                throw CryptoBoringWrapperError.internalBoringSSLError()
+            }
+            self.finished = true
+            var tag = Data(repeating: 0, count: self.tagByteCount)
+            var actualTagSize = 0
+            let rc = tag.withUnsafeMutableBytes { tagPointer in
+                CCryptoBoringSSLShims_AEAD_STREAM_seal_final(self.stream, tagPointer.baseAddress, &actualTagSize, tagPointer.count)
+            }
+            guard rc == 1 else {
+                throw CryptoBoringWrapperError.internalBoringSSLError()
+            }
+            return tag.prefix(actualTagSize)
+        }
+
+        /// Finishes an open, returning whether `tag` authenticates everything that was decrypted.
+        public func openFinal(tag: UnsafeRawBufferPointer) throws -> Bool {
+            guard !self.finished else {
+                throw CryptoBoringWrapperError.internalBoringSSLError()
+            }
+            self.finished = true
+            return CCryptoBoringSSLShims_AEAD_STREAM_open_final(self.stream, tag.baseAddress, tag.count) == 1
+        }
+    }
+}
+
+// MARK: - Batching
+
+extension BoringSSLAEAD {
+    /// A single operation in a batch of AEAD operations.
+    ///
+    /// All of the pointers must remain valid until the batch call that uses this operation returns.
+    public struct BatchOperation {
+        public var nonce: UnsafeRawBufferPointer
+        public var input: UnsafeRawBufferPointer
+        public var authenticatedData: UnsafeRawBufferPointer
+        public var output: UnsafeMutableRawBufferPointer
+        /// For sealing, the buffer the tag is written into. For opening, the tag to check.
+        public var tag: UnsafeMutableRawBufferPointer
+
+        public init(nonce: UnsafeRawBufferPointer, input: UnsafeRawBufferPointer, authenticatedData: UnsafeRawBufferPointer, output: UnsafeMutableRawBufferPointer, tag: UnsafeMutableRawBufferPointer) {
+            self.nonce = nonce
+            self.input = input
+            self.authenticatedData = authenticatedData
+            self.output = output
+            self.tag = tag
+        }
+    }
+}
+
+extension BoringSSLAEAD.AEADContext {
+    /// Seals every operation in the batch with this context, in a single call into BoringSSL.
+    ///
+    /// Each output buffer must be at least as large as its input, and each tag buffer must be large enough to hold a tag.
+    public func seal(batch operations: [BoringSSLAEAD.BatchOperation]) throws {
+        var ops = operations.map { CCryptoBoringSSLShims_AEAD_batch_op($0) }
+
+        let failures = ops.withUnsafeMutableBufferPointer { opsPointer in
+            withUnsafePointer(to: &self.context) { contextPointer in
+                CCryptoBoringSSLShims_EVP_AEAD_CTX_seal_batch(contextPointer, opsPointer.baseAddress, opsPointer.count)
+            }
+        }
+
+        guard failures == 0 else {
+            let error = CryptoBoringWrapperError.internalBoringSSLError()
+            // Each failed operation left an entry on the error queue; only the first is reported.
+            CCryptoBoringSSL_ERR_clear_error()
+            throw error
+        }
+    }
+
+    /// Opens every operation in the batch with this context, in a single call into BoringSSL.
+    ///
+    /// Each output buffer must be at least as large as its input. Operations that fail to authenticate have their output
+    /// zeroed.
+    ///
+    /// - Returns: Whether each operation was opened successfully, in the same order as `operations`.
+    public func open(batch operations: [BoringSSLAEAD.BatchOperation]) -> [Bool] {
+        var ops = operations.map { CCryptoBoringSSLShims_AEAD_batch_op($0) }
+
+        let failures = ops.withUnsafeMutableBufferPointer { opsPointer in
+            withUnsafePointer(to: &self.context) { contextPointer in
+                CCryptoBoringSSLShims_EVP_AEAD_CTX_open_batch(contextPointer, opsPointer.baseAddress, opsPointer.count)
+            }
+        }
+
+        if failures != 0 {
+            // The failed operations each left an entry on the error queue, which we report through the return value instead.
+            CCryptoBoringSSL_ERR_clear_error()
+        }
+
+        return ops.map { $0.result == 1 }
+    }
+}
+
+extension CCryptoBoringSSLShims_AEAD_batch_op {
+    init(_ operation: BoringSSLAEAD.BatchOperation) {
+        precondition(operation.output.count >= operation.input.count)
+        self.init(nonce: operation.nonce.baseAddress, nonce_len: operation.nonce.count,
+                  in: operation.input.baseAddress, in_len: operation.input.count,
+                  ad: operation.authenticatedData.baseAddress, ad_len: operation.authenticatedData.count,
+                  out: operation.output.baseAddress,
+                  tag: operation.tag.baseAddress, tag_len: operation.tag.count,
+                  result: 0)
+    }
 }
 
 // MARK: - Supported ciphers
@@ -269,3 +865,101 @@ extension BoringSSLAEAD {
         }
     }
 }
+
+// MARK: - Concurrent AES-GCM
+
+extension BoringSSLAEAD.AEADContext {
+    /// Whether this context can seal and open a single message across several threads.
+    public var supportsConcurrentSealing: Bool {
+        withUnsafePointer(to: &self.context) { contextPointer in
+            CCryptoBoringSSLShims_GCM_PARALLEL_supported(contextPointer) == 1
+        }
+    }
+
+    /// Seals a message into a caller-provided buffer, processing `segmentByteCount`-byte segments of it on all
+    /// available cores. The ciphertext and tag are the same as ``seal(message:nonce:authenticatedData:into:)`` writes.
+    ///
+    /// `segmentByteCount` must be a positive multiple of 16, and the context must support concurrent sealing.
+    public func sealConcurrently<Nonce: ContiguousBytes, AuthenticatedData: DataProtocol>(message: UnsafeRawBufferPointer, nonce: Nonce, authenticatedData: AuthenticatedData, into output: UnsafeMutableRawBufferPointer, segmentByteCount: Int) throws {
+        let tagByteCount = CCryptoBoringSSL_EVP_AEAD_max_overhead(self.context.aead)
+        precondition(output.count == message.count + tagByteCount)
+        let tagBuffer = UnsafeMutableRawBufferPointer(rebasing: output[(output.count - tagByteCount)...])
+
+        let rc = self._withParallelState(nonce: nonce, authenticatedData: authenticatedData, messageByteCount: message.count, segmentByteCount: segmentByteCount, encrypt: true) { state, ghashes in
+            Self._processSegments(state: state, input: message.baseAddress, output: output.baseAddress, ghashes: ghashes)
+            var actualTagSize = 0
+            let rc = CCryptoBoringSSLShims_GCM_PARALLEL_seal_finish(state, ghashes.baseAddress, tagBuffer.baseAddress, &actualTagSize, tagBuffer.count)
+            precondition(rc != 1 || actualTagSize == tagByteCount)
+            return rc
+        }
+
+        guard rc == 1 else {
+            throw CryptoBoringWrapperError.internalBoringSSLError()
+        }
+    }
+
+    /// Opens a message in place, processing `segmentByteCount`-byte segments of it on all available cores. Behaves
+    /// like ``open(inPlace:nonce:authenticatedData:)``, including zeroing the ciphertext if authentication fails.
+    ///
+    /// `segmentByteCount` must be a positive multiple of 16, and the context must support concurrent sealing.
+    public func openConcurrently<Nonce: ContiguousBytes, AuthenticatedData: DataProtocol>(inPlace buffer: UnsafeMutableRawBufferPointer, nonce: Nonce, authenticatedData: AuthenticatedData, segmentByteCount: Int) throws -> Int {
+        let tagByteCount = CCryptoBoringSSL_EVP_AEAD_max_overhead(self.context.aead)
+        precondition(buffer.count >= tagByteCount)
+        let ciphertextByteCount = buffer.count - tagByteCount
+        let ciphertext = UnsafeMutableRawBufferPointer(rebasing: buffer.prefix(ciphertextByteCount))
+        let tag = UnsafeRawBufferPointer(rebasing: buffer.suffix(tagByteCount))
+
+        let rc = self._withParallelState(nonce: nonce, authenticatedData: authenticatedData, messageByteCount: ciphertextByteCount, segmentByteCount: segmentByteCount, encrypt: false) { state, ghashes in
+            Self._processSegments(state: state, input: UnsafeRawPointer(ciphertext.baseAddress), output: ciphertext.baseAddress, ghashes: ghashes)
+            return CCryptoBoringSSLShims_GCM_PARALLEL_open_finish(state, ghashes.baseAddress, tag.baseAddress, tag.count)
+        }
+
+        guard rc == 1 else {
+            CCryptoBoringSSL_OPENSSL_cleanse(ciphertext.baseAddress, ciphertext.count)
+            throw CryptoBoringWrapperError.internalBoringSSLError()
+        }
+
+        return ciphertextByteCount
+    }
+
+    private func _withParallelState<Nonce: ContiguousBytes, AuthenticatedData: DataProtocol>(nonce: Nonce, authenticatedData: AuthenticatedData, messageByteCount: Int, segmentByteCount: Int, encrypt: Bool, _ body: (UnsafeMutablePointer<CCryptoBoringSSLShims_GCM_PARALLEL>, UnsafeMutableBufferPointer<UInt8>) -> CInt) -> CInt {
+        var state = CCryptoBoringSSLShims_GCM_PARALLEL()
+        defer {
+            withUnsafeMutableBytes(of: &state) { stateBytes in
+                CCryptoBoringSSL_OPENSSL_cleanse(stateBytes.baseAddress, stateBytes.count)
+            }
+        }
+        // The authenticated data is hashed once, up front, so copying it together costs little.
+        let authenticatedData = Array(authenticatedData)
+
+        // The state reads the key from the context, so everything has to happen while we hold a pointer to it.
+        return withUnsafePointer(to: &self.context) { contextPointer in
+            withUnsafeMutablePointer(to: &state) { statePointer in
+                let rc = nonce.withUnsafeBytes { nonceBytes in
+                    authenticatedData.withUnsafeBytes { authenticatedDataBytes in
+                        CCryptoBoringSSLShims_GCM_PARALLEL_init(statePointer, contextPointer,
+                                                                nonceBytes.baseAddress, nonceBytes.count,
+                                                                authenticatedDataBytes.baseAddress, authenticatedDataBytes.count,
+                                                                messageByteCount, segmentByteCount, encrypt ? 1 : 0)
+                    }
+                }
+                guard rc == 1 else {
+                    return 0
+                }
+
+                let segmentCount = CCryptoBoringSSLShims_GCM_PARALLEL_segment_count(statePointer)
+                var ghashes = [UInt8](repeating: 0, count: max(segmentCount, 1) * 16)
+                return ghashes.withUnsafeMutableBufferPointer { ghashes in
+                    body(statePointer, ghashes)
+                }
+            }
+        }
+    }
+
+    private static func _processSegments(state: UnsafeMutablePointer<CCryptoBoringSSLShims_GCM_PARALLEL>, input: UnsafeRawPointer?, output: UnsafeMutableRawPointer?, ghashes: UnsafeMutableBufferPointer<UInt8>) {
+        let segmentCount = CCryptoBoringSSLShims_GCM_PARALLEL_segment_count(state)
+        DispatchQueue.concurrentPerform(iterations: segmentCount) { segment in
+            CCryptoBoringSSLShims_GCM_PARALLEL_segment(state, segment, input, output, ghashes.baseAddress! + 16 * segment)
+        }
+    }
+}
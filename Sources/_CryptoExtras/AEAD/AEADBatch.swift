@@ -0,0 +1,146 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+/// The AEADs supported by the batching and caller-buffer APIs.
+@usableFromInline
+enum AEADAlgorithm {
+    case aesGCM
+    case chaChaPoly
+}
+
+/// A single message to seal as part of a batch.
+///
+/// The batch APIs write directly into caller-provided memory, so all of the buffers
+/// referenced here must remain valid until the batch call returns.
+public struct _AEADBatchSealOperation {
+    /// The nonce to use for this message. It must be unique for every use of the key.
+    public var nonce: UnsafeRawBufferPointer
+    /// The message to encrypt and authenticate.
+    public var plaintext: UnsafeRawBufferPointer
+    /// Data to authenticate as part of the seal.
+    public var authenticatedData: UnsafeRawBufferPointer
+    /// The buffer the ciphertext is written into. Must be exactly as large as `plaintext`,
+    /// and may be the same memory as `plaintext` to seal in place.
+    public var ciphertext: UnsafeMutableRawBufferPointer
+    /// The buffer the authentication tag is written into. Must be exactly 16 bytes.
+    public var tag: UnsafeMutableRawBufferPointer
+
+    public init(
+        nonce: UnsafeRawBufferPointer,
+        plaintext: UnsafeRawBufferPointer,
+        authenticatedData: UnsafeRawBufferPointer = UnsafeRawBufferPointer(start: nil, count: 0),
+        ciphertext: UnsafeMutableRawBufferPointer,
+        tag: UnsafeMutableRawBufferPointer
+    ) {
+        self.nonce = nonce
+        self.plaintext = plaintext
+        self.authenticatedData = authenticatedData
+        self.ciphertext = ciphertext
+        self.tag = tag
+    }
+}
+
+/// A single message to open as part of a batch.
+///
+/// The batch APIs write directly into caller-provided memory, so all of the buffers
+/// referenced here must remain valid until the batch call returns.
+public struct _AEADBatchOpenOperation {
+    /// The nonce the message was sealed with.
+    public var nonce: UnsafeRawBufferPointer
+    /// The ciphertext to authenticate and decrypt.
+    public var ciphertext: UnsafeRawBufferPointer
+    /// The authentication tag. Must be exactly 16 bytes.
+    public var tag: UnsafeRawBufferPointer
+    /// Data that was authenticated as part of the seal.
+    public var authenticatedData: UnsafeRawBufferPointer
+    /// The buffer the plaintext is written into. Must be exactly as large as `ciphertext`,
+    /// and may be the same memory as `ciphertext` to open in place.
+    public var plaintext: UnsafeMutableRawBufferPointer
+
+    public init(
+        nonce: UnsafeRawBufferPointer,
+        ciphertext: UnsafeRawBufferPointer,
+        tag: UnsafeRawBufferPointer,
+        authenticatedData: UnsafeRawBufferPointer = UnsafeRawBufferPointer(start: nil, count: 0),
+        plaintext: UnsafeMutableRawBufferPointer
+    ) {
+        self.nonce = nonce
+        self.ciphertext = ciphertext
+        self.tag = tag
+        self.authenticatedData = authenticatedData
+        self.plaintext = plaintext
+    }
+}
+
+extension AES.GCM {
+    /// Encrypts and authenticates a batch of messages using AES-GCM, all under the same key.
+    ///
+    /// The key is expanded once for the whole batch, and every message is sealed in a single
+    /// call into BoringSSL, so this is substantially cheaper than calling `seal` in a loop
+    /// for many small messages.
+    ///
+    /// - Parameters:
+    ///   - operations: The messages to seal, along with the buffers to write their ciphertexts and tags into.
+    ///   - key: An encryption key of 128, 192, or 256 bits
+    /// - Throws: CryptoKitError errors. If any message fails to seal, the contents of all output buffers are unspecified.
+    public static func _sealBatch(_ operations: [_AEADBatchSealOperation], using key: SymmetricKey) throws {
+        try OpenSSLAEADBatchImpl.seal(operations, algorithm: .aesGCM, key: key)
+    }
+
+    /// Authenticates and decrypts a batch of messages using AES-GCM, all under the same key.
+    ///
+    /// Every message in the batch is processed, even if some of them fail to authenticate.
+    /// The plaintext buffer of a message that fails to authenticate is zeroed.
+    ///
+    /// - Parameters:
+    ///   - operations: The messages to open, along with the buffers to write their plaintexts into.
+    ///   - key: An encryption key of 128, 192, or 256 bits
+    /// - Returns: Whether each message authenticated successfully, in the same order as `operations`.
+    /// - Throws: CryptoKitError errors if the key, any nonce or any buffer has an invalid size.
+    public static func _openBatch(_ operations: [_AEADBatchOpenOperation], using key: SymmetricKey) throws -> [Bool] {
+        try OpenSSLAEADBatchImpl.open(operations, algorithm: .aesGCM, key: key)
+    }
+}
+
+extension ChaChaPoly {
+    /// Encrypts and authenticates a batch of messages using ChaCha20-Poly1305, all under the same key.
+    ///
+    /// Every message is sealed in a single call into BoringSSL, so this is substantially cheaper
+    /// than calling `seal` in a loop for many small messages.
+    ///
+    /// - Parameters:
+    ///   - operations: The messages to seal, along with the buffers to write their ciphertexts and tags into.
+    ///   - key: A 256-bit encryption key
+    /// - Throws: CryptoKitError errors. If any message fails to seal, the contents of all output buffers are unspecified.
+    public static func _sealBatch(_ operations: [_AEADBatchSealOperation], using key: SymmetricKey) throws {
+        try OpenSSLAEADBatchImpl.seal(operations, algorithm: .chaChaPoly, key: key)
+    }
+
+    /// Authenticates and decrypts a batch of messages using ChaCha20-Poly1305, all under the same key.
+    ///
+    /// Every message in the batch is processed, even if some of them fail to authenticate.
+    /// The plaintext buffer of a message that fails to authenticate is zeroed.
+    ///
+    /// - Parameters:
+    ///   - operations: The messages to open, along with the buffers to write their plaintexts into.
+    ///   - key: A 256-bit encryption key
+    /// - Returns: Whether each message authenticated successfully, in the same order as `operations`.
+    /// - Throws: CryptoKitError errors if the key, any nonce or any buffer has an invalid size.
+    public static func _openBatch(_ operations: [_AEADBatchOpenOperation], using key: SymmetricKey) throws -> [Bool] {
+        try OpenSSLAEADBatchImpl.open(operations, algorithm: .chaChaPoly, key: key)
+    }
+}
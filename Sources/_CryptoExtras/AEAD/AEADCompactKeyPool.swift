@@ -0,0 +1,130 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+
+extension AES.GCM {
+    /// A pool of AES-GCM session keys kept in compact form, for servers that hold very many live sessions.
+    ///
+    /// A ``AES/GCM/_PreparedKey`` keeps a fully initialised AEAD context: the AES key schedule and a table of
+    /// GHASH key powers, several hundred bytes per key. The pool instead keeps only the raw key and the GHASH key
+    /// H for each session, 56 bytes apiece, allocated in large slabs. In front of these sits a fixed number of
+    /// fully expanded slots, managed as a least-recently-used cache. Using a session promotes it into a slot, so
+    /// sessions in active use run at prepared-key speed, and a cold session pays for one key expansion the next
+    /// time it is used.
+    ///
+    /// `hotCapacity` sets the trade-off: each slot costs a few hundred bytes, and every session outside the
+    /// working set pays a key expansion on use. ``statistics`` reports the hit, promotion and eviction counts
+    /// needed to tune it.
+    ///
+    /// Pools are internally synchronised and may be shared freely between threads. The lock is not held while
+    /// data is encrypted.
+    public final class _CompactKeyPool: @unchecked Sendable {
+        let backing: OpenSSLAESGCMCompactKeyPool
+
+        /// Creates an empty pool.
+        ///
+        /// - Parameter hotCapacity: The number of sessions to keep fully expanded. May be zero, in which case
+        ///   every operation expands its key.
+        public init(hotCapacity: Int = 1024) {
+            self.backing = OpenSSLAESGCMCompactKeyPool(hotCapacity: hotCapacity)
+        }
+
+        /// Adds a session key to the pool.
+        ///
+        /// The session is removed from the pool, and its key cleared, when the returned key is released.
+        ///
+        /// - Parameter key: An encryption key of 128, 192, or 256 bits
+        public func key(_ key: SymmetricKey) throws -> _CompactKey {
+            _CompactKey(backing: try OpenSSLAESGCMCompactKey(key, pool: self.backing))
+        }
+
+        /// A snapshot of the pool's size and cache behaviour.
+        public var statistics: Statistics {
+            self.backing.statistics
+        }
+    }
+
+    /// An AES-GCM session key held in a ``AES/GCM/_CompactKeyPool``.
+    ///
+    /// Compact keys may be shared freely between threads.
+    public struct _CompactKey: Sendable {
+        let backing: OpenSSLAESGCMCompactKey
+
+        /// Encrypts and authenticates data.
+        ///
+        /// - Parameters:
+        ///   - message: The message to encrypt and authenticate
+        ///   - nonce: The nonce to use. It must be unique for every use of the key to seal data. If `nil`, a random nonce is generated.
+        ///   - authenticatedData: Data to authenticate as part of the seal
+        /// - Returns: A sealed box returning the authentication tag (seal) and the ciphertext
+        public func seal<Plaintext: DataProtocol, AuthenticatedData: DataProtocol>(
+            _ message: Plaintext,
+            nonce: AES.GCM.Nonce? = nil,
+            authenticating authenticatedData: AuthenticatedData
+        ) throws -> AES.GCM.SealedBox {
+            try self.backing.seal(message, nonce: nonce ?? AES.GCM.Nonce(), authenticatedData: authenticatedData)
+        }
+
+        /// Encrypts and authenticates data.
+        ///
+        /// - Parameters:
+        ///   - message: The message to encrypt and authenticate
+        ///   - nonce: The nonce to use. It must be unique for every use of the key to seal data. If `nil`, a random nonce is generated.
+        /// - Returns: A sealed box returning the authentication tag (seal) and the ciphertext
+        public func seal<Plaintext: DataProtocol>(_ message: Plaintext, nonce: AES.GCM.Nonce? = nil) throws -> AES.GCM.SealedBox {
+            try self.seal(message, nonce: nonce, authenticating: [UInt8]())
+        }
+
+        /// Authenticates and decrypts data.
+        ///
+        /// - Parameters:
+        ///   - sealedBox: The sealed box to authenticate and decrypt
+        ///   - authenticatedData: Data that was authenticated as part of the seal
+        /// - Returns: The plaintext if opening was successful
+        public func open<AuthenticatedData: DataProtocol>(_ sealedBox: AES.GCM.SealedBox, authenticating authenticatedData: AuthenticatedData) throws -> Data {
+            try self.backing.open(sealedBox, authenticatedData: authenticatedData)
+        }
+
+        /// Authenticates and decrypts data.
+        ///
+        /// - Parameter sealedBox: The sealed box to authenticate and decrypt
+        /// - Returns: The plaintext if opening was successful
+        public func open(_ sealedBox: AES.GCM.SealedBox) throws -> Data {
+            try self.open(sealedBox, authenticating: [UInt8]())
+        }
+    }
+}
+
+extension AES.GCM._CompactKeyPool {
+    /// Counters describing a ``AES/GCM/_CompactKeyPool``. Counters are read together under the pool's lock.
+    public struct Statistics: Sendable, Hashable {
+        /// The number of live sessions.
+        public var sessionCount: Int
+        /// The bytes allocated for compact session entries, including unused entries in the last slab.
+        public var compactByteCount: Int
+        /// The number of fully expanded slots.
+        public var hotCapacity: Int
+        /// The bytes allocated for the expanded slots.
+        public var hotByteCount: Int
+        /// Operations whose session was already expanded.
+        public var hits: UInt64
+        /// Operations that expanded their session into a slot.
+        public var promotions: UInt64
+        /// Promotions that pushed another session out of its slot.
+        public var evictions: UInt64
+        /// Operations that expanded their session privately because every slot was in use by another thread.
+        public var transientExpansions: UInt64
+    }
+}
@@ -0,0 +1,184 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+extension AES.GCM {
+    /// Encrypts and authenticates data using AES-GCM, writing the result into a caller-provided buffer.
+    ///
+    /// The ciphertext is written to the front of `output`, immediately followed by the 16-byte tag. No
+    /// intermediate buffers are allocated. To seal in place, pass the prefix of `output` as `message`.
+    ///
+    /// - Parameters:
+    ///   - message: The message to encrypt and authenticate
+    ///   - output: The buffer to write the ciphertext and tag into. Must be exactly 16 bytes larger than `message`.
+    ///   - key: An encryption key of 128, 192, or 256 bits
+    ///   - nonce: The nonce to use. It must be unique for every use of the key to seal data.
+    ///   - authenticatedData: Data to authenticate as part of the seal
+    /// - Throws: CryptoKitError errors
+    @inlinable
+    public static func _seal<AuthenticatedData: DataProtocol>(
+        _ message: UnsafeRawBufferPointer,
+        into output: UnsafeMutableRawBufferPointer,
+        using key: SymmetricKey,
+        nonce: AES.GCM.Nonce,
+        authenticating authenticatedData: AuthenticatedData
+    ) throws {
+        try OpenSSLAEADInPlaceImpl.seal(message, into: output, algorithm: .aesGCM, key: key, nonce: nonce, authenticatedData: authenticatedData)
+    }
+
+    /// Encrypts and authenticates data using AES-GCM, writing the result into a caller-provided buffer.
+    ///
+    /// The ciphertext is written to the front of `output`, immediately followed by the 16-byte tag. No
+    /// intermediate buffers are allocated. To seal in place, pass the prefix of `output` as `message`.
+    ///
+    /// - Parameters:
+    ///   - message: The message to encrypt and authenticate
+    ///   - output: The buffer to write the ciphertext and tag into. Must be exactly 16 bytes larger than `message`.
+    ///   - key: An encryption key of 128, 192, or 256 bits
+    ///   - nonce: The nonce to use. It must be unique for every use of the key to seal data.
+    /// - Throws: CryptoKitError errors
+    @inlinable
+    public static func _seal(
+        _ message: UnsafeRawBufferPointer,
+        into output: UnsafeMutableRawBufferPointer,
+        using key: SymmetricKey,
+        nonce: AES.GCM.Nonce
+    ) throws {
+        try Self._seal(message, into: output, using: key, nonce: nonce, authenticating: [UInt8]())
+    }
+
+    /// Authenticates and decrypts data using AES-GCM, in place in a caller-provided buffer.
+    ///
+    /// - Parameters:
+    ///   - buffer: A buffer holding the ciphertext immediately followed by the 16-byte tag.
+    ///   - key: An encryption key of 128, 192, or 256 bits
+    ///   - nonce: The nonce the data was sealed with.
+    ///   - authenticatedData: Data that was authenticated as part of the seal
+    /// - Returns: The prefix of `buffer` that now holds the plaintext.
+    /// - Throws: CryptoKitError errors. If authentication fails, the ciphertext portion of `buffer` is zeroed.
+    @inlinable
+    @discardableResult
+    public static func _open<AuthenticatedData: DataProtocol>(
+        inPlace buffer: UnsafeMutableRawBufferPointer,
+        using key: SymmetricKey,
+        nonce: AES.GCM.Nonce,
+        authenticating authenticatedData: AuthenticatedData
+    ) throws -> UnsafeMutableRawBufferPointer {
+        try OpenSSLAEADInPlaceImpl.open(inPlace: buffer, algorithm: .aesGCM, key: key, nonce: nonce, authenticatedData: authenticatedData)
+    }
+
+    /// Authenticates and decrypts data using AES-GCM, in place in a caller-provided buffer.
+    ///
+    /// - Parameters:
+    ///   - buffer: A buffer holding the ciphertext immediately followed by the 16-byte tag.
+    ///   - key: An encryption key of 128, 192, or 256 bits
+    ///   - nonce: The nonce the data was sealed with.
+    /// - Returns: The prefix of `buffer` that now holds the plaintext.
+    /// - Throws: CryptoKitError errors. If authentication fails, the ciphertext portion of `buffer` is zeroed.
+    @inlinable
+    @discardableResult
+    public static func _open(
+        inPlace buffer: UnsafeMutableRawBufferPointer,
+        using key: SymmetricKey,
+        nonce: AES.GCM.Nonce
+    ) throws -> UnsafeMutableRawBufferPointer {
+        try Self._open(inPlace: buffer, using: key, nonce: nonce, authenticating: [UInt8]())
+    }
+}
+
+extension ChaChaPoly {
+    /// Encrypts and authenticates data using ChaCha20-Poly1305, writing the result into a caller-provided buffer.
+    ///
+    /// The ciphertext is written to the front of `output`, immediately followed by the 16-byte tag. No
+    /// intermediate buffers are allocated. To seal in place, pass the prefix of `output` as `message`.
+    ///
+    /// - Parameters:
+    ///   - message: The message to encrypt and authenticate
+    ///   - output: The buffer to write the ciphertext and tag into. Must be exactly 16 bytes larger than `message`.
+    ///   - key: A 256-bit encryption key
+    ///   - nonce: The nonce to use. It must be unique for every use of the key to seal data.
+    ///   - authenticatedData: Data to authenticate as part of the seal
+    /// - Throws: CryptoKitError errors
+    @inlinable
+    public static func _seal<AuthenticatedData: DataProtocol>(
+        _ message: UnsafeRawBufferPointer,
+        into output: UnsafeMutableRawBufferPointer,
+        using key: SymmetricKey,
+        nonce: ChaChaPoly.Nonce,
+        authenticating authenticatedData: AuthenticatedData
+    ) throws {
+        try OpenSSLAEADInPlaceImpl.seal(message, into: output, algorithm: .chaChaPoly, key: key, nonce: nonce, authenticatedData: authenticatedData)
+    }
+
+    /// Encrypts and authenticates data using ChaCha20-Poly1305, writing the result into a caller-provided buffer.
+    ///
+    /// The ciphertext is written to the front of `output`, immediately followed by the 16-byte tag. No
+    /// intermediate buffers are allocated. To seal in place, pass the prefix of `output` as `message`.
+    ///
+    /// - Parameters:
+    ///   - message: The message to encrypt and authenticate
+    ///   - output: The buffer to write the ciphertext and tag into. Must be exactly 16 bytes larger than `message`.
+    ///   - key: A 256-bit encryption key
+    ///   - nonce: The nonce to use. It must be unique for every use of the key to seal data.
+    /// - Throws: CryptoKitError errors
+    @inlinable
+    public static func _seal(
+        _ message: UnsafeRawBufferPointer,
+        into output: UnsafeMutableRawBufferPointer,
+        using key: SymmetricKey,
+        nonce: ChaChaPoly.Nonce
+    ) throws {
+        try Self._seal(message, into: output, using: key, nonce: nonce, authenticating: [UInt8]())
+    }
+
+    /// Authenticates and decrypts data using ChaCha20-Poly1305, in place in a caller-provided buffer.
+    ///
+    /// - Parameters:
+    ///   - buffer: A buffer holding the ciphertext immediately followed by the 16-byte tag.
+    ///   - key: A 256-bit encryption key
+    ///   - nonce: The nonce the data was sealed with.
+    ///   - authenticatedData: Data that was authenticated as part of the seal
+    /// - Returns: The prefix of `buffer` that now holds the plaintext.
+    /// - Throws: CryptoKitError errors. If authentication fails, the ciphertext portion of `buffer` is zeroed.
+    @inlinable
+    @discardableResult
+    public static func _open<AuthenticatedData: DataProtocol>(
+        inPlace buffer: UnsafeMutableRawBufferPointer,
+        using key: SymmetricKey,
+        nonce: ChaChaPoly.Nonce,
+        authenticating authenticatedData: AuthenticatedData
+    ) throws -> UnsafeMutableRawBufferPointer {
+        try OpenSSLAEADInPlaceImpl.open(inPlace: buffer, algorithm: .chaChaPoly, key: key, nonce: nonce, authenticatedData: authenticatedData)
+    }
+
+    /// Authenticates and decrypts data using ChaCha20-Poly1305, in place in a caller-provided buffer.
+    ///
+    /// - Parameters:
+    ///   - buffer: A buffer holding the ciphertext immediately followed by the 16-byte tag.
+    ///   - key: A 256-bit encryption key
+    ///   - nonce: The nonce the data was sealed with.
+    /// - Returns: The prefix of `buffer` that now holds the plaintext.
+    /// - Throws: CryptoKitError errors. If authentication fails, the ciphertext portion of `buffer` is zeroed.
+    @inlinable
+    @discardableResult
+    public static func _open(
+        inPlace buffer: UnsafeMutableRawBufferPointer,
+        using key: SymmetricKey,
+        nonce: ChaChaPoly.Nonce
+    ) throws -> UnsafeMutableRawBufferPointer {
+        try Self._open(inPlace: buffer, using: key, nonce: nonce, authenticating: [UInt8]())
+    }
+}
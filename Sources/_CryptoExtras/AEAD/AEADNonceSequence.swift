@@ -0,0 +1,135 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+/// Errors from ``_AEADNonceSequence``.
+public enum _AEADNonceSequenceError: Error {
+    /// The sequence has produced as many nonces as its limit allows. Seal with a new key.
+    case exhausted
+    /// The sequence has already been used with a different key.
+    case boundToDifferentKey
+    /// The key already takes its nonces from a different sequence.
+    case keyBoundToDifferentSequence
+}
+
+/// A source of unique 96-bit AEAD nonces built from a random prefix and a counter.
+///
+/// Sealing without an explicit nonce draws 12 fresh bytes from the system random number generator for every
+/// message. A nonce sequence instead draws a random 32-bit prefix once and follows it with a 64-bit big-endian
+/// counter, which is the deterministic construction of NIST SP 800-38D section 8.2.1. Nonces are unique for as
+/// long as the sequence is the only source of nonces for its key.
+///
+/// A sequence binds itself to the first prepared key it seals with, and the key binds itself to the sequence:
+/// using the sequence with any other key throws ``_AEADNonceSequenceError/boundToDifferentKey``, and using the key
+/// with any other sequence throws ``_AEADNonceSequenceError/keyBoundToDifferentSequence``. The sequence is a
+/// reference type, so every holder of it draws from the one counter, and it may be shared between threads.
+///
+/// The binding cannot see past the current process or the current prepared key. Two prepared keys built from the
+/// same ``SymmetricKey`` each accept their own sequence, and each new sequence starts its counter at zero behind a
+/// fresh 32-bit prefix, so sequences that share a key collide far sooner than random 96-bit nonces would. Prepare
+/// a key once, and to carry on after a restart resume the stored ``prefix`` and ``counter`` with
+/// ``init(prefix:counter:limit:)`` rather than starting a new sequence. After `fork()` the parent and the child
+/// hold the same counter and would hand out the same nonces; a process that forks must not seal with a sequence
+/// in both the parent and the child.
+public final class _AEADNonceSequence: @unchecked Sendable {
+    /// The largest number of nonces a sequence can produce.
+    public static let maximumLimit = UInt64.max
+
+    /// The random prefix shared by every nonce of this sequence.
+    public let prefix: UInt32
+
+    /// The number of nonces the sequence will produce in total.
+    public let limit: UInt64
+
+    private let lock = NSLock()
+
+    // Protected by `lock`.
+    private var _counter: UInt64
+
+    // Protected by `lock`. The key the sequence is bound to, once it has been used.
+    private var boundKey: OpenSSLAEADPreparedKey?
+
+    /// Creates a sequence with a fresh random prefix.
+    ///
+    /// - Parameter limit: The number of nonces the sequence will produce before throwing
+    ///   ``_AEADNonceSequenceError/exhausted``. Set this to the number of messages the key may protect.
+    public convenience init(limit: UInt64 = _AEADNonceSequence.maximumLimit) {
+        var rng = SystemRandomNumberGenerator()
+        self.init(prefix: UInt32(truncatingIfNeeded: rng.next() as UInt64), counter: 0, limit: limit)
+    }
+
+    /// Resumes a sequence from a prefix and counter that were stored earlier.
+    ///
+    /// - Parameters:
+    ///   - prefix: The ``prefix`` of the stored sequence.
+    ///   - counter: The ``counter`` of the stored sequence. No nonce before this point will be produced again.
+    ///   - limit: The number of nonces the sequence will produce in total, including those before `counter`.
+    public init(prefix: UInt32, counter: UInt64, limit: UInt64 = _AEADNonceSequence.maximumLimit) {
+        self.prefix = prefix
+        self._counter = counter
+        self.limit = limit
+    }
+
+    /// The counter value of the next nonce.
+    public var counter: UInt64 {
+        self.lock.lock()
+        defer {
+            self.lock.unlock()
+        }
+        return self._counter
+    }
+
+    /// The number of nonces the sequence can still produce.
+    public var remaining: UInt64 {
+        let counter = self.counter
+        return counter < self.limit ? self.limit - counter : 0
+    }
+
+    /// Produces the next nonce for `key`, binding the sequence and the key to each other on first use.
+    func next<Result>(for key: OpenSSLAEADPreparedKey, _ body: (UnsafeRawBufferPointer) throws -> Result) throws -> Result {
+        let counter: UInt64
+        do {
+            self.lock.lock()
+            defer {
+                self.lock.unlock()
+            }
+            guard self._counter < self.limit else {
+                throw _AEADNonceSequenceError.exhausted
+            }
+            if let boundKey = self.boundKey {
+                guard boundKey === key else {
+                    throw _AEADNonceSequenceError.boundToDifferentKey
+                }
+            } else {
+                guard key.bindNonceSequence() else {
+                    throw _AEADNonceSequenceError.keyBoundToDifferentSequence
+                }
+                self.boundKey = key
+            }
+            counter = self._counter
+            self._counter += 1
+        }
+
+        let nonce = (
+            self.prefix.bigEndian,
+            UInt32(truncatingIfNeeded: counter >> 32).bigEndian,
+            UInt32(truncatingIfNeeded: counter).bigEndian
+        )
+        return try withUnsafeBytes(of: nonce) { noncePtr in
+            try body(noncePtr)
+        }
+    }
+}
@@ -0,0 +1,366 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+
+extension AES.GCM {
+    /// An AES-GCM key that has already been set up for sealing and opening.
+    ///
+    /// Every call to ``AES/GCM/seal(_:using:nonce:authenticating:)`` initialises a fresh AEAD context, which
+    /// expands the AES key schedule and computes the GHASH key table. A prepared key does that once and keeps the
+    /// context, which suits workloads that seal many small messages under one long-lived key.
+    ///
+    /// Prepared keys are immutable and may be shared freely between threads.
+    public struct _PreparedKey {
+        private let backing: OpenSSLAEADPreparedKey
+
+        /// Prepares a symmetric key for repeated AES-GCM operations.
+        ///
+        /// - Parameter key: An encryption key of 128, 192, or 256 bits
+        public init(_ key: SymmetricKey) throws {
+            self.backing = try OpenSSLAEADPreparedKey(key, algorithm: .aesGCM)
+        }
+
+        /// Prepares a symmetric key for repeated AES-GCM operations, optionally keeping one copy of the prepared
+        /// state per NUMA node.
+        ///
+        /// On a multi-socket machine where threads on every socket use the same key, replicating lets each socket
+        /// read its own copy rather than pulling the key schedule across the interconnect. Each node's copy is built
+        /// the first time a thread running there uses the key. On a single-node machine this behaves like
+        /// ``init(_:)``.
+        ///
+        /// - Parameters:
+        ///   - key: An encryption key of 128, 192, or 256 bits
+        ///   - replicatedPerNode: Whether to keep one copy of the prepared state per NUMA node.
+        public init(_ key: SymmetricKey, replicatedPerNode: Bool) throws {
+            self.backing = try OpenSSLAEADPreparedKey(key, algorithm: .aesGCM, replicatedPerNode: replicatedPerNode)
+        }
+
+        init(_ backing: OpenSSLAEADPreparedKey) {
+            self.backing = backing
+        }
+
+        /// Encrypts and authenticates data.
+        ///
+        /// - Parameters:
+        ///   - message: The message to encrypt and authenticate
+        ///   - nonce: The nonce to use. It must be unique for every use of the key to seal data. If `nil`, a random nonce is generated.
+        ///   - authenticatedData: Data to authenticate as part of the seal
+        /// - Returns: A sealed box returning the authentication tag (seal) and the ciphertext
+        public func seal<Plaintext: DataProtocol, AuthenticatedData: DataProtocol>(
+            _ message: Plaintext,
+            nonce: AES.GCM.Nonce? = nil,
+            authenticating authenticatedData: AuthenticatedData
+        ) throws -> AES.GCM.SealedBox {
+            let nonce = nonce ?? AES.GCM.Nonce()
+            let (ciphertext, tag) = try self.backing.seal(message, nonce: nonce, authenticatedData: authenticatedData)
+            return try AES.GCM.SealedBox(nonce: nonce, ciphertext: ciphertext, tag: tag)
+        }
+
+        /// Encrypts and authenticates data.
+        ///
+        /// - Parameters:
+        ///   - message: The message to encrypt and authenticate
+        ///   - nonce: The nonce to use. It must be unique for every use of the key to seal data. If `nil`, a random nonce is generated.
+        /// - Returns: A sealed box returning the authentication tag (seal) and the ciphertext
+        public func seal<Plaintext: DataProtocol>(_ message: Plaintext, nonce: AES.GCM.Nonce? = nil) throws -> AES.GCM.SealedBox {
+            try self.seal(message, nonce: nonce, authenticating: [UInt8]())
+        }
+
+        /// Encrypts and authenticates data, taking the nonce from a nonce sequence.
+        ///
+        /// - Parameters:
+        ///   - message: The message to encrypt and authenticate
+        ///   - nonces: The nonce sequence for this key. It and this key are bound to each other the first time it is used.
+        ///   - authenticatedData: Data to authenticate as part of the seal
+        /// - Returns: A sealed box returning the authentication tag (seal) and the ciphertext
+        /// - Throws: ``_AEADNonceSequenceError`` if `nonces` is exhausted, or if it or this key is bound to another.
+        public func seal<Plaintext: DataProtocol, AuthenticatedData: DataProtocol>(
+            _ message: Plaintext,
+            nonces: _AEADNonceSequence,
+            authenticating authenticatedData: AuthenticatedData
+        ) throws -> AES.GCM.SealedBox {
+            let nonce = try nonces.next(for: self.backing) { try AES.GCM.Nonce(data: $0) }
+            return try self.seal(message, nonce: nonce, authenticating: authenticatedData)
+        }
+
+        /// Encrypts and authenticates data, taking the nonce from a nonce sequence.
+        ///
+        /// - Parameters:
+        ///   - message: The message to encrypt and authenticate
+        ///   - nonces: The nonce sequence for this key. It and this key are bound to each other the first time it is used.
+        /// - Returns: A sealed box returning the authentication tag (seal) and the ciphertext
+        /// - Throws: ``_AEADNonceSequenceError`` if `nonces` is exhausted, or if it or this key is bound to another.
+        public func seal<Plaintext: DataProtocol>(_ message: Plaintext, nonces: _AEADNonceSequence) throws -> AES.GCM.SealedBox {
+            try self.seal(message, nonces: nonces, authenticating: [UInt8]())
+        }
+
+        /// Authenticates and decrypts data.
+        ///
+        /// - Parameters:
+        ///   - sealedBox: The sealed box to authenticate and decrypt
+        ///   - authenticatedData: Data that was authenticated as part of the seal
+        /// - Returns: The plaintext if opening was successful
+        public func open<AuthenticatedData: DataProtocol>(_ sealedBox: AES.GCM.SealedBox, authenticating authenticatedData: AuthenticatedData) throws -> Data {
+            try self.backing.open(ciphertext: sealedBox.ciphertext, nonce: sealedBox.nonce, tag: sealedBox.tag, authenticatedData: authenticatedData)
+        }
+
+        /// Authenticates and decrypts data.
+        ///
+        /// - Parameter sealedBox: The sealed box to authenticate and decrypt
+        /// - Returns: The plaintext if opening was successful
+        public func open(_ sealedBox: AES.GCM.SealedBox) throws -> Data {
+            try self.open(sealedBox, authenticating: [UInt8]())
+        }
+
+        /// Encrypts and authenticates data, writing the result into a caller-provided buffer.
+        ///
+        /// The ciphertext is written to the front of `output`, immediately followed by the 16-byte tag. To seal in
+        /// place, pass the prefix of `output` as `message`.
+        ///
+        /// With `concurrently` set, a large message is cut into segments that are encrypted and hashed across all
+        /// available cores, and the segments' hashes are then combined. The ciphertext and tag are the same as
+        /// sealing serially. Messages of a few megabytes or less are always sealed serially.
+        ///
+        /// - Parameters:
+        ///   - message: The message to encrypt and authenticate
+        ///   - output: The buffer to write the ciphertext and tag into. Must be exactly 16 bytes larger than `message`.
+        ///   - nonce: The nonce to use. It must be unique for every use of the key to seal data.
+        ///   - authenticatedData: Data to authenticate as part of the seal
+        ///   - concurrently: Whether to spread the work of sealing across all available cores.
+        public func seal<AuthenticatedData: DataProtocol>(
+            _ message: UnsafeRawBufferPointer,
+            into output: UnsafeMutableRawBufferPointer,
+            nonce: AES.GCM.Nonce,
+            authenticating authenticatedData: AuthenticatedData,
+            concurrently: Bool = false
+        ) throws {
+            try self.backing.seal(message, into: output, nonce: nonce, authenticatedData: authenticatedData, concurrently: concurrently)
+        }
+
+        /// Encrypts and authenticates data into a caller-provided buffer, taking the nonce from a nonce sequence.
+        ///
+        /// - Parameters:
+        ///   - message: The message to encrypt and authenticate
+        ///   - output: The buffer to write the ciphertext and tag into. Must be exactly 16 bytes larger than `message`.
+        ///   - nonces: The nonce sequence for this key. It and this key are bound to each other the first time it is used.
+        ///   - authenticatedData: Data to authenticate as part of the seal
+        /// - Returns: The nonce the data was sealed with.
+        /// - Throws: ``_AEADNonceSequenceError`` if `nonces` is exhausted, or if it or this key is bound to another.
+        @discardableResult
+        public func seal<AuthenticatedData: DataProtocol>(
+            _ message: UnsafeRawBufferPointer,
+            into output: UnsafeMutableRawBufferPointer,
+            nonces: _AEADNonceSequence,
+            authenticating authenticatedData: AuthenticatedData
+        ) throws -> AES.GCM.Nonce {
+            try nonces.next(for: self.backing) { nonce in
+                try self.backing.seal(message, into: output, nonce: nonce, authenticatedData: authenticatedData)
+                return try AES.GCM.Nonce(data: nonce)
+            }
+        }
+
+        /// Authenticates and decrypts data in place in a caller-provided buffer.
+        ///
+        /// With `concurrently` set, a large message is decrypted and hashed across all available cores, as
+        /// ``seal(_:into:nonce:authenticating:concurrently:)`` describes.
+        ///
+        /// - Parameters:
+        ///   - buffer: A buffer holding the ciphertext immediately followed by the 16-byte tag.
+        ///   - nonce: The nonce the data was sealed with.
+        ///   - authenticatedData: Data that was authenticated as part of the seal
+        ///   - concurrently: Whether to spread the work of opening across all available cores.
+        /// - Returns: The prefix of `buffer` that now holds the plaintext.
+        /// - Throws: CryptoKitError errors. If authentication fails, the ciphertext portion of `buffer` is zeroed.
+        @discardableResult
+        public func open<AuthenticatedData: DataProtocol>(
+            inPlace buffer: UnsafeMutableRawBufferPointer,
+            nonce: AES.GCM.Nonce,
+            authenticating authenticatedData: AuthenticatedData,
+            concurrently: Bool = false
+        ) throws -> UnsafeMutableRawBufferPointer {
+            try self.backing.open(inPlace: buffer, nonce: nonce, authenticatedData: authenticatedData, concurrently: concurrently)
+        }
+    }
+}
+
+extension ChaChaPoly {
+    /// A ChaCha20-Poly1305 key that has already been set up for sealing and opening.
+    ///
+    /// Every call to ``ChaChaPoly/seal(_:using:nonce:authenticating:)`` initialises and tears down a fresh AEAD
+    /// context. A prepared key does that once and keeps the context, which suits workloads that seal many small
+    /// messages under one long-lived key.
+    ///
+    /// Prepared keys are immutable and may be shared freely between threads.
+    public struct _PreparedKey {
+        private let backing: OpenSSLAEADPreparedKey
+
+        /// Prepares a symmetric key for repeated ChaCha20-Poly1305 operations.
+        ///
+        /// - Parameter key: A 256-bit encryption key
+        public init(_ key: SymmetricKey) throws {
+            self.backing = try OpenSSLAEADPreparedKey(key, algorithm: .chaChaPoly)
+        }
+
+        /// Prepares a symmetric key for repeated ChaCha20-Poly1305 operations, optionally keeping one copy of the prepared
+        /// state per NUMA node.
+        ///
+        /// On a multi-socket machine where threads on every socket use the same key, replicating lets each socket
+        /// read its own copy rather than pulling the key schedule across the interconnect. Each node's copy is built
+        /// the first time a thread running there uses the key. On a single-node machine this behaves like
+        /// ``init(_:)``.
+        ///
+        /// - Parameters:
+        ///   - key: A 256-bit encryption key
+        ///   - replicatedPerNode: Whether to keep one copy of the prepared state per NUMA node.
+        public init(_ key: SymmetricKey, replicatedPerNode: Bool) throws {
+            self.backing = try OpenSSLAEADPreparedKey(key, algorithm: .chaChaPoly, replicatedPerNode: replicatedPerNode)
+        }
+
+        init(_ backing: OpenSSLAEADPreparedKey) {
+            self.backing = backing
+        }
+
+        /// Encrypts and authenticates data.
+        ///
+        /// - Parameters:
+        ///   - message: The message to encrypt and authenticate
+        ///   - nonce: The nonce to use. It must be unique for every use of the key to seal data. If `nil`, a random nonce is generated.
+        ///   - authenticatedData: Data to authenticate as part of the seal
+        /// - Returns: A sealed box returning the authentication tag (seal) and the ciphertext
+        public func seal<Plaintext: DataProtocol, AuthenticatedData: DataProtocol>(
+            _ message: Plaintext,
+            nonce: ChaChaPoly.Nonce? = nil,
+            authenticating authenticatedData: AuthenticatedData
+        ) throws -> ChaChaPoly.SealedBox {
+            let nonce = nonce ?? ChaChaPoly.Nonce()
+            let (ciphertext, tag) = try self.backing.seal(message, nonce: nonce, authenticatedData: authenticatedData)
+            return try ChaChaPoly.SealedBox(nonce: nonce, ciphertext: ciphertext, tag: tag)
+        }
+
+        /// Encrypts and authenticates data.
+        ///
+        /// - Parameters:
+        ///   - message: The message to encrypt and authenticate
+        ///   - nonce: The nonce to use. It must be unique for every use of the key to seal data. If `nil`, a random nonce is generated.
+        /// - Returns: A sealed box returning the authentication tag (seal) and the ciphertext
+        public func seal<Plaintext: DataProtocol>(_ message: Plaintext, nonce: ChaChaPoly.Nonce? = nil) throws -> ChaChaPoly.SealedBox {
+            try self.seal(message, nonce: nonce, authenticating: [UInt8]())
+        }
+
+        /// Encrypts and authenticates data, taking the nonce from a nonce sequence.
+        ///
+        /// - Parameters:
+        ///   - message: The message to encrypt and authenticate
+        ///   - nonces: The nonce sequence for this key. It and this key are bound to each other the first time it is used.
+        ///   - authenticatedData: Data to authenticate as part of the seal
+        /// - Returns: A sealed box returning the authentication tag (seal) and the ciphertext
+        /// - Throws: ``_AEADNonceSequenceError`` if `nonces` is exhausted, or if it or this key is bound to another.
+        public func seal<Plaintext: DataProtocol, AuthenticatedData: DataProtocol>(
+            _ message: Plaintext,
+            nonces: _AEADNonceSequence,
+            authenticating authenticatedData: AuthenticatedData
+        ) throws -> ChaChaPoly.SealedBox {
+            let nonce = try nonces.next(for: self.backing) { try ChaChaPoly.Nonce(data: $0) }
+            return try self.seal(message, nonce: nonce, authenticating: authenticatedData)
+        }
+
+        /// Encrypts and authenticates data, taking the nonce from a nonce sequence.
+        ///
+        /// - Parameters:
+        ///   - message: The message to encrypt and authenticate
+        ///   - nonces: The nonce sequence for this key. It and this key are bound to each other the first time it is used.
+        /// - Returns: A sealed box returning the authentication tag (seal) and the ciphertext
+        /// - Throws: ``_AEADNonceSequenceError`` if `nonces` is exhausted, or if it or this key is bound to another.
+        public func seal<Plaintext: DataProtocol>(_ message: Plaintext, nonces: _AEADNonceSequence) throws -> ChaChaPoly.SealedBox {
+            try self.seal(message, nonces: nonces, authenticating: [UInt8]())
+        }
+
+        /// Authenticates and decrypts data.
+        ///
+        /// - Parameters:
+        ///   - sealedBox: The sealed box to authenticate and decrypt
+        ///   - authenticatedData: Data that was authenticated as part of the seal
+        /// - Returns: The plaintext if opening was successful
+        public func open<AuthenticatedData: DataProtocol>(_ sealedBox: ChaChaPoly.SealedBox, authenticating authenticatedData: AuthenticatedData) throws -> Data {
+            try self.backing.open(ciphertext: sealedBox.ciphertext, nonce: sealedBox.nonce, tag: sealedBox.tag, authenticatedData: authenticatedData)
+        }
+
+        /// Authenticates and decrypts data.
+        ///
+        /// - Parameter sealedBox: The sealed box to authenticate and decrypt
+        /// - Returns: The plaintext if opening was successful
+        public func open(_ sealedBox: ChaChaPoly.SealedBox) throws -> Data {
+            try self.open(sealedBox, authenticating: [UInt8]())
+        }
+
+        /// Encrypts and authenticates data, writing the result into a caller-provided buffer.
+        ///
+        /// The ciphertext is written to the front of `output`, immediately followed by the 16-byte tag. To seal in
+        /// place, pass the prefix of `output` as `message`.
+        ///
+        /// - Parameters:
+        ///   - message: The message to encrypt and authenticate
+        ///   - output: The buffer to write the ciphertext and tag into. Must be exactly 16 bytes larger than `message`.
+        ///   - nonce: The nonce to use. It must be unique for every use of the key to seal data.
+        ///   - authenticatedData: Data to authenticate as part of the seal
+        public func seal<AuthenticatedData: DataProtocol>(
+            _ message: UnsafeRawBufferPointer,
+            into output: UnsafeMutableRawBufferPointer,
+            nonce: ChaChaPoly.Nonce,
+            authenticating authenticatedData: AuthenticatedData
+        ) throws {
+            try self.backing.seal(message, into: output, nonce: nonce, authenticatedData: authenticatedData)
+        }
+
+        /// Encrypts and authenticates data into a caller-provided buffer, taking the nonce from a nonce sequence.
+        ///
+        /// - Parameters:
+        ///   - message: The message to encrypt and authenticate
+        ///   - output: The buffer to write the ciphertext and tag into. Must be exactly 16 bytes larger than `message`.
+        ///   - nonces: The nonce sequence for this key. It and this key are bound to each other the first time it is used.
+        ///   - authenticatedData: Data to authenticate as part of the seal
+        /// - Returns: The nonce the data was sealed with.
+        /// - Throws: ``_AEADNonceSequenceError`` if `nonces` is exhausted, or if it or this key is bound to another.
+        @discardableResult
+        public func seal<AuthenticatedData: DataProtocol>(
+            _ message: UnsafeRawBufferPointer,
+            into output: UnsafeMutableRawBufferPointer,
+            nonces: _AEADNonceSequence,
+            authenticating authenticatedData: AuthenticatedData
+        ) throws -> ChaChaPoly.Nonce {
+            try nonces.next(for: self.backing) { nonce in
+                try self.backing.seal(message, into: output, nonce: nonce, authenticatedData: authenticatedData)
+                return try ChaChaPoly.Nonce(data: nonce)
+            }
+        }
+
+        /// Authenticates and decrypts data in place in a caller-provided buffer.
+        ///
+        /// - Parameters:
+        ///   - buffer: A buffer holding the ciphertext immediately followed by the 16-byte tag.
+        ///   - nonce: The nonce the data was sealed with.
+        ///   - authenticatedData: Data that was authenticated as part of the seal
+        /// - Returns: The prefix of `buffer` that now holds the plaintext.
+        /// - Throws: CryptoKitError errors. If authentication fails, the ciphertext portion of `buffer` is zeroed.
+        @discardableResult
+        public func open<AuthenticatedData: DataProtocol>(
+            inPlace buffer: UnsafeMutableRawBufferPointer,
+            nonce: ChaChaPoly.Nonce,
+            authenticating authenticatedData: AuthenticatedData
+        ) throws -> UnsafeMutableRawBufferPointer {
+            try self.backing.open(inPlace: buffer, nonce: nonce, authenticatedData: authenticatedData)
+        }
+    }
+}
@@ -0,0 +1,171 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+
+extension AES.GCM {
+    /// A bounded cache of prepared AES-GCM keys, looked up by an identifier the caller chooses.
+    ///
+    /// Code that stores keys by identifier, such as a session table, tends to call
+    /// ``AES/GCM/seal(_:using:nonce:authenticating:)`` with a `SymmetricKey` for every message, which repeats the
+    /// key schedule and GHASH table setup each time. The cache keeps a ``AES/GCM/_PreparedKey`` per identifier, so
+    /// that work happens once for as long as the key stays in use. When the cache is full, the least recently used
+    /// key is dropped.
+    ///
+    /// The cache is split into shards, each with its own lock, and a key is prepared without any lock held.
+    /// A dropped key's context is cleared when the last reference to it is released, which may be later than the
+    /// eviction if another thread is still using it.
+    ///
+    /// Key identifiers are compared for equality only. An identifier must always name the same key: if a key is
+    /// rotated under an existing identifier, call ``removeKey(for:)`` first.
+    public final class _PreparedKeyCache<KeyID: Hashable>: @unchecked Sendable {
+        private let keys: ShardedLRUCache<KeyID, _PreparedKey>
+
+        /// Creates an empty cache.
+        ///
+        /// - Parameters:
+        ///   - capacity: The most keys to keep, rounded up to a multiple of `shards`. Must be positive.
+        ///   - shards: The number of independently locked parts of the cache. Must be positive.
+        ///   - budget: The budget to charge the cached keys to, or `nil` to bound the cache by `capacity` alone.
+        ///   - budgetWeight: The weight of the cache's share of `budget`. Must be positive.
+        public init(
+            capacity: Int = 1024,
+            shards: Int = 16,
+            budget: _CryptoCacheBudget? = .shared,
+            budgetWeight: Double = 1
+        ) {
+            self.keys = ShardedLRUCache(
+                capacity: capacity,
+                shardCount: shards,
+                budget: budget,
+                name: "AES.GCM._PreparedKeyCache",
+                weight: budgetWeight,
+                entryByteCount: { _, _ in preparedAEADKeyByteCount }
+            )
+        }
+
+        /// Returns the prepared key for `keyID`, calling `loadKey` to fetch and prepare it if it isn't cached.
+        ///
+        /// - Parameters:
+        ///   - keyID: The identifier of the key.
+        ///   - loadKey: Returns the key for `keyID`. Called without any lock held, and possibly on more than one
+        ///     thread at once for the same identifier.
+        public func key(for keyID: KeyID, loadingKeyWith loadKey: () throws -> SymmetricKey) throws -> _PreparedKey {
+            try self.keys.value(for: keyID) {
+                try _PreparedKey(loadKey())
+            }
+        }
+
+        /// Drops the key for `keyID`, if it's cached.
+        public func removeKey(for keyID: KeyID) {
+            self.keys.removeValue(for: keyID)
+        }
+
+        /// Drops every cached key.
+        public func removeAll() {
+            self.keys.removeAll()
+        }
+
+        /// A snapshot of the cache's size and hit rate.
+        public var statistics: _PreparedKeyCacheStatistics {
+            _PreparedKeyCacheStatistics(self.keys)
+        }
+    }
+}
+
+extension ChaChaPoly {
+    /// A bounded cache of prepared ChaCha20-Poly1305 keys, looked up by an identifier the caller chooses.
+    ///
+    /// This is the ChaCha20-Poly1305 counterpart of ``AES/GCM/_PreparedKeyCache``, and behaves the same way.
+    public final class _PreparedKeyCache<KeyID: Hashable>: @unchecked Sendable {
+        private let keys: ShardedLRUCache<KeyID, _PreparedKey>
+
+        /// Creates an empty cache.
+        ///
+        /// - Parameters:
+        ///   - capacity: The most keys to keep, rounded up to a multiple of `shards`. Must be positive.
+        ///   - shards: The number of independently locked parts of the cache. Must be positive.
+        ///   - budget: The budget to charge the cached keys to, or `nil` to bound the cache by `capacity` alone.
+        ///   - budgetWeight: The weight of the cache's share of `budget`. Must be positive.
+        public init(
+            capacity: Int = 1024,
+            shards: Int = 16,
+            budget: _CryptoCacheBudget? = .shared,
+            budgetWeight: Double = 1
+        ) {
+            self.keys = ShardedLRUCache(
+                capacity: capacity,
+                shardCount: shards,
+                budget: budget,
+                name: "ChaChaPoly._PreparedKeyCache",
+                weight: budgetWeight,
+                entryByteCount: { _, _ in preparedAEADKeyByteCount }
+            )
+        }
+
+        /// Returns the prepared key for `keyID`, calling `loadKey` to fetch and prepare it if it isn't cached.
+        ///
+        /// - Parameters:
+        ///   - keyID: The identifier of the key.
+        ///   - loadKey: Returns the key for `keyID`. Called without any lock held, and possibly on more than one
+        ///     thread at once for the same identifier.
+        public func key(for keyID: KeyID, loadingKeyWith loadKey: () throws -> SymmetricKey) throws -> _PreparedKey {
+            try self.keys.value(for: keyID) {
+                try _PreparedKey(loadKey())
+            }
+        }
+
+        /// Drops the key for `keyID`, if it's cached.
+        public func removeKey(for keyID: KeyID) {
+            self.keys.removeValue(for: keyID)
+        }
+
+        /// Drops every cached key.
+        public func removeAll() {
+            self.keys.removeAll()
+        }
+
+        /// A snapshot of the cache's size and hit rate.
+        public var statistics: _PreparedKeyCacheStatistics {
+            _PreparedKeyCacheStatistics(self.keys)
+        }
+    }
+}
+
+// The estimated memory of a cached prepared key: its AEAD context, which holds 564 bytes of state, and the object
+// around it.
+private let preparedAEADKeyByteCount = 768
+
+/// The size and hit rate of an ``AES/GCM/_PreparedKeyCache`` or ``ChaChaPoly/_PreparedKeyCache``.
+public struct _PreparedKeyCacheStatistics: Sendable, Hashable {
+    /// The number of cached keys.
+    public var keyCount: Int
+    /// The most keys the cache holds.
+    public var capacity: Int
+    /// Lookups that found their key in the cache.
+    public var hits: UInt64
+    /// Lookups that had to load and prepare their key.
+    public var misses: UInt64
+    /// Keys dropped to make room for another.
+    public var evictions: UInt64
+
+    init<KeyID, Value>(_ cache: ShardedLRUCache<KeyID, Value>) {
+        let statistics = cache.statistics
+        self.keyCount = statistics.count
+        self.capacity = cache.capacity
+        self.hits = statistics.hits
+        self.misses = statistics.misses
+        self.evictions = statistics.evictions
+    }
+}
@@ -0,0 +1,197 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+/// Errors from ``_StreamingAEADSealer`` and ``_UnverifiedStreamingAEADOpener``.
+public enum _StreamingAEADError: Error {
+    /// The stream has already been finished.
+    case alreadyFinished
+}
+
+/// Seals one message that arrives in pieces, producing exactly the ciphertext and tag that sealing the whole message at
+/// once would.
+///
+/// Each piece is encrypted as soon as it is passed to ``update(_:)``, so a large upload can be encrypted as it is read
+/// without being held in memory. ``finish()`` returns the tag, which authenticates the whole message. The nonce must be
+/// unique for every message sealed with the key, as for a one-shot seal.
+///
+/// ```swift
+/// let sealer = try AES.GCM._makeStreamingSealer(using: key, nonce: nonce, authenticating: header)
+/// for chunk in upload {
+///     try output.write(sealer.update(chunk))
+/// }
+/// try output.write(sealer.finish())
+/// ```
+///
+/// A sealer is not safe to use from several threads at once.
+public final class _StreamingAEADSealer {
+    private let stream: OpenSSLStreamingAEAD
+
+    fileprivate init(_ stream: OpenSSLStreamingAEAD) {
+        self.stream = stream
+    }
+
+    /// Encrypts the next piece of the message.
+    ///
+    /// - Returns: The ciphertext of `plaintext`, which is the same size.
+    public func update<Plaintext: DataProtocol>(_ plaintext: Plaintext) throws -> Data {
+        try self.stream.update(plaintext)
+    }
+
+    /// Encrypts the next piece of the message into a caller-provided buffer.
+    ///
+    /// - Parameters:
+    ///   - plaintext: The next piece of the message.
+    ///   - ciphertext: The buffer to write its ciphertext into. Must be the same size as `plaintext`, and may be the same
+    ///     memory.
+    public func update(_ plaintext: UnsafeRawBufferPointer, into ciphertext: UnsafeMutableRawBufferPointer) throws {
+        try self.stream.update(plaintext, into: ciphertext)
+    }
+
+    /// Finishes the message.
+    ///
+    /// - Returns: The 16-byte tag.
+    public func finish() throws -> Data {
+        try self.stream.sealFinal()
+    }
+}
+
+/// Opens one message that arrives in pieces, releasing plaintext **before** it has been authenticated.
+///
+/// This is unsafe by design. ``update(_:)`` returns the decryption of each piece immediately, and nothing about it is
+/// known to be genuine until ``finish(tag:)`` returns without throwing. An attacker can flip any bit of that plaintext
+/// by flipping the same bit of the ciphertext. Callers must treat everything released as untrusted: stage it somewhere
+/// it can't be acted on, and discard all of it if ``finish(tag:)`` throws. Where holding the plaintext until the end is
+/// acceptable, use the one-shot `open` instead; where it isn't, prefer ``_SegmentedAEAD``, which authenticates each
+/// segment before releasing it.
+///
+/// An opener is not safe to use from several threads at once.
+public final class _UnverifiedStreamingAEADOpener {
+    private let stream: OpenSSLStreamingAEAD
+
+    fileprivate init(_ stream: OpenSSLStreamingAEAD) {
+        self.stream = stream
+    }
+
+    /// Decrypts the next piece of the ciphertext, without authenticating it.
+    ///
+    /// - Returns: The unauthenticated plaintext of `ciphertext`, which is the same size.
+    public func update<Ciphertext: DataProtocol>(_ ciphertext: Ciphertext) throws -> Data {
+        try self.stream.update(ciphertext)
+    }
+
+    /// Decrypts the next piece of the ciphertext into a caller-provided buffer, without authenticating it.
+    ///
+    /// - Parameters:
+    ///   - ciphertext: The next piece of the ciphertext.
+    ///   - plaintext: The buffer to write its unauthenticated plaintext into. Must be the same size as `ciphertext`, and
+    ///     may be the same memory.
+    public func update(_ ciphertext: UnsafeRawBufferPointer, into plaintext: UnsafeMutableRawBufferPointer) throws {
+        try self.stream.update(ciphertext, into: plaintext)
+    }
+
+    /// Checks the tag against everything decrypted so far.
+    ///
+    /// - Throws: `CryptoKitError.authenticationFailure` if the tag does not match, in which case every byte of plaintext
+    ///     released by this opener must be discarded.
+    public func finish<Tag: DataProtocol>(tag: Tag) throws {
+        try self.stream.openFinal(tag: tag)
+    }
+}
+
+extension AES.GCM {
+    /// Starts sealing a message that arrives in pieces with AES-GCM. See ``_StreamingAEADSealer``.
+    ///
+    /// - Parameters:
+    ///   - key: An encryption key of 128, 192, or 256 bits
+    ///   - nonce: The nonce to use. It must be unique for every use of the key to seal data.
+    ///   - authenticatedData: Data to authenticate as part of the seal
+    public static func _makeStreamingSealer<AuthenticatedData: DataProtocol>(
+        using key: SymmetricKey,
+        nonce: AES.GCM.Nonce,
+        authenticating authenticatedData: AuthenticatedData
+    ) throws -> _StreamingAEADSealer {
+        _StreamingAEADSealer(try OpenSSLStreamingAEAD(algorithm: .aesGCM, key: key, nonce: nonce, authenticatedData: authenticatedData, encrypt: true))
+    }
+
+    /// Starts sealing a message that arrives in pieces with AES-GCM. See ``_StreamingAEADSealer``.
+    public static func _makeStreamingSealer(using key: SymmetricKey, nonce: AES.GCM.Nonce) throws -> _StreamingAEADSealer {
+        try Self._makeStreamingSealer(using: key, nonce: nonce, authenticating: Data())
+    }
+
+    /// Starts opening a message that arrives in pieces with AES-GCM, releasing plaintext before it is authenticated. See
+    /// ``_UnverifiedStreamingAEADOpener``.
+    ///
+    /// - Parameters:
+    ///   - key: The key the message was sealed with
+    ///   - nonce: The nonce the message was sealed with
+    ///   - authenticatedData: The data that was authenticated when the message was sealed
+    public static func _makeUnverifiedStreamingOpener<AuthenticatedData: DataProtocol>(
+        using key: SymmetricKey,
+        nonce: AES.GCM.Nonce,
+        authenticating authenticatedData: AuthenticatedData
+    ) throws -> _UnverifiedStreamingAEADOpener {
+        _UnverifiedStreamingAEADOpener(try OpenSSLStreamingAEAD(algorithm: .aesGCM, key: key, nonce: nonce, authenticatedData: authenticatedData, encrypt: false))
+    }
+
+    /// Starts opening a message that arrives in pieces with AES-GCM, releasing plaintext before it is authenticated. See
+    /// ``_UnverifiedStreamingAEADOpener``.
+    public static func _makeUnverifiedStreamingOpener(using key: SymmetricKey, nonce: AES.GCM.Nonce) throws -> _UnverifiedStreamingAEADOpener {
+        try Self._makeUnverifiedStreamingOpener(using: key, nonce: nonce, authenticating: Data())
+    }
+}
+
+extension ChaChaPoly {
+    /// Starts sealing a message that arrives in pieces with ChaCha20-Poly1305. See ``_StreamingAEADSealer``.
+    ///
+    /// - Parameters:
+    ///   - key: A 256-bit encryption key
+    ///   - nonce: The nonce to use. It must be unique for every use of the key to seal data.
+    ///   - authenticatedData: Data to authenticate as part of the seal
+    public static func _makeStreamingSealer<AuthenticatedData: DataProtocol>(
+        using key: SymmetricKey,
+        nonce: ChaChaPoly.Nonce,
+        authenticating authenticatedData: AuthenticatedData
+    ) throws -> _StreamingAEADSealer {
+        _StreamingAEADSealer(try OpenSSLStreamingAEAD(algorithm: .chaChaPoly, key: key, nonce: nonce, authenticatedData: authenticatedData, encrypt: true))
+    }
+
+    /// Starts sealing a message that arrives in pieces with ChaCha20-Poly1305. See ``_StreamingAEADSealer``.
+    public static func _makeStreamingSealer(using key: SymmetricKey, nonce: ChaChaPoly.Nonce) throws -> _StreamingAEADSealer {
+        try Self._makeStreamingSealer(using: key, nonce: nonce, authenticating: Data())
+    }
+
+    /// Starts opening a message that arrives in pieces with ChaCha20-Poly1305, releasing plaintext before it is
+    /// authenticated. See ``_UnverifiedStreamingAEADOpener``.
+    ///
+    /// - Parameters:
+    ///   - key: The key the message was sealed with
+    ///   - nonce: The nonce the message was sealed with
+    ///   - authenticatedData: The data that was authenticated when the message was sealed
+    public static func _makeUnverifiedStreamingOpener<AuthenticatedData: DataProtocol>(
+        using key: SymmetricKey,
+        nonce: ChaChaPoly.Nonce,
+        authenticating authenticatedData: AuthenticatedData
+    ) throws -> _UnverifiedStreamingAEADOpener {
+        _UnverifiedStreamingAEADOpener(try OpenSSLStreamingAEAD(algorithm: .chaChaPoly, key: key, nonce: nonce, authenticatedData: authenticatedData, encrypt: false))
+    }
+
+    /// Starts opening a message that arrives in pieces with ChaCha20-Poly1305, releasing plaintext before it is
+    /// authenticated. See ``_UnverifiedStreamingAEADOpener``.
+    public static func _makeUnverifiedStreamingOpener(using key: SymmetricKey, nonce: ChaChaPoly.Nonce) throws -> _UnverifiedStreamingAEADOpener {
+        try Self._makeUnverifiedStreamingOpener(using: key, nonce: nonce, authenticating: Data())
+    }
+}
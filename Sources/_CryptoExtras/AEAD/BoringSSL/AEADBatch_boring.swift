@@ -0,0 +1,108 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+@_implementationOnly import CryptoBoringWrapper
+import Foundation
+
+enum OpenSSLAEADBatchImpl {
+    // All of the AEADs we support batching for use 128-bit tags.
+    static let tagByteCount = 16
+
+    // The nonce sizes `AES.GCM.Nonce` and `ChaChaPoly.Nonce` accept.
+    static func isValidNonce(_ nonce: UnsafeRawBufferPointer, for algorithm: AEADAlgorithm) -> Bool {
+        switch algorithm {
+        case .aesGCM:
+            return nonce.count >= 12
+        case .chaChaPoly:
+            return nonce.count == 12
+        }
+    }
+
+    static func seal(_ operations: [_AEADBatchSealOperation], algorithm: AEADAlgorithm, key: SymmetricKey) throws {
+        let cipher = try BoringSSLAEAD(algorithm, key: key)
+        let batch = try operations.map { operation -> BoringSSLAEAD.BatchOperation in
+            guard operation.ciphertext.count == operation.plaintext.count,
+                  operation.tag.count == Self.tagByteCount,
+                  Self.isValidNonce(operation.nonce, for: algorithm) else {
+                throw CryptoKitError.incorrectParameterSize
+            }
+
+            return BoringSSLAEAD.BatchOperation(
+                nonce: operation.nonce,
+                input: operation.plaintext,
+                authenticatedData: operation.authenticatedData,
+                output: operation.ciphertext,
+                tag: operation.tag
+            )
+        }
+
+        do {
+            let context = try BoringSSLAEAD.AEADContext(cipher: cipher, key: key)
+            try context.seal(batch: batch)
+        } catch CryptoBoringWrapperError.underlyingCoreCryptoError(let errorCode) {
+            throw CryptoKitError.underlyingCoreCryptoError(error: errorCode)
+        }
+    }
+
+    static func open(_ operations: [_AEADBatchOpenOperation], algorithm: AEADAlgorithm, key: SymmetricKey) throws -> [Bool] {
+        let cipher = try BoringSSLAEAD(algorithm, key: key)
+        let batch = try operations.map { operation -> BoringSSLAEAD.BatchOperation in
+            guard operation.plaintext.count == operation.ciphertext.count,
+                  operation.tag.count == Self.tagByteCount,
+                  Self.isValidNonce(operation.nonce, for: algorithm) else {
+                throw CryptoKitError.incorrectParameterSize
+            }
+
+            // The tag is only ever read when opening.
+            return BoringSSLAEAD.BatchOperation(
+                nonce: operation.nonce,
+                input: operation.ciphertext,
+                authenticatedData: operation.authenticatedData,
+                output: operation.plaintext,
+                tag: UnsafeMutableRawBufferPointer(mutating: operation.tag)
+            )
+        }
+
+        do {
+            let context = try BoringSSLAEAD.AEADContext(cipher: cipher, key: key)
+            return context.open(batch: batch)
+        } catch CryptoBoringWrapperError.underlyingCoreCryptoError(let errorCode) {
+            throw CryptoKitError.underlyingCoreCryptoError(error: errorCode)
+        }
+    }
+}
+
+extension BoringSSLAEAD {
+    /// The BoringSSL AEAD implementing the given algorithm with a key of this size.
+    init(_ algorithm: AEADAlgorithm, key: SymmetricKey) throws {
+        try self.init(algorithm, keyBitCount: key.bitCount)
+    }
+
+    /// The BoringSSL AEAD implementing the given algorithm with a key of `keyBitCount` bits.
+    init(_ algorithm: AEADAlgorithm, keyBitCount: Int) throws {
+        switch (algorithm, keyBitCount) {
+        case (.aesGCM, 128):
+            self = .aes128gcm
+        case (.aesGCM, 192):
+            self = .aes192gcm
+        case (.aesGCM, 256):
+            self = .aes256gcm
+        case (.chaChaPoly, 256):
+            self = .chacha20
+        default:
+            throw CryptoKitError.incorrectKeySize
+        }
+    }
+}
@@ -0,0 +1,136 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+import Crypto
+import Foundation
+
+/// Owns the C pool. Sessions retain it, so it outlives every key added to it.
+final class OpenSSLAESGCMCompactKeyPool {
+    let pool: OpaquePointer
+
+    init(hotCapacity: Int) {
+        precondition(hotCapacity >= 0 && hotCapacity < Int(UInt32.max), "Invalid hot capacity \(hotCapacity)")
+        guard let pool = CCryptoBoringSSLShims_GCM_POOL_new(hotCapacity) else {
+            fatalError("Unable to allocate AES-GCM key pool")
+        }
+        self.pool = pool
+    }
+
+    deinit {
+        CCryptoBoringSSLShims_GCM_POOL_free(self.pool)
+    }
+
+    var statistics: AES.GCM._CompactKeyPool.Statistics {
+        var stats = CCryptoBoringSSLShims_GCM_POOL_statistics()
+        CCryptoBoringSSLShims_GCM_POOL_get_statistics(self.pool, &stats)
+        return AES.GCM._CompactKeyPool.Statistics(
+            sessionCount: Int(stats.sessions),
+            compactByteCount: Int(stats.compact_bytes),
+            hotCapacity: Int(stats.hot_capacity),
+            hotByteCount: Int(stats.hot_bytes),
+            hits: stats.hits,
+            promotions: stats.promotions,
+            evictions: stats.evictions,
+            transientExpansions: stats.transient_expansions
+        )
+    }
+}
+
+/// One session in a compact key pool, removed from the pool when released.
+final class OpenSSLAESGCMCompactKey: @unchecked Sendable {
+    private let pool: OpenSSLAESGCMCompactKeyPool
+
+    private let handle: UInt32
+
+    init(_ key: SymmetricKey, pool: OpenSSLAESGCMCompactKeyPool) throws {
+        guard [128, 192, 256].contains(key.bitCount) else {
+            throw CryptoKitError.incorrectKeySize
+        }
+        self.pool = pool
+        var handle = UInt32(0)
+        let rc = key.withUnsafeBytes { keyPtr in
+            CCryptoBoringSSLShims_GCM_POOL_add(pool.pool, keyPtr.baseAddress?.assumingMemoryBound(to: UInt8.self), keyPtr.count, &handle)
+        }
+        guard rc == 1 else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+        self.handle = handle
+    }
+
+    deinit {
+        CCryptoBoringSSLShims_GCM_POOL_remove(self.pool.pool, self.handle)
+    }
+
+    func seal<Plaintext: DataProtocol, AuthenticatedData: DataProtocol>(
+        _ message: Plaintext,
+        nonce: AES.GCM.Nonce,
+        authenticatedData: AuthenticatedData
+    ) throws -> AES.GCM.SealedBox {
+        var ciphertext = Data(message)
+        var tag = Data(repeating: 0, count: 16)
+        let ad = Data(authenticatedData)
+        let rc = nonce.withUnsafeBytes { noncePtr in
+            ad.withUnsafeBytes { adPtr in
+                tag.withUnsafeMutableBytes { tagPtr in
+                    ciphertext.withUnsafeMutableBytes { bufferPtr in
+                        let buffer = bufferPtr.baseAddress?.assumingMemoryBound(to: UInt8.self)
+                        return CCryptoBoringSSLShims_GCM_POOL_seal(
+                            self.pool.pool, self.handle,
+                            noncePtr.baseAddress?.assumingMemoryBound(to: UInt8.self), noncePtr.count,
+                            adPtr.baseAddress?.assumingMemoryBound(to: UInt8.self), adPtr.count,
+                            buffer, bufferPtr.count,
+                            buffer,
+                            tagPtr.baseAddress?.assumingMemoryBound(to: UInt8.self)
+                        )
+                    }
+                }
+            }
+        }
+        guard rc == 1 else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+        return try AES.GCM.SealedBox(nonce: nonce, ciphertext: ciphertext, tag: tag)
+    }
+
+    func open<AuthenticatedData: DataProtocol>(_ sealedBox: AES.GCM.SealedBox, authenticatedData: AuthenticatedData) throws -> Data {
+        let tag = sealedBox.tag
+        guard tag.count == 16 else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+        var plaintext = sealedBox.ciphertext
+        let ad = Data(authenticatedData)
+        let rc = sealedBox.nonce.withUnsafeBytes { noncePtr in
+            ad.withUnsafeBytes { adPtr in
+                tag.withUnsafeBytes { tagPtr in
+                    plaintext.withUnsafeMutableBytes { bufferPtr in
+                        let buffer = bufferPtr.baseAddress?.assumingMemoryBound(to: UInt8.self)
+                        return CCryptoBoringSSLShims_GCM_POOL_open(
+                            self.pool.pool, self.handle,
+                            noncePtr.baseAddress?.assumingMemoryBound(to: UInt8.self), noncePtr.count,
+                            adPtr.baseAddress?.assumingMemoryBound(to: UInt8.self), adPtr.count,
+                            buffer, bufferPtr.count,
+                            tagPtr.baseAddress?.assumingMemoryBound(to: UInt8.self),
+                            buffer
+                        )
+                    }
+                }
+            }
+        }
+        guard rc == 1 else {
+            throw CryptoKitError.authenticationFailure
+        }
+        return plaintext
+    }
+}
@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+@_implementationOnly import CryptoBoringWrapper
+import Foundation
+
+enum OpenSSLAEADHashingImpl {
+    // All of the AEADs we support here use 128-bit tags.
+    static let tagByteCount = 16
+
+    static func seal<Nonce: ContiguousBytes, AuthenticatedData: DataProtocol>(
+        _ message: UnsafeRawBufferPointer,
+        into output: UnsafeMutableRawBufferPointer,
+        algorithm: AEADAlgorithm,
+        key: SymmetricKey,
+        nonce: Nonce,
+        authenticatedData: AuthenticatedData
+    ) throws -> Data {
+        let cipher = try BoringSSLAEAD(algorithm, key: key)
+        guard output.count == message.count + Self.tagByteCount else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+
+        var digest = Data(repeating: 0, count: SHA256.byteCount)
+        do {
+            let context = try BoringSSLAEAD.AEADContext(cipher: cipher, key: key)
+            try digest.withUnsafeMutableBytes { digestPointer in
+                try context.sealHashingPlaintext(message: message, nonce: nonce, authenticatedData: authenticatedData, into: output, digest: digestPointer)
+            }
+        } catch CryptoBoringWrapperError.underlyingCoreCryptoError(let errorCode) {
+            throw CryptoKitError.underlyingCoreCryptoError(error: errorCode)
+        }
+        return digest
+    }
+
+    static func seal<Plaintext: DataProtocol, Nonce: ContiguousBytes, AuthenticatedData: DataProtocol>(
+        _ message: Plaintext,
+        algorithm: AEADAlgorithm,
+        key: SymmetricKey,
+        nonce: Nonce,
+        authenticatedData: AuthenticatedData
+    ) throws -> (ciphertext: Data, tag: Data, digest: Data) {
+        var output = Data(repeating: 0, count: message.count + Self.tagByteCount)
+        let digest = try output.withUnsafeMutableBytes { outputPointer -> Data in
+            if let region = message.regions.first, message.regions.count == 1 {
+                return try region.withUnsafeBytes { messagePointer in
+                    try Self.seal(messagePointer, into: outputPointer, algorithm: algorithm, key: key, nonce: nonce, authenticatedData: authenticatedData)
+                }
+            }
+            // Copying a discontiguous message into the output lets it be sealed in place.
+            _ = outputPointer.copyBytes(from: message)
+            return try Self.seal(UnsafeRawBufferPointer(rebasing: outputPointer.prefix(message.count)), into: outputPointer, algorithm: algorithm, key: key, nonce: nonce, authenticatedData: authenticatedData)
+        }
+        return (ciphertext: output.prefix(message.count), tag: output.suffix(Self.tagByteCount), digest: digest)
+    }
+
+    static func open<Nonce: ContiguousBytes, AuthenticatedData: DataProtocol>(
+        inPlace buffer: UnsafeMutableRawBufferPointer,
+        algorithm: AEADAlgorithm,
+        key: SymmetricKey,
+        nonce: Nonce,
+        authenticatedData: AuthenticatedData
+    ) throws -> (plaintext: UnsafeMutableRawBufferPointer, plaintextDigest: Data) {
+        let cipher = try BoringSSLAEAD(algorithm, key: key)
+        guard buffer.count >= Self.tagByteCount else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+
+        var digest = Data(repeating: 0, count: SHA256.byteCount)
+        do {
+            let context = try BoringSSLAEAD.AEADContext(cipher: cipher, key: key)
+            let plaintextByteCount = try digest.withUnsafeMutableBytes { digestPointer in
+                try context.openHashingPlaintext(inPlace: buffer, nonce: nonce, authenticatedData: authenticatedData, digest: digestPointer)
+            }
+            return (UnsafeMutableRawBufferPointer(rebasing: buffer.prefix(plaintextByteCount)), digest)
+        } catch CryptoBoringWrapperError.underlyingCoreCryptoError(let errorCode) {
+            throw CryptoKitError.underlyingCoreCryptoError(error: errorCode)
+        }
+    }
+}
@@ -0,0 +1,67 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+@_implementationOnly import CryptoBoringWrapper
+import Foundation
+
+@usableFromInline
+enum OpenSSLAEADInPlaceImpl {
+    // All of the AEADs we support here use 128-bit tags.
+    static let tagByteCount = 16
+
+    @usableFromInline
+    static func seal<Nonce: ContiguousBytes, AuthenticatedData: DataProtocol>(
+        _ message: UnsafeRawBufferPointer,
+        into output: UnsafeMutableRawBufferPointer,
+        algorithm: AEADAlgorithm,
+        key: SymmetricKey,
+        nonce: Nonce,
+        authenticatedData: AuthenticatedData
+    ) throws {
+        let cipher = try BoringSSLAEAD(algorithm, key: key)
+        guard output.count == message.count + Self.tagByteCount else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+
+        do {
+            let context = try BoringSSLAEAD.AEADContext(cipher: cipher, key: key)
+            try context.seal(message: message, nonce: nonce, authenticatedData: authenticatedData, into: output)
+        } catch CryptoBoringWrapperError.underlyingCoreCryptoError(let errorCode) {
+            throw CryptoKitError.underlyingCoreCryptoError(error: errorCode)
+        }
+    }
+
+    @usableFromInline
+    static func open<Nonce: ContiguousBytes, AuthenticatedData: DataProtocol>(
+        inPlace buffer: UnsafeMutableRawBufferPointer,
+        algorithm: AEADAlgorithm,
+        key: SymmetricKey,
+        nonce: Nonce,
+        authenticatedData: AuthenticatedData
+    ) throws -> UnsafeMutableRawBufferPointer {
+        let cipher = try BoringSSLAEAD(algorithm, key: key)
+        guard buffer.count >= Self.tagByteCount else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+
+        do {
+            let context = try BoringSSLAEAD.AEADContext(cipher: cipher, key: key)
+            let plaintextByteCount = try context.open(inPlace: buffer, nonce: nonce, authenticatedData: authenticatedData)
+            return UnsafeMutableRawBufferPointer(rebasing: buffer.prefix(plaintextByteCount))
+        } catch CryptoBoringWrapperError.underlyingCoreCryptoError(let errorCode) {
+            throw CryptoKitError.underlyingCoreCryptoError(error: errorCode)
+        }
+    }
+}
@@ -0,0 +1,164 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+@_implementationOnly import CryptoBoringWrapper
+import Foundation
+
+/// An AES-GCM or ChaCha20-Poly1305 key with its `EVP_AEAD_CTX` already initialised. For AES-GCM that means the
+/// AES key schedule and the GHASH key table are computed once, rather than for every message. The context is
+/// only read after initialisation, so it may be used from several threads at once.
+///
+/// With `replicatedPerNode`, each NUMA node gets its own context, built the first time a thread on that node uses
+/// the key.
+final class OpenSSLAEADPreparedKey {
+    private let context: BoringSSLAEAD.AEADContext
+
+    private let replicas: NodeLocalReplicas<BoringSSLAEAD.AEADContext>?
+
+    private let nonceSequenceLock = NSLock()
+
+    // Protected by `nonceSequenceLock`. Whether an `_AEADNonceSequence` has claimed this key.
+    private var hasNonceSequence = false
+
+    init(_ key: SymmetricKey, algorithm: AEADAlgorithm, replicatedPerNode: Bool = false) throws {
+        let cipher = try BoringSSLAEAD(algorithm, key: key)
+        let makeContext = { () throws -> BoringSSLAEAD.AEADContext in
+            do {
+                return try BoringSSLAEAD.AEADContext(cipher: cipher, key: key)
+            } catch CryptoBoringWrapperError.underlyingCoreCryptoError(let errorCode) {
+                throw CryptoKitError.underlyingCoreCryptoError(error: errorCode)
+            }
+        }
+        self.context = try makeContext()
+        self.replicas = replicatedPerNode ? NodeLocalReplicas(primary: self.context, makeReplica: makeContext) : nil
+    }
+
+    /// Wraps a context that has already been initialised. There is no key to build replicas from, so the key is
+    /// never replicated per node.
+    init(context: BoringSSLAEAD.AEADContext) {
+        self.context = context
+        self.replicas = nil
+    }
+
+    /// The number of NUMA nodes that have their own copy of the context.
+    var replicaCount: Int {
+        self.replicas?.replicaCount ?? 1
+    }
+
+    /// Claims the key for a nonce sequence. Returns `false` if another sequence already has it; the sequence keeps
+    /// a reference to the key it claimed, so it can tell its own key apart without asking again.
+    func bindNonceSequence() -> Bool {
+        self.nonceSequenceLock.lock()
+        defer {
+            self.nonceSequenceLock.unlock()
+        }
+        if self.hasNonceSequence {
+            return false
+        }
+        self.hasNonceSequence = true
+        return true
+    }
+
+    private func currentContext() throws -> BoringSSLAEAD.AEADContext {
+        try self.replicas?.current() ?? self.context
+    }
+
+    func seal<Plaintext: DataProtocol, Nonce: ContiguousBytes, AuthenticatedData: DataProtocol>(
+        _ message: Plaintext,
+        nonce: Nonce,
+        authenticatedData: AuthenticatedData
+    ) throws -> (ciphertext: Data, tag: Data) {
+        do {
+            return try self.currentContext().seal(message: message, nonce: nonce, authenticatedData: authenticatedData)
+        } catch CryptoBoringWrapperError.underlyingCoreCryptoError(let errorCode) {
+            throw CryptoKitError.underlyingCoreCryptoError(error: errorCode)
+        }
+    }
+
+    func seal<Nonce: ContiguousBytes, AuthenticatedData: DataProtocol>(
+        _ message: UnsafeRawBufferPointer,
+        into output: UnsafeMutableRawBufferPointer,
+        nonce: Nonce,
+        authenticatedData: AuthenticatedData,
+        concurrently: Bool = false
+    ) throws {
+        guard output.count == message.count + OpenSSLAEADInPlaceImpl.tagByteCount else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+
+        do {
+            let context = try self.currentContext()
+            if concurrently, let segmentByteCount = Self.concurrentSegmentByteCount(messageByteCount: message.count), context.supportsConcurrentSealing {
+                try context.sealConcurrently(message: message, nonce: nonce, authenticatedData: authenticatedData, into: output, segmentByteCount: segmentByteCount)
+            } else {
+                try context.seal(message: message, nonce: nonce, authenticatedData: authenticatedData, into: output)
+            }
+        } catch CryptoBoringWrapperError.underlyingCoreCryptoError(let errorCode) {
+            throw CryptoKitError.underlyingCoreCryptoError(error: errorCode)
+        }
+    }
+
+    func open<Nonce: ContiguousBytes, AuthenticatedData: DataProtocol>(
+        ciphertext: Data,
+        nonce: Nonce,
+        tag: Data,
+        authenticatedData: AuthenticatedData
+    ) throws -> Data {
+        do {
+            return try self.currentContext().open(ciphertext: ciphertext, nonce: nonce, tag: tag, authenticatedData: authenticatedData)
+        } catch CryptoBoringWrapperError.underlyingCoreCryptoError(let errorCode) {
+            throw CryptoKitError.underlyingCoreCryptoError(error: errorCode)
+        }
+    }
+
+    func open<Nonce: ContiguousBytes, AuthenticatedData: DataProtocol>(
+        inPlace buffer: UnsafeMutableRawBufferPointer,
+        nonce: Nonce,
+        authenticatedData: AuthenticatedData,
+        concurrently: Bool = false
+    ) throws -> UnsafeMutableRawBufferPointer {
+        guard buffer.count >= OpenSSLAEADInPlaceImpl.tagByteCount else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+
+        do {
+            let context = try self.currentContext()
+            let plaintextByteCount: Int
+            if concurrently, let segmentByteCount = Self.concurrentSegmentByteCount(messageByteCount: buffer.count - OpenSSLAEADInPlaceImpl.tagByteCount), context.supportsConcurrentSealing {
+                plaintextByteCount = try context.openConcurrently(inPlace: buffer, nonce: nonce, authenticatedData: authenticatedData, segmentByteCount: segmentByteCount)
+            } else {
+                plaintextByteCount = try context.open(inPlace: buffer, nonce: nonce, authenticatedData: authenticatedData)
+            }
+            return UnsafeMutableRawBufferPointer(rebasing: buffer.prefix(plaintextByteCount))
+        } catch CryptoBoringWrapperError.underlyingCoreCryptoError(let errorCode) {
+            throw CryptoKitError.underlyingCoreCryptoError(error: errorCode)
+        }
+    }
+
+    /// Messages shorter than this are processed serially: below it, dispatching segments to other cores costs more
+    /// than it saves.
+    static let minimumConcurrentMessageByteCount = 4 << 20
+
+    /// The segment size for processing a message concurrently, or `nil` if it should be processed serially.
+    ///
+    /// Aims for a few segments per core so that uneven scheduling evens out, without going below 1 MiB per segment.
+    static func concurrentSegmentByteCount(messageByteCount: Int) -> Int? {
+        let cores = ProcessInfo.processInfo.activeProcessorCount
+        guard cores > 1, messageByteCount >= Self.minimumConcurrentMessageByteCount else {
+            return nil
+        }
+        let target = max(messageByteCount / (cores * 4), 1 << 20)
+        return (target + 15) & ~15
+    }
+}
@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+@_implementationOnly import CryptoBoringWrapper
+import Foundation
+
+/// One AES-GCM or ChaCha20-Poly1305 seal or open fed across several calls.
+final class OpenSSLStreamingAEAD {
+    private let stream: BoringSSLAEAD.AEADStream
+
+    private var finished = false
+
+    init<Nonce: ContiguousBytes, AuthenticatedData: DataProtocol>(
+        algorithm: AEADAlgorithm,
+        key: SymmetricKey,
+        nonce: Nonce,
+        authenticatedData: AuthenticatedData,
+        encrypt: Bool
+    ) throws {
+        let cipher = try BoringSSLAEAD(algorithm, key: key)
+        do {
+            self.stream = try BoringSSLAEAD.AEADStream(cipher: cipher, key: key, nonce: nonce, authenticatedData: authenticatedData, encrypt: encrypt)
+        } catch CryptoBoringWrapperError.underlyingCoreCryptoError(let errorCode) {
+            throw CryptoKitError.underlyingCoreCryptoError(error: errorCode)
+        }
+    }
+
+    func update(_ input: UnsafeRawBufferPointer, into output: UnsafeMutableRawBufferPointer) throws {
+        guard !self.finished else {
+            throw _StreamingAEADError.alreadyFinished
+        }
+        guard input.count == output.count else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+        do {
+            try self.stream.update(input, into: output)
+        } catch CryptoBoringWrapperError.underlyingCoreCryptoError(let errorCode) {
+            throw CryptoKitError.underlyingCoreCryptoError(error: errorCode)
+        }
+    }
+
+    func update<Input: DataProtocol>(_ input: Input) throws -> Data {
+        var output = Data(count: input.count)
+        try output.withUnsafeMutableBytes { output in
+            var offset = 0
+            for region in input.regions {
+                try region.withUnsafeBytes { region in
+                    try self.update(region, into: UnsafeMutableRawBufferPointer(rebasing: output[offset..<(offset + region.count)]))
+                    offset += region.count
+                }
+            }
+        }
+        return output
+    }
+
+    func sealFinal() throws -> Data {
+        guard !self.finished else {
+            throw _StreamingAEADError.alreadyFinished
+        }
+        self.finished = true
+        do {
+            return try self.stream.sealFinal()
+        } catch CryptoBoringWrapperError.underlyingCoreCryptoError(let errorCode) {
+            throw CryptoKitError.underlyingCoreCryptoError(error: errorCode)
+        }
+    }
+
+    func openFinal<Tag: DataProtocol>(tag: Tag) throws {
+        guard !self.finished else {
+            throw _StreamingAEADError.alreadyFinished
+        }
+        self.finished = true
+        let authenticated: Bool
+        do {
+            authenticated = try Array(tag).withUnsafeBytes { try self.stream.openFinal(tag: $0) }
+        } catch CryptoBoringWrapperError.underlyingCoreCryptoError(let errorCode) {
+            throw CryptoKitError.underlyingCoreCryptoError(error: errorCode)
+        }
+        guard authenticated else {
+            throw CryptoKitError.authenticationFailure
+        }
+    }
+}
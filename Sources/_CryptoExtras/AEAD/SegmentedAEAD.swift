@@ -0,0 +1,643 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+/// Errors from ``_SegmentedAEAD``.
+public enum _SegmentedAEADError: Error {
+    /// The header is malformed, or was written with a different algorithm or segment size.
+    case invalidHeader
+    /// The ciphertext is not a length that any plaintext seals to, so it has been truncated or extended.
+    case invalidCiphertextLength
+    /// The plaintext needs more than 2³² segments. Use a larger segment size.
+    case messageTooLong
+    /// The requested range extends past the end of the plaintext.
+    case invalidRange
+    /// The stream has already been finished.
+    case alreadyFinished
+}
+
+/// A segmented online AEAD, in the style of the STREAM construction, for encrypting data too large to hold in
+/// memory at once.
+///
+/// The plaintext is cut into segments of ``segmentByteCount`` bytes, the last of which may be shorter, and each is
+/// sealed on its own. The ciphertext is a header followed by the sealed segments:
+///
+/// - The header is a version byte, an algorithm byte, the segment size as a big-endian `UInt32`, a 32-byte random
+///   salt and a 7-byte random nonce prefix.
+/// - The segments are sealed with a key derived by HKDF-SHA256 from the key, the salt, and an info string binding
+///   the algorithm, the segment size and the caller's authenticated data.
+/// - Segment `i` is sealed with the nonce `prefix || i as UInt32 big-endian || last`, where `last` is 1 for the
+///   final segment and 0 otherwise, so segments can't be reordered, dropped or truncated undetected.
+///
+/// Because every segment stands alone, messages can be encrypted and decrypted from a stream while holding about one
+/// segment in memory, any byte range of a ciphertext can be decrypted by opening only the segments it covers, and the
+/// segments of a buffer can be processed on all cores at once.
+public struct _SegmentedAEAD: Sendable {
+    /// The AEAD that seals each segment.
+    public enum Algorithm: UInt8, Sendable {
+        /// AES-256-GCM.
+        case aesGCM = 1
+        /// ChaCha20-Poly1305.
+        case chaChaPoly = 2
+    }
+
+    /// The default plaintext segment size, 64 KiB.
+    public static let defaultSegmentByteCount = 1 << 16
+
+    /// The number of bytes in the header.
+    public static let headerByteCount = 2 + 4 + Self.saltByteCount + Self.noncePrefixByteCount
+
+    /// The number of bytes each sealed segment adds to its plaintext.
+    public static let tagByteCount = 16
+
+    static let version: UInt8 = 1
+
+    static let saltByteCount = 32
+
+    static let noncePrefixByteCount = 7
+
+    static let maximumSegmentCount = 1 << 32
+
+    /// The AEAD that seals each segment.
+    public let algorithm: Algorithm
+
+    /// The size of every plaintext segment except possibly the last.
+    public let segmentByteCount: Int
+
+    private let key: SymmetricKey
+
+    /// Creates a segmented AEAD.
+    ///
+    /// - Parameters:
+    ///   - key: The key to derive each message's segment key from. Must be at least 128 bits.
+    ///   - algorithm: The AEAD that seals each segment.
+    ///   - segmentByteCount: The plaintext size of each segment. Must be between 1 byte and 1 GiB. Larger segments
+    ///     cost less per byte, smaller segments make random access and streaming use less memory.
+    public init(key: SymmetricKey, algorithm: Algorithm = .aesGCM, segmentByteCount: Int = Self.defaultSegmentByteCount) throws {
+        guard key.bitCount >= 128 else {
+            throw CryptoKitError.incorrectKeySize
+        }
+        guard segmentByteCount > 0, segmentByteCount <= 1 << 30 else {
+            throw CryptoKitError.invalidParameter
+        }
+        self.key = key
+        self.algorithm = algorithm
+        self.segmentByteCount = segmentByteCount
+    }
+
+    private var sealedSegmentByteCount: Int {
+        self.segmentByteCount + Self.tagByteCount
+    }
+
+    /// The size of the ciphertext for a plaintext of `plaintextByteCount` bytes.
+    public func ciphertextByteCount(plaintextByteCount: Int) -> Int {
+        Self.headerByteCount + plaintextByteCount + self.segmentCount(plaintextByteCount: plaintextByteCount) * Self.tagByteCount
+    }
+
+    /// The size of the plaintext of a ciphertext of `ciphertextByteCount` bytes.
+    ///
+    /// - Throws: ``_SegmentedAEADError/invalidCiphertextLength`` if no plaintext seals to that length.
+    public func plaintextByteCount(ciphertextByteCount: Int) throws -> Int {
+        let bodyByteCount = ciphertextByteCount - Self.headerByteCount
+        let segmentCount = try self.segmentCount(bodyByteCount: bodyByteCount)
+        return bodyByteCount - segmentCount * Self.tagByteCount
+    }
+
+    /// An empty plaintext still has a single, empty, segment.
+    private func segmentCount(plaintextByteCount: Int) -> Int {
+        max(1, (plaintextByteCount + self.segmentByteCount - 1) / self.segmentByteCount)
+    }
+
+    private func segmentCount(bodyByteCount: Int) throws -> Int {
+        guard bodyByteCount >= Self.tagByteCount else {
+            throw _SegmentedAEADError.invalidCiphertextLength
+        }
+        let segmentCount = (bodyByteCount + self.sealedSegmentByteCount - 1) / self.sealedSegmentByteCount
+        // Every segment but the last is full, and the last holds at least its tag.
+        guard bodyByteCount - (segmentCount - 1) * self.sealedSegmentByteCount >= Self.tagByteCount else {
+            throw _SegmentedAEADError.invalidCiphertextLength
+        }
+        return segmentCount
+    }
+
+    // MARK: - Whole buffers
+
+    /// Seals a whole plaintext into a caller-provided buffer.
+    ///
+    /// - Parameters:
+    ///   - plaintext: The data to encrypt.
+    ///   - output: The buffer to write the header and segments into. Must be exactly
+    ///     ``ciphertextByteCount(plaintextByteCount:)`` bytes.
+    ///   - authenticatedData: Data to authenticate along with the plaintext. The same data must be given to open it.
+    ///   - concurrently: Whether to seal the segments concurrently across all available cores.
+    public func seal<AuthenticatedData: DataProtocol>(
+        _ plaintext: UnsafeRawBufferPointer,
+        into output: UnsafeMutableRawBufferPointer,
+        authenticating authenticatedData: AuthenticatedData,
+        concurrently: Bool = false
+    ) throws {
+        guard output.count == self.ciphertextByteCount(plaintextByteCount: plaintext.count) else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+        let segmentCount = self.segmentCount(plaintextByteCount: plaintext.count)
+        guard segmentCount <= Self.maximumSegmentCount else {
+            throw _SegmentedAEADError.messageTooLong
+        }
+
+        let header = Header(algorithm: self.algorithm, segmentByteCount: self.segmentByteCount)
+        header.write(into: UnsafeMutableRawBufferPointer(rebasing: output[..<Self.headerByteCount]))
+        let session = try Session(aead: self, header: header, authenticatedData: authenticatedData)
+
+        let body = UnsafeMutableRawBufferPointer(rebasing: output[Self.headerByteCount...])
+        try Self.forEachSegment(segmentCount, concurrently: concurrently) { index in
+            let start = index * self.segmentByteCount
+            let end = min(start + self.segmentByteCount, plaintext.count)
+            let sealedStart = index * self.sealedSegmentByteCount
+            try session.seal(
+                segment: index,
+                isLast: index == segmentCount - 1,
+                UnsafeRawBufferPointer(rebasing: plaintext[start..<end]),
+                into: UnsafeMutableRawBufferPointer(rebasing: body[sealedStart..<(sealedStart + end - start + Self.tagByteCount)])
+            )
+        }
+    }
+
+    /// Seals a whole plaintext.
+    ///
+    /// - Parameters:
+    ///   - plaintext: The data to encrypt.
+    ///   - authenticatedData: Data to authenticate along with the plaintext. The same data must be given to open it.
+    ///   - concurrently: Whether to seal the segments concurrently across all available cores.
+    /// - Returns: The header followed by the sealed segments.
+    public func seal<Plaintext: DataProtocol, AuthenticatedData: DataProtocol>(
+        _ plaintext: Plaintext,
+        authenticating authenticatedData: AuthenticatedData,
+        concurrently: Bool = false
+    ) throws -> Data {
+        let plaintext = Array(plaintext)
+        var ciphertext = Data(count: self.ciphertextByteCount(plaintextByteCount: plaintext.count))
+        try plaintext.withUnsafeBytes { plaintext in
+            try ciphertext.withUnsafeMutableBytes { output in
+                try self.seal(plaintext, into: output, authenticating: authenticatedData, concurrently: concurrently)
+            }
+        }
+        return ciphertext
+    }
+
+    /// Opens a whole ciphertext into a caller-provided buffer.
+    ///
+    /// - Parameters:
+    ///   - ciphertext: The header followed by the sealed segments.
+    ///   - output: The buffer to write the plaintext into. Must be exactly ``plaintextByteCount(ciphertextByteCount:)``
+    ///     bytes.
+    ///   - authenticatedData: The data that was authenticated when the plaintext was sealed.
+    ///   - concurrently: Whether to open the segments concurrently across all available cores.
+    /// - Throws: If any segment fails to authenticate, `output` is zeroed.
+    public func open<AuthenticatedData: DataProtocol>(
+        _ ciphertext: UnsafeRawBufferPointer,
+        into output: UnsafeMutableRawBufferPointer,
+        authenticating authenticatedData: AuthenticatedData,
+        concurrently: Bool = false
+    ) throws {
+        guard output.count == (try self.plaintextByteCount(ciphertextByteCount: ciphertext.count)) else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+        do {
+            try self.open(ciphertext, plaintextRange: 0..<output.count, into: output, authenticating: authenticatedData, concurrently: concurrently)
+        } catch {
+            output.initializeMemory(as: UInt8.self, repeating: 0)
+            throw error
+        }
+    }
+
+    /// Opens a whole ciphertext.
+    ///
+    /// - Parameters:
+    ///   - ciphertext: The header followed by the sealed segments.
+    ///   - authenticatedData: The data that was authenticated when the plaintext was sealed.
+    ///   - concurrently: Whether to open the segments concurrently across all available cores.
+    /// - Returns: The plaintext.
+    public func open<Ciphertext: DataProtocol, AuthenticatedData: DataProtocol>(
+        _ ciphertext: Ciphertext,
+        authenticating authenticatedData: AuthenticatedData,
+        concurrently: Bool = false
+    ) throws -> Data {
+        let ciphertext = Array(ciphertext)
+        var plaintext = Data(count: try self.plaintextByteCount(ciphertextByteCount: ciphertext.count))
+        try ciphertext.withUnsafeBytes { ciphertext in
+            try plaintext.withUnsafeMutableBytes { output in
+                try self.open(ciphertext, into: output, authenticating: authenticatedData, concurrently: concurrently)
+            }
+        }
+        return plaintext
+    }
+
+    // MARK: - Random access
+
+    /// Decrypts one byte range of the plaintext, opening only the segments that it covers.
+    ///
+    /// This suits ciphertexts in memory-mapped files, where only the pages of the segments that are opened are read.
+    ///
+    /// - Parameters:
+    ///   - ciphertext: The whole ciphertext, header included.
+    ///   - range: The range of plaintext bytes to decrypt.
+    ///   - authenticatedData: The data that was authenticated when the plaintext was sealed.
+    /// - Returns: The plaintext bytes in `range`.
+    /// - Throws: ``_SegmentedAEADError/invalidRange`` if `range` extends past the end of the plaintext.
+    public func open<AuthenticatedData: DataProtocol>(
+        _ ciphertext: UnsafeRawBufferPointer,
+        range: Range<Int>,
+        authenticating authenticatedData: AuthenticatedData
+    ) throws -> Data {
+        guard range.lowerBound >= 0, range.upperBound <= (try self.plaintextByteCount(ciphertextByteCount: ciphertext.count)) else {
+            throw _SegmentedAEADError.invalidRange
+        }
+        var plaintext = Data(count: range.count)
+        try plaintext.withUnsafeMutableBytes { output in
+            try self.open(ciphertext, plaintextRange: range, into: output, authenticating: authenticatedData, concurrently: false)
+        }
+        return plaintext
+    }
+
+    /// Opens the segments covering `plaintextRange`, which has been checked against the ciphertext, and copies that
+    /// range of their plaintext into `output`.
+    private func open<AuthenticatedData: DataProtocol>(
+        _ ciphertext: UnsafeRawBufferPointer,
+        plaintextRange: Range<Int>,
+        into output: UnsafeMutableRawBufferPointer,
+        authenticating authenticatedData: AuthenticatedData,
+        concurrently: Bool
+    ) throws {
+        let header = try Header(parsing: UnsafeRawBufferPointer(rebasing: ciphertext[..<Self.headerByteCount]), for: self)
+        let session = try Session(aead: self, header: header, authenticatedData: authenticatedData)
+        let body = UnsafeRawBufferPointer(rebasing: ciphertext[Self.headerByteCount...])
+        let segmentCount = try self.segmentCount(bodyByteCount: body.count)
+
+        // An empty range still opens a segment, so that the key and header are authenticated.
+        let firstSegment = min(plaintextRange.lowerBound / self.segmentByteCount, segmentCount - 1)
+        let lastSegment = max(firstSegment, (plaintextRange.upperBound - 1) / self.segmentByteCount)
+        try Self.forEachSegment(lastSegment - firstSegment + 1, concurrently: concurrently) { offset in
+            let index = firstSegment + offset
+            let sealedStart = index * self.sealedSegmentByteCount
+            let sealedEnd = min(sealedStart + self.sealedSegmentByteCount, body.count)
+
+            // Opening works in place, and the ciphertext may be read-only, so each segment is opened in a copy.
+            var scratch = [UInt8](UnsafeRawBufferPointer(rebasing: body[sealedStart..<sealedEnd]))
+            try scratch.withUnsafeMutableBytes { scratch in
+                let segment = try session.open(segment: index, isLast: index == segmentCount - 1, inPlace: scratch)
+
+                let segmentStart = index * self.segmentByteCount
+                let copyStart = max(plaintextRange.lowerBound, segmentStart)
+                let copyEnd = min(plaintextRange.upperBound, segmentStart + segment.count)
+                if copyStart < copyEnd {
+                    UnsafeMutableRawBufferPointer(rebasing: output[(copyStart - plaintextRange.lowerBound)...])
+                        .copyMemory(from: UnsafeRawBufferPointer(rebasing: segment[(copyStart - segmentStart)..<(copyEnd - segmentStart)]))
+                }
+            }
+        }
+    }
+
+    private static func forEachSegment(_ count: Int, concurrently: Bool, _ body: (Int) throws -> Void) throws {
+        guard concurrently && count > 1 else {
+            try (0..<count).forEach(body)
+            return
+        }
+
+        let lock = NSLock()
+        var firstError: Error?
+        DispatchQueue.concurrentPerform(iterations: count) { index in
+            do {
+                try body(index)
+            } catch {
+                lock.lock()
+                defer {
+                    lock.unlock()
+                }
+                firstError = firstError ?? error
+            }
+        }
+        if let firstError = firstError {
+            throw firstError
+        }
+    }
+
+    // MARK: - Streams
+
+    /// Makes an encryptor that seals a plaintext arriving in pieces.
+    ///
+    /// - Parameter authenticatedData: Data to authenticate along with the plaintext.
+    public func makeEncryptor<AuthenticatedData: DataProtocol>(authenticating authenticatedData: AuthenticatedData) throws -> Encryptor {
+        try Encryptor(aead: self, authenticatedData: authenticatedData)
+    }
+
+    /// Makes a decryptor that opens a ciphertext arriving in pieces.
+    ///
+    /// - Parameter authenticatedData: The data that was authenticated when the plaintext was sealed.
+    public func makeDecryptor<AuthenticatedData: DataProtocol>(authenticating authenticatedData: AuthenticatedData) -> Decryptor {
+        Decryptor(aead: self, authenticatedData: Array(authenticatedData))
+    }
+
+    /// Seals a plaintext that arrives in pieces, holding at most one segment of it at a time.
+    ///
+    /// Write ``header`` first, then the output of every call to ``update(_:)``, then the output of ``finish()``.
+    public struct Encryptor {
+        /// The header of the ciphertext.
+        public let header: Data
+
+        private let aead: _SegmentedAEAD
+
+        private let session: Session
+
+        private var pending: [UInt8] = []
+
+        private var nextSegment = 0
+
+        private var finished = false
+
+        fileprivate init<AuthenticatedData: DataProtocol>(aead: _SegmentedAEAD, authenticatedData: AuthenticatedData) throws {
+            let header = Header(algorithm: aead.algorithm, segmentByteCount: aead.segmentByteCount)
+            self.aead = aead
+            self.header = header.bytes
+            self.session = try Session(aead: aead, header: header, authenticatedData: authenticatedData)
+        }
+
+        /// Adds more plaintext.
+        ///
+        /// - Returns: The ciphertext of any segments that are now complete.
+        public mutating func update<Plaintext: DataProtocol>(_ plaintext: Plaintext) throws -> Data {
+            guard !self.finished else {
+                throw _SegmentedAEADError.alreadyFinished
+            }
+            self.pending.append(contentsOf: plaintext)
+
+            // A full segment can only be sealed once more data shows that it isn't the last.
+            let segmentByteCount = self.aead.segmentByteCount
+            let readySegments = (self.pending.count - 1) / segmentByteCount
+            guard readySegments > 0 else {
+                return Data()
+            }
+            let sealedSegmentByteCount = self.aead.sealedSegmentByteCount
+            let session = self.session
+            let firstSegment = try self.segmentIndex(offset: readySegments - 1) - (readySegments - 1)
+            var output = Data(count: readySegments * sealedSegmentByteCount)
+            try self.pending.withUnsafeBytes { pending in
+                try output.withUnsafeMutableBytes { output in
+                    for segment in 0..<readySegments {
+                        let sealedStart = segment * sealedSegmentByteCount
+                        try session.seal(
+                            segment: firstSegment + segment,
+                            isLast: false,
+                            UnsafeRawBufferPointer(rebasing: pending[(segment * segmentByteCount)..<((segment + 1) * segmentByteCount)]),
+                            into: UnsafeMutableRawBufferPointer(rebasing: output[sealedStart..<(sealedStart + sealedSegmentByteCount)])
+                        )
+                    }
+                }
+            }
+            self.pending.removeFirst(readySegments * segmentByteCount)
+            self.nextSegment += readySegments
+            return output
+        }
+
+        /// Seals the last segment.
+        ///
+        /// - Returns: The ciphertext of the last segment.
+        public mutating func finish() throws -> Data {
+            guard !self.finished else {
+                throw _SegmentedAEADError.alreadyFinished
+            }
+            var output = Data(count: self.pending.count + _SegmentedAEAD.tagByteCount)
+            let session = self.session
+            let segment = try self.segmentIndex(offset: 0)
+            try self.pending.withUnsafeBytes { pending in
+                try output.withUnsafeMutableBytes { output in
+                    try session.seal(segment: segment, isLast: true, pending, into: output)
+                }
+            }
+            self.pending = []
+            self.finished = true
+            return output
+        }
+
+        private func segmentIndex(offset: Int) throws -> Int {
+            guard self.nextSegment + offset < _SegmentedAEAD.maximumSegmentCount else {
+                throw _SegmentedAEADError.messageTooLong
+            }
+            return self.nextSegment + offset
+        }
+    }
+
+    /// Opens a ciphertext that arrives in pieces, holding at most about two segments of it at a time.
+    ///
+    /// Plaintext is only returned once its segment has been authenticated. Nothing returned before ``finish()``
+    /// succeeds is known to be the whole message, so callers must not act on a stream that fails to finish.
+    public struct Decryptor {
+        private let aead: _SegmentedAEAD
+
+        private let authenticatedData: [UInt8]
+
+        private var session: Session?
+
+        private var pending: [UInt8] = []
+
+        private var nextSegment = 0
+
+        private var finished = false
+
+        fileprivate init(aead: _SegmentedAEAD, authenticatedData: [UInt8]) {
+            self.aead = aead
+            self.authenticatedData = authenticatedData
+        }
+
+        /// Adds more ciphertext, starting with the header.
+        ///
+        /// - Returns: The plaintext of any segments that are now complete and authenticated.
+        public mutating func update<Ciphertext: DataProtocol>(_ ciphertext: Ciphertext) throws -> Data {
+            guard !self.finished else {
+                throw _SegmentedAEADError.alreadyFinished
+            }
+            self.pending.append(contentsOf: ciphertext)
+
+            if self.session == nil {
+                guard self.pending.count >= _SegmentedAEAD.headerByteCount else {
+                    return Data()
+                }
+                let header = try self.pending.withUnsafeBytes {
+                    try Header(parsing: UnsafeRawBufferPointer(rebasing: $0[..<_SegmentedAEAD.headerByteCount]), for: self.aead)
+                }
+                self.session = try Session(aead: self.aead, header: header, authenticatedData: self.authenticatedData)
+                self.pending.removeFirst(_SegmentedAEAD.headerByteCount)
+            }
+
+            // As when sealing, a full segment may turn out to be the last until more data arrives.
+            let sealedSegmentByteCount = self.aead.sealedSegmentByteCount
+            let readySegments = self.pending.isEmpty ? 0 : (self.pending.count - 1) / sealedSegmentByteCount
+            guard readySegments > 0 else {
+                return Data()
+            }
+            let segmentByteCount = self.aead.segmentByteCount
+            let session = self.session!
+            let firstSegment = try self.segmentIndex(offset: readySegments - 1) - (readySegments - 1)
+            var output = Data(count: readySegments * segmentByteCount)
+            try self.pending.withUnsafeMutableBytes { pending in
+                try output.withUnsafeMutableBytes { output in
+                    for segment in 0..<readySegments {
+                        let sealedStart = segment * sealedSegmentByteCount
+                        let opened = try session.open(
+                            segment: firstSegment + segment,
+                            isLast: false,
+                            inPlace: UnsafeMutableRawBufferPointer(rebasing: pending[sealedStart..<(sealedStart + sealedSegmentByteCount)])
+                        )
+                        UnsafeMutableRawBufferPointer(rebasing: output[(segment * segmentByteCount)...])
+                            .copyMemory(from: UnsafeRawBufferPointer(opened))
+                    }
+                }
+            }
+            self.pending.removeFirst(readySegments * sealedSegmentByteCount)
+            self.nextSegment += readySegments
+            return output
+        }
+
+        /// Opens the last segment, checking that the ciphertext wasn't truncated.
+        ///
+        /// - Returns: The plaintext of the last segment.
+        public mutating func finish() throws -> Data {
+            guard !self.finished else {
+                throw _SegmentedAEADError.alreadyFinished
+            }
+            guard let session = self.session else {
+                throw _SegmentedAEADError.invalidHeader
+            }
+            guard self.pending.count >= _SegmentedAEAD.tagByteCount else {
+                throw _SegmentedAEADError.invalidCiphertextLength
+            }
+            let segment = try self.segmentIndex(offset: 0)
+            let plaintext = try self.pending.withUnsafeMutableBytes { pending in
+                Data(try session.open(segment: segment, isLast: true, inPlace: pending))
+            }
+            self.pending = []
+            self.finished = true
+            return plaintext
+        }
+
+        private func segmentIndex(offset: Int) throws -> Int {
+            guard self.nextSegment + offset < _SegmentedAEAD.maximumSegmentCount else {
+                throw _SegmentedAEADError.messageTooLong
+            }
+            return self.nextSegment + offset
+        }
+    }
+}
+
+extension _SegmentedAEAD {
+    fileprivate struct Header {
+        var algorithm: Algorithm
+
+        var segmentByteCount: Int
+
+        var salt: [UInt8]
+
+        var noncePrefix: [UInt8]
+
+        /// A header with a fresh random salt and nonce prefix.
+        init(algorithm: Algorithm, segmentByteCount: Int) {
+            self.algorithm = algorithm
+            self.segmentByteCount = segmentByteCount
+            var random = [UInt8](repeating: 0, count: _SegmentedAEAD.saltByteCount + _SegmentedAEAD.noncePrefixByteCount)
+            random.withUnsafeMutableBytes { $0.initializeWithRandomBytes(count: $0.count) }
+            self.salt = Array(random.prefix(_SegmentedAEAD.saltByteCount))
+            self.noncePrefix = Array(random.suffix(_SegmentedAEAD.noncePrefixByteCount))
+        }
+
+        /// Parses a header, checking that it was written by `aead`'s configuration.
+        init(parsing bytes: UnsafeRawBufferPointer, for aead: _SegmentedAEAD) throws {
+            guard bytes.count == _SegmentedAEAD.headerByteCount,
+                  bytes[0] == _SegmentedAEAD.version,
+                  bytes[1] == aead.algorithm.rawValue,
+                  bytes[2..<6].reduce(0, { $0 << 8 | Int($1) }) == aead.segmentByteCount else {
+                throw _SegmentedAEADError.invalidHeader
+            }
+            self.algorithm = aead.algorithm
+            self.segmentByteCount = aead.segmentByteCount
+            self.salt = Array(bytes[6..<(6 + _SegmentedAEAD.saltByteCount)])
+            self.noncePrefix = Array(bytes[(6 + _SegmentedAEAD.saltByteCount)...])
+        }
+
+        var bytes: Data {
+            var bytes = Data([_SegmentedAEAD.version, self.algorithm.rawValue])
+            bytes.append(contentsOf: (0..<4).reversed().map { UInt8(truncatingIfNeeded: self.segmentByteCount >> ($0 * 8)) })
+            bytes.append(contentsOf: self.salt)
+            bytes.append(contentsOf: self.noncePrefix)
+            return bytes
+        }
+
+        func write(into output: UnsafeMutableRawBufferPointer) {
+            output.copyBytes(from: self.bytes)
+        }
+    }
+
+    /// The segment key and nonce prefix of one message.
+    fileprivate struct Session {
+        private enum SegmentKey {
+            case aesGCM(AES.GCM._PreparedKey)
+            case chaChaPoly(ChaChaPoly._PreparedKey)
+        }
+
+        private let key: SegmentKey
+
+        private let noncePrefix: [UInt8]
+
+        init<AuthenticatedData: DataProtocol>(aead: _SegmentedAEAD, header: Header, authenticatedData: AuthenticatedData) throws {
+            var info = Array("swift-crypto segmented AEAD".utf8)
+            info.append(contentsOf: header.bytes.prefix(6))
+            info.append(contentsOf: authenticatedData)
+            let segmentKey = HKDF<SHA256>.deriveKey(inputKeyMaterial: aead.key, salt: header.salt, info: info, outputByteCount: 32)
+            switch aead.algorithm {
+            case .aesGCM:
+                self.key = .aesGCM(try AES.GCM._PreparedKey(segmentKey))
+            case .chaChaPoly:
+                self.key = .chaChaPoly(try ChaChaPoly._PreparedKey(segmentKey))
+            }
+            self.noncePrefix = header.noncePrefix
+        }
+
+        private func nonce(segment: Int, isLast: Bool) -> [UInt8] {
+            var nonce = self.noncePrefix
+            nonce.append(contentsOf: (0..<4).reversed().map { UInt8(truncatingIfNeeded: segment >> ($0 * 8)) })
+            nonce.append(isLast ? 1 : 0)
+            return nonce
+        }
+
+        func seal(segment: Int, isLast: Bool, _ plaintext: UnsafeRawBufferPointer, into output: UnsafeMutableRawBufferPointer) throws {
+            let nonce = self.nonce(segment: segment, isLast: isLast)
+            switch self.key {
+            case .aesGCM(let key):
+                try key.seal(plaintext, into: output, nonce: AES.GCM.Nonce(data: nonce), authenticating: [UInt8]())
+            case .chaChaPoly(let key):
+                try key.seal(plaintext, into: output, nonce: ChaChaPoly.Nonce(data: nonce), authenticating: [UInt8]())
+            }
+        }
+
+        func open(segment: Int, isLast: Bool, inPlace buffer: UnsafeMutableRawBufferPointer) throws -> UnsafeMutableRawBufferPointer {
+            let nonce = self.nonce(segment: segment, isLast: isLast)
+            switch self.key {
+            case .aesGCM(let key):
+                return try key.open(inPlace: buffer, nonce: AES.GCM.Nonce(data: nonce), authenticating: [UInt8]())
+            case .chaChaPoly(let key):
+                return try key.open(inPlace: buffer, nonce: ChaChaPoly.Nonce(data: nonce), authenticating: [UInt8]())
+            }
+        }
+    }
+}
@@ -21,17 +21,6 @@ extension AES {
     public enum _CBC {
         private static var blockSize: Int { 16 }
 
-        private static func encryptBlockInPlace(
-            _ plaintext: inout Block,
-            priorCiphertextBlock: Block,
-            using key: SymmetricKey
-        ) throws {
-            assert([128, 192, 256].contains(key.bitCount))
-
-            plaintext ^= priorCiphertextBlock
-            try AES.permute(&plaintext, key: key)
-        }
-
         /// Encrypts data using AES-CBC.
         ///
         /// - Parameters:
@@ -64,36 +53,19 @@ extension AES {
                 throw CryptoKitError.incorrectParameterSize
             }
 
-            var ciphertext = Data()
-            ciphertext.reserveCapacity(plaintext.count + Self.blockSize)  // Room for padding.
-
-            var previousBlock = Block(iv)
-            var plaintext = plaintext[...]
+            let paddingByteCount = noPadding ? 0 : Self.blockSize - (plaintext.count % Self.blockSize)
 
-            while plaintext.count > 0 {
-                var block = Block(blockBytes: plaintext.prefix(Self.blockSize))
-                try Self.encryptBlockInPlace(&block, priorCiphertextBlock: previousBlock, using: key)
-                ciphertext.append(contentsOf: block)
-                previousBlock = block
-                plaintext = plaintext.dropFirst(Self.blockSize)
-            }
+            var ciphertext = Data()
+            ciphertext.reserveCapacity(plaintext.count + paddingByteCount)
+            ciphertext.append(contentsOf: plaintext)
+            ciphertext.append(contentsOf: repeatElement(UInt8(truncatingIfNeeded: paddingByteCount), count: paddingByteCount))
 
-            if requiresFullPaddingBlock && !noPadding {
-                var block = Block.paddingBlock
-                try Self.encryptBlockInPlace(&block, priorCiphertextBlock: previousBlock, using: key)
-                ciphertext.append(contentsOf: block)
+            ciphertext.withUnsafeMutableBytes { ciphertextPtr in
+                OpenSSLAESCBCImpl.encrypt(inPlace: ciphertextPtr, using: key, iv: iv)
             }
-
             return ciphertext
         }
 
-        private static func decryptBlockInPlace(_ ciphertext: inout Block, priorCiphertextBlock: Block, using key: SymmetricKey) throws {
-            assert([128, 192, 256].contains(key.bitCount))
-
-            try AES.inversePermute(&ciphertext, key: key)
-            ciphertext ^= priorCiphertextBlock
-        }
-
         /// Decrypts data using AES-CBC.
         ///
         /// - Parameters:
@@ -118,19 +90,13 @@ extension AES {
                 throw CryptoKitError.incorrectKeySize
             }
 
-            var plaintext = Data()
-            plaintext.reserveCapacity(ciphertext.count)
-
-            var previousBlock = Block(iv)
-            var ciphertext = ciphertext[...]
+            guard ciphertext.count % Self.blockSize == 0 else {
+                throw CryptoKitError.incorrectParameterSize
+            }
 
-            while ciphertext.count > 0 {
-                let ctBlock = Block(blockBytes: ciphertext.prefix(Self.blockSize))
-                var block = ctBlock
-                try Self.decryptBlockInPlace(&block, priorCiphertextBlock: previousBlock, using: key)
-                plaintext.append(contentsOf: block)
-                previousBlock = ctBlock
-                ciphertext = ciphertext.dropFirst(Self.blockSize)
+            var plaintext = Data(ciphertext)
+            plaintext.withUnsafeMutableBytes { plaintextPtr in
+                OpenSSLAESCBCImpl.decrypt(inPlace: plaintextPtr, using: key, iv: iv)
             }
 
             if !noPadding {
@@ -0,0 +1,253 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+extension AES {
+    /// AES in CCM mode (RFC 3610, NIST SP 800-38C), as used by Bluetooth LE, Matter, Zigbee and IEEE 802.15.4.
+    ///
+    /// CCM authenticates with a CBC-MAC over the plaintext and encrypts with CTR mode. On CPUs with AES instructions
+    /// the two block streams go through the cipher together in one loop, so the keystream costs little on top of
+    /// the MAC's serial chain.
+    ///
+    /// The nonce is between 7 and 13 bytes. A shorter nonce allows a longer message: the message length must fit in
+    /// 15 minus the nonce length bytes. The tag is an even number of bytes from 4 to 16.
+    public enum _CCM {
+        static let defaultNonceByteCount = 13
+        static let nonceByteCounts = 7...13
+
+        /// Encrypts and authenticates data using AES-CCM.
+        ///
+        /// - Parameters:
+        ///   - message: The message to encrypt and authenticate.
+        ///   - key: An encryption key of 128, 192, or 256 bits.
+        ///   - nonce: A nonce for AES-CCM. It must be unique for every use of the key. If `nil`, a random 13-byte
+        ///     nonce is generated.
+        ///   - authenticatedData: Data to authenticate as part of the seal.
+        ///   - tagByteCount: The length of the tag: 4, 6, 8, 10, 12, 14, or 16 bytes.
+        /// - Returns: A sealed box containing the nonce, ciphertext, and tag.
+        public static func seal<Plaintext: DataProtocol, AuthenticatedData: DataProtocol>(
+            _ message: Plaintext,
+            using key: SymmetricKey,
+            nonce: Nonce? = nil,
+            authenticating authenticatedData: AuthenticatedData,
+            tagByteCount: Int = 16
+        ) throws -> SealedBox {
+            try PreparedKey(key).seal(message, nonce: nonce, authenticating: authenticatedData, tagByteCount: tagByteCount)
+        }
+
+        /// Encrypts and authenticates data using AES-CCM.
+        ///
+        /// - Parameters:
+        ///   - message: The message to encrypt and authenticate.
+        ///   - key: An encryption key of 128, 192, or 256 bits.
+        ///   - nonce: A nonce for AES-CCM. It must be unique for every use of the key. If `nil`, a random 13-byte
+        ///     nonce is generated.
+        ///   - tagByteCount: The length of the tag: 4, 6, 8, 10, 12, 14, or 16 bytes.
+        /// - Returns: A sealed box containing the nonce, ciphertext, and tag.
+        public static func seal<Plaintext: DataProtocol>(
+            _ message: Plaintext,
+            using key: SymmetricKey,
+            nonce: Nonce? = nil,
+            tagByteCount: Int = 16
+        ) throws -> SealedBox {
+            try PreparedKey(key).seal(message, nonce: nonce, authenticating: Data(), tagByteCount: tagByteCount)
+        }
+
+        /// Authenticates and decrypts data using AES-CCM.
+        ///
+        /// - Parameters:
+        ///   - sealedBox: The sealed box to authenticate and decrypt.
+        ///   - key: An encryption key of 128, 192, or 256 bits.
+        ///   - authenticatedData: Data that was authenticated as part of the seal.
+        /// - Returns: The plaintext if opening was successful.
+        /// - Throws: `CryptoKitError.authenticationFailure` if the tag does not match.
+        public static func open<AuthenticatedData: DataProtocol>(
+            _ sealedBox: SealedBox,
+            using key: SymmetricKey,
+            authenticating authenticatedData: AuthenticatedData
+        ) throws -> Data {
+            try PreparedKey(key).open(sealedBox, authenticating: authenticatedData)
+        }
+
+        /// Authenticates and decrypts data using AES-CCM.
+        ///
+        /// - Parameters:
+        ///   - sealedBox: The sealed box to authenticate and decrypt.
+        ///   - key: An encryption key of 128, 192, or 256 bits.
+        /// - Returns: The plaintext if opening was successful.
+        /// - Throws: `CryptoKitError.authenticationFailure` if the tag does not match.
+        public static func open(_ sealedBox: SealedBox, using key: SymmetricKey) throws -> Data {
+            try PreparedKey(key).open(sealedBox, authenticating: Data())
+        }
+    }
+}
+
+extension AES._CCM {
+    /// An AES-CCM key whose key schedule has been expanded once, for protocols that seal and open many short
+    /// frames under one key.
+    ///
+    /// Prepared keys are immutable and may be shared freely between threads.
+    public struct PreparedKey {
+        private let backing: OpenSSLAESCCMKey
+
+        /// Prepares a key for repeated AES-CCM operations.
+        ///
+        /// - Parameter key: An encryption key of 128, 192, or 256 bits.
+        public init(_ key: SymmetricKey) throws {
+            self.backing = try OpenSSLAESCCMKey(key)
+        }
+
+        /// Encrypts and authenticates data using AES-CCM.
+        ///
+        /// - Parameters:
+        ///   - message: The message to encrypt and authenticate.
+        ///   - nonce: A nonce for AES-CCM. It must be unique for every use of the key. If `nil`, a random 13-byte
+        ///     nonce is generated.
+        ///   - authenticatedData: Data to authenticate as part of the seal.
+        ///   - tagByteCount: The length of the tag: 4, 6, 8, 10, 12, 14, or 16 bytes.
+        /// - Returns: A sealed box containing the nonce, ciphertext, and tag.
+        public func seal<Plaintext: DataProtocol, AuthenticatedData: DataProtocol>(
+            _ message: Plaintext,
+            nonce: AES._CCM.Nonce? = nil,
+            authenticating authenticatedData: AuthenticatedData,
+            tagByteCount: Int = 16
+        ) throws -> AES._CCM.SealedBox {
+            try self.backing.seal(
+                message,
+                nonce: nonce ?? AES._CCM.Nonce(),
+                authenticatedData: authenticatedData,
+                tagByteCount: tagByteCount
+            )
+        }
+
+        /// Encrypts and authenticates data using AES-CCM.
+        ///
+        /// - Parameters:
+        ///   - message: The message to encrypt and authenticate.
+        ///   - nonce: A nonce for AES-CCM. It must be unique for every use of the key. If `nil`, a random 13-byte
+        ///     nonce is generated.
+        ///   - tagByteCount: The length of the tag: 4, 6, 8, 10, 12, 14, or 16 bytes.
+        /// - Returns: A sealed box containing the nonce, ciphertext, and tag.
+        public func seal<Plaintext: DataProtocol>(
+            _ message: Plaintext,
+            nonce: AES._CCM.Nonce? = nil,
+            tagByteCount: Int = 16
+        ) throws -> AES._CCM.SealedBox {
+            try self.seal(message, nonce: nonce, authenticating: Data(), tagByteCount: tagByteCount)
+        }
+
+        /// Authenticates and decrypts data using AES-CCM.
+        ///
+        /// - Parameters:
+        ///   - sealedBox: The sealed box to authenticate and decrypt.
+        ///   - authenticatedData: Data that was authenticated as part of the seal.
+        /// - Returns: The plaintext if opening was successful.
+        /// - Throws: `CryptoKitError.authenticationFailure` if the tag does not match.
+        public func open<AuthenticatedData: DataProtocol>(
+            _ sealedBox: AES._CCM.SealedBox,
+            authenticating authenticatedData: AuthenticatedData
+        ) throws -> Data {
+            try self.backing.open(sealedBox, authenticatedData: authenticatedData)
+        }
+
+        /// Authenticates and decrypts data using AES-CCM.
+        ///
+        /// - Parameter sealedBox: The sealed box to authenticate and decrypt.
+        /// - Returns: The plaintext if opening was successful.
+        /// - Throws: `CryptoKitError.authenticationFailure` if the tag does not match.
+        public func open(_ sealedBox: AES._CCM.SealedBox) throws -> Data {
+            try self.open(sealedBox, authenticating: Data())
+        }
+    }
+}
+
+extension AES._CCM {
+    public struct Nonce: Sendable, ContiguousBytes, Sequence {
+        let bytes: Data
+
+        /// Generates a fresh random 13-byte nonce. Unless required by a specification to provide a specific nonce,
+        /// this is the recommended initializer.
+        public init() {
+            var data = Data(repeating: 0, count: AES._CCM.defaultNonceByteCount)
+            data.withUnsafeMutableBytes {
+                $0.initializeWithRandomBytes(count: AES._CCM.defaultNonceByteCount)
+            }
+            self.bytes = data
+        }
+
+        /// Creates a nonce from 7 to 13 bytes of data.
+        public init<D: DataProtocol>(data: D) throws {
+            guard AES._CCM.nonceByteCounts.contains(data.count) else {
+                throw CryptoKitError.incorrectParameterSize
+            }
+
+            self.bytes = Data(data)
+        }
+
+        public func withUnsafeBytes<R>(_ body: (UnsafeRawBufferPointer) throws -> R) rethrows -> R {
+            return try self.bytes.withUnsafeBytes(body)
+        }
+
+        public func makeIterator() -> Array<UInt8>.Iterator {
+            self.withUnsafeBytes({ (buffPtr) in
+                return Array(buffPtr).makeIterator()
+            })
+        }
+    }
+}
+
+extension AES._CCM {
+    /// A sealed box holding the nonce, ciphertext, and tag of an AES-CCM message.
+    ///
+    /// CCM nonces and tags vary in length between protocols, so there is no single combined representation. The
+    /// parts are kept separately, and the protocol's framing decides how they are laid out on the wire.
+    public struct SealedBox: Sendable {
+        /// The nonce.
+        public let nonce: AES._CCM.Nonce
+        /// The ciphertext.
+        public let ciphertext: Data
+        /// The authentication tag.
+        public let tag: Data
+
+        /// The combined representation (nonce || ciphertext || tag).
+        public var combined: Data {
+            self.nonce.bytes + self.ciphertext + self.tag
+        }
+
+        public init<C: DataProtocol, T: DataProtocol>(nonce: AES._CCM.Nonce, ciphertext: C, tag: T) throws {
+            guard tag.count >= 4, tag.count <= 16, tag.count % 2 == 0 else {
+                throw CryptoKitError.incorrectParameterSize
+            }
+
+            self.nonce = nonce
+            self.ciphertext = Data(ciphertext)
+            self.tag = Data(tag)
+        }
+
+        /// Splits a combined representation (nonce || ciphertext || tag) whose nonce and tag lengths are known.
+        public init<D: DataProtocol>(combined: D, nonceByteCount: Int = 13, tagByteCount: Int = 16) throws {
+            guard combined.count >= nonceByteCount + tagByteCount else {
+                throw CryptoKitError.incorrectParameterSize
+            }
+            let bytes = Data(combined)
+            try self.init(
+                nonce: AES._CCM.Nonce(data: bytes.prefix(nonceByteCount)),
+                ciphertext: bytes.dropFirst(nonceByteCount).dropLast(tagByteCount),
+                tag: bytes.suffix(tagByteCount)
+            )
+        }
+    }
+}
@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+
+extension AES._CTR {
+    /// An AES-CTR keystream that is applied across several calls.
+    ///
+    /// ``AES/_CTR/encrypt(_:using:nonce:)`` expands the AES key schedule and starts the counter afresh on every
+    /// call. A stream expands the key once and carries the counter, and any unused keystream from a partial block,
+    /// from one call to the next, so a message can be processed in chunks of any size. Encrypting a message in
+    /// pieces produces the same output as encrypting it in one go.
+    ///
+    /// A stream has reference semantics: it is a single position in a single keystream, and never yields the same
+    /// keystream twice. It is not safe to use from multiple threads at once.
+    public final class _Stream {
+        private let backing: OpenSSLAESCTRStream
+
+        /// Starts a keystream.
+        ///
+        /// - Parameters:
+        ///   - key: An encryption key of 128, 192, or 256 bits.
+        ///   - nonce: The initial counter block.
+        public init(key: SymmetricKey, nonce: AES._CTR.Nonce) throws {
+            self.backing = try OpenSSLAESCTRStream(key: key, nonce: nonce)
+        }
+
+        /// Encrypts the next chunk of a message.
+        ///
+        /// - Parameter message: The next bytes of the message.
+        /// - Returns: The corresponding bytes of ciphertext.
+        public func encrypt<Plaintext: DataProtocol>(_ message: Plaintext) -> Data {
+            var output = Data(repeating: 0, count: message.count)
+            output.withUnsafeMutableBytes { outputPtr in
+                if let region = message.regions.first, message.regions.count == 1 {
+                    region.withUnsafeBytes { self.backing.apply($0, into: outputPtr) }
+                } else {
+                    Array(message).withUnsafeBytes { self.backing.apply($0, into: outputPtr) }
+                }
+            }
+            return output
+        }
+
+        /// Encrypts the next chunk of a message in place.
+        ///
+        /// - Parameter buffer: The next bytes of the message, which are replaced by the ciphertext.
+        public func encrypt(inPlace buffer: UnsafeMutableRawBufferPointer) {
+            self.backing.apply(UnsafeRawBufferPointer(buffer), into: buffer)
+        }
+
+        /// Decrypts the next chunk of a message.
+        ///
+        /// - Parameter ciphertext: The next bytes of the ciphertext.
+        /// - Returns: The corresponding bytes of plaintext.
+        public func decrypt<Ciphertext: DataProtocol>(_ ciphertext: Ciphertext) -> Data {
+            // CTR mode is symmetric in encryption/decryption.
+            self.encrypt(ciphertext)
+        }
+
+        /// Decrypts the next chunk of a message in place.
+        ///
+        /// - Parameter buffer: The next bytes of the ciphertext, which are replaced by the plaintext.
+        public func decrypt(inPlace buffer: UnsafeMutableRawBufferPointer) {
+            self.encrypt(inPlace: buffer)
+        }
+    }
+}
@@ -0,0 +1,80 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+extension AES.GCM._SIV {
+    /// An AES-GCM-SIV key that has already been set up for encryption and decryption.
+    ///
+    /// Every call to ``AES/GCM/_SIV/seal(_:using:nonce:authenticating:)`` initialises a fresh AEAD context, which
+    /// expands the AES key schedule that derives each message's keys. A prepared key does that once and keeps the
+    /// context, which suits workloads that seal many small messages under one long-lived key, such as
+    /// deterministic encryption of database columns.
+    ///
+    /// Prepared keys are immutable and may be shared freely between threads.
+    public struct _PreparedKey {
+        private let backing: OpenSSLAESGCMSIVPreparedKey
+
+        /// Prepares a symmetric key for repeated AES-GCM-SIV operations.
+        ///
+        /// - Parameter key: An encryption key of 128 or 256 bits.
+        public init(_ key: SymmetricKey) throws {
+            self.backing = try OpenSSLAESGCMSIVPreparedKey(key)
+        }
+
+        /// Encrypts and authenticates data using AES-GCM-SIV.
+        ///
+        /// - Parameters:
+        ///   - message: The message to encrypt and authenticate
+        ///   - nonce: An Nonce for AES-GCM-SIV encryption. If `nil`, a random nonce is generated.
+        ///   - authenticatedData: Data to authenticate as part of the seal
+        /// - Returns: A sealed box returning the authentication tag (seal) and the ciphertext
+        public func seal<Plaintext: DataProtocol, AuthenticatedData: DataProtocol>(
+            _ message: Plaintext,
+            nonce: Nonce? = nil,
+            authenticating authenticatedData: AuthenticatedData
+        ) throws -> SealedBox {
+            try self.backing.seal(message, nonce: nonce, authenticatedData: authenticatedData)
+        }
+
+        /// Encrypts and authenticates data using AES-GCM-SIV.
+        ///
+        /// - Parameters:
+        ///   - message: The message to encrypt and authenticate
+        ///   - nonce: An Nonce for AES-GCM-SIV encryption. If `nil`, a random nonce is generated.
+        /// - Returns: A sealed box returning the authentication tag (seal) and the ciphertext
+        public func seal<Plaintext: DataProtocol>(_ message: Plaintext, nonce: Nonce? = nil) throws -> SealedBox {
+            try self.backing.seal(message, nonce: nonce, authenticatedData: [UInt8]())
+        }
+
+        /// Authenticates and decrypts data using AES-GCM-SIV.
+        ///
+        /// - Parameters:
+        ///   - sealedBox: The sealed box to authenticate and decrypt
+        ///   - authenticatedData: Data that was authenticated as part of the seal
+        /// - Returns: The plaintext if opening was successful
+        public func open<AuthenticatedData: DataProtocol>(_ sealedBox: SealedBox, authenticating authenticatedData: AuthenticatedData) throws -> Data {
+            try self.backing.open(sealedBox, authenticatedData: authenticatedData)
+        }
+
+        /// Authenticates and decrypts data using AES-GCM-SIV.
+        ///
+        /// - Parameter sealedBox: The sealed box to authenticate and decrypt
+        /// - Returns: The plaintext if opening was successful
+        public func open(_ sealedBox: SealedBox) throws -> Data {
+            try self.backing.open(sealedBox, authenticatedData: [UInt8]())
+        }
+    }
+}
@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+extension AES.KeyWrap {
+    /// An AES key-encryption key that has already been expanded for wrapping and unwrapping.
+    ///
+    /// ``AES/KeyWrap/wrap(_:using:)`` and ``AES/KeyWrap/unwrap(_:using:)`` expand the AES key schedule on every call.
+    /// A prepared key does that once, which suits envelope encryption, where a single long-lived key-encryption key
+    /// protects many data keys.
+    ///
+    /// Each of the 6n steps of a key wrap depends on the one before it, so a single wrap keeps only one block in
+    /// flight. The batch methods interleave the steps of many wraps so that the block function is always handed
+    /// many independent blocks at once. Their output is identical to wrapping each key on its own.
+    ///
+    /// Prepared keys are immutable and may be shared freely between threads.
+    public struct _PreparedKey {
+        private let backing: OpenSSLAESKeyWrapPreparedKey
+
+        /// Prepares a key-encryption key for repeated AES key wrap operations.
+        ///
+        /// - Parameter kek: A key-encryption key of 128, 192, or 256 bits.
+        public init(_ kek: SymmetricKey) throws {
+            self.backing = try OpenSSLAESKeyWrapPreparedKey(kek)
+        }
+
+        /// Wraps a key using the AES wrap algorithm.
+        ///
+        /// - Parameter keyToWrap: The key to wrap. It must be at least 128 bits, and a multiple of 64 bits.
+        /// - Returns: The wrapped key.
+        public func wrap(_ keyToWrap: SymmetricKey) throws -> Data {
+            try self.backing.wrap(batch: [keyToWrap])[0]
+        }
+
+        /// Unwraps a key using the AES wrap algorithm.
+        ///
+        /// - Parameter wrappedKey: The key to unwrap.
+        /// - Returns: The unwrapped key.
+        public func unwrap<WrappedKey: DataProtocol>(_ wrappedKey: WrappedKey) throws -> SymmetricKey {
+            guard let key = self.backing.unwrap(batch: [Data(wrappedKey)])[0] else {
+                throw CryptoKitError.internalBoringSSLError()
+            }
+            return key
+        }
+
+        /// Wraps many keys using the AES wrap algorithm.
+        ///
+        /// - Parameter keysToWrap: The keys to wrap. Each must be at least 128 bits, and a multiple of 64 bits.
+        /// - Returns: The wrapped keys, in the same order as `keysToWrap`.
+        public func wrap(batch keysToWrap: [SymmetricKey]) throws -> [Data] {
+            try self.backing.wrap(batch: keysToWrap)
+        }
+
+        /// Unwraps many keys using the AES wrap algorithm.
+        ///
+        /// A key that fails its integrity check does not fail the rest of the batch.
+        ///
+        /// - Parameter wrappedKeys: The keys to unwrap.
+        /// - Returns: The unwrapped keys, in the same order as `wrappedKeys`, with `nil` for any key that could not
+        ///   be unwrapped.
+        public func unwrap<WrappedKey: DataProtocol>(batch wrappedKeys: [WrappedKey]) -> [SymmetricKey?] {
+            self.backing.unwrap(batch: wrappedKeys.map { Data($0) })
+        }
+    }
+}
@@ -0,0 +1,212 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+extension AES {
+    /// AES in XTS mode (IEEE 1619, NIST SP 800-38E), for encrypting storage a sector at a time.
+    ///
+    /// XTS encrypts each data unit, usually a disk sector, under a tweak derived from its position, so any sector
+    /// can be read or rewritten without touching the others and the ciphertext is the same size as the plaintext.
+    /// It doesn't authenticate: a modified sector decrypts to unpredictable data rather than failing. Use an AEAD
+    /// wherever there is room for a tag.
+    ///
+    /// The key is 256 bits for AES-128-XTS or 512 bits for AES-256-XTS: the data key followed by the tweak key,
+    /// which must differ. A data unit is from 16 bytes to 2^20 blocks long; lengths that aren't a multiple of 16
+    /// use ciphertext stealing.
+    ///
+    /// On CPUs with AES instructions, eight blocks go through the cipher at a time, or sixteen on x86-64 CPUs with
+    /// VAES.
+    public enum _XTS {
+        static let dataUnitByteCounts = 16...(1 << 24)
+
+        /// Encrypts one data unit using AES-XTS.
+        ///
+        /// - Parameters:
+        ///   - plaintext: The data unit to encrypt, from 16 bytes to 2^20 blocks long.
+        ///   - key: A 256-bit or 512-bit AES-XTS key.
+        ///   - tweak: The tweak of the data unit, usually derived from its position.
+        /// - Returns: The ciphertext, which is the same length as the plaintext.
+        public static func encrypt<Plaintext: DataProtocol>(
+            _ plaintext: Plaintext,
+            using key: SymmetricKey,
+            tweak: Tweak
+        ) throws -> Data {
+            try PreparedKey(key).encrypt(plaintext, tweak: tweak)
+        }
+
+        /// Decrypts one data unit using AES-XTS.
+        ///
+        /// - Parameters:
+        ///   - ciphertext: The data unit to decrypt, from 16 bytes to 2^20 blocks long.
+        ///   - key: A 256-bit or 512-bit AES-XTS key.
+        ///   - tweak: The tweak the data unit was encrypted with.
+        /// - Returns: The plaintext.
+        public static func decrypt<Ciphertext: DataProtocol>(
+            _ ciphertext: Ciphertext,
+            using key: SymmetricKey,
+            tweak: Tweak
+        ) throws -> Data {
+            try PreparedKey(key).decrypt(ciphertext, tweak: tweak)
+        }
+    }
+}
+
+extension AES._XTS {
+    /// The 16-byte tweak of an AES-XTS data unit.
+    public struct Tweak: Sendable, ContiguousBytes {
+        let bytes: Data
+
+        /// Creates a tweak from 16 bytes of data.
+        public init<D: DataProtocol>(data: D) throws {
+            guard data.count == 16 else {
+                throw CryptoKitError.incorrectParameterSize
+            }
+            self.bytes = Data(data)
+        }
+
+        /// Creates the tweak of a sector: its number as a 16-byte little-endian integer, as in the IEEE 1619 test
+        /// vectors and dm-crypt's `plain64` IV.
+        public init(sectorNumber: UInt64) {
+            var bytes = Data(repeating: 0, count: 16)
+            bytes.withUnsafeMutableBytes {
+                $0.storeBytes(of: sectorNumber.littleEndian, as: UInt64.self)
+            }
+            self.bytes = bytes
+        }
+
+        public func withUnsafeBytes<R>(_ body: (UnsafeRawBufferPointer) throws -> R) rethrows -> R {
+            try self.bytes.withUnsafeBytes(body)
+        }
+    }
+}
+
+extension AES._XTS {
+    /// An AES-XTS key whose key schedules have been expanded once, for encrypting and decrypting many sectors.
+    ///
+    /// The sector methods take runs of consecutive, equally sized sectors and number them from `firstSector`,
+    /// using ``Tweak/init(sectorNumber:)`` for each. Prepared keys are immutable and may be shared freely between
+    /// threads.
+    public struct PreparedKey {
+        private let backing: OpenSSLAESXTSKey
+
+        /// Prepares a key for repeated AES-XTS operations.
+        ///
+        /// - Parameter key: A 256-bit or 512-bit AES-XTS key whose two halves differ.
+        /// - Throws: `CryptoKitError.incorrectKeySize` if the key is the wrong size, or
+        ///   `CryptoKitError.invalidParameter` if its halves are equal.
+        public init(_ key: SymmetricKey) throws {
+            self.backing = try OpenSSLAESXTSKey(key)
+        }
+
+        /// Encrypts one data unit using AES-XTS.
+        ///
+        /// - Parameters:
+        ///   - plaintext: The data unit to encrypt, from 16 bytes to 2^20 blocks long.
+        ///   - tweak: The tweak of the data unit.
+        /// - Returns: The ciphertext, which is the same length as the plaintext.
+        public func encrypt<Plaintext: DataProtocol>(_ plaintext: Plaintext, tweak: AES._XTS.Tweak) throws -> Data {
+            var data = Data(plaintext)
+            try data.withUnsafeMutableBytes {
+                try self.backing.crypt(inPlace: $0, tweak: tweak, encrypting: true)
+            }
+            return data
+        }
+
+        /// Decrypts one data unit using AES-XTS.
+        ///
+        /// - Parameters:
+        ///   - ciphertext: The data unit to decrypt, from 16 bytes to 2^20 blocks long.
+        ///   - tweak: The tweak the data unit was encrypted with.
+        /// - Returns: The plaintext.
+        public func decrypt<Ciphertext: DataProtocol>(_ ciphertext: Ciphertext, tweak: AES._XTS.Tweak) throws -> Data {
+            var data = Data(ciphertext)
+            try data.withUnsafeMutableBytes {
+                try self.backing.crypt(inPlace: $0, tweak: tweak, encrypting: false)
+            }
+            return data
+        }
+
+        /// Encrypts consecutive sectors using AES-XTS.
+        ///
+        /// - Parameters:
+        ///   - plaintext: The sectors to encrypt. The length must be a multiple of `sectorByteCount`.
+        ///   - sectorByteCount: The length of each sector, from 16 bytes to 2^20 blocks.
+        ///   - firstSector: The number of the first sector.
+        /// - Returns: The encrypted sectors.
+        public func encryptSectors<Plaintext: DataProtocol>(
+            _ plaintext: Plaintext,
+            sectorByteCount: Int = 4096,
+            startingAt firstSector: UInt64
+        ) throws -> Data {
+            var data = Data(plaintext)
+            try data.withUnsafeMutableBytes {
+                try self.encryptSectors(inPlace: $0, sectorByteCount: sectorByteCount, startingAt: firstSector)
+            }
+            return data
+        }
+
+        /// Decrypts consecutive sectors using AES-XTS.
+        ///
+        /// - Parameters:
+        ///   - ciphertext: The sectors to decrypt. The length must be a multiple of `sectorByteCount`.
+        ///   - sectorByteCount: The length of each sector, from 16 bytes to 2^20 blocks.
+        ///   - firstSector: The number of the first sector.
+        /// - Returns: The decrypted sectors.
+        public func decryptSectors<Ciphertext: DataProtocol>(
+            _ ciphertext: Ciphertext,
+            sectorByteCount: Int = 4096,
+            startingAt firstSector: UInt64
+        ) throws -> Data {
+            var data = Data(ciphertext)
+            try data.withUnsafeMutableBytes {
+                try self.decryptSectors(inPlace: $0, sectorByteCount: sectorByteCount, startingAt: firstSector)
+            }
+            return data
+        }
+
+        /// Encrypts consecutive sectors in place using AES-XTS, for buffers that are about to be written to storage.
+        ///
+        /// - Parameters:
+        ///   - buffer: The sectors to encrypt. The length must be a multiple of `sectorByteCount`.
+        ///   - sectorByteCount: The length of each sector, from 16 bytes to 2^20 blocks.
+        ///   - firstSector: The number of the first sector.
+        /// - Throws: `CryptoKitError.incorrectParameterSize` if the lengths are invalid, or
+        ///   `CryptoKitError.invalidParameter` if the sector numbers would pass `UInt64.max`.
+        public func encryptSectors(
+            inPlace buffer: UnsafeMutableRawBufferPointer,
+            sectorByteCount: Int = 4096,
+            startingAt firstSector: UInt64
+        ) throws {
+            try self.backing.cryptSectors(inPlace: buffer, sectorByteCount: sectorByteCount, firstSector: firstSector, encrypting: true)
+        }
+
+        /// Decrypts consecutive sectors in place using AES-XTS, for buffers that have just been read from storage.
+        ///
+        /// - Parameters:
+        ///   - buffer: The sectors to decrypt. The length must be a multiple of `sectorByteCount`.
+        ///   - sectorByteCount: The length of each sector, from 16 bytes to 2^20 blocks.
+        ///   - firstSector: The number of the first sector.
+        /// - Throws: `CryptoKitError.incorrectParameterSize` if the lengths are invalid, or
+        ///   `CryptoKitError.invalidParameter` if the sector numbers would pass `UInt64.max`.
+        public func decryptSectors(
+            inPlace buffer: UnsafeMutableRawBufferPointer,
+            sectorByteCount: Int = 4096,
+            startingAt firstSector: UInt64
+        ) throws {
+            try self.backing.cryptSectors(inPlace: buffer, sectorByteCount: sectorByteCount, firstSector: firstSector, encrypting: false)
+        }
+    }
+}
@@ -47,6 +47,60 @@ extension AES {
         return try Self.permuteBlock(&payload, key: key, permutation: .backward)
     }
 
+    /// Apply the AES permutation operation in the encryption direction to each block of `payload`.
+    ///
+    /// This is equivalent to calling ``permute(_:key:)`` on each consecutive 16-byte block of `payload`, but expands
+    /// the key once and hands all the blocks to BoringSSL together, where the hardware implementations pipeline
+    /// several blocks at once. The same caveats apply: this is a dangerous primitive that should only be used to
+    /// compose higher-level primitives.
+    ///
+    /// - parameter payload: The blocks to encrypt. Must be a multiple of 16 bytes long.
+    /// - parameter key: The encryption key to use.
+    /// - throws: On invalid parameter sizes.
+    public static func _permuteBlocks<Payload: MutableCollection>(_ payload: inout Payload, key: SymmetricKey) throws where Payload.Element == UInt8 {
+        return try Self.permuteBlocks(&payload, key: key, permutation: .forward)
+    }
+
+    /// Apply the AES permutation operation in the decryption direction to each block of `payload`.
+    ///
+    /// This is equivalent to calling ``inversePermute(_:key:)`` on each consecutive 16-byte block of `payload`, with
+    /// the same batching as ``_permuteBlocks(_:key:)``.
+    ///
+    /// - parameter payload: The blocks to decrypt. Must be a multiple of 16 bytes long.
+    /// - parameter key: The decryption key to use.
+    /// - throws: On invalid parameter sizes.
+    public static func _inversePermuteBlocks<Payload: MutableCollection>(_ payload: inout Payload, key: SymmetricKey) throws where Payload.Element == UInt8 {
+        return try Self.permuteBlocks(&payload, key: key, permutation: .backward)
+    }
+
+    private static func permuteBlocks<Payload: MutableCollection>(_ payload: inout Payload, key: SymmetricKey, permutation: Permutation) throws where Payload.Element == UInt8 {
+        if payload.count % Int(Self.blockSize) != 0 {
+            throw CryptoKitError.incorrectParameterSize
+        }
+
+        if !AES.isValidKey(key) {
+            throw CryptoKitError.incorrectKeySize
+        }
+
+        let requiresSlowPath: Bool = payload.withContiguousMutableStorageIfAvailable { storage in
+            OpenSSLAESECBImpl.permuteBlocks(inPlace: UnsafeMutableRawBufferPointer(storage), using: key, permutation: permutation)
+            return false
+        } ?? true
+
+        if requiresSlowPath {
+            var blocks = Array(payload)
+            blocks.withUnsafeMutableBytes { blocksPtr in
+                OpenSSLAESECBImpl.permuteBlocks(inPlace: blocksPtr, using: key, permutation: permutation)
+            }
+
+            var index = payload.startIndex
+            for byte in blocks {
+                payload[index] = byte
+                payload.formIndex(after: &index)
+            }
+        }
+    }
+
     private static func permuteBlock<Payload: MutableCollection>(_ payload: inout Payload, key: SymmetricKey, permutation: Permutation) throws where Payload.Element == UInt8 {
         if payload.count != Int(Self.blockSize) {
             throw CryptoKitError.incorrectParameterSize
@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+import Crypto
+import Foundation
+
+enum OpenSSLAESCBCImpl {
+    /// Encrypts `buffer` in place. `buffer.count` must be a multiple of the block size.
+    ///
+    /// The key is expanded once and the whole buffer goes through `AES_cbc_encrypt`, which uses the hardware CBC
+    /// kernel where there is one.
+    static func encrypt(inPlace buffer: UnsafeMutableRawBufferPointer, using key: SymmetricKey, iv: AES._CBC.IV) {
+        Self.cbc(buffer, using: key, iv: iv, direction: AES_ENCRYPT)
+    }
+
+    /// Decrypts `buffer` in place. `buffer.count` must be a multiple of the block size.
+    ///
+    /// Unlike encryption, CBC decryption has no dependency between blocks, so the hardware kernels pipeline
+    /// several blocks at once.
+    static func decrypt(inPlace buffer: UnsafeMutableRawBufferPointer, using key: SymmetricKey, iv: AES._CBC.IV) {
+        Self.cbc(buffer, using: key, iv: iv, direction: AES_DECRYPT)
+    }
+
+    private static func cbc(_ buffer: UnsafeMutableRawBufferPointer, using key: SymmetricKey, iv: AES._CBC.IV, direction: Int32) {
+        precondition(buffer.count % Int(AES_BLOCK_SIZE) == 0)
+        guard buffer.count > 0 else {
+            return
+        }
+
+        var iv = iv
+        key.withUnsafeBytes { keyPtr in
+            withUnsafeMutableBytes(of: &iv.ivBytes) { ivPtr in
+                var aesKey = AES_KEY()
+                let rc: Int32
+                if direction == AES_ENCRYPT {
+                    rc = CCryptoBoringSSL_AES_set_encrypt_key(keyPtr.baseAddress, UInt32(keyPtr.count * 8), &aesKey)
+                } else {
+                    rc = CCryptoBoringSSL_AES_set_decrypt_key(keyPtr.baseAddress, UInt32(keyPtr.count * 8), &aesKey)
+                }
+                precondition(rc == 0)
+
+                CCryptoBoringSSL_AES_cbc_encrypt(
+                    buffer.baseAddress,
+                    buffer.baseAddress,
+                    buffer.count,
+                    &aesKey,
+                    ivPtr.baseAddress,
+                    direction
+                )
+                CCryptoBoringSSL_OPENSSL_cleanse(&aesKey, MemoryLayout<AES_KEY>.size)
+            }
+        }
+    }
+}
+
+enum OpenSSLAESECBImpl {
+    /// Applies the AES block function to every block of `buffer` in place, with a single key schedule.
+    static func permuteBlocks(inPlace buffer: UnsafeMutableRawBufferPointer, using key: SymmetricKey, permutation: AES.Permutation) {
+        precondition(buffer.count % Int(AES_BLOCK_SIZE) == 0)
+        guard buffer.count > 0 else {
+            return
+        }
+
+        key.withUnsafeBytes { keyPtr in
+            var aesKey = AES_KEY()
+            let rc: Int32
+            switch permutation {
+            case .forward:
+                rc = CCryptoBoringSSL_AES_set_encrypt_key(keyPtr.baseAddress, UInt32(keyPtr.count * 8), &aesKey)
+            case .backward:
+                rc = CCryptoBoringSSL_AES_set_decrypt_key(keyPtr.baseAddress, UInt32(keyPtr.count * 8), &aesKey)
+            }
+            precondition(rc == 0)
+
+            CCryptoBoringSSLShims_AES_ecb_encrypt_blocks(
+                buffer.baseAddress,
+                buffer.baseAddress,
+                buffer.count,
+                &aesKey,
+                permutation == .forward ? AES_ENCRYPT : AES_DECRYPT
+            )
+            CCryptoBoringSSL_OPENSSL_cleanse(&aesKey, MemoryLayout<AES_KEY>.size)
+        }
+    }
+}
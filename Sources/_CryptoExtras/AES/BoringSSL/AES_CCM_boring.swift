@@ -0,0 +1,115 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+import Crypto
+import Foundation
+
+/// An expanded AES key for CCM. The key is only read after creation, so it may be used from several threads at once.
+final class OpenSSLAESCCMKey {
+    private let key: UnsafeMutablePointer<CCryptoBoringSSLShims_CCM_KEY>
+
+    init(_ key: SymmetricKey) throws {
+        guard [128, 192, 256].contains(key.bitCount) else {
+            throw CryptoKitError.incorrectKeySize
+        }
+        self.key = .allocate(capacity: 1)
+        let rc = key.withUnsafeBytes { keyPtr in
+            CCryptoBoringSSLShims_CCM_KEY_init(self.key, keyPtr.baseAddress?.assumingMemoryBound(to: UInt8.self), keyPtr.count)
+        }
+        precondition(rc == 1)
+    }
+
+    deinit {
+        CCryptoBoringSSL_OPENSSL_cleanse(self.key, MemoryLayout<CCryptoBoringSSLShims_CCM_KEY>.size)
+        self.key.deallocate()
+    }
+
+    /// Checks the lengths that the C code would otherwise reject, so that each gets a specific error.
+    private static func validate(nonce: AES._CCM.Nonce, messageByteCount: Int, tagByteCount: Int) throws {
+        guard tagByteCount >= 4, tagByteCount <= 16, tagByteCount % 2 == 0 else {
+            throw CryptoKitError.invalidParameter
+        }
+        let lengthFieldBits = (15 - nonce.bytes.count) * 8
+        guard lengthFieldBits >= UInt64.bitWidth || UInt64(messageByteCount) >> lengthFieldBits == 0 else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+    }
+
+    func seal<Plaintext: DataProtocol, AuthenticatedData: DataProtocol>(
+        _ message: Plaintext,
+        nonce: AES._CCM.Nonce,
+        authenticatedData: AuthenticatedData,
+        tagByteCount: Int
+    ) throws -> AES._CCM.SealedBox {
+        try Self.validate(nonce: nonce, messageByteCount: message.count, tagByteCount: tagByteCount)
+
+        var ciphertext = Data(message)
+        var tag = Data(repeating: 0, count: tagByteCount)
+        let ad = Data(authenticatedData)
+        let rc = nonce.withUnsafeBytes { noncePtr in
+            ad.withUnsafeBytes { adPtr in
+                tag.withUnsafeMutableBytes { tagPtr in
+                    ciphertext.withUnsafeMutableBytes { bufferPtr in
+                        let buffer = bufferPtr.baseAddress?.assumingMemoryBound(to: UInt8.self)
+                        return CCryptoBoringSSLShims_AES_CCM_seal(
+                            self.key,
+                            noncePtr.baseAddress?.assumingMemoryBound(to: UInt8.self), noncePtr.count,
+                            adPtr.baseAddress?.assumingMemoryBound(to: UInt8.self), adPtr.count,
+                            buffer, bufferPtr.count,
+                            buffer,
+                            tagPtr.baseAddress?.assumingMemoryBound(to: UInt8.self), tagPtr.count
+                        )
+                    }
+                }
+            }
+        }
+        guard rc == 1 else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+        return try AES._CCM.SealedBox(nonce: nonce, ciphertext: ciphertext, tag: tag)
+    }
+
+    func open<AuthenticatedData: DataProtocol>(
+        _ sealedBox: AES._CCM.SealedBox,
+        authenticatedData: AuthenticatedData
+    ) throws -> Data {
+        try Self.validate(nonce: sealedBox.nonce, messageByteCount: sealedBox.ciphertext.count, tagByteCount: sealedBox.tag.count)
+
+        var plaintext = sealedBox.ciphertext
+        let ad = Data(authenticatedData)
+        let rc = sealedBox.nonce.withUnsafeBytes { noncePtr in
+            ad.withUnsafeBytes { adPtr in
+                sealedBox.tag.withUnsafeBytes { tagPtr in
+                    plaintext.withUnsafeMutableBytes { bufferPtr in
+                        let buffer = bufferPtr.baseAddress?.assumingMemoryBound(to: UInt8.self)
+                        return CCryptoBoringSSLShims_AES_CCM_open(
+                            self.key,
+                            noncePtr.baseAddress?.assumingMemoryBound(to: UInt8.self), noncePtr.count,
+                            adPtr.baseAddress?.assumingMemoryBound(to: UInt8.self), adPtr.count,
+                            buffer, bufferPtr.count,
+                            tagPtr.baseAddress?.assumingMemoryBound(to: UInt8.self), tagPtr.count,
+                            buffer
+                        )
+                    }
+                }
+            }
+        }
+        guard rc == 1 else {
+            throw CryptoKitError.authenticationFailure
+        }
+        return plaintext
+    }
+}
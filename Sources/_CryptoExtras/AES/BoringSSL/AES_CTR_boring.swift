@@ -64,3 +64,60 @@ enum OpenSSLAESCTRImpl {
         return ciphertext
     }
 }
+
+/// The state of an AES-CTR keystream: the expanded key, the counter block, and any unused keystream from the
+/// last partial block. `AES_ctr128_encrypt` carries the partial block across calls itself.
+final class OpenSSLAESCTRStream {
+    private let key: UnsafeMutablePointer<AES_KEY>
+
+    /// The counter block followed by the encrypted counter block.
+    private let blocks: UnsafeMutableRawBufferPointer
+
+    private let unusedKeystreamOffset: UnsafeMutablePointer<UInt32>
+
+    init(key: SymmetricKey, nonce: AES._CTR.Nonce) throws {
+        guard [128, 192, 256].contains(key.bitCount) else {
+            throw CryptoKitError.incorrectKeySize
+        }
+
+        self.key = .allocate(capacity: 1)
+        self.blocks = .allocate(byteCount: 32, alignment: 16)
+        self.blocks.initializeMemory(as: UInt8.self, repeating: 0)
+        self.unusedKeystreamOffset = .allocate(capacity: 1)
+        self.unusedKeystreamOffset.initialize(to: 0)
+
+        var nonce = nonce
+        nonce.withUnsafeMutableBytes { nonceBufferPtr in
+            UnsafeMutableRawBufferPointer(rebasing: self.blocks[0..<16]).copyMemory(from: UnsafeRawBufferPointer(nonceBufferPtr))
+        }
+        key.withUnsafeBytes { keyBufferPtr in
+            precondition(CCryptoBoringSSL_AES_set_encrypt_key(keyBufferPtr.baseAddress, UInt32(keyBufferPtr.count * 8), self.key) == 0)
+        }
+    }
+
+    deinit {
+        CCryptoBoringSSL_OPENSSL_cleanse(self.key, MemoryLayout<AES_KEY>.size)
+        CCryptoBoringSSL_OPENSSL_cleanse(self.blocks.baseAddress, self.blocks.count)
+        self.key.deallocate()
+        self.blocks.deallocate()
+        self.unusedKeystreamOffset.deallocate()
+    }
+
+    /// XORs the next `input.count` bytes of keystream into `input`, writing the result to `output`. The two may be
+    /// the same buffer.
+    func apply(_ input: UnsafeRawBufferPointer, into output: UnsafeMutableRawBufferPointer) {
+        precondition(input.count == output.count)
+        guard input.count > 0 else {
+            return
+        }
+        CCryptoBoringSSL_AES_ctr128_encrypt(
+            input.baseAddress,
+            output.baseAddress,
+            input.count,
+            self.key,
+            self.blocks.baseAddress,
+            self.blocks.baseAddress! + 16,
+            self.unusedKeystreamOffset
+        )
+    }
+}
@@ -85,3 +85,44 @@ enum OpenSSLAESGCMSIVImpl {
         }
     }
 }
+
+/// An AES-GCM-SIV key with its `EVP_AEAD_CTX` already initialised, so the key-generating AES schedule is
+/// expanded once rather than for every message. The context is only read after initialisation, so it may be
+/// used from several threads at once.
+final class OpenSSLAESGCMSIVPreparedKey {
+    private let context: BoringSSLAEAD.AEADContext
+
+    init(_ key: SymmetricKey) throws {
+        do {
+            self.context = try BoringSSLAEAD.AEADContext(cipher: OpenSSLAESGCMSIVImpl._backingAEAD(key: key), key: key)
+        } catch CryptoBoringWrapperError.underlyingCoreCryptoError(let errorCode) {
+            throw CryptoKitError.underlyingCoreCryptoError(error: errorCode)
+        }
+    }
+
+    func seal<Plaintext: DataProtocol, AuthenticatedData: DataProtocol>(
+        _ message: Plaintext,
+        nonce: AES.GCM._SIV.Nonce?,
+        authenticatedData: AuthenticatedData
+    ) throws -> AES.GCM._SIV.SealedBox {
+        let nonce = nonce ?? AES.GCM._SIV.Nonce()
+        do {
+            let (ciphertext, tag) = try self.context.seal(message: message, nonce: nonce, authenticatedData: authenticatedData)
+            return try AES.GCM._SIV.SealedBox(nonce: nonce, ciphertext: ciphertext, tag: tag)
+        } catch CryptoBoringWrapperError.underlyingCoreCryptoError(let errorCode) {
+            throw CryptoKitError.underlyingCoreCryptoError(error: errorCode)
+        }
+    }
+
+    func open<AuthenticatedData: DataProtocol>(_ sealedBox: AES.GCM._SIV.SealedBox, authenticatedData: AuthenticatedData) throws -> Data {
+        do {
+            return try self.context.open(
+                combinedCiphertextAndTag: sealedBox.combined.dropFirst(AES.GCM._SIV.nonceByteCount),
+                nonce: sealedBox.nonce,
+                authenticatedData: authenticatedData
+            )
+        } catch CryptoBoringWrapperError.underlyingCoreCryptoError(let errorCode) {
+            throw CryptoKitError.underlyingCoreCryptoError(error: errorCode)
+        }
+    }
+}
@@ -0,0 +1,127 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+import Crypto
+import Foundation
+
+/// The encryption and decryption key schedules of an AES key-encryption key.
+final class OpenSSLAESKeyWrapPreparedKey {
+    private let encryptKey: UnsafeMutablePointer<AES_KEY>
+
+    private let decryptKey: UnsafeMutablePointer<AES_KEY>
+
+    init(_ kek: SymmetricKey) throws {
+        guard [128, 192, 256].contains(kek.bitCount) else {
+            throw CryptoKitError.incorrectKeySize
+        }
+
+        self.encryptKey = .allocate(capacity: 1)
+        self.decryptKey = .allocate(capacity: 1)
+        kek.withUnsafeBytes { keyBufferPtr in
+            let bits = UInt32(keyBufferPtr.count * 8)
+            precondition(CCryptoBoringSSL_AES_set_encrypt_key(keyBufferPtr.baseAddress, bits, self.encryptKey) == 0)
+            precondition(CCryptoBoringSSL_AES_set_decrypt_key(keyBufferPtr.baseAddress, bits, self.decryptKey) == 0)
+        }
+    }
+
+    deinit {
+        CCryptoBoringSSL_OPENSSL_cleanse(self.encryptKey, MemoryLayout<AES_KEY>.size)
+        CCryptoBoringSSL_OPENSSL_cleanse(self.decryptKey, MemoryLayout<AES_KEY>.size)
+        self.encryptKey.deallocate()
+        self.decryptKey.deallocate()
+    }
+
+    func wrap(batch keysToWrap: [SymmetricKey]) throws -> [Data] {
+        // Check the sizes up front so that nothing is wrapped when the batch throws.
+        for key in keysToWrap {
+            guard key.byteCount >= 16, key.byteCount % 8 == 0 else {
+                throw CryptoKitError.incorrectKeySize
+            }
+        }
+
+        // The keys are gathered into one buffer, wrapped in place, and split up again. There's a flat 8-byte
+        // overhead to AES KeyWrap, so each key is copied 8 bytes into its slot.
+        var storage = [UInt8]()
+        storage.reserveCapacity(keysToWrap.reduce(0) { $0 + $1.byteCount + 8 })
+        for key in keysToWrap {
+            storage.append(contentsOf: repeatElement(0, count: 8))
+            key.withUnsafeBytes { storage.append(contentsOf: $0) }
+        }
+        defer {
+            storage.withUnsafeMutableBytes { CCryptoBoringSSL_OPENSSL_cleanse($0.baseAddress, $0.count) }
+        }
+
+        let failures = storage.withUnsafeMutableBytes { storagePtr -> Int in
+            var offset = 0
+            var ops = keysToWrap.map { key -> CCryptoBoringSSLShims_AES_wrap_batch_op in
+                defer { offset += key.byteCount + 8 }
+                return CCryptoBoringSSLShims_AES_wrap_batch_op(
+                    in: UnsafeRawPointer(storagePtr.baseAddress! + offset + 8),
+                    in_len: key.byteCount,
+                    out: storagePtr.baseAddress! + offset,
+                    result: 0
+                )
+            }
+            return CCryptoBoringSSLShims_AES_wrap_key_batch(self.encryptKey, &ops, ops.count)
+        }
+        guard failures == 0 else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+
+        var offset = 0
+        return keysToWrap.map { key in
+            defer { offset += key.byteCount + 8 }
+            return Data(storage[offset..<(offset + key.byteCount + 8)])
+        }
+    }
+
+    func unwrap(batch wrappedKeys: [Data]) -> [SymmetricKey?] {
+        // The wrapped keys are gathered into one buffer and unwrapped in place. Each key comes out 8 bytes shorter,
+        // at the start of its slot.
+        var storage = [UInt8]()
+        storage.reserveCapacity(wrappedKeys.reduce(0) { $0 + $1.count })
+        for wrappedKey in wrappedKeys {
+            storage.append(contentsOf: wrappedKey)
+        }
+        defer {
+            storage.withUnsafeMutableBytes { CCryptoBoringSSL_OPENSSL_cleanse($0.baseAddress, $0.count) }
+        }
+
+        let results = storage.withUnsafeMutableBytes { storagePtr -> [CInt] in
+            var offset = 0
+            var ops = wrappedKeys.map { wrappedKey -> CCryptoBoringSSLShims_AES_wrap_batch_op in
+                defer { offset += wrappedKey.count }
+                return CCryptoBoringSSLShims_AES_wrap_batch_op(
+                    in: UnsafeRawPointer(storagePtr.baseAddress.map { $0 + offset }),
+                    in_len: wrappedKey.count,
+                    out: storagePtr.baseAddress.map { $0 + offset },
+                    result: 0
+                )
+            }
+            _ = CCryptoBoringSSLShims_AES_unwrap_key_batch(self.decryptKey, &ops, ops.count)
+            return ops.map { $0.result }
+        }
+
+        var offset = 0
+        return zip(wrappedKeys, results).map { wrappedKey, result in
+            defer { offset += wrappedKey.count }
+            guard result == 1 else {
+                return nil
+            }
+            return SymmetricKey(data: storage[offset..<(offset + wrappedKey.count - 8)])
+        }
+    }
+}
@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+import Crypto
+import Foundation
+
+/// An expanded AES-XTS key. The key is only read after creation, so it may be used from several threads at once.
+final class OpenSSLAESXTSKey {
+    private let key: UnsafeMutablePointer<CCryptoBoringSSLShims_XTS_KEY>
+
+    init(_ key: SymmetricKey) throws {
+        guard [256, 512].contains(key.bitCount) else {
+            throw CryptoKitError.incorrectKeySize
+        }
+        self.key = .allocate(capacity: 1)
+        let rc = key.withUnsafeBytes { keyPtr in
+            CCryptoBoringSSLShims_XTS_KEY_init(self.key, keyPtr.baseAddress?.assumingMemoryBound(to: UInt8.self), keyPtr.count)
+        }
+        guard rc == 1 else {
+            // The only other failure: the data key and the tweak key are the same. deinit frees `key`.
+            throw CryptoKitError.invalidParameter
+        }
+    }
+
+    deinit {
+        CCryptoBoringSSL_OPENSSL_cleanse(self.key, MemoryLayout<CCryptoBoringSSLShims_XTS_KEY>.size)
+        self.key.deallocate()
+    }
+
+    static func validate(dataUnitByteCount: Int) throws {
+        guard AES._XTS.dataUnitByteCounts.contains(dataUnitByteCount) else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+    }
+
+    func crypt(inPlace buffer: UnsafeMutableRawBufferPointer, tweak: AES._XTS.Tweak, encrypting: Bool) throws {
+        try Self.validate(dataUnitByteCount: buffer.count)
+        let rc = tweak.withUnsafeBytes { tweakPtr in
+            let bytes = buffer.baseAddress?.assumingMemoryBound(to: UInt8.self)
+            return CCryptoBoringSSLShims_AES_XTS_crypt(
+                self.key,
+                tweakPtr.baseAddress?.assumingMemoryBound(to: UInt8.self),
+                bytes,
+                bytes,
+                buffer.count,
+                encrypting ? 1 : 0
+            )
+        }
+        guard rc == 1 else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+    }
+
+    func cryptSectors(
+        inPlace buffer: UnsafeMutableRawBufferPointer,
+        sectorByteCount: Int,
+        firstSector: UInt64,
+        encrypting: Bool
+    ) throws {
+        try Self.validate(dataUnitByteCount: sectorByteCount)
+        guard buffer.count % sectorByteCount == 0 else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+        let sectorCount = buffer.count / sectorByteCount
+        guard sectorCount == 0 || UInt64(sectorCount - 1) <= UInt64.max - firstSector else {
+            throw CryptoKitError.invalidParameter
+        }
+        let bytes = buffer.baseAddress?.assumingMemoryBound(to: UInt8.self)
+        let rc = CCryptoBoringSSLShims_AES_XTS_crypt_sectors(
+            self.key,
+            firstSector,
+            bytes,
+            bytes,
+            sectorByteCount,
+            sectorCount,
+            encrypting ? 1 : 0
+        )
+        guard rc == 1 else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+    }
+}
@@ -50,7 +50,7 @@ enum OpenSSLChaCha20CTRImpl {
                     var ciphertext = Data(repeating: 0, count: plaintext.count)
 
                     ciphertext.withUnsafeMutableBytes { ciphertext in
-                        CCryptoBoringSSL_CRYPTO_chacha_20(
+                        CCryptoBoringSSLShims_chacha_20(
                             ciphertext.baseAddress,
                             plaintext.baseAddress,
                             plaintext.count,
@@ -66,3 +66,120 @@ enum OpenSSLChaCha20CTRImpl {
         }
     }
 }
+
+/// The state of a ChaCha20 keystream across calls: the key and nonce, the next block counter, and the unused
+/// tail of the last keystream block.
+final class OpenSSLChaCha20CTRStream {
+    private static let blockByteCount = 64
+
+    /// The key, followed by the nonce, followed by one block of keystream.
+    private let storage: UnsafeMutableRawBufferPointer
+
+    /// The counter of the next block to generate. This is wider than the 32-bit ChaCha20 counter so that running
+    /// off the end of the counter space can be detected.
+    private var nextBlock: UInt64
+
+    /// The offset of the first unused byte of keystream, or `blockByteCount` if there is none.
+    private var keystreamOffset: Int
+
+    init(key: SymmetricKey, nonce: Insecure.ChaCha20CTR.Nonce, counter: Insecure.ChaCha20CTR.Counter) throws {
+        guard key.bitCount == Insecure.ChaCha20CTR.keyBitsCount else {
+            throw CryptoKitError.incorrectKeySize
+        }
+
+        let keyByteCount = Insecure.ChaCha20CTR.keyBitsCount / 8
+        self.storage = .allocate(byteCount: keyByteCount + Insecure.ChaCha20CTR.nonceByteCount + Self.blockByteCount, alignment: 16)
+        self.storage.initializeMemory(as: UInt8.self, repeating: 0)
+        key.withUnsafeBytes { keyPtr in
+            UnsafeMutableRawBufferPointer(rebasing: self.storage[..<keyByteCount]).copyMemory(from: keyPtr)
+        }
+        nonce.withUnsafeBytes { noncePtr in
+            UnsafeMutableRawBufferPointer(rebasing: self.storage[keyByteCount...]).copyMemory(from: noncePtr)
+        }
+        self.nextBlock = UInt64(counter.counter)
+        self.keystreamOffset = Self.blockByteCount
+    }
+
+    deinit {
+        CCryptoBoringSSL_OPENSSL_cleanse(self.storage.baseAddress, self.storage.count)
+        self.storage.deallocate()
+    }
+
+    private var keyPointer: UnsafePointer<UInt8> {
+        UnsafePointer(self.storage.baseAddress!.assumingMemoryBound(to: UInt8.self))
+    }
+
+    private var noncePointer: UnsafePointer<UInt8> {
+        self.keyPointer + Insecure.ChaCha20CTR.keyBitsCount / 8
+    }
+
+    private var keystream: UnsafeMutablePointer<UInt8> {
+        UnsafeMutablePointer(mutating: self.noncePointer + Insecure.ChaCha20CTR.nonceByteCount)
+    }
+
+    /// XORs the next `input.count` bytes of keystream into `input`, writing the result to `output`. The two may be
+    /// the same buffer.
+    ///
+    /// Throws, without touching `output`, if doing so would exhaust the 32-bit block counter.
+    func apply(_ input: UnsafeRawBufferPointer, into output: UnsafeMutableRawBufferPointer) throws {
+        precondition(input.count == output.count)
+        guard input.count > 0 else {
+            return
+        }
+
+        let buffered = Self.blockByteCount - self.keystreamOffset
+        if input.count > buffered {
+            let blocksNeeded = UInt64((input.count - buffered + Self.blockByteCount - 1) / Self.blockByteCount)
+            guard blocksNeeded <= (1 << 32) - self.nextBlock else {
+                throw CryptoKitError.invalidParameter
+            }
+        }
+
+        let inputBytes = input.bindMemory(to: UInt8.self)
+        let outputBytes = output.bindMemory(to: UInt8.self)
+        var offset = 0
+
+        // Use up what is left of the last block first.
+        let fromBuffer = min(buffered, input.count)
+        while offset < fromBuffer {
+            outputBytes[offset] = inputBytes[offset] ^ self.keystream[self.keystreamOffset]
+            self.keystreamOffset += 1
+            offset += 1
+        }
+
+        // Whole blocks go straight through, without staging the keystream.
+        let wholeBlockBytes = (input.count - offset) / Self.blockByteCount * Self.blockByteCount
+        if wholeBlockBytes > 0 {
+            CCryptoBoringSSLShims_chacha_20(
+                outputBytes.baseAddress! + offset,
+                inputBytes.baseAddress! + offset,
+                wholeBlockBytes,
+                self.keyPointer,
+                self.noncePointer,
+                UInt32(truncatingIfNeeded: self.nextBlock)
+            )
+            self.nextBlock += UInt64(wholeBlockBytes / Self.blockByteCount)
+            offset += wholeBlockBytes
+        }
+
+        // A partial tail generates one block of keystream and keeps the rest for the next call.
+        if offset < input.count {
+            self.keystream.initialize(repeating: 0, count: Self.blockByteCount)
+            CCryptoBoringSSLShims_chacha_20(
+                self.keystream,
+                self.keystream,
+                Self.blockByteCount,
+                self.keyPointer,
+                self.noncePointer,
+                UInt32(truncatingIfNeeded: self.nextBlock)
+            )
+            self.nextBlock += 1
+            self.keystreamOffset = 0
+            while offset < input.count {
+                outputBytes[offset] = inputBytes[offset] ^ self.keystream[self.keystreamOffset]
+                self.keystreamOffset += 1
+                offset += 1
+            }
+        }
+    }
+}
@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+
+extension Insecure.ChaCha20CTR {
+    /// A ChaCha20 keystream that is applied across several calls.
+    ///
+    /// ``Insecure/ChaCha20CTR/encrypt(_:using:counter:nonce:)`` starts from a given block counter on every call, so
+    /// a message can only be split on 64-byte boundaries. A stream carries the counter and any unused keystream
+    /// from a partial block from one call to the next, so a message can be processed in chunks of any size.
+    /// Encrypting a message in pieces produces the same output as encrypting it in one go.
+    ///
+    /// A stream has reference semantics: it is a single position in a single keystream, and never yields the same
+    /// keystream twice. It is not safe to use from multiple threads at once.
+    public final class _Stream {
+        private let backing: OpenSSLChaCha20CTRStream
+
+        /// Starts a keystream.
+        ///
+        /// - Parameters:
+        ///   - key: A 256-bit encryption key
+        ///   - counter: The block counter to start from, defaults to 0
+        ///   - nonce: A 12 byte nonce for ChaCha20 encryption. The nonce must be unique for every use of the key.
+        public init(key: SymmetricKey, counter: Insecure.ChaCha20CTR.Counter = Counter(), nonce: Insecure.ChaCha20CTR.Nonce) throws {
+            self.backing = try OpenSSLChaCha20CTRStream(key: key, nonce: nonce, counter: counter)
+        }
+
+        /// Encrypts the next chunk of a message.
+        ///
+        /// - Parameter message: The next bytes of the message.
+        /// - Returns: The corresponding bytes of ciphertext.
+        /// - Throws: `CryptoKitError.invalidParameter` if the chunk would run past the end of the 32-bit block counter.
+        public func encrypt<Plaintext: DataProtocol>(_ message: Plaintext) throws -> Data {
+            var output = Data(repeating: 0, count: message.count)
+            try output.withUnsafeMutableBytes { outputPtr in
+                if let region = message.regions.first, message.regions.count == 1 {
+                    try region.withUnsafeBytes { try self.backing.apply($0, into: outputPtr) }
+                } else {
+                    try Array(message).withUnsafeBytes { try self.backing.apply($0, into: outputPtr) }
+                }
+            }
+            return output
+        }
+
+        /// Encrypts the next chunk of a message in place.
+        ///
+        /// - Parameter buffer: The next bytes of the message, which are replaced by the ciphertext.
+        /// - Throws: `CryptoKitError.invalidParameter` if the chunk would run past the end of the 32-bit block
+        ///     counter, in which case `buffer` is left unchanged.
+        public func encrypt(inPlace buffer: UnsafeMutableRawBufferPointer) throws {
+            try self.backing.apply(UnsafeRawBufferPointer(buffer), into: buffer)
+        }
+    }
+}
@@ -0,0 +1,249 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+extension HashFunction {
+    /// The number of bytes hashed between cancellation checks.
+    static var _asyncHashChunkByteCount: Int { 1 << 20 }
+
+    /// Computes the digest of `data` on `executor`, suspending the calling task until it's done.
+    ///
+    /// This is intended for inputs large enough that hashing them inline would hold a cooperative thread for a
+    /// noticeable time. Cancelling the calling task stops hashing within ``_asyncHashChunkByteCount`` bytes.
+    ///
+    /// - Parameters:
+    ///   - data: The data to hash.
+    ///   - executor: The executor to hash on.
+    ///   - priority: The priority of the hashing operation on `executor`.
+    /// - Returns: The digest of `data`.
+    /// - Throws: `CancellationError` if the calling task is cancelled before the digest is complete.
+    public static func _hash<D: DataProtocol>(
+        data: D,
+        on executor: _CryptoExecutor,
+        priority: _CryptoExecutor.Priority = .utility
+    ) async throws -> Digest {
+        try await executor.run(priority: priority) { cancellation in
+            var hasher = Self()
+            try hasher.update(data: data, checking: cancellation)
+            return hasher.finalize()
+        }
+    }
+
+    /// Computes the digest of a file's contents on `executor`, suspending the calling task until it's done.
+    ///
+    /// The file is read in large chunks into two buffers in turn, so that the next read is in flight while the
+    /// previous chunk is hashed. A large file is therefore hashed at the speed of the slower of the two, rather than
+    /// the sum of both. Cancelling the calling task stops hashing within one chunk.
+    ///
+    /// - Parameters:
+    ///   - path: The path of the file to hash.
+    ///   - executor: The executor to hash on.
+    ///   - priority: The priority of the hashing operation on `executor`.
+    /// - Returns: The digest of the file's contents.
+    /// - Throws: `POSIXError` if the file can't be opened or read, or `CancellationError` if the calling task is
+    ///   cancelled before the digest is complete.
+    public static func _hash(
+        contentsOfFile path: String,
+        on executor: _CryptoExecutor,
+        priority: _CryptoExecutor.Priority = .utility
+    ) async throws -> Digest {
+        let fileDescriptor = open(path, O_RDONLY)
+        guard fileDescriptor >= 0 else {
+            throw POSIXError.fromErrno()
+        }
+        defer {
+            close(fileDescriptor)
+        }
+        return try await Self._hash(fileDescriptor: fileDescriptor, on: executor, priority: priority)
+    }
+
+    /// Computes the digest of everything that can be read from `fileDescriptor`, on `executor`, suspending the
+    /// calling task until it's done.
+    ///
+    /// This reads from the descriptor's current offset until the end of the file, overlapping reads and hashing as
+    /// ``_hash(contentsOfFile:on:priority:)`` does. It works with pipes and sockets as well as regular files. The
+    /// descriptor isn't closed, and mustn't be used by anything else until this returns.
+    ///
+    /// - Parameters:
+    ///   - fileDescriptor: An open, readable file descriptor.
+    ///   - executor: The executor to hash on.
+    ///   - priority: The priority of the hashing operation on `executor`.
+    /// - Returns: The digest of the bytes read.
+    /// - Throws: `POSIXError` if reading fails, or `CancellationError` if the calling task is cancelled before the
+    ///   digest is complete.
+    public static func _hash(
+        fileDescriptor: CInt,
+        on executor: _CryptoExecutor,
+        priority: _CryptoExecutor.Priority = .utility
+    ) async throws -> Digest {
+        try await executor.run(priority: priority) { cancellation in
+            var hasher = Self()
+            let reader = DoubleBufferedFileReader(fileDescriptor: fileDescriptor, chunkByteCount: Self._asyncHashChunkByteCount)
+            try reader.forEachChunk { chunk in
+                try cancellation.checkCancellation()
+                hasher.update(bufferPointer: chunk)
+            }
+            return hasher.finalize()
+        }
+    }
+
+    /// Computes the digest of a sequence of chunks, hashing each on `executor` while the next is being produced.
+    ///
+    /// At most one chunk is hashed at a time, and it's hashed while the sequence produces the next one. Reading from a
+    /// network stream or a file through an `AsyncSequence` thus overlaps with hashing, as it does for
+    /// ``_hash(fileDescriptor:on:priority:)``.
+    ///
+    /// - Parameters:
+    ///   - chunks: The chunks to hash, in order.
+    ///   - executor: The executor to hash on.
+    ///   - priority: The priority of the hashing operations on `executor`.
+    /// - Returns: The digest of the concatenated chunks.
+    /// - Throws: Whatever `chunks` throws, or `CancellationError` if the calling task is cancelled before the digest is
+    ///   complete.
+    public static func _hash<Chunks: AsyncSequence>(
+        chunks: Chunks,
+        on executor: _CryptoExecutor,
+        priority: _CryptoExecutor.Priority = .utility
+    ) async throws -> Digest where Chunks.Element: DataProtocol & Sendable {
+        let state = AsyncHasherState<Self>()
+        try await withThrowingTaskGroup(of: Void.self) { group in
+            for try await chunk in chunks {
+                // Let the previous chunk finish before starting this one; the hasher is only used by one at a time.
+                _ = try await group.next()
+                group.addTask {
+                    try await executor.run(priority: priority) { cancellation in
+                        try state.hasher.update(data: chunk, checking: cancellation)
+                    }
+                }
+            }
+            _ = try await group.next()
+        }
+        return state.hasher.finalize()
+    }
+}
+
+extension HashFunction {
+    fileprivate mutating func update<D: DataProtocol>(data: D, checking cancellation: _CryptoCancellation) throws {
+        for region in data.regions {
+            try region.withUnsafeBytes { bytes in
+                var offset = 0
+                while offset < bytes.count {
+                    try cancellation.checkCancellation()
+                    let end = min(offset + Self._asyncHashChunkByteCount, bytes.count)
+                    self.update(bufferPointer: UnsafeRawBufferPointer(rebasing: bytes[offset..<end]))
+                    offset = end
+                }
+            }
+        }
+    }
+}
+
+/// The hasher for ``HashFunction/_hash(chunks:on:priority:)``, shared by the tasks that hash each chunk. They run one
+/// after another, and each finishes before the next starts, so it needs no lock.
+private final class AsyncHasherState<H: HashFunction>: @unchecked Sendable {
+    var hasher = H()
+}
+
+/// Reads a file descriptor into two page-aligned buffers in turn, so that one chunk is being read while the caller
+/// processes the other. The buffers are allocated once and reused for the whole file.
+final class DoubleBufferedFileReader: @unchecked Sendable {
+    private let fileDescriptor: CInt
+
+    private let chunkByteCount: Int
+
+    private let buffers: UnsafeMutableRawPointer
+
+    private let readQueue = DispatchQueue(label: "swift-crypto.file-reader")
+
+    private let readCompleted = DispatchSemaphore(value: 0)
+
+    // Written on `readQueue` and read after waiting for `readCompleted`.
+    private var readResult: Result<Int, Error> = .success(0)
+
+    init(fileDescriptor: CInt, chunkByteCount: Int) {
+        precondition(chunkByteCount > 0)
+        self.fileDescriptor = fileDescriptor
+        self.chunkByteCount = chunkByteCount
+        self.buffers = UnsafeMutableRawPointer.allocate(byteCount: 2 * chunkByteCount, alignment: Int(getpagesize()))
+    }
+
+    deinit {
+        self.buffers.deallocate()
+    }
+
+    /// Calls `body` with each chunk read until the end of the file. Every chunk but the last is full.
+    func forEachChunk(_ body: (UnsafeRawBufferPointer) throws -> Void) throws {
+        var current = 0
+        var readInFlight = true
+        self.startRead(into: current)
+        defer {
+            // The buffers can't be released, or reused by the next call, while a read is still filling one.
+            if readInFlight {
+                self.readCompleted.wait()
+            }
+        }
+
+        while readInFlight {
+            self.readCompleted.wait()
+            readInFlight = false
+            let byteCount = try self.readResult.get()
+
+            // A chunk is only short at the end of the file, in which case there's nothing more to read.
+            if byteCount == self.chunkByteCount {
+                self.startRead(into: 1 - current)
+                readInFlight = true
+            }
+            if byteCount > 0 {
+                try body(UnsafeRawBufferPointer(start: self.buffer(current), count: byteCount))
+            }
+            current = 1 - current
+        }
+    }
+
+    private func buffer(_ index: Int) -> UnsafeMutableRawPointer {
+        self.buffers + index * self.chunkByteCount
+    }
+
+    private func startRead(into index: Int) {
+        let buffer = self.buffer(index)
+        self.readQueue.async {
+            self.readResult = Self.fill(buffer, byteCount: self.chunkByteCount, from: self.fileDescriptor)
+            self.readCompleted.signal()
+        }
+    }
+
+    /// Reads until `buffer` is full or the file ends, since pipes and sockets may return less than was asked for.
+    private static func fill(_ buffer: UnsafeMutableRawPointer, byteCount: Int, from fileDescriptor: CInt) -> Result<Int, Error> {
+        var filled = 0
+        while filled < byteCount {
+            let result = read(fileDescriptor, buffer + filled, byteCount - filled)
+            if result > 0 {
+                filled += result
+            } else if result == 0 {
+                break
+            } else if errno != EINTR {
+                return .failure(POSIXError.fromErrno())
+            }
+        }
+        return .success(filled)
+    }
+}
+
+extension POSIXError {
+    fileprivate static func fromErrno() -> POSIXError {
+        POSIXError(POSIXErrorCode(rawValue: errno) ?? .EIO)
+    }
+}
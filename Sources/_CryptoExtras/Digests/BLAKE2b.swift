@@ -0,0 +1,188 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+/// An implementation of BLAKE2b with a 256-bit digest, as specified in RFC 7693.
+public struct _BLAKE2b256: HashFunction {
+    /// The number of bytes compressed at a time.
+    public static let blockByteCount = 128
+
+    private var impl: OpenSSLBLAKE2bImpl
+
+    /// Creates a BLAKE2b-256 hash function.
+    public init() {
+        self.impl = OpenSSLBLAKE2bImpl(outputByteCount: _BLAKE2b256Digest.byteCount)
+    }
+
+    /// Creates a keyed BLAKE2b-256 hash function, which acts as a message authentication code.
+    ///
+    /// - Parameter key: A key of between 1 and 64 bytes.
+    public init(key: SymmetricKey) throws {
+        self.impl = try OpenSSLBLAKE2bImpl(outputByteCount: _BLAKE2b256Digest.byteCount, key: key)
+    }
+
+    /// Incrementally updates the hash function with the contents of the buffer.
+    public mutating func update(bufferPointer: UnsafeRawBufferPointer) {
+        self.impl.update(bufferPointer)
+    }
+
+    /// Finalizes the hash function and returns the computed digest.
+    public func finalize() -> _BLAKE2b256Digest {
+        var digest = _BLAKE2b256Digest()
+        Swift.withUnsafeMutableBytes(of: &digest.bytes) { self.impl.finalize(into: $0) }
+        return digest
+    }
+}
+
+/// The output of a BLAKE2b-256 hash.
+public struct _BLAKE2b256Digest: Digest {
+    fileprivate var bytes: (UInt64, UInt64, UInt64, UInt64) = (0, 0, 0, 0)
+
+    fileprivate init() {}
+
+    /// The number of bytes in the digest.
+    public static var byteCount: Int {
+        return 32
+    }
+
+    /// Invokes the given closure with a buffer pointer covering the raw bytes of the digest.
+    public func withUnsafeBytes<R>(_ body: (UnsafeRawBufferPointer) throws -> R) rethrows -> R {
+        return try Swift.withUnsafeBytes(of: self.bytes, body)
+    }
+
+    /// Hashes the essential components of the digest by feeding them into the given hasher.
+    public func hash(into hasher: inout Hasher) {
+        self.withUnsafeBytes { hasher.combine(bytes: $0) }
+    }
+}
+
+/// An implementation of BLAKE2b with a 512-bit digest, as specified in RFC 7693.
+public struct _BLAKE2b512: HashFunction {
+    /// The number of bytes compressed at a time.
+    public static let blockByteCount = 128
+
+    private var impl: OpenSSLBLAKE2bImpl
+
+    /// Creates a BLAKE2b-512 hash function.
+    public init() {
+        self.impl = OpenSSLBLAKE2bImpl(outputByteCount: _BLAKE2b512Digest.byteCount)
+    }
+
+    /// Creates a keyed BLAKE2b-512 hash function, which acts as a message authentication code.
+    ///
+    /// - Parameter key: A key of between 1 and 64 bytes.
+    public init(key: SymmetricKey) throws {
+        self.impl = try OpenSSLBLAKE2bImpl(outputByteCount: _BLAKE2b512Digest.byteCount, key: key)
+    }
+
+    /// Incrementally updates the hash function with the contents of the buffer.
+    public mutating func update(bufferPointer: UnsafeRawBufferPointer) {
+        self.impl.update(bufferPointer)
+    }
+
+    /// Finalizes the hash function and returns the computed digest.
+    public func finalize() -> _BLAKE2b512Digest {
+        var digest = _BLAKE2b512Digest()
+        Swift.withUnsafeMutableBytes(of: &digest.bytes) { self.impl.finalize(into: $0) }
+        return digest
+    }
+}
+
+/// The output of a BLAKE2b-512 hash.
+public struct _BLAKE2b512Digest: Digest {
+    fileprivate var bytes: (UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64) = (0, 0, 0, 0, 0, 0, 0, 0)
+
+    fileprivate init() {}
+
+    /// The number of bytes in the digest.
+    public static var byteCount: Int {
+        return 64
+    }
+
+    /// Invokes the given closure with a buffer pointer covering the raw bytes of the digest.
+    public func withUnsafeBytes<R>(_ body: (UnsafeRawBufferPointer) throws -> R) rethrows -> R {
+        return try Swift.withUnsafeBytes(of: self.bytes, body)
+    }
+
+    /// Hashes the essential components of the digest by feeding them into the given hasher.
+    public func hash(into hasher: inout Hasher) {
+        self.withUnsafeBytes { hasher.combine(bytes: $0) }
+    }
+}
+
+/// BLAKE2b with a digest length chosen at runtime, as specified in RFC 7693.
+///
+/// The digest length is part of BLAKE2b's parameter block, so a shorter digest is not a
+/// truncation of a longer one.
+public struct _BLAKE2b {
+    /// The number of bytes compressed at a time.
+    public static let blockByteCount = 128
+
+    /// The largest digest, and the largest key, that BLAKE2b supports.
+    public static let maximumByteCount = 64
+
+    private var impl: OpenSSLBLAKE2bImpl
+
+    /// Creates a BLAKE2b function.
+    ///
+    /// - Parameters:
+    ///   - outputByteCount: The digest length, between 1 and 64 bytes.
+    ///   - key: An optional key of between 1 and 64 bytes, which makes the function a message
+    ///     authentication code.
+    public init(outputByteCount: Int = 64, key: SymmetricKey? = nil) throws {
+        if let key = key {
+            self.impl = try OpenSSLBLAKE2bImpl(outputByteCount: outputByteCount, key: key)
+        } else {
+            guard (1...Self.maximumByteCount).contains(outputByteCount) else {
+                throw CryptoKitError.incorrectParameterSize
+            }
+            self.impl = OpenSSLBLAKE2bImpl(outputByteCount: outputByteCount)
+        }
+    }
+
+    /// The number of bytes `finalize()` returns.
+    public var outputByteCount: Int {
+        return self.impl.outputByteCount
+    }
+
+    /// Incrementally updates the function with the contents of the buffer.
+    public mutating func update(bufferPointer: UnsafeRawBufferPointer) {
+        self.impl.update(bufferPointer)
+    }
+
+    /// Incrementally updates the function with the given data.
+    public mutating func update<D: DataProtocol>(data: D) {
+        for region in data.regions {
+            region.withUnsafeBytes { self.update(bufferPointer: $0) }
+        }
+    }
+
+    /// Returns the digest of the data absorbed so far. More data may be absorbed afterwards.
+    public func finalize() -> Data {
+        return self.impl.finalized()
+    }
+
+    /// Computes the BLAKE2b digest of `data`.
+    public static func hash<D: DataProtocol>(
+        data: D,
+        outputByteCount: Int = 64,
+        key: SymmetricKey? = nil
+    ) throws -> Data {
+        var blake2b = try Self(outputByteCount: outputByteCount, key: key)
+        blake2b.update(data: data)
+        return blake2b.finalize()
+    }
+}
@@ -0,0 +1,67 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+@_implementationOnly import CCryptoBoringSSLShims
+import Crypto
+import Foundation
+
+/// A BLAKE2b state. The state holds no pointers, so copying the struct forks the hash.
+struct OpenSSLBLAKE2bImpl {
+    private var context: CCryptoBoringSSLShims_blake2b_ctx
+
+    static let maximumByteCount = Int(CCryptoBoringSSLShims_BLAKE2B_MAX_BYTES)
+
+    init(outputByteCount: Int) {
+        precondition((1...Self.maximumByteCount).contains(outputByteCount))
+        self.context = CCryptoBoringSSLShims_blake2b_ctx()
+        let rc = CCryptoBoringSSLShims_blake2b_init(&self.context, outputByteCount, nil, 0)
+        precondition(rc == 1)
+    }
+
+    init(outputByteCount: Int, key: SymmetricKey) throws {
+        guard (1...Self.maximumByteCount).contains(outputByteCount) else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+        guard (1...Self.maximumByteCount).contains(key.bitCount / 8) else {
+            throw CryptoKitError.incorrectKeySize
+        }
+        self.context = CCryptoBoringSSLShims_blake2b_ctx()
+        let rc = key.withUnsafeBytes {
+            CCryptoBoringSSLShims_blake2b_init(&self.context, outputByteCount, $0.baseAddress, $0.count)
+        }
+        precondition(rc == 1)
+    }
+
+    var outputByteCount: Int {
+        return self.context.out_len
+    }
+
+    mutating func update(_ bytes: UnsafeRawBufferPointer) {
+        CCryptoBoringSSLShims_blake2b_update(&self.context, bytes.baseAddress, bytes.count)
+    }
+
+    /// Writes the digest into `output`, which must be exactly `outputByteCount` bytes, without
+    /// disturbing this state.
+    func finalize(into output: UnsafeMutableRawBufferPointer) {
+        precondition(output.count == self.outputByteCount)
+        var copy = self.context
+        CCryptoBoringSSLShims_blake2b_final(&copy, output.baseAddress)
+    }
+
+    func finalized() -> Data {
+        var output = Data(repeating: 0, count: self.outputByteCount)
+        output.withUnsafeMutableBytes { self.finalize(into: $0) }
+        return output
+    }
+}
@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+@_implementationOnly import CCryptoBoringSSLShims
+import Foundation
+
+/// A Keccak sponge. The state holds no pointers, so copying the struct forks the hash.
+struct OpenSSLKeccakImpl {
+    enum Function {
+        case sha3_256
+        case sha3_512
+        case shake128
+        case shake256
+    }
+
+    private var context: CCryptoBoringSSLShims_keccak_ctx
+
+    init(_ function: Function) {
+        self.context = CCryptoBoringSSLShims_keccak_ctx()
+        CCryptoBoringSSLShims_keccak_init(&self.context, function.shimFunction)
+    }
+
+    mutating func absorb(_ bytes: UnsafeRawBufferPointer) {
+        CCryptoBoringSSLShims_keccak_absorb(&self.context, bytes.baseAddress, bytes.count)
+    }
+
+    /// Pads the message and squeezes `output.count` bytes. Only the SHAKE functions may be
+    /// squeezed more than once.
+    mutating func squeeze(into output: UnsafeMutableRawBufferPointer) {
+        CCryptoBoringSSLShims_keccak_squeeze(&self.context, output.baseAddress, output.count)
+    }
+
+    func squeezed(byteCount: Int) -> Data {
+        var copy = self
+        var output = Data(repeating: 0, count: byteCount)
+        output.withUnsafeMutableBytes { copy.squeeze(into: $0) }
+        return output
+    }
+}
+
+extension OpenSSLKeccakImpl.Function {
+    fileprivate var shimFunction: CCryptoBoringSSLShims_keccak_function {
+        switch self {
+        case .sha3_256:
+            return CCryptoBoringSSLShims_keccak_sha3_256
+        case .sha3_512:
+            return CCryptoBoringSSLShims_keccak_sha3_512
+        case .shake128:
+            return CCryptoBoringSSLShims_keccak_shake128
+        case .shake256:
+            return CCryptoBoringSSLShims_keccak_shake256
+        }
+    }
+}
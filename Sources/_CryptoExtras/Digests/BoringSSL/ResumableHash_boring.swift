@@ -0,0 +1,218 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+import Crypto
+import Foundation
+
+/// A SHA-2 state held inline and driven through BoringSSL's low-level hash functions, so that copying it is a
+/// plain copy of the context struct.
+struct OpenSSLResumableHashImpl: Sendable {
+    private enum Variant: Sendable {
+        case sha256
+        case sha384
+        case sha512
+    }
+
+    private let variant: Variant
+
+    // Raw storage for a `SHA256_CTX` or `SHA512_CTX`. The shims statically assert that this is large enough.
+    private var state: (UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64) = (0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0)
+
+    init<H: HashFunction>(_: H.Type) throws {
+        switch H.self {
+        case is SHA256.Type:
+            self.variant = .sha256
+        case is SHA384.Type:
+            self.variant = .sha384
+        case is SHA512.Type:
+            self.variant = .sha512
+        default:
+            throw CryptoKitError.invalidParameter
+        }
+
+        let variant = self.variant
+        self.withContext { context in
+            switch variant {
+            case .sha256:
+                CCryptoBoringSSL_SHA256_Init(context.assumingMemoryBound(to: SHA256_CTX.self))
+            case .sha384:
+                CCryptoBoringSSL_SHA384_Init(context.assumingMemoryBound(to: SHA512_CTX.self))
+            case .sha512:
+                CCryptoBoringSSL_SHA512_Init(context.assumingMemoryBound(to: SHA512_CTX.self))
+            }
+        }
+    }
+
+    init<H: HashFunction>(_: H.Type, midstate: UnsafeRawBufferPointer) throws {
+        try self.init(H.self)
+        let nid = self.nid
+        let rc = self.withContext { context in
+            CCryptoBoringSSLShims_SHA2_import_midstate(nid, context, midstate.baseAddress, midstate.count)
+        }
+        guard rc == 1 else {
+            throw CryptoKitError.invalidParameter
+        }
+    }
+
+    private var nid: CInt {
+        switch self.variant {
+        case .sha256:
+            return NID_sha256
+        case .sha384:
+            return NID_sha384
+        case .sha512:
+            return NID_sha512
+        }
+    }
+
+    /// The size of a midstate taken on a block boundary: the chaining value and the length, with nothing buffered.
+    var blockAlignedMidstateByteCount: Int {
+        switch self.variant {
+        case .sha256:
+            return 32 + 8
+        case .sha384, .sha512:
+            return 64 + 16
+        }
+    }
+
+    var midstate: Data {
+        var copy = self
+        let nid = self.nid
+        var bytes = [UInt8](repeating: 0, count: Int(CCryptoBoringSSLShims_SHA2_MIDSTATE_MAX_BYTES))
+        let count = copy.withContext { context in
+            CCryptoBoringSSLShims_SHA2_export_midstate(nid, context, &bytes, bytes.count)
+        }
+        precondition(count > 0, "Unable to export a SHA-2 midstate")
+        return Data(bytes.prefix(count))
+    }
+
+    mutating func update(bufferPointer: UnsafeRawBufferPointer) {
+        guard let baseAddress = bufferPointer.baseAddress else {
+            return
+        }
+        let variant = self.variant
+        self.withContext { context in
+            switch variant {
+            case .sha256:
+                CCryptoBoringSSL_SHA256_Update(context.assumingMemoryBound(to: SHA256_CTX.self), baseAddress, bufferPointer.count)
+            case .sha384:
+                CCryptoBoringSSL_SHA384_Update(context.assumingMemoryBound(to: SHA512_CTX.self), baseAddress, bufferPointer.count)
+            case .sha512:
+                CCryptoBoringSSL_SHA512_Update(context.assumingMemoryBound(to: SHA512_CTX.self), baseAddress, bufferPointer.count)
+            }
+        }
+    }
+
+    func finalize() -> Data {
+        // Finalizing is destructive, so work on a copy and cleanse it afterwards.
+        var copy = self
+        let variant = self.variant
+        let stateByteCount = MemoryLayout.size(ofValue: self.state)
+        var digest = [UInt8](repeating: 0, count: Int(SHA512_DIGEST_LENGTH))
+        let count: Int = copy.withContext { context in
+            defer {
+                CCryptoBoringSSL_OPENSSL_cleanse(context, stateByteCount)
+            }
+            switch variant {
+            case .sha256:
+                CCryptoBoringSSL_SHA256_Final(&digest, context.assumingMemoryBound(to: SHA256_CTX.self))
+                return Int(SHA256_DIGEST_LENGTH)
+            case .sha384:
+                CCryptoBoringSSL_SHA384_Final(&digest, context.assumingMemoryBound(to: SHA512_CTX.self))
+                return Int(SHA384_DIGEST_LENGTH)
+            case .sha512:
+                CCryptoBoringSSL_SHA512_Final(&digest, context.assumingMemoryBound(to: SHA512_CTX.self))
+                return Int(SHA512_DIGEST_LENGTH)
+            }
+        }
+        return Data(digest.prefix(count))
+    }
+
+    private mutating func withContext<ReturnValue>(_ body: (UnsafeMutableRawPointer) -> ReturnValue) -> ReturnValue {
+        withUnsafeMutableBytes(of: &self.state) { body($0.baseAddress!) }
+    }
+}
+
+/// HMAC over two `OpenSSLResumableHashImpl` states, so that the keyed pads can be exported and resumed too.
+struct OpenSSLResumableHMACImpl: Sendable {
+    private var inner: OpenSSLResumableHashImpl
+
+    private let outer: OpenSSLResumableHashImpl
+
+    init<H: HashFunction>(_: H.Type, key: SymmetricKey) throws {
+        var inner = try OpenSSLResumableHashImpl(H.self)
+        var outer = inner
+
+        // As in RFC 2104, keys longer than a block are hashed first, and the result is padded with zeros.
+        var pad = [UInt8](repeating: 0, count: H.blockByteCount)
+        defer {
+            CCryptoBoringSSL_OPENSSL_cleanse(&pad, pad.count)
+        }
+        key.withUnsafeBytes { keyBytes in
+            if keyBytes.count > H.blockByteCount {
+                var keyHash = inner
+                keyHash.update(bufferPointer: keyBytes)
+                let digest = keyHash.finalize()
+                pad.replaceSubrange(0..<digest.count, with: digest)
+            } else {
+                pad.replaceSubrange(0..<keyBytes.count, with: keyBytes)
+            }
+        }
+
+        for index in pad.indices {
+            pad[index] ^= 0x36
+        }
+        pad.withUnsafeBytes { inner.update(bufferPointer: $0) }
+        for index in pad.indices {
+            pad[index] ^= 0x36 ^ 0x5c
+        }
+        pad.withUnsafeBytes { outer.update(bufferPointer: $0) }
+
+        self.inner = inner
+        self.outer = outer
+    }
+
+    init<H: HashFunction>(_: H.Type, midstate: UnsafeRawBufferPointer) throws {
+        // The outer state has only ever absorbed one block, so its midstate has a fixed size and comes first.
+        let outerByteCount = try OpenSSLResumableHashImpl(H.self).blockAlignedMidstateByteCount
+        guard midstate.count >= outerByteCount else {
+            throw CryptoKitError.invalidParameter
+        }
+        self.outer = try OpenSSLResumableHashImpl(H.self, midstate: UnsafeRawBufferPointer(rebasing: midstate.prefix(outerByteCount)))
+        self.inner = try OpenSSLResumableHashImpl(H.self, midstate: UnsafeRawBufferPointer(rebasing: midstate.dropFirst(outerByteCount)))
+    }
+
+    var midstate: Data {
+        self.outer.midstate + self.inner.midstate
+    }
+
+    mutating func update(bufferPointer: UnsafeRawBufferPointer) {
+        self.inner.update(bufferPointer: bufferPointer)
+    }
+
+    func finalize() -> Data {
+        var outer = self.outer
+        self.inner.finalize().withUnsafeBytes { outer.update(bufferPointer: $0) }
+        return outer.finalize()
+    }
+
+    func isValidAuthenticationCode(_ authenticationCode: UnsafeRawBufferPointer) -> Bool {
+        let computed = self.finalize()
+        guard computed.count == authenticationCode.count else {
+            return false
+        }
+        return computed.withUnsafeBytes { CCryptoBoringSSL_CRYPTO_memcmp($0.baseAddress, authenticationCode.baseAddress, $0.count) == 0 }
+    }
+}
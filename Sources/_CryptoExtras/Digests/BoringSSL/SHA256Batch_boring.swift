@@ -0,0 +1,35 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+@_implementationOnly import CCryptoBoringSSLShims
+import Crypto
+import Foundation
+
+enum OpenSSLSHA256BatchImpl {
+    static func hash(batch messages: [UnsafeRawBufferPointer], into digests: UnsafeMutableRawBufferPointer) {
+        precondition(digests.count == messages.count * SHA256.byteCount)
+
+        let ops = messages.enumerated().map { index, message in
+            CCryptoBoringSSLShims_hash_batch_op(
+                in: message.baseAddress,
+                in_len: message.count,
+                out: digests.baseAddress! + (index * SHA256.byteCount)
+            )
+        }
+
+        ops.withUnsafeBufferPointer { opsPointer in
+            CCryptoBoringSSLShims_SHA256_batch(opsPointer.baseAddress, opsPointer.count)
+        }
+    }
+}
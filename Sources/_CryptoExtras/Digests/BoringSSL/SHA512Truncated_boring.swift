@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+
+/// A truncated SHA-512 hash. The state holds no pointers, so copying the struct forks the hash.
+struct OpenSSLSHA512TruncatedImpl {
+    enum Function {
+        case sha512_224
+        case sha512_256
+
+        var digestByteCount: Int {
+            switch self {
+            case .sha512_224:
+                return Int(CCryptoBoringSSLShims_SHA512_224_DIGEST_LENGTH)
+            case .sha512_256:
+                return Int(SHA512_256_DIGEST_LENGTH)
+            }
+        }
+    }
+
+    private let function: Function
+
+    private var context: SHA512_CTX
+
+    init(_ function: Function) {
+        self.function = function
+        self.context = SHA512_CTX()
+        switch function {
+        case .sha512_224:
+            CCryptoBoringSSLShims_SHA512_224_Init(&self.context)
+        case .sha512_256:
+            CCryptoBoringSSL_SHA512_256_Init(&self.context)
+        }
+    }
+
+    mutating func update(_ bytes: UnsafeRawBufferPointer) {
+        guard bytes.baseAddress != nil else {
+            return
+        }
+        CCryptoBoringSSL_SHA512_Update(&self.context, bytes.baseAddress, bytes.count)
+    }
+
+    /// Writes the digest of the data so far to `output`, which must be exactly the digest size, leaving this hash
+    /// able to continue.
+    func finalize(into output: UnsafeMutableRawBufferPointer) {
+        precondition(output.count == self.function.digestByteCount)
+        // Finalizing is destructive, so work on a copy.
+        var copy = self.context
+        let digest = output.baseAddress!.assumingMemoryBound(to: UInt8.self)
+        switch self.function {
+        case .sha512_224:
+            CCryptoBoringSSLShims_SHA512_224_Final(digest, &copy)
+        case .sha512_256:
+            CCryptoBoringSSL_SHA512_256_Final(digest, &copy)
+            CCryptoBoringSSL_OPENSSL_cleanse(&copy, MemoryLayout<SHA512_CTX>.size)
+        }
+    }
+}
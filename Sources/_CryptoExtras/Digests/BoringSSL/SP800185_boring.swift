@@ -0,0 +1,176 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+import Crypto
+import Foundation
+
+/// A cSHAKE sponge from NIST SP 800-185, set up as plain cSHAKE or as the start of KMAC or ParallelHash. Like
+/// ``OpenSSLKeccakImpl`` the state holds no pointers, so copying the struct forks the computation.
+struct OpenSSLSP800185Impl {
+    enum Strength {
+        case bits128
+        case bits256
+    }
+
+    private var context: CCryptoBoringSSLShims_keccak_ctx
+
+    init(cSHAKE strength: Strength, functionName: Data, customization: Data) {
+        self.context = CCryptoBoringSSLShims_keccak_ctx()
+        functionName.withUnsafeBytes { functionName in
+            customization.withUnsafeBytes { customization in
+                CCryptoBoringSSLShims_keccak_cshake_init(
+                    &self.context, strength.shimFunction,
+                    functionName.baseAddress, functionName.count, customization.baseAddress, customization.count
+                )
+            }
+        }
+    }
+
+    init(kmac strength: Strength, key: SymmetricKey, customization: Data) {
+        self.context = CCryptoBoringSSLShims_keccak_ctx()
+        key.withUnsafeBytes { key in
+            customization.withUnsafeBytes { customization in
+                CCryptoBoringSSLShims_keccak_kmac_init(
+                    &self.context, strength.shimFunction,
+                    key.baseAddress, key.count, customization.baseAddress, customization.count
+                )
+            }
+        }
+    }
+
+    init(parallelHash strength: Strength, blockByteCount: Int, customization: Data) {
+        self.context = CCryptoBoringSSLShims_keccak_ctx()
+        customization.withUnsafeBytes { customization in
+            CCryptoBoringSSLShims_keccak_parallel_hash_init(
+                &self.context, strength.shimFunction, blockByteCount, customization.baseAddress, customization.count
+            )
+        }
+    }
+
+    mutating func absorb(_ bytes: UnsafeRawBufferPointer) {
+        CCryptoBoringSSLShims_keccak_absorb(&self.context, bytes.baseAddress, bytes.count)
+    }
+
+    mutating func absorbRightEncoded(_ value: UInt64) {
+        CCryptoBoringSSLShims_keccak_absorb_right_encode(&self.context, value)
+    }
+
+    /// Hashes `bytes` as consecutive ParallelHash blocks of `blockByteCount` bytes, and absorbs their chaining
+    /// values.
+    mutating func absorbParallelHashBlocks(_ bytes: UnsafeRawBufferPointer, blockByteCount: Int, maximumThreadCount: Int) {
+        precondition(bytes.count % blockByteCount == 0)
+        let rc = CCryptoBoringSSLShims_keccak_parallel_hash_absorb_blocks(
+            &self.context, bytes.baseAddress, blockByteCount, bytes.count / blockByteCount, max(maximumThreadCount, 1)
+        )
+        precondition(rc == 1, "Unable to allocate memory for ParallelHash")
+    }
+
+    mutating func squeeze(into output: UnsafeMutableRawBufferPointer) {
+        CCryptoBoringSSLShims_keccak_cshake_squeeze(&self.context, output.baseAddress, output.count)
+    }
+
+    func squeezed(byteCount: Int) -> Data {
+        var copy = self
+        var output = Data(repeating: 0, count: byteCount)
+        output.withUnsafeMutableBytes { copy.squeeze(into: $0) }
+        return output
+    }
+
+    /// Finishes KMAC at the length of `code`, and compares `code` against the result in constant time.
+    func isValidKMAC(_ code: UnsafeRawBufferPointer) -> Bool {
+        var copy = self
+        copy.absorbRightEncoded(UInt64(code.count) * 8)
+        let computed = copy.squeezed(byteCount: code.count)
+        return computed.withUnsafeBytes { CCryptoBoringSSL_CRYPTO_memcmp($0.baseAddress, code.baseAddress, $0.count) == 0 }
+    }
+}
+
+extension OpenSSLSP800185Impl.Strength {
+    fileprivate var shimFunction: CCryptoBoringSSLShims_keccak_function {
+        switch self {
+        case .bits128:
+            return CCryptoBoringSSLShims_keccak_shake128
+        case .bits256:
+            return CCryptoBoringSSLShims_keccak_shake256
+        }
+    }
+}
+
+/// The ParallelHash of SP 800-185 over an input that arrives in pieces. Whole blocks are hashed as soon as they
+/// arrive, and the rest of a block waits in `pending`.
+struct ParallelHashState {
+    let blockByteCount: Int
+
+    let maximumThreadCount: Int
+
+    private var impl: OpenSSLSP800185Impl
+
+    private var pending: [UInt8] = []
+
+    private var blockCount: UInt64 = 0
+
+    init(_ strength: OpenSSLSP800185Impl.Strength, blockByteCount: Int, customization: Data, maximumThreadCount: Int) {
+        precondition(blockByteCount > 0, "The block size must be positive")
+        precondition(maximumThreadCount > 0, "The thread count must be positive")
+        self.blockByteCount = blockByteCount
+        self.maximumThreadCount = maximumThreadCount
+        self.impl = OpenSSLSP800185Impl(parallelHash: strength, blockByteCount: blockByteCount, customization: customization)
+    }
+
+    mutating func update(_ bytes: UnsafeRawBufferPointer) {
+        var bytes = bytes[...]
+        if !self.pending.isEmpty {
+            let taken = min(self.blockByteCount - self.pending.count, bytes.count)
+            self.pending.append(contentsOf: bytes.prefix(taken))
+            bytes = bytes.dropFirst(taken)
+            guard self.pending.count == self.blockByteCount else {
+                return
+            }
+            self.absorbPending()
+        }
+
+        let wholeByteCount = bytes.count - bytes.count % self.blockByteCount
+        if wholeByteCount > 0 {
+            self.impl.absorbParallelHashBlocks(
+                UnsafeRawBufferPointer(rebasing: bytes.prefix(wholeByteCount)),
+                blockByteCount: self.blockByteCount,
+                maximumThreadCount: self.maximumThreadCount
+            )
+            self.blockCount += UInt64(wholeByteCount / self.blockByteCount)
+        }
+        self.pending.append(contentsOf: bytes.dropFirst(wholeByteCount))
+    }
+
+    /// Returns `outputByteCount` bytes of ParallelHash output, or of ParallelHashXOF output if `extendable` is set.
+    func finalize(outputByteCount: Int, extendable: Bool) -> Data {
+        precondition(outputByteCount >= 0)
+        var copy = self
+        if !copy.pending.isEmpty {
+            copy.absorbPending()
+        }
+        copy.impl.absorbRightEncoded(copy.blockCount)
+        copy.impl.absorbRightEncoded(extendable ? 0 : UInt64(outputByteCount) * 8)
+        return copy.impl.squeezed(byteCount: outputByteCount)
+    }
+
+    /// Hashes the pending bytes as one block, which is short if this is the end of the input.
+    private mutating func absorbPending() {
+        self.pending.withUnsafeBytes {
+            self.impl.absorbParallelHashBlocks($0, blockByteCount: $0.count, maximumThreadCount: 1)
+        }
+        self.pending.removeAll(keepingCapacity: true)
+        self.blockCount += 1
+    }
+}
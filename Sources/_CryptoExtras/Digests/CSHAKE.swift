@@ -0,0 +1,117 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+
+/// An implementation of the cSHAKE128 customizable extendable-output function, as specified in NIST SP 800-185.
+///
+/// A function name and a customization string separate the outputs of cSHAKE128 for different purposes. With
+/// both empty it's ``_SHAKE128``. Like SHAKE128, the caller chooses how many bytes of output to produce, and
+/// finalizing doesn't consume the state.
+public struct _CSHAKE128 {
+    /// The number of bytes absorbed per permutation of the Keccak state.
+    public static let blockByteCount = 168
+
+    private var impl: OpenSSLSP800185Impl
+
+    /// Creates a cSHAKE128 function.
+    ///
+    /// - Parameters:
+    ///   - functionName: The name of a function defined on top of cSHAKE. Other uses leave it empty.
+    ///   - customization: A string that separates this use of the function from others.
+    public init(functionName: Data = Data(), customization: Data = Data()) {
+        self.impl = OpenSSLSP800185Impl(cSHAKE: .bits128, functionName: functionName, customization: customization)
+    }
+
+    /// Incrementally updates the function with the contents of the buffer.
+    public mutating func update(bufferPointer: UnsafeRawBufferPointer) {
+        self.impl.absorb(bufferPointer)
+    }
+
+    /// Incrementally updates the function with the given data.
+    public mutating func update<D: DataProtocol>(data: D) {
+        for region in data.regions {
+            region.withUnsafeBytes { self.update(bufferPointer: $0) }
+        }
+    }
+
+    /// Returns `outputByteCount` bytes of output for the data absorbed so far.
+    public func finalize(outputByteCount: Int) -> Data {
+        precondition(outputByteCount >= 0)
+        return self.impl.squeezed(byteCount: outputByteCount)
+    }
+
+    /// Computes `outputByteCount` bytes of cSHAKE128 output for `data`.
+    public static func hash<D: DataProtocol>(
+        data: D,
+        outputByteCount: Int,
+        functionName: Data = Data(),
+        customization: Data = Data()
+    ) -> Data {
+        var cshake = Self(functionName: functionName, customization: customization)
+        cshake.update(data: data)
+        return cshake.finalize(outputByteCount: outputByteCount)
+    }
+}
+
+/// An implementation of the cSHAKE256 customizable extendable-output function, as specified in NIST SP 800-185.
+///
+/// A function name and a customization string separate the outputs of cSHAKE256 for different purposes. With
+/// both empty it's ``_SHAKE256``. Like SHAKE256, the caller chooses how many bytes of output to produce, and
+/// finalizing doesn't consume the state.
+public struct _CSHAKE256 {
+    /// The number of bytes absorbed per permutation of the Keccak state.
+    public static let blockByteCount = 136
+
+    private var impl: OpenSSLSP800185Impl
+
+    /// Creates a cSHAKE256 function.
+    ///
+    /// - Parameters:
+    ///   - functionName: The name of a function defined on top of cSHAKE. Other uses leave it empty.
+    ///   - customization: A string that separates this use of the function from others.
+    public init(functionName: Data = Data(), customization: Data = Data()) {
+        self.impl = OpenSSLSP800185Impl(cSHAKE: .bits256, functionName: functionName, customization: customization)
+    }
+
+    /// Incrementally updates the function with the contents of the buffer.
+    public mutating func update(bufferPointer: UnsafeRawBufferPointer) {
+        self.impl.absorb(bufferPointer)
+    }
+
+    /// Incrementally updates the function with the given data.
+    public mutating func update<D: DataProtocol>(data: D) {
+        for region in data.regions {
+            region.withUnsafeBytes { self.update(bufferPointer: $0) }
+        }
+    }
+
+    /// Returns `outputByteCount` bytes of output for the data absorbed so far.
+    public func finalize(outputByteCount: Int) -> Data {
+        precondition(outputByteCount >= 0)
+        return self.impl.squeezed(byteCount: outputByteCount)
+    }
+
+    /// Computes `outputByteCount` bytes of cSHAKE256 output for `data`.
+    public static func hash<D: DataProtocol>(
+        data: D,
+        outputByteCount: Int,
+        functionName: Data = Data(),
+        customization: Data = Data()
+    ) -> Data {
+        var cshake = Self(functionName: functionName, customization: customization)
+        cshake.update(data: data)
+        return cshake.finalize(outputByteCount: outputByteCount)
+    }
+}
@@ -0,0 +1,169 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+
+/// An implementation of ParallelHash128, as specified in NIST SP 800-185.
+///
+/// ParallelHash128 splits its input into blocks of ``blockByteCount`` bytes and hashes each one on its own before
+/// combining the results, so the blocks of a large input can be hashed on several lanes of the Keccak permutation
+/// at once and on several threads. Its output depends on the block size, which is part of the computation, but not
+/// on the thread count or on how the input was split between calls to ``update(data:)``.
+///
+/// Like ``_SHAKE128``, the caller chooses how many bytes of output to produce, and finalizing doesn't consume the
+/// state. ``finalizeXOF(outputByteCount:)`` returns ParallelHashXOF128 instead, whose outputs of different lengths
+/// are prefixes of each other.
+public struct _ParallelHash128 {
+    /// The default block size, which keeps the hashing of every block in the L1 cache.
+    public static let defaultBlockByteCount = 8192
+
+    private var state: ParallelHashState
+
+    /// The number of bytes in each block.
+    public var blockByteCount: Int {
+        self.state.blockByteCount
+    }
+
+    /// Creates a ParallelHash128 function.
+    ///
+    /// - Parameters:
+    ///   - blockByteCount: The number of bytes in each block. Must be positive.
+    ///   - customization: A string that separates this use of the function from others.
+    ///   - maximumThreadCount: The most threads to hash the blocks of one update on. Inputs shorter than 256 KiB
+    ///     per thread use fewer threads.
+    public init(
+        blockByteCount: Int = _ParallelHash128.defaultBlockByteCount,
+        customization: Data = Data(),
+        maximumThreadCount: Int = 1
+    ) {
+        self.state = ParallelHashState(
+            .bits128,
+            blockByteCount: blockByteCount,
+            customization: customization,
+            maximumThreadCount: maximumThreadCount
+        )
+    }
+
+    /// Incrementally updates the function with the contents of the buffer.
+    public mutating func update(bufferPointer: UnsafeRawBufferPointer) {
+        self.state.update(bufferPointer)
+    }
+
+    /// Incrementally updates the function with the given data.
+    public mutating func update<D: DataProtocol>(data: D) {
+        for region in data.regions {
+            region.withUnsafeBytes { self.update(bufferPointer: $0) }
+        }
+    }
+
+    /// Returns `outputByteCount` bytes of ParallelHash128 output for the data absorbed so far.
+    public func finalize(outputByteCount: Int = 32) -> Data {
+        self.state.finalize(outputByteCount: outputByteCount, extendable: false)
+    }
+
+    /// Returns `outputByteCount` bytes of ParallelHashXOF128 output for the data absorbed so far.
+    public func finalizeXOF(outputByteCount: Int) -> Data {
+        self.state.finalize(outputByteCount: outputByteCount, extendable: true)
+    }
+
+    /// Computes `outputByteCount` bytes of ParallelHash128 output for `data`.
+    public static func hash<D: DataProtocol>(
+        data: D,
+        outputByteCount: Int = 32,
+        blockByteCount: Int = _ParallelHash128.defaultBlockByteCount,
+        customization: Data = Data(),
+        maximumThreadCount: Int = 1
+    ) -> Data {
+        var hash = Self(blockByteCount: blockByteCount, customization: customization, maximumThreadCount: maximumThreadCount)
+        hash.update(data: data)
+        return hash.finalize(outputByteCount: outputByteCount)
+    }
+}
+
+/// An implementation of ParallelHash256, as specified in NIST SP 800-185.
+///
+/// ParallelHash256 splits its input into blocks of ``blockByteCount`` bytes and hashes each one on its own before
+/// combining the results, so the blocks of a large input can be hashed on several lanes of the Keccak permutation
+/// at once and on several threads. Its output depends on the block size, which is part of the computation, but not
+/// on the thread count or on how the input was split between calls to ``update(data:)``.
+///
+/// Like ``_SHAKE256``, the caller chooses how many bytes of output to produce, and finalizing doesn't consume the
+/// state. ``finalizeXOF(outputByteCount:)`` returns ParallelHashXOF256 instead, whose outputs of different lengths
+/// are prefixes of each other.
+public struct _ParallelHash256 {
+    /// The default block size, which keeps the hashing of every block in the L1 cache.
+    public static let defaultBlockByteCount = 8192
+
+    private var state: ParallelHashState
+
+    /// The number of bytes in each block.
+    public var blockByteCount: Int {
+        self.state.blockByteCount
+    }
+
+    /// Creates a ParallelHash256 function.
+    ///
+    /// - Parameters:
+    ///   - blockByteCount: The number of bytes in each block. Must be positive.
+    ///   - customization: A string that separates this use of the function from others.
+    ///   - maximumThreadCount: The most threads to hash the blocks of one update on. Inputs shorter than 256 KiB
+    ///     per thread use fewer threads.
+    public init(
+        blockByteCount: Int = _ParallelHash256.defaultBlockByteCount,
+        customization: Data = Data(),
+        maximumThreadCount: Int = 1
+    ) {
+        self.state = ParallelHashState(
+            .bits256,
+            blockByteCount: blockByteCount,
+            customization: customization,
+            maximumThreadCount: maximumThreadCount
+        )
+    }
+
+    /// Incrementally updates the function with the contents of the buffer.
+    public mutating func update(bufferPointer: UnsafeRawBufferPointer) {
+        self.state.update(bufferPointer)
+    }
+
+    /// Incrementally updates the function with the given data.
+    public mutating func update<D: DataProtocol>(data: D) {
+        for region in data.regions {
+            region.withUnsafeBytes { self.update(bufferPointer: $0) }
+        }
+    }
+
+    /// Returns `outputByteCount` bytes of ParallelHash256 output for the data absorbed so far.
+    public func finalize(outputByteCount: Int = 64) -> Data {
+        self.state.finalize(outputByteCount: outputByteCount, extendable: false)
+    }
+
+    /// Returns `outputByteCount` bytes of ParallelHashXOF256 output for the data absorbed so far.
+    public func finalizeXOF(outputByteCount: Int) -> Data {
+        self.state.finalize(outputByteCount: outputByteCount, extendable: true)
+    }
+
+    /// Computes `outputByteCount` bytes of ParallelHash256 output for `data`.
+    public static func hash<D: DataProtocol>(
+        data: D,
+        outputByteCount: Int = 64,
+        blockByteCount: Int = _ParallelHash256.defaultBlockByteCount,
+        customization: Data = Data(),
+        maximumThreadCount: Int = 1
+    ) -> Data {
+        var hash = Self(blockByteCount: blockByteCount, customization: customization, maximumThreadCount: maximumThreadCount)
+        hash.update(data: data)
+        return hash.finalize(outputByteCount: outputByteCount)
+    }
+}
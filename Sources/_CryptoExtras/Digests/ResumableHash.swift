@@ -0,0 +1,72 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+
+/// A SHA-2 hash state that can be forked cheaply, and exported as a midstate to be resumed later.
+///
+/// When many messages share a long common prefix, such as domain-separated transcripts or labeled
+/// extracts, the prefix only needs hashing once: absorb it, then copy the value once per message.
+/// Copying is a plain copy of the underlying hash state and never allocates. ``midstate`` serializes
+/// the same state, so a precomputed prefix can be persisted and restored with ``init(midstate:)``.
+///
+/// Only ``SHA256``, ``SHA384`` and ``SHA512`` are supported.
+///
+/// - Note: A midstate contains the tail of the absorbed input verbatim and is enough to extend it.
+///   Treat it as being as sensitive as the prefix itself.
+public struct _ResumableHash<H: HashFunction>: Sendable {
+    private var impl: OpenSSLResumableHashImpl
+
+    /// Creates an empty hash state.
+    ///
+    /// - Throws: `CryptoKitError.invalidParameter` if `H` is not a supported hash function.
+    public init() throws {
+        self.impl = try OpenSSLResumableHashImpl(H.self)
+    }
+
+    /// Restores a hash state from a midstate previously exported with ``midstate``.
+    ///
+    /// - Parameter midstate: The serialized state.
+    /// - Throws: `CryptoKitError.invalidParameter` if `H` is not supported or the midstate is malformed.
+    public init<Bytes: ContiguousBytes>(midstate: Bytes) throws {
+        self.impl = try midstate.withUnsafeBytes { try OpenSSLResumableHashImpl(H.self, midstate: $0) }
+    }
+
+    /// The serialized state: the chaining value, the number of bits absorbed and any partial block.
+    public var midstate: Data {
+        self.impl.midstate
+    }
+
+    /// Returns an independent copy of this state. This is the same as copying the value.
+    public func fork() -> _ResumableHash<H> {
+        return self
+    }
+
+    /// Absorbs the contents of the buffer.
+    public mutating func update(bufferPointer: UnsafeRawBufferPointer) {
+        self.impl.update(bufferPointer: bufferPointer)
+    }
+
+    /// Absorbs the given data.
+    public mutating func update<D: DataProtocol>(data: D) {
+        for region in data.regions {
+            region.withUnsafeBytes { self.impl.update(bufferPointer: $0) }
+        }
+    }
+
+    /// Returns the digest of everything absorbed so far. The state itself is left unchanged.
+    public func finalize() -> Data {
+        self.impl.finalize()
+    }
+}
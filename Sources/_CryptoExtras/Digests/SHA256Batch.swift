@@ -0,0 +1,37 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+extension SHA256 {
+    /// Computes the SHA-256 digest of many independent messages in a single call.
+    ///
+    /// This is intended for hashing large numbers of small messages, such as content-addressed
+    /// chunks or Merkle tree leaves, where the per-call overhead of ``SHA256/hash(data:)`` dominates.
+    /// The digests are written contiguously into `digests`, in the same order as `messages`.
+    /// On x86-64 CPUs with AVX2 but without the SHA extensions, the messages are hashed eight at a time, one
+    /// per vector lane.
+    ///
+    /// - Parameters:
+    ///   - messages: The messages to hash.
+    ///   - digests: The buffer to write the digests into. Must be exactly `messages.count * SHA256.byteCount` bytes.
+    /// - Throws: `CryptoKitError.incorrectParameterSize` if `digests` has the wrong size.
+    public static func _hash(batch messages: [UnsafeRawBufferPointer], into digests: UnsafeMutableRawBufferPointer) throws {
+        guard digests.count == messages.count * SHA256.byteCount else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+        OpenSSLSHA256BatchImpl.hash(batch: messages, into: digests)
+    }
+}
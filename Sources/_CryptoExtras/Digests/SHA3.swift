@@ -0,0 +1,194 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+/// An implementation of SHA3-256, as specified in FIPS 202.
+public struct _SHA3_256: HashFunction {
+    /// The number of bytes absorbed per permutation of the Keccak state.
+    public static let blockByteCount = 136
+
+    private var impl: OpenSSLKeccakImpl
+
+    /// Creates a SHA3-256 hash function.
+    public init() {
+        self.impl = OpenSSLKeccakImpl(.sha3_256)
+    }
+
+    /// Incrementally updates the hash function with the contents of the buffer.
+    public mutating func update(bufferPointer: UnsafeRawBufferPointer) {
+        self.impl.absorb(bufferPointer)
+    }
+
+    /// Finalizes the hash function and returns the computed digest.
+    public func finalize() -> _SHA3_256Digest {
+        var digest = _SHA3_256Digest()
+        var impl = self.impl
+        Swift.withUnsafeMutableBytes(of: &digest.bytes) { impl.squeeze(into: $0) }
+        return digest
+    }
+}
+
+/// The output of a SHA3-256 hash.
+public struct _SHA3_256Digest: Digest {
+    fileprivate var bytes: (UInt64, UInt64, UInt64, UInt64) = (0, 0, 0, 0)
+
+    fileprivate init() {}
+
+    /// The number of bytes in the digest.
+    public static var byteCount: Int {
+        return 32
+    }
+
+    /// Invokes the given closure with a buffer pointer covering the raw bytes of the digest.
+    public func withUnsafeBytes<R>(_ body: (UnsafeRawBufferPointer) throws -> R) rethrows -> R {
+        return try Swift.withUnsafeBytes(of: self.bytes, body)
+    }
+
+    /// Hashes the essential components of the digest by feeding them into the given hasher.
+    public func hash(into hasher: inout Hasher) {
+        self.withUnsafeBytes { hasher.combine(bytes: $0) }
+    }
+}
+
+/// An implementation of SHA3-512, as specified in FIPS 202.
+public struct _SHA3_512: HashFunction {
+    /// The number of bytes absorbed per permutation of the Keccak state.
+    public static let blockByteCount = 72
+
+    private var impl: OpenSSLKeccakImpl
+
+    /// Creates a SHA3-512 hash function.
+    public init() {
+        self.impl = OpenSSLKeccakImpl(.sha3_512)
+    }
+
+    /// Incrementally updates the hash function with the contents of the buffer.
+    public mutating func update(bufferPointer: UnsafeRawBufferPointer) {
+        self.impl.absorb(bufferPointer)
+    }
+
+    /// Finalizes the hash function and returns the computed digest.
+    public func finalize() -> _SHA3_512Digest {
+        var digest = _SHA3_512Digest()
+        var impl = self.impl
+        Swift.withUnsafeMutableBytes(of: &digest.bytes) { impl.squeeze(into: $0) }
+        return digest
+    }
+}
+
+/// The output of a SHA3-512 hash.
+public struct _SHA3_512Digest: Digest {
+    fileprivate var bytes: (UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64) = (0, 0, 0, 0, 0, 0, 0, 0)
+
+    fileprivate init() {}
+
+    /// The number of bytes in the digest.
+    public static var byteCount: Int {
+        return 64
+    }
+
+    /// Invokes the given closure with a buffer pointer covering the raw bytes of the digest.
+    public func withUnsafeBytes<R>(_ body: (UnsafeRawBufferPointer) throws -> R) rethrows -> R {
+        return try Swift.withUnsafeBytes(of: self.bytes, body)
+    }
+
+    /// Hashes the essential components of the digest by feeding them into the given hasher.
+    public func hash(into hasher: inout Hasher) {
+        self.withUnsafeBytes { hasher.combine(bytes: $0) }
+    }
+}
+
+/// An implementation of the SHAKE128 extendable-output function, as specified in FIPS 202.
+///
+/// Unlike a ``HashFunction``, the caller chooses how many bytes of output to produce.
+/// Finalizing doesn't consume the state, so more input can be absorbed afterwards.
+public struct _SHAKE128 {
+    /// The number of bytes absorbed per permutation of the Keccak state.
+    public static let blockByteCount = 168
+
+    private var impl: OpenSSLKeccakImpl
+
+    /// Creates a SHAKE128 function.
+    public init() {
+        self.impl = OpenSSLKeccakImpl(.shake128)
+    }
+
+    /// Incrementally updates the function with the contents of the buffer.
+    public mutating func update(bufferPointer: UnsafeRawBufferPointer) {
+        self.impl.absorb(bufferPointer)
+    }
+
+    /// Incrementally updates the function with the given data.
+    public mutating func update<D: DataProtocol>(data: D) {
+        for region in data.regions {
+            region.withUnsafeBytes { self.update(bufferPointer: $0) }
+        }
+    }
+
+    /// Returns `outputByteCount` bytes of output for the data absorbed so far.
+    public func finalize(outputByteCount: Int) -> Data {
+        precondition(outputByteCount >= 0)
+        return self.impl.squeezed(byteCount: outputByteCount)
+    }
+
+    /// Computes `outputByteCount` bytes of SHAKE128 output for `data`.
+    public static func hash<D: DataProtocol>(data: D, outputByteCount: Int) -> Data {
+        var shake = Self()
+        shake.update(data: data)
+        return shake.finalize(outputByteCount: outputByteCount)
+    }
+}
+
+/// An implementation of the SHAKE256 extendable-output function, as specified in FIPS 202.
+///
+/// Unlike a ``HashFunction``, the caller chooses how many bytes of output to produce.
+/// Finalizing doesn't consume the state, so more input can be absorbed afterwards.
+public struct _SHAKE256 {
+    /// The number of bytes absorbed per permutation of the Keccak state.
+    public static let blockByteCount = 136
+
+    private var impl: OpenSSLKeccakImpl
+
+    /// Creates a SHAKE256 function.
+    public init() {
+        self.impl = OpenSSLKeccakImpl(.shake256)
+    }
+
+    /// Incrementally updates the function with the contents of the buffer.
+    public mutating func update(bufferPointer: UnsafeRawBufferPointer) {
+        self.impl.absorb(bufferPointer)
+    }
+
+    /// Incrementally updates the function with the given data.
+    public mutating func update<D: DataProtocol>(data: D) {
+        for region in data.regions {
+            region.withUnsafeBytes { self.update(bufferPointer: $0) }
+        }
+    }
+
+    /// Returns `outputByteCount` bytes of output for the data absorbed so far.
+    public func finalize(outputByteCount: Int) -> Data {
+        precondition(outputByteCount >= 0)
+        return self.impl.squeezed(byteCount: outputByteCount)
+    }
+
+    /// Computes `outputByteCount` bytes of SHAKE256 output for `data`.
+    public static func hash<D: DataProtocol>(data: D, outputByteCount: Int) -> Data {
+        var shake = Self()
+        shake.update(data: data)
+        return shake.finalize(outputByteCount: outputByteCount)
+    }
+}
@@ -0,0 +1,116 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+
+/// An implementation of SHA-512/256, as specified in FIPS 180-4.
+///
+/// SHA-512/256 is SHA-512 with a distinct initial value, truncated to 256 bits. It works on 64-bit words, so on
+/// 64-bit processors without SHA-256 instructions it hashes long inputs about one and a half times as fast as
+/// ``SHA256``, for a digest of the same size. It can be used with ``HMAC`` and ``HKDF`` like any other hash function.
+public struct _SHA512_256: HashFunction {
+    /// The number of bytes that represents the hash function’s internal state.
+    public static let blockByteCount = 128
+
+    private var impl: OpenSSLSHA512TruncatedImpl
+
+    /// Creates a SHA-512/256 hash function.
+    public init() {
+        self.impl = OpenSSLSHA512TruncatedImpl(.sha512_256)
+    }
+
+    /// Incrementally updates the hash function with the contents of the buffer.
+    public mutating func update(bufferPointer: UnsafeRawBufferPointer) {
+        self.impl.update(bufferPointer)
+    }
+
+    /// Finalizes the hash function and returns the computed digest.
+    public func finalize() -> _SHA512_256Digest {
+        var digest = _SHA512_256Digest()
+        Swift.withUnsafeMutableBytes(of: &digest.bytes) { self.impl.finalize(into: $0) }
+        return digest
+    }
+}
+
+/// The output of a SHA-512/256 hash.
+public struct _SHA512_256Digest: Digest {
+    fileprivate var bytes: (UInt64, UInt64, UInt64, UInt64) = (0, 0, 0, 0)
+
+    fileprivate init() {}
+
+    /// The number of bytes in the digest.
+    public static var byteCount: Int {
+        return 32
+    }
+
+    /// Invokes the given closure with a buffer pointer covering the raw bytes of the digest.
+    public func withUnsafeBytes<R>(_ body: (UnsafeRawBufferPointer) throws -> R) rethrows -> R {
+        return try Swift.withUnsafeBytes(of: self.bytes, body)
+    }
+
+    /// Hashes the essential components of the digest by feeding them into the given hasher.
+    public func hash(into hasher: inout Hasher) {
+        self.withUnsafeBytes { hasher.combine(bytes: $0) }
+    }
+}
+
+/// An implementation of SHA-512/224, as specified in FIPS 180-4.
+///
+/// SHA-512/224 is SHA-512 with a distinct initial value, truncated to 224 bits.
+public struct _SHA512_224: HashFunction {
+    /// The number of bytes that represents the hash function’s internal state.
+    public static let blockByteCount = 128
+
+    private var impl: OpenSSLSHA512TruncatedImpl
+
+    /// Creates a SHA-512/224 hash function.
+    public init() {
+        self.impl = OpenSSLSHA512TruncatedImpl(.sha512_224)
+    }
+
+    /// Incrementally updates the hash function with the contents of the buffer.
+    public mutating func update(bufferPointer: UnsafeRawBufferPointer) {
+        self.impl.update(bufferPointer)
+    }
+
+    /// Finalizes the hash function and returns the computed digest.
+    public func finalize() -> _SHA512_224Digest {
+        var digest = _SHA512_224Digest()
+        Swift.withUnsafeMutableBytes(of: &digest.bytes) { self.impl.finalize(into: UnsafeMutableRawBufferPointer(rebasing: $0.prefix(28))) }
+        return digest
+    }
+}
+
+/// The output of a SHA-512/224 hash.
+public struct _SHA512_224Digest: Digest {
+    // 28 bytes, as three and a half words; the last four bytes are always zero.
+    fileprivate var bytes: (UInt64, UInt64, UInt64, UInt64) = (0, 0, 0, 0)
+
+    fileprivate init() {}
+
+    /// The number of bytes in the digest.
+    public static var byteCount: Int {
+        return 28
+    }
+
+    /// Invokes the given closure with a buffer pointer covering the raw bytes of the digest.
+    public func withUnsafeBytes<R>(_ body: (UnsafeRawBufferPointer) throws -> R) rethrows -> R {
+        return try Swift.withUnsafeBytes(of: self.bytes) { try body(UnsafeRawBufferPointer(rebasing: $0.prefix(Self.byteCount))) }
+    }
+
+    /// Hashes the essential components of the digest by feeding them into the given hasher.
+    public func hash(into hasher: inout Hasher) {
+        self.withUnsafeBytes { hasher.combine(bytes: $0) }
+    }
+}
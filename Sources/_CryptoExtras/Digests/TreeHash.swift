@@ -0,0 +1,159 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+/// A Merkle tree hash over fixed-size leaves of a single large input.
+///
+/// A single hash stream is limited to one core. A tree hash splits the input into fixed-size
+/// leaves that can be hashed concurrently, and then combines the leaf digests into a single root.
+/// The tree is constructed as in RFC 6962: leaves are hashed as `H(0x00 || leaf)` and interior
+/// nodes as `H(0x01 || left || right)`, so the root can't be confused with the plain hash of
+/// any input.
+///
+/// The tree keeps every level of interior digests, so replacing the contents of a single leaf
+/// only re-hashes that leaf and its path to the root.
+///
+/// - Note: The root of a tree hash is *not* the same as the plain ``HashFunction`` digest of the
+///   input, and it also depends on ``leafByteCount``. Both parties must agree on the construction.
+public struct _TreeHash<H: HashFunction> {
+    /// The size of every leaf except possibly the last.
+    public let leafByteCount: Int
+
+    /// The digests of each level of the tree, from the leaves (index 0) to the root.
+    private var levels: [[H.Digest]]
+
+    /// Builds the tree hash of `data`.
+    ///
+    /// - Parameters:
+    ///   - data: The input to hash.
+    ///   - leafByteCount: The size of each leaf. Must be positive. Defaults to 1 MiB.
+    ///   - concurrently: Whether to hash the leaves concurrently across all available cores.
+    public init(hashing data: UnsafeRawBufferPointer, leafByteCount: Int = 1 << 20, concurrently: Bool = true) {
+        precondition(leafByteCount > 0)
+        self.leafByteCount = leafByteCount
+
+        // An empty input still has a single, empty, leaf.
+        let leafCount = max(1, (data.count + leafByteCount - 1) / leafByteCount)
+        let leaves = [H.Digest](unsafeUninitializedCapacity: leafCount) { buffer, initializedCount in
+            let base = buffer.baseAddress!
+            let hashLeaf = { (index: Int) in
+                let start = index * leafByteCount
+                let end = min(start + leafByteCount, data.count)
+                (base + index).initialize(to: Self.leafDigest(UnsafeRawBufferPointer(rebasing: data[start..<end])))
+            }
+
+            if concurrently && leafCount > 1 {
+                DispatchQueue.concurrentPerform(iterations: leafCount, execute: hashLeaf)
+            } else {
+                (0..<leafCount).forEach(hashLeaf)
+            }
+            initializedCount = leafCount
+        }
+
+        self.levels = [leaves]
+        self.buildLevels()
+    }
+
+    /// Builds the tree hash of `data`.
+    ///
+    /// - Parameters:
+    ///   - data: The input to hash.
+    ///   - leafByteCount: The size of each leaf. Must be positive. Defaults to 1 MiB.
+    ///   - concurrently: Whether to hash the leaves concurrently across all available cores.
+    public init<D: DataProtocol>(hashing data: D, leafByteCount: Int = 1 << 20, concurrently: Bool = true) {
+        if data.regions.count == 1 {
+            self = data.regions.first!.withUnsafeBytes {
+                Self(hashing: $0, leafByteCount: leafByteCount, concurrently: concurrently)
+            }
+        } else {
+            self = Array(data).withUnsafeBytes {
+                Self(hashing: $0, leafByteCount: leafByteCount, concurrently: concurrently)
+            }
+        }
+    }
+
+    /// The number of leaves in the tree.
+    public var leafCount: Int {
+        self.levels[0].count
+    }
+
+    /// The root digest of the tree.
+    public var root: H.Digest {
+        self.levels.last!.first!
+    }
+
+    /// Replaces the contents of a single leaf, re-hashing only that leaf and its path to the root.
+    ///
+    /// - Parameters:
+    ///   - index: The index of the leaf to replace.
+    ///   - data: The new contents of the leaf. Every leaf but the last must be exactly ``leafByteCount`` bytes,
+    ///     and the last leaf may be at most that size.
+    public mutating func updateLeaf<D: DataProtocol>(at index: Int, with data: D) {
+        precondition(self.levels[0].indices.contains(index))
+        precondition(index == self.leafCount - 1 ? data.count <= self.leafByteCount : data.count == self.leafByteCount)
+
+        var digest: H.Digest
+        if data.regions.count == 1 {
+            digest = data.regions.first!.withUnsafeBytes { Self.leafDigest($0) }
+        } else {
+            digest = Array(data).withUnsafeBytes { Self.leafDigest($0) }
+        }
+
+        var index = index
+        self.levels[0][index] = digest
+        for level in self.levels.indices.dropFirst() {
+            let below = self.levels[level - 1]
+            let sibling = index ^ 1
+            if sibling < below.count {
+                digest = index & 1 == 0 ? Self.nodeDigest(digest, below[sibling]) : Self.nodeDigest(below[sibling], digest)
+            }
+            // Otherwise this node has no sibling, and is promoted to the level above unchanged.
+            index >>= 1
+            self.levels[level][index] = digest
+        }
+    }
+
+    private mutating func buildLevels() {
+        while self.levels.last!.count > 1 {
+            let below = self.levels.last!
+            var level = [H.Digest]()
+            level.reserveCapacity((below.count + 1) / 2)
+            for pairStart in stride(from: 0, to: below.count, by: 2) {
+                if pairStart + 1 < below.count {
+                    level.append(Self.nodeDigest(below[pairStart], below[pairStart + 1]))
+                } else {
+                    level.append(below[pairStart])
+                }
+            }
+            self.levels.append(level)
+        }
+    }
+
+    private static func leafDigest(_ leaf: UnsafeRawBufferPointer) -> H.Digest {
+        var hasher = H()
+        withUnsafeBytes(of: UInt8(0x00)) { hasher.update(bufferPointer: $0) }
+        hasher.update(bufferPointer: leaf)
+        return hasher.finalize()
+    }
+
+    private static func nodeDigest(_ left: H.Digest, _ right: H.Digest) -> H.Digest {
+        var hasher = H()
+        withUnsafeBytes(of: UInt8(0x01)) { hasher.update(bufferPointer: $0) }
+        left.withUnsafeBytes { hasher.update(bufferPointer: $0) }
+        right.withUnsafeBytes { hasher.update(bufferPointer: $0) }
+        return hasher.finalize()
+    }
+}
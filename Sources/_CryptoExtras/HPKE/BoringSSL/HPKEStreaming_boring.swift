@@ -0,0 +1,113 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+@_implementationOnly import CryptoBoringWrapper
+import Foundation
+
+/// The AEAD half of an HPKE context: a long-lived `EVP_AEAD_CTX`, the base nonce and the sequence number.
+///
+/// This is a class so that copies of the owning sender or recipient share one sequence number and can never
+/// reuse a nonce.
+final class HPKEAEADStream {
+    static let tagByteCount = 16
+
+    private let context: BoringSSLAEAD.AEADContext
+
+    private let baseNonce: [UInt8]
+
+    /// The nonce for the current sequence number. Only the low eight bytes ever differ from the base nonce.
+    private var nonce: [UInt8]
+
+    private var sequenceNumber: UInt64 = 0
+
+    private var isExhausted = false
+
+    init(schedule: HPKEKeySchedule, aead: HPKE.AEAD) throws {
+        let algorithm: AEADAlgorithm
+        switch aead {
+        case .AES_GCM_128, .AES_GCM_256:
+            algorithm = .aesGCM
+        case .chaChaPoly:
+            algorithm = .chaChaPoly
+        case .exportOnly:
+            throw HPKE.Errors.exportOnlyMode
+        }
+        guard let key = schedule.key else {
+            throw HPKE.Errors.exportOnlyMode
+        }
+
+        self.context = try BoringSSLAEAD.AEADContext(cipher: BoringSSLAEAD(algorithm, key: key), key: key)
+        self.baseNonce = schedule.baseNonce
+        self.nonce = schedule.baseNonce
+        precondition(self.nonce.count >= MemoryLayout<UInt64>.size)
+    }
+
+    func seal<AuthenticatedData: DataProtocol>(
+        _ message: UnsafeRawBufferPointer,
+        into output: UnsafeMutableRawBufferPointer,
+        authenticating authenticatedData: AuthenticatedData
+    ) throws {
+        guard output.count == message.count + Self.tagByteCount else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+        try self.withCurrentNonce { nonce in
+            try self.context.seal(message: message, nonce: nonce, authenticatedData: authenticatedData, into: output)
+        }
+    }
+
+    func open<AuthenticatedData: DataProtocol>(
+        inPlace buffer: UnsafeMutableRawBufferPointer,
+        authenticating authenticatedData: AuthenticatedData
+    ) throws -> Int {
+        guard buffer.count >= Self.tagByteCount else {
+            throw HPKE.Errors.ciphertextTooShort
+        }
+        return try self.withCurrentNonce { nonce in
+            try self.context.open(inPlace: buffer, nonce: nonce, authenticatedData: authenticatedData)
+        }
+    }
+
+    /// Runs `body` with the nonce for the current sequence number, and advances the sequence number if it succeeds.
+    private func withCurrentNonce<Result>(_ body: ([UInt8]) throws -> Result) throws -> Result {
+        guard !self.isExhausted else {
+            throw HPKE.Errors.outOfRangeSequenceNumber
+        }
+
+        let result: Result
+        do {
+            result = try body(self.nonce)
+        } catch CryptoBoringWrapperError.underlyingCoreCryptoError(let errorCode) {
+            throw CryptoKitError.underlyingCoreCryptoError(error: errorCode)
+        }
+
+        if self.sequenceNumber == .max {
+            self.isExhausted = true
+        } else {
+            self.sequenceNumber += 1
+            self.updateNonce()
+        }
+        return result
+    }
+
+    /// XORs the big-endian sequence number into the low bytes of the base nonce, in place.
+    private func updateNonce() {
+        let offset = self.nonce.count - MemoryLayout<UInt64>.size
+        var sequenceNumber = self.sequenceNumber
+        for index in (offset..<self.nonce.count).reversed() {
+            self.nonce[index] = self.baseNonce[index] ^ UInt8(truncatingIfNeeded: sequenceNumber)
+            sequenceNumber >>= 8
+        }
+    }
+}
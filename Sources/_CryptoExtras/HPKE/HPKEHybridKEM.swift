@@ -0,0 +1,226 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+extension HPKE {
+    /// The X25519Kyber768Draft00 hybrid key encapsulation mechanism, from draft-westerbaan-cfrg-hpke-xyber768d00.
+    ///
+    /// The shared secret is the concatenation of an X25519 DHKEM secret and a Kyber768 secret, so a message stays
+    /// confidential as long as either of the two stays unbroken.
+    public enum _X25519Kyber768Draft00 {
+        /// The `kem_id` from the HPKE IANA registry.
+        static let codePoint: UInt16 = 0x0030
+
+        /// The KEM that the classical half uses.
+        static let x25519KEM = HPKE.KEM.Curve25519_HKDF_SHA256
+
+        static let x25519KeyByteCount = 32
+
+        /// The number of bytes in an encoded public key.
+        public static let publicKeyByteCount = Self.x25519KeyByteCount + _Kyber768.publicKeyByteCount
+
+        /// The number of bytes in an encapsulated key.
+        public static let encapsulatedKeyByteCount = Self.x25519KeyByteCount + _Kyber768.ciphertextByteCount
+
+        /// A hybrid public key: an X25519 key and a Kyber768 key.
+        public struct PublicKey: KEMPublicKey {
+            /// The classical half of the key.
+            public let x25519: Curve25519.KeyAgreement.PublicKey
+
+            /// The post-quantum half of the key.
+            public let kyber: _Kyber768.PublicKey
+
+            /// Creates a hybrid public key from its two halves.
+            public init(x25519: Curve25519.KeyAgreement.PublicKey, kyber: _Kyber768.PublicKey) {
+                self.x25519 = x25519
+                self.kyber = kyber
+            }
+
+            /// Parses an encoded public key: the X25519 key followed by the Kyber768 key.
+            public init<Bytes: ContiguousBytes>(rawRepresentation: Bytes) throws {
+                let (x25519, kyber) = try rawRepresentation.withUnsafeBytes { bytes in
+                    guard bytes.count == _X25519Kyber768Draft00.publicKeyByteCount else {
+                        throw CryptoKitError.incorrectKeySize
+                    }
+                    let split = _X25519Kyber768Draft00.x25519KeyByteCount
+                    return (
+                        try Curve25519.KeyAgreement.PublicKey(rawRepresentation: UnsafeRawBufferPointer(rebasing: bytes[..<split])),
+                        try _Kyber768.PublicKey(rawRepresentation: UnsafeRawBufferPointer(rebasing: bytes[split...]))
+                    )
+                }
+                self.x25519 = x25519
+                self.kyber = kyber
+            }
+
+            /// The encoding of the key.
+            public var rawRepresentation: Data {
+                self.x25519.rawRepresentation + self.kyber.rawRepresentation
+            }
+
+            /// Generates a random 64-byte shared secret and encapsulates it to this key.
+            public func encapsulate() throws -> KEM.EncapsulationResult {
+                let (x25519Secret, x25519Encapsulated) = try HPKEDHKEM.encapsulate(to: self.x25519, kem: _X25519Kyber768Draft00.x25519KEM)
+                let kyber = try self.kyber.encapsulate()
+                return KEM.EncapsulationResult(
+                    sharedSecret: _X25519Kyber768Draft00.combine(x25519Secret, kyber.sharedSecret),
+                    encapsulated: x25519Encapsulated + kyber.encapsulated
+                )
+            }
+        }
+
+        /// A hybrid private key: an X25519 key and a Kyber768 key.
+        public struct PrivateKey: KEMPrivateKey {
+            /// The classical half of the key.
+            public let x25519: Curve25519.KeyAgreement.PrivateKey
+
+            /// The post-quantum half of the key.
+            public let kyber: _Kyber768.PrivateKey
+
+            /// Creates a hybrid private key from its two halves.
+            public init(x25519: Curve25519.KeyAgreement.PrivateKey, kyber: _Kyber768.PrivateKey) {
+                self.x25519 = x25519
+                self.kyber = kyber
+            }
+
+            /// Generates a random private key.
+            public init() {
+                self.init(x25519: Curve25519.KeyAgreement.PrivateKey(), kyber: _Kyber768.PrivateKey())
+            }
+
+            /// Generates a random private key.
+            public static func generate() throws -> Self {
+                Self()
+            }
+
+            /// The public key that corresponds to this private key.
+            public var publicKey: PublicKey {
+                PublicKey(x25519: self.x25519.publicKey, kyber: self.kyber.publicKey)
+            }
+
+            /// Recovers the 64-byte shared secret from a key encapsulated to this key's public key.
+            public func decapsulate(_ encapsulated: Data) throws -> SymmetricKey {
+                guard encapsulated.count == _X25519Kyber768Draft00.encapsulatedKeyByteCount else {
+                    throw CryptoKitError.incorrectParameterSize
+                }
+                let split = encapsulated.startIndex + _X25519Kyber768Draft00.x25519KeyByteCount
+                let x25519Secret = try HPKEDHKEM.decapsulate(Data(encapsulated[..<split]), using: self.x25519, kem: _X25519Kyber768Draft00.x25519KEM)
+                let kyberSecret = try self.kyber.decapsulate(Data(encapsulated[split...]))
+                return _X25519Kyber768Draft00.combine(x25519Secret, kyberSecret)
+            }
+        }
+
+        private static func combine(_ x25519Secret: SymmetricKey, _ kyberSecret: SymmetricKey) -> SymmetricKey {
+            var combined = x25519Secret.withUnsafeBytes { Array($0) }
+            kyberSecret.withUnsafeBytes { combined.append(contentsOf: $0) }
+            defer {
+                combined.withUnsafeMutableBytes { $0.initializeMemory(as: UInt8.self, repeating: 0) }
+            }
+            return SymmetricKey(data: combined)
+        }
+    }
+
+    /// An HPKE base-mode sender that encapsulates with the X25519Kyber768Draft00 hybrid KEM.
+    ///
+    /// ``HPKE/Ciphersuite`` can only name the KEMs of RFC 9180, so the KDF and AEAD are given separately.
+    public struct _HybridSender {
+        /// The encapsulated symmetric key that the recipient uses to decrypt messages.
+        public let encapsulatedKey: Data
+
+        private let stream: HPKEAEADStream
+
+        /// Creates a sender in base mode.
+        ///
+        /// - Parameters:
+        ///   - recipientKey: The recipient's public key for encrypting the messages.
+        ///   - kdf: The key derivation function for the key schedule.
+        ///   - aead: The AEAD that encrypts the messages.
+        ///   - info: Data that the key derivation function uses to compute the symmetric key material.
+        public init(recipientKey: _X25519Kyber768Draft00.PublicKey, kdf: HPKE.KDF, aead: HPKE.AEAD, info: Data) throws {
+            let encapsulation = try recipientKey.encapsulate()
+            let inputs = HPKEKeyScheduleInputs(kemCodePoint: _X25519Kyber768Draft00.codePoint, kdf: kdf, aead: aead, info: info)
+            self.stream = try HPKEAEADStream(schedule: HPKEKeySchedule(sharedSecret: encapsulation.sharedSecret, inputs: inputs), aead: aead)
+            self.encapsulatedKey = encapsulation.encapsulated
+        }
+
+        /// Encrypts the next message in the stream.
+        ///
+        /// - Parameters:
+        ///   - message: The plaintext to encrypt.
+        ///   - aad: Additional data to authenticate.
+        /// - Returns: The ciphertext followed by the tag.
+        public mutating func seal<Message: DataProtocol, AuthenticatedData: DataProtocol>(
+            _ message: Message,
+            authenticating aad: AuthenticatedData
+        ) throws -> Data {
+            let message = Array(message)
+            var ciphertext = Data(repeating: 0, count: message.count + HPKEAEADStream.tagByteCount)
+            try message.withUnsafeBytes { message in
+                try ciphertext.withUnsafeMutableBytes { try self.stream.seal(message, into: $0, authenticating: aad) }
+            }
+            return ciphertext
+        }
+
+        /// Encrypts the next message in the stream.
+        ///
+        /// - Parameter message: The plaintext to encrypt.
+        /// - Returns: The ciphertext followed by the tag.
+        public mutating func seal<Message: DataProtocol>(_ message: Message) throws -> Data {
+            try self.seal(message, authenticating: [UInt8]())
+        }
+    }
+
+    /// An HPKE base-mode recipient for messages from a ``HPKE/_HybridSender``.
+    public struct _HybridRecipient {
+        private let stream: HPKEAEADStream
+
+        /// Creates a recipient in base mode.
+        ///
+        /// - Parameters:
+        ///   - privateKey: The recipient's private key for decrypting the incoming messages.
+        ///   - kdf: The key derivation function for the key schedule.
+        ///   - aead: The AEAD that encrypts the messages.
+        ///   - info: Data that the key derivation function uses to compute the symmetric key material.
+        ///   - encapsulatedKey: The encapsulated symmetric key that the sender provides.
+        public init(privateKey: _X25519Kyber768Draft00.PrivateKey, kdf: HPKE.KDF, aead: HPKE.AEAD, info: Data, encapsulatedKey: Data) throws {
+            let sharedSecret = try privateKey.decapsulate(encapsulatedKey)
+            let inputs = HPKEKeyScheduleInputs(kemCodePoint: _X25519Kyber768Draft00.codePoint, kdf: kdf, aead: aead, info: info)
+            self.stream = try HPKEAEADStream(schedule: HPKEKeySchedule(sharedSecret: sharedSecret, inputs: inputs), aead: aead)
+        }
+
+        /// Decrypts the next message in the stream.
+        ///
+        /// - Parameters:
+        ///   - ciphertext: The ciphertext followed by the tag.
+        ///   - aad: Additional data that was authenticated with the message.
+        /// - Returns: The plaintext.
+        public mutating func open<Ciphertext: DataProtocol, AuthenticatedData: DataProtocol>(
+            _ ciphertext: Ciphertext,
+            authenticating aad: AuthenticatedData
+        ) throws -> Data {
+            var buffer = Data(ciphertext)
+            let plaintextByteCount = try buffer.withUnsafeMutableBytes { try self.stream.open(inPlace: $0, authenticating: aad) }
+            return buffer.prefix(plaintextByteCount)
+        }
+
+        /// Decrypts the next message in the stream.
+        ///
+        /// - Parameter ciphertext: The ciphertext followed by the tag.
+        /// - Returns: The plaintext.
+        public mutating func open<Ciphertext: DataProtocol>(_ ciphertext: Ciphertext) throws -> Data {
+            try self.open(ciphertext, authenticating: [UInt8]())
+        }
+    }
+}
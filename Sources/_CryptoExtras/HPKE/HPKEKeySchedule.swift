@@ -0,0 +1,255 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+// The HPKE code in Crypto is internal to that module, so the extensions in this module carry their own copy of the
+// RFC 9180 base-mode key schedule, built from the public HKDF and AEAD APIs.
+
+extension HPKE.KEM {
+    /// The `kem_id` from the HPKE IANA registry.
+    var codePoint: UInt16 {
+        switch self {
+        case .P256_HKDF_SHA256: return 0x0010
+        case .P384_HKDF_SHA384: return 0x0011
+        case .P521_HKDF_SHA512: return 0x0012
+        case .Curve25519_HKDF_SHA256: return 0x0020
+        }
+    }
+
+    /// The KDF that the DHKEM uses to derive its shared secret.
+    var keyDerivationFunction: HPKE.KDF {
+        switch self {
+        case .P256_HKDF_SHA256, .Curve25519_HKDF_SHA256: return .HKDF_SHA256
+        case .P384_HKDF_SHA384: return .HKDF_SHA384
+        case .P521_HKDF_SHA512: return .HKDF_SHA512
+        }
+    }
+
+    /// `Nsecret`, the length of the KEM shared secret.
+    var sharedSecretByteCount: Int {
+        switch self {
+        case .P256_HKDF_SHA256, .Curve25519_HKDF_SHA256: return 32
+        case .P384_HKDF_SHA384: return 48
+        case .P521_HKDF_SHA512: return 64
+        }
+    }
+}
+
+extension HPKE.KDF {
+    /// The `kdf_id` from the HPKE IANA registry.
+    var codePoint: UInt16 {
+        switch self {
+        case .HKDF_SHA256: return 0x0001
+        case .HKDF_SHA384: return 0x0002
+        case .HKDF_SHA512: return 0x0003
+        }
+    }
+}
+
+extension HPKE.AEAD {
+    /// The `aead_id` from the HPKE IANA registry.
+    var codePoint: UInt16 {
+        switch self {
+        case .AES_GCM_128: return 0x0001
+        case .AES_GCM_256: return 0x0002
+        case .chaChaPoly: return 0x0003
+        case .exportOnly: return 0xFFFF
+        }
+    }
+
+    /// `Nk`, the length of the AEAD key.
+    var aeadKeyByteCount: Int {
+        switch self {
+        case .AES_GCM_128: return 16
+        case .AES_GCM_256, .chaChaPoly: return 32
+        case .exportOnly: return 0
+        }
+    }
+
+    /// `Nn`, the length of the AEAD nonce.
+    var aeadNonceByteCount: Int {
+        switch self {
+        case .AES_GCM_128, .AES_GCM_256, .chaChaPoly: return 12
+        case .exportOnly: return 0
+        }
+    }
+
+    /// `Nt`, the length of the AEAD tag.
+    var aeadTagByteCount: Int {
+        switch self {
+        case .AES_GCM_128, .AES_GCM_256, .chaChaPoly: return 16
+        case .exportOnly: return 0
+        }
+    }
+}
+
+extension Array where Element == UInt8 {
+    /// Appends `value` in big-endian order, as `I2OSP(value, 2)`.
+    fileprivate mutating func appendBigEndian(_ value: UInt16) {
+        self.append(UInt8(truncatingIfNeeded: value >> 8))
+        self.append(UInt8(truncatingIfNeeded: value))
+    }
+}
+
+/// The `LabeledExtract` and `LabeledExpand` functions of RFC 9180, section 4, for one suite ID.
+struct HPKELabeledKDF {
+    private static let protocolLabel = Array("HPKE-v1".utf8)
+
+    let kdf: HPKE.KDF
+
+    let suiteID: [UInt8]
+
+    /// The KDF a DHKEM uses, with the `"KEM" || I2OSP(kem_id, 2)` suite ID.
+    init(kem: HPKE.KEM) {
+        var suiteID = Array("KEM".utf8)
+        suiteID.appendBigEndian(kem.codePoint)
+        self.kdf = kem.keyDerivationFunction
+        self.suiteID = suiteID
+    }
+
+    /// The KDF the key schedule uses, with the `"HPKE" || kem_id || kdf_id || aead_id` suite ID.
+    init(kemCodePoint: UInt16, kdf: HPKE.KDF, aead: HPKE.AEAD) {
+        var suiteID = Array("HPKE".utf8)
+        suiteID.appendBigEndian(kemCodePoint)
+        suiteID.appendBigEndian(kdf.codePoint)
+        suiteID.appendBigEndian(aead.codePoint)
+        self.kdf = kdf
+        self.suiteID = suiteID
+    }
+
+    func extract<Salt: ContiguousBytes>(salt: Salt, label: String, ikm: ContiguousBytes?) -> [UInt8] {
+        var labeledIKM = Self.protocolLabel
+        labeledIKM.append(contentsOf: self.suiteID)
+        labeledIKM.append(contentsOf: label.utf8)
+        ikm?.withUnsafeBytes { labeledIKM.append(contentsOf: $0) }
+        defer {
+            labeledIKM.withUnsafeMutableBytes { $0.initializeMemory(as: UInt8.self, repeating: 0) }
+        }
+
+        let inputKeyMaterial = SymmetricKey(data: labeledIKM)
+        return salt.withUnsafeBytes { salt in
+            switch self.kdf {
+            case .HKDF_SHA256:
+                return Array(HKDF<SHA256>.extract(inputKeyMaterial: inputKeyMaterial, salt: salt))
+            case .HKDF_SHA384:
+                return Array(HKDF<SHA384>.extract(inputKeyMaterial: inputKeyMaterial, salt: salt))
+            case .HKDF_SHA512:
+                return Array(HKDF<SHA512>.extract(inputKeyMaterial: inputKeyMaterial, salt: salt))
+            }
+        }
+    }
+
+    func expand<PRK: ContiguousBytes>(prk: PRK, label: String, info: [UInt8], outputByteCount: Int) -> SymmetricKey {
+        var labeledInfo = [UInt8]()
+        labeledInfo.appendBigEndian(UInt16(outputByteCount))
+        labeledInfo.append(contentsOf: Self.protocolLabel)
+        labeledInfo.append(contentsOf: self.suiteID)
+        labeledInfo.append(contentsOf: label.utf8)
+        labeledInfo.append(contentsOf: info)
+
+        switch self.kdf {
+        case .HKDF_SHA256:
+            return HKDF<SHA256>.expand(pseudoRandomKey: prk, info: labeledInfo, outputByteCount: outputByteCount)
+        case .HKDF_SHA384:
+            return HKDF<SHA384>.expand(pseudoRandomKey: prk, info: labeledInfo, outputByteCount: outputByteCount)
+        case .HKDF_SHA512:
+            return HKDF<SHA512>.expand(pseudoRandomKey: prk, info: labeledInfo, outputByteCount: outputByteCount)
+        }
+    }
+}
+
+enum HPKEDHKEM {
+    /// `ExtractAndExpand` from the DHKEM construction of RFC 9180, section 4.1.
+    static func sharedSecret(dh: ContiguousBytes, encapsulatedKey: Data, recipientKey: Data, kem: HPKE.KEM) -> SymmetricKey {
+        let kdf = HPKELabeledKDF(kem: kem)
+        var eaePRK = kdf.extract(salt: [UInt8](), label: "eae_prk", ikm: dh)
+        defer {
+            eaePRK.withUnsafeMutableBytes { $0.initializeMemory(as: UInt8.self, repeating: 0) }
+        }
+        let kemContext = Array(encapsulatedKey) + Array(recipientKey)
+        return kdf.expand(prk: eaePRK, label: "shared_secret", info: kemContext, outputByteCount: kem.sharedSecretByteCount)
+    }
+
+    /// `Encap` for a single recipient, with a fresh ephemeral key.
+    static func encapsulate<PublicKey: HPKEDiffieHellmanPublicKey>(to recipientKey: PublicKey, kem: HPKE.KEM) throws -> (sharedSecret: SymmetricKey, encapsulatedKey: Data) {
+        let recipientRepresentation = try recipientKey.hpkeRepresentation(kem: kem)
+        let ephemeralKey = PublicKey.EphemeralPrivateKey()
+        let encapsulatedKey = try ephemeralKey.publicKey.hpkeRepresentation(kem: kem)
+        let dh = try ephemeralKey.sharedSecretFromKeyAgreement(with: recipientKey)
+        let sharedSecret = Self.sharedSecret(dh: dh, encapsulatedKey: encapsulatedKey, recipientKey: recipientRepresentation, kem: kem)
+        return (sharedSecret, encapsulatedKey)
+    }
+
+    /// `Decap` of an encapsulated key with the recipient's private key.
+    static func decapsulate<PrivateKey: HPKEDiffieHellmanPrivateKey>(_ encapsulatedKey: Data, using privateKey: PrivateKey, kem: HPKE.KEM) throws -> SymmetricKey {
+        let ephemeralKey = try PrivateKey.PublicKey(encapsulatedKey, kem: kem)
+        let dh = try privateKey.sharedSecretFromKeyAgreement(with: ephemeralKey)
+        let recipientRepresentation = try privateKey.publicKey.hpkeRepresentation(kem: kem)
+        return Self.sharedSecret(dh: dh, encapsulatedKey: encapsulatedKey, recipientKey: recipientRepresentation, kem: kem)
+    }
+}
+
+/// The parts of the base-mode key schedule that depend only on the cipher suite and `info`,
+/// so they can be shared by every context created with them.
+struct HPKEKeyScheduleInputs {
+    let aead: HPKE.AEAD
+
+    let kdf: HPKELabeledKDF
+
+    /// `key_schedule_context`: the mode, `psk_id_hash` and `info_hash`.
+    let context: [UInt8]
+
+    init(ciphersuite: HPKE.Ciphersuite, info: Data) {
+        self.init(kemCodePoint: ciphersuite.kem.codePoint, kdf: ciphersuite.kdf, aead: ciphersuite.aead, info: info)
+    }
+
+    /// Inputs for a KEM that ``HPKE/KEM`` can't represent.
+    init(kemCodePoint: UInt16, kdf: HPKE.KDF, aead: HPKE.AEAD, info: Data) {
+        let kdf = HPKELabeledKDF(kemCodePoint: kemCodePoint, kdf: kdf, aead: aead)
+        var context: [UInt8] = [0x00]  // mode_base
+        context.append(contentsOf: kdf.extract(salt: [UInt8](), label: "psk_id_hash", ikm: nil))
+        context.append(contentsOf: kdf.extract(salt: [UInt8](), label: "info_hash", ikm: info))
+
+        self.aead = aead
+        self.kdf = kdf
+        self.context = context
+    }
+}
+
+/// The AEAD key and base nonce derived by the base-mode key schedule.
+struct HPKEKeySchedule {
+    /// The AEAD key, or `nil` for export-only cipher suites.
+    let key: SymmetricKey?
+
+    let baseNonce: [UInt8]
+
+    init(sharedSecret: SymmetricKey, inputs: HPKEKeyScheduleInputs) {
+        let aead = inputs.aead
+        guard aead != .exportOnly else {
+            self.key = nil
+            self.baseNonce = []
+            return
+        }
+
+        var secret = sharedSecret.withUnsafeBytes { inputs.kdf.extract(salt: $0, label: "secret", ikm: nil) }
+        defer {
+            secret.withUnsafeMutableBytes { $0.initializeMemory(as: UInt8.self, repeating: 0) }
+        }
+        self.key = inputs.kdf.expand(prk: secret, label: "key", info: inputs.context, outputByteCount: aead.aeadKeyByteCount)
+        self.baseNonce = inputs.kdf.expand(prk: secret, label: "base_nonce", info: inputs.context, outputByteCount: aead.aeadNonceByteCount)
+            .withUnsafeBytes { Array($0) }
+    }
+}
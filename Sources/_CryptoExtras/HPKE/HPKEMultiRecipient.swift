@@ -0,0 +1,93 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+extension HPKE {
+    /// Encrypts one message to many recipients in HPKE base mode, sharing a single ephemeral key between them.
+    ///
+    /// This is equivalent to creating an ``HPKE/Sender`` for each recipient and sealing `message` once with each,
+    /// but it generates one ephemeral key pair for the whole batch, computes the key schedule inputs that depend
+    /// only on `ciphersuite` and `info` once, and batches the X25519 operations where the KEM allows. All recipients
+    /// receive the same encapsulated key. Each recipient opens its ciphertext with an ordinary ``HPKE/Recipient``
+    /// created with that encapsulated key.
+    ///
+    /// Reusing the ephemeral key means an observer can tell that the ciphertexts were produced together. Do not
+    /// use this where recipients must not be linkable to one another.
+    ///
+    /// - Parameters:
+    ///   - message: The plaintext to encrypt.
+    ///   - aad: Additional data to authenticate.
+    ///   - recipientKeys: The recipients' public keys.
+    ///   - ciphersuite: The cipher suite that defines the cryptographic algorithms to use.
+    ///   - info: Data that the key derivation function uses to compute the symmetric key material.
+    /// - Returns: The shared encapsulated key, and the ciphertext for each recipient, in the same order as
+    ///   `recipientKeys`.
+    public static func _seal<PublicKey: HPKEDiffieHellmanPublicKey, M: DataProtocol, AD: DataProtocol>(
+        _ message: M,
+        authenticating aad: AD,
+        to recipientKeys: [PublicKey],
+        ciphersuite: HPKE.Ciphersuite,
+        info: Data
+    ) throws -> (encapsulatedKey: Data, ciphertexts: [Data]) {
+        guard ciphersuite.aead != .exportOnly else {
+            throw HPKE.Errors.exportOnlyMode
+        }
+
+        let kem = ciphersuite.kem
+        let recipientRepresentations = try recipientKeys.map { try $0.hpkeRepresentation(kem: kem) }
+        let ephemeralKey = PublicKey.EphemeralPrivateKey()
+        let encapsulatedKey = try ephemeralKey.publicKey.hpkeRepresentation(kem: kem)
+
+        let dhOutputs: [SymmetricKey]
+        if let ephemeralKey = ephemeralKey as? Curve25519.KeyAgreement.PrivateKey,
+           let recipientKeys = recipientKeys as? [Curve25519.KeyAgreement.PublicKey] {
+            dhOutputs = ephemeralKey._sharedSecrets(with: recipientKeys)
+        } else {
+            dhOutputs = try recipientKeys.map { SymmetricKey(data: try ephemeralKey.sharedSecretFromKeyAgreement(with: $0)) }
+        }
+
+        let inputs = HPKEKeyScheduleInputs(ciphersuite: ciphersuite, info: info)
+        let ciphertexts = try zip(dhOutputs, recipientRepresentations).map { dh, recipientKey in
+            let sharedSecret = HPKEDHKEM.sharedSecret(dh: dh, encapsulatedKey: encapsulatedKey, recipientKey: recipientKey, kem: kem)
+            let schedule = HPKEKeySchedule(sharedSecret: sharedSecret, inputs: inputs)
+            return try Self.sealFirstMessage(message, authenticating: aad, schedule: schedule, aead: ciphersuite.aead)
+        }
+        return (encapsulatedKey, ciphertexts)
+    }
+
+    /// Seals the message with sequence number zero, whose nonce is the base nonce itself.
+    private static func sealFirstMessage<M: DataProtocol, AD: DataProtocol>(
+        _ message: M,
+        authenticating aad: AD,
+        schedule: HPKEKeySchedule,
+        aead: HPKE.AEAD
+    ) throws -> Data {
+        guard let key = schedule.key else {
+            throw HPKE.Errors.exportOnlyMode
+        }
+
+        switch aead {
+        case .AES_GCM_128, .AES_GCM_256:
+            let box = try AES.GCM.seal(message, using: key, nonce: AES.GCM.Nonce(data: schedule.baseNonce), authenticating: aad)
+            return box.ciphertext + box.tag
+        case .chaChaPoly:
+            let box = try ChaChaPoly.seal(message, using: key, nonce: ChaChaPoly.Nonce(data: schedule.baseNonce), authenticating: aad)
+            return box.ciphertext + box.tag
+        case .exportOnly:
+            throw HPKE.Errors.exportOnlyMode
+        }
+    }
+}
@@ -0,0 +1,121 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+extension HPKE {
+    /// An HPKE base-mode sender that seals a stream of messages into caller-provided buffers.
+    ///
+    /// Messages sealed with this type can be opened by an ordinary ``HPKE/Recipient``, and vice versa. Unlike
+    /// ``HPKE/Sender``, the AEAD context is set up once and kept for the lifetime of the sender, nonces are derived
+    /// in place, and ciphertexts are written directly into memory the caller owns, so long-lived streams run at close
+    /// to the speed of the underlying AEAD.
+    ///
+    /// Copies of a sender share one sequence number.
+    public struct _StreamingSender {
+        /// The encapsulated symmetric key that the recipient uses to decrypt messages.
+        public let encapsulatedKey: Data
+
+        private let stream: HPKEAEADStream
+
+        /// Creates a sender in base mode.
+        ///
+        /// - Parameters:
+        ///   - recipientKey: The recipient's public key for encrypting the messages.
+        ///   - ciphersuite: The cipher suite that defines the cryptographic algorithms to use.
+        ///   - info: Data that the key derivation function uses to compute the symmetric key material.
+        public init<PublicKey: HPKEDiffieHellmanPublicKey>(recipientKey: PublicKey, ciphersuite: HPKE.Ciphersuite, info: Data) throws {
+            let (sharedSecret, encapsulatedKey) = try HPKEDHKEM.encapsulate(to: recipientKey, kem: ciphersuite.kem)
+            let schedule = HPKEKeySchedule(sharedSecret: sharedSecret, inputs: HPKEKeyScheduleInputs(ciphersuite: ciphersuite, info: info))
+            self.stream = try HPKEAEADStream(schedule: schedule, aead: ciphersuite.aead)
+            self.encapsulatedKey = encapsulatedKey
+        }
+
+        /// The number of bytes the AEAD tag adds to each message.
+        public var tagByteCount: Int {
+            HPKEAEADStream.tagByteCount
+        }
+
+        /// Encrypts the next message in the stream, writing the ciphertext and tag into a caller-provided buffer.
+        ///
+        /// - Parameters:
+        ///   - message: The plaintext to encrypt.
+        ///   - output: The buffer to write into. Must be exactly ``tagByteCount`` bytes larger than `message`.
+        ///     `message` may be the prefix of `output`, in which case the message is sealed in place.
+        ///   - aad: Additional data to authenticate.
+        public mutating func seal<AuthenticatedData: DataProtocol>(
+            _ message: UnsafeRawBufferPointer,
+            into output: UnsafeMutableRawBufferPointer,
+            authenticating aad: AuthenticatedData
+        ) throws {
+            try self.stream.seal(message, into: output, authenticating: aad)
+        }
+
+        /// Encrypts the next message in the stream, writing the ciphertext and tag into a caller-provided buffer.
+        ///
+        /// - Parameters:
+        ///   - message: The plaintext to encrypt.
+        ///   - output: The buffer to write into. Must be exactly ``tagByteCount`` bytes larger than `message`.
+        public mutating func seal(_ message: UnsafeRawBufferPointer, into output: UnsafeMutableRawBufferPointer) throws {
+            try self.seal(message, into: output, authenticating: [UInt8]())
+        }
+    }
+
+    /// An HPKE base-mode recipient that opens a stream of messages in place.
+    ///
+    /// This opens messages from either a ``HPKE/_StreamingSender`` or an ordinary ``HPKE/Sender``.
+    /// Copies of a recipient share one sequence number.
+    public struct _StreamingRecipient {
+        private let stream: HPKEAEADStream
+
+        /// Creates a recipient in base mode.
+        ///
+        /// - Parameters:
+        ///   - privateKey: The recipient's private key for decrypting the incoming messages.
+        ///   - ciphersuite: The cipher suite that defines the cryptographic algorithms to use.
+        ///   - info: Data that the key derivation function uses to compute the symmetric key material.
+        ///   - encapsulatedKey: The encapsulated symmetric key that the sender provides.
+        public init<PrivateKey: HPKEDiffieHellmanPrivateKey>(privateKey: PrivateKey, ciphersuite: HPKE.Ciphersuite, info: Data, encapsulatedKey: Data) throws {
+            let sharedSecret = try HPKEDHKEM.decapsulate(encapsulatedKey, using: privateKey, kem: ciphersuite.kem)
+            let schedule = HPKEKeySchedule(sharedSecret: sharedSecret, inputs: HPKEKeyScheduleInputs(ciphersuite: ciphersuite, info: info))
+            self.stream = try HPKEAEADStream(schedule: schedule, aead: ciphersuite.aead)
+        }
+
+        /// Decrypts the next message in the stream, in place.
+        ///
+        /// - Parameters:
+        ///   - buffer: A buffer holding the ciphertext immediately followed by the tag.
+        ///   - aad: Additional data that was authenticated with the message.
+        /// - Returns: The prefix of `buffer` that now holds the plaintext.
+        @discardableResult
+        public mutating func open<AuthenticatedData: DataProtocol>(
+            inPlace buffer: UnsafeMutableRawBufferPointer,
+            authenticating aad: AuthenticatedData
+        ) throws -> UnsafeMutableRawBufferPointer {
+            let plaintextByteCount = try self.stream.open(inPlace: buffer, authenticating: aad)
+            return UnsafeMutableRawBufferPointer(rebasing: buffer.prefix(plaintextByteCount))
+        }
+
+        /// Decrypts the next message in the stream, in place.
+        ///
+        /// - Parameters:
+        ///   - buffer: A buffer holding the ciphertext immediately followed by the tag.
+        /// - Returns: The prefix of `buffer` that now holds the plaintext.
+        @discardableResult
+        public mutating func open(inPlace buffer: UnsafeMutableRawBufferPointer) throws -> UnsafeMutableRawBufferPointer {
+            try self.open(inPlace: buffer, authenticating: [UInt8]())
+        }
+    }
+}
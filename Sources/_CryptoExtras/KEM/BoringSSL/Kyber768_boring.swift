@@ -0,0 +1,160 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+import Crypto
+import Foundation
+
+enum OpenSSLKyber768Impl {
+    static let publicKeyByteCount = Int(CCryptoBoringSSLShims_KYBER_PUBLIC_KEY_BYTES)
+
+    static let privateKeyByteCount = Int(CCryptoBoringSSLShims_KYBER_PRIVATE_KEY_BYTES)
+
+    static let ciphertextByteCount = Int(CCryptoBoringSSLShims_KYBER_CIPHERTEXT_BYTES)
+
+    static let sharedSecretByteCount = Int(CCryptoBoringSSLShims_KYBER_SHARED_SECRET_BYTES)
+
+    fileprivate static let keyAlignment = 16
+
+    /// A parsed public key. BoringSSL's parsed form includes the expanded matrix `A`, so parsing a key once and
+    /// encapsulating to it many times only pays for the matrix expansion once.
+    final class PublicKey {
+        private let storage: UnsafeMutableRawPointer
+
+        init<Bytes: ContiguousBytes>(rawRepresentation: Bytes) throws {
+            let storage = UnsafeMutableRawPointer.allocate(
+                byteCount: CCryptoBoringSSLShims_kyber_public_key_size(),
+                alignment: OpenSSLKyber768Impl.keyAlignment
+            )
+            let result: Int32 = rawRepresentation.withUnsafeBytes { bytes in
+                guard bytes.count == OpenSSLKyber768Impl.publicKeyByteCount else {
+                    return -1
+                }
+                return CCryptoBoringSSLShims_kyber_parse_public_key(storage, bytes.baseAddress, bytes.count)
+            }
+            guard result == 1 else {
+                storage.deallocate()
+                throw result == -1 ? CryptoKitError.incorrectKeySize : CryptoKitError.invalidParameter
+            }
+            self.storage = storage
+        }
+
+        init(privateKey: PrivateKey) {
+            self.storage = UnsafeMutableRawPointer.allocate(
+                byteCount: CCryptoBoringSSLShims_kyber_public_key_size(),
+                alignment: OpenSSLKyber768Impl.keyAlignment
+            )
+            privateKey.withUnsafeKey { CCryptoBoringSSLShims_kyber_public_from_private(self.storage, $0) }
+        }
+
+        deinit {
+            self.storage.deallocate()
+        }
+
+        var rawRepresentation: Data {
+            var bytes = Data(repeating: 0, count: OpenSSLKyber768Impl.publicKeyByteCount)
+            let result = bytes.withUnsafeMutableBytes {
+                CCryptoBoringSSLShims_kyber_marshal_public_key($0.baseAddress, self.storage)
+            }
+            precondition(result == 1)
+            return bytes
+        }
+
+        func encapsulate() -> (ciphertext: Data, sharedSecret: SymmetricKey) {
+            var ciphertext = Data(repeating: 0, count: OpenSSLKyber768Impl.ciphertextByteCount)
+            let sharedSecret = OpenSSLKyber768Impl.withSharedSecretBuffer { sharedSecret in
+                ciphertext.withUnsafeMutableBytes {
+                    CCryptoBoringSSLShims_kyber_encap($0.baseAddress, sharedSecret, self.storage)
+                }
+            }
+            return (ciphertext, sharedSecret)
+        }
+    }
+
+    final class PrivateKey {
+        private let storage: UnsafeMutableRawPointer
+
+        private init(uninitialized: ()) {
+            self.storage = UnsafeMutableRawPointer.allocate(
+                byteCount: CCryptoBoringSSLShims_kyber_private_key_size(),
+                alignment: OpenSSLKyber768Impl.keyAlignment
+            )
+        }
+
+        convenience init() {
+            self.init(uninitialized: ())
+            // The encoded public key isn't needed: the public key is recovered from the private key directly.
+            var encodedPublicKey = [UInt8](repeating: 0, count: OpenSSLKyber768Impl.publicKeyByteCount)
+            encodedPublicKey.withUnsafeMutableBytes {
+                CCryptoBoringSSLShims_kyber_generate_key($0.baseAddress, self.storage)
+            }
+        }
+
+        convenience init<Bytes: ContiguousBytes>(rawRepresentation: Bytes) throws {
+            self.init(uninitialized: ())
+            let result: Int32 = rawRepresentation.withUnsafeBytes { bytes in
+                guard bytes.count == OpenSSLKyber768Impl.privateKeyByteCount else {
+                    return -1
+                }
+                return CCryptoBoringSSLShims_kyber_parse_private_key(self.storage, bytes.baseAddress, bytes.count)
+            }
+            guard result == 1 else {
+                throw result == -1 ? CryptoKitError.incorrectKeySize : CryptoKitError.invalidParameter
+            }
+        }
+
+        deinit {
+            CCryptoBoringSSL_OPENSSL_cleanse(self.storage, CCryptoBoringSSLShims_kyber_private_key_size())
+            self.storage.deallocate()
+        }
+
+        fileprivate func withUnsafeKey<Result>(_ body: (UnsafeRawPointer) throws -> Result) rethrows -> Result {
+            try body(self.storage)
+        }
+
+        var rawRepresentation: Data {
+            var bytes = Data(repeating: 0, count: OpenSSLKyber768Impl.privateKeyByteCount)
+            let result = bytes.withUnsafeMutableBytes {
+                CCryptoBoringSSLShims_kyber_marshal_private_key($0.baseAddress, self.storage)
+            }
+            precondition(result == 1)
+            return bytes
+        }
+
+        func decapsulate<Ciphertext: DataProtocol>(_ ciphertext: Ciphertext) throws -> SymmetricKey {
+            guard ciphertext.count == OpenSSLKyber768Impl.ciphertextByteCount else {
+                throw CryptoKitError.incorrectParameterSize
+            }
+            let contiguousCiphertext = Array(ciphertext)
+            return OpenSSLKyber768Impl.withSharedSecretBuffer { sharedSecret in
+                contiguousCiphertext.withUnsafeBytes {
+                    CCryptoBoringSSLShims_kyber_decap(sharedSecret, $0.baseAddress, self.storage)
+                }
+            }
+        }
+    }
+
+    /// Runs `body` with a scratch buffer for a shared secret, and returns the secret as a key. The scratch
+    /// buffer is wiped afterwards.
+    private static func withSharedSecretBuffer(_ body: (UnsafeMutableRawPointer) -> Void) -> SymmetricKey {
+        let buffer = UnsafeMutableRawBufferPointer.allocate(byteCount: Self.sharedSecretByteCount, alignment: 1)
+        defer {
+            CCryptoBoringSSL_OPENSSL_cleanse(buffer.baseAddress, buffer.count)
+            buffer.deallocate()
+        }
+        body(buffer.baseAddress!)
+        return SymmetricKey(data: UnsafeRawBufferPointer(buffer))
+    }
+}
@@ -0,0 +1,107 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+/// The Kyber768 key encapsulation mechanism, as specified in round 3 of the NIST post-quantum competition.
+///
+/// - Note: This is the round-3 Kyber that the X25519Kyber768Draft00 hybrid uses, not ML-KEM-768 as finalized in
+///   FIPS 203. The two are not interoperable.
+public enum _Kyber768 {
+    /// The number of bytes in an encoded public key.
+    public static let publicKeyByteCount = OpenSSLKyber768Impl.publicKeyByteCount
+
+    /// The number of bytes in an encoded private key.
+    public static let privateKeyByteCount = OpenSSLKyber768Impl.privateKeyByteCount
+
+    /// The number of bytes in an encapsulated shared secret.
+    public static let ciphertextByteCount = OpenSSLKyber768Impl.ciphertextByteCount
+
+    /// A Kyber768 public key.
+    ///
+    /// The key is kept in parsed form, so encapsulating to the same key repeatedly doesn't re-derive its matrix.
+    /// Copies of a public key share that parsed form.
+    public struct PublicKey: KEMPublicKey {
+        let backing: OpenSSLKyber768Impl.PublicKey
+
+        fileprivate init(backing: OpenSSLKyber768Impl.PublicKey) {
+            self.backing = backing
+        }
+
+        /// Parses an encoded public key.
+        ///
+        /// - Parameter rawRepresentation: The ``publicKeyByteCount``-byte encoding of the key.
+        public init<Bytes: ContiguousBytes>(rawRepresentation: Bytes) throws {
+            self.backing = try OpenSSLKyber768Impl.PublicKey(rawRepresentation: rawRepresentation)
+        }
+
+        /// The encoding of the key.
+        public var rawRepresentation: Data {
+            self.backing.rawRepresentation
+        }
+
+        /// Generates a random shared secret and encapsulates it to this key.
+        ///
+        /// - Returns: The 32-byte shared secret, and the ``ciphertextByteCount``-byte encapsulation to send
+        ///   to the holder of the private key.
+        public func encapsulate() throws -> KEM.EncapsulationResult {
+            let (ciphertext, sharedSecret) = self.backing.encapsulate()
+            return KEM.EncapsulationResult(sharedSecret: sharedSecret, encapsulated: ciphertext)
+        }
+    }
+
+    /// A Kyber768 private key.
+    public struct PrivateKey: KEMPrivateKey {
+        let backing: OpenSSLKyber768Impl.PrivateKey
+
+        /// The public key that corresponds to this private key.
+        public let publicKey: PublicKey
+
+        /// Generates a random private key.
+        public init() {
+            self.backing = OpenSSLKyber768Impl.PrivateKey()
+            self.publicKey = PublicKey(backing: OpenSSLKyber768Impl.PublicKey(privateKey: self.backing))
+        }
+
+        /// Parses an encoded private key.
+        ///
+        /// - Parameter rawRepresentation: The ``privateKeyByteCount``-byte encoding of the key.
+        public init<Bytes: ContiguousBytes>(rawRepresentation: Bytes) throws {
+            self.backing = try OpenSSLKyber768Impl.PrivateKey(rawRepresentation: rawRepresentation)
+            self.publicKey = PublicKey(backing: OpenSSLKyber768Impl.PublicKey(privateKey: self.backing))
+        }
+
+        /// Generates a random private key.
+        public static func generate() throws -> Self {
+            Self()
+        }
+
+        /// The encoding of the key.
+        public var rawRepresentation: Data {
+            self.backing.rawRepresentation
+        }
+
+        /// Recovers the shared secret from an encapsulation made to this key's public key.
+        ///
+        /// Kyber decapsulation never fails on a well-formed input: an invalid ciphertext yields a pseudorandom
+        /// secret instead, so the secret must be used with an authenticated cipher.
+        ///
+        /// - Parameter encapsulated: The ``ciphertextByteCount``-byte encapsulated secret.
+        /// - Returns: The 32-byte shared secret.
+        public func decapsulate(_ encapsulated: Data) throws -> SymmetricKey {
+            try self.backing.decapsulate(encapsulated)
+        }
+    }
+}
@@ -0,0 +1,50 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+extension _Kyber768.PublicKey {
+    /// Parses an encoded public key, reusing a previously parsed key when the same bytes have been seen before.
+    ///
+    /// Parsing a Kyber768 key expands its matrix from the seed, which costs more than an encapsulation. Keys
+    /// returned from this constructor are shared across the whole process, which suits servers that repeatedly
+    /// encapsulate to the same long-term keys. The cache holds a bounded number of keys, about 6 KiB each; the
+    /// oldest entries are evicted first.
+    ///
+    /// - Parameter rawRepresentation: The ``_Kyber768/publicKeyByteCount``-byte encoding of the key.
+    public static func _cached<Bytes: DataProtocol>(rawRepresentation: Bytes) throws -> _Kyber768.PublicKey {
+        let fingerprint = SHA256.hash(data: rawRepresentation)
+        if let key = _Kyber768.PublicKey.cache.key(for: fingerprint) {
+            return key
+        }
+
+        let key = try _Kyber768.PublicKey(rawRepresentation: Array(rawRepresentation))
+        _Kyber768.PublicKey.cache.insert(key, for: fingerprint)
+        return key
+    }
+
+    /// Removes every key cached by ``_cached(rawRepresentation:)``.
+    public static func _removeAllCachedKeys() {
+        _Kyber768.PublicKey.cache.removeAll()
+    }
+
+    // A parsed key keeps its 6208-byte expanded form, including the public matrix.
+    static let cache = ParsedKeyCache<_Kyber768.PublicKey>(
+        capacity: 256,
+        budget: .shared,
+        name: "_Kyber768.PublicKey._cached",
+        keyByteCount: { _ in 6208 + 128 }
+    )
+}
@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+import Crypto
+import Foundation
+
+enum OpenSSLFFDHE2048Impl {
+    static let byteCount = Int(CCryptoBoringSSLShims_FFDHE2048_BYTES)
+
+    static func validatedPublicKey<Bytes: ContiguousBytes>(_ rawRepresentation: Bytes) throws -> Data {
+        try rawRepresentation.withUnsafeBytes { bytes in
+            guard bytes.count == Self.byteCount else {
+                throw CryptoKitError.incorrectKeySize
+            }
+            guard CCryptoBoringSSLShims_FFDHE2048_check_public_key(bytes.baseAddress, bytes.count) == 1 else {
+                throw CryptoKitError.invalidParameter
+            }
+            return Data(bytes)
+        }
+    }
+
+    /// A private exponent held in memory that is wiped when the key is released.
+    final class PrivateKey {
+        private let exponent: UnsafeMutableRawBufferPointer
+
+        private init() {
+            self.exponent = .allocate(byteCount: OpenSSLFFDHE2048Impl.byteCount, alignment: 1)
+        }
+
+        deinit {
+            CCryptoBoringSSL_OPENSSL_cleanse(self.exponent.baseAddress, self.exponent.count)
+            self.exponent.deallocate()
+        }
+
+        static func generate() -> (PrivateKey, Data) {
+            let key = PrivateKey()
+            var publicKey = Data(repeating: 0, count: OpenSSLFFDHE2048Impl.byteCount)
+            let rc = publicKey.withUnsafeMutableBytes { publicKey in
+                CCryptoBoringSSLShims_FFDHE2048_generate_key(key.exponent.baseAddress, publicKey.baseAddress)
+            }
+            // Only fails if memory runs out.
+            precondition(rc == 1)
+            return (key, publicKey)
+        }
+
+        static func parse<Bytes: ContiguousBytes>(_ rawRepresentation: Bytes) throws -> (PrivateKey, Data) {
+            let key = PrivateKey()
+            try rawRepresentation.withUnsafeBytes { bytes in
+                guard bytes.count == OpenSSLFFDHE2048Impl.byteCount else {
+                    throw CryptoKitError.incorrectKeySize
+                }
+                key.exponent.copyMemory(from: bytes)
+            }
+            var publicKey = Data(repeating: 0, count: OpenSSLFFDHE2048Impl.byteCount)
+            let rc = publicKey.withUnsafeMutableBytes { publicKey in
+                CCryptoBoringSSLShims_FFDHE2048_public_key(publicKey.baseAddress, key.exponent.baseAddress)
+            }
+            guard rc == 1 else {
+                throw CryptoKitError.invalidParameter
+            }
+            return (key, publicKey)
+        }
+
+        var rawRepresentation: Data {
+            Data(self.exponent)
+        }
+
+        func sharedSecret(with peerPublicKey: Data) throws -> SymmetricKey {
+            let secret = UnsafeMutableRawBufferPointer.allocate(byteCount: OpenSSLFFDHE2048Impl.byteCount, alignment: 1)
+            defer {
+                CCryptoBoringSSL_OPENSSL_cleanse(secret.baseAddress, secret.count)
+                secret.deallocate()
+            }
+            let rc = peerPublicKey.withUnsafeBytes { peerPublicKey in
+                CCryptoBoringSSLShims_FFDHE2048_compute_key(
+                    secret.baseAddress, self.exponent.baseAddress, peerPublicKey.baseAddress, peerPublicKey.count
+                )
+            }
+            guard rc == 1 else {
+                throw CryptoKitError.invalidParameter
+            }
+            return SymmetricKey(data: UnsafeRawBufferPointer(secret))
+        }
+    }
+}
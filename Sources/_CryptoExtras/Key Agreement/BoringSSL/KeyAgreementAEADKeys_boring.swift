@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+@_implementationOnly import CryptoBoringWrapper
+import Crypto
+import Foundation
+
+enum OpenSSLKeyAgreementAEADKeyImpl {
+    enum KeyAgreement {
+        case x25519
+        case p256
+
+        fileprivate var shimValue: CInt {
+            switch self {
+            case .x25519:
+                return CCRYPTOBORINGSSLSHIMS_KEY_AGREEMENT_X25519
+            case .p256:
+                return CCRYPTOBORINGSSLSHIMS_KEY_AGREEMENT_P256
+            }
+        }
+    }
+
+    /// Agrees a secret between `privateKey` and `peerPublicKey`, derives an `algorithm` key of `keyByteCount` bytes
+    /// from it with HKDF, and returns it prepared. `derivedKey` computes the same key the long way, and is only used
+    /// for hash functions BoringSSL doesn't implement.
+    static func preparedKey<H: HashFunction, Salt: DataProtocol, SharedInfo: DataProtocol>(
+        algorithm: AEADAlgorithm,
+        keyByteCount: Int,
+        keyAgreement: KeyAgreement,
+        privateKey: UnsafeRawBufferPointer,
+        peerPublicKey: UnsafeRawBufferPointer,
+        hashFunction: H.Type,
+        salt: Salt,
+        sharedInfo: SharedInfo,
+        derivedKey: () throws -> SymmetricKey
+    ) throws -> OpenSSLAEADPreparedKey {
+        let cipher = try BoringSSLAEAD(algorithm, keyBitCount: keyByteCount * 8)
+        guard let md = Self.messageDigest(for: H.self) else {
+            return try OpenSSLAEADPreparedKey(derivedKey(), algorithm: algorithm)
+        }
+
+        let contiguousSalt: ContiguousBytes = salt.regions.count == 1 ? salt.regions.first! : Array(salt)
+        let contiguousInfo: ContiguousBytes = sharedInfo.regions.count == 1 ? sharedInfo.regions.first! : Array(sharedInfo)
+        do {
+            let context = try contiguousSalt.withUnsafeBytes { salt in
+                try contiguousInfo.withUnsafeBytes { info in
+                    try BoringSSLAEAD.AEADContext(cipher: cipher) { aead, context in
+                        CCryptoBoringSSLShims_EVP_AEAD_CTX_init_with_key_agreement(
+                            context, aead, keyAgreement.shimValue,
+                            privateKey.baseAddress, peerPublicKey.baseAddress,
+                            md, salt.baseAddress, salt.count, info.baseAddress, info.count
+                        ) == 1
+                    }
+                }
+            }
+            return OpenSSLAEADPreparedKey(context: context)
+        } catch CryptoBoringWrapperError.underlyingCoreCryptoError(let errorCode) {
+            throw CryptoKitError.underlyingCoreCryptoError(error: errorCode)
+        }
+    }
+
+    private static func messageDigest<H: HashFunction>(for hashFunction: H.Type) -> OpaquePointer? {
+        switch hashFunction {
+        case is SHA256.Type:
+            return CCryptoBoringSSL_EVP_sha256()
+        case is SHA384.Type:
+            return CCryptoBoringSSL_EVP_sha384()
+        case is SHA512.Type:
+            return CCryptoBoringSSL_EVP_sha512()
+        default:
+            return nil
+        }
+    }
+}
@@ -0,0 +1,87 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+import Crypto
+import Foundation
+
+enum OpenSSLP256RawKeyAgreementImpl {
+    static let scalarByteCount = Int(CCryptoBoringSSLShims_P256_SCALAR_BYTES)
+    static let uncompressedPointByteCount = Int(CCryptoBoringSSLShims_P256_UNCOMPRESSED_POINT_BYTES)
+
+    static func sharedSecret(
+        privateScalar: UnsafeRawBufferPointer,
+        peerPublicKey: UnsafeRawBufferPointer,
+        into output: UnsafeMutableRawBufferPointer
+    ) throws {
+        guard privateScalar.count == Self.scalarByteCount,
+              peerPublicKey.count == Self.uncompressedPointByteCount,
+              output.count == Self.scalarByteCount else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+
+        guard CCryptoBoringSSLShims_p256_ecdh(output.baseAddress, privateScalar.baseAddress, peerPublicKey.baseAddress) == 1 else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+    }
+
+    static func sharedSecrets(
+        privateScalars: UnsafeRawBufferPointer,
+        peerPublicKeys: UnsafeRawBufferPointer,
+        into output: UnsafeMutableRawBufferPointer
+    ) throws {
+        let count = privateScalars.count / Self.scalarByteCount
+        guard privateScalars.count == count * Self.scalarByteCount,
+              peerPublicKeys.count == count * Self.uncompressedPointByteCount,
+              output.count == count * Self.scalarByteCount else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+        guard count > 0 else {
+            return
+        }
+
+        guard CCryptoBoringSSLShims_p256_ecdh_batch(output.baseAddress, privateScalars.baseAddress, peerPublicKeys.baseAddress, count) == 1 else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+    }
+}
+
+/// A P-256 private scalar held in memory that is wiped when the key is released.
+final class OpenSSLP256RawPrivateKey {
+    private let scalar: UnsafeMutableRawBufferPointer
+
+    init(_ privateKey: P256.KeyAgreement.PrivateKey) {
+        self.scalar = .allocate(byteCount: OpenSSLP256RawKeyAgreementImpl.scalarByteCount, alignment: 1)
+
+        var rawRepresentation = privateKey.rawRepresentation
+        defer {
+            rawRepresentation.resetBytes(in: 0..<rawRepresentation.count)
+        }
+        precondition(rawRepresentation.count == self.scalar.count)
+        rawRepresentation.withUnsafeBytes { self.scalar.copyMemory(from: $0) }
+    }
+
+    deinit {
+        CCryptoBoringSSL_OPENSSL_cleanse(self.scalar.baseAddress, self.scalar.count)
+        self.scalar.deallocate()
+    }
+
+    func sharedSecret(peerPublicKey: UnsafeRawBufferPointer, into output: UnsafeMutableRawBufferPointer) throws {
+        try OpenSSLP256RawKeyAgreementImpl.sharedSecret(privateScalar: UnsafeRawBufferPointer(self.scalar), peerPublicKey: peerPublicKey, into: output)
+    }
+
+    func withUnsafeScalar<Result>(_ body: (UnsafeRawBufferPointer) throws -> Result) rethrows -> Result {
+        try body(UnsafeRawBufferPointer(self.scalar))
+    }
+}
@@ -0,0 +1,57 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+import Crypto
+import Foundation
+
+enum OpenSSLX25519BatchImpl {
+    static let keyByteCount = 32
+
+    static func sharedSecrets(privateKey: Curve25519.KeyAgreement.PrivateKey, publicKeys: [Curve25519.KeyAgreement.PublicKey]) -> [SymmetricKey] {
+        guard !publicKeys.isEmpty else {
+            return []
+        }
+
+        var peers = [UInt8]()
+        peers.reserveCapacity(publicKeys.count * Self.keyByteCount)
+        for publicKey in publicKeys {
+            peers.append(contentsOf: publicKey.rawRepresentation)
+        }
+
+        var privateKeyBytes = privateKey.rawRepresentation
+        defer {
+            privateKeyBytes.resetBytes(in: 0..<privateKeyBytes.count)
+        }
+        precondition(privateKeyBytes.count == Self.keyByteCount)
+
+        // The secrets are computed into a single scratch buffer, which is wiped once they have been moved into keys.
+        let secrets = UnsafeMutableRawBufferPointer.allocate(byteCount: publicKeys.count * Self.keyByteCount, alignment: 1)
+        defer {
+            CCryptoBoringSSL_OPENSSL_cleanse(secrets.baseAddress, secrets.count)
+            secrets.deallocate()
+        }
+
+        privateKeyBytes.withUnsafeBytes { privateKeyPointer in
+            peers.withUnsafeBytes { peersPointer in
+                CCryptoBoringSSLShims_X25519_batch(secrets.baseAddress, privateKeyPointer.baseAddress, peersPointer.baseAddress, publicKeys.count)
+            }
+        }
+
+        return stride(from: 0, to: secrets.count, by: Self.keyByteCount).map { offset in
+            SymmetricKey(data: UnsafeRawBufferPointer(rebasing: secrets[offset..<(offset + Self.keyByteCount)]))
+        }
+    }
+}
@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+
+/// Finite-field Diffie-Hellman in the 2048-bit `ffdhe2048` group of RFC 7919.
+///
+/// This is for interoperating with peers that only offer finite-field groups. New protocols should prefer
+/// Curve25519/KeyAgreement or P256/KeyAgreement, whose keys are far smaller and faster.
+///
+/// Key generation raises the group's generator with a fixed-base table that is built on first use, which makes it
+/// a few times faster than BoringSSL's `DH_generate_key`. Key agreement shares one Montgomery context for the group
+/// across every key.
+public enum _FFDHE2048 {
+    /// The number of bytes in a public value, a private exponent and a shared secret.
+    public static let byteCount = OpenSSLFFDHE2048Impl.byteCount
+
+    /// An ffdhe2048 public value.
+    public struct PublicKey: Sendable {
+        /// The public value, as `byteCount` big-endian bytes.
+        public let rawRepresentation: Data
+
+        fileprivate init(validated rawRepresentation: Data) {
+            self.rawRepresentation = rawRepresentation
+        }
+
+        /// Parses a public value, checking it as `DH_check_pub_key` would.
+        ///
+        /// - Parameter rawRepresentation: The value as `byteCount` big-endian bytes.
+        public init<Bytes: ContiguousBytes>(rawRepresentation: Bytes) throws {
+            self.rawRepresentation = try OpenSSLFFDHE2048Impl.validatedPublicKey(rawRepresentation)
+        }
+    }
+
+    /// An ffdhe2048 private exponent.
+    public struct PrivateKey {
+        let backing: OpenSSLFFDHE2048Impl.PrivateKey
+
+        /// The public value that corresponds to this private exponent.
+        public let publicKey: PublicKey
+
+        /// Generates a random private exponent, uniformly in [1, q - 1] as `DH_generate_key` does.
+        public init() {
+            let (backing, publicKey) = OpenSSLFFDHE2048Impl.PrivateKey.generate()
+            self.backing = backing
+            self.publicKey = PublicKey(validated: publicKey)
+        }
+
+        /// Parses a private exponent.
+        ///
+        /// - Parameter rawRepresentation: The exponent as `byteCount` big-endian bytes, in [1, q - 1].
+        public init<Bytes: ContiguousBytes>(rawRepresentation: Bytes) throws {
+            let (backing, publicKey) = try OpenSSLFFDHE2048Impl.PrivateKey.parse(rawRepresentation)
+            self.backing = backing
+            self.publicKey = PublicKey(validated: publicKey)
+        }
+
+        /// The private exponent, as `byteCount` big-endian bytes.
+        public var rawRepresentation: Data {
+            self.backing.rawRepresentation
+        }
+
+        /// Computes the shared secret with a peer.
+        ///
+        /// The result is the raw Diffie-Hellman output, padded to `byteCount` bytes as in SP 800-56A. It must be passed
+        /// through a key derivation function, such as `HKDF`, before use as a key.
+        ///
+        /// - Parameter peerPublicKey: The peer's public value.
+        /// - Throws: `CryptoKitError.invalidParameter` if the secret is degenerate.
+        public func sharedSecret(with peerPublicKey: PublicKey) throws -> SymmetricKey {
+            try self.backing.sharedSecret(with: peerPublicKey.rawRepresentation)
+        }
+    }
+}
@@ -0,0 +1,213 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+
+// Each of these runs the key agreement, HKDF and the AEAD context setup in one call into BoringSSL. The usual route,
+// `sharedSecretFromKeyAgreement(with:)` then `hkdfDerivedSymmetricKey(using:salt:sharedInfo:outputByteCount:)` then a
+// prepared key, allocates a `SharedSecret`, a `SymmetricKey` and an HMAC context on the way, and the context is set
+// up on top of all of them. Here the shared secret and the derived key only exist on the stack of the C call, which
+// wipes them before returning. The keys are the same ones the usual route derives.
+//
+// BoringSSL implements HKDF with SHA-256, SHA-384 and SHA-512. With any other hash function these take the usual
+// route.
+
+extension Curve25519.KeyAgreement.PrivateKey {
+    /// Agrees a shared secret with a peer and derives a prepared AES-GCM key from it with HKDF, in one step that
+    /// keeps the secret and the key out of Swift-managed memory.
+    ///
+    /// - Parameters:
+    ///   - publicKeyShare: The peer's public key.
+    ///   - hashFunction: The hash function HKDF uses.
+    ///   - salt: The salt HKDF uses.
+    ///   - sharedInfo: The shared information HKDF uses.
+    ///   - outputByteCount: The size of the AES key: 16, 24 or 32 bytes.
+    /// - Returns: The prepared form of the key that
+    ///   `sharedSecretFromKeyAgreement(with:).hkdfDerivedSymmetricKey(using:salt:sharedInfo:outputByteCount:)`
+    ///   returns for the same arguments.
+    public func _preparedAESGCMKey<H: HashFunction, Salt: DataProtocol, SharedInfo: DataProtocol>(
+        agreeingWith publicKeyShare: Curve25519.KeyAgreement.PublicKey,
+        using hashFunction: H.Type,
+        salt: Salt,
+        sharedInfo: SharedInfo,
+        outputByteCount: Int = 32
+    ) throws -> AES.GCM._PreparedKey {
+        try AES.GCM._PreparedKey(self.preparedKey(
+            algorithm: .aesGCM, keyByteCount: outputByteCount, agreeingWith: publicKeyShare,
+            using: hashFunction, salt: salt, sharedInfo: sharedInfo
+        ))
+    }
+
+    /// Agrees a shared secret with a peer and derives a prepared ChaCha20-Poly1305 key from it with HKDF, in one step
+    /// that keeps the secret and the key out of Swift-managed memory.
+    ///
+    /// - Parameters:
+    ///   - publicKeyShare: The peer's public key.
+    ///   - hashFunction: The hash function HKDF uses.
+    ///   - salt: The salt HKDF uses.
+    ///   - sharedInfo: The shared information HKDF uses.
+    /// - Returns: The prepared form of the 32-byte key that
+    ///   `sharedSecretFromKeyAgreement(with:).hkdfDerivedSymmetricKey(using:salt:sharedInfo:outputByteCount:)`
+    ///   returns for the same arguments.
+    public func _preparedChaChaPolyKey<H: HashFunction, Salt: DataProtocol, SharedInfo: DataProtocol>(
+        agreeingWith publicKeyShare: Curve25519.KeyAgreement.PublicKey,
+        using hashFunction: H.Type,
+        salt: Salt,
+        sharedInfo: SharedInfo
+    ) throws -> ChaChaPoly._PreparedKey {
+        try ChaChaPoly._PreparedKey(self.preparedKey(
+            algorithm: .chaChaPoly, keyByteCount: 32, agreeingWith: publicKeyShare,
+            using: hashFunction, salt: salt, sharedInfo: sharedInfo
+        ))
+    }
+
+    private func preparedKey<H: HashFunction, Salt: DataProtocol, SharedInfo: DataProtocol>(
+        algorithm: AEADAlgorithm,
+        keyByteCount: Int,
+        agreeingWith publicKeyShare: Curve25519.KeyAgreement.PublicKey,
+        using hashFunction: H.Type,
+        salt: Salt,
+        sharedInfo: SharedInfo
+    ) throws -> OpenSSLAEADPreparedKey {
+        var privateKey = self.rawRepresentation
+        defer {
+            privateKey.resetBytes(in: 0..<privateKey.count)
+        }
+        return try privateKey.withUnsafeBytes { privateKey in
+            try publicKeyShare.rawRepresentation.withUnsafeBytes { peerPublicKey in
+                try OpenSSLKeyAgreementAEADKeyImpl.preparedKey(
+                    algorithm: algorithm, keyByteCount: keyByteCount, keyAgreement: .x25519,
+                    privateKey: privateKey, peerPublicKey: peerPublicKey,
+                    hashFunction: hashFunction, salt: salt, sharedInfo: sharedInfo
+                ) {
+                    try self.sharedSecretFromKeyAgreement(with: publicKeyShare)
+                        .hkdfDerivedSymmetricKey(using: hashFunction, salt: salt, sharedInfo: sharedInfo, outputByteCount: keyByteCount)
+                }
+            }
+        }
+    }
+}
+
+extension P256.KeyAgreement.PrivateKey {
+    /// Agrees a shared secret with a peer and derives a prepared AES-GCM key from it with HKDF, in one step that
+    /// keeps the secret and the key out of Swift-managed memory.
+    ///
+    /// - Parameters:
+    ///   - publicKeyShare: The peer's public key.
+    ///   - hashFunction: The hash function HKDF uses.
+    ///   - salt: The salt HKDF uses.
+    ///   - sharedInfo: The shared information HKDF uses.
+    ///   - outputByteCount: The size of the AES key: 16, 24 or 32 bytes.
+    /// - Returns: The prepared form of the key that
+    ///   `sharedSecretFromKeyAgreement(with:).hkdfDerivedSymmetricKey(using:salt:sharedInfo:outputByteCount:)`
+    ///   returns for the same arguments.
+    public func _preparedAESGCMKey<H: HashFunction, Salt: DataProtocol, SharedInfo: DataProtocol>(
+        agreeingWith publicKeyShare: P256.KeyAgreement.PublicKey,
+        using hashFunction: H.Type,
+        salt: Salt,
+        sharedInfo: SharedInfo,
+        outputByteCount: Int = 32
+    ) throws -> AES.GCM._PreparedKey {
+        try self._raw._preparedAESGCMKey(
+            agreeingWith: publicKeyShare, using: hashFunction, salt: salt, sharedInfo: sharedInfo,
+            outputByteCount: outputByteCount
+        )
+    }
+
+    /// Agrees a shared secret with a peer and derives a prepared ChaCha20-Poly1305 key from it with HKDF, in one step
+    /// that keeps the secret and the key out of Swift-managed memory.
+    ///
+    /// - Parameters:
+    ///   - publicKeyShare: The peer's public key.
+    ///   - hashFunction: The hash function HKDF uses.
+    ///   - salt: The salt HKDF uses.
+    ///   - sharedInfo: The shared information HKDF uses.
+    /// - Returns: The prepared form of the 32-byte key that
+    ///   `sharedSecretFromKeyAgreement(with:).hkdfDerivedSymmetricKey(using:salt:sharedInfo:outputByteCount:)`
+    ///   returns for the same arguments.
+    public func _preparedChaChaPolyKey<H: HashFunction, Salt: DataProtocol, SharedInfo: DataProtocol>(
+        agreeingWith publicKeyShare: P256.KeyAgreement.PublicKey,
+        using hashFunction: H.Type,
+        salt: Salt,
+        sharedInfo: SharedInfo
+    ) throws -> ChaChaPoly._PreparedKey {
+        try self._raw._preparedChaChaPolyKey(agreeingWith: publicKeyShare, using: hashFunction, salt: salt, sharedInfo: sharedInfo)
+    }
+}
+
+extension P256.KeyAgreement._RawPrivateKey {
+    /// Agrees a shared secret with a peer and derives a prepared AES-GCM key from it with HKDF, in one step that
+    /// keeps the secret and the key out of Swift-managed memory.
+    ///
+    /// This is ``P256/KeyAgreement/PrivateKey/_preparedAESGCMKey(agreeingWith:using:salt:sharedInfo:outputByteCount:)``
+    /// without extracting the scalar again.
+    public func _preparedAESGCMKey<H: HashFunction, Salt: DataProtocol, SharedInfo: DataProtocol>(
+        agreeingWith publicKeyShare: P256.KeyAgreement.PublicKey,
+        using hashFunction: H.Type,
+        salt: Salt,
+        sharedInfo: SharedInfo,
+        outputByteCount: Int = 32
+    ) throws -> AES.GCM._PreparedKey {
+        try AES.GCM._PreparedKey(self.preparedKey(
+            algorithm: .aesGCM, keyByteCount: outputByteCount, agreeingWith: publicKeyShare,
+            using: hashFunction, salt: salt, sharedInfo: sharedInfo
+        ))
+    }
+
+    /// Agrees a shared secret with a peer and derives a prepared ChaCha20-Poly1305 key from it with HKDF, in one step
+    /// that keeps the secret and the key out of Swift-managed memory.
+    ///
+    /// This is ``P256/KeyAgreement/PrivateKey/_preparedChaChaPolyKey(agreeingWith:using:salt:sharedInfo:)`` without
+    /// extracting the scalar again.
+    public func _preparedChaChaPolyKey<H: HashFunction, Salt: DataProtocol, SharedInfo: DataProtocol>(
+        agreeingWith publicKeyShare: P256.KeyAgreement.PublicKey,
+        using hashFunction: H.Type,
+        salt: Salt,
+        sharedInfo: SharedInfo
+    ) throws -> ChaChaPoly._PreparedKey {
+        try ChaChaPoly._PreparedKey(self.preparedKey(
+            algorithm: .chaChaPoly, keyByteCount: 32, agreeingWith: publicKeyShare,
+            using: hashFunction, salt: salt, sharedInfo: sharedInfo
+        ))
+    }
+
+    private func preparedKey<H: HashFunction, Salt: DataProtocol, SharedInfo: DataProtocol>(
+        algorithm: AEADAlgorithm,
+        keyByteCount: Int,
+        agreeingWith publicKeyShare: P256.KeyAgreement.PublicKey,
+        using hashFunction: H.Type,
+        salt: Salt,
+        sharedInfo: SharedInfo
+    ) throws -> OpenSSLAEADPreparedKey {
+        try self.withUnsafeScalar { privateKey in
+            try publicKeyShare.x963Representation.withUnsafeBytes { peerPublicKey in
+                try OpenSSLKeyAgreementAEADKeyImpl.preparedKey(
+                    algorithm: algorithm, keyByteCount: keyByteCount, keyAgreement: .p256,
+                    privateKey: privateKey, peerPublicKey: peerPublicKey,
+                    hashFunction: hashFunction, salt: salt, sharedInfo: sharedInfo
+                ) {
+                    var secret = [UInt8](repeating: 0, count: 32)
+                    defer {
+                        secret.withUnsafeMutableBytes { $0.initializeMemory(as: UInt8.self, repeating: 0) }
+                    }
+                    try secret.withUnsafeMutableBytes { try self.sharedSecret(withX963PeerPublicKey: peerPublicKey, into: $0) }
+                    return HKDF<H>.deriveKey(
+                        inputKeyMaterial: SymmetricKey(data: secret), salt: salt, info: sharedInfo,
+                        outputByteCount: keyByteCount
+                    )
+                }
+            }
+        }
+    }
+}
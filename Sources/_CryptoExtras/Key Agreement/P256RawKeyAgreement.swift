@@ -0,0 +1,100 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+
+extension P256.KeyAgreement {
+    /// Computes a P-256 Diffie-Hellman shared secret from raw bytes, writing it into a caller-provided buffer.
+    ///
+    /// This skips the `EC_KEY`, `EC_POINT` and `BIGNUM` objects that ``PrivateKey/sharedSecretFromKeyAgreement(with:)``
+    /// goes through, and does no heap allocation. The peer's point is still checked to be on the curve.
+    ///
+    /// As with ``PrivateKey/sharedSecretFromKeyAgreement(with:)``, the result is raw Diffie-Hellman output and must
+    /// be passed through a key derivation function, such as ``HKDF``, before use as a key.
+    ///
+    /// - Parameters:
+    ///   - privateKey: The private scalar, as 32 big-endian bytes.
+    ///   - peerPublicKey: The peer's public key in 65-byte uncompressed (X9.63) form.
+    ///   - output: The buffer to write the 32-byte shared secret into.
+    /// - Throws: `CryptoKitError.incorrectParameterSize` if any buffer has the wrong size, or
+    ///     `CryptoKitError.underlyingCoreCryptoError` if the scalar or the peer's point is invalid.
+    public static func _sharedSecret(
+        privateKey: UnsafeRawBufferPointer,
+        peerPublicKey: UnsafeRawBufferPointer,
+        into output: UnsafeMutableRawBufferPointer
+    ) throws {
+        try OpenSSLP256RawKeyAgreementImpl.sharedSecret(privateScalar: privateKey, peerPublicKey: peerPublicKey, into: output)
+    }
+
+    /// A P-256 private key whose scalar has been extracted once, so that key agreements with it do no heap
+    /// allocation.
+    ///
+    /// The scalar is wiped from memory when the last copy of the key is released. This type may be shared
+    /// freely between threads.
+    public struct _RawPrivateKey {
+        private let backing: OpenSSLP256RawPrivateKey
+
+        /// Extracts the scalar of a key agreement private key.
+        public init(_ privateKey: P256.KeyAgreement.PrivateKey) {
+            self.backing = OpenSSLP256RawPrivateKey(privateKey)
+        }
+
+        /// Computes the shared secret with a peer, writing it into a caller-provided buffer.
+        ///
+        /// - Parameters:
+        ///   - peerPublicKey: The peer's public key in 65-byte uncompressed (X9.63) form.
+        ///   - output: The buffer to write the 32-byte shared secret into.
+        /// - Throws: `CryptoKitError.incorrectParameterSize` if either buffer has the wrong size, or
+        ///     `CryptoKitError.underlyingCoreCryptoError` if the peer's point is invalid.
+        public func sharedSecret(withX963PeerPublicKey peerPublicKey: UnsafeRawBufferPointer, into output: UnsafeMutableRawBufferPointer) throws {
+            try self.backing.sharedSecret(peerPublicKey: peerPublicKey, into: output)
+        }
+
+        func withUnsafeScalar<Result>(_ body: (UnsafeRawBufferPointer) throws -> Result) rethrows -> Result {
+            try self.backing.withUnsafeScalar(body)
+        }
+    }
+}
+
+extension P256.KeyAgreement.PrivateKey {
+    /// This key's scalar in a form that can be used for allocation-free key agreement.
+    public var _raw: P256.KeyAgreement._RawPrivateKey {
+        P256.KeyAgreement._RawPrivateKey(self)
+    }
+}
+
+extension P256.KeyAgreement {
+    /// Computes many independent P-256 Diffie-Hellman shared secrets, each with its own private scalar and peer,
+    /// writing them into a caller-provided buffer.
+    ///
+    /// Each secret is the one ``_sharedSecret(privateKey:peerPublicKey:into:)`` computes for the corresponding pair.
+    /// On x86-64 machines with AVX-512 IFMA, eight pairs are multiplied at once in vector registers, which is several
+    /// times the throughput of computing them one at a time; elsewhere they are computed one at a time. This suits a
+    /// server that accumulates handshakes, each with a fresh ephemeral key, and completes them together.
+    ///
+    /// - Parameters:
+    ///   - privateKeys: The private scalars, back to back, each as 32 big-endian bytes.
+    ///   - peerPublicKeys: The peers' public keys, back to back, each in 65-byte uncompressed (X9.63) form.
+    ///   - output: The buffer to write the 32-byte shared secrets into, back to back.
+    /// - Throws: `CryptoKitError.incorrectParameterSize` if the buffers don't hold the same whole number of
+    ///     scalars, points and secrets, or `CryptoKitError.underlyingCoreCryptoError` if any scalar or point is
+    ///     invalid, in which case `output` is cleared.
+    public static func _sharedSecrets(
+        privateKeys: UnsafeRawBufferPointer,
+        peerPublicKeys: UnsafeRawBufferPointer,
+        into output: UnsafeMutableRawBufferPointer
+    ) throws {
+        try OpenSSLP256RawKeyAgreementImpl.sharedSecrets(privateScalars: privateKeys, peerPublicKeys: peerPublicKeys, into: output)
+    }
+}
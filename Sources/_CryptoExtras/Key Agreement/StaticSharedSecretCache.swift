@@ -0,0 +1,171 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+/// A bounded cache of static-static key agreement results, for protocols that agree the same shared secret every
+/// time a known peer connects.
+///
+/// Noise handshakes such as IK and KK, and other protocols that authenticate with long-term Diffie-Hellman keys,
+/// repeat a full scalar multiplication between the same two static keys on every reconnection. Passing a cache to
+/// `_sharedSecretFromKeyAgreement(with:cachingIn:)` returns the secret agreed the first time instead. When the cache
+/// is full, the least recently used secret is dropped.
+///
+/// Secrets are keyed by the curve, the local public key and the peer's public key, so one cache can serve any
+/// number of local keys, and a rotated key never finds its predecessor's secrets. A dropped secret's bytes are
+/// zeroed when the last copy of it is released, which may be later than the eviction if a caller still holds one.
+///
+/// Only cache secrets between static keys. Ephemeral keys are used once, so caching their secrets only keeps key
+/// material alive for longer. Whether a lookup hits is visible in its timing, which reveals whether a peer has
+/// connected recently.
+public final class _StaticSharedSecretCache: @unchecked Sendable {
+    /// The size and hit rate of a cache.
+    public struct Statistics: Sendable, Hashable {
+        /// The number of cached secrets.
+        public var secretCount: Int
+        /// The most secrets the cache holds.
+        public var capacity: Int
+        /// Key agreements answered from the cache.
+        public var hits: UInt64
+        /// Key agreements that had to be computed.
+        public var misses: UInt64
+        /// Secrets dropped to make room for another.
+        public var evictions: UInt64
+    }
+
+    fileprivate enum Curve: UInt8 {
+        case x25519 = 1
+        case p256 = 2
+        case p384 = 3
+        case p521 = 4
+    }
+
+    private let secrets: ShardedLRUCache<Data, SharedSecret>
+
+    /// Creates an empty cache.
+    ///
+    /// - Parameters:
+    ///   - capacity: The most secrets to keep, rounded up to a multiple of `shards`. Must be positive.
+    ///   - shards: The number of independently locked parts of the cache. Must be positive.
+    ///   - budget: The budget to charge the cached secrets to, or `nil` to bound the cache by `capacity` alone.
+    ///   - budgetWeight: The weight of the cache's share of `budget`. Must be positive.
+    public init(
+        capacity: Int = 1024,
+        shards: Int = 16,
+        budget: _CryptoCacheBudget? = .shared,
+        budgetWeight: Double = 1
+    ) {
+        // Each entry keeps its key and a secret of at most 66 bytes in an object of its own.
+        self.secrets = ShardedLRUCache(
+            capacity: capacity,
+            shardCount: shards,
+            budget: budget,
+            name: "_StaticSharedSecretCache",
+            weight: budgetWeight,
+            entryByteCount: { key, _ in key.count + 160 }
+        )
+    }
+
+    /// Drops every cached secret.
+    public func removeAll() {
+        self.secrets.removeAll()
+    }
+
+    /// A snapshot of the cache's size and hit rate.
+    public var statistics: Statistics {
+        let statistics = self.secrets.statistics
+        return Statistics(
+            secretCount: statistics.count,
+            capacity: self.secrets.capacity,
+            hits: statistics.hits,
+            misses: statistics.misses,
+            evictions: statistics.evictions
+        )
+    }
+
+    fileprivate func sharedSecret(
+        curve: Curve,
+        localPublicKey: Data,
+        peerPublicKey: Data,
+        agree: () throws -> SharedSecret
+    ) rethrows -> SharedSecret {
+        // Public keys of one curve have a fixed size, so the concatenation is unambiguous.
+        var key = Data(capacity: 1 + localPublicKey.count + peerPublicKey.count)
+        key.append(curve.rawValue)
+        key.append(localPublicKey)
+        key.append(peerPublicKey)
+        return try self.secrets.value(for: key, orInsert: agree)
+    }
+}
+
+extension Curve25519.KeyAgreement.PrivateKey {
+    /// Computes a shared secret with a peer's static public key, using `cache` to skip the computation for a peer seen
+    /// recently. See ``_StaticSharedSecretCache``.
+    ///
+    /// - Returns: The secret that ``sharedSecretFromKeyAgreement(with:)`` returns for the same arguments.
+    public func _sharedSecretFromKeyAgreement(
+        with publicKeyShare: Curve25519.KeyAgreement.PublicKey,
+        cachingIn cache: _StaticSharedSecretCache
+    ) throws -> SharedSecret {
+        try cache.sharedSecret(curve: .x25519, localPublicKey: self.publicKey.rawRepresentation, peerPublicKey: publicKeyShare.rawRepresentation) {
+            try self.sharedSecretFromKeyAgreement(with: publicKeyShare)
+        }
+    }
+}
+
+extension P256.KeyAgreement.PrivateKey {
+    /// Computes a shared secret with a peer's static public key, using `cache` to skip the computation for a peer seen
+    /// recently. See ``_StaticSharedSecretCache``.
+    ///
+    /// - Returns: The secret that ``sharedSecretFromKeyAgreement(with:)`` returns for the same arguments.
+    public func _sharedSecretFromKeyAgreement(
+        with publicKeyShare: P256.KeyAgreement.PublicKey,
+        cachingIn cache: _StaticSharedSecretCache
+    ) throws -> SharedSecret {
+        try cache.sharedSecret(curve: .p256, localPublicKey: self.publicKey.x963Representation, peerPublicKey: publicKeyShare.x963Representation) {
+            try self.sharedSecretFromKeyAgreement(with: publicKeyShare)
+        }
+    }
+}
+
+extension P384.KeyAgreement.PrivateKey {
+    /// Computes a shared secret with a peer's static public key, using `cache` to skip the computation for a peer seen
+    /// recently. See ``_StaticSharedSecretCache``.
+    ///
+    /// - Returns: The secret that ``sharedSecretFromKeyAgreement(with:)`` returns for the same arguments.
+    public func _sharedSecretFromKeyAgreement(
+        with publicKeyShare: P384.KeyAgreement.PublicKey,
+        cachingIn cache: _StaticSharedSecretCache
+    ) throws -> SharedSecret {
+        try cache.sharedSecret(curve: .p384, localPublicKey: self.publicKey.x963Representation, peerPublicKey: publicKeyShare.x963Representation) {
+            try self.sharedSecretFromKeyAgreement(with: publicKeyShare)
+        }
+    }
+}
+
+extension P521.KeyAgreement.PrivateKey {
+    /// Computes a shared secret with a peer's static public key, using `cache` to skip the computation for a peer seen
+    /// recently. See ``_StaticSharedSecretCache``.
+    ///
+    /// - Returns: The secret that ``sharedSecretFromKeyAgreement(with:)`` returns for the same arguments.
+    public func _sharedSecretFromKeyAgreement(
+        with publicKeyShare: P521.KeyAgreement.PublicKey,
+        cachingIn cache: _StaticSharedSecretCache
+    ) throws -> SharedSecret {
+        try cache.sharedSecret(curve: .p521, localPublicKey: self.publicKey.x963Representation, peerPublicKey: publicKeyShare.x963Representation) {
+            try self.sharedSecretFromKeyAgreement(with: publicKeyShare)
+        }
+    }
+}
@@ -0,0 +1,30 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+extension Curve25519.KeyAgreement.PrivateKey {
+    /// Computes the X25519 shared secrets between this key and each of the given public keys, in a single
+    /// call into BoringSSL.
+    ///
+    /// As with ``sharedSecretFromKeyAgreement(with:)``, the resulting values are raw Diffie-Hellman output
+    /// and must be passed through a key derivation function, such as ``HKDF``, before use as keys.
+    ///
+    /// - Parameter publicKeys: The peers' public keys.
+    /// - Returns: The raw shared secret with each peer, in the same order as `publicKeys`.
+    public func _sharedSecrets(with publicKeys: [Curve25519.KeyAgreement.PublicKey]) -> [SymmetricKey] {
+        OpenSSLX25519BatchImpl.sharedSecrets(privateKey: self, publicKeys: publicKeys)
+    }
+}
@@ -0,0 +1,136 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+#if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+// This is only used when bulding with BoringSSL.
+#else
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+#endif
+import Crypto
+import Foundation
+
+enum OpenSSLHKDFImpl<H: HashFunction> {
+    static func deriveKey<Salt: DataProtocol, Info: DataProtocol>(
+        inputKeyMaterial: SymmetricKey,
+        salt: Salt,
+        info: Info,
+        into output: UnsafeMutableRawBufferPointer
+    ) throws {
+        try inputKeyMaterial.withUnsafeBytes { secret in
+            try Self.deriveKey(inputKeyMaterial: secret, salt: salt, info: info, into: output)
+        }
+    }
+
+    static func deriveKey<Salt: DataProtocol, Info: DataProtocol>(
+        inputKeyMaterial secret: UnsafeRawBufferPointer,
+        salt: Salt,
+        info: Info,
+        into output: UnsafeMutableRawBufferPointer
+    ) throws {
+        #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+        try Self.genericDeriveKey(inputKeyMaterial: SymmetricKey(data: secret), salt: salt, info: info, into: output)
+        #else
+        guard let digest = try? DigestType(forDigestType: H.Digest.self) else {
+            // BoringSSL only knows the SHA family; anything else takes the generic path.
+            try Self.genericDeriveKey(inputKeyMaterial: SymmetricKey(data: secret), salt: salt, info: info, into: output)
+            return
+        }
+
+        let contiguousSalt: ContiguousBytes = salt.regions.count == 1 ? salt.regions.first! : Array(salt)
+        let contiguousInfo: ContiguousBytes = info.regions.count == 1 ? info.regions.first! : Array(info)
+        let rc = contiguousSalt.withUnsafeBytes { salt in
+            contiguousInfo.withUnsafeBytes { info in
+                CCryptoBoringSSLShims_HKDF(
+                    output.baseAddress, output.count, digest.dispatchTable,
+                    secret.baseAddress, secret.count,
+                    salt.baseAddress, salt.count,
+                    info.baseAddress, info.count
+                )
+            }
+        }
+        guard rc == 1 else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+        #endif
+    }
+
+    /// Writes HKDF-Extract of `secret` and `salt` to `output`, which must be `H.Digest.byteCount` bytes long.
+    static func extract<Salt: DataProtocol>(
+        inputKeyMaterial secret: UnsafeRawBufferPointer,
+        salt: Salt,
+        into output: UnsafeMutableRawBufferPointer
+    ) throws {
+        precondition(output.count == H.Digest.byteCount)
+        #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+        HKDF<H>.extract(inputKeyMaterial: SymmetricKey(data: secret), salt: salt).withUnsafeBytes { output.copyMemory(from: $0) }
+        #else
+        guard let digest = try? DigestType(forDigestType: H.Digest.self) else {
+            HKDF<H>.extract(inputKeyMaterial: SymmetricKey(data: secret), salt: salt).withUnsafeBytes { output.copyMemory(from: $0) }
+            return
+        }
+
+        let contiguousSalt: ContiguousBytes = salt.regions.count == 1 ? salt.regions.first! : Array(salt)
+        var outputLength = 0
+        let rc = contiguousSalt.withUnsafeBytes { salt in
+            CCryptoBoringSSL_HKDF_extract(
+                output.baseAddress?.assumingMemoryBound(to: UInt8.self), &outputLength, digest.dispatchTable,
+                secret.baseAddress?.assumingMemoryBound(to: UInt8.self), secret.count,
+                salt.baseAddress?.assumingMemoryBound(to: UInt8.self), salt.count
+            )
+        }
+        guard rc == 1, outputLength == output.count else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+        #endif
+    }
+
+    /// Fills `output` with HKDF-Expand of `pseudoRandomKey` and `info`.
+    static func expand<Info: DataProtocol>(
+        pseudoRandomKey: UnsafeRawBufferPointer,
+        info: Info,
+        into output: UnsafeMutableRawBufferPointer
+    ) throws {
+        #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+        try HKDF<H>._PreparedPseudoRandomKey(pseudoRandomKey).expand(info: info, into: output)
+        #else
+        guard let digest = try? DigestType(forDigestType: H.Digest.self) else {
+            try HKDF<H>._PreparedPseudoRandomKey(pseudoRandomKey).expand(info: info, into: output)
+            return
+        }
+
+        let contiguousInfo: ContiguousBytes = info.regions.count == 1 ? info.regions.first! : Array(info)
+        let rc = contiguousInfo.withUnsafeBytes { info in
+            CCryptoBoringSSL_HKDF_expand(
+                output.baseAddress?.assumingMemoryBound(to: UInt8.self), output.count, digest.dispatchTable,
+                pseudoRandomKey.baseAddress?.assumingMemoryBound(to: UInt8.self), pseudoRandomKey.count,
+                info.baseAddress?.assumingMemoryBound(to: UInt8.self), info.count
+            )
+        }
+        guard rc == 1 else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+        #endif
+    }
+
+    private static func genericDeriveKey<Salt: DataProtocol, Info: DataProtocol>(
+        inputKeyMaterial: SymmetricKey,
+        salt: Salt,
+        info: Info,
+        into output: UnsafeMutableRawBufferPointer
+    ) throws {
+        let key = HKDF<H>._PreparedPseudoRandomKey(inputKeyMaterial: inputKeyMaterial, salt: salt)
+        try key.expand(info: info, into: output)
+    }
+}
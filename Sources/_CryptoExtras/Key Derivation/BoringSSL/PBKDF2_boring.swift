@@ -0,0 +1,153 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+#if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+// This is only used when bulding with BoringSSL.
+#else
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+#endif
+import Crypto
+import Foundation
+
+enum OpenSSLPBKDF2Impl<H: HashFunction> {
+    static func deriveKey<Password: DataProtocol, Salt: DataProtocol>(
+        from password: Password,
+        salt: Salt,
+        outputByteCount: Int,
+        rounds: UInt32
+    ) throws -> SymmetricKey {
+        let contiguousPassword: ContiguousBytes = password.regions.count == 1 ? password.regions.first! : Array(password)
+        let contiguousSalt: ContiguousBytes = salt.regions.count == 1 ? salt.regions.first! : Array(salt)
+        return try contiguousPassword.withUnsafeBytes { password in
+            try contiguousSalt.withUnsafeBytes { salt in
+                try Self.deriveKey(from: password, salt: salt, outputByteCount: outputByteCount, rounds: rounds)
+            }
+        }
+    }
+
+    static func deriveKeys(
+        batch passwords: [UnsafeRawBufferPointer],
+        salts: [UnsafeRawBufferPointer],
+        outputByteCount: Int,
+        rounds: UInt32
+    ) throws -> [SymmetricKey] {
+        precondition(salts.count == passwords.count)
+
+        #if !(CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API)
+        if H.self == SHA256.self {
+            var output = [UInt8](repeating: 0, count: passwords.count * outputByteCount)
+            defer {
+                output.withUnsafeMutableBytes { CCryptoBoringSSL_OPENSSL_cleanse($0.baseAddress, $0.count) }
+            }
+            let rc = output.withUnsafeMutableBytes { output in
+                let ops = zip(passwords, salts).enumerated().map { index, input in
+                    CCryptoBoringSSLShims_PBKDF2_batch_op(
+                        password: input.0.baseAddress,
+                        password_len: input.0.count,
+                        salt: input.1.baseAddress,
+                        salt_len: input.1.count,
+                        out_key: output.baseAddress! + (index * outputByteCount)
+                    )
+                }
+                return ops.withUnsafeBufferPointer { ops in
+                    CCryptoBoringSSLShims_PBKDF2_HMAC_SHA256_batch(ops.baseAddress, ops.count, rounds, outputByteCount)
+                }
+            }
+            guard rc == 1 else {
+                throw CryptoKitError.internalBoringSSLError()
+            }
+            return output.withUnsafeBytes { output in
+                (0..<passwords.count).map { index in
+                    SymmetricKey(data: UnsafeRawBufferPointer(rebasing: output[(index * outputByteCount)..<((index + 1) * outputByteCount)]))
+                }
+            }
+        }
+        #endif
+
+        return try zip(passwords, salts).map { password, salt in
+            try Self.deriveKey(from: password, salt: salt, outputByteCount: outputByteCount, rounds: rounds)
+        }
+    }
+
+    private static func deriveKey(
+        from password: UnsafeRawBufferPointer,
+        salt: UnsafeRawBufferPointer,
+        outputByteCount: Int,
+        rounds: UInt32
+    ) throws -> SymmetricKey {
+        #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+        return Self.genericDeriveKey(from: password, salt: salt, outputByteCount: outputByteCount, rounds: rounds)
+        #else
+        guard let digest = try? DigestType(forDigestType: H.Digest.self) else {
+            // BoringSSL only knows the SHA family; anything else takes the generic path.
+            return Self.genericDeriveKey(from: password, salt: salt, outputByteCount: outputByteCount, rounds: rounds)
+        }
+
+        var output = [UInt8](repeating: 0, count: outputByteCount)
+        defer {
+            output.withUnsafeMutableBytes { CCryptoBoringSSL_OPENSSL_cleanse($0.baseAddress, $0.count) }
+        }
+        let rc = output.withUnsafeMutableBytes { output in
+            if digest.nid == NID_sha256 {
+                return CCryptoBoringSSLShims_PBKDF2_HMAC_SHA256(
+                    password.baseAddress, password.count,
+                    salt.baseAddress, salt.count,
+                    rounds, output.baseAddress, output.count
+                )
+            }
+            return CCryptoBoringSSL_PKCS5_PBKDF2_HMAC(
+                password.baseAddress?.assumingMemoryBound(to: CChar.self), password.count,
+                salt.baseAddress?.assumingMemoryBound(to: UInt8.self), salt.count,
+                rounds, digest.dispatchTable,
+                output.count, output.baseAddress?.assumingMemoryBound(to: UInt8.self)
+            )
+        }
+        guard rc == 1 else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+        return SymmetricKey(data: output)
+        #endif
+    }
+
+    private static func genericDeriveKey(
+        from password: UnsafeRawBufferPointer,
+        salt: UnsafeRawBufferPointer,
+        outputByteCount: Int,
+        rounds: UInt32
+    ) -> SymmetricKey {
+        // Preparing the key once means each round only hashes the previous block.
+        let key = HMAC<H>._PreparedKey(SymmetricKey(data: password))
+        var output = [UInt8]()
+        output.reserveCapacity(outputByteCount)
+
+        var blockIndex: UInt32 = 1
+        while output.count < outputByteCount {
+            var authenticator = key.makeAuthenticator()
+            authenticator.update(data: salt)
+            withUnsafeBytes(of: blockIndex.bigEndian) { authenticator.update(data: $0) }
+            var u = Array(authenticator.finalize())
+            var block = u
+            for _ in 1..<rounds {
+                u = Array(key.authenticationCode(for: u))
+                for index in block.indices {
+                    block[index] ^= u[index]
+                }
+            }
+            output.append(contentsOf: block.prefix(outputByteCount - output.count))
+            blockIndex += 1
+        }
+        return SymmetricKey(data: output)
+    }
+}
@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+import Crypto
+import Foundation
+
+enum OpenSSLScryptImpl {
+    static func deriveKey<Password: DataProtocol, Salt: DataProtocol>(
+        from password: Password,
+        salt: Salt,
+        outputByteCount: Int,
+        rounds: UInt64,
+        blockSize: UInt64,
+        parallelism: UInt64,
+        maxMemory: Int,
+        maxThreads: Int,
+        useHugePages: Bool,
+        cancellation: _CryptoCancellation? = nil
+    ) throws -> SymmetricKey {
+        let contiguousPassword: ContiguousBytes = password.regions.count == 1 ? password.regions.first! : Array(password)
+        let contiguousSalt: ContiguousBytes = salt.regions.count == 1 ? salt.regions.first! : Array(salt)
+
+        var output = [UInt8](repeating: 0, count: outputByteCount)
+        defer {
+            output.withUnsafeMutableBytes { CCryptoBoringSSL_OPENSSL_cleanse($0.baseAddress, $0.count) }
+        }
+        let derive = { (cancel: UnsafePointer<CCryptoBoringSSLShims_CANCEL_FLAG>?) in
+            contiguousPassword.withUnsafeBytes { password in
+                contiguousSalt.withUnsafeBytes { salt in
+                    output.withUnsafeMutableBytes { output in
+                        CCryptoBoringSSLShims_scrypt(
+                            password.baseAddress, password.count,
+                            salt.baseAddress, salt.count,
+                            rounds, blockSize, parallelism,
+                            maxMemory, maxThreads, useHugePages ? 1 : 0,
+                            output.baseAddress, output.count,
+                            cancel
+                        )
+                    }
+                }
+            }
+        }
+        let rc = cancellation.map { $0.withFlagPointer { derive($0) } } ?? derive(nil)
+        guard rc == 1 else {
+            try cancellation?.checkCancellation()
+            throw CryptoKitError.invalidParameter
+        }
+        return SymmetricKey(data: output)
+    }
+}
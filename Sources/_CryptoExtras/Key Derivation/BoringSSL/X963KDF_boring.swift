@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+// This is only used when bulding with BoringSSL.
+#else
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+#endif
+import Crypto
+import Foundation
+
+enum OpenSSLX963KDFImpl<H: HashFunction> {
+    static func deriveKey<SharedInfo: DataProtocol>(
+        sharedSecret: SharedSecret,
+        sharedInfo: SharedInfo,
+        into output: UnsafeMutableRawBufferPointer
+    ) throws {
+        #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+        Self.genericDeriveKey(sharedSecret: sharedSecret, sharedInfo: sharedInfo, into: output)
+        #else
+        guard let digest = try? DigestType(forDigestType: H.Digest.self) else {
+            // BoringSSL only knows the SHA family; anything else takes the generic path.
+            Self.genericDeriveKey(sharedSecret: sharedSecret, sharedInfo: sharedInfo, into: output)
+            return
+        }
+
+        let contiguousSharedInfo: ContiguousBytes = sharedInfo.regions.count == 1 ? sharedInfo.regions.first! : Array(sharedInfo)
+        let rc = sharedSecret.withUnsafeBytes { secret in
+            contiguousSharedInfo.withUnsafeBytes { sharedInfo in
+                CCryptoBoringSSLShims_X963_KDF(
+                    output.baseAddress, output.count, digest.dispatchTable,
+                    secret.baseAddress, secret.count,
+                    sharedInfo.baseAddress, sharedInfo.count
+                )
+            }
+        }
+        guard rc == 1 else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+        #endif
+    }
+
+    private static func genericDeriveKey<SharedInfo: DataProtocol>(
+        sharedSecret: SharedSecret,
+        sharedInfo: SharedInfo,
+        into output: UnsafeMutableRawBufferPointer
+    ) {
+        let key = sharedSecret.x963DerivedSymmetricKey(using: H.self, sharedInfo: sharedInfo, outputByteCount: output.count)
+        key.withUnsafeBytes { output.copyMemory(from: $0) }
+    }
+}
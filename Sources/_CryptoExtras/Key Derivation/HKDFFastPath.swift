@@ -0,0 +1,116 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+extension HKDF {
+    /// Derives key material into a caller-provided buffer using HKDF with the salt and information you specify.
+    ///
+    /// This performs the extract and expand steps in a single call without allocating any intermediate keys or
+    /// authentication codes, which makes it suitable for hot paths such as session-ticket key derivation.
+    /// The output is identical to ``HKDF/deriveKey(inputKeyMaterial:salt:info:outputByteCount:)`` with
+    /// `outputByteCount` equal to `output.count`.
+    ///
+    /// - Parameters:
+    ///   - inputKeyMaterial: The main key or passcode the derivation function uses to derive a key.
+    ///   - salt: The salt to use for key derivation.
+    ///   - info: The shared information to use for key derivation.
+    ///   - output: The buffer to fill with derived key material.
+    /// - Throws: `CryptoKitError.incorrectParameterSize` if `output` is longer than 255 times the digest size.
+    public static func _deriveKey<Salt: DataProtocol, Info: DataProtocol>(
+        inputKeyMaterial: SymmetricKey,
+        salt: Salt,
+        info: Info,
+        into output: UnsafeMutableRawBufferPointer
+    ) throws {
+        guard output.count <= 255 * H.Digest.byteCount else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+        try OpenSSLHKDFImpl<H>.deriveKey(inputKeyMaterial: inputKeyMaterial, salt: salt, info: info, into: output)
+    }
+
+    /// A pseudorandom key prepared for many HKDF expand operations.
+    ///
+    /// The HMAC key schedule for the pseudorandom key is computed once, so each call to
+    /// ``expand(info:into:)`` only pays for hashing the expand blocks themselves. This suits protocols that derive
+    /// several keys from one secret with different `info` values, such as HPKE and TLS 1.3 key schedules.
+    public struct _PreparedPseudoRandomKey {
+        private let key: HMAC<H>._PreparedKey
+
+        /// Prepares a pseudorandom key, such as the output of ``HKDF/extract(inputKeyMaterial:salt:)``.
+        ///
+        /// - Parameters:
+        ///   - pseudoRandomKey: The pseudorandom key to expand.
+        public init<PRK: ContiguousBytes>(_ pseudoRandomKey: PRK) {
+            self.key = HMAC<H>._PreparedKey(SymmetricKey(data: pseudoRandomKey))
+        }
+
+        /// Extracts and prepares a pseudorandom key from a main key or passcode.
+        ///
+        /// - Parameters:
+        ///   - inputKeyMaterial: The main key or passcode the derivation function uses to derive a key.
+        ///   - salt: The salt to use for key derivation.
+        public init<Salt: DataProtocol>(inputKeyMaterial: SymmetricKey, salt: Salt) {
+            self.init(HKDF<H>.extract(inputKeyMaterial: inputKeyMaterial, salt: salt))
+        }
+
+        /// Expands the pseudorandom key into a caller-provided buffer.
+        ///
+        /// - Parameters:
+        ///   - info: The shared information to use for key derivation.
+        ///   - output: The buffer to fill with derived key material.
+        /// - Throws: `CryptoKitError.incorrectParameterSize` if `output` is longer than 255 times the digest size.
+        public func expand<Info: DataProtocol>(info: Info, into output: UnsafeMutableRawBufferPointer) throws {
+            guard output.count <= 255 * H.Digest.byteCount else {
+                throw CryptoKitError.incorrectParameterSize
+            }
+
+            var offset = 0
+            var counter = UInt8(1)
+            var previousBlock: HMAC<H>.MAC? = nil
+            while offset < output.count {
+                var authenticator = self.key.makeAuthenticator()
+                previousBlock?.withUnsafeBytes { authenticator.update(data: $0) }
+                authenticator.update(data: info)
+                withUnsafeBytes(of: counter) { authenticator.update(data: $0) }
+                let block = authenticator.finalize()
+
+                let blockByteCount = min(H.Digest.byteCount, output.count - offset)
+                block.withUnsafeBytes { blockBytes in
+                    UnsafeMutableRawBufferPointer(rebasing: output[offset...]).copyMemory(from: UnsafeRawBufferPointer(rebasing: blockBytes.prefix(blockByteCount)))
+                }
+                offset += blockByteCount
+                counter &+= 1
+                previousBlock = block
+            }
+        }
+
+        /// Expands the pseudorandom key into a derived symmetric key.
+        ///
+        /// - Parameters:
+        ///   - info: The shared information to use for key derivation.
+        ///   - outputByteCount: The length in bytes of the resulting symmetric key.
+        /// - Returns: The derived symmetric key.
+        /// - Throws: `CryptoKitError.incorrectParameterSize` if `outputByteCount` is longer than 255 times the digest size.
+        public func expand<Info: DataProtocol>(info: Info, outputByteCount: Int) throws -> SymmetricKey {
+            var output = [UInt8](repeating: 0, count: outputByteCount)
+            defer {
+                output.withUnsafeMutableBytes { $0.initializeMemory(as: UInt8.self, repeating: 0) }
+            }
+            try output.withUnsafeMutableBytes { try self.expand(info: info, into: $0) }
+            return SymmetricKey(data: output)
+        }
+    }
+}
@@ -0,0 +1,176 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+
+extension HKDF {
+    /// Derives keys from a tree of HKDF derivations rooted at one key, caching the pseudorandom keys of the
+    /// tree's inner nodes.
+    ///
+    /// Key trees such as per-tenant, per-table and per-column keys are often derived by nesting
+    /// ``HKDF/deriveKey(inputKeyMaterial:salt:info:outputByteCount:)`` calls, which walks every extract and expand
+    /// from the root for each key. A hierarchy gives the same keys: the key at path `[tenant, table]` with `info` is
+    ///
+    /// ```swift
+    /// let tenantKey = HKDF<H>.deriveKey(
+    ///     inputKeyMaterial: rootKey, salt: salt, info: tenant, outputByteCount: intermediateKeyByteCount
+    /// )
+    /// let tableKey = HKDF<H>.deriveKey(
+    ///     inputKeyMaterial: tenantKey, salt: salt, info: table, outputByteCount: intermediateKeyByteCount
+    /// )
+    /// let key = HKDF<H>.deriveKey(inputKeyMaterial: tableKey, salt: salt, info: info, outputByteCount: outputByteCount)
+    /// ```
+    ///
+    /// but the pseudorandom key extracted at each path is kept in a bounded cache, so a key under a cached path
+    /// costs a single HKDF expand. When the cache is full, the least recently used path is dropped, and a path
+    /// missing from the cache is derived from its longest cached prefix.
+    ///
+    /// Cached pseudorandom keys are held as `SymmetricKey`s, so their bytes are cleared when they are dropped, and
+    /// every intermediate key is cleared as soon as it has been used. Hierarchies are internally synchronised and
+    /// may be shared freely between threads.
+    public final class _KeyHierarchy: @unchecked Sendable {
+        private let rootPseudoRandomKey: SymmetricKey
+
+        private let salt: Data
+
+        private let intermediateByteCount: Int
+
+        private let pseudoRandomKeys: ShardedLRUCache<[Data], SymmetricKey>
+
+        /// Creates a hierarchy rooted at `rootKey`.
+        ///
+        /// - Parameters:
+        ///   - rootKey: The key at the root of the tree.
+        ///   - salt: The salt used by every derivation in the tree.
+        ///   - intermediateKeyByteCount: The length of the key derived at each inner node of the tree. Defaults to
+        ///     the digest size.
+        ///   - capacity: The most paths to keep, rounded up to a multiple of `shards`. Must be positive.
+        ///   - shards: The number of independently locked parts of the cache. Must be positive.
+        ///   - budget: The budget to charge the cached keys to, or `nil` to bound the cache by `capacity` alone.
+        ///   - budgetWeight: The weight of the cache's share of `budget`. Must be positive.
+        /// - Throws: `CryptoKitError.incorrectParameterSize` if `intermediateKeyByteCount` isn't positive or is
+        ///   longer than 255 times the digest size.
+        public init<Salt: DataProtocol>(
+            rootKey: SymmetricKey,
+            salt: Salt,
+            intermediateKeyByteCount: Int = H.Digest.byteCount,
+            capacity: Int = 1024,
+            shards: Int = 16,
+            budget: _CryptoCacheBudget? = .shared,
+            budgetWeight: Double = 1
+        ) throws {
+            guard intermediateKeyByteCount > 0, intermediateKeyByteCount <= 255 * H.Digest.byteCount else {
+                throw CryptoKitError.incorrectParameterSize
+            }
+            let salt = Data(salt)
+            self.salt = salt
+            self.intermediateByteCount = intermediateKeyByteCount
+            // Each entry keeps its path and a pseudorandom key in objects of their own.
+            self.pseudoRandomKeys = ShardedLRUCache(
+                capacity: capacity,
+                shardCount: shards,
+                budget: budget,
+                name: "HKDF._KeyHierarchy",
+                weight: budgetWeight,
+                entryByteCount: { path, key in path.reduce(0) { $0 + $1.count + 32 } + key.bitCount / 8 + 96 }
+            )
+            self.rootPseudoRandomKey = try rootKey.withUnsafeBytes { rootKey in
+                try Self.extract(inputKeyMaterial: rootKey, salt: salt)
+            }
+        }
+
+        /// Derives the key at `path` with `info` into a caller-provided buffer.
+        ///
+        /// - Parameters:
+        ///   - path: The `info` of each derivation from the root to the key's parent, outermost first. An empty
+        ///     path derives straight from the root key.
+        ///   - info: The shared information for the final derivation.
+        ///   - output: The buffer to fill with derived key material.
+        /// - Throws: `CryptoKitError.incorrectParameterSize` if `output` is longer than 255 times the digest size.
+        public func deriveKey<PathComponent: DataProtocol, Info: DataProtocol>(
+            path: [PathComponent],
+            info: Info,
+            into output: UnsafeMutableRawBufferPointer
+        ) throws {
+            guard output.count <= 255 * H.Digest.byteCount else {
+                throw CryptoKitError.incorrectParameterSize
+            }
+            try self.pseudoRandomKey(for: path.map { Data($0) }).withUnsafeBytes { pseudoRandomKey in
+                try OpenSSLHKDFImpl<H>.expand(pseudoRandomKey: pseudoRandomKey, info: info, into: output)
+            }
+        }
+
+        /// Derives the key at `path` with `info`.
+        ///
+        /// - Parameters:
+        ///   - path: The `info` of each derivation from the root to the key's parent, outermost first. An empty
+        ///     path derives straight from the root key.
+        ///   - info: The shared information for the final derivation.
+        ///   - outputByteCount: The length in bytes of the resulting symmetric key.
+        /// - Returns: The derived symmetric key.
+        /// - Throws: `CryptoKitError.incorrectParameterSize` if `outputByteCount` is longer than 255 times the digest
+        ///   size.
+        public func deriveKey<PathComponent: DataProtocol, Info: DataProtocol>(
+            path: [PathComponent],
+            info: Info,
+            outputByteCount: Int
+        ) throws -> SymmetricKey {
+            var output = [UInt8](repeating: 0, count: outputByteCount)
+            defer {
+                output.withUnsafeMutableBytes { $0.initializeMemory(as: UInt8.self, repeating: 0) }
+            }
+            try output.withUnsafeMutableBytes { try self.deriveKey(path: path, info: info, into: $0) }
+            return SymmetricKey(data: output)
+        }
+
+        /// Drops every cached path.
+        public func removeAll() {
+            self.pseudoRandomKeys.removeAll()
+        }
+
+        /// A snapshot of the cache's size and hit rate, counting paths as keys.
+        public var statistics: _PreparedKeyCacheStatistics {
+            _PreparedKeyCacheStatistics(self.pseudoRandomKeys)
+        }
+
+        /// Returns the pseudorandom key extracted at `path`, deriving it and any missing prefixes of it on a miss.
+        private func pseudoRandomKey(for path: [Data]) throws -> SymmetricKey {
+            guard let component = path.last else {
+                return self.rootPseudoRandomKey
+            }
+            return try self.pseudoRandomKeys.value(for: path) {
+                let parent = try self.pseudoRandomKey(for: Array(path.dropLast()))
+                return try withUnsafeTemporaryAllocation(byteCount: self.intermediateByteCount, alignment: 1) { key in
+                    defer {
+                        key.initializeMemory(as: UInt8.self, repeating: 0)
+                    }
+                    try parent.withUnsafeBytes { parent in
+                        try OpenSSLHKDFImpl<H>.expand(pseudoRandomKey: parent, info: component, into: key)
+                    }
+                    return try Self.extract(inputKeyMaterial: UnsafeRawBufferPointer(key), salt: self.salt)
+                }
+            }
+        }
+
+        private static func extract(inputKeyMaterial: UnsafeRawBufferPointer, salt: Data) throws -> SymmetricKey {
+            try withUnsafeTemporaryAllocation(byteCount: H.Digest.byteCount, alignment: 1) { pseudoRandomKey in
+                defer {
+                    pseudoRandomKey.initializeMemory(as: UInt8.self, repeating: 0)
+                }
+                try OpenSSLHKDFImpl<H>.extract(inputKeyMaterial: inputKeyMaterial, salt: salt, into: pseudoRandomKey)
+                return SymmetricKey(data: UnsafeRawBufferPointer(pseudoRandomKey))
+            }
+        }
+    }
+}
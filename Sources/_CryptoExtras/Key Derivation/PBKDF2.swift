@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+/// The password-based key derivation function PBKDF2, as specified in RFC 8018, with HMAC as the
+/// pseudorandom function.
+///
+/// PBKDF2 is deliberately slow, so that guessing passwords is slow too. Choose `rounds` to be as
+/// large as your latency budget allows; OWASP currently recommends 600,000 for HMAC-SHA256.
+///
+/// The HMAC pad states for a password are computed once, so every round costs exactly two
+/// compression function calls. With SHA-256, ``deriveKeys(batch:salts:outputByteCount:rounds:)``
+/// additionally runs many derivations side by side in SIMD lanes where the CPU supports it.
+public enum _PBKDF2<H: HashFunction> {
+    /// Derives a symmetric key from a password.
+    ///
+    /// - Parameters:
+    ///   - password: The password to derive the key from.
+    ///   - salt: The salt. Use a unique random salt of at least 16 bytes for every password.
+    ///   - outputByteCount: The length in bytes of the key to derive.
+    ///   - rounds: The number of iterations.
+    /// - Returns: The derived key.
+    /// - Throws: `CryptoKitError.incorrectParameterSize` if `outputByteCount` isn't positive, or
+    ///   `CryptoKitError.invalidParameter` if `rounds` isn't between 1 and `UInt32.max`.
+    public static func deriveKey<Password: DataProtocol, Salt: DataProtocol>(
+        from password: Password,
+        salt: Salt,
+        outputByteCount: Int,
+        rounds: Int
+    ) throws -> SymmetricKey {
+        try Self.validate(outputByteCount: outputByteCount, rounds: rounds)
+        return try OpenSSLPBKDF2Impl<H>.deriveKey(
+            from: password,
+            salt: salt,
+            outputByteCount: outputByteCount,
+            rounds: UInt32(rounds)
+        )
+    }
+
+    /// Derives a symmetric key from each of many passwords, all with the same parameters.
+    ///
+    /// This is intended for services that verify many passwords concurrently. With SHA-256 on
+    /// x86-64 CPUs that have AVX2 but not the SHA extensions, eight derivations run at once in SIMD
+    /// lanes; elsewhere the derivations run one after another.
+    ///
+    /// - Parameters:
+    ///   - passwords: The passwords to derive keys from.
+    ///   - salts: The salt for each password. Must have the same count as `passwords`.
+    ///   - outputByteCount: The length in bytes of each key to derive.
+    ///   - rounds: The number of iterations.
+    /// - Returns: The key derived from each password, in the same order as `passwords`.
+    /// - Throws: `CryptoKitError.incorrectParameterSize` if `salts` has the wrong count or
+    ///   `outputByteCount` isn't positive, or `CryptoKitError.invalidParameter` if `rounds` isn't
+    ///   between 1 and `UInt32.max`.
+    public static func deriveKeys(
+        batch passwords: [UnsafeRawBufferPointer],
+        salts: [UnsafeRawBufferPointer],
+        outputByteCount: Int,
+        rounds: Int
+    ) throws -> [SymmetricKey] {
+        guard salts.count == passwords.count else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+        try Self.validate(outputByteCount: outputByteCount, rounds: rounds)
+        return try OpenSSLPBKDF2Impl<H>.deriveKeys(
+            batch: passwords,
+            salts: salts,
+            outputByteCount: outputByteCount,
+            rounds: UInt32(rounds)
+        )
+    }
+
+    private static func validate(outputByteCount: Int, rounds: Int) throws {
+        // RFC 8018 limits the output to 2^32 - 1 blocks.
+        guard outputByteCount > 0, outputByteCount / H.Digest.byteCount < Int(UInt32.max) else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+        guard rounds >= 1, rounds <= UInt32.max else {
+            throw CryptoKitError.invalidParameter
+        }
+    }
+}
@@ -0,0 +1,120 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+/// The memory-hard password-based key derivation function scrypt, as specified in RFC 7914.
+///
+/// scrypt's `parallelism` lanes are independent, so they can run on several threads at once. Each
+/// thread needs its own `128 * blockSize * rounds` bytes of scratch memory, which must fit within
+/// `maxMemory` together with the lanes' state. If it can't hold every requested thread, fewer
+/// are used. The output doesn't depend on the number of threads.
+public enum _Scrypt {
+    /// The memory limit used when none is given, matching BoringSSL's `EVP_PBE_scrypt`.
+    public static let defaultMaxMemory = 32 * 1024 * 1024
+
+    /// Derives a symmetric key from a password.
+    ///
+    /// - Parameters:
+    ///   - password: The password to derive the key from.
+    ///   - salt: The salt. Use a unique random salt of at least 16 bytes for every password.
+    ///   - outputByteCount: The length in bytes of the key to derive.
+    ///   - rounds: The CPU and memory cost, N. Must be a power of two greater than one.
+    ///   - blockSize: The block size, r.
+    ///   - parallelism: The number of independent lanes, p.
+    ///   - maxMemory: The most memory, in bytes, the derivation may use.
+    ///   - maxThreads: The most threads that may compute lanes concurrently, including the
+    ///     calling thread.
+    ///   - useHugePages: Whether to ask the operating system to back the scratch memory with huge
+    ///     pages, which reduces TLB misses for large `rounds`. This is only a hint.
+    /// - Returns: The derived key.
+    /// - Throws: `CryptoKitError.incorrectParameterSize` if `outputByteCount` isn't positive, or
+    ///   `CryptoKitError.invalidParameter` if the cost parameters are invalid or need more than
+    ///   `maxMemory` bytes for a single thread.
+    public static func deriveKey<Password: DataProtocol, Salt: DataProtocol>(
+        from password: Password,
+        salt: Salt,
+        outputByteCount: Int,
+        rounds: Int,
+        blockSize: Int,
+        parallelism: Int,
+        maxMemory: Int = Self.defaultMaxMemory,
+        maxThreads: Int = 1,
+        useHugePages: Bool = false
+    ) throws -> SymmetricKey {
+        guard outputByteCount > 0 else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+        guard rounds > 1, blockSize > 0, parallelism > 0, maxMemory > 0, maxThreads > 0 else {
+            throw CryptoKitError.invalidParameter
+        }
+        return try OpenSSLScryptImpl.deriveKey(
+            from: password,
+            salt: salt,
+            outputByteCount: outputByteCount,
+            rounds: UInt64(rounds),
+            blockSize: UInt64(blockSize),
+            parallelism: UInt64(parallelism),
+            maxMemory: maxMemory,
+            maxThreads: maxThreads,
+            useHugePages: useHugePages
+        )
+    }
+
+    /// Derives a symmetric key from a password on `executor`, suspending the calling task until it's done.
+    ///
+    /// The parameters and errors are as for
+    /// ``deriveKey(from:salt:outputByteCount:rounds:blockSize:parallelism:maxMemory:maxThreads:useHugePages:)``.
+    /// Cancelling the calling task stops the derivation within a few hundred ROMix iterations.
+    ///
+    /// - Throws: `CancellationError` if the calling task is cancelled before the key is derived.
+    public static func deriveKey<Password: DataProtocol, Salt: DataProtocol>(
+        from password: Password,
+        salt: Salt,
+        outputByteCount: Int,
+        rounds: Int,
+        blockSize: Int,
+        parallelism: Int,
+        maxMemory: Int = Self.defaultMaxMemory,
+        maxThreads: Int = 1,
+        useHugePages: Bool = false,
+        on executor: _CryptoExecutor,
+        priority: _CryptoExecutor.Priority = .utility
+    ) async throws -> SymmetricKey {
+        guard outputByteCount > 0 else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+        guard rounds > 1, blockSize > 0, parallelism > 0, maxMemory > 0, maxThreads > 0 else {
+            throw CryptoKitError.invalidParameter
+        }
+        // Copy the inputs so that the operation doesn't depend on the caller's storage.
+        let password = Array(password)
+        let salt = Array(salt)
+        return try await executor.run(priority: priority) { cancellation in
+            try OpenSSLScryptImpl.deriveKey(
+                from: password,
+                salt: salt,
+                outputByteCount: outputByteCount,
+                rounds: UInt64(rounds),
+                blockSize: UInt64(blockSize),
+                parallelism: UInt64(parallelism),
+                maxMemory: maxMemory,
+                maxThreads: maxThreads,
+                useHugePages: useHugePages,
+                cancellation: cancellation
+            )
+        }
+    }
+}
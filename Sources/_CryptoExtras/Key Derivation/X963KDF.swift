@@ -0,0 +1,42 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+extension SharedSecret {
+    /// Derives key material from the secret into a caller-provided buffer using X9.63 key derivation.
+    ///
+    /// The shared secret is hashed once rather than once per digest-sized block, and each block is written straight
+    /// into `output`, so no intermediate keys or digests are allocated. This suits ECIES-style schemes that derive an
+    /// encryption key and a MAC key for every message. The output is identical to
+    /// ``SharedSecret/x963DerivedSymmetricKey(using:sharedInfo:outputByteCount:)`` with `outputByteCount` equal to
+    /// `output.count`.
+    ///
+    /// - Parameters:
+    ///   - hashFunction: The hash function to use for key derivation.
+    ///   - sharedInfo: The shared information to use for key derivation.
+    ///   - output: The buffer to fill with derived key material.
+    /// - Throws: `CryptoKitError.incorrectParameterSize` if `output` is too long for `hashFunction`.
+    public func _x963DeriveKey<H: HashFunction, SharedInfo: DataProtocol>(
+        using hashFunction: H.Type,
+        sharedInfo: SharedInfo,
+        into output: UnsafeMutableRawBufferPointer
+    ) throws {
+        guard UInt64(output.count) < UInt64(H.Digest.byteCount) * UInt64(UInt32.max) else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+        try OpenSSLX963KDFImpl<H>.deriveKey(sharedSecret: self, sharedInfo: sharedInfo, into: output)
+    }
+}
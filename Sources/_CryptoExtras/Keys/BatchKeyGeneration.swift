@@ -0,0 +1,56 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+
+extension P256 {
+    /// Generates a batch of P-256 key pairs, writing them back to back into caller-provided buffers.
+    ///
+    /// The public points are converted out of projective coordinates together, so the whole batch pays for
+    /// one field inversion per 32 keys rather than one per key. The keys can be used directly with
+    /// ``P256/KeyAgreement/_sharedSecret(privateKey:peerPublicKey:into:)``.
+    ///
+    /// - Parameters:
+    ///   - privateKeys: The buffer to write the private scalars into, as 32 big-endian bytes each. Its size
+    ///     sets the number of keys generated.
+    ///   - publicKeys: The buffer to write the public keys into, in 65-byte uncompressed (X9.63) form. It must
+    ///     hold exactly one public key per private key.
+    /// - Throws: `CryptoKitError.incorrectParameterSize` if the buffers don't hold the same number of keys.
+    public static func _generateKeyPairs(
+        privateKeys: UnsafeMutableRawBufferPointer,
+        publicKeys: UnsafeMutableRawBufferPointer
+    ) throws {
+        try OpenSSLBatchKeyGenerationImpl.generateP256KeyPairs(privateKeys: privateKeys, publicKeys: publicKeys)
+    }
+}
+
+extension Curve25519.Signing {
+    /// Generates a batch of Ed25519 key pairs, writing them back to back into caller-provided buffers.
+    ///
+    /// Each seed is the ``PrivateKey/rawRepresentation`` of a private key, and each public key is the
+    /// ``PublicKey/rawRepresentation`` of its public key.
+    ///
+    /// - Parameters:
+    ///   - seeds: The buffer to write the 32-byte private key seeds into. Its size sets the number of keys
+    ///     generated.
+    ///   - publicKeys: The buffer to write the 32-byte public keys into. It must hold exactly one public key
+    ///     per seed.
+    /// - Throws: `CryptoKitError.incorrectParameterSize` if the buffers don't hold the same number of keys.
+    public static func _generateKeyPairs(
+        seeds: UnsafeMutableRawBufferPointer,
+        publicKeys: UnsafeMutableRawBufferPointer
+    ) throws {
+        try OpenSSLBatchKeyGenerationImpl.generateEd25519KeyPairs(seeds: seeds, publicKeys: publicKeys)
+    }
+}
@@ -0,0 +1,61 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+import Crypto
+import Foundation
+
+enum OpenSSLBatchKeyGenerationImpl {
+    static let ed25519SeedByteCount = Int(CCryptoBoringSSLShims_ED25519_SEED_BYTES)
+    static let ed25519PublicKeyByteCount = Int(ED25519_PUBLIC_KEY_LEN)
+
+    static func generateP256KeyPairs(
+        privateKeys: UnsafeMutableRawBufferPointer,
+        publicKeys: UnsafeMutableRawBufferPointer
+    ) throws {
+        let scalarByteCount = OpenSSLP256RawKeyAgreementImpl.scalarByteCount
+        let pointByteCount = OpenSSLP256RawKeyAgreementImpl.uncompressedPointByteCount
+
+        guard privateKeys.count % scalarByteCount == 0,
+              publicKeys.count == (privateKeys.count / scalarByteCount) * pointByteCount else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+
+        let count = privateKeys.count / scalarByteCount
+        guard count > 0 else {
+            return
+        }
+
+        guard CCryptoBoringSSLShims_p256_generate_keys(privateKeys.baseAddress, publicKeys.baseAddress, count) == 1 else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+    }
+
+    static func generateEd25519KeyPairs(
+        seeds: UnsafeMutableRawBufferPointer,
+        publicKeys: UnsafeMutableRawBufferPointer
+    ) throws {
+        guard seeds.count % Self.ed25519SeedByteCount == 0,
+              publicKeys.count == (seeds.count / Self.ed25519SeedByteCount) * Self.ed25519PublicKeyByteCount else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+
+        let count = seeds.count / Self.ed25519SeedByteCount
+        guard count > 0 else {
+            return
+        }
+
+        CCryptoBoringSSLShims_ED25519_generate_keys(seeds.baseAddress, publicKeys.baseAddress, count)
+    }
+}
@@ -0,0 +1,50 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+import Crypto
+import Foundation
+
+enum OpenSSLCompactPublicKeyImpl {
+    typealias Curve = OpenSSLCompressedPointsImpl.Curve
+
+    /// Checks that `rawRepresentation` is a point on `curve` and copies it into `storage`.
+    static func load(_ rawRepresentation: UnsafeRawBufferPointer, into storage: UnsafeMutableRawBufferPointer, curve: Curve) throws {
+        assert(storage.count == curve.coordinateByteCount * 2)
+        guard rawRepresentation.count == storage.count else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+        guard CCryptoBoringSSLShims_EC_raw_point_is_valid(curve.nid, rawRepresentation.baseAddress, rawRepresentation.count) == 1 else {
+            throw CryptoKitError.invalidParameter
+        }
+        storage.copyMemory(from: rawRepresentation)
+    }
+
+    static func isValidSignature(
+        _ signature: Data,
+        for digest: UnsafeRawBufferPointer,
+        point: UnsafeRawBufferPointer,
+        curve: Curve
+    ) -> Bool {
+        signature.withUnsafeBytes { signature in
+            CCryptoBoringSSLShims_ECDSA_verify_raw_point(
+                curve.nid,
+                point.baseAddress, point.count,
+                digest.baseAddress, digest.count,
+                signature.baseAddress, signature.count
+            ) == 1
+        }
+    }
+}
@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+import Crypto
+import Foundation
+
+enum OpenSSLCompressedPointsImpl {
+    enum Curve {
+        case p256
+        case p384
+        case p521
+
+        var nid: CInt {
+            switch self {
+            case .p256:
+                return NID_X9_62_prime256v1
+            case .p384:
+                return NID_secp384r1
+            case .p521:
+                return NID_secp521r1
+            }
+        }
+
+        var coordinateByteCount: Int {
+            switch self {
+            case .p256:
+                return 32
+            case .p384:
+                return 48
+            case .p521:
+                return 66
+            }
+        }
+    }
+
+    static func decompress(_ compressedKeys: UnsafeRawBufferPointer, into output: UnsafeMutableRawBufferPointer, curve: Curve) throws {
+        let compressedByteCount = curve.coordinateByteCount + 1
+        let uncompressedByteCount = (curve.coordinateByteCount * 2) + 1
+
+        guard compressedKeys.count % compressedByteCount == 0,
+              output.count == (compressedKeys.count / compressedByteCount) * uncompressedByteCount else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+
+        let count = compressedKeys.count / compressedByteCount
+        guard count > 0 else {
+            return
+        }
+
+        guard CCryptoBoringSSLShims_EC_points_decompress(curve.nid, output.baseAddress, compressedKeys.baseAddress, count) == count else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+    }
+}
@@ -0,0 +1,91 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+import Crypto
+import Foundation
+
+enum OpenSSLHashToCurveImpl {
+    typealias Curve = OpenSSLCompressedPointsImpl.Curve
+
+    static func hash<Message: DataProtocol, DST: DataProtocol>(
+        _ message: Message,
+        domainSeparationTag: DST,
+        curve: Curve
+    ) throws -> Data {
+        guard domainSeparationTag.count > 0 else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+
+        var point = Data(count: (curve.coordinateByteCount * 2) + 1)
+        let message: ContiguousBytes = message.regions.count == 1 ? message.regions.first! : Array(message)
+        let dst: ContiguousBytes = domainSeparationTag.regions.count == 1 ? domainSeparationTag.regions.first! : Array(domainSeparationTag)
+        let rc = point.withUnsafeMutableBytes { point in
+            message.withUnsafeBytes { message in
+                dst.withUnsafeBytes { dst in
+                    CCryptoBoringSSLShims_EC_hash_to_curve(
+                        curve.nid, point.baseAddress, dst.baseAddress, dst.count, message.baseAddress, message.count
+                    )
+                }
+            }
+        }
+        guard rc == 1 else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+        return point
+    }
+
+    static func hash<Message: DataProtocol, DST: DataProtocol>(
+        _ messages: [Message],
+        domainSeparationTag: DST,
+        into output: UnsafeMutableRawBufferPointer,
+        curve: Curve
+    ) throws {
+        guard domainSeparationTag.count > 0, output.count == messages.count * ((curve.coordinateByteCount * 2) + 1) else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+        guard messages.count > 0 else {
+            return
+        }
+
+        // Lay the messages out back to back, so one set of pointers reaches them all.
+        var bytes = [UInt8]()
+        bytes.reserveCapacity(messages.reduce(0) { $0 + $1.count })
+        var offsets = [Int]()
+        offsets.reserveCapacity(messages.count)
+        for message in messages {
+            offsets.append(bytes.count)
+            bytes.append(contentsOf: message)
+        }
+        let lengths = messages.map { $0.count }
+        let dst: ContiguousBytes = domainSeparationTag.regions.count == 1 ? domainSeparationTag.regions.first! : Array(domainSeparationTag)
+
+        let hashed = bytes.withUnsafeBufferPointer { bytes in
+            let pointers = offsets.map { bytes.baseAddress.map { base in UnsafePointer(base + $0) } }
+            return pointers.withUnsafeBufferPointer { pointers in
+                lengths.withUnsafeBufferPointer { lengths in
+                    dst.withUnsafeBytes { dst in
+                        CCryptoBoringSSLShims_EC_hash_to_curve_batch(
+                            curve.nid, output.baseAddress, dst.baseAddress, dst.count,
+                            pointers.baseAddress, lengths.baseAddress, messages.count
+                        )
+                    }
+                }
+            }
+        }
+        guard hashed == messages.count else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+    }
+}
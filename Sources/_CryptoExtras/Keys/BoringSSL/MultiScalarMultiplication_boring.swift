@@ -0,0 +1,51 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+import Crypto
+import Foundation
+
+enum OpenSSLMultiScalarMultiplicationImpl {
+    typealias Curve = OpenSSLCompressedPointsImpl.Curve
+
+    /// Returns the uncompressed sum, or `nil` for the point at infinity.
+    static func sum(
+        scalars: UnsafeRawBufferPointer,
+        points: UnsafeRawBufferPointer,
+        maximumThreadCount: Int,
+        curve: Curve
+    ) throws -> Data? {
+        // The order of P-256 and P-384 is as wide as the field.
+        let scalarByteCount = curve.coordinateByteCount
+        let pointByteCount = (curve.coordinateByteCount * 2) + 1
+        guard scalars.count % scalarByteCount == 0,
+              points.count % pointByteCount == 0,
+              scalars.count / scalarByteCount == points.count / pointByteCount else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+
+        var sum = Data(count: pointByteCount)
+        var isInfinity = CInt(0)
+        let rc = sum.withUnsafeMutableBytes { sum in
+            CCryptoBoringSSLShims_EC_multi_scalar_mul(
+                curve.nid, sum.baseAddress, &isInfinity, scalars.baseAddress, points.baseAddress,
+                points.count / pointByteCount, max(maximumThreadCount, 1)
+            )
+        }
+        guard rc == 1 else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+        return isInfinity != 0 ? nil : sum
+    }
+}
@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+#if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+enum OpenSSLPreparedPublicKeyImpl {
+    // CryptoKit verifies Ed25519 signatures its own way, so there is no table to prepare.
+    static let ed25519Layout = UInt16(0)
+
+    static func prepareEd25519(_ publicKey: Data) -> Data? {
+        nil
+    }
+
+    static func isValidEd25519Signature<S: DataProtocol, D: DataProtocol>(_ signature: S, for data: D, publicKey: UnsafeRawBufferPointer, prepared: UnsafeRawBufferPointer) -> Bool {
+        guard let publicKey = try? Curve25519.Signing.PublicKey(rawRepresentation: publicKey) else {
+            return false
+        }
+        return publicKey.isValidSignature(signature, for: data)
+    }
+}
+#else
+@_implementationOnly import CCryptoBoringSSLShims
+
+enum OpenSSLPreparedPublicKeyImpl {
+    static let ed25519Layout = UInt16(CCryptoBoringSSLShims_ED25519_prepared_layout())
+
+    static func prepareEd25519(_ publicKey: Data) -> Data? {
+        var prepared = Data(repeating: 0, count: Int(CCryptoBoringSSLShims_ED25519_PREPARED_BYTES))
+        let rc = prepared.withUnsafeMutableBytes { preparedPointer in
+            publicKey.withUnsafeBytes { publicKeyPointer in
+                CCryptoBoringSSLShims_ED25519_prepare(preparedPointer.baseAddress, publicKeyPointer.baseAddress)
+            }
+        }
+        return rc == 1 ? prepared : nil
+    }
+
+    static func isValidEd25519Signature<S: DataProtocol, D: DataProtocol>(_ signature: S, for data: D, publicKey: UnsafeRawBufferPointer, prepared: UnsafeRawBufferPointer) -> Bool {
+        precondition(publicKey.count == 32 && prepared.count == Int(CCryptoBoringSSLShims_ED25519_PREPARED_BYTES))
+        guard signature.count == 64 else {
+            return false
+        }
+        let signatureBytes = Array(signature)
+        let verify = { (message: UnsafeRawBufferPointer) -> Bool in
+            CCryptoBoringSSLShims_ED25519_verify_prepared(message.baseAddress, message.count, signatureBytes, publicKey.baseAddress, prepared.baseAddress) == 1
+        }
+        if data.regions.count == 1 {
+            return data.regions.first!.withUnsafeBytes(verify)
+        }
+        return Array(data).withUnsafeBytes(verify)
+    }
+}
+#endif
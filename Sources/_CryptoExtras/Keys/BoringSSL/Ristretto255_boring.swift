@@ -0,0 +1,310 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+import Crypto
+import Foundation
+
+enum OpenSSLRistretto255Impl {
+    static let pointByteCount = Int(CCryptoBoringSSLShims_RISTRETTO255_POINT_BYTES)
+
+    static let elementByteCount = Int(CCryptoBoringSSLShims_RISTRETTO255_ELEMENT_BYTES)
+
+    static let scalarByteCount = Int(CCryptoBoringSSLShims_RISTRETTO255_SCALAR_BYTES)
+
+    private static func point(_ body: (UnsafeMutableRawPointer) -> Void) -> Data {
+        var point = Data(repeating: 0, count: Self.pointByteCount)
+        point.withUnsafeMutableBytes { body($0.baseAddress!) }
+        return point
+    }
+
+    private static func scalar(_ body: (UnsafeMutableRawPointer) -> Void) -> Data {
+        var scalar = Data(repeating: 0, count: Self.scalarByteCount)
+        scalar.withUnsafeMutableBytes { body($0.baseAddress!) }
+        return scalar
+    }
+
+    // MARK: Elements
+
+    static func decode(_ encoding: Data) throws -> Data {
+        guard encoding.count == Self.elementByteCount else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+        var point = Data(repeating: 0, count: Self.pointByteCount)
+        let rc = point.withUnsafeMutableBytes { point in
+            encoding.withUnsafeBytes { encoding in
+                CCryptoBoringSSLShims_ristretto255_decode(point.baseAddress, encoding.baseAddress)
+            }
+        }
+        guard rc == 1 else {
+            throw CryptoKitError.invalidParameter
+        }
+        return point
+    }
+
+    static func encode(_ point: Data) -> Data {
+        var encoding = Data(repeating: 0, count: Self.elementByteCount)
+        encoding.withUnsafeMutableBytes { encoding in
+            point.withUnsafeBytes { point in
+                CCryptoBoringSSLShims_ristretto255_encode(encoding.baseAddress, point.baseAddress)
+            }
+        }
+        return encoding
+    }
+
+    static func equal(_ lhs: Data, _ rhs: Data) -> Bool {
+        lhs.withUnsafeBytes { lhs in
+            rhs.withUnsafeBytes { rhs in
+                CCryptoBoringSSLShims_ristretto255_equal(lhs.baseAddress, rhs.baseAddress) == 1
+            }
+        }
+    }
+
+    static func identity() -> Data {
+        Self.point { CCryptoBoringSSLShims_ristretto255_identity($0) }
+    }
+
+    static func fromUniformBytes(_ bytes: Data) throws -> Data {
+        guard bytes.count == 64 else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+        return Self.point { point in
+            bytes.withUnsafeBytes { CCryptoBoringSSLShims_ristretto255_from_uniform_bytes(point, $0.baseAddress) }
+        }
+    }
+
+    static func hashToGroup<Message: DataProtocol, DST: DataProtocol>(_ message: Message, domainSeparationTag: DST) throws -> Data {
+        guard domainSeparationTag.count > 0 else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+        let message: ContiguousBytes = message.regions.count == 1 ? message.regions.first! : Array(message)
+        let dst: ContiguousBytes = domainSeparationTag.regions.count == 1 ? domainSeparationTag.regions.first! : Array(domainSeparationTag)
+        var point = Data(repeating: 0, count: Self.pointByteCount)
+        let rc = point.withUnsafeMutableBytes { point in
+            message.withUnsafeBytes { message in
+                dst.withUnsafeBytes { dst in
+                    CCryptoBoringSSLShims_ristretto255_hash_to_group(
+                        point.baseAddress, message.baseAddress, message.count, dst.baseAddress, dst.count
+                    )
+                }
+            }
+        }
+        guard rc == 1 else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+        return point
+    }
+
+    static func add(_ lhs: Data, _ rhs: Data) -> Data {
+        Self.point { point in
+            lhs.withUnsafeBytes { lhs in
+                rhs.withUnsafeBytes { rhs in
+                    CCryptoBoringSSLShims_ristretto255_add(point, lhs.baseAddress, rhs.baseAddress)
+                }
+            }
+        }
+    }
+
+    static func subtract(_ lhs: Data, _ rhs: Data) -> Data {
+        Self.point { point in
+            lhs.withUnsafeBytes { lhs in
+                rhs.withUnsafeBytes { rhs in
+                    CCryptoBoringSSLShims_ristretto255_sub(point, lhs.baseAddress, rhs.baseAddress)
+                }
+            }
+        }
+    }
+
+    static func negate(_ point: Data) -> Data {
+        Self.point { negated in
+            point.withUnsafeBytes { CCryptoBoringSSLShims_ristretto255_neg(negated, $0.baseAddress) }
+        }
+    }
+
+    static func multiplyGenerator(by scalar: Data) -> Data {
+        Self.point { point in
+            scalar.withUnsafeBytes { CCryptoBoringSSLShims_ristretto255_scalarmult_base(point, $0.baseAddress) }
+        }
+    }
+
+    static func multiply(_ point: Data, by scalar: Data) -> Data {
+        Self.point { product in
+            scalar.withUnsafeBytes { scalar in
+                point.withUnsafeBytes { point in
+                    CCryptoBoringSSLShims_ristretto255_scalarmult(product, scalar.baseAddress, point.baseAddress)
+                }
+            }
+        }
+    }
+
+    /// Lays `items` out back to back, so one pointer reaches them all.
+    private static func concatenate(_ items: [Data], itemByteCount: Int) -> [UInt8] {
+        var bytes = [UInt8]()
+        bytes.reserveCapacity(items.count * itemByteCount)
+        for item in items {
+            bytes.append(contentsOf: item)
+        }
+        return bytes
+    }
+
+    private static func split(_ bytes: [UInt8], count: Int) -> [Data] {
+        (0..<count).map { index in
+            Data(bytes[(index * Self.elementByteCount)..<((index + 1) * Self.elementByteCount)])
+        }
+    }
+
+    static func encodeDoubled(_ points: [Data]) -> [Data] {
+        guard !points.isEmpty else {
+            return []
+        }
+        let points = Self.concatenate(points, itemByteCount: Self.pointByteCount)
+        var encodings = [UInt8](repeating: 0, count: (points.count / Self.pointByteCount) * Self.elementByteCount)
+        encodings.withUnsafeMutableBytes { encodings in
+            points.withUnsafeBytes { points in
+                CCryptoBoringSSLShims_ristretto255_encode_doubled_batch(
+                    encodings.baseAddress, points.baseAddress, points.count / Self.pointByteCount
+                )
+            }
+        }
+        return Self.split(encodings, count: points.count / Self.pointByteCount)
+    }
+
+    static func multiplyAndEncode(_ points: [Data], by scalar: Data) -> [Data] {
+        guard !points.isEmpty else {
+            return []
+        }
+        let points = Self.concatenate(points, itemByteCount: Self.pointByteCount)
+        var encodings = [UInt8](repeating: 0, count: (points.count / Self.pointByteCount) * Self.elementByteCount)
+        encodings.withUnsafeMutableBytes { encodings in
+            scalar.withUnsafeBytes { scalar in
+                points.withUnsafeBytes { points in
+                    CCryptoBoringSSLShims_ristretto255_scalarmult_encode_batch(
+                        encodings.baseAddress, scalar.baseAddress, points.baseAddress, points.count / Self.pointByteCount
+                    )
+                }
+            }
+        }
+        return Self.split(encodings, count: points.count / Self.pointByteCount)
+    }
+
+    static func multiplyGeneratorAndEncode(by scalars: [Data]) -> [Data] {
+        guard !scalars.isEmpty else {
+            return []
+        }
+        let scalarBytes = Self.concatenate(scalars, itemByteCount: Self.scalarByteCount)
+        var encodings = [UInt8](repeating: 0, count: scalars.count * Self.elementByteCount)
+        encodings.withUnsafeMutableBytes { encodings in
+            scalarBytes.withUnsafeBytes { scalarBytes in
+                CCryptoBoringSSLShims_ristretto255_scalarmult_base_encode_batch(
+                    encodings.baseAddress, scalarBytes.baseAddress, scalars.count
+                )
+            }
+        }
+        return Self.split(encodings, count: scalars.count)
+    }
+
+    static func multiScalarMultiplication(_ scalars: [Data], _ points: [Data]) throws -> Data {
+        precondition(scalars.count == points.count)
+        let scalarBytes = Self.concatenate(scalars, itemByteCount: Self.scalarByteCount)
+        let pointBytes = Self.concatenate(points, itemByteCount: Self.pointByteCount)
+        var sum = Data(repeating: 0, count: Self.pointByteCount)
+        let rc = sum.withUnsafeMutableBytes { sum in
+            scalarBytes.withUnsafeBytes { scalarBytes in
+                pointBytes.withUnsafeBytes { pointBytes in
+                    CCryptoBoringSSLShims_ristretto255_multi_scalar_mul(
+                        sum.baseAddress, scalarBytes.baseAddress, pointBytes.baseAddress, points.count
+                    )
+                }
+            }
+        }
+        guard rc == 1 else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+        return sum
+    }
+
+    // MARK: Scalars
+
+    static func validateScalar(_ scalar: Data) throws {
+        guard scalar.count == Self.scalarByteCount else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+        let rc = scalar.withUnsafeBytes { CCryptoBoringSSLShims_ristretto255_scalar_is_canonical($0.baseAddress) }
+        guard rc == 1 else {
+            throw CryptoKitError.invalidParameter
+        }
+    }
+
+    static func reduceScalar(_ wide: Data) throws -> Data {
+        guard wide.count == 64 else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+        return Self.scalar { scalar in
+            wide.withUnsafeBytes { CCryptoBoringSSLShims_ristretto255_scalar_reduce(scalar, $0.baseAddress) }
+        }
+    }
+
+    static func randomScalar() -> Data {
+        Self.scalar { scalar in
+            let rc = CCryptoBoringSSLShims_ristretto255_scalar_random(scalar)
+            precondition(rc == 1, "Unable to generate a random scalar")
+        }
+    }
+
+    static func scalarOperation(
+        _ lhs: Data,
+        _ rhs: Data,
+        _ operation: (UnsafeMutableRawPointer?, UnsafeRawPointer?, UnsafeRawPointer?) -> Void
+    ) -> Data {
+        Self.scalar { result in
+            lhs.withUnsafeBytes { lhs in
+                rhs.withUnsafeBytes { rhs in
+                    operation(result, lhs.baseAddress, rhs.baseAddress)
+                }
+            }
+        }
+    }
+
+    static func addScalars(_ lhs: Data, _ rhs: Data) -> Data {
+        Self.scalarOperation(lhs, rhs) { CCryptoBoringSSLShims_ristretto255_scalar_add($0, $1, $2) }
+    }
+
+    static func subtractScalars(_ lhs: Data, _ rhs: Data) -> Data {
+        Self.scalarOperation(lhs, rhs) { CCryptoBoringSSLShims_ristretto255_scalar_sub($0, $1, $2) }
+    }
+
+    static func multiplyScalars(_ lhs: Data, _ rhs: Data) -> Data {
+        Self.scalarOperation(lhs, rhs) { CCryptoBoringSSLShims_ristretto255_scalar_mul($0, $1, $2) }
+    }
+
+    static func negateScalar(_ scalar: Data) -> Data {
+        Self.scalar { negated in
+            scalar.withUnsafeBytes { CCryptoBoringSSLShims_ristretto255_scalar_neg(negated, $0.baseAddress) }
+        }
+    }
+
+    static func invertScalar(_ scalar: Data) -> Data {
+        Self.scalar { inverse in
+            scalar.withUnsafeBytes { CCryptoBoringSSLShims_ristretto255_scalar_invert(inverse, $0.baseAddress) }
+        }
+    }
+
+    static func scalarsAreEqual(_ lhs: Data, _ rhs: Data) -> Bool {
+        lhs.withUnsafeBytes { lhs in
+            rhs.withUnsafeBytes { rhs in
+                CCryptoBoringSSL_CRYPTO_memcmp(lhs.baseAddress, rhs.baseAddress, lhs.count) == 0
+            }
+        }
+    }
+}
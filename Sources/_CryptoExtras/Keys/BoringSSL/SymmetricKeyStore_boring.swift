@@ -0,0 +1,167 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+import Crypto
+@_implementationOnly import CryptoBoringWrapper
+import Foundation
+
+/// The key material of a ``_SymmetricKeyStore``: fixed-size slots packed back to back in page-aligned chunks.
+/// Chunks are never moved or freed while the store is alive, so a slot's address is stable. Every slot is cleared
+/// when its key is removed, and every chunk is cleared again before it is returned to the allocator.
+///
+/// Not synchronised; the store serialises access.
+final class KeyStoreRegion {
+    let slotByteCount: Int
+
+    let slotsPerChunk: Int
+
+    private let chunkByteCount: Int
+
+    private let pageByteCount = Int(getpagesize())
+
+    private var chunks: [UnsafeMutableRawPointer] = []
+
+    init(slotByteCount: Int) {
+        precondition(slotByteCount > 0)
+        self.slotByteCount = slotByteCount
+        // Large enough that a million 32-byte keys take a few hundred chunks, rounded to whole pages.
+        let target = max(64 << 10, slotByteCount)
+        self.chunkByteCount = (target + self.pageByteCount - 1) / self.pageByteCount * self.pageByteCount
+        self.slotsPerChunk = self.chunkByteCount / slotByteCount
+    }
+
+    deinit {
+        for chunk in self.chunks {
+            CCryptoBoringSSL_OPENSSL_cleanse(chunk, self.chunkByteCount)
+            chunk.deallocate()
+        }
+    }
+
+    /// The number of slots allocated.
+    var slotCount: Int {
+        self.chunks.count * self.slotsPerChunk
+    }
+
+    /// The bytes allocated for key material.
+    var byteCount: Int {
+        self.chunks.count * self.chunkByteCount
+    }
+
+    func grow() {
+        let chunk = UnsafeMutableRawPointer.allocate(byteCount: self.chunkByteCount, alignment: self.pageByteCount)
+        chunk.initializeMemory(as: UInt8.self, repeating: 0, count: self.chunkByteCount)
+        self.chunks.append(chunk)
+    }
+
+    func slot(_ index: Int) -> UnsafeMutableRawBufferPointer {
+        let (chunk, offset) = index.quotientAndRemainder(dividingBy: self.slotsPerChunk)
+        return UnsafeMutableRawBufferPointer(start: self.chunks[chunk] + offset * self.slotByteCount, count: self.slotByteCount)
+    }
+
+    func fillRandom(_ index: Int) throws {
+        let slot = self.slot(index)
+        guard CCryptoBoringSSL_RAND_bytes(slot.baseAddress!.assumingMemoryBound(to: UInt8.self), slot.count) == 1 else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+    }
+
+    static func cleanse(_ bytes: UnsafeMutableRawBufferPointer) {
+        CCryptoBoringSSL_OPENSSL_cleanse(bytes.baseAddress, bytes.count)
+    }
+}
+
+/// The operations that take their key from a ``_SymmetricKeyStore``. Each is handed the raw key bytes, which are
+/// only valid for the duration of the call.
+enum OpenSSLKeyStoreImpl {
+    static func seal<Plaintext: DataProtocol, Nonce: ContiguousBytes, AuthenticatedData: DataProtocol>(
+        _ message: Plaintext,
+        algorithm: AEADAlgorithm,
+        key: UnsafeRawBufferPointer,
+        nonce: Nonce,
+        authenticatedData: AuthenticatedData
+    ) throws -> (ciphertext: Data, tag: Data) {
+        let cipher = try BoringSSLAEAD(algorithm, keyBitCount: key.count * 8)
+        do {
+            let context = try BoringSSLAEAD.AEADContext(cipher: cipher, key: key)
+            return try context.seal(message: message, nonce: nonce, authenticatedData: authenticatedData)
+        } catch CryptoBoringWrapperError.underlyingCoreCryptoError(let errorCode) {
+            throw CryptoKitError.underlyingCoreCryptoError(error: errorCode)
+        }
+    }
+
+    static func open<Nonce: ContiguousBytes, AuthenticatedData: DataProtocol>(
+        ciphertext: Data,
+        algorithm: AEADAlgorithm,
+        key: UnsafeRawBufferPointer,
+        nonce: Nonce,
+        tag: Data,
+        authenticatedData: AuthenticatedData
+    ) throws -> Data {
+        let cipher = try BoringSSLAEAD(algorithm, keyBitCount: key.count * 8)
+        do {
+            let context = try BoringSSLAEAD.AEADContext(cipher: cipher, key: key)
+            return try context.open(ciphertext: ciphertext, nonce: nonce, tag: tag, authenticatedData: authenticatedData)
+        } catch CryptoBoringWrapperError.underlyingCoreCryptoError(let errorCode) {
+            throw CryptoKitError.underlyingCoreCryptoError(error: errorCode)
+        }
+    }
+
+    static func authenticationCode<H: HashFunction, Message: DataProtocol>(
+        _: H.Type,
+        for message: Message,
+        key: UnsafeRawBufferPointer,
+        into output: UnsafeMutableRawBufferPointer
+    ) throws {
+        precondition(output.count == H.Digest.byteCount)
+        #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+        try Self.genericAuthenticationCode(H.self, for: message, key: key, into: output)
+        #else
+        guard let digest = try? DigestType(forDigestType: H.Digest.self) else {
+            // BoringSSL only knows the SHA family; anything else takes the generic path.
+            try Self.genericAuthenticationCode(H.self, for: message, key: key, into: output)
+            return
+        }
+
+        let contiguousMessage: ContiguousBytes = message.regions.count == 1 ? message.regions.first! : Array(message)
+        var outputByteCount = CUnsignedInt(0)
+        let result = contiguousMessage.withUnsafeBytes { message in
+            CCryptoBoringSSL_HMAC(
+                digest.dispatchTable,
+                key.baseAddress, key.count,
+                message.baseAddress?.assumingMemoryBound(to: UInt8.self), message.count,
+                output.baseAddress?.assumingMemoryBound(to: UInt8.self), &outputByteCount
+            )
+        }
+        guard result != nil, Int(outputByteCount) == output.count else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+        #endif
+    }
+
+    /// Used where BoringSSL doesn't implement the hash. This does make a short-lived `SymmetricKey`.
+    private static func genericAuthenticationCode<H: HashFunction, Message: DataProtocol>(
+        _: H.Type,
+        for message: Message,
+        key: UnsafeRawBufferPointer,
+        into output: UnsafeMutableRawBufferPointer
+    ) throws {
+        let code = HMAC<H>.authenticationCode(for: message, using: SymmetricKey(data: key))
+        code.withUnsafeBytes { output.copyMemory(from: $0) }
+    }
+
+    static func constantTimeEquals(_ lhs: UnsafeRawBufferPointer, _ rhs: UnsafeRawBufferPointer) -> Bool {
+        lhs.count == rhs.count && CCryptoBoringSSL_CRYPTO_memcmp(lhs.baseAddress, rhs.baseAddress, lhs.count) == 0
+    }
+}
@@ -0,0 +1,324 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+// x || y of each curve, as inline storage with no padding.
+fileprivate typealias P256CompactPoint = (
+    UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64
+)
+
+fileprivate typealias P384CompactPoint = (
+    UInt64, UInt64, UInt64, UInt64, UInt64, UInt64,
+    UInt64, UInt64, UInt64, UInt64, UInt64, UInt64
+)
+
+fileprivate typealias P521CompactPoint = (
+    UInt32, UInt32, UInt32, UInt32, UInt32, UInt32, UInt32, UInt32, UInt32, UInt32, UInt32,
+    UInt32, UInt32, UInt32, UInt32, UInt32, UInt32, UInt32, UInt32, UInt32, UInt32, UInt32,
+    UInt32, UInt32, UInt32, UInt32, UInt32, UInt32, UInt32, UInt32, UInt32, UInt32, UInt32
+)
+
+extension P256.Signing {
+    /// A P-256 public key held as nothing but its coordinates, stored inline, for verifiers that keep very many keys in
+    /// memory.
+    ///
+    /// A ``P256/Signing/PublicKey`` owns a BoringSSL `EC_KEY` and its `EC_POINT`: about 320 bytes on the heap in
+    /// several allocations, plus the object that owns them. A compact key is the 64 bytes of x || y and nothing else,
+    /// so an array of them is one contiguous allocation. Each verification decodes the point onto the stack, which
+    /// costs a fraction of a microsecond next to the tens of microseconds of the verification itself. Points are
+    /// checked to be on the curve when the key is created.
+    ///
+    /// Verification accepts exactly the signatures ``P256/Signing/PublicKey`` accepts.
+    public struct _CompactPublicKey: Hashable, Sendable {
+        fileprivate var bytes: P256CompactPoint = (0, 0, 0, 0, 0, 0, 0, 0)
+
+        /// Creates a compact copy of `publicKey`.
+        public init(_ publicKey: P256.Signing.PublicKey) {
+            // The key was checked when it was created.
+            publicKey.rawRepresentation.withUnsafeBytes {
+                Swift.withUnsafeMutableBytes(of: &self.bytes) { bytes in bytes.copyMemory(from: $0) }
+            }
+        }
+
+        /// Creates a key from its raw representation, x || y.
+        ///
+        /// - Throws: `CryptoKitError.incorrectParameterSize` if the length is wrong, or
+        ///   `CryptoKitError.invalidParameter` if the point is not on the curve.
+        public init<Bytes: ContiguousBytes>(rawRepresentation: Bytes) throws {
+            try rawRepresentation.withUnsafeBytes { raw in
+                try Swift.withUnsafeMutableBytes(of: &self.bytes) { bytes in
+                    try OpenSSLCompactPublicKeyImpl.load(raw, into: bytes, curve: .p256)
+                }
+            }
+        }
+
+        /// Creates a key from its uncompressed X9.63 representation, 0x04 || x || y.
+        ///
+        /// - Throws: `CryptoKitError.incorrectParameterSize` if the length or the leading byte is wrong, or
+        ///   `CryptoKitError.invalidParameter` if the point is not on the curve.
+        public init<Bytes: ContiguousBytes>(x963Representation: Bytes) throws {
+            let rawRepresentation = try x963Representation.withUnsafeBytes { x963 in
+                guard x963.first == 0x04 else {
+                    throw CryptoKitError.incorrectParameterSize
+                }
+                return Data(x963.dropFirst())
+            }
+            try self.init(rawRepresentation: rawRepresentation)
+        }
+
+        /// The raw representation of the key, x || y.
+        public var rawRepresentation: Data {
+            Swift.withUnsafeBytes(of: self.bytes) { Data($0) }
+        }
+
+        /// The uncompressed X9.63 representation of the key, 0x04 || x || y.
+        public var x963Representation: Data {
+            [0x04] + self.rawRepresentation
+        }
+
+        /// The key as a ``P256/Signing/PublicKey``, which builds the BoringSSL structures this type avoids.
+        public var publicKey: P256.Signing.PublicKey {
+            // The point was checked when this key was created.
+            try! P256.Signing.PublicKey(rawRepresentation: self.rawRepresentation)
+        }
+
+        /// Verifies an ECDSA signature over a digest.
+        ///
+        /// - Returns: What ``P256/Signing/PublicKey/isValidSignature(_:for:)`` returns for the same arguments.
+        public func isValidSignature<D: Digest>(_ signature: P256.Signing.ECDSASignature, for digest: D) -> Bool {
+            Swift.withUnsafeBytes(of: self.bytes) { point in
+                digest.withUnsafeBytes { digest in
+                    OpenSSLCompactPublicKeyImpl.isValidSignature(
+                        signature.rawRepresentation,
+                        for: digest,
+                        point: point,
+                        curve: .p256
+                    )
+                }
+            }
+        }
+
+        /// Verifies an ECDSA signature over the SHA-256 digest of `data`.
+        ///
+        /// - Returns: What ``P256/Signing/PublicKey/isValidSignature(_:for:)`` returns for the same arguments.
+        public func isValidSignature<D: DataProtocol>(_ signature: P256.Signing.ECDSASignature, for data: D) -> Bool {
+            self.isValidSignature(signature, for: SHA256.hash(data: data))
+        }
+
+        public static func == (lhs: Self, rhs: Self) -> Bool {
+            Swift.withUnsafeBytes(of: lhs.bytes) { lhs in
+                Swift.withUnsafeBytes(of: rhs.bytes) { rhs in lhs.elementsEqual(rhs) }
+            }
+        }
+
+        public func hash(into hasher: inout Hasher) {
+            Swift.withUnsafeBytes(of: self.bytes) { hasher.combine(bytes: $0) }
+        }
+    }
+}
+
+extension P384.Signing {
+    /// A P-384 public key held as nothing but its coordinates, stored inline.
+    ///
+    /// This works as ``P256/Signing/_CompactPublicKey`` does, for P-384: the key is 96 bytes, against about 320
+    /// for a ``P384/Signing/PublicKey``.
+    public struct _CompactPublicKey: Hashable, Sendable {
+        fileprivate var bytes: P384CompactPoint = (
+            0, 0, 0, 0, 0, 0,
+            0, 0, 0, 0, 0, 0
+        )
+
+        /// Creates a compact copy of `publicKey`.
+        public init(_ publicKey: P384.Signing.PublicKey) {
+            // The key was checked when it was created.
+            publicKey.rawRepresentation.withUnsafeBytes {
+                Swift.withUnsafeMutableBytes(of: &self.bytes) { bytes in bytes.copyMemory(from: $0) }
+            }
+        }
+
+        /// Creates a key from its raw representation, x || y.
+        ///
+        /// - Throws: `CryptoKitError.incorrectParameterSize` if the length is wrong, or
+        ///   `CryptoKitError.invalidParameter` if the point is not on the curve.
+        public init<Bytes: ContiguousBytes>(rawRepresentation: Bytes) throws {
+            try rawRepresentation.withUnsafeBytes { raw in
+                try Swift.withUnsafeMutableBytes(of: &self.bytes) { bytes in
+                    try OpenSSLCompactPublicKeyImpl.load(raw, into: bytes, curve: .p384)
+                }
+            }
+        }
+
+        /// Creates a key from its uncompressed X9.63 representation, 0x04 || x || y.
+        ///
+        /// - Throws: `CryptoKitError.incorrectParameterSize` if the length or the leading byte is wrong, or
+        ///   `CryptoKitError.invalidParameter` if the point is not on the curve.
+        public init<Bytes: ContiguousBytes>(x963Representation: Bytes) throws {
+            let rawRepresentation = try x963Representation.withUnsafeBytes { x963 in
+                guard x963.first == 0x04 else {
+                    throw CryptoKitError.incorrectParameterSize
+                }
+                return Data(x963.dropFirst())
+            }
+            try self.init(rawRepresentation: rawRepresentation)
+        }
+
+        /// The raw representation of the key, x || y.
+        public var rawRepresentation: Data {
+            Swift.withUnsafeBytes(of: self.bytes) { Data($0) }
+        }
+
+        /// The uncompressed X9.63 representation of the key, 0x04 || x || y.
+        public var x963Representation: Data {
+            [0x04] + self.rawRepresentation
+        }
+
+        /// The key as a ``P384/Signing/PublicKey``, which builds the BoringSSL structures this type avoids.
+        public var publicKey: P384.Signing.PublicKey {
+            // The point was checked when this key was created.
+            try! P384.Signing.PublicKey(rawRepresentation: self.rawRepresentation)
+        }
+
+        /// Verifies an ECDSA signature over a digest.
+        ///
+        /// - Returns: What ``P384/Signing/PublicKey/isValidSignature(_:for:)`` returns for the same arguments.
+        public func isValidSignature<D: Digest>(_ signature: P384.Signing.ECDSASignature, for digest: D) -> Bool {
+            Swift.withUnsafeBytes(of: self.bytes) { point in
+                digest.withUnsafeBytes { digest in
+                    OpenSSLCompactPublicKeyImpl.isValidSignature(
+                        signature.rawRepresentation,
+                        for: digest,
+                        point: point,
+                        curve: .p384
+                    )
+                }
+            }
+        }
+
+        /// Verifies an ECDSA signature over the SHA-384 digest of `data`.
+        ///
+        /// - Returns: What ``P384/Signing/PublicKey/isValidSignature(_:for:)`` returns for the same arguments.
+        public func isValidSignature<D: DataProtocol>(_ signature: P384.Signing.ECDSASignature, for data: D) -> Bool {
+            self.isValidSignature(signature, for: SHA384.hash(data: data))
+        }
+
+        public static func == (lhs: Self, rhs: Self) -> Bool {
+            Swift.withUnsafeBytes(of: lhs.bytes) { lhs in
+                Swift.withUnsafeBytes(of: rhs.bytes) { rhs in lhs.elementsEqual(rhs) }
+            }
+        }
+
+        public func hash(into hasher: inout Hasher) {
+            Swift.withUnsafeBytes(of: self.bytes) { hasher.combine(bytes: $0) }
+        }
+    }
+}
+
+extension P521.Signing {
+    /// A P-521 public key held as nothing but its coordinates, stored inline.
+    ///
+    /// This works as ``P256/Signing/_CompactPublicKey`` does, for P-521: the key is 132 bytes, against about 320
+    /// for a ``P521/Signing/PublicKey``.
+    public struct _CompactPublicKey: Hashable, Sendable {
+        fileprivate var bytes: P521CompactPoint = (
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+        )
+
+        /// Creates a compact copy of `publicKey`.
+        public init(_ publicKey: P521.Signing.PublicKey) {
+            // The key was checked when it was created.
+            publicKey.rawRepresentation.withUnsafeBytes {
+                Swift.withUnsafeMutableBytes(of: &self.bytes) { bytes in bytes.copyMemory(from: $0) }
+            }
+        }
+
+        /// Creates a key from its raw representation, x || y.
+        ///
+        /// - Throws: `CryptoKitError.incorrectParameterSize` if the length is wrong, or
+        ///   `CryptoKitError.invalidParameter` if the point is not on the curve.
+        public init<Bytes: ContiguousBytes>(rawRepresentation: Bytes) throws {
+            try rawRepresentation.withUnsafeBytes { raw in
+                try Swift.withUnsafeMutableBytes(of: &self.bytes) { bytes in
+                    try OpenSSLCompactPublicKeyImpl.load(raw, into: bytes, curve: .p521)
+                }
+            }
+        }
+
+        /// Creates a key from its uncompressed X9.63 representation, 0x04 || x || y.
+        ///
+        /// - Throws: `CryptoKitError.incorrectParameterSize` if the length or the leading byte is wrong, or
+        ///   `CryptoKitError.invalidParameter` if the point is not on the curve.
+        public init<Bytes: ContiguousBytes>(x963Representation: Bytes) throws {
+            let rawRepresentation = try x963Representation.withUnsafeBytes { x963 in
+                guard x963.first == 0x04 else {
+                    throw CryptoKitError.incorrectParameterSize
+                }
+                return Data(x963.dropFirst())
+            }
+            try self.init(rawRepresentation: rawRepresentation)
+        }
+
+        /// The raw representation of the key, x || y.
+        public var rawRepresentation: Data {
+            Swift.withUnsafeBytes(of: self.bytes) { Data($0) }
+        }
+
+        /// The uncompressed X9.63 representation of the key, 0x04 || x || y.
+        public var x963Representation: Data {
+            [0x04] + self.rawRepresentation
+        }
+
+        /// The key as a ``P521/Signing/PublicKey``, which builds the BoringSSL structures this type avoids.
+        public var publicKey: P521.Signing.PublicKey {
+            // The point was checked when this key was created.
+            try! P521.Signing.PublicKey(rawRepresentation: self.rawRepresentation)
+        }
+
+        /// Verifies an ECDSA signature over a digest.
+        ///
+        /// - Returns: What ``P521/Signing/PublicKey/isValidSignature(_:for:)`` returns for the same arguments.
+        public func isValidSignature<D: Digest>(_ signature: P521.Signing.ECDSASignature, for digest: D) -> Bool {
+            Swift.withUnsafeBytes(of: self.bytes) { point in
+                digest.withUnsafeBytes { digest in
+                    OpenSSLCompactPublicKeyImpl.isValidSignature(
+                        signature.rawRepresentation,
+                        for: digest,
+                        point: point,
+                        curve: .p521
+                    )
+                }
+            }
+        }
+
+        /// Verifies an ECDSA signature over the SHA-512 digest of `data`.
+        ///
+        /// - Returns: What ``P521/Signing/PublicKey/isValidSignature(_:for:)`` returns for the same arguments.
+        public func isValidSignature<D: DataProtocol>(_ signature: P521.Signing.ECDSASignature, for data: D) -> Bool {
+            self.isValidSignature(signature, for: SHA512.hash(data: data))
+        }
+
+        public static func == (lhs: Self, rhs: Self) -> Bool {
+            Swift.withUnsafeBytes(of: lhs.bytes) { lhs in
+                Swift.withUnsafeBytes(of: rhs.bytes) { rhs in lhs.elementsEqual(rhs) }
+            }
+        }
+
+        public func hash(into hasher: inout Hasher) {
+            Swift.withUnsafeBytes(of: self.bytes) { hasher.combine(bytes: $0) }
+        }
+    }
+}
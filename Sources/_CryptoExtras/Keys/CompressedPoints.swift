@@ -0,0 +1,54 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+
+extension P256 {
+    /// Decompresses a batch of compressed public keys, writing them back to back into a caller-provided buffer.
+    ///
+    /// Each input is a 33-byte compressed X9.62 point: 0x02 or 0x03, followed by the x coordinate. Each output is
+    /// the matching 65-byte uncompressed (X9.63) point. The square roots are computed with fixed-width field
+    /// arithmetic, so the batch does no per-key allocation. The results can be passed to
+    /// ``P256/KeyAgreement/_sharedSecret(privateKey:peerPublicKey:into:)`` or to `init(x963Representation:)`.
+    ///
+    /// - Parameters:
+    ///   - compressedKeys: The compressed public keys, back to back.
+    ///   - output: The buffer to write the uncompressed public keys into. It must hold exactly one uncompressed
+    ///     key per compressed key.
+    /// - Throws: `CryptoKitError.incorrectParameterSize` if the buffers don't hold a whole number of keys or
+    ///     don't match, or `CryptoKitError.underlyingCoreCryptoError` if any key is invalid.
+    public static func _decompressPublicKeys(_ compressedKeys: UnsafeRawBufferPointer, into output: UnsafeMutableRawBufferPointer) throws {
+        try OpenSSLCompressedPointsImpl.decompress(compressedKeys, into: output, curve: .p256)
+    }
+}
+
+extension P384 {
+    /// Decompresses a batch of compressed public keys, writing them back to back into a caller-provided buffer.
+    ///
+    /// This works as ``P256/_decompressPublicKeys(_:into:)`` does, for P-384: each input is 49 bytes and
+    /// each output 97 bytes.
+    public static func _decompressPublicKeys(_ compressedKeys: UnsafeRawBufferPointer, into output: UnsafeMutableRawBufferPointer) throws {
+        try OpenSSLCompressedPointsImpl.decompress(compressedKeys, into: output, curve: .p384)
+    }
+}
+
+extension P521 {
+    /// Decompresses a batch of compressed public keys, writing them back to back into a caller-provided buffer.
+    ///
+    /// This works as ``P256/_decompressPublicKeys(_:into:)`` does, for P-521: each input is 67 bytes and
+    /// each output 133 bytes.
+    public static func _decompressPublicKeys(_ compressedKeys: UnsafeRawBufferPointer, into output: UnsafeMutableRawBufferPointer) throws {
+        try OpenSSLCompressedPointsImpl.decompress(compressedKeys, into: output, curve: .p521)
+    }
+}
@@ -0,0 +1,79 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+
+extension P256 {
+    /// Hashes a message to a point on P-256, using the RFC 9380 suite `P256_XMD:SHA-256_SSWU_RO_`.
+    ///
+    /// This is the hash-to-group operation of protocols such as OPRFs. The result is uniformly distributed on the
+    /// curve, and nobody knows its discrete logarithm. The computation is constant-time in the message.
+    ///
+    /// - Parameters:
+    ///   - message: The message to hash.
+    ///   - domainSeparationTag: The domain separation tag of the protocol, which must not be empty.
+    /// - Returns: The point, as a public key.
+    /// - Throws: `CryptoKitError.incorrectParameterSize` if the domain separation tag is empty.
+    public static func _hashToCurve<Message: DataProtocol, DST: DataProtocol>(
+        _ message: Message,
+        domainSeparationTag: DST
+    ) throws -> P256.KeyAgreement.PublicKey {
+        let point = try OpenSSLHashToCurveImpl.hash(message, domainSeparationTag: domainSeparationTag, curve: .p256)
+        return try P256.KeyAgreement.PublicKey(x963Representation: point)
+    }
+
+    /// Hashes a batch of messages to points on P-256, writing them back to back into a caller-provided buffer.
+    ///
+    /// Each output is the 65-byte uncompressed (X9.63) point that ``_hashToCurve(_:domainSeparationTag:)`` returns
+    /// for that message. The points share their conversions to affine coordinates, which makes a batch cheaper per
+    /// message than hashing one at a time.
+    ///
+    /// - Parameters:
+    ///   - messages: The messages to hash.
+    ///   - domainSeparationTag: The domain separation tag of the protocol, which must not be empty.
+    ///   - output: The buffer to write the points into. It must hold exactly one point per message.
+    /// - Throws: `CryptoKitError.incorrectParameterSize` if the domain separation tag is empty or the buffer is the
+    ///     wrong size.
+    public static func _hashToCurve<Message: DataProtocol, DST: DataProtocol>(
+        _ messages: [Message],
+        domainSeparationTag: DST,
+        into output: UnsafeMutableRawBufferPointer
+    ) throws {
+        try OpenSSLHashToCurveImpl.hash(messages, domainSeparationTag: domainSeparationTag, into: output, curve: .p256)
+    }
+}
+
+extension P384 {
+    /// Hashes a message to a point on P-384, using the RFC 9380 suite `P384_XMD:SHA-384_SSWU_RO_`.
+    ///
+    /// This works as ``P256/_hashToCurve(_:domainSeparationTag:)`` does, for P-384.
+    public static func _hashToCurve<Message: DataProtocol, DST: DataProtocol>(
+        _ message: Message,
+        domainSeparationTag: DST
+    ) throws -> P384.KeyAgreement.PublicKey {
+        let point = try OpenSSLHashToCurveImpl.hash(message, domainSeparationTag: domainSeparationTag, curve: .p384)
+        return try P384.KeyAgreement.PublicKey(x963Representation: point)
+    }
+
+    /// Hashes a batch of messages to points on P-384, writing them back to back into a caller-provided buffer.
+    ///
+    /// This works as ``P256/_hashToCurve(_:domainSeparationTag:into:)`` does, for P-384: each output is 97 bytes.
+    public static func _hashToCurve<Message: DataProtocol, DST: DataProtocol>(
+        _ messages: [Message],
+        domainSeparationTag: DST,
+        into output: UnsafeMutableRawBufferPointer
+    ) throws {
+        try OpenSSLHashToCurveImpl.hash(messages, domainSeparationTag: domainSeparationTag, into: output, curve: .p384)
+    }
+}
@@ -0,0 +1,58 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+
+extension P256 {
+    /// Computes the sum of a batch of scalar multiples of points, Σ scalars[i] · points[i].
+    ///
+    /// This uses Pippenger's bucket method, which for thousands of terms costs a small fraction of multiplying each
+    /// point separately. It runs in variable time, so it must only be used with public scalars, such as in the
+    /// verification of commitments and zero-knowledge proofs.
+    ///
+    /// - Parameters:
+    ///   - scalars: The scalars, back to back, each a 32-byte big-endian integer less than the group order.
+    ///   - points: The points, back to back, each a 65-byte uncompressed (X9.63) point.
+    ///   - maximumThreadCount: The number of threads to spread the work over, including the calling one. Sums of
+    ///     fewer than a few hundred terms always use only the calling thread.
+    /// - Returns: The sum, or `nil` if it is the point at infinity. An empty batch sums to the point at infinity.
+    /// - Throws: `CryptoKitError.incorrectParameterSize` if the buffers don't hold a whole number of scalars and
+    ///     points, or don't hold as many of each, or `CryptoKitError.underlyingCoreCryptoError` if any scalar or
+    ///     point is invalid.
+    public static func _multiScalarMultiplication(
+        scalars: UnsafeRawBufferPointer,
+        points: UnsafeRawBufferPointer,
+        maximumThreadCount: Int = 1
+    ) throws -> P256.KeyAgreement.PublicKey? {
+        try OpenSSLMultiScalarMultiplicationImpl.sum(
+            scalars: scalars, points: points, maximumThreadCount: maximumThreadCount, curve: .p256
+        ).map { try P256.KeyAgreement.PublicKey(x963Representation: $0) }
+    }
+}
+
+extension P384 {
+    /// Computes the sum of a batch of scalar multiples of points, Σ scalars[i] · points[i].
+    ///
+    /// This works as ``P256/_multiScalarMultiplication(scalars:points:maximumThreadCount:)`` does, for P-384: each
+    /// scalar is 48 bytes and each point 97 bytes.
+    public static func _multiScalarMultiplication(
+        scalars: UnsafeRawBufferPointer,
+        points: UnsafeRawBufferPointer,
+        maximumThreadCount: Int = 1
+    ) throws -> P384.KeyAgreement.PublicKey? {
+        try OpenSSLMultiScalarMultiplicationImpl.sum(
+            scalars: scalars, points: points, maximumThreadCount: maximumThreadCount, curve: .p384
+        ).map { try P384.KeyAgreement.PublicKey(x963Representation: $0) }
+    }
+}
@@ -0,0 +1,381 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+/// A file of public keys stored together with the state that verifying with them would otherwise build first, which
+/// can be mapped into memory and used in place.
+///
+/// Parsing tens of thousands of keys from PEM or DER and then warming each one takes time at every process start. A
+/// store is written once, with ``serializedRepresentation(of:)``, and opened with
+/// ``init(contentsOf:verifyingIntegrity:)``, which maps the file rather than reading it. Opening does no per-key work
+/// beyond checking each entry's bounds, so keys are usable immediately, and processes on one host that open the same
+/// file share its pages.
+///
+/// For each kind of key the store holds:
+///
+/// - Ed25519: the 32-byte key, and the table of multiples of its decoded point that every verification otherwise
+///   rebuilds. ``isValidEd25519Signature(_:for:keyIdentifier:)`` verifies with the table straight from the file.
+/// - RSA: the SPKI DER, and R^2 mod n, the constant whose computation dominates setting up the key's Montgomery
+///   context. Keys come out of the store with that context already in place.
+/// - P-256: the uncompressed point. BoringSSL keeps no per-key state for P-256 verification, so there is nothing to
+///   prepare.
+///
+/// ## Format
+///
+/// All integers are little-endian, and every offset is from the start of the file, so the layout is
+/// position-independent. The file starts with a 32-byte header: the magic `SCPKSTOR`, a 16-bit version, the 16-bit
+/// layout of the Ed25519 tables, the 32-bit number of entries, the 64-bit length of the file and 8 reserved bytes. A
+/// table of 32-byte entries follows, sorted by the UTF-8 bytes of their identifiers, so that a key is found by binary
+/// search without building an index. Each entry holds the kind of key, the offset and length of its identifier, and
+/// the offset and length of its key, followed at the next 16-byte boundary by its prepared state. The file ends with
+/// the SHA-256 digest of everything before it.
+///
+/// Prepared state depends on the platform: Ed25519 tables on the field arithmetic, and RSA constants on the word
+/// size. State that doesn't match the platform opening the store is ignored, and computed as it would be for any
+/// other key.
+///
+/// - Important: The store is as trusted as the keys in it. Its digest detects corruption, not tampering: anyone who
+///   can modify the file can replace the keys too.
+public struct _PreparedPublicKeyStore: Sendable {
+    /// A public key held in a store.
+    public enum Key: Sendable {
+        case ed25519(Curve25519.Signing.PublicKey)
+        case p256(P256.Signing.PublicKey)
+        case rsa(_RSA.Signing.PublicKey)
+    }
+
+    private let bytes: Data
+
+    /// The number of keys in the store.
+    public let count: Int
+
+    private let ed25519Layout: UInt16
+
+    /// Serializes `keys` as a store, with the prepared state for each.
+    ///
+    /// - Parameter keys: The keys, each with an identifier to look it up by. Identifiers must be unique.
+    /// - Returns: The store, to be written to a file.
+    /// - Throws: `CryptoKitError.invalidParameter` if two keys have the same identifier or an Ed25519 key is invalid.
+    public static func serializedRepresentation<Keys: Sequence>(of keys: Keys) throws -> Data where Keys.Element == (identifier: String, key: Key) {
+        var entries = keys.map { (identifier: Array($0.identifier.utf8), key: $0.key) }
+        entries.sort { $0.identifier.lexicographicallyPrecedes($1.identifier) }
+        for index in entries.indices.dropFirst() where entries[index - 1].identifier == entries[index].identifier {
+            throw CryptoKitError.invalidParameter
+        }
+
+        let ed25519Layout = OpenSSLPreparedPublicKeyImpl.ed25519Layout
+        var header = Data()
+        header.append(contentsOf: Self.magic)
+        header.appendLittleEndian(Self.version)
+        header.appendLittleEndian(ed25519Layout)
+        header.appendLittleEndian(UInt32(entries.count))
+
+        var table = Data()
+        var blobs = Data()
+        let blobsStart = Self.headerByteCount + entries.count * Self.entryByteCount
+        func appendBlob(_ blob: Data) -> Int {
+            blobs.append(contentsOf: repeatElement(0, count: Self.paddingToAlignment(blobsStart + blobs.count)))
+            let offset = blobsStart + blobs.count
+            blobs.append(blob)
+            return offset
+        }
+
+        for entry in entries {
+            let kind: Kind
+            let key: Data
+            var prepared = Data()
+            switch entry.key {
+            case .ed25519(let publicKey):
+                kind = .ed25519
+                key = publicKey.rawRepresentation
+                if ed25519Layout != 0 {
+                    guard let table = OpenSSLPreparedPublicKeyImpl.prepareEd25519(key) else {
+                        throw CryptoKitError.invalidParameter
+                    }
+                    prepared = table
+                }
+            case .p256(let publicKey):
+                kind = .p256
+                key = publicKey.x963Representation
+            case .rsa(let publicKey):
+                kind = .rsa
+                key = publicKey.derRepresentation
+                if let (rr, rBits) = publicKey.montgomeryRR {
+                    prepared.appendLittleEndian(rBits)
+                    prepared.appendLittleEndian(UInt32(0))
+                    prepared.append(rr)
+                }
+            }
+
+            let identifierOffset = appendBlob(Data(entry.identifier))
+            let keyOffset = appendBlob(key)
+            if !prepared.isEmpty {
+                _ = appendBlob(prepared)
+            }
+            table.append(kind.rawValue)
+            table.append(contentsOf: [0, 0, 0])
+            table.appendLittleEndian(UInt32(entry.identifier.count))
+            table.appendLittleEndian(UInt64(identifierOffset))
+            table.appendLittleEndian(UInt64(keyOffset))
+            table.appendLittleEndian(UInt32(key.count))
+            table.appendLittleEndian(UInt32(prepared.count))
+        }
+
+        let totalByteCount = blobsStart + blobs.count + SHA256.byteCount
+        header.appendLittleEndian(UInt64(totalByteCount))
+        header.appendLittleEndian(UInt64(0))
+
+        var result = header + table + blobs
+        result.append(contentsOf: SHA256.hash(data: result))
+        assert(result.count == totalByteCount)
+        return result
+    }
+
+    /// Opens a store by mapping the file at `url` into memory.
+    ///
+    /// - Parameters:
+    ///   - url: The location of the store.
+    ///   - verifyingIntegrity: Whether to check the store's digest, which reads the whole file. The layout is checked
+    ///     either way.
+    /// - Throws: `CryptoKitError.invalidParameter` if the file is not a valid store, or the error reading it.
+    public init(contentsOf url: URL, verifyingIntegrity: Bool = true) throws {
+        try self.init(serializedRepresentation: Data(contentsOf: url, options: .alwaysMapped), verifyingIntegrity: verifyingIntegrity)
+    }
+
+    /// Opens a store that is already in memory, without copying it.
+    ///
+    /// - Parameters:
+    ///   - serializedRepresentation: The store, as ``serializedRepresentation(of:)`` returned it.
+    ///   - verifyingIntegrity: Whether to check the store's digest. The layout is checked either way.
+    /// - Throws: `CryptoKitError.invalidParameter` if `serializedRepresentation` is not a valid store.
+    public init(serializedRepresentation: Data, verifyingIntegrity: Bool = true) throws {
+        self.bytes = serializedRepresentation
+        (self.count, self.ed25519Layout) = try serializedRepresentation.withUnsafeBytes { bytes in
+            try Self.validate(bytes, verifyingIntegrity: verifyingIntegrity)
+        }
+    }
+
+    /// The identifiers of the keys in the store, in the order of their UTF-8 bytes.
+    public var identifiers: [String] {
+        self.bytes.withUnsafeBytes { bytes in
+            (0..<self.count).compactMap { index in
+                Entry(bytes, index: index).map { String(decoding: $0.identifier(in: bytes), as: UTF8.self) }
+            }
+        }
+    }
+
+    /// The key with the given identifier, or `nil` if the store has none.
+    ///
+    /// An RSA key comes with its Montgomery context set up, where the store has one for this platform.
+    public subscript(identifier: String) -> Key? {
+        self.bytes.withUnsafeBytes { bytes in
+            guard let entry = self.entry(identifier, in: bytes) else {
+                return nil
+            }
+            let key = entry.key(in: bytes)
+            // The keys were valid when the store was written, and its layout has been checked since.
+            switch entry.kind {
+            case .ed25519:
+                return (try? Curve25519.Signing.PublicKey(rawRepresentation: key)).map { .ed25519($0) }
+            case .p256:
+                return (try? P256.Signing.PublicKey(x963Representation: key)).map { .p256($0) }
+            case .rsa:
+                guard let publicKey = try? _RSA.Signing.PublicKey(unsafeDERRepresentation: key) else {
+                    return nil
+                }
+                let prepared = entry.prepared(in: bytes)
+                if prepared.count > 8 {
+                    publicKey.setMontgomeryRR(UnsafeRawBufferPointer(rebasing: prepared[(prepared.startIndex + 8)...]), rBits: prepared.loadLittleEndian(fromByteOffset: 0, as: UInt32.self))
+                }
+                return .rsa(publicKey)
+            }
+        }
+    }
+
+    /// Verifies an EdDSA signature over Curve25519 with a key in the store, using its prepared table in place.
+    ///
+    /// - Parameters:
+    ///   - signature: The signature to verify.
+    ///   - data: The signed data.
+    ///   - keyIdentifier: The identifier of the Ed25519 key to verify with.
+    /// - Returns: What ``Curve25519/Signing/PublicKey/isValidSignature(_:for:)`` returns for the same key, or `false`
+    ///   if the store has no Ed25519 key with that identifier.
+    public func isValidEd25519Signature<S: DataProtocol, D: DataProtocol>(_ signature: S, for data: D, keyIdentifier: String) -> Bool {
+        self.bytes.withUnsafeBytes { bytes in
+            guard let entry = self.entry(keyIdentifier, in: bytes), entry.kind == .ed25519 else {
+                return false
+            }
+            let key = entry.key(in: bytes)
+            let prepared = entry.prepared(in: bytes)
+            guard self.ed25519Layout == OpenSSLPreparedPublicKeyImpl.ed25519Layout, !prepared.isEmpty else {
+                guard let publicKey = try? Curve25519.Signing.PublicKey(rawRepresentation: key) else {
+                    return false
+                }
+                return publicKey.isValidSignature(signature, for: data)
+            }
+            return OpenSSLPreparedPublicKeyImpl.isValidEd25519Signature(signature, for: data, publicKey: key, prepared: prepared)
+        }
+    }
+
+    private func entry(_ identifier: String, in bytes: UnsafeRawBufferPointer) -> Entry? {
+        var identifier = identifier
+        return identifier.withUTF8 { identifier in
+            var low = 0
+            var high = self.count
+            while low < high {
+                let middle = low + (high - low) / 2
+                guard let entry = Entry(bytes, index: middle) else {
+                    return nil
+                }
+                let candidate = entry.identifier(in: bytes)
+                if candidate.elementsEqual(identifier) {
+                    return entry
+                } else if candidate.lexicographicallyPrecedes(identifier) {
+                    low = middle + 1
+                } else {
+                    high = middle
+                }
+            }
+            return nil
+        }
+    }
+}
+
+extension _PreparedPublicKeyStore {
+    private static let magic = Array("SCPKSTOR".utf8)
+
+    private static let version = UInt16(1)
+
+    private static let headerByteCount = 32
+
+    private static let entryByteCount = 32
+
+    private static let ed25519PreparedByteCount = 1280
+
+    private enum Kind: UInt8 {
+        case ed25519 = 1
+        case p256 = 2
+        case rsa = 3
+    }
+
+    private static func paddingToAlignment(_ offset: Int) -> Int {
+        (16 - offset % 16) % 16
+    }
+
+    /// An entry in the table.
+    private struct Entry {
+        var kind: Kind
+        var identifierRange: Range<Int>
+        var keyRange: Range<Int>
+        var preparedRange: Range<Int>
+
+        /// Reads an entry for a lookup. The whole table was checked when the store was opened, but a mapped file can
+        /// still change underneath it, so every entry is checked again as it is read.
+        init?(_ bytes: UnsafeRawBufferPointer, index: Int) {
+            guard let entry = try? Entry(validating: bytes, index: index) else {
+                return nil
+            }
+            self = entry
+        }
+
+        init(validating bytes: UnsafeRawBufferPointer, index: Int) throws {
+            let base = _PreparedPublicKeyStore.headerByteCount + index * _PreparedPublicKeyStore.entryByteCount
+            let entry = UnsafeRawBufferPointer(rebasing: bytes[base..<(base + _PreparedPublicKeyStore.entryByteCount)])
+            guard let kind = Kind(rawValue: entry[0]) else {
+                throw CryptoKitError.invalidParameter
+            }
+            self.kind = kind
+
+            // Everything must lie between the table and the trailing digest.
+            let limit = bytes.count - SHA256.byteCount
+            func range(offset: UInt64, count: UInt32) throws -> Range<Int> {
+                guard offset <= UInt64(limit), UInt64(count) <= UInt64(limit) - offset else {
+                    throw CryptoKitError.invalidParameter
+                }
+                return Int(offset)..<(Int(offset) + Int(count))
+            }
+            self.identifierRange = try range(offset: entry.loadLittleEndian(fromByteOffset: 8, as: UInt64.self), count: entry.loadLittleEndian(fromByteOffset: 4, as: UInt32.self))
+            self.keyRange = try range(offset: entry.loadLittleEndian(fromByteOffset: 16, as: UInt64.self), count: entry.loadLittleEndian(fromByteOffset: 24, as: UInt32.self))
+            let preparedOffset = self.keyRange.upperBound + _PreparedPublicKeyStore.paddingToAlignment(self.keyRange.upperBound)
+            self.preparedRange = try range(offset: UInt64(preparedOffset), count: entry.loadLittleEndian(fromByteOffset: 28, as: UInt32.self))
+
+            if self.kind == .ed25519 {
+                guard self.keyRange.count == 32, self.preparedRange.isEmpty || self.preparedRange.count == _PreparedPublicKeyStore.ed25519PreparedByteCount else {
+                    throw CryptoKitError.invalidParameter
+                }
+            }
+        }
+
+        func identifier(in bytes: UnsafeRawBufferPointer) -> UnsafeRawBufferPointer {
+            UnsafeRawBufferPointer(rebasing: bytes[self.identifierRange])
+        }
+
+        func key(in bytes: UnsafeRawBufferPointer) -> UnsafeRawBufferPointer {
+            UnsafeRawBufferPointer(rebasing: bytes[self.keyRange])
+        }
+
+        func prepared(in bytes: UnsafeRawBufferPointer) -> UnsafeRawBufferPointer {
+            UnsafeRawBufferPointer(rebasing: bytes[self.preparedRange])
+        }
+    }
+
+    /// Checks the header, every entry, the order of the identifiers and optionally the digest, and returns the number
+    /// of entries and the layout of the Ed25519 tables.
+    private static func validate(_ bytes: UnsafeRawBufferPointer, verifyingIntegrity: Bool) throws -> (Int, UInt16) {
+        guard bytes.count >= Self.headerByteCount + SHA256.byteCount,
+              bytes.prefix(Self.magic.count).elementsEqual(Self.magic),
+              bytes.loadLittleEndian(fromByteOffset: 8, as: UInt16.self) == Self.version,
+              bytes.loadLittleEndian(fromByteOffset: 16, as: UInt64.self) == UInt64(bytes.count) else {
+            throw CryptoKitError.invalidParameter
+        }
+        let ed25519Layout = bytes.loadLittleEndian(fromByteOffset: 10, as: UInt16.self)
+        let count = Int(bytes.loadLittleEndian(fromByteOffset: 12, as: UInt32.self))
+        guard count <= (bytes.count - Self.headerByteCount - SHA256.byteCount) / Self.entryByteCount else {
+            throw CryptoKitError.invalidParameter
+        }
+
+        if verifyingIntegrity {
+            let contents = UnsafeRawBufferPointer(rebasing: bytes.dropLast(SHA256.byteCount))
+            guard SHA256.hash(bufferPointer: contents).elementsEqual(bytes.suffix(SHA256.byteCount)) else {
+                throw CryptoKitError.invalidParameter
+            }
+        }
+
+        var previous: Entry?
+        for index in 0..<count {
+            let entry = try Entry(validating: bytes, index: index)
+            if let previous = previous {
+                guard previous.identifier(in: bytes).lexicographicallyPrecedes(entry.identifier(in: bytes)) else {
+                    throw CryptoKitError.invalidParameter
+                }
+            }
+            previous = entry
+        }
+        return (count, ed25519Layout)
+    }
+}
+
+extension UnsafeRawBufferPointer {
+    fileprivate func loadLittleEndian<T: FixedWidthInteger>(fromByteOffset offset: Int, as type: T.Type) -> T {
+        T(littleEndian: self.loadUnaligned(fromByteOffset: offset, as: T.self))
+    }
+}
+
+extension Data {
+    fileprivate mutating func appendLittleEndian<T: FixedWidthInteger>(_ value: T) {
+        Swift.withUnsafeBytes(of: value.littleEndian) { self.append(contentsOf: $0) }
+    }
+}
@@ -0,0 +1,229 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+
+/// The ristretto255 prime-order group of RFC 9496, built on Curve25519.
+///
+/// Ristretto255 gives protocols such as OPRFs, PAKEs and anonymous credentials a group of prime order
+/// 2^252 + 27742317777372353535851937790883648493 with canonical 32-byte encodings, so they need not handle
+/// Curve25519's cofactor themselves.
+///
+/// Besides single operations, the group offers batched ones for servers that handle many elements at a time:
+/// encoding many products shares one field inversion between all of them, and
+/// ``Element/multiScalarMultiplication(_:_:)`` sums many products at a fraction of the cost of computing each.
+public enum _Ristretto255 {}
+
+extension _Ristretto255 {
+    /// An integer modulo the order of the group.
+    public struct Scalar: Sendable, Equatable {
+        // 32 bytes, little-endian, fully reduced.
+        var backing: Data
+
+        fileprivate init(backing: Data) {
+            self.backing = backing
+        }
+
+        /// Creates a random scalar.
+        public init() {
+            self.backing = OpenSSLRistretto255Impl.randomScalar()
+        }
+
+        /// Creates a scalar from its canonical encoding.
+        ///
+        /// - Parameter rawRepresentation: A 32-byte little-endian integer less than the group order.
+        /// - Throws: `CryptoKitError.incorrectParameterSize` if the encoding isn't 32 bytes long, or
+        ///     `CryptoKitError.invalidParameter` if it isn't less than the group order.
+        public init<D: DataProtocol>(rawRepresentation: D) throws {
+            let backing = Data(rawRepresentation)
+            try OpenSSLRistretto255Impl.validateScalar(backing)
+            self.backing = backing
+        }
+
+        /// Creates a scalar by reducing a 64-byte little-endian integer modulo the group order.
+        ///
+        /// Reducing 64 uniformly random bytes, such as the output of a hash, gives a uniformly random scalar.
+        ///
+        /// - Throws: `CryptoKitError.incorrectParameterSize` if `wideRepresentation` isn't 64 bytes long.
+        public init<D: DataProtocol>(reducing wideRepresentation: D) throws {
+            self.backing = try OpenSSLRistretto255Impl.reduceScalar(Data(wideRepresentation))
+        }
+
+        /// The canonical encoding of the scalar: 32 bytes, little-endian.
+        public var rawRepresentation: Data {
+            self.backing
+        }
+
+        /// The multiplicative inverse of the scalar, or zero if the scalar is zero.
+        public var inverse: Scalar {
+            Scalar(backing: OpenSSLRistretto255Impl.invertScalar(self.backing))
+        }
+
+        public static func + (lhs: Scalar, rhs: Scalar) -> Scalar {
+            Scalar(backing: OpenSSLRistretto255Impl.addScalars(lhs.backing, rhs.backing))
+        }
+
+        public static func - (lhs: Scalar, rhs: Scalar) -> Scalar {
+            Scalar(backing: OpenSSLRistretto255Impl.subtractScalars(lhs.backing, rhs.backing))
+        }
+
+        public static func * (lhs: Scalar, rhs: Scalar) -> Scalar {
+            Scalar(backing: OpenSSLRistretto255Impl.multiplyScalars(lhs.backing, rhs.backing))
+        }
+
+        public static prefix func - (scalar: Scalar) -> Scalar {
+            Scalar(backing: OpenSSLRistretto255Impl.negateScalar(scalar.backing))
+        }
+
+        /// Compares two scalars in constant time.
+        public static func == (lhs: Scalar, rhs: Scalar) -> Bool {
+            OpenSSLRistretto255Impl.scalarsAreEqual(lhs.backing, rhs.backing)
+        }
+    }
+}
+
+extension _Ristretto255 {
+    /// An element of the group.
+    public struct Element: Sendable, Hashable {
+        // An extended Edwards point, in BoringSSL's internal representation.
+        var point: Data
+
+        fileprivate init(point: Data) {
+            self.point = point
+        }
+
+        /// Creates an element from its canonical 32-byte encoding.
+        ///
+        /// - Throws: `CryptoKitError.incorrectParameterSize` if the encoding isn't 32 bytes long, or
+        ///     `CryptoKitError.invalidParameter` if it isn't the canonical encoding of an element.
+        public init<D: DataProtocol>(rawRepresentation: D) throws {
+            self.point = try OpenSSLRistretto255Impl.decode(Data(rawRepresentation))
+        }
+
+        /// Maps 64 uniformly random bytes to an element, with the one-way map of RFC 9496.
+        ///
+        /// - Throws: `CryptoKitError.incorrectParameterSize` if `uniformBytes` isn't 64 bytes long.
+        public init<D: DataProtocol>(uniformBytes: D) throws {
+            self.point = try OpenSSLRistretto255Impl.fromUniformBytes(Data(uniformBytes))
+        }
+
+        /// Hashes a message to an element, as the `hash_to_group` of RFC 9497 does, with `expand_message_xmd` over
+        /// SHA-512.
+        ///
+        /// - Throws: `CryptoKitError.incorrectParameterSize` if `domainSeparationTag` is empty.
+        public init<Message: DataProtocol, DST: DataProtocol>(
+            hashing message: Message,
+            domainSeparationTag: DST
+        ) throws {
+            self.point = try OpenSSLRistretto255Impl.hashToGroup(message, domainSeparationTag: domainSeparationTag)
+        }
+
+        /// Creates the product of the group's generator and `scalar`.
+        ///
+        /// This uses a table of multiples of the generator, so it runs much faster than `generator.multiplied(by:)`.
+        public init(generatorMultipliedBy scalar: Scalar) {
+            self.point = OpenSSLRistretto255Impl.multiplyGenerator(by: scalar.backing)
+        }
+
+        /// The generator of the group.
+        public static let generator = Element(point: OpenSSLRistretto255Impl.multiplyGenerator(
+            by: Data([1] + [UInt8](repeating: 0, count: 31))
+        ))
+
+        /// The identity element of the group.
+        public static let identity = Element(point: OpenSSLRistretto255Impl.identity())
+
+        /// The canonical 32-byte encoding of the element.
+        public var rawRepresentation: Data {
+            OpenSSLRistretto255Impl.encode(self.point)
+        }
+
+        /// Returns the product of this element and `scalar`, computed in constant time.
+        public func multiplied(by scalar: Scalar) -> Element {
+            Element(point: OpenSSLRistretto255Impl.multiply(self.point, by: scalar.backing))
+        }
+
+        public static func + (lhs: Element, rhs: Element) -> Element {
+            Element(point: OpenSSLRistretto255Impl.add(lhs.point, rhs.point))
+        }
+
+        public static func - (lhs: Element, rhs: Element) -> Element {
+            Element(point: OpenSSLRistretto255Impl.subtract(lhs.point, rhs.point))
+        }
+
+        public static prefix func - (element: Element) -> Element {
+            Element(point: OpenSSLRistretto255Impl.negate(element.point))
+        }
+
+        /// Compares two elements in constant time, without encoding them.
+        public static func == (lhs: Element, rhs: Element) -> Bool {
+            OpenSSLRistretto255Impl.equal(lhs.point, rhs.point)
+        }
+
+        public func hash(into hasher: inout Hasher) {
+            hasher.combine(self.rawRepresentation)
+        }
+    }
+}
+
+extension _Ristretto255.Element {
+    /// Returns the encodings of twice each of `elements`.
+    ///
+    /// An element's encoding needs an inverse square root, which can't be shared between elements, but the encoding
+    /// of a doubled element needs only an inversion, which can. Encoding a batch this way costs a fraction of
+    /// encoding each element.
+    public static func doubledRawRepresentations(of elements: [_Ristretto255.Element]) -> [Data] {
+        OpenSSLRistretto255Impl.encodeDoubled(elements.map(\.point))
+    }
+
+    /// Returns the encodings of the products of each of `elements` and `scalar`.
+    ///
+    /// This gives the same results as encoding `element.multiplied(by: scalar)` for each element, but shares the
+    /// final inversion of the encodings between the whole batch, as ``doubledRawRepresentations(of:)`` does. It
+    /// suits an OPRF server evaluating many blinded elements under one key.
+    public static func rawRepresentations(
+        of elements: [_Ristretto255.Element],
+        multipliedBy scalar: _Ristretto255.Scalar
+    ) -> [Data] {
+        OpenSSLRistretto255Impl.multiplyAndEncode(elements.map(\.point), by: scalar.backing)
+    }
+
+    /// Returns the encodings of the products of the group's generator and each of `scalars`.
+    ///
+    /// This gives the same results as encoding `Element(generatorMultipliedBy: scalar)` for each scalar, but shares
+    /// the final inversion of the encodings between the whole batch, as ``doubledRawRepresentations(of:)`` does.
+    public static func rawRepresentations(ofGeneratorMultipliedBy scalars: [_Ristretto255.Scalar]) -> [Data] {
+        OpenSSLRistretto255Impl.multiplyGeneratorAndEncode(by: scalars.map(\.backing))
+    }
+
+    /// Computes the sum of a batch of scalar multiples of elements, Σ scalars[i] · elements[i].
+    ///
+    /// This uses Pippenger's bucket method, which for hundreds of terms costs a small fraction of multiplying each
+    /// element separately. It runs in variable time, so it must only be used with public scalars, such as in the
+    /// verification of zero-knowledge proofs.
+    ///
+    /// - Returns: The sum. An empty batch sums to the identity.
+    /// - Throws: `CryptoKitError.incorrectParameterSize` if there aren't as many scalars as elements.
+    public static func multiScalarMultiplication(
+        _ scalars: [_Ristretto255.Scalar],
+        _ elements: [_Ristretto255.Element]
+    ) throws -> _Ristretto255.Element {
+        guard scalars.count == elements.count else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+        return _Ristretto255.Element(point: try OpenSSLRistretto255Impl.multiScalarMultiplication(
+            scalars.map(\.backing), elements.map(\.point)
+        ))
+    }
+}
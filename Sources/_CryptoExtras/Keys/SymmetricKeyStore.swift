@@ -0,0 +1,377 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+
+/// A store for very many symmetric keys of one size, kept together in a single region of memory.
+///
+/// Each `SymmetricKey` is its own heap object, with a header, a reference count and an allocation of its own.
+/// A store instead packs the raw key bytes back to back in page-aligned chunks, and keeps the bookkeeping for every
+/// key in separate arrays alongside. A key is named by a ``Handle``, a plain 64-bit value that costs nothing to copy
+/// and involves no reference counting.
+///
+/// The AES-GCM, ChaCha20-Poly1305, HMAC and HKDF operations in this module that take a handle read the key straight
+/// from the store: it is copied to a stack buffer for the duration of the call and cleared afterwards, and no
+/// `SymmetricKey` is created. A key's bytes are cleared as soon as it's removed, and the whole region is cleared
+/// again when the store is released.
+///
+/// Stores are internally synchronised and may be shared freely between threads. The lock is held only long enough
+/// to copy a key, not while data is processed.
+public final class _SymmetricKeyStore: @unchecked Sendable {
+    /// Names one key in a ``_SymmetricKeyStore``.
+    ///
+    /// A handle stays valid until its key is removed. Using it after that throws, even if its slot has since been
+    /// given to another key.
+    public struct Handle: Hashable, Sendable {
+        fileprivate var index: UInt32
+
+        fileprivate var generation: UInt32
+    }
+
+    private let region: KeyStoreRegion
+
+    private let lock = NSLock()
+
+    // Protected by `lock`. One entry per slot. A slot holds a key when its generation is odd, and every insertion
+    // and removal bumps the generation, so a handle from before a removal no longer matches.
+    private var generations: [UInt32] = []
+
+    // Protected by `lock`. Empty slots, reused most recently freed first.
+    private var freeSlots: [UInt32] = []
+
+    // Protected by `lock`.
+    private var liveCount = 0
+
+    /// Creates an empty store.
+    ///
+    /// - Parameters:
+    ///   - keySize: The size of every key in the store. At most 512 bits.
+    ///   - minimumCapacity: The number of keys to allocate room for up front.
+    public init(keySize: SymmetricKeySize, minimumCapacity: Int = 0) {
+        precondition(keySize.bitCount > 0 && keySize.bitCount <= 512 && keySize.bitCount % 8 == 0, "Invalid key size \(keySize.bitCount)")
+        precondition(minimumCapacity >= 0)
+        self.region = KeyStoreRegion(slotByteCount: keySize.bitCount / 8)
+        while self.region.slotCount < minimumCapacity {
+            self.growLocked()
+        }
+    }
+
+    /// The size of every key in the store.
+    public var keySize: SymmetricKeySize {
+        SymmetricKeySize(bitCount: self.region.slotByteCount * 8)
+    }
+
+    /// The number of keys in the store.
+    public var count: Int {
+        self.lock.lock()
+        defer {
+            self.lock.unlock()
+        }
+        return self.liveCount
+    }
+
+    /// The bytes allocated for key material, including room for keys not yet added.
+    public var keyMaterialByteCount: Int {
+        self.lock.lock()
+        defer {
+            self.lock.unlock()
+        }
+        return self.region.byteCount
+    }
+
+    /// Adds a copy of `key` to the store.
+    ///
+    /// - Throws: `CryptoKitError.incorrectKeySize` if `key` isn't ``keySize``.
+    public func insert(_ key: SymmetricKey) throws -> Handle {
+        try key.withUnsafeBytes { try self.insert(bytes: $0) }
+    }
+
+    /// Adds a key to the store, copying its bytes from `bytes`.
+    ///
+    /// - Throws: `CryptoKitError.incorrectKeySize` if `bytes` isn't ``keySize``.
+    public func insert<Bytes: ContiguousBytes>(bytes: Bytes) throws -> Handle {
+        try bytes.withUnsafeBytes { bytes in
+            guard bytes.count == self.region.slotByteCount else {
+                throw CryptoKitError.incorrectKeySize
+            }
+            return self.insert { self.region.slot($0).copyMemory(from: bytes) }
+        }
+    }
+
+    /// Generates a random key directly into the store.
+    public func insertRandomKey() throws -> Handle {
+        try self.insert { try self.region.fillRandom($0) }
+    }
+
+    /// Removes a key from the store and clears its bytes.
+    ///
+    /// - Returns: `false` if the key had already been removed.
+    @discardableResult
+    public func remove(_ handle: Handle) -> Bool {
+        self.lock.lock()
+        defer {
+            self.lock.unlock()
+        }
+        guard self.isLiveLocked(handle) else {
+            return false
+        }
+        let index = Int(handle.index)
+        KeyStoreRegion.cleanse(self.region.slot(index))
+        self.generations[index] &+= 1
+        self.freeSlots.append(handle.index)
+        self.liveCount -= 1
+        return true
+    }
+
+    /// Whether the key named by `handle` is still in the store.
+    public func contains(_ handle: Handle) -> Bool {
+        self.lock.lock()
+        defer {
+            self.lock.unlock()
+        }
+        return self.isLiveLocked(handle)
+    }
+
+    /// Calls `body` with a copy of the key's bytes, which is cleared when `body` returns.
+    ///
+    /// - Throws: `CryptoKitError.invalidParameter` if the key has been removed.
+    func withUnsafeKeyBytes<Result>(_ handle: Handle, _ body: (UnsafeRawBufferPointer) throws -> Result) throws -> Result {
+        try withUnsafeTemporaryAllocation(byteCount: self.region.slotByteCount, alignment: 16) { scratch in
+            defer {
+                KeyStoreRegion.cleanse(scratch)
+            }
+
+            self.lock.lock()
+            guard self.isLiveLocked(handle) else {
+                self.lock.unlock()
+                throw CryptoKitError.invalidParameter
+            }
+            scratch.copyMemory(from: UnsafeRawBufferPointer(self.region.slot(Int(handle.index))))
+            self.lock.unlock()
+
+            return try body(UnsafeRawBufferPointer(scratch))
+        }
+    }
+
+    /// Claims a slot and calls `fill` with its index to write the key, all under the lock.
+    private func insert(_ fill: (Int) throws -> Void) rethrows -> Handle {
+        self.lock.lock()
+        defer {
+            self.lock.unlock()
+        }
+        if self.freeSlots.isEmpty {
+            self.growLocked()
+        }
+        let index = self.freeSlots.last!
+        do {
+            try fill(Int(index))
+        } catch {
+            KeyStoreRegion.cleanse(self.region.slot(Int(index)))
+            throw error
+        }
+        self.freeSlots.removeLast()
+        self.generations[Int(index)] &+= 1
+        self.liveCount += 1
+        return Handle(index: index, generation: self.generations[Int(index)])
+    }
+
+    private func isLiveLocked(_ handle: Handle) -> Bool {
+        let index = Int(handle.index)
+        return index < self.generations.count && self.generations[index] == handle.generation && handle.generation & 1 == 1
+    }
+
+    private func growLocked() {
+        let first = self.region.slotCount
+        self.region.grow()
+        precondition(self.region.slotCount <= Int(UInt32.max), "Too many keys")
+        self.generations.append(contentsOf: repeatElement(0, count: self.region.slotCount - first))
+        // Reversed so that slots are handed out in address order.
+        self.freeSlots.append(contentsOf: (first..<self.region.slotCount).reversed().map { UInt32($0) })
+    }
+}
+
+extension AES.GCM {
+    /// Encrypts and authenticates data using a key held in a ``_SymmetricKeyStore``.
+    ///
+    /// - Parameters:
+    ///   - message: The message to encrypt and authenticate
+    ///   - key: The handle of a 128, 192, or 256-bit key
+    ///   - store: The store holding the key
+    ///   - nonce: The nonce to use. It must be unique for every use of the key to seal data. If `nil`, a random nonce is generated.
+    ///   - authenticatedData: Data to authenticate as part of the seal
+    /// - Returns: A sealed box returning the authentication tag (seal) and the ciphertext
+    /// - Throws: `CryptoKitError.invalidParameter` if the key has been removed from `store`.
+    public static func _seal<Plaintext: DataProtocol, AuthenticatedData: DataProtocol>(
+        _ message: Plaintext,
+        using key: _SymmetricKeyStore.Handle,
+        in store: _SymmetricKeyStore,
+        nonce: AES.GCM.Nonce? = nil,
+        authenticating authenticatedData: AuthenticatedData
+    ) throws -> AES.GCM.SealedBox {
+        let nonce = nonce ?? AES.GCM.Nonce()
+        let (ciphertext, tag) = try store.withUnsafeKeyBytes(key) { key in
+            try OpenSSLKeyStoreImpl.seal(message, algorithm: .aesGCM, key: key, nonce: nonce, authenticatedData: authenticatedData)
+        }
+        return try AES.GCM.SealedBox(nonce: nonce, ciphertext: ciphertext, tag: tag)
+    }
+
+    /// Decrypts the message and verifies its authenticity using a key held in a ``_SymmetricKeyStore``.
+    ///
+    /// - Parameters:
+    ///   - sealedBox: The sealed box to open
+    ///   - key: The handle of the key used to seal
+    ///   - store: The store holding the key
+    ///   - authenticatedData: Data that was authenticated as part of the seal
+    /// - Returns: The ciphertext if opening was successful
+    public static func _open<AuthenticatedData: DataProtocol>(
+        _ sealedBox: AES.GCM.SealedBox,
+        using key: _SymmetricKeyStore.Handle,
+        in store: _SymmetricKeyStore,
+        authenticating authenticatedData: AuthenticatedData
+    ) throws -> Data {
+        try store.withUnsafeKeyBytes(key) { key in
+            try OpenSSLKeyStoreImpl.open(
+                ciphertext: sealedBox.ciphertext, algorithm: .aesGCM, key: key, nonce: sealedBox.nonce,
+                tag: sealedBox.tag, authenticatedData: authenticatedData
+            )
+        }
+    }
+}
+
+extension ChaChaPoly {
+    /// Encrypts and authenticates data using a key held in a ``_SymmetricKeyStore``.
+    ///
+    /// - Parameters:
+    ///   - message: The message to encrypt and authenticate
+    ///   - key: The handle of a 256-bit key
+    ///   - store: The store holding the key
+    ///   - nonce: The nonce to use. It must be unique for every use of the key to seal data. If `nil`, a random nonce is generated.
+    ///   - authenticatedData: Data to authenticate as part of the seal
+    /// - Returns: A sealed box returning the authentication tag (seal) and the ciphertext
+    /// - Throws: `CryptoKitError.invalidParameter` if the key has been removed from `store`.
+    public static func _seal<Plaintext: DataProtocol, AuthenticatedData: DataProtocol>(
+        _ message: Plaintext,
+        using key: _SymmetricKeyStore.Handle,
+        in store: _SymmetricKeyStore,
+        nonce: ChaChaPoly.Nonce? = nil,
+        authenticating authenticatedData: AuthenticatedData
+    ) throws -> ChaChaPoly.SealedBox {
+        let nonce = nonce ?? ChaChaPoly.Nonce()
+        let (ciphertext, tag) = try store.withUnsafeKeyBytes(key) { key in
+            try OpenSSLKeyStoreImpl.seal(message, algorithm: .chaChaPoly, key: key, nonce: nonce, authenticatedData: authenticatedData)
+        }
+        return try ChaChaPoly.SealedBox(nonce: nonce, ciphertext: ciphertext, tag: tag)
+    }
+
+    /// Decrypts the message and verifies its authenticity using a key held in a ``_SymmetricKeyStore``.
+    ///
+    /// - Parameters:
+    ///   - sealedBox: The sealed box to open
+    ///   - key: The handle of the key used to seal
+    ///   - store: The store holding the key
+    ///   - authenticatedData: Data that was authenticated as part of the seal
+    /// - Returns: The ciphertext if opening was successful
+    public static func _open<AuthenticatedData: DataProtocol>(
+        _ sealedBox: ChaChaPoly.SealedBox,
+        using key: _SymmetricKeyStore.Handle,
+        in store: _SymmetricKeyStore,
+        authenticating authenticatedData: AuthenticatedData
+    ) throws -> Data {
+        try store.withUnsafeKeyBytes(key) { key in
+            try OpenSSLKeyStoreImpl.open(
+                ciphertext: sealedBox.ciphertext, algorithm: .chaChaPoly, key: key, nonce: sealedBox.nonce,
+                tag: sealedBox.tag, authenticatedData: authenticatedData
+            )
+        }
+    }
+}
+
+extension HMAC {
+    /// Computes a message authentication code using a key held in a ``_SymmetricKeyStore``.
+    ///
+    /// - Parameters:
+    ///   - message: The data to authenticate.
+    ///   - key: The handle of the key.
+    ///   - store: The store holding the key.
+    ///   - output: The buffer to write the code into. Must be exactly `H.Digest.byteCount` bytes.
+    /// - Throws: `CryptoKitError.incorrectParameterSize` if `output` has the wrong size, and
+    ///   `CryptoKitError.invalidParameter` if the key has been removed from `store`.
+    public static func _authenticationCode<Message: DataProtocol>(
+        for message: Message,
+        using key: _SymmetricKeyStore.Handle,
+        in store: _SymmetricKeyStore,
+        into output: UnsafeMutableRawBufferPointer
+    ) throws {
+        guard output.count == H.Digest.byteCount else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+        try store.withUnsafeKeyBytes(key) { key in
+            try OpenSSLKeyStoreImpl.authenticationCode(H.self, for: message, key: key, into: output)
+        }
+    }
+
+    /// Checks a message authentication code using a key held in a ``_SymmetricKeyStore``. The comparison takes
+    /// the same time whatever the code's contents.
+    ///
+    /// - Parameters:
+    ///   - authenticationCode: The code to check.
+    ///   - message: The data the code authenticates.
+    ///   - key: The handle of the key.
+    ///   - store: The store holding the key.
+    /// - Returns: Whether the code is valid.
+    /// - Throws: `CryptoKitError.invalidParameter` if the key has been removed from `store`.
+    public static func _isValidAuthenticationCode<Code: ContiguousBytes, Message: DataProtocol>(
+        _ authenticationCode: Code,
+        authenticating message: Message,
+        using key: _SymmetricKeyStore.Handle,
+        in store: _SymmetricKeyStore
+    ) throws -> Bool {
+        try withUnsafeTemporaryAllocation(byteCount: H.Digest.byteCount, alignment: 1) { expected in
+            try Self._authenticationCode(for: message, using: key, in: store, into: expected)
+            return authenticationCode.withUnsafeBytes { code in
+                OpenSSLKeyStoreImpl.constantTimeEquals(code, UnsafeRawBufferPointer(expected))
+            }
+        }
+    }
+}
+
+extension HKDF {
+    /// Derives key material into a caller-provided buffer, using a key held in a ``_SymmetricKeyStore`` as the
+    /// input key material.
+    ///
+    /// The output is identical to ``HKDF/_deriveKey(inputKeyMaterial:salt:info:into:)`` with the same key.
+    ///
+    /// - Parameters:
+    ///   - inputKeyMaterial: The handle of the main key.
+    ///   - store: The store holding the key.
+    ///   - salt: The salt to use for key derivation.
+    ///   - info: The shared information to use for key derivation.
+    ///   - output: The buffer to fill with derived key material.
+    /// - Throws: `CryptoKitError.incorrectParameterSize` if `output` is longer than 255 times the digest size, and
+    ///   `CryptoKitError.invalidParameter` if the key has been removed from `store`.
+    public static func _deriveKey<Salt: DataProtocol, Info: DataProtocol>(
+        inputKeyMaterial: _SymmetricKeyStore.Handle,
+        in store: _SymmetricKeyStore,
+        salt: Salt,
+        info: Info,
+        into output: UnsafeMutableRawBufferPointer
+    ) throws {
+        guard output.count <= 255 * H.Digest.byteCount else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+        try store.withUnsafeKeyBytes(inputKeyMaterial) { secret in
+            try OpenSSLHKDFImpl<H>.deriveKey(inputKeyMaterial: secret, salt: salt, info: info, into: output)
+        }
+    }
+}
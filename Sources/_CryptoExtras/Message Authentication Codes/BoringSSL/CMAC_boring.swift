@@ -0,0 +1,83 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+import Crypto
+import Foundation
+
+/// An AES-CMAC key schedule and its K1 and K2 subkeys, derived once. The key is only read after creation, so it
+/// may be used from several threads at once.
+final class OpenSSLCMACKey {
+    let key: UnsafeMutablePointer<CCryptoBoringSSLShims_CMAC_KEY>
+
+    init(_ key: SymmetricKey) throws {
+        guard [128, 192, 256].contains(key.bitCount) else {
+            throw CryptoKitError.incorrectKeySize
+        }
+        self.key = .allocate(capacity: 1)
+        let rc = key.withUnsafeBytes { keyPtr in
+            CCryptoBoringSSLShims_CMAC_KEY_init(self.key, keyPtr.baseAddress?.assumingMemoryBound(to: UInt8.self), keyPtr.count)
+        }
+        precondition(rc == 1)
+    }
+
+    deinit {
+        CCryptoBoringSSL_OPENSSL_cleanse(self.key, MemoryLayout<CCryptoBoringSSLShims_CMAC_KEY>.size)
+        self.key.deallocate()
+    }
+}
+
+/// The state of an AES-CMAC computation. The context holds no pointers, so copying the struct forks the
+/// computation; the key is shared.
+struct OpenSSLCMACImpl {
+    private var context: CCryptoBoringSSLShims_CMAC_CTX
+
+    private let key: OpenSSLCMACKey
+
+    init(key: OpenSSLCMACKey) {
+        self.key = key
+        self.context = CCryptoBoringSSLShims_CMAC_CTX()
+        CCryptoBoringSSLShims_CMAC_init(&self.context)
+    }
+
+    mutating func update(_ bytes: UnsafeRawBufferPointer) {
+        CCryptoBoringSSLShims_CMAC_update(&self.context, self.key.key, bytes.baseAddress, bytes.count)
+    }
+
+    mutating func update<D: DataProtocol>(data: D) {
+        for region in data.regions {
+            region.withUnsafeBytes { self.update($0) }
+        }
+    }
+
+    /// Returns the 16-byte tag without disturbing this state.
+    func finalized() -> Data {
+        var copy = self.context
+        var output = Data(repeating: 0, count: 16)
+        output.withUnsafeMutableBytes { outputPtr in
+            CCryptoBoringSSLShims_CMAC_final(&copy, self.key.key, outputPtr.baseAddress!.assumingMemoryBound(to: UInt8.self))
+        }
+        return output
+    }
+
+    /// Compares `code` against the tag in constant time.
+    func isValid(_ code: UnsafeRawBufferPointer) -> Bool {
+        let computed = self.finalized()
+        guard code.count == computed.count else {
+            return false
+        }
+        return computed.withUnsafeBytes { CCryptoBoringSSL_CRYPTO_memcmp($0.baseAddress, code.baseAddress, $0.count) == 0 }
+    }
+}
@@ -0,0 +1,131 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+import Crypto
+import Foundation
+
+/// A GMAC or POLYVAL key, with the table of powers of H that the GHASH kernels use computed once. The table is
+/// only read after creation, so one key may be used from several threads at once.
+final class OpenSSLGHASHKey {
+    let key: OpaquePointer
+
+    init(gmacKey: SymmetricKey) throws {
+        guard [128, 192, 256].contains(gmacKey.bitCount) else {
+            throw CryptoKitError.incorrectKeySize
+        }
+        let key = gmacKey.withUnsafeBytes { keyPtr in
+            CCryptoBoringSSLShims_GMAC_KEY_new(keyPtr.baseAddress?.assumingMemoryBound(to: UInt8.self), keyPtr.count)
+        }
+        guard let key = key else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+        self.key = key
+    }
+
+    init(polyvalKey: SymmetricKey) throws {
+        guard polyvalKey.bitCount == 128 else {
+            throw CryptoKitError.incorrectKeySize
+        }
+        let key = polyvalKey.withUnsafeBytes { keyPtr in
+            CCryptoBoringSSLShims_POLYVAL_KEY_new(keyPtr.baseAddress?.assumingMemoryBound(to: UInt8.self))
+        }
+        guard let key = key else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+        self.key = key
+    }
+
+    deinit {
+        CCryptoBoringSSLShims_GHASH_KEY_free(self.key)
+    }
+}
+
+/// The state of a GMAC or POLYVAL computation. The context holds no pointers, so copying the struct forks the
+/// computation; the key is shared.
+struct OpenSSLGHASHImpl {
+    enum Function {
+        case gmac
+        case polyval
+    }
+
+    private var context: CCryptoBoringSSLShims_GHASH_CTX
+
+    private let key: OpenSSLGHASHKey
+
+    private let function: Function
+
+    init<Nonce: ContiguousBytes>(gmacKey key: OpenSSLGHASHKey, nonce: Nonce) {
+        self.key = key
+        self.function = .gmac
+        self.context = CCryptoBoringSSLShims_GHASH_CTX()
+        let rc = nonce.withUnsafeBytes { noncePtr in
+            CCryptoBoringSSLShims_GMAC_init(
+                &self.context, key.key, noncePtr.baseAddress?.assumingMemoryBound(to: UInt8.self), noncePtr.count
+            )
+        }
+        // Nonces are never empty, which is the only way this fails.
+        precondition(rc == 1)
+    }
+
+    init(polyvalKey key: OpenSSLGHASHKey) {
+        self.key = key
+        self.function = .polyval
+        self.context = CCryptoBoringSSLShims_GHASH_CTX()
+        CCryptoBoringSSLShims_POLYVAL_init(&self.context)
+    }
+
+    mutating func update(_ bytes: UnsafeRawBufferPointer) {
+        let rc: CInt
+        switch self.function {
+        case .gmac:
+            rc = CCryptoBoringSSLShims_GMAC_update(&self.context, self.key.key, bytes.baseAddress, bytes.count)
+        case .polyval:
+            rc = CCryptoBoringSSLShims_POLYVAL_update(&self.context, self.key.key, bytes.baseAddress, bytes.count)
+        }
+        precondition(rc == 1, "GMAC and POLYVAL inputs are limited to 2^61 bytes")
+    }
+
+    mutating func update<D: DataProtocol>(data: D) {
+        for region in data.regions {
+            region.withUnsafeBytes { self.update($0) }
+        }
+    }
+
+    /// Returns the 16-byte result without disturbing this state.
+    func finalized() -> Data {
+        var copy = self.context
+        var output = Data(repeating: 0, count: 16)
+        output.withUnsafeMutableBytes { outputPtr in
+            let out = outputPtr.baseAddress!.assumingMemoryBound(to: UInt8.self)
+            switch self.function {
+            case .gmac:
+                CCryptoBoringSSLShims_GMAC_final(&copy, self.key.key, out)
+            case .polyval:
+                CCryptoBoringSSLShims_POLYVAL_final(&copy, self.key.key, out)
+            }
+        }
+        return output
+    }
+
+    /// Compares `code` against the result in constant time.
+    func isValid(_ code: UnsafeRawBufferPointer) -> Bool {
+        let computed = self.finalized()
+        guard code.count == computed.count else {
+            return false
+        }
+        return computed.withUnsafeBytes { CCryptoBoringSSL_CRYPTO_memcmp($0.baseAddress, code.baseAddress, $0.count) == 0 }
+    }
+}
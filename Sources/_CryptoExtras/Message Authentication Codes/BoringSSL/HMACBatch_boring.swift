@@ -0,0 +1,83 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+import Crypto
+import Foundation
+
+enum OpenSSLHMACBatchImpl {
+    static func authenticationCodes(batch messages: [UnsafeRawBufferPointer], using key: SymmetricKey, into macs: UnsafeMutableRawBufferPointer) throws {
+        precondition(macs.count == messages.count * SHA256.byteCount)
+
+        try key.withUnsafeBytes { keyBytes in
+            let ops = messages.enumerated().map { index, message in
+                CCryptoBoringSSLShims_HMAC_batch_op(
+                    key: keyBytes.baseAddress,
+                    key_len: keyBytes.count,
+                    in: message.baseAddress,
+                    in_len: message.count,
+                    out: macs.baseAddress! + (index * SHA256.byteCount)
+                )
+            }
+            try Self.run(ops)
+        }
+    }
+
+    static func authenticationCodes(batch messages: [UnsafeRawBufferPointer], using keys: [SymmetricKey], into macs: UnsafeMutableRawBufferPointer) throws {
+        precondition(keys.count == messages.count)
+        precondition(macs.count == messages.count * SHA256.byteCount)
+
+        // The keys are gathered into one scratch buffer so that their bytes stay valid for the
+        // whole call. A key equal to its predecessor reuses the predecessor's range, which lets
+        // the shim skip re-keying.
+        var keyRanges = [Range<Int>]()
+        keyRanges.reserveCapacity(keys.count)
+        var keyStorage = [UInt8]()
+        for (index, key) in keys.enumerated() {
+            if index > 0, key == keys[index - 1] {
+                keyRanges.append(keyRanges[index - 1])
+            } else {
+                let start = keyStorage.count
+                key.withUnsafeBytes { keyStorage.append(contentsOf: $0) }
+                keyRanges.append(start..<keyStorage.count)
+            }
+        }
+        defer {
+            keyStorage.withUnsafeMutableBytes { CCryptoBoringSSL_OPENSSL_cleanse($0.baseAddress, $0.count) }
+        }
+
+        try keyStorage.withUnsafeBytes { keyStorage in
+            let ops = messages.enumerated().map { index, message in
+                CCryptoBoringSSLShims_HMAC_batch_op(
+                    key: keyStorage.baseAddress.map { $0 + keyRanges[index].lowerBound },
+                    key_len: keyRanges[index].count,
+                    in: message.baseAddress,
+                    in_len: message.count,
+                    out: macs.baseAddress! + (index * SHA256.byteCount)
+                )
+            }
+            try Self.run(ops)
+        }
+    }
+
+    private static func run(_ ops: [CCryptoBoringSSLShims_HMAC_batch_op]) throws {
+        let rc = ops.withUnsafeBufferPointer { opsPointer in
+            CCryptoBoringSSLShims_HMAC_SHA256_batch(opsPointer.baseAddress, opsPointer.count)
+        }
+        guard rc == 1 else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+    }
+}
@@ -0,0 +1,67 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+import Crypto
+import Foundation
+
+struct OpenSSLSipHash24Impl: Sendable {
+    /// The key as the two little-endian words `SIPHASH_24` takes.
+    private let key: (UInt64, UInt64)
+
+    init(key: SymmetricKey) {
+        precondition(key.bitCount == 128)
+        self.key = key.withUnsafeBytes { bytes in
+            (
+                UInt64(littleEndian: bytes.loadUnaligned(fromByteOffset: 0, as: UInt64.self)),
+                UInt64(littleEndian: bytes.loadUnaligned(fromByteOffset: 8, as: UInt64.self))
+            )
+        }
+    }
+
+    func hash(_ input: UnsafeRawBufferPointer) -> UInt64 {
+        return self.withKey { key in
+            CCryptoBoringSSL_SIPHASH_24(key, input.baseAddress?.assumingMemoryBound(to: UInt8.self), input.count)
+        }
+    }
+
+    func hashes(batch inputs: [UnsafeRawBufferPointer]) -> [UInt64] {
+        let pointers = inputs.map { $0.baseAddress?.assumingMemoryBound(to: UInt8.self) }
+        let lengths = inputs.map { $0.count }
+        return [UInt64](unsafeUninitializedCapacity: inputs.count) { output, initializedCount in
+            self.withKey { key in
+                pointers.withUnsafeBufferPointer { pointers in
+                    lengths.withUnsafeBufferPointer { lengths in
+                        CCryptoBoringSSLShims_SIPHASH_24_batch(
+                            key,
+                            pointers.baseAddress,
+                            lengths.baseAddress,
+                            inputs.count,
+                            output.baseAddress
+                        )
+                    }
+                }
+            }
+            initializedCount = inputs.count
+        }
+    }
+
+    private func withKey<R>(_ body: (UnsafePointer<UInt64>) -> R) -> R {
+        var key = self.key
+        return Swift.withUnsafePointer(to: &key) {
+            $0.withMemoryRebound(to: UInt64.self, capacity: 2, body)
+        }
+    }
+}
@@ -0,0 +1,87 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+/// AES-CMAC, the block cipher-based message authentication code of NIST SP 800-38B and RFC 4493.
+///
+/// A ``PreparedKey`` expands the AES key and derives the K1 and K2 subkeys once, so each message only pays for
+/// its own blocks. Runs of whole blocks are chained through the AES-CBC kernel, which uses the CPU's AES
+/// instructions where they are available.
+public struct _AESCMAC {
+    /// The number of bytes in a CMAC tag.
+    public static let byteCount = 16
+
+    /// An AES key with its key schedule and CMAC subkeys already derived.
+    ///
+    /// Prepared keys are immutable and may be shared freely between threads.
+    public struct PreparedKey {
+        let backing: OpenSSLCMACKey
+
+        /// Prepares a key for repeated CMAC computations.
+        ///
+        /// - Parameter key: An AES key of 128, 192, or 256 bits.
+        public init(_ key: SymmetricKey) throws {
+            self.backing = try OpenSSLCMACKey(key)
+        }
+    }
+
+    private var impl: OpenSSLCMACImpl
+
+    /// Starts a CMAC computation.
+    public init(key: PreparedKey) {
+        self.impl = OpenSSLCMACImpl(key: key.backing)
+    }
+
+    /// Adds data to be authenticated.
+    public mutating func update<D: DataProtocol>(data: D) {
+        self.impl.update(data: data)
+    }
+
+    /// Adds data to be authenticated.
+    public mutating func update(bufferPointer: UnsafeRawBufferPointer) {
+        self.impl.update(bufferPointer)
+    }
+
+    /// Returns the 16-byte tag over the data added so far.
+    public func finalize() -> Data {
+        self.impl.finalized()
+    }
+
+    /// Computes the CMAC tag of `data`.
+    ///
+    /// - Parameters:
+    ///   - data: The data to authenticate.
+    ///   - key: The prepared key.
+    /// - Returns: The 16-byte tag.
+    public static func authenticationCode<D: DataProtocol>(for data: D, using key: PreparedKey) -> Data {
+        var cmac = Self(key: key)
+        cmac.update(data: data)
+        return cmac.finalize()
+    }
+
+    /// Returns a Boolean value indicating whether `authenticationCode` is the CMAC tag of `data`.
+    ///
+    /// The comparison is performed in constant time.
+    public static func isValidAuthenticationCode<C: ContiguousBytes, D: DataProtocol>(
+        _ authenticationCode: C,
+        authenticating data: D,
+        using key: PreparedKey
+    ) -> Bool {
+        var cmac = Self(key: key)
+        cmac.update(data: data)
+        return authenticationCode.withUnsafeBytes { cmac.impl.isValid($0) }
+    }
+}
@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+/// AES-GMAC, the authentication-only mode of AES-GCM.
+///
+/// A GMAC tag is exactly the tag AES-GCM produces for the same key and nonce when the message is empty and the
+/// data is passed as authenticated data, so GMAC interoperates with ``AES/GCM``. Computing it directly skips the
+/// AEAD setup and copies, and a ``PreparedKey`` keeps the GHASH key table between messages, which suits
+/// integrity checks over large blobs.
+///
+/// As with AES-GCM, a nonce must never be reused with the same key.
+public struct _AESGMAC {
+    /// The number of bytes in a GMAC tag.
+    public static let byteCount = 16
+
+    /// An AES key with its GHASH key table already computed.
+    ///
+    /// Prepared keys are immutable and may be shared freely between threads.
+    public struct PreparedKey {
+        let backing: OpenSSLGHASHKey
+
+        /// Prepares a key for repeated GMAC computations.
+        ///
+        /// - Parameter key: An AES key of 128, 192, or 256 bits.
+        public init(_ key: SymmetricKey) throws {
+            self.backing = try OpenSSLGHASHKey(gmacKey: key)
+        }
+    }
+
+    private var impl: OpenSSLGHASHImpl
+
+    /// Starts a GMAC computation.
+    ///
+    /// - Parameters:
+    ///   - key: The prepared key.
+    ///   - nonce: The nonce. It must be unique for every use of the key.
+    public init(key: PreparedKey, nonce: AES.GCM.Nonce) {
+        self.impl = OpenSSLGHASHImpl(gmacKey: key.backing, nonce: nonce)
+    }
+
+    /// Adds data to be authenticated.
+    public mutating func update<D: DataProtocol>(data: D) {
+        self.impl.update(data: data)
+    }
+
+    /// Adds data to be authenticated.
+    public mutating func update(bufferPointer: UnsafeRawBufferPointer) {
+        self.impl.update(bufferPointer)
+    }
+
+    /// Returns the 16-byte tag over the data added so far.
+    public func finalize() -> Data {
+        self.impl.finalized()
+    }
+
+    /// Computes the GMAC tag of `data`.
+    ///
+    /// - Parameters:
+    ///   - data: The data to authenticate.
+    ///   - key: The prepared key.
+    ///   - nonce: The nonce. It must be unique for every use of the key.
+    /// - Returns: The 16-byte tag.
+    public static func authenticationCode<D: DataProtocol>(for data: D, using key: PreparedKey, nonce: AES.GCM.Nonce) -> Data {
+        var gmac = Self(key: key, nonce: nonce)
+        gmac.update(data: data)
+        return gmac.finalize()
+    }
+
+    /// Returns a Boolean value indicating whether `authenticationCode` is the GMAC tag of `data`.
+    ///
+    /// The comparison is performed in constant time.
+    public static func isValidAuthenticationCode<C: ContiguousBytes, D: DataProtocol>(
+        _ authenticationCode: C,
+        authenticating data: D,
+        using key: PreparedKey,
+        nonce: AES.GCM.Nonce
+    ) -> Bool {
+        var gmac = Self(key: key, nonce: nonce)
+        gmac.update(data: data)
+        return authenticationCode.withUnsafeBytes { gmac.impl.isValid($0) }
+    }
+}
@@ -0,0 +1,56 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+extension HMAC where H == SHA256 {
+    /// Computes the HMAC-SHA256 authentication codes of many independent messages under one key.
+    ///
+    /// The key is absorbed into the pad states once for the whole batch, and every message is
+    /// then authenticated without any per-message allocation. This is intended for verifiers that
+    /// check large numbers of small tags, such as request signatures or cookies.
+    /// On x86-64 CPUs with AVX2 but without the SHA extensions, the messages are authenticated eight at a time,
+    /// one per vector lane.
+    /// The codes are written contiguously into `macs`, in the same order as `messages`.
+    ///
+    /// - Parameters:
+    ///   - messages: The messages to authenticate.
+    ///   - key: The symmetric key used to secure the computation.
+    ///   - macs: The buffer to write the codes into. Must be exactly `messages.count * SHA256.byteCount` bytes.
+    /// - Throws: `CryptoKitError.incorrectParameterSize` if `macs` has the wrong size.
+    public static func _authenticationCodes(batch messages: [UnsafeRawBufferPointer], using key: SymmetricKey, into macs: UnsafeMutableRawBufferPointer) throws {
+        guard macs.count == messages.count * SHA256.byteCount else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+        try OpenSSLHMACBatchImpl.authenticationCodes(batch: messages, using: key, into: macs)
+    }
+
+    /// Computes the HMAC-SHA256 authentication codes of many independent messages, each under its own key.
+    ///
+    /// Consecutive messages that use equal keys share their pad states, so grouping messages by key
+    /// makes the batch cheaper. The codes are written contiguously into `macs`, in the same order as `messages`.
+    ///
+    /// - Parameters:
+    ///   - messages: The messages to authenticate.
+    ///   - keys: The key for each message. Must have the same count as `messages`.
+    ///   - macs: The buffer to write the codes into. Must be exactly `messages.count * SHA256.byteCount` bytes.
+    /// - Throws: `CryptoKitError.incorrectParameterSize` if `keys` or `macs` has the wrong size.
+    public static func _authenticationCodes(batch messages: [UnsafeRawBufferPointer], using keys: [SymmetricKey], into macs: UnsafeMutableRawBufferPointer) throws {
+        guard keys.count == messages.count, macs.count == messages.count * SHA256.byteCount else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+        try OpenSSLHMACBatchImpl.authenticationCodes(batch: messages, using: keys, into: macs)
+    }
+}
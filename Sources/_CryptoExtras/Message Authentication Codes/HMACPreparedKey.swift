@@ -0,0 +1,74 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+extension HMAC {
+    /// A symmetric key that has already been absorbed into the HMAC inner and outer pad states.
+    ///
+    /// Creating an ``HMAC`` hashes the key (if it is longer than a block), XORs it with the
+    /// inner and outer pads, and runs both padded blocks through the compression function.
+    /// A prepared key does that work once and keeps the resulting hash states, so each message
+    /// only pays for copying those states and hashing the message itself. This is intended for
+    /// services that authenticate many messages under a small number of long-lived keys.
+    ///
+    /// Prepared keys are immutable and may be shared freely; every computation works on a copy.
+    public struct _PreparedKey {
+        private let authenticator: HMAC<H>
+
+        /// Prepares a symmetric key for repeated HMAC computations.
+        ///
+        /// - Parameters:
+        ///   - key: The symmetric key used to secure the computation.
+        public init(_ key: SymmetricKey) {
+            self.authenticator = HMAC<H>(key: key)
+        }
+
+        /// Returns a fresh message authentication code generator keyed with this key.
+        ///
+        /// Use this to authenticate a message that arrives in pieces.
+        public func makeAuthenticator() -> HMAC<H> {
+            return self.authenticator
+        }
+
+        /// Computes a message authentication code for the given data.
+        ///
+        /// - Parameters:
+        ///   - data: The data for which to compute the authentication code.
+        ///
+        /// - Returns: The message authentication code.
+        public func authenticationCode<D: DataProtocol>(for data: D) -> HMAC<H>.MAC {
+            var authenticator = self.authenticator
+            authenticator.update(data: data)
+            return authenticator.finalize()
+        }
+
+        /// Returns a Boolean value indicating whether the given message
+        /// authentication code is valid for a block of data.
+        ///
+        /// The comparison is performed in constant time.
+        ///
+        /// - Parameters:
+        ///   - authenticationCode: The authentication code to compare.
+        ///   - authenticatedData: The block of data to compare.
+        ///
+        /// - Returns: A Boolean value that’s `true` if the message authentication
+        /// code is valid for the specified block of data.
+        public func isValidAuthenticationCode<C: ContiguousBytes, D: DataProtocol>(_ authenticationCode: C, authenticating authenticatedData: D) -> Bool {
+            let computedMAC = self.authenticationCode(for: authenticatedData)
+            return authenticationCode.withUnsafeBytes { computedMAC == $0 }
+        }
+    }
+}
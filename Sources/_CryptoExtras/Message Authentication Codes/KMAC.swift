@@ -0,0 +1,161 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+
+/// An implementation of KMAC128, the Keccak message authentication code specified in NIST SP 800-185.
+///
+/// The length of the code is part of the computation, so a shorter code isn't a prefix of a longer one. Finalizing
+/// doesn't consume the state. ``finalizeXOF(outputByteCount:)`` returns KMACXOF128 instead, whose outputs of
+/// different lengths are prefixes of each other.
+public struct _KMAC128 {
+    private var impl: OpenSSLSP800185Impl
+
+    /// Creates a KMAC128 function.
+    ///
+    /// - Parameters:
+    ///   - key: The key. It should have at least 128 bits.
+    ///   - customization: A string that separates this use of the function from others.
+    public init(key: SymmetricKey, customization: Data = Data()) {
+        self.impl = OpenSSLSP800185Impl(kmac: .bits128, key: key, customization: customization)
+    }
+
+    /// Incrementally updates the function with the contents of the buffer.
+    public mutating func update(bufferPointer: UnsafeRawBufferPointer) {
+        self.impl.absorb(bufferPointer)
+    }
+
+    /// Incrementally updates the function with the given data.
+    public mutating func update<D: DataProtocol>(data: D) {
+        for region in data.regions {
+            region.withUnsafeBytes { self.update(bufferPointer: $0) }
+        }
+    }
+
+    /// Returns the `outputByteCount`-byte KMAC128 of the data absorbed so far.
+    public func finalize(outputByteCount: Int = 32) -> Data {
+        precondition(outputByteCount >= 0)
+        var impl = self.impl
+        impl.absorbRightEncoded(UInt64(outputByteCount) * 8)
+        return impl.squeezed(byteCount: outputByteCount)
+    }
+
+    /// Returns `outputByteCount` bytes of KMACXOF128 output for the data absorbed so far.
+    public func finalizeXOF(outputByteCount: Int) -> Data {
+        precondition(outputByteCount >= 0)
+        var impl = self.impl
+        impl.absorbRightEncoded(0)
+        return impl.squeezed(byteCount: outputByteCount)
+    }
+
+    /// Computes the `outputByteCount`-byte KMAC128 of `data`.
+    public static func authenticationCode<D: DataProtocol>(
+        for data: D,
+        using key: SymmetricKey,
+        outputByteCount: Int = 32,
+        customization: Data = Data()
+    ) -> Data {
+        var kmac = Self(key: key, customization: customization)
+        kmac.update(data: data)
+        return kmac.finalize(outputByteCount: outputByteCount)
+    }
+
+    /// Returns a Boolean value indicating whether `authenticationCode` is the KMAC128 of `data`.
+    ///
+    /// The code is recomputed at the length of `authenticationCode`, and the comparison is performed in constant
+    /// time.
+    public static func isValidAuthenticationCode<C: ContiguousBytes, D: DataProtocol>(
+        _ authenticationCode: C,
+        authenticating data: D,
+        using key: SymmetricKey,
+        customization: Data = Data()
+    ) -> Bool {
+        var kmac = Self(key: key, customization: customization)
+        kmac.update(data: data)
+        return authenticationCode.withUnsafeBytes { kmac.impl.isValidKMAC($0) }
+    }
+}
+
+/// An implementation of KMAC256, the Keccak message authentication code specified in NIST SP 800-185.
+///
+/// The length of the code is part of the computation, so a shorter code isn't a prefix of a longer one. Finalizing
+/// doesn't consume the state. ``finalizeXOF(outputByteCount:)`` returns KMACXOF256 instead, whose outputs of
+/// different lengths are prefixes of each other.
+public struct _KMAC256 {
+    private var impl: OpenSSLSP800185Impl
+
+    /// Creates a KMAC256 function.
+    ///
+    /// - Parameters:
+    ///   - key: The key. It should have at least 256 bits.
+    ///   - customization: A string that separates this use of the function from others.
+    public init(key: SymmetricKey, customization: Data = Data()) {
+        self.impl = OpenSSLSP800185Impl(kmac: .bits256, key: key, customization: customization)
+    }
+
+    /// Incrementally updates the function with the contents of the buffer.
+    public mutating func update(bufferPointer: UnsafeRawBufferPointer) {
+        self.impl.absorb(bufferPointer)
+    }
+
+    /// Incrementally updates the function with the given data.
+    public mutating func update<D: DataProtocol>(data: D) {
+        for region in data.regions {
+            region.withUnsafeBytes { self.update(bufferPointer: $0) }
+        }
+    }
+
+    /// Returns the `outputByteCount`-byte KMAC256 of the data absorbed so far.
+    public func finalize(outputByteCount: Int = 64) -> Data {
+        precondition(outputByteCount >= 0)
+        var impl = self.impl
+        impl.absorbRightEncoded(UInt64(outputByteCount) * 8)
+        return impl.squeezed(byteCount: outputByteCount)
+    }
+
+    /// Returns `outputByteCount` bytes of KMACXOF256 output for the data absorbed so far.
+    public func finalizeXOF(outputByteCount: Int) -> Data {
+        precondition(outputByteCount >= 0)
+        var impl = self.impl
+        impl.absorbRightEncoded(0)
+        return impl.squeezed(byteCount: outputByteCount)
+    }
+
+    /// Computes the `outputByteCount`-byte KMAC256 of `data`.
+    public static func authenticationCode<D: DataProtocol>(
+        for data: D,
+        using key: SymmetricKey,
+        outputByteCount: Int = 64,
+        customization: Data = Data()
+    ) -> Data {
+        var kmac = Self(key: key, customization: customization)
+        kmac.update(data: data)
+        return kmac.finalize(outputByteCount: outputByteCount)
+    }
+
+    /// Returns a Boolean value indicating whether `authenticationCode` is the KMAC256 of `data`.
+    ///
+    /// The code is recomputed at the length of `authenticationCode`, and the comparison is performed in constant
+    /// time.
+    public static func isValidAuthenticationCode<C: ContiguousBytes, D: DataProtocol>(
+        _ authenticationCode: C,
+        authenticating data: D,
+        using key: SymmetricKey,
+        customization: Data = Data()
+    ) -> Bool {
+        var kmac = Self(key: key, customization: customization)
+        kmac.update(data: data)
+        return authenticationCode.withUnsafeBytes { kmac.impl.isValidKMAC($0) }
+    }
+}
@@ -0,0 +1,73 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+/// POLYVAL, the universal hash function of AES-GCM-SIV, as specified in RFC 8452.
+///
+/// POLYVAL is a building block rather than a MAC: its output must be protected, for example by encrypting it as
+/// AES-GCM-SIV does, before it can authenticate anything. The input is split into 16-byte blocks however it is
+/// divided between calls to ``update(data:)``, and a trailing partial block is padded with zeros, so callers that
+/// need an unambiguous encoding should append a length block themselves.
+///
+/// This runs on the same carry-less multiplication kernels as AES-GCM, with the key table computed once per
+/// ``PreparedKey``.
+public struct _POLYVAL {
+    /// The number of bytes in a POLYVAL output.
+    public static let byteCount = 16
+
+    /// A POLYVAL key with its multiplication table already computed.
+    ///
+    /// Prepared keys are immutable and may be shared freely between threads.
+    public struct PreparedKey {
+        let backing: OpenSSLGHASHKey
+
+        /// Prepares a key for repeated POLYVAL computations.
+        ///
+        /// - Parameter key: A 128-bit key, the field element H.
+        public init(_ key: SymmetricKey) throws {
+            self.backing = try OpenSSLGHASHKey(polyvalKey: key)
+        }
+    }
+
+    private var impl: OpenSSLGHASHImpl
+
+    /// Starts a POLYVAL computation.
+    public init(key: PreparedKey) {
+        self.impl = OpenSSLGHASHImpl(polyvalKey: key.backing)
+    }
+
+    /// Adds data to the hash.
+    public mutating func update<D: DataProtocol>(data: D) {
+        self.impl.update(data: data)
+    }
+
+    /// Adds data to the hash.
+    public mutating func update(bufferPointer: UnsafeRawBufferPointer) {
+        self.impl.update(bufferPointer)
+    }
+
+    /// Returns the 16-byte POLYVAL output over the data added so far.
+    public func finalize() -> Data {
+        self.impl.finalized()
+    }
+
+    /// Computes the POLYVAL output of `data`.
+    public static func hash<D: DataProtocol>(data: D, using key: PreparedKey) -> Data {
+        var polyval = Self(key: key)
+        polyval.update(data: data)
+        return polyval.finalize()
+    }
+}
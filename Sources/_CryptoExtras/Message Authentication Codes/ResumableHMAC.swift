@@ -0,0 +1,76 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+
+/// An HMAC state over SHA-2 that can be forked cheaply, and exported as a midstate to be resumed later.
+///
+/// This is the HMAC counterpart of ``_ResumableHash``. The midstate covers both the keyed outer pad
+/// and the running inner hash, so a keyed prefix can be persisted without keeping the key itself.
+///
+/// Only ``SHA256``, ``SHA384`` and ``SHA512`` are supported.
+///
+/// - Note: A midstate is enough to compute authentication codes for any extension of the absorbed
+///   input. Protect it as you would the key.
+public struct _ResumableHMAC<H: HashFunction>: Sendable {
+    private var impl: OpenSSLResumableHMACImpl
+
+    /// Creates an HMAC state keyed with `key`.
+    ///
+    /// - Throws: `CryptoKitError.invalidParameter` if `H` is not a supported hash function.
+    public init(key: SymmetricKey) throws {
+        self.impl = try OpenSSLResumableHMACImpl(H.self, key: key)
+    }
+
+    /// Restores an HMAC state from a midstate previously exported with ``midstate``.
+    ///
+    /// - Parameter midstate: The serialized state.
+    /// - Throws: `CryptoKitError.invalidParameter` if `H` is not supported or the midstate is malformed.
+    public init<Bytes: ContiguousBytes>(midstate: Bytes) throws {
+        self.impl = try midstate.withUnsafeBytes { try OpenSSLResumableHMACImpl(H.self, midstate: $0) }
+    }
+
+    /// The serialized state: the outer pad's hash state followed by the inner hash state.
+    public var midstate: Data {
+        self.impl.midstate
+    }
+
+    /// Returns an independent copy of this state. This is the same as copying the value.
+    public func fork() -> _ResumableHMAC<H> {
+        return self
+    }
+
+    /// Absorbs the contents of the buffer.
+    public mutating func update(bufferPointer: UnsafeRawBufferPointer) {
+        self.impl.update(bufferPointer: bufferPointer)
+    }
+
+    /// Absorbs the given data.
+    public mutating func update<D: DataProtocol>(data: D) {
+        for region in data.regions {
+            region.withUnsafeBytes { self.impl.update(bufferPointer: $0) }
+        }
+    }
+
+    /// Returns the authentication code of everything absorbed so far. The state itself is left unchanged.
+    public func finalize() -> Data {
+        self.impl.finalize()
+    }
+
+    /// Returns a Boolean value indicating whether `authenticationCode` is the authentication code of
+    /// everything absorbed so far. The comparison is performed in constant time.
+    public func isValidAuthenticationCode<C: ContiguousBytes>(_ authenticationCode: C) -> Bool {
+        authenticationCode.withUnsafeBytes { self.impl.isValidAuthenticationCode($0) }
+    }
+}
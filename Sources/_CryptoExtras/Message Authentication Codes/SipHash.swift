@@ -0,0 +1,64 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+/// SipHash-2-4, a fast keyed pseudorandom function for short inputs.
+///
+/// SipHash is intended for hash-flooding-resistant hash tables, shard selection and similar uses
+/// where an attacker can choose the inputs but mustn't be able to predict or collide their
+/// hashes. Its 64-bit output is too short for it to serve as a general-purpose MAC; use ``HMAC``
+/// for that.
+public struct _SipHash24: Sendable {
+    /// The number of bytes in a SipHash key.
+    public static let keyByteCount = 16
+
+    private let impl: OpenSSLSipHash24Impl
+
+    /// Creates a SipHash-2-4 function with the given key.
+    ///
+    /// - Parameter key: A 128-bit key.
+    /// - Throws: `CryptoKitError.incorrectKeySize` if the key isn't 128 bits.
+    public init(key: SymmetricKey) throws {
+        guard key.bitCount == Self.keyByteCount * 8 else {
+            throw CryptoKitError.incorrectKeySize
+        }
+        self.impl = OpenSSLSipHash24Impl(key: key)
+    }
+
+    /// Computes the SipHash-2-4 output of `bufferPointer`.
+    public func hash(bufferPointer: UnsafeRawBufferPointer) -> UInt64 {
+        return self.impl.hash(bufferPointer)
+    }
+
+    /// Computes the SipHash-2-4 output of `data`.
+    public func hash<D: DataProtocol>(data: D) -> UInt64 {
+        if let output = data.withContiguousStorageIfAvailable({ self.hash(bufferPointer: UnsafeRawBufferPointer($0)) }) {
+            return output
+        }
+        return Array(data).withUnsafeBytes { self.hash(bufferPointer: $0) }
+    }
+
+    /// Computes the SipHash-2-4 outputs of many inputs.
+    ///
+    /// Where the CPU supports it, inputs are hashed several at a time in SIMD lanes, so this is
+    /// considerably faster than hashing them one by one. Inputs of equal length batch best.
+    ///
+    /// - Parameter inputs: The inputs to hash.
+    /// - Returns: The output for each input, in the same order as `inputs`.
+    public func hashes(batch inputs: [UnsafeRawBufferPointer]) -> [UInt64] {
+        return self.impl.hashes(batch: inputs)
+    }
+}
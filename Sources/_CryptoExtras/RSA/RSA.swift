@@ -118,6 +118,27 @@ extension _RSA.Signing {
             self.backing.keySizeInBits
         }
 
+        /// Performs the one-off setup for public-key operations with this key ahead of time.
+        ///
+        /// Without this the setup happens lazily, on the first signature verification, and takes a lock
+        /// shared by every copy of the key. Calling it is never required.
+        public func _prepare() {
+            self.backing.prepare()
+        }
+
+        /// R^2 mod n for the key's Montgomery context and the number of bits in R, or `nil` if the platform keeps no
+        /// such state.
+        internal var montgomeryRR: (rr: Data, rBits: UInt32)? {
+            self.backing.montgomeryRR
+        }
+
+        /// Sets up the key's Montgomery context from a value ``montgomeryRR`` returned for the same modulus, so that it
+        /// needn't be computed. Only for a key that has just been created and not yet used or shared. Does nothing if
+        /// the value doesn't fit this platform.
+        internal func setMontgomeryRR(_ rr: UnsafeRawBufferPointer, rBits: UInt32) {
+            self.backing.setMontgomeryRR(rr, rBits: rBits)
+        }
+
         fileprivate init(_ backing: BackingPublicKey) {
             self.backing = backing
         }
@@ -188,6 +209,48 @@ extension _RSA.Signing {
             }
             self.backing = try BackingPrivateKey(keySize: keySize)
         }
+
+        /// Randomly generate a new RSA private key of a given size, racing several searches for primes in parallel.
+        ///
+        /// The first search to produce a key wins and the others are cancelled. Key generation time varies widely
+        /// from run to run, so this mostly trims the long tail, particularly for large keys. The native RSA
+        /// implementation on Apple platforms ignores `concurrency`.
+        ///
+        /// This constructor will refuse to generate keys smaller than 2048 bits. Callers that want to enforce minimum
+        /// key size requirements should validate `keySize` before use.
+        ///
+        /// - Parameters:
+        ///   - keySize: The size of the key to generate.
+        ///   - concurrency: The number of searches to run at once. Values of 1 or less behave like ``init(keySize:)``.
+        public init(keySize: _RSA.Signing.KeySize, _concurrency concurrency: Int) throws {
+            guard keySize.bitCount >= 2048 else {
+                throw CryptoKitError.incorrectParameterSize
+            }
+            self.backing = try BackingPrivateKey(keySize: keySize, concurrency: concurrency)
+        }
+
+        /// Randomly generate a new RSA private key of a given size on `executor`, suspending the calling task until
+        /// it's done.
+        ///
+        /// Cancelling the calling task abandons the search for primes. The native RSA implementation on Apple platforms
+        /// can only be cancelled before generation starts.
+        ///
+        /// This constructor will refuse to generate keys smaller than 2048 bits. Callers that want to enforce minimum
+        /// key size requirements should validate `keySize` before use.
+        ///
+        /// - Throws: `CancellationError` if the calling task is cancelled before the key is generated.
+        public init(
+            keySize: _RSA.Signing.KeySize,
+            on executor: _CryptoExecutor,
+            priority: _CryptoExecutor.Priority = .utility
+        ) async throws {
+            guard keySize.bitCount >= 2048 else {
+                throw CryptoKitError.incorrectParameterSize
+            }
+            self.backing = try await executor.run(priority: priority) { cancellation in
+                try BackingPrivateKey(keySize: keySize, cancellation: cancellation)
+            }
+        }
         
         /// Randomly generate a new RSA private key of a given size.
         ///
@@ -220,6 +283,33 @@ extension _RSA.Signing {
         public var publicKey: _RSA.Signing.PublicKey {
             _RSA.Signing.PublicKey(self.backing.publicKey)
         }
+
+        /// Returns a copy of this key that spreads signing operations across `shardCount` independent copies
+        /// of the underlying key.
+        ///
+        /// Each copy keeps its own lock and blinding cache, and each thread sticks to one copy. Use this for a
+        /// single hot key that many threads sign with at once. It costs one extra copy of the key per shard, and
+        /// has no effect when the platform's native RSA implementation is in use.
+        ///
+        /// - Parameter shardCount: The number of key copies to use. Must be at least 1.
+        public func _withSigningShards(_ shardCount: Int) -> _RSA.Signing.PrivateKey {
+            precondition(shardCount > 0, "RSA signing shard count must be at least 1")
+            var copy = self
+            copy.backing = self.backing.withSigningShards(shardCount)
+            return copy
+        }
+
+        /// Returns a copy of this key that computes each signature's two CRT halves concurrently.
+        ///
+        /// The exponentiations modulo each prime run on separate threads, which roughly halves the latency of a
+        /// single signature at the cost of a thread per operation. Use this for large keys where the latency of an
+        /// individual signature matters more than throughput. It has no effect when the platform's native RSA
+        /// implementation is in use.
+        public func _withParallelCRT() -> _RSA.Signing.PrivateKey {
+            var copy = self
+            copy.backing = self.backing.withParallelCRT()
+            return copy
+        }
     }
 }
 
@@ -367,6 +457,21 @@ extension _RSA.Signing.PublicKey {
     public func isValidSignature<D: DataProtocol>(_ signature: _RSA.Signing.RSASignature, for data: D, padding: _RSA.Signing.Padding) -> Bool {
         return self.isValidSignature(signature, for: SHA256.hash(data: data), padding: padding)
     }
+
+    /// Verifies a batch of RSA signatures with the given padding over the matching digests.
+    ///
+    /// This is equivalent to calling ``isValidSignature(_:for:padding:)`` for each pair, but shares the key
+    /// setup and padding work across the whole batch.
+    ///
+    /// - Parameters:
+    ///   - signatures: The signatures to verify.
+    ///   - digests: The digests that were signed, one per signature.
+    ///   - padding: The padding to use.
+    /// - Returns: For each signature, true if it is valid and false otherwise.
+    public func _areValidSignatures<D: Digest>(_ signatures: [_RSA.Signing.RSASignature], for digests: [D], padding: _RSA.Signing.Padding) -> [Bool] {
+        precondition(signatures.count == digests.count, "Every signature needs exactly one digest")
+        return self.backing.areValidSignatures(signatures, for: digests, padding: padding)
+    }
 }
 
 extension _RSA.Signing {
@@ -0,0 +1,281 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+
+extension _RSA.Signing {
+    /// An RSA public key held as its modulus bytes and public exponent, for verifiers that keep very many keys in
+    /// memory but verify with only a few of them at a time.
+    ///
+    /// A ``_RSA/Signing/PublicKey`` owns a BoringSSL `RSA` with a `BIGNUM` per component, plus, once it has verified
+    /// anything, a Montgomery context for its modulus: for a 2048-bit key, about 650 bytes on the heap in several
+    /// allocations before the first verification and about 1.5 KB after it. A compact key is the 256 bytes of the
+    /// modulus in one allocation and the exponent stored inline. Almost every key uses one of a handful of exponents,
+    /// usually 65537, so there's nothing to gain from storing the exponent as anything more than a number.
+    ///
+    /// Verifying with a compact key builds a ``_RSA/Signing/PublicKey`` for the one verification, which costs about
+    /// 3µs on top of the 16µs the verification itself takes for a 2048-bit key. Pass a ``_CompactPublicKeyCache`` to
+    /// keep the keys in use ready for verification instead.
+    ///
+    /// Verification accepts exactly the signatures ``_RSA/Signing/PublicKey`` accepts.
+    public struct _CompactPublicKey: Hashable, Sendable {
+        /// The modulus, big-endian with no leading zero bytes.
+        public let modulus: Data
+
+        /// The public exponent.
+        public let publicExponent: UInt64
+
+        /// Creates a compact copy of `publicKey`.
+        ///
+        /// - Throws: `CryptoKitError.invalidParameter` if the public exponent doesn't fit in 64 bits, which BoringSSL
+        ///   never allows.
+        public init(_ publicKey: _RSA.Signing.PublicKey) throws {
+            (self.modulus, self.publicExponent) = try Self.parsePKCS1(publicKey.pkcs1DERRepresentation)
+        }
+
+        /// Creates a key from its modulus and public exponent.
+        ///
+        /// This constructor supports key sizes of 2048 bits or more. Users should validate that key sizes are
+        /// appropriate for their use-case.
+        ///
+        /// - Parameters:
+        ///   - modulus: The modulus, big-endian. Leading zero bytes are ignored.
+        ///   - publicExponent: The public exponent.
+        /// - Throws: `CryptoKitError.incorrectParameterSize` if the key is smaller than 2048 bits, or another error if
+        ///   the modulus or exponent is not acceptable to ``_RSA/Signing/PublicKey``.
+        public init<Bytes: DataProtocol>(modulus: Bytes, publicExponent: UInt64) throws {
+            self.modulus = Data(modulus.drop { $0 == 0 })
+            self.publicExponent = publicExponent
+            // Check the key the same way every other constructor does.
+            _ = try _RSA.Signing.PublicKey(derRepresentation: self.pkcs1DERRepresentation)
+        }
+
+        /// Creates a key from a DER representation, in either SPKI or PKCS#1 form.
+        ///
+        /// This constructor supports key sizes of 2048 bits or more. Users should validate that key sizes are
+        /// appropriate for their use-case.
+        public init<Bytes: DataProtocol>(derRepresentation: Bytes) throws {
+            try self.init(_RSA.Signing.PublicKey(derRepresentation: derRepresentation))
+        }
+
+        /// The size of the key in bits, as ``_RSA/Signing/PublicKey/keySizeInBits`` reports it.
+        public var keySizeInBits: Int {
+            self.modulus.count * 8
+        }
+
+        /// The PKCS#1 DER representation of the key.
+        public var pkcs1DERRepresentation: Data {
+            let modulus = Self.derInteger(self.modulus)
+            let exponent = Self.derInteger(Self.bigEndianBytes(of: self.publicExponent))
+            return Self.derNode(tag: 0x30, contents: modulus + exponent)
+        }
+
+        /// The key as a ``_RSA/Signing/PublicKey``, which builds the BoringSSL structures this type avoids.
+        public var publicKey: _RSA.Signing.PublicKey {
+            // The key was checked when this value was created.
+            try! _RSA.Signing.PublicKey(derRepresentation: self.pkcs1DERRepresentation)
+        }
+
+        /// Verifies an RSA signature with the given padding over a given digest.
+        ///
+        /// - Returns: What ``_RSA/Signing/PublicKey/isValidSignature(_:for:padding:)`` returns for the same arguments.
+        public func isValidSignature<D: Digest>(
+            _ signature: _RSA.Signing.RSASignature,
+            for digest: D,
+            padding: _RSA.Signing.Padding
+        ) -> Bool {
+            self.publicKey.isValidSignature(signature, for: digest, padding: padding)
+        }
+
+        /// Verifies an RSA signature with the given padding over the SHA-256 digest of `data`.
+        ///
+        /// - Returns: What ``_RSA/Signing/PublicKey/isValidSignature(_:for:padding:)`` returns for the same arguments.
+        public func isValidSignature<D: DataProtocol>(
+            _ signature: _RSA.Signing.RSASignature,
+            for data: D,
+            padding: _RSA.Signing.Padding
+        ) -> Bool {
+            self.isValidSignature(signature, for: SHA256.hash(data: data), padding: padding)
+        }
+
+        /// Verifies an RSA signature with the given padding over a given digest, using the key `cache` keeps ready
+        /// for this key, and adding one if there isn't one.
+        ///
+        /// - Returns: What ``_RSA/Signing/PublicKey/isValidSignature(_:for:padding:)`` returns for the same arguments.
+        public func isValidSignature<D: Digest>(
+            _ signature: _RSA.Signing.RSASignature,
+            for digest: D,
+            padding: _RSA.Signing.Padding,
+            cachingIn cache: _CompactPublicKeyCache
+        ) -> Bool {
+            cache.preparedKey(for: self).isValidSignature(signature, for: digest, padding: padding)
+        }
+
+        /// Verifies an RSA signature with the given padding over the SHA-256 digest of `data`, using the key `cache`
+        /// keeps ready for this key, and adding one if there isn't one.
+        ///
+        /// - Returns: What ``_RSA/Signing/PublicKey/isValidSignature(_:for:padding:)`` returns for the same arguments.
+        public func isValidSignature<D: DataProtocol>(
+            _ signature: _RSA.Signing.RSASignature,
+            for data: D,
+            padding: _RSA.Signing.Padding,
+            cachingIn cache: _CompactPublicKeyCache
+        ) -> Bool {
+            self.isValidSignature(signature, for: SHA256.hash(data: data), padding: padding, cachingIn: cache)
+        }
+    }
+
+    /// A bounded cache of ``_RSA/Signing/PublicKey`` values, prepared with ``_RSA/Signing/PublicKey/_prepare()``, for
+    /// the ``_CompactPublicKey`` values verifying most often.
+    ///
+    /// Most of the cost of verifying with a compact key that isn't in a cache is building and preparing a full key,
+    /// so a cache of the keys in use removes it for them while the rest of the keys stay compact. When the cache is
+    /// full, the least recently used key is dropped.
+    ///
+    /// The cache is split into shards, each with its own lock, and a key is built and prepared without any lock held.
+    public final class _CompactPublicKeyCache: @unchecked Sendable {
+        /// The size and hit rate of a cache.
+        public struct Statistics: Sendable, Hashable {
+            /// The number of cached keys.
+            public var keyCount: Int
+            /// The most keys the cache holds.
+            public var capacity: Int
+            /// Verifications that found their key in the cache.
+            public var hits: UInt64
+            /// Verifications that had to build and prepare their key.
+            public var misses: UInt64
+            /// Keys dropped to make room for another.
+            public var evictions: UInt64
+        }
+
+        private let keys: ShardedLRUCache<_CompactPublicKey, _RSA.Signing.PublicKey>
+
+        /// Creates an empty cache.
+        ///
+        /// - Parameters:
+        ///   - capacity: The most keys to keep, rounded up to a multiple of `shards`. Must be positive.
+        ///   - shards: The number of independently locked parts of the cache. Must be positive.
+        ///   - budget: The budget to charge the cached keys to, or `nil` to bound the cache by `capacity` alone.
+        ///   - budgetWeight: The weight of the cache's share of `budget`. Must be positive.
+        public init(
+            capacity: Int = 1024,
+            shards: Int = 16,
+            budget: _CryptoCacheBudget? = .shared,
+            budgetWeight: Double = 1
+        ) {
+            self.keys = ShardedLRUCache(
+                capacity: capacity,
+                shardCount: shards,
+                budget: budget,
+                name: "_RSA.Signing._CompactPublicKeyCache",
+                weight: budgetWeight,
+                entryByteCount: { _, key in key.estimatedCachedByteCount }
+            )
+        }
+
+        /// Drops the prepared key for `key`, if it's cached.
+        public func removeKey(for key: _CompactPublicKey) {
+            self.keys.removeValue(for: key)
+        }
+
+        /// Drops every cached key.
+        public func removeAll() {
+            self.keys.removeAll()
+        }
+
+        /// A snapshot of the cache's size and hit rate.
+        public var statistics: Statistics {
+            let statistics = self.keys.statistics
+            return Statistics(
+                keyCount: statistics.count,
+                capacity: self.keys.capacity,
+                hits: statistics.hits,
+                misses: statistics.misses,
+                evictions: statistics.evictions
+            )
+        }
+
+        fileprivate func preparedKey(for key: _CompactPublicKey) -> _RSA.Signing.PublicKey {
+            self.keys.value(for: key) {
+                let publicKey = key.publicKey
+                publicKey._prepare()
+                return publicKey
+            }
+        }
+    }
+}
+
+extension _RSA.Signing._CompactPublicKey {
+    // An ad-hoc encoder and parser for the PKCS#1 RSAPublicKey structure, SEQUENCE { INTEGER n, INTEGER e }, which is
+    // all this type needs of ASN.1.
+
+    fileprivate static func parsePKCS1(_ der: Data) throws -> (modulus: Data, publicExponent: UInt64) {
+        var bytes = der[...]
+        var sequence = try Self.readNode(tag: 0x30, from: &bytes)
+        let modulus = try Self.readNode(tag: 0x02, from: &sequence).drop { $0 == 0 }
+        let exponent = try Self.readNode(tag: 0x02, from: &sequence).drop { $0 == 0 }
+        guard bytes.isEmpty, sequence.isEmpty, exponent.count <= 8 else {
+            throw CryptoKitError.invalidParameter
+        }
+        return (Data(modulus), exponent.reduce(UInt64(0)) { $0 << 8 | UInt64($1) })
+    }
+
+    private static func readNode(tag: UInt8, from bytes: inout Data.SubSequence) throws -> Data.SubSequence {
+        guard bytes.popFirst() == tag, let first = bytes.popFirst() else {
+            throw CryptoKitError.invalidParameter
+        }
+        var length = Int(first)
+        if first & 0x80 != 0 {
+            let lengthByteCount = Int(first & 0x7F)
+            guard lengthByteCount > 0, lengthByteCount <= 4, bytes.count >= lengthByteCount else {
+                throw CryptoKitError.invalidParameter
+            }
+            length = bytes.prefix(lengthByteCount).reduce(Int(0)) { $0 << 8 | Int($1) }
+            bytes.removeFirst(lengthByteCount)
+        }
+        guard bytes.count >= length else {
+            throw CryptoKitError.invalidParameter
+        }
+        defer {
+            bytes.removeFirst(length)
+        }
+        return bytes.prefix(length)
+    }
+
+    fileprivate static func bigEndianBytes(of value: UInt64) -> Data {
+        Swift.withUnsafeBytes(of: value.bigEndian) { Data($0.drop { $0 == 0 }) }
+    }
+
+    fileprivate static func derInteger(_ magnitude: Data) -> Data {
+        // INTEGERs are signed, so a leading byte with its top bit set needs a zero byte in front of it.
+        if let first = magnitude.first, first & 0x80 == 0 {
+            return Self.derNode(tag: 0x02, contents: magnitude)
+        }
+        return Self.derNode(tag: 0x02, contents: [0] + magnitude)
+    }
+
+    fileprivate static func derNode(tag: UInt8, contents: Data) -> Data {
+        var node = Data(capacity: 6 + contents.count)
+        node.append(tag)
+        if contents.count < 0x80 {
+            node.append(UInt8(contents.count))
+        } else {
+            let length = Self.bigEndianBytes(of: UInt64(contents.count))
+            node.append(0x80 | UInt8(length.count))
+            node.append(length)
+        }
+        node.append(contents)
+        return node
+    }
+}
@@ -0,0 +1,76 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Foundation
+import Crypto
+
+extension _RSA.Signing.PublicKey {
+    /// Construct an RSA public key from a DER representation, reusing a previously constructed key when the same
+    /// bytes have been seen before.
+    ///
+    /// Keys returned from this constructor have already been prepared with ``_prepare()``, and are shared across the
+    /// whole process. This suits verifiers that repeatedly re-parse the same small set of keys, such as JWKS documents.
+    /// The cache holds a bounded number of keys; the oldest entries are evicted first.
+    ///
+    /// This constructor supports key sizes of 2048 bits or more. Users should validate that key sizes are appropriate
+    /// for their use-case.
+    public static func _cached<Bytes: DataProtocol>(derRepresentation: Bytes) throws -> _RSA.Signing.PublicKey {
+        let fingerprint = SHA256.hash(data: derRepresentation)
+        if let key = _RSA.Signing.PublicKey.cache.key(for: fingerprint) {
+            return key
+        }
+
+        let key = try _RSA.Signing.PublicKey(derRepresentation: derRepresentation)
+        key._prepare()
+        _RSA.Signing.PublicKey.cache.insert(key, for: fingerprint)
+        return key
+    }
+
+    /// Construct an RSA public key from a PEM representation, reusing a previously constructed key when the same
+    /// DER bytes have been seen before.
+    ///
+    /// The cache is shared with ``_cached(derRepresentation:)``, and keyed by the DER bytes inside the document, so a
+    /// key is found whether it was first imported as PEM or as DER. Documents that ``init(pemRepresentation:)`` only
+    /// accepts through its lenient fallback, such as those surrounded by other text, are parsed and prepared but not
+    /// cached.
+    ///
+    /// This constructor supports key sizes of 2048 bits or more. Users should validate that key sizes are appropriate
+    /// for their use-case.
+    public static func _cached(pemRepresentation: String) throws -> _RSA.Signing.PublicKey {
+        guard let document = try? ASN1.PEMDocument(pemString: pemRepresentation),
+              document.type == _RSA.SPKIPublicKeyType || document.type == _RSA.PKCS1PublicKeyType else {
+            let key = try _RSA.Signing.PublicKey(pemRepresentation: pemRepresentation)
+            key._prepare()
+            return key
+        }
+        return try _RSA.Signing.PublicKey._cached(derRepresentation: document.derBytes)
+    }
+
+    /// Removes every key cached by ``_cached(derRepresentation:)`` and ``_cached(pemRepresentation:)``.
+    public static func _removeAllCachedKeys() {
+        _RSA.Signing.PublicKey.cache.removeAll()
+    }
+
+    static let cache = ParsedKeyCache<_RSA.Signing.PublicKey>(
+        capacity: 1024,
+        budget: .shared,
+        name: "_RSA.Signing.PublicKey._cached",
+        keyByteCount: { $0.estimatedCachedByteCount }
+    )
+
+    /// The estimated memory a cached key keeps alive: the RSA structure with its modulus, and the Montgomery context
+    /// built for the modulus when the key is first used.
+    var estimatedCachedByteCount: Int {
+        1024 + self.keySizeInBits / 8 * 4
+    }
+}
@@ -51,6 +51,18 @@ internal struct BoringSSLRSAPublicKey: Sendable {
         self.backing.keySizeInBits
     }
 
+    func prepare() {
+        self.backing.prepare()
+    }
+
+    var montgomeryRR: (rr: Data, rBits: UInt32)? {
+        self.backing.montgomeryRR
+    }
+
+    func setMontgomeryRR(_ rr: UnsafeRawBufferPointer, rBits: UInt32) {
+        self.backing.setMontgomeryRR(rr, rBits: rBits)
+    }
+
     fileprivate init(_ backing: Backing) {
         self.backing = backing
     }
@@ -60,6 +72,13 @@ internal struct BoringSSLRSAPublicKey: Sendable {
 internal struct BoringSSLRSAPrivateKey: Sendable {
     private var backing: Backing
 
+    // Additional copies of `backing` used to spread out signing. BoringSSL serialises blinding on a per-key lock,
+    // so giving each thread its own copy of a hot key avoids that contention.
+    private var signingShards: [Backing] = []
+
+    // Whether signing splits the CRT exponentiations across two threads.
+    private var parallelCRT = false
+
     init(pemRepresentation: String) throws {
         self.backing = try Backing(pemRepresentation: pemRepresentation)
     }
@@ -72,6 +91,18 @@ internal struct BoringSSLRSAPrivateKey: Sendable {
         self.backing = try Backing(keySize: keySize)
     }
 
+    init(keySize: _RSA.Signing.KeySize, concurrency: Int) throws {
+        if concurrency > 1 {
+            self.backing = try Backing(keySize: keySize, concurrency: concurrency)
+        } else {
+            self.backing = try Backing(keySize: keySize)
+        }
+    }
+
+    init(keySize: _RSA.Signing.KeySize, cancellation: _CryptoCancellation) throws {
+        self.backing = try Backing(keySize: keySize, cancellation: cancellation)
+    }
+
     var derRepresentation: Data {
         self.backing.derRepresentation
     }
@@ -91,11 +122,33 @@ internal struct BoringSSLRSAPrivateKey: Sendable {
     var publicKey: BoringSSLRSAPublicKey {
         self.backing.publicKey
     }
+
+    func withSigningShards(_ shardCount: Int) -> BoringSSLRSAPrivateKey {
+        var copy = self
+        copy.signingShards = (1..<shardCount).map { _ in Backing(copying: self.backing) }
+        return copy
+    }
+
+    func withParallelCRT() -> BoringSSLRSAPrivateKey {
+        var copy = self
+        copy.parallelCRT = true
+        return copy
+    }
+
+    private var signingBacking: Backing {
+        guard !self.signingShards.isEmpty else {
+            return self.backing
+        }
+
+        // A given thread always lands on the same shard, so its blinding cache stays warm.
+        let index = ObjectIdentifier(Thread.current).hashValue.magnitude % UInt(self.signingShards.count + 1)
+        return index == 0 ? self.backing : self.signingShards[Int(index) - 1]
+    }
 }
 
 extension BoringSSLRSAPrivateKey {
     internal func signature<D: Digest>(for digest: D, padding: _RSA.Signing.Padding) throws -> _RSA.Signing.RSASignature {
-        return try self.backing.signature(for: digest, padding: padding)
+        return try self.signingBacking.signature(for: digest, padding: padding, parallelCRT: self.parallelCRT)
     }
     
     internal func decrypt<D: DataProtocol>(_ data: D, padding: _RSA.Encryption.Padding) throws -> Data {
@@ -107,6 +160,10 @@ extension BoringSSLRSAPublicKey {
     func isValidSignature<D: Digest>(_ signature: _RSA.Signing.RSASignature, for digest: D, padding: _RSA.Signing.Padding) -> Bool {
         return self.backing.isValidSignature(signature, for: digest, padding: padding)
     }
+
+    func areValidSignatures<D: Digest>(_ signatures: [_RSA.Signing.RSASignature], for digests: [D], padding: _RSA.Signing.Padding) -> [Bool] {
+        return self.backing.areValidSignatures(signatures, for: digests, padding: padding)
+    }
     
     internal func encrypt<D: DataProtocol>(_ data: D, padding: _RSA.Encryption.Padding) throws -> Data {
         return try self.backing.encrypt(data, padding: padding)
@@ -128,6 +185,20 @@ extension BoringSSLRSAPublicKey {
         }
 
         fileprivate init(pemRepresentation: String) throws {
+            // Well-formed documents are decoded here and their DER parsed in place. Anything the strict decoder
+            // rejects, such as a document surrounded by other text, goes to BoringSSL's more lenient PEM reader.
+            if let document = try? ASN1.PEMDocument(pemString: pemRepresentation),
+               document.type == _RSA.SPKIPublicKeyType || document.type == _RSA.PKCS1PublicKeyType {
+                let parsed = document.type == _RSA.SPKIPublicKeyType ?
+                    Backing.spkiDERPublicKey(document.derBytes) : Backing.pkcs1DERPublicKey(document.derBytes)
+                guard let rsaPublicKey = parsed else {
+                    throw CryptoKitError.internalBoringSSLError()
+                }
+                self.pointer = CCryptoBoringSSL_EVP_PKEY_new()
+                CCryptoBoringSSL_EVP_PKEY_assign_RSA(self.pointer, rsaPublicKey)
+                return
+            }
+
             var pemRepresentation = pemRepresentation
             self.pointer = CCryptoBoringSSL_EVP_PKEY_new()
 
@@ -172,45 +243,33 @@ extension BoringSSLRSAPublicKey {
         }
 
         private init<Bytes: ContiguousBytes>(contiguousDerRepresentation: Bytes) throws {
-            self.pointer = CCryptoBoringSSL_EVP_PKEY_new()
             // There are two encodings for RSA public keys: PKCS#1 and the SPKI form.
             // The SPKI form is what we support for EC keys, so we try that first, then we
             // fall back to the PKCS#1 form if that parse fails.
-            do {
-                let rsaPublicKey = try contiguousDerRepresentation.withUnsafeBytes { derPtr in
-                    return try BIOHelper.withReadOnlyMemoryBIO(wrapping: derPtr) { bio in
-                        guard let key = CCryptoBoringSSL_d2i_RSA_PUBKEY_bio(bio, nil) else {
-                            throw CryptoKitError.internalBoringSSLError()
-                        }
-                        return key
-                    }
-                }
-                CCryptoBoringSSL_EVP_PKEY_assign_RSA(self.pointer, rsaPublicKey)
-            } catch {
-                do {
-                    let rsaPublicKey = try contiguousDerRepresentation.withUnsafeBytes { derPtr in
-                        return try BIOHelper.withReadOnlyMemoryBIO(wrapping: derPtr) { bio in
-                            guard let key = CCryptoBoringSSL_d2i_RSAPublicKey_bio(bio, nil) else {
-                                throw CryptoKitError.internalBoringSSLError()
-                            }
-                            return key
-                        }
-                    }
-                    CCryptoBoringSSL_EVP_PKEY_assign_RSA(self.pointer, rsaPublicKey)
-                } catch {
-                    CCryptoBoringSSL_EVP_PKEY_free(self.pointer)
-                    throw error
-                }
+            guard let rsaPublicKey = Backing.spkiDERPublicKey(contiguousDerRepresentation) ??
+                    Backing.pkcs1DERPublicKey(contiguousDerRepresentation) else {
+                throw CryptoKitError.internalBoringSSLError()
             }
+            self.pointer = CCryptoBoringSSL_EVP_PKEY_new()
+            CCryptoBoringSSL_EVP_PKEY_assign_RSA(self.pointer, rsaPublicKey)
         }
 
-        fileprivate var pkcs1DERRepresentation: Data {
-            return BIOHelper.withWritableMemoryBIO { bio in
-                let rsaPublicKey = CCryptoBoringSSL_EVP_PKEY_get0_RSA(self.pointer)
-                let rc = CCryptoBoringSSL_i2d_RSAPublicKey_bio(bio, rsaPublicKey)
-                precondition(rc == 1)
+        private static func spkiDERPublicKey<Bytes: ContiguousBytes>(_ derRepresentation: Bytes) -> OpaquePointer? {
+            return derRepresentation.withUnsafeBytes { derPtr in
+                CCryptoBoringSSLShims_RSA_parse_spki_buffer(derPtr.bindMemory(to: UInt8.self).baseAddress, derPtr.count)
+            }
+        }
+
+        private static func pkcs1DERPublicKey<Bytes: ContiguousBytes>(_ derRepresentation: Bytes) -> OpaquePointer? {
+            return derRepresentation.withUnsafeBytes { derPtr in
+                CCryptoBoringSSLShims_RSA_parse_public_key_buffer(derPtr.bindMemory(to: UInt8.self).baseAddress, derPtr.count)
+            }
+        }
 
-                return try! Data(copyingMemoryBIO: bio)
+        fileprivate var pkcs1DERRepresentation: Data {
+            let rsaPublicKey = CCryptoBoringSSL_EVP_PKEY_get0_RSA(self.pointer)
+            return Data(marshallingExactly: CCryptoBoringSSLShims_RSA_public_key_der_size(rsaPublicKey)) {
+                CCryptoBoringSSLShims_RSA_marshal_public_key_fixed($0, $1, rsaPublicKey)
             }
         }
 
@@ -219,12 +278,9 @@ extension BoringSSLRSAPublicKey {
         }
 
         fileprivate var derRepresentation: Data {
-            return BIOHelper.withWritableMemoryBIO { bio in
-                let rsaPublicKey = CCryptoBoringSSL_EVP_PKEY_get0_RSA(self.pointer)
-                let rc = CCryptoBoringSSL_i2d_RSA_PUBKEY_bio(bio, rsaPublicKey)
-                precondition(rc == 1)
-
-                return try! Data(copyingMemoryBIO: bio)
+            let rsaPublicKey = CCryptoBoringSSL_EVP_PKEY_get0_RSA(self.pointer)
+            return Data(marshallingExactly: CCryptoBoringSSLShims_RSA_spki_der_size(rsaPublicKey)) {
+                CCryptoBoringSSLShims_RSA_marshal_spki_fixed($0, $1, self.pointer)
             }
         }
 
@@ -237,37 +293,115 @@ extension BoringSSLRSAPublicKey {
             return Int(CCryptoBoringSSL_RSA_size(rsaPublicKey)) * 8
         }
 
+        fileprivate func prepare() {
+            // BoringSSL sets up the Montgomery context for the modulus on the first public-key operation. Computing
+            // 1^e mod n with no padding is the cheapest operation that goes through that path.
+            let rsaPublicKey = CCryptoBoringSSL_EVP_PKEY_get0_RSA(self.pointer)
+            let size = Int(CCryptoBoringSSL_RSA_size(rsaPublicKey))
+            var input = [UInt8](repeating: 0, count: size)
+            input[size - 1] = 1
+            var output = [UInt8](repeating: 0, count: size)
+            var outputLength = 0
+
+            let rc = CCryptoBoringSSL_RSA_verify_raw(
+                rsaPublicKey,
+                &outputLength,
+                &output,
+                output.count,
+                input,
+                input.count,
+                RSA_NO_PADDING
+            )
+            precondition(rc == 1)
+        }
+
+        fileprivate var montgomeryRR: (rr: Data, rBits: UInt32)? {
+            let rsaPublicKey = CCryptoBoringSSL_EVP_PKEY_get0_RSA(self.pointer)
+            var rr = Data(repeating: 0, count: Int(CCryptoBoringSSL_RSA_size(rsaPublicKey)))
+            var rBits = UInt32(0)
+            let rc = rr.withUnsafeMutableBytes { rrPointer in
+                CCryptoBoringSSLShims_RSA_montgomery_rr(rsaPublicKey, rrPointer.bindMemory(to: UInt8.self).baseAddress, rrPointer.count, &rBits)
+            }
+            return rc == 1 ? (rr, rBits) : nil
+        }
+
+        fileprivate func setMontgomeryRR(_ rr: UnsafeRawBufferPointer, rBits: UInt32) {
+            // On failure the context is set up on first use, as for any other key.
+            _ = CCryptoBoringSSLShims_RSA_set_montgomery_rr(CCryptoBoringSSL_EVP_PKEY_get0_RSA(self.pointer), rr.bindMemory(to: UInt8.self).baseAddress, rr.count, rBits)
+        }
+
         fileprivate func isValidSignature<D: Digest>(_ signature: _RSA.Signing.RSASignature, for digest: D, padding: _RSA.Signing.Padding) -> Bool {
             let hashDigestType = try! DigestType(forDigestType: D.self)
             let rsaPublicKey = CCryptoBoringSSL_EVP_PKEY_get0_RSA(self.pointer)
 
+            let pssDigest: OpaquePointer?
+            switch padding.backing {
+            case .pkcs1v1_5:
+                pssDigest = nil
+            case .pss:
+                pssDigest = hashDigestType.dispatchTable
+            }
+
+            // Invalid signatures are an expected outcome, so this path never touches the error queue.
             return signature.withUnsafeBytes { signaturePtr in
                 let rc: CInt = digest.withUnsafeBytes { digestPtr in
+                    CCryptoBoringSSLShims_RSA_verify_quiet(
+                        rsaPublicKey,
+                        hashDigestType.nid,
+                        pssDigest,
+                        digestPtr.baseAddress,
+                        digestPtr.count,
+                        signaturePtr.baseAddress,
+                        signaturePtr.count
+                    )
+                }
+                return rc == 1
+            }
+        }
+
+        fileprivate func areValidSignatures<D: Digest>(_ signatures: [_RSA.Signing.RSASignature], for digests: [D], padding: _RSA.Signing.Padding) -> [Bool] {
+            let hashDigestType = try! DigestType(forDigestType: D.self)
+            let rsaPublicKey = CCryptoBoringSSL_EVP_PKEY_get0_RSA(self.pointer)
+            let signatureSize = Int(CCryptoBoringSSL_RSA_size(rsaPublicKey))
+
+            // Pack everything back to back for the shim. A signature of the wrong length can never be valid, so it
+            // is left zeroed and its result overridden below.
+            var packedSignatures = [UInt8](repeating: 0, count: signatures.count * signatureSize)
+            var packedDigests = [UInt8]()
+            packedDigests.reserveCapacity(digests.count * hashDigestType.digestLength)
+            for (index, signature) in signatures.enumerated() where signature.rawRepresentation.count == signatureSize {
+                packedSignatures.replaceSubrange(
+                    (index * signatureSize)..<((index + 1) * signatureSize),
+                    with: signature.rawRepresentation
+                )
+            }
+            for digest in digests {
+                digest.withUnsafeBytes { packedDigests.append(contentsOf: $0) }
+            }
+
+            var results = [UInt8](repeating: 0, count: signatures.count)
+            packedSignatures.withUnsafeBytes { signaturesPtr in
+                packedDigests.withUnsafeBytes { digestsPtr in
+                    let pssDigest: OpaquePointer?
                     switch padding.backing {
                     case .pkcs1v1_5:
-                        return CCryptoBoringSSLShims_RSA_verify(
-                            hashDigestType.nid,
-                            digestPtr.baseAddress,
-                            digestPtr.count,
-                            signaturePtr.baseAddress,
-                            signaturePtr.count,
-                            rsaPublicKey
-                        )
+                        pssDigest = nil
                     case .pss:
-                        return CCryptoBoringSSLShims_RSA_verify_pss_mgf1(
-                            rsaPublicKey,
-                            digestPtr.baseAddress,
-                            digestPtr.count,
-                            hashDigestType.dispatchTable,
-                            hashDigestType.dispatchTable,
-                            CInt(hashDigestType.digestLength),
-                            signaturePtr.baseAddress,
-                            signaturePtr.count
-                        )
+                        pssDigest = hashDigestType.dispatchTable
                     }
+                    CCryptoBoringSSLShims_RSA_verify_batch(
+                        rsaPublicKey,
+                        hashDigestType.nid,
+                        pssDigest,
+                        digestsPtr.baseAddress,
+                        hashDigestType.digestLength,
+                        signaturesPtr.baseAddress,
+                        signatures.count,
+                        &results
+                    )
                 }
-                return rc == 1
             }
+            return zip(signatures, results).map { $0.rawRepresentation.count == signatureSize && $1 == 1 }
         }
         
         fileprivate func encrypt<D: DataProtocol>(_ data: D, padding: _RSA.Encryption.Padding) throws -> Data {
@@ -278,38 +412,20 @@ extension BoringSSLRSAPublicKey {
             let contiguousData: ContiguousBytes = data.regions.count == 1 ? data.regions.first! : Array(data)
             try output.withUnsafeMutableBytes { bufferPtr in
                 try contiguousData.withUnsafeBytes { dataPtr in
-                    // `nil` 'engine' defaults to the standard implementation with no hooks
-                    let ctx = CCryptoBoringSSL_EVP_PKEY_CTX_new(self.pointer, nil)
-                    defer {
-                        CCryptoBoringSSL_EVP_PKEY_CTX_free(ctx)
-                    }
-
-                    CCryptoBoringSSL_EVP_PKEY_encrypt_init(ctx)
-
-                    switch padding.backing {
-                    case let .pkcs1_oaep(digest):
-                        CCryptoBoringSSL_EVP_PKEY_CTX_set_rsa_padding(ctx, RSA_PKCS1_OAEP_PADDING)
-                        switch digest {
-                        case .sha1:
-                            break // default case, nothing to set
-                        case .sha256:
-                            CCryptoBoringSSL_EVP_PKEY_CTX_set_rsa_oaep_md(ctx, CCryptoBoringSSL_EVP_sha256())
-                        }
-                    }
-
-                    var writtenLength = bufferPtr.count
-                    let rc = CCryptoBoringSSLShims_EVP_PKEY_encrypt(
-                        ctx,
-                        bufferPtr.baseAddress,
+                    var writtenLength = 0
+                    let rc = CCryptoBoringSSLShims_RSA_encrypt_oaep(
+                        rsaPublicKey,
                         &writtenLength,
+                        bufferPtr.baseAddress,
+                        bufferPtr.count,
                         dataPtr.baseAddress,
-                        dataPtr.count
+                        dataPtr.count,
+                        padding.oaepDigest
                     )
-                    precondition(writtenLength == bufferPtr.count, "PKEY encrypt actual written length should match RSA key size.")
-
                     guard rc == 1 else {
                         throw CryptoKitError.internalBoringSSLError()
                     }
+                    precondition(writtenLength == bufferPtr.count, "RSA encrypt actual written length should match RSA key size.")
                 }
             }
             return output
@@ -332,6 +448,19 @@ extension BoringSSLRSAPrivateKey {
         }
 
         fileprivate init(pemRepresentation: String) throws {
+            // As for public keys, well-formed documents are parsed in place and anything else goes to BoringSSL's
+            // PEM reader, which also handles encrypted documents.
+            if let document = try? ASN1.PEMDocument(pemString: pemRepresentation),
+               document.type == _RSA.PKCS8KeyType || document.type == _RSA.PKCS1KeyType {
+                guard let rsaPrivateKey = Backing.pkcs8DERPrivateKey(document.derBytes) ??
+                        Backing.pkcs1DERPrivateKey(document.derBytes) else {
+                    throw CryptoKitError.internalBoringSSLError()
+                }
+                self.pointer = CCryptoBoringSSL_EVP_PKEY_new()
+                CCryptoBoringSSL_EVP_PKEY_assign_RSA(self.pointer, rsaPrivateKey)
+                return
+            }
+
             var pemRepresentation = pemRepresentation
             self.pointer = CCryptoBoringSSL_EVP_PKEY_new()
 
@@ -371,30 +500,13 @@ extension BoringSSLRSAPrivateKey {
 
         private static func pkcs8DERPrivateKey<Bytes: ContiguousBytes>(_ derRepresentation: Bytes) -> OpaquePointer? {
             return derRepresentation.withUnsafeBytes { derPtr in
-                return BIOHelper.withReadOnlyMemoryBIO(wrapping: derPtr) { bio in
-                    guard let p8 = CCryptoBoringSSL_d2i_PKCS8_PRIV_KEY_INFO_bio(bio, nil) else {
-                        return nil
-                    }
-                    defer {
-                        CCryptoBoringSSL_PKCS8_PRIV_KEY_INFO_free(p8)
-                    }
-
-                    guard let pkey = CCryptoBoringSSL_EVP_PKCS82PKEY(p8) else {
-                        return nil
-                    }
-                    defer {
-                        CCryptoBoringSSL_EVP_PKEY_free(pkey)
-                    }
-                    return CCryptoBoringSSL_EVP_PKEY_get1_RSA(pkey)
-                }
+                CCryptoBoringSSLShims_RSA_parse_pkcs8_buffer(derPtr.bindMemory(to: UInt8.self).baseAddress, derPtr.count)
             }
         }
 
         private static func pkcs1DERPrivateKey<Bytes: ContiguousBytes>(_ derRepresentation: Bytes) -> OpaquePointer? {
             return derRepresentation.withUnsafeBytes { derPtr in
-                return BIOHelper.withReadOnlyMemoryBIO(wrapping: derPtr) { bio in
-                    return CCryptoBoringSSL_d2i_RSAPrivateKey_bio(bio, nil)
-                }
+                CCryptoBoringSSLShims_RSA_parse_private_key_buffer(derPtr.bindMemory(to: UInt8.self).baseAddress, derPtr.count)
             }
         }
 
@@ -421,13 +533,81 @@ extension BoringSSLRSAPrivateKey {
             }
         }
 
-        fileprivate var derRepresentation: Data {
-            return BIOHelper.withWritableMemoryBIO { bio in
-                let rsaPrivateKey = CCryptoBoringSSL_EVP_PKEY_get0_RSA(self.pointer)
-                let rc = CCryptoBoringSSL_i2d_RSAPrivateKey_bio(bio, rsaPrivateKey)
-                precondition(rc == 1)
+        fileprivate init(keySize: _RSA.Signing.KeySize, concurrency: Int) throws {
+            let race = KeyGenerationRace()
+            DispatchQueue.concurrentPerform(iterations: concurrency) { _ in
+                Backing.generateKey(keySize: keySize, racing: race)
+            }
 
-                return try! Data(copyingMemoryBIO: bio)
+            guard let pointer = race.winner else {
+                throw CryptoKitError.internalBoringSSLError()
+            }
+
+            self.pointer = CCryptoBoringSSL_EVP_PKEY_new()
+            CCryptoBoringSSL_EVP_PKEY_assign_RSA(self.pointer, pointer)
+        }
+
+        fileprivate init(keySize: _RSA.Signing.KeySize, cancellation: _CryptoCancellation) throws {
+            let pointer = CCryptoBoringSSL_RSA_new()!
+
+            // BoringSSL invokes the callback throughout the prime search, and abandons the search if it returns 0.
+            var callback = BN_GENCB()
+            CCryptoBoringSSL_BN_GENCB_set(&callback, { _, _, callback in
+                let cancellation = Unmanaged<_CryptoCancellation>.fromOpaque(callback!.pointee.arg).takeUnretainedValue()
+                return cancellation.isCancelled ? 0 : 1
+            }, Unmanaged.passUnretained(cancellation).toOpaque())
+
+            let rc = withExtendedLifetime(cancellation) {
+                RSA_F4.withBignumPointer { bignumPtr in
+                    CCryptoBoringSSL_RSA_generate_key_ex(
+                        pointer, CInt(keySize.bitCount), bignumPtr, &callback
+                    )
+                }
+            }
+
+            guard rc == 1 else {
+                CCryptoBoringSSL_RSA_free(pointer)
+                if cancellation.isCancelled {
+                    CCryptoBoringSSL_ERR_clear_error()
+                    throw CancellationError()
+                }
+                throw CryptoKitError.internalBoringSSLError()
+            }
+
+            self.pointer = CCryptoBoringSSL_EVP_PKEY_new()
+            CCryptoBoringSSL_EVP_PKEY_assign_RSA(self.pointer, pointer)
+        }
+
+        private static func generateKey(keySize: _RSA.Signing.KeySize, racing race: KeyGenerationRace) {
+            let pointer = CCryptoBoringSSL_RSA_new()!
+
+            // BoringSSL invokes the callback throughout the prime search, and abandons the search if it returns 0.
+            var callback = BN_GENCB()
+            CCryptoBoringSSL_BN_GENCB_set(&callback, { _, _, callback in
+                let race = Unmanaged<KeyGenerationRace>.fromOpaque(callback!.pointee.arg).takeUnretainedValue()
+                return race.isFinished ? 0 : 1
+            }, Unmanaged.passUnretained(race).toOpaque())
+
+            let rc = withExtendedLifetime(race) {
+                RSA_F4.withBignumPointer { bignumPtr in
+                    CCryptoBoringSSL_RSA_generate_key_ex(
+                        pointer, CInt(keySize.bitCount), bignumPtr, &callback
+                    )
+                }
+            }
+
+            guard rc == 1, race.offer(pointer) else {
+                // Losing searches leave an error on this thread's queue; don't let it leak into later operations.
+                CCryptoBoringSSL_RSA_free(pointer)
+                CCryptoBoringSSL_ERR_clear_error()
+                return
+            }
+        }
+
+        fileprivate var derRepresentation: Data {
+            let rsaPrivateKey = CCryptoBoringSSL_EVP_PKEY_get0_RSA(self.pointer)
+            return Data(marshallingExactly: CCryptoBoringSSLShims_RSA_private_key_der_size(rsaPrivateKey)) {
+                CCryptoBoringSSLShims_RSA_marshal_private_key_fixed($0, $1, rsaPrivateKey)
             }
         }
 
@@ -471,7 +651,11 @@ extension BoringSSLRSAPrivateKey {
             return BoringSSLRSAPublicKey(backing)
         }
 
-        fileprivate func signature<D: Digest>(for digest: D, padding: _RSA.Signing.Padding) throws -> _RSA.Signing.RSASignature {
+        fileprivate func signature<D: Digest>(
+            for digest: D,
+            padding: _RSA.Signing.Padding,
+            parallelCRT: Bool
+        ) throws -> _RSA.Signing.RSASignature {
             let rsaPrivateKey = CCryptoBoringSSL_EVP_PKEY_get0_RSA(self.pointer)
             let hashDigestType = try DigestType(forDigestType: D.self)
             let outputSize = Int(CCryptoBoringSSL_RSA_size(rsaPrivateKey))
@@ -482,8 +666,11 @@ extension BoringSSLRSAPrivateKey {
                 let rc: CInt = digest.withUnsafeBytes { digestPtr in
                     switch padding.backing {
                     case .pkcs1v1_5:
+                        let sign = parallelCRT
+                            ? CCryptoBoringSSLShims_RSA_sign_parallel_crt
+                            : CCryptoBoringSSLShims_RSA_sign
                         var writtenLength = CUnsignedInt(0)
-                        let rc = CCryptoBoringSSLShims_RSA_sign(
+                        let rc = sign(
                             hashDigestType.nid,
                             digestPtr.baseAddress,
                             CUnsignedInt(digestPtr.count),
@@ -494,7 +681,10 @@ extension BoringSSLRSAPrivateKey {
                         outputLength = Int(writtenLength)
                         return rc
                     case .pss:
-                        return CCryptoBoringSSLShims_RSA_sign_pss_mgf1(
+                        let sign = parallelCRT
+                            ? CCryptoBoringSSLShims_RSA_sign_pss_mgf1_parallel_crt
+                            : CCryptoBoringSSLShims_RSA_sign_pss_mgf1
+                        return sign(
                             rsaPrivateKey,
                             &outputLength,
                             bufferPtr.baseAddress,
@@ -522,45 +712,26 @@ extension BoringSSLRSAPrivateKey {
             var output = Data(count: outputSize)
 
             let contiguousData: ContiguousBytes = data.regions.count == 1 ? data.regions.first! : Array(data)
-            let writtenLength: CInt = try output.withUnsafeMutableBytes { bufferPtr in
+            let writtenLength: Int = try output.withUnsafeMutableBytes { bufferPtr in
                 try contiguousData.withUnsafeBytes { dataPtr in
-                    let ctx = CCryptoBoringSSL_EVP_PKEY_CTX_new(self.pointer, nil)
-                    defer {
-                        CCryptoBoringSSL_EVP_PKEY_CTX_free(ctx)
-                    }
-
-                    CCryptoBoringSSL_EVP_PKEY_decrypt_init(ctx)
-                    switch padding.backing {
-                    case let .pkcs1_oaep(digest):
-                        CCryptoBoringSSL_EVP_PKEY_CTX_set_rsa_padding(ctx, RSA_PKCS1_OAEP_PADDING)
-                        switch digest {
-                        case .sha1:
-                            break // default case, nothing to set
-                        case .sha256:
-                            CCryptoBoringSSL_EVP_PKEY_CTX_set_rsa_oaep_md(ctx, CCryptoBoringSSL_EVP_sha256())
-                        }
-                    }
-
-
-                    var writtenLength = bufferPtr.count
-
-                    let rc = CCryptoBoringSSLShims_EVP_PKEY_decrypt(
-                        ctx,
-                        bufferPtr.baseAddress,
+                    var writtenLength = 0
+                    let rc = CCryptoBoringSSLShims_RSA_decrypt_oaep(
+                        rsaPrivateKey,
                         &writtenLength,
+                        bufferPtr.baseAddress,
+                        bufferPtr.count,
                         dataPtr.baseAddress,
-                        dataPtr.count
+                        dataPtr.count,
+                        padding.oaepDigest
                     )
-
                     guard rc == 1 else {
                         throw CryptoKitError.internalBoringSSLError()
                     }
-
-                    return CInt(writtenLength)
+                    return writtenLength
                 }
             }
 
-            output.removeSubrange(output.index(output.startIndex, offsetBy: Int(writtenLength)) ..< output.endIndex)
+            output.removeSubrange(output.index(output.startIndex, offsetBy: writtenLength) ..< output.endIndex)
             return output
         }
 
@@ -569,4 +740,53 @@ extension BoringSSLRSAPrivateKey {
         }
     }
 }
+
+extension _RSA.Encryption.Padding {
+    /// The digest used for both the OAEP label hash and MGF1.
+    fileprivate var oaepDigest: OpaquePointer {
+        switch self.backing {
+        case .pkcs1_oaep(.sha1):
+            return CCryptoBoringSSL_EVP_sha1()
+        case .pkcs1_oaep(.sha256):
+            return CCryptoBoringSSL_EVP_sha256()
+        }
+    }
+}
+
+/// Collects the first key produced by a set of concurrent key generation attempts.
+private final class KeyGenerationRace: @unchecked Sendable {
+    private let lock = NSLock()
+
+    // Protected by `lock`.
+    private var _winner: OpaquePointer? = nil
+
+    var isFinished: Bool {
+        self.lock.lock()
+        defer {
+            self.lock.unlock()
+        }
+        return self._winner != nil
+    }
+
+    var winner: OpaquePointer? {
+        self.lock.lock()
+        defer {
+            self.lock.unlock()
+        }
+        return self._winner
+    }
+
+    /// Records `key` as the winner if no other attempt has finished yet. Returns `false` if the caller still owns `key`.
+    func offer(_ key: OpaquePointer) -> Bool {
+        self.lock.lock()
+        defer {
+            self.lock.unlock()
+        }
+        guard self._winner == nil else {
+            return false
+        }
+        self._winner = key
+        return true
+    }
+}
 #endif
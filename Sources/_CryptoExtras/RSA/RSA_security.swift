@@ -65,6 +65,19 @@ internal struct SecurityRSAPublicKey: @unchecked Sendable {
         SecKeyGetBlockSize(self.backing) * 8
     }
 
+    func prepare() {
+        // Security.framework manages any per-key state itself; there is nothing to set up ahead of time.
+    }
+
+    var montgomeryRR: (rr: Data, rBits: UInt32)? {
+        // Security.framework doesn't expose its per-key state.
+        nil
+    }
+
+    func setMontgomeryRR(_ rr: UnsafeRawBufferPointer, rBits: UInt32) {
+        // Nothing to do.
+    }
+
     fileprivate init(_ backing: SecKey) {
         self.backing = backing
     }
@@ -118,6 +131,17 @@ internal struct SecurityRSAPrivateKey: @unchecked Sendable {
         self.backing = unwrappedKey
     }
 
+    init(keySize: _RSA.Signing.KeySize, concurrency: Int) throws {
+        // Security.framework generates keys itself; there is no search to parallelise.
+        try self.init(keySize: keySize)
+    }
+
+    init(keySize: _RSA.Signing.KeySize, cancellation: _CryptoCancellation) throws {
+        // Security.framework offers no way to interrupt key generation, so it can only be cancelled before it starts.
+        try cancellation.checkCancellation()
+        try self.init(keySize: keySize)
+    }
+
     init(keySize: _RSA.Signing.KeySize) throws {
         let keyAttributes: [CFString: Any] = [
             kSecAttrKeyType: kSecAttrKeyTypeRSA,
@@ -162,6 +186,16 @@ internal struct SecurityRSAPrivateKey: @unchecked Sendable {
     var publicKey: SecurityRSAPublicKey {
         SecurityRSAPublicKey(SecKeyCopyPublicKey(self.backing)!)
     }
+
+    func withSigningShards(_ shardCount: Int) -> SecurityRSAPrivateKey {
+        // Security.framework does its own blinding, so there is nothing to shard.
+        return self
+    }
+
+    func withParallelCRT() -> SecurityRSAPrivateKey {
+        // Security.framework schedules its own private key operations.
+        return self
+    }
 }
 
 extension SecurityRSAPrivateKey {
@@ -212,6 +246,10 @@ extension SecurityRSAPublicKey {
             return false
         }
     }
+
+    func areValidSignatures<D: Digest>(_ signatures: [_RSA.Signing.RSASignature], for digests: [D], padding: _RSA.Signing.Padding) -> [Bool] {
+        return zip(signatures, digests).map { self.isValidSignature($0, for: $1, padding: padding) }
+    }
 }
 
 extension SecurityRSAPublicKey {
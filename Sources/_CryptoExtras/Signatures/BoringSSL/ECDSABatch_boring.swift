@@ -0,0 +1,122 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+import Crypto
+import Foundation
+
+enum OpenSSLECDSABatchImpl {
+    enum Curve {
+        case p256
+        case p384
+
+        var nid: CInt {
+            switch self {
+            case .p256:
+                return NID_X9_62_prime256v1
+            case .p384:
+                return NID_secp384r1
+            }
+        }
+    }
+
+    static func isValidSignatures(_ rawSignatures: [Data], for digests: [Data], publicKeyX963Representation: Data, curve: Curve) -> [Bool] {
+        precondition(rawSignatures.count == digests.count)
+        guard !rawSignatures.isEmpty else {
+            return []
+        }
+
+        // The public key has already been validated by Crypto, so failures here are internal errors.
+        let key = CCryptoBoringSSL_EC_KEY_new_by_curve_name(curve.nid)!
+        defer {
+            CCryptoBoringSSL_EC_KEY_free(key)
+        }
+        let rc = publicKeyX963Representation.withUnsafeBytes { keyBytes in
+            CCryptoBoringSSL_EC_KEY_oct2key(key, keyBytes.bindMemory(to: UInt8.self).baseAddress, keyBytes.count, nil)
+        }
+        precondition(rc == 1, "Unable to decode a valid public key")
+
+        // Gather everything BoringSSL needs into a single buffer, so that all of it can be pinned at once.
+        var storage = [UInt8]()
+        storage.reserveCapacity(zip(rawSignatures, digests).reduce(0) { $0 + $1.0.count + $1.1.count })
+        for (signature, digest) in zip(rawSignatures, digests) {
+            storage.append(contentsOf: signature)
+            storage.append(contentsOf: digest)
+        }
+
+        var results = [CInt](repeating: 0, count: rawSignatures.count)
+        storage.withUnsafeBytes { storage in
+            var offset = 0
+            let ops = zip(rawSignatures, digests).map { signature, digest in
+                defer { offset += signature.count + digest.count }
+                return CCryptoBoringSSLShims_ECDSA_verify_batch_op(
+                    digest: storage.baseAddress! + offset + signature.count,
+                    digest_len: digest.count,
+                    signature: storage.baseAddress! + offset,
+                    signature_len: signature.count
+                )
+            }
+
+            ops.withUnsafeBufferPointer { opsPointer in
+                results.withUnsafeMutableBufferPointer { resultsPointer in
+                    _ = CCryptoBoringSSLShims_ECDSA_verify_batch(key, opsPointer.baseAddress, opsPointer.count, resultsPointer.baseAddress)
+                }
+            }
+        }
+
+        return results.map { $0 == 1 }
+    }
+}
+
+extension OpenSSLECDSABatchImpl {
+    static func signatures(for digests: [Data], rawPrivateKey: Data, curve: Curve) throws -> [Data] {
+        guard let digestLength = digests.first?.count else {
+            return []
+        }
+        precondition(digests.allSatisfy { $0.count == digestLength }, "Every digest must be the same length")
+
+        var digestStorage = [UInt8]()
+        digestStorage.reserveCapacity(digestLength * digests.count)
+        for digest in digests {
+            digestStorage.append(contentsOf: digest)
+        }
+
+        // The raw private key is exactly as wide as the group order, and each signature is twice that.
+        let signatureLength = 2 * rawPrivateKey.count
+        var signatureStorage = [UInt8](repeating: 0, count: signatureLength * digests.count)
+        let rc = rawPrivateKey.withUnsafeBytes { keyBytes in
+            digestStorage.withUnsafeBytes { digestBytes in
+                signatureStorage.withUnsafeMutableBytes { signatureBytes in
+                    CCryptoBoringSSLShims_ecdsa_sign_batch(
+                        signatureBytes.baseAddress,
+                        curve.nid,
+                        keyBytes.baseAddress,
+                        keyBytes.count,
+                        digestBytes.baseAddress,
+                        digestLength,
+                        digests.count
+                    )
+                }
+            }
+        }
+        guard rc == 1 else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+
+        return (0..<digests.count).map { index in
+            Data(signatureStorage[(index * signatureLength)..<((index + 1) * signatureLength)])
+        }
+    }
+}
@@ -0,0 +1,206 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+import Crypto
+import Dispatch
+import Foundation
+
+/// A stock of ECDSA presignatures for one private key, topped up in the background.
+///
+/// Each presignature is handed out exactly once: it is removed from the stock and wiped under the lock, and the
+/// shim wipes the caller's copy once the signature is complete.
+///
+/// A `fork` copies the stock into the child, and if both processes used it they would sign different messages with
+/// the same nonces, which reveals the private key. The stock is therefore tagged with BoringSSL's fork generation and
+/// thrown away when that changes. Where forks can't be detected, nothing is stocked and every presignature is made
+/// inline.
+final class OpenSSLECDSAPresignaturePool: @unchecked Sendable {
+    typealias Curve = OpenSSLECDSABatchImpl.Curve
+
+    private let curve: Curve
+
+    private let privateKey: UnsafeMutableRawBufferPointer
+
+    private let capacity: Int
+
+    private let lock = NSLock()
+
+    // Protected by `lock`. The first `available` entries hold unused presignatures.
+    private let presignatures: UnsafeMutablePointer<CCryptoBoringSSLShims_ecdsa_presignature>
+
+    // Protected by `lock`.
+    private var available = 0
+
+    // Protected by `lock`. Whether a replenishment task is queued or running.
+    private var replenishing = false
+
+    // Protected by `lock`. The fork generation the stock was made in.
+    private var generation: UInt64
+
+    private let replenishmentQueue = DispatchQueue.global(qos: .utility)
+
+    init(curve: Curve, rawPrivateKey: Data, capacity: Int) {
+        precondition(capacity > 0)
+        self.curve = curve
+        self.capacity = capacity
+
+        self.privateKey = .allocate(byteCount: rawPrivateKey.count, alignment: 1)
+        rawPrivateKey.withUnsafeBytes { self.privateKey.copyMemory(from: $0) }
+
+        self.presignatures = .allocate(capacity: capacity)
+        self.presignatures.initialize(repeating: CCryptoBoringSSLShims_ecdsa_presignature(), count: capacity)
+        self.generation = CCryptoBoringSSLShims_fork_generation()
+
+        self.scheduleReplenishmentIfNeeded()
+    }
+
+    deinit {
+        CCryptoBoringSSL_OPENSSL_cleanse(self.privateKey.baseAddress, self.privateKey.count)
+        CCryptoBoringSSL_OPENSSL_cleanse(self.presignatures, self.capacity * MemoryLayout<CCryptoBoringSSLShims_ecdsa_presignature>.stride)
+        self.privateKey.deallocate()
+        self.presignatures.deallocate()
+    }
+
+    /// Whether the pool can keep a stock, which needs BoringSSL to detect forks.
+    static var isStockingSupported: Bool {
+        CCryptoBoringSSLShims_fork_generation() != 0
+    }
+
+    var availablePresignatures: Int {
+        self.lock.lock()
+        defer {
+            self.lock.unlock()
+        }
+        return self.stockIsUsable() ? self.available : 0
+    }
+
+    /// Signs `digest`, using a stored presignature if there is one and generating one inline otherwise.
+    func signature(for digest: UnsafeRawBufferPointer) throws -> Data {
+        var signature = Data(repeating: 0, count: 2 * self.privateKey.count)
+        for _ in 0..<8 {
+            var presignature = try self.takePresignature()
+            var signatureLength = 0
+            let rc = signature.withUnsafeMutableBytes { signaturePtr in
+                CCryptoBoringSSLShims_ecdsa_sign_presigned(
+                    signaturePtr.baseAddress,
+                    &signatureLength,
+                    self.curve.nid,
+                    self.privateKey.baseAddress,
+                    self.privateKey.count,
+                    digest.baseAddress,
+                    digest.count,
+                    &presignature
+                )
+            }
+            if rc == 1 {
+                precondition(signatureLength == signature.count)
+                return signature
+            }
+            // s = 0 happens with negligible probability; try again with a fresh presignature.
+        }
+        throw CryptoKitError.internalBoringSSLError()
+    }
+
+    private func takePresignature() throws -> CCryptoBoringSSLShims_ecdsa_presignature {
+        var presignature = CCryptoBoringSSLShims_ecdsa_presignature()
+
+        self.lock.lock()
+        let tookOne = self.stockIsUsable() && self.available > 0
+        if tookOne {
+            self.available -= 1
+            presignature = self.presignatures[self.available]
+            CCryptoBoringSSL_OPENSSL_cleanse(self.presignatures + self.available, MemoryLayout<CCryptoBoringSSLShims_ecdsa_presignature>.size)
+        }
+        self.lock.unlock()
+
+        self.scheduleReplenishmentIfNeeded()
+
+        if !tookOne {
+            presignature = try self.makePresignature()
+        }
+        return presignature
+    }
+
+    private func makePresignature() throws -> CCryptoBoringSSLShims_ecdsa_presignature {
+        var presignature = CCryptoBoringSSLShims_ecdsa_presignature()
+        guard CCryptoBoringSSLShims_ecdsa_presign(&presignature, self.curve.nid, self.privateKey.baseAddress, self.privateKey.count) == 1 else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+        return presignature
+    }
+
+    /// Throws the stock away if the process has forked since it was made, and returns whether a stock may be kept
+    /// at all. Must be called with `lock` held.
+    private func stockIsUsable() -> Bool {
+        let generation = CCryptoBoringSSLShims_fork_generation()
+        guard generation != self.generation else {
+            return generation != 0
+        }
+        CCryptoBoringSSL_OPENSSL_cleanse(self.presignatures, self.capacity * MemoryLayout<CCryptoBoringSSLShims_ecdsa_presignature>.stride)
+        self.available = 0
+        self.generation = generation
+        // Only the forking thread exists in the child, so a refill that was running in the parent isn't here.
+        self.replenishing = false
+        return generation != 0
+    }
+
+    /// Starts a background refill once the stock falls to half of capacity.
+    private func scheduleReplenishmentIfNeeded() {
+        self.lock.lock()
+        let shouldStart = self.stockIsUsable() && !self.replenishing && self.available <= self.capacity / 2
+        if shouldStart {
+            self.replenishing = true
+        }
+        self.lock.unlock()
+
+        if shouldStart {
+            self.replenishmentQueue.async { [weak self] in
+                self?.replenish()
+            }
+        }
+    }
+
+    private func replenish() {
+        while true {
+            // The expensive part happens outside the lock, so signers are never held up by it.
+            let generation = CCryptoBoringSSLShims_fork_generation()
+            var presignature: CCryptoBoringSSLShims_ecdsa_presignature
+            do {
+                presignature = try self.makePresignature()
+            } catch {
+                break
+            }
+
+            self.lock.lock()
+            // A presignature made before a fork belongs to the stock that the fork invalidated.
+            let usable = self.stockIsUsable() && generation == self.generation
+            if usable && self.available < self.capacity {
+                self.presignatures[self.available] = presignature
+                self.available += 1
+            }
+            let done = !usable || self.available == self.capacity
+            self.lock.unlock()
+
+            CCryptoBoringSSL_OPENSSL_cleanse(&presignature, MemoryLayout<CCryptoBoringSSLShims_ecdsa_presignature>.size)
+            if done {
+                break
+            }
+        }
+
+        self.lock.lock()
+        self.replenishing = false
+        self.lock.unlock()
+    }
+}
@@ -0,0 +1,114 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+import Crypto
+import Foundation
+
+enum OpenSSLEd25519BatchImpl {
+    static let signatureByteCount = 64
+    static let publicKeyByteCount = 32
+    static let seedByteCount = 32
+
+    static func isValidSignatures(_ items: [Curve25519.Signing._BatchVerificationItem]) -> [Bool] {
+        // Signatures of the wrong length can never be valid, so they never make it to BoringSSL.
+        let candidates = items.indices.filter { items[$0].signature.count == Self.signatureByteCount }
+
+        // Gather everything BoringSSL needs into a single buffer, so that all of it can be pinned at once.
+        // Copying the inputs is cheap compared to the verification itself.
+        var storage = [UInt8]()
+        storage.reserveCapacity(candidates.reduce(0) { $0 + items[$1].data.count + Self.signatureByteCount + Self.publicKeyByteCount })
+        var offsets = [Int]()
+        offsets.reserveCapacity(candidates.count)
+        for index in candidates {
+            offsets.append(storage.count)
+            storage.append(contentsOf: items[index].signature)
+            storage.append(contentsOf: items[index].publicKey.rawRepresentation)
+            storage.append(contentsOf: items[index].data)
+        }
+
+        var results = [CInt](repeating: 0, count: candidates.count)
+        storage.withUnsafeBytes { storage in
+            let ops = zip(candidates, offsets).map { index, offset in
+                let signature = storage.baseAddress! + offset
+                let publicKey = signature + Self.signatureByteCount
+                return CCryptoBoringSSLShims_ED25519_verify_batch_op(
+                    message: publicKey + Self.publicKeyByteCount,
+                    message_len: items[index].data.count,
+                    signature: signature,
+                    public_key: publicKey
+                )
+            }
+
+            ops.withUnsafeBufferPointer { opsPointer in
+                results.withUnsafeMutableBufferPointer { resultsPointer in
+                    _ = CCryptoBoringSSLShims_ED25519_verify_batch(opsPointer.baseAddress, opsPointer.count, resultsPointer.baseAddress)
+                }
+            }
+        }
+
+        var valid = [Bool](repeating: false, count: items.count)
+        for (index, result) in zip(candidates, results) {
+            valid[index] = result == 1
+        }
+        return valid
+    }
+
+    static func signatures(for items: [Curve25519.Signing._BatchSigningItem]) -> [Data] {
+        guard !items.isEmpty else {
+            return []
+        }
+
+        // As for verification, pin everything at once. The seeds are wiped once the batch is signed.
+        let entryByteCount = Self.seedByteCount + Self.publicKeyByteCount
+        var storage = [UInt8]()
+        storage.reserveCapacity(items.reduce(0) { $0 + $1.data.count + entryByteCount })
+        var offsets = [Int]()
+        offsets.reserveCapacity(items.count)
+        for item in items {
+            offsets.append(storage.count)
+            storage.append(contentsOf: item.privateKey.rawRepresentation)
+            storage.append(contentsOf: item.privateKey.publicKey.rawRepresentation)
+            storage.append(contentsOf: item.data)
+        }
+        defer {
+            storage.withUnsafeMutableBytes { CCryptoBoringSSL_OPENSSL_cleanse($0.baseAddress, $0.count) }
+        }
+
+        var signatures = [UInt8](repeating: 0, count: items.count * Self.signatureByteCount)
+        storage.withUnsafeBytes { storage in
+            let ops = zip(items, offsets).map { item, offset in
+                let seed = storage.baseAddress! + offset
+                let publicKey = seed + Self.seedByteCount
+                return CCryptoBoringSSLShims_ED25519_sign_batch_op(
+                    message: publicKey + Self.publicKeyByteCount,
+                    message_len: item.data.count,
+                    seed: seed,
+                    public_key: publicKey
+                )
+            }
+
+            ops.withUnsafeBufferPointer { opsPointer in
+                signatures.withUnsafeMutableBytes { signaturesPointer in
+                    CCryptoBoringSSLShims_ED25519_sign_batch(signaturesPointer.baseAddress, opsPointer.baseAddress, opsPointer.count)
+                }
+            }
+        }
+
+        return (0..<items.count).map { index in
+            Data(signatures[(index * Self.signatureByteCount)..<((index + 1) * Self.signatureByteCount)])
+        }
+    }
+}
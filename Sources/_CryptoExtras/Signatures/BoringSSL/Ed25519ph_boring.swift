@@ -0,0 +1,107 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+import Crypto
+import Foundation
+
+enum OpenSSLEd25519phImpl {
+    static let maximumContextByteCount = 255
+    static let signatureByteCount = 64
+
+    static func validatedContext<C: DataProtocol>(_ context: C) throws -> Data {
+        guard context.count <= Self.maximumContextByteCount else {
+            throw CryptoKitError.incorrectParameterSize
+        }
+        return Data(context)
+    }
+
+    static func isValidSignature<S: DataProtocol>(
+        _ signature: S,
+        for digest: SHA512Digest,
+        context: Data,
+        publicKey: Curve25519.Signing.PublicKey
+    ) -> Bool {
+        guard signature.count == Self.signatureByteCount else {
+            return false
+        }
+
+        let signature = Array(signature)
+        let publicKeyBytes = publicKey.rawRepresentation
+        let rc: CInt = digest.withUnsafeBytes { digestPtr in
+            context.withUnsafeBytes { contextPtr in
+                signature.withUnsafeBytes { signaturePtr in
+                    publicKeyBytes.withUnsafeBytes { publicKeyPtr in
+                        CCryptoBoringSSLShims_ED25519ph_verify(digestPtr.baseAddress,
+                                                               contextPtr.baseAddress,
+                                                               contextPtr.count,
+                                                               signaturePtr.baseAddress,
+                                                               publicKeyPtr.baseAddress)
+                    }
+                }
+            }
+        }
+        return rc == 1
+    }
+}
+
+/// An Ed25519 private key in the expanded form Ed25519ph signs with, held in memory that is wiped when the key
+/// is released.
+final class OpenSSLEd25519phPrivateKey {
+    // The 64-byte expanded key followed by the 32-byte public key.
+    private let storage: UnsafeMutableRawBufferPointer
+
+    private static let expandedKeyByteCount = Int(CCryptoBoringSSLShims_ED25519_EXPANDED_KEY_BYTES)
+
+    init(_ privateKey: Curve25519.Signing.PrivateKey) {
+        self.storage = .allocate(byteCount: Self.expandedKeyByteCount + Int(ED25519_PUBLIC_KEY_LEN), alignment: 1)
+
+        var seed = privateKey.rawRepresentation
+        defer {
+            seed.resetBytes(in: 0..<seed.count)
+        }
+        seed.withUnsafeBytes { seedPtr in
+            CCryptoBoringSSLShims_ED25519_expand(self.storage.baseAddress, seedPtr.baseAddress)
+        }
+        privateKey.publicKey.rawRepresentation.withUnsafeBytes { publicKeyPtr in
+            UnsafeMutableRawBufferPointer(rebasing: self.storage[Self.expandedKeyByteCount...]).copyMemory(from: publicKeyPtr)
+        }
+    }
+
+    deinit {
+        CCryptoBoringSSL_OPENSSL_cleanse(self.storage.baseAddress, self.storage.count)
+        self.storage.deallocate()
+    }
+
+    func signature(for digest: SHA512Digest, context: Data) throws -> Data {
+        var signature = Data(repeating: 0, count: OpenSSLEd25519phImpl.signatureByteCount)
+        let rc: CInt = signature.withUnsafeMutableBytes { signaturePtr in
+            digest.withUnsafeBytes { digestPtr in
+                context.withUnsafeBytes { contextPtr in
+                    CCryptoBoringSSLShims_ED25519ph_sign(signaturePtr.baseAddress,
+                                                         digestPtr.baseAddress,
+                                                         contextPtr.baseAddress,
+                                                         contextPtr.count,
+                                                         self.storage.baseAddress,
+                                                         self.storage.baseAddress! + Self.expandedKeyByteCount)
+                }
+            }
+        }
+
+        guard rc == 1 else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+        return signature
+    }
+}
@@ -0,0 +1,140 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+import Crypto
+import Foundation
+
+enum OpenSSLSPHINCSPlusImpl {
+    static let publicKeyByteCount = Int(CCryptoBoringSSLShims_SPX_PUBLIC_KEY_BYTES)
+
+    static let secretKeyByteCount = Int(CCryptoBoringSSLShims_SPX_SECRET_KEY_BYTES)
+
+    static let signatureByteCount = Int(CCryptoBoringSSLShims_SPX_SIGNATURE_BYTES)
+
+    final class SecretKey {
+        private let storage: UnsafeMutableRawBufferPointer
+
+        let publicKey: Data
+
+        private init(storage: UnsafeMutableRawBufferPointer) {
+            self.storage = storage
+            var publicKey = Data(repeating: 0, count: OpenSSLSPHINCSPlusImpl.publicKeyByteCount)
+            publicKey.withUnsafeMutableBytes {
+                CCryptoBoringSSLShims_spx_public_from_secret($0.baseAddress, storage.baseAddress)
+            }
+            self.publicKey = publicKey
+        }
+
+        convenience init() {
+            let storage = UnsafeMutableRawBufferPointer.allocate(byteCount: OpenSSLSPHINCSPlusImpl.secretKeyByteCount, alignment: 1)
+            var publicKey = [UInt8](repeating: 0, count: OpenSSLSPHINCSPlusImpl.publicKeyByteCount)
+            publicKey.withUnsafeMutableBytes {
+                CCryptoBoringSSLShims_spx_generate_key($0.baseAddress, storage.baseAddress)
+            }
+            self.init(storage: storage)
+        }
+
+        convenience init<Bytes: ContiguousBytes>(rawRepresentation: Bytes) throws {
+            let storage = try rawRepresentation.withUnsafeBytes { bytes in
+                guard bytes.count == OpenSSLSPHINCSPlusImpl.secretKeyByteCount else {
+                    throw CryptoKitError.incorrectKeySize
+                }
+                let storage = UnsafeMutableRawBufferPointer.allocate(byteCount: bytes.count, alignment: 1)
+                storage.copyMemory(from: bytes)
+                return storage
+            }
+            self.init(storage: storage)
+        }
+
+        deinit {
+            CCryptoBoringSSL_OPENSSL_cleanse(self.storage.baseAddress, self.storage.count)
+            self.storage.deallocate()
+        }
+
+        var rawRepresentation: Data {
+            Data(self.storage)
+        }
+
+        func signature<D: DataProtocol>(for data: D, randomized: Bool, concurrently: Bool) -> Data {
+            let message = Array(data)
+            var signature = Data(repeating: 0, count: OpenSSLSPHINCSPlusImpl.signatureByteCount)
+            signature.withUnsafeMutableBytes { signature in
+                message.withUnsafeBytes { message in
+                    if concurrently {
+                        self.concurrentSignature(for: message, randomized: randomized, into: signature)
+                    } else {
+                        CCryptoBoringSSLShims_spx_sign(signature.baseAddress, self.storage.baseAddress, message.baseAddress, message.count, randomized ? 1 : 0)
+                    }
+                }
+            }
+            return signature
+        }
+
+        /// Signs with the independent authentication-path subtrees computed across all available cores.
+        private func concurrentSignature(for message: UnsafeRawBufferPointer, randomized: Bool, into signature: UnsafeMutableRawBufferPointer) {
+            let secretKey = UnsafeRawPointer(self.storage.baseAddress)
+            let output = signature.baseAddress
+            var state = CCryptoBoringSSLShims_spx_signing_state()
+            CCryptoBoringSSLShims_spx_sign_begin(&state, output, secretKey, message.baseAddress, message.count, randomized ? 1 : 0)
+
+            let taskCount = CCryptoBoringSSLShims_spx_sign_task_count()
+            withUnsafePointer(to: state) { state in
+                DispatchQueue.concurrentPerform(iterations: taskCount) { task in
+                    CCryptoBoringSSLShims_spx_sign_task(state, output, secretKey, task)
+                }
+            }
+
+            CCryptoBoringSSLShims_spx_sign_finish(&state, output, secretKey)
+        }
+
+        /// Signs one authentication-path subtree at a time, checking `cancellation` between them.
+        func signature<D: DataProtocol>(for data: D, randomized: Bool, cancellation: _CryptoCancellation) throws -> Data {
+            let message = Array(data)
+            var signature = Data(repeating: 0, count: OpenSSLSPHINCSPlusImpl.signatureByteCount)
+            try signature.withUnsafeMutableBytes { signature in
+                try message.withUnsafeBytes { message in
+                    let secretKey = UnsafeRawPointer(self.storage.baseAddress)
+                    let output = signature.baseAddress
+                    var state = CCryptoBoringSSLShims_spx_signing_state()
+                    CCryptoBoringSSLShims_spx_sign_begin(&state, output, secretKey, message.baseAddress, message.count, randomized ? 1 : 0)
+
+                    for task in 0..<CCryptoBoringSSLShims_spx_sign_task_count() {
+                        try cancellation.checkCancellation()
+                        CCryptoBoringSSLShims_spx_sign_task(&state, output, secretKey, task)
+                    }
+
+                    CCryptoBoringSSLShims_spx_sign_finish(&state, output, secretKey)
+                }
+            }
+            return signature
+        }
+    }
+
+    static func isValidSignature<S: DataProtocol, D: DataProtocol>(_ signature: S, for data: D, publicKey: Data) -> Bool {
+        guard signature.count == Self.signatureByteCount else {
+            return false
+        }
+        let signature = Array(signature)
+        let message = Array(data)
+        return signature.withUnsafeBytes { signature in
+            message.withUnsafeBytes { message in
+                publicKey.withUnsafeBytes { publicKey in
+                    CCryptoBoringSSLShims_spx_verify(signature.baseAddress, publicKey.baseAddress, message.baseAddress, message.count) == 1
+                }
+            }
+        }
+    }
+}
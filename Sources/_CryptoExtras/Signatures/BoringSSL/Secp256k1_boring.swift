@@ -0,0 +1,196 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+import Crypto
+import Foundation
+
+enum OpenSSLSecp256k1Impl {
+    static let scalarByteCount = 32
+
+    static let rawPublicKeyByteCount = 64
+
+    static let rawSignatureByteCount = 64
+
+    final class PrivateKey {
+        private let storage: UnsafeMutableRawBufferPointer
+
+        let publicKey: Data
+
+        private init(validatedStorage storage: UnsafeMutableRawBufferPointer) {
+            self.storage = storage
+            var publicKey = Data(repeating: 0, count: OpenSSLSecp256k1Impl.rawPublicKeyByteCount)
+            let rc = publicKey.withUnsafeMutableBytes {
+                CCryptoBoringSSLShims_secp256k1_public_key($0.baseAddress, storage.baseAddress)
+            }
+            precondition(rc == 1, "Unable to derive the public key of a valid private key")
+            self.publicKey = publicKey
+        }
+
+        convenience init() {
+            let storage = UnsafeMutableRawBufferPointer.allocate(byteCount: OpenSSLSecp256k1Impl.scalarByteCount, alignment: 1)
+            let rc = CCryptoBoringSSLShims_secp256k1_generate_key(storage.baseAddress)
+            precondition(rc == 1, "Unable to generate a secp256k1 key")
+            self.init(validatedStorage: storage)
+        }
+
+        convenience init<Bytes: ContiguousBytes>(rawRepresentation: Bytes) throws {
+            let storage = try rawRepresentation.withUnsafeBytes { bytes in
+                guard bytes.count == OpenSSLSecp256k1Impl.scalarByteCount else {
+                    throw CryptoKitError.incorrectKeySize
+                }
+                var publicKey = [UInt8](repeating: 0, count: OpenSSLSecp256k1Impl.rawPublicKeyByteCount)
+                guard CCryptoBoringSSLShims_secp256k1_public_key(&publicKey, bytes.baseAddress) == 1 else {
+                    throw CryptoKitError.invalidParameter
+                }
+                let storage = UnsafeMutableRawBufferPointer.allocate(byteCount: bytes.count, alignment: 1)
+                storage.copyMemory(from: bytes)
+                return storage
+            }
+            self.init(validatedStorage: storage)
+        }
+
+        deinit {
+            CCryptoBoringSSL_OPENSSL_cleanse(self.storage.baseAddress, self.storage.count)
+            self.storage.deallocate()
+        }
+
+        var rawRepresentation: Data {
+            Data(self.storage)
+        }
+
+        func signature(for digest: UnsafeRawBufferPointer) throws -> Data {
+            var signature = Data(repeating: 0, count: OpenSSLSecp256k1Impl.rawSignatureByteCount)
+            let rc = signature.withUnsafeMutableBytes { signature in
+                CCryptoBoringSSLShims_secp256k1_sign(signature.baseAddress, self.storage.baseAddress, digest.baseAddress, digest.count)
+            }
+            guard rc == 1 else {
+                throw CryptoKitError.internalBoringSSLError()
+            }
+            return signature
+        }
+    }
+
+    /// Checks that `rawRepresentation` is a point on the curve.
+    static func validatePublicKey(_ rawRepresentation: Data) throws {
+        guard rawRepresentation.count == Self.rawPublicKeyByteCount else {
+            throw CryptoKitError.incorrectKeySize
+        }
+        let rc = rawRepresentation.withUnsafeBytes {
+            CCryptoBoringSSLShims_secp256k1_public_key_is_valid($0.baseAddress)
+        }
+        guard rc == 1 else {
+            throw CryptoKitError.invalidParameter
+        }
+    }
+
+    static func decompress(_ compressedRepresentation: Data) throws -> Data {
+        guard compressedRepresentation.count == Self.scalarByteCount + 1 else {
+            throw CryptoKitError.incorrectKeySize
+        }
+        var rawRepresentation = Data(repeating: 0, count: Self.rawPublicKeyByteCount)
+        let rc = rawRepresentation.withUnsafeMutableBytes { raw in
+            compressedRepresentation.withUnsafeBytes { compressed in
+                CCryptoBoringSSLShims_secp256k1_decompress(raw.baseAddress, compressed.baseAddress)
+            }
+        }
+        guard rc == 1 else {
+            throw CryptoKitError.invalidParameter
+        }
+        return rawRepresentation
+    }
+
+    static func isValidSignature(_ rawSignature: Data, for digest: UnsafeRawBufferPointer, publicKey: Data) -> Bool {
+        publicKey.withUnsafeBytes { publicKey in
+            rawSignature.withUnsafeBytes { signature in
+                CCryptoBoringSSLShims_secp256k1_verify(
+                    publicKey.baseAddress,
+                    digest.baseAddress, digest.count,
+                    signature.baseAddress, signature.count
+                ) == 1
+            }
+        }
+    }
+
+    static func isValidSignatures(_ rawSignatures: [Data], for digests: [Data], publicKey: Data) -> [Bool] {
+        precondition(rawSignatures.count == digests.count)
+        guard !rawSignatures.isEmpty else {
+            return []
+        }
+
+        // Gather everything into a single buffer, so that all of it can be pinned at once.
+        var storage = [UInt8]()
+        storage.reserveCapacity(zip(rawSignatures, digests).reduce(0) { $0 + $1.0.count + $1.1.count })
+        for (signature, digest) in zip(rawSignatures, digests) {
+            storage.append(contentsOf: signature)
+            storage.append(contentsOf: digest)
+        }
+
+        var results = [CInt](repeating: 0, count: rawSignatures.count)
+        storage.withUnsafeBytes { storage in
+            var offset = 0
+            let ops = zip(rawSignatures, digests).map { signature, digest in
+                defer { offset += signature.count + digest.count }
+                return CCryptoBoringSSLShims_ECDSA_verify_batch_op(
+                    digest: storage.baseAddress! + offset + signature.count,
+                    digest_len: digest.count,
+                    signature: storage.baseAddress! + offset,
+                    signature_len: signature.count
+                )
+            }
+
+            publicKey.withUnsafeBytes { publicKey in
+                ops.withUnsafeBufferPointer { opsPointer in
+                    results.withUnsafeMutableBufferPointer { resultsPointer in
+                        _ = CCryptoBoringSSLShims_secp256k1_verify_batch(
+                            publicKey.baseAddress,
+                            opsPointer.baseAddress,
+                            opsPointer.count,
+                            resultsPointer.baseAddress
+                        )
+                    }
+                }
+            }
+        }
+
+        return results.map { $0 == 1 }
+    }
+
+    static func rawSignature(derRepresentation: Data) throws -> Data {
+        var rawSignature = Data(repeating: 0, count: Self.rawSignatureByteCount)
+        let rc = rawSignature.withUnsafeMutableBytes { raw in
+            derRepresentation.withUnsafeBytes { der in
+                CCryptoBoringSSLShims_ECDSA_der_signature_to_raw(raw.baseAddress, Self.scalarByteCount, der.baseAddress, der.count)
+            }
+        }
+        guard rc == 1 else {
+            throw CryptoKitError.invalidParameter
+        }
+        return rawSignature
+    }
+
+    static func derRepresentation(rawSignature: Data) -> Data {
+        // Each INTEGER is at most 33 bytes plus a 2-byte header, inside a 2-byte SEQUENCE header.
+        var der = Data(repeating: 0, count: 72)
+        var count = 0
+        let rc = der.withUnsafeMutableBytes { der in
+            rawSignature.withUnsafeBytes { raw in
+                CCryptoBoringSSLShims_ECDSA_raw_signature_to_der(der.baseAddress, &count, der.count, raw.baseAddress, raw.count)
+            }
+        }
+        precondition(rc == 1, "Unable to encode a signature as DER")
+        return der.prefix(count)
+    }
+}
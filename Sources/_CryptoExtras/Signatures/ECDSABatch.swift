@@ -0,0 +1,109 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+extension P256.Signing.PublicKey {
+    /// Verifies a batch of ECDSA signatures over SHA-256 digests of the given data, in a single call into BoringSSL.
+    ///
+    /// The key is decoded once for the whole batch, and the inversions of the signatures' `s` values are shared
+    /// between them. Each signature is accepted exactly when ``P256/Signing/PublicKey/isValidSignature(_:for:)``
+    /// would accept it.
+    ///
+    /// - Parameters:
+    ///   - signatures: The signatures to verify.
+    ///   - data: The signed data, one entry per signature.
+    /// - Returns: Whether each signature is valid, in the same order as `signatures`.
+    public func _isValidSignatures<D: DataProtocol>(_ signatures: [P256.Signing.ECDSASignature], for data: [D]) -> [Bool] {
+        precondition(signatures.count == data.count, "Every signature must have exactly one message")
+        return self._isValidSignatures(signatures, for: data.map { SHA256.hash(data: $0) })
+    }
+
+    /// Verifies a batch of ECDSA signatures over the given digests, in a single call into BoringSSL.
+    ///
+    /// The key is decoded once for the whole batch, and the inversions of the signatures' `s` values are shared
+    /// between them. Each signature is accepted exactly when ``P256/Signing/PublicKey/isValidSignature(_:for:)``
+    /// would accept it.
+    ///
+    /// - Parameters:
+    ///   - signatures: The signatures to verify.
+    ///   - digests: The signed digests, one entry per signature.
+    /// - Returns: Whether each signature is valid, in the same order as `signatures`.
+    public func _isValidSignatures<D: Digest>(_ signatures: [P256.Signing.ECDSASignature], for digests: [D]) -> [Bool] {
+        precondition(signatures.count == digests.count, "Every signature must have exactly one digest")
+        return OpenSSLECDSABatchImpl.isValidSignatures(
+            signatures.map { $0.rawRepresentation },
+            for: digests.map { Data($0) },
+            publicKeyX963Representation: self.x963Representation,
+            curve: .p256
+        )
+    }
+}
+
+extension P256.Signing.PrivateKey {
+    /// Generates ECDSA signatures over SHA-256 digests of the given data, in a single call into BoringSSL.
+    ///
+    /// Every signature gets its own randomly drawn nonce, exactly as ``P256/Signing/PrivateKey/signature(for:)``
+    /// would choose it. What the batch shares is the arithmetic: the nonces are inverted together with one modular
+    /// inversion, and the points k·G are converted to affine coordinates with one field inversion.
+    ///
+    /// - Parameter data: The data to sign.
+    /// - Returns: One signature per entry of `data`, in the same order.
+    public func _signatures<D: DataProtocol>(for data: [D]) throws -> [P256.Signing.ECDSASignature] {
+        try self._signatures(for: data.map { SHA256.hash(data: $0) })
+    }
+
+    /// Generates ECDSA signatures over the given digests, in a single call into BoringSSL.
+    ///
+    /// Every signature gets its own randomly drawn nonce, exactly as ``P256/Signing/PrivateKey/signature(for:)``
+    /// would choose it. What the batch shares is the arithmetic: the nonces are inverted together with one modular
+    /// inversion, and the points k·G are converted to affine coordinates with one field inversion.
+    ///
+    /// - Parameter digests: The digests to sign.
+    /// - Returns: One signature per digest, in the same order.
+    public func _signatures<D: Digest>(for digests: [D]) throws -> [P256.Signing.ECDSASignature] {
+        try OpenSSLECDSABatchImpl.signatures(
+            for: digests.map { Data($0) },
+            rawPrivateKey: self.rawRepresentation,
+            curve: .p256
+        ).map { try P256.Signing.ECDSASignature(rawRepresentation: $0) }
+    }
+}
+
+extension P384.Signing.PrivateKey {
+    /// Generates ECDSA signatures over SHA-384 digests of the given data, in a single call into BoringSSL.
+    ///
+    /// This works as the P-256 batch signing does, for P-384.
+    ///
+    /// - Parameter data: The data to sign.
+    /// - Returns: One signature per entry of `data`, in the same order.
+    public func _signatures<D: DataProtocol>(for data: [D]) throws -> [P384.Signing.ECDSASignature] {
+        try self._signatures(for: data.map { SHA384.hash(data: $0) })
+    }
+
+    /// Generates ECDSA signatures over the given digests, in a single call into BoringSSL.
+    ///
+    /// This works as the P-256 batch signing does, for P-384.
+    ///
+    /// - Parameter digests: The digests to sign.
+    /// - Returns: One signature per digest, in the same order.
+    public func _signatures<D: Digest>(for digests: [D]) throws -> [P384.Signing.ECDSASignature] {
+        try OpenSSLECDSABatchImpl.signatures(
+            for: digests.map { Data($0) },
+            rawPrivateKey: self.rawRepresentation,
+            curve: .p384
+        ).map { try P384.Signing.ECDSASignature(rawRepresentation: $0) }
+    }
+}
@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+
+extension P256.Signing {
+    /// A stock of precomputed ECDSA presignatures for one private key, for low-latency signing.
+    ///
+    /// Most of the cost of an ECDSA signature is choosing the nonce k and computing k·G and k⁻¹, none of which
+    /// depend on the message. The pool does that work ahead of time on a background queue and keeps up to
+    /// `capacity` results, topping them up whenever the stock falls to half. Signing then consumes one
+    /// presignature and costs only a few multiplications modulo the group order. If the stock runs dry, signing
+    /// falls back to computing a presignature inline, so it never waits on the background work.
+    ///
+    /// Each presignature is used exactly once and wiped afterwards. Signatures are randomized, as with
+    /// ``P256/Signing/PrivateKey/signature(for:)``. Pools may be shared freely between threads.
+    public struct _PresignaturePool: Sendable {
+        let backing: OpenSSLECDSAPresignaturePool
+
+        /// Creates a pool for a private key and starts filling it in the background.
+        ///
+        /// - Parameters:
+        ///   - privateKey: The key to sign with.
+        ///   - capacity: The number of presignatures to keep in stock.
+        public init(privateKey: P256.Signing.PrivateKey, capacity: Int = 64) {
+            self.backing = OpenSSLECDSAPresignaturePool(curve: .p256, rawPrivateKey: privateKey.rawRepresentation, capacity: capacity)
+        }
+
+        /// Generates an ECDSA signature over the given digest.
+        public func signature<D: Digest>(for digest: D) throws -> P256.Signing.ECDSASignature {
+            let rawSignature = try digest.withUnsafeBytes { try self.backing.signature(for: $0) }
+            return try P256.Signing.ECDSASignature(rawRepresentation: rawSignature)
+        }
+
+        /// Generates an ECDSA signature over the SHA-256 digest of the given data.
+        public func signature<D: DataProtocol>(for data: D) throws -> P256.Signing.ECDSASignature {
+            try self.signature(for: SHA256.hash(data: data))
+        }
+    }
+}
+
+extension P384.Signing {
+    /// A stock of precomputed ECDSA presignatures for one private key, for low-latency signing.
+    ///
+    /// This works as ``P256/Signing/_PresignaturePool`` does, for P-384.
+    public struct _PresignaturePool: Sendable {
+        let backing: OpenSSLECDSAPresignaturePool
+
+        /// Creates a pool for a private key and starts filling it in the background.
+        ///
+        /// - Parameters:
+        ///   - privateKey: The key to sign with.
+        ///   - capacity: The number of presignatures to keep in stock.
+        public init(privateKey: P384.Signing.PrivateKey, capacity: Int = 64) {
+            self.backing = OpenSSLECDSAPresignaturePool(curve: .p384, rawPrivateKey: privateKey.rawRepresentation, capacity: capacity)
+        }
+
+        /// Generates an ECDSA signature over the given digest.
+        public func signature<D: Digest>(for digest: D) throws -> P384.Signing.ECDSASignature {
+            let rawSignature = try digest.withUnsafeBytes { try self.backing.signature(for: $0) }
+            return try P384.Signing.ECDSASignature(rawRepresentation: rawSignature)
+        }
+
+        /// Generates an ECDSA signature over the SHA-384 digest of the given data.
+        public func signature<D: DataProtocol>(for data: D) throws -> P384.Signing.ECDSASignature {
+            try self.signature(for: SHA384.hash(data: data))
+        }
+    }
+}
+
+extension P256.Signing.PrivateKey {
+    /// Creates a pool of presignatures for this key. See ``P256/Signing/_PresignaturePool``.
+    public func _presignaturePool(capacity: Int = 64) -> P256.Signing._PresignaturePool {
+        P256.Signing._PresignaturePool(privateKey: self, capacity: capacity)
+    }
+}
+
+extension P384.Signing.PrivateKey {
+    /// Creates a pool of presignatures for this key. See ``P384/Signing/_PresignaturePool``.
+    public func _presignaturePool(capacity: Int = 64) -> P384.Signing._PresignaturePool {
+        P384.Signing._PresignaturePool(privateKey: self, capacity: capacity)
+    }
+}
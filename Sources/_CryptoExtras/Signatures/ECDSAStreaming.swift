@@ -0,0 +1,197 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+
+extension P256.Signing {
+    /// Signs a message supplied in chunks, such as a large file read piece by piece.
+    ///
+    /// The message is hashed with SHA-256 as it arrives, so signing takes a single pass and constant memory however
+    /// large the message is. The result is the same signature ``PrivateKey/signature(for:)`` would produce over
+    /// the whole message at once.
+    public struct _StreamingSigner {
+        private var hasher: SHA256
+        private let privateKey: P256.Signing.PrivateKey
+
+        /// Creates a signer for a private key.
+        public init(privateKey: P256.Signing.PrivateKey) {
+            self.hasher = SHA256()
+            self.privateKey = privateKey
+        }
+
+        /// Adds the next chunk of the message.
+        public mutating func update<D: DataProtocol>(data: D) {
+            self.hasher.update(data: data)
+        }
+
+        /// Adds the next chunk of the message.
+        public mutating func update(bufferPointer: UnsafeRawBufferPointer) {
+            self.hasher.update(bufferPointer: bufferPointer)
+        }
+
+        /// Generates an ECDSA signature over the message supplied so far.
+        public func signature() throws -> P256.Signing.ECDSASignature {
+            try self.privateKey.signature(for: self.hasher.finalize())
+        }
+    }
+
+    /// Checks a signature over a message supplied in chunks.
+    ///
+    /// The message is hashed with SHA-256 as it arrives, so verification takes a single pass and constant memory.
+    public struct _StreamingVerifier {
+        private var hasher: SHA256
+        private let publicKey: P256.Signing.PublicKey
+
+        /// Creates a verifier for a public key.
+        public init(publicKey: P256.Signing.PublicKey) {
+            self.hasher = SHA256()
+            self.publicKey = publicKey
+        }
+
+        /// Adds the next chunk of the message.
+        public mutating func update<D: DataProtocol>(data: D) {
+            self.hasher.update(data: data)
+        }
+
+        /// Adds the next chunk of the message.
+        public mutating func update(bufferPointer: UnsafeRawBufferPointer) {
+            self.hasher.update(bufferPointer: bufferPointer)
+        }
+
+        /// Checks whether a signature is valid for the message supplied so far.
+        public func isValidSignature(_ signature: P256.Signing.ECDSASignature) -> Bool {
+            self.publicKey.isValidSignature(signature, for: self.hasher.finalize())
+        }
+    }
+}
+
+extension P384.Signing {
+    /// Signs a message supplied in chunks, hashing it with SHA-384.
+    ///
+    /// This works as ``P256/Signing/_StreamingSigner`` does, for P-384.
+    public struct _StreamingSigner {
+        private var hasher: SHA384
+        private let privateKey: P384.Signing.PrivateKey
+
+        /// Creates a signer for a private key.
+        public init(privateKey: P384.Signing.PrivateKey) {
+            self.hasher = SHA384()
+            self.privateKey = privateKey
+        }
+
+        /// Adds the next chunk of the message.
+        public mutating func update<D: DataProtocol>(data: D) {
+            self.hasher.update(data: data)
+        }
+
+        /// Adds the next chunk of the message.
+        public mutating func update(bufferPointer: UnsafeRawBufferPointer) {
+            self.hasher.update(bufferPointer: bufferPointer)
+        }
+
+        /// Generates an ECDSA signature over the message supplied so far.
+        public func signature() throws -> P384.Signing.ECDSASignature {
+            try self.privateKey.signature(for: self.hasher.finalize())
+        }
+    }
+
+    /// Checks a signature over a message supplied in chunks, hashing it with SHA-384.
+    ///
+    /// This works as ``P256/Signing/_StreamingVerifier`` does, for P-384.
+    public struct _StreamingVerifier {
+        private var hasher: SHA384
+        private let publicKey: P384.Signing.PublicKey
+
+        /// Creates a verifier for a public key.
+        public init(publicKey: P384.Signing.PublicKey) {
+            self.hasher = SHA384()
+            self.publicKey = publicKey
+        }
+
+        /// Adds the next chunk of the message.
+        public mutating func update<D: DataProtocol>(data: D) {
+            self.hasher.update(data: data)
+        }
+
+        /// Adds the next chunk of the message.
+        public mutating func update(bufferPointer: UnsafeRawBufferPointer) {
+            self.hasher.update(bufferPointer: bufferPointer)
+        }
+
+        /// Checks whether a signature is valid for the message supplied so far.
+        public func isValidSignature(_ signature: P384.Signing.ECDSASignature) -> Bool {
+            self.publicKey.isValidSignature(signature, for: self.hasher.finalize())
+        }
+    }
+}
+
+extension P521.Signing {
+    /// Signs a message supplied in chunks, hashing it with SHA-512.
+    ///
+    /// This works as ``P256/Signing/_StreamingSigner`` does, for P-521.
+    public struct _StreamingSigner {
+        private var hasher: SHA512
+        private let privateKey: P521.Signing.PrivateKey
+
+        /// Creates a signer for a private key.
+        public init(privateKey: P521.Signing.PrivateKey) {
+            self.hasher = SHA512()
+            self.privateKey = privateKey
+        }
+
+        /// Adds the next chunk of the message.
+        public mutating func update<D: DataProtocol>(data: D) {
+            self.hasher.update(data: data)
+        }
+
+        /// Adds the next chunk of the message.
+        public mutating func update(bufferPointer: UnsafeRawBufferPointer) {
+            self.hasher.update(bufferPointer: bufferPointer)
+        }
+
+        /// Generates an ECDSA signature over the message supplied so far.
+        public func signature() throws -> P521.Signing.ECDSASignature {
+            try self.privateKey.signature(for: self.hasher.finalize())
+        }
+    }
+
+    /// Checks a signature over a message supplied in chunks, hashing it with SHA-512.
+    ///
+    /// This works as ``P256/Signing/_StreamingVerifier`` does, for P-521.
+    public struct _StreamingVerifier {
+        private var hasher: SHA512
+        private let publicKey: P521.Signing.PublicKey
+
+        /// Creates a verifier for a public key.
+        public init(publicKey: P521.Signing.PublicKey) {
+            self.hasher = SHA512()
+            self.publicKey = publicKey
+        }
+
+        /// Adds the next chunk of the message.
+        public mutating func update<D: DataProtocol>(data: D) {
+            self.hasher.update(data: data)
+        }
+
+        /// Adds the next chunk of the message.
+        public mutating func update(bufferPointer: UnsafeRawBufferPointer) {
+            self.hasher.update(bufferPointer: bufferPointer)
+        }
+
+        /// Checks whether a signature is valid for the message supplied so far.
+        public func isValidSignature(_ signature: P521.Signing.ECDSASignature) -> Bool {
+            self.publicKey.isValidSignature(signature, for: self.hasher.finalize())
+        }
+    }
+}
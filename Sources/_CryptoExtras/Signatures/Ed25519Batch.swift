@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+extension Curve25519.Signing {
+    /// A single signature to check as part of a batch verification.
+    public struct _BatchVerificationItem {
+        /// The public key the signature claims to be from.
+        public var publicKey: PublicKey
+        /// The signature to check.
+        public var signature: Data
+        /// The signed data.
+        public var data: Data
+
+        public init<S: DataProtocol, D: DataProtocol>(publicKey: PublicKey, signature: S, data: D) {
+            self.publicKey = publicKey
+            self.signature = Data(signature)
+            self.data = Data(data)
+        }
+    }
+
+    /// A single message to sign as part of a batch signing.
+    public struct _BatchSigningItem {
+        /// The key to sign with.
+        public var privateKey: PrivateKey
+        /// The data to sign.
+        public var data: Data
+
+        public init<D: DataProtocol>(privateKey: PrivateKey, data: D) {
+            self.privateKey = privateKey
+            self.data = Data(data)
+        }
+    }
+
+    /// Verifies a batch of EdDSA signatures over Curve25519, in a single call into BoringSSL.
+    ///
+    /// Each signature is checked exactly as ``Curve25519/Signing/PublicKey/isValidSignature(_:for:)``
+    /// would check it, so a batch never accepts a signature that verifying alone would reject.
+    ///
+    /// - Parameter items: The signatures to verify, along with their public keys and signed data.
+    /// - Returns: Whether each signature is valid, in the same order as `items`.
+    public static func _isValidSignatures(_ items: [_BatchVerificationItem]) -> [Bool] {
+        OpenSSLEd25519BatchImpl.isValidSignatures(items)
+    }
+
+    /// Generates a batch of EdDSA signatures over Curve25519, in a single call into BoringSSL.
+    ///
+    /// Each signature is the deterministic RFC 8032 signature, which is what
+    /// ``Curve25519/Signing/PrivateKey/signature(for:)`` produces when it is backed by BoringSSL. What the batch shares is the hashing and the point encoding: on x86-64 with AVX2 or AVX-512,
+    /// the SHA-512s of different items run side by side in SIMD lanes, and the nonce commitments share one field
+    /// inversion. The items may use any mix of keys.
+    ///
+    /// - Parameter items: The keys to sign with, along with the data to sign.
+    /// - Returns: One signature per item, in the same order as `items`.
+    public static func _signatures(for items: [_BatchSigningItem]) -> [Data] {
+        OpenSSLEd25519BatchImpl.signatures(for: items)
+    }
+}
@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+extension Curve25519.Signing.PublicKey {
+    /// An EdDSA public key over Curve25519 that has been decoded ahead of time, for verifying many signatures with it.
+    ///
+    /// Each ``Curve25519/Signing/PublicKey/isValidSignature(_:for:)`` decompresses the key, which takes a square
+    /// root, and then builds a table of multiples of the decoded point. An expanded key does both once, when it is
+    /// created, and keeps the 1280-byte table for every verification after that. It accepts exactly the signatures
+    /// the key itself accepts.
+    ///
+    /// When Crypto is backed by CryptoKit, or the field arithmetic in use has no table layout, verification falls
+    /// back to ``Curve25519/Signing/PublicKey/isValidSignature(_:for:)``.
+    public struct _Expanded: Sendable {
+        /// The key this was expanded from.
+        public let publicKey: Curve25519.Signing.PublicKey
+
+        // The table of multiples of the decoded key, or empty where there is no table layout.
+        private let prepared: Data
+
+        /// Decodes `publicKey` and builds its table of multiples.
+        public init(_ publicKey: Curve25519.Signing.PublicKey) {
+            self.publicKey = publicKey
+            if OpenSSLPreparedPublicKeyImpl.ed25519Layout != 0,
+               let prepared = OpenSSLPreparedPublicKeyImpl.prepareEd25519(publicKey.rawRepresentation) {
+                self.prepared = prepared
+            } else {
+                self.prepared = Data()
+            }
+        }
+
+        /// Verifies an EdDSA signature over Curve25519 with the expanded key.
+        ///
+        /// - Parameters:
+        ///   - signature: The signature to verify.
+        ///   - data: The signed data.
+        /// - Returns: What ``Curve25519/Signing/PublicKey/isValidSignature(_:for:)`` returns for the same key.
+        public func isValidSignature<S: DataProtocol, D: DataProtocol>(_ signature: S, for data: D) -> Bool {
+            guard !self.prepared.isEmpty else {
+                return self.publicKey.isValidSignature(signature, for: data)
+            }
+            return self.publicKey.rawRepresentation.withUnsafeBytes { publicKey in
+                self.prepared.withUnsafeBytes { prepared in
+                    OpenSSLPreparedPublicKeyImpl.isValidEd25519Signature(signature, for: data, publicKey: publicKey, prepared: prepared)
+                }
+            }
+        }
+    }
+
+    /// This key, decoded ahead of time for verifying many signatures with it.
+    public var _expanded: _Expanded {
+        _Expanded(self)
+    }
+}
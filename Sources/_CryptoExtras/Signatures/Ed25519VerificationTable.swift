@@ -0,0 +1,53 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+
+#if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+// Nothing; CryptoKit verifies signatures its own way.
+#else
+@_implementationOnly import CCryptoBoringSSLShims
+#endif
+
+extension Curve25519.Signing {
+    /// Whether EdDSA verification uses a larger precomputed table for the base point.
+    ///
+    /// Half of each verification is a multiplication of the base point, which BoringSSL does with a table of 8
+    /// multiples. When enabled, verification uses a table of 64 multiples instead, which is built on first use and
+    /// takes 7.5 KiB. That saves about a third of the point additions in that half, and makes a verification a few
+    /// percent cheaper. Verification that hashes the message region by region, which can't share work between the
+    /// two halves otherwise, becomes as cheap as verifying a contiguous message.
+    ///
+    /// The same signatures are accepted either way. This applies to
+    /// ``Curve25519/Signing/PublicKey/isValidSignature(_:for:)``, ``_isValidSignatures(_:)`` and Ed25519ph.
+    ///
+    /// This is disabled by default. It can only be enabled on 64-bit platforms, and has no effect when Crypto is
+    /// backed by CryptoKit.
+    public static var _isWideBasePointTableEnabled: Bool {
+        get {
+            #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+            return false
+            #else
+            return CCryptoBoringSSLShims_ED25519_wide_base_table_enabled() != 0
+            #endif
+        }
+        set {
+            #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+            // Nothing to do.
+            #else
+            CCryptoBoringSSLShims_ED25519_set_wide_base_table_enabled(newValue ? 1 : 0)
+            #endif
+        }
+    }
+}
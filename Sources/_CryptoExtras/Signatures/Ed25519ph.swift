@@ -0,0 +1,136 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+
+extension Curve25519.Signing {
+    /// Signs a message supplied in chunks with Ed25519ph, the prehashed variant of EdDSA from RFC 8032.
+    ///
+    /// Plain Ed25519 hashes the message twice and so needs all of it at once. Ed25519ph signs the SHA-512 digest
+    /// of the message instead, so the message can be hashed as it arrives and signing takes a single pass and
+    /// constant memory. Ed25519ph signatures are not interchangeable with Ed25519 ones: they must be checked with
+    /// ``_Ed25519phVerifier`` or ``PublicKey/_isValidEd25519phSignature(_:for:context:)``.
+    public struct _Ed25519phSigner {
+        private var hasher: SHA512
+        private let privateKey: OpenSSLEd25519phPrivateKey
+        private let context: Data
+
+        /// Creates a signer for a private key.
+        ///
+        /// - Parameters:
+        ///   - privateKey: The key to sign with.
+        ///   - context: Up to 255 bytes that bind the signature to an application-specific purpose. The verifier
+        ///     must use the same context.
+        /// - Throws: `CryptoKitError.incorrectParameterSize` if `context` is longer than 255 bytes.
+        public init<C: DataProtocol>(privateKey: Curve25519.Signing.PrivateKey, context: C) throws {
+            self.context = try OpenSSLEd25519phImpl.validatedContext(context)
+            self.hasher = SHA512()
+            self.privateKey = OpenSSLEd25519phPrivateKey(privateKey)
+        }
+
+        /// Creates a signer for a private key, with an empty context.
+        public init(privateKey: Curve25519.Signing.PrivateKey) {
+            self.context = Data()
+            self.hasher = SHA512()
+            self.privateKey = OpenSSLEd25519phPrivateKey(privateKey)
+        }
+
+        /// Adds the next chunk of the message.
+        public mutating func update<D: DataProtocol>(data: D) {
+            self.hasher.update(data: data)
+        }
+
+        /// Adds the next chunk of the message.
+        public mutating func update(bufferPointer: UnsafeRawBufferPointer) {
+            self.hasher.update(bufferPointer: bufferPointer)
+        }
+
+        /// Generates an Ed25519ph signature over the message supplied so far.
+        public func signature() throws -> Data {
+            try self.privateKey.signature(for: self.hasher.finalize(), context: self.context)
+        }
+    }
+
+    /// Checks an Ed25519ph signature over a message supplied in chunks.
+    ///
+    /// The message is hashed with SHA-512 as it arrives, so verification takes a single pass and constant memory.
+    public struct _Ed25519phVerifier {
+        private var hasher: SHA512
+        private let publicKey: Curve25519.Signing.PublicKey
+        private let context: Data
+
+        /// Creates a verifier for a public key.
+        ///
+        /// - Parameters:
+        ///   - publicKey: The key the signature claims to be from.
+        ///   - context: The context the message was signed with.
+        /// - Throws: `CryptoKitError.incorrectParameterSize` if `context` is longer than 255 bytes.
+        public init<C: DataProtocol>(publicKey: Curve25519.Signing.PublicKey, context: C) throws {
+            self.context = try OpenSSLEd25519phImpl.validatedContext(context)
+            self.hasher = SHA512()
+            self.publicKey = publicKey
+        }
+
+        /// Creates a verifier for a public key, with an empty context.
+        public init(publicKey: Curve25519.Signing.PublicKey) {
+            self.context = Data()
+            self.hasher = SHA512()
+            self.publicKey = publicKey
+        }
+
+        /// Adds the next chunk of the message.
+        public mutating func update<D: DataProtocol>(data: D) {
+            self.hasher.update(data: data)
+        }
+
+        /// Adds the next chunk of the message.
+        public mutating func update(bufferPointer: UnsafeRawBufferPointer) {
+            self.hasher.update(bufferPointer: bufferPointer)
+        }
+
+        /// Checks whether a signature is valid for the message supplied so far.
+        public func isValidSignature<S: DataProtocol>(_ signature: S) -> Bool {
+            OpenSSLEd25519phImpl.isValidSignature(signature, for: self.hasher.finalize(), context: self.context, publicKey: self.publicKey)
+        }
+    }
+}
+
+extension Curve25519.Signing.PrivateKey {
+    /// Generates an Ed25519ph signature over the SHA-512 digest of a message.
+    ///
+    /// - Parameters:
+    ///   - digest: The SHA-512 digest of the message.
+    ///   - context: Up to 255 bytes that bind the signature to an application-specific purpose.
+    /// - Throws: `CryptoKitError.incorrectParameterSize` if `context` is longer than 255 bytes.
+    public func _ed25519phSignature<C: DataProtocol>(for digest: SHA512Digest, context: C) throws -> Data {
+        let context = try OpenSSLEd25519phImpl.validatedContext(context)
+        return try OpenSSLEd25519phPrivateKey(self).signature(for: digest, context: context)
+    }
+}
+
+extension Curve25519.Signing.PublicKey {
+    /// Checks an Ed25519ph signature over the SHA-512 digest of a message.
+    ///
+    /// - Parameters:
+    ///   - signature: The signature to check.
+    ///   - digest: The SHA-512 digest of the message.
+    ///   - context: The context the message was signed with.
+    /// - Returns: Whether the signature is valid. A context longer than 255 bytes never validates.
+    public func _isValidEd25519phSignature<S: DataProtocol, C: DataProtocol>(_ signature: S, for digest: SHA512Digest, context: C) -> Bool {
+        guard let context = try? OpenSSLEd25519phImpl.validatedContext(context) else {
+            return false
+        }
+        return OpenSSLEd25519phImpl.isValidSignature(signature, for: digest, context: context, publicKey: self)
+    }
+}
@@ -0,0 +1,119 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+/// SPHINCS+-SHA2-128s, a stateless hash-based signature scheme.
+///
+/// SPHINCS+ relies only on the security of the underlying hash function, at the cost of large signatures and slow
+/// signing. This is the round-3 parameter set that BoringSSL implements, not SLH-DSA as finalized in FIPS 205.
+public enum _SPHINCSPlus {
+    /// The number of bytes in a signature.
+    public static let signatureByteCount = OpenSSLSPHINCSPlusImpl.signatureByteCount
+
+    /// A SPHINCS+ public key.
+    public struct PublicKey {
+        /// The encoding of the key: `PK.seed || PK.root`.
+        public let rawRepresentation: Data
+
+        /// Creates a public key from its encoding.
+        public init<Bytes: ContiguousBytes>(rawRepresentation: Bytes) throws {
+            let bytes = rawRepresentation.withUnsafeBytes { Data($0) }
+            guard bytes.count == OpenSSLSPHINCSPlusImpl.publicKeyByteCount else {
+                throw CryptoKitError.incorrectKeySize
+            }
+            self.rawRepresentation = bytes
+        }
+
+        fileprivate init(validatedRawRepresentation: Data) {
+            self.rawRepresentation = validatedRawRepresentation
+        }
+
+        /// Verifies a SPHINCS+ signature.
+        ///
+        /// - Parameters:
+        ///   - signature: The signature to check.
+        ///   - data: The signed data.
+        /// - Returns: Whether the signature is valid for `data` under this key.
+        public func isValidSignature<S: DataProtocol, D: DataProtocol>(_ signature: S, for data: D) -> Bool {
+            OpenSSLSPHINCSPlusImpl.isValidSignature(signature, for: data, publicKey: self.rawRepresentation)
+        }
+    }
+
+    /// A SPHINCS+ private key.
+    public struct PrivateKey {
+        private let backing: OpenSSLSPHINCSPlusImpl.SecretKey
+
+        /// Generates a random private key.
+        public init() {
+            self.backing = OpenSSLSPHINCSPlusImpl.SecretKey()
+        }
+
+        /// Creates a private key from its encoding.
+        public init<Bytes: ContiguousBytes>(rawRepresentation: Bytes) throws {
+            self.backing = try OpenSSLSPHINCSPlusImpl.SecretKey(rawRepresentation: rawRepresentation)
+        }
+
+        /// The encoding of the key: `SK.seed || SK.prf || PK.seed || PK.root`.
+        public var rawRepresentation: Data {
+            self.backing.rawRepresentation
+        }
+
+        /// The public key that corresponds to this private key.
+        public var publicKey: PublicKey {
+            PublicKey(validatedRawRepresentation: self.backing.publicKey)
+        }
+
+        /// Signs data with a randomized SPHINCS+ signature.
+        ///
+        /// With `concurrently` set, the signature's independent subtrees are computed across all available cores.
+        /// This produces the same signature as signing serially, in a fraction of the latency on a multi-core machine.
+        ///
+        /// - Parameters:
+        ///   - data: The data to sign.
+        ///   - concurrently: Whether to spread the work of signing across all available cores.
+        /// - Returns: The ``_SPHINCSPlus/signatureByteCount``-byte signature.
+        public func signature<D: DataProtocol>(for data: D, concurrently: Bool = false) -> Data {
+            self.backing.signature(for: data, randomized: true, concurrently: concurrently)
+        }
+
+        /// Signs data with a randomized SPHINCS+ signature on `executor`, suspending the calling task until it's done.
+        ///
+        /// Cancelling the calling task stops signing at the next authentication-path subtree.
+        ///
+        /// - Parameters:
+        ///   - data: The data to sign.
+        ///   - executor: The executor to sign on.
+        ///   - priority: The priority of the signing operation on `executor`.
+        /// - Returns: The ``_SPHINCSPlus/signatureByteCount``-byte signature.
+        /// - Throws: `CancellationError` if the calling task is cancelled before the signature is complete.
+        public func signature<D: DataProtocol>(
+            for data: D,
+            on executor: _CryptoExecutor,
+            priority: _CryptoExecutor.Priority = .utility
+        ) async throws -> Data {
+            let message = Array(data)
+            let backing = self.backing
+            return try await executor.run(priority: priority) { cancellation in
+                try backing.signature(for: message, randomized: true, cancellation: cancellation)
+            }
+        }
+
+        /// Signs data deterministically, for tests that compare signatures.
+        func deterministicSignature<D: DataProtocol>(for data: D, concurrently: Bool) -> Data {
+            self.backing.signature(for: data, randomized: false, concurrently: concurrently)
+        }
+    }
+}
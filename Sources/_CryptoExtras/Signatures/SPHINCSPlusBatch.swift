@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+extension _SPHINCSPlus {
+    /// A single signature to check as part of a batch verification.
+    public struct _BatchVerificationItem {
+        /// The public key the signature claims to be from.
+        public var publicKey: PublicKey
+        /// The signature to check.
+        public var signature: Data
+        /// The signed data.
+        public var data: Data
+
+        public init<S: DataProtocol, D: DataProtocol>(publicKey: PublicKey, signature: S, data: D) {
+            self.publicKey = publicKey
+            self.signature = Data(signature)
+            self.data = Data(data)
+        }
+    }
+
+    /// Verifies a batch of SPHINCS+ signatures.
+    ///
+    /// Each signature is checked exactly as ``_SPHINCSPlus/PublicKey/isValidSignature(_:for:)`` would check it.
+    /// A SPHINCS+ verification is thousands of independent hash evaluations, long enough that spreading a batch
+    /// across cores scales close to linearly.
+    ///
+    /// - Parameters:
+    ///   - items: The signatures to verify, along with their public keys and signed data.
+    ///   - concurrently: Whether to verify the signatures concurrently across all available cores.
+    /// - Returns: Whether each signature is valid, in the same order as `items`.
+    public static func _isValidSignatures(_ items: [_BatchVerificationItem], concurrently: Bool = true) -> [Bool] {
+        guard !items.isEmpty else {
+            return []
+        }
+
+        return [Bool](unsafeUninitializedCapacity: items.count) { buffer, initializedCount in
+            let base = buffer.baseAddress!
+            let verify = { (index: Int) in
+                let item = items[index]
+                (base + index).initialize(to: item.publicKey.isValidSignature(item.signature, for: item.data))
+            }
+
+            if concurrently && items.count > 1 {
+                DispatchQueue.concurrentPerform(iterations: items.count, execute: verify)
+            } else {
+                (0..<items.count).forEach(verify)
+            }
+            initializedCount = items.count
+        }
+    }
+}
@@ -0,0 +1,213 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+/// ECDSA over secp256k1, the curve of Bitcoin and Ethereum.
+///
+/// Signing uses BoringSSL's constant-time arithmetic, with a random nonce, and always produces the low-s form of the
+/// signature that those systems require. Verification accepts either form, as ECDSA does, and uses arithmetic
+/// specialised to secp256k1: its efficiently computable endomorphism splits each scalar into two of half the length,
+/// which makes verification about twice as fast as on a generic curve. Verifying many signatures under one key with
+/// ``_Secp256k1/Signing/PublicKey/_isValidSignatures(_:for:)`` precomputes the key's multiples once for them all.
+///
+/// Digests are used as ECDSA specifies, truncated to 256 bits, so any hash function works.
+public enum _Secp256k1 {
+    public enum Signing {}
+}
+
+extension _Secp256k1.Signing {
+    /// A secp256k1 ECDSA signature.
+    public struct ECDSASignature: ContiguousBytes, Hashable, Sendable {
+        /// The raw representation of the signature, r || s, 64 bytes.
+        public let rawRepresentation: Data
+
+        /// Creates a signature from its raw representation, r || s.
+        ///
+        /// - Throws: `CryptoKitError.incorrectParameterSize` if the representation is not 64 bytes.
+        public init<D: DataProtocol>(rawRepresentation: D) throws {
+            guard rawRepresentation.count == OpenSSLSecp256k1Impl.rawSignatureByteCount else {
+                throw CryptoKitError.incorrectParameterSize
+            }
+            self.rawRepresentation = Data(rawRepresentation)
+        }
+
+        /// Creates a signature from its DER representation, a SEQUENCE of two INTEGERs.
+        ///
+        /// - Throws: `CryptoKitError.invalidParameter` if the representation is not valid DER, or either integer is
+        ///   longer than 32 bytes.
+        public init<D: DataProtocol>(derRepresentation: D) throws {
+            self.rawRepresentation = try OpenSSLSecp256k1Impl.rawSignature(derRepresentation: Data(derRepresentation))
+        }
+
+        fileprivate init(validatedRawRepresentation: Data) {
+            self.rawRepresentation = validatedRawRepresentation
+        }
+
+        /// The DER representation of the signature.
+        public var derRepresentation: Data {
+            OpenSSLSecp256k1Impl.derRepresentation(rawSignature: self.rawRepresentation)
+        }
+
+        public func withUnsafeBytes<R>(_ body: (UnsafeRawBufferPointer) throws -> R) rethrows -> R {
+            try self.rawRepresentation.withUnsafeBytes(body)
+        }
+    }
+
+    /// A secp256k1 public key.
+    public struct PublicKey: Hashable, Sendable {
+        /// The raw representation of the key, x || y, 64 bytes.
+        public let rawRepresentation: Data
+
+        /// Creates a key from its raw representation, x || y.
+        ///
+        /// - Throws: `CryptoKitError.incorrectKeySize` if the length is wrong, or `CryptoKitError.invalidParameter` if
+        ///   the point is not on the curve.
+        public init<D: DataProtocol>(rawRepresentation: D) throws {
+            let rawRepresentation = Data(rawRepresentation)
+            try OpenSSLSecp256k1Impl.validatePublicKey(rawRepresentation)
+            self.rawRepresentation = rawRepresentation
+        }
+
+        /// Creates a key from its uncompressed X9.63 representation, 0x04 || x || y.
+        ///
+        /// - Throws: `CryptoKitError.incorrectKeySize` if the length or the leading byte is wrong, or
+        ///   `CryptoKitError.invalidParameter` if the point is not on the curve.
+        public init<D: DataProtocol>(x963Representation: D) throws {
+            guard x963Representation.first == 0x04 else {
+                throw CryptoKitError.incorrectKeySize
+            }
+            try self.init(rawRepresentation: x963Representation.dropFirst())
+        }
+
+        /// Creates a key from its SEC 1 compressed representation, 0x02 or 0x03, then x.
+        ///
+        /// - Throws: `CryptoKitError.incorrectKeySize` if the length is wrong, or `CryptoKitError.invalidParameter` if
+        ///   no point on the curve has this representation.
+        public init<D: DataProtocol>(compressedRepresentation: D) throws {
+            self.rawRepresentation = try OpenSSLSecp256k1Impl.decompress(Data(compressedRepresentation))
+        }
+
+        fileprivate init(validatedRawRepresentation: Data) {
+            self.rawRepresentation = validatedRawRepresentation
+        }
+
+        /// The uncompressed X9.63 representation of the key, 0x04 || x || y.
+        public var x963Representation: Data {
+            [0x04] + self.rawRepresentation
+        }
+
+        /// The SEC 1 compressed representation of the key: 0x02 if y is even and 0x03 if it is odd, then x.
+        public var compressedRepresentation: Data {
+            let yIsOdd = self.rawRepresentation.last! & 1 == 1
+            var compressed = Data([yIsOdd ? 0x03 : 0x02])
+            compressed.append(self.rawRepresentation.prefix(OpenSSLSecp256k1Impl.scalarByteCount))
+            return compressed
+        }
+
+        /// Verifies an ECDSA signature over a digest.
+        ///
+        /// - Parameters:
+        ///   - signature: The signature to check.
+        ///   - digest: The signed digest.
+        /// - Returns: Whether the signature is valid for `digest` under this key, in either its low-s or high-s form.
+        public func isValidSignature<D: Digest>(_ signature: _Secp256k1.Signing.ECDSASignature, for digest: D) -> Bool {
+            digest.withUnsafeBytes { digest in
+                OpenSSLSecp256k1Impl.isValidSignature(signature.rawRepresentation, for: digest, publicKey: self.rawRepresentation)
+            }
+        }
+
+        /// Verifies an ECDSA signature over the SHA-256 digest of `data`.
+        ///
+        /// - Returns: What ``isValidSignature(_:for:)`` returns for the SHA-256 digest of `data`.
+        public func isValidSignature<D: DataProtocol>(_ signature: _Secp256k1.Signing.ECDSASignature, for data: D) -> Bool {
+            self.isValidSignature(signature, for: SHA256.hash(data: data))
+        }
+
+        /// Verifies a batch of ECDSA signatures over the given digests, in a single call into BoringSSL.
+        ///
+        /// The multiples of the key that verification uses are computed once for the whole batch, and each signature
+        /// is checked exactly as ``isValidSignature(_:for:)`` would check it.
+        ///
+        /// - Parameters:
+        ///   - signatures: The signatures to verify.
+        ///   - digests: The signed digests, one entry per signature.
+        /// - Returns: Whether each signature is valid, in the same order as `signatures`.
+        public func _isValidSignatures<D: Digest>(_ signatures: [_Secp256k1.Signing.ECDSASignature], for digests: [D]) -> [Bool] {
+            precondition(signatures.count == digests.count, "Every signature must have exactly one digest")
+            return OpenSSLSecp256k1Impl.isValidSignatures(
+                signatures.map { $0.rawRepresentation },
+                for: digests.map { Data($0) },
+                publicKey: self.rawRepresentation
+            )
+        }
+
+        /// Verifies a batch of ECDSA signatures over SHA-256 digests of the given data, in a single call into BoringSSL.
+        ///
+        /// - Parameters:
+        ///   - signatures: The signatures to verify.
+        ///   - data: The signed data, one entry per signature.
+        /// - Returns: Whether each signature is valid, in the same order as `signatures`.
+        public func _isValidSignatures<D: DataProtocol>(_ signatures: [_Secp256k1.Signing.ECDSASignature], for data: [D]) -> [Bool] {
+            precondition(signatures.count == data.count, "Every signature must have exactly one message")
+            return self._isValidSignatures(signatures, for: data.map { SHA256.hash(data: $0) })
+        }
+    }
+
+    /// A secp256k1 private key.
+    public struct PrivateKey {
+        private let backing: OpenSSLSecp256k1Impl.PrivateKey
+
+        /// Generates a random private key.
+        public init() {
+            self.backing = OpenSSLSecp256k1Impl.PrivateKey()
+        }
+
+        /// Creates a private key from its raw representation, the 32-byte big-endian scalar.
+        ///
+        /// - Throws: `CryptoKitError.incorrectKeySize` if the length is wrong, or `CryptoKitError.invalidParameter` if
+        ///   the scalar is zero or not below the order of the curve.
+        public init<Bytes: ContiguousBytes>(rawRepresentation: Bytes) throws {
+            self.backing = try OpenSSLSecp256k1Impl.PrivateKey(rawRepresentation: rawRepresentation)
+        }
+
+        /// The raw representation of the key, the 32-byte big-endian scalar.
+        public var rawRepresentation: Data {
+            self.backing.rawRepresentation
+        }
+
+        /// The public key that corresponds to this private key.
+        public var publicKey: _Secp256k1.Signing.PublicKey {
+            PublicKey(validatedRawRepresentation: self.backing.publicKey)
+        }
+
+        /// Signs a digest with ECDSA.
+        ///
+        /// - Parameter digest: The digest to sign.
+        /// - Returns: The low-s signature.
+        public func signature<D: Digest>(for digest: D) throws -> _Secp256k1.Signing.ECDSASignature {
+            let signature = try digest.withUnsafeBytes { try self.backing.signature(for: $0) }
+            return _Secp256k1.Signing.ECDSASignature(validatedRawRepresentation: signature)
+        }
+
+        /// Signs the SHA-256 digest of `data` with ECDSA.
+        ///
+        /// - Parameter data: The data to sign.
+        /// - Returns: The low-s signature.
+        public func signature<D: DataProtocol>(for data: D) throws -> _Secp256k1.Signing.ECDSASignature {
+            try self.signature(for: SHA256.hash(data: data))
+        }
+    }
+}
@@ -0,0 +1,305 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+/// Gathers signature verifications that arrive one at a time from many tasks into batches, and checks each batch
+/// with one call to the batch verification APIs.
+///
+/// Batch verification pays off only for callers that have batches. A server verifying a signature per request
+/// usually hasn't, so this service holds each verification for at most ``maximumLatency``, or until
+/// ``maximumBatchSize`` verifications of the same kind are waiting, and then verifies them together on a
+/// ``_CryptoExecutor``:
+///
+/// - Ed25519 signatures are checked by ``Curve25519/Signing/_isValidSignatures(_:)``, whatever their keys.
+/// - P-256 and RSA signatures are grouped by public key, and each group is checked by
+///   ``P256/Signing/PublicKey/_isValidSignatures(_:for:)`` or
+///   ``_RSA/Signing/PublicKey/_areValidSignatures(_:for:padding:)``.
+///
+/// Every result is the one verifying alone would give. Using the service is opt-in: it adds up to
+/// ``maximumLatency`` to each verification in exchange for throughput.
+public final class _SignatureVerificationService: @unchecked Sendable {
+    /// What the service has done since it was created.
+    public struct Statistics: Hashable, Sendable {
+        /// The signatures verified.
+        public var verifications = 0
+        /// The batches they were verified in.
+        public var batches = 0
+    }
+
+    /// The longest a verification waits for others to join its batch.
+    public let maximumLatency: TimeInterval
+
+    /// The most verifications of one kind in a batch.
+    public let maximumBatchSize: Int
+
+    private let executor: _CryptoExecutor
+
+    private let priority: _CryptoExecutor.Priority
+
+    private let statisticsLock = NSLock()
+
+    // Protected by `statisticsLock`.
+    private var _statistics = Statistics()
+
+    private var ed25519: Lane<Ed25519Item>!
+
+    private var p256: Lane<P256Item>!
+
+    private var rsa: Lane<RSAItem>!
+
+    /// Creates a verification service.
+    ///
+    /// - Parameters:
+    ///   - maximumLatency: The longest a verification waits for others to join its batch.
+    ///   - maximumBatchSize: The most verifications of one kind in a batch. Must be positive.
+    ///   - executor: Where batches are verified.
+    ///   - priority: The priority of each batch on `executor`.
+    public init(
+        maximumLatency: TimeInterval = 0.0002,
+        maximumBatchSize: Int = 64,
+        executor: _CryptoExecutor = .shared,
+        priority: _CryptoExecutor.Priority = .userInitiated
+    ) {
+        precondition(maximumLatency >= 0)
+        precondition(maximumBatchSize > 0)
+        self.maximumLatency = maximumLatency
+        self.maximumBatchSize = maximumBatchSize
+        self.executor = executor
+        self.priority = priority
+        self.ed25519 = Lane(service: self, label: "ed25519") { items in
+            Curve25519.Signing._isValidSignatures(items.map(\.item))
+        }
+        self.p256 = Lane(service: self, label: "p256") { items in
+            Self.verifyGroupedByKey(items, key: \.keyRepresentation) { group in
+                group[0].publicKey._isValidSignatures(group.map(\.signature), for: group.map(\.digest))
+            }
+        }
+        self.rsa = Lane(service: self, label: "rsa") { items in
+            Self.verifyGroupedByKey(items, key: \.keyRepresentation) { group in
+                group[0].publicKey._areValidSignatures(group.map(\.signature), for: group.map(\.digest), padding: group[0].padding)
+            }
+        }
+    }
+
+    /// What the service has done since it was created.
+    public var statistics: Statistics {
+        self.statisticsLock.lock()
+        defer {
+            self.statisticsLock.unlock()
+        }
+        return self._statistics
+    }
+
+    /// Verifies an EdDSA signature over Curve25519 as part of a batch.
+    ///
+    /// - Returns: What ``Curve25519/Signing/PublicKey/isValidSignature(_:for:)`` returns for the same arguments.
+    public func isValidSignature<S: DataProtocol, D: DataProtocol>(
+        _ signature: S,
+        for data: D,
+        publicKey: Curve25519.Signing.PublicKey
+    ) async -> Bool {
+        await self.ed25519.verify(Ed25519Item(item: .init(publicKey: publicKey, signature: signature, data: data)))
+    }
+
+    /// Verifies a P-256 ECDSA signature over a SHA-256 digest as part of a batch.
+    ///
+    /// - Returns: What ``P256/Signing/PublicKey/isValidSignature(_:for:)`` returns for the same arguments.
+    public func isValidSignature(
+        _ signature: P256.Signing.ECDSASignature,
+        for digest: SHA256.Digest,
+        publicKey: P256.Signing.PublicKey
+    ) async -> Bool {
+        await self.p256.verify(P256Item(publicKey: publicKey, keyRepresentation: publicKey.x963Representation, signature: signature, digest: digest))
+    }
+
+    /// Verifies a P-256 ECDSA signature over the SHA-256 digest of `data` as part of a batch.
+    ///
+    /// - Returns: What ``P256/Signing/PublicKey/isValidSignature(_:for:)`` returns for the same arguments.
+    public func isValidSignature<D: DataProtocol>(
+        _ signature: P256.Signing.ECDSASignature,
+        for data: D,
+        publicKey: P256.Signing.PublicKey
+    ) async -> Bool {
+        await self.isValidSignature(signature, for: SHA256.hash(data: data), publicKey: publicKey)
+    }
+
+    /// Verifies an RSA signature over a SHA-256 digest as part of a batch.
+    ///
+    /// Signatures are batched by key and padding together, so a key used with both paddings forms two groups.
+    ///
+    /// - Returns: What ``_RSA/Signing/PublicKey/isValidSignature(_:for:padding:)`` returns for the same arguments.
+    public func isValidSignature(
+        _ signature: _RSA.Signing.RSASignature,
+        for digest: SHA256.Digest,
+        padding: _RSA.Signing.Padding,
+        publicKey: _RSA.Signing.PublicKey
+    ) async -> Bool {
+        var keyRepresentation = publicKey.derRepresentation
+        keyRepresentation.append(padding.backing == .pss ? 1 : 0)
+        return await self.rsa.verify(RSAItem(publicKey: publicKey, keyRepresentation: keyRepresentation, padding: padding, signature: signature, digest: digest))
+    }
+
+    /// Verifies an RSA signature over the SHA-256 digest of `data` as part of a batch.
+    ///
+    /// - Returns: What ``_RSA/Signing/PublicKey/isValidSignature(_:for:padding:)`` returns for the same arguments.
+    public func isValidSignature<D: DataProtocol>(
+        _ signature: _RSA.Signing.RSASignature,
+        for data: D,
+        padding: _RSA.Signing.Padding,
+        publicKey: _RSA.Signing.PublicKey
+    ) async -> Bool {
+        await self.isValidSignature(signature, for: SHA256.hash(data: data), padding: padding, publicKey: publicKey)
+    }
+
+    /// Splits `items` into groups with the same key, verifies each group with `verify`, and returns the results in the
+    /// order of `items`.
+    private static func verifyGroupedByKey<Item>(
+        _ items: [Item],
+        key: (Item) -> Data,
+        verify: ([Item]) -> [Bool]
+    ) -> [Bool] {
+        var groups = [Data: [Int]]()
+        for index in items.indices {
+            groups[key(items[index]), default: []].append(index)
+        }
+        var results = [Bool](repeating: false, count: items.count)
+        for indices in groups.values {
+            for (index, result) in zip(indices, verify(indices.map { items[$0] })) {
+                results[index] = result
+            }
+        }
+        return results
+    }
+
+    fileprivate func run(_ batchCount: Int, _ verify: @escaping () -> [Bool], completion: @escaping ([Bool]) -> Void) {
+        self.statisticsLock.lock()
+        self._statistics.verifications += batchCount
+        self._statistics.batches += 1
+        self.statisticsLock.unlock()
+
+        Task {
+            // The executor only throws when the task it runs for is cancelled, which this one never is.
+            let results = (try? await self.executor.run(priority: self.priority) { _ in verify() }) ?? verify()
+            completion(results)
+        }
+    }
+}
+
+extension _SignatureVerificationService {
+    private struct Ed25519Item {
+        var item: Curve25519.Signing._BatchVerificationItem
+    }
+
+    private struct P256Item {
+        var publicKey: P256.Signing.PublicKey
+        var keyRepresentation: Data
+        var signature: P256.Signing.ECDSASignature
+        var digest: SHA256.Digest
+    }
+
+    private struct RSAItem {
+        var publicKey: _RSA.Signing.PublicKey
+        // The key's DER representation followed by a padding byte.
+        var keyRepresentation: Data
+        var padding: _RSA.Signing.Padding
+        var signature: _RSA.Signing.RSASignature
+        var digest: SHA256.Digest
+    }
+
+    /// The verifications of one kind waiting to be batched.
+    private final class Lane<Item>: @unchecked Sendable {
+        // A flush timer keeps its lane alive, and may fire after the service is gone.
+        private weak var service: _SignatureVerificationService?
+
+        private let maximumBatchSize: Int
+
+        private let maximumLatency: TimeInterval
+
+        private let timerQueue: DispatchQueue
+
+        private let verifyBatch: ([Item]) -> [Bool]
+
+        private let lock = NSLock()
+
+        // Protected by `lock`. Verifications waiting to be batched, oldest first.
+        private var pending: [(item: Item, continuation: CheckedContinuation<Bool, Never>)] = []
+
+        // Protected by `lock`. Whether a timer will dispatch `pending`.
+        private var flushScheduled = false
+
+        init(service: _SignatureVerificationService, label: String, verifyBatch: @escaping ([Item]) -> [Bool]) {
+            self.service = service
+            self.maximumBatchSize = service.maximumBatchSize
+            self.maximumLatency = service.maximumLatency
+            self.timerQueue = DispatchQueue(label: "swift-crypto.verification-service.\(label)")
+            self.verifyBatch = verifyBatch
+        }
+
+        func verify(_ item: Item) async -> Bool {
+            await withCheckedContinuation { continuation in
+                self.lock.lock()
+                self.pending.append((item, continuation))
+                if self.pending.count >= self.maximumBatchSize {
+                    let batch = self.takeBatch()
+                    self.lock.unlock()
+                    self.dispatch(batch)
+                    return
+                }
+                let scheduleFlush = !self.flushScheduled
+                self.flushScheduled = true
+                self.lock.unlock()
+
+                if scheduleFlush {
+                    self.timerQueue.asyncAfter(deadline: .now() + self.maximumLatency) {
+                        self.lock.lock()
+                        self.flushScheduled = false
+                        let batch = self.takeBatch()
+                        self.lock.unlock()
+                        self.dispatch(batch)
+                    }
+                }
+            }
+        }
+
+        // Must be called with `lock` held.
+        private func takeBatch() -> [(item: Item, continuation: CheckedContinuation<Bool, Never>)] {
+            let count = min(self.pending.count, self.maximumBatchSize)
+            let batch = Array(self.pending.prefix(count))
+            self.pending.removeFirst(count)
+            return batch
+        }
+
+        private func dispatch(_ batch: [(item: Item, continuation: CheckedContinuation<Bool, Never>)]) {
+            guard !batch.isEmpty else {
+                return
+            }
+            let items = batch.map(\.item)
+            let verifyBatch = self.verifyBatch
+            let complete = { (results: [Bool]) in
+                for (entry, result) in zip(batch, results) {
+                    entry.continuation.resume(returning: result)
+                }
+            }
+            // Each waiting caller holds the service, so it is only gone once nothing is pending. Verify here anyway
+            // rather than leave a caller waiting.
+            guard let service = self.service else {
+                complete(verifyBatch(items))
+                return
+            }
+            service.run(items.count, { verifyBatch(items) }, completion: complete)
+        }
+    }
+}
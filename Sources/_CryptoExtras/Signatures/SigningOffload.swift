@@ -0,0 +1,345 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+/// A device that computes private-key signatures away from the CPU, such as an Intel QuickAssist card.
+///
+/// BoringSSL has no asynchronous engine interface, so offload is arranged above it: a ``_SigningOffload`` gathers
+/// requests into batches, hands each batch to the provider, and resumes the waiting tasks as the provider completes
+/// them. The provider decides how keys reach the device, for example by loading each key's DER representation once
+/// and caching the device handle.
+public protocol _SigningOffloadProvider: AnyObject, Sendable {
+    /// The most requests to submit to the device in one batch.
+    var maximumBatchSize: Int { get }
+
+    /// The most requests the device should have outstanding at once. Requests beyond this are signed in software.
+    var maximumOutstandingRequests: Int { get }
+
+    /// Starts signing `requests` on the device.
+    ///
+    /// `completion` must be called exactly once, on any thread, with one result per request in the same order. Each
+    /// success holds the signature in the form ``_SigningOffloadRequest`` describes. A request that fails is signed
+    /// again in software, so a provider may fail any request it doesn't support.
+    func submit(_ requests: [_SigningOffloadRequest], completion: @escaping @Sendable ([Result<Data, Error>]) -> Void)
+}
+
+/// One signature for a ``_SigningOffloadProvider`` to compute.
+///
+/// RSA results are the signature bytes, as long as the modulus. ECDSA results are the raw `r || s` form of
+/// ``P256/Signing/ECDSASignature/rawRepresentation`` and its counterparts.
+public struct _SigningOffloadRequest: @unchecked Sendable {
+    /// The key, and the signature scheme to use it with.
+    public enum Operation {
+        /// An RSA signature with PKCS#1 v1.5 padding.
+        case rsaPKCS1v1_5(_RSA.Signing.PrivateKey)
+        /// An RSA signature with PSS padding, using MGF1 with the digest's hash function and a salt as long as the
+        /// digest.
+        case rsaPSS(_RSA.Signing.PrivateKey)
+        /// An ECDSA signature over P-256.
+        case ecdsaP256(P256.Signing.PrivateKey)
+        /// An ECDSA signature over P-384.
+        case ecdsaP384(P384.Signing.PrivateKey)
+        /// An ECDSA signature over P-521.
+        case ecdsaP521(P521.Signing.PrivateKey)
+    }
+
+    /// The hash function that produced a digest.
+    public enum DigestAlgorithm: Hashable, Sendable {
+        case sha1
+        case sha256
+        case sha384
+        case sha512
+
+        init<D: Digest>(_ digestType: D.Type) throws {
+            switch digestType {
+            case is Insecure.SHA1.Digest.Type:
+                self = .sha1
+            case is SHA256.Digest.Type:
+                self = .sha256
+            case is SHA384.Digest.Type:
+                self = .sha384
+            case is SHA512.Digest.Type:
+                self = .sha512
+            default:
+                throw CryptoKitError.incorrectParameterSize
+            }
+        }
+    }
+
+    /// The key and signature scheme.
+    public let operation: Operation
+
+    /// The hash function that produced ``digest``.
+    public let digestAlgorithm: DigestAlgorithm
+
+    /// The digest to sign.
+    public let digest: Data
+
+    /// Signs the request on the CPU, producing the same form of result a provider must.
+    let signInSoftware: () throws -> Data
+
+    init<D: Digest>(_ operation: Operation, digest: D, signInSoftware: @escaping () throws -> Data) throws {
+        self.operation = operation
+        self.digestAlgorithm = try DigestAlgorithm(D.self)
+        self.digest = Data(digest)
+        self.signInSoftware = signInSoftware
+    }
+}
+
+/// Batches signing requests to a ``_SigningOffloadProvider``, falling back to software when the device is busy or
+/// fails.
+///
+/// A request waits at most ``batchingDelay`` for others to join its batch, and a batch is submitted as soon as it
+/// reaches the provider's ``_SigningOffloadProvider/maximumBatchSize``. Once the provider has
+/// ``_SigningOffloadProvider/maximumOutstandingRequests`` requests, counting the ones still being batched, new
+/// requests are signed on the fallback executor instead of queueing behind the device. Requests the provider fails
+/// are signed there too.
+///
+/// Cancelling a task does not withdraw a request that has been batched, since a device can rarely take work back.
+public final class _SigningOffload: @unchecked Sendable {
+    /// What the offload has done since it was created.
+    public struct Statistics: Hashable, Sendable {
+        /// The requests the provider signed.
+        public var offloaded = 0
+        /// The batches submitted to the provider.
+        public var batches = 0
+        /// The requests signed in software because the provider already had its maximum outstanding.
+        public var softwareWhenSaturated = 0
+        /// The requests signed in software after the provider failed them.
+        public var softwareAfterFailure = 0
+    }
+
+    /// The device signatures are offloaded to.
+    public let provider: _SigningOffloadProvider
+
+    /// The longest a request waits for others to join its batch.
+    public let batchingDelay: TimeInterval
+
+    private let fallbackExecutor: _CryptoExecutor
+
+    private let timerQueue = DispatchQueue(label: "swift-crypto.signing-offload")
+
+    private let lock = NSLock()
+
+    // Protected by `lock`. Requests waiting to be submitted, oldest first.
+    private var pending: [Entry] = []
+
+    // Protected by `lock`. Requests batched or submitted and not yet completed.
+    private var outstanding = 0
+
+    // Protected by `lock`. Whether a timer will submit `pending`.
+    private var flushScheduled = false
+
+    // Protected by `lock`.
+    private var _statistics = Statistics()
+
+    /// Creates an offload.
+    ///
+    /// - Parameters:
+    ///   - provider: The device to offload signatures to.
+    ///   - batchingDelay: The longest a request waits for others to join its batch.
+    ///   - fallbackExecutor: Where requests are signed in software.
+    public init(provider: _SigningOffloadProvider, batchingDelay: TimeInterval = 0.0001, fallbackExecutor: _CryptoExecutor = .shared) {
+        precondition(provider.maximumBatchSize > 0)
+        precondition(batchingDelay >= 0)
+        self.provider = provider
+        self.batchingDelay = batchingDelay
+        self.fallbackExecutor = fallbackExecutor
+    }
+
+    /// What the offload has done since it was created.
+    public var statistics: Statistics {
+        self.lock.lock()
+        defer {
+            self.lock.unlock()
+        }
+        return self._statistics
+    }
+
+    func sign(_ request: _SigningOffloadRequest, priority: _CryptoExecutor.Priority) async throws -> Data {
+        self.lock.lock()
+        guard self.outstanding < self.provider.maximumOutstandingRequests else {
+            self._statistics.softwareWhenSaturated += 1
+            self.lock.unlock()
+            return try await self.fallbackExecutor.run(priority: priority) { _ in try request.signInSoftware() }
+        }
+        self.outstanding += 1
+        self.lock.unlock()
+
+        let result = await withCheckedContinuation { (continuation: CheckedContinuation<Result<Data, Error>, Never>) in
+            self.enqueue(Entry(request: request, continuation: continuation))
+        }
+        switch result {
+        case .success(let signature):
+            return signature
+        case .failure:
+            self.lock.lock()
+            self._statistics.softwareAfterFailure += 1
+            self.lock.unlock()
+            return try await self.fallbackExecutor.run(priority: priority) { _ in try request.signInSoftware() }
+        }
+    }
+
+    private func enqueue(_ entry: Entry) {
+        self.lock.lock()
+        self.pending.append(entry)
+        if self.pending.count >= self.provider.maximumBatchSize {
+            let batch = self.takeBatch()
+            self.lock.unlock()
+            self.submit(batch)
+            return
+        }
+        let scheduleFlush = !self.flushScheduled
+        self.flushScheduled = true
+        self.lock.unlock()
+
+        if scheduleFlush {
+            self.timerQueue.asyncAfter(deadline: .now() + self.batchingDelay) {
+                self.lock.lock()
+                self.flushScheduled = false
+                let batch = self.takeBatch()
+                self.lock.unlock()
+                self.submit(batch)
+            }
+        }
+    }
+
+    // Must be called with `lock` held.
+    private func takeBatch() -> [Entry] {
+        let count = min(self.pending.count, self.provider.maximumBatchSize)
+        let batch = Array(self.pending.prefix(count))
+        self.pending.removeFirst(count)
+        if count > 0 {
+            self._statistics.batches += 1
+        }
+        return batch
+    }
+
+    private func submit(_ batch: [Entry]) {
+        guard !batch.isEmpty else {
+            return
+        }
+        self.provider.submit(batch.map(\.request)) { results in
+            var offloaded = 0
+            for (index, entry) in batch.enumerated() {
+                // A provider that returns too few results fails the rest.
+                let result = index < results.count ? results[index] : .failure(CryptoKitError.internalBoringSSLError())
+                if case .success = result {
+                    offloaded += 1
+                }
+                entry.continuation.resume(returning: result)
+            }
+
+            self.lock.lock()
+            self.outstanding -= batch.count
+            self._statistics.offloaded += offloaded
+            self.lock.unlock()
+        }
+    }
+}
+
+extension _SigningOffload {
+    private struct Entry {
+        var request: _SigningOffloadRequest
+        var continuation: CheckedContinuation<Result<Data, Error>, Never>
+    }
+}
+
+extension _RSA.Signing.PrivateKey {
+    /// Generates an RSA signature over `digest`, offloading it to a device when one is free.
+    ///
+    /// - Parameters:
+    ///   - digest: The digest to sign, from SHA-1, SHA-256, SHA-384 or SHA-512.
+    ///   - padding: The padding to use.
+    ///   - offload: The offload to submit the request to.
+    ///   - priority: The priority of any software fallback on the offload's executor.
+    /// - Returns: The signature ``signature(for:padding:)`` would compute.
+    public func signature<D: Digest>(
+        for digest: D,
+        padding: _RSA.Signing.Padding,
+        offloadingTo offload: _SigningOffload,
+        priority: _CryptoExecutor.Priority = .utility
+    ) async throws -> _RSA.Signing.RSASignature {
+        let operation: _SigningOffloadRequest.Operation
+        switch padding.backing {
+        case .pkcs1v1_5:
+            operation = .rsaPKCS1v1_5(self)
+        case .pss:
+            operation = .rsaPSS(self)
+        }
+        let request = try _SigningOffloadRequest(operation, digest: digest) {
+            try self.signature(for: digest, padding: padding).rawRepresentation
+        }
+        return _RSA.Signing.RSASignature(rawRepresentation: try await offload.sign(request, priority: priority))
+    }
+}
+
+extension P256.Signing.PrivateKey {
+    /// Generates an ECDSA signature over `digest`, offloading it to a device when one is free.
+    ///
+    /// - Parameters:
+    ///   - digest: The digest to sign, from SHA-1, SHA-256, SHA-384 or SHA-512.
+    ///   - offload: The offload to submit the request to.
+    ///   - priority: The priority of any software fallback on the offload's executor.
+    public func signature<D: Digest>(
+        for digest: D,
+        offloadingTo offload: _SigningOffload,
+        priority: _CryptoExecutor.Priority = .utility
+    ) async throws -> P256.Signing.ECDSASignature {
+        let request = try _SigningOffloadRequest(.ecdsaP256(self), digest: digest) {
+            try self.signature(for: digest).rawRepresentation
+        }
+        return try P256.Signing.ECDSASignature(rawRepresentation: try await offload.sign(request, priority: priority))
+    }
+}
+
+extension P384.Signing.PrivateKey {
+    /// Generates an ECDSA signature over `digest`, offloading it to a device when one is free.
+    ///
+    /// - Parameters:
+    ///   - digest: The digest to sign, from SHA-1, SHA-256, SHA-384 or SHA-512.
+    ///   - offload: The offload to submit the request to.
+    ///   - priority: The priority of any software fallback on the offload's executor.
+    public func signature<D: Digest>(
+        for digest: D,
+        offloadingTo offload: _SigningOffload,
+        priority: _CryptoExecutor.Priority = .utility
+    ) async throws -> P384.Signing.ECDSASignature {
+        let request = try _SigningOffloadRequest(.ecdsaP384(self), digest: digest) {
+            try self.signature(for: digest).rawRepresentation
+        }
+        return try P384.Signing.ECDSASignature(rawRepresentation: try await offload.sign(request, priority: priority))
+    }
+}
+
+extension P521.Signing.PrivateKey {
+    /// Generates an ECDSA signature over `digest`, offloading it to a device when one is free.
+    ///
+    /// - Parameters:
+    ///   - digest: The digest to sign, from SHA-1, SHA-256, SHA-384 or SHA-512.
+    ///   - offload: The offload to submit the request to.
+    ///   - priority: The priority of any software fallback on the offload's executor.
+    public func signature<D: Digest>(
+        for digest: D,
+        offloadingTo offload: _SigningOffload,
+        priority: _CryptoExecutor.Priority = .utility
+    ) async throws -> P521.Signing.ECDSASignature {
+        let request = try _SigningOffloadRequest(.ecdsaP521(self), digest: digest) {
+            try self.signature(for: digest).rawRepresentation
+        }
+        return try P521.Signing.ECDSASignature(rawRepresentation: try await offload.sign(request, priority: priority))
+    }
+}
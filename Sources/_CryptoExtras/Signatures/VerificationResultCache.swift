@@ -0,0 +1,267 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+
+/// A bounded cache of successful signature verifications, for services that check the same signature over the same
+/// message with the same key again and again, such as a token presented on every request.
+///
+/// Each verification is looked up by a SHA-256 hash over the algorithm, the public key, the signature and the
+/// signed message or digest, so a repeat costs one hash instead of a scalar multiplication or a modular
+/// exponentiation. Only successes are cached: a signature that fails is verified in full every time it's presented,
+/// and can't crowd valid ones out. Each result is kept for at most ``timeToLive``, and when the cache is full the
+/// least recently used result is dropped.
+///
+/// Every method returns what the corresponding `isValidSignature` method of the public key returns. Whether a
+/// verification was answered from the cache is visible in its timing, which reveals that the same signature was
+/// verified recently.
+public final class _VerificationResultCache: @unchecked Sendable {
+    /// The size and hit rate of a cache.
+    public struct Statistics: Sendable, Hashable {
+        /// The number of cached results.
+        public var resultCount: Int
+        /// The most results the cache holds.
+        public var capacity: Int
+        /// Verifications answered from the cache.
+        public var hits: UInt64
+        /// Verifications that were checked in full, including those that found an expired result.
+        public var misses: UInt64
+        /// Results dropped to make room for another.
+        public var evictions: UInt64
+    }
+
+    private enum Algorithm: UInt8 {
+        case ed25519 = 1
+        case p256 = 2
+        case p384 = 3
+        case p521 = 4
+        case rsaPKCS1v1_5 = 5
+        case rsaPSS = 6
+    }
+
+    /// How long a result is kept, or `nil` to keep results until they are evicted.
+    public let timeToLive: TimeInterval?
+
+    // Each value is the uptime in nanoseconds after which the result is no longer used.
+    private let results: ShardedLRUCache<SHA256Digest, UInt64>
+
+    /// Creates an empty cache.
+    ///
+    /// - Parameters:
+    ///   - capacity: The most results to keep, rounded up to a multiple of `shards`. Must be positive.
+    ///   - timeToLive: How long a result is kept, or `nil` to keep results until they are evicted. Must be positive.
+    ///   - shards: The number of independently locked parts of the cache. Must be positive.
+    ///   - budget: The budget to charge the cached results to, or `nil` to bound the cache by `capacity` alone.
+    ///   - budgetWeight: The weight of the cache's share of `budget`. Must be positive.
+    public init(
+        capacity: Int = 4096,
+        timeToLive: TimeInterval? = 300,
+        shards: Int = 16,
+        budget: _CryptoCacheBudget? = .shared,
+        budgetWeight: Double = 1
+    ) {
+        precondition(timeToLive.map { $0 > 0 } ?? true)
+        self.timeToLive = timeToLive
+        // Each entry is a 32-byte hash and a deadline in the shard's tables.
+        self.results = ShardedLRUCache(
+            capacity: capacity,
+            shardCount: shards,
+            budget: budget,
+            name: "_VerificationResultCache",
+            weight: budgetWeight,
+            entryByteCount: { _, _ in 96 }
+        )
+    }
+
+    /// Drops every cached result.
+    public func removeAll() {
+        self.results.removeAll()
+    }
+
+    /// A snapshot of the cache's size and hit rate.
+    public var statistics: Statistics {
+        let statistics = self.results.statistics
+        return Statistics(
+            resultCount: statistics.count,
+            capacity: self.results.capacity,
+            hits: statistics.hits,
+            misses: statistics.misses,
+            evictions: statistics.evictions
+        )
+    }
+
+    /// Verifies an EdDSA signature over Curve25519, answering from the cache if it was verified recently.
+    ///
+    /// - Returns: What ``Curve25519/Signing/PublicKey/isValidSignature(_:for:)`` returns for the same arguments.
+    public func isValidSignature<S: DataProtocol, D: DataProtocol>(
+        _ signature: S,
+        for data: D,
+        publicKey: Curve25519.Signing.PublicKey
+    ) -> Bool {
+        let key = Self.key(.ed25519, publicKey.rawRepresentation, Data(signature), data)
+        return self.isValid(key) {
+            publicKey.isValidSignature(signature, for: data)
+        }
+    }
+
+    /// Verifies a P-256 ECDSA signature over a digest, answering from the cache if it was verified recently.
+    ///
+    /// - Returns: What ``P256/Signing/PublicKey/isValidSignature(_:for:)`` returns for the same arguments.
+    public func isValidSignature<D: Digest>(
+        _ signature: P256.Signing.ECDSASignature,
+        for digest: D,
+        publicKey: P256.Signing.PublicKey
+    ) -> Bool {
+        let key = Self.key(.p256, publicKey.x963Representation, signature.rawRepresentation, Data(digest))
+        return self.isValid(key) {
+            publicKey.isValidSignature(signature, for: digest)
+        }
+    }
+
+    /// Verifies a P-256 ECDSA signature over the SHA-256 digest of `data`, answering from the cache if it was
+    /// verified recently.
+    ///
+    /// - Returns: What ``P256/Signing/PublicKey/isValidSignature(_:for:)`` returns for the same arguments.
+    public func isValidSignature<D: DataProtocol>(
+        _ signature: P256.Signing.ECDSASignature,
+        for data: D,
+        publicKey: P256.Signing.PublicKey
+    ) -> Bool {
+        self.isValidSignature(signature, for: SHA256.hash(data: data), publicKey: publicKey)
+    }
+
+    /// Verifies a P-384 ECDSA signature over a digest, answering from the cache if it was verified recently.
+    ///
+    /// - Returns: What ``P384/Signing/PublicKey/isValidSignature(_:for:)`` returns for the same arguments.
+    public func isValidSignature<D: Digest>(
+        _ signature: P384.Signing.ECDSASignature,
+        for digest: D,
+        publicKey: P384.Signing.PublicKey
+    ) -> Bool {
+        let key = Self.key(.p384, publicKey.x963Representation, signature.rawRepresentation, Data(digest))
+        return self.isValid(key) {
+            publicKey.isValidSignature(signature, for: digest)
+        }
+    }
+
+    /// Verifies a P-384 ECDSA signature over the SHA-384 digest of `data`, answering from the cache if it was
+    /// verified recently.
+    ///
+    /// - Returns: What ``P384/Signing/PublicKey/isValidSignature(_:for:)`` returns for the same arguments.
+    public func isValidSignature<D: DataProtocol>(
+        _ signature: P384.Signing.ECDSASignature,
+        for data: D,
+        publicKey: P384.Signing.PublicKey
+    ) -> Bool {
+        self.isValidSignature(signature, for: SHA384.hash(data: data), publicKey: publicKey)
+    }
+
+    /// Verifies a P-521 ECDSA signature over a digest, answering from the cache if it was verified recently.
+    ///
+    /// - Returns: What ``P521/Signing/PublicKey/isValidSignature(_:for:)`` returns for the same arguments.
+    public func isValidSignature<D: Digest>(
+        _ signature: P521.Signing.ECDSASignature,
+        for digest: D,
+        publicKey: P521.Signing.PublicKey
+    ) -> Bool {
+        let key = Self.key(.p521, publicKey.x963Representation, signature.rawRepresentation, Data(digest))
+        return self.isValid(key) {
+            publicKey.isValidSignature(signature, for: digest)
+        }
+    }
+
+    /// Verifies a P-521 ECDSA signature over the SHA-512 digest of `data`, answering from the cache if it was
+    /// verified recently.
+    ///
+    /// - Returns: What ``P521/Signing/PublicKey/isValidSignature(_:for:)`` returns for the same arguments.
+    public func isValidSignature<D: DataProtocol>(
+        _ signature: P521.Signing.ECDSASignature,
+        for data: D,
+        publicKey: P521.Signing.PublicKey
+    ) -> Bool {
+        self.isValidSignature(signature, for: SHA512.hash(data: data), publicKey: publicKey)
+    }
+
+    /// Verifies an RSA signature over a digest, answering from the cache if it was verified recently.
+    ///
+    /// - Returns: What ``_RSA/Signing/PublicKey/isValidSignature(_:for:padding:)`` returns for the same arguments.
+    public func isValidSignature<D: Digest>(
+        _ signature: _RSA.Signing.RSASignature,
+        for digest: D,
+        padding: _RSA.Signing.Padding = .PSS,
+        publicKey: _RSA.Signing.PublicKey
+    ) -> Bool {
+        // PKCS #1 v1.5 signs the digest algorithm along with the digest, so the type is part of the key.
+        var signed = Data(String(reflecting: D.self).utf8)
+        signed.append(contentsOf: digest)
+        let key = Self.key(
+            padding.backing == .pss ? .rsaPSS : .rsaPKCS1v1_5,
+            publicKey.derRepresentation,
+            signature.rawRepresentation,
+            signed
+        )
+        return self.isValid(key) {
+            publicKey.isValidSignature(signature, for: digest, padding: padding)
+        }
+    }
+
+    /// Verifies an RSA signature over the SHA-256 digest of `data`, answering from the cache if it was verified
+    /// recently.
+    ///
+    /// - Returns: What ``_RSA/Signing/PublicKey/isValidSignature(_:for:padding:)`` returns for the same arguments.
+    public func isValidSignature<D: DataProtocol>(
+        _ signature: _RSA.Signing.RSASignature,
+        for data: D,
+        padding: _RSA.Signing.Padding = .PSS,
+        publicKey: _RSA.Signing.PublicKey
+    ) -> Bool {
+        self.isValidSignature(signature, for: SHA256.hash(data: data), padding: padding, publicKey: publicKey)
+    }
+
+    private func isValid(_ key: SHA256Digest, verify: () -> Bool) -> Bool {
+        let now = DispatchTime.now().uptimeNanoseconds
+        if self.results.value(for: key, ifUsable: { now < $0 }) != nil {
+            return true
+        }
+        guard verify() else {
+            return false
+        }
+        let deadline = self.timeToLive.map { now &+ UInt64(min($0, 1e9) * 1e9) } ?? .max
+        self.results.updateValue(deadline, for: key)
+        return true
+    }
+
+    /// Hashes the algorithm followed by each part with its length, so that no two different verifications share a
+    /// key.
+    private static func key<S: DataProtocol>(
+        _ algorithm: Algorithm,
+        _ publicKey: Data,
+        _ signature: Data,
+        _ signed: S
+    ) -> SHA256Digest {
+        var hash = SHA256()
+        hash.update(data: [algorithm.rawValue])
+        for part in [publicKey, signature] {
+            hash.update(data: Self.lengthPrefix(part.count))
+            hash.update(data: part)
+        }
+        hash.update(data: Self.lengthPrefix(signed.count))
+        hash.update(data: signed)
+        return hash.finalize()
+    }
+
+    private static func lengthPrefix(_ count: Int) -> [UInt8] {
+        withUnsafeBytes(of: UInt64(count).bigEndian) { Array($0) }
+    }
+}
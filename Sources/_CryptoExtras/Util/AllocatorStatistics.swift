@@ -0,0 +1,91 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Foundation
+import Crypto
+
+#if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+// Nothing; CryptoKit manages its own memory.
+#else
+@_implementationOnly import CCryptoBoringSSLShims
+#endif
+
+/// Reports on the optional slab allocator that serves BoringSSL's small allocations.
+///
+/// The slab allocator is compiled in when the package is built with `CRYPTO_BORINGSSL_SLAB_ALLOCATOR` defined
+/// (for CMake builds, by enabling `SWIFT_CRYPTO_SLAB_ALLOCATOR`), and only on ELF platforms. It then replaces
+/// BoringSSL's allocator for the whole process. Otherwise, and when Crypto is backed by CryptoKit, ``isEnabled``
+/// is `false` and ``sizeClasses`` is empty.
+public enum _CryptoAllocatorStatistics {
+    /// The counters for one size class.
+    public struct SizeClass: Hashable, Sendable {
+        /// The largest allocation served by this class, or `nil` for allocations too large for any class.
+        public var blockByteCount: Int?
+
+        /// The number of allocations made from this class.
+        public var allocations: UInt64
+
+        /// The number of allocations from this class that have been freed.
+        public var frees: UInt64
+
+        /// The number of allocations that were served from a thread cache without taking a lock.
+        public var cachedAllocations: UInt64
+
+        /// The total number of bytes requested from this class.
+        public var requestedBytes: UInt64
+
+        /// The number of slabs carved for this class.
+        public var slabs: UInt64
+
+        /// The number of allocations from this class that are still live.
+        public var liveAllocations: UInt64 {
+            self.allocations &- self.frees
+        }
+    }
+
+    /// Whether the slab allocator is compiled in.
+    public static var isEnabled: Bool {
+        #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+        return false
+        #else
+        return CCryptoBoringSSLShims_slab_allocator_enabled() != 0
+        #endif
+    }
+
+    /// A snapshot of the counters for every size class, smallest first, followed by the oversize class.
+    ///
+    /// Counters are updated without synchronization between them, so a snapshot taken while other threads are
+    /// allocating may be slightly inconsistent.
+    public static var sizeClasses: [SizeClass] {
+        #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+        return []
+        #else
+        let count = CCryptoBoringSSLShims_slab_allocator_class_count()
+        return (0..<count).compactMap { index in
+            var statistics = CCryptoBoringSSLShims_slab_statistics()
+            guard CCryptoBoringSSLShims_slab_allocator_statistics(index, &statistics) != 0 else {
+                return nil
+            }
+            return SizeClass(
+                blockByteCount: statistics.block_size == 0 ? nil : Int(statistics.block_size),
+                allocations: statistics.allocations,
+                frees: statistics.frees,
+                cachedAllocations: statistics.cached_allocations,
+                requestedBytes: statistics.requested_bytes,
+                slabs: statistics.slabs
+            )
+        }
+        #endif
+    }
+}
@@ -0,0 +1,129 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Foundation
+
+#if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+// Nothing; CryptoKit chooses its own implementations.
+#else
+@_implementationOnly import CCryptoBoringSSLShims
+#endif
+
+/// Picks BoringSSL's kernels by timing them on the running machine, rather than by feature detection alone.
+///
+/// The kernel BoringSSL's feature detection prefers isn't always the fastest. Wide vector code can lower the clock
+/// on some server parts, and virtual machines sometimes advertise extensions they emulate slowly. ``tune(cacheFile:)``
+/// briefly runs the candidate kernels for AES-GCM, ChaCha20-Poly1305, SHA-256 and Montgomery multiplication. It
+/// then removes the capabilities, with ``_CryptoCPUCapabilities/restrict(removing:)``, that select a slower kernel.
+/// A candidate must be at least 5% faster to be chosen.
+///
+/// Probing takes a few tens of milliseconds. With a cache file, the decision is stored under the CPU model and its
+/// detected capabilities, so later starts on the same kind of machine apply it without probing.
+///
+/// Tuning is opt-in, and only x86-64 currently has candidates to choose between; elsewhere it changes nothing.
+public enum _CryptoAutotuner {
+    /// The timing of one primitive.
+    public struct Measurement: Hashable, Sendable {
+        /// The primitive: `"aes-gcm"`, `"chacha20-poly1305"`, `"sha256"` or `"montgomery"`.
+        public var primitive: String
+        /// The capabilities whose removal made the primitive fastest. Empty if the detected kernel was best.
+        public var removedCapabilities: _CryptoCPUCapabilities
+        /// The time for one operation with every detected capability.
+        public var defaultNanoseconds: UInt64
+        /// The time for one operation with ``removedCapabilities`` removed.
+        public var tunedNanoseconds: UInt64
+    }
+
+    /// The outcome of tuning.
+    public struct Decision: Hashable, Sendable {
+        /// The CPU model the decision was made for, or an empty string if it isn't known.
+        public var cpuModel: String
+        /// The capabilities that were removed.
+        public var removedCapabilities: _CryptoCPUCapabilities
+        /// The timings behind the decision. Empty when the decision came from the cache.
+        public var measurements: [Measurement]
+        /// Whether the decision was read from the cache file rather than measured.
+        public var isCached: Bool
+    }
+
+    /// Chooses the fastest kernels and restricts BoringSSL's capabilities to select them.
+    ///
+    /// Call this at startup, before any other use of Crypto and before starting other threads that might use it, for
+    /// the same reasons as ``_CryptoCPUCapabilities/restrict(removing:)``.
+    ///
+    /// - Parameter cacheFile: A file to read earlier decisions from and write this one to, or `nil` to always probe.
+    ///   A missing or unreadable file is treated as empty, and failing to write it is not an error.
+    /// - Returns: What was decided.
+    @discardableResult
+    public static func tune(cacheFile: URL? = nil) -> Decision {
+        #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+        return Decision(cpuModel: "", removedCapabilities: [], measurements: [], isCached: false)
+        #else
+        let cpuModel = Self.cpuModel
+        let cacheKey = "\(cpuModel)|\(String(_CryptoCPUCapabilities.current.rawValue, radix: 16))"
+        var cache = cacheFile.flatMap { try? Data(contentsOf: $0) }.flatMap { try? JSONDecoder().decode(Cache.self, from: $0) } ?? Cache()
+
+        if cache.version == Cache.currentVersion, let removed = cache.decisions[cacheKey] {
+            let removed = _CryptoCPUCapabilities(rawValue: removed)
+            _CryptoCPUCapabilities.restrict(removing: removed)
+            return Decision(cpuModel: cpuModel, removedCapabilities: removed, measurements: [], isCached: true)
+        }
+
+        var results = Array(repeating: CCryptoBoringSSLShims_autotune_result(), count: Int(CCryptoBoringSSLShims_AUTOTUNE_PRIMITIVES))
+        var removedRawValue = UInt64(0)
+        let count = results.withUnsafeMutableBufferPointer { results in
+            CCryptoBoringSSLShims_cpu_autotune(results.baseAddress, &removedRawValue)
+        }
+        let measurements = results.prefix(count).map { result in
+            Measurement(
+                primitive: String(cString: result.primitive),
+                removedCapabilities: _CryptoCPUCapabilities(rawValue: result.removed),
+                defaultNanoseconds: result.default_ns,
+                tunedNanoseconds: result.tuned_ns
+            )
+        }
+        let removed = _CryptoCPUCapabilities(rawValue: removedRawValue)
+        _CryptoCPUCapabilities.restrict(removing: removed)
+
+        if let cacheFile = cacheFile {
+            if cache.version != Cache.currentVersion {
+                cache = Cache()
+            }
+            cache.decisions[cacheKey] = removed.rawValue
+            try? JSONEncoder().encode(cache).write(to: cacheFile, options: .atomic)
+        }
+        return Decision(cpuModel: cpuModel, removedCapabilities: removed, measurements: measurements, isCached: false)
+        #endif
+    }
+
+    /// The CPU model name, or an empty string if it isn't known.
+    public static var cpuModel: String {
+        #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+        return ""
+        #else
+        var buffer = [CChar](repeating: 0, count: 64)
+        CCryptoBoringSSLShims_cpu_model(&buffer, buffer.count)
+        return String(cString: buffer)
+        #endif
+    }
+
+    private struct Cache: Codable {
+        /// Bumped when the candidates change, which makes every stored decision stale.
+        static let currentVersion = 1
+
+        var version = Self.currentVersion
+
+        /// Removed capabilities, keyed by CPU model and detected capabilities.
+        var decisions: [String: UInt64] = [:]
+    }
+}
@@ -65,6 +65,23 @@ extension Data {
     }
 }
 
+extension Data {
+    /// Creates data whose storage is a fresh buffer of exactly `byteCount` bytes, which `marshal` fills.
+    ///
+    /// `marshal` receives the buffer and its size, and returns one if it wrote exactly that many bytes. The buffer
+    /// becomes the data's storage without being copied.
+    init(marshallingExactly byteCount: Int, _ marshal: (UnsafeMutablePointer<UInt8>, Int) -> CInt) {
+        // We force unwrap to trigger crashes if the allocation fails.
+        let buffer = malloc(max(byteCount, 1))!.bindMemory(to: UInt8.self, capacity: byteCount)
+        guard marshal(buffer, byteCount) == 1 else {
+            free(buffer)
+            // This should only fire on internal consistency errors.
+            preconditionFailure("Marshalled size did not match the computed size")
+        }
+        self = Data(bytesNoCopy: buffer, count: byteCount, deallocator: .free)
+    }
+}
+
 extension String {
     init(copyingUTF8MemoryBIO bio: UnsafeMutablePointer<BIO>) throws {
         var innerPointer: UnsafePointer<UInt8>? = nil
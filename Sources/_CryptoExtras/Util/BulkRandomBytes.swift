@@ -0,0 +1,50 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Foundation
+import Crypto
+
+extension _CryptoRandom {
+    /// Fills `buffer` with cryptographically secure random bytes, optimised for large outputs.
+    ///
+    /// Every 1 MiB of output is the AES-256-CTR keystream under a fresh key and counter drawn from the system's
+    /// secure random source. The keystream uses the widest AES-CTR kernel the CPU supports. For outputs of more than a
+    /// few kilobytes, such as padding, test data or batches of key material, this is much faster than requesting random
+    /// bytes in small pieces.
+    ///
+    /// When Crypto is backed by CryptoKit this uses the system random number generator directly.
+    ///
+    /// - Parameter buffer: The buffer to fill.
+    public static func _fillWithBulkRandomBytes(_ buffer: UnsafeMutableRawBufferPointer) {
+        #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+        buffer.initializeWithRandomBytes(count: buffer.count)
+        #else
+        OpenSSLBulkRandomImpl.fill(buffer)
+        #endif
+    }
+
+    /// Returns `count` cryptographically secure random bytes, optimised for large outputs.
+    ///
+    /// See ``_fillWithBulkRandomBytes(_:)`` for details of how the bytes are produced.
+    ///
+    /// - Parameter count: The number of bytes to generate.
+    /// - Returns: The random bytes.
+    public static func _bulkRandomBytes(count: Int) -> Data {
+        precondition(count >= 0)
+        var bytes = Data(repeating: 0, count: count)
+        bytes.withUnsafeMutableBytes { buffer in
+            Self._fillWithBulkRandomBytes(buffer)
+        }
+        return bytes
+    }
+}
@@ -0,0 +1,72 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+#if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+// This is only used when bulding with BoringSSL.
+#else
+@_implementationOnly import CCryptoBoringSSL
+import Crypto
+import Foundation
+
+enum OpenSSLBulkRandomImpl {
+    /// The number of bytes produced under each key before drawing a new one.
+    static let rekeyInterval = 1 << 20
+
+    static func fill(_ buffer: UnsafeMutableRawBufferPointer) {
+        var offset = 0
+        while offset < buffer.count {
+            let chunkCount = min(Self.rekeyInterval, buffer.count - offset)
+            Self.fillChunk(UnsafeMutableRawBufferPointer(rebasing: buffer[offset..<(offset + chunkCount)]))
+            offset += chunkCount
+        }
+    }
+
+    private static func fillChunk(_ chunk: UnsafeMutableRawBufferPointer) {
+        var keyBytes = (UInt64.zero, UInt64.zero, UInt64.zero, UInt64.zero)
+        var counter = (UInt64.zero, UInt64.zero)
+        var ecountBytes = (UInt64.zero, UInt64.zero)
+        var num = UInt32.zero
+        var key = AES_KEY()
+        defer {
+            withUnsafeMutableBytes(of: &keyBytes) { CCryptoBoringSSL_OPENSSL_cleanse($0.baseAddress, $0.count) }
+            withUnsafeMutableBytes(of: &key) { CCryptoBoringSSL_OPENSSL_cleanse($0.baseAddress, $0.count) }
+            withUnsafeMutableBytes(of: &ecountBytes) { CCryptoBoringSSL_OPENSSL_cleanse($0.baseAddress, $0.count) }
+        }
+
+        withUnsafeMutableBytes(of: &keyBytes) { keyBufferPtr in
+            keyBufferPtr.initializeWithRandomBytes(count: keyBufferPtr.count)
+            precondition(CCryptoBoringSSL_AES_set_encrypt_key(keyBufferPtr.baseAddress, UInt32(keyBufferPtr.count * 8), &key) == 0)
+        }
+        withUnsafeMutableBytes(of: &counter) { counterBufferPtr in
+            counterBufferPtr.initializeWithRandomBytes(count: counterBufferPtr.count)
+        }
+
+        // The output is the keystream, i.e. the encryption of zeros.
+        chunk.initializeMemory(as: UInt8.self, repeating: 0)
+        withUnsafeMutableBytes(of: &counter) { counterBufferPtr in
+            withUnsafeMutableBytes(of: &ecountBytes) { ecountBufferPtr in
+                CCryptoBoringSSL_AES_ctr128_encrypt(
+                    chunk.baseAddress,
+                    chunk.baseAddress,
+                    chunk.count,
+                    &key,
+                    counterBufferPtr.baseAddress,
+                    ecountBufferPtr.baseAddress,
+                    &num
+                )
+            }
+        }
+    }
+}
+#endif
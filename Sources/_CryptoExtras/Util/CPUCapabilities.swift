@@ -0,0 +1,120 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Foundation
+
+#if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+// Nothing; CryptoKit chooses its own implementations.
+#else
+@_implementationOnly import CCryptoBoringSSLShims
+#endif
+
+/// The CPU instruction set extensions that BoringSSL chooses its kernels by.
+///
+/// BoringSSL detects these once, the first time it's used. ``current`` reports the result, and
+/// ``restrict(removing:)`` stops BoringSSL from using some of them, for example to keep wide vector kernels off a
+/// host shared with latency-sensitive work. This is the supported replacement for setting `OPENSSL_ia32cap` in the
+/// environment.
+///
+/// Capabilities the compiler was told to assume, such as with `-mavx2` or on Apple silicon, are always used and
+/// can't be removed. When Crypto is backed by CryptoKit, no capabilities are reported and restricting has no
+/// effect.
+public struct _CryptoCPUCapabilities: OptionSet, Hashable, Sendable {
+    // These values match the CCryptoBoringSSLShims_CPU_* constants.
+    public let rawValue: UInt64
+
+    public init(rawValue: UInt64) {
+        self.rawValue = rawValue
+    }
+
+    /// x86 Supplemental SSE3, used by the vector-permute AES, GHASH and ChaCha20 kernels.
+    public static let ssse3 = _CryptoCPUCapabilities(rawValue: 1 << 0)
+    /// x86 SSE4.1, used by the combined ChaCha20-Poly1305 assembly.
+    public static let sse41 = _CryptoCPUCapabilities(rawValue: 1 << 1)
+    /// x86 carry-less multiplication, used by GHASH.
+    public static let pclmul = _CryptoCPUCapabilities(rawValue: 1 << 2)
+    /// x86 MOVBE, required with AVX by the combined AES-GCM assembly.
+    public static let movbe = _CryptoCPUCapabilities(rawValue: 1 << 3)
+    /// x86 AES-NI.
+    public static let aesni = _CryptoCPUCapabilities(rawValue: 1 << 4)
+    /// x86 AVX, used by AES-GCM, GHASH, SHA-2 and P-256. Removing it also removes ``avx2``, ``avx512f`` and
+    /// ``avx512ifma``.
+    public static let avx = _CryptoCPUCapabilities(rawValue: 1 << 5)
+    /// x86 AVX2, used by ChaCha20.
+    public static let avx2 = _CryptoCPUCapabilities(rawValue: 1 << 6)
+    /// x86 BMI1, required with BMI2 and ADX by the X25519 and Ed25519 kernels.
+    public static let bmi1 = _CryptoCPUCapabilities(rawValue: 1 << 7)
+    /// x86 BMI2, used by big-number, P-256 and X25519 arithmetic.
+    public static let bmi2 = _CryptoCPUCapabilities(rawValue: 1 << 8)
+    /// x86 ADX, used by big-number, P-256 and X25519 arithmetic.
+    public static let adx = _CryptoCPUCapabilities(rawValue: 1 << 9)
+    /// x86 SHA extensions, used by SHA-1 and SHA-256.
+    public static let sha = _CryptoCPUCapabilities(rawValue: 1 << 10)
+    /// x86 AVX-512 Foundation. BoringSSL has no AVX-512 kernels, but this package's ChaCha20 uses it.
+    public static let avx512f = _CryptoCPUCapabilities(rawValue: 1 << 11)
+    /// x86 AVX-512 integer fused multiply-add, used with ``avx512f`` by batched P-256 key agreement.
+    public static let avx512ifma = _CryptoCPUCapabilities(rawValue: 1 << 12)
+    /// Arm NEON (Advanced SIMD).
+    public static let neon = _CryptoCPUCapabilities(rawValue: 1 << 32)
+    /// Armv8 AES instructions.
+    public static let armv8AES = _CryptoCPUCapabilities(rawValue: 1 << 33)
+    /// Armv8 polynomial multiplication, used by GHASH.
+    public static let armv8PMULL = _CryptoCPUCapabilities(rawValue: 1 << 34)
+    /// Armv8 SHA-1 instructions.
+    public static let armv8SHA1 = _CryptoCPUCapabilities(rawValue: 1 << 35)
+    /// Armv8 SHA-256 instructions.
+    public static let armv8SHA256 = _CryptoCPUCapabilities(rawValue: 1 << 36)
+    /// Armv8.2 SHA-512 instructions.
+    public static let armv8SHA512 = _CryptoCPUCapabilities(rawValue: 1 << 37)
+
+    /// The capabilities BoringSSL uses on this machine.
+    public static var current: _CryptoCPUCapabilities {
+        #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+        return []
+        #else
+        return _CryptoCPUCapabilities(rawValue: CCryptoBoringSSLShims_cpu_capabilities())
+        #endif
+    }
+
+    /// Stops BoringSSL from using `capabilities` for the rest of the process.
+    ///
+    /// Call this at startup, before any other use of Crypto and before starting other threads that might use it.
+    /// Keys and contexts that already exist keep the kernels they chose when they were set up, and the capability
+    /// words are not updated atomically. Capabilities can't be added back.
+    ///
+    /// - Parameter capabilities: The capabilities to stop using.
+    /// - Returns: The capabilities BoringSSL uses from now on. Any of `capabilities` that remain were assumed at
+    ///   compile time.
+    @discardableResult
+    public static func restrict(removing capabilities: _CryptoCPUCapabilities) -> _CryptoCPUCapabilities {
+        #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+        return []
+        #else
+        return _CryptoCPUCapabilities(rawValue: CCryptoBoringSSLShims_cpu_restrict_capabilities(capabilities.rawValue))
+        #endif
+    }
+}
+
+extension _CryptoCPUCapabilities: CustomStringConvertible {
+    private static let names: [(_CryptoCPUCapabilities, String)] = [
+        (.ssse3, "ssse3"), (.sse41, "sse4.1"), (.pclmul, "pclmul"), (.movbe, "movbe"), (.aesni, "aes-ni"),
+        (.avx, "avx"), (.avx2, "avx2"), (.bmi1, "bmi1"), (.bmi2, "bmi2"), (.adx, "adx"), (.sha, "sha"),
+        (.avx512f, "avx512f"), (.avx512ifma, "avx512ifma"), (.neon, "neon"), (.armv8AES, "armv8-aes"),
+        (.armv8PMULL, "armv8-pmull"), (.armv8SHA1, "armv8-sha1"), (.armv8SHA256, "armv8-sha256"),
+        (.armv8SHA512, "armv8-sha512"),
+    ]
+
+    public var description: String {
+        "[" + Self.names.filter { self.contains($0.0) }.map(\.1).joined(separator: ", ") + "]"
+    }
+}
@@ -0,0 +1,356 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Foundation
+
+/// A byte budget shared by the caches of this module, so that together they stay bounded however many of them are
+/// in use.
+///
+/// Each cache estimates the memory of its entries and charges it to a budget, ``shared`` unless it was given
+/// another one. When the caches of a budget hold more than ``byteLimit`` bytes between them, the ones holding more
+/// than their share drop their least recently used entries until the total fits. The limit is shared out in
+/// proportion to the caches' weights, and the share of a cache that needs less than its own is handed to the rest.
+///
+/// Under memory pressure, ``handleMemoryPressure(_:)`` halves every cache, or on ``MemoryPressure/critical``
+/// empties them, and then calls the handlers added with ``addMemoryPressureHandler(_:)``. On Apple platforms
+/// ``monitorSystemMemoryPressure()`` does that whenever the system reports pressure.
+///
+/// The byte counts are estimates of what a cache keeps alive, not exact measurements of the heap.
+public final class _CryptoCacheBudget: @unchecked Sendable {
+    /// How urgently memory should be given back.
+    public enum MemoryPressure: Hashable, Sendable {
+        /// Every cache drops its older half.
+        case warning
+        /// Every cache drops everything.
+        case critical
+    }
+
+    /// The size and evictions of one cache charged to a budget.
+    public struct CacheStatistics: Hashable, Sendable {
+        /// The kind of cache.
+        public var name: String
+        /// The weight the cache's share of the limit is reckoned by.
+        public var weight: Double
+        /// The estimated bytes the cache holds.
+        public var byteCount: Int
+        /// Entries dropped to keep the budget within its limit.
+        public var budgetEvictions: UInt64
+        /// The estimated bytes of those entries.
+        public var budgetEvictedBytes: UInt64
+        /// Entries dropped because of memory pressure.
+        public var pressureEvictions: UInt64
+        /// The estimated bytes of those entries.
+        public var pressureEvictedBytes: UInt64
+    }
+
+    /// A snapshot of a budget.
+    public struct Statistics: Hashable, Sendable {
+        /// The most bytes the caches hold between them.
+        public var byteLimit: Int
+        /// The estimated bytes the caches hold.
+        public var byteCount: Int
+        /// The caches charged to the budget, in the order they were created.
+        public var caches: [CacheStatistics]
+    }
+
+    /// The budget caches are charged to by default.
+    public static let shared = _CryptoCacheBudget(byteLimit: 64 * 1024 * 1024)
+
+    private let lock = NSLock()
+
+    // Protected by `lock`.
+    private var _byteLimit: Int
+
+    // Protected by `lock`.
+    private var byteCount = 0
+
+    // Protected by `lock`. Registrations remove themselves when their cache goes away.
+    private var members: [ObjectIdentifier: WeakMember] = [:]
+
+    // Protected by `lock`.
+    private var nextMemberOrder = 0
+
+    // Protected by `lock`. Whether a thread is trimming caches to fit the limit.
+    private var enforcing = false
+
+    // Protected by `lock`.
+    private var pressureHandlers: [@Sendable (MemoryPressure) -> Void] = []
+
+    // Protected by `lock`.
+    private var pressureSource: AnyObject?
+
+    /// Creates a budget.
+    ///
+    /// - Parameter byteLimit: The most bytes the caches charged to the budget hold between them. Must not be
+    ///   negative.
+    public init(byteLimit: Int) {
+        precondition(byteLimit >= 0)
+        self._byteLimit = byteLimit
+    }
+
+    /// The most bytes the caches charged to the budget hold between them.
+    ///
+    /// Lowering the limit trims the caches straight away.
+    public var byteLimit: Int {
+        get {
+            self.lock.lock()
+            defer {
+                self.lock.unlock()
+            }
+            return self._byteLimit
+        }
+        set {
+            precondition(newValue >= 0)
+            self.lock.lock()
+            self._byteLimit = newValue
+            self.lock.unlock()
+            self.enforceLimit()
+        }
+    }
+
+    /// A snapshot of the budget and the caches charged to it.
+    public var statistics: Statistics {
+        self.lock.lock()
+        defer {
+            self.lock.unlock()
+        }
+        let caches = self.members.values.compactMap { $0.member }.sorted { $0.order < $1.order }.map {
+            CacheStatistics(
+                name: $0.name,
+                weight: $0.weight,
+                byteCount: $0.byteCount,
+                budgetEvictions: $0.budgetEvictions,
+                budgetEvictedBytes: $0.budgetEvictedBytes,
+                pressureEvictions: $0.pressureEvictions,
+                pressureEvictedBytes: $0.pressureEvictedBytes
+            )
+        }
+        return Statistics(byteLimit: self._byteLimit, byteCount: self.byteCount, caches: caches)
+    }
+
+    /// Gives memory back from every cache charged to the budget, then calls the memory pressure handlers.
+    public func handleMemoryPressure(_ pressure: MemoryPressure) {
+        self.lock.lock()
+        let targets = self.members.values.compactMap { $0.member }.map { member -> (Member, Int) in
+            switch pressure {
+            case .warning:
+                return (member, member.byteCount / 2)
+            case .critical:
+                return (member, 0)
+            }
+        }
+        let handlers = self.pressureHandlers
+        self.lock.unlock()
+
+        for (member, target) in targets {
+            let trimmed = member.trim(target)
+            self.lock.lock()
+            member.byteCount -= trimmed.bytes
+            self.byteCount -= trimmed.bytes
+            member.pressureEvictions += UInt64(trimmed.entries)
+            member.pressureEvictedBytes += UInt64(trimmed.bytes)
+            self.lock.unlock()
+        }
+        for handler in handlers {
+            handler(pressure)
+        }
+    }
+
+    /// Adds a closure that ``handleMemoryPressure(_:)`` calls after trimming the caches, for memory the caller
+    /// keeps outside them.
+    public func addMemoryPressureHandler(_ handler: @escaping @Sendable (MemoryPressure) -> Void) {
+        self.lock.lock()
+        defer {
+            self.lock.unlock()
+        }
+        self.pressureHandlers.append(handler)
+    }
+
+    /// Calls ``handleMemoryPressure(_:)`` whenever the system reports memory pressure, from now on.
+    ///
+    /// - Returns: Whether the system reports memory pressure on this platform. Only Apple platforms do; elsewhere
+    ///   this does nothing.
+    @discardableResult
+    public func monitorSystemMemoryPressure() -> Bool {
+        #if canImport(Darwin)
+        self.lock.lock()
+        defer {
+            self.lock.unlock()
+        }
+        guard self.pressureSource == nil else {
+            return true
+        }
+        let source = DispatchSource.makeMemoryPressureSource(eventMask: [.warning, .critical], queue: .global(qos: .utility))
+        source.setEventHandler { [weak self, unowned source] in
+            self?.handleMemoryPressure(source.data.contains(.critical) ? .critical : .warning)
+        }
+        source.activate()
+        self.pressureSource = source
+        return true
+        #else
+        return false
+        #endif
+    }
+
+    /// Charges a new cache to the budget.
+    ///
+    /// - Parameters:
+    ///   - name: The kind of cache, for ``statistics``.
+    ///   - weight: The weight the cache's share of the limit is reckoned by. Must be positive.
+    ///   - trim: Drops the cache's least recently used entries until it holds at most the given number of bytes, and
+    ///     returns how many entries and bytes it dropped. It must not charge what it drops to the registration.
+    func register(
+        name: String,
+        weight: Double,
+        trim: @escaping (Int) -> (entries: Int, bytes: Int)
+    ) -> Registration {
+        precondition(weight > 0)
+        let member = Member(name: name, weight: weight, trim: trim)
+        let registration = Registration(budget: self, member: member)
+        self.lock.lock()
+        member.order = self.nextMemberOrder
+        self.nextMemberOrder += 1
+        self.members[ObjectIdentifier(member)] = WeakMember(member)
+        self.lock.unlock()
+        return registration
+    }
+
+    fileprivate func charge(_ member: Member, _ delta: Int) {
+        self.lock.lock()
+        member.byteCount += delta
+        self.byteCount += delta
+        let overLimit = self.byteCount > self._byteLimit
+        self.lock.unlock()
+
+        if overLimit {
+            self.enforceLimit()
+        }
+    }
+
+    fileprivate func unregister(_ member: Member) {
+        self.lock.lock()
+        defer {
+            self.lock.unlock()
+        }
+        self.members.removeValue(forKey: ObjectIdentifier(member))
+        self.byteCount -= member.byteCount
+    }
+
+    /// Trims the caches that hold more than their share until the total fits the limit. A thread arriving while
+    /// another one is trimming leaves the work to it.
+    private func enforceLimit() {
+        self.lock.lock()
+        guard !self.enforcing else {
+            self.lock.unlock()
+            return
+        }
+        self.enforcing = true
+
+        // Caches may grow again while they are trimmed, so keep going until the total fits or nothing was dropped.
+        while self.byteCount > self._byteLimit {
+            let targets = self.targets()
+            self.lock.unlock()
+
+            var dropped = 0
+            for (member, target) in targets {
+                let trimmed = member.trim(target)
+                dropped += trimmed.entries
+                self.lock.lock()
+                member.byteCount -= trimmed.bytes
+                self.byteCount -= trimmed.bytes
+                member.budgetEvictions += UInt64(trimmed.entries)
+                member.budgetEvictedBytes += UInt64(trimmed.bytes)
+                self.lock.unlock()
+            }
+
+            self.lock.lock()
+            if dropped == 0 {
+                break
+            }
+        }
+        self.enforcing = false
+        self.lock.unlock()
+    }
+
+    /// Shares out the limit by weight, handing the share a cache doesn't need to the others, and returns the caches
+    /// holding more than their share along with it. Must be called with `lock` held.
+    private func targets() -> [(Member, Int)] {
+        var active = self.members.values.compactMap { $0.member }.filter { $0.byteCount > 0 }
+        var remaining = Double(self._byteLimit)
+        while !active.isEmpty {
+            let totalWeight = active.reduce(0) { $0 + $1.weight }
+            let fitting = active.filter { Double($0.byteCount) <= remaining * $0.weight / totalWeight }
+            guard !fitting.isEmpty else {
+                return active.map { ($0, Int(remaining * $0.weight / totalWeight)) }
+            }
+            for member in fitting {
+                remaining -= Double(member.byteCount)
+            }
+            active.removeAll { member in fitting.contains { $0 === member } }
+        }
+        return []
+    }
+}
+
+extension _CryptoCacheBudget {
+    /// A cache's place in a budget. The cache charges the estimated bytes of what it inserts and removes, and the
+    /// registration leaves the budget when it's released.
+    final class Registration: @unchecked Sendable {
+        private let budget: _CryptoCacheBudget
+
+        fileprivate let member: Member
+
+        fileprivate init(budget: _CryptoCacheBudget, member: Member) {
+            self.budget = budget
+            self.member = member
+        }
+
+        func charge(_ delta: Int) {
+            if delta != 0 {
+                self.budget.charge(self.member, delta)
+            }
+        }
+
+        deinit {
+            self.budget.unregister(self.member)
+        }
+    }
+
+    fileprivate final class Member {
+        let name: String
+        let weight: Double
+        let trim: (Int) -> (entries: Int, bytes: Int)
+
+        // The rest is protected by the budget's lock.
+        var order = 0
+        var byteCount = 0
+        var budgetEvictions: UInt64 = 0
+        var budgetEvictedBytes: UInt64 = 0
+        var pressureEvictions: UInt64 = 0
+        var pressureEvictedBytes: UInt64 = 0
+
+        init(name: String, weight: Double, trim: @escaping (Int) -> (entries: Int, bytes: Int)) {
+            self.name = name
+            self.weight = weight
+            self.trim = trim
+        }
+    }
+
+    fileprivate struct WeakMember {
+        weak var member: Member?
+
+        init(_ member: Member) {
+            self.member = member
+        }
+    }
+}
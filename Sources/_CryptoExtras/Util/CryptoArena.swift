@@ -0,0 +1,113 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Foundation
+import Crypto
+
+#if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+// Nothing; CryptoKit manages its own memory.
+#else
+@_implementationOnly import CCryptoBoringSSLShims
+#endif
+
+/// Serves the temporary BoringSSL allocations of one operation from a request-scoped arena.
+///
+/// One operation, such as importing a PEM key and verifying a signature with it, allocates in many parts of
+/// BoringSSL. Inside ``withArena(regionByteCount:_:)`` each of those allocations on the calling thread is bumped
+/// from a few large regions, freeing costs nothing, and at the end of the scope the regions are cleansed and
+/// released together.
+///
+/// Anything created inside the scope that outlives it, such as a key returned from `body`, stays valid: its memory
+/// keeps the arena's regions alive until it's freed, at which point it's cleansed. Scopes are best kept to work
+/// whose results are plain values, so that the regions are released at once.
+///
+/// Arenas are compiled in when the package is built with `CRYPTO_BORINGSSL_ARENAS` defined (for CMake builds, by
+/// enabling `SWIFT_CRYPTO_ARENAS`), and only on ELF platforms. They then take over the allocator hooks of this
+/// package's copy of BoringSSL, leaving any other copy in the process alone, and allocations made outside an arena
+/// go to the heap, or the slab allocator if that is also compiled in, with a 16-byte header of their own. Otherwise, and when Crypto is backed by CryptoKit,
+/// ``isEnabled`` is `false` and `body` runs as it would without an arena.
+public enum _CryptoArena {
+    /// What the innermost arena on a thread has served so far.
+    public struct Statistics: Hashable, Sendable {
+        /// The number of allocations made from the arena.
+        public var allocations: UInt64
+
+        /// The total number of bytes requested from the arena.
+        public var allocatedBytes: UInt64
+
+        /// The number of allocations from the arena that haven't been freed yet.
+        public var liveAllocations: UInt64
+
+        /// The number of regions the arena has reserved.
+        public var regions: UInt64
+
+        /// The total number of bytes in those regions.
+        public var reservedBytes: UInt64
+    }
+
+    /// The default size of each region.
+    public static let defaultRegionByteCount = 16 * 1024
+
+    /// Whether arenas are compiled in.
+    public static var isEnabled: Bool {
+        #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+        return false
+        #else
+        return CCryptoBoringSSLShims_arena_enabled() != 0
+        #endif
+    }
+
+    /// Runs `body` with an arena installed on the calling thread.
+    ///
+    /// Arenas nest, so a scope inside another has an arena of its own. Work that `body` hands to other threads,
+    /// including the batch and parallel APIs of this module, allocates outside the arena.
+    ///
+    /// - Parameters:
+    ///   - regionByteCount: The size of each region. An allocation larger than this gets a region to itself.
+    ///   - body: The operation to run.
+    /// - Returns: The result of `body`.
+    public static func withArena<Result>(
+        regionByteCount: Int = _CryptoArena.defaultRegionByteCount,
+        _ body: () throws -> Result
+    ) rethrows -> Result {
+        precondition(regionByteCount > 0)
+        #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+        return try body()
+        #else
+        let arena = CCryptoBoringSSLShims_arena_push(regionByteCount)
+        defer {
+            CCryptoBoringSSLShims_arena_pop(arena)
+        }
+        return try body()
+        #endif
+    }
+
+    /// The statistics of the innermost arena on the calling thread, or `nil` if there is none.
+    public static var currentStatistics: Statistics? {
+        #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+        return nil
+        #else
+        var statistics = CCryptoBoringSSLShims_arena_statistics()
+        guard CCryptoBoringSSLShims_arena_current_statistics(&statistics) != 0 else {
+            return nil
+        }
+        return Statistics(
+            allocations: statistics.allocations,
+            allocatedBytes: statistics.allocated_bytes,
+            liveAllocations: statistics.live_allocations,
+            regions: statistics.regions,
+            reservedBytes: statistics.reserved_bytes
+        )
+        #endif
+    }
+}
@@ -0,0 +1,226 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+@_implementationOnly import CCryptoBoringSSLShims
+import Foundation
+
+/// A bounded pool that runs long, blocking cryptographic operations away from Swift's cooperative thread pool.
+///
+/// RSA key generation, SPHINCS+ signing, scrypt with a high cost, or hashing gigabytes of data can each hold a
+/// thread for a long time. Doing that on a cooperative thread stalls every other task scheduled there, so the
+/// `async` variants of those operations hand the work to an executor and suspend until it's done.
+///
+/// At most ``maxConcurrency`` operations run at once. The rest wait in one queue per ``Priority``, and a higher
+/// class is always started before a lower one. Cancelling the waiting task removes an operation that hasn't
+/// started yet, and asks one that is running to stop at its next cancellation check.
+public final class _CryptoExecutor: @unchecked Sendable {
+    /// How urgently an operation should run, relative to the others on the same executor.
+    public enum Priority: Int, CaseIterable, Sendable {
+        /// Work that nobody is waiting on, such as generating keys ahead of time.
+        case background
+        /// Work a caller is waiting on, but not interactively.
+        case utility
+        /// Work that blocks a user-visible result.
+        case userInitiated
+
+        fileprivate var qos: DispatchQoS {
+            switch self {
+            case .background:
+                return .background
+            case .utility:
+                return .utility
+            case .userInitiated:
+                return .userInitiated
+            }
+        }
+    }
+
+    /// An executor shared by the whole process, running one operation per active processor.
+    public static let shared = _CryptoExecutor(maxConcurrency: ProcessInfo.processInfo.activeProcessorCount)
+
+    /// The most operations that run at once.
+    public let maxConcurrency: Int
+
+    private let queues: [DispatchQueue]
+
+    private let lock = NSLock()
+
+    // Protected by `lock`. Operations waiting for a slot, indexed by priority, oldest first.
+    private var pending: [[Job]]
+
+    // Protected by `lock`.
+    private var running = 0
+
+    /// Creates an executor.
+    ///
+    /// - Parameter maxConcurrency: The most operations that run at once. Must be positive.
+    public init(maxConcurrency: Int) {
+        precondition(maxConcurrency > 0)
+        self.maxConcurrency = maxConcurrency
+        self.queues = Priority.allCases.map { priority in
+            DispatchQueue(label: "swift-crypto.executor.\(priority)", qos: priority.qos, attributes: .concurrent)
+        }
+        self.pending = Array(repeating: [], count: Priority.allCases.count)
+    }
+
+    /// Runs `operation` on the executor and suspends until it returns.
+    ///
+    /// `operation` receives a ``_CryptoCancellation`` that it should check during long loops, so that cancelling the
+    /// calling task can stop it early.
+    ///
+    /// - Throws: `CancellationError` if the task was cancelled before `operation` started, and otherwise whatever
+    ///   `operation` throws.
+    public func run<Result>(priority: Priority = .utility, _ operation: @escaping (_CryptoCancellation) throws -> Result) async throws -> Result {
+        let cancellation = _CryptoCancellation()
+        return try await withTaskCancellationHandler {
+            try await withCheckedThrowingContinuation { (continuation: CheckedContinuation<Result, Error>) in
+                let job = Job(priority: priority, cancellation: cancellation, run: {
+                    continuation.resume(with: Swift.Result { try operation(cancellation) })
+                }, abandon: {
+                    continuation.resume(throwing: CancellationError())
+                })
+                self.submit(job)
+            }
+        } onCancel: {
+            cancellation.cancel()
+            self.abandonCancelledJobs()
+        }
+    }
+
+    /// The number of operations waiting for a slot.
+    var pendingJobCount: Int {
+        self.lock.lock()
+        defer {
+            self.lock.unlock()
+        }
+        return self.pending.reduce(0) { $0 + $1.count }
+    }
+
+    private func submit(_ job: Job) {
+        self.lock.lock()
+        if job.cancellation.isCancelled {
+            // The task was cancelled before it got here, so the cancellation handler had nothing to remove.
+            self.lock.unlock()
+            job.abandon()
+            return
+        }
+        self.pending[job.priority.rawValue].append(job)
+        self.lock.unlock()
+
+        self.startJobs()
+    }
+
+    /// Starts waiting jobs, highest priority first, while there are free slots.
+    private func startJobs() {
+        while let job = self.claimNextJob() {
+            self.queues[job.priority.rawValue].async {
+                if job.cancellation.isCancelled {
+                    job.abandon()
+                } else {
+                    job.run()
+                }
+                self.lock.lock()
+                self.running -= 1
+                self.lock.unlock()
+                self.startJobs()
+            }
+        }
+    }
+
+    private func claimNextJob() -> Job? {
+        self.lock.lock()
+        defer {
+            self.lock.unlock()
+        }
+        guard self.running < self.maxConcurrency else {
+            return nil
+        }
+        for priority in Priority.allCases.reversed() where !self.pending[priority.rawValue].isEmpty {
+            self.running += 1
+            return self.pending[priority.rawValue].removeFirst()
+        }
+        return nil
+    }
+
+    private func abandonCancelledJobs() {
+        var abandoned: [Job] = []
+        self.lock.lock()
+        for priority in Priority.allCases {
+            abandoned.append(contentsOf: self.pending[priority.rawValue].filter { $0.cancellation.isCancelled })
+            self.pending[priority.rawValue].removeAll { $0.cancellation.isCancelled }
+        }
+        self.lock.unlock()
+
+        // Resume outside the lock: a continuation may run its task inline.
+        for job in abandoned {
+            job.abandon()
+        }
+    }
+}
+
+extension _CryptoExecutor {
+    // Exactly one of `run` and `abandon` is called, by whichever of the executor's paths removes the job from
+    // `pending`.
+    private final class Job {
+        let priority: Priority
+        let cancellation: _CryptoCancellation
+        let run: () -> Void
+        let abandon: () -> Void
+
+        init(priority: Priority, cancellation: _CryptoCancellation, run: @escaping () -> Void, abandon: @escaping () -> Void) {
+            self.priority = priority
+            self.cancellation = cancellation
+            self.run = run
+            self.abandon = abandon
+        }
+    }
+}
+
+/// Lets an operation running on a ``_CryptoExecutor`` notice that the task waiting for it has been cancelled.
+///
+/// The flag is also visible to BoringSSL-level loops that take it, so they can stop without returning to Swift.
+public final class _CryptoCancellation: @unchecked Sendable {
+    private let flag: UnsafeMutablePointer<CCryptoBoringSSLShims_CANCEL_FLAG>
+
+    init() {
+        self.flag = .allocate(capacity: 1)
+        self.flag.initialize(to: CCryptoBoringSSLShims_CANCEL_FLAG())
+    }
+
+    deinit {
+        self.flag.deallocate()
+    }
+
+    /// Whether the task waiting for the operation has been cancelled.
+    public var isCancelled: Bool {
+        CCryptoBoringSSLShims_CANCEL_FLAG_is_set(self.flag) == 1
+    }
+
+    /// Throws `CancellationError` if the task waiting for the operation has been cancelled.
+    public func checkCancellation() throws {
+        if self.isCancelled {
+            throw CancellationError()
+        }
+    }
+
+    func cancel() {
+        CCryptoBoringSSLShims_CANCEL_FLAG_set(self.flag)
+    }
+
+    /// Calls `body` with the flag in the form BoringSSL-level loops take. The pointer must not escape `body`.
+    func withFlagPointer<Result>(_ body: (UnsafePointer<CCryptoBoringSSLShims_CANCEL_FLAG>) throws -> Result) rethrows -> Result {
+        try withExtendedLifetime(self) {
+            try body(self.flag)
+        }
+    }
+}
@@ -15,3 +15,12 @@
 public enum _CryptoRSAError: Error {
     case invalidPEMDocument
 }
+
+public enum _CryptoTrustStoreError: Error {
+    /// The bundle held an object that could not be split out or parsed, starting at `offset` bytes into it.
+    case malformedBundle(offset: Int)
+    /// The snapshot was malformed or corrupted, or the store already had one.
+    case malformedSnapshot
+    /// The certificate directory could not be read, or the store already had one.
+    case unreadableDirectory
+}
@@ -0,0 +1,114 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Foundation
+import Crypto
+
+#if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+// Nothing; CryptoKit chooses its own implementations.
+#else
+@_implementationOnly import CCryptoBoringSSLShims
+#endif
+
+/// Reports which implementation of each primitive is used on the running machine.
+///
+/// BoringSSL picks between several implementations of its hash, cipher and field arithmetic kernels at runtime,
+/// based on the instructions the CPU supports and any restriction made with ``_CryptoCPUCapabilities``. These
+/// properties report that choice, so that deployments can confirm that hardware acceleration is in use. Values are short identifiers such as `"sha-ni"`, `"armv8-sha512"`, `"avx"`,
+/// `"aes-ni"` or `"c"`; they are intended for logging and metrics, and their spelling may change between releases.
+///
+/// When Crypto is backed by CryptoKit, every string property returns `"cryptokit"`.
+public enum _CryptoImplementationReport {
+    /// The implementation used for SHA-256.
+    public static var sha256: String {
+        #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+        return "cryptokit"
+        #else
+        return String(cString: CCryptoBoringSSLShims_SHA256_implementation())
+        #endif
+    }
+
+    /// The implementation used for SHA-384 and SHA-512.
+    public static var sha512: String {
+        #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+        return "cryptokit"
+        #else
+        return String(cString: CCryptoBoringSSLShims_SHA512_implementation())
+        #endif
+    }
+
+    /// The implementation used for the AES block cipher, including AES-GCM.
+    public static var aes: String {
+        #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+        return "cryptokit"
+        #else
+        return String(cString: CCryptoBoringSSLShims_AES_implementation())
+        #endif
+    }
+
+    /// The implementation used for P-256: `"nistz256"` for the assembly implementation with its 150 KB fixed-base
+    /// table, or `"fiat"` for the portable one with a 2 KB table, which builds with `SWIFT_CRYPTO_SMALL_TABLES`
+    /// always use.
+    public static var p256: String {
+        #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+        return "cryptokit"
+        #else
+        return String(cString: CCryptoBoringSSLShims_P256_implementation())
+        #endif
+    }
+
+    /// The implementation used for GHASH, the authenticator in AES-GCM and GMAC.
+    public static var ghash: String {
+        #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+        return "cryptokit"
+        #else
+        return String(cString: CCryptoBoringSSLShims_GHASH_implementation())
+        #endif
+    }
+
+    /// The implementation used for the ChaCha20 stream cipher on messages longer than 192 bytes. Shorter messages
+    /// may use a narrower kernel.
+    public static var chaCha20: String {
+        #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+        return "cryptokit"
+        #else
+        return String(cString: CCryptoBoringSSLShims_ChaCha20_implementation())
+        #endif
+    }
+
+    /// The implementation used for ChaCha20-Poly1305: `"sse4.1"` or `"neon"` for the combined assembly, or `"c"`
+    /// when ChaCha20 and Poly1305 run separately.
+    public static var chaChaPoly: String {
+        #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+        return "cryptokit"
+        #else
+        return String(cString: CCryptoBoringSSLShims_ChaCha20Poly1305_implementation())
+        #endif
+    }
+
+    /// The implementation used for X25519 and Ed25519 field arithmetic: `"adx"`, `"neon"`, or the portable
+    /// `"fiat"`.
+    public static var x25519: String {
+        #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+        return "cryptokit"
+        #else
+        return String(cString: CCryptoBoringSSLShims_X25519_implementation())
+        #endif
+    }
+
+    /// The CPU capabilities BoringSSL uses on this machine, after any ``_CryptoCPUCapabilities/restrict(removing:)``.
+    public static var cpuCapabilities: _CryptoCPUCapabilities {
+        _CryptoCPUCapabilities.current
+    }
+}
@@ -0,0 +1,182 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Foundation
+import Crypto
+
+#if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+// Nothing; CryptoKit is not instrumented.
+#else
+@_implementationOnly import CCryptoBoringSSLShims
+#endif
+
+/// Counts allocations and other hot-path events inside BoringSSL.
+///
+/// Instrumentation is compiled in when the package is built with `CRYPTO_BORINGSSL_INSTRUMENTATION` defined: for
+/// CMake builds, by enabling `SWIFT_CRYPTO_INSTRUMENTATION`, and for SwiftPM builds with
+/// `-Xcc -DCRYPTO_BORINGSSL_INSTRUMENTATION`, which Swift's view of the shims' header needs as well. Each thread keeps
+/// its own counters, so taking a ``currentThread`` snapshot before and after an operation and subtracting one from the
+/// other attributes events to that operation, even while other threads are busy.
+///
+/// Allocations are counted through BoringSSL's allocation hooks, which only exist on ELF platforms. Random bytes,
+/// AEAD operations and digest updates are counted on every platform with pthreads. When instrumentation is not
+/// compiled in, or Crypto is backed by CryptoKit, every counter is zero.
+public enum _CryptoInstrumentation {
+    /// A snapshot of the event counters.
+    public struct Counters: Hashable, Sendable {
+        /// Allocations made by BoringSSL, and the number of bytes they requested.
+        public var allocations: UInt64 = 0
+        public var allocatedBytes: UInt64 = 0
+
+        /// Allocations freed by BoringSSL.
+        public var frees: UInt64 = 0
+
+        /// Requests for random bytes from BoringSSL's DRBG, and the number of bytes requested. Crypto only makes
+        /// these when thread-local random buffering is enabled, and otherwise uses the system generator.
+        public var randomRequests: UInt64 = 0
+        public var randomBytes: UInt64 = 0
+
+        /// Draws from BoringSSL's DRBG. With thread-local random buffering enabled, this is usually much lower than
+        /// ``randomRequests``.
+        public var randomGenerations: UInt64 = 0
+
+        /// AEAD seal operations, and the number of plaintext bytes sealed.
+        public var aeadSeals: UInt64 = 0
+        public var aeadSealedBytes: UInt64 = 0
+
+        /// AEAD open operations, the number of input bytes they were given, and how many failed.
+        public var aeadOpens: UInt64 = 0
+        public var aeadOpenedBytes: UInt64 = 0
+        public var aeadOpenFailures: UInt64 = 0
+
+        /// Incremental digest updates, and the number of bytes hashed through them.
+        public var digestUpdates: UInt64 = 0
+        public var digestedBytes: UInt64 = 0
+
+        /// The counts accumulated between `earlier` and `self`.
+        public func subtracting(_ earlier: Counters) -> Counters {
+            var result = Counters()
+            result.allocations = self.allocations &- earlier.allocations
+            result.allocatedBytes = self.allocatedBytes &- earlier.allocatedBytes
+            result.frees = self.frees &- earlier.frees
+            result.randomRequests = self.randomRequests &- earlier.randomRequests
+            result.randomBytes = self.randomBytes &- earlier.randomBytes
+            result.randomGenerations = self.randomGenerations &- earlier.randomGenerations
+            result.aeadSeals = self.aeadSeals &- earlier.aeadSeals
+            result.aeadSealedBytes = self.aeadSealedBytes &- earlier.aeadSealedBytes
+            result.aeadOpens = self.aeadOpens &- earlier.aeadOpens
+            result.aeadOpenedBytes = self.aeadOpenedBytes &- earlier.aeadOpenedBytes
+            result.aeadOpenFailures = self.aeadOpenFailures &- earlier.aeadOpenFailures
+            result.digestUpdates = self.digestUpdates &- earlier.digestUpdates
+            result.digestedBytes = self.digestedBytes &- earlier.digestedBytes
+            return result
+        }
+    }
+
+    /// Whether instrumentation is compiled in.
+    public static var isEnabled: Bool {
+        #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+        return false
+        #else
+        return CCryptoBoringSSLShims_instrumentation_enabled() != 0
+        #endif
+    }
+
+    /// The counters for the calling thread.
+    public static var currentThread: Counters {
+        #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+        return Counters()
+        #else
+        return Counters { CCryptoBoringSSLShims_instrumentation_thread_counters($0, $1) }
+        #endif
+    }
+
+    /// The counters summed over every thread in the process, including threads that have exited.
+    public static var process: Counters {
+        #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+        return Counters()
+        #else
+        return Counters { CCryptoBoringSSLShims_instrumentation_process_counters($0, $1) }
+        #endif
+    }
+
+    /// A lock inside the shims whose contention is measured.
+    public enum LockSite: CaseIterable, Hashable, Sendable {
+        /// The lock of each ``AES/GCM/_CompactKeyPool``.
+        case compactKeyPool
+        /// The shared free lists of the slab allocator.
+        case slabAllocator
+    }
+
+    /// How often a lock was found held, summed over the process since it started.
+    public struct LockContention: Hashable, Sendable {
+        /// The acquisitions that had to wait for the lock. Those that found it free aren't counted.
+        public var contendedAcquisitions: UInt64 = 0
+        /// The contended acquisitions that went to sleep, rather than spinning until the lock was released.
+        public var sleeps: UInt64 = 0
+        /// The total time the contended acquisitions waited.
+        public var waitNanoseconds: UInt64 = 0
+    }
+
+    /// The contention measured at `site`, or zeroes if instrumentation is not compiled in.
+    public static func lockContention(at site: LockSite) -> LockContention {
+        #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+        return LockContention()
+        #else
+        let shimSite: CCryptoBoringSSLShims_lock_site
+        switch site {
+        case .compactKeyPool:
+            shimSite = CCryptoBoringSSLShims_lock_site_gcm_key_pool
+        case .slabAllocator:
+            shimSite = CCryptoBoringSSLShims_lock_site_slab_allocator
+        }
+        var statistics = CCryptoBoringSSLShims_lock_statistics()
+        CCryptoBoringSSLShims_lock_site_statistics(shimSite, &statistics)
+        return LockContention(
+            contendedAcquisitions: statistics.contended,
+            sleeps: statistics.sleeps,
+            waitNanoseconds: statistics.wait_ns
+        )
+        #endif
+    }
+}
+
+#if !(CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API)
+extension _CryptoInstrumentation.Counters {
+    fileprivate init(_ read: (UnsafeMutablePointer<UInt64>, Int) -> Void) {
+        let count = Int(CCryptoBoringSSLShims_event_count.rawValue)
+        let counts = [UInt64](unsafeUninitializedCapacity: count) { buffer, initializedCount in
+            read(buffer.baseAddress!, count)
+            initializedCount = count
+        }
+        func counter(_ event: CCryptoBoringSSLShims_event) -> UInt64 {
+            counts[Int(event.rawValue)]
+        }
+
+        self.allocations = counter(CCryptoBoringSSLShims_event_allocations)
+        self.allocatedBytes = counter(CCryptoBoringSSLShims_event_allocated_bytes)
+        self.frees = counter(CCryptoBoringSSLShims_event_frees)
+        self.randomRequests = counter(CCryptoBoringSSLShims_event_random_requests)
+        self.randomBytes = counter(CCryptoBoringSSLShims_event_random_bytes)
+        self.randomGenerations = counter(CCryptoBoringSSLShims_event_random_generations)
+        self.aeadSeals = counter(CCryptoBoringSSLShims_event_aead_seals)
+        self.aeadSealedBytes = counter(CCryptoBoringSSLShims_event_aead_sealed_bytes)
+        self.aeadOpens = counter(CCryptoBoringSSLShims_event_aead_opens)
+        self.aeadOpenedBytes = counter(CCryptoBoringSSLShims_event_aead_opened_bytes)
+        self.aeadOpenFailures = counter(CCryptoBoringSSLShims_event_aead_open_failures)
+        self.digestUpdates = counter(CCryptoBoringSSLShims_event_digest_updates)
+        self.digestedBytes = counter(CCryptoBoringSSLShims_event_digested_bytes)
+    }
+}
+#endif
@@ -0,0 +1,149 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Foundation
+import Crypto
+
+#if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+// Nothing; CryptoKit is not instrumented.
+#else
+@_implementationOnly import CCryptoBoringSSLShims
+#endif
+
+/// Sampled latency histograms for BoringSSL's main operations, for publishing percentiles such as p50 and p99.
+///
+/// The histograms are part of the instrumentation described on ``_CryptoInstrumentation``, and, like its counters,
+/// exist only when that is compiled in. Nothing is timed until ``sampleInterval`` is set: after that, one in every
+/// `sampleInterval` of the operations listed in ``_CryptoTracing/Operation`` on each thread is timed and counted in
+/// the histogram for its ``Series``. Each thread keeps its own histograms, which ``snapshot()`` merges.
+///
+/// A histogram stores counts in buckets that widen with the value, eight per power of two, so percentiles are
+/// reported as the upper bound of a bucket and are at most 12.5% above the true value. That is plenty to notice an
+/// operation that has lost its assembly path or started missing a cache, which typically costs several times more.
+public enum _CryptoLatency {
+    /// The operations one histogram covers.
+    public struct Series: Hashable, Sendable {
+        public var operation: _CryptoTracing.Operation
+
+        /// The BoringSSL NID of the AEAD, the curve or the digest, as in ``_CryptoTracing/Event/algorithm``.
+        public var algorithm: Int32
+
+        /// The size of the key in bits, as in ``_CryptoTracing/Event/keyBits``.
+        public var keyBits: Int32
+
+        /// For AEAD operations, the largest message in this series: 64, 1024 or 16384 bytes, or `UInt64.max` for
+        /// anything larger. `nil` for every other operation.
+        public var maxMessageSize: UInt64?
+    }
+
+    /// The sampled latencies of one series.
+    public struct Histogram: Hashable, Sendable {
+        /// The number of samples in each bucket.
+        public var bucketCounts: [UInt64]
+
+        /// The number of samples.
+        public var count: UInt64 {
+            self.bucketCounts.reduce(0, &+)
+        }
+
+        /// The smallest bucket upper bound, in nanoseconds, at or below which at least `fraction` of the samples
+        /// lie, or `nil` if there are none. `percentile(0.99)` is the p99 latency.
+        public func percentile(_ fraction: Double) -> UInt64? {
+            precondition((0...1).contains(fraction))
+            let count = self.count
+            guard count > 0 else {
+                return nil
+            }
+            let target = max(1, UInt64((Double(count) * fraction).rounded(.up)))
+            var seen: UInt64 = 0
+            for (bucket, bucketCount) in self.bucketCounts.enumerated() {
+                seen += bucketCount
+                if seen >= target {
+                    return _CryptoLatency.upperBound(ofBucket: bucket)
+                }
+            }
+            return _CryptoLatency.upperBound(ofBucket: self.bucketCounts.count - 1)
+        }
+
+        /// The samples taken between `earlier` and `self`.
+        public func subtracting(_ earlier: Histogram) -> Histogram {
+            var result = self
+            for bucket in earlier.bucketCounts.indices where bucket < result.bucketCounts.count {
+                result.bucketCounts[bucket] &-= earlier.bucketCounts[bucket]
+            }
+            return result
+        }
+    }
+
+    /// Whether latency histograms are compiled in.
+    public static var isEnabled: Bool {
+        _CryptoInstrumentation.isEnabled
+    }
+
+    /// Times one in every `sampleInterval` operations on each thread. Zero, the default, turns sampling off.
+    /// Setting it does nothing when histograms are not compiled in.
+    public static var sampleInterval: UInt32 {
+        get {
+            #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+            return 0
+            #else
+            return CCryptoBoringSSLShims_latency_sample_interval()
+            #endif
+        }
+        set {
+            #if !(CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API)
+            CCryptoBoringSSLShims_latency_set_sample_interval(newValue)
+            #endif
+        }
+    }
+
+    /// The histograms of every series with samples, merged over every thread in the process, including threads that
+    /// have exited.
+    public static func snapshot() -> [Series: Histogram] {
+        #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+        return [:]
+        #else
+        let bucketCount = Int(CCryptoBoringSSLShims_LATENCY_BUCKET_COUNT)
+        var capacity = 16
+        while true {
+            var keys = [CCryptoBoringSSLShims_latency_series_key](repeating: .init(), count: capacity)
+            var counts = [UInt64](repeating: 0, count: capacity * bucketCount)
+            let needed = CCryptoBoringSSLShims_latency_histograms(&keys, &counts, capacity)
+            guard needed <= capacity else {
+                capacity = needed
+                continue
+            }
+
+            var histograms: [Series: Histogram] = [:]
+            for index in 0..<needed {
+                let key = keys[index]
+                guard let operation = _CryptoTracing.Operation(key.operation) else {
+                    continue
+                }
+                let series = Series(operation: operation, algorithm: key.algorithm, keyBits: key.key_bits, maxMessageSize: key.max_bytes == 0 ? nil : key.max_bytes)
+                histograms[series] = Histogram(bucketCounts: Array(counts[(index * bucketCount)..<((index + 1) * bucketCount)]))
+            }
+            return histograms
+        }
+        #endif
+    }
+
+    /// The largest number of nanoseconds counted in `bucket`.
+    static func upperBound(ofBucket bucket: Int) -> UInt64 {
+        #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+        return 0
+        #else
+        return CCryptoBoringSSLShims_latency_bucket_upper_bound(bucket)
+        #endif
+    }
+}
@@ -0,0 +1,72 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+@_implementationOnly import CCryptoBoringSSLShims
+import Foundation
+
+/// One copy of some read-only object per NUMA node, each made on first use by a thread running on that node.
+///
+/// When threads on several sockets read the same key schedule, each read can pull the cache lines across the
+/// interconnect. Building a replica from a thread on the node that will use it lets the kernel's first-touch
+/// policy place its memory there. Lookups are a CPU-to-node table read and an atomic load, with no lock.
+///
+/// On a single-node machine, or where the topology is unknown, this holds only the primary.
+final class NodeLocalReplicas<Replica: AnyObject>: @unchecked Sendable {
+    private let slots: UnsafeMutablePointer<UnsafeMutableRawPointer?>
+
+    private let nodeCount: Int
+
+    private let makeReplica: () throws -> Replica
+
+    /// - Parameters:
+    ///   - primary: The copy for the node of the calling thread.
+    ///   - makeReplica: Builds a copy for another node. Called on a thread running on that node.
+    init(primary: Replica, makeReplica: @escaping () throws -> Replica) {
+        self.nodeCount = Int(CCryptoBoringSSLShims_numa_node_count())
+        self.makeReplica = makeReplica
+        self.slots = .allocate(capacity: self.nodeCount)
+        self.slots.initialize(repeating: nil, count: self.nodeCount)
+        self.slots[Int(CCryptoBoringSSLShims_numa_current_node())] = Unmanaged.passRetained(primary).toOpaque()
+    }
+
+    deinit {
+        for node in 0..<self.nodeCount {
+            if let replica = self.slots[node] {
+                Unmanaged<Replica>.fromOpaque(replica).release()
+            }
+        }
+        self.slots.deallocate()
+    }
+
+    /// The replica for the node the calling thread is running on, making it if this is the node's first use.
+    func current() throws -> Replica {
+        let slot = self.slots + Int(CCryptoBoringSSLShims_numa_current_node())
+        if let existing = CCryptoBoringSSLShims_atomic_load_pointer(slot) {
+            return Unmanaged<Replica>.fromOpaque(existing).takeUnretainedValue()
+        }
+
+        // Two threads on a new node may race to build its replica; the loser's copy is discarded.
+        let replica = try self.makeReplica()
+        let opaque = Unmanaged.passRetained(replica).toOpaque()
+        if CCryptoBoringSSLShims_atomic_compare_exchange_pointer(slot, nil, opaque) == 1 {
+            return replica
+        }
+        Unmanaged<Replica>.fromOpaque(opaque).release()
+        return Unmanaged<Replica>.fromOpaque(CCryptoBoringSSLShims_atomic_load_pointer(slot)!).takeUnretainedValue()
+    }
+
+    /// The number of nodes that have a replica so far.
+    var replicaCount: Int {
+        (0..<self.nodeCount).filter { CCryptoBoringSSLShims_atomic_load_pointer(self.slots + $0) != nil }.count
+    }
+}
@@ -0,0 +1,169 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Foundation
+
+/// Reads PEM documents one at a time from a file, without loading the whole file into memory.
+///
+/// This is intended for large bundles of PEM documents, such as CA bundles or key stores. Only one chunk of the input
+/// and the document currently being decoded are held in memory at a time. Text outside PEM documents, such as the
+/// comments found in many CA bundles, is skipped.
+///
+/// ```swift
+/// var reader = try _PEMReader(contentsOfFile: "/etc/ssl/cert.pem")
+/// while let document = try reader.next() {
+///     print(document.type, document.derBytes.count)
+/// }
+/// ```
+public struct _PEMReader {
+    /// A single decoded PEM document.
+    public struct Document: Sendable {
+        /// The discriminator from the `-----BEGIN <type>-----` line.
+        public var type: String
+
+        /// The decoded bytes of the document.
+        public var derBytes: Data
+    }
+
+    /// The maximum number of bytes of a single line, or of a single document's PEM text.
+    ///
+    /// Inputs exceeding this are rejected rather than buffered, so that memory stays bounded on malformed input.
+    public static let maximumDocumentSize = 1 << 20
+
+    private let fileHandle: FileHandle
+
+    private let closesFileHandle: Bool
+
+    private let chunkSize: Int
+
+    private var buffer: [UInt8] = []
+
+    private var bufferOffset = 0
+
+    private var reachedEndOfFile = false
+
+    /// Creates a reader over an already-open file handle, which the caller remains responsible for closing.
+    ///
+    /// - Parameters:
+    ///   - fileHandle: The handle to read from, starting at its current offset.
+    ///   - chunkSize: The number of bytes to read from the handle at a time.
+    public init(fileHandle: FileHandle, chunkSize: Int = 64 * 1024) {
+        precondition(chunkSize > 0)
+        self.fileHandle = fileHandle
+        self.closesFileHandle = false
+        self.chunkSize = chunkSize
+    }
+
+    /// Creates a reader over the file at `path`.
+    ///
+    /// The file is closed once the reader has read to the end of it.
+    ///
+    /// - Parameters:
+    ///   - path: The path of the file to read.
+    ///   - chunkSize: The number of bytes to read from the file at a time.
+    public init(contentsOfFile path: String, chunkSize: Int = 64 * 1024) throws {
+        precondition(chunkSize > 0)
+        guard let fileHandle = FileHandle(forReadingAtPath: path) else {
+            throw CocoaError(.fileReadNoSuchFile, userInfo: [NSFilePathErrorKey: path])
+        }
+        self.fileHandle = fileHandle
+        self.closesFileHandle = true
+        self.chunkSize = chunkSize
+    }
+
+    /// Reads and decodes the next PEM document.
+    ///
+    /// - Returns: The next document, or `nil` once the input is exhausted.
+    /// - Throws: ``_CryptoRSAError/invalidPEMDocument`` if a document is malformed or truncated, or is larger than
+    ///     ``maximumDocumentSize``.
+    public mutating func next() throws -> Document? {
+        // Skip ahead to the next BEGIN line.
+        var beginLine: Substring? = nil
+        while beginLine == nil {
+            guard let line = try self.nextLine() else {
+                return nil
+            }
+            if line.hasPrefix("-----BEGIN ") {
+                beginLine = line
+            }
+        }
+
+        var lines = [beginLine!]
+        var documentSize = beginLine!.utf8.count
+        while true {
+            guard let line = try self.nextLine() else {
+                // We ran out of input in the middle of a document.
+                throw _CryptoRSAError.invalidPEMDocument
+            }
+            documentSize += line.utf8.count + 1
+            guard documentSize <= Self.maximumDocumentSize else {
+                throw _CryptoRSAError.invalidPEMDocument
+            }
+            lines.append(line)
+            if line.hasPrefix("-----END ") {
+                break
+            }
+        }
+
+        let document = try ASN1.PEMDocument(pemString: lines.joined(separator: "\n"))
+        return Document(type: document.type, derBytes: document.derBytes)
+    }
+
+    /// Returns the next line of input with its line terminator removed, or `nil` at the end of the input.
+    private mutating func nextLine() throws -> Substring? {
+        while true {
+            if let newlineIndex = self.buffer[self.bufferOffset...].firstIndex(of: UInt8(ascii: "\n")) {
+                var lineBytes = self.buffer[self.bufferOffset..<newlineIndex]
+                self.bufferOffset = newlineIndex + 1
+                if lineBytes.last == UInt8(ascii: "\r") {
+                    lineBytes = lineBytes.dropLast()
+                }
+                return Substring(decoding: lineBytes, as: UTF8.self)
+            }
+
+            if self.reachedEndOfFile {
+                // Return whatever is left as an unterminated final line.
+                guard self.bufferOffset < self.buffer.count else {
+                    return nil
+                }
+                var lineBytes = self.buffer[self.bufferOffset...]
+                self.bufferOffset = self.buffer.count
+                if lineBytes.last == UInt8(ascii: "\r") {
+                    lineBytes = lineBytes.dropLast()
+                }
+                return Substring(decoding: lineBytes, as: UTF8.self)
+            }
+
+            guard self.buffer.count - self.bufferOffset <= Self.maximumDocumentSize else {
+                throw _CryptoRSAError.invalidPEMDocument
+            }
+            self.readChunk()
+        }
+    }
+
+    private mutating func readChunk() {
+        // Drop the bytes that have already been consumed before appending more.
+        self.buffer.removeSubrange(..<self.bufferOffset)
+        self.bufferOffset = 0
+
+        let chunk = self.fileHandle.readData(ofLength: self.chunkSize)
+        if chunk.isEmpty {
+            self.reachedEndOfFile = true
+            if self.closesFileHandle {
+                self.fileHandle.closeFile()
+            }
+        } else {
+            self.buffer.append(contentsOf: chunk)
+        }
+    }
+}
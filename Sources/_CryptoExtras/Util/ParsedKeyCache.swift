@@ -0,0 +1,110 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+
+/// A bounded map from the SHA-256 fingerprint of a key's encoding to the parsed key. The oldest entries are
+/// evicted first.
+///
+/// A cache given a ``_CryptoCacheBudget`` charges the estimated bytes of its keys to it, and drops its oldest keys
+/// when the budget asks it to.
+final class ParsedKeyCache<Key>: @unchecked Sendable {
+    private let capacity: Int
+
+    private let keyByteCount: (Key) -> Int
+
+    private let lock = NSLock()
+
+    // Protected by `lock`.
+    private var keys: [SHA256Digest: (key: Key, byteCount: Int)] = [:]
+
+    // Protected by `lock`. Fingerprints in insertion order, used for eviction.
+    private var insertionOrder: [SHA256Digest] = []
+
+    // Set once, before the cache is shared.
+    private var registration: _CryptoCacheBudget.Registration?
+
+    init(
+        capacity: Int,
+        budget: _CryptoCacheBudget? = nil,
+        name: String = "",
+        weight: Double = 1,
+        keyByteCount: @escaping (Key) -> Int = { _ in 0 }
+    ) {
+        precondition(capacity > 0)
+        self.capacity = capacity
+        self.keyByteCount = keyByteCount
+        self.registration = budget?.register(name: name, weight: weight) { [weak self] byteCount in
+            self?.trim(toByteCount: byteCount) ?? (0, 0)
+        }
+    }
+
+    func key(for fingerprint: SHA256Digest) -> Key? {
+        self.lock.lock()
+        defer {
+            self.lock.unlock()
+        }
+        return self.keys[fingerprint]?.key
+    }
+
+    func insert(_ key: Key, for fingerprint: SHA256Digest) {
+        let byteCount = self.registration == nil ? 0 : self.keyByteCount(key)
+        var evicted: (key: Key, byteCount: Int)?
+        self.lock.lock()
+        // Another thread may have raced us to parse the same key.
+        guard self.keys.updateValue((key, byteCount), forKey: fingerprint) == nil else {
+            self.lock.unlock()
+            return
+        }
+        self.insertionOrder.append(fingerprint)
+
+        if self.insertionOrder.count > self.capacity {
+            evicted = self.keys.removeValue(forKey: self.insertionOrder.removeFirst())
+        }
+        self.lock.unlock()
+
+        withExtendedLifetime(evicted) {}
+        self.registration?.charge(byteCount - (evicted?.byteCount ?? 0))
+    }
+
+    func removeAll() {
+        self.lock.lock()
+        let removed = self.keys
+        self.keys.removeAll()
+        self.insertionOrder.removeAll()
+        self.lock.unlock()
+
+        self.registration?.charge(-removed.values.reduce(0) { $0 + $1.byteCount })
+    }
+
+    /// Drops the oldest keys until at most `byteCount` bytes are left, and returns how many keys and bytes were
+    /// dropped. This is what the budget calls, so it doesn't charge the budget itself.
+    private func trim(toByteCount byteCount: Int) -> (entries: Int, bytes: Int) {
+        var removed: [(key: Key, byteCount: Int)] = []
+        self.lock.lock()
+        var remaining = self.keys.values.reduce(0) { $0 + $1.byteCount }
+        var dropped = 0
+        while remaining > byteCount, dropped < self.insertionOrder.count {
+            let entry = self.keys.removeValue(forKey: self.insertionOrder[dropped])!
+            remaining -= entry.byteCount
+            removed.append(entry)
+            dropped += 1
+        }
+        self.insertionOrder.removeFirst(dropped)
+        self.lock.unlock()
+
+        return (removed.count, removed.reduce(0) { $0 + $1.byteCount })
+    }
+}
@@ -0,0 +1,327 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Foundation
+
+/// A bounded least-recently-used map, split into independently locked shards so that threads using different
+/// keys rarely contend. Each shard holds at most its share of the capacity and evicts its own oldest entry.
+///
+/// Values are never released while a shard lock is held, so a value's `deinit` may be arbitrarily slow.
+///
+/// A cache given a ``_CryptoCacheBudget`` charges the estimated bytes of its entries to it, and drops its least
+/// recently used entries when the budget asks it to.
+final class ShardedLRUCache<Key: Hashable, Value>: @unchecked Sendable {
+    struct Statistics: Hashable {
+        var count = 0
+        var byteCount = 0
+        var hits: UInt64 = 0
+        var misses: UInt64 = 0
+        var evictions: UInt64 = 0
+    }
+
+    private let shards: [Shard]
+
+    /// The most entries the cache holds. This is `capacity` rounded up to a multiple of the shard count.
+    let capacity: Int
+
+    private let entryByteCount: (Key, Value) -> Int
+
+    // Set once, before the cache is shared.
+    private var registration: _CryptoCacheBudget.Registration?
+
+    /// Creates an empty cache.
+    ///
+    /// - Parameters:
+    ///   - capacity: The most entries to hold.
+    ///   - shardCount: The number of independently locked shards.
+    ///   - budget: The budget to charge the entries to, if any.
+    ///   - name: The kind of cache, for the budget's statistics.
+    ///   - weight: The weight of the cache's share of the budget.
+    ///   - entryByteCount: The estimated bytes an entry keeps alive.
+    init(
+        capacity: Int,
+        shardCount: Int,
+        budget: _CryptoCacheBudget? = nil,
+        name: String = "",
+        weight: Double = 1,
+        entryByteCount: @escaping (Key, Value) -> Int = { _, _ in 0 }
+    ) {
+        precondition(capacity > 0)
+        precondition(shardCount > 0)
+        let shardCount = min(shardCount, capacity)
+        let shardCapacity = (capacity + shardCount - 1) / shardCount
+        self.shards = (0..<shardCount).map { _ in Shard(capacity: shardCapacity) }
+        self.capacity = shardCapacity * shardCount
+        self.entryByteCount = entryByteCount
+        self.registration = budget?.register(name: name, weight: weight) { [weak self] byteCount in
+            self?.trim(toByteCount: byteCount) ?? (0, 0)
+        }
+    }
+
+    private func shard(for key: Key) -> Shard {
+        var hasher = Hasher()
+        hasher.combine(key)
+        return self.shards[Int(UInt(bitPattern: hasher.finalize()) % UInt(self.shards.count))]
+    }
+
+    /// Returns the value for `key`, calling `makeValue` to create it on a miss.
+    ///
+    /// `makeValue` runs without the lock held. If two threads miss on the same key at once, both create a value
+    /// and the first one inserted wins.
+    func value(for key: Key, orInsert makeValue: () throws -> Value) rethrows -> Value {
+        let shard = self.shard(for: key)
+        if let value = shard.withLock({ $0.lookUp(key) }) {
+            return value
+        }
+
+        let value = try makeValue()
+        let byteCount = self.registration == nil ? 0 : self.entryByteCount(key, value)
+        let (winner, evicted, delta) = shard.withLock { $0.insert(value, for: key, byteCount: byteCount) }
+        withExtendedLifetime(evicted) {}
+        self.registration?.charge(delta)
+        return winner
+    }
+
+    /// Returns the value for `key` if there is one and `isUsable` accepts it. A value it rejects is removed, and
+    /// the lookup counts as a miss.
+    func value(for key: Key, ifUsable isUsable: (Value) -> Bool) -> Value? {
+        let (value, removed) = self.shard(for: key).withLock { $0.lookUp(key, ifUsable: isUsable) }
+        withExtendedLifetime(removed) {}
+        self.registration?.charge(-(removed?.byteCount ?? 0))
+        return value
+    }
+
+    /// Inserts `value` for `key`, replacing any value already there.
+    func updateValue(_ value: Value, for key: Key) {
+        let byteCount = self.registration == nil ? 0 : self.entryByteCount(key, value)
+        let shard = self.shard(for: key)
+        let (removed, evicted, delta) = shard.withLock { list -> ((value: Value, byteCount: Int)?, Value?, Int) in
+            let removed = list.remove(key)
+            let (_, evicted, delta) = list.insert(value, for: key, byteCount: byteCount)
+            return (removed, evicted, delta - (removed?.byteCount ?? 0))
+        }
+        withExtendedLifetime((removed, evicted)) {}
+        self.registration?.charge(delta)
+    }
+
+    func removeValue(for key: Key) {
+        let removed = self.shard(for: key).withLock { $0.remove(key) }
+        withExtendedLifetime(removed) {}
+        self.registration?.charge(-(removed?.byteCount ?? 0))
+    }
+
+    func removeAll() {
+        for shard in self.shards {
+            let removed = shard.withLock { $0.removeAll() }
+            withExtendedLifetime(removed) {}
+            self.registration?.charge(-removed.byteCount)
+        }
+    }
+
+    /// Drops the least recently used entries of each shard until the shard holds at most its share of
+    /// `byteCount`, and returns how many entries and bytes were dropped. This is what the budget calls, so it
+    /// doesn't charge the budget itself.
+    private func trim(toByteCount byteCount: Int) -> (entries: Int, bytes: Int) {
+        let shardByteCount = byteCount / self.shards.count
+        var entries = 0
+        var bytes = 0
+        for shard in self.shards {
+            let removed = shard.withLock { $0.trim(toByteCount: shardByteCount) }
+            withExtendedLifetime(removed) {}
+            entries += removed.values.count
+            bytes += removed.byteCount
+        }
+        return (entries, bytes)
+    }
+
+    var statistics: Statistics {
+        self.shards.reduce(into: Statistics()) { total, shard in
+            let statistics = shard.withLock { $0.statistics }
+            total.count += statistics.count
+            total.byteCount += statistics.byteCount
+            total.hits += statistics.hits
+            total.misses += statistics.misses
+            total.evictions += statistics.evictions
+        }
+    }
+}
+
+extension ShardedLRUCache {
+    private final class Shard {
+        private let lock = NSLock()
+
+        // Protected by `lock`.
+        private var list: EntryList
+
+        init(capacity: Int) {
+            self.list = EntryList(capacity: capacity)
+        }
+
+        func withLock<Result>(_ body: (inout EntryList) -> Result) -> Result {
+            self.lock.lock()
+            defer {
+                self.lock.unlock()
+            }
+            return body(&self.list)
+        }
+    }
+
+    /// A doubly linked recency list threaded through an array, with a dictionary from key to array index. Freed
+    /// slots are reused, so a full shard no longer allocates.
+    private struct EntryList {
+        private struct Entry {
+            var key: Key
+            var value: Value?
+            var byteCount: Int
+            var newer: Int
+            var older: Int
+        }
+
+        private let capacity: Int
+
+        private var indices: [Key: Int] = [:]
+
+        private var entries: [Entry] = []
+
+        private var freeIndices: [Int] = []
+
+        // The most and least recently used entries, or -1 when the list is empty.
+        private var newest = -1
+        private var oldest = -1
+
+        private(set) var statistics = Statistics()
+
+        init(capacity: Int) {
+            self.capacity = capacity
+            self.indices.reserveCapacity(capacity)
+        }
+
+        mutating func lookUp(_ key: Key) -> Value? {
+            guard let index = self.indices[key] else {
+                self.statistics.misses += 1
+                return nil
+            }
+            self.statistics.hits += 1
+            self.moveToFront(index)
+            return self.entries[index].value
+        }
+
+        mutating func lookUp(_ key: Key, ifUsable isUsable: (Value) -> Bool) -> (Value?, removed: (value: Value, byteCount: Int)?) {
+            guard let index = self.indices[key], isUsable(self.entries[index].value!) else {
+                self.statistics.misses += 1
+                return (nil, self.indices[key] == nil ? nil : self.remove(key))
+            }
+            self.statistics.hits += 1
+            self.moveToFront(index)
+            return (self.entries[index].value, nil)
+        }
+
+        /// Inserts `value` unless another thread got there first, and returns the value now in the list along with
+        /// any value that was pushed out and the change in the list's byte count.
+        mutating func insert(_ value: Value, for key: Key, byteCount: Int) -> (Value, evicted: Value?, delta: Int) {
+            if let index = self.indices[key] {
+                self.moveToFront(index)
+                return (self.entries[index].value!, nil, 0)
+            }
+
+            var evicted: (value: Value, byteCount: Int)?
+            if self.indices.count == self.capacity {
+                evicted = self.remove(self.entries[self.oldest].key)
+                self.statistics.evictions += 1
+            }
+
+            let entry = Entry(key: key, value: value, byteCount: byteCount, newer: -1, older: self.newest)
+            let index: Int
+            if let free = self.freeIndices.popLast() {
+                index = free
+                self.entries[index] = entry
+            } else {
+                index = self.entries.count
+                self.entries.append(entry)
+            }
+            if self.newest >= 0 {
+                self.entries[self.newest].newer = index
+            } else {
+                self.oldest = index
+            }
+            self.newest = index
+            self.indices[key] = index
+            self.statistics.count = self.indices.count
+            self.statistics.byteCount += byteCount
+            return (value, evicted?.value, byteCount - (evicted?.byteCount ?? 0))
+        }
+
+        mutating func remove(_ key: Key) -> (value: Value, byteCount: Int)? {
+            guard let index = self.indices.removeValue(forKey: key) else {
+                return nil
+            }
+            self.unlink(index)
+            self.freeIndices.append(index)
+            self.statistics.count = self.indices.count
+            self.statistics.byteCount -= self.entries[index].byteCount
+            defer {
+                self.entries[index].value = nil
+            }
+            return (self.entries[index].value!, self.entries[index].byteCount)
+        }
+
+        mutating func removeAll() -> (values: [Value], byteCount: Int) {
+            let values = self.entries.compactMap(\.value)
+            let byteCount = self.statistics.byteCount
+            self.indices.removeAll(keepingCapacity: true)
+            self.entries.removeAll()
+            self.freeIndices.removeAll()
+            self.newest = -1
+            self.oldest = -1
+            self.statistics.count = 0
+            self.statistics.byteCount = 0
+            return (values, byteCount)
+        }
+
+        /// Removes the least recently used entries until at most `byteCount` bytes are left.
+        mutating func trim(toByteCount byteCount: Int) -> (values: [Value], byteCount: Int) {
+            var values: [Value] = []
+            let before = self.statistics.byteCount
+            while self.statistics.byteCount > byteCount, self.oldest >= 0 {
+                values.append(self.remove(self.entries[self.oldest].key)!.value)
+            }
+            return (values, before - self.statistics.byteCount)
+        }
+
+        private mutating func unlink(_ index: Int) {
+            let (newer, older) = (self.entries[index].newer, self.entries[index].older)
+            if newer >= 0 {
+                self.entries[newer].older = older
+            } else {
+                self.newest = older
+            }
+            if older >= 0 {
+                self.entries[older].newer = newer
+            } else {
+                self.oldest = newer
+            }
+        }
+
+        private mutating func moveToFront(_ index: Int) {
+            guard index != self.newest else {
+                return
+            }
+            self.unlink(index)
+            self.entries[index].newer = -1
+            self.entries[index].older = self.newest
+            self.entries[self.newest].newer = index
+            self.newest = index
+        }
+    }
+}
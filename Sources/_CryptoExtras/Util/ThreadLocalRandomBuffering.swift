@@ -0,0 +1,49 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Foundation
+import Crypto
+
+#if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+// Nothing; CryptoKit generates its own random bytes.
+#else
+@_implementationOnly import CCryptoBoringSSLShims
+#endif
+
+/// Controls how random bytes for keys and nonces are generated.
+public enum _CryptoRandom {
+    /// Whether small requests for random bytes are served from a per-thread buffer.
+    ///
+    /// When enabled, requests of up to 256 bytes, such as those made when generating nonces and keys, are served from a
+    /// per-thread buffer. The buffer is refilled from BoringSSL's DRBG 4 KiB at a time, which makes each request
+    /// considerably cheaper. Bytes are wiped from the buffer as they are handed out, and the buffer is discarded after a
+    /// fork. Buffering is never used where BoringSSL cannot detect forks.
+    ///
+    /// This is disabled by default, and has no effect when Crypto is backed by CryptoKit.
+    public static var _isThreadLocalBufferingEnabled: Bool {
+        get {
+            #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+            return false
+            #else
+            return CCryptoBoringSSLShims_RAND_buffering_enabled() != 0
+            #endif
+        }
+        set {
+            #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+            // Nothing to do.
+            #else
+            CCryptoBoringSSLShims_RAND_set_buffering_enabled(newValue ? 1 : 0)
+            #endif
+        }
+    }
+}
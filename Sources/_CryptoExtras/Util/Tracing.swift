@@ -0,0 +1,153 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Foundation
+import Crypto
+
+#if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+// Nothing; CryptoKit is not traced.
+#else
+@_implementationOnly import CCryptoBoringSSLShims
+#endif
+
+/// Marks the start and end of BoringSSL's main operations, so their cost can be placed on a request trace.
+///
+/// Tracepoints are compiled in when the package is built with `CRYPTO_BORINGSSL_TRACEPOINTS` defined (for CMake
+/// builds, by enabling `SWIFT_CRYPTO_TRACEPOINTS`). On Linux, when `<sys/sdt.h>` is available at build time, every
+/// mark is also a USDT probe in the `swift_crypto` provider, such as `swift_crypto:aead_seal_entry`, that perf,
+/// bpftrace or SystemTap can attach to without a handler installed here.
+///
+/// A handler installed with ``setHandler(_:)`` receives the same marks in Swift, for example to open and close
+/// signpost intervals or spans in a tracing system. It runs inline on the thread doing the work, so it should be
+/// cheap. When tracepoints are not compiled in, or Crypto is backed by CryptoKit, the handler is never called.
+public enum _CryptoTracing {
+    /// A traced operation.
+    public enum Operation: Hashable, Sendable {
+        case aeadSeal
+        case aeadOpen
+        case ecdsaSign
+        case ecdsaVerify
+        case rsaSign
+        case rsaVerify
+        case ed25519Sign
+        case ed25519Verify
+        /// An X25519 key agreement, or a batch of them sharing a private key.
+        case x25519
+        /// A draw from BoringSSL's DRBG, which may reseed it.
+        case randomGeneration
+    }
+
+    /// The start or end of an operation.
+    public struct Event: Hashable, Sendable {
+        public var operation: Operation
+
+        /// Whether this marks the end of the operation, rather than its start.
+        public var isEnd: Bool
+
+        /// The BoringSSL NID of the AEAD, the curve or the digest the operation uses, or zero if it has none.
+        public var algorithm: Int32
+
+        /// The size of the key in bits: the AEAD key, the curve's field, or the RSA modulus. Zero for random
+        /// generation.
+        public var keyBits: Int32
+
+        /// The number of bytes the operation processes: the message or digest for signatures, the plaintext or
+        /// ciphertext for AEADs, and the output for key agreement and random generation.
+        public var byteCount: UInt64
+
+        /// Whether the operation succeeded. Always `false` at the start of an operation.
+        public var succeeded: Bool
+    }
+
+    /// Whether tracepoints are compiled in.
+    public static var isEnabled: Bool {
+        #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+        return false
+        #else
+        return CCryptoBoringSSLShims_tracepoints_enabled() != 0
+        #endif
+    }
+
+    /// Installs `handler` to be called at the start and end of every traced operation, replacing any previous
+    /// handler. Passing `nil` removes the handler, which leaves only the USDT probes.
+    public static func setHandler(_ handler: (@Sendable (Event) -> Void)?) {
+        #if !(CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API)
+        traceHandler.set(handler)
+        CCryptoBoringSSLShims_set_trace_hook(handler == nil ? nil : traceHook)
+        #endif
+    }
+}
+
+#if !(CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API)
+private final class TraceHandlerStorage: @unchecked Sendable {
+    private let lock = NSLock()
+
+    // Protected by `lock`.
+    private var handler: (@Sendable (_CryptoTracing.Event) -> Void)?
+
+    func get() -> (@Sendable (_CryptoTracing.Event) -> Void)? {
+        self.lock.lock()
+        defer {
+            self.lock.unlock()
+        }
+        return self.handler
+    }
+
+    func set(_ handler: (@Sendable (_CryptoTracing.Event) -> Void)?) {
+        self.lock.lock()
+        defer {
+            self.lock.unlock()
+        }
+        self.handler = handler
+    }
+}
+
+private let traceHandler = TraceHandlerStorage()
+
+// The shims call this for every mark once a handler has been installed.
+private let traceHook: CCryptoBoringSSLShims_trace_hook = { operation, isReturn, algorithm, keyBits, byteCount, result in
+    guard let handler = traceHandler.get(), let operation = _CryptoTracing.Operation(operation) else {
+        return
+    }
+    handler(_CryptoTracing.Event(operation: operation, isEnd: isReturn != 0, algorithm: algorithm, keyBits: keyBits, byteCount: byteCount, succeeded: result == 1))
+}
+
+extension _CryptoTracing.Operation {
+    init?(_ operation: CCryptoBoringSSLShims_trace_operation) {
+        switch operation {
+        case CCryptoBoringSSLShims_trace_aead_seal:
+            self = .aeadSeal
+        case CCryptoBoringSSLShims_trace_aead_open:
+            self = .aeadOpen
+        case CCryptoBoringSSLShims_trace_ecdsa_sign:
+            self = .ecdsaSign
+        case CCryptoBoringSSLShims_trace_ecdsa_verify:
+            self = .ecdsaVerify
+        case CCryptoBoringSSLShims_trace_rsa_sign:
+            self = .rsaSign
+        case CCryptoBoringSSLShims_trace_rsa_verify:
+            self = .rsaVerify
+        case CCryptoBoringSSLShims_trace_ed25519_sign:
+            self = .ed25519Sign
+        case CCryptoBoringSSLShims_trace_ed25519_verify:
+            self = .ed25519Verify
+        case CCryptoBoringSSLShims_trace_x25519:
+            self = .x25519
+        case CCryptoBoringSSLShims_trace_random_generate:
+            self = .randomGeneration
+        default:
+            return nil
+        }
+    }
+}
+#endif
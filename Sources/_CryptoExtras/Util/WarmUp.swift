@@ -0,0 +1,222 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+
+#if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+// Nothing; CryptoKit does its own set-up.
+#else
+@_implementationOnly import CCryptoBoringSSLShims
+#endif
+
+/// Does the work that Crypto otherwise defers to the first use of each primitive, so that it isn't paid by the first
+/// requests a service handles.
+///
+/// On first use BoringSSL detects the CPU's features, opens the entropy source and sets up the built-in EC groups,
+/// and each thread instantiates and seeds its own DRBG the first time it asks for random bytes. The Swift runtime
+/// also instantiates the metadata and witness tables of each generic type as it's first used, and the code of a
+/// primitive is paged in when it first runs. Together these can add milliseconds to the first requests after a
+/// deploy.
+///
+/// ``warmUp(algorithms:threads:)`` does the process-wide set-up, runs each of `algorithms` once on throwaway keys,
+/// and then seeds the DRBG on up to `threads` of the threads Dispatch uses for its global concurrent queues, which
+/// also run the operations of ``_CryptoExecutor``. Threads started later still seed their DRBG on first use.
+public enum _CryptoWarmUp {
+    /// The primitives to run ahead of time.
+    public struct Algorithms: OptionSet, Hashable, Sendable {
+        public var rawValue: UInt32
+
+        public init(rawValue: UInt32) {
+            self.rawValue = rawValue
+        }
+
+        /// SHA-256, SHA-384 and SHA-512, and HMAC and HKDF over them.
+        public static let sha2 = Algorithms(rawValue: 1 << 0)
+        /// AES-GCM with 128- and 256-bit keys.
+        public static let aesGCM = Algorithms(rawValue: 1 << 1)
+        /// ChaCha20-Poly1305.
+        public static let chaChaPoly = Algorithms(rawValue: 1 << 2)
+        /// X25519 key agreement and Ed25519 signatures.
+        public static let curve25519 = Algorithms(rawValue: 1 << 3)
+        /// P-256 key agreement and ECDSA.
+        public static let p256 = Algorithms(rawValue: 1 << 4)
+        /// P-384 key agreement and ECDSA.
+        public static let p384 = Algorithms(rawValue: 1 << 5)
+        /// P-521 key agreement and ECDSA.
+        public static let p521 = Algorithms(rawValue: 1 << 6)
+        /// RSA signature verification. Private keys aren't generated, because that alone takes longer than the
+        /// first-use costs this removes.
+        public static let rsa = Algorithms(rawValue: 1 << 7)
+
+        /// Every primitive above.
+        public static let all: Algorithms = [.sha2, .aesGCM, .chaChaPoly, .curve25519, .p256, .p384, .p521, .rsa]
+    }
+
+    /// What a warm-up did.
+    public struct Report: Hashable, Sendable {
+        /// The number of distinct threads whose DRBG was seeded, including the calling one.
+        public var threadCount: Int
+        /// How long the warm-up took.
+        public var duration: TimeInterval
+    }
+
+    /// Does Crypto's deferred set-up now.
+    ///
+    /// Call this at startup, before serving requests. It's safe to call more than once, and from several threads.
+    ///
+    /// - Parameters:
+    ///   - algorithms: The primitives to run once.
+    ///   - threads: The most worker threads to seed the DRBG on, besides the calling one. Dispatch decides how many
+    ///     threads it runs the warm-up on, so ``Report/threadCount`` may be lower. Must not be negative.
+    /// - Returns: What was done.
+    @discardableResult
+    public static func warmUp(
+        algorithms: Algorithms = .all,
+        threads: Int = ProcessInfo.processInfo.activeProcessorCount
+    ) -> Report {
+        precondition(threads >= 0)
+        let start = DispatchTime.now().uptimeNanoseconds
+        #if !(CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API)
+        CCryptoBoringSSLShims_warm_up_process()
+        CCryptoBoringSSLShims_warm_up_thread()
+        #endif
+        Self.run(algorithms)
+        let threadCount = 1 + Self.warmUpWorkerThreads(threads)
+        return Report(
+            threadCount: threadCount,
+            duration: TimeInterval(DispatchTime.now().uptimeNanoseconds - start) / 1e9
+        )
+    }
+
+    // Failures are ignored: the point is to run the code, not to use what it returns.
+    private static func run(_ algorithms: Algorithms) {
+        let message = Data("swift-crypto warm-up".utf8)
+
+        if algorithms.contains(.sha2) {
+            _ = SHA256.hash(data: message)
+            _ = SHA384.hash(data: message)
+            _ = SHA512.hash(data: message)
+            let key = SymmetricKey(size: .bits256)
+            _ = HMAC<SHA256>.authenticationCode(for: message, using: key)
+            _ = HMAC<SHA384>.authenticationCode(for: message, using: key)
+            _ = HMAC<SHA512>.authenticationCode(for: message, using: key)
+            _ = HKDF<SHA256>.deriveKey(inputKeyMaterial: key, outputByteCount: 32)
+            _ = HKDF<SHA384>.deriveKey(inputKeyMaterial: key, outputByteCount: 48)
+            _ = HKDF<SHA512>.deriveKey(inputKeyMaterial: key, outputByteCount: 64)
+        }
+
+        if algorithms.contains(.aesGCM) {
+            for size in [SymmetricKeySize.bits128, .bits256] {
+                let key = SymmetricKey(size: size)
+                if let box = try? AES.GCM.seal(message, using: key) {
+                    _ = try? AES.GCM.open(box, using: key)
+                }
+            }
+        }
+
+        if algorithms.contains(.chaChaPoly) {
+            let key = SymmetricKey(size: .bits256)
+            if let box = try? ChaChaPoly.seal(message, using: key) {
+                _ = try? ChaChaPoly.open(box, using: key)
+            }
+        }
+
+        if algorithms.contains(.curve25519) {
+            let agreementKey = Curve25519.KeyAgreement.PrivateKey()
+            _ = try? agreementKey.sharedSecretFromKeyAgreement(with: Curve25519.KeyAgreement.PrivateKey().publicKey)
+            let signingKey = Curve25519.Signing.PrivateKey()
+            if let signature = try? signingKey.signature(for: message) {
+                _ = signingKey.publicKey.isValidSignature(signature, for: message)
+            }
+        }
+
+        if algorithms.contains(.p256) {
+            let agreementKey = P256.KeyAgreement.PrivateKey()
+            _ = try? agreementKey.sharedSecretFromKeyAgreement(with: P256.KeyAgreement.PrivateKey().publicKey)
+            let signingKey = P256.Signing.PrivateKey()
+            if let signature = try? signingKey.signature(for: message) {
+                _ = signingKey.publicKey.isValidSignature(signature, for: message)
+            }
+        }
+
+        if algorithms.contains(.p384) {
+            let agreementKey = P384.KeyAgreement.PrivateKey()
+            _ = try? agreementKey.sharedSecretFromKeyAgreement(with: P384.KeyAgreement.PrivateKey().publicKey)
+            let signingKey = P384.Signing.PrivateKey()
+            if let signature = try? signingKey.signature(for: message) {
+                _ = signingKey.publicKey.isValidSignature(signature, for: message)
+            }
+        }
+
+        if algorithms.contains(.p521) {
+            let agreementKey = P521.KeyAgreement.PrivateKey()
+            _ = try? agreementKey.sharedSecretFromKeyAgreement(with: P521.KeyAgreement.PrivateKey().publicKey)
+            let signingKey = P521.Signing.PrivateKey()
+            if let signature = try? signingKey.signature(for: message) {
+                _ = signingKey.publicKey.isValidSignature(signature, for: message)
+            }
+        }
+
+        if algorithms.contains(.rsa), let key = try? _RSA.Signing.PublicKey(pemRepresentation: Self.rsaPublicKeyPEM) {
+            // The signature is made up, so both checks fail, but only after the full modular exponentiation.
+            let signature = _RSA.Signing.RSASignature(rawRepresentation: Data(repeating: 1, count: 256))
+            _ = key.isValidSignature(signature, for: message, padding: .PSS)
+            _ = key.isValidSignature(signature, for: message, padding: .insecurePKCS1v1_5)
+        }
+    }
+
+    /// Seeds the DRBG on up to `count` Dispatch worker threads, and returns how many distinct threads it ran on.
+    private static func warmUpWorkerThreads(_ count: Int) -> Int {
+        guard count > 0 else {
+            return 0
+        }
+        let condition = NSCondition()
+        var arrived = 0
+        var threads = Set<ObjectIdentifier>()
+        let caller = ObjectIdentifier(Thread.current)
+        // Each iteration waits briefly for the others, so that Dispatch spreads them over different threads rather
+        // than running them one after another on the first.
+        let deadline = Date(timeIntervalSinceNow: 0.05)
+        DispatchQueue.concurrentPerform(iterations: count) { _ in
+            #if !(CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API)
+            CCryptoBoringSSLShims_warm_up_thread()
+            #endif
+            condition.lock()
+            defer {
+                condition.unlock()
+            }
+            arrived += 1
+            let thread = ObjectIdentifier(Thread.current)
+            if thread != caller {
+                threads.insert(thread)
+            }
+            condition.broadcast()
+            while arrived < count && condition.wait(until: deadline) {}
+        }
+        return threads.count
+    }
+
+    /// A 2048-bit public key with no private key kept anywhere, used only to run the verification code.
+    private static let rsaPublicKeyPEM = """
+        -----BEGIN PUBLIC KEY-----
+        MIIBIjANBgkqhkiG9w0BAQEFAAOCAQ8AMIIBCgKCAQEAto4CCGr5Jn04UlY11Zv8
+        IZsmCtZck7+/D+VU5CcKOl8DyhJTe0pmTpDNs5tpXfSHkybqwT50qEM4St8St8TY
+        ZSb+rzwJIICfjNQFILdM93rOBASjwo3cSm86BoXCyzcyXB6vFhQ6jA4V3OAUwJsr
+        2+NIbTT4H3qgZuyfqXfVRR+aF7SDpW60wpfJ+azDEEk6qpXWQZS6wiwztUEBHPjT
+        i2tHBMfpLhbq8MEWKUlPNVE+9k2vRR+wktwIxLQKL7EDtuC6flZ/t5bH5sHK8olN
+        n1LlrKNkR61PPz+ZqH6ajxtIyYXoBNvmsjLV2H/4BIvMqEIHTADVwRvBKRRpmdHH
+        LQIDAQAB
+        -----END PUBLIC KEY-----
+        """
+}
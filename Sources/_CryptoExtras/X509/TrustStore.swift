@@ -0,0 +1,371 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+@_implementationOnly import CCryptoBoringSSL
+@_implementationOnly import CCryptoBoringSSLShims
+import Crypto
+import Foundation
+
+/// A set of trusted certificates, backed by a BoringSSL `X509_STORE`, that can be filled quickly from large CA
+/// bundles.
+///
+/// Loading a bundle one certificate at a time decodes and parses serially, and takes the store's lock once per
+/// certificate. ``load(bundle:maximumThreads:)`` instead splits the bundle at its object boundaries, decodes and parses the
+/// certificates on several threads, and inserts them all under a single acquisition of the lock.
+///
+/// ```swift
+/// let store = try _X509TrustStore()
+/// let statistics = try store.load(contentsOfFile: "/etc/ssl/certs/ca-certificates.crt")
+/// print(statistics.certificatesAdded, statistics.bytesPerSecond)
+/// ```
+///
+/// A store built once can be saved with ``snapshotRepresentation()`` and reopened with
+/// ``init(contentsOfSnapshot:verifyingIntegrity:)``, which maps the snapshot and parses each certificate only when a
+/// lookup first needs its subject.
+///
+/// A hashed CA directory such as `/etc/ssl/certs` can be added with
+/// ``addCertificateDirectory(atPath:refreshInterval:)``, which indexes its file names once instead of probing the
+/// filesystem on every lookup.
+///
+/// The store is safe to use from several threads at once.
+public final class _X509TrustStore: @unchecked Sendable {
+    /// What a load did, and how long it took.
+    public struct LoadStatistics: Hashable, Sendable {
+        /// The size of the bundle.
+        public var byteCount: Int
+        /// The certificates found in the bundle.
+        public var certificatesParsed: Int
+        /// PEM blocks of other types, such as CRLs or keys, which were ignored.
+        public var objectsSkipped: Int
+        /// The certificates that were new to the store.
+        public var certificatesAdded: Int
+        /// The certificates that were already in the store, or repeated in the bundle.
+        public var duplicates: Int
+        /// The threads that parsed certificates, including the calling one.
+        public var threadCount: Int
+        /// The time spent splitting and parsing the bundle.
+        public var parseNanoseconds: UInt64
+        /// The time spent inserting the parsed certificates into the store.
+        public var insertNanoseconds: UInt64
+
+        /// The load throughput, or zero if no time was measured.
+        public var bytesPerSecond: Double {
+            let nanoseconds = self.parseNanoseconds + self.insertNanoseconds
+            return nanoseconds == 0 ? 0 : Double(self.byteCount) * 1e9 / Double(nanoseconds)
+        }
+    }
+
+    private let store: OpaquePointer
+
+    // The snapshot the store reads certificates from, if it was opened from one. BoringSSL holds a pointer into it, so
+    // it is set once, before the snapshot is added, and never mutated; a `Data` that is not mutated keeps its bytes
+    // where they are.
+    private var snapshot: Data?
+
+    /// Creates an empty store.
+    public init() throws {
+        guard let store = CCryptoBoringSSL_X509_STORE_new() else {
+            throw CryptoKitError.internalBoringSSLError()
+        }
+        self.store = store
+    }
+
+    deinit {
+        CCryptoBoringSSL_X509_STORE_free(self.store)
+    }
+
+    /// The number of certificates in the store, including any from a snapshot that haven't been parsed yet.
+    public var certificateCount: Int {
+        CCryptoBoringSSLShims_X509_STORE_certificate_count(self.store)
+    }
+
+    /// Adds every certificate in a CA bundle.
+    ///
+    /// The bundle is either PEM, where text between the blocks is ignored as in most CA files, or back-to-back DER
+    /// certificates. `CERTIFICATE`, `X509 CERTIFICATE` and `TRUSTED CERTIFICATE` blocks are loaded, and any other block
+    /// is skipped. Certificates already in the store are ignored.
+    ///
+    /// - Parameters:
+    ///   - bundle: The PEM or DER bundle.
+    ///   - maximumThreads: The most threads to parse on, including the calling one. Small bundles use fewer.
+    /// - Returns: What was loaded, and how long it took.
+    /// - Throws: ``_CryptoTrustStoreError/malformedBundle(offset:)`` if any object in the bundle is malformed, in which
+    ///     case nothing is added.
+    @discardableResult
+    public func load<Bundle: DataProtocol>(
+        bundle: Bundle,
+        maximumThreads: Int = ProcessInfo.processInfo.activeProcessorCount
+    ) throws -> LoadStatistics {
+        precondition(maximumThreads > 0)
+        let contiguousBundle: ContiguousBytes = bundle.regions.count == 1 ? bundle.regions.first! : Array(bundle)
+        var statistics = CCryptoBoringSSLShims_X509_bundle_statistics()
+        let result = contiguousBundle.withUnsafeBytes { bundle in
+            CCryptoBoringSSLShims_X509_STORE_load_bundle(
+                self.store,
+                bundle.baseAddress,
+                bundle.count,
+                maximumThreads,
+                &statistics
+            )
+        }
+        guard result == 1 else {
+            CCryptoBoringSSL_ERR_clear_error()
+            throw _CryptoTrustStoreError.malformedBundle(offset: statistics.failed_offset)
+        }
+        return LoadStatistics(
+            byteCount: statistics.bytes,
+            certificatesParsed: statistics.objects_parsed,
+            objectsSkipped: statistics.objects_skipped,
+            certificatesAdded: statistics.certificates_added,
+            duplicates: statistics.duplicates,
+            threadCount: statistics.threads,
+            parseNanoseconds: statistics.parse_ns,
+            insertNanoseconds: statistics.insert_ns
+        )
+    }
+
+    /// Adds every certificate in the CA bundle at `path`. See ``load(bundle:maximumThreads:)``.
+    @discardableResult
+    public func load(
+        contentsOfFile path: String,
+        maximumThreads: Int = ProcessInfo.processInfo.activeProcessorCount
+    ) throws -> LoadStatistics {
+        let bundle = try Data(contentsOf: URL(fileURLWithPath: path), options: .alwaysMapped)
+        return try self.load(bundle: bundle, maximumThreads: maximumThreads)
+    }
+}
+
+extension _X509TrustStore {
+    /// Opens a store from a snapshot made by ``snapshotRepresentation()``.
+    ///
+    /// Opening checks the snapshot's structure, and its digest if `verifyingIntegrity` is set, but parses no
+    /// certificates. Each is parsed and added to the store the first time a lookup or chain build asks for its
+    /// subject. The store keeps `snapshot`, so a mapped snapshot stays mapped for as long as the store lives.
+    ///
+    /// - Parameters:
+    ///   - snapshot: The snapshot.
+    ///   - verifyingIntegrity: Whether to check the snapshot's SHA-256 digest, which means reading all of it.
+    /// - Throws: ``_CryptoTrustStoreError/malformedSnapshot`` if the snapshot is malformed or corrupted.
+    public convenience init(snapshot: Data, verifyingIntegrity: Bool = true) throws {
+        try self.init()
+        self.snapshot = snapshot
+        let result = self.snapshot!.withUnsafeBytes { snapshot in
+            CCryptoBoringSSLShims_X509_STORE_add_snapshot(
+                self.store,
+                snapshot.baseAddress,
+                snapshot.count,
+                verifyingIntegrity ? 1 : 0
+            )
+        }
+        guard result == 1 else {
+            CCryptoBoringSSL_ERR_clear_error()
+            throw _CryptoTrustStoreError.malformedSnapshot
+        }
+    }
+
+    /// Maps the snapshot at `url` and opens a store from it. See ``init(snapshot:verifyingIntegrity:)``.
+    public convenience init(contentsOfSnapshot url: URL, verifyingIntegrity: Bool = true) throws {
+        try self.init(snapshot: Data(contentsOf: url, options: .alwaysMapped), verifyingIntegrity: verifyingIntegrity)
+    }
+
+    /// Serializes every certificate in the store into a snapshot, loading any from its directory that lookups haven't
+    /// needed yet.
+    ///
+    /// Alongside each certificate's DER encoding, the snapshot holds its canonical subject name and its hash, and its
+    /// subject key identifier, with indexes over both. The same certificates always give the same snapshot.
+    public func snapshotRepresentation() throws -> Data {
+        var bytes: UnsafeMutablePointer<UInt8>? = nil
+        var count = 0
+        guard CCryptoBoringSSLShims_X509_STORE_write_snapshot(self.store, &bytes, &count) == 1, let bytes = bytes else {
+            CCryptoBoringSSL_ERR_clear_error()
+            throw CryptoKitError.internalBoringSSLError()
+        }
+        defer {
+            CCryptoBoringSSL_OPENSSL_free(bytes)
+        }
+        return Data(bytes: bytes, count: count)
+    }
+
+    /// Looks up a trusted certificate that issued `certificate`, as building a chain from it would.
+    ///
+    /// - Parameter certificate: A DER certificate.
+    /// - Returns: The issuer's DER encoding, or `nil` if the store holds no issuer of `certificate`.
+    public func issuer<Certificate: DataProtocol>(of certificate: Certificate) throws -> Data? {
+        let contiguousCertificate: ContiguousBytes =
+            certificate.regions.count == 1 ? certificate.regions.first! : Array(certificate)
+        return try contiguousCertificate.withUnsafeBytes { certificate in
+            try Self.foundCertificate { der, count in
+                CCryptoBoringSSLShims_X509_STORE_find_issuer(
+                    self.store,
+                    certificate.baseAddress?.assumingMemoryBound(to: UInt8.self),
+                    certificate.count,
+                    der,
+                    count
+                )
+            }
+        }
+    }
+
+    /// Looks up a certificate in the store by its subject key identifier.
+    ///
+    /// Certificates in a snapshot are found through its index, without parsing any of them.
+    ///
+    /// - Returns: The certificate's DER encoding, or `nil` if no certificate in the store has that identifier.
+    public func certificate<KeyIdentifier: DataProtocol>(
+        withSubjectKeyIdentifier keyIdentifier: KeyIdentifier
+    ) throws -> Data? {
+        let keyIdentifier = Array(keyIdentifier)
+        return try keyIdentifier.withUnsafeBufferPointer { keyIdentifier in
+            try Self.foundCertificate { der, count in
+                CCryptoBoringSSLShims_X509_STORE_find_by_key_id(
+                    self.store,
+                    keyIdentifier.baseAddress,
+                    keyIdentifier.count,
+                    der,
+                    count
+                )
+            }
+        }
+    }
+
+    /// The certificates from the store's snapshot that lookups have needed so far.
+    var snapshotCertificatesParsed: Int {
+        CCryptoBoringSSLShims_X509_STORE_snapshot_parsed_count(self.store)
+    }
+
+    fileprivate static func foundCertificate(
+        _ find: (UnsafeMutablePointer<UnsafeMutablePointer<UInt8>?>, UnsafeMutablePointer<Int>) -> CInt
+    ) throws -> Data? {
+        var der: UnsafeMutablePointer<UInt8>? = nil
+        var count = 0
+        let result = find(&der, &count)
+        defer {
+            CCryptoBoringSSL_OPENSSL_free(der)
+        }
+        switch result {
+        case 1:
+            return Data(bytes: der!, count: count)
+        case 0:
+            return nil
+        default:
+            CCryptoBoringSSL_ERR_clear_error()
+            throw CryptoKitError.invalidParameter
+        }
+    }
+}
+
+extension _X509TrustStore {
+    /// An immutable copy of a store's certificates, for issuer lookups on hot paths that many threads share.
+    ///
+    /// Every ``_X509TrustStore/issuer(of:)`` takes and drops a reference to the store and to the issuer, and takes the
+    /// store's lock and the issuer's extension-cache lock. Those are atomic writes to the same few cache lines from
+    /// every thread, so a widely shared trust anchor keeps them moving between cores. Pinned anchors hold only what
+    /// the issuer checks compare, copied out of each certificate once, with no reference counts or locks, and a lookup
+    /// writes only to the certificate it was given.
+    ///
+    /// The copy doesn't see certificates loaded into the store after it was made.
+    public final class PinnedAnchors: @unchecked Sendable {
+        private let pinned: OpaquePointer
+
+        fileprivate init(store: OpaquePointer) throws {
+            guard let pinned = CCryptoBoringSSLShims_X509_STORE_pin_anchors(store) else {
+                throw CryptoKitError.internalBoringSSLError()
+            }
+            self.pinned = pinned
+        }
+
+        deinit {
+            CCryptoBoringSSLShims_X509_pinned_anchors_free(self.pinned)
+        }
+
+        /// The number of distinct certificates that were pinned.
+        public var certificateCount: Int {
+            CCryptoBoringSSLShims_X509_pinned_anchors_count(self.pinned)
+        }
+
+        /// Looks up a pinned certificate that issued `certificate`, with the checks ``_X509TrustStore/issuer(of:)``
+        /// makes.
+        ///
+        /// - Parameter certificate: A DER certificate.
+        /// - Returns: The issuer's DER encoding, or `nil` if no pinned certificate issued `certificate`.
+        public func issuer<Certificate: DataProtocol>(of certificate: Certificate) throws -> Data? {
+            let contiguousCertificate: ContiguousBytes =
+                certificate.regions.count == 1 ? certificate.regions.first! : Array(certificate)
+            return try contiguousCertificate.withUnsafeBytes { certificate in
+                try _X509TrustStore.foundCertificate { der, count in
+                    CCryptoBoringSSLShims_X509_pinned_anchors_find_issuer(
+                        self.pinned,
+                        certificate.baseAddress?.assumingMemoryBound(to: UInt8.self),
+                        certificate.count,
+                        der,
+                        count
+                    )
+                }
+            }
+        }
+    }
+
+    /// Copies every certificate in the store, including any from a snapshot or a directory that haven't been parsed
+    /// yet, into a ``PinnedAnchors`` for contention-free lookups.
+    public func pinnedAnchors() throws -> PinnedAnchors {
+        try PinnedAnchors(store: self.store)
+    }
+}
+
+extension _X509TrustStore {
+    /// What a store's certificate directory holds, and how often lookups have gone to the filesystem for it.
+    public struct DirectoryStatistics: Hashable, Sendable {
+        /// The certificate files in the directory's index.
+        public var filesIndexed: Int
+        /// The files that lookups have opened so far.
+        public var filesLoaded: Int
+        /// The times the directory's file names have been read, including when it was added.
+        public var scans: Int
+    }
+
+    /// Makes the certificates in a hashed CA directory, such as `/etc/ssl/certs`, available to the store.
+    ///
+    /// The directory holds files named by subject name hash, `<hash>.0`, `<hash>.1` and so on, as `openssl rehash`
+    /// writes them. Their names are read into an index here, once. A lookup opens only the files for its subject's
+    /// hash, the first time that hash is asked for, and a subject the directory doesn't hold is answered from the
+    /// index without touching the filesystem.
+    ///
+    /// Lookups check the directory's modification time at most once per `refreshInterval`, and read its names again
+    /// when it has changed. New and replaced files are loaded the next time their hash is asked for. Certificates from
+    /// files that were removed stay in the store.
+    ///
+    /// - Parameters:
+    ///   - path: The directory.
+    ///   - refreshInterval: The least time between checks of the directory's modification time.
+    /// - Throws: ``_CryptoTrustStoreError/unreadableDirectory`` if the directory can't be read, or the store already
+    ///     has one. Directories are not supported on Windows.
+    public func addCertificateDirectory(atPath path: String, refreshInterval: TimeInterval = 1) throws {
+        precondition(refreshInterval >= 0)
+        let refreshNanoseconds =
+            refreshInterval * 1e9 >= Double(UInt64.max) ? UInt64.max : UInt64(refreshInterval * 1e9)
+        guard CCryptoBoringSSLShims_X509_STORE_add_directory(self.store, path, refreshNanoseconds) == 1 else {
+            throw _CryptoTrustStoreError.unreadableDirectory
+        }
+    }
+
+    /// What the store's certificate directory holds, or zeros if it has none.
+    public var directoryStatistics: DirectoryStatistics {
+        var statistics = CCryptoBoringSSLShims_X509_directory_statistics()
+        CCryptoBoringSSLShims_X509_STORE_directory_statistics(self.store, &statistics)
+        return DirectoryStatistics(
+            filesIndexed: statistics.files_indexed,
+            filesLoaded: statistics.files_loaded,
+            scans: statistics.scans
+        )
+    }
+}
@@ -0,0 +1,117 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import CCryptoBenchmarkAllocations
+import Foundation
+import _CryptoExtras
+
+// Allocation runs count heap allocations per operation rather than time. Heap allocations are counted for the whole
+// process by wrapping malloc, which only works on Linux with glibc; BoringSSL's own are counted by
+// _CryptoInstrumentation when it is compiled in. Either column is "-" when it can't be counted.
+
+struct AllocationCount {
+    var heap: Double?
+    var boringSSL: Double?
+}
+
+/// Runs `body` once to build any lazily created state, such as the DRBG and curve groups, then counts the allocations
+/// of `iterations` further operations.
+func countAllocations(_ body: Benchmark.Body, iterations: Int) throws -> AllocationCount {
+    try body(1)
+
+    let boringSSLBefore = _CryptoInstrumentation.currentThread
+    let heapBefore = CCryptoBenchmarkAllocations_count()
+    try body(iterations)
+    let heapAfter = CCryptoBenchmarkAllocations_count()
+    let boringSSL = _CryptoInstrumentation.currentThread.subtracting(boringSSLBefore)
+
+    var count = AllocationCount()
+    if CCryptoBenchmarkAllocations_enabled() != 0 {
+        count.heap = Double(heapAfter - heapBefore) / Double(iterations)
+    }
+    if _CryptoInstrumentation.isEnabled {
+        count.boringSSL = Double(boringSSL.allocations) / Double(iterations)
+    }
+    return count
+}
+
+/// The counts an allocation run is checked against, keyed by benchmark name and layer.
+///
+/// The file is the `--csv` output of an earlier allocation run.
+struct AllocationBaseline {
+    var counts: [String: AllocationCount] = [:]
+
+    /// Anything more than this many allocations per operation over the baseline is a regression.
+    static let tolerance = 0.05
+
+    init(contentsOf path: String) throws {
+        let contents = try String(contentsOfFile: path, encoding: .utf8)
+        for line in contents.split(whereSeparator: \.isNewline) {
+            let fields = line.split(separator: ",", omittingEmptySubsequences: false).map(String.init)
+            guard fields.count >= 4, fields[0] != allocationHeadings[0] else {
+                continue
+            }
+            self.counts[Self.key(fields[0], fields[1])] = AllocationCount(heap: Double(fields[2]), boringSSL: Double(fields[3]))
+        }
+    }
+
+    static func key(_ name: String, _ layer: String) -> String {
+        "\(name)/\(layer)"
+    }
+
+    /// Describes each count in `count` that exceeds the baseline for `benchmark`.
+    func regressions(of count: AllocationCount, for benchmark: Benchmark) -> [String] {
+        guard let baseline = self.counts[Self.key(benchmark.name, benchmark.layer.rawValue)] else {
+            return []
+        }
+        var regressions = [String]()
+        if let heap = count.heap, let limit = baseline.heap, heap > limit + Self.tolerance {
+            regressions.append("heap \(format(heap, decimals: 2)) > \(format(limit, decimals: 2))")
+        }
+        if let boringSSL = count.boringSSL, let limit = baseline.boringSSL, boringSSL > limit + Self.tolerance {
+            regressions.append("boringssl \(format(boringSSL, decimals: 2)) > \(format(limit, decimals: 2))")
+        }
+        return regressions
+    }
+}
+
+let allocationHeadings = ["benchmark", "layer", "heap allocs/op", "boringssl allocs/op"]
+let allocationWidths = [32, 6, 15, 20]
+
+/// Counts the allocations of every benchmark over `iterations` operations. With a baseline, reports each benchmark
+/// that allocates more than it records and returns false if there were any.
+func runAllocations(_ benchmarks: [Benchmark], iterations: Int, baseline: AllocationBaseline?, options: Options) -> Bool {
+    printRow(allocationHeadings, widths: allocationWidths, options: options)
+    var regressed = [String]()
+    for benchmark in benchmarks {
+        do {
+            let count = try countAllocations(try benchmark.makeBody(), iterations: iterations)
+            printRow([
+                benchmark.name,
+                benchmark.layer.rawValue,
+                format(count.heap, decimals: 2),
+                format(count.boringSSL, decimals: 2),
+            ], widths: allocationWidths, options: options)
+            if let regressions = baseline?.regressions(of: count, for: benchmark), !regressions.isEmpty {
+                regressed.append("\(benchmark.name) (\(benchmark.layer.rawValue)): \(regressions.joined(separator: ", "))")
+            }
+        } catch {
+            FileHandle.standardError.write(Data("\(benchmark.name) (\(benchmark.layer.rawValue)) failed: \(error)\n".utf8))
+        }
+    }
+
+    for regression in regressed {
+        FileHandle.standardError.write(Data("Allocation regression in \(regression)\n".utf8))
+    }
+    return regressed.isEmpty
+}
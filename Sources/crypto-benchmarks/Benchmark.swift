@@ -0,0 +1,128 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Foundation
+
+/// A single timed operation.
+struct Benchmark {
+    /// Runs the operation `iterations` times.
+    typealias Body = (_ iterations: Int) throws -> Void
+
+    /// Whether a benchmark goes through the Swift API or calls BoringSSL directly.
+    enum Layer: String {
+        case swift
+        case c
+    }
+
+    var name: String
+    var layer: Layer
+
+    /// The number of bytes each operation processes, for benchmarks where throughput is meaningful.
+    var bytesPerOperation: Int?
+
+    /// Whether the threads of a scaling run share one key, rather than each generating their own.
+    var sharesKey: Bool
+
+    /// For a benchmark that rotates through many keys, the name of the benchmark that does the same work with one.
+    var hotKey: String?
+
+    /// Builds the keys and buffers the operation needs, then returns one body for each of `threads` threads. Setup
+    /// is not timed.
+    var makeBodies: (_ threads: Int) throws -> [Body]
+
+    /// A benchmark in which every thread sets up its own key and buffers.
+    init(_ name: String, layer: Layer, bytesPerOperation: Int? = nil, hotKey: String? = nil, makeBody: @escaping () throws -> Body) {
+        self.name = name
+        self.layer = layer
+        self.bytesPerOperation = bytesPerOperation
+        self.sharesKey = false
+        self.hotKey = hotKey
+        self.makeBodies = { threads in
+            try (0..<threads).map { _ in try makeBody() }
+        }
+    }
+
+    /// A benchmark in which the threads share the state made by `makeSharedState`, typically a key, and each set up
+    /// their own buffers around it.
+    init<State>(
+        _ name: String,
+        layer: Layer,
+        bytesPerOperation: Int? = nil,
+        sharing makeSharedState: @escaping () throws -> State,
+        makeBody: @escaping (State) throws -> Body
+    ) {
+        self.name = name
+        self.layer = layer
+        self.bytesPerOperation = bytesPerOperation
+        self.sharesKey = true
+        self.makeBodies = { threads in
+            let state = try makeSharedState()
+            return try (0..<threads).map { _ in try makeBody(state) }
+        }
+    }
+
+    /// Builds the body for a single-threaded run.
+    func makeBody() throws -> Body {
+        try self.makeBodies(1)[0]
+    }
+}
+
+struct Measurement {
+    var iterations: Int
+    var nanoseconds: UInt64
+
+    var nanosecondsPerOperation: Double {
+        Double(self.nanoseconds) / Double(self.iterations)
+    }
+
+    var operationsPerSecond: Double {
+        1_000_000_000 / self.nanosecondsPerOperation
+    }
+}
+
+/// Keeps the optimizer from discarding the result of a benchmarked operation.
+@inline(never)
+func blackHole<T>(_ value: T) {
+    withExtendedLifetime(value) {}
+}
+
+func time(_ body: Benchmark.Body, iterations: Int) throws -> UInt64 {
+    let start = DispatchTime.now().uptimeNanoseconds
+    try body(iterations)
+    return DispatchTime.now().uptimeNanoseconds - start
+}
+
+/// Finds an iteration count for which `body` takes at least `duration` seconds, returning it and the time it took.
+func calibrate(_ body: Benchmark.Body, duration: Double) throws -> (iterations: Int, nanoseconds: UInt64) {
+    let target = UInt64(duration * 1_000_000_000)
+    var iterations = 1
+    var elapsed = try time(body, iterations: iterations)
+    while elapsed < target {
+        // Grow towards the target from the rate seen so far, but never by more than 10x in a single step.
+        let estimate = Double(iterations) * Double(target) / Double(max(elapsed, 1))
+        iterations = max(iterations + 1, min(iterations * 10, Int(estimate * 1.1)))
+        elapsed = try time(body, iterations: iterations)
+    }
+    return (iterations, elapsed)
+}
+
+/// Picks an iteration count that takes at least `duration` seconds, then reports the fastest of `rounds` runs of it.
+func measure(_ body: Benchmark.Body, duration: Double, rounds: Int) throws -> Measurement {
+    let (iterations, elapsed) = try calibrate(body, duration: duration)
+
+    var best = elapsed
+    for _ in 1..<max(rounds, 1) {
+        best = min(best, try time(body, iterations: iterations))
+    }
+    return Measurement(iterations: iterations, nanoseconds: best)
+}
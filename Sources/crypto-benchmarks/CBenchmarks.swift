@@ -0,0 +1,631 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import CCryptoBoringSSL
+import CCryptoBoringSSLShims
+import Foundation
+
+// These call BoringSSL directly, doing the same work as the matching Swift benchmarks. Keys and contexts are
+// set up once, outside the timed loop, so the difference between the two layers is the cost of the Swift API:
+// per-call key setup, allocation of the returned values, and argument conversion.
+
+struct BenchmarkSetupError: Error {
+    var benchmark: String
+}
+
+/// An initialized `EVP_AEAD_CTX` with a random key.
+final class RawAEADContext {
+    let context: UnsafeMutablePointer<EVP_AEAD_CTX>
+
+    init(_ aead: OpaquePointer) throws {
+        let context = UnsafeMutablePointer<EVP_AEAD_CTX>.allocate(capacity: 1)
+        context.initialize(to: EVP_AEAD_CTX())
+        var key = [UInt8](repeating: 0, count: CCryptoBoringSSL_EVP_AEAD_key_length(aead))
+        let keyByteCount = key.count
+        CCryptoBoringSSL_RAND_bytes(&key, keyByteCount)
+        guard CCryptoBoringSSL_EVP_AEAD_CTX_init(context, aead, key, keyByteCount, 0, nil) == 1 else {
+            context.deallocate()
+            throw BenchmarkSetupError(benchmark: "EVP_AEAD_CTX_init")
+        }
+        self.context = context
+    }
+
+    deinit {
+        CCryptoBoringSSL_EVP_AEAD_CTX_cleanup(self.context)
+        self.context.deallocate()
+    }
+}
+
+/// A freshly generated `EC_KEY`.
+final class RawECKey {
+    let key: OpaquePointer
+
+    init(curve: Int32) throws {
+        guard let key = CCryptoBoringSSL_EC_KEY_new_by_curve_name(curve) else {
+            throw BenchmarkSetupError(benchmark: "EC_KEY_new_by_curve_name")
+        }
+        self.key = key
+        guard CCryptoBoringSSL_EC_KEY_generate_key(key) == 1 else {
+            throw BenchmarkSetupError(benchmark: "EC_KEY_generate_key")
+        }
+    }
+
+    deinit {
+        CCryptoBoringSSL_EC_KEY_free(self.key)
+    }
+}
+
+/// A freshly generated `RSA` key with a public exponent of 65537.
+final class RawRSAKey {
+    let key: OpaquePointer
+
+    init(bits: Int32) throws {
+        guard let key = CCryptoBoringSSL_RSA_new() else {
+            throw BenchmarkSetupError(benchmark: "RSA_new")
+        }
+        self.key = key
+        let exponent = CCryptoBoringSSL_BN_new()
+        defer { CCryptoBoringSSL_BN_free(exponent) }
+        guard CCryptoBoringSSL_BN_set_word(exponent, 65537) == 1,
+              CCryptoBoringSSL_RSA_generate_key_ex(key, bits, exponent, nil) == 1 else {
+            throw BenchmarkSetupError(benchmark: "RSA_generate_key_ex")
+        }
+    }
+
+    deinit {
+        CCryptoBoringSSL_RSA_free(self.key)
+    }
+}
+
+/// An HPKE context set up as a sender to a freshly generated X25519 key.
+final class RawHPKESender {
+    let context: UnsafeMutablePointer<EVP_HPKE_CTX>
+    let recipientPublicKey: [UInt8]
+
+    init(info: [UInt8]) throws {
+        guard let context = CCryptoBoringSSL_EVP_HPKE_CTX_new() else {
+            throw BenchmarkSetupError(benchmark: "EVP_HPKE_CTX_new")
+        }
+        self.context = context
+        self.recipientPublicKey = try Self.generateRecipientPublicKey()
+
+        var encapsulatedKey = [UInt8](repeating: 0, count: Int(EVP_HPKE_MAX_ENC_LENGTH))
+        var encapsulatedKeyByteCount = 0
+        let encapsulatedKeyCapacity = encapsulatedKey.count
+        guard CCryptoBoringSSL_EVP_HPKE_CTX_setup_sender(
+            context, &encapsulatedKey, &encapsulatedKeyByteCount, encapsulatedKeyCapacity,
+            CCryptoBoringSSL_EVP_hpke_x25519_hkdf_sha256(), CCryptoBoringSSL_EVP_hpke_hkdf_sha256(),
+            CCryptoBoringSSL_EVP_hpke_chacha20_poly1305(),
+            self.recipientPublicKey, self.recipientPublicKey.count, info, info.count
+        ) == 1 else {
+            throw BenchmarkSetupError(benchmark: "EVP_HPKE_CTX_setup_sender")
+        }
+    }
+
+    static func generateRecipientPublicKey() throws -> [UInt8] {
+        guard let key = CCryptoBoringSSL_EVP_HPKE_KEY_new() else {
+            throw BenchmarkSetupError(benchmark: "EVP_HPKE_KEY_new")
+        }
+        defer { CCryptoBoringSSL_EVP_HPKE_KEY_free(key) }
+
+        var publicKey = [UInt8](repeating: 0, count: Int(EVP_HPKE_MAX_PUBLIC_KEY_LENGTH))
+        var publicKeyByteCount = 0
+        let publicKeyCapacity = publicKey.count
+        guard CCryptoBoringSSL_EVP_HPKE_KEY_generate(key, CCryptoBoringSSL_EVP_hpke_x25519_hkdf_sha256()) == 1,
+              CCryptoBoringSSL_EVP_HPKE_KEY_public_key(key, &publicKey, &publicKeyByteCount, publicKeyCapacity) == 1 else {
+            throw BenchmarkSetupError(benchmark: "EVP_HPKE_KEY_generate")
+        }
+        return Array(publicKey.prefix(publicKeyByteCount))
+    }
+
+    deinit {
+        CCryptoBoringSSL_EVP_HPKE_CTX_free(self.context)
+    }
+}
+
+func cAEADBenchmarks(_ name: String, aead: @escaping () -> OpaquePointer?, message: [UInt8]) -> [Benchmark] {
+    let size = message.count
+    let seal = Benchmark("\(name) seal \(size)B", layer: .c, bytesPerOperation: size) {
+        let context = try RawAEADContext(aead()!)
+        let nonce = [UInt8](repeating: 0, count: CCryptoBoringSSL_EVP_AEAD_nonce_length(aead()))
+        var output = [UInt8](repeating: 0, count: size + CCryptoBoringSSL_EVP_AEAD_max_overhead(aead()))
+        let outputCapacity = output.count
+        return { iterations in
+            var outputByteCount = 0
+            for _ in 0..<iterations {
+                guard CCryptoBoringSSL_EVP_AEAD_CTX_seal(context.context, &output, &outputByteCount, outputCapacity,
+                                                         nonce, nonce.count, message, size, nil, 0) == 1 else {
+                    throw BenchmarkSetupError(benchmark: "EVP_AEAD_CTX_seal")
+                }
+            }
+        }
+    }
+    let open = Benchmark("\(name) open \(size)B", layer: .c, bytesPerOperation: size) {
+        let context = try RawAEADContext(aead()!)
+        let nonce = [UInt8](repeating: 0, count: CCryptoBoringSSL_EVP_AEAD_nonce_length(aead()))
+        var ciphertext = [UInt8](repeating: 0, count: size + CCryptoBoringSSL_EVP_AEAD_max_overhead(aead()))
+        var ciphertextByteCount = 0
+        let ciphertextCapacity = ciphertext.count
+        guard CCryptoBoringSSL_EVP_AEAD_CTX_seal(context.context, &ciphertext, &ciphertextByteCount, ciphertextCapacity,
+                                                 nonce, nonce.count, message, size, nil, 0) == 1 else {
+            throw BenchmarkSetupError(benchmark: "EVP_AEAD_CTX_seal")
+        }
+        var output = [UInt8](repeating: 0, count: ciphertextByteCount)
+        let outputCapacity = output.count
+        return { iterations in
+            var outputByteCount = 0
+            for _ in 0..<iterations {
+                guard CCryptoBoringSSL_EVP_AEAD_CTX_open(context.context, &output, &outputByteCount, outputCapacity,
+                                                         nonce, nonce.count, ciphertext, ciphertextByteCount, nil, 0) == 1 else {
+                    throw BenchmarkSetupError(benchmark: "EVP_AEAD_CTX_open")
+                }
+            }
+        }
+    }
+    return [seal, open]
+}
+
+func cDigestBenchmark(_ name: String, digest: @escaping () -> OpaquePointer?, message: [UInt8]) -> Benchmark {
+    Benchmark("\(name) \(message.count)B", layer: .c, bytesPerOperation: message.count) {
+        var output = [UInt8](repeating: 0, count: Int(EVP_MAX_MD_SIZE))
+        var outputByteCount: UInt32 = 0
+        return { iterations in
+            for _ in 0..<iterations {
+                CCryptoBoringSSL_EVP_Digest(message, message.count, &output, &outputByteCount, digest(), nil)
+            }
+        }
+    }
+}
+
+func cECDSABenchmarks(_ name: String, curve: Int32, digest: @escaping () -> OpaquePointer?) -> [Benchmark] {
+    let message = Array(signedMessage)
+
+    // Like the Swift API, each operation hashes the message before signing or verifying it.
+    func hash(into output: inout [UInt8]) -> Int {
+        var outputByteCount: UInt32 = 0
+        CCryptoBoringSSL_EVP_Digest(message, message.count, &output, &outputByteCount, digest(), nil)
+        return Int(outputByteCount)
+    }
+
+    let sign = Benchmark("\(name) sign", layer: .c) {
+        let key = try RawECKey(curve: curve)
+        var signature = [UInt8](repeating: 0, count: CCryptoBoringSSL_ECDSA_size(key.key))
+        var hashed = [UInt8](repeating: 0, count: Int(EVP_MAX_MD_SIZE))
+        return { iterations in
+            var signatureByteCount: UInt32 = 0
+            for _ in 0..<iterations {
+                let hashedByteCount = hash(into: &hashed)
+                guard CCryptoBoringSSL_ECDSA_sign(0, hashed, hashedByteCount, &signature, &signatureByteCount, key.key) == 1 else {
+                    throw BenchmarkSetupError(benchmark: "ECDSA_sign")
+                }
+            }
+        }
+    }
+    let verify = Benchmark("\(name) verify", layer: .c) {
+        let key = try RawECKey(curve: curve)
+        var signature = [UInt8](repeating: 0, count: CCryptoBoringSSL_ECDSA_size(key.key))
+        var hashed = [UInt8](repeating: 0, count: Int(EVP_MAX_MD_SIZE))
+        var signatureByteCount: UInt32 = 0
+        let hashedByteCount = hash(into: &hashed)
+        guard CCryptoBoringSSL_ECDSA_sign(0, hashed, hashedByteCount, &signature, &signatureByteCount, key.key) == 1 else {
+            throw BenchmarkSetupError(benchmark: "ECDSA_sign")
+        }
+        return { iterations in
+            for _ in 0..<iterations {
+                let hashedByteCount = hash(into: &hashed)
+                guard CCryptoBoringSSL_ECDSA_verify(0, hashed, hashedByteCount, signature, Int(signatureByteCount), key.key) == 1 else {
+                    throw BenchmarkSetupError(benchmark: "ECDSA_verify")
+                }
+            }
+        }
+    }
+    return [sign, verify]
+}
+
+func cRSABenchmarks(bits: Int32) -> [Benchmark] {
+    let message = Array(signedMessage)
+
+    func hash(into output: inout [UInt8]) {
+        CCryptoBoringSSL_SHA256(message, message.count, &output)
+    }
+
+    // A salt length of -1 means a salt as long as the digest, which is what the Swift API uses.
+    let sign = Benchmark("RSA-\(bits) PSS sign", layer: .c) {
+        let key = try RawRSAKey(bits: bits)
+        var signature = [UInt8](repeating: 0, count: Int(CCryptoBoringSSL_RSA_size(key.key)))
+        let signatureCapacity = signature.count
+        var hashed = [UInt8](repeating: 0, count: Int(SHA256_DIGEST_LENGTH))
+        return { iterations in
+            var signatureByteCount = 0
+            for _ in 0..<iterations {
+                hash(into: &hashed)
+                guard CCryptoBoringSSL_RSA_sign_pss_mgf1(key.key, &signatureByteCount, &signature, signatureCapacity,
+                                                         hashed, hashed.count, CCryptoBoringSSL_EVP_sha256(), nil, -1) == 1 else {
+                    throw BenchmarkSetupError(benchmark: "RSA_sign_pss_mgf1")
+                }
+            }
+        }
+    }
+    let verify = Benchmark("RSA-\(bits) PSS verify", layer: .c) {
+        let key = try RawRSAKey(bits: bits)
+        var signature = [UInt8](repeating: 0, count: Int(CCryptoBoringSSL_RSA_size(key.key)))
+        let signatureCapacity = signature.count
+        var hashed = [UInt8](repeating: 0, count: Int(SHA256_DIGEST_LENGTH))
+        var signatureByteCount = 0
+        hash(into: &hashed)
+        guard CCryptoBoringSSL_RSA_sign_pss_mgf1(key.key, &signatureByteCount, &signature, signatureCapacity,
+                                                 hashed, hashed.count, CCryptoBoringSSL_EVP_sha256(), nil, -1) == 1 else {
+            throw BenchmarkSetupError(benchmark: "RSA_sign_pss_mgf1")
+        }
+        return { iterations in
+            for _ in 0..<iterations {
+                hash(into: &hashed)
+                guard CCryptoBoringSSL_RSA_verify_pss_mgf1(key.key, hashed, hashed.count, CCryptoBoringSSL_EVP_sha256(), nil, -1,
+                                                           signature, signatureByteCount) == 1 else {
+                    throw BenchmarkSetupError(benchmark: "RSA_verify_pss_mgf1")
+                }
+            }
+        }
+    }
+    return [sign, verify]
+}
+
+func cBenchmarks() -> [Benchmark] {
+    var benchmarks = [Benchmark]()
+
+    for size in messageSizes {
+        let message = [UInt8](repeating: 0x2a, count: size)
+        benchmarks.append(contentsOf: cAEADBenchmarks("AES-GCM-256", aead: { CCryptoBoringSSL_EVP_aead_aes_256_gcm() }, message: message))
+        benchmarks.append(contentsOf: cAEADBenchmarks("ChaChaPoly", aead: { CCryptoBoringSSL_EVP_aead_chacha20_poly1305() }, message: message))
+        benchmarks.append(contentsOf: cAEADBenchmarks("AES-GCM-SIV-256", aead: { CCryptoBoringSSL_EVP_aead_aes_256_gcm_siv() }, message: message))
+        // e_aesccm.c runs the CBC-MAC and the CTR keystream as separate passes.
+        benchmarks.append(contentsOf: cAEADBenchmarks("AES-CCM-128", aead: { CCryptoBoringSSL_EVP_aead_aes_128_ccm_matter() }, message: message))
+        benchmarks.append(cDigestBenchmark("SHA256", digest: { CCryptoBoringSSL_EVP_sha256() }, message: message))
+        benchmarks.append(cDigestBenchmark("SHA384", digest: { CCryptoBoringSSL_EVP_sha384() }, message: message))
+        benchmarks.append(cDigestBenchmark("SHA512", digest: { CCryptoBoringSSL_EVP_sha512() }, message: message))
+        // cmac.c runs each block through AES_encrypt on its own.
+        benchmarks.append(Benchmark("AES-CMAC-128 \(size)B", layer: .c, bytesPerOperation: size) {
+            let key = [UInt8](repeating: 0x0b, count: 16)
+            var output = [UInt8](repeating: 0, count: 16)
+            return { iterations in
+                for _ in 0..<iterations {
+                    guard CCryptoBoringSSL_AES_CMAC(&output, key, key.count, message, size) == 1 else {
+                        throw BenchmarkSetupError(benchmark: "AES_CMAC")
+                    }
+                }
+            }
+        })
+        // The shim entries run sixteen ChaCha20 blocks at a time with AVX-512 and four Poly1305 blocks at a time
+        // with AVX2, where the CPU has them. Elsewhere they match the BoringSSL entries.
+        benchmarks.append(Benchmark("ChaCha20 \(size)B", layer: .c, bytesPerOperation: size) {
+            let key = [UInt8](repeating: 0x0b, count: 32)
+            let nonce = [UInt8](repeating: 0x0c, count: 12)
+            var output = [UInt8](repeating: 0, count: size)
+            return { iterations in
+                for _ in 0..<iterations {
+                    CCryptoBoringSSL_CRYPTO_chacha_20(&output, message, size, key, nonce, 0)
+                }
+            }
+        })
+        benchmarks.append(Benchmark("ChaCha20 shim \(size)B", layer: .c, bytesPerOperation: size) {
+            let key = [UInt8](repeating: 0x0b, count: 32)
+            let nonce = [UInt8](repeating: 0x0c, count: 12)
+            var output = [UInt8](repeating: 0, count: size)
+            return { iterations in
+                for _ in 0..<iterations {
+                    CCryptoBoringSSLShims_chacha_20(&output, message, size, key, nonce, 0)
+                }
+            }
+        })
+        benchmarks.append(Benchmark("Poly1305 \(size)B", layer: .c, bytesPerOperation: size) {
+            let key = [UInt8](repeating: 0x0b, count: 32)
+            // poly1305_state is a C array, which Swift imports as a tuple with no initializer.
+            var storage = [UInt8](repeating: 0, count: MemoryLayout<poly1305_state>.size)
+            var tag = [UInt8](repeating: 0, count: 16)
+            return { iterations in
+                storage.withUnsafeMutableBytes { storage in
+                    let state = storage.baseAddress!.assumingMemoryBound(to: poly1305_state.self)
+                    for _ in 0..<iterations {
+                        CCryptoBoringSSL_CRYPTO_poly1305_init(state, key)
+                        CCryptoBoringSSL_CRYPTO_poly1305_update(state, message, size)
+                        CCryptoBoringSSL_CRYPTO_poly1305_finish(state, &tag)
+                    }
+                }
+            }
+        })
+        benchmarks.append(Benchmark("Poly1305 shim \(size)B", layer: .c, bytesPerOperation: size) {
+            let key = [UInt8](repeating: 0x0b, count: 32)
+            var state = CCryptoBoringSSLShims_POLY1305_STATE()
+            var tag = [UInt8](repeating: 0, count: 16)
+            return { iterations in
+                for _ in 0..<iterations {
+                    CCryptoBoringSSLShims_poly1305_init(&state, key)
+                    CCryptoBoringSSLShims_poly1305_update(&state, message, size)
+                    CCryptoBoringSSLShims_poly1305_finish(&state, &tag)
+                }
+            }
+        })
+        benchmarks.append(Benchmark("HMAC-SHA256 \(size)B", layer: .c, bytesPerOperation: size) {
+            let key = [UInt8](repeating: 0x0b, count: 32)
+            var output = [UInt8](repeating: 0, count: Int(EVP_MAX_MD_SIZE))
+            var outputByteCount: UInt32 = 0
+            return { iterations in
+                for _ in 0..<iterations {
+                    CCryptoBoringSSL_HMAC(CCryptoBoringSSL_EVP_sha256(), key, key.count, message, size, &output, &outputByteCount)
+                }
+            }
+        })
+    }
+
+    benchmarks.append(Benchmark("HKDF-SHA256 32B", layer: .c) {
+        let inputKeyMaterial = [UInt8](repeating: 0x0b, count: 32)
+        let salt = [UInt8](repeating: 0x01, count: 32)
+        let info = Array("benchmark".utf8)
+        var output = [UInt8](repeating: 0, count: 32)
+        let outputByteCount = output.count
+        return { iterations in
+            for _ in 0..<iterations {
+                guard CCryptoBoringSSL_HKDF(&output, outputByteCount, CCryptoBoringSSL_EVP_sha256(),
+                                            inputKeyMaterial, inputKeyMaterial.count, salt, salt.count, info, info.count) == 1 else {
+                    throw BenchmarkSetupError(benchmark: "HKDF")
+                }
+            }
+        }
+    })
+
+    benchmarks.append(contentsOf: cECDSABenchmarks("P256", curve: NID_X9_62_prime256v1, digest: { CCryptoBoringSSL_EVP_sha256() }))
+    benchmarks.append(contentsOf: cECDSABenchmarks("P384", curve: NID_secp384r1, digest: { CCryptoBoringSSL_EVP_sha384() }))
+    benchmarks.append(contentsOf: cECDSABenchmarks("P521", curve: NID_secp521r1, digest: { CCryptoBoringSSL_EVP_sha512() }))
+
+    let message = Array(signedMessage)
+    benchmarks.append(Benchmark("Ed25519 sign", layer: .c) {
+        var publicKey = [UInt8](repeating: 0, count: 32)
+        var privateKey = [UInt8](repeating: 0, count: 64)
+        CCryptoBoringSSL_ED25519_keypair(&publicKey, &privateKey)
+        var signature = [UInt8](repeating: 0, count: 64)
+        return { iterations in
+            for _ in 0..<iterations {
+                CCryptoBoringSSL_ED25519_sign(&signature, message, message.count, privateKey)
+            }
+        }
+    })
+    benchmarks.append(Benchmark("Ed25519 verify", layer: .c) {
+        var publicKey = [UInt8](repeating: 0, count: 32)
+        var privateKey = [UInt8](repeating: 0, count: 64)
+        CCryptoBoringSSL_ED25519_keypair(&publicKey, &privateKey)
+        var signature = [UInt8](repeating: 0, count: 64)
+        CCryptoBoringSSL_ED25519_sign(&signature, message, message.count, privateKey)
+        return { iterations in
+            for _ in 0..<iterations {
+                guard CCryptoBoringSSL_ED25519_verify(message, message.count, signature, publicKey) == 1 else {
+                    throw BenchmarkSetupError(benchmark: "ED25519_verify")
+                }
+            }
+        }
+    })
+    benchmarks.append(Benchmark("X25519 agreement", layer: .c) {
+        var publicKey = [UInt8](repeating: 0, count: 32)
+        var privateKey = [UInt8](repeating: 0, count: 32)
+        var peerPublicKey = [UInt8](repeating: 0, count: 32)
+        var peerPrivateKey = [UInt8](repeating: 0, count: 32)
+        CCryptoBoringSSL_X25519_keypair(&publicKey, &privateKey)
+        CCryptoBoringSSL_X25519_keypair(&peerPublicKey, &peerPrivateKey)
+        var sharedSecret = [UInt8](repeating: 0, count: 32)
+        return { iterations in
+            for _ in 0..<iterations {
+                guard CCryptoBoringSSL_X25519(&sharedSecret, privateKey, peerPublicKey) == 1 else {
+                    throw BenchmarkSetupError(benchmark: "X25519")
+                }
+            }
+        }
+    })
+
+    for bits: Int32 in [2048, 3072, 4096] {
+        benchmarks.append(contentsOf: cRSABenchmarks(bits: bits))
+    }
+
+    let info = Array("benchmark".utf8)
+    benchmarks.append(Benchmark("HPKE X25519 setup", layer: .c) {
+        let recipientPublicKey = try RawHPKESender.generateRecipientPublicKey()
+        var encapsulatedKey = [UInt8](repeating: 0, count: Int(EVP_HPKE_MAX_ENC_LENGTH))
+        let encapsulatedKeyCapacity = encapsulatedKey.count
+        guard let context = CCryptoBoringSSL_EVP_HPKE_CTX_new() else {
+            throw BenchmarkSetupError(benchmark: "EVP_HPKE_CTX_new")
+        }
+        // The context is reused by cleaning it up between setups, which matches the Swift API creating a new one.
+        let holder = RawHPKEContextHolder(context)
+        return { iterations in
+            var encapsulatedKeyByteCount = 0
+            for _ in 0..<iterations {
+                CCryptoBoringSSL_EVP_HPKE_CTX_cleanup(holder.context)
+                guard CCryptoBoringSSL_EVP_HPKE_CTX_setup_sender(
+                    holder.context, &encapsulatedKey, &encapsulatedKeyByteCount, encapsulatedKeyCapacity,
+                    CCryptoBoringSSL_EVP_hpke_x25519_hkdf_sha256(), CCryptoBoringSSL_EVP_hpke_hkdf_sha256(),
+                    CCryptoBoringSSL_EVP_hpke_chacha20_poly1305(),
+                    recipientPublicKey, recipientPublicKey.count, info, info.count
+                ) == 1 else {
+                    throw BenchmarkSetupError(benchmark: "EVP_HPKE_CTX_setup_sender")
+                }
+            }
+        }
+    })
+    for size in messageSizes {
+        let message = [UInt8](repeating: 0x2a, count: size)
+        benchmarks.append(Benchmark("HPKE X25519 seal \(size)B", layer: .c, bytesPerOperation: size) {
+            let sender = try RawHPKESender(info: info)
+            var output = [UInt8](repeating: 0, count: size + CCryptoBoringSSL_EVP_HPKE_CTX_max_overhead(sender.context))
+            let outputCapacity = output.count
+            return { iterations in
+                var outputByteCount = 0
+                for _ in 0..<iterations {
+                    guard CCryptoBoringSSL_EVP_HPKE_CTX_seal(sender.context, &output, &outputByteCount, outputCapacity,
+                                                             message, size, nil, 0) == 1 else {
+                        throw BenchmarkSetupError(benchmark: "EVP_HPKE_CTX_seal")
+                    }
+                }
+            }
+        })
+    }
+
+    for count in randomByteCounts {
+        benchmarks.append(Benchmark("RAND_bytes \(count >> 10)KiB", layer: .c, bytesPerOperation: count) {
+            var output = [UInt8](repeating: 0, count: count)
+            return { iterations in
+                for _ in 0..<iterations {
+                    guard CCryptoBoringSSL_RAND_bytes(&output, count) == 1 else {
+                        throw BenchmarkSetupError(benchmark: "RAND_bytes")
+                    }
+                }
+            }
+        })
+        // AES_ctr128_encrypt reaches aes_hw_ctr32_encrypt_blocks where the CPU has AES instructions, so this is the
+        // rate the bulk random generator would reach with no rekeying.
+        benchmarks.append(Benchmark("AES-256-CTR keystream \(count >> 10)KiB", layer: .c, bytesPerOperation: count) {
+            let keyBytes = [UInt8](repeating: 0x0b, count: 32)
+            var key = AES_KEY()
+            guard CCryptoBoringSSL_AES_set_encrypt_key(keyBytes, 256, &key) == 0 else {
+                throw BenchmarkSetupError(benchmark: "AES_set_encrypt_key")
+            }
+            let zeros = [UInt8](repeating: 0, count: count)
+            var output = [UInt8](repeating: 0, count: count)
+            var counter = [UInt8](repeating: 0, count: 16)
+            var ecount = [UInt8](repeating: 0, count: 16)
+            var num = UInt32.zero
+            return { iterations in
+                for _ in 0..<iterations {
+                    CCryptoBoringSSL_AES_ctr128_encrypt(zeros, &output, count, &key, &counter, &ecount, &num)
+                }
+            }
+        })
+    }
+
+    benchmarks.append(contentsOf: cTrustTokenBenchmarks(requests: 16, tokensPerRequest: 10))
+
+    return benchmarks
+}
+
+/// A PST v1 (PMBTokens) issuer with a fresh key, and one client request for each of `requests` clients.
+final class RawTrustTokenIssuer {
+    let issuer: OpaquePointer
+
+    /// The requests, as allocated by `TRUST_TOKEN_CLIENT_begin_issuance`.
+    let requests: [UnsafeBufferPointer<UInt8>]
+
+    init(requests: Int, tokensPerRequest: Int) throws {
+        let method = CCryptoBoringSSL_TRUST_TOKEN_pst_v1_pmb()
+        var privateKey = [UInt8](repeating: 0, count: Int(TRUST_TOKEN_MAX_PRIVATE_KEY_SIZE))
+        var publicKey = [UInt8](repeating: 0, count: Int(TRUST_TOKEN_MAX_PUBLIC_KEY_SIZE))
+        var privateKeyByteCount = 0
+        var publicKeyByteCount = 0
+        let privateKeyCapacity = privateKey.count
+        let publicKeyCapacity = publicKey.count
+        guard CCryptoBoringSSL_TRUST_TOKEN_generate_key(
+            method, &privateKey, &privateKeyByteCount, privateKeyCapacity,
+            &publicKey, &publicKeyByteCount, publicKeyCapacity, 1
+        ) == 1 else {
+            throw BenchmarkSetupError(benchmark: "TRUST_TOKEN_generate_key")
+        }
+
+        guard let issuer = CCryptoBoringSSL_TRUST_TOKEN_ISSUER_new(method, tokensPerRequest) else {
+            throw BenchmarkSetupError(benchmark: "TRUST_TOKEN_ISSUER_new")
+        }
+        self.issuer = issuer
+        guard CCryptoBoringSSL_TRUST_TOKEN_ISSUER_add_key(issuer, privateKey, privateKeyByteCount) == 1 else {
+            throw BenchmarkSetupError(benchmark: "TRUST_TOKEN_ISSUER_add_key")
+        }
+
+        self.requests = try (0..<requests).map { _ in
+            guard let client = CCryptoBoringSSL_TRUST_TOKEN_CLIENT_new(method, tokensPerRequest) else {
+                throw BenchmarkSetupError(benchmark: "TRUST_TOKEN_CLIENT_new")
+            }
+            defer { CCryptoBoringSSL_TRUST_TOKEN_CLIENT_free(client) }
+            var keyIndex = 0
+            var request: UnsafeMutablePointer<UInt8>?
+            var requestByteCount = 0
+            guard CCryptoBoringSSL_TRUST_TOKEN_CLIENT_add_key(client, &keyIndex, publicKey, publicKeyByteCount) == 1,
+                  CCryptoBoringSSL_TRUST_TOKEN_CLIENT_begin_issuance(client, &request, &requestByteCount, tokensPerRequest) == 1 else {
+                throw BenchmarkSetupError(benchmark: "TRUST_TOKEN_CLIENT_begin_issuance")
+            }
+            return UnsafeBufferPointer(start: request, count: requestByteCount)
+        }
+    }
+
+    deinit {
+        for request in self.requests {
+            CCryptoBoringSSL_OPENSSL_free(UnsafeMutableRawPointer(mutating: request.baseAddress))
+        }
+        CCryptoBoringSSL_TRUST_TOKEN_ISSUER_free(self.issuer)
+    }
+}
+
+/// Issuance of a batch of client requests, one at a time and spread across every core. The issuer key and its
+/// precomputed tables are shared by both.
+func cTrustTokenBenchmarks(requests: Int, tokensPerRequest: Int) -> [Benchmark] {
+    let name = "Trust token issue \(requests)x\(tokensPerRequest)"
+    let serial = Benchmark(name, layer: .c) {
+        let issuer = try RawTrustTokenIssuer(requests: requests, tokensPerRequest: tokensPerRequest)
+        return { iterations in
+            for _ in 0..<iterations {
+                for request in issuer.requests {
+                    var response: UnsafeMutablePointer<UInt8>?
+                    var responseByteCount = 0
+                    var tokensIssued = 0
+                    guard CCryptoBoringSSL_TRUST_TOKEN_ISSUER_issue(
+                        issuer.issuer, &response, &responseByteCount, &tokensIssued,
+                        request.baseAddress, request.count, 1, 0, tokensPerRequest
+                    ) == 1 else {
+                        throw BenchmarkSetupError(benchmark: "TRUST_TOKEN_ISSUER_issue")
+                    }
+                    CCryptoBoringSSL_OPENSSL_free(response)
+                }
+            }
+        }
+    }
+    let parallel = Benchmark("\(name) parallel", layer: .c) {
+        let issuer = try RawTrustTokenIssuer(requests: requests, tokensPerRequest: tokensPerRequest)
+        let threads = ProcessInfo.processInfo.activeProcessorCount
+        return { iterations in
+            for _ in 0..<iterations {
+                var ops = issuer.requests.map { request in
+                    CCryptoBoringSSLShims_TRUST_TOKEN_issue_op(
+                        request: request.baseAddress, request_len: request.count,
+                        out: nil, out_len: 0, tokens_issued: 0, result: 0
+                    )
+                }
+                let failures = CCryptoBoringSSLShims_TRUST_TOKEN_ISSUER_issue_batch(
+                    issuer.issuer, &ops, ops.count, 1, 0, tokensPerRequest, threads
+                )
+                for op in ops {
+                    CCryptoBoringSSL_OPENSSL_free(op.out)
+                }
+                guard failures == 0 else {
+                    throw BenchmarkSetupError(benchmark: "TRUST_TOKEN_ISSUER_issue_batch")
+                }
+            }
+        }
+    }
+    return [serial, parallel]
+}
+
+/// Frees an `EVP_HPKE_CTX` when the benchmark that uses it is done.
+final class RawHPKEContextHolder {
+    let context: UnsafeMutablePointer<EVP_HPKE_CTX>
+
+    init(_ context: UnsafeMutablePointer<EVP_HPKE_CTX>) {
+        self.context = context
+    }
+
+    deinit {
+        CCryptoBoringSSL_EVP_HPKE_CTX_free(self.context)
+    }
+}
@@ -0,0 +1,270 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import CCryptoBoringSSL
+import Crypto
+import _CryptoExtras
+import Foundation
+
+// Key-agile benchmarks do the same work as a hot-key benchmark, but move to the next of a large set of keys on every
+// operation, the way a server handling many clients does. That brings back the costs a single key hides: per-call key
+// setup such as AES key expansion in EVP_AEAD_CTX_init, misses on key schedules, Montgomery contexts and precomputed
+// tables that no longer fit in L1 or L2, and the first-use setup of each key. With --flush-caches the benchmarks also
+// sweep the cache before every operation.
+
+let aesKeyCount = 10_000
+let rsaKeyCount = 1_000
+let p256KeyCount = 10_000
+
+/// Reads through the cache before each operation of a key-agile benchmark, if `--flush-caches` was given.
+struct CacheFlush {
+    private var sweep: [UInt8]?
+
+    init(enabled: Bool) {
+        self.sweep = enabled ? [UInt8](repeating: 1, count: cacheSweepByteCount) : nil
+    }
+
+    var isEnabled: Bool {
+        self.sweep != nil
+    }
+
+    @inline(__always)
+    func run() {
+        if let sweep = self.sweep {
+            blackHole(sweepCache(sweep))
+        }
+    }
+}
+
+/// RSA-2048 public keys with distinct moduli.
+///
+/// Generating a thousand RSA keys takes minutes, so the moduli are products of pairs drawn from a pool of primes taken
+/// from a few dozen generated keys. Sharing primes between moduli would be fatal for real keys, but every modulus is
+/// still a different number with its own Montgomery context, which is what matters here.
+final class RawRSAPublicKeys {
+    let keys: [OpaquePointer]
+
+    init(count: Int) throws {
+        var primes = [OpaquePointer]()
+        var generated = [RawRSAKey]()
+        while primes.count * (primes.count - 1) / 2 < count {
+            let key = try RawRSAKey(bits: 2048)
+            generated.append(key)
+            primes.append(CCryptoBoringSSL_RSA_get0_p(key.key))
+            primes.append(CCryptoBoringSSL_RSA_get0_q(key.key))
+        }
+
+        let context = CCryptoBoringSSL_BN_CTX_new()
+        let modulus = CCryptoBoringSSL_BN_new()
+        let exponent = CCryptoBoringSSL_BN_new()
+        defer {
+            CCryptoBoringSSL_BN_CTX_free(context)
+            CCryptoBoringSSL_BN_free(modulus)
+            CCryptoBoringSSL_BN_free(exponent)
+        }
+        guard CCryptoBoringSSL_BN_set_word(exponent, 65537) == 1 else {
+            throw BenchmarkSetupError(benchmark: "BN_set_word")
+        }
+
+        // The primes belong to the generated keys, which must outlive the loop.
+        var keys = [OpaquePointer]()
+        defer { withExtendedLifetime(generated) {} }
+        outer: for i in primes.indices {
+            for j in (i + 1)..<primes.count {
+                guard keys.count < count else {
+                    break outer
+                }
+                guard CCryptoBoringSSL_BN_mul(modulus, primes[i], primes[j], context) == 1,
+                      let key = CCryptoBoringSSL_RSA_new_public_key(modulus, exponent) else {
+                    keys.forEach { CCryptoBoringSSL_RSA_free($0) }
+                    throw BenchmarkSetupError(benchmark: "RSA_new_public_key")
+                }
+                keys.append(key)
+            }
+        }
+        self.keys = keys
+    }
+
+    /// The PKCS#1 encoding of each key.
+    func derRepresentations() throws -> [Data] {
+        try self.keys.map { key in
+            var bytes: UnsafeMutablePointer<UInt8>?
+            var byteCount = 0
+            guard CCryptoBoringSSL_RSA_public_key_to_bytes(&bytes, &byteCount, key) == 1, let bytes = bytes else {
+                throw BenchmarkSetupError(benchmark: "RSA_public_key_to_bytes")
+            }
+            defer { CCryptoBoringSSL_OPENSSL_free(bytes) }
+            return Data(bytes: bytes, count: byteCount)
+        }
+    }
+
+    deinit {
+        self.keys.forEach { CCryptoBoringSSL_RSA_free($0) }
+    }
+}
+
+/// A signature that is shorter than every modulus but otherwise random. Verifying it does the whole public-key
+/// operation, which is nearly all of the cost of a verification, and then fails on the padding check.
+let rsaAgileSignature: [UInt8] = [0] + (1..<256).map { _ in UInt8.random(in: 0...255) }
+
+func keyAgileBenchmarks(flush: CacheFlush) -> [Benchmark] {
+    var benchmarks = [Benchmark]()
+
+    for size in [16, 1024] {
+        let message = Data(repeating: 0x2a, count: size)
+        let bytes = Array(message)
+
+        benchmarks.append(Benchmark("AES-GCM-256 seal \(size)B, 10k keys", layer: .swift, bytesPerOperation: size,
+                                    hotKey: "AES-GCM-256 seal \(size)B") {
+            let keys = (0..<aesKeyCount).map { _ in SymmetricKey(size: .bits256) }
+            return { iterations in
+                for iteration in 0..<iterations {
+                    flush.run()
+                    blackHole(try AES.GCM.seal(message, using: keys[iteration % keys.count]))
+                }
+            }
+        })
+
+        // The raw keys are expanded on every operation, as the Swift API does.
+        benchmarks.append(Benchmark("AES-GCM-256 seal \(size)B, 10k keys", layer: .c, bytesPerOperation: size,
+                                    hotKey: "AES-GCM-256 seal \(size)B") {
+            let aead = CCryptoBoringSSL_EVP_aead_aes_256_gcm()
+            let keyByteCount = CCryptoBoringSSL_EVP_AEAD_key_length(aead)
+            var keys = [UInt8](repeating: 0, count: aesKeyCount * keyByteCount)
+            let keysByteCount = keys.count
+            CCryptoBoringSSL_RAND_bytes(&keys, keysByteCount)
+            let nonce = [UInt8](repeating: 0, count: CCryptoBoringSSL_EVP_AEAD_nonce_length(aead))
+            var output = [UInt8](repeating: 0, count: size + CCryptoBoringSSL_EVP_AEAD_max_overhead(aead))
+            let outputCapacity = output.count
+            var context = EVP_AEAD_CTX()
+            return { iterations in
+                var outputByteCount = 0
+                for iteration in 0..<iterations {
+                    flush.run()
+                    let offset = (iteration % aesKeyCount) * keyByteCount
+                    let sealed = keys.withUnsafeBufferPointer { keys in
+                        CCryptoBoringSSL_EVP_AEAD_CTX_init(&context, aead, keys.baseAddress! + offset, keyByteCount, 0, nil) == 1 &&
+                            CCryptoBoringSSL_EVP_AEAD_CTX_seal(&context, &output, &outputByteCount, outputCapacity,
+                                                               nonce, nonce.count, bytes, size, nil, 0) == 1
+                    }
+                    CCryptoBoringSSL_EVP_AEAD_CTX_cleanup(&context)
+                    guard sealed else {
+                        throw BenchmarkSetupError(benchmark: "EVP_AEAD_CTX_seal")
+                    }
+                }
+            }
+        })
+    }
+
+    benchmarks.append(Benchmark("P256 verify, 10k keys", layer: .swift, hotKey: "P256 verify") {
+        let keys = try (0..<p256KeyCount).map { _ -> (P256.Signing.PublicKey, P256.Signing.ECDSASignature) in
+            let key = P256.Signing.PrivateKey()
+            return (key.publicKey, try key.signature(for: signedMessage))
+        }
+        return { iterations in
+            for iteration in 0..<iterations {
+                flush.run()
+                let (key, signature) = keys[iteration % keys.count]
+                blackHole(key.isValidSignature(signature, for: signedMessage))
+            }
+        }
+    })
+    benchmarks.append(Benchmark("P256 verify, 10k keys", layer: .c, hotKey: "P256 verify") {
+        let message = Array(signedMessage)
+        var hashed = [UInt8](repeating: 0, count: Int(SHA256_DIGEST_LENGTH))
+        CCryptoBoringSSL_SHA256(message, message.count, &hashed)
+        let keys = try (0..<p256KeyCount).map { _ -> (RawECKey, [UInt8]) in
+            let key = try RawECKey(curve: NID_X9_62_prime256v1)
+            var signature = [UInt8](repeating: 0, count: CCryptoBoringSSL_ECDSA_size(key.key))
+            var signatureByteCount: UInt32 = 0
+            guard CCryptoBoringSSL_ECDSA_sign(0, hashed, hashed.count, &signature, &signatureByteCount, key.key) == 1 else {
+                throw BenchmarkSetupError(benchmark: "ECDSA_sign")
+            }
+            return (key, Array(signature.prefix(Int(signatureByteCount))))
+        }
+        return { iterations in
+            for iteration in 0..<iterations {
+                flush.run()
+                let (key, signature) = keys[iteration % keys.count]
+                // Like the hot-key benchmark, each operation hashes the message first.
+                CCryptoBoringSSL_SHA256(message, message.count, &hashed)
+                guard CCryptoBoringSSL_ECDSA_verify(0, hashed, hashed.count, signature, signature.count, key.key) == 1 else {
+                    throw BenchmarkSetupError(benchmark: "ECDSA_verify")
+                }
+            }
+        }
+    })
+
+    benchmarks.append(Benchmark("RSA-2048 PSS verify, 1k keys", layer: .swift, hotKey: "RSA-2048 PSS verify") {
+        let keys = try RawRSAPublicKeys(count: rsaKeyCount).derRepresentations().map {
+            try _RSA.Signing.PublicKey(derRepresentation: $0)
+        }
+        let signature = _RSA.Signing.RSASignature(rawRepresentation: rsaAgileSignature)
+        return { iterations in
+            for iteration in 0..<iterations {
+                flush.run()
+                blackHole(keys[iteration % keys.count].isValidSignature(signature, for: signedMessage, padding: .PSS))
+            }
+        }
+    })
+    benchmarks.append(Benchmark("RSA-2048 PSS verify, 1k keys", layer: .c, hotKey: "RSA-2048 PSS verify") {
+        let keys = try RawRSAPublicKeys(count: rsaKeyCount)
+        let message = Array(signedMessage)
+        var hashed = [UInt8](repeating: 0, count: Int(SHA256_DIGEST_LENGTH))
+        return { iterations in
+            for iteration in 0..<iterations {
+                flush.run()
+                CCryptoBoringSSL_SHA256(message, message.count, &hashed)
+                blackHole(CCryptoBoringSSL_RSA_verify_pss_mgf1(keys.keys[iteration % keys.keys.count], hashed, hashed.count,
+                                                               CCryptoBoringSSL_EVP_sha256(), nil, -1,
+                                                               rsaAgileSignature, rsaAgileSignature.count))
+            }
+        }
+    })
+
+    return benchmarks
+}
+
+/// Compares each key-agile benchmark against the hot-key benchmark it rotates keys for. When the caches were flushed,
+/// the time the flush itself takes is measured and left out.
+func printKeyAgility(_ results: [Result], flush: CacheFlush, options: Options) {
+    let hotResults = Dictionary(
+        results.map { ("\($0.benchmark.name)/\($0.benchmark.layer.rawValue)", $0.measurement) },
+        uniquingKeysWith: { first, _ in first }
+    )
+    let pairs = results.compactMap { result -> (Result, Measurement)? in
+        guard let hotKey = result.benchmark.hotKey else {
+            return nil
+        }
+        return hotResults["\(hotKey)/\(result.benchmark.layer.rawValue)"].map { (result, $0) }
+    }
+    guard !pairs.isEmpty else {
+        return
+    }
+
+    var flushNanoseconds = 0.0
+    if flush.isEnabled, let measurement = try? measure({ iterations in
+        for _ in 0..<iterations {
+            flush.run()
+        }
+    }, duration: options.duration, rounds: options.rounds) {
+        flushNanoseconds = measurement.nanosecondsPerOperation
+    }
+
+    print("\nKey-agile cost relative to one hot key\(flush.isEnabled ? ", excluding the cache flush" : ""):")
+    for (result, hot) in pairs {
+        let agile = result.measurement.nanosecondsPerOperation - flushNanoseconds
+        let name = "\(result.benchmark.name) (\(result.benchmark.layer.rawValue))"
+        print("\(name.padding(toLength: 40, withPad: " ", startingAt: 0)) \(format(agile / hot.nanosecondsPerOperation, decimals: 2))x  (\(format(agile - hot.nanosecondsPerOperation, decimals: 1)) ns/op)")
+    }
+}
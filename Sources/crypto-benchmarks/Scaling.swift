@@ -0,0 +1,202 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import CCryptoBoringSSL
+import Crypto
+import _CryptoExtras
+import Foundation
+
+// Scaling runs time the same operation on several threads at once. Per-thread-key benchmarks show contention on
+// global state (the DRBG's thread state list, CRYPTO_once, CRYPTO_BUFFER pools), while the shared-key benchmarks
+// below add contention on per-key state such as RSA blinding and the lazily built Montgomery contexts.
+
+func sharedKeyBenchmarks() -> [Benchmark] {
+    let message = Data(repeating: 0x2a, count: 1024)
+    let bytes = Array(message)
+    var benchmarks = [Benchmark]()
+
+    benchmarks.append(Benchmark("AES-GCM-256 seal 1024B", layer: .swift, bytesPerOperation: 1024, sharing: {
+        SymmetricKey(size: .bits256)
+    }) { key in
+        let nonce = AES.GCM.Nonce()
+        return { iterations in
+            for _ in 0..<iterations {
+                blackHole(try AES.GCM.seal(message, using: key, nonce: nonce))
+            }
+        }
+    })
+    benchmarks.append(Benchmark("AES-GCM-256 seal 1024B", layer: .c, bytesPerOperation: 1024, sharing: {
+        try RawAEADContext(CCryptoBoringSSL_EVP_aead_aes_256_gcm())
+    }) { context in
+        let nonce = [UInt8](repeating: 0, count: 12)
+        var output = [UInt8](repeating: 0, count: bytes.count + 16)
+        let outputCapacity = output.count
+        return { iterations in
+            var outputByteCount = 0
+            for _ in 0..<iterations {
+                guard CCryptoBoringSSL_EVP_AEAD_CTX_seal(context.context, &output, &outputByteCount, outputCapacity,
+                                                         nonce, nonce.count, bytes, bytes.count, nil, 0) == 1 else {
+                    throw BenchmarkSetupError(benchmark: "EVP_AEAD_CTX_seal")
+                }
+            }
+        }
+    })
+
+    benchmarks.append(Benchmark("RSA-2048 PSS sign", layer: .swift, sharing: {
+        try _RSA.Signing.PrivateKey(keySize: .bits2048)
+    }) { key in
+        return { iterations in
+            for _ in 0..<iterations {
+                blackHole(try key.signature(for: signedMessage, padding: .PSS))
+            }
+        }
+    })
+    benchmarks.append(Benchmark("RSA-2048 PSS sign", layer: .c, sharing: {
+        try RawRSAKey(bits: 2048)
+    }) { key in
+        var signature = [UInt8](repeating: 0, count: Int(CCryptoBoringSSL_RSA_size(key.key)))
+        let signatureCapacity = signature.count
+        var hashed = [UInt8](repeating: 0, count: Int(SHA256_DIGEST_LENGTH))
+        let message = Array(signedMessage)
+        return { iterations in
+            var signatureByteCount = 0
+            for _ in 0..<iterations {
+                CCryptoBoringSSL_SHA256(message, message.count, &hashed)
+                guard CCryptoBoringSSL_RSA_sign_pss_mgf1(key.key, &signatureByteCount, &signature, signatureCapacity,
+                                                         hashed, hashed.count, CCryptoBoringSSL_EVP_sha256(), nil, -1) == 1 else {
+                    throw BenchmarkSetupError(benchmark: "RSA_sign_pss_mgf1")
+                }
+            }
+        }
+    })
+
+    benchmarks.append(Benchmark("P256 sign", layer: .swift, sharing: {
+        P256.Signing.PrivateKey()
+    }) { key in
+        return { iterations in
+            for _ in 0..<iterations {
+                blackHole(try key.signature(for: signedMessage))
+            }
+        }
+    })
+
+    return benchmarks
+}
+
+struct ScalingResult {
+    var threads: Int
+    var operations: Int
+    var nanoseconds: UInt64
+
+    var operationsPerSecond: Double {
+        Double(self.operations) * 1_000_000_000 / Double(self.nanoseconds)
+    }
+}
+
+/// Runs `bodies` concurrently, one per thread, each for `iterations` iterations, and reports the wall-clock time from
+/// the moment all of them are released until the last one finishes.
+func runConcurrently(_ bodies: [Benchmark.Body], iterations: Int) throws -> UInt64 {
+    let ready = DispatchSemaphore(value: 0)
+    let start = DispatchSemaphore(value: 0)
+    let finished = DispatchGroup()
+    let firstError = FirstError()
+
+    for body in bodies {
+        finished.enter()
+        let thread = Thread {
+            defer { finished.leave() }
+            ready.signal()
+            start.wait()
+            do {
+                try body(iterations)
+            } catch {
+                firstError.record(error)
+            }
+        }
+        thread.start()
+    }
+
+    for _ in bodies {
+        ready.wait()
+    }
+    let startTime = DispatchTime.now().uptimeNanoseconds
+    for _ in bodies {
+        start.signal()
+    }
+    finished.wait()
+    let elapsed = DispatchTime.now().uptimeNanoseconds - startTime
+
+    if let error = firstError.error {
+        throw error
+    }
+    return elapsed
+}
+
+/// Holds the first error thrown by any thread of a concurrent run.
+final class FirstError {
+    private let lock = NSLock()
+    private var _error: Error?
+
+    var error: Error? {
+        self.lock.lock()
+        defer { self.lock.unlock() }
+        return self._error
+    }
+
+    func record(_ error: Error) {
+        self.lock.lock()
+        defer { self.lock.unlock() }
+        if self._error == nil {
+            self._error = error
+        }
+    }
+}
+
+/// Times `benchmark` at each of `threadCounts`, reporting the fastest of `rounds` runs at each count.
+///
+/// Each thread performs the number of iterations that takes one thread `duration` seconds, so perfect scaling keeps
+/// the wall-clock time constant as threads are added.
+func measureScaling(_ benchmark: Benchmark, threadCounts: [Int], duration: Double, rounds: Int) throws -> [ScalingResult] {
+    let (iterations, _) = try calibrate(try benchmark.makeBody(), duration: duration)
+
+    return try threadCounts.map { threads in
+        let bodies = try benchmark.makeBodies(threads)
+        var best = UInt64.max
+        for _ in 0..<max(rounds, 1) {
+            best = min(best, try runConcurrently(bodies, iterations: iterations))
+        }
+        return ScalingResult(threads: threads, operations: threads * iterations, nanoseconds: best)
+    }
+}
+
+/// Parses a thread count specification: either a list such as `1,2,8,64`, or a single maximum `N`, which means
+/// powers of two up to and including `N`.
+func parseThreadCounts(_ specification: String) -> [Int]? {
+    let counts = specification.split(separator: ",").map { Int($0) }
+    guard !counts.isEmpty, counts.allSatisfy({ ($0 ?? 0) > 0 }) else {
+        return nil
+    }
+    if counts.count > 1 {
+        return counts.map { $0! }
+    }
+
+    let maximum = counts[0]!
+    var result = [Int]()
+    var threads = 1
+    while threads < maximum {
+        result.append(threads)
+        threads *= 2
+    }
+    result.append(maximum)
+    return result
+}
@@ -0,0 +1,116 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+
+// Startup runs measure what a short-lived process pays before its first signature: loading the binary, the first
+// use of the DRBG and CPU capability detection, and building the curve's EC_GROUP under CRYPTO_once. None of that
+// repeats within a process, so each sample is a fresh child process that signs exactly once.
+
+struct StartupCurve {
+    /// The name passed to `--first-signature`.
+    var flag: String
+
+    var name: String
+
+    var sign: () throws -> Void
+}
+
+private let startupMessage = Data("time to first signature".utf8)
+
+let startupCurves = [
+    StartupCurve(flag: "p256", name: "P256 time to first signature") {
+        blackHole(try P256.Signing.PrivateKey().signature(for: startupMessage))
+    },
+    StartupCurve(flag: "p384", name: "P384 time to first signature") {
+        blackHole(try P384.Signing.PrivateKey().signature(for: startupMessage))
+    },
+    StartupCurve(flag: "p521", name: "P521 time to first signature") {
+        blackHole(try P521.Signing.PrivateKey().signature(for: startupMessage))
+    },
+]
+
+/// Generates a key and signs once, then prints the nanoseconds that took. This is the child side of `--startup`.
+func runFirstSignature(flag: String) {
+    guard let curve = startupCurves.first(where: { $0.flag == flag }) else {
+        print("The curve must be one of \(startupCurves.map(\.flag).joined(separator: ", ")).")
+        exit(1)
+    }
+    let start = DispatchTime.now().uptimeNanoseconds
+    do {
+        try curve.sign()
+    } catch {
+        FileHandle.standardError.write(Data("\(curve.name) failed: \(error)\n".utf8))
+        exit(1)
+    }
+    print(DispatchTime.now().uptimeNanoseconds - start)
+}
+
+let startupHeadings = ["benchmark", "runs", "process min ms", "process med ms", "first sign min us", "first sign med us"]
+let startupWidths = [32, 5, 14, 14, 17, 17]
+
+private func median(_ samples: [UInt64]) -> UInt64 {
+    samples.sorted()[samples.count / 2]
+}
+
+/// Launches this binary with `--first-signature` `runs` times for each curve. The process column is the wall-clock
+/// time from launch to exit as seen from here; the first signature column is the time the child reports for its
+/// key generation and signature alone.
+func runStartup(runs: Int, options: Options) {
+    let executable = Bundle.main.executableURL ?? URL(fileURLWithPath: CommandLine.arguments[0])
+    printRow(startupHeadings, widths: startupWidths, options: options)
+
+    for curve in startupCurves where options.filter.map({ curve.name.contains($0) }) ?? true {
+        var processTimes = [UInt64]()
+        var signatureTimes = [UInt64]()
+        for _ in 0..<runs {
+            let output = Pipe()
+            let process = Process()
+            process.executableURL = executable
+            process.arguments = ["--first-signature", curve.flag]
+            process.standardOutput = output
+
+            let start = DispatchTime.now().uptimeNanoseconds
+            do {
+                try process.run()
+            } catch {
+                FileHandle.standardError.write(Data("\(curve.name) failed to launch: \(error)\n".utf8))
+                break
+            }
+            let reported = output.fileHandleForReading.readDataToEndOfFile()
+            process.waitUntilExit()
+            let elapsed = DispatchTime.now().uptimeNanoseconds - start
+
+            guard process.terminationStatus == 0,
+                  let signatureTime = UInt64(String(decoding: reported, as: UTF8.self).trimmingCharacters(in: .whitespacesAndNewlines)) else {
+                FileHandle.standardError.write(Data("\(curve.name) failed: the child exited with \(process.terminationStatus)\n".utf8))
+                break
+            }
+            processTimes.append(elapsed)
+            signatureTimes.append(signatureTime)
+        }
+        guard !processTimes.isEmpty else {
+            continue
+        }
+
+        printRow([
+            curve.name,
+            String(processTimes.count),
+            format(Double(processTimes.min()!) / 1_000_000, decimals: 2),
+            format(Double(median(processTimes)) / 1_000_000, decimals: 2),
+            format(Double(signatureTimes.min()!) / 1_000, decimals: 1),
+            format(Double(median(signatureTimes)) / 1_000, decimals: 1),
+        ], widths: startupWidths, options: options)
+    }
+}
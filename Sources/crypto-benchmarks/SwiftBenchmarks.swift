@@ -0,0 +1,610 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import _CryptoExtras
+import Foundation
+
+/// The message sizes used for the symmetric primitives.
+let messageSizes = [16, 256, 1024, 8192, 16384]
+
+/// The input sizes used for the short-input keyed hashes, compared against HMAC.
+let shortInputSizes = [8, 16, 32, 64]
+
+/// The output sizes used for the random byte benchmarks. The largest crosses the bulk generator's 1 MiB rekeying
+/// interval.
+let randomByteCounts = [64 << 10, 1 << 20, 16 << 20]
+
+/// The message signed and verified by the signature benchmarks.
+let signedMessage = Data(repeating: 0x5a, count: 64)
+
+/// The amount of memory the cache pressure benchmarks read before each operation.
+let cacheSweepByteCount = 4 << 20
+
+/// Reads one byte from every cache line of `buffer`.
+@inline(never)
+func sweepCache(_ buffer: [UInt8]) -> UInt8 {
+    buffer.withUnsafeBufferPointer { bytes in
+        var sum: UInt8 = 0
+        for index in stride(from: 0, to: bytes.count, by: 64) {
+            sum &+= bytes[index]
+        }
+        return sum
+    }
+}
+
+func swiftBenchmarks() -> [Benchmark] {
+    var benchmarks = [Benchmark]()
+
+    for size in messageSizes {
+        let message = Data(repeating: 0x2a, count: size)
+
+        benchmarks.append(Benchmark("AES-GCM-256 seal \(size)B", layer: .swift, bytesPerOperation: size) {
+            let key = SymmetricKey(size: .bits256)
+            let nonce = AES.GCM.Nonce()
+            return { iterations in
+                for _ in 0..<iterations {
+                    blackHole(try AES.GCM.seal(message, using: key, nonce: nonce))
+                }
+            }
+        })
+        benchmarks.append(Benchmark("AES-GCM-256 open \(size)B", layer: .swift, bytesPerOperation: size) {
+            let key = SymmetricKey(size: .bits256)
+            let box = try AES.GCM.seal(message, using: key)
+            return { iterations in
+                for _ in 0..<iterations {
+                    blackHole(try AES.GCM.open(box, using: key))
+                }
+            }
+        })
+        benchmarks.append(Benchmark("AES-GCM-256 seal 4 regions \(size)B", layer: .swift, bytesPerOperation: size) {
+            let key = SymmetricKey(size: .bits256)
+            let nonce = AES.GCM.Nonce()
+            // The same message in four separately allocated regions, as a network read might deliver it.
+            let regionByteCount = size / 4
+            let discontiguous = message.withUnsafeBytes { messagePointer in
+                var data = DispatchData.empty
+                for start in stride(from: 0, to: size, by: regionByteCount) {
+                    data.append(DispatchData(bytes: UnsafeRawBufferPointer(rebasing: messagePointer[start..<(start + regionByteCount)])))
+                }
+                return data
+            }
+            return { iterations in
+                for _ in 0..<iterations {
+                    blackHole(try AES.GCM.seal(discontiguous, using: key, nonce: nonce))
+                }
+            }
+        })
+        benchmarks.append(Benchmark("ChaChaPoly seal \(size)B", layer: .swift, bytesPerOperation: size) {
+            let key = SymmetricKey(size: .bits256)
+            let nonce = ChaChaPoly.Nonce()
+            return { iterations in
+                for _ in 0..<iterations {
+                    blackHole(try ChaChaPoly.seal(message, using: key, nonce: nonce))
+                }
+            }
+        })
+        benchmarks.append(Benchmark("ChaChaPoly open \(size)B", layer: .swift, bytesPerOperation: size) {
+            let key = SymmetricKey(size: .bits256)
+            let box = try ChaChaPoly.seal(message, using: key)
+            return { iterations in
+                for _ in 0..<iterations {
+                    blackHole(try ChaChaPoly.open(box, using: key))
+                }
+            }
+        })
+        benchmarks.append(Benchmark("AES-GCM-SIV-256 seal \(size)B", layer: .swift, bytesPerOperation: size) {
+            let key = SymmetricKey(size: .bits256)
+            let nonce = AES.GCM._SIV.Nonce()
+            return { iterations in
+                for _ in 0..<iterations {
+                    blackHole(try AES.GCM._SIV.seal(message, using: key, nonce: nonce))
+                }
+            }
+        })
+        benchmarks.append(Benchmark("AES-GCM-SIV-256 open \(size)B", layer: .swift, bytesPerOperation: size) {
+            let key = SymmetricKey(size: .bits256)
+            let box = try AES.GCM._SIV.seal(message, using: key)
+            return { iterations in
+                for _ in 0..<iterations {
+                    blackHole(try AES.GCM._SIV.open(box, using: key))
+                }
+            }
+        })
+        // Authentication only: GMAC directly, against AES-GCM sealing an empty message over the same data.
+        benchmarks.append(Benchmark("AES-GMAC-256 \(size)B", layer: .swift, bytesPerOperation: size) {
+            let key = try _AESGMAC.PreparedKey(SymmetricKey(size: .bits256))
+            let nonce = AES.GCM.Nonce()
+            return { iterations in
+                for _ in 0..<iterations {
+                    blackHole(_AESGMAC.authenticationCode(for: message, using: key, nonce: nonce))
+                }
+            }
+        })
+        benchmarks.append(Benchmark("AES-GCM-256 empty seal over AAD \(size)B", layer: .swift, bytesPerOperation: size) {
+            let key = SymmetricKey(size: .bits256)
+            let nonce = AES.GCM.Nonce()
+            return { iterations in
+                for _ in 0..<iterations {
+                    blackHole(try AES.GCM.seal(Data(), using: key, nonce: nonce, authenticating: message))
+                }
+            }
+        })
+        benchmarks.append(Benchmark("AES-CCM-128 seal \(size)B", layer: .swift, bytesPerOperation: size) {
+            let key = try AES._CCM.PreparedKey(SymmetricKey(size: .bits128))
+            let nonce = AES._CCM.Nonce()
+            return { iterations in
+                for _ in 0..<iterations {
+                    blackHole(try key.seal(message, nonce: nonce))
+                }
+            }
+        })
+        benchmarks.append(Benchmark("AES-CCM-128 open \(size)B", layer: .swift, bytesPerOperation: size) {
+            let key = try AES._CCM.PreparedKey(SymmetricKey(size: .bits128))
+            let box = try key.seal(message)
+            return { iterations in
+                for _ in 0..<iterations {
+                    blackHole(try key.open(box))
+                }
+            }
+        })
+        benchmarks.append(Benchmark("AES-256-XTS encrypt \(size)B", layer: .swift, bytesPerOperation: size) {
+            let key = try AES._XTS.PreparedKey(SymmetricKey(size: SymmetricKeySize(bitCount: 512)))
+            var buffer = [UInt8](message)
+            return { iterations in
+                for iteration in 0..<iterations {
+                    try buffer.withUnsafeMutableBytes {
+                        try key.encryptSectors(inPlace: $0, sectorByteCount: size, startingAt: UInt64(iteration))
+                    }
+                }
+                blackHole(buffer)
+            }
+        })
+        benchmarks.append(Benchmark("AES-CMAC-128 \(size)B", layer: .swift, bytesPerOperation: size) {
+            let key = try _AESCMAC.PreparedKey(SymmetricKey(size: .bits128))
+            return { iterations in
+                for _ in 0..<iterations {
+                    blackHole(_AESCMAC.authenticationCode(for: message, using: key))
+                }
+            }
+        })
+        benchmarks.append(Benchmark("SHA256 \(size)B", layer: .swift, bytesPerOperation: size) {
+            return { iterations in
+                for _ in 0..<iterations {
+                    blackHole(SHA256.hash(data: message))
+                }
+            }
+        })
+        benchmarks.append(Benchmark("SHA384 \(size)B", layer: .swift, bytesPerOperation: size) {
+            return { iterations in
+                for _ in 0..<iterations {
+                    blackHole(SHA384.hash(data: message))
+                }
+            }
+        })
+        benchmarks.append(Benchmark("SHA512 \(size)B", layer: .swift, bytesPerOperation: size) {
+            return { iterations in
+                for _ in 0..<iterations {
+                    blackHole(SHA512.hash(data: message))
+                }
+            }
+        })
+        benchmarks.append(Benchmark("HMAC-SHA256 \(size)B", layer: .swift, bytesPerOperation: size) {
+            let key = SymmetricKey(size: .bits256)
+            return { iterations in
+                for _ in 0..<iterations {
+                    blackHole(HMAC<SHA256>.authenticationCode(for: message, using: key))
+                }
+            }
+        })
+    }
+
+    for size in shortInputSizes {
+        let input = Data(repeating: 0x2a, count: size)
+
+        benchmarks.append(Benchmark("SipHash-2-4 \(size)B", layer: .swift, bytesPerOperation: size) {
+            let siphash = try _SipHash24(key: SymmetricKey(size: .bits128))
+            return { iterations in
+                for _ in 0..<iterations {
+                    blackHole(siphash.hash(data: input))
+                }
+            }
+        })
+        // One operation is one input, so this compares directly with the unbatched figure.
+        benchmarks.append(Benchmark("SipHash-2-4 batch \(size)B", layer: .swift, bytesPerOperation: size) {
+            let siphash = try _SipHash24(key: SymmetricKey(size: .bits128))
+            let batchSize = 256
+            let storage = [UInt8](repeating: 0x2a, count: size * batchSize)
+            return { iterations in
+                storage.withUnsafeBytes { storage in
+                    let inputs = (0..<batchSize).map {
+                        UnsafeRawBufferPointer(rebasing: storage[($0 * size)..<(($0 + 1) * size)])
+                    }
+                    var remaining = iterations
+                    while remaining >= batchSize {
+                        blackHole(siphash.hashes(batch: inputs))
+                        remaining -= batchSize
+                    }
+                    if remaining > 0 {
+                        blackHole(siphash.hashes(batch: Array(inputs[..<remaining])))
+                    }
+                }
+            }
+        })
+        if !messageSizes.contains(size) {
+            benchmarks.append(Benchmark("HMAC-SHA256 \(size)B", layer: .swift, bytesPerOperation: size) {
+                let key = SymmetricKey(size: .bits256)
+                return { iterations in
+                    for _ in 0..<iterations {
+                        blackHole(HMAC<SHA256>.authenticationCode(for: input, using: key))
+                    }
+                }
+            })
+        }
+    }
+
+    // Per-call overhead for each shape of small input. `DispatchData` has no contiguous storage, so it still walks
+    // `regions` and shows the generic path the others now skip.
+    let shortBytes = [UInt8](repeating: 0x2a, count: 64)
+    let shortInputs: [(String, (SymmetricKey) -> Void)] = [
+        ("[UInt8]", { key in
+            blackHole(SHA256.hash(data: shortBytes))
+            blackHole(HMAC<SHA256>.authenticationCode(for: shortBytes, using: key))
+        }),
+        ("Data", { [shortData = Data(shortBytes)] key in
+            blackHole(SHA256.hash(data: shortData))
+            blackHole(HMAC<SHA256>.authenticationCode(for: shortData, using: key))
+        }),
+        ("DispatchData", { [shortDispatchData = shortBytes.withUnsafeBytes { DispatchData(bytes: $0) }] key in
+            blackHole(SHA256.hash(data: shortDispatchData))
+            blackHole(HMAC<SHA256>.authenticationCode(for: shortDispatchData, using: key))
+        }),
+    ]
+    for (label, operation) in shortInputs {
+        benchmarks.append(Benchmark("SHA256 + HMAC-SHA256 64B \(label)", layer: .swift, bytesPerOperation: 64) {
+            let key = SymmetricKey(size: .bits256)
+            return { iterations in
+                for _ in 0..<iterations {
+                    operation(key)
+                }
+            }
+        })
+    }
+
+    benchmarks.append(Benchmark("HKDF-SHA256 32B", layer: .swift) {
+        let inputKeyMaterial = SymmetricKey(size: .bits256)
+        let salt = Data(repeating: 0x01, count: 32)
+        let info = Data("benchmark".utf8)
+        return { iterations in
+            for _ in 0..<iterations {
+                blackHole(HKDF<SHA256>.deriveKey(inputKeyMaterial: inputKeyMaterial, salt: salt, info: info, outputByteCount: 32))
+            }
+        }
+    })
+
+    benchmarks.append(Benchmark("P256 sign", layer: .swift) {
+        let key = P256.Signing.PrivateKey()
+        return { iterations in
+            for _ in 0..<iterations {
+                blackHole(try key.signature(for: signedMessage))
+            }
+        }
+    })
+    // One operation is one signature, so this compares directly with "P256 sign".
+    benchmarks.append(Benchmark("P256 batch sign", layer: .swift) {
+        let key = P256.Signing.PrivateKey()
+        let batchSize = 64
+        let digests = Array(repeating: SHA256.hash(data: signedMessage), count: batchSize)
+        return { iterations in
+            var remaining = iterations
+            while remaining >= batchSize {
+                blackHole(try key._signatures(for: digests))
+                remaining -= batchSize
+            }
+            if remaining > 0 {
+                blackHole(try key._signatures(for: Array(digests[..<remaining])))
+            }
+        }
+    })
+    benchmarks.append(Benchmark("P256 verify", layer: .swift) {
+        let key = P256.Signing.PrivateKey()
+        let signature = try key.signature(for: signedMessage)
+        return { iterations in
+            for _ in 0..<iterations {
+                blackHole(key.publicKey.isValidSignature(signature, for: signedMessage))
+            }
+        }
+    })
+    benchmarks.append(Benchmark("P256 keygen", layer: .swift) {
+        return { iterations in
+            for _ in 0..<iterations {
+                blackHole(P256.Signing.PrivateKey())
+            }
+        }
+    })
+
+    // These read through more memory than a typical L2 before every operation, evicting the fixed-base table the
+    // way a neighbouring workload would. Subtract "cache sweep" for the latency of the operation itself.
+    benchmarks.append(Benchmark("cache sweep \(cacheSweepByteCount >> 20)MiB", layer: .swift) {
+        let sweep = [UInt8](repeating: 1, count: cacheSweepByteCount)
+        return { iterations in
+            for _ in 0..<iterations {
+                blackHole(sweepCache(sweep))
+            }
+        }
+    })
+    benchmarks.append(Benchmark("P256 keygen under cache pressure", layer: .swift) {
+        let sweep = [UInt8](repeating: 1, count: cacheSweepByteCount)
+        return { iterations in
+            for _ in 0..<iterations {
+                blackHole(sweepCache(sweep))
+                blackHole(P256.Signing.PrivateKey())
+            }
+        }
+    })
+    benchmarks.append(Benchmark("P256 sign under cache pressure", layer: .swift) {
+        let key = P256.Signing.PrivateKey()
+        let sweep = [UInt8](repeating: 1, count: cacheSweepByteCount)
+        return { iterations in
+            for _ in 0..<iterations {
+                blackHole(sweepCache(sweep))
+                blackHole(try key.signature(for: signedMessage))
+            }
+        }
+    })
+    benchmarks.append(Benchmark("P384 sign", layer: .swift) {
+        let key = P384.Signing.PrivateKey()
+        return { iterations in
+            for _ in 0..<iterations {
+                blackHole(try key.signature(for: signedMessage))
+            }
+        }
+    })
+    benchmarks.append(Benchmark("P384 verify", layer: .swift) {
+        let key = P384.Signing.PrivateKey()
+        let signature = try key.signature(for: signedMessage)
+        return { iterations in
+            for _ in 0..<iterations {
+                blackHole(key.publicKey.isValidSignature(signature, for: signedMessage))
+            }
+        }
+    })
+    benchmarks.append(Benchmark("P521 sign", layer: .swift) {
+        let key = P521.Signing.PrivateKey()
+        return { iterations in
+            for _ in 0..<iterations {
+                blackHole(try key.signature(for: signedMessage))
+            }
+        }
+    })
+    benchmarks.append(Benchmark("P521 verify", layer: .swift) {
+        let key = P521.Signing.PrivateKey()
+        let signature = try key.signature(for: signedMessage)
+        return { iterations in
+            for _ in 0..<iterations {
+                blackHole(key.publicKey.isValidSignature(signature, for: signedMessage))
+            }
+        }
+    })
+
+    benchmarks.append(Benchmark("Ed25519 sign", layer: .swift) {
+        let key = Curve25519.Signing.PrivateKey()
+        return { iterations in
+            for _ in 0..<iterations {
+                blackHole(try key.signature(for: signedMessage))
+            }
+        }
+    })
+    benchmarks.append(Benchmark("Ed25519 verify", layer: .swift) {
+        let key = Curve25519.Signing.PrivateKey()
+        let signature = try key.signature(for: signedMessage)
+        return { iterations in
+            for _ in 0..<iterations {
+                blackHole(key.publicKey.isValidSignature(signature, for: signedMessage))
+            }
+        }
+    })
+    benchmarks.append(Benchmark("X25519 agreement", layer: .swift) {
+        let key = Curve25519.KeyAgreement.PrivateKey()
+        let peer = Curve25519.KeyAgreement.PrivateKey().publicKey
+        return { iterations in
+            for _ in 0..<iterations {
+                blackHole(try key.sharedSecretFromKeyAgreement(with: peer))
+            }
+        }
+    })
+    // One operation is one agreement, so this compares directly with "X25519 agreement".
+    benchmarks.append(Benchmark("X25519 batch agreement", layer: .swift) {
+        let key = Curve25519.KeyAgreement.PrivateKey()
+        let batchSize = 64
+        let peers = (0..<batchSize).map { _ in Curve25519.KeyAgreement.PrivateKey().publicKey }
+        return { iterations in
+            var remaining = iterations
+            while remaining >= batchSize {
+                blackHole(key._sharedSecrets(with: peers))
+                remaining -= batchSize
+            }
+            if remaining > 0 {
+                blackHole(key._sharedSecrets(with: Array(peers[..<remaining])))
+            }
+        }
+    })
+    benchmarks.append(Benchmark("P256 raw agreement", layer: .swift) {
+        let scalar = Array(P256.KeyAgreement.PrivateKey().rawRepresentation)
+        let peer = Array(P256.KeyAgreement.PrivateKey().publicKey.x963Representation)
+        var secret = [UInt8](repeating: 0, count: 32)
+        return { iterations in
+            for _ in 0..<iterations {
+                try scalar.withUnsafeBytes { scalar in
+                    try peer.withUnsafeBytes { peer in
+                        try secret.withUnsafeMutableBytes {
+                            try P256.KeyAgreement._sharedSecret(privateKey: scalar, peerPublicKey: peer, into: $0)
+                        }
+                    }
+                }
+            }
+            blackHole(secret)
+        }
+    })
+    // One operation is one agreement, with a different key on each side, so this compares directly with
+    // "P256 raw agreement".
+    benchmarks.append(Benchmark("P256 batch agreement", layer: .swift) {
+        let batchSize = 64
+        let scalars = (0..<batchSize).flatMap { _ in Array(P256.KeyAgreement.PrivateKey().rawRepresentation) }
+        let peers = (0..<batchSize).flatMap { _ in Array(P256.KeyAgreement.PrivateKey().publicKey.x963Representation) }
+        var secrets = [UInt8](repeating: 0, count: batchSize * 32)
+        return { iterations in
+            var remaining = iterations
+            while remaining > 0 {
+                let count = min(remaining, batchSize)
+                try scalars.withUnsafeBytes { scalars in
+                    try peers.withUnsafeBytes { peers in
+                        try secrets.withUnsafeMutableBytes { secrets in
+                            try P256.KeyAgreement._sharedSecrets(
+                                privateKeys: UnsafeRawBufferPointer(rebasing: scalars[..<(count * 32)]),
+                                peerPublicKeys: UnsafeRawBufferPointer(rebasing: peers[..<(count * 65)]),
+                                into: UnsafeMutableRawBufferPointer(rebasing: secrets[..<(count * 32)])
+                            )
+                        }
+                    }
+                }
+                remaining -= count
+            }
+            blackHole(secrets)
+        }
+    })
+
+    for keySize in [2048, 3072, 4096] {
+        benchmarks.append(Benchmark("RSA-\(keySize) PSS sign", layer: .swift) {
+            let key = try _RSA.Signing.PrivateKey(keySize: .init(bitCount: keySize))
+            return { iterations in
+                for _ in 0..<iterations {
+                    blackHole(try key.signature(for: signedMessage, padding: .PSS))
+                }
+            }
+        })
+        benchmarks.append(Benchmark("RSA-\(keySize) PSS verify", layer: .swift) {
+            let key = try _RSA.Signing.PrivateKey(keySize: .init(bitCount: keySize))
+            let signature = try key.signature(for: signedMessage, padding: .PSS)
+            let publicKey = key.publicKey
+            return { iterations in
+                for _ in 0..<iterations {
+                    blackHole(publicKey.isValidSignature(signature, for: signedMessage, padding: .PSS))
+                }
+            }
+        })
+    }
+
+    // A fresh random nonce per seal against a nonce sequence, at a size where drawing the nonce is a large share
+    // of the work.
+    let smallMessage = Data(repeating: 0x2a, count: 16)
+    benchmarks.append(Benchmark("AES-GCM-256 prepared seal random nonce 16B", layer: .swift, bytesPerOperation: 16) {
+        let key = try AES.GCM._PreparedKey(SymmetricKey(size: .bits256))
+        return { iterations in
+            for _ in 0..<iterations {
+                blackHole(try key.seal(smallMessage))
+            }
+        }
+    })
+    benchmarks.append(Benchmark("AES-GCM-256 prepared seal nonce sequence 16B", layer: .swift, bytesPerOperation: 16) {
+        let key = try AES.GCM._PreparedKey(SymmetricKey(size: .bits256))
+        let nonces = _AEADNonceSequence()
+        return { iterations in
+            for _ in 0..<iterations {
+                blackHole(try key.seal(smallMessage, nonces: nonces))
+            }
+        }
+    })
+
+    // Compact sessions that stay hot against ones that miss the cache on every seal and must be expanded again.
+    for (label, sessionCount) in [("hot", 64), ("cold", 4096)] {
+        benchmarks.append(Benchmark("AES-GCM-256 compact pool \(label) seal 16B", layer: .swift, bytesPerOperation: 16) {
+            let pool = AES.GCM._CompactKeyPool(hotCapacity: 1024)
+            let keys = try (0..<sessionCount).map { _ in try pool.key(SymmetricKey(size: .bits256)) }
+            let nonce = AES.GCM.Nonce()
+            return { iterations in
+                for i in 0..<iterations {
+                    blackHole(try keys[i % keys.count].seal(smallMessage, nonce: nonce))
+                }
+            }
+        })
+    }
+
+    // One large object sealed on a single core and across all of them.
+    let largeMessageByteCount = 64 << 20
+    for concurrently in [false, true] {
+        let label = concurrently ? "concurrently" : "serially"
+        benchmarks.append(Benchmark("AES-GCM-256 prepared seal 64MiB \(label)", layer: .swift, bytesPerOperation: largeMessageByteCount) {
+            let key = try AES.GCM._PreparedKey(SymmetricKey(size: .bits256))
+            let nonce = AES.GCM.Nonce()
+            // Sealed in place: the message is the front of the output buffer.
+            var buffer = [UInt8](repeating: 0x2a, count: largeMessageByteCount + 16)
+            return { iterations in
+                for _ in 0..<iterations {
+                    try buffer.withUnsafeMutableBytes { buffer in
+                        let message = UnsafeRawBufferPointer(rebasing: buffer.prefix(largeMessageByteCount))
+                        try key.seal(message, into: buffer, nonce: nonce, authenticating: [UInt8](), concurrently: concurrently)
+                    }
+                }
+            }
+        })
+    }
+
+    // Compared against RAND_bytes and the raw AES-256-CTR keystream by the C benchmarks of the same sizes.
+    for count in randomByteCounts {
+        benchmarks.append(Benchmark("bulk random bytes \(count >> 10)KiB", layer: .swift, bytesPerOperation: count) {
+            var buffer = [UInt8](repeating: 0, count: count)
+            return { iterations in
+                for _ in 0..<iterations {
+                    buffer.withUnsafeMutableBytes { buffer in
+                        _CryptoRandom._fillWithBulkRandomBytes(buffer)
+                    }
+                }
+            }
+        })
+    }
+
+    if #available(macOS 14, iOS 17, watchOS 10, tvOS 17, *) {
+        benchmarks.append(contentsOf: swiftHPKEBenchmarks())
+    }
+
+    return benchmarks
+}
+
+@available(macOS 14, iOS 17, watchOS 10, tvOS 17, *)
+func swiftHPKEBenchmarks() -> [Benchmark] {
+    let ciphersuite = HPKE.Ciphersuite.Curve25519_SHA256_ChachaPoly
+    let info = Data("benchmark".utf8)
+    var benchmarks = [Benchmark]()
+
+    benchmarks.append(Benchmark("HPKE X25519 setup", layer: .swift) {
+        let recipientKey = Curve25519.KeyAgreement.PrivateKey().publicKey
+        return { iterations in
+            for _ in 0..<iterations {
+                blackHole(try HPKE.Sender(recipientKey: recipientKey, ciphersuite: ciphersuite, info: info))
+            }
+        }
+    })
+    for size in messageSizes {
+        let message = Data(repeating: 0x2a, count: size)
+        benchmarks.append(Benchmark("HPKE X25519 seal \(size)B", layer: .swift, bytesPerOperation: size) {
+            var sender = try HPKE.Sender(recipientKey: Curve25519.KeyAgreement.PrivateKey().publicKey, ciphersuite: ciphersuite, info: info)
+            return { iterations in
+                for _ in 0..<iterations {
+                    blackHole(try sender.seal(message))
+                }
+            }
+        })
+    }
+    return benchmarks
+}
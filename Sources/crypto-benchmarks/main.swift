@@ -0,0 +1,313 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Foundation
+
+let help = """
+Usage: crypto-benchmarks [OPTION]...
+Measure the throughput and latency of each primitive, through the Swift API
+and through direct BoringSSL calls.
+
+  -f, --filter TEXT   only run benchmarks whose name contains TEXT
+  -l, --layer LAYER   only run the swift or c benchmarks
+  -t, --time SECONDS  minimum duration of each timed run (default 0.2)
+  -r, --rounds N      timed runs per benchmark, reporting the fastest (default 3)
+      --cpu-ghz GHZ   CPU clock rate, used to report cycles per operation and
+                      per byte
+  -j, --threads N     run each benchmark on 1, 2, 4, ... up to N threads at once
+                      and report scaling efficiency; a list such as 1,8,64
+                      picks the thread counts exactly. Adds benchmarks in
+                      which all threads share one key.
+      --flush-caches  sweep the cache before every operation of the benchmarks
+                      that rotate through many keys
+      --startup N     launch a fresh process N times per curve and report the
+                      time to its first signature, including process startup
+      --first-signature CURVE
+                      sign once with a new p256, p384 or p521 key and print
+                      the nanoseconds it took; used by --startup
+      --allocations N run each benchmark N times and report the heap
+                      allocations per operation, in total and made by
+                      BoringSSL
+      --allocation-baseline FILE
+                      with --allocations, fail if any benchmark allocates more
+                      per operation than FILE, the --csv output of an earlier
+                      allocation run
+      --csv           print comma-separated values instead of a table
+      --list          list the benchmarks without running them
+"""
+
+struct Options {
+    var filter: String?
+    var layer: Benchmark.Layer?
+    var duration = 0.2
+    var rounds = 3
+    var cpuGHz: Double?
+    var threadCounts: [Int]?
+    var flushCaches = false
+    var startupRuns: Int?
+    var allocationIterations: Int?
+    var allocationBaseline: String?
+    var csv = false
+    var list = false
+}
+
+struct Result {
+    var benchmark: Benchmark
+    var measurement: Measurement
+}
+
+func format(_ value: Double?, decimals: Int) -> String {
+    guard let value = value else {
+        return "-"
+    }
+    return String(format: "%.\(decimals)f", value)
+}
+
+func columns(for result: Result, options: Options) -> [String] {
+    let bytes = result.benchmark.bytesPerOperation.map(Double.init)
+    let nanoseconds = result.measurement.nanosecondsPerOperation
+    let cyclesPerOperation = options.cpuGHz.map { nanoseconds * $0 }
+    return [
+        result.benchmark.name,
+        result.benchmark.layer.rawValue,
+        format(result.measurement.operationsPerSecond, decimals: 0),
+        format(nanoseconds, decimals: 1),
+        format(bytes.map { $0 / nanoseconds * 1_000 }, decimals: 1),
+        format(cyclesPerOperation, decimals: 0),
+        format(bytes.flatMap { bytes in cyclesPerOperation.map { $0 / bytes } }, decimals: 2),
+    ]
+}
+
+let tableHeadings = ["benchmark", "layer", "ops/s", "ns/op", "MB/s", "cycles/op", "cycles/B"]
+let tableWidths = [32, 6, 12, 12, 10, 10, 9]
+
+func printRow(_ row: [String], widths: [Int] = tableWidths, options: Options) {
+    if options.csv {
+        print(row.joined(separator: ","))
+        return
+    }
+    let padded = zip(row, widths).enumerated().map { index, column -> String in
+        let (text, width) = column
+        let padding = String(repeating: " ", count: max(width - text.count, 0))
+        // Names are left-aligned and numbers right-aligned.
+        return index == 0 ? text + padding : padding + text
+    }
+    print(padded.joined(separator: " "))
+}
+
+/// Compares each Swift benchmark against the C benchmark of the same name.
+func printOverheads(_ results: [Result]) {
+    let cResults = Dictionary(
+        results.filter { $0.benchmark.layer == .c }.map { ($0.benchmark.name, $0.measurement) },
+        uniquingKeysWith: { first, _ in first }
+    )
+    let pairs = results.filter { $0.benchmark.layer == .swift }.compactMap { result in
+        cResults[result.benchmark.name].map { (result.benchmark.name, result.measurement, $0) }
+    }
+    guard !pairs.isEmpty else {
+        return
+    }
+
+    print("\nSwift API overhead relative to direct BoringSSL calls:")
+    for (name, swift, c) in pairs {
+        let extra = swift.nanosecondsPerOperation - c.nanosecondsPerOperation
+        print("\(name.padding(toLength: 32, withPad: " ", startingAt: 0)) \(format(swift.nanosecondsPerOperation / c.nanosecondsPerOperation, decimals: 2))x  (\(format(extra, decimals: 1)) ns/op)")
+    }
+}
+
+let scalingHeadings = ["benchmark", "layer", "key", "threads", "ops/s", "ops/s/thread", "efficiency"]
+let scalingWidths = [32, 6, 10, 7, 12, 12, 10]
+
+func runScaling(_ benchmarks: [Benchmark], threadCounts: [Int], options: Options) {
+    printRow(scalingHeadings, widths: scalingWidths, options: options)
+    for benchmark in benchmarks {
+        do {
+            let results = try measureScaling(benchmark, threadCounts: threadCounts, duration: options.duration, rounds: options.rounds)
+            // Efficiency compares each thread's share of the throughput to the rate at the smallest thread count.
+            let baseline = results[0].operationsPerSecond / Double(results[0].threads)
+            for result in results {
+                let perThread = result.operationsPerSecond / Double(result.threads)
+                printRow([
+                    benchmark.name,
+                    benchmark.layer.rawValue,
+                    benchmark.sharesKey ? "shared" : "per-thread",
+                    String(result.threads),
+                    format(result.operationsPerSecond, decimals: 0),
+                    format(perThread, decimals: 0),
+                    format(perThread / baseline * 100, decimals: 1) + "%",
+                ], widths: scalingWidths, options: options)
+            }
+        } catch {
+            FileHandle.standardError.write(Data("\(benchmark.name) (\(benchmark.layer.rawValue)) failed: \(error)\n".utf8))
+        }
+    }
+}
+
+func main() {
+    var arguments = CommandLine.arguments.dropFirst()
+    var options = Options()
+
+    while let first = arguments.popFirst() {
+        switch first {
+        case "-f", "--filter":
+            guard let filter = arguments.popFirst() else {
+                print("--filter needs some text to match.")
+                return
+            }
+            options.filter = filter
+
+        case "-l", "--layer":
+            guard let flag = arguments.popFirst(), let layer = Benchmark.Layer(rawValue: flag) else {
+                print("The layer must be swift or c.")
+                return
+            }
+            options.layer = layer
+
+        case "-t", "--time":
+            guard let flag = arguments.popFirst(), let duration = Double(flag), duration > 0 else {
+                print("The duration must be a positive number of seconds.")
+                return
+            }
+            options.duration = duration
+
+        case "-r", "--rounds":
+            guard let flag = arguments.popFirst(), let rounds = Int(flag), rounds > 0 else {
+                print("The number of rounds must be a positive integer.")
+                return
+            }
+            options.rounds = rounds
+
+        case "--cpu-ghz":
+            guard let flag = arguments.popFirst(), let ghz = Double(flag), ghz > 0 else {
+                print("The clock rate must be a positive number of GHz.")
+                return
+            }
+            options.cpuGHz = ghz
+
+        case "-j", "--threads":
+            guard let flag = arguments.popFirst(), let threadCounts = parseThreadCounts(flag) else {
+                print("The thread counts must be a positive integer or a comma-separated list of them.")
+                return
+            }
+            options.threadCounts = threadCounts
+
+        case "--flush-caches":
+            options.flushCaches = true
+
+        case "--startup":
+            guard let flag = arguments.popFirst(), let runs = Int(flag), runs > 0 else {
+                print("The number of startup runs must be a positive integer.")
+                return
+            }
+            options.startupRuns = runs
+
+        case "--first-signature":
+            guard let flag = arguments.popFirst() else {
+                print("--first-signature needs a curve.")
+                return
+            }
+            runFirstSignature(flag: flag)
+            return
+
+        case "--allocations":
+            guard let flag = arguments.popFirst(), let iterations = Int(flag), iterations > 0 else {
+                print("The number of allocation iterations must be a positive integer.")
+                return
+            }
+            options.allocationIterations = iterations
+
+        case "--allocation-baseline":
+            guard let path = arguments.popFirst() else {
+                print("--allocation-baseline needs a file.")
+                return
+            }
+            options.allocationBaseline = path
+
+        case "--csv":
+            options.csv = true
+
+        case "--list":
+            options.list = true
+
+        default:
+            print(help)
+            return
+        }
+    }
+
+    if let runs = options.startupRuns {
+        runStartup(runs: runs, options: options)
+        return
+    }
+
+    let flush = CacheFlush(enabled: options.flushCaches)
+    var candidates = swiftBenchmarks() + cBenchmarks()
+    if options.threadCounts != nil {
+        candidates += sharedKeyBenchmarks()
+    } else {
+        // Every thread of a scaling run would build its own key set.
+        candidates += keyAgileBenchmarks(flush: flush)
+    }
+    let benchmarks = candidates.filter { benchmark in
+        (options.filter.map { benchmark.name.contains($0) } ?? true) &&
+            (options.layer.map { benchmark.layer == $0 } ?? true)
+    }
+
+    if options.list {
+        for benchmark in benchmarks {
+            print("\(benchmark.name) (\(benchmark.layer.rawValue)\(benchmark.sharesKey ? ", shared key" : ""))")
+        }
+        return
+    }
+
+    if let iterations = options.allocationIterations {
+        var baseline: AllocationBaseline?
+        if let path = options.allocationBaseline {
+            do {
+                baseline = try AllocationBaseline(contentsOf: path)
+            } catch {
+                print("Couldn't read the allocation baseline: \(error)")
+                exit(1)
+            }
+        }
+        if !runAllocations(benchmarks, iterations: iterations, baseline: baseline, options: options) {
+            exit(1)
+        }
+        return
+    }
+
+    if let threadCounts = options.threadCounts {
+        runScaling(benchmarks, threadCounts: threadCounts, options: options)
+        return
+    }
+
+    printRow(tableHeadings, options: options)
+    var results = [Result]()
+    for benchmark in benchmarks {
+        do {
+            let body = try benchmark.makeBody()
+            let result = Result(benchmark: benchmark, measurement: try measure(body, duration: options.duration, rounds: options.rounds))
+            printRow(columns(for: result, options: options), options: options)
+            results.append(result)
+        } catch {
+            FileHandle.standardError.write(Data("\(benchmark.name) (\(benchmark.layer.rawValue)) failed: \(error)\n".utf8))
+        }
+    }
+
+    if !options.csv {
+        printOverheads(results)
+        printKeyAgility(results, flush: flush, options: options)
+    }
+}
+
+main()
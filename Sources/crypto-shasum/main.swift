@@ -13,19 +13,35 @@
 //===----------------------------------------------------------------------===//
 import Foundation
 import Crypto
+import _CryptoExtras
 
 let help = """
 Usage: crypto-shasum [OPTION]... [FILE]...
 Print SHA checksums.
 With no FILE, or when FILE is -, read standard input.
 
-  -a, --algorithm   256 (default), 384, 512
+  -a, --algorithm   256 (default), 384, 512, 512224, 512256, or several
+                    separated by commas, such as 256,512, to compute each
+                    digest from one read of every file
+  -c, --check       read checksums from the FILEs and check them
+  -j, --jobs        number of files to hash concurrently (default 1, or one
+                    per processor with --check)
+  -m, --mmap        memory-map files instead of reading them in chunks
+      --throughput  report the total bytes hashed and throughput on stderr
+      --tree        print a Merkle tree hash over 1 MiB leaves, hashing the
+                    leaves of each file concurrently
+
+The following options are only useful when checking checksums:
+      --fail-fast   stop at the first file that fails to check
+      --quiet       don't print OK for each successfully checked file
 """
 
 enum SupportedHashFunction {
     case sha256
     case sha384
     case sha512
+    case sha512_224
+    case sha512_256
 
     init?(commandLineFlag flag: String) {
         switch flag {
@@ -35,71 +51,461 @@ enum SupportedHashFunction {
             self = .sha384
         case "512":
             self = .sha512
+        case "512224":
+            self = .sha512_224
+        case "512256":
+            self = .sha512_256
         default:
             return nil
         }
     }
 
-    func hashLoop(from input: FileHandle) -> Data {
+    /// The name `shasum --tag` gives the algorithm.
+    var tag: String {
         switch self {
         case .sha256:
-            return Data(Self.hashLoop(from: input, with: SHA256.self))
+            return "SHA256"
         case .sha384:
-            return Data(Self.hashLoop(from: input, with: SHA384.self))
+            return "SHA384"
         case .sha512:
-            return Data(Self.hashLoop(from: input, with: SHA512.self))
+            return "SHA512"
+        case .sha512_224:
+            return "SHA512/224"
+        case .sha512_256:
+            return "SHA512/256"
+        }
+    }
+
+    func makeHasher() -> RunningHash {
+        switch self {
+        case .sha256:
+            return RunningHash(SHA256.self)
+        case .sha384:
+            return RunningHash(SHA384.self)
+        case .sha512:
+            return RunningHash(SHA512.self)
+        case .sha512_224:
+            return RunningHash(_SHA512_224.self)
+        case .sha512_256:
+            return RunningHash(_SHA512_256.self)
+        }
+    }
+
+    func hash(mappedData data: Data) -> Data {
+        switch self {
+        case .sha256:
+            return Data(SHA256.hash(data: data))
+        case .sha384:
+            return Data(SHA384.hash(data: data))
+        case .sha512:
+            return Data(SHA512.hash(data: data))
+        case .sha512_224:
+            return Data(_SHA512_224.hash(data: data))
+        case .sha512_256:
+            return Data(_SHA512_256.hash(data: data))
+        }
+    }
+
+    func treeHash(_ data: Data) -> Data {
+        switch self {
+        case .sha256:
+            return Data(_TreeHash<SHA256>(hashing: data).root)
+        case .sha384:
+            return Data(_TreeHash<SHA384>(hashing: data).root)
+        case .sha512:
+            return Data(_TreeHash<SHA512>(hashing: data).root)
+        case .sha512_224:
+            return Data(_TreeHash<_SHA512_224>(hashing: data).root)
+        case .sha512_256:
+            return Data(_TreeHash<_SHA512_256>(hashing: data).root)
+        }
+    }
+
+    var digestByteCount: Int {
+        switch self {
+        case .sha256:
+            return SHA256.byteCount
+        case .sha384:
+            return SHA384.byteCount
+        case .sha512:
+            return SHA512.byteCount
+        case .sha512_224:
+            return _SHA512_224Digest.byteCount
+        case .sha512_256:
+            return _SHA512_256Digest.byteCount
         }
     }
 
     private static let readSize = 8192
 
-    private static func hashLoop<HF: HashFunction>(from input: FileHandle, with hasher: HF.Type) -> HF.Digest {
-        var hasher = HF()
+    /// Several digests read larger chunks, each of which is worth handing to a core per digest.
+    private static let multipleDigestReadSize = 1 << 20
+
+    static func hashLoop(from input: FileHandle, with algorithms: [SupportedHashFunction]) -> (digests: [Data], byteCount: Int) {
+        let hashers = algorithms.map { $0.makeHasher() }
+        let readSize = hashers.count > 1 ? Self.multipleDigestReadSize : Self.readSize
+        let concurrent = hashers.count > 1 && ProcessInfo.processInfo.activeProcessorCount > 1
+        var byteCount = 0
 
-        while true {
-            let data = input.readData(ofLength: Self.readSize)
-            if data.count == 0 {
-                break
+        var data = input.readData(ofLength: readSize)
+        while data.count > 0 {
+            byteCount += data.count
+            let chunk = data
+            if concurrent && chunk.count == readSize {
+                // A full chunk means a large input: hash it on a core per digest while the next one is read.
+                let group = DispatchGroup()
+                for hasher in hashers {
+                    DispatchQueue.global().async(group: group) {
+                        hasher.update(chunk)
+                    }
+                }
+                data = input.readData(ofLength: readSize)
+                group.wait()
+            } else {
+                for hasher in hashers {
+                    hasher.update(chunk)
+                }
+                data = input.readData(ofLength: readSize)
             }
+        }
 
-            hasher.update(data: data)
+        return (hashers.map { $0.finalize() }, byteCount)
+    }
+
+    /// Computes `body` for each algorithm, on a core each when there are several and the input is large.
+    static func each(
+        of algorithms: [SupportedHashFunction], byteCount: Int, _ body: (SupportedHashFunction) -> Data
+    ) -> [Data] {
+        guard algorithms.count > 1, byteCount >= Self.multipleDigestReadSize else {
+            return algorithms.map(body)
+        }
+        var digests = [Data](repeating: Data(), count: algorithms.count)
+        let lock = NSLock()
+        DispatchQueue.concurrentPerform(iterations: algorithms.count) { index in
+            let digest = body(algorithms[index])
+            lock.lock()
+            digests[index] = digest
+            lock.unlock()
         }
+        return digests
+    }
+}
 
-        return hasher.finalize()
+/// A hash in progress with its type erased, so that one read of the input can feed several.
+///
+/// Each hasher is only ever updated by one thread at a time, and the updates are ordered by the caller.
+struct RunningHash {
+    let update: (Data) -> Void
+    let finalize: () -> Data
+
+    init<HF: HashFunction>(_: HF.Type) {
+        var hasher = HF()
+        self.update = { hasher.update(data: $0) }
+        self.finalize = { Data(hasher.finalize()) }
     }
 }
 
 
 extension String {
+    private static let hexDigits = Array("0123456789abcdef".utf8)
+
     init(hexEncoding data: Data) {
-        self = data.map { byte in
-            let s = String(byte, radix: 16)
-            switch s.count {
-            case 0:
-                return "00"
-            case 1:
-                return "0" + s
-            case 2:
-                return s
+        // Digests are short, but there can be millions of them: encode into one buffer, with no per-byte strings.
+        let hexChars = [UInt8](unsafeUninitializedCapacity: data.count * 2) { hexChars, initializedCount in
+            for (index, byte) in data.enumerated() {
+                hexChars[index * 2] = Self.hexDigits[Int(byte >> 4)]
+                hexChars[index * 2 + 1] = Self.hexDigits[Int(byte & 0xF)]
+            }
+            initializedCount = data.count * 2
+        }
+        self = String(decoding: hexChars, as: UTF8.self)
+    }
+}
+
+extension Data {
+    /// Decodes a string of hex digits, in either case, or returns `nil` if it isn't one.
+    init?(hexEncoding string: Substring) {
+        let characters = Array(string.utf8)
+        guard characters.count.isMultiple(of: 2) else {
+            return nil
+        }
+        func nibble(_ character: UInt8) -> UInt8? {
+            switch character {
+            case UInt8(ascii: "0")...UInt8(ascii: "9"):
+                return character - UInt8(ascii: "0")
+            case UInt8(ascii: "a")...UInt8(ascii: "f"):
+                return character - UInt8(ascii: "a") + 10
+            case UInt8(ascii: "A")...UInt8(ascii: "F"):
+                return character - UInt8(ascii: "A") + 10
             default:
-                fatalError("Weirdly hex encoded byte")
+                return nil
+            }
+        }
+        var bytes = [UInt8]()
+        bytes.reserveCapacity(characters.count / 2)
+        for index in stride(from: 0, to: characters.count, by: 2) {
+            guard let high = nibble(characters[index]), let low = nibble(characters[index + 1]) else {
+                return nil
+            }
+            bytes.append(high << 4 | low)
+        }
+        self.init(bytes)
+    }
+}
+
+
+struct Input {
+    var name: String
+    var handle: FileHandle
+
+    /// The path to the file, if this input is a regular file that can be memory-mapped.
+    var path: String?
+
+    static let standardInput = Input(name: "-", handle: FileHandle.standardInput, path: nil)
+}
+
+struct Options {
+    var algorithms = [SupportedHashFunction.sha256]  // Default to sha256
+    var jobs: Int? = nil
+    var memoryMap = false
+    var reportThroughput = false
+    var treeHash = false
+    var check = false
+    var failFast = false
+    var quiet = false
+}
+
+/// Returns one digest per algorithm in `options`, in the same order.
+func hash(_ input: Input, options: Options) -> (digests: [Data], byteCount: Int) {
+    if options.treeHash {
+        // The tree hash needs the whole input up front, so map it if we can and otherwise read it all in.
+        let data = input.path.flatMap { try? Data(contentsOf: URL(fileURLWithPath: $0), options: .alwaysMapped) }
+            ?? input.handle.readDataToEndOfFile()
+        return (SupportedHashFunction.each(of: options.algorithms, byteCount: data.count) { $0.treeHash(data) }, data.count)
+    }
+
+    if options.memoryMap, let path = input.path,
+       let data = try? Data(contentsOf: URL(fileURLWithPath: path), options: .alwaysMapped) {
+        return (SupportedHashFunction.each(of: options.algorithms, byteCount: data.count) { $0.hash(mappedData: data) }, data.count)
+    }
+
+    // Either we weren't asked to map, or this input can't be mapped (e.g. a pipe). Fall back to reading.
+    return SupportedHashFunction.hashLoop(from: input.handle, with: options.algorithms)
+}
+
+/// Prints in the format of `sha256sum` for one algorithm, and of `shasum --tag` for several, which names each.
+func printDigests(_ digests: [Data], of name: String, options: Options) {
+    if options.algorithms.count == 1 {
+        print("\(String(hexEncoding: digests[0]))  \(name)")
+        return
+    }
+    for (algorithm, digest) in zip(options.algorithms, digests) {
+        print("\(algorithm.tag) (\(name)) = \(String(hexEncoding: digest))")
+    }
+}
+
+func processInputs(_ inputs: [Input], options: Options) {
+    var results = [(digests: [Data], byteCount: Int)?](repeating: nil, count: inputs.count)
+    let start = DispatchTime.now()
+
+    if (options.jobs ?? 1) <= 1 || inputs.count <= 1 {
+        for (index, input) in inputs.enumerated() {
+            results[index] = hash(input, options: options)
+            // Print as we go, so that a long-running sequential hash still produces output promptly.
+            printDigests(results[index]!.digests, of: input.name, options: options)
+        }
+    } else {
+        // Each worker repeatedly claims the next unhashed input, so a few large files don't hold up the rest.
+        let lock = NSLock()
+        var nextIndex = 0
+
+        DispatchQueue.concurrentPerform(iterations: min(options.jobs ?? 1, inputs.count)) { _ in
+            while true {
+                lock.lock()
+                let index = nextIndex
+                nextIndex += 1
+                lock.unlock()
+
+                guard index < inputs.count else {
+                    return
+                }
+
+                let result = hash(inputs[index], options: options)
+                lock.lock()
+                results[index] = result
+                lock.unlock()
             }
-        }.joined()
+        }
+
+        // Report in the order the files were given, regardless of the order they finished in.
+        for (input, result) in zip(inputs, results) {
+            printDigests(result!.digests, of: input.name, options: options)
+        }
+    }
+
+    if options.reportThroughput {
+        reportThroughput(byteCount: results.reduce(0) { $0 + ($1?.byteCount ?? 0) }, since: start)
     }
 }
 
+func reportThroughput(byteCount: Int, since start: DispatchTime) {
+    let elapsedNanoseconds = DispatchTime.now().uptimeNanoseconds - start.uptimeNanoseconds
+    let seconds = Double(elapsedNanoseconds) / 1_000_000_000
+    let megabytesPerSecond = seconds > 0 ? Double(byteCount) / 1_000_000 / seconds : 0
+    let report = "\(byteCount) bytes in \(String(format: "%.3f", seconds))s (\(String(format: "%.1f", megabytesPerSecond)) MB/s)\n"
+    FileHandle.standardError.write(Data(report.utf8))
+}
 
-func processInputs(_ handles: [String: FileHandle], algorithm: SupportedHashFunction) {
-    for (name, fh) in handles {
-        let result = algorithm.hashLoop(from: fh)
-        print("\(String(hexEncoding: result))  \(name)")
+/// One line of a checksum manifest, in the `<hex digest>  <file name>` format that `sha256sum` writes. A `*` in
+/// place of the second space marks binary mode, which makes no difference here.
+struct ManifestEntry {
+    var expectedDigest: Data
+    var path: String
+
+    init?(line: Substring, algorithm: SupportedHashFunction) {
+        let hexCount = algorithm.digestByteCount * 2
+        let characters = line.utf8
+        guard characters.count > hexCount + 2,
+              let separator = characters.index(characters.startIndex, offsetBy: hexCount, limitedBy: characters.endIndex),
+              characters[separator] == UInt8(ascii: " "),
+              [UInt8(ascii: " "), UInt8(ascii: "*")].contains(characters[characters.index(after: separator)]),
+              let digest = Data(hexEncoding: line[..<separator]) else {
+            return nil
+        }
+        self.expectedDigest = digest
+        self.path = String(line[characters.index(separator, offsetBy: 2)...])
     }
 }
 
+enum CheckResult {
+    case ok
+    case mismatch
+    case unreadable
+}
+
+/// Checks every file listed in the manifests, printing one result per file in manifest order.
+///
+/// Files are hashed largest first, so that a few large files at the end of a manifest don't leave the other workers
+/// idle while they finish, and results are printed as soon as every earlier file in the manifest has been reported.
+///
+/// - Returns: Whether every file was checked successfully.
+func checkManifests(_ manifests: [Input], options: Options) -> Bool {
+    var entries = [ManifestEntry]()
+    var malformedLineCount = 0
+    for manifest in manifests {
+        let contents = String(decoding: manifest.handle.readDataToEndOfFile(), as: UTF8.self)
+        for line in contents.split(whereSeparator: \.isNewline) {
+            if let entry = ManifestEntry(line: line, algorithm: options.algorithms[0]) {
+                entries.append(entry)
+            } else {
+                malformedLineCount += 1
+            }
+        }
+    }
+    if malformedLineCount > 0 {
+        FileHandle.standardError.write(Data("WARNING: \(malformedLineCount) line(s) improperly formatted\n".utf8))
+    }
+
+    let start = DispatchTime.now()
+    let sizes = entries.map { entry in
+        ((try? FileManager.default.attributesOfItem(atPath: entry.path))?[.size] as? NSNumber)?.intValue ?? 0
+    }
+    let schedule = entries.indices.sorted { sizes[$0] > sizes[$1] }
+
+    // Protected by `condition`.
+    var results = [CheckResult?](repeating: nil, count: entries.count)
+    var nextScheduled = 0
+    var stopped = false
+    var hashedByteCount = 0
+    let condition = NSCondition()
+
+    let jobs = min(options.jobs ?? ProcessInfo.processInfo.activeProcessorCount, max(entries.count, 1))
+    let workers = DispatchGroup()
+    DispatchQueue.global().async(group: workers) {
+        DispatchQueue.concurrentPerform(iterations: jobs) { _ in
+            while true {
+                condition.lock()
+                guard !stopped, nextScheduled < schedule.count else {
+                    condition.unlock()
+                    return
+                }
+                let index = schedule[nextScheduled]
+                nextScheduled += 1
+                condition.unlock()
+
+                let result: CheckResult
+                var byteCount = 0
+                if let handle = FileHandle(forReadingAtPath: entries[index].path) {
+                    let input = Input(name: entries[index].path, handle: handle, path: entries[index].path)
+                    let digests: [Data]
+                    (digests, byteCount) = hash(input, options: options)
+                    handle.closeFile()
+                    result = digests[0] == entries[index].expectedDigest ? .ok : .mismatch
+                } else {
+                    result = .unreadable
+                }
+
+                condition.lock()
+                results[index] = result
+                hashedByteCount += byteCount
+                condition.broadcast()
+                condition.unlock()
+            }
+        }
+    }
+
+    var mismatchCount = 0
+    var unreadableCount = 0
+    for index in entries.indices {
+        condition.lock()
+        while results[index] == nil {
+            condition.wait()
+        }
+        let result = results[index]!
+        condition.unlock()
+
+        let path = entries[index].path
+        switch result {
+        case .ok:
+            if !options.quiet {
+                print("\(path): OK")
+            }
+        case .mismatch:
+            mismatchCount += 1
+            print("\(path): FAILED")
+        case .unreadable:
+            unreadableCount += 1
+            print("\(path): FAILED open or read")
+        }
+
+        if result != .ok && options.failFast {
+            condition.lock()
+            stopped = true
+            condition.unlock()
+            break
+        }
+    }
+    workers.wait()
+
+    if unreadableCount > 0 {
+        FileHandle.standardError.write(Data("WARNING: \(unreadableCount) listed file(s) could not be read\n".utf8))
+    }
+    if mismatchCount > 0 {
+        FileHandle.standardError.write(Data("WARNING: \(mismatchCount) computed checksum(s) did NOT match\n".utf8))
+    }
+    if options.reportThroughput {
+        condition.lock()
+        let byteCount = hashedByteCount
+        condition.unlock()
+        reportThroughput(byteCount: byteCount, since: start)
+    }
+    return mismatchCount == 0 && unreadableCount == 0 && !entries.isEmpty
+}
+
 func main() {
     var arguments = CommandLine.arguments.dropFirst()
-    var algorithm = SupportedHashFunction.sha256  // Default to sha256
-    var files = [String: FileHandle]()
+    var options = Options()
+    var inputs = [Input]()
 
     // First get the flags.
     flagsLoop: while let first = arguments.first, first.starts(with: "-") {
@@ -107,18 +513,53 @@ func main() {
 
         switch first {
         case "-a", "--algorithm":
-            guard let flag = arguments.popFirst(), let newAlgorithm = SupportedHashFunction(commandLineFlag: flag) else {
+            guard let flag = arguments.popFirst() else {
                 print("Unknown algorithm description.")
                 return
             }
-            algorithm = newAlgorithm
+            var algorithms = [SupportedHashFunction]()
+            for description in flag.split(separator: ",", omittingEmptySubsequences: false) {
+                guard let algorithm = SupportedHashFunction(commandLineFlag: String(description)) else {
+                    print("Unknown algorithm description.")
+                    return
+                }
+                if !algorithms.contains(algorithm) {
+                    algorithms.append(algorithm)
+                }
+            }
+            options.algorithms = algorithms
+
+        case "-c", "--check":
+            options.check = true
+
+        case "--fail-fast":
+            options.failFast = true
+
+        case "--quiet":
+            options.quiet = true
+
+        case "-j", "--jobs":
+            guard let flag = arguments.popFirst(), let jobs = Int(flag), jobs > 0 else {
+                print("The number of jobs must be a positive integer.")
+                return
+            }
+            options.jobs = jobs
+
+        case "-m", "--mmap":
+            options.memoryMap = true
+
+        case "--throughput":
+            options.reportThroughput = true
+
+        case "--tree":
+            options.treeHash = true
 
         case "--":
             break flagsLoop  // Everything left is files.
 
         case "-":
             // Whoops, this is a file. We need to read from stdin. Ignore any further flags, the rest of the arguments are files.
-            files["-"] = FileHandle.standardInput
+            inputs.append(.standardInput)
             break flagsLoop
 
         default:
@@ -129,21 +570,38 @@ func main() {
 
     // Now the files.
     while let first = arguments.popFirst() {
+        if first == "-" {
+            inputs.append(.standardInput)
+            continue
+        }
+
         // We assume this is a path.
         guard let fh = FileHandle(forReadingAtPath: first) else {
             print("Unable to open \(first)")
             return
         }
 
-        files[first] = fh
+        inputs.append(Input(name: first, handle: fh, path: first))
     }
 
-    if files.count == 0 {
+    if inputs.count == 0 {
         // No flags. We assume that means stdin.
-        files["-"] = FileHandle.standardInput
+        inputs.append(.standardInput)
     }
 
-    processInputs(files, algorithm: algorithm)
+    if options.check {
+        guard options.algorithms.count == 1 else {
+            print("Checking takes a single algorithm.")
+            return
+        }
+        // Checking always takes the memory-mapped path, which falls back to reading for files that can't be mapped.
+        options.memoryMap = true
+        if !checkManifests(inputs, options: options) {
+            exit(1)
+        }
+    } else {
+        processInputs(inputs, options: options)
+    }
 }
 
 
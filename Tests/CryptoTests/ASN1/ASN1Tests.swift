@@ -359,6 +359,68 @@ class ASN1Tests: XCTestCase {
         }
     }
 
+    func testRejectsSingleSubidentifierOIDs() throws {
+        // 06 01 2A is the OID 1.2, which has only a single subidentifier.
+        let parsed = try ASN1.parse([0x06, 0x01, 0x2A])
+        XCTAssertThrowsError(try ASN1.ASN1ObjectIdentifier(asn1Encoded: parsed)) { error in
+            XCTAssertEqual(error as? CryptoKitASN1Error, .invalidObjectIdentifier)
+        }
+    }
+
+    func testInternedOIDsRoundTripAndCompareEqual() throws {
+        // 1.2.840.10045.3.1.7 (secp256r1) is interned; 1.3.132.0.10 (secp256k1) is not.
+        let interned: [UInt8] = [0x06, 0x08, 0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x03, 0x01, 0x07]
+        let notInterned: [UInt8] = [0x06, 0x05, 0x2B, 0x81, 0x04, 0x00, 0x0A]
+
+        for (encoded, expected) in [(interned, ASN1.ASN1ObjectIdentifier.NamedCurves.secp256r1), (notInterned, [1, 3, 132, 0, 10])] {
+            let oid = try ASN1.ASN1ObjectIdentifier(asn1Encoded: try ASN1.parse(encoded))
+            XCTAssertEqual(oid, expected)
+            XCTAssertEqual(oid.hashValue, expected.hashValue)
+
+            var serializer = ASN1.Serializer()
+            try serializer.serialize(oid)
+            XCTAssertEqual(serializer.serializedBytes, encoded)
+        }
+
+        let parsedInterned = try ASN1.ASN1ObjectIdentifier(asn1Encoded: try ASN1.parse(interned))
+        XCTAssertNotEqual(parsedInterned, .NamedCurves.secp384r1)
+        XCTAssertNotEqual(parsedInterned, [1, 3, 132, 0, 10])
+    }
+
+    func testNonMinimalEncodingOfInternedOIDIsStillEqual() throws {
+        // secp384r1, 1.3.132.0.34, with a redundant leading 0x80 on the "132" subidentifier.
+        let parsed = try ASN1.parse([0x06, 0x06, 0x2B, 0x80, 0x81, 0x04, 0x00, 0x22])
+        let oid = try ASN1.ASN1ObjectIdentifier(asn1Encoded: parsed)
+        XCTAssertEqual(oid, .NamedCurves.secp384r1)
+        XCTAssertEqual(Set([oid, .NamedCurves.secp384r1]).count, 1)
+    }
+
+    func testParsedNodesReferenceTheirEncodedBytes() throws {
+        let encodedSPKI = "MFkwEwYHKoZIzj0CAQYIKoZIzj0DAQcDQgAE2adMrdG7aUfZH57aeKFFM01dPnkxC18ScRb4Z6poMBgJtYlVtd9ly63URv57ZW0Ncs1LiZB7WATb3svu+1c7HQ=="
+        let decodedSPKI = Array(Data(base64Encoded: encodedSPKI)!)
+
+        let result = try ASN1.parse(decodedSPKI)
+        XCTAssertEqual(result.encodedBytes, decodedSPKI[...])
+
+        guard case .constructed(let children) = result.content else {
+            XCTFail("SPKI should be constructed")
+            return
+        }
+        var iterator = children.makeIterator()
+        let algorithmIdentifier = try XCTUnwrap(iterator.next())
+        let key = try XCTUnwrap(iterator.next())
+
+        // The children are slices of the original bytes, laid out back to back after the SEQUENCE header.
+        XCTAssertEqual(algorithmIdentifier.encodedBytes.startIndex, 2)
+        XCTAssertEqual(algorithmIdentifier.encodedBytes.endIndex, key.encodedBytes.startIndex)
+        XCTAssertEqual(key.encodedBytes.endIndex, decodedSPKI.endIndex)
+
+        // ANY values are taken directly from the parsed bytes, and must match a fresh serialization.
+        let spki = try ASN1.SubjectPublicKeyInfo(asn1Encoded: result)
+        let expectedParameters = try ASN1.ASN1Any(erasing: ASN1.ASN1ObjectIdentifier.NamedCurves.secp256r1)
+        XCTAssertEqual(spki.algorithmIdentifier.parameters, expectedParameters)
+    }
+
     func testRejectsMassiveIntegers() throws {
         // This is an ASN.1 integer containing UInt64.max * 2. This is too big for us to store, and we reject it.
         // This test may need to be rewritten if we either support arbitrary integers or move to platforms where
@@ -414,6 +476,41 @@ O9zxi7HTvuXyQr7QKSBtdCGmHym+WoPsbA==
         XCTAssertNoThrow(try ASN1.PEMDocument(pemString: simplePEM))
     }
 
+    func testPEMBase64DecodingMatchesFoundation() throws {
+        var generator = SystemRandomNumberGenerator()
+        for length in 0..<200 {
+            let bytes = Data((0..<length).map { _ in UInt8.random(in: .min ... .max, using: &generator) })
+            let document = ASN1.PEMDocument(type: "TEST", derBytes: bytes)
+            if length == 0 {
+                // There is no body line for an empty document, which PEMDocument rejects.
+                XCTAssertThrowsError(try ASN1.PEMDocument(pemString: document.pemString))
+                continue
+            }
+            XCTAssertEqual(try ASN1.PEMDocument(pemString: document.pemString).derBytes, bytes)
+        }
+    }
+
+    func testInvalidPEMBase64IsRejected() throws {
+        let invalidBodies = [
+            "AAA",
+            "AA=A",
+            "A===",
+            "AAA*",
+            "AA==AAAA",
+            "====",
+        ]
+        for body in invalidBodies {
+            XCTAssertNil(Data(base64Encoded: body))
+            XCTAssertThrowsError(try ASN1.PEMDocument(pemString: "-----BEGIN TEST-----\n\(body)\n-----END TEST-----")) { error in
+                XCTAssertEqual(error as? CryptoKitASN1Error, .invalidPEMDocument)
+            }
+        }
+
+        // Padding may only appear at the very end of the document, not at the end of an earlier line.
+        let paddedFirstLine = String(repeating: "A", count: 62) + "=="
+        XCTAssertThrowsError(try ASN1.PEMDocument(pemString: "-----BEGIN TEST-----\n\(paddedFirstLine)\nAAAA\n-----END TEST-----"))
+    }
+
     func testMismatchedDiscriminatorsAreRejected() throws {
         // Different discriminators is not allowed.
         let simplePEM = """
@@ -1775,6 +1872,34 @@ A5UvlNrk6ioTg2tumXD3Co06r1Hn+7lkkcjfT5mZO4jy7vP9ItvprJrIa6ySzVQ8
         let largeBytes = BigIntOfBytes(bytes: .init(repeating: 1, count: 1024))
         XCTAssertEqual(largeBytes, try oneShotDecode(oneShotSerialize(largeBytes)))
     }
+
+    func testTwoPassSerializationMatchesAppending() throws {
+        // Content lengths either side of each length-of-length boundary, nested so that outer lengths grow too.
+        for contentLength in [0, 1, 0x7F, 0x80, 0xFF, 0x100, 0x10000] {
+            let content = ASN1.ASN1OctetString(contentBytes: ArraySlice(repeating: 0x5a, count: contentLength))
+            let write = { (coder: inout ASN1.Serializer) throws in
+                try coder.appendConstructedNode(identifier: .sequence) { coder in
+                    try coder.serialize(0)
+                    try coder.serialize(content)
+                    try coder.serialize(explicitlyTaggedWithTagNumber: 1, tagClass: .contextSpecific) { coder in
+                        try coder.serialize(ASN1.ASN1Any(erasing: content))
+                        try coder.serialize(ASN1.RFC5480AlgorithmIdentifier.ecdsaP384)
+                    }
+                }
+            }
+
+            var appending = ASN1.Serializer()
+            try write(&appending)
+            XCTAssertEqual(try ASN1.Serializer.serialize(write), appending.serializedBytes)
+        }
+
+        let key = P384.Signing.PrivateKey()
+        let pkcs8 = ASN1.PKCS8PrivateKey(algorithm: .ecdsaP384, privateKey: Array(key.rawRepresentation), publicKey: Array(key.publicKey.x963Representation))
+        var appending = ASN1.Serializer()
+        try appending.serialize(pkcs8)
+        XCTAssertEqual(try ASN1.Serializer.serializedBytes(of: pkcs8), appending.serializedBytes)
+        XCTAssertEqual(Array(key.derRepresentation), appending.serializedBytes)
+    }
 }
 
 #endif
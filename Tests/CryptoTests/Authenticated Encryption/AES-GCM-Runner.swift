@@ -185,6 +185,30 @@ class AESGCMTests: XCTestCase {
         _ = try orFail { try roundTrip(message: discontiguousMessage, aad: discontiguousAad) }
     }
 
+    func testManyRegionDataProtocolsMatchContiguous() throws {
+        let key = SymmetricKey(size: .bits128)
+        let nonce = AES.GCM.Nonce()
+        let message = Array((0..<1000).map { UInt8(truncatingIfNeeded: $0) })
+        let aad = Array((0..<77).map { UInt8(truncatingIfNeeded: $0 &* 7) })
+
+        let expected = try orFail { try AES.GCM.seal(message, using: key, nonce: nonce, authenticating: aad) }
+
+        // Region sizes that are not multiples of the block size, so that blocks straddle regions.
+        for regionByteCount in [1, 7, 16, 33] {
+            let sealed = try orFail { try AES.GCM.seal(message.asDispatchData(regionByteCount: regionByteCount), using: key, nonce: nonce,
+                                                        authenticating: aad.asDispatchData(regionByteCount: regionByteCount)) }
+            XCTAssertEqual(sealed.ciphertext, expected.ciphertext)
+            XCTAssertEqual(sealed.tag, expected.tag)
+
+            let opened = try orFail { try AES.GCM.open(expected, using: key, authenticating: aad.asDispatchData(regionByteCount: regionByteCount)) }
+            XCTAssertEqual(Array(opened), message)
+
+            var wrongAAD = aad
+            wrongAAD[wrongAAD.count - 1] ^= 1
+            XCTAssertThrowsError(try AES.GCM.open(expected, using: key, authenticating: wrongAAD.asDispatchData(regionByteCount: regionByteCount)))
+        }
+    }
+
     func testWycheproof() throws {
         try orFail {
             try wycheproofTest(
@@ -111,5 +111,29 @@ final class ArbitraryPrecisionIntegerTests: XCTestCase {
         XCTAssertFalse(two > two)
         XCTAssertTrue(two >= two)
     }
+
+    func testMontgomeryFieldArithmeticMatchesModularArithmetic() throws {
+        let p = ArbitraryPrecisionInteger(1_000_003)
+        let context = try FiniteFieldArithmeticContext(fieldSize: p)
+        let x = ArbitraryPrecisionInteger(123_456)
+        let y = ArbitraryPrecisionInteger(987_654)
+
+        var element = try context.montgomeryElement(x)
+        let yElement = try context.montgomeryElement(y)
+        XCTAssertEqual(try context.integer(from: element), x)
+
+        try context.square(&element)
+        XCTAssertEqual(try context.integer(from: element), try context.square(x))
+
+        try context.multiply(&element, by: yElement)
+        let expectedProduct = try context.multiply(context.square(x), y)
+        XCTAssertEqual(try context.integer(from: element), expectedProduct)
+
+        try context.add(&element, yElement)
+        XCTAssertEqual(try context.integer(from: element), try context.add(expectedProduct, y))
+
+        // Inputs outside the field are reduced on the way in.
+        XCTAssertEqual(try context.integer(from: context.montgomeryElement(p + x)), x)
+    }
 }
 #endif // CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
@@ -113,6 +113,24 @@ class DigestsTests: XCTestCase {
         try orFail { try testHashFunctionImplementsCoW(hf: SHA512.self) }
     }
     
+    func testHashFunctionFinalizeIsNonDestructive<H: HashFunction>(hf: H.Type) throws {
+        var hf = H()
+        hf.update(data: [1, 2, 3, 4])
+        XCTAssertEqual(hf.finalize(), hf.finalize())
+        XCTAssertEqual(hf.finalize(), H.hash(data: [1, 2, 3, 4]))
+
+        hf.update(data: [5, 6, 7, 8])
+        XCTAssertEqual(hf.finalize(), H.hash(data: [1, 2, 3, 4, 5, 6, 7, 8]))
+    }
+
+    func testHashFunctionsFinalizeIsNonDestructive() throws {
+        try orFail { try testHashFunctionFinalizeIsNonDestructive(hf: Insecure.MD5.self) }
+        try orFail { try testHashFunctionFinalizeIsNonDestructive(hf: Insecure.SHA1.self) }
+        try orFail { try testHashFunctionFinalizeIsNonDestructive(hf: SHA256.self) }
+        try orFail { try testHashFunctionFinalizeIsNonDestructive(hf: SHA384.self) }
+        try orFail { try testHashFunctionFinalizeIsNonDestructive(hf: SHA512.self) }
+    }
+
     @available(macOS 10.15, iOS 13.2, tvOS 13.2, watchOS 6.1, *)
     func testBlockSizes() {
         XCTAssertEqual(Insecure.MD5.blockByteCount, 64)
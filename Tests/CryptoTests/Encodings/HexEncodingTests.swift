@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Foundation
+import XCTest
+
+#if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+// Skip tests that require @testable imports of CryptoKit.
+#else
+@testable import Crypto
+
+class HexEncodingTests: XCTestCase {
+    func testEncodeMatchesFormat() {
+        let bytes = (0..<256).map { UInt8($0) }
+        // Cover every tail length around the four-byte steps.
+        for count in 0..<20 {
+            let input = Array(bytes.shuffled().prefix(count))
+            let expected = input.map { String(format: "%02x", $0) }.joined()
+            var output = [UInt8](repeating: 0, count: count * 2)
+            input.withUnsafeBytes { input in
+                output.withUnsafeMutableBytes { input.hexEncode(into: $0) }
+            }
+            XCTAssertEqual(String(decoding: output, as: UTF8.self), expected)
+        }
+
+        let digest = SHA256.hash(data: bytes)
+        XCTAssertEqual(digest.description, "SHA256 digest: " + digest.map { String(format: "%02x", $0) }.joined())
+    }
+
+    func testDecodeRoundTrips() throws {
+        let bytes = (0..<256).map { UInt8($0) }
+        var output = [UInt8](repeating: 0, count: 256)
+        try Array("\(bytes.withUnsafeBytes { $0.hexString })".utf8).withUnsafeBytes { hex in
+            try output.withUnsafeMutableBytes { try hex.hexDecode(into: $0, allowingUppercase: false) }
+        }
+        XCTAssertEqual(output, bytes)
+    }
+
+    func testDecodeCase() throws {
+        var output = [UInt8](repeating: 0, count: 2)
+        try Array("aBcD".utf8).withUnsafeBytes { hex in
+            try output.withUnsafeMutableBytes { try hex.hexDecode(into: $0, allowingUppercase: true) }
+        }
+        XCTAssertEqual(output, [0xab, 0xcd])
+
+        XCTAssertThrowsError(try Array("aB".utf8).withUnsafeBytes { hex in
+            try output.withUnsafeMutableBytes { try hex.hexDecode(into: UnsafeMutableRawBufferPointer(rebasing: $0[..<1]), allowingUppercase: false) }
+        })
+        for invalid in ["0g", "g0", " 0", "0/", ":0", "`0", "0G"] {
+            XCTAssertThrowsError(try Array(invalid.utf8).withUnsafeBytes { hex in
+                try output.withUnsafeMutableBytes { try hex.hexDecode(into: UnsafeMutableRawBufferPointer(rebasing: $0[..<1]), allowingUppercase: true) }
+            })
+        }
+    }
+}
+#endif // CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
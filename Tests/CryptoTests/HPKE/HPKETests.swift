@@ -37,6 +37,19 @@ class HPKETests: XCTestCase {
         XCTAssertThrowsError(try HPKE.Sender(recipientKey: skR.publicKey, ciphersuite: .P384_SHA384_AES_GCM_256, info: Data()))
     }
         
+    func testCachedSuiteConstantsMatchLabeledExtract() {
+        for ciphersuite in [HPKE.Ciphersuite.P256_SHA256_AES_GCM_256, .P384_SHA384_AES_GCM_256, .P521_SHA512_AES_GCM_256, .Curve25519_SHA256_ChachaPoly] {
+            let constants = ciphersuite.keyScheduleConstants
+            let info = Data("some info".utf8)
+            XCTAssertEqual(constants.defaultPSKIDHash,
+                           NonSecretOutputLabeledExtract(salt: nil, label: Data("psk_id_hash".utf8), ikm: nil, suiteID: ciphersuite.identifier, kdf: ciphersuite.kdf))
+            XCTAssertEqual(constants.pskIDHashExtract.extract(ikm: info),
+                           NonSecretOutputLabeledExtract(salt: nil, label: Data("psk_id_hash".utf8), ikm: SymmetricKey(data: info), suiteID: ciphersuite.identifier, kdf: ciphersuite.kdf))
+            XCTAssertEqual(constants.infoHashExtract.extract(ikm: info),
+                           NonSecretOutputLabeledExtract(salt: nil, label: Data("info_hash".utf8), ikm: SymmetricKey(data: info), suiteID: ciphersuite.identifier, kdf: ciphersuite.kdf))
+        }
+    }
+        
     func testCiphersuite(_ ciphersuite: HPKE.Ciphersuite) throws {
         switch ciphersuite.kem {
         case .P256_HKDF_SHA256:
@@ -103,6 +116,44 @@ class HPKETests: XCTestCase {
         XCTAssertThrowsError(try recipient.open(ct, authenticating: aad))
         XCTAssertEqual(try recipient.open(ct, authenticating: aad2), msg)
     }
+
+    func testCopiesSealAndOpenIndependently() throws {
+        for aead in [HPKE.AEAD.AES_GCM_128, .AES_GCM_256, .chaChaPoly] {
+            let ciphersuite = HPKE.Ciphersuite(kem: .Curve25519_HKDF_SHA256, kdf: .HKDF_SHA256, aead: aead)
+            let skR = Curve25519.KeyAgreement.PrivateKey()
+            var sender = try HPKE.Sender(recipientKey: skR.publicKey, ciphersuite: ciphersuite, info: Data())
+            var recipient = try HPKE.Recipient(privateKey: skR, ciphersuite: ciphersuite, info: Data(), encapsulatedKey: sender.encapsulatedKey)
+            let msg = Data("copied".utf8)
+
+            XCTAssertEqual(try recipient.open(sender.seal(msg)), msg)
+            var senderCopy = sender
+            var recipientCopy = recipient
+            let ct = try sender.seal(msg)
+            XCTAssertEqual(try senderCopy.seal(msg), ct)
+            XCTAssertEqual(try recipient.open(ct), msg)
+            XCTAssertEqual(try recipientCopy.open(ct), msg)
+            XCTAssertThrowsError(try recipient.open(ct))
+        }
+    }
+
+    func testSequenceNumberLimit() throws {
+        for ciphersuite in [HPKE.Ciphersuite.Curve25519_SHA256_ChachaPoly, .P256_SHA256_AES_GCM_256] {
+            var sender: HPKE.Sender
+            if ciphersuite.kem == .Curve25519_HKDF_SHA256 {
+                sender = try HPKE.Sender(recipientKey: Curve25519.KeyAgreement.PrivateKey().publicKey, ciphersuite: ciphersuite, info: Data())
+            } else {
+                sender = try HPKE.Sender(recipientKey: P256.KeyAgreement.PrivateKey().publicKey, ciphersuite: ciphersuite, info: Data())
+            }
+            for _ in 0..<4095 {
+                _ = try sender.seal(Data())
+            }
+            XCTAssertThrowsError(try sender.seal(Data())) { error in
+                guard case HPKE.Errors.outOfRangeSequenceNumber = error else {
+                    return XCTFail("Unexpected error \(error)")
+                }
+            }
+        }
+    }
 }
 
 #endif // CRYPTO_IN_SWIFTPM
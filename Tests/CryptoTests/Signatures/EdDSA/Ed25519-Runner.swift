@@ -84,6 +84,49 @@ class Ed25519Tests: XCTestCase {
         XCTAssertFalse(otherPrivateKey.publicKey.isValidSignature(discontiguousSignature, for: someDiscontiguousData))
     }
 
+    func testSigningManyRegionData() throws {
+        let privateKey = Curve25519.Signing.PrivateKey()
+        let message = Array((0..<1000).map { UInt8(truncatingIfNeeded: $0) })
+
+        let signatureOnContiguous = try orFail { try privateKey.signature(for: message) }
+        let signatureOnDiscontiguous = try orFail { try privateKey.signature(for: message.asDispatchData(regionByteCount: 33)) }
+        #if !(canImport(Darwin))
+        XCTAssertEqual(signatureOnContiguous, signatureOnDiscontiguous)
+        #endif
+        XCTAssertTrue(privateKey.publicKey.isValidSignature(signatureOnDiscontiguous, for: message))
+    }
+
+    func testVerifyingLargeDiscontiguousData() throws {
+        // Large enough that the regions are hashed where they lie rather than copied together.
+        let privateKey = Curve25519.Signing.PrivateKey()
+        var message = Array(repeating: UInt8(0x5a), count: (1 << 20) + 17)
+        let signature = try orFail { try privateKey.signature(for: message) }
+        XCTAssertTrue(privateKey.publicKey.isValidSignature(signature, for: message.asDispatchData(regionByteCount: 65536)))
+
+        let (_, discontiguousSignature) = Array(signature).asDataProtocols()
+        XCTAssertTrue(privateKey.publicKey.isValidSignature(discontiguousSignature, for: message.asDispatchData(regionByteCount: 65536)))
+
+        message[message.count / 2] ^= 1
+        XCTAssertFalse(privateKey.publicKey.isValidSignature(signature, for: message.asDispatchData(regionByteCount: 65536)))
+    }
+
+    func testSigningMatchesRFC8032() throws {
+        // RFC 8032, section 7.1, TEST 2.
+        let seed = try orFail { try Array(hexString: "4ccd089b28ff96da9db6c346ec114e0f5b8a319f35aba624da8cf6ed4fb8a6fb") }
+        let publicKey = try orFail { try Data(hexString: "3d4017c3e843895a92b70aa74d1b7ebc9c982ccf2ec4968cc0cd55f12af4660c") }
+        let message = try orFail { try Data(hexString: "72") }
+        let expectedSignature = try orFail { try Data(hexString: "92a009a9f0d4cab8720e820b5f642540a2b27b5416503f8fb3762223ebdb69da085ac1e43e15996e458f3613d0f11d8c387b2eaeb4302aeeb00d291612bb0c00") }
+
+        let privateKey = try orFail { try Curve25519.Signing.PrivateKey(rawRepresentation: seed) }
+        XCTAssertEqual(privateKey.publicKey.rawRepresentation, publicKey)
+
+        let signature = try orFail { try privateKey.signature(for: message) }
+        #if !(canImport(Darwin))
+        XCTAssertEqual(signature, expectedSignature)
+        #endif
+        XCTAssertTrue(privateKey.publicKey.isValidSignature(signature, for: message))
+    }
+
     func testSigningZeroRegionDataProtocol() throws {
         let privateKey = Curve25519.Signing.PrivateKey()
         let signature = try orFail { try privateKey.signature(for: DispatchData.empty) }
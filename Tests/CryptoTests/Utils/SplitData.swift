@@ -34,4 +34,17 @@ extension Array where Element == UInt8 {
 
         return (contiguous: contiguous, discontiguous: discontiguous)
     }
+
+    // A discontiguous representation with a region every `regionByteCount` bytes, for exercising code that walks the regions.
+    func asDispatchData(regionByteCount: Int) -> DispatchData {
+        precondition(regionByteCount > 0)
+        return self.withUnsafeBytes { bytesPointer in
+            var data = DispatchData.empty
+            for start in stride(from: 0, to: bytesPointer.count, by: regionByteCount) {
+                let end = Swift.min(start + regionByteCount, bytesPointer.count)
+                data.append(DispatchData(bytes: UnsafeRawBufferPointer(rebasing: bytesPointer[start..<end])))
+            }
+            return data
+        }
+    }
 }
@@ -0,0 +1,228 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class AEADBatchTests: XCTestCase {
+    private struct Message {
+        var nonce: [UInt8]
+        var plaintext: [UInt8]
+        var authenticatedData: [UInt8]
+    }
+
+    private static func randomMessages(count: Int) -> [Message] {
+        var rng = SystemRandomNumberGenerator()
+        return (0..<count).map { index in
+            Message(
+                nonce: (0..<12).map { _ in rng.next() },
+                plaintext: (0..<(index * 37)).map { _ in rng.next() },
+                authenticatedData: (0..<(index % 3) * 8).map { _ in rng.next() }
+            )
+        }
+    }
+
+    /// Seals the messages with the batch API, returning a combined ciphertext || tag for each message.
+    private static func sealBatch(
+        _ messages: [Message],
+        _ seal: ([_AEADBatchSealOperation]) throws -> Void
+    ) throws -> [[UInt8]] {
+        let outputs = messages.map { UnsafeMutableRawBufferPointer.allocate(byteCount: $0.plaintext.count + 16, alignment: 1) }
+        defer { outputs.forEach { $0.deallocate() } }
+
+        // Build the operations with all of the input buffers pinned for the duration of the call.
+        func withOperations(_ index: Int, _ operations: [_AEADBatchSealOperation]) throws {
+            guard index < messages.count else {
+                return try seal(operations)
+            }
+            try messages[index].nonce.withUnsafeBytes { nonce in
+                try messages[index].plaintext.withUnsafeBytes { plaintext in
+                    try messages[index].authenticatedData.withUnsafeBytes { ad in
+                        let output = outputs[index]
+                        let operation = _AEADBatchSealOperation(
+                            nonce: nonce,
+                            plaintext: plaintext,
+                            authenticatedData: ad,
+                            ciphertext: UnsafeMutableRawBufferPointer(rebasing: output.dropLast(16)),
+                            tag: UnsafeMutableRawBufferPointer(rebasing: output.suffix(16))
+                        )
+                        try withOperations(index + 1, operations + [operation])
+                    }
+                }
+            }
+        }
+        try withOperations(0, [])
+        return outputs.map { Array($0) }
+    }
+
+    private static func openBatch(
+        _ messages: [Message],
+        _ sealed: [[UInt8]],
+        _ open: ([_AEADBatchOpenOperation]) throws -> [Bool]
+    ) throws -> ([[UInt8]], [Bool]) {
+        let outputs = messages.map { UnsafeMutableRawBufferPointer.allocate(byteCount: $0.plaintext.count, alignment: 1) }
+        defer { outputs.forEach { $0.deallocate() } }
+        outputs.forEach { $0.initializeMemory(as: UInt8.self, repeating: 0xFF) }
+        var results: [Bool] = []
+
+        func withOperations(_ index: Int, _ operations: [_AEADBatchOpenOperation]) throws {
+            guard index < messages.count else {
+                results = try open(operations)
+                return
+            }
+            try messages[index].nonce.withUnsafeBytes { nonce in
+                try sealed[index].withUnsafeBytes { combined in
+                    try messages[index].authenticatedData.withUnsafeBytes { ad in
+                        let operation = _AEADBatchOpenOperation(
+                            nonce: nonce,
+                            ciphertext: UnsafeRawBufferPointer(rebasing: combined.dropLast(16)),
+                            tag: UnsafeRawBufferPointer(rebasing: combined.suffix(16)),
+                            authenticatedData: ad,
+                            plaintext: outputs[index]
+                        )
+                        try withOperations(index + 1, operations + [operation])
+                    }
+                }
+            }
+        }
+        try withOperations(0, [])
+        return (outputs.map { Array($0) }, results)
+    }
+
+    func testAESGCMBatchMatchesSingleShot() throws {
+        for keySize in [SymmetricKeySize.bits128, .bits192, .bits256] {
+            let key = SymmetricKey(size: keySize)
+            let messages = Self.randomMessages(count: 10)
+
+            let sealed = try Self.sealBatch(messages) { try AES.GCM._sealBatch($0, using: key) }
+
+            for (message, combined) in zip(messages, sealed) {
+                let box = try AES.GCM.seal(message.plaintext, using: key, nonce: AES.GCM.Nonce(data: message.nonce), authenticating: message.authenticatedData)
+                XCTAssertEqual(Array(box.ciphertext + box.tag), combined)
+            }
+
+            let (opened, results) = try Self.openBatch(messages, sealed) { try AES.GCM._openBatch($0, using: key) }
+            XCTAssertEqual(results, Array(repeating: true, count: messages.count))
+            XCTAssertEqual(opened, messages.map { $0.plaintext })
+        }
+    }
+
+    func testChaChaPolyBatchMatchesSingleShot() throws {
+        let key = SymmetricKey(size: .bits256)
+        let messages = Self.randomMessages(count: 10)
+
+        let sealed = try Self.sealBatch(messages) { try ChaChaPoly._sealBatch($0, using: key) }
+
+        for (message, combined) in zip(messages, sealed) {
+            let box = try ChaChaPoly.seal(message.plaintext, using: key, nonce: ChaChaPoly.Nonce(data: message.nonce), authenticating: message.authenticatedData)
+            XCTAssertEqual(Array(box.ciphertext + box.tag), combined)
+        }
+
+        let (opened, results) = try Self.openBatch(messages, sealed) { try ChaChaPoly._openBatch($0, using: key) }
+        XCTAssertEqual(results, Array(repeating: true, count: messages.count))
+        XCTAssertEqual(opened, messages.map { $0.plaintext })
+    }
+
+    func testBatchOpenReportsEachFailure() throws {
+        let key = SymmetricKey(size: .bits256)
+        let messages = Self.randomMessages(count: 4)
+
+        var sealed = try Self.sealBatch(messages) { try AES.GCM._sealBatch($0, using: key) }
+        sealed[1][sealed[1].count - 1] ^= 1
+        sealed[3][0] ^= 1
+
+        let (opened, results) = try Self.openBatch(messages, sealed) { try AES.GCM._openBatch($0, using: key) }
+        XCTAssertEqual(results, [true, false, true, false])
+        XCTAssertEqual(opened[0], messages[0].plaintext)
+        XCTAssertEqual(opened[1], Array(repeating: 0, count: messages[1].plaintext.count))
+        XCTAssertEqual(opened[2], messages[2].plaintext)
+        XCTAssertEqual(opened[3], Array(repeating: 0, count: messages[3].plaintext.count))
+    }
+
+    func testBatchRejectsInvalidParameters() throws {
+        let nonce = [UInt8](repeating: 0, count: 12)
+        let plaintext = [UInt8](repeating: 0, count: 32)
+        var output = [UInt8](repeating: 0, count: 48)
+
+        try nonce.withUnsafeBytes { nonce in
+            try plaintext.withUnsafeBytes { plaintext in
+                try output.withUnsafeMutableBytes { output in
+                    let shortTag = _AEADBatchSealOperation(
+                        nonce: nonce,
+                        plaintext: plaintext,
+                        ciphertext: UnsafeMutableRawBufferPointer(rebasing: output.prefix(32)),
+                        tag: UnsafeMutableRawBufferPointer(rebasing: output[32..<40])
+                    )
+                    XCTAssertThrowsError(try AES.GCM._sealBatch([shortTag], using: SymmetricKey(size: .bits128))) { error in
+                        guard case .some(.incorrectParameterSize) = error as? CryptoKitError else {
+                            XCTFail("Unexpected error: \(error)")
+                            return
+                        }
+                    }
+                    XCTAssertThrowsError(try ChaChaPoly._sealBatch([], using: SymmetricKey(size: .bits128))) { error in
+                        guard case .some(.incorrectKeySize) = error as? CryptoKitError else {
+                            XCTFail("Unexpected error: \(error)")
+                            return
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    func testBatchRejectsInvalidNonces() {
+        let longNonce = [UInt8](repeating: 0, count: 16)
+        let plaintext = [UInt8](repeating: 0, count: 32)
+        var output = [UInt8](repeating: 0, count: 48)
+
+        longNonce.withUnsafeBytes { longNonce in
+            plaintext.withUnsafeBytes { plaintext in
+                output.withUnsafeMutableBytes { output in
+                    let ciphertext = UnsafeMutableRawBufferPointer(rebasing: output.prefix(32))
+                    let tag = UnsafeMutableRawBufferPointer(rebasing: output[32...])
+                    let shortNonce = UnsafeRawBufferPointer(rebasing: longNonce.prefix(8))
+
+                    let key = SymmetricKey(size: .bits256)
+                    func assertIncorrectParameterSize(_ body: () throws -> Void) {
+                        XCTAssertThrowsError(try body()) { error in
+                            guard case .some(.incorrectParameterSize) = error as? CryptoKitError else {
+                                XCTFail("Unexpected error: \(error)")
+                                return
+                            }
+                        }
+                    }
+                    func operations(_ nonce: UnsafeRawBufferPointer) -> (_AEADBatchSealOperation, _AEADBatchOpenOperation) {
+                        (
+                            _AEADBatchSealOperation(nonce: nonce, plaintext: plaintext, ciphertext: ciphertext, tag: tag),
+                            _AEADBatchOpenOperation(nonce: nonce, ciphertext: UnsafeRawBufferPointer(ciphertext), tag: UnsafeRawBufferPointer(tag), plaintext: ciphertext)
+                        )
+                    }
+
+                    let (shortSeal, shortOpen) = operations(shortNonce)
+                    assertIncorrectParameterSize { try AES.GCM._sealBatch([shortSeal], using: key) }
+                    assertIncorrectParameterSize { _ = try AES.GCM._openBatch([shortOpen], using: key) }
+
+                    let (longSeal, longOpen) = operations(longNonce)
+                    assertIncorrectParameterSize { try ChaChaPoly._sealBatch([longSeal], using: key) }
+                    assertIncorrectParameterSize { _ = try ChaChaPoly._openBatch([longOpen], using: key) }
+
+                    // AES-GCM accepts nonces longer than 12 bytes, as AES.GCM.Nonce does.
+                    XCTAssertNoThrow(try AES.GCM._sealBatch([longSeal], using: key))
+                }
+            }
+        }
+    }
+}
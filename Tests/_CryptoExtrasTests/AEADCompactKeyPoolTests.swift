@@ -0,0 +1,113 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class AEADCompactKeyPoolTests: XCTestCase {
+    func testInteroperatesWithAESGCM() throws {
+        let pool = AES.GCM._CompactKeyPool(hotCapacity: 4)
+        for bits in [SymmetricKeySize.bits128, .bits192, .bits256] {
+            let key = SymmetricKey(size: bits)
+            let compact = try pool.key(key)
+            for byteCount in [0, 1, 16, 17, 100, 1024] {
+                let message = [UInt8]((0..<byteCount).map { UInt8(truncatingIfNeeded: $0) })
+                let nonce = AES.GCM.Nonce()
+                let box = try compact.seal(message, nonce: nonce, authenticating: [1, 2, 3])
+                let reference = try AES.GCM.seal(message, using: key, nonce: nonce, authenticating: [1, 2, 3])
+                XCTAssertEqual(box.ciphertext, reference.ciphertext)
+                XCTAssertEqual(box.tag, reference.tag)
+                XCTAssertEqual(Array(try compact.open(reference, authenticating: [1, 2, 3])), message)
+            }
+        }
+    }
+
+    func testColdSessionsArePromotedAndEvicted() throws {
+        let pool = AES.GCM._CompactKeyPool(hotCapacity: 2)
+        let keys = try (0..<3).map { _ in try pool.key(SymmetricKey(size: .bits128)) }
+        XCTAssertEqual(pool.statistics.sessionCount, 3)
+
+        _ = try keys[0].seal([1])
+        _ = try keys[0].seal([1])
+        _ = try keys[1].seal([1])
+        // The third session pushes out the least recently used, key 0.
+        _ = try keys[2].seal([1])
+        _ = try keys[1].seal([1])
+        _ = try keys[0].seal([1])
+
+        let statistics = pool.statistics
+        XCTAssertEqual(statistics.hotCapacity, 2)
+        XCTAssertEqual(statistics.hits, 2)
+        XCTAssertEqual(statistics.promotions, 4)
+        XCTAssertEqual(statistics.evictions, 2)
+        XCTAssertEqual(statistics.transientExpansions, 0)
+    }
+
+    func testPoolWithoutHotSlots() throws {
+        let pool = AES.GCM._CompactKeyPool(hotCapacity: 0)
+        let key = try pool.key(SymmetricKey(size: .bits256))
+        let box = try key.seal(Array("hello".utf8))
+        XCTAssertEqual(Array(try key.open(box)), Array("hello".utf8))
+        XCTAssertEqual(pool.statistics.transientExpansions, 2)
+        XCTAssertEqual(pool.statistics.hotByteCount, 0)
+    }
+
+    func testReleasingAKeyRemovesTheSession() throws {
+        let pool = AES.GCM._CompactKeyPool(hotCapacity: 1)
+        do {
+            let key = try pool.key(SymmetricKey(size: .bits128))
+            _ = try key.seal([1, 2, 3])
+            XCTAssertEqual(pool.statistics.sessionCount, 1)
+        }
+        XCTAssertEqual(pool.statistics.sessionCount, 0)
+
+        // The freed slot and entry are reused.
+        let key = try pool.key(SymmetricKey(size: .bits128))
+        _ = try key.seal([1, 2, 3])
+        XCTAssertEqual(pool.statistics.sessionCount, 1)
+        XCTAssertEqual(pool.statistics.evictions, 0)
+    }
+
+    func testTamperingIsDetected() throws {
+        let pool = AES.GCM._CompactKeyPool(hotCapacity: 1)
+        let key = try pool.key(SymmetricKey(size: .bits128))
+        let box = try key.seal(Array(repeating: UInt8(7), count: 32), authenticating: [1])
+        XCTAssertThrowsError(try key.open(box, authenticating: [2])) { error in
+            guard case .some(.authenticationFailure) = error as? CryptoKitError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+        XCTAssertThrowsError(try pool.key(SymmetricKey(size: SymmetricKeySize(bitCount: 64))))
+    }
+
+    func testPoolIsUsableConcurrently() throws {
+        // Fewer slots than threads, so some operations fall back to private expansions.
+        let pool = AES.GCM._CompactKeyPool(hotCapacity: 2)
+        let keys = try (0..<16).map { _ in try pool.key(SymmetricKey(size: .bits128)) }
+
+        DispatchQueue.concurrentPerform(iterations: 8) { thread in
+            for i in 0..<200 {
+                let key = keys[(thread + i) % keys.count]
+                let message = [UInt8](repeating: UInt8(truncatingIfNeeded: i), count: i % 64)
+                let sealed = try! key.seal(message)
+                XCTAssertEqual(try! key.open(sealed), Data(message))
+            }
+        }
+        let statistics = pool.statistics
+        XCTAssertEqual(statistics.hits + statistics.promotions + statistics.transientExpansions, 8 * 200 * 2)
+    }
+}
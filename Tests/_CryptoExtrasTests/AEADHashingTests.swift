@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class AEADHashingTests: XCTestCase {
+    let authenticatedData = Array("Some authenticated data".utf8)
+
+    func testAESGCMSealMatchesSealAndHash() throws {
+        let key = SymmetricKey(size: .bits256)
+        // Cover messages shorter than, equal to and spanning several internal chunks.
+        for count in [0, 1, 15, 8191, 8192, 8193, 100_003] {
+            let message = (0..<count).map { UInt8(truncatingIfNeeded: $0 &* 7) }
+            let nonce = AES.GCM.Nonce()
+            let expected = try AES.GCM.seal(message, using: key, nonce: nonce, authenticating: authenticatedData)
+
+            var output = [UInt8](repeating: 0, count: count + 16)
+            let digest = try message.withUnsafeBytes { message in
+                try output.withUnsafeMutableBytes { output in
+                    try AES.GCM._sealHashingPlaintext(message, into: output, using: key, nonce: nonce, authenticating: authenticatedData)
+                }
+            }
+            XCTAssertEqual(output, Array(expected.ciphertext + expected.tag), "count \(count)")
+            XCTAssertEqual(digest, Data(SHA256.hash(data: message)), "count \(count)")
+        }
+    }
+
+    func testAESGCMSealedBoxRoundTrip() throws {
+        let key = SymmetricKey(size: .bits128)
+        let message = Data((0..<20_000).map { UInt8(truncatingIfNeeded: $0) })
+
+        let (sealedBox, sealDigest) = try AES.GCM._sealHashingPlaintext(message, using: key)
+        XCTAssertEqual(sealDigest, Data(SHA256.hash(data: message)))
+        XCTAssertEqual(try AES.GCM.open(sealedBox, using: key), message)
+
+        var buffer = Array(sealedBox.ciphertext + sealedBox.tag)
+        let (plaintext, openDigest) = try buffer.withUnsafeMutableBytes { buffer -> ([UInt8], Data) in
+            let opened = try AES.GCM._openHashingPlaintext(inPlace: buffer, using: key, nonce: sealedBox.nonce, authenticating: [UInt8]())
+            return (Array(opened.plaintext), opened.plaintextDigest)
+        }
+        XCTAssertEqual(plaintext, Array(message))
+        XCTAssertEqual(openDigest, sealDigest)
+    }
+
+    func testDiscontiguousMessageIsSealed() throws {
+        let key = SymmetricKey(size: .bits256)
+        let nonce = AES.GCM.Nonce()
+        var message = DispatchData.empty
+        for part in [Array("first part, ".utf8), Array("second part".utf8)] {
+            part.withUnsafeBytes { message.append($0) }
+        }
+        let expected = try AES.GCM.seal(message, using: key, nonce: nonce, authenticating: authenticatedData)
+
+        let (sealedBox, digest) = try AES.GCM._sealHashingPlaintext(message, using: key, nonce: nonce, authenticating: authenticatedData)
+        XCTAssertEqual(sealedBox.ciphertext, expected.ciphertext)
+        XCTAssertEqual(sealedBox.tag, expected.tag)
+        XCTAssertEqual(digest, Data(SHA256.hash(data: message)))
+    }
+
+    func testChaChaPolyInPlaceRoundTrip() throws {
+        let key = SymmetricKey(size: .bits256)
+        let nonce = ChaChaPoly.Nonce()
+        let message = (0..<30_000).map { UInt8(truncatingIfNeeded: $0 &* 3) }
+        let expected = try ChaChaPoly.seal(message, using: key, nonce: nonce, authenticating: authenticatedData)
+
+        var buffer = message + [UInt8](repeating: 0, count: 16)
+        let (plaintext, sealDigest, openDigest) = try buffer.withUnsafeMutableBytes { buffer -> ([UInt8], Data, Data) in
+            let sealDigest = try ChaChaPoly._sealHashingPlaintext(UnsafeRawBufferPointer(rebasing: buffer.prefix(message.count)), into: buffer, using: key, nonce: nonce, authenticating: authenticatedData)
+            XCTAssertEqual(Array(buffer), Array(expected.ciphertext + expected.tag))
+            let opened = try ChaChaPoly._openHashingPlaintext(inPlace: buffer, using: key, nonce: nonce, authenticating: authenticatedData)
+            return (Array(opened.plaintext), sealDigest, opened.plaintextDigest)
+        }
+        XCTAssertEqual(plaintext, message)
+        XCTAssertEqual(sealDigest, Data(SHA256.hash(data: message)))
+        XCTAssertEqual(openDigest, sealDigest)
+    }
+
+    func testOpenFailureZeroesPlaintext() throws {
+        let key = SymmetricKey(size: .bits256)
+        let nonce = AES.GCM.Nonce()
+        let message = Array("Some message".utf8)
+        let sealedBox = try AES.GCM.seal(message, using: key, nonce: nonce)
+
+        var buffer = Array(sealedBox.ciphertext + sealedBox.tag)
+        buffer[buffer.count - 1] ^= 1
+        buffer.withUnsafeMutableBytes { buffer in
+            XCTAssertThrowsError(try AES.GCM._openHashingPlaintext(inPlace: buffer, using: key, nonce: nonce, authenticating: [UInt8]()))
+        }
+        XCTAssertEqual(Array(buffer.prefix(message.count)), [UInt8](repeating: 0, count: message.count))
+    }
+
+    func testWrongOutputSizeIsRejected() throws {
+        let key = SymmetricKey(size: .bits256)
+        let message = [UInt8](repeating: 1, count: 32)
+        var output = [UInt8](repeating: 0, count: 32)
+        message.withUnsafeBytes { message in
+            output.withUnsafeMutableBytes { output in
+                XCTAssertThrowsError(try AES.GCM._sealHashingPlaintext(message, into: output, using: key, nonce: AES.GCM.Nonce(), authenticating: [UInt8]())) { error in
+                    XCTAssertEqual(error as? CryptoKitError, .incorrectParameterSize)
+                }
+            }
+        }
+    }
+}
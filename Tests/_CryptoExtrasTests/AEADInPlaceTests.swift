@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class AEADInPlaceTests: XCTestCase {
+    let message = Array("Some message to seal in place".utf8)
+    let authenticatedData = Array("Some authenticated data".utf8)
+
+    func testAESGCMSealIntoMatchesSealedBox() throws {
+        let key = SymmetricKey(size: .bits256)
+        let nonce = AES.GCM.Nonce()
+        let expected = try AES.GCM.seal(message, using: key, nonce: nonce, authenticating: authenticatedData)
+
+        var output = [UInt8](repeating: 0, count: message.count + 16)
+        try message.withUnsafeBytes { message in
+            try output.withUnsafeMutableBytes { output in
+                try AES.GCM._seal(message, into: output, using: key, nonce: nonce, authenticating: authenticatedData)
+            }
+        }
+        XCTAssertEqual(output, Array(expected.ciphertext + expected.tag))
+    }
+
+    func testAESGCMInPlaceRoundTrip() throws {
+        let key = SymmetricKey(size: .bits128)
+        let nonce = AES.GCM.Nonce()
+
+        var buffer = message + [UInt8](repeating: 0, count: 16)
+        let plaintext = try buffer.withUnsafeMutableBytes { buffer -> [UInt8] in
+            try AES.GCM._seal(UnsafeRawBufferPointer(rebasing: buffer.prefix(message.count)), into: buffer, using: key, nonce: nonce)
+            XCTAssertNotEqual(Array(buffer.prefix(message.count)), message)
+            return Array(try AES.GCM._open(inPlace: buffer, using: key, nonce: nonce))
+        }
+        XCTAssertEqual(plaintext, message)
+    }
+
+    func testChaChaPolyInPlaceRoundTrip() throws {
+        let key = SymmetricKey(size: .bits256)
+        let nonce = ChaChaPoly.Nonce()
+        let expected = try ChaChaPoly.seal(message, using: key, nonce: nonce, authenticating: authenticatedData)
+
+        var buffer = message + [UInt8](repeating: 0, count: 16)
+        let plaintext = try buffer.withUnsafeMutableBytes { buffer -> [UInt8] in
+            try ChaChaPoly._seal(UnsafeRawBufferPointer(rebasing: buffer.prefix(message.count)), into: buffer, using: key, nonce: nonce, authenticating: authenticatedData)
+            XCTAssertEqual(Array(buffer), Array(expected.ciphertext + expected.tag))
+            return Array(try ChaChaPoly._open(inPlace: buffer, using: key, nonce: nonce, authenticating: authenticatedData))
+        }
+        XCTAssertEqual(plaintext, message)
+    }
+
+    func testOpenInPlaceRejectsTamperedData() throws {
+        let key = SymmetricKey(size: .bits256)
+        let nonce = ChaChaPoly.Nonce()
+        let sealed = try ChaChaPoly.seal(message, using: key, nonce: nonce)
+
+        var buffer = Array(sealed.ciphertext + sealed.tag)
+        buffer[buffer.count - 1] ^= 1
+        try buffer.withUnsafeMutableBytes { buffer in
+            XCTAssertThrowsError(try ChaChaPoly._open(inPlace: buffer, using: key, nonce: nonce))
+        }
+        XCTAssertEqual(Array(buffer.prefix(message.count)), [UInt8](repeating: 0, count: message.count))
+    }
+
+    func testSealIntoRejectsIncorrectOutputSize() throws {
+        let key = SymmetricKey(size: .bits256)
+        var output = [UInt8](repeating: 0, count: message.count)
+        try message.withUnsafeBytes { message in
+            try output.withUnsafeMutableBytes { output in
+                XCTAssertThrowsError(try AES.GCM._seal(message, into: output, using: key, nonce: AES.GCM.Nonce())) { error in
+                    guard case .some(.incorrectParameterSize) = error as? CryptoKitError else {
+                        XCTFail("Unexpected error: \(error)")
+                        return
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,166 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class AEADNonceSequenceTests: XCTestCase {
+    let message = Array("Some message to seal with a nonce sequence".utf8)
+
+    func testNoncesArePrefixThenCounter() throws {
+        let prepared = try AES.GCM._PreparedKey(SymmetricKey(size: .bits256))
+        // Start just below the point where the counter carries into its upper 32 bits.
+        let nonces = _AEADNonceSequence(prefix: 0x0102_0304, counter: 0xff_ffff_fffe)
+
+        let nonceBytes = try (0..<3).map { _ in Array(try prepared.seal(message, nonces: nonces).nonce) }
+        XCTAssertEqual(nonceBytes, [
+            [0x01, 0x02, 0x03, 0x04, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xfe],
+            [0x01, 0x02, 0x03, 0x04, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff],
+            [0x01, 0x02, 0x03, 0x04, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00],
+        ])
+        XCTAssertEqual(nonces.counter, 0x100_0000_0001)
+    }
+
+    func testSealedBoxesOpenWithOneShot() throws {
+        let key = SymmetricKey(size: .bits256)
+        let aesNonces = _AEADNonceSequence()
+        let chachaNonces = _AEADNonceSequence()
+        let aesKey = try AES.GCM._PreparedKey(key)
+        let chachaKey = try ChaChaPoly._PreparedKey(key)
+        let authenticatedData = Array("Some authenticated data".utf8)
+
+        var seen = Set<Data>()
+        for _ in 0..<100 {
+            let aesBox = try aesKey.seal(message, nonces: aesNonces, authenticating: authenticatedData)
+            XCTAssertEqual(try AES.GCM.open(aesBox, using: key, authenticating: authenticatedData), Data(message))
+            XCTAssertTrue(seen.insert(Data(aesBox.nonce)).inserted)
+
+            let chachaBox = try chachaKey.seal(message, nonces: chachaNonces)
+            XCTAssertEqual(try ChaChaPoly.open(chachaBox, using: key), Data(message))
+        }
+        XCTAssertEqual(aesNonces.counter, 100)
+        XCTAssertEqual(Set(seen.map { $0.prefix(4) }).count, 1)
+    }
+
+    func testSealIntoBufferReturnsNonce() throws {
+        let prepared = try ChaChaPoly._PreparedKey(SymmetricKey(size: .bits256))
+        let nonces = _AEADNonceSequence()
+
+        var buffer = message + [UInt8](repeating: 0, count: 16)
+        let plaintext = try buffer.withUnsafeMutableBytes { buffer -> [UInt8] in
+            let input = UnsafeRawBufferPointer(rebasing: buffer.prefix(message.count))
+            let nonce = try prepared.seal(input, into: buffer, nonces: nonces, authenticating: [UInt8]())
+            return Array(try prepared.open(inPlace: buffer, nonce: nonce, authenticating: [UInt8]()))
+        }
+        XCTAssertEqual(plaintext, message)
+    }
+
+    func testLimitIsEnforced() throws {
+        let prepared = try AES.GCM._PreparedKey(SymmetricKey(size: .bits128))
+        let nonces = _AEADNonceSequence(limit: 2)
+        XCTAssertEqual(nonces.remaining, 2)
+
+        _ = try prepared.seal(message, nonces: nonces)
+        _ = try prepared.seal(message, nonces: nonces)
+        XCTAssertEqual(nonces.remaining, 0)
+        XCTAssertThrowsError(try prepared.seal(message, nonces: nonces)) { error in
+            guard case .some(.exhausted) = error as? _AEADNonceSequenceError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+
+        // A key takes a single sequence, so the exhausted one starting at the end gets a key of its own.
+        let atEnd = _AEADNonceSequence(prefix: 0, counter: .max, limit: .max)
+        let unused = try AES.GCM._PreparedKey(SymmetricKey(size: .bits128))
+        XCTAssertThrowsError(try unused.seal(message, nonces: atEnd)) { error in
+            guard case .some(.exhausted) = error as? _AEADNonceSequenceError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+    }
+
+    func testSequenceIsBoundToItsKey() throws {
+        let first = try AES.GCM._PreparedKey(SymmetricKey(size: .bits256))
+        let second = try AES.GCM._PreparedKey(SymmetricKey(size: .bits256))
+        let nonces = _AEADNonceSequence()
+
+        _ = try first.seal(message, nonces: nonces)
+        XCTAssertThrowsError(try second.seal(message, nonces: nonces)) { error in
+            guard case .some(.boundToDifferentKey) = error as? _AEADNonceSequenceError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+        XCTAssertEqual(nonces.counter, 1)
+
+        // Copies of a prepared key share its context, so they share the binding too.
+        let copy = first
+        XCTAssertNoThrow(try copy.seal(message, nonces: nonces))
+    }
+
+    func testKeyIsBoundToItsSequence() throws {
+        let prepared = try ChaChaPoly._PreparedKey(SymmetricKey(size: .bits256))
+        let nonces = _AEADNonceSequence()
+        let other = _AEADNonceSequence()
+
+        _ = try prepared.seal(message, nonces: nonces)
+        XCTAssertThrowsError(try prepared.seal(message, nonces: other)) { error in
+            guard case .some(.keyBoundToDifferentSequence) = error as? _AEADNonceSequenceError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+        XCTAssertEqual(other.counter, 0)
+
+        // A rejected sequence stays unbound, so it can still serve a fresh key.
+        let fresh = try ChaChaPoly._PreparedKey(SymmetricKey(size: .bits256))
+        XCTAssertNoThrow(try fresh.seal(message, nonces: other))
+    }
+
+    func testEveryHolderDrawsFromOneCounter() throws {
+        let prepared = try AES.GCM._PreparedKey(SymmetricKey(size: .bits128))
+        let nonces = _AEADNonceSequence()
+        let alias = nonces
+
+        func sealTwice(_ nonces: _AEADNonceSequence) throws -> [Data] {
+            try (0..<2).map { _ in Data(try prepared.seal(message, nonces: nonces).nonce) }
+        }
+        let first = try sealTwice(nonces)
+        let second = try sealTwice(alias)
+        XCTAssertEqual(Set(first + second).count, 4)
+        XCTAssertEqual(nonces.counter, 4)
+    }
+
+    func testConcurrentSealsNeverRepeatANonce() throws {
+        let prepared = try AES.GCM._PreparedKey(SymmetricKey(size: .bits256))
+        let nonces = _AEADNonceSequence()
+        let lock = NSLock()
+        var seen = Set<Data>()
+
+        DispatchQueue.concurrentPerform(iterations: 8) { _ in
+            for _ in 0..<100 {
+                let nonce = Data(try! prepared.seal(message, nonces: nonces).nonce)
+                lock.lock()
+                seen.insert(nonce)
+                lock.unlock()
+            }
+        }
+        XCTAssertEqual(seen.count, 800)
+        XCTAssertEqual(nonces.counter, 800)
+    }
+}
@@ -0,0 +1,117 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class AEADPreparedKeyCacheTests: XCTestCase {
+    func testCachedKeysInteroperateWithOneShot() throws {
+        let aesCache = AES.GCM._PreparedKeyCache<String>(capacity: 4, shards: 2)
+        let chachaCache = ChaChaPoly._PreparedKeyCache<String>(capacity: 4, shards: 2)
+        let key = SymmetricKey(size: .bits256)
+        let message = Array("cached key".utf8)
+
+        let aes = try aesCache.key(for: "a") { key }
+        XCTAssertEqual(try AES.GCM.open(aes.seal(message), using: key), Data(message))
+        let chacha = try chachaCache.key(for: "a") { key }
+        XCTAssertEqual(try ChaChaPoly.open(chacha.seal(message), using: key), Data(message))
+    }
+
+    func testHitsDoNotReloadTheKey() throws {
+        let cache = AES.GCM._PreparedKeyCache<Int>(capacity: 8, shards: 4)
+        var loads = 0
+        for _ in 0..<10 {
+            _ = try cache.key(for: 7) {
+                loads += 1
+                return SymmetricKey(size: .bits128)
+            }
+        }
+        XCTAssertEqual(loads, 1)
+        let statistics = cache.statistics
+        XCTAssertEqual(statistics.keyCount, 1)
+        XCTAssertEqual(statistics.hits, 9)
+        XCTAssertEqual(statistics.misses, 1)
+    }
+
+    func testLeastRecentlyUsedKeyIsEvicted() throws {
+        // A single shard makes the eviction order deterministic.
+        let cache = AES.GCM._PreparedKeyCache<Int>(capacity: 2, shards: 1)
+        var loaded: [Int] = []
+        func use(_ id: Int) throws {
+            _ = try cache.key(for: id) {
+                loaded.append(id)
+                return SymmetricKey(size: .bits128)
+            }
+        }
+
+        try use(1)
+        try use(2)
+        try use(1)
+        try use(3)
+        try use(1)
+        try use(2)
+        XCTAssertEqual(loaded, [1, 2, 3, 2])
+        XCTAssertEqual(cache.statistics.evictions, 2)
+        XCTAssertEqual(cache.statistics.keyCount, 2)
+    }
+
+    func testRemoval() throws {
+        let cache = ChaChaPoly._PreparedKeyCache<Int>(capacity: 16)
+        for id in 0..<10 {
+            _ = try cache.key(for: id) { SymmetricKey(size: .bits256) }
+        }
+        cache.removeKey(for: 3)
+        XCTAssertEqual(cache.statistics.keyCount, 9)
+        cache.removeAll()
+        XCTAssertEqual(cache.statistics.keyCount, 0)
+
+        var reloaded = false
+        _ = try cache.key(for: 3) {
+            reloaded = true
+            return SymmetricKey(size: .bits256)
+        }
+        XCTAssertTrue(reloaded)
+    }
+
+    func testLoadErrorsArePropagatedAndNotCached() throws {
+        struct LoadError: Error {}
+        let cache = AES.GCM._PreparedKeyCache<Int>()
+        XCTAssertThrowsError(try cache.key(for: 1) { throw LoadError() }) { error in
+            XCTAssertTrue(error is LoadError)
+        }
+        XCTAssertThrowsError(try cache.key(for: 1) { SymmetricKey(size: .init(bitCount: 100)) })
+        XCTAssertEqual(cache.statistics.keyCount, 0)
+    }
+
+    func testCapacityIsRoundedUpToTheShardCount() {
+        XCTAssertEqual(AES.GCM._PreparedKeyCache<Int>(capacity: 10, shards: 4).statistics.capacity, 12)
+        XCTAssertEqual(AES.GCM._PreparedKeyCache<Int>(capacity: 2, shards: 16).statistics.capacity, 2)
+    }
+
+    func testConcurrentUseStaysWithinCapacity() throws {
+        let cache = AES.GCM._PreparedKeyCache<Int>(capacity: 64, shards: 8)
+        let keys = (0..<256).map { _ in SymmetricKey(size: .bits128) }
+        let message = Array("concurrent".utf8)
+        DispatchQueue.concurrentPerform(iterations: 8) { thread in
+            for round in 0..<500 {
+                let id = (thread * 31 + round * 7) % keys.count
+                let prepared = try! cache.key(for: id) { keys[id] }
+                XCTAssertEqual(try AES.GCM.open(prepared.seal(message), using: keys[id]), Data(message))
+            }
+        }
+        XCTAssertLessThanOrEqual(cache.statistics.keyCount, cache.statistics.capacity)
+    }
+}
@@ -0,0 +1,148 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class AEADPreparedKeyTests: XCTestCase {
+    let message = Array("Some message to seal with a prepared key".utf8)
+    let authenticatedData = Array("Some authenticated data".utf8)
+
+    func testAESGCMPreparedKeyInteroperatesWithOneShot() throws {
+        for size in [SymmetricKeySize.bits128, .bits192, .bits256] {
+            let key = SymmetricKey(size: size)
+            let prepared = try AES.GCM._PreparedKey(key)
+            let nonce = AES.GCM.Nonce()
+
+            let sealed = try prepared.seal(message, nonce: nonce, authenticating: authenticatedData)
+            let expected = try AES.GCM.seal(message, using: key, nonce: nonce, authenticating: authenticatedData)
+            XCTAssertEqual(sealed.combined, expected.combined)
+
+            XCTAssertEqual(try prepared.open(expected, authenticating: authenticatedData), Data(message))
+            XCTAssertEqual(try AES.GCM.open(prepared.seal(message), using: key), Data(message))
+            XCTAssertThrowsError(try prepared.open(sealed))
+        }
+    }
+
+    func testChaChaPolyPreparedKeyInteroperatesWithOneShot() throws {
+        let key = SymmetricKey(size: .bits256)
+        let prepared = try ChaChaPoly._PreparedKey(key)
+        let nonce = ChaChaPoly.Nonce()
+
+        let sealed = try prepared.seal(message, nonce: nonce, authenticating: authenticatedData)
+        let expected = try ChaChaPoly.seal(message, using: key, nonce: nonce, authenticating: authenticatedData)
+        XCTAssertEqual(sealed.combined, expected.combined)
+
+        XCTAssertEqual(try prepared.open(expected, authenticating: authenticatedData), Data(message))
+        XCTAssertEqual(try ChaChaPoly.open(prepared.seal(message), using: key), Data(message))
+        XCTAssertThrowsError(try prepared.open(sealed))
+    }
+
+    func testPreparedKeyInPlaceRoundTrip() throws {
+        let prepared = try AES.GCM._PreparedKey(SymmetricKey(size: .bits256))
+        let nonce = AES.GCM.Nonce()
+
+        var buffer = message + [UInt8](repeating: 0, count: 16)
+        let plaintext = try buffer.withUnsafeMutableBytes { buffer -> [UInt8] in
+            try prepared.seal(UnsafeRawBufferPointer(rebasing: buffer.prefix(message.count)), into: buffer, nonce: nonce, authenticating: authenticatedData)
+            return Array(try prepared.open(inPlace: buffer, nonce: nonce, authenticating: authenticatedData))
+        }
+        XCTAssertEqual(plaintext, message)
+    }
+
+    func testPreparedKeyRejectsInvalidKeySizes() {
+        XCTAssertThrowsError(try AES.GCM._PreparedKey(SymmetricKey(size: SymmetricKeySize(bitCount: 64))))
+        XCTAssertThrowsError(try ChaChaPoly._PreparedKey(SymmetricKey(size: .bits128)))
+    }
+
+    func testPreparedKeyIsUsableConcurrently() throws {
+        let key = SymmetricKey(size: .bits256)
+        let prepared = try AES.GCM._PreparedKey(key)
+        let message = self.message
+
+        DispatchQueue.concurrentPerform(iterations: 16) { _ in
+            let sealed = try! prepared.seal(message)
+            XCTAssertEqual(try! AES.GCM.open(sealed, using: key), Data(message))
+        }
+    }
+
+    func testReplicatedPreparedKeysWorkFromManyThreads() throws {
+        let key = SymmetricKey(size: .bits256)
+        let gcm = try AES.GCM._PreparedKey(key, replicatedPerNode: true)
+        let chaCha = try ChaChaPoly._PreparedKey(key, replicatedPerNode: true)
+        let message = self.message
+        let failures = NSLock()
+        var failureCount = 0
+
+        DispatchQueue.concurrentPerform(iterations: 64) { _ in
+            do {
+                let sealedGCM = try gcm.seal(message)
+                let sealedChaCha = try chaCha.seal(message)
+                guard try AES.GCM.open(sealedGCM, using: key) == Data(message),
+                      try ChaChaPoly.open(sealedChaCha, using: key) == Data(message),
+                      try gcm.open(AES.GCM.seal(message, using: key)) == Data(message) else {
+                    throw CryptoKitError.authenticationFailure
+                }
+            } catch {
+                failures.lock()
+                failureCount += 1
+                failures.unlock()
+            }
+        }
+        XCTAssertEqual(failureCount, 0)
+    }
+
+    func testConcurrentSealMatchesSerial() throws {
+        let key = SymmetricKey(size: .bits256)
+        let prepared = try AES.GCM._PreparedKey(key)
+        let nonce = AES.GCM.Nonce()
+        // Not a multiple of the block size, so the last segment ends in a partial block.
+        let messageByteCount = OpenSSLAEADPreparedKey.minimumConcurrentMessageByteCount + 12345
+        let message = (0..<messageByteCount).map { UInt8(truncatingIfNeeded: $0 &* 7) }
+
+        var serial = [UInt8](repeating: 0, count: messageByteCount + 16)
+        var concurrent = serial
+        try message.withUnsafeBytes { message in
+            try serial.withUnsafeMutableBytes {
+                try prepared.seal(message, into: $0, nonce: nonce, authenticating: authenticatedData)
+            }
+            try concurrent.withUnsafeMutableBytes {
+                try prepared.seal(message, into: $0, nonce: nonce, authenticating: authenticatedData, concurrently: true)
+            }
+        }
+        XCTAssertEqual(serial, concurrent)
+
+        var opened = concurrent
+        let plaintext = try opened.withUnsafeMutableBytes {
+            Array(try prepared.open(inPlace: $0, nonce: nonce, authenticating: authenticatedData, concurrently: true))
+        }
+        XCTAssertEqual(plaintext, message)
+
+        var tampered = concurrent
+        tampered[messageByteCount / 2] ^= 1
+        tampered.withUnsafeMutableBytes { buffer in
+            XCTAssertThrowsError(try prepared.open(inPlace: buffer, nonce: nonce, authenticating: authenticatedData, concurrently: true))
+        }
+        XCTAssertTrue(tampered.prefix(messageByteCount).allSatisfy { $0 == 0 })
+    }
+
+    func testConcurrentSegmentSizes() {
+        XCTAssertNil(OpenSSLAEADPreparedKey.concurrentSegmentByteCount(messageByteCount: 1 << 20))
+        if let segmentByteCount = OpenSSLAEADPreparedKey.concurrentSegmentByteCount(messageByteCount: 1 << 30) {
+            XCTAssertEqual(segmentByteCount % 16, 0)
+            XCTAssertGreaterThanOrEqual(segmentByteCount, 1 << 20)
+        }
+    }
+}
@@ -0,0 +1,116 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class AEADStreamingTests: XCTestCase {
+    func testAESGCMStreamMatchesOneShotSeal() throws {
+        let key = SymmetricKey(size: .bits256)
+        let nonce = AES.GCM.Nonce()
+        let message = Data((0..<10_000).map { UInt8(truncatingIfNeeded: $0) })
+        let authenticatedData = Data("header".utf8)
+
+        // Uneven pieces, including an empty one, cover partial blocks carried between calls.
+        let sealer = try AES.GCM._makeStreamingSealer(using: key, nonce: nonce, authenticating: authenticatedData)
+        var ciphertext = Data()
+        var offset = 0
+        for length in [1, 15, 0, 17, 4096, 5000, 871] {
+            ciphertext += try sealer.update(message[offset..<(offset + length)])
+            offset += length
+        }
+        XCTAssertEqual(offset, message.count)
+        let tag = try sealer.finish()
+
+        let sealedBox = try AES.GCM.seal(message, using: key, nonce: nonce, authenticating: authenticatedData)
+        XCTAssertEqual(ciphertext, sealedBox.ciphertext)
+        XCTAssertEqual(tag, sealedBox.tag)
+
+        let opener = try AES.GCM._makeUnverifiedStreamingOpener(using: key, nonce: nonce, authenticating: authenticatedData)
+        var plaintext = try opener.update(ciphertext.prefix(3000))
+        plaintext += try opener.update(ciphertext.dropFirst(3000))
+        try opener.finish(tag: tag)
+        XCTAssertEqual(plaintext, message)
+    }
+
+    func testChaChaPolyStreamMatchesOneShotSeal() throws {
+        let key = SymmetricKey(size: .bits256)
+        let nonce = ChaChaPoly.Nonce()
+        let message = Data(repeating: 0x5a, count: 1000)
+
+        let sealer = try ChaChaPoly._makeStreamingSealer(using: key, nonce: nonce)
+        var ciphertext = Data(count: message.count)
+        try message.withUnsafeBytes { message in
+            try ciphertext.withUnsafeMutableBytes { ciphertext in
+                try sealer.update(UnsafeRawBufferPointer(rebasing: message[..<63]), into: UnsafeMutableRawBufferPointer(rebasing: ciphertext[..<63]))
+                try sealer.update(UnsafeRawBufferPointer(rebasing: message[63...]), into: UnsafeMutableRawBufferPointer(rebasing: ciphertext[63...]))
+            }
+        }
+        let tag = try sealer.finish()
+
+        let sealedBox = try ChaChaPoly.seal(message, using: key, nonce: nonce)
+        XCTAssertEqual(ciphertext, sealedBox.ciphertext)
+        XCTAssertEqual(tag, sealedBox.tag)
+
+        // Decrypting in place.
+        let opener = try ChaChaPoly._makeUnverifiedStreamingOpener(using: key, nonce: nonce)
+        var buffer = ciphertext
+        try buffer.withUnsafeMutableBytes { buffer in
+            try opener.update(UnsafeRawBufferPointer(buffer), into: buffer)
+        }
+        try opener.finish(tag: tag)
+        XCTAssertEqual(buffer, message)
+    }
+
+    func testTamperedStreamFailsToFinish() throws {
+        let key = SymmetricKey(size: .bits128)
+        let nonce = AES.GCM.Nonce()
+        let sealedBox = try AES.GCM.seal(Data("attack at dawn".utf8), using: key, nonce: nonce, authenticating: Data("ad".utf8))
+
+        var ciphertext = sealedBox.ciphertext
+        ciphertext[0] ^= 1
+        let opener = try AES.GCM._makeUnverifiedStreamingOpener(using: key, nonce: nonce, authenticating: Data("ad".utf8))
+        _ = try opener.update(ciphertext)
+        XCTAssertThrowsError(try opener.finish(tag: sealedBox.tag)) { error in
+            XCTAssertEqual(error as? CryptoKitError, .authenticationFailure)
+        }
+
+        let wrongData = try AES.GCM._makeUnverifiedStreamingOpener(using: key, nonce: nonce, authenticating: Data("da".utf8))
+        _ = try wrongData.update(sealedBox.ciphertext)
+        XCTAssertThrowsError(try wrongData.finish(tag: sealedBox.tag))
+    }
+
+    func testFinishedStreamCannotBeReused() throws {
+        let sealer = try AES.GCM._makeStreamingSealer(using: SymmetricKey(size: .bits256), nonce: AES.GCM.Nonce())
+        _ = try sealer.update(Data([1, 2, 3]))
+        _ = try sealer.finish()
+        XCTAssertThrowsError(try sealer.update(Data([4]))) { error in
+            guard case _StreamingAEADError.alreadyFinished = error else {
+                return XCTFail("Unexpected error \(error)")
+            }
+        }
+        XCTAssertThrowsError(try sealer.finish())
+    }
+
+    func testMismatchedBufferIsRejected() throws {
+        let sealer = try AES.GCM._makeStreamingSealer(using: SymmetricKey(size: .bits256), nonce: AES.GCM.Nonce())
+        let input = [UInt8](repeating: 0, count: 4)
+        var output = [UInt8](repeating: 0, count: 5)
+        XCTAssertThrowsError(try input.withUnsafeBytes { input in
+            try output.withUnsafeMutableBytes { try sealer.update(input, into: $0) }
+        })
+    }
+}
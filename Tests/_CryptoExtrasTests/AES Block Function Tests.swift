@@ -227,6 +227,39 @@ final class AESBlockFunctionTests: XCTestCase {
             XCTAssertThrowsError(try AES.inversePermute(&block, key: key))
         }
     }
+
+    func test128BitBatchPermute() throws {
+        let key = SymmetricKey(
+            data: try! Array(hexString: "2b7e151628aed2a6abf7158809cf4f3c")
+        )
+        let plaintext = Self.nistPlaintextChunks.flatMap { $0 }
+        let ciphertext = try Array(hexString: """
+        3ad77bb40d7a3660a89ecaf32466ef97\
+        f5d3d58503b9699de785895a96fdbaaf\
+        43b1cd7f598ece23881b00e3ed030688\
+        7b0c785e27e8ad3f8223207104725dd4
+        """)
+
+        // Fast-path
+        var blocks = plaintext
+        try AES._permuteBlocks(&blocks, key: key)
+        XCTAssertEqual(blocks, ciphertext)
+        try AES._inversePermuteBlocks(&blocks, key: key)
+        XCTAssertEqual(blocks, plaintext)
+
+        // Slow-path
+        var block = Block(wrapped: plaintext[...])
+        try AES._permuteBlocks(&block, key: key)
+        XCTAssertEqual(Array(block.wrapped), ciphertext)
+        try AES._inversePermuteBlocks(&block, key: key)
+        XCTAssertEqual(Array(block.wrapped), plaintext)
+
+        // An empty batch is fine, but a partial block is not.
+        var empty = [UInt8]()
+        XCTAssertNoThrow(try AES._permuteBlocks(&empty, key: key))
+        var partial = Array(plaintext.dropLast())
+        XCTAssertThrowsError(try AES._permuteBlocks(&partial, key: key))
+    }
 }
 
 // We use this for testing. Specifically, there's a slow path in the code
@@ -74,6 +74,29 @@ final class AESGCMSIVTests: XCTestCase {
         XCTAssertEqual(recoveredPlaintextWithoutAAD, plaintext)
     }
 
+    func testPreparedKeyInteroperatesWithOneShotAPI() throws {
+        let key = SymmetricKey(size: .bits256)
+        let preparedKey = try AES.GCM._SIV._PreparedKey(key)
+        let aad = Data("column".utf8)
+
+        for length in [0, 1, 16, 100] {
+            let plaintext = Data(repeating: UInt8(length), count: length)
+            let nonce = AES.GCM._SIV.Nonce()
+
+            let prepared = try preparedKey.seal(plaintext, nonce: nonce, authenticating: aad)
+            let oneShot = try AES.GCM._SIV.seal(plaintext, using: key, nonce: nonce, authenticating: aad)
+            XCTAssertEqual(prepared.combined, oneShot.combined)
+
+            XCTAssertEqual(try preparedKey.open(oneShot, authenticating: aad), plaintext)
+            XCTAssertEqual(try AES.GCM._SIV.open(prepared, using: key, authenticating: aad), plaintext)
+            XCTAssertThrowsError(try preparedKey.open(prepared))
+        }
+
+        let sealed = try preparedKey.seal(Data("no aad".utf8))
+        XCTAssertEqual(try preparedKey.open(sealed), Data("no aad".utf8))
+        XCTAssertThrowsError(try AES.GCM._SIV._PreparedKey(SymmetricKey(size: .bits192)).seal(Data()))
+    }
+
     func testExtractingBytesFromNonce() throws {
         let nonce = AES.GCM._SIV.Nonce()
         XCTAssertEqual(Array(nonce), nonce.withUnsafeBytes { Array($0) })
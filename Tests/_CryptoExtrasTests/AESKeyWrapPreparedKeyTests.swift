@@ -0,0 +1,108 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class AESKeyWrapPreparedKeyTests: XCTestCase {
+    func testRFC3394Vectors() throws {
+        // RFC 3394, sections 4.1, 4.3, and 4.6.
+        let vectors: [(kek: String, key: String, wrapped: String)] = [
+            (
+                "000102030405060708090A0B0C0D0E0F",
+                "00112233445566778899AABBCCDDEEFF",
+                "1FA68B0A8112B447AEF34BD8FB5A7B829D3E862371D2CFE5"
+            ),
+            (
+                "000102030405060708090A0B0C0D0E0F1011121314151617",
+                "00112233445566778899AABBCCDDEEFF0001020304050607",
+                "031D33264E15D33268F24EC260743EDCE1C6C7DDEE725A936BA814915C6762D2"
+            ),
+            (
+                "000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F",
+                "00112233445566778899AABBCCDDEEFF000102030405060708090A0B0C0D0E0F",
+                "28C9F404C4B810F4CBCCB35CFB87F8263F5786E2D80ED326CBC7F0E71A99F43BFB988B9B7A02DD21"
+            ),
+        ]
+
+        for vector in vectors {
+            let preparedKey = try AES.KeyWrap._PreparedKey(SymmetricKey(data: try Array(hexString: vector.kek)))
+            let key = SymmetricKey(data: try Array(hexString: vector.key))
+            let wrapped = try Array(hexString: vector.wrapped)
+
+            XCTAssertEqual(Array(try preparedKey.wrap(key)), wrapped)
+            XCTAssertEqual(try preparedKey.unwrap(wrapped), key)
+        }
+    }
+
+    func testBatchMatchesOneShot() throws {
+        let kek = SymmetricKey(size: .bits256)
+        let preparedKey = try AES.KeyWrap._PreparedKey(kek)
+
+        // Mixed sizes, and more keys than the implementation interleaves at once.
+        let keys = (0..<100).map { i in
+            SymmetricKey(data: [UInt8]((0..<(16 + 8 * (i % 6))).map { UInt8(truncatingIfNeeded: $0 &* 7 &+ i) }))
+        }
+
+        let wrapped = try preparedKey.wrap(batch: keys)
+        XCTAssertEqual(wrapped.count, keys.count)
+        for (key, wrappedKey) in zip(keys, wrapped) {
+            XCTAssertEqual(wrappedKey, try AES.KeyWrap.wrap(key, using: kek))
+        }
+
+        let unwrapped = preparedKey.unwrap(batch: wrapped)
+        XCTAssertEqual(unwrapped, keys.map { Optional($0) })
+        XCTAssertEqual(try preparedKey.wrap(batch: []).count, 0)
+    }
+
+    func testBatchUnwrapReportsEachFailure() throws {
+        let preparedKey = try AES.KeyWrap._PreparedKey(SymmetricKey(size: .bits128))
+        let keys = (0..<5).map { _ in SymmetricKey(size: .bits256) }
+        var wrapped = try preparedKey.wrap(batch: keys)
+
+        // One key is tampered with, and one is too short to be a wrapped key.
+        wrapped[1][wrapped[1].startIndex + 3] ^= 1
+        wrapped[3] = Data(repeating: 0, count: 16)
+
+        let unwrapped = preparedKey.unwrap(batch: wrapped)
+        XCTAssertEqual(unwrapped[0], keys[0])
+        XCTAssertNil(unwrapped[1])
+        XCTAssertEqual(unwrapped[2], keys[2])
+        XCTAssertNil(unwrapped[3])
+        XCTAssertEqual(unwrapped[4], keys[4])
+
+        XCTAssertThrowsError(try preparedKey.unwrap(wrapped[1]))
+    }
+
+    func testRejectsInvalidSizes() throws {
+        XCTAssertThrowsError(try AES.KeyWrap._PreparedKey(SymmetricKey(size: .init(bitCount: 136)))) { error in
+            guard case .some(.incorrectKeySize) = error as? CryptoKitError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+
+        let preparedKey = try AES.KeyWrap._PreparedKey(SymmetricKey(size: .bits256))
+        let badKeys = [SymmetricKey(size: .bits128), SymmetricKey(data: [UInt8](repeating: 0, count: 20))]
+        XCTAssertThrowsError(try preparedKey.wrap(batch: badKeys)) { error in
+            guard case .some(.incorrectKeySize) = error as? CryptoKitError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+        XCTAssertThrowsError(try preparedKey.wrap(SymmetricKey(data: [UInt8](repeating: 0, count: 8))))
+    }
+}
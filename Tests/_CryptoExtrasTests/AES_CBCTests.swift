@@ -158,6 +158,31 @@ final class CBCTests: XCTestCase {
             }
         }
     }
+
+    func testDecryptRejectsPartialBlocks() throws {
+        let key = try Data(hexString: "b6fc08df9b778d11850356b8bfc9561a")
+        let iv = try AES._CBC.IV(ivBytes: Array(hexString: "00000000000000000000000000000000"))
+        let input = try Data(hexString: "6741b46d1390dac577e3236b")
+        for noPadding in [true, false] {
+            XCTAssertThrowsError(try AES._CBC.decrypt(input, using: SymmetricKey(data: key), iv: iv, noPadding: noPadding)) { error in
+                guard let error = error as? CryptoKitError, case .incorrectParameterSize = error else {
+                    XCTFail("Unexpected error: \(error)")
+                    return
+                }
+            }
+        }
+    }
+
+    func testRoundTripsMultipleBlocks() throws {
+        let key = SymmetricKey(size: .bits256)
+        let iv = AES._CBC.IV()
+        for count in [0, 1, 15, 16, 17, 255, 256, 1000] {
+            let message = Data((0..<count).map { UInt8(truncatingIfNeeded: $0) })
+            let ciphertext = try AES._CBC.encrypt(message, using: key, iv: iv)
+            XCTAssertEqual(ciphertext.count, (count / 16 + 1) * 16)
+            XCTAssertEqual(try AES._CBC.decrypt(ciphertext, using: key, iv: iv), message)
+        }
+    }
 }
 
 
@@ -0,0 +1,112 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class AES_CCMTests: XCTestCase {
+    func testRFC3610PacketVector1() throws {
+        let key = SymmetricKey(data: try Array(hexString: "c0c1c2c3c4c5c6c7c8c9cacbcccdcecf"))
+        let nonce = try AES._CCM.Nonce(data: try Array(hexString: "00000003020100a0a1a2a3a4a5"))
+        let aad = try Array(hexString: "0001020304050607")
+        let plaintext = try Array(hexString: "08090a0b0c0d0e0f101112131415161718191a1b1c1d1e")
+
+        let box = try AES._CCM.seal(plaintext, using: key, nonce: nonce, authenticating: aad, tagByteCount: 8)
+        XCTAssertEqual(Array(box.ciphertext), try Array(hexString: "588c979a61c663d2f066d0c2c0f989806d5f6b61dac384"))
+        XCTAssertEqual(Array(box.tag), try Array(hexString: "17e8d12cfdf926e0"))
+        XCTAssertEqual(Array(try AES._CCM.open(box, using: key, authenticating: aad)), plaintext)
+    }
+
+    func testSP800_38CExamples() throws {
+        // NIST SP 800-38C, appendix C.1 and C.2: short nonces and short tags.
+        let key = try AES._CCM.PreparedKey(SymmetricKey(data: try Array(hexString: "404142434445464748494a4b4c4d4e4f")))
+        let vectors: [(nonce: String, aad: String, plaintext: String, tagByteCount: Int, sealed: String)] = [
+            ("10111213141516", "0001020304050607", "20212223", 4, "7162015b4dac255d"),
+            ("1011121314151617", "000102030405060708090a0b0c0d0e0f", "202122232425262728292a2b2c2d2e2f", 6,
+             "d2a1f0e051ea5f62081a7792073d593d1fc64fbfaccd"),
+        ]
+        for vector in vectors {
+            let nonce = try AES._CCM.Nonce(data: try Array(hexString: vector.nonce))
+            let aad = try Array(hexString: vector.aad)
+            let box = try key.seal(try Array(hexString: vector.plaintext), nonce: nonce, authenticating: aad, tagByteCount: vector.tagByteCount)
+            XCTAssertEqual(Array(box.ciphertext + box.tag), try Array(hexString: vector.sealed))
+            XCTAssertEqual(Array(try key.open(box, authenticating: aad)), try Array(hexString: vector.plaintext))
+        }
+    }
+
+    func testRoundTripAcrossLengths() throws {
+        // Lengths around the block size exercise both the stitched loop and the partial final block.
+        for bits in [SymmetricKeySize.bits128, .bits192, .bits256] {
+            let key = try AES._CCM.PreparedKey(SymmetricKey(size: bits))
+            for byteCount in [0, 1, 15, 16, 17, 31, 32, 33, 100, 1024] {
+                let message = [UInt8]((0..<byteCount).map { UInt8(truncatingIfNeeded: $0 &* 7) })
+                let box = try key.seal(message, authenticating: [1, 2, 3])
+                XCTAssertEqual(box.ciphertext.count, byteCount)
+                XCTAssertEqual(box.tag.count, 16)
+                XCTAssertEqual(Array(try key.open(box, authenticating: [1, 2, 3])), message)
+            }
+        }
+    }
+
+    func testCombinedRepresentation() throws {
+        let key = SymmetricKey(size: .bits128)
+        let box = try AES._CCM.seal(Array("hello, world".utf8), using: key, tagByteCount: 8)
+        let split = try AES._CCM.SealedBox(combined: box.combined, nonceByteCount: 13, tagByteCount: 8)
+        XCTAssertEqual(Array(try AES._CCM.open(split, using: key)), Array("hello, world".utf8))
+    }
+
+    func testTamperingIsDetected() throws {
+        let key = try AES._CCM.PreparedKey(SymmetricKey(size: .bits128))
+        let box = try key.seal(Array(repeating: UInt8(0x42), count: 40), authenticating: [9], tagByteCount: 4)
+
+        var ciphertext = box.ciphertext
+        ciphertext[ciphertext.startIndex + 20] ^= 1
+        let tampered = try AES._CCM.SealedBox(nonce: box.nonce, ciphertext: ciphertext, tag: box.tag)
+        for (candidate, aad) in [(tampered, [UInt8(9)]), (box, [UInt8(8)])] {
+            XCTAssertThrowsError(try key.open(candidate, authenticating: aad)) { error in
+                guard case .some(.authenticationFailure) = error as? CryptoKitError else {
+                    XCTFail("Unexpected error: \(error)")
+                    return
+                }
+            }
+        }
+    }
+
+    func testInvalidParameters() throws {
+        XCTAssertThrowsError(try AES._CCM.Nonce(data: [UInt8](repeating: 0, count: 6)))
+        XCTAssertThrowsError(try AES._CCM.Nonce(data: [UInt8](repeating: 0, count: 14)))
+
+        let key = try AES._CCM.PreparedKey(SymmetricKey(size: .bits128))
+        for tagByteCount in [0, 2, 5, 18] {
+            XCTAssertThrowsError(try key.seal([1, 2, 3], tagByteCount: tagByteCount)) { error in
+                guard case .some(.invalidParameter) = error as? CryptoKitError else {
+                    XCTFail("Unexpected error: \(error)")
+                    return
+                }
+            }
+        }
+
+        // A 13-byte nonce leaves a two-byte length field.
+        let nonce = try AES._CCM.Nonce(data: [UInt8](repeating: 0, count: 13))
+        XCTAssertThrowsError(try key.seal([UInt8](repeating: 0, count: 1 << 16), nonce: nonce)) { error in
+            guard case .some(.incorrectParameterSize) = error as? CryptoKitError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+        XCTAssertThrowsError(try AES._CCM.PreparedKey(SymmetricKey(size: SymmetricKeySize(bitCount: 64))))
+    }
+}
@@ -156,4 +156,47 @@ final class AESCTRTests: XCTestCase {
             }
         }
     }
+
+    func testStreamMatchesOneShotForAnyChunking() throws {
+        let key = SymmetricKey(size: .bits256)
+        let nonce = AES._CTR.Nonce()
+        let plaintext = Array((0..<1000).map { UInt8(truncatingIfNeeded: $0) })
+        let expected = try AES._CTR.encrypt(plaintext, using: key, nonce: nonce)
+
+        for chunkSize in [1, 7, 15, 16, 17, 64, 333] {
+            let stream = try AES._CTR._Stream(key: key, nonce: nonce)
+            var ciphertext = Data()
+            var offset = 0
+            while offset < plaintext.count {
+                let end = min(offset + chunkSize, plaintext.count)
+                ciphertext.append(stream.encrypt(plaintext[offset..<end]))
+                offset = end
+            }
+            XCTAssertEqual(ciphertext, expected, "chunk size \(chunkSize)")
+        }
+    }
+
+    func testStreamInPlace() throws {
+        let key = SymmetricKey(size: .bits128)
+        let nonce = AES._CTR.Nonce()
+        let expected = try AES._CTR.encrypt(Self.plaintextBytes, using: key, nonce: nonce)
+
+        var buffer = Self.plaintextBytes
+        let encryptor = try AES._CTR._Stream(key: key, nonce: nonce)
+        buffer.withUnsafeMutableBytes { bufferPtr in
+            encryptor.encrypt(inPlace: UnsafeMutableRawBufferPointer(rebasing: bufferPtr[..<5]))
+            encryptor.encrypt(inPlace: UnsafeMutableRawBufferPointer(rebasing: bufferPtr[5...]))
+        }
+        XCTAssertEqual(Data(buffer), expected)
+
+        let decryptor = try AES._CTR._Stream(key: key, nonce: nonce)
+        buffer.withUnsafeMutableBytes { decryptor.decrypt(inPlace: $0) }
+        XCTAssertEqual(buffer, Self.plaintextBytes)
+    }
+
+    func testStreamRejectsInvalidKeySizes() {
+        XCTAssertThrowsError(try AES._CTR._Stream(key: SymmetricKey(size: SymmetricKeySize(bitCount: 64)), nonce: AES._CTR.Nonce())) { error in
+            guard case CryptoKitError.incorrectKeySize = error else { return XCTFail("Error thrown was of unexpected type: \(error)") }
+        }
+    }
 }
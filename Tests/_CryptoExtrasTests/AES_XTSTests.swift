@@ -0,0 +1,135 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class AES_XTSTests: XCTestCase {
+    // IEEE 1619-2007, appendix B, vectors 4 and 10: 512-byte data units of 00 01 ... ff 00 01 ... ff.
+    static let vector4Key = "2718281828459045235360287471352631415926535897932384626433832795"
+    static let vector4Ciphertext = "27a7479befa1d476489f308cd4cfa6e2a96e4bbe3208ff25287dd3819616e89cc78cf7f5e543445f8333d8fa7f56000005279fa5d8b5e4ad40e736ddb4d35412328063fd2aab53e5ea1e0a9f332500a5df9487d07a5c92cc512c8866c7e860ce93fdf166a24912b422976146ae20ce846bb7dc9ba94a767aaef20c0d61ad02655ea92dc4c4e41a8952c651d33174be51a10c421110e6d81588ede82103a252d8a750e8768defffed9122810aaeb99f9172af82b604dc4b8e51bcb08235a6f4341332e4ca60482a4ba1a03b3e65008fc5da76b70bf1690db4eae29c5f1badd03c5ccf2a55d705ddcd86d449511ceb7ec30bf12b1fa35b913f9f747a8afd1b130e94bff94effd01a91735ca1726acd0b197c4e5b03393697e126826fb6bbde8ecc1e08298516e2c9ed03ff3c1b7860f6de76d4cecd94c8119855ef5297ca67e9f3e7ff72b1e99785ca0a7e7720c5b36dc6d72cac9574c8cbbc2f801e23e56fd344b07f22154beba0f08ce8891e643ed995c94d9a69c9f1b5f499027a78572aeebd74d20cc39881c213ee770b1010e4bea718846977ae119f7a023ab58cca0ad752afe656bb3c17256a9f6e9bf19fdd5a38fc82bbe872c5539edb609ef4f79c203ebb140f2e583cb2ad15b4aa5b655016a8449277dbd477ef2c8d6c017db738b18deb4a427d1923ce3ff262735779a418f20a282df920147beabe421ee5319d0568"
+    static let vector10Key = "27182818284590452353602874713526624977572470936999595749669676273141592653589793238462643383279502884197169399375105820974944592"
+    static let vector10Ciphertext = "1c3b3a102f770386e4836c99e370cf9bea00803f5e482357a4ae12d414a3e63b5d31e276f8fe4a8d66b317f9ac683f44680a86ac35adfc3345befecb4bb188fd5776926c49a3095eb108fd1098baec70aaa66999a72a82f27d848b21d4a741b0c5cd4d5fff9dac89aeba122961d03a757123e9870f8acf1000020887891429ca2a3e7a7d7df7b10355165c8b9a6d0a7de8b062c4500dc4cd120c0f7418dae3d0b5781c34803fa75421c790dfe1de1834f280d7667b327f6c8cd7557e12ac3a0f93ec05c52e0493ef31a12d3d9260f79a289d6a379bc70c50841473d1a8cc81ec583e9645e07b8d9670655ba5bbcfecc6dc3966380ad8fecb17b6ba02469a020a84e18e8f84252070c13e9f1f289be54fbc481457778f616015e1327a02b140f1505eb309326d68378f8374595c849d84f4c333ec4423885143cb47bd71c5edae9be69a2ffeceb1bec9de244fbe15992b11b77c040f12bd8f6a975a44a0f90c29a9abc3d4d893927284c58754cce294529f8614dcd2aba991925fedc4ae74ffac6e333b93eb4aff0479da9a410e4450e0dd7ae4c6e2910900575da401fc07059f645e8b7e9bfdef33943054ff84011493c27b3429eaedb4ed5376441a77ed43851ad77f16f541dfd269d50d6a5f14fb0aab1cbb4c1550be97f7ab4066193c4caa773dad38014bd2092fa755c824bb5e54c4f36ffda9fcea70b9c6e693e148c151"
+    static let counting = [UInt8]((0..<512).map { UInt8(truncatingIfNeeded: $0) })
+
+    func testIEEE1619Vectors() throws {
+        let vectors: [(key: String, sector: UInt64, ciphertext: String)] = [
+            (Self.vector4Key, 0, Self.vector4Ciphertext),
+            (Self.vector10Key, 0xff, Self.vector10Ciphertext),
+        ]
+        for vector in vectors {
+            let key = SymmetricKey(data: try Array(hexString: vector.key))
+            let tweak = AES._XTS.Tweak(sectorNumber: vector.sector)
+            let ciphertext = try AES._XTS.encrypt(Self.counting, using: key, tweak: tweak)
+            XCTAssertEqual(Array(ciphertext), try Array(hexString: vector.ciphertext))
+            XCTAssertEqual(Array(try AES._XTS.decrypt(ciphertext, using: key, tweak: tweak)), Self.counting)
+        }
+    }
+
+    func testCiphertextStealingVectors() throws {
+        // IEEE 1619-2007, appendix B, vectors 15 and 18: 17 and 20 bytes.
+        let key = try AES._XTS.PreparedKey(SymmetricKey(data: try Array(hexString: "fffefdfcfbfaf9f8f7f6f5f4f3f2f1f0bfbebdbcbbbab9b8b7b6b5b4b3b2b1b0")))
+        let tweak = try AES._XTS.Tweak(data: try Array(hexString: "9a785634120000000000000000000000"))
+        for ciphertext in ["6c1625db4671522d3d7599601de7ca09ed", "9d84c813f719aa2c7be3f66171c7c5c2edbf9dac"] {
+            let expected = try Array(hexString: ciphertext)
+            let plaintext = Array(Self.counting.prefix(expected.count))
+            XCTAssertEqual(Array(try key.encrypt(plaintext, tweak: tweak)), expected)
+            XCTAssertEqual(Array(try key.decrypt(expected, tweak: tweak)), plaintext)
+        }
+    }
+
+    func testSectorsMatchSingleDataUnits() throws {
+        for (hexKey, sectorByteCount) in [(Self.vector4Key, 512), (Self.vector10Key, 4096), (Self.vector10Key, 100)] {
+            let key = try AES._XTS.PreparedKey(SymmetricKey(data: try Array(hexString: hexKey)))
+            let plaintext = [UInt8]((0..<(sectorByteCount * 5)).map { UInt8(truncatingIfNeeded: $0 &* 13) })
+            let ciphertext = try key.encryptSectors(plaintext, sectorByteCount: sectorByteCount, startingAt: 41)
+
+            for sector in 0..<5 {
+                let range = (sector * sectorByteCount)..<((sector + 1) * sectorByteCount)
+                let expected = try key.encrypt(plaintext[range], tweak: AES._XTS.Tweak(sectorNumber: 41 + UInt64(sector)))
+                XCTAssertEqual(ciphertext[range], expected)
+            }
+            XCTAssertEqual(Array(try key.decryptSectors(ciphertext, sectorByteCount: sectorByteCount, startingAt: 41)), plaintext)
+
+            var buffer = plaintext
+            try buffer.withUnsafeMutableBytes {
+                try key.encryptSectors(inPlace: $0, sectorByteCount: sectorByteCount, startingAt: 41)
+            }
+            XCTAssertEqual(Data(buffer), ciphertext)
+            try buffer.withUnsafeMutableBytes {
+                try key.decryptSectors(inPlace: $0, sectorByteCount: sectorByteCount, startingAt: 41)
+            }
+            XCTAssertEqual(buffer, plaintext)
+        }
+
+        let key = try AES._XTS.PreparedKey(SymmetricKey(data: try Array(hexString: Self.vector4Key)))
+        let sectors = try key.encryptSectors(Self.counting + Self.counting, sectorByteCount: 512, startingAt: 0)
+        XCTAssertEqual(Array(sectors.prefix(512)), try Array(hexString: Self.vector4Ciphertext))
+    }
+
+    func testRoundTripAcrossLengths() throws {
+        // Lengths around multiples of eight and sixteen blocks reach every kernel's tail handling.
+        for bits in [256, 512] {
+            let key = try AES._XTS.PreparedKey(SymmetricKey(size: SymmetricKeySize(bitCount: bits)))
+            let tweak = AES._XTS.Tweak(sectorNumber: 7)
+            for byteCount in [16, 17, 31, 32, 127, 128, 129, 255, 256, 257, 271, 4096, 4111] {
+                let message = [UInt8]((0..<byteCount).map { UInt8(truncatingIfNeeded: $0 &* 7) })
+                let ciphertext = try key.encrypt(message, tweak: tweak)
+                XCTAssertEqual(ciphertext.count, byteCount)
+                XCTAssertNotEqual(Array(ciphertext), message)
+                XCTAssertEqual(Array(try key.decrypt(ciphertext, tweak: tweak)), message)
+            }
+        }
+    }
+
+    func testInvalidParameters() throws {
+        XCTAssertThrowsError(try AES._XTS.PreparedKey(SymmetricKey(size: .bits128))) { error in
+            guard case .some(.incorrectKeySize) = error as? CryptoKitError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+        // IEEE 1619 requires the data key and the tweak key to differ.
+        XCTAssertThrowsError(try AES._XTS.PreparedKey(SymmetricKey(data: [UInt8](repeating: 1, count: 64)))) { error in
+            guard case .some(.invalidParameter) = error as? CryptoKitError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+        XCTAssertThrowsError(try AES._XTS.Tweak(data: [UInt8](repeating: 0, count: 15)))
+
+        let key = try AES._XTS.PreparedKey(SymmetricKey(size: .bits256))
+        XCTAssertThrowsError(try key.encrypt([UInt8](repeating: 0, count: 15), tweak: AES._XTS.Tweak(sectorNumber: 0))) { error in
+            guard case .some(.incorrectParameterSize) = error as? CryptoKitError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+        XCTAssertThrowsError(try key.encryptSectors([UInt8](repeating: 0, count: 1000), sectorByteCount: 512, startingAt: 0)) { error in
+            guard case .some(.incorrectParameterSize) = error as? CryptoKitError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+        XCTAssertThrowsError(try key.encryptSectors([UInt8](repeating: 0, count: 1024), sectorByteCount: 512, startingAt: .max)) { error in
+            guard case .some(.invalidParameter) = error as? CryptoKitError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+        XCTAssertEqual(try key.encryptSectors([UInt8](repeating: 0, count: 512), sectorByteCount: 512, startingAt: .max).count, 512)
+    }
+}
@@ -0,0 +1,48 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class AllocatorStatisticsTests: XCTestCase {
+    func testStatisticsMatchConfiguration() throws {
+        guard _CryptoAllocatorStatistics.isEnabled else {
+            XCTAssertTrue(_CryptoAllocatorStatistics.sizeClasses.isEmpty)
+            return
+        }
+
+        let before = _CryptoAllocatorStatistics.sizeClasses
+        XCTAssertEqual(before.last?.blockByteCount, nil)
+        let blockByteCounts = before.dropLast().compactMap { $0.blockByteCount }
+        XCTAssertEqual(blockByteCounts.count, before.count - 1)
+        XCTAssertEqual(blockByteCounts, blockByteCounts.sorted())
+
+        let key = P256.Signing.PrivateKey()
+        for _ in 0..<16 {
+            _ = try key.signature(for: Data("hello".utf8))
+        }
+
+        let after = _CryptoAllocatorStatistics.sizeClasses
+        XCTAssertEqual(before.count, after.count)
+        let allocationsBefore = before.reduce(0) { $0 + $1.allocations }
+        let allocationsAfter = after.reduce(0) { $0 + $1.allocations }
+        XCTAssertGreaterThan(allocationsAfter, allocationsBefore)
+        for sizeClass in after {
+            XCTAssertLessThanOrEqual(sizeClass.frees, sizeClass.allocations)
+            XCTAssertLessThanOrEqual(sizeClass.cachedAllocations, sizeClass.allocations)
+        }
+    }
+}
@@ -0,0 +1,54 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class AutotuningTests: XCTestCase {
+    func testDecisionIsCached() throws {
+        let cacheFile = FileManager.default.temporaryDirectory.appendingPathComponent("autotune-\(UUID()).json")
+        defer {
+            try? FileManager.default.removeItem(at: cacheFile)
+        }
+
+        let measured = _CryptoAutotuner.tune(cacheFile: cacheFile)
+        XCTAssertFalse(measured.isCached)
+        for measurement in measured.measurements {
+            XCTAssertTrue(measured.removedCapabilities.isSuperset(of: measurement.removedCapabilities))
+            XCTAssertLessThanOrEqual(measurement.tunedNanoseconds, measurement.defaultNanoseconds)
+        }
+
+        // Tuning removed capabilities, so the cache key changes unless nothing was removed.
+        let second = _CryptoAutotuner.tune(cacheFile: cacheFile)
+        XCTAssertEqual(second.cpuModel, measured.cpuModel)
+        if measured.removedCapabilities.isEmpty {
+            XCTAssertTrue(second.isCached)
+            XCTAssertEqual(second.removedCapabilities, [])
+        }
+    }
+
+    func testTuningKeepsResultsCorrect() throws {
+        _CryptoAutotuner.tune()
+        let key = SymmetricKey(size: .bits256)
+        let message = Data("tuned".utf8)
+        XCTAssertEqual(try AES.GCM.open(AES.GCM.seal(message, using: key), using: key), message)
+        XCTAssertEqual(try ChaChaPoly.open(ChaChaPoly.seal(message, using: key), using: key), message)
+        XCTAssertEqual(
+            Array(SHA256.hash(data: Array("abc".utf8))),
+            Array(Data(base64Encoded: "ungWv48Bz+pBQUDeXa4iI7ADYaOWF3qctBD/YfIAFa0=")!)
+        )
+    }
+}
@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class BLAKE2bTests: XCTestCase {
+    func testBLAKE2b512() throws {
+        XCTAssertEqual(
+            Array(_BLAKE2b512.hash(data: Data())),
+            try Array(hexString: "786a02f742015903c6c6fd852552d272912f4740e15847618a86e217f71f5419d25e1031afee585313896444934eb04b903a685b1448b755d56f701afe9be2ce")
+        )
+        XCTAssertEqual(
+            Array(_BLAKE2b512.hash(data: Array("abc".utf8))),
+            try Array(hexString: "ba80a53f981c4d0d6a2797b69f12f6e94c212f14685ac4b74b12bb6fdbffa2d17d87c5392aab792dc252d5de4533cc9518d38aa8dbf1925ab92386edd4009923")
+        )
+    }
+
+    func testBLAKE2b256() throws {
+        XCTAssertEqual(
+            Array(_BLAKE2b256.hash(data: Array("abc".utf8))),
+            try Array(hexString: "bddd813c634239723171ef3fee98579b94964e3bb1cb3e427262c8c068d52319")
+        )
+    }
+
+    func testKeyed() throws {
+        // RFC 7693 reference test vectors: key 00 01 ... 3f.
+        let key = SymmetricKey(data: Array(UInt8(0)..<64))
+        var hasher = try _BLAKE2b512(key: key)
+        XCTAssertEqual(
+            Array(hasher.finalize()),
+            try Array(hexString: "10ebb67700b1868efb4417987acf4690ae9d972fb7a590c2f02871799aaa4786b5e996e8f0f4eb981fc214b005f42d2ff4233499391653df7aefcbc13fc51568")
+        )
+        hasher.update(data: [0x00])
+        XCTAssertEqual(
+            Array(hasher.finalize()),
+            try Array(hexString: "961f6dd1e4dd30f63901690c512e78e4b45e4742ed197c3c5e45c549fd25f2e4187b0bc9fe30492b16b0d0bc4ef9b0f34c7003fac09a5ef1532e69430234cebd")
+        )
+
+        var short = try _BLAKE2b256(key: SymmetricKey(data: Array(UInt8(0)..<32)))
+        short.update(data: Array("abc".utf8))
+        XCTAssertEqual(
+            Array(short.finalize()),
+            try Array(hexString: "d63a32d3e44738d7907f964316c241adaba0abfeabc32349677578a15a203f7f")
+        )
+    }
+
+    func testVariableOutputLength() throws {
+        // 512 bytes spans several blocks; feed it in uneven pieces.
+        let message = Array(repeating: Array(UInt8(0)...UInt8(255)), count: 2).flatMap { $0 }
+        var hasher = try _BLAKE2b(outputByteCount: 20)
+        hasher.update(data: message[..<1])
+        hasher.update(data: message[1..<128])
+        hasher.update(data: message[128..<257])
+        hasher.update(data: message[257...])
+        XCTAssertEqual(hasher.outputByteCount, 20)
+        XCTAssertEqual(
+            Array(hasher.finalize()),
+            try Array(hexString: "e1695d971d2357c55fe6824cf175e915700ea2f2")
+        )
+        XCTAssertEqual(hasher.finalize(), try _BLAKE2b.hash(data: message, outputByteCount: 20))
+
+        // The digest length is bound into the state, so a 32-byte digest is not a prefix of a 64-byte one.
+        XCTAssertEqual(try _BLAKE2b.hash(data: message, outputByteCount: 32), Data(_BLAKE2b256.hash(data: message)))
+        XCTAssertNotEqual(try _BLAKE2b.hash(data: message).prefix(32), Data(_BLAKE2b256.hash(data: message)))
+    }
+
+    func testInvalidParameters() throws {
+        for outputByteCount in [0, 65] {
+            XCTAssertThrowsError(try _BLAKE2b(outputByteCount: outputByteCount)) { error in
+                guard case .some(.incorrectParameterSize) = error as? CryptoKitError else {
+                    XCTFail("Unexpected error: \(error)")
+                    return
+                }
+            }
+        }
+        XCTAssertThrowsError(try _BLAKE2b512(key: SymmetricKey(data: [UInt8](repeating: 0, count: 65)))) { error in
+            guard case .some(.incorrectKeySize) = error as? CryptoKitError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+    }
+}
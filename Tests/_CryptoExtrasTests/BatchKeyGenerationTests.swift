@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class BatchKeyGenerationTests: XCTestCase {
+    func testP256KeyPairsMatch() throws {
+        // More than one chunk, and not a multiple of the chunk size.
+        let count = 70
+        var privateKeys = [UInt8](repeating: 0, count: count * 32)
+        var publicKeys = [UInt8](repeating: 0, count: count * 65)
+        try privateKeys.withUnsafeMutableBytes { privateKeys in
+            try publicKeys.withUnsafeMutableBytes { publicKeys in
+                try P256._generateKeyPairs(privateKeys: privateKeys, publicKeys: publicKeys)
+            }
+        }
+
+        var seen = Set<[UInt8]>()
+        for i in 0..<count {
+            let scalar = privateKeys[(i * 32)..<((i + 1) * 32)]
+            let point = publicKeys[(i * 65)..<((i + 1) * 65)]
+            let key = try P256.Signing.PrivateKey(rawRepresentation: scalar)
+            XCTAssertEqual(key.publicKey.x963Representation, Data(point))
+            XCTAssertTrue(seen.insert(Array(scalar)).inserted)
+        }
+    }
+
+    func testEd25519KeyPairsMatch() throws {
+        let count = 10
+        var seeds = [UInt8](repeating: 0, count: count * 32)
+        var publicKeys = [UInt8](repeating: 0, count: count * 32)
+        try seeds.withUnsafeMutableBytes { seeds in
+            try publicKeys.withUnsafeMutableBytes { publicKeys in
+                try Curve25519.Signing._generateKeyPairs(seeds: seeds, publicKeys: publicKeys)
+            }
+        }
+
+        for i in 0..<count {
+            let key = try Curve25519.Signing.PrivateKey(rawRepresentation: seeds[(i * 32)..<((i + 1) * 32)])
+            XCTAssertEqual(key.publicKey.rawRepresentation, Data(publicKeys[(i * 32)..<((i + 1) * 32)]))
+        }
+    }
+
+    func testMismatchedBuffersAreRejected() throws {
+        var privateKeys = [UInt8](repeating: 0, count: 64)
+        var publicKeys = [UInt8](repeating: 0, count: 65)
+        privateKeys.withUnsafeMutableBytes { privateKeys in
+            publicKeys.withUnsafeMutableBytes { publicKeys in
+                XCTAssertThrowsError(try P256._generateKeyPairs(privateKeys: privateKeys, publicKeys: publicKeys)) { error in
+                    guard case .some(.incorrectParameterSize) = error as? CryptoKitError else {
+                        XCTFail("Unexpected error: \(error)")
+                        return
+                    }
+                }
+                XCTAssertThrowsError(try Curve25519.Signing._generateKeyPairs(seeds: privateKeys, publicKeys: publicKeys)) { error in
+                    guard case .some(.incorrectParameterSize) = error as? CryptoKitError else {
+                        XCTFail("Unexpected error: \(error)")
+                        return
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,41 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class BulkRandomBytesTests: XCTestCase {
+    func testSizes() {
+        for count in [0, 1, 15, 16, 17, 4096, (1 << 20) + 17] {
+            XCTAssertEqual(_CryptoRandom._bulkRandomBytes(count: count).count, count)
+        }
+    }
+
+    func testOutputsDiffer() {
+        let first = _CryptoRandom._bulkRandomBytes(count: 64)
+        let second = _CryptoRandom._bulkRandomBytes(count: 64)
+        XCTAssertNotEqual(first, second)
+        XCTAssertNotEqual(first, Data(repeating: 0, count: 64))
+    }
+
+    func testChunksAreIndependent() {
+        // Each rekey interval draws a new key and counter, so consecutive chunks should not repeat.
+        let chunk = 1 << 20
+        let bytes = _CryptoRandom._bulkRandomBytes(count: 2 * chunk)
+        XCTAssertNotEqual(bytes.prefix(64), bytes.dropFirst(chunk).prefix(64))
+        XCTAssertFalse(bytes.suffix(4096).allSatisfy { $0 == 0 })
+    }
+}
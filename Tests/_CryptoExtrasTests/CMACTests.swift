@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class CMACTests: XCTestCase {
+    let message = "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e5130c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710"
+
+    func testRFC4493Vectors() throws {
+        let key = try _AESCMAC.PreparedKey(SymmetricKey(data: try Array(hexString: "2b7e151628aed2a6abf7158809cf4f3c")))
+        let message = try Array(hexString: self.message)
+        let vectors: [(byteCount: Int, tag: String)] = [
+            (0, "bb1d6929e95937287fa37d129b756746"),
+            (16, "070a16b46b4d4144f79bdd9dd04a287c"),
+            (40, "dfa66747de9ae63030ca32611497c827"),
+            (64, "51f0bebf7e3b9d92fc49741779363cfe"),
+        ]
+        for vector in vectors {
+            let tag = _AESCMAC.authenticationCode(for: message.prefix(vector.byteCount), using: key)
+            XCTAssertEqual(Array(tag), try Array(hexString: vector.tag))
+        }
+    }
+
+    func testSP800_38BLongerKeys() throws {
+        // NIST SP 800-38B, appendix D.2 and D.3.
+        let vectors: [(key: String, byteCount: Int, tag: String)] = [
+            ("8e73b0f7da0e6452c810f32b809079e562f8ead2522c6b7b", 0, "d17ddf46adaacde531cac483de7a9367"),
+            ("8e73b0f7da0e6452c810f32b809079e562f8ead2522c6b7b", 16, "9e99a7bf31e710900662f65e617c5184"),
+            ("603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4", 0, "028962f61b7bf89efc6b551f4667d983"),
+            ("603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4", 16, "28a7023f452e8f82bd4bf28d8c37c35c"),
+        ]
+        let message = try Array(hexString: self.message)
+        for vector in vectors {
+            let key = try _AESCMAC.PreparedKey(SymmetricKey(data: try Array(hexString: vector.key)))
+            let tag = _AESCMAC.authenticationCode(for: message.prefix(vector.byteCount), using: key)
+            XCTAssertEqual(Array(tag), try Array(hexString: vector.tag))
+        }
+    }
+
+    func testStreamingMatchesOneShot() throws {
+        let key = try _AESCMAC.PreparedKey(SymmetricKey(size: .bits256))
+        // Cover messages that end on and off a block boundary, and bulk runs longer than one CBC call.
+        for byteCount in [15, 16, 32, 1000, 1024] {
+            let data = [UInt8]((0..<byteCount).map { UInt8(truncatingIfNeeded: $0 &* 11) })
+            let expected = _AESCMAC.authenticationCode(for: data, using: key)
+
+            for chunkByteCount in [1, 16, 17, 600] {
+                var cmac = _AESCMAC(key: key)
+                var offset = 0
+                while offset < data.count {
+                    let end = min(offset + chunkByteCount, data.count)
+                    cmac.update(data: data[offset..<end])
+                    offset = end
+                }
+                XCTAssertEqual(cmac.finalize(), expected)
+                XCTAssertEqual(cmac.finalize(), expected)
+            }
+        }
+    }
+
+    func testValidation() throws {
+        let key = try _AESCMAC.PreparedKey(SymmetricKey(size: .bits128))
+        let data = Array("Some payment message".utf8)
+        var tag = Array(_AESCMAC.authenticationCode(for: data, using: key))
+
+        XCTAssertTrue(_AESCMAC.isValidAuthenticationCode(tag, authenticating: data, using: key))
+        XCTAssertFalse(_AESCMAC.isValidAuthenticationCode(tag.prefix(8), authenticating: data, using: key))
+        tag[15] ^= 1
+        XCTAssertFalse(_AESCMAC.isValidAuthenticationCode(tag, authenticating: data, using: key))
+    }
+
+    func testRejectsInvalidKeySizes() throws {
+        XCTAssertThrowsError(try _AESCMAC.PreparedKey(SymmetricKey(size: .init(bitCount: 64)))) { error in
+            guard case .some(.incorrectKeySize) = error as? CryptoKitError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+    }
+}
@@ -0,0 +1,156 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class CacheBudgetTests: XCTestCase {
+    // What a prepared AEAD key is charged at.
+    let keyByteCount = 768
+
+    private func fill(_ cache: AES.GCM._PreparedKeyCache<Int>, keys: Range<Int>) throws {
+        for keyID in keys {
+            _ = try cache.key(for: keyID) { SymmetricKey(size: .bits128) }
+        }
+    }
+
+    func testCachesStayWithinTheLimit() throws {
+        let budget = _CryptoCacheBudget(byteLimit: 10 * self.keyByteCount)
+        let cache = AES.GCM._PreparedKeyCache<Int>(shards: 1, budget: budget)
+        try self.fill(cache, keys: 0..<50)
+
+        XCTAssertEqual(cache.statistics.keyCount, 10)
+        XCTAssertEqual(cache.statistics.evictions, 0)
+        let statistics = budget.statistics
+        XCTAssertEqual(statistics.byteCount, 10 * self.keyByteCount)
+        XCTAssertEqual(statistics.caches.count, 1)
+        XCTAssertEqual(statistics.caches[0].name, "AES.GCM._PreparedKeyCache")
+        XCTAssertEqual(statistics.caches[0].budgetEvictions, 40)
+        XCTAssertEqual(statistics.caches[0].budgetEvictedBytes, UInt64(40 * self.keyByteCount))
+
+        // The most recently used keys are the ones kept.
+        var reloaded = false
+        _ = try cache.key(for: 49) {
+            reloaded = true
+            return SymmetricKey(size: .bits128)
+        }
+        XCTAssertFalse(reloaded)
+    }
+
+    func testLimitIsSharedByWeight() throws {
+        let budget = _CryptoCacheBudget(byteLimit: 40 * self.keyByteCount)
+        let light = AES.GCM._PreparedKeyCache<Int>(shards: 1, budget: budget, budgetWeight: 1)
+        let heavy = AES.GCM._PreparedKeyCache<Int>(shards: 1, budget: budget, budgetWeight: 3)
+        for keyID in 0..<100 {
+            try self.fill(light, keys: keyID..<(keyID + 1))
+            try self.fill(heavy, keys: keyID..<(keyID + 1))
+        }
+
+        XCTAssertEqual(light.statistics.keyCount, 10)
+        XCTAssertEqual(heavy.statistics.keyCount, 30)
+        XCTAssertEqual(budget.statistics.byteCount, 40 * self.keyByteCount)
+    }
+
+    func testUnusedShareIsHandedOn() throws {
+        let budget = _CryptoCacheBudget(byteLimit: 40 * self.keyByteCount)
+        let small = AES.GCM._PreparedKeyCache<Int>(shards: 1, budget: budget)
+        let large = ChaChaPoly._PreparedKeyCache<Int>(shards: 1, budget: budget)
+        try self.fill(small, keys: 0..<4)
+        for keyID in 0..<100 {
+            _ = try large.key(for: keyID) { SymmetricKey(size: .bits256) }
+        }
+
+        XCTAssertEqual(small.statistics.keyCount, 4)
+        XCTAssertEqual(large.statistics.keyCount, 36)
+    }
+
+    func testCapacityStillApplies() throws {
+        let budget = _CryptoCacheBudget(byteLimit: 1000 * self.keyByteCount)
+        let cache = AES.GCM._PreparedKeyCache<Int>(capacity: 8, shards: 1, budget: budget)
+        try self.fill(cache, keys: 0..<20)
+
+        XCTAssertEqual(cache.statistics.evictions, 12)
+        XCTAssertEqual(budget.statistics.byteCount, 8 * self.keyByteCount)
+        XCTAssertEqual(budget.statistics.caches[0].budgetEvictions, 0)
+    }
+
+    func testMemoryPressure() throws {
+        let budget = _CryptoCacheBudget(byteLimit: 1000 * self.keyByteCount)
+        let cache = AES.GCM._PreparedKeyCache<Int>(shards: 1, budget: budget)
+        try self.fill(cache, keys: 0..<20)
+
+        let received = LockedBox<[_CryptoCacheBudget.MemoryPressure]>([])
+        budget.addMemoryPressureHandler { pressure in
+            received.withValue { $0.append(pressure) }
+        }
+
+        budget.handleMemoryPressure(.warning)
+        XCTAssertEqual(cache.statistics.keyCount, 10)
+        XCTAssertEqual(budget.statistics.byteCount, 10 * self.keyByteCount)
+
+        budget.handleMemoryPressure(.critical)
+        XCTAssertEqual(cache.statistics.keyCount, 0)
+        XCTAssertEqual(budget.statistics.byteCount, 0)
+        XCTAssertEqual(budget.statistics.caches[0].pressureEvictions, 20)
+        XCTAssertEqual(received.withValue { $0 }, [.warning, .critical])
+    }
+
+    func testLoweringTheLimitTrims() throws {
+        let budget = _CryptoCacheBudget(byteLimit: 1000 * self.keyByteCount)
+        let cache = AES.GCM._PreparedKeyCache<Int>(shards: 1, budget: budget)
+        try self.fill(cache, keys: 0..<20)
+
+        budget.byteLimit = 5 * self.keyByteCount
+        XCTAssertEqual(cache.statistics.keyCount, 5)
+        XCTAssertEqual(budget.statistics.byteCount, 5 * self.keyByteCount)
+    }
+
+    func testReleasedCachesLeaveTheBudget() throws {
+        let budget = _CryptoCacheBudget(byteLimit: 1000 * self.keyByteCount)
+        var cache: AES.GCM._PreparedKeyCache<Int>? = AES.GCM._PreparedKeyCache<Int>(budget: budget)
+        try self.fill(cache!, keys: 0..<20)
+        let others = _StaticSharedSecretCache(budget: budget)
+        XCTAssertEqual(budget.statistics.caches.map(\.name), ["AES.GCM._PreparedKeyCache", "_StaticSharedSecretCache"])
+
+        cache = nil
+        XCTAssertEqual(budget.statistics.caches.map(\.name), ["_StaticSharedSecretCache"])
+        XCTAssertEqual(budget.statistics.byteCount, 0)
+        withExtendedLifetime(others) {}
+    }
+
+    func testUnbudgetedCachesAreNotCharged() throws {
+        let before = _CryptoCacheBudget.shared.statistics.caches.count
+        let cache = AES.GCM._PreparedKeyCache<Int>(budget: nil)
+        try self.fill(cache, keys: 0..<4)
+        XCTAssertEqual(_CryptoCacheBudget.shared.statistics.caches.count, before)
+    }
+}
+
+private final class LockedBox<Value>: @unchecked Sendable {
+    private let lock = NSLock()
+    private var value: Value
+
+    init(_ value: Value) {
+        self.value = value
+    }
+
+    func withValue<Result>(_ body: (inout Value) -> Result) -> Result {
+        self.lock.lock()
+        defer {
+            self.lock.unlock()
+        }
+        return body(&self.value)
+    }
+}
@@ -96,4 +96,71 @@ class ChaCha20CTRTests: XCTestCase {
         let ciphertext4 = try Insecure.ChaCha20CTR.encrypt(Array<UInt8>(repeating: 0, count: 5), using: key, counter: counter, nonce: Insecure.ChaCha20CTR.Nonce())
         XCTAssertNotEqual(ciphertext3, ciphertext4)
     }
+
+    func testStreamMatchesOneShotForAnyChunking() throws {
+        let key = SymmetricKey(size: .bits256)
+        let nonce = Insecure.ChaCha20CTR.Nonce()
+        let counter = try Insecure.ChaCha20CTR.Counter(offset: 7)
+        let plaintext = Array((0..<1000).map { UInt8(truncatingIfNeeded: $0) })
+        let expected = try Insecure.ChaCha20CTR.encrypt(plaintext, using: key, counter: counter, nonce: nonce)
+
+        for chunkSize in [1, 13, 63, 64, 65, 128, 333] {
+            let stream = try Insecure.ChaCha20CTR._Stream(key: key, counter: counter, nonce: nonce)
+            var ciphertext = Data()
+            var offset = 0
+            while offset < plaintext.count {
+                let end = min(offset + chunkSize, plaintext.count)
+                try ciphertext.append(stream.encrypt(plaintext[offset..<end]))
+                offset = end
+            }
+            XCTAssertEqual(ciphertext, expected, "chunk size \(chunkSize)")
+        }
+    }
+
+    func testStreamInPlace() throws {
+        let key = SymmetricKey(size: .bits256)
+        let nonce = Insecure.ChaCha20CTR.Nonce()
+        let plaintext = Array(repeating: UInt8(0x5a), count: 200)
+        let expected = try Insecure.ChaCha20CTR.encrypt(plaintext, using: key, nonce: nonce)
+
+        var buffer = plaintext
+        let stream = try Insecure.ChaCha20CTR._Stream(key: key, nonce: nonce)
+        try buffer.withUnsafeMutableBytes { bufferPtr in
+            try stream.encrypt(inPlace: UnsafeMutableRawBufferPointer(rebasing: bufferPtr[..<100]))
+            try stream.encrypt(inPlace: UnsafeMutableRawBufferPointer(rebasing: bufferPtr[100...]))
+        }
+        XCTAssertEqual(Data(buffer), expected)
+    }
+
+    func testStreamRefusesToWrapTheCounter() throws {
+        let key = SymmetricKey(size: .bits256)
+        let stream = try Insecure.ChaCha20CTR._Stream(key: key, counter: Insecure.ChaCha20CTR.Counter(offset: UInt32.max), nonce: Insecure.ChaCha20CTR.Nonce())
+
+        // The last block is available, in pieces, and nothing after it.
+        XCTAssertNoThrow(try stream.encrypt(Array(repeating: UInt8(0), count: 10)))
+        XCTAssertNoThrow(try stream.encrypt(Array(repeating: UInt8(0), count: 54)))
+        XCTAssertThrowsError(try stream.encrypt([UInt8(0)])) { error in
+            guard case CryptoKitError.invalidParameter = error else { return XCTFail("Error thrown was of unexpected type: \(error)") }
+        }
+    }
+
+    func testLongMessagesMatchBlockByBlockKeystream() throws {
+        // Long inputs take the sixteen-block path where the CPU has one. Each 64-byte block must match the
+        // keystream generated for that counter alone, including across the 1 KiB boundaries and the tail.
+        let key = SymmetricKey(size: .bits256)
+        let nonce = Insecure.ChaCha20CTR.Nonce()
+        let zeros = Array(repeating: UInt8(0), count: 3 * 1024 + 100)
+        let keystream = try Insecure.ChaCha20CTR.encrypt(zeros, using: key, counter: Insecure.ChaCha20CTR.Counter(offset: 5), nonce: nonce)
+
+        for block in stride(from: 0, to: zeros.count, by: 64) {
+            let length = min(64, zeros.count - block)
+            let expected = try Insecure.ChaCha20CTR.encrypt(
+                zeros[..<length],
+                using: key,
+                counter: Insecure.ChaCha20CTR.Counter(offset: 5 + UInt32(block / 64)),
+                nonce: nonce
+            )
+            XCTAssertEqual(Data(keystream[block..<(block + length)]), expected, "block \(block / 64)")
+        }
+    }
 }
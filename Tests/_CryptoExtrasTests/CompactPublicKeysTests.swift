@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class CompactPublicKeysTests: XCTestCase {
+    func testP256MatchesPublicKey() throws {
+        let privateKey = P256.Signing.PrivateKey()
+        let compact = P256.Signing._CompactPublicKey(privateKey.publicKey)
+        XCTAssertEqual(MemoryLayout<P256.Signing._CompactPublicKey>.size, 64)
+        XCTAssertEqual(compact.rawRepresentation, privateKey.publicKey.rawRepresentation)
+        XCTAssertEqual(compact.x963Representation, privateKey.publicKey.x963Representation)
+        XCTAssertEqual(compact.publicKey.rawRepresentation, privateKey.publicKey.rawRepresentation)
+        XCTAssertEqual(try P256.Signing._CompactPublicKey(x963Representation: privateKey.publicKey.x963Representation), compact)
+
+        let message = Data("hello".utf8)
+        let signature = try privateKey.signature(for: message)
+        XCTAssertTrue(compact.isValidSignature(signature, for: message))
+        XCTAssertTrue(compact.isValidSignature(signature, for: SHA256.hash(data: message)))
+        XCTAssertFalse(compact.isValidSignature(signature, for: Data("hellp".utf8)))
+        XCTAssertFalse(P256.Signing._CompactPublicKey(P256.Signing.PrivateKey().publicKey).isValidSignature(signature, for: message))
+    }
+
+    func testP384MatchesPublicKey() throws {
+        let privateKey = P384.Signing.PrivateKey()
+        let compact = try P384.Signing._CompactPublicKey(rawRepresentation: privateKey.publicKey.rawRepresentation)
+        XCTAssertEqual(MemoryLayout<P384.Signing._CompactPublicKey>.size, 96)
+        XCTAssertEqual(compact.x963Representation, privateKey.publicKey.x963Representation)
+
+        let message = Data("hello".utf8)
+        let signature = try privateKey.signature(for: message)
+        XCTAssertTrue(compact.isValidSignature(signature, for: message))
+        // Other digests are truncated or padded as the full key treats them.
+        let digest = SHA256.hash(data: message)
+        let digestSignature = try privateKey.signature(for: digest)
+        XCTAssertEqual(compact.isValidSignature(digestSignature, for: digest), privateKey.publicKey.isValidSignature(digestSignature, for: digest))
+        XCTAssertTrue(compact.isValidSignature(digestSignature, for: digest))
+        XCTAssertFalse(compact.isValidSignature(signature, for: digest))
+    }
+
+    func testP521MatchesPublicKey() throws {
+        let privateKey = P521.Signing.PrivateKey()
+        let compact = P521.Signing._CompactPublicKey(privateKey.publicKey)
+        XCTAssertEqual(MemoryLayout<P521.Signing._CompactPublicKey>.size, 132)
+        XCTAssertEqual(compact.x963Representation, privateKey.publicKey.x963Representation)
+
+        let message = Data("hello".utf8)
+        let signature = try privateKey.signature(for: message)
+        XCTAssertTrue(compact.isValidSignature(signature, for: message))
+        var tampered = signature.rawRepresentation
+        tampered[tampered.startIndex + 70] ^= 1
+        XCTAssertFalse(compact.isValidSignature(try P521.Signing.ECDSASignature(rawRepresentation: tampered), for: message))
+    }
+
+    func testKeysAreHashable() throws {
+        let keys = (0..<4).map { _ in P256.Signing._CompactPublicKey(P256.Signing.PrivateKey().publicKey) }
+        let set = Set(keys + keys)
+        XCTAssertEqual(set.count, 4)
+        XCTAssertTrue(set.contains(try P256.Signing._CompactPublicKey(rawRepresentation: keys[2].rawRepresentation)))
+    }
+
+    func testInvalidPointsAreRejected() throws {
+        var raw = P256.Signing.PrivateKey().publicKey.rawRepresentation
+        XCTAssertThrowsError(try P256.Signing._CompactPublicKey(rawRepresentation: raw.dropLast())) { error in
+            guard case .some(.incorrectParameterSize) = error as? CryptoKitError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+        raw[raw.startIndex + 63] ^= 1
+        XCTAssertThrowsError(try P256.Signing._CompactPublicKey(rawRepresentation: raw)) { error in
+            guard case .some(.invalidParameter) = error as? CryptoKitError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+        // A coordinate of p or more is not a field element.
+        XCTAssertThrowsError(try P384.Signing._CompactPublicKey(rawRepresentation: Data(repeating: 0xff, count: 96)))
+        let x963 = P521.Signing.PrivateKey().publicKey.x963Representation
+        XCTAssertThrowsError(try P521.Signing._CompactPublicKey(x963Representation: [0x02] + x963.dropFirst()))
+    }
+}
@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class CompressedPointsTests: XCTestCase {
+    func testP256BatchMatchesX963() throws {
+        let keys = (0..<16).map { _ in P256.Signing.PrivateKey().publicKey }
+        let compressed = keys.reduce(into: Data()) { $0.append($1.compressedRepresentation) }
+        var uncompressed = Data(count: keys.count * 65)
+        try compressed.withUnsafeBytes { compressed in
+            try uncompressed.withUnsafeMutableBytes { output in
+                try P256._decompressPublicKeys(compressed, into: output)
+            }
+        }
+        XCTAssertEqual(uncompressed, keys.reduce(into: Data()) { $0.append($1.x963Representation) })
+    }
+
+    func testP384AndP521BatchesMatchX963() throws {
+        let p384Keys = (0..<4).map { _ in P384.Signing.PrivateKey().publicKey }
+        let p384Compressed = p384Keys.reduce(into: Data()) { $0.append($1.compressedRepresentation) }
+        var p384Uncompressed = Data(count: p384Keys.count * 97)
+        try p384Compressed.withUnsafeBytes { compressed in
+            try p384Uncompressed.withUnsafeMutableBytes { output in
+                try P384._decompressPublicKeys(compressed, into: output)
+            }
+        }
+        XCTAssertEqual(p384Uncompressed, p384Keys.reduce(into: Data()) { $0.append($1.x963Representation) })
+
+        let p521Keys = (0..<4).map { _ in P521.Signing.PrivateKey().publicKey }
+        let p521Compressed = p521Keys.reduce(into: Data()) { $0.append($1.compressedRepresentation) }
+        var p521Uncompressed = Data(count: p521Keys.count * 133)
+        try p521Compressed.withUnsafeBytes { compressed in
+            try p521Uncompressed.withUnsafeMutableBytes { output in
+                try P521._decompressPublicKeys(compressed, into: output)
+            }
+        }
+        XCTAssertEqual(p521Uncompressed, p521Keys.reduce(into: Data()) { $0.append($1.x963Representation) })
+    }
+
+    func testInvalidPointsAreRejected() throws {
+        // x = p - 1 is not a valid x coordinate on P-256, and a bad prefix is never valid.
+        var invalidX = Data([0x02] + [UInt8](repeating: 0xff, count: 32))
+        var badPrefix = P256.Signing.PrivateKey().publicKey.compressedRepresentation
+        badPrefix[0] = 0x04
+        var output = Data(count: 65)
+
+        for compressed in [invalidX, badPrefix] {
+            compressed.withUnsafeBytes { compressed in
+                output.withUnsafeMutableBytes { output in
+                    XCTAssertThrowsError(try P256._decompressPublicKeys(compressed, into: output))
+                }
+            }
+        }
+
+        invalidX.removeLast()
+        invalidX.withUnsafeBytes { compressed in
+            output.withUnsafeMutableBytes { output in
+                XCTAssertThrowsError(try P256._decompressPublicKeys(compressed, into: output)) { error in
+                    guard case .some(.incorrectParameterSize) = error as? CryptoKitError else {
+                        XCTFail("Unexpected error: \(error)")
+                        return
+                    }
+                }
+            }
+        }
+    }
+}
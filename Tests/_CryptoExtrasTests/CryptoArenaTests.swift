@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class CryptoArenaTests: XCTestCase {
+    func testArenaMatchesConfiguration() throws {
+        let key = P256.Signing.PrivateKey()
+        let message = Data("hello".utf8)
+        let pem = key.publicKey.pemRepresentation
+
+        let isValid = try _CryptoArena.withArena {
+            let publicKey = try P256.Signing.PublicKey(pemRepresentation: pem)
+            let signature = try key.signature(for: message)
+            if _CryptoArena.isEnabled {
+                let statistics = try XCTUnwrap(_CryptoArena.currentStatistics)
+                XCTAssertGreaterThan(statistics.allocations, 0)
+                XCTAssertGreaterThanOrEqual(statistics.reservedBytes, statistics.allocatedBytes)
+            } else {
+                XCTAssertNil(_CryptoArena.currentStatistics)
+            }
+            return publicKey.isValidSignature(signature, for: message)
+        }
+        XCTAssertTrue(isValid)
+        XCTAssertNil(_CryptoArena.currentStatistics)
+    }
+
+    func testArenasNest() throws {
+        try _CryptoArena.withArena {
+            let outer = _CryptoArena.currentStatistics
+            try _CryptoArena.withArena(regionByteCount: 1024) {
+                _ = try P256.Signing.PrivateKey().signature(for: Data("inner".utf8))
+                if _CryptoArena.isEnabled {
+                    XCTAssertGreaterThan(try XCTUnwrap(_CryptoArena.currentStatistics).allocations, 0)
+                }
+            }
+            XCTAssertEqual(_CryptoArena.currentStatistics?.allocations, outer?.allocations)
+        }
+    }
+
+    func testObjectsMayOutliveTheArena() throws {
+        let message = Data("hello".utf8)
+        let (key, signature) = try _CryptoArena.withArena {
+            let key = P384.Signing.PrivateKey()
+            return (key, try key.signature(for: message))
+        }
+        XCTAssertTrue(key.publicKey.isValidSignature(signature, for: message))
+        XCTAssertTrue(key.publicKey.isValidSignature(try key.signature(for: message), for: message))
+    }
+}
@@ -0,0 +1,219 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class CryptoExecutorTests: XCTestCase {
+    func testRunReturnsResultAndRethrows() async throws {
+        let executor = _CryptoExecutor(maxConcurrency: 2)
+        let value = try await executor.run { _ in 42 }
+        XCTAssertEqual(value, 42)
+
+        do {
+            _ = try await executor.run { _ -> Int in throw CryptoKitError.invalidParameter }
+            XCTFail("Expected an error")
+        } catch CryptoKitError.invalidParameter {
+            // Expected.
+        }
+    }
+
+    func testHigherPriorityStartsFirst() async throws {
+        let executor = _CryptoExecutor(maxConcurrency: 1)
+        let started = DispatchSemaphore(value: 0)
+        let release = DispatchSemaphore(value: 0)
+        let blocker = Task {
+            try await executor.run { _ in
+                started.signal()
+                release.wait()
+            }
+        }
+        await Self.wait { started.wait(timeout: .now()) == .success }
+
+        let order = LockedArray()
+        let low = Task {
+            try await executor.run(priority: .background) { _ in order.append(0) }
+        }
+        await Self.wait { executor.pendingJobCount == 1 }
+        let high = Task {
+            try await executor.run(priority: .userInitiated) { _ in order.append(2) }
+        }
+        await Self.wait { executor.pendingJobCount == 2 }
+
+        release.signal()
+        try await blocker.value
+        try await low.value
+        try await high.value
+        XCTAssertEqual(order.values, [2, 0])
+    }
+
+    func testCancellationBeforeStart() async throws {
+        let executor = _CryptoExecutor(maxConcurrency: 1)
+        let ran = LockedArray()
+        let task = Task { () async throws -> Void in
+            while !Task.isCancelled {
+                await Task.yield()
+            }
+            try await executor.run { _ in ran.append(1) }
+        }
+        task.cancel()
+        do {
+            try await task.value
+            XCTFail("Expected cancellation")
+        } catch is CancellationError {
+            // Expected.
+        }
+        XCTAssertEqual(ran.values, [])
+    }
+
+    func testCancellingScryptStopsEarly() async throws {
+        let executor = _CryptoExecutor(maxConcurrency: 1)
+        let task = Task {
+            try await _Scrypt.deriveKey(
+                from: Array("password".utf8),
+                salt: Array("NaCl".utf8),
+                outputByteCount: 64,
+                rounds: 1 << 18,
+                blockSize: 8,
+                parallelism: 1,
+                maxMemory: 512 * 1024 * 1024,
+                on: executor
+            )
+        }
+        try await Task.sleep(nanoseconds: 50_000_000)
+        task.cancel()
+        do {
+            _ = try await task.value
+            XCTFail("Expected cancellation")
+        } catch is CancellationError {
+            // Expected.
+        }
+    }
+
+    func testAsyncScryptMatchesSync() async throws {
+        let expected = try _Scrypt.deriveKey(
+            from: Array("password".utf8), salt: Array("NaCl".utf8), outputByteCount: 64, rounds: 1024, blockSize: 8, parallelism: 16
+        )
+        let key = try await _Scrypt.deriveKey(
+            from: Array("password".utf8), salt: Array("NaCl".utf8), outputByteCount: 64, rounds: 1024, blockSize: 8, parallelism: 16,
+            on: .shared
+        )
+        XCTAssertEqual(key, expected)
+    }
+
+    func testAsyncHashMatchesSync() async throws {
+        var data = Data(count: 3 * SHA256._asyncHashChunkByteCount + 17)
+        data.withUnsafeMutableBytes { bytes in
+            for i in bytes.indices {
+                bytes[i] = UInt8(truncatingIfNeeded: i &* 31)
+            }
+        }
+        let digest = try await SHA256._hash(data: data, on: .shared)
+        XCTAssertEqual(digest, SHA256.hash(data: data))
+        let empty = try await SHA512._hash(data: Data(), on: .shared, priority: .background)
+        XCTAssertEqual(empty, SHA512.hash(data: Data()))
+    }
+
+    func testFileHashMatchesSync() async throws {
+        let chunk = SHA256._asyncHashChunkByteCount
+        // Empty, short, exactly whole chunks, and a partial last chunk.
+        for byteCount in [0, 100, 2 * chunk, 3 * chunk + 17] {
+            let data = Data((0..<byteCount).map { UInt8(truncatingIfNeeded: $0 &* 31) })
+            let url = FileManager.default.temporaryDirectory.appendingPathComponent("file-hash-\(UUID()).bin")
+            try data.write(to: url)
+            defer {
+                try? FileManager.default.removeItem(at: url)
+            }
+
+            let digest = try await SHA256._hash(contentsOfFile: url.path, on: .shared)
+            XCTAssertEqual(digest, SHA256.hash(data: data), "\(byteCount) bytes")
+
+            let handle = try FileHandle(forReadingFrom: url)
+            defer {
+                try? handle.close()
+            }
+            let fromDescriptor = try await SHA384._hash(fileDescriptor: handle.fileDescriptor, on: .shared)
+            XCTAssertEqual(fromDescriptor, SHA384.hash(data: data), "\(byteCount) bytes")
+        }
+    }
+
+    func testFileHashReportsMissingFile() async throws {
+        do {
+            _ = try await SHA256._hash(contentsOfFile: "/nonexistent/\(UUID())", on: .shared)
+            XCTFail("Expected an error")
+        } catch let error as POSIXError {
+            XCTAssertEqual(error.code, .ENOENT)
+        }
+    }
+
+    func testChunkSequenceHashMatchesSync() async throws {
+        let chunks = (0..<20).map { index in [UInt8](repeating: UInt8(index), count: 1000 * index) }
+        let stream = AsyncStream<[UInt8]> { continuation in
+            for chunk in chunks {
+                continuation.yield(chunk)
+            }
+            continuation.finish()
+        }
+        let digest = try await SHA512._hash(chunks: stream, on: .shared)
+        XCTAssertEqual(digest, SHA512.hash(data: chunks.flatMap { $0 }))
+
+        let empty = try await SHA256._hash(chunks: AsyncStream<Data> { $0.finish() }, on: .shared)
+        XCTAssertEqual(empty, SHA256.hash(data: Data()))
+    }
+
+    func testAsyncRSAKeyGeneration() async throws {
+        let key = try await _RSA.Signing.PrivateKey(keySize: .bits2048, on: .shared, priority: .userInitiated)
+        XCTAssertEqual(key.keySizeInBits, 2048)
+        let signature = try key.signature(for: Data("hello".utf8))
+        XCTAssertTrue(key.publicKey.isValidSignature(signature, for: Data("hello".utf8)))
+    }
+
+    func testAsyncSPHINCSPlusSignature() async throws {
+        let key = _SPHINCSPlus.PrivateKey()
+        let message = Data("hello".utf8)
+        let signature = try await key.signature(for: message, on: .shared)
+        XCTAssertEqual(signature.count, _SPHINCSPlus.signatureByteCount)
+        XCTAssertTrue(key.publicKey.isValidSignature(signature, for: message))
+    }
+
+    private static func wait(until condition: () -> Bool) async {
+        while !condition() {
+            await Task.yield()
+        }
+    }
+}
+
+private final class LockedArray: @unchecked Sendable {
+    private let lock = NSLock()
+
+    // Protected by `lock`.
+    private var storage: [Int] = []
+
+    func append(_ value: Int) {
+        self.lock.lock()
+        defer {
+            self.lock.unlock()
+        }
+        self.storage.append(value)
+    }
+
+    var values: [Int] {
+        self.lock.lock()
+        defer {
+            self.lock.unlock()
+        }
+        return self.storage
+    }
+}
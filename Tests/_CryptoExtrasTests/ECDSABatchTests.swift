@@ -0,0 +1,83 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class ECDSABatchTests: XCTestCase {
+    func testBatchMatchesSingleVerification() throws {
+        let key = P256.Signing.PrivateKey()
+        let otherKey = P256.Signing.PrivateKey()
+        var messages = (0..<16).map { Data((0..<($0 * 11)).map { UInt8(truncatingIfNeeded: $0) }) }
+        var signatures = try messages.enumerated().map { index, message in
+            // Sign a couple of the messages with the wrong key.
+            try (index % 5 == 4 ? otherKey : key).signature(for: message)
+        }
+
+        // And corrupt a couple of the others.
+        messages[2].append(0)
+        var corrupted = signatures[6].rawRepresentation
+        corrupted[40] ^= 1
+        signatures[6] = try P256.Signing.ECDSASignature(rawRepresentation: corrupted)
+
+        let results = key.publicKey._isValidSignatures(signatures, for: messages)
+        XCTAssertEqual(results.count, messages.count)
+        for (index, result) in results.enumerated() {
+            XCTAssertEqual(result, key.publicKey.isValidSignature(signatures[index], for: messages[index]), "index: \(index)")
+        }
+        XCTAssertEqual(results.indices.filter { !results[$0] }, [2, 4, 6, 9, 14])
+
+        let digestResults = key.publicKey._isValidSignatures(signatures, for: messages.map { SHA256.hash(data: $0) })
+        XCTAssertEqual(digestResults, results)
+    }
+
+    func testEmptyBatch() throws {
+        let key = P256.Signing.PrivateKey()
+        XCTAssertEqual(key.publicKey._isValidSignatures([], for: [Data]()), [])
+    }
+
+    func testBatchSigningProducesValidSignatures() throws {
+        // 70 spans more than two of the shim's chunks of 32.
+        let messages = (0..<70).map { Data((0..<($0 * 3)).map { UInt8(truncatingIfNeeded: $0) }) }
+
+        let p256Key = P256.Signing.PrivateKey()
+        let p256Signatures = try p256Key._signatures(for: messages)
+        XCTAssertEqual(p256Signatures.count, messages.count)
+        for (signature, message) in zip(p256Signatures, messages) {
+            XCTAssertTrue(p256Key.publicKey.isValidSignature(signature, for: message))
+        }
+        XCTAssertEqual(Set(p256Signatures.map { $0.rawRepresentation.prefix(32) }).count, messages.count)
+
+        let p384Key = P384.Signing.PrivateKey()
+        let p384Signatures = try p384Key._signatures(for: messages.map { SHA384.hash(data: $0) })
+        XCTAssertEqual(p384Signatures.count, messages.count)
+        for (signature, message) in zip(p384Signatures, messages) {
+            XCTAssertTrue(p384Key.publicKey.isValidSignature(signature, for: message))
+        }
+    }
+
+    func testBatchSigningUsesFreshNoncesForRepeatedMessages() throws {
+        let key = P256.Signing.PrivateKey()
+        let message = Data("the same message".utf8)
+        let signatures = try key._signatures(for: Array(repeating: message, count: 8))
+        XCTAssertEqual(Set(signatures.map { $0.rawRepresentation }).count, 8)
+        XCTAssertTrue(signatures.allSatisfy { key.publicKey.isValidSignature($0, for: message) })
+    }
+
+    func testEmptySigningBatch() throws {
+        XCTAssertEqual(try P256.Signing.PrivateKey()._signatures(for: [Data]()).count, 0)
+    }
+}
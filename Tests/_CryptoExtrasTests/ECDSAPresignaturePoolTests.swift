@@ -0,0 +1,124 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+#if canImport(Darwin)
+import Darwin
+#elseif canImport(Glibc)
+import Glibc
+#endif
+
+final class ECDSAPresignaturePoolTests: XCTestCase {
+    func testP256PoolSignaturesVerify() throws {
+        let privateKey = P256.Signing.PrivateKey()
+        let pool = privateKey._presignaturePool(capacity: 4)
+
+        // More signatures than the pool holds, so some are made inline or from refills.
+        var signatures = Set<Data>()
+        for i in 0..<16 {
+            let message = Data("message \(i)".utf8)
+            let signature = try pool.signature(for: message)
+            XCTAssertTrue(privateKey.publicKey.isValidSignature(signature, for: message))
+            XCTAssertFalse(privateKey.publicKey.isValidSignature(signature, for: Data("another message".utf8)))
+            signatures.insert(signature.rawRepresentation)
+        }
+        XCTAssertEqual(signatures.count, 16)
+        XCTAssertLessThanOrEqual(pool.backing.availablePresignatures, 4)
+    }
+
+    func testP384PoolSignaturesVerify() throws {
+        let privateKey = P384.Signing.PrivateKey()
+        let pool = privateKey._presignaturePool(capacity: 2)
+
+        for i in 0..<6 {
+            let message = Data("message \(i)".utf8)
+            let signature = try pool.signature(for: message)
+            XCTAssertTrue(privateKey.publicKey.isValidSignature(signature, for: message))
+
+            let digest = SHA384.hash(data: message)
+            XCTAssertTrue(privateKey.publicKey.isValidSignature(try pool.signature(for: digest), for: digest))
+        }
+    }
+
+    func testPoolIsUsableConcurrently() throws {
+        let privateKey = P256.Signing.PrivateKey()
+        let pool = privateKey._presignaturePool(capacity: 8)
+        let publicKey = privateKey.publicKey
+        let message = Data("some message".utf8)
+
+        DispatchQueue.concurrentPerform(iterations: 32) { _ in
+            let signature = try! pool.signature(for: message)
+            XCTAssertTrue(publicKey.isValidSignature(signature, for: message))
+        }
+    }
+
+    #if canImport(Darwin) || canImport(Glibc)
+    func testChildProcessDoesNotReuseParentPresignatures() throws {
+        guard OpenSSLECDSAPresignaturePool.isStockingSupported else {
+            throw XCTSkip("BoringSSL can't detect forks on this platform")
+        }
+        let privateKey = P256.Signing.PrivateKey()
+        let pool = privateKey._presignaturePool(capacity: 4)
+        let message = Data("some message".utf8)
+
+        // Fork only once the refill is done, so that no other thread holds the pool's lock.
+        let deadline = Date(timeIntervalSinceNow: 10)
+        while pool.backing.availablePresignatures < 4 && Date() < deadline {
+            Thread.sleep(forTimeInterval: 0.01)
+        }
+        XCTAssertEqual(pool.backing.availablePresignatures, 4)
+        Thread.sleep(forTimeInterval: 0.05)
+
+        var fds: [Int32] = [0, 0]
+        XCTAssertEqual(pipe(&fds), 0)
+        let pid = fork()
+        if pid == 0 {
+            // The child reports how much of the stock it sees, then signs with whatever it gets.
+            close(fds[0])
+            var report = [UInt8(truncatingIfNeeded: pool.backing.availablePresignatures)]
+            report += (try? pool.signature(for: message).rawRepresentation) ?? Data(count: 64)
+            _ = report.withUnsafeBytes { write(fds[1], $0.baseAddress, $0.count) }
+            _exit(0)
+        }
+        XCTAssertGreaterThan(pid, 0)
+        close(fds[1])
+        var report = [UInt8](repeating: 0, count: 65)
+        var received = 0
+        while received < report.count {
+            let count = report.withUnsafeMutableBytes { read(fds[0], $0.baseAddress! + received, $0.count - received) }
+            guard count > 0 else {
+                break
+            }
+            received += count
+        }
+        close(fds[0])
+        var status: Int32 = 0
+        waitpid(pid, &status, 0)
+        XCTAssertEqual(received, report.count)
+
+        XCTAssertEqual(report[0], 0)
+        let childSignature = try P256.Signing.ECDSASignature(rawRepresentation: report[1...])
+        XCTAssertTrue(privateKey.publicKey.isValidSignature(childSignature, for: message))
+
+        // The parent still has its stock, and none of it shares a nonce with what the child signed.
+        for _ in 0..<4 {
+            let signature = try pool.signature(for: message)
+            XCTAssertNotEqual(signature.rawRepresentation.prefix(32), childSignature.rawRepresentation.prefix(32))
+        }
+    }
+    #endif
+}
@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class Ed25519BatchTests: XCTestCase {
+    func testBatchMatchesSingleVerification() throws {
+        let keys = (0..<4).map { _ in Curve25519.Signing.PrivateKey() }
+        var items = try (0..<20).map { index -> Curve25519.Signing._BatchVerificationItem in
+            let key = keys[index % keys.count]
+            let message = Data((0..<(index * 13)).map { UInt8(truncatingIfNeeded: $0) })
+            return try .init(publicKey: key.publicKey, signature: key.signature(for: message), data: message)
+        }
+
+        // Corrupt a few entries in different ways.
+        items[3].signature[0] ^= 1
+        items[7].data.append(0)
+        // Entry 11 was signed by keys[3], so any other key must reject it.
+        items[11].publicKey = keys[0].publicKey
+        items[15].signature = items[15].signature.dropLast()
+
+        let results = Curve25519.Signing._isValidSignatures(items)
+        XCTAssertEqual(results.count, items.count)
+        for (item, result) in zip(items, results) {
+            XCTAssertEqual(result, item.publicKey.isValidSignature(item.signature, for: item.data))
+        }
+        XCTAssertEqual(results.indices.filter { !results[$0] }, [3, 7, 11, 15])
+    }
+
+    func testEmptyBatch() throws {
+        XCTAssertEqual(Curve25519.Signing._isValidSignatures([]), [])
+    }
+
+    func testBatchSigningMatchesSingleSigning() throws {
+        let keys = (0..<5).map { _ in Curve25519.Signing.PrivateKey() }
+        // Enough items to fill several SIMD lane groups and more than one chunk, with messages either side of the
+        // SHA-512 block boundaries.
+        for count in [1, 3, 8, 9, 33, 70] {
+            let items = (0..<count).map { index -> Curve25519.Signing._BatchSigningItem in
+                let message = Data((0..<((index * 37) % 260)).map { UInt8(truncatingIfNeeded: $0 &* 7) })
+                return .init(privateKey: keys[index % keys.count], data: message)
+            }
+
+            let signatures = Curve25519.Signing._signatures(for: items)
+            XCTAssertEqual(signatures.count, items.count)
+            for (item, signature) in zip(items, signatures) {
+                // CryptoKit randomizes its Ed25519 signatures, so only BoringSSL's can be compared byte for byte.
+                #if !(CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API)
+                XCTAssertEqual(signature, try item.privateKey.signature(for: item.data))
+                #endif
+                XCTAssertTrue(item.privateKey.publicKey.isValidSignature(signature, for: item.data))
+            }
+        }
+        XCTAssertEqual(Curve25519.Signing._signatures(for: []), [])
+    }
+}
@@ -0,0 +1,57 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class Ed25519ExpandedPublicKeyTests: XCTestCase {
+    func testExpandedKeyAcceptsTheSameSignatures() throws {
+        let key = Curve25519.Signing.PrivateKey()
+        let expanded = key.publicKey._expanded
+        XCTAssertEqual(expanded.publicKey.rawRepresentation, key.publicKey.rawRepresentation)
+
+        for index in 0..<32 {
+            let message = Data((0..<(index * 11)).map { UInt8(truncatingIfNeeded: $0 &* 13) })
+            var signature = try key.signature(for: message)
+            switch index % 4 {
+            case 1:
+                signature[index % 64] ^= 0x04
+            case 2:
+                // An s that is out of range.
+                signature.replaceSubrange(32..<64, with: repeatElement(0xff, count: 32))
+            case 3:
+                signature = signature.prefix(63)
+            default:
+                break
+            }
+            XCTAssertEqual(expanded.isValidSignature(signature, for: message), key.publicKey.isValidSignature(signature, for: message))
+            XCTAssertEqual(expanded.isValidSignature(signature, for: message), index % 4 == 0)
+        }
+    }
+
+    func testExpandedKeyRejectsOtherKeysSignatures() throws {
+        let message = Data("expanded".utf8)
+        let signature = try Curve25519.Signing.PrivateKey().signature(for: message)
+        XCTAssertFalse(Curve25519.Signing.PrivateKey().publicKey._expanded.isValidSignature(signature, for: message))
+    }
+
+    func testNonContiguousMessage() throws {
+        let key = Curve25519.Signing.PrivateKey()
+        let (message, discontiguousMessage) = Array(repeating: UInt8(0x5a), count: 300).asDataProtocols()
+        let signature = try key.signature(for: message)
+        XCTAssertTrue(Curve25519.Signing.PublicKey._Expanded(key.publicKey).isValidSignature(signature, for: discontiguousMessage))
+    }
+}
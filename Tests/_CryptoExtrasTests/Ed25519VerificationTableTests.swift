@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class Ed25519VerificationTableTests: XCTestCase {
+    override func tearDown() {
+        Curve25519.Signing._isWideBasePointTableEnabled = false
+        super.tearDown()
+    }
+
+    func testWideTableAcceptsTheSameSignatures() throws {
+        var cases: [(Curve25519.Signing.PublicKey, Data, Data)] = []
+        for index in 0..<64 {
+            let key = Curve25519.Signing.PrivateKey()
+            let message = Data((0..<(index * 7)).map { UInt8(truncatingIfNeeded: $0 &* 31) })
+            var signature = try key.signature(for: message)
+            switch index % 4 {
+            case 1:
+                signature[index % 64] ^= 0x10
+            case 2:
+                // An s that is out of range.
+                signature.replaceSubrange(32..<64, with: repeatElement(0xff, count: 32))
+            default:
+                break
+            }
+            cases.append((key.publicKey, signature, message))
+        }
+
+        Curve25519.Signing._isWideBasePointTableEnabled = false
+        let expected = cases.map { $0.0.isValidSignature($0.1, for: $0.2) }
+        Curve25519.Signing._isWideBasePointTableEnabled = true
+        let actual = cases.map { $0.0.isValidSignature($0.1, for: $0.2) }
+        XCTAssertEqual(actual, expected)
+        XCTAssertTrue(expected.contains(true))
+        XCTAssertTrue(expected.contains(false))
+
+        let items = cases.map { Curve25519.Signing._BatchVerificationItem(publicKey: $0.0, signature: $0.1, data: $0.2) }
+        XCTAssertEqual(Curve25519.Signing._isValidSignatures(items), expected)
+    }
+
+    func testToggling() {
+        Curve25519.Signing._isWideBasePointTableEnabled = false
+        XCTAssertFalse(Curve25519.Signing._isWideBasePointTableEnabled)
+        Curve25519.Signing._isWideBasePointTableEnabled = true
+        #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+        XCTAssertFalse(Curve25519.Signing._isWideBasePointTableEnabled)
+        #else
+        #if arch(x86_64) || arch(arm64)
+        XCTAssertTrue(Curve25519.Signing._isWideBasePointTableEnabled)
+        #endif
+        #endif
+    }
+}
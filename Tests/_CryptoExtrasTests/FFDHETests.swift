@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class FFDHETests: XCTestCase {
+    func testAgreement() throws {
+        let alice = _FFDHE2048.PrivateKey()
+        let bob = _FFDHE2048.PrivateKey()
+        XCTAssertEqual(alice.publicKey.rawRepresentation.count, _FFDHE2048.byteCount)
+        XCTAssertNotEqual(alice.publicKey.rawRepresentation, bob.publicKey.rawRepresentation)
+
+        let aliceSecret = try alice.sharedSecret(with: bob.publicKey)
+        let bobSecret = try bob.sharedSecret(with: alice.publicKey)
+        XCTAssertEqual(aliceSecret, bobSecret)
+        XCTAssertEqual(aliceSecret.bitCount, _FFDHE2048.byteCount * 8)
+    }
+
+    func testRoundTrip() throws {
+        let key = _FFDHE2048.PrivateKey()
+        let parsed = try _FFDHE2048.PrivateKey(rawRepresentation: key.rawRepresentation)
+        XCTAssertEqual(parsed.publicKey.rawRepresentation, key.publicKey.rawRepresentation)
+
+        let publicKey = try _FFDHE2048.PublicKey(rawRepresentation: key.publicKey.rawRepresentation)
+        XCTAssertEqual(publicKey.rawRepresentation, key.publicKey.rawRepresentation)
+    }
+
+    func testSmallExponents() throws {
+        // 2^1 and 2^2 pin down the comb's handling of the lowest bits.
+        var exponent = [UInt8](repeating: 0, count: _FFDHE2048.byteCount)
+        exponent[exponent.count - 1] = 1
+        var expected = [UInt8](repeating: 0, count: _FFDHE2048.byteCount)
+        expected[expected.count - 1] = 2
+        XCTAssertEqual(Array(try _FFDHE2048.PrivateKey(rawRepresentation: exponent).publicKey.rawRepresentation), expected)
+
+        exponent[exponent.count - 1] = 2
+        expected[expected.count - 1] = 4
+        XCTAssertEqual(Array(try _FFDHE2048.PrivateKey(rawRepresentation: exponent).publicKey.rawRepresentation), expected)
+    }
+
+    func testInvalidKeysAreRejected() {
+        let zero = [UInt8](repeating: 0, count: _FFDHE2048.byteCount)
+        var one = zero
+        one[one.count - 1] = 1
+        let large = [UInt8](repeating: 0xff, count: _FFDHE2048.byteCount)
+
+        XCTAssertThrowsError(try _FFDHE2048.PrivateKey(rawRepresentation: zero))
+        XCTAssertThrowsError(try _FFDHE2048.PrivateKey(rawRepresentation: large))
+        XCTAssertThrowsError(try _FFDHE2048.PrivateKey(rawRepresentation: one.dropFirst()))
+
+        XCTAssertThrowsError(try _FFDHE2048.PublicKey(rawRepresentation: zero))
+        XCTAssertThrowsError(try _FFDHE2048.PublicKey(rawRepresentation: one))
+        XCTAssertThrowsError(try _FFDHE2048.PublicKey(rawRepresentation: large))
+        XCTAssertThrowsError(try _FFDHE2048.PublicKey(rawRepresentation: one.dropFirst()))
+    }
+}
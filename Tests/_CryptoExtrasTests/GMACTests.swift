@@ -0,0 +1,79 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class GMACTests: XCTestCase {
+    func testMatchesAESGCMTagOverAuthenticatedData() throws {
+        for size in [SymmetricKeySize.bits128, .bits192, .bits256] {
+            let key = SymmetricKey(size: size)
+            let prepared = try _AESGMAC.PreparedKey(key)
+
+            // Non-default nonce lengths go through the GHASH-derived pre-counter block.
+            for nonceByteCount in [12, 16, 60] {
+                let nonce = try AES.GCM.Nonce(data: [UInt8]((0..<nonceByteCount).map { UInt8(truncatingIfNeeded: $0 &* 3) }))
+                for dataByteCount in [0, 1, 15, 16, 17, 1000] {
+                    let data = [UInt8]((0..<dataByteCount).map { UInt8(truncatingIfNeeded: $0) })
+                    let expected = try AES.GCM.seal([UInt8](), using: key, nonce: nonce, authenticating: data).tag
+                    XCTAssertEqual(_AESGMAC.authenticationCode(for: data, using: prepared, nonce: nonce), expected)
+                }
+            }
+        }
+    }
+
+    func testStreamingMatchesOneShot() throws {
+        let prepared = try _AESGMAC.PreparedKey(SymmetricKey(size: .bits256))
+        let nonce = AES.GCM.Nonce()
+        let data = [UInt8]((0..<4096).map { UInt8(truncatingIfNeeded: $0 &* 7) })
+        let expected = _AESGMAC.authenticationCode(for: data, using: prepared, nonce: nonce)
+
+        for chunkByteCount in [1, 7, 16, 33, 512] {
+            var gmac = _AESGMAC(key: prepared, nonce: nonce)
+            var offset = 0
+            while offset < data.count {
+                let end = min(offset + chunkByteCount, data.count)
+                gmac.update(data: data[offset..<end])
+                offset = end
+            }
+            XCTAssertEqual(gmac.finalize(), expected)
+            // Finalizing doesn't consume the state.
+            XCTAssertEqual(gmac.finalize(), expected)
+        }
+    }
+
+    func testValidation() throws {
+        let prepared = try _AESGMAC.PreparedKey(SymmetricKey(size: .bits128))
+        let nonce = AES.GCM.Nonce()
+        let data = Array("Some replicated blob".utf8)
+        var tag = Array(_AESGMAC.authenticationCode(for: data, using: prepared, nonce: nonce))
+
+        XCTAssertTrue(_AESGMAC.isValidAuthenticationCode(tag, authenticating: data, using: prepared, nonce: nonce))
+        XCTAssertFalse(_AESGMAC.isValidAuthenticationCode(tag, authenticating: data, using: prepared, nonce: AES.GCM.Nonce()))
+        XCTAssertFalse(_AESGMAC.isValidAuthenticationCode(tag.prefix(8), authenticating: data, using: prepared, nonce: nonce))
+        tag[0] ^= 1
+        XCTAssertFalse(_AESGMAC.isValidAuthenticationCode(tag, authenticating: data, using: prepared, nonce: nonce))
+    }
+
+    func testRejectsInvalidKeySizes() throws {
+        XCTAssertThrowsError(try _AESGMAC.PreparedKey(SymmetricKey(size: .init(bitCount: 64)))) { error in
+            guard case .some(.incorrectKeySize) = error as? CryptoKitError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+    }
+}
@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class HKDFFastPathTests: XCTestCase {
+    private let inputKeyMaterial = SymmetricKey(data: [UInt8](repeating: 0x0b, count: 22))
+    private let salt = [UInt8](0x00...0x0c)
+    private let info = [UInt8](0xf0...0xf9)
+
+    private func checkSingleShot<H: HashFunction>(_: H.Type) throws {
+        for outputByteCount in [1, 32, 42, 100, 255 * H.Digest.byteCount] {
+            let expected = HKDF<H>.deriveKey(inputKeyMaterial: self.inputKeyMaterial, salt: self.salt, info: self.info, outputByteCount: outputByteCount)
+            var output = [UInt8](repeating: 0, count: outputByteCount)
+            try output.withUnsafeMutableBytes {
+                try HKDF<H>._deriveKey(inputKeyMaterial: self.inputKeyMaterial, salt: self.salt, info: self.info, into: $0)
+            }
+            XCTAssertEqual(SymmetricKey(data: output), expected)
+        }
+    }
+
+    func testSingleShotMatchesHKDF() throws {
+        try self.checkSingleShot(SHA256.self)
+        try self.checkSingleShot(SHA384.self)
+        try self.checkSingleShot(SHA512.self)
+        try self.checkSingleShot(Insecure.SHA1.self)
+        try self.checkSingleShot(Insecure.MD5.self)
+    }
+
+    func testRFC5869TestCase1() throws {
+        var output = [UInt8](repeating: 0, count: 42)
+        try output.withUnsafeMutableBytes {
+            try HKDF<SHA256>._deriveKey(inputKeyMaterial: self.inputKeyMaterial, salt: self.salt, info: self.info, into: $0)
+        }
+        XCTAssertEqual(
+            output,
+            try Array(hexString: "3cb25f25faacd57a90434f64d0362f2a2d2d0a90cf1a5a4c5db02d56ecc4c5bf34007208d5b887185865")
+        )
+    }
+
+    func testPreparedPseudoRandomKeyMatchesExpand() throws {
+        let pseudoRandomKey = HKDF<SHA256>.extract(inputKeyMaterial: self.inputKeyMaterial, salt: self.salt)
+        let prepared = HKDF<SHA256>._PreparedPseudoRandomKey(pseudoRandomKey)
+        XCTAssertEqual(
+            try prepared.expand(info: self.info, outputByteCount: 42),
+            try HKDF<SHA256>._PreparedPseudoRandomKey(inputKeyMaterial: self.inputKeyMaterial, salt: self.salt).expand(info: self.info, outputByteCount: 42)
+        )
+
+        for label in ["key", "iv", "secret", ""] {
+            for outputByteCount in [12, 32, 33, 64, 255 * SHA256.byteCount] {
+                let expected = HKDF<SHA256>.expand(pseudoRandomKey: pseudoRandomKey, info: Array(label.utf8), outputByteCount: outputByteCount)
+                XCTAssertEqual(try prepared.expand(info: Array(label.utf8), outputByteCount: outputByteCount), expected)
+            }
+        }
+    }
+
+    func testEmptyOutput() throws {
+        let empty = UnsafeMutableRawBufferPointer(start: nil, count: 0)
+        try HKDF<SHA256>._deriveKey(inputKeyMaterial: self.inputKeyMaterial, salt: self.salt, info: self.info, into: empty)
+        try HKDF<SHA256>._PreparedPseudoRandomKey(SymmetricKey(size: .bits256)).expand(info: self.info, into: empty)
+    }
+
+    func testRejectsOverlongOutput() throws {
+        var output = [UInt8](repeating: 0, count: 255 * SHA256.byteCount + 1)
+        try output.withUnsafeMutableBytes { output in
+            XCTAssertThrowsError(try HKDF<SHA256>._deriveKey(inputKeyMaterial: self.inputKeyMaterial, salt: self.salt, info: self.info, into: output)) { error in
+                guard case .some(.incorrectParameterSize) = error as? CryptoKitError else {
+                    XCTFail("Unexpected error: \(error)")
+                    return
+                }
+            }
+            XCTAssertThrowsError(try HKDF<SHA256>._PreparedPseudoRandomKey(SymmetricKey(size: .bits256)).expand(info: self.info, into: output)) { error in
+                guard case .some(.incorrectParameterSize) = error as? CryptoKitError else {
+                    XCTFail("Unexpected error: \(error)")
+                    return
+                }
+            }
+        }
+    }
+}
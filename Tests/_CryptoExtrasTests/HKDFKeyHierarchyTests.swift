@@ -0,0 +1,104 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class HKDFKeyHierarchyTests: XCTestCase {
+    private let rootKey = SymmetricKey(size: .bits256)
+    private let salt = Array("hierarchy salt".utf8)
+
+    /// Derives a key by nesting `deriveKey` calls from the root, as a hierarchy is specified to.
+    private func nestedKey<H: HashFunction>(
+        _: H.Type,
+        path: [String],
+        info: String,
+        intermediateKeyByteCount: Int = H.Digest.byteCount,
+        outputByteCount: Int
+    ) -> SymmetricKey {
+        let parent = path.reduce(self.rootKey) { key, component in
+            HKDF<H>.deriveKey(
+                inputKeyMaterial: key, salt: self.salt, info: Array(component.utf8), outputByteCount: intermediateKeyByteCount
+            )
+        }
+        return HKDF<H>.deriveKey(inputKeyMaterial: parent, salt: self.salt, info: Array(info.utf8), outputByteCount: outputByteCount)
+    }
+
+    private func checkMatchesNestedDerivation<H: HashFunction>(_: H.Type) throws {
+        let hierarchy = try HKDF<H>._KeyHierarchy(rootKey: self.rootKey, salt: self.salt, intermediateKeyByteCount: 42)
+        for path in [[], ["tenant"], ["tenant", "table"], ["tenant", "table", "column"], ["other", "table"]] {
+            for outputByteCount in [16, 32, 100] {
+                let key = try hierarchy.deriveKey(path: path.map { Array($0.utf8) }, info: Array("leaf".utf8), outputByteCount: outputByteCount)
+                XCTAssertEqual(
+                    key,
+                    self.nestedKey(H.self, path: path, info: "leaf", intermediateKeyByteCount: 42, outputByteCount: outputByteCount),
+                    "\(H.self) \(path) \(outputByteCount)"
+                )
+            }
+        }
+    }
+
+    func testMatchesNestedDerivation() throws {
+        try self.checkMatchesNestedDerivation(SHA256.self)
+        try self.checkMatchesNestedDerivation(SHA384.self)
+        try self.checkMatchesNestedDerivation(SHA512.self)
+        try self.checkMatchesNestedDerivation(Insecure.SHA1.self)
+    }
+
+    func testPathsAreCachedAndEvicted() throws {
+        let hierarchy = try HKDF<SHA256>._KeyHierarchy(rootKey: self.rootKey, salt: self.salt, capacity: 4, shards: 1)
+        let path = ["tenant", "table", "column"].map { Array($0.utf8) }
+
+        _ = try hierarchy.deriveKey(path: path, info: Array("a".utf8), outputByteCount: 32)
+        XCTAssertEqual(hierarchy.statistics.keyCount, 3)
+        XCTAssertEqual(hierarchy.statistics.misses, 3)
+
+        // A key under a cached path only looks that path up.
+        var output = [UInt8](repeating: 0, count: 32)
+        try output.withUnsafeMutableBytes { try hierarchy.deriveKey(path: path, info: Array("b".utf8), into: $0) }
+        XCTAssertEqual(hierarchy.statistics.hits, 1)
+        XCTAssertEqual(SymmetricKey(data: output), self.nestedKey(SHA256.self, path: ["tenant", "table", "column"], info: "b", outputByteCount: 32))
+
+        // A sibling path reuses its cached prefix.
+        _ = try hierarchy.deriveKey(path: ["tenant", "other"].map { Array($0.utf8) }, info: Array("a".utf8), outputByteCount: 32)
+        XCTAssertEqual(hierarchy.statistics.keyCount, 4)
+        XCTAssertEqual(hierarchy.statistics.hits, 2)
+
+        // Past the capacity, the least recently used path is dropped, and keys are unchanged.
+        let key = try hierarchy.deriveKey(path: ["another"].map { Array($0.utf8) }, info: Array("a".utf8), outputByteCount: 32)
+        XCTAssertEqual(hierarchy.statistics.evictions, 1)
+        XCTAssertEqual(key, self.nestedKey(SHA256.self, path: ["another"], info: "a", outputByteCount: 32))
+
+        hierarchy.removeAll()
+        XCTAssertEqual(hierarchy.statistics.keyCount, 0)
+        XCTAssertEqual(
+            try hierarchy.deriveKey(path: path, info: Array("b".utf8), outputByteCount: 32),
+            SymmetricKey(data: output)
+        )
+    }
+
+    func testRejectsInvalidSizes() throws {
+        XCTAssertThrowsError(try HKDF<SHA256>._KeyHierarchy(rootKey: self.rootKey, salt: self.salt, intermediateKeyByteCount: 0))
+        let hierarchy = try HKDF<SHA256>._KeyHierarchy(rootKey: self.rootKey, salt: self.salt)
+        XCTAssertThrowsError(
+            try hierarchy.deriveKey(path: [Array("tenant".utf8)], info: [UInt8](), outputByteCount: 255 * SHA256.byteCount + 1)
+        ) { error in
+            guard case .some(.incorrectParameterSize) = error as? CryptoKitError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+    }
+}
@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class HMACBatchTests: XCTestCase {
+    private let storage = [UInt8]((0..<2048).map { UInt8(truncatingIfNeeded: $0 &* 13) })
+    private let ranges = [0..<0, 0..<1, 5..<69, 100..<228, 1000..<2048]
+
+    private func macs(_ body: ([UnsafeRawBufferPointer], UnsafeMutableRawBufferPointer) throws -> Void) rethrows -> [UInt8] {
+        var macs = [UInt8](repeating: 0, count: self.ranges.count * SHA256.byteCount)
+        try self.storage.withUnsafeBytes { storage in
+            try macs.withUnsafeMutableBytes { macs in
+                try body(self.ranges.map { UnsafeRawBufferPointer(rebasing: storage[$0]) }, macs)
+            }
+        }
+        return macs
+    }
+
+    func testSingleKeyBatchMatchesOneShot() throws {
+        for key in [SymmetricKey(size: .bits256), SymmetricKey(data: [UInt8](repeating: 7, count: 100)), SymmetricKey(data: [UInt8]())] {
+            let macs = try self.macs { try HMAC<SHA256>._authenticationCodes(batch: $0, using: key, into: $1) }
+
+            for (index, range) in self.ranges.enumerated() {
+                let expected = Array(HMAC<SHA256>.authenticationCode(for: self.storage[range], using: key))
+                XCTAssertEqual(Array(macs[(index * SHA256.byteCount)..<((index + 1) * SHA256.byteCount)]), expected)
+            }
+        }
+    }
+
+    func testMultiKeyBatchMatchesOneShot() throws {
+        let first = SymmetricKey(size: .bits256)
+        let second = SymmetricKey(size: .bits128)
+        // Include runs of the same key as well as a key that reappears later in the batch.
+        let keys = [first, first, second, SymmetricKey(data: [UInt8]()), first]
+        let macs = try self.macs { try HMAC<SHA256>._authenticationCodes(batch: $0, using: keys, into: $1) }
+
+        for (index, range) in self.ranges.enumerated() {
+            let expected = Array(HMAC<SHA256>.authenticationCode(for: self.storage[range], using: keys[index]))
+            XCTAssertEqual(Array(macs[(index * SHA256.byteCount)..<((index + 1) * SHA256.byteCount)]), expected)
+        }
+    }
+
+    func testBatchRejectsIncorrectSizes() throws {
+        var macs = [UInt8](repeating: 0, count: SHA256.byteCount + 1)
+        let message = UnsafeRawBufferPointer(start: nil, count: 0)
+        try macs.withUnsafeMutableBytes { macs in
+            XCTAssertThrowsError(try HMAC<SHA256>._authenticationCodes(batch: [message], using: SymmetricKey(size: .bits256), into: macs)) { error in
+                guard case .some(.incorrectParameterSize) = error as? CryptoKitError else {
+                    XCTFail("Unexpected error: \(error)")
+                    return
+                }
+            }
+            let rightSize = UnsafeMutableRawBufferPointer(rebasing: macs.prefix(SHA256.byteCount))
+            XCTAssertThrowsError(try HMAC<SHA256>._authenticationCodes(batch: [message], using: [], into: rightSize)) { error in
+                guard case .some(.incorrectParameterSize) = error as? CryptoKitError else {
+                    XCTFail("Unexpected error: \(error)")
+                    return
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,57 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class HMACPreparedKeyTests: XCTestCase {
+    func testPreparedKeyMatchesOneShot() throws {
+        // Cover keys shorter than, equal to, and longer than the SHA-256 block size.
+        for keyByteCount in [16, 64, 100] {
+            let key = SymmetricKey(data: [UInt8]((0..<keyByteCount).map { UInt8(truncatingIfNeeded: $0) }))
+            let preparedKey = HMAC<SHA256>._PreparedKey(key)
+
+            for messageLength in [0, 1, 63, 64, 65, 1000] {
+                let message = [UInt8](repeating: UInt8(truncatingIfNeeded: messageLength), count: messageLength)
+                let expected = HMAC<SHA256>.authenticationCode(for: message, using: key)
+                XCTAssertEqual(preparedKey.authenticationCode(for: message), expected)
+                XCTAssertTrue(preparedKey.isValidAuthenticationCode(expected, authenticating: message))
+            }
+        }
+    }
+
+    func testPreparedKeyIsReusable() throws {
+        let key = SymmetricKey(size: .bits256)
+        let preparedKey = HMAC<SHA512>._PreparedKey(key)
+
+        var authenticator = preparedKey.makeAuthenticator()
+        authenticator.update(data: Array("hello, ".utf8))
+        authenticator.update(data: Array("world".utf8))
+        let streamed = authenticator.finalize()
+
+        // Using the prepared key after a derived authenticator has been updated must not see that state.
+        XCTAssertEqual(preparedKey.authenticationCode(for: Array("hello, world".utf8)), streamed)
+        XCTAssertEqual(preparedKey.authenticationCode(for: Array("other".utf8)), HMAC<SHA512>.authenticationCode(for: Array("other".utf8), using: key))
+    }
+
+    func testPreparedKeyRejectsWrongCode() throws {
+        let preparedKey = HMAC<SHA256>._PreparedKey(SymmetricKey(size: .bits256))
+        var mac = Array(preparedKey.authenticationCode(for: Array("message".utf8)))
+        mac[0] ^= 1
+        XCTAssertFalse(preparedKey.isValidAuthenticationCode(mac, authenticating: Array("message".utf8)))
+        XCTAssertFalse(preparedKey.isValidAuthenticationCode(mac.dropLast(), authenticating: Array("message".utf8)))
+    }
+}
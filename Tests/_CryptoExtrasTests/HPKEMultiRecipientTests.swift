@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class HPKEMultiRecipientTests: XCTestCase {
+    private let message = Data("a message for everyone".utf8)
+    private let aad = Data("header".utf8)
+    private let info = Data("group-42".utf8)
+
+    private func checkRoundTrip<PrivateKey: HPKEDiffieHellmanPrivateKeyGeneration>(_: PrivateKey.Type, ciphersuite: HPKE.Ciphersuite) throws {
+        let recipients = (0..<5).map { _ in PrivateKey() }
+        let sealed = try HPKE._seal(self.message, authenticating: self.aad, to: recipients.map { $0.publicKey }, ciphersuite: ciphersuite, info: self.info)
+        XCTAssertEqual(sealed.ciphertexts.count, recipients.count)
+
+        for (recipientKey, ciphertext) in zip(recipients, sealed.ciphertexts) {
+            var recipient = try HPKE.Recipient(privateKey: recipientKey, ciphersuite: ciphersuite, info: self.info, encapsulatedKey: sealed.encapsulatedKey)
+            XCTAssertEqual(try recipient.open(ciphertext, authenticating: self.aad), self.message)
+        }
+
+        // A recipient cannot open another recipient's ciphertext.
+        var recipient = try HPKE.Recipient(privateKey: recipients[0], ciphersuite: ciphersuite, info: self.info, encapsulatedKey: sealed.encapsulatedKey)
+        XCTAssertThrowsError(try recipient.open(sealed.ciphertexts[1], authenticating: self.aad))
+    }
+
+    func testRecipientsCanOpen() throws {
+        try self.checkRoundTrip(Curve25519.KeyAgreement.PrivateKey.self, ciphersuite: .Curve25519_SHA256_ChachaPoly)
+        try self.checkRoundTrip(P256.KeyAgreement.PrivateKey.self, ciphersuite: .P256_SHA256_AES_GCM_256)
+        try self.checkRoundTrip(P384.KeyAgreement.PrivateKey.self, ciphersuite: .P384_SHA384_AES_GCM_256)
+        try self.checkRoundTrip(P521.KeyAgreement.PrivateKey.self, ciphersuite: .P521_SHA512_AES_GCM_256)
+        try self.checkRoundTrip(Curve25519.KeyAgreement.PrivateKey.self, ciphersuite: HPKE.Ciphersuite(kem: .Curve25519_HKDF_SHA256, kdf: .HKDF_SHA512, aead: .AES_GCM_128))
+    }
+
+    func testMismatchedKEMIsRejected() throws {
+        let recipient = P256.KeyAgreement.PrivateKey()
+        XCTAssertThrowsError(try HPKE._seal(self.message, authenticating: self.aad, to: [recipient.publicKey], ciphersuite: .P384_SHA384_AES_GCM_256, info: self.info))
+    }
+
+    func testExportOnlyIsRejected() throws {
+        let ciphersuite = HPKE.Ciphersuite(kem: .Curve25519_HKDF_SHA256, kdf: .HKDF_SHA256, aead: .exportOnly)
+        XCTAssertThrowsError(try HPKE._seal(self.message, authenticating: self.aad, to: [Curve25519.KeyAgreement.PrivateKey().publicKey], ciphersuite: ciphersuite, info: self.info)) { error in
+            guard case .some(.exportOnlyMode) = error as? HPKE.Errors else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+    }
+}
@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class HPKEStreamingTests: XCTestCase {
+    private let info = Data("stream".utf8)
+
+    private func messages() -> [[UInt8]] {
+        (0..<20).map { [UInt8](repeating: UInt8($0), count: $0 * 37) }
+    }
+
+    private func checkStreamingSender<PrivateKey: HPKEDiffieHellmanPrivateKeyGeneration>(_: PrivateKey.Type, ciphersuite: HPKE.Ciphersuite) throws {
+        let recipientKey = PrivateKey()
+        var sender = try HPKE._StreamingSender(recipientKey: recipientKey.publicKey, ciphersuite: ciphersuite, info: self.info)
+        var recipient = try HPKE.Recipient(privateKey: recipientKey, ciphersuite: ciphersuite, info: self.info, encapsulatedKey: sender.encapsulatedKey)
+
+        for (index, message) in self.messages().enumerated() {
+            let aad = [UInt8(index)]
+            var ciphertext = [UInt8](repeating: 0, count: message.count + sender.tagByteCount)
+            try message.withUnsafeBytes { message in
+                try ciphertext.withUnsafeMutableBytes { try sender.seal(message, into: $0, authenticating: aad) }
+            }
+            XCTAssertEqual(try recipient.open(ciphertext, authenticating: aad), Data(message))
+        }
+    }
+
+    private func checkStreamingRecipient<PrivateKey: HPKEDiffieHellmanPrivateKeyGeneration>(_: PrivateKey.Type, ciphersuite: HPKE.Ciphersuite) throws {
+        let recipientKey = PrivateKey()
+        var sender = try HPKE.Sender(recipientKey: recipientKey.publicKey, ciphersuite: ciphersuite, info: self.info)
+        var recipient = try HPKE._StreamingRecipient(privateKey: recipientKey, ciphersuite: ciphersuite, info: self.info, encapsulatedKey: sender.encapsulatedKey)
+
+        for message in self.messages() {
+            var buffer = Array(try sender.seal(message))
+            let plaintext = try buffer.withUnsafeMutableBytes { Array(try recipient.open(inPlace: $0)) }
+            XCTAssertEqual(plaintext, message)
+        }
+    }
+
+    func testInteroperatesWithHPKE() throws {
+        try self.checkStreamingSender(Curve25519.KeyAgreement.PrivateKey.self, ciphersuite: .Curve25519_SHA256_ChachaPoly)
+        try self.checkStreamingSender(P256.KeyAgreement.PrivateKey.self, ciphersuite: .P256_SHA256_AES_GCM_256)
+        try self.checkStreamingSender(P521.KeyAgreement.PrivateKey.self, ciphersuite: .P521_SHA512_AES_GCM_256)
+        try self.checkStreamingRecipient(Curve25519.KeyAgreement.PrivateKey.self, ciphersuite: .Curve25519_SHA256_ChachaPoly)
+        try self.checkStreamingRecipient(P384.KeyAgreement.PrivateKey.self, ciphersuite: .P384_SHA384_AES_GCM_256)
+        try self.checkStreamingRecipient(P256.KeyAgreement.PrivateKey.self, ciphersuite: HPKE.Ciphersuite(kem: .P256_HKDF_SHA256, kdf: .HKDF_SHA256, aead: .AES_GCM_128))
+    }
+
+    func testTamperedMessageDoesNotAdvanceTheStream() throws {
+        let recipientKey = Curve25519.KeyAgreement.PrivateKey()
+        var sender = try HPKE.Sender(recipientKey: recipientKey.publicKey, ciphersuite: .Curve25519_SHA256_ChachaPoly, info: self.info)
+        var recipient = try HPKE._StreamingRecipient(privateKey: recipientKey, ciphersuite: .Curve25519_SHA256_ChachaPoly, info: self.info, encapsulatedKey: sender.encapsulatedKey)
+
+        let ciphertext = Array(try sender.seal(Array("hello".utf8)))
+        var tampered = ciphertext
+        tampered[0] ^= 1
+        XCTAssertThrowsError(try tampered.withUnsafeMutableBytes { try recipient.open(inPlace: $0) })
+
+        var buffer = ciphertext
+        XCTAssertEqual(try buffer.withUnsafeMutableBytes { Array(try recipient.open(inPlace: $0)) }, Array("hello".utf8))
+    }
+
+    func testSealRejectsWrongOutputSize() throws {
+        var sender = try HPKE._StreamingSender(recipientKey: Curve25519.KeyAgreement.PrivateKey().publicKey, ciphersuite: .Curve25519_SHA256_ChachaPoly, info: self.info)
+        var output = [UInt8](repeating: 0, count: 10)
+        try [UInt8](repeating: 0, count: 10).withUnsafeBytes { message in
+            try output.withUnsafeMutableBytes { output in
+                XCTAssertThrowsError(try sender.seal(message, into: output)) { error in
+                    guard case .some(.incorrectParameterSize) = error as? CryptoKitError else {
+                        XCTFail("Unexpected error: \(error)")
+                        return
+                    }
+                }
+            }
+        }
+    }
+
+    func testExportOnlyIsRejected() throws {
+        let ciphersuite = HPKE.Ciphersuite(kem: .Curve25519_HKDF_SHA256, kdf: .HKDF_SHA256, aead: .exportOnly)
+        XCTAssertThrowsError(try HPKE._StreamingSender(recipientKey: Curve25519.KeyAgreement.PrivateKey().publicKey, ciphersuite: ciphersuite, info: self.info))
+    }
+}
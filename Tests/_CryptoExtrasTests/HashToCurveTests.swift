@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class HashToCurveTests: XCTestCase {
+    // The test vectors of appendix J of RFC 9380.
+    let p256DST = Array("QUUX-V01-CS02-with-P256_XMD:SHA-256_SSWU_RO_".utf8)
+    let p384DST = Array("QUUX-V01-CS02-with-P384_XMD:SHA-384_SSWU_RO_".utf8)
+
+    func testP256Vectors() throws {
+        XCTAssertEqual(
+            try P256._hashToCurve(Data(), domainSeparationTag: p256DST).x963Representation,
+            Data(try Array(hexString: "042c15230b26dbc6fc9a37051158c95b79656e17a1a920b11394ca91c44247d3e48a7a74985cc5c776cdfe4b1f19884970453912e9d31528c060be9ab5c43e8415"))
+        )
+        XCTAssertEqual(
+            try P256._hashToCurve(Array("abc".utf8), domainSeparationTag: p256DST).x963Representation,
+            Data(try Array(hexString: "040bb8b87485551aa43ed54f009230450b492fead5f1cc91658775dac4a3388a0f5c41b3d0731a27a7b14bc0bf0ccded2d8751f83493404c84a88e71ffd424212e"))
+        )
+    }
+
+    func testP384Vectors() throws {
+        XCTAssertEqual(
+            try P384._hashToCurve(Data(), domainSeparationTag: p384DST).x963Representation,
+            Data(try Array(hexString: "04eb9fe1b4f4e14e7140803c1d99d0a93cd823d2b024040f9c067a8eca1f5a2eeac9ad604973527a356f3fa3aeff0e4d830c21708cff382b7f4643c07b105c2eaec2cead93a917d825601e63c8f21f6abd9abc22c93c2bed6f235954b25048bb1a"))
+        )
+        XCTAssertEqual(
+            try P384._hashToCurve(Array("abc".utf8), domainSeparationTag: p384DST).x963Representation,
+            Data(try Array(hexString: "04e02fc1a5f44a7519419dd314e29863f30df55a514da2d655775a81d413003c4d4e7fd59af0826dfaad4200ac6f60abe101f638d04d98677d65bef99aef1a12a70a4cbb9270ec55248c04530d8bc1f8f90f8a6a859a7c1f1ddccedf8f96d675f6"))
+        )
+    }
+
+    func testBatchMatchesOneAtATime() throws {
+        // More than one internal batch, with a mix of lengths including empty.
+        let messages = (0..<70).map { i in [UInt8](repeating: UInt8(truncatingIfNeeded: i), count: i % 9) }
+
+        var p256Points = Data(count: messages.count * 65)
+        try p256Points.withUnsafeMutableBytes { output in
+            try P256._hashToCurve(messages, domainSeparationTag: p256DST, into: output)
+        }
+        XCTAssertEqual(
+            p256Points,
+            try messages.reduce(into: Data()) { $0.append(try P256._hashToCurve($1, domainSeparationTag: p256DST).x963Representation) }
+        )
+
+        var p384Points = Data(count: messages.count * 97)
+        try p384Points.withUnsafeMutableBytes { output in
+            try P384._hashToCurve(messages, domainSeparationTag: p384DST, into: output)
+        }
+        XCTAssertEqual(
+            p384Points,
+            try messages.reduce(into: Data()) { $0.append(try P384._hashToCurve($1, domainSeparationTag: p384DST).x963Representation) }
+        )
+    }
+
+    func testInvalidParametersAreRejected() throws {
+        XCTAssertThrowsError(try P256._hashToCurve(Array("abc".utf8), domainSeparationTag: [UInt8]())) { error in
+            guard case CryptoKitError.incorrectParameterSize = error else {
+                return XCTFail("Unexpected error \(error)")
+            }
+        }
+
+        var output = Data(count: 64)
+        XCTAssertThrowsError(try output.withUnsafeMutableBytes { output in
+            try P256._hashToCurve([Array("abc".utf8)], domainSeparationTag: p256DST, into: output)
+        })
+    }
+}
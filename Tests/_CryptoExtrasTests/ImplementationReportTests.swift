@@ -0,0 +1,57 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class ImplementationReportTests: XCTestCase {
+    func testReportsAreStable() throws {
+        for report in [
+            _CryptoImplementationReport.sha256, _CryptoImplementationReport.sha512, _CryptoImplementationReport.aes,
+            _CryptoImplementationReport.p256, _CryptoImplementationReport.ghash, _CryptoImplementationReport.chaCha20,
+            _CryptoImplementationReport.chaChaPoly, _CryptoImplementationReport.x25519,
+        ] {
+            XCTAssertFalse(report.isEmpty)
+        }
+        XCTAssertEqual(_CryptoImplementationReport.sha256, _CryptoImplementationReport.sha256)
+    }
+
+    func testP256ReportNamesAnImplementation() throws {
+        XCTAssertTrue(["nistz256", "fiat", "cryptokit"].contains(_CryptoImplementationReport.p256))
+    }
+
+    func testX25519ReportNamesAnImplementation() throws {
+        XCTAssertTrue(["adx", "neon", "fiat", "cryptokit"].contains(_CryptoImplementationReport.x25519))
+    }
+
+    func testCapabilitiesAreForTheRunningArchitecture() throws {
+        let capabilities = _CryptoImplementationReport.cpuCapabilities
+        let x86: _CryptoCPUCapabilities = [.ssse3, .sse41, .pclmul, .movbe, .aesni, .avx, .avx2, .bmi1, .bmi2, .adx, .sha, .avx512f, .avx512ifma]
+        let arm: _CryptoCPUCapabilities = [.neon, .armv8AES, .armv8PMULL, .armv8SHA1, .armv8SHA256, .armv8SHA512]
+        XCTAssertTrue(capabilities.isDisjoint(with: x86) || capabilities.isDisjoint(with: arm))
+        if capabilities.contains(.aesni) || capabilities.contains(.armv8AES) {
+            XCTAssertTrue(["aes-ni", "armv8-aes"].contains(_CryptoImplementationReport.aes))
+        }
+    }
+
+    func testRestrictingAnUnusedCapability() throws {
+        // BoringSSL has no AVX-512 kernels, so removing it can't change the behaviour of other tests.
+        let remaining = _CryptoCPUCapabilities.restrict(removing: .avx512f)
+        XCTAssertFalse(remaining.contains(.avx512f))
+        XCTAssertEqual(remaining, _CryptoCPUCapabilities.current)
+        XCTAssertEqual(_CryptoCPUCapabilities.restrict(removing: []), remaining)
+    }
+}
@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class InstrumentationTests: XCTestCase {
+    func testCountersFollowOperationsOnThisThread() throws {
+        guard _CryptoInstrumentation.isEnabled else {
+            XCTAssertEqual(_CryptoInstrumentation.currentThread, _CryptoInstrumentation.Counters())
+            XCTAssertEqual(_CryptoInstrumentation.process, _CryptoInstrumentation.Counters())
+            return
+        }
+
+        let key = SymmetricKey(size: .bits256)
+        let message = Data(repeating: 0x2a, count: 100)
+
+        let before = _CryptoInstrumentation.currentThread
+        let box = try AES.GCM.seal(message, using: key)
+        _ = try AES.GCM.open(box, using: key)
+        let wrongKey = SymmetricKey(size: .bits256)
+        XCTAssertThrowsError(try AES.GCM.open(box, using: wrongKey))
+        var hasher = SHA256()
+        hasher.update(data: message)
+        _ = hasher.finalize()
+        let delta = _CryptoInstrumentation.currentThread.subtracting(before)
+
+        XCTAssertEqual(delta.aeadSeals, 1)
+        XCTAssertEqual(delta.aeadSealedBytes, 100)
+        XCTAssertEqual(delta.aeadOpens, 2)
+        XCTAssertEqual(delta.aeadOpenFailures, 1)
+        XCTAssertGreaterThanOrEqual(delta.digestUpdates, 1)
+        XCTAssertGreaterThanOrEqual(delta.digestedBytes, 100)
+    }
+
+    func testProcessCountersIncludeOtherThreads() throws {
+        guard _CryptoInstrumentation.isEnabled else {
+            return
+        }
+
+        let before = _CryptoInstrumentation.process
+        let group = DispatchGroup()
+        DispatchQueue.global().async(group: group) {
+            var hasher = SHA256()
+            hasher.update(data: Data(repeating: 0, count: 64))
+            _ = hasher.finalize()
+        }
+        XCTAssertEqual(group.wait(timeout: .now() + 10), .success)
+
+        let delta = _CryptoInstrumentation.process.subtracting(before)
+        XCTAssertGreaterThanOrEqual(delta.digestedBytes, 64)
+    }
+
+    func testLockContentionIsMeasuredOnlyWhenEnabled() throws {
+        guard _CryptoInstrumentation.isEnabled else {
+            for site in _CryptoInstrumentation.LockSite.allCases {
+                XCTAssertEqual(_CryptoInstrumentation.lockContention(at: site), _CryptoInstrumentation.LockContention())
+            }
+            return
+        }
+
+        let before = _CryptoInstrumentation.lockContention(at: .compactKeyPool)
+        let pool = AES.GCM._CompactKeyPool(hotCapacity: 4)
+        let keys = try (0..<16).map { _ in try pool.key(SymmetricKey(size: .bits128)) }
+        let message = Data(repeating: 0x2a, count: 16)
+        DispatchQueue.concurrentPerform(iterations: 8) { thread in
+            for round in 0..<500 {
+                _ = try! keys[(thread + round) % keys.count].seal(message)
+            }
+        }
+        let after = _CryptoInstrumentation.lockContention(at: .compactKeyPool)
+        XCTAssertGreaterThanOrEqual(after.contendedAcquisitions, before.contendedAcquisitions)
+        XCTAssertGreaterThanOrEqual(after.waitNanoseconds, before.waitNanoseconds)
+        XCTAssertLessThanOrEqual(after.sleeps - before.sleeps, after.contendedAcquisitions - before.contendedAcquisitions)
+    }
+}
@@ -0,0 +1,101 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class KeyAgreementAEADKeysTests: XCTestCase {
+    let salt = Data("salt".utf8)
+    let sharedInfo = Data("shared info".utf8)
+    let message = Data("hello, world".utf8)
+
+    func testCurve25519KeysMatchDerivedKeys() throws {
+        let privateKey = Curve25519.KeyAgreement.PrivateKey()
+        let peer = Curve25519.KeyAgreement.PrivateKey().publicKey
+        let sharedSecret = try privateKey.sharedSecretFromKeyAgreement(with: peer)
+
+        for outputByteCount in [16, 24, 32] {
+            let expected = sharedSecret.hkdfDerivedSymmetricKey(using: SHA256.self, salt: self.salt, sharedInfo: self.sharedInfo, outputByteCount: outputByteCount)
+            let prepared = try privateKey._preparedAESGCMKey(agreeingWith: peer, using: SHA256.self, salt: self.salt, sharedInfo: self.sharedInfo, outputByteCount: outputByteCount)
+            try self.assertSameKey(prepared, expected)
+        }
+
+        try self.assertSameChaChaPolyKey(SHA384.self, privateKey: privateKey, peer: peer)
+        try self.assertSameChaChaPolyKey(SHA512.self, privateKey: privateKey, peer: peer)
+    }
+
+    func testP256KeysMatchDerivedKeys() throws {
+        let privateKey = P256.KeyAgreement.PrivateKey()
+        let peer = P256.KeyAgreement.PrivateKey().publicKey
+        let sharedSecret = try privateKey.sharedSecretFromKeyAgreement(with: peer)
+
+        let expected = sharedSecret.hkdfDerivedSymmetricKey(using: SHA256.self, salt: self.salt, sharedInfo: self.sharedInfo, outputByteCount: 16)
+        try self.assertSameKey(
+            privateKey._preparedAESGCMKey(agreeingWith: peer, using: SHA256.self, salt: self.salt, sharedInfo: self.sharedInfo, outputByteCount: 16),
+            expected
+        )
+        try self.assertSameKey(
+            privateKey._raw._preparedAESGCMKey(agreeingWith: peer, using: SHA256.self, salt: self.salt, sharedInfo: self.sharedInfo, outputByteCount: 16),
+            expected
+        )
+
+        let expectedChaChaPoly = sharedSecret.hkdfDerivedSymmetricKey(using: SHA384.self, salt: self.salt, sharedInfo: self.sharedInfo, outputByteCount: 32)
+        let box = try ChaChaPoly.seal(self.message, using: expectedChaChaPoly)
+        let prepared = try privateKey._preparedChaChaPolyKey(agreeingWith: peer, using: SHA384.self, salt: self.salt, sharedInfo: self.sharedInfo)
+        XCTAssertEqual(try prepared.open(box), self.message)
+    }
+
+    func testOtherHashFunctionsTakeTheUsualRoute() throws {
+        let privateKey = P256.KeyAgreement.PrivateKey()
+        let peer = P256.KeyAgreement.PrivateKey().publicKey
+        let expected = try privateKey.sharedSecretFromKeyAgreement(with: peer)
+            .hkdfDerivedSymmetricKey(using: Insecure.SHA1.self, salt: self.salt, sharedInfo: self.sharedInfo, outputByteCount: 32)
+        try self.assertSameKey(
+            privateKey._preparedAESGCMKey(agreeingWith: peer, using: Insecure.SHA1.self, salt: self.salt, sharedInfo: self.sharedInfo),
+            expected
+        )
+    }
+
+    func testRejectsUnsupportedKeySizes() throws {
+        let privateKey = Curve25519.KeyAgreement.PrivateKey()
+        let peer = Curve25519.KeyAgreement.PrivateKey().publicKey
+        XCTAssertThrowsError(try privateKey._preparedAESGCMKey(agreeingWith: peer, using: SHA256.self, salt: self.salt, sharedInfo: self.sharedInfo, outputByteCount: 20)) { error in
+            guard case .some(.incorrectKeySize) = error as? CryptoKitError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+    }
+
+    private func assertSameKey(_ prepared: AES.GCM._PreparedKey, _ key: SymmetricKey, file: StaticString = #filePath, line: UInt = #line) throws {
+        let nonce = AES.GCM.Nonce()
+        let expected = try AES.GCM.seal(self.message, using: key, nonce: nonce, authenticating: self.sharedInfo)
+        let sealed = try prepared.seal(self.message, nonce: nonce, authenticating: self.sharedInfo)
+        XCTAssertEqual(sealed.combined, expected.combined, file: file, line: line)
+    }
+
+    private func assertSameChaChaPolyKey<H: HashFunction>(
+        _ hashFunction: H.Type,
+        privateKey: Curve25519.KeyAgreement.PrivateKey,
+        peer: Curve25519.KeyAgreement.PublicKey
+    ) throws {
+        let key = try privateKey.sharedSecretFromKeyAgreement(with: peer)
+            .hkdfDerivedSymmetricKey(using: hashFunction, salt: self.salt, sharedInfo: self.sharedInfo, outputByteCount: 32)
+        let prepared = try privateKey._preparedChaChaPolyKey(agreeingWith: peer, using: hashFunction, salt: self.salt, sharedInfo: self.sharedInfo)
+        let nonce = ChaChaPoly.Nonce()
+        let expected = try ChaChaPoly.seal(self.message, using: key, nonce: nonce)
+        XCTAssertEqual(try prepared.seal(self.message, nonce: nonce).combined, expected.combined)
+    }
+}
@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class Kyber768Tests: XCTestCase {
+    func testEncapsulateDecapsulate() throws {
+        let privateKey = try _Kyber768.PrivateKey.generate()
+        let result = try privateKey.publicKey.encapsulate()
+        XCTAssertEqual(result.encapsulated.count, _Kyber768.ciphertextByteCount)
+        XCTAssertEqual(result.sharedSecret.bitCount, 256)
+        XCTAssertEqual(try privateKey.decapsulate(result.encapsulated), result.sharedSecret)
+
+        // A parsed key is reused across encapsulations, and each one is fresh.
+        let other = try privateKey.publicKey.encapsulate()
+        XCTAssertNotEqual(other.encapsulated, result.encapsulated)
+        XCTAssertEqual(try privateKey.decapsulate(other.encapsulated), other.sharedSecret)
+    }
+
+    func testKeyRoundTrips() throws {
+        let privateKey = _Kyber768.PrivateKey()
+        let publicKey = try _Kyber768.PublicKey(rawRepresentation: privateKey.publicKey.rawRepresentation)
+        XCTAssertEqual(publicKey.rawRepresentation.count, _Kyber768.publicKeyByteCount)
+        XCTAssertEqual(publicKey.rawRepresentation, privateKey.publicKey.rawRepresentation)
+
+        let restored = try _Kyber768.PrivateKey(rawRepresentation: privateKey.rawRepresentation)
+        XCTAssertEqual(restored.rawRepresentation.count, _Kyber768.privateKeyByteCount)
+        XCTAssertEqual(restored.publicKey.rawRepresentation, publicKey.rawRepresentation)
+
+        let result = try publicKey.encapsulate()
+        XCTAssertEqual(try restored.decapsulate(result.encapsulated), result.sharedSecret)
+    }
+
+    func testRejectsWrongSizes() throws {
+        let privateKey = _Kyber768.PrivateKey()
+        XCTAssertThrowsError(try _Kyber768.PublicKey(rawRepresentation: privateKey.publicKey.rawRepresentation.dropLast()))
+        XCTAssertThrowsError(try _Kyber768.PrivateKey(rawRepresentation: Data(count: 32)))
+        XCTAssertThrowsError(try privateKey.decapsulate(Data(count: _Kyber768.ciphertextByteCount - 1)))
+    }
+
+    func testTamperedCiphertextGivesADifferentSecret() throws {
+        let privateKey = _Kyber768.PrivateKey()
+        let result = try privateKey.publicKey.encapsulate()
+        var tampered = result.encapsulated
+        tampered[tampered.startIndex] ^= 1
+        XCTAssertNotEqual(try privateKey.decapsulate(tampered), result.sharedSecret)
+    }
+
+    func testCachedPublicKeys() throws {
+        _Kyber768.PublicKey._removeAllCachedKeys()
+        defer {
+            _Kyber768.PublicKey._removeAllCachedKeys()
+        }
+
+        let privateKey = _Kyber768.PrivateKey()
+        let encoded = privateKey.publicKey.rawRepresentation
+        let first = try _Kyber768.PublicKey._cached(rawRepresentation: encoded)
+        let second = try _Kyber768.PublicKey._cached(rawRepresentation: encoded)
+        XCTAssertTrue(first.backing === second.backing)
+        XCTAssertEqual(second.rawRepresentation, encoded)
+
+        let result = try second.encapsulate()
+        XCTAssertEqual(try privateKey.decapsulate(result.encapsulated), result.sharedSecret)
+
+        XCTAssertThrowsError(try _Kyber768.PublicKey._cached(rawRepresentation: encoded.dropLast()))
+    }
+
+    func testHybridHPKE() throws {
+        let privateKey = HPKE._X25519Kyber768Draft00.PrivateKey()
+        let publicKey = try HPKE._X25519Kyber768Draft00.PublicKey(rawRepresentation: privateKey.publicKey.rawRepresentation)
+        let info = Data("hybrid".utf8)
+
+        var sender = try HPKE._HybridSender(recipientKey: publicKey, kdf: .HKDF_SHA256, aead: .AES_GCM_128, info: info)
+        XCTAssertEqual(sender.encapsulatedKey.count, HPKE._X25519Kyber768Draft00.encapsulatedKeyByteCount)
+        var recipient = try HPKE._HybridRecipient(privateKey: privateKey, kdf: .HKDF_SHA256, aead: .AES_GCM_128, info: info, encapsulatedKey: sender.encapsulatedKey)
+
+        for index in 0..<4 {
+            let message = Data(repeating: UInt8(index), count: index * 100)
+            let aad = [UInt8(index)]
+            let ciphertext = try sender.seal(message, authenticating: aad)
+            XCTAssertEqual(try recipient.open(ciphertext, authenticating: aad), message)
+        }
+
+        var mismatched = try HPKE._HybridRecipient(privateKey: privateKey, kdf: .HKDF_SHA256, aead: .AES_GCM_128, info: Data(), encapsulatedKey: sender.encapsulatedKey)
+        XCTAssertThrowsError(try mismatched.open(try sender.seal(Data("hello".utf8))))
+    }
+
+    func testHybridSharedSecretCombinesBothHalves() throws {
+        let privateKey = try HPKE._X25519Kyber768Draft00.PrivateKey.generate()
+        let result = try privateKey.publicKey.encapsulate()
+        XCTAssertEqual(result.sharedSecret.bitCount, 512)
+        XCTAssertEqual(try privateKey.decapsulate(result.encapsulated), result.sharedSecret)
+
+        let kyberOnly = try privateKey.kyber.decapsulate(result.encapsulated.dropFirst(32))
+        XCTAssertEqual(result.sharedSecret.withUnsafeBytes { Array($0.suffix(32)) }, kyberOnly.withUnsafeBytes { Array($0) })
+    }
+}
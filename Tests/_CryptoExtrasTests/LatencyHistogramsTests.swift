@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class LatencyHistogramsTests: XCTestCase {
+    func testSampledOperationsAreCountedPerSeries() throws {
+        let before = _CryptoLatency.snapshot()
+        _CryptoLatency.sampleInterval = 1
+        defer {
+            _CryptoLatency.sampleInterval = 0
+        }
+
+        let key = SymmetricKey(size: .bits128)
+        for _ in 0..<10 {
+            _ = try AES.GCM.seal(Data(repeating: 0, count: 100), using: key)
+        }
+        let signingKey = P384.Signing.PrivateKey()
+        for _ in 0..<3 {
+            _ = try signingKey.signature(for: Data("message".utf8))
+        }
+
+        guard _CryptoLatency.isEnabled else {
+            XCTAssertEqual(_CryptoLatency.sampleInterval, 0)
+            XCTAssertTrue(_CryptoLatency.snapshot().isEmpty)
+            return
+        }
+        XCTAssertEqual(_CryptoLatency.sampleInterval, 1)
+
+        let after = _CryptoLatency.snapshot()
+        func samples(_ matching: (_CryptoLatency.Series) -> Bool) -> UInt64 {
+            after.filter { matching($0.key) }.reduce(0) { total, entry in
+                total + entry.value.subtracting(before[entry.key] ?? .init(bucketCounts: [])).count
+            }
+        }
+        // Other tests may be running crypto at the same time, so these are lower bounds.
+        XCTAssertGreaterThanOrEqual(samples { $0.operation == .aeadSeal && $0.keyBits == 128 && $0.maxMessageSize == 1024 }, 10)
+        XCTAssertGreaterThanOrEqual(samples { $0.operation == .ecdsaSign && $0.keyBits == 384 && $0.maxMessageSize == nil }, 3)
+    }
+
+    func testPercentilesAreBucketUpperBounds() {
+        var histogram = _CryptoLatency.Histogram(bucketCounts: Array(repeating: 0, count: 40))
+        XCTAssertNil(histogram.percentile(0.5))
+
+        histogram.bucketCounts[3] = 50
+        histogram.bucketCounts[30] = 49
+        histogram.bucketCounts[39] = 1
+        XCTAssertEqual(histogram.count, 100)
+        XCTAssertEqual(histogram.percentile(0.5), _CryptoLatency.upperBound(ofBucket: 3))
+        XCTAssertEqual(histogram.percentile(0.99), _CryptoLatency.upperBound(ofBucket: 30))
+        XCTAssertEqual(histogram.percentile(1), _CryptoLatency.upperBound(ofBucket: 39))
+    }
+}
@@ -0,0 +1,119 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class MultiScalarMultiplicationTests: XCTestCase {
+    let p256OrderMinusOne = try! Array(hexString: "ffffffff00000000ffffffffffffffffbce6faada7179e84f3b9cac2fc632550")
+    let p384OrderMinusOne = try! Array(hexString: "ffffffffffffffffffffffffffffffffffffffffffffffffc7634d81f4372ddf581a0db248b0a77aecec196accc52972")
+
+    /// `value` as a big-endian scalar of `byteCount` bytes.
+    func scalar(_ value: UInt64, byteCount: Int) -> [UInt8] {
+        [UInt8](repeating: 0, count: byteCount - 8) + (0..<8).reversed().map { UInt8(truncatingIfNeeded: value >> ($0 * 8)) }
+    }
+
+    func testP256MatchesScalarSum() throws {
+        // Points k·G and scalars s, so the sum is (Σ k·s)·G. Enough terms to use several threads.
+        for count in [1, 2, 17, 300] {
+            let ks = (0..<count).map { UInt64($0 * 7 + 1) }
+            let ss = (0..<count).map { UInt64($0 * 13 + 5) }
+            let points = try ks.flatMap { k in
+                Array(try P256.Signing.PrivateKey(rawRepresentation: scalar(k, byteCount: 32)).publicKey.x963Representation)
+            }
+            let scalars = ss.flatMap { scalar($0, byteCount: 32) }
+            let expected = try P256.KeyAgreement.PrivateKey(
+                rawRepresentation: scalar(zip(ks, ss).map { $0 * $1 }.reduce(0, +), byteCount: 32)
+            ).publicKey
+
+            for threads in [1, 4] {
+                let sum = try scalars.withUnsafeBytes { scalars in
+                    try points.withUnsafeBytes { points in
+                        try P256._multiScalarMultiplication(scalars: scalars, points: points, maximumThreadCount: threads)
+                    }
+                }
+                XCTAssertEqual(sum?.x963Representation, expected.x963Representation)
+            }
+        }
+    }
+
+    func testP384MatchesScalarSum() throws {
+        for count in [1, 3, 300] {
+            let ks = (0..<count).map { UInt64($0 * 11 + 2) }
+            let ss = (0..<count).map { UInt64($0 * 3 + 1) }
+            let points = try ks.flatMap { k in
+                Array(try P384.Signing.PrivateKey(rawRepresentation: scalar(k, byteCount: 48)).publicKey.x963Representation)
+            }
+            let scalars = ss.flatMap { scalar($0, byteCount: 48) }
+            let expected = try P384.KeyAgreement.PrivateKey(
+                rawRepresentation: scalar(zip(ks, ss).map { $0 * $1 }.reduce(0, +), byteCount: 48)
+            ).publicKey
+
+            let sum = try scalars.withUnsafeBytes { scalars in
+                try points.withUnsafeBytes { points in
+                    try P384._multiScalarMultiplication(scalars: scalars, points: points, maximumThreadCount: 2)
+                }
+            }
+            XCTAssertEqual(sum?.x963Representation, expected.x963Representation)
+        }
+    }
+
+    func testCancellingTermsSumToInfinity() throws {
+        // (n - 1)·P + 1·P is the point at infinity, and so is an empty sum.
+        let p256Point = Array(P256.KeyAgreement.PrivateKey().publicKey.x963Representation)
+        let p256Scalars = p256OrderMinusOne + scalar(1, byteCount: 32)
+        let p256Sum = try p256Scalars.withUnsafeBytes { scalars in
+            try (p256Point + p256Point).withUnsafeBytes { points in
+                try P256._multiScalarMultiplication(scalars: scalars, points: points)
+            }
+        }
+        XCTAssertNil(p256Sum)
+        XCTAssertNil(try P256._multiScalarMultiplication(scalars: UnsafeRawBufferPointer(start: nil, count: 0), points: UnsafeRawBufferPointer(start: nil, count: 0)))
+
+        let p384Point = Array(P384.KeyAgreement.PrivateKey().publicKey.x963Representation)
+        let p384Scalars = p384OrderMinusOne + scalar(1, byteCount: 48)
+        let p384Sum = try p384Scalars.withUnsafeBytes { scalars in
+            try (p384Point + p384Point).withUnsafeBytes { points in
+                try P384._multiScalarMultiplication(scalars: scalars, points: points)
+            }
+        }
+        XCTAssertNil(p384Sum)
+    }
+
+    func testInvalidInputsAreRejected() throws {
+        let point = Array(P256.KeyAgreement.PrivateKey().publicKey.x963Representation)
+        let one = scalar(1, byteCount: 32)
+
+        // Mismatched counts and partial elements.
+        for (scalars, points) in [(one + one, point), (Array(one.dropLast()), point), (one, Array(point.dropLast()))] {
+            XCTAssertThrowsError(try scalars.withUnsafeBytes { scalars in
+                try points.withUnsafeBytes { try P256._multiScalarMultiplication(scalars: scalars, points: $0) }
+            }) { error in
+                guard case CryptoKitError.incorrectParameterSize = error else {
+                    return XCTFail("Unexpected error \(error)")
+                }
+            }
+        }
+
+        // A scalar not below the order, and a point not on the curve.
+        var offCurve = point
+        offCurve[64] ^= 1
+        for (scalars, points) in [([UInt8](repeating: 0xff, count: 32), point), (one, offCurve)] {
+            XCTAssertThrowsError(try scalars.withUnsafeBytes { scalars in
+                try points.withUnsafeBytes { try P256._multiScalarMultiplication(scalars: scalars, points: $0) }
+            })
+        }
+    }
+}
@@ -0,0 +1,123 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class P256RawKeyAgreementTests: XCTestCase {
+    func testMatchesSharedSecretFromKeyAgreement() throws {
+        for _ in 0..<8 {
+            let privateKey = P256.KeyAgreement.PrivateKey()
+            let peer = P256.KeyAgreement.PrivateKey()
+            let expected = try privateKey.sharedSecretFromKeyAgreement(with: peer.publicKey).withUnsafeBytes { Array($0) }
+
+            let peerPoint = Array(peer.publicKey.x963Representation)
+            var fromRawBytes = [UInt8](repeating: 0, count: 32)
+            try Array(privateKey.rawRepresentation).withUnsafeBytes { scalar in
+                try peerPoint.withUnsafeBytes { peerPoint in
+                    try fromRawBytes.withUnsafeMutableBytes { output in
+                        try P256.KeyAgreement._sharedSecret(privateKey: scalar, peerPublicKey: peerPoint, into: output)
+                    }
+                }
+            }
+            XCTAssertEqual(fromRawBytes, expected)
+
+            var fromRawKey = [UInt8](repeating: 0, count: 32)
+            let rawKey = privateKey._raw
+            try peerPoint.withUnsafeBytes { peerPoint in
+                try fromRawKey.withUnsafeMutableBytes { output in
+                    try rawKey.sharedSecret(withX963PeerPublicKey: peerPoint, into: output)
+                }
+            }
+            XCTAssertEqual(fromRawKey, expected)
+        }
+    }
+
+    func testRejectsInvalidInputs() throws {
+        let rawKey = P256.KeyAgreement.PrivateKey()._raw
+        var output = [UInt8](repeating: 0, count: 32)
+
+        var offCurve = Array(P256.KeyAgreement.PrivateKey().publicKey.x963Representation)
+        offCurve[64] ^= 1
+        XCTAssertThrowsError(try offCurve.withUnsafeBytes { peerPoint in
+            try output.withUnsafeMutableBytes { try rawKey.sharedSecret(withX963PeerPublicKey: peerPoint, into: $0) }
+        })
+
+        let compressed = Array(P256.KeyAgreement.PrivateKey().publicKey.compressedRepresentation)
+        XCTAssertThrowsError(try compressed.withUnsafeBytes { peerPoint in
+            try output.withUnsafeMutableBytes { try rawKey.sharedSecret(withX963PeerPublicKey: peerPoint, into: $0) }
+        }) { error in
+            guard case CryptoKitError.incorrectParameterSize = error else { return XCTFail("Unexpected error: \(error)") }
+        }
+
+        let peerPoint = Array(P256.KeyAgreement.PrivateKey().publicKey.x963Representation)
+        let zeroScalar = [UInt8](repeating: 0, count: 32)
+        XCTAssertThrowsError(try zeroScalar.withUnsafeBytes { scalar in
+            try peerPoint.withUnsafeBytes { peerPoint in
+                try output.withUnsafeMutableBytes { try P256.KeyAgreement._sharedSecret(privateKey: scalar, peerPublicKey: peerPoint, into: $0) }
+            }
+        })
+    }
+
+    func testBatchMatchesSharedSecretFromKeyAgreement() throws {
+        // Counts around the eight-lane groups of the vector implementation.
+        for count in [0, 1, 7, 8, 9, 33] {
+            let privateKeys = (0..<count).map { _ in P256.KeyAgreement.PrivateKey() }
+            let peers = (0..<count).map { _ in P256.KeyAgreement.PrivateKey().publicKey }
+            let expected = try zip(privateKeys, peers).flatMap { privateKey, peer in
+                try privateKey.sharedSecretFromKeyAgreement(with: peer).withUnsafeBytes { Array($0) }
+            }
+
+            let scalars = privateKeys.flatMap { Array($0.rawRepresentation) }
+            let points = peers.flatMap { Array($0.x963Representation) }
+            var secrets = [UInt8](repeating: 0, count: count * 32)
+            try scalars.withUnsafeBytes { scalars in
+                try points.withUnsafeBytes { points in
+                    try secrets.withUnsafeMutableBytes { output in
+                        try P256.KeyAgreement._sharedSecrets(privateKeys: scalars, peerPublicKeys: points, into: output)
+                    }
+                }
+            }
+            XCTAssertEqual(secrets, expected)
+        }
+    }
+
+    func testBatchRejectsInvalidInputs() throws {
+        let scalars = (0..<9).flatMap { _ in Array(P256.KeyAgreement.PrivateKey().rawRepresentation) }
+        var points = (0..<9).flatMap { _ in Array(P256.KeyAgreement.PrivateKey().publicKey.x963Representation) }
+        var secrets = [UInt8](repeating: 0xaa, count: 9 * 32)
+
+        XCTAssertThrowsError(try scalars.withUnsafeBytes { scalars in
+            try points.dropLast().withUnsafeBytes { points in
+                try secrets.withUnsafeMutableBytes {
+                    try P256.KeyAgreement._sharedSecrets(privateKeys: scalars, peerPublicKeys: points, into: $0)
+                }
+            }
+        }) { error in
+            guard case CryptoKitError.incorrectParameterSize = error else { return XCTFail("Unexpected error: \(error)") }
+        }
+
+        // One point off the curve fails the whole batch and clears every secret.
+        points[5 * 65 + 64] ^= 1
+        XCTAssertThrowsError(try scalars.withUnsafeBytes { scalars in
+            try points.withUnsafeBytes { points in
+                try secrets.withUnsafeMutableBytes {
+                    try P256.KeyAgreement._sharedSecrets(privateKeys: scalars, peerPublicKeys: points, into: $0)
+                }
+            }
+        })
+        XCTAssertEqual(secrets, [UInt8](repeating: 0, count: 9 * 32))
+    }
+}
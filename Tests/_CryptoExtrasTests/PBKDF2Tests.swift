@@ -0,0 +1,114 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class PBKDF2Tests: XCTestCase {
+    func testSHA256Vectors() throws {
+        // RFC 7914, section 11.
+        let short = try _PBKDF2<SHA256>.deriveKey(from: Array("password".utf8), salt: Array("salt".utf8), outputByteCount: 32, rounds: 1)
+        XCTAssertEqual(
+            short.withUnsafeBytes { Array($0) },
+            try Array(hexString: "120fb6cffcf8b32c43e7225256c4f837a86548c92ccc35480805987cb70be17b")
+        )
+
+        // A long password and salt, and an output that ends part-way through the second block.
+        let long = try _PBKDF2<SHA256>.deriveKey(
+            from: Array("passwordPASSWORDpassword".utf8),
+            salt: Array("saltSALTsaltSALTsaltSALTsaltSALTsalt".utf8),
+            outputByteCount: 40,
+            rounds: 4096
+        )
+        XCTAssertEqual(
+            long.withUnsafeBytes { Array($0) },
+            try Array(hexString: "348c89dbcbd32b2f32d814b8116e84cf2b17347ebc1800181c4e2a1fb8dd53e1c635518c7dac47e9")
+        )
+    }
+
+    func testOtherHashFunctions() throws {
+        let sha1 = try _PBKDF2<Insecure.SHA1>.deriveKey(from: Array("password".utf8), salt: Array("salt".utf8), outputByteCount: 20, rounds: 2)
+        XCTAssertEqual(sha1.withUnsafeBytes { Array($0) }, try Array(hexString: "ea6c014dc72d6f8ccd1ed92ace1d41f0d8de8957"))
+
+        let sha512 = try _PBKDF2<SHA512>.deriveKey(from: Array("password".utf8), salt: Array("salt".utf8), outputByteCount: 64, rounds: 2)
+        XCTAssertEqual(
+            sha512.withUnsafeBytes { Array($0) },
+            try Array(hexString: "e1d9c16aa681708a45f5c7c4e215ceb66e011a2e9f0040713f18aefdb866d53cf76cab2868a39b9f7840edce4fef5a82be67335c77a6068e04112754f27ccf4e")
+        )
+
+        // BoringSSL has no MD5 PBKDF2 path, so this exercises the generic implementation.
+        let md5 = try _PBKDF2<Insecure.MD5>.deriveKey(from: Array("password".utf8), salt: Array("salt".utf8), outputByteCount: 40, rounds: 3)
+        XCTAssertEqual(
+            md5.withUnsafeBytes { Array($0) },
+            try Array(hexString: "f6acd4bda3e4d3d831a5f61da9ca9d5c3877566e979f4928778d81be4f2e9433a31043bbf3945c35")
+        )
+    }
+
+    func testBatchMatchesSingleDerivations() throws {
+        // Eleven passwords of two blocks each fill two full sets of eight lanes and part of a third.
+        let storage = [UInt8]((0..<512).map { UInt8(truncatingIfNeeded: $0 &* 29) })
+        let passwordRanges = (0..<11).map { ($0 * 7)..<($0 * 7 + $0 * 3) }
+        let saltRanges = (0..<11).map { (200 + $0 * 16)..<(216 + $0 * 16) }
+        let expected = try zip(passwordRanges, saltRanges).map { passwordRange, saltRange in
+            try _PBKDF2<SHA256>.deriveKey(from: storage[passwordRange], salt: storage[saltRange], outputByteCount: 48, rounds: 100)
+        }
+
+        let keys = try storage.withUnsafeBytes { storage in
+            try _PBKDF2<SHA256>.deriveKeys(
+                batch: passwordRanges.map { UnsafeRawBufferPointer(rebasing: storage[$0]) },
+                salts: saltRanges.map { UnsafeRawBufferPointer(rebasing: storage[$0]) },
+                outputByteCount: 48,
+                rounds: 100
+            )
+        }
+        XCTAssertEqual(keys, expected)
+
+        let single = try Array("pw0salt0".utf8).withUnsafeBytes { bytes in
+            try _PBKDF2<SHA256>.deriveKeys(
+                batch: [UnsafeRawBufferPointer(rebasing: bytes[0..<3])],
+                salts: [UnsafeRawBufferPointer(rebasing: bytes[3...])],
+                outputByteCount: 48,
+                rounds: 1000
+            )
+        }
+        XCTAssertEqual(
+            single.map { $0.withUnsafeBytes { Array($0) } },
+            [try Array(hexString: "c944529d9d9165bca12a22a77b78b8459917afdbdb261b81cece49155b2cdd7c83bda5e9d3ca14314726072bc669ab60")]
+        )
+        XCTAssertEqual(try _PBKDF2<SHA256>.deriveKeys(batch: [], salts: [], outputByteCount: 32, rounds: 1), [])
+    }
+
+    func testInvalidParameters() throws {
+        XCTAssertThrowsError(try _PBKDF2<SHA256>.deriveKey(from: [UInt8](), salt: [UInt8](), outputByteCount: 32, rounds: 0)) { error in
+            guard case .some(.invalidParameter) = error as? CryptoKitError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+        XCTAssertThrowsError(try _PBKDF2<SHA256>.deriveKey(from: [UInt8](), salt: [UInt8](), outputByteCount: 0, rounds: 1)) { error in
+            guard case .some(.incorrectParameterSize) = error as? CryptoKitError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+        XCTAssertThrowsError(try _PBKDF2<SHA256>.deriveKeys(batch: [], salts: [UnsafeRawBufferPointer(start: nil, count: 0)], outputByteCount: 32, rounds: 1)) { error in
+            guard case .some(.incorrectParameterSize) = error as? CryptoKitError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+    }
+}
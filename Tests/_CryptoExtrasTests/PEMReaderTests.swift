@@ -0,0 +1,75 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class PEMReaderTests: XCTestCase {
+    private func writeTemporaryFile(_ contents: String) throws -> String {
+        let path = NSTemporaryDirectory() + "PEMReaderTests-\(UUID().uuidString).pem"
+        try Data(contents.utf8).write(to: URL(fileURLWithPath: path))
+        addTeardownBlock {
+            try? FileManager.default.removeItem(atPath: path)
+        }
+        return path
+    }
+
+    func testReadsEveryDocumentInABundle() throws {
+        let payloads = (0..<5).map { index in Data((0..<(index * 37 + 1)).map { UInt8(truncatingIfNeeded: $0 &* 7) }) }
+        var bundle = "# A comment before the first document\n"
+        for (index, payload) in payloads.enumerated() {
+            bundle += "# Document \(index)\n"
+            bundle += ASN1.PEMDocument(type: "TEST \(index)", derBytes: payload).pemString
+            bundle += "\n\n"
+        }
+        // Windows line endings must also be accepted.
+        bundle = bundle.replacingOccurrences(of: "\n", with: "\r\n")
+
+        for chunkSize in [1, 7, 64, 64 * 1024] {
+            var reader = try _PEMReader(contentsOfFile: self.writeTemporaryFile(bundle), chunkSize: chunkSize)
+            var documents = [_PEMReader.Document]()
+            while let document = try reader.next() {
+                documents.append(document)
+            }
+            XCTAssertEqual(documents.map { $0.type }, (0..<5).map { "TEST \($0)" })
+            XCTAssertEqual(documents.map { $0.derBytes }, payloads)
+            XCTAssertNil(try reader.next())
+        }
+    }
+
+    func testTruncatedDocumentIsRejected() throws {
+        let pem = ASN1.PEMDocument(type: "TEST", derBytes: Data(repeating: 1, count: 100)).pemString
+        let truncated = String(pem.dropLast(10))
+
+        var reader = try _PEMReader(contentsOfFile: self.writeTemporaryFile(pem + "\n" + truncated), chunkSize: 16)
+        XCTAssertNotNil(try reader.next())
+        XCTAssertThrowsError(try reader.next()) { error in
+            guard case .some(.invalidPEMDocument) = error as? _CryptoRSAError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+    }
+
+    func testEmptyInput() throws {
+        var reader = try _PEMReader(contentsOfFile: self.writeTemporaryFile("no documents here\n"))
+        XCTAssertNil(try reader.next())
+    }
+
+    func testMissingFile() {
+        XCTAssertThrowsError(try _PEMReader(contentsOfFile: "/nonexistent/\(UUID().uuidString).pem"))
+    }
+}
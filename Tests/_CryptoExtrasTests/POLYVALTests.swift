@@ -0,0 +1,60 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class POLYVALTests: XCTestCase {
+    func testRFC8452Vector() throws {
+        // RFC 8452, appendix A.
+        let key = try _POLYVAL.PreparedKey(SymmetricKey(data: try Array(hexString: "25629347589242761d31f826ba4b757b")))
+        let data = try Array(hexString: "4f4f95668c83dfb6401762bb2d01a262d1a24ddd2721d006bbe45f20d3c9f362")
+        XCTAssertEqual(Array(_POLYVAL.hash(data: data, using: key)), try Array(hexString: "f7a3b47b846119fae5b7866cf5e5b77e"))
+    }
+
+    func testStreamingMatchesOneShot() throws {
+        let key = try _POLYVAL.PreparedKey(SymmetricKey(size: .bits128))
+        let data = [UInt8]((0..<1000).map { UInt8(truncatingIfNeeded: $0 &* 5) })
+        let expected = _POLYVAL.hash(data: data, using: key)
+
+        for chunkByteCount in [1, 5, 16, 100] {
+            var polyval = _POLYVAL(key: key)
+            var offset = 0
+            while offset < data.count {
+                let end = min(offset + chunkByteCount, data.count)
+                data[offset..<end].withUnsafeBytes { polyval.update(bufferPointer: $0) }
+                offset = end
+            }
+            XCTAssertEqual(polyval.finalize(), expected)
+        }
+    }
+
+    func testPartialBlockIsZeroPadded() throws {
+        let key = try _POLYVAL.PreparedKey(SymmetricKey(size: .bits128))
+        let data: [UInt8] = [1, 2, 3]
+        XCTAssertEqual(_POLYVAL.hash(data: data, using: key), _POLYVAL.hash(data: data + [UInt8](repeating: 0, count: 13), using: key))
+        XCTAssertEqual(_POLYVAL.hash(data: [UInt8](), using: key), Data(repeating: 0, count: 16))
+    }
+
+    func testRejectsInvalidKeySizes() throws {
+        XCTAssertThrowsError(try _POLYVAL.PreparedKey(SymmetricKey(size: .bits256))) { error in
+            guard case .some(.incorrectKeySize) = error as? CryptoKitError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+    }
+}
@@ -0,0 +1,122 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class PreparedPublicKeyStoreTests: XCTestCase {
+    func testKeysRoundTrip() throws {
+        let ed25519 = Curve25519.Signing.PrivateKey()
+        let p256 = P256.Signing.PrivateKey()
+        let rsa = try _RSA.Signing.PrivateKey(keySize: .bits2048)
+        let serialized = try _PreparedPublicKeyStore.serializedRepresentation(of: [
+            (identifier: "rsa", key: .rsa(rsa.publicKey)),
+            (identifier: "ed25519", key: .ed25519(ed25519.publicKey)),
+            (identifier: "p256", key: .p256(p256.publicKey)),
+        ])
+        let store = try _PreparedPublicKeyStore(serializedRepresentation: serialized)
+
+        XCTAssertEqual(store.count, 3)
+        XCTAssertEqual(store.identifiers, ["ed25519", "p256", "rsa"])
+        XCTAssertNil(store["missing"])
+
+        guard case .ed25519(let ed25519Key) = store["ed25519"] else {
+            return XCTFail("Expected an Ed25519 key")
+        }
+        XCTAssertEqual(ed25519Key.rawRepresentation, ed25519.publicKey.rawRepresentation)
+
+        guard case .p256(let p256Key) = store["p256"] else {
+            return XCTFail("Expected a P-256 key")
+        }
+        XCTAssertEqual(p256Key.x963Representation, p256.publicKey.x963Representation)
+
+        guard case .rsa(let rsaKey) = store["rsa"] else {
+            return XCTFail("Expected an RSA key")
+        }
+        XCTAssertEqual(rsaKey.derRepresentation, rsa.publicKey.derRepresentation)
+        let message = Data("hello".utf8)
+        let signature = try rsa.signature(for: message)
+        XCTAssertTrue(rsaKey.isValidSignature(signature, for: message))
+        XCTAssertFalse(rsaKey.isValidSignature(signature, for: Data("goodbye".utf8)))
+    }
+
+    func testEd25519VerificationMatchesPublicKey() throws {
+        let keys = (0..<10).map { _ in Curve25519.Signing.PrivateKey() }
+        let store = try _PreparedPublicKeyStore(serializedRepresentation: _PreparedPublicKeyStore.serializedRepresentation(
+            of: keys.enumerated().map { (identifier: "key \($0.offset)", key: .ed25519($0.element.publicKey)) }
+        ))
+
+        for (index, key) in keys.enumerated() {
+            let message = Data("message \(index)".utf8)
+            var signature = try key.signature(for: message)
+            XCTAssertTrue(store.isValidEd25519Signature(signature, for: message, keyIdentifier: "key \(index)"))
+            XCTAssertFalse(store.isValidEd25519Signature(signature, for: message, keyIdentifier: "key \((index + 1) % keys.count)"))
+            XCTAssertFalse(store.isValidEd25519Signature(signature, for: Data("other".utf8), keyIdentifier: "key \(index)"))
+            signature[0] ^= 1
+            XCTAssertFalse(store.isValidEd25519Signature(signature, for: message, keyIdentifier: "key \(index)"))
+        }
+        XCTAssertFalse(store.isValidEd25519Signature(Data(count: 64), for: Data(), keyIdentifier: "missing"))
+    }
+
+    func testStoreIsMappedFromFile() throws {
+        let key = Curve25519.Signing.PrivateKey()
+        let url = FileManager.default.temporaryDirectory.appendingPathComponent("prepared-keys-\(UUID()).bin")
+        defer {
+            try? FileManager.default.removeItem(at: url)
+        }
+        try _PreparedPublicKeyStore.serializedRepresentation(of: [(identifier: "key", key: .ed25519(key.publicKey))]).write(to: url)
+
+        let store = try _PreparedPublicKeyStore(contentsOf: url)
+        let message = Data("hello".utf8)
+        XCTAssertTrue(store.isValidEd25519Signature(try key.signature(for: message), for: message, keyIdentifier: "key"))
+    }
+
+    func testDuplicateIdentifiersAreRejected() throws {
+        let key = P256.Signing.PrivateKey().publicKey
+        XCTAssertThrowsError(try _PreparedPublicKeyStore.serializedRepresentation(of: [
+            (identifier: "key", key: .p256(key)),
+            (identifier: "key", key: .p256(key)),
+        ]))
+    }
+
+    func testCorruptionIsDetected() throws {
+        let serialized = try _PreparedPublicKeyStore.serializedRepresentation(of: [
+            (identifier: "key", key: .ed25519(Curve25519.Signing.PrivateKey().publicKey)),
+        ])
+
+        // Any flipped byte fails the digest.
+        for offset in [0, 12, 40, serialized.count / 2, serialized.count - 1] {
+            var corrupted = serialized
+            corrupted[offset] ^= 1
+            XCTAssertThrowsError(try _PreparedPublicKeyStore(serializedRepresentation: corrupted), "offset \(offset)")
+        }
+        // Truncation fails the length check even without the digest.
+        XCTAssertThrowsError(try _PreparedPublicKeyStore(serializedRepresentation: serialized.dropLast(), verifyingIntegrity: false))
+        XCTAssertThrowsError(try _PreparedPublicKeyStore(serializedRepresentation: Data()))
+
+        // An entry pointing past the end fails the bounds check even without the digest.
+        var outOfBounds = serialized
+        outOfBounds[32 + 16 + 7] = 0xff
+        XCTAssertThrowsError(try _PreparedPublicKeyStore(serializedRepresentation: outOfBounds, verifyingIntegrity: false))
+    }
+
+    func testEmptyStore() throws {
+        let store = try _PreparedPublicKeyStore(serializedRepresentation: _PreparedPublicKeyStore.serializedRepresentation(of: []))
+        XCTAssertEqual(store.count, 0)
+        XCTAssertEqual(store.identifiers, [])
+        XCTAssertNil(store["key"])
+    }
+}
@@ -0,0 +1,91 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class RSACompactPublicKeyTests: XCTestCase {
+    func testRoundTripsThroughPublicKey() throws {
+        let privateKey = try _RSA.Signing.PrivateKey(keySize: .bits2048)
+        let compact = try _RSA.Signing._CompactPublicKey(privateKey.publicKey)
+
+        XCTAssertEqual(compact.publicExponent, 65537)
+        XCTAssertEqual(compact.modulus.count, 256)
+        XCTAssertEqual(compact.keySizeInBits, privateKey.publicKey.keySizeInBits)
+        XCTAssertEqual(compact.pkcs1DERRepresentation, privateKey.publicKey.pkcs1DERRepresentation)
+        XCTAssertEqual(compact.publicKey.derRepresentation, privateKey.publicKey.derRepresentation)
+        XCTAssertEqual(try _RSA.Signing._CompactPublicKey(derRepresentation: privateKey.publicKey.derRepresentation), compact)
+    }
+
+    func testModulusAndExponent() throws {
+        let publicKey = try _RSA.Signing.PrivateKey(keySize: .bits2048).publicKey
+        let compact = try _RSA.Signing._CompactPublicKey(publicKey)
+
+        let padded = try _RSA.Signing._CompactPublicKey(modulus: [0, 0] + compact.modulus, publicExponent: 65537)
+        XCTAssertEqual(padded, compact)
+        XCTAssertEqual(padded.hashValue, compact.hashValue)
+        XCTAssertNotEqual(try _RSA.Signing._CompactPublicKey(modulus: compact.modulus, publicExponent: 3), compact)
+
+        XCTAssertThrowsError(try _RSA.Signing._CompactPublicKey(modulus: compact.modulus, publicExponent: 65536))
+        var evenModulus = compact.modulus
+        evenModulus[evenModulus.endIndex - 1] &= 0xFE
+        XCTAssertThrowsError(try _RSA.Signing._CompactPublicKey(modulus: evenModulus, publicExponent: 65537))
+        var smallModulus = Data(compact.modulus.prefix(128))
+        smallModulus[smallModulus.endIndex - 1] |= 1
+        XCTAssertThrowsError(try _RSA.Signing._CompactPublicKey(modulus: smallModulus, publicExponent: 65537)) { error in
+            guard case .some(.incorrectParameterSize) = error as? CryptoKitError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+    }
+
+    func testVerificationMatchesPublicKey() throws {
+        let privateKey = try _RSA.Signing.PrivateKey(keySize: .bits2048)
+        let compact = try _RSA.Signing._CompactPublicKey(privateKey.publicKey)
+        let cache = _RSA.Signing._CompactPublicKeyCache(capacity: 4, shards: 1)
+        let message = Data("hello".utf8)
+
+        for padding in [_RSA.Signing.Padding.PSS, .insecurePKCS1v1_5] {
+            let signature = try privateKey.signature(for: message, padding: padding)
+            XCTAssertTrue(compact.isValidSignature(signature, for: message, padding: padding))
+            XCTAssertTrue(compact.isValidSignature(signature, for: message, padding: padding, cachingIn: cache))
+            XCTAssertTrue(compact.isValidSignature(signature, for: SHA256.hash(data: message), padding: padding, cachingIn: cache))
+            XCTAssertFalse(compact.isValidSignature(signature, for: Data("goodbye".utf8), padding: padding))
+            XCTAssertFalse(compact.isValidSignature(signature, for: Data("goodbye".utf8), padding: padding, cachingIn: cache))
+        }
+
+        let statistics = cache.statistics
+        XCTAssertEqual(statistics.keyCount, 1)
+        XCTAssertEqual(statistics.misses, 1)
+        XCTAssertEqual(statistics.hits, 5)
+    }
+
+    func testCacheEvictsLeastRecentlyUsedKey() throws {
+        let cache = _RSA.Signing._CompactPublicKeyCache(capacity: 2, shards: 1)
+        let privateKeys = try (0..<3).map { _ in try _RSA.Signing.PrivateKey(keySize: .bits2048) }
+        let message = Data("hello".utf8)
+
+        for privateKey in privateKeys {
+            let compact = try _RSA.Signing._CompactPublicKey(privateKey.publicKey)
+            let signature = try privateKey.signature(for: message)
+            XCTAssertTrue(compact.isValidSignature(signature, for: message, padding: .PSS, cachingIn: cache))
+        }
+        XCTAssertEqual(cache.statistics, .init(keyCount: 2, capacity: 2, hits: 0, misses: 3, evictions: 1))
+
+        cache.removeAll()
+        XCTAssertEqual(cache.statistics.keyCount, 0)
+    }
+}
@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class ResumableHashTests: XCTestCase {
+    let message = Array((0..<1000).map { UInt8(truncatingIfNeeded: $0 &* 7) })
+
+    func checkHash<H: HashFunction>(_: H.Type) throws {
+        let expected = Data(H.hash(data: self.message))
+
+        for split in stride(from: 0, to: 300, by: 37) {
+            var prefix = try _ResumableHash<H>()
+            prefix.update(data: self.message[..<split])
+
+            var forked = prefix.fork()
+            forked.update(data: self.message[split...])
+            XCTAssertEqual(forked.finalize(), expected)
+
+            var resumed = try _ResumableHash<H>(midstate: prefix.midstate)
+            XCTAssertEqual(resumed.midstate, prefix.midstate)
+            resumed.update(data: self.message[split...])
+            XCTAssertEqual(resumed.finalize(), expected)
+        }
+    }
+
+    func testHashesMatchOneShot() throws {
+        try self.checkHash(SHA256.self)
+        try self.checkHash(SHA384.self)
+        try self.checkHash(SHA512.self)
+    }
+
+    func checkHMAC<H: HashFunction>(_: H.Type) throws {
+        for keySize in [16, H.blockByteCount, H.blockByteCount + 1] {
+            let key = SymmetricKey(size: .init(bitCount: keySize * 8))
+            let expected = Data(HMAC<H>.authenticationCode(for: self.message, using: key))
+
+            var prefix = try _ResumableHMAC<H>(key: key)
+            prefix.update(data: self.message[..<100])
+
+            var resumed = try _ResumableHMAC<H>(midstate: prefix.midstate)
+            resumed.update(data: self.message[100...])
+            XCTAssertEqual(resumed.finalize(), expected)
+            XCTAssertTrue(resumed.isValidAuthenticationCode(expected))
+            XCTAssertFalse(resumed.isValidAuthenticationCode(expected.dropLast()))
+            XCTAssertFalse(prefix.isValidAuthenticationCode(expected))
+        }
+    }
+
+    func testHMACMatchesOneShot() throws {
+        try self.checkHMAC(SHA256.self)
+        try self.checkHMAC(SHA384.self)
+        try self.checkHMAC(SHA512.self)
+    }
+
+    func testRejectsMalformedMidstates() throws {
+        var hash = try _ResumableHash<SHA256>()
+        hash.update(data: [1, 2, 3])
+        let midstate = hash.midstate
+
+        for malformed in [Data(), midstate.dropLast(), midstate + [0], Data(repeating: 0, count: 39)] {
+            XCTAssertThrowsError(try _ResumableHash<SHA256>(midstate: malformed)) { error in
+                guard case .some(.invalidParameter) = error as? CryptoKitError else {
+                    XCTFail("Unexpected error: \(error)")
+                    return
+                }
+            }
+        }
+    }
+
+    func testRejectsUnsupportedHashFunctions() throws {
+        XCTAssertThrowsError(try _ResumableHash<Insecure.SHA1>()) { error in
+            guard case .some(.invalidParameter) = error as? CryptoKitError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+    }
+}
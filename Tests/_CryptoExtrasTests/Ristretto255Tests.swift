@@ -0,0 +1,150 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class Ristretto255Tests: XCTestCase {
+    typealias Element = _Ristretto255.Element
+    typealias Scalar = _Ristretto255.Scalar
+
+    func scalar(_ value: UInt8) throws -> Scalar {
+        try Scalar(rawRepresentation: [value] + [UInt8](repeating: 0, count: 31))
+    }
+
+    func testGeneratorMultiples() throws {
+        // RFC 9496, Appendix A.1.
+        let multiples = [
+            "0000000000000000000000000000000000000000000000000000000000000000",
+            "e2f2ae0a6abc4e71a884a961c500515f58e30b6aa582dd8db6a65945e08d2d76",
+            "6a493210f7499cd17fecb510ae0cea23a110e8d5b901f8acadd3095c73a3b919",
+            "94741f5d5d52755ece4f23f044ee27d5d1ea1e2bd196b462166b16152a9d0259",
+        ]
+        XCTAssertEqual(Element.identity.rawRepresentation, Data(try Array(hexString: multiples[0])))
+        XCTAssertEqual(Element.generator.rawRepresentation, Data(try Array(hexString: multiples[1])))
+        for (index, multiple) in multiples.enumerated() {
+            let expected = Data(try Array(hexString: multiple))
+            let scalar = try self.scalar(UInt8(index))
+            XCTAssertEqual(Element(generatorMultipliedBy: scalar).rawRepresentation, expected)
+            XCTAssertEqual(Element.generator.multiplied(by: scalar).rawRepresentation, expected)
+            XCTAssertEqual(try Element(rawRepresentation: expected).rawRepresentation, expected)
+        }
+        XCTAssertEqual(Element.generator + Element.generator + Element.generator, try Element(rawRepresentation: Array(hexString: multiples[3])))
+    }
+
+    func testInvalidEncodingsAreRejected() throws {
+        // RFC 9496, Appendix A.2: non-canonical, negative and non-square encodings.
+        for encoding in [
+            "00ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff",
+            "0100000000000000000000000000000000000000000000000000000000000000",
+            "26948d35ca62e643e26a83177332e6b6afeb9d08e4268b650f1f5bbd8d81d371",
+        ] {
+            XCTAssertThrowsError(try Element(rawRepresentation: Array(hexString: encoding))) { error in
+                guard case .some(.invalidParameter) = error as? CryptoKitError else {
+                    XCTFail("Unexpected error: \(error)")
+                    return
+                }
+            }
+        }
+        XCTAssertThrowsError(try Element(rawRepresentation: [UInt8](repeating: 0, count: 31))) { error in
+            guard case .some(.incorrectParameterSize) = error as? CryptoKitError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+    }
+
+    func testUniformBytes() throws {
+        // RFC 9496, Appendix A.3.
+        let element = try Element(uniformBytes: Array(hexString: "5d1be09e3d0c82fc538112490e35701979d99e06ca3e2b5b54bffe8b4dc772c14d98b696a1bbfb5ca32c436cc61c16563790306c79eaca7705668b47dffe5bb6"))
+        XCTAssertEqual(element.rawRepresentation, Data(try Array(hexString: "3066f82a1a747d45120d1740f14358531a8f04bbffe6a819f86dfe50f44a0a46")))
+    }
+
+    func testGroupLaws() throws {
+        let a = Element(generatorMultipliedBy: Scalar())
+        let b = try Element(hashing: Data("message".utf8), domainSeparationTag: Data("Ristretto255Tests".utf8))
+        let k = Scalar()
+        let m = Scalar()
+
+        XCTAssertEqual(a + b - b, a)
+        XCTAssertEqual(a + -a, .identity)
+        XCTAssertEqual((a + b).multiplied(by: k), a.multiplied(by: k) + b.multiplied(by: k))
+        XCTAssertEqual(a.multiplied(by: k + m), a.multiplied(by: k) + a.multiplied(by: m))
+        XCTAssertEqual(a.multiplied(by: k * m), a.multiplied(by: k).multiplied(by: m))
+        XCTAssertEqual(a.multiplied(by: k).multiplied(by: k.inverse), a)
+        XCTAssertEqual(k - k, try self.scalar(0))
+        XCTAssertEqual(k + -k, try self.scalar(0))
+        XCTAssertEqual(k * k.inverse, try self.scalar(1))
+        XCTAssertEqual(Set([a, a + .identity, b]).count, 2)
+    }
+
+    func testScalarEncodings() throws {
+        // The group order is not a canonical scalar, but one less than it is.
+        var order = try Array(hexString: "edd3f55c1a631258d69cf7a2def9de1400000000000000000000000000000010")
+        XCTAssertThrowsError(try Scalar(rawRepresentation: order)) { error in
+            guard case .some(.invalidParameter) = error as? CryptoKitError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+        order[0] -= 1
+        XCTAssertEqual(try Scalar(rawRepresentation: order), try -self.scalar(1))
+
+        // Reducing the order, padded to 64 bytes, gives zero.
+        order[0] += 1
+        XCTAssertEqual(try Scalar(reducing: order + [UInt8](repeating: 0, count: 32)), try self.scalar(0))
+    }
+
+    func testBatchEncodingsMatchSingleEncodings() throws {
+        for count in [0, 1, 3, 64, 65] {
+            var elements = (0..<count).map { _ in Element(generatorMultipliedBy: Scalar()) }
+            if count > 1 {
+                elements[1] = .identity
+            }
+            let scalars = (0..<count).map { _ in Scalar() }
+            let k = Scalar()
+
+            XCTAssertEqual(Element.doubledRawRepresentations(of: elements), elements.map { ($0 + $0).rawRepresentation })
+            XCTAssertEqual(
+                Element.rawRepresentations(of: elements, multipliedBy: k),
+                elements.map { $0.multiplied(by: k).rawRepresentation }
+            )
+            XCTAssertEqual(
+                Element.rawRepresentations(ofGeneratorMultipliedBy: scalars),
+                scalars.map { Element(generatorMultipliedBy: $0).rawRepresentation }
+            )
+        }
+    }
+
+    func testMultiScalarMultiplicationMatchesNaiveSum() throws {
+        for count in [0, 1, 2, 7, 100] {
+            let elements = (0..<count).map { _ in Element(generatorMultipliedBy: Scalar()) }
+            var scalars = (0..<count).map { _ in Scalar() }
+            if count > 1 {
+                scalars[0] = try self.scalar(0)
+                scalars[1] = try -self.scalar(1)
+            }
+            let expected = zip(scalars, elements).reduce(Element.identity) { $0 + $1.1.multiplied(by: $1.0) }
+            XCTAssertEqual(try Element.multiScalarMultiplication(scalars, elements), expected)
+        }
+
+        XCTAssertThrowsError(try Element.multiScalarMultiplication([Scalar()], [])) { error in
+            guard case .some(.incorrectParameterSize) = error as? CryptoKitError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+    }
+}
@@ -0,0 +1,56 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class SHA256BatchTests: XCTestCase {
+    func testBatchMatchesSingleShot() throws {
+        // Cover messages either side of the 64-byte block boundary, and an empty one.
+        let storage = [UInt8]((0..<4096).map { UInt8(truncatingIfNeeded: $0 &* 7) })
+        let ranges = [0..<0, 0..<1, 3..<58, 10..<74, 100..<228, 1000..<4096]
+
+        var digests = [UInt8](repeating: 0, count: ranges.count * SHA256.byteCount)
+        try storage.withUnsafeBytes { storage in
+            try digests.withUnsafeMutableBytes { digests in
+                let messages = ranges.map { UnsafeRawBufferPointer(rebasing: storage[$0]) }
+                try SHA256._hash(batch: messages, into: digests)
+            }
+        }
+
+        for (index, range) in ranges.enumerated() {
+            let expected = Array(SHA256.hash(data: storage[range]))
+            let actual = digests[(index * SHA256.byteCount)..<((index + 1) * SHA256.byteCount)]
+            XCTAssertEqual(Array(actual), expected)
+        }
+    }
+
+    func testEmptyBatch() throws {
+        try SHA256._hash(batch: [], into: UnsafeMutableRawBufferPointer(start: nil, count: 0))
+    }
+
+    func testBatchRejectsIncorrectOutputSize() throws {
+        var digests = [UInt8](repeating: 0, count: SHA256.byteCount + 1)
+        try digests.withUnsafeMutableBytes { digests in
+            XCTAssertThrowsError(try SHA256._hash(batch: [UnsafeRawBufferPointer(start: nil, count: 0)], into: digests)) { error in
+                guard case .some(.incorrectParameterSize) = error as? CryptoKitError else {
+                    XCTFail("Unexpected error: \(error)")
+                    return
+                }
+            }
+        }
+    }
+}
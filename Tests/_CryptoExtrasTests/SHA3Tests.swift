@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class SHA3Tests: XCTestCase {
+    func testSHA3_256() throws {
+        XCTAssertEqual(
+            Array(_SHA3_256.hash(data: Data())),
+            try Array(hexString: "a7ffc6f8bf1ed76651c14756a061d662f580ff4de43b49fa82d80a4b80f8434a")
+        )
+        XCTAssertEqual(
+            Array(_SHA3_256.hash(data: Array("abc".utf8))),
+            try Array(hexString: "3a985da74fe225b2045c172d6bd390bd855f086e3e9d525b46bfe24511431532")
+        )
+    }
+
+    func testSHA3_512() throws {
+        XCTAssertEqual(
+            Array(_SHA3_512.hash(data: Array("abc".utf8))),
+            try Array(hexString: "b751850b1a57168a5693cd924b6b096e08f621827444f70d884f5d0240d2712e10e116e9192af3c91a7ec57647e3934057340b4cf408d5a56592f8274eec53f0")
+        )
+
+        // 200 bytes crosses the 72-byte rate twice; feed it in uneven pieces.
+        let message = [UInt8](repeating: UInt8(ascii: "a"), count: 200)
+        var hasher = _SHA3_512()
+        hasher.update(data: message[0..<1])
+        hasher.update(data: message[1..<73])
+        hasher.update(data: message[73...])
+        XCTAssertEqual(
+            Array(hasher.finalize()),
+            try Array(hexString: "eae6c85c6904f11075de9f9d5e1064371d000510fa3d2d79d40cf9be34892fb01859d0a0234e138bcb0ad5c84f6c0dca226a414b0c9a2897cb695f5185fe36ec")
+        )
+        XCTAssertEqual(hasher.finalize(), _SHA3_512.hash(data: message))
+    }
+
+    func testSHAKE() throws {
+        XCTAssertEqual(
+            Array(_SHAKE128.hash(data: Data(), outputByteCount: 32)),
+            try Array(hexString: "7f9c2ba4e88f827d616045507605853ed73b8093f6efbc88eb1a6eacfa66ef26")
+        )
+        XCTAssertEqual(
+            Array(_SHAKE256.hash(data: Data(), outputByteCount: 64)),
+            try Array(hexString: "46b9dd2b0ba88d13233b3feb743eeb243fcd52ea62b81b82b50c27646ed5762fd75dc4ddd8c0f200cb05019d67b592f6fc821c49479ab48640292eacb3b7c4be")
+        )
+        XCTAssertEqual(
+            Array(_SHAKE256.hash(data: Array("abc".utf8), outputByteCount: 32)),
+            try Array(hexString: "483366601360a8771c6863080cc4114d8db44530f8f1e1ee4f94ea37e78b5739")
+        )
+    }
+
+    func testSHAKELongOutputAndContinuedAbsorb() throws {
+        var shake = _SHAKE128()
+        for _ in 0..<50 {
+            shake.update(data: Array("abc".utf8))
+        }
+        // Finalizing must not disturb the state.
+        let early = shake.finalize(outputByteCount: 16)
+        for _ in 0..<50 {
+            shake.update(data: Array("abc".utf8))
+        }
+
+        let output = shake.finalize(outputByteCount: 300)
+        XCTAssertEqual(
+            Array(output.prefix(32)),
+            try Array(hexString: "f19e315ccd07c6b34ca5b21bd4c3a48c701e32e8631e94f3df2c802484e6333d")
+        )
+        XCTAssertEqual(Array(output.suffix(16)), try Array(hexString: "6f3d1ec5b36e60a97aa39ddb64c86001"))
+        XCTAssertEqual(shake.finalize(outputByteCount: 300), output)
+        XCTAssertNotEqual(Array(early), Array(output.prefix(16)))
+    }
+}
@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class SHA512TruncatedTests: XCTestCase {
+    static let longMessage = Array(
+        "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu".utf8
+    )
+
+    func testSHA512_256() throws {
+        XCTAssertEqual(
+            Array(_SHA512_256.hash(data: Data())),
+            try Array(hexString: "c672b8d1ef56ed28ab87c3622c5114069bdd3ad7b8f9737498d0c01ecef0967a")
+        )
+        XCTAssertEqual(
+            Array(_SHA512_256.hash(data: Array("abc".utf8))),
+            try Array(hexString: "53048e2681941ef99b2e29b76b4c7dabe4c2d0c634fc6d46e0e2f13107e7af23")
+        )
+        XCTAssertEqual(
+            Array(_SHA512_256.hash(data: Self.longMessage)),
+            try Array(hexString: "3928e184fb8690f840da3988121d31be65cb9d3ef83ee6146feac861e19b563a")
+        )
+    }
+
+    func testSHA512_224() throws {
+        XCTAssertEqual(
+            Array(_SHA512_224.hash(data: Data())),
+            try Array(hexString: "6ed0dd02806fa89e25de060c19d3ac86cabb87d6a0ddd05c333b84f4")
+        )
+        XCTAssertEqual(
+            Array(_SHA512_224.hash(data: Array("abc".utf8))),
+            try Array(hexString: "4634270f707b6a54daae7530460842e20e37ed265ceee9a43e8924aa")
+        )
+        XCTAssertEqual(
+            Array(_SHA512_224.hash(data: Self.longMessage)),
+            try Array(hexString: "23fec5bb94d60b23308192640b0c453335d664734fe40e7268674af9")
+        )
+        XCTAssertEqual(_SHA512_224Digest.byteCount, 28)
+    }
+
+    func testIncrementalUpdates() throws {
+        // Uneven pieces that straddle the 128-byte block.
+        var hasher = _SHA512_256()
+        hasher.update(data: Self.longMessage[0..<1])
+        hasher.update(data: Self.longMessage[1..<100])
+        hasher.update(data: Self.longMessage[100...])
+        XCTAssertEqual(hasher.finalize(), _SHA512_256.hash(data: Self.longMessage))
+
+        // Finalizing doesn't consume the hasher.
+        var short = _SHA512_224()
+        short.update(data: Array("ab".utf8))
+        _ = short.finalize()
+        short.update(data: Array("c".utf8))
+        XCTAssertEqual(short.finalize(), _SHA512_224.hash(data: Array("abc".utf8)))
+    }
+
+    func testHMACAndHKDF() throws {
+        let code = HMAC<_SHA512_256>.authenticationCode(
+            for: Array("The quick brown fox jumps over the lazy dog".utf8),
+            using: SymmetricKey(data: Array("key".utf8))
+        )
+        XCTAssertEqual(
+            Array(code),
+            try Array(hexString: "7fb65e03577da9151a1016e9c2e514d4d48842857f13927f348588173dca6d89")
+        )
+
+        let derived = HKDF<_SHA512_256>.deriveKey(
+            inputKeyMaterial: SymmetricKey(data: Array("ikm".utf8)),
+            salt: Array("salt".utf8),
+            info: Array("info".utf8),
+            outputByteCount: 42
+        )
+        XCTAssertEqual(
+            derived.withUnsafeBytes { Array($0) },
+            try Array(hexString: "234e926bcc6f74eb213f29db8f2d16f99c05e09dd83e20a66b6cf4d7e3450e76511b81d73388eb3cb473")
+        )
+    }
+}
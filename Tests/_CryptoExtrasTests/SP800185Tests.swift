@@ -0,0 +1,173 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+// Test vectors are the samples published with NIST SP 800-185.
+final class SP800185Tests: XCTestCase {
+    let fourBytes = Data([0x00, 0x01, 0x02, 0x03])
+    let twoHundredBytes = Data((0..<200).map { UInt8($0) })
+    let key = SymmetricKey(data: Data((0x40...0x5F).map { UInt8($0) }))
+    let parallelHashInput = try! Data(hexString: "000102030405060710111213141516172021222324252627")
+
+    func testCSHAKE128() throws {
+        XCTAssertEqual(
+            _CSHAKE128.hash(data: self.fourBytes, outputByteCount: 32, customization: Data("Email Signature".utf8)),
+            try Data(hexString: "c1c36925b6409a04f1b504fcbca9d82b4017277cb5ed2b2065fc1d3814d5aaf5")
+        )
+        XCTAssertEqual(
+            _CSHAKE128.hash(data: self.twoHundredBytes, outputByteCount: 32, customization: Data("Email Signature".utf8)),
+            try Data(hexString: "c5221d50e4f822d96a2e8881a961420f294b7b24fe3d2094baed2c6524cc166b")
+        )
+    }
+
+    func testCSHAKE256() throws {
+        XCTAssertEqual(
+            _CSHAKE256.hash(data: self.fourBytes, outputByteCount: 64, customization: Data("Email Signature".utf8)),
+            try Data(hexString: "d008828e2b80ac9d2218ffee1d070c48b8e4c87bff32c9699d5b6896eee0edd164020e2be0560858d9c00c037e34a96937c561a74c412bb4c746469527281c8c")
+        )
+    }
+
+    func testCSHAKEWithoutNamesIsSHAKE() throws {
+        XCTAssertEqual(
+            _CSHAKE128.hash(data: self.twoHundredBytes, outputByteCount: 300),
+            _SHAKE128.hash(data: self.twoHundredBytes, outputByteCount: 300)
+        )
+        XCTAssertEqual(
+            _CSHAKE256.hash(data: self.twoHundredBytes, outputByteCount: 300),
+            _SHAKE256.hash(data: self.twoHundredBytes, outputByteCount: 300)
+        )
+    }
+
+    func testCSHAKEIncrementalMatchesOneShot() throws {
+        let customization = Data("Incremental".utf8)
+        var cshake = _CSHAKE256(functionName: Data("Test".utf8), customization: customization)
+        cshake.update(data: self.twoHundredBytes.prefix(7))
+        cshake.update(data: self.twoHundredBytes.dropFirst(7))
+        XCTAssertEqual(
+            cshake.finalize(outputByteCount: 200),
+            _CSHAKE256.hash(data: self.twoHundredBytes, outputByteCount: 200, functionName: Data("Test".utf8), customization: customization)
+        )
+    }
+
+    func testKMAC128() throws {
+        XCTAssertEqual(
+            _KMAC128.authenticationCode(for: self.fourBytes, using: self.key),
+            try Data(hexString: "e5780b0d3ea6f7d3a429c5706aa43a00fadbd7d49628839e3187243f456ee14e")
+        )
+        XCTAssertEqual(
+            _KMAC128.authenticationCode(for: self.fourBytes, using: self.key, customization: Data("My Tagged Application".utf8)),
+            try Data(hexString: "3b1fba963cd8b0b59e8c1a6d71888b7143651af8ba0a7070c0979e2811324aa5")
+        )
+    }
+
+    func testKMAC256() throws {
+        XCTAssertEqual(
+            _KMAC256.authenticationCode(for: self.fourBytes, using: self.key, customization: Data("My Tagged Application".utf8)),
+            try Data(hexString: "20c570c31346f703c9ac36c61c03cb64c3970d0cfc787e9b79599d273a68d2f7f69d4cc3de9d104a351689f27cf6f5951f0103f33f4f24871024d9c27773a8dd")
+        )
+    }
+
+    func testKMACXOF128() throws {
+        var kmac = _KMAC128(key: self.key)
+        kmac.update(data: self.fourBytes)
+        XCTAssertEqual(
+            kmac.finalizeXOF(outputByteCount: 32),
+            try Data(hexString: "cd83740bbd92ccc8cf032b1481a0f4460e7ca9dd12b08a0c4031178bacd6ec35")
+        )
+        XCTAssertEqual(kmac.finalizeXOF(outputByteCount: 16), kmac.finalizeXOF(outputByteCount: 32).prefix(16))
+    }
+
+    func testKMACValidation() throws {
+        let code = _KMAC256.authenticationCode(for: self.twoHundredBytes, using: self.key, outputByteCount: 48)
+        XCTAssertTrue(_KMAC256.isValidAuthenticationCode(code, authenticating: self.twoHundredBytes, using: self.key))
+
+        // The length is part of the code, so a truncated code isn't valid.
+        XCTAssertFalse(_KMAC256.isValidAuthenticationCode(code.prefix(32), authenticating: self.twoHundredBytes, using: self.key))
+        XCTAssertFalse(_KMAC256.isValidAuthenticationCode(code, authenticating: self.fourBytes, using: self.key))
+        XCTAssertFalse(
+            _KMAC256.isValidAuthenticationCode(code, authenticating: self.twoHundredBytes, using: self.key, customization: Data("Other".utf8))
+        )
+    }
+
+    func testParallelHash128() throws {
+        XCTAssertEqual(
+            _ParallelHash128.hash(data: self.parallelHashInput, blockByteCount: 8),
+            try Data(hexString: "ba8dc1d1d979331d3f813603c67f72609ab5e44b94a0b8f9af46514454a2b4f5")
+        )
+        XCTAssertEqual(
+            _ParallelHash128.hash(data: self.parallelHashInput, blockByteCount: 8, customization: Data("Parallel Data".utf8)),
+            try Data(hexString: "fc484dcb3f84dceedc353438151bee58157d6efed0445a81f165e495795b7206")
+        )
+    }
+
+    func testParallelHash256() throws {
+        XCTAssertEqual(
+            _ParallelHash256.hash(data: self.parallelHashInput, blockByteCount: 8),
+            try Data(hexString: "bc1ef124da34495e948ead207dd9842235da432d2bbc54b4c110e64c451105531b7f2a3e0ce055c02805e7c2de1fb746af97a1dd01f43b824e31b87612410429")
+        )
+        XCTAssertEqual(
+            _ParallelHash256.hash(data: self.parallelHashInput, blockByteCount: 8, customization: Data("Parallel Data".utf8)),
+            try Data(hexString: "cdf15289b54f6212b4bc270528b49526006dd9b54e2b6add1ef6900dda3963bb33a72491f236969ca8afaea29c682d47a393c065b38e29fae651a2091c833110")
+        )
+    }
+
+    func testParallelHashXOF128() throws {
+        var hash = _ParallelHash128(blockByteCount: 8)
+        hash.update(data: self.parallelHashInput)
+        XCTAssertEqual(
+            hash.finalizeXOF(outputByteCount: 32),
+            try Data(hexString: "fe47d661e49ffe5b7d999922c062356750caf552985b8e8ce6667f2727c3c8d3")
+        )
+    }
+
+    func testParallelHashIncrementalMatchesOneShot() throws {
+        let input = Data((0..<100_000).map { UInt8(truncatingIfNeeded: $0 &* 31) })
+        let expected = _ParallelHash256.hash(data: input, blockByteCount: 1000)
+
+        for pieceSize in [1, 999, 1000, 1001, 4096, 60_000] {
+            var hash = _ParallelHash256(blockByteCount: 1000)
+            var offset = input.startIndex
+            while offset < input.endIndex {
+                let end = min(offset + pieceSize, input.endIndex)
+                hash.update(data: input[offset..<end])
+                offset = end
+            }
+            XCTAssertEqual(hash.finalize(), expected, "piece size \(pieceSize)")
+        }
+    }
+
+    func testParallelHashIsIndependentOfThreadCount() throws {
+        // Large enough to be split between threads.
+        let input = Data((0..<(3 << 20) + 12345).map { UInt8(truncatingIfNeeded: $0 &* 7) })
+        for blockByteCount in [1024, 8192] {
+            let expected128 = _ParallelHash128.hash(data: input, blockByteCount: blockByteCount)
+            let expected256 = _ParallelHash256.hash(data: input, blockByteCount: blockByteCount)
+            for threads in [2, 4, 8] {
+                XCTAssertEqual(_ParallelHash128.hash(data: input, blockByteCount: blockByteCount, maximumThreadCount: threads), expected128)
+                XCTAssertEqual(_ParallelHash256.hash(data: input, blockByteCount: blockByteCount, maximumThreadCount: threads), expected256)
+            }
+        }
+    }
+
+    func testParallelHashOfEmptyInputHasNoBlocks() throws {
+        // left_encode(8), no chaining values, right_encode(0) and right_encode(256).
+        var expected = _CSHAKE128(functionName: Data("ParallelHash".utf8))
+        expected.update(data: [0x01, 0x08])
+        expected.update(data: [0x00, 0x01, 0x01, 0x00, 0x02])
+        XCTAssertEqual(_ParallelHash128.hash(data: Data(), blockByteCount: 8), expected.finalize(outputByteCount: 32))
+    }
+}
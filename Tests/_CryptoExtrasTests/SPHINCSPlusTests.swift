@@ -0,0 +1,76 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class SPHINCSPlusTests: XCTestCase {
+    // Signing is slow, so each test signs as few times as it can.
+    func testConcurrentSigningMatchesSerialSigning() throws {
+        let privateKey = _SPHINCSPlus.PrivateKey()
+        let message = Array("firmware manifest".utf8)
+
+        let serial = privateKey.deterministicSignature(for: message, concurrently: false)
+        let concurrent = privateKey.deterministicSignature(for: message, concurrently: true)
+        XCTAssertEqual(serial.count, _SPHINCSPlus.signatureByteCount)
+        XCTAssertEqual(serial, concurrent)
+        XCTAssertTrue(privateKey.publicKey.isValidSignature(concurrent, for: message))
+    }
+
+    func testSignVerifyAndKeyRoundTrips() throws {
+        let privateKey = try _SPHINCSPlus.PrivateKey(rawRepresentation: _SPHINCSPlus.PrivateKey().rawRepresentation)
+        let publicKey = try _SPHINCSPlus.PublicKey(rawRepresentation: privateKey.publicKey.rawRepresentation)
+        let message = Data("hello, world!".utf8)
+
+        let signature = privateKey.signature(for: message, concurrently: true)
+        XCTAssertTrue(publicKey.isValidSignature(signature, for: message))
+        XCTAssertFalse(publicKey.isValidSignature(signature, for: message.dropLast()))
+        XCTAssertFalse(publicKey.isValidSignature(signature.dropLast(), for: message))
+
+        var tampered = signature
+        tampered[tampered.startIndex + 100] ^= 1
+        XCTAssertFalse(publicKey.isValidSignature(tampered, for: message))
+        XCTAssertFalse(_SPHINCSPlus.PrivateKey().publicKey.isValidSignature(signature, for: message))
+    }
+
+    func testRejectsWrongKeySizes() {
+        XCTAssertThrowsError(try _SPHINCSPlus.PublicKey(rawRepresentation: Data(count: 31)))
+        XCTAssertThrowsError(try _SPHINCSPlus.PrivateKey(rawRepresentation: Data(count: 32)))
+    }
+
+    func testBatchVerification() throws {
+        let privateKey = _SPHINCSPlus.PrivateKey()
+        let otherKey = _SPHINCSPlus.PrivateKey()
+        let message = Data("update manifest".utf8)
+        let signature = privateKey.signature(for: message, concurrently: true)
+
+        var tampered = signature
+        tampered[tampered.startIndex + 5000] ^= 1
+        let items = [
+            _SPHINCSPlus._BatchVerificationItem(publicKey: privateKey.publicKey, signature: signature, data: message),
+            _SPHINCSPlus._BatchVerificationItem(publicKey: otherKey.publicKey, signature: signature, data: message),
+            _SPHINCSPlus._BatchVerificationItem(publicKey: privateKey.publicKey, signature: tampered, data: message),
+            _SPHINCSPlus._BatchVerificationItem(publicKey: privateKey.publicKey, signature: signature.prefix(64), data: message),
+            _SPHINCSPlus._BatchVerificationItem(publicKey: privateKey.publicKey, signature: signature, data: message.dropFirst()),
+            _SPHINCSPlus._BatchVerificationItem(publicKey: privateKey.publicKey, signature: signature, data: message),
+        ]
+
+        let expected = [true, false, false, false, false, true]
+        XCTAssertEqual(_SPHINCSPlus._isValidSignatures(items), expected)
+        XCTAssertEqual(_SPHINCSPlus._isValidSignatures(items, concurrently: false), expected)
+        XCTAssertEqual(_SPHINCSPlus._isValidSignatures([]), [])
+    }
+}
@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class ScryptTests: XCTestCase {
+    // RFC 7914, section 12.
+    func testRFCVectors() throws {
+        let empty = try _Scrypt.deriveKey(from: [UInt8](), salt: [UInt8](), outputByteCount: 64, rounds: 16, blockSize: 1, parallelism: 1)
+        XCTAssertEqual(
+            empty.withUnsafeBytes { Array($0) },
+            try Array(hexString: "77d6576238657b203b19ca42c18a0497f16b4844e3074ae8dfdffa3fede21442fcd0069ded0948f8326a753a0fc81f17e8d3e0fb2e0d3628cf35e20c38d18906")
+        )
+
+        let expected = try Array(hexString: "fdbabe1c9d3472007856e7190d01e9fe7c6ad7cbc8237830e77376634b3731622eaf30d92e22a3886ff109279d9830dac727afb94a83ee6d8360cbdfa2cc0640")
+        for maxThreads in [1, 4, 16] {
+            let key = try _Scrypt.deriveKey(
+                from: Array("password".utf8),
+                salt: Array("NaCl".utf8),
+                outputByteCount: 64,
+                rounds: 1024,
+                blockSize: 8,
+                parallelism: 16,
+                maxThreads: maxThreads,
+                useHugePages: maxThreads > 1
+            )
+            XCTAssertEqual(key.withUnsafeBytes { Array($0) }, expected, "maxThreads: \(maxThreads)")
+        }
+    }
+
+    func testMemoryLimit() throws {
+        // One thread needs 128 * 8 * 1024 bytes of V, so a limit that fits one but not four
+        // still succeeds on fewer threads.
+        let key = try _Scrypt.deriveKey(
+            from: Array("password".utf8),
+            salt: Array("NaCl".utf8),
+            outputByteCount: 64,
+            rounds: 1024,
+            blockSize: 8,
+            parallelism: 16,
+            maxMemory: 2 * 1024 * 1024 + 1024 * 32,
+            maxThreads: 4
+        )
+        XCTAssertEqual(
+            key.withUnsafeBytes { Array($0) },
+            try Array(hexString: "fdbabe1c9d3472007856e7190d01e9fe7c6ad7cbc8237830e77376634b3731622eaf30d92e22a3886ff109279d9830dac727afb94a83ee6d8360cbdfa2cc0640")
+        )
+
+        XCTAssertThrowsError(
+            try _Scrypt.deriveKey(from: [UInt8](), salt: [UInt8](), outputByteCount: 32, rounds: 1 << 20, blockSize: 8, parallelism: 1)
+        ) { error in
+            guard case .some(.invalidParameter) = error as? CryptoKitError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+    }
+
+    func testInvalidParameters() throws {
+        for (rounds, blockSize, parallelism) in [(1, 8, 1), (1000, 8, 1), (1024, 0, 1), (1024, 8, 0)] {
+            XCTAssertThrowsError(
+                try _Scrypt.deriveKey(from: [UInt8](), salt: [UInt8](), outputByteCount: 32, rounds: rounds, blockSize: blockSize, parallelism: parallelism)
+            ) { error in
+                guard case .some(.invalidParameter) = error as? CryptoKitError else {
+                    XCTFail("Unexpected error: \(error)")
+                    return
+                }
+            }
+        }
+    }
+}
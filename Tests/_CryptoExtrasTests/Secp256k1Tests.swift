@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class Secp256k1Tests: XCTestCase {
+    // A key and a high-s signature over "sample", made with OpenSSL.
+    let privateKeyBytes = try! Array(hexString: "c9afa9d845ba75166b5c215767b1d6934e50c3db36e89b127b8a622b120f6721")
+    let x963PublicKey = try! Array(hexString: "042c8c31fc9f990c6b55e3865a184a4ce50e09481f2eaeb3e60ec1cea13a6ae64564b95e4fdb6948c0386e189b006a29f686769b011704275e4459822dc3328085")
+    let compressedPublicKey = try! Array(hexString: "032c8c31fc9f990c6b55e3865a184a4ce50e09481f2eaeb3e60ec1cea13a6ae645")
+    let highSSignature = try! Array(hexString: "f415a172d35c7e2d80dd4a8314b2d4e76d54462970d4658df2ed742666e4e48bbdd1acc7f14ad71747c43d2a2946a5145eb9fe15f107d2c2f53f2ad258221ff0")
+
+    func testKnownKeyAndSignature() throws {
+        let privateKey = try _Secp256k1.Signing.PrivateKey(rawRepresentation: self.privateKeyBytes)
+        XCTAssertEqual(Array(privateKey.publicKey.x963Representation), self.x963PublicKey)
+        XCTAssertEqual(Array(privateKey.publicKey.compressedRepresentation), self.compressedPublicKey)
+        XCTAssertEqual(try _Secp256k1.Signing.PublicKey(compressedRepresentation: self.compressedPublicKey), privateKey.publicKey)
+        XCTAssertEqual(try _Secp256k1.Signing.PublicKey(x963Representation: self.x963PublicKey), privateKey.publicKey)
+
+        let signature = try _Secp256k1.Signing.ECDSASignature(rawRepresentation: self.highSSignature)
+        let message = Data("sample".utf8)
+        XCTAssertTrue(privateKey.publicKey.isValidSignature(signature, for: message))
+        XCTAssertFalse(privateKey.publicKey.isValidSignature(signature, for: Data("samplf".utf8)))
+        XCTAssertEqual(try _Secp256k1.Signing.ECDSASignature(derRepresentation: signature.derRepresentation), signature)
+    }
+
+    func testSignaturesAreLowS() throws {
+        let privateKey = _Secp256k1.Signing.PrivateKey()
+        let halfOrder = try! Array(hexString: "7fffffffffffffffffffffffffffffff5d576e7357a4501ddfe92f46681b20a0")
+        for index in 0..<32 {
+            let digest = SHA256.hash(data: [UInt8(index)])
+            let signature = try privateKey.signature(for: digest)
+            XCTAssertFalse(halfOrder.lexicographicallyPrecedes(signature.rawRepresentation.suffix(32)))
+            XCTAssertTrue(privateKey.publicKey.isValidSignature(signature, for: digest))
+            XCTAssertFalse(privateKey.publicKey.isValidSignature(signature, for: SHA256.hash(data: [UInt8(index), 0])))
+        }
+    }
+
+    func testBatchMatchesSingleVerification() throws {
+        let privateKey = _Secp256k1.Signing.PrivateKey()
+        let messages = (0..<10).map { Data("message \($0)".utf8) }
+        var signatures = try messages.map { try privateKey.signature(for: $0) }
+        // Check a tampered signature and one by another key too.
+        var tampered = Array(signatures[3].rawRepresentation)
+        tampered[40] ^= 1
+        signatures[3] = try _Secp256k1.Signing.ECDSASignature(rawRepresentation: tampered)
+        signatures[7] = try _Secp256k1.Signing.PrivateKey().signature(for: messages[7])
+
+        let results = privateKey.publicKey._isValidSignatures(signatures, for: messages)
+        XCTAssertEqual(results, zip(signatures, messages).map { privateKey.publicKey.isValidSignature($0, for: $1) })
+        XCTAssertEqual(results, (0..<10).map { $0 != 3 && $0 != 7 })
+        XCTAssertEqual(privateKey.publicKey._isValidSignatures([], for: [Data]()), [])
+    }
+
+    func testInvalidKeysAreRejected() throws {
+        // Zero, and the order of the group.
+        for bytes in [[UInt8](repeating: 0, count: 32), try! Array(hexString: "fffffffffffffffffffffffffffffffebaaedce6af48a03bbfd25e8cd0364141")] {
+            XCTAssertThrowsError(try _Secp256k1.Signing.PrivateKey(rawRepresentation: bytes)) { error in
+                guard case .some(.invalidParameter) = error as? CryptoKitError else {
+                    XCTFail("Unexpected error: \(error)")
+                    return
+                }
+            }
+        }
+        XCTAssertThrowsError(try _Secp256k1.Signing.PrivateKey(rawRepresentation: [UInt8](repeating: 1, count: 31)))
+
+        var offCurve = Array(self.x963PublicKey.dropFirst())
+        offCurve[63] ^= 1
+        XCTAssertThrowsError(try _Secp256k1.Signing.PublicKey(rawRepresentation: offCurve)) { error in
+            guard case .some(.invalidParameter) = error as? CryptoKitError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+        // x = 5 is not the x-coordinate of any point on the curve.
+        var compressed = [UInt8](repeating: 0, count: 33)
+        compressed[0] = 0x02
+        compressed[32] = 5
+        XCTAssertThrowsError(try _Secp256k1.Signing.PublicKey(compressedRepresentation: compressed))
+        XCTAssertThrowsError(try _Secp256k1.Signing.ECDSASignature(rawRepresentation: [UInt8](repeating: 0, count: 63)))
+    }
+}
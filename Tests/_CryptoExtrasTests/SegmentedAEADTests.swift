@@ -0,0 +1,143 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class SegmentedAEADTests: XCTestCase {
+    let key = SymmetricKey(size: .bits256)
+    let aad = Array("header".utf8)
+
+    func message(_ count: Int) -> [UInt8] {
+        (0..<count).map { UInt8(truncatingIfNeeded: $0 &* 31 &+ 7) }
+    }
+
+    func testRoundTripBothAlgorithms() throws {
+        for algorithm in [_SegmentedAEAD.Algorithm.aesGCM, .chaChaPoly] {
+            let aead = try _SegmentedAEAD(key: self.key, algorithm: algorithm, segmentByteCount: 64)
+            for count in [0, 1, 63, 64, 65, 128, 1000] {
+                let plaintext = self.message(count)
+                let ciphertext = try aead.seal(plaintext, authenticating: self.aad)
+                XCTAssertEqual(ciphertext.count, aead.ciphertextByteCount(plaintextByteCount: count))
+                XCTAssertEqual(try aead.plaintextByteCount(ciphertextByteCount: ciphertext.count), count)
+                XCTAssertEqual(Array(try aead.open(ciphertext, authenticating: self.aad)), plaintext)
+            }
+        }
+    }
+
+    func testConcurrentMatchesSerial() throws {
+        let aead = try _SegmentedAEAD(key: self.key, segmentByteCount: 1024)
+        let plaintext = self.message(100_000)
+        let ciphertext = try aead.seal(plaintext, authenticating: self.aad, concurrently: true)
+        XCTAssertEqual(Array(try aead.open(ciphertext, authenticating: self.aad)), plaintext)
+        XCTAssertEqual(Array(try aead.open(ciphertext, authenticating: self.aad, concurrently: true)), plaintext)
+    }
+
+    func testStreamingMatchesWholeBuffer() throws {
+        let aead = try _SegmentedAEAD(key: self.key, algorithm: .chaChaPoly, segmentByteCount: 100)
+        for count in [0, 99, 100, 101, 1234] {
+            let plaintext = self.message(count)
+            var encryptor = try aead.makeEncryptor(authenticating: self.aad)
+            var ciphertext = encryptor.header
+            for piece in stride(from: 0, to: count, by: 37) {
+                ciphertext += try encryptor.update(plaintext[piece..<min(piece + 37, count)])
+            }
+            ciphertext += try encryptor.finish()
+            XCTAssertThrowsError(try encryptor.finish())
+            XCTAssertEqual(Array(try aead.open(ciphertext, authenticating: self.aad)), plaintext)
+
+            var decryptor = aead.makeDecryptor(authenticating: self.aad)
+            var opened = Data()
+            for piece in stride(from: 0, to: ciphertext.count, by: 53) {
+                opened += try decryptor.update(ciphertext[piece..<min(piece + 53, ciphertext.count)])
+            }
+            opened += try decryptor.finish()
+            XCTAssertEqual(Array(opened), plaintext)
+        }
+    }
+
+    func testRandomAccess() throws {
+        let aead = try _SegmentedAEAD(key: self.key, segmentByteCount: 64)
+        let plaintext = self.message(1000)
+        let ciphertext = try aead.seal(plaintext, authenticating: self.aad)
+        try ciphertext.withUnsafeBytes { ciphertext in
+            for range in [0..<0, 0..<1, 10..<200, 63..<65, 960..<1000, 1000..<1000, 0..<1000] {
+                XCTAssertEqual(Array(try aead.open(ciphertext, range: range, authenticating: self.aad)), Array(plaintext[range]))
+            }
+            XCTAssertThrowsError(try aead.open(ciphertext, range: 990..<1001, authenticating: self.aad)) { error in
+                guard case .some(.invalidRange) = error as? _SegmentedAEADError else {
+                    XCTFail("Unexpected error \(error)")
+                    return
+                }
+            }
+        }
+    }
+
+    func testTamperingIsDetected() throws {
+        let aead = try _SegmentedAEAD(key: self.key, segmentByteCount: 64)
+        let ciphertext = Array(try aead.seal(self.message(200), authenticating: self.aad))
+        let segment = 64 + _SegmentedAEAD.tagByteCount
+        let body = _SegmentedAEAD.headerByteCount
+
+        // Wrong authenticated data.
+        XCTAssertThrowsError(try aead.open(ciphertext, authenticating: Array("other".utf8)))
+
+        // A flipped bit in a segment, and in the salt.
+        for index in [body + 5, 10] {
+            var tampered = ciphertext
+            tampered[index] ^= 1
+            XCTAssertThrowsError(try aead.open(tampered, authenticating: self.aad))
+        }
+
+        // Swapped segments.
+        var swapped = ciphertext
+        swapped.replaceSubrange(body..<(body + segment), with: ciphertext[(body + segment)..<(body + 2 * segment)])
+        swapped.replaceSubrange((body + segment)..<(body + 2 * segment), with: ciphertext[body..<(body + segment)])
+        XCTAssertThrowsError(try aead.open(swapped, authenticating: self.aad))
+
+        // Truncation at a segment boundary leaves a valid length, but the new last segment wasn't sealed as last.
+        XCTAssertThrowsError(try aead.open(Array(ciphertext.prefix(body + 2 * segment)), authenticating: self.aad))
+
+        // A length no plaintext seals to.
+        XCTAssertThrowsError(try aead.open(Array(ciphertext.prefix(body + segment + 3)), authenticating: self.aad)) { error in
+            guard case .some(.invalidCiphertextLength) = error as? _SegmentedAEADError else {
+                XCTFail("Unexpected error \(error)")
+                return
+            }
+        }
+
+        // A stream that stops early fails to finish.
+        var decryptor = aead.makeDecryptor(authenticating: self.aad)
+        _ = try decryptor.update(ciphertext.prefix(body + 2 * segment))
+        XCTAssertThrowsError(try decryptor.finish())
+    }
+
+    func testHeaderMustMatchConfiguration() throws {
+        let aead = try _SegmentedAEAD(key: self.key, segmentByteCount: 64)
+        let ciphertext = try aead.seal(self.message(100), authenticating: self.aad)
+        let other = try _SegmentedAEAD(key: self.key, algorithm: .chaChaPoly, segmentByteCount: 64)
+        XCTAssertThrowsError(try other.open(ciphertext, authenticating: self.aad)) { error in
+            guard case .some(.invalidHeader) = error as? _SegmentedAEADError else {
+                XCTFail("Unexpected error \(error)")
+                return
+            }
+        }
+    }
+
+    func testRejectsBadParameters() {
+        XCTAssertThrowsError(try _SegmentedAEAD(key: SymmetricKey(size: SymmetricKeySize(bitCount: 64))))
+        XCTAssertThrowsError(try _SegmentedAEAD(key: self.key, segmentByteCount: 0))
+    }
+}
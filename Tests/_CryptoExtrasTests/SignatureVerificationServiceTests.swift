@@ -0,0 +1,147 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class SignatureVerificationServiceTests: XCTestCase {
+    func testEd25519VerificationsAreBatched() async throws {
+        let service = _SignatureVerificationService(maximumLatency: 0.01, maximumBatchSize: 8)
+        let keys = (0..<3).map { _ in Curve25519.Signing.PrivateKey() }
+        let messages = (0..<20).map { Data("message \($0)".utf8) }
+        let signatures = try messages.enumerated().map { index, message in
+            try keys[index % keys.count].signature(for: message)
+        }
+
+        let results = await withTaskGroup(of: (Int, Bool).self) { group in
+            for index in messages.indices {
+                group.addTask {
+                    // Every fifth message is checked against the wrong key.
+                    let key = keys[(index + (index % 5 == 0 ? 1 : 0)) % keys.count].publicKey
+                    return (index, await service.isValidSignature(signatures[index], for: messages[index], publicKey: key))
+                }
+            }
+            var results = [Int: Bool]()
+            for await (index, result) in group {
+                results[index] = result
+            }
+            return results
+        }
+
+        for index in messages.indices {
+            XCTAssertEqual(results[index], index % 5 != 0, "message \(index)")
+        }
+        let statistics = service.statistics
+        XCTAssertEqual(statistics.verifications, messages.count)
+        XCTAssertLessThan(statistics.batches, messages.count)
+        XCTAssertGreaterThanOrEqual(statistics.batches, 3)
+    }
+
+    func testP256VerificationsAreGroupedByKey() async throws {
+        let service = _SignatureVerificationService(maximumLatency: 0.01, maximumBatchSize: 16)
+        let keys = (0..<2).map { _ in P256.Signing.PrivateKey() }
+        let digests = (0..<12).map { SHA256.hash(data: [UInt8($0)]) }
+        let signatures = try digests.enumerated().map { index, digest in
+            try keys[index % 2].signature(for: digest)
+        }
+
+        let results = await withTaskGroup(of: (Int, Bool).self) { group in
+            for index in digests.indices {
+                group.addTask {
+                    // The last digest is checked against the other key.
+                    let key = keys[(index + (index == digests.count - 1 ? 1 : 0)) % 2].publicKey
+                    return (index, await service.isValidSignature(signatures[index], for: digests[index], publicKey: key))
+                }
+            }
+            var results = [Int: Bool]()
+            for await (index, result) in group {
+                results[index] = result
+            }
+            return results
+        }
+
+        for index in digests.indices {
+            XCTAssertEqual(results[index], index != digests.count - 1, "digest \(index)")
+        }
+        XCTAssertEqual(service.statistics.verifications, digests.count)
+    }
+
+    func testRSAVerificationsMatchSingleVerification() async throws {
+        let service = _SignatureVerificationService(maximumLatency: 0.01, maximumBatchSize: 4)
+        let key = try _RSA.Signing.PrivateKey(keySize: .bits2048)
+        let message = Data("hello".utf8)
+        let paddings = [_RSA.Signing.Padding.PSS, .insecurePKCS1v1_5, .PSS, .insecurePKCS1v1_5]
+        let signatures = try paddings.map { try key.signature(for: message, padding: $0) }
+
+        let results = await withTaskGroup(of: (Int, Bool).self) { group in
+            for index in paddings.indices {
+                group.addTask {
+                    // Checking the first signature with the other padding must fail.
+                    let padding = index == 0 ? _RSA.Signing.Padding.insecurePKCS1v1_5 : paddings[index]
+                    return (index, await service.isValidSignature(signatures[index], for: message, padding: padding, publicKey: key.publicKey))
+                }
+            }
+            var results = [Int: Bool]()
+            for await (index, result) in group {
+                results[index] = result
+            }
+            return results
+        }
+
+        XCTAssertEqual(results, [0: false, 1: true, 2: true, 3: true])
+    }
+
+    func testFullBatchIsVerifiedWithoutWaiting() async throws {
+        // With a latency this long, only reaching the batch size can finish the test in time.
+        let service = _SignatureVerificationService(maximumLatency: 60, maximumBatchSize: 1)
+        let key = Curve25519.Signing.PrivateKey()
+        let message = Data("hello".utf8)
+        let signature = try key.signature(for: message)
+
+        let isValid = await service.isValidSignature(signature, for: message, publicKey: key.publicKey)
+        XCTAssertTrue(isValid)
+        XCTAssertEqual(service.statistics, .init(verifications: 1, batches: 1))
+    }
+
+    func testFlushTimerOutlivingTheServiceIsHarmless() async throws {
+        // The first verification schedules a flush, then the second fills the batch, so both return before the timer
+        // fires, by which time nothing else holds the service.
+        var service: _SignatureVerificationService? = _SignatureVerificationService(maximumLatency: 0.2, maximumBatchSize: 2)
+        weak var weakService = service
+        let key = Curve25519.Signing.PrivateKey()
+        let message = Data("hello".utf8)
+        let signature = try key.signature(for: message)
+
+        let results = await withTaskGroup(of: Bool.self) { [service] group in
+            for _ in 0..<2 {
+                group.addTask {
+                    await service!.isValidSignature(signature, for: message, publicKey: key.publicKey)
+                }
+            }
+            var results = [Bool]()
+            for await result in group {
+                results.append(result)
+            }
+            return results
+        }
+        XCTAssertEqual(results, [true, true])
+        XCTAssertEqual(service?.statistics, _SignatureVerificationService.Statistics(verifications: 2, batches: 1))
+
+        service = nil
+        try await Task.sleep(nanoseconds: 500_000_000)
+        XCTAssertNil(weakService)
+    }
+}
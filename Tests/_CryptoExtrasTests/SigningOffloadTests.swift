@@ -0,0 +1,130 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class SigningOffloadTests: XCTestCase {
+    /// Signs in software on its own queue, standing in for a device.
+    final class SoftwareProvider: _SigningOffloadProvider, @unchecked Sendable {
+        let maximumBatchSize: Int
+        let maximumOutstandingRequests: Int
+        let failsEverything: Bool
+
+        private let queue = DispatchQueue(label: "signing-offload-tests")
+        private let lock = NSLock()
+        private var _batchSizes: [Int] = []
+
+        init(maximumBatchSize: Int, maximumOutstandingRequests: Int, failsEverything: Bool = false) {
+            self.maximumBatchSize = maximumBatchSize
+            self.maximumOutstandingRequests = maximumOutstandingRequests
+            self.failsEverything = failsEverything
+        }
+
+        var batchSizes: [Int] {
+            self.lock.lock()
+            defer {
+                self.lock.unlock()
+            }
+            return self._batchSizes
+        }
+
+        func submit(_ requests: [_SigningOffloadRequest], completion: @escaping @Sendable ([Result<Data, Error>]) -> Void) {
+            self.lock.lock()
+            self._batchSizes.append(requests.count)
+            self.lock.unlock()
+
+            let failsEverything = self.failsEverything
+            self.queue.async {
+                completion(requests.map { request in
+                    failsEverything ? .failure(CryptoKitError.invalidParameter) : Result { try request.signInSoftware() }
+                })
+            }
+        }
+    }
+
+    func testRequestsAreBatched() async throws {
+        let provider = SoftwareProvider(maximumBatchSize: 4, maximumOutstandingRequests: 64)
+        let offload = _SigningOffload(provider: provider, batchingDelay: 0.01)
+        let key = P256.Signing.PrivateKey()
+        let digests = (0..<10).map { SHA256.hash(data: [UInt8($0)]) }
+
+        let signatures = try await withThrowingTaskGroup(of: (Int, P256.Signing.ECDSASignature).self) { group in
+            for (index, digest) in digests.enumerated() {
+                group.addTask {
+                    (index, try await key.signature(for: digest, offloadingTo: offload))
+                }
+            }
+            var signatures = [Int: P256.Signing.ECDSASignature]()
+            for try await (index, signature) in group {
+                signatures[index] = signature
+            }
+            return signatures
+        }
+
+        for (index, digest) in digests.enumerated() {
+            XCTAssertTrue(key.publicKey.isValidSignature(signatures[index]!, for: digest))
+        }
+        XCTAssertEqual(provider.batchSizes.reduce(0, +), digests.count)
+        XCTAssertTrue(provider.batchSizes.allSatisfy { $0 <= 4 })
+        let statistics = offload.statistics
+        XCTAssertEqual(statistics.offloaded, digests.count)
+        XCTAssertEqual(statistics.batches, provider.batchSizes.count)
+        XCTAssertEqual(statistics.softwareWhenSaturated, 0)
+        XCTAssertEqual(statistics.softwareAfterFailure, 0)
+    }
+
+    func testSaturatedProviderFallsBackToSoftware() async throws {
+        let provider = SoftwareProvider(maximumBatchSize: 4, maximumOutstandingRequests: 0)
+        let offload = _SigningOffload(provider: provider)
+        let key = P384.Signing.PrivateKey()
+        let digest = SHA384.hash(data: [1, 2, 3])
+
+        let signature = try await key.signature(for: digest, offloadingTo: offload)
+        XCTAssertTrue(key.publicKey.isValidSignature(signature, for: digest))
+        XCTAssertEqual(provider.batchSizes, [])
+        XCTAssertEqual(offload.statistics.softwareWhenSaturated, 1)
+    }
+
+    func testFailedRequestsAreSignedInSoftware() async throws {
+        let provider = SoftwareProvider(maximumBatchSize: 1, maximumOutstandingRequests: 8, failsEverything: true)
+        let offload = _SigningOffload(provider: provider)
+        let key = try _RSA.Signing.PrivateKey(keySize: .bits2048)
+        let digest = SHA256.hash(data: [4, 5, 6])
+
+        for padding in [_RSA.Signing.Padding.PSS, .insecurePKCS1v1_5] {
+            let signature = try await key.signature(for: digest, padding: padding, offloadingTo: offload)
+            XCTAssertTrue(key.publicKey.isValidSignature(signature, for: digest, padding: padding))
+        }
+        XCTAssertEqual(provider.batchSizes, [1, 1])
+        let statistics = offload.statistics
+        XCTAssertEqual(statistics.offloaded, 0)
+        XCTAssertEqual(statistics.softwareAfterFailure, 2)
+    }
+
+    func testUnsupportedDigestIsRejected() async throws {
+        let provider = SoftwareProvider(maximumBatchSize: 1, maximumOutstandingRequests: 8)
+        let offload = _SigningOffload(provider: provider)
+        let key = P256.Signing.PrivateKey()
+        do {
+            _ = try await key.signature(for: Insecure.MD5.hash(data: [1]), offloadingTo: offload)
+            XCTFail("Expected an error")
+        } catch CryptoKitError.incorrectParameterSize {
+            // Expected.
+        }
+        XCTAssertEqual(provider.batchSizes, [])
+    }
+}
@@ -0,0 +1,53 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class SipHashTests: XCTestCase {
+    // The reference key 00 01 ... 0f from the SipHash paper.
+    let referenceKey = SymmetricKey(data: Array(UInt8(0)..<16))
+
+    func testReferenceVectors() throws {
+        let siphash = try _SipHash24(key: self.referenceKey)
+        XCTAssertEqual(siphash.hash(data: Data()), 0x726f_db47_dd0e_0e31)
+        XCTAssertEqual(siphash.hash(data: Array(UInt8(0)..<15)), 0xa129_ca61_49be_45e5)
+    }
+
+    func testBatchMatchesSingleInputs() throws {
+        let siphash = try _SipHash24(key: SymmetricKey(size: .bits128))
+        let message = Array(UInt8(0)..<128)
+
+        // Mixed lengths, then a run of equal lengths, with a ragged tail.
+        let lengths = Array(0..<70) + Array(repeating: 16, count: 9)
+        message.withUnsafeBytes { message in
+            let inputs = lengths.enumerated().map { index, length in
+                UnsafeRawBufferPointer(rebasing: message[(index % 7)..<((index % 7) + length)])
+            }
+            XCTAssertEqual(siphash.hashes(batch: inputs), inputs.map { siphash.hash(bufferPointer: $0) })
+        }
+        XCTAssertEqual(siphash.hashes(batch: []), [])
+    }
+
+    func testInvalidKeySize() throws {
+        XCTAssertThrowsError(try _SipHash24(key: SymmetricKey(size: .bits256))) { error in
+            guard case .some(.incorrectKeySize) = error as? CryptoKitError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+    }
+}
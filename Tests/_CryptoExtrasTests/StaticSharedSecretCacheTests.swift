@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class StaticSharedSecretCacheTests: XCTestCase {
+    private func bytes(_ secret: SharedSecret) -> Data {
+        secret.withUnsafeBytes { Data($0) }
+    }
+
+    func testCachedSecretsMatchKeyAgreement() throws {
+        let cache = _StaticSharedSecretCache(capacity: 16, shards: 2)
+
+        let x25519 = Curve25519.KeyAgreement.PrivateKey()
+        let x25519Peer = Curve25519.KeyAgreement.PrivateKey().publicKey
+        let p256 = P256.KeyAgreement.PrivateKey()
+        let p256Peer = P256.KeyAgreement.PrivateKey().publicKey
+        let p384 = P384.KeyAgreement.PrivateKey()
+        let p384Peer = P384.KeyAgreement.PrivateKey().publicKey
+        let p521 = P521.KeyAgreement.PrivateKey()
+        let p521Peer = P521.KeyAgreement.PrivateKey().publicKey
+
+        for _ in 0..<2 {
+            XCTAssertEqual(
+                self.bytes(try x25519._sharedSecretFromKeyAgreement(with: x25519Peer, cachingIn: cache)),
+                self.bytes(try x25519.sharedSecretFromKeyAgreement(with: x25519Peer))
+            )
+            XCTAssertEqual(
+                self.bytes(try p256._sharedSecretFromKeyAgreement(with: p256Peer, cachingIn: cache)),
+                self.bytes(try p256.sharedSecretFromKeyAgreement(with: p256Peer))
+            )
+            XCTAssertEqual(
+                self.bytes(try p384._sharedSecretFromKeyAgreement(with: p384Peer, cachingIn: cache)),
+                self.bytes(try p384.sharedSecretFromKeyAgreement(with: p384Peer))
+            )
+            XCTAssertEqual(
+                self.bytes(try p521._sharedSecretFromKeyAgreement(with: p521Peer, cachingIn: cache)),
+                self.bytes(try p521.sharedSecretFromKeyAgreement(with: p521Peer))
+            )
+        }
+        let statistics = cache.statistics
+        XCTAssertEqual(statistics.secretCount, 4)
+        XCTAssertEqual(statistics.misses, 4)
+        XCTAssertEqual(statistics.hits, 4)
+    }
+
+    func testSecretsAreKeyedByBothKeys() throws {
+        let cache = _StaticSharedSecretCache()
+        let first = Curve25519.KeyAgreement.PrivateKey()
+        let second = Curve25519.KeyAgreement.PrivateKey()
+        let peer = Curve25519.KeyAgreement.PrivateKey()
+
+        let firstSecret = try first._sharedSecretFromKeyAgreement(with: peer.publicKey, cachingIn: cache)
+        let secondSecret = try second._sharedSecretFromKeyAgreement(with: peer.publicKey, cachingIn: cache)
+        XCTAssertNotEqual(self.bytes(firstSecret), self.bytes(secondSecret))
+        XCTAssertEqual(self.bytes(secondSecret), self.bytes(try second.sharedSecretFromKeyAgreement(with: peer.publicKey)))
+
+        // The peer computing from its side is a different pair of keys, but the same secret.
+        let reverse = try peer._sharedSecretFromKeyAgreement(with: first.publicKey, cachingIn: cache)
+        XCTAssertEqual(self.bytes(reverse), self.bytes(firstSecret))
+        XCTAssertEqual(cache.statistics.misses, 3)
+    }
+
+    func testLeastRecentlyUsedSecretIsEvicted() throws {
+        // A single shard makes the eviction order deterministic.
+        let cache = _StaticSharedSecretCache(capacity: 2, shards: 1)
+        let local = P256.KeyAgreement.PrivateKey()
+        let peers = (0..<3).map { _ in P256.KeyAgreement.PrivateKey().publicKey }
+
+        for index in [0, 1, 0, 2, 0, 1] {
+            _ = try local._sharedSecretFromKeyAgreement(with: peers[index], cachingIn: cache)
+        }
+        let statistics = cache.statistics
+        XCTAssertEqual(statistics.misses, 4)
+        XCTAssertEqual(statistics.hits, 2)
+        XCTAssertEqual(statistics.evictions, 2)
+        XCTAssertEqual(statistics.secretCount, 2)
+
+        cache.removeAll()
+        XCTAssertEqual(cache.statistics.secretCount, 0)
+    }
+}
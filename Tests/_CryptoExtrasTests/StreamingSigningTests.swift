@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class StreamingSigningTests: XCTestCase {
+    func testECDSAStreamingSignatureVerifiesAsOneShot() throws {
+        let message = Data((0..<10_000).map { UInt8(truncatingIfNeeded: $0) })
+        let privateKey = P256.Signing.PrivateKey()
+
+        var signer = P256.Signing._StreamingSigner(privateKey: privateKey)
+        for start in stride(from: 0, to: message.count, by: 777) {
+            signer.update(data: message[start..<min(start + 777, message.count)])
+        }
+        let signature = try signer.signature()
+        XCTAssertTrue(privateKey.publicKey.isValidSignature(signature, for: message))
+
+        var verifier = P256.Signing._StreamingVerifier(publicKey: privateKey.publicKey)
+        verifier.update(data: message.prefix(5000))
+        verifier.update(data: message.dropFirst(5000))
+        XCTAssertTrue(verifier.isValidSignature(signature))
+
+        verifier.update(data: [0])
+        XCTAssertFalse(verifier.isValidSignature(signature))
+    }
+
+    func testECDSAStreamingOtherCurves() throws {
+        let message = Data("a message in two parts".utf8)
+
+        let p384Key = P384.Signing.PrivateKey()
+        var p384Signer = P384.Signing._StreamingSigner(privateKey: p384Key)
+        p384Signer.update(data: message.prefix(3))
+        p384Signer.update(data: message.dropFirst(3))
+        XCTAssertTrue(p384Key.publicKey.isValidSignature(try p384Signer.signature(), for: message))
+
+        let p521Key = P521.Signing.PrivateKey()
+        var p521Signer = P521.Signing._StreamingSigner(privateKey: p521Key)
+        p521Signer.update(data: message.prefix(3))
+        p521Signer.update(data: message.dropFirst(3))
+        XCTAssertTrue(p521Key.publicKey.isValidSignature(try p521Signer.signature(), for: message))
+    }
+
+    func testEd25519phMatchesRFC8032() throws {
+        // RFC 8032, section 7.3.
+        let privateKey = try Curve25519.Signing.PrivateKey(rawRepresentation: Array(hexString: "833fe62409237b9d62ec77587520911e9a759cec1d19755b7da901b96dca3d42"))
+        let expectedSignature = try Data(hexString: "98a70222f0b8121aa9d30f813d683f809e462b469c7ff87639499bb94e6dae4131f85042463c2a355a2003d062adf5aaa10b8c61e636062aaad11c2a26083406")
+
+        var signer = Curve25519.Signing._Ed25519phSigner(privateKey: privateKey)
+        signer.update(data: Data("a".utf8))
+        signer.update(data: Data("bc".utf8))
+        let signature = try signer.signature()
+        XCTAssertEqual(signature, expectedSignature)
+
+        var verifier = Curve25519.Signing._Ed25519phVerifier(publicKey: privateKey.publicKey)
+        verifier.update(data: Data("abc".utf8))
+        XCTAssertTrue(verifier.isValidSignature(signature))
+
+        let digest = SHA512.hash(data: Data("abc".utf8))
+        XCTAssertEqual(try privateKey._ed25519phSignature(for: digest, context: Data()), expectedSignature)
+        XCTAssertTrue(privateKey.publicKey._isValidEd25519phSignature(signature, for: digest, context: Data()))
+
+        // Ed25519ph and Ed25519 signatures must not be confused.
+        XCTAssertFalse(privateKey.publicKey.isValidSignature(signature, for: Data("abc".utf8)))
+        XCTAssertFalse(privateKey.publicKey._isValidEd25519phSignature(try privateKey.signature(for: Data("abc".utf8)), for: digest, context: Data()))
+    }
+
+    func testEd25519phContext() throws {
+        let privateKey = Curve25519.Signing.PrivateKey()
+        let digest = SHA512.hash(data: Data("message".utf8))
+        let signature = try privateKey._ed25519phSignature(for: digest, context: Data("context".utf8))
+
+        XCTAssertTrue(privateKey.publicKey._isValidEd25519phSignature(signature, for: digest, context: Data("context".utf8)))
+        XCTAssertFalse(privateKey.publicKey._isValidEd25519phSignature(signature, for: digest, context: Data()))
+        XCTAssertFalse(privateKey.publicKey._isValidEd25519phSignature(signature, for: digest, context: Data("contexu".utf8)))
+
+        XCTAssertThrowsError(try Curve25519.Signing._Ed25519phSigner(privateKey: privateKey, context: Data(count: 256))) { error in
+            guard case .some(.incorrectParameterSize) = error as? CryptoKitError else {
+                XCTFail("Unexpected error: \(error)")
+                return
+            }
+        }
+    }
+}
@@ -0,0 +1,130 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class SymmetricKeyStoreTests: XCTestCase {
+    let message = Array("Some message to seal with a stored key".utf8)
+    let authenticatedData = Array("Some authenticated data".utf8)
+
+    func testAEADInteroperatesWithOneShot() throws {
+        for size in [SymmetricKeySize.bits128, .bits192, .bits256] {
+            let store = _SymmetricKeyStore(keySize: size)
+            let key = SymmetricKey(size: size)
+            let handle = try store.insert(key)
+            let nonce = AES.GCM.Nonce()
+
+            let sealed = try AES.GCM._seal(message, using: handle, in: store, nonce: nonce, authenticating: authenticatedData)
+            let expected = try AES.GCM.seal(message, using: key, nonce: nonce, authenticating: authenticatedData)
+            XCTAssertEqual(sealed.combined, expected.combined)
+            XCTAssertEqual(try AES.GCM._open(expected, using: handle, in: store, authenticating: authenticatedData), Data(message))
+            XCTAssertThrowsError(try AES.GCM._open(sealed, using: handle, in: store, authenticating: [UInt8]()))
+        }
+
+        let store = _SymmetricKeyStore(keySize: .bits256)
+        let key = SymmetricKey(size: .bits256)
+        let handle = try store.insert(key)
+        let sealed = try ChaChaPoly._seal(message, using: handle, in: store, authenticating: authenticatedData)
+        XCTAssertEqual(try ChaChaPoly.open(sealed, using: key, authenticating: authenticatedData), Data(message))
+        XCTAssertEqual(try ChaChaPoly._open(sealed, using: handle, in: store, authenticating: authenticatedData), Data(message))
+    }
+
+    func testHMACAndHKDFInteroperateWithOneShot() throws {
+        let store = _SymmetricKeyStore(keySize: .bits256)
+        let key = SymmetricKey(size: .bits256)
+        let handle = try store.insert(key)
+
+        var code = [UInt8](repeating: 0, count: SHA384.byteCount)
+        try code.withUnsafeMutableBytes { try HMAC<SHA384>._authenticationCode(for: message, using: handle, in: store, into: $0) }
+        XCTAssertEqual(code, Array(HMAC<SHA384>.authenticationCode(for: message, using: key)))
+        XCTAssertTrue(try HMAC<SHA384>._isValidAuthenticationCode(code, authenticating: message, using: handle, in: store))
+        code[0] ^= 1
+        XCTAssertFalse(try HMAC<SHA384>._isValidAuthenticationCode(code, authenticating: message, using: handle, in: store))
+
+        var derived = [UInt8](repeating: 0, count: 42)
+        try derived.withUnsafeMutableBytes {
+            try HKDF<SHA256>._deriveKey(inputKeyMaterial: handle, in: store, salt: [1, 2, 3], info: [4, 5], into: $0)
+        }
+        let expected = HKDF<SHA256>.deriveKey(inputKeyMaterial: key, salt: [1, 2, 3], info: [4, 5], outputByteCount: 42)
+        XCTAssertEqual(derived, expected.withUnsafeBytes { Array($0) })
+    }
+
+    func testRemovedHandlesAreRejected() throws {
+        let store = _SymmetricKeyStore(keySize: .bits128)
+        let first = try store.insertRandomKey()
+        XCTAssertTrue(store.contains(first))
+        XCTAssertTrue(store.remove(first))
+        XCTAssertFalse(store.remove(first))
+        XCTAssertFalse(store.contains(first))
+
+        // The slot is reused, but the old handle must not reach the new key.
+        let second = try store.insertRandomKey()
+        XCTAssertNotEqual(first, second)
+        XCTAssertThrowsError(try AES.GCM._seal(message, using: first, in: store, authenticating: [UInt8]())) { error in
+            guard case CryptoKitError.invalidParameter = error else {
+                return XCTFail("Unexpected error \(error)")
+            }
+        }
+        XCTAssertNoThrow(try AES.GCM._seal(message, using: second, in: store, authenticating: [UInt8]()))
+        XCTAssertEqual(store.count, 1)
+    }
+
+    func testWrongKeySizeIsRejected() {
+        let store = _SymmetricKeyStore(keySize: .bits256)
+        XCTAssertThrowsError(try store.insert(SymmetricKey(size: .bits128)))
+        XCTAssertThrowsError(try store.insert(bytes: [UInt8](repeating: 0, count: 31)))
+        XCTAssertEqual(store.count, 0)
+
+        let aesOnly = _SymmetricKeyStore(keySize: .bits128)
+        let handle = try! aesOnly.insertRandomKey()
+        XCTAssertThrowsError(try ChaChaPoly._seal(message, using: handle, in: aesOnly, authenticating: [UInt8]()))
+    }
+
+    func testStoreGrowsInWholeChunks() throws {
+        let store = _SymmetricKeyStore(keySize: .bits256, minimumCapacity: 10_000)
+        let reserved = store.keyMaterialByteCount
+        XCTAssertGreaterThanOrEqual(reserved, 10_000 * 32)
+
+        let handles = try (0..<10_000).map { _ in try store.insertRandomKey() }
+        XCTAssertEqual(store.count, 10_000)
+        XCTAssertEqual(store.keyMaterialByteCount, reserved)
+        XCTAssertEqual(Set(handles).count, handles.count)
+
+        for handle in handles {
+            store.remove(handle)
+        }
+        XCTAssertEqual(store.count, 0)
+    }
+
+    func testConcurrentUse() throws {
+        let store = _SymmetricKeyStore(keySize: .bits256)
+        let keys = (0..<64).map { _ in SymmetricKey(size: .bits256) }
+        let handles = try keys.map { try store.insert($0) }
+        let message = self.message
+        DispatchQueue.concurrentPerform(iterations: 8) { thread in
+            for round in 0..<200 {
+                let index = (thread + round) % keys.count
+                let sealed = try! AES.GCM._seal(message, using: handles[index], in: store, authenticating: [UInt8]())
+                XCTAssertEqual(try AES.GCM.open(sealed, using: keys[index]), Data(message))
+                // Churn some slots that nobody else reads.
+                let scratch = try! store.insertRandomKey()
+                store.remove(scratch)
+            }
+        }
+        XCTAssertEqual(store.count, keys.count)
+    }
+}
@@ -30,6 +30,26 @@ final class TestRSAEncryption: XCTestCase {
             testFunction: self.testOAEPGroup)
     }
     
+    func testConcurrentOperationsWithBothPaddings() throws {
+        let privateKey = try _RSA.Encryption.PrivateKey(keySize: .bits2048)
+        let publicKey = privateKey.publicKey
+        let message = Data("a data key".utf8)
+
+        DispatchQueue.concurrentPerform(iterations: 32) { iteration in
+            let padding: _RSA.Encryption.Padding = iteration.isMultiple(of: 2) ? .PKCS1_OAEP : .PKCS1_OAEP_SHA256
+            let otherPadding: _RSA.Encryption.Padding = iteration.isMultiple(of: 2) ? .PKCS1_OAEP_SHA256 : .PKCS1_OAEP
+            do {
+                let ciphertext = try publicKey.encrypt(message, padding: padding)
+                XCTAssertEqual(try privateKey.decrypt(ciphertext, padding: padding), message)
+                // A failed decryption must not disturb the context it used.
+                XCTAssertThrowsError(try privateKey.decrypt(ciphertext, padding: otherPadding))
+                XCTAssertEqual(try privateKey.decrypt(ciphertext, padding: padding), message)
+            } catch {
+                XCTFail("Unexpected error: \(error)")
+            }
+        }
+    }
+
     private func testOAEPGroup(_ group: RSAEncryptionOAEPTestGroup) throws {
         let derPrivKey: _RSA.Encryption.PrivateKey
         let pemPrivKey: _RSA.Encryption.PrivateKey
@@ -281,6 +281,139 @@ final class TestRSASigning: XCTestCase {
         XCTAssertTrue(key.publicKey.isValidSignature(roundTripped, for: data))
     }
 
+    func testPreparedAndCachedPublicKeys() throws {
+        _RSA.Signing.PublicKey._removeAllCachedKeys()
+        defer {
+            _RSA.Signing.PublicKey._removeAllCachedKeys()
+        }
+
+        let data = Array("hello, world!".utf8)
+        let key = try _RSA.Signing.PrivateKey(keySize: .bits2048)
+        let signature = try key.signature(for: data)
+
+        let preparedKey = key.publicKey
+        preparedKey._prepare()
+        preparedKey._prepare()
+        XCTAssertTrue(preparedKey.isValidSignature(signature, for: data))
+
+        let der = key.publicKey.derRepresentation
+        let first = try _RSA.Signing.PublicKey._cached(derRepresentation: der)
+        let second = try _RSA.Signing.PublicKey._cached(derRepresentation: der)
+        XCTAssertEqual(first.derRepresentation, der)
+        XCTAssertEqual(second.derRepresentation, der)
+        XCTAssertTrue(first.isValidSignature(signature, for: data))
+        XCTAssertTrue(second.isValidSignature(signature, for: data))
+        XCTAssertFalse(second.isValidSignature(signature, for: data.dropLast()))
+
+        let third = try _RSA.Signing.PublicKey._cached(pemRepresentation: key.publicKey.pemRepresentation)
+        let fourth = try _RSA.Signing.PublicKey._cached(pemRepresentation: "preamble\n" + key.publicKey.pemRepresentation)
+        XCTAssertEqual(third.derRepresentation, der)
+        XCTAssertEqual(fourth.derRepresentation, der)
+        XCTAssertTrue(third.isValidSignature(signature, for: data))
+
+        let smallKey = try _RSA.Signing.PrivateKey(unsafeKeySize: .init(bitCount: 1024))
+        XCTAssertThrowsError(try _RSA.Signing.PublicKey._cached(derRepresentation: smallKey.publicKey.derRepresentation))
+    }
+
+    func testPEMImportWithSurroundingText() throws {
+        let key = try _RSA.Signing.PrivateKey(keySize: .bits2048)
+
+        // These are rejected by the strict PEM decoder, so they go through BoringSSL's PEM reader.
+        let privatePEM = "Bag Attributes\n" + key.pemRepresentation + "\n"
+        XCTAssertEqual(try _RSA.Signing.PrivateKey(pemRepresentation: privatePEM).derRepresentation, key.derRepresentation)
+        let pkcs8PEM = "Bag Attributes\n" + key.pkcs8PEMRepresentation + "\n"
+        XCTAssertEqual(try _RSA.Signing.PrivateKey(pemRepresentation: pkcs8PEM).derRepresentation, key.derRepresentation)
+        let publicPEM = "Bag Attributes\n" + key.publicKey.pemRepresentation + "\n"
+        XCTAssertEqual(try _RSA.Signing.PublicKey(pemRepresentation: publicPEM).derRepresentation, key.publicKey.derRepresentation)
+
+        // A PKCS #1 body under the SPKI label is rejected on either path.
+        let mislabelled = key.publicKey.pkcs1PEMRepresentation.replacingOccurrences(of: "RSA PUBLIC KEY", with: "PUBLIC KEY")
+        XCTAssertThrowsError(try _RSA.Signing.PublicKey(pemRepresentation: mislabelled))
+        XCTAssertThrowsError(try _RSA.Signing.PublicKey(pemRepresentation: "Bag Attributes\n" + mislabelled))
+    }
+
+    func testConcurrentKeyGeneration() throws {
+        let data = Array("hello, world!".utf8)
+        for concurrency in [0, 1, 4] {
+            let key = try _RSA.Signing.PrivateKey(keySize: .bits2048, _concurrency: concurrency)
+            XCTAssertEqual(key.keySizeInBits, 2048)
+            let signature = try key.signature(for: data)
+            XCTAssertTrue(key.publicKey.isValidSignature(signature, for: data))
+        }
+
+        XCTAssertThrowsError(try _RSA.Signing.PrivateKey(keySize: .init(bitCount: 1024), _concurrency: 4))
+    }
+
+    func testShardedSigningKeys() throws {
+        let data = Array("hello, world!".utf8)
+        let key = try _RSA.Signing.PrivateKey(keySize: .bits2048)
+        let sharded = key._withSigningShards(4)
+        XCTAssertEqual(sharded.derRepresentation, key.derRepresentation)
+        XCTAssertEqual(sharded.publicKey.derRepresentation, key.publicKey.derRepresentation)
+
+        let results = UnsafeMutableBufferPointer<Bool>.allocate(capacity: 16)
+        defer {
+            results.deallocate()
+        }
+        DispatchQueue.concurrentPerform(iterations: results.count) { index in
+            let signature = try! sharded.signature(for: data, padding: index.isMultiple(of: 2) ? .PSS : .insecurePKCS1v1_5)
+            results[index] = key.publicKey.isValidSignature(signature, for: data, padding: index.isMultiple(of: 2) ? .PSS : .insecurePKCS1v1_5)
+        }
+        XCTAssertTrue(results.allSatisfy { $0 })
+    }
+
+    func testParallelCRTSigning() throws {
+        let data = Array("hello, world!".utf8)
+        let key = try _RSA.Signing.PrivateKey(keySize: .bits3072)
+        let parallel = key._withParallelCRT()
+        XCTAssertEqual(parallel.derRepresentation, key.derRepresentation)
+
+        // The first signature prepares the key; the rest take the parallel path.
+        for _ in 0..<3 {
+            let pkcs1 = try parallel.signature(for: data, padding: .insecurePKCS1v1_5)
+            XCTAssertEqual(pkcs1.rawRepresentation, try key.signature(for: data, padding: .insecurePKCS1v1_5).rawRepresentation)
+
+            let pss = try parallel.signature(for: data, padding: .PSS)
+            XCTAssertTrue(key.publicKey.isValidSignature(pss, for: data, padding: .PSS))
+        }
+    }
+
+    func testGarbageSignaturesAreRejected() throws {
+        let key = try _RSA.Signing.PrivateKey(keySize: .bits2048)
+        let digest = SHA256.hash(data: Array("hello, world!".utf8))
+        let garbage = [
+            _RSA.Signing.RSASignature(rawRepresentation: [UInt8](repeating: 0, count: 256)),
+            _RSA.Signing.RSASignature(rawRepresentation: [UInt8](repeating: 0xff, count: 256)),
+            _RSA.Signing.RSASignature(rawRepresentation: [UInt8](repeating: 0x01, count: 257)),
+            _RSA.Signing.RSASignature(rawRepresentation: []),
+        ]
+
+        for padding in [_RSA.Signing.Padding.PSS, .insecurePKCS1v1_5] {
+            for signature in garbage {
+                XCTAssertFalse(key.publicKey.isValidSignature(signature, for: digest, padding: padding))
+            }
+            let signature = try key.signature(for: digest, padding: padding)
+            XCTAssertTrue(key.publicKey.isValidSignature(signature, for: digest, padding: padding))
+        }
+    }
+
+    func testBatchVerification() throws {
+        let key = try _RSA.Signing.PrivateKey(keySize: .bits2048)
+        let digests = (0..<8).map { SHA256.hash(data: Array("message \($0)".utf8)) }
+
+        for padding in [_RSA.Signing.Padding.PSS, .insecurePKCS1v1_5] {
+            var signatures = try digests.map { try key.signature(for: $0, padding: padding) }
+            var corrupted = Array(signatures[3].rawRepresentation)
+            corrupted[17] ^= 1
+            signatures[3] = _RSA.Signing.RSASignature(rawRepresentation: corrupted)
+            signatures[5] = _RSA.Signing.RSASignature(rawRepresentation: signatures[5].rawRepresentation.dropLast())
+
+            let results = key.publicKey._areValidSignatures(signatures, for: digests, padding: padding)
+            XCTAssertEqual(results, zip(signatures, digests).map { key.publicKey.isValidSignature($0, for: $1, padding: padding) })
+            XCTAssertEqual(results, [true, true, true, false, true, false, true, true])
+        }
+    }
+
     func testKeySizes() throws {
         let keysAndSizes: [(_RSA.Signing.PrivateKey, Int)] = try [
             (_RSA.Signing.PrivateKey(keySize: .bits2048), 2048),
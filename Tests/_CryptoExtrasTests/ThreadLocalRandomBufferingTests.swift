@@ -0,0 +1,59 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class ThreadLocalRandomBufferingTests: XCTestCase {
+    override func tearDown() {
+        _CryptoRandom._isThreadLocalBufferingEnabled = false
+        super.tearDown()
+    }
+
+    func testBufferedKeysAreDistinct() {
+        _CryptoRandom._isThreadLocalBufferingEnabled = true
+
+        // Enough keys to run through the buffer several times, plus one request too large to be buffered.
+        var keys = Set<Data>()
+        for _ in 0..<1000 {
+            keys.insert(SymmetricKey(size: .bits256).withUnsafeBytes { Data($0) })
+        }
+        keys.insert(SymmetricKey(size: .init(bitCount: 8 * 512)).withUnsafeBytes { Data($0) })
+        XCTAssertEqual(keys.count, 1001)
+    }
+
+    func testBufferedNoncesSealAndOpen() throws {
+        _CryptoRandom._isThreadLocalBufferingEnabled = true
+
+        let key = SymmetricKey(size: .bits256)
+        let message = Data("hello, world".utf8)
+        let nonces = (0..<100).map { _ in AES.GCM.Nonce().withUnsafeBytes { Data($0) } }
+        XCTAssertEqual(Set(nonces).count, nonces.count)
+
+        let box = try AES.GCM.seal(message, using: key)
+        XCTAssertEqual(try AES.GCM.open(box, using: key), message)
+    }
+
+    func testToggling() {
+        _CryptoRandom._isThreadLocalBufferingEnabled = false
+        XCTAssertFalse(_CryptoRandom._isThreadLocalBufferingEnabled)
+        #if CRYPTO_IN_SWIFTPM && !CRYPTO_IN_SWIFTPM_FORCE_BUILD_API
+        #else
+        _CryptoRandom._isThreadLocalBufferingEnabled = true
+        XCTAssertTrue(_CryptoRandom._isThreadLocalBufferingEnabled)
+        #endif
+    }
+}
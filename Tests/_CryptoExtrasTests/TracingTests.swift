@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class TracingTests: XCTestCase {
+    private final class EventLog: @unchecked Sendable {
+        private let lock = NSLock()
+        private var events: [_CryptoTracing.Event] = []
+        private let thread = Thread.current
+
+        func record(_ event: _CryptoTracing.Event) {
+            // Other tests may run crypto on other threads at the same time.
+            guard Thread.current == self.thread else {
+                return
+            }
+            self.lock.lock()
+            self.events.append(event)
+            self.lock.unlock()
+        }
+
+        var recorded: [_CryptoTracing.Event] {
+            self.lock.lock()
+            defer {
+                self.lock.unlock()
+            }
+            return self.events
+        }
+    }
+
+    func testHandlerSeesStartAndEndOfOperations() throws {
+        let log = EventLog()
+        _CryptoTracing.setHandler { log.record($0) }
+        defer {
+            _CryptoTracing.setHandler(nil)
+        }
+
+        let key = SymmetricKey(size: .bits256)
+        let box = try AES.GCM.seal(Data(repeating: 0x2a, count: 100), using: key)
+        XCTAssertThrowsError(try AES.GCM.open(box, using: SymmetricKey(size: .bits256)))
+        let signingKey = P256.Signing.PrivateKey()
+        _ = try signingKey.signature(for: Data("message".utf8))
+
+        guard _CryptoTracing.isEnabled else {
+            XCTAssertTrue(log.recorded.isEmpty)
+            return
+        }
+
+        let events = log.recorded
+        let seal = events.filter { $0.operation == .aeadSeal }
+        XCTAssertEqual(seal.map(\.isEnd), [false, true])
+        XCTAssertEqual(seal.map(\.byteCount), [100, 100])
+        XCTAssertEqual(seal.last?.succeeded, true)
+        XCTAssertEqual(seal.map(\.keyBits), [256, 256])
+
+        let open = events.filter { $0.operation == .aeadOpen }
+        XCTAssertEqual(open.map(\.isEnd), [false, true])
+        XCTAssertEqual(open.last?.succeeded, false)
+        XCTAssertEqual(Set(open.map(\.algorithm)), Set(seal.map(\.algorithm)))
+
+        let sign = events.filter { $0.operation == .ecdsaSign }
+        XCTAssertEqual(sign.map(\.isEnd), [false, true])
+        XCTAssertEqual(sign.map(\.byteCount), [32, 32])
+        XCTAssertEqual(sign.map(\.keyBits), [256, 256])
+        XCTAssertEqual(sign.last?.succeeded, true)
+    }
+
+    func testRemovingTheHandlerStopsEvents() throws {
+        let log = EventLog()
+        _CryptoTracing.setHandler { log.record($0) }
+        _CryptoTracing.setHandler(nil)
+
+        _ = try AES.GCM.seal(Data(repeating: 0, count: 16), using: SymmetricKey(size: .bits128))
+        XCTAssertTrue(log.recorded.isEmpty)
+    }
+}
@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class TreeHashTests: XCTestCase {
+    /// A direct transcription of the RFC 6962 Merkle Tree Hash, to check the tree against.
+    private static func referenceTreeHash<H: HashFunction>(_ leaves: ArraySlice<ArraySlice<UInt8>>, _: H.Type) -> [UInt8] {
+        if leaves.count == 1 {
+            return Array(H.hash(data: [0x00] + leaves.first!))
+        }
+
+        var split = 1
+        while split * 2 < leaves.count {
+            split *= 2
+        }
+
+        let left = Self.referenceTreeHash(leaves.prefix(split), H.self)
+        let right = Self.referenceTreeHash(leaves.dropFirst(split), H.self)
+        return Array(H.hash(data: [0x01] + left + right))
+    }
+
+    private static func leaves(of data: [UInt8], leafByteCount: Int) -> ArraySlice<ArraySlice<UInt8>> {
+        if data.isEmpty {
+            return [[]]
+        }
+        return ArraySlice(stride(from: 0, to: data.count, by: leafByteCount).map {
+            data[$0..<min($0 + leafByteCount, data.count)]
+        })
+    }
+
+    func testMatchesReferenceConstruction() throws {
+        let leafByteCount = 64
+        for leafCount in [0, 1, 2, 3, 5, 6, 7, 8, 13] {
+            let data = [UInt8]((0..<(leafCount * leafByteCount - (leafCount > 0 ? 5 : 0))).map { UInt8(truncatingIfNeeded: $0) })
+            let expected = Self.referenceTreeHash(Self.leaves(of: data, leafByteCount: leafByteCount), SHA256.self)
+
+            let concurrent = _TreeHash<SHA256>(hashing: data, leafByteCount: leafByteCount)
+            let serial = _TreeHash<SHA256>(hashing: data, leafByteCount: leafByteCount, concurrently: false)
+            XCTAssertEqual(Array(concurrent.root), expected, "leafCount: \(leafCount)")
+            XCTAssertEqual(Array(serial.root), expected, "leafCount: \(leafCount)")
+            XCTAssertEqual(concurrent.leafCount, max(1, leafCount))
+        }
+    }
+
+    func testRootDiffersFromPlainHash() throws {
+        let data = [UInt8](repeating: 0x42, count: 100)
+        XCTAssertNotEqual(Array(_TreeHash<SHA512>(hashing: data).root), Array(SHA512.hash(data: data)))
+    }
+
+    func testUpdatingLeafMatchesRebuild() throws {
+        let leafByteCount = 32
+        var data = [UInt8]((0..<(leafByteCount * 11 + 7)).map { UInt8(truncatingIfNeeded: $0) })
+        var tree = _TreeHash<SHA384>(hashing: data, leafByteCount: leafByteCount)
+
+        for index in [0, 5, 10, 11] {
+            let start = index * leafByteCount
+            let end = min(start + leafByteCount, data.count)
+            for offset in start..<end {
+                data[offset] ^= 0xFF
+            }
+
+            tree.updateLeaf(at: index, with: data[start..<end])
+            let rebuilt = _TreeHash<SHA384>(hashing: data, leafByteCount: leafByteCount)
+            XCTAssertEqual(Array(tree.root), Array(rebuilt.root), "index: \(index)")
+        }
+    }
+}
@@ -0,0 +1,283 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class TrustStoreTests: XCTestCase {
+    static let firstCertificate = """
+        -----BEGIN CERTIFICATE-----
+        MIIBlzCCAT2gAwIBAgIUfaermshaYTk3BLXHC/GaYHU9soMwCgYIKoZIzj0EAwIw
+        IDEeMBwGA1UEAwwVVHJ1c3QgU3RvcmUgVGVzdCBDQSAxMCAXDTI2MTAxNDEzNTcy
+        N1oYDzIxMjYwOTIwMTM1NzI3WjAgMR4wHAYDVQQDDBVUcnVzdCBTdG9yZSBUZXN0
+        IENBIDEwWTATBgcqhkjOPQIBBggqhkjOPQMBBwNCAASrgoP8IRahW28NyD/Vi2Dk
+        OdyC7XSEIRGA+GhVcs5bmCmctZwHgena2RjNBlLube7IeXshlz2pdLlRhV9DxwS0
+        o1MwUTAdBgNVHQ4EFgQUgiPfCxg/VXvHMK0qzbmG99E0kKAwHwYDVR0jBBgwFoAU
+        giPfCxg/VXvHMK0qzbmG99E0kKAwDwYDVR0TAQH/BAUwAwEB/zAKBggqhkjOPQQD
+        AgNIADBFAiEAleG8HqDLbGcvIVPl9RqNwnLSri69AZo64VTPWNYdd2gCIDQrdzpU
+        SRM2IgwbAmrUT2T6tFZ8eWnunsXrtVfoVDSM
+        -----END CERTIFICATE-----
+        """
+
+    static let secondCertificate = """
+        -----BEGIN CERTIFICATE-----
+        MIIBlzCCAT2gAwIBAgIUWlIoHCbiV4TFQcPtWkAe71XgfXYwCgYIKoZIzj0EAwIw
+        IDEeMBwGA1UEAwwVVHJ1c3QgU3RvcmUgVGVzdCBDQSAyMCAXDTI2MTAxNDEzNTcy
+        N1oYDzIxMjYwOTIwMTM1NzI3WjAgMR4wHAYDVQQDDBVUcnVzdCBTdG9yZSBUZXN0
+        IENBIDIwWTATBgcqhkjOPQIBBggqhkjOPQMBBwNCAAQl3PQFKTJ3i8LzXqaVYtLH
+        i7B8uMY+X6h1HNqnDv1qRo7BE8uEuWrD/nScQki7NriXvQVZcxXPQ8YA0NNl4QhI
+        o1MwUTAdBgNVHQ4EFgQUNUDPKAqUymsa/ziA9OZJ9cx6IggwHwYDVR0jBBgwFoAU
+        NUDPKAqUymsa/ziA9OZJ9cx6IggwDwYDVR0TAQH/BAUwAwEB/zAKBggqhkjOPQQD
+        AgNIADBFAiEA6Prr1E6x+J/jbtAwZG3NQVBllILw+bxK+Y5sVlw5jxoCID/Xt+Ul
+        aNx0lqrjur4a4IS07j2+fKxadmxK+pbd2J1h
+        -----END CERTIFICATE-----
+        """
+
+    func testPEMBundleSkipsCommentsAndOtherBlocks() throws {
+        let bundle = """
+            # A comment, as found in most CA bundles.
+            \(Self.firstCertificate)
+
+            -----BEGIN X509 CRL-----
+            AAAA
+            -----END X509 CRL-----
+            \(Self.secondCertificate)
+            """
+        let store = try _X509TrustStore()
+        let statistics = try store.load(bundle: Array(bundle.utf8))
+        XCTAssertEqual(statistics.byteCount, bundle.utf8.count)
+        XCTAssertEqual(statistics.certificatesParsed, 2)
+        XCTAssertEqual(statistics.objectsSkipped, 1)
+        XCTAssertEqual(statistics.certificatesAdded, 2)
+        XCTAssertEqual(statistics.duplicates, 0)
+        XCTAssertEqual(store.certificateCount, 2)
+    }
+
+    func testDERBundleAndDuplicatesAreIgnored() throws {
+        let der = try [Self.firstCertificate, Self.secondCertificate].map {
+            try ASN1.PEMDocument(pemString: $0).derBytes
+        }
+        let store = try _X509TrustStore()
+        try store.load(bundle: Array(Self.firstCertificate.utf8))
+
+        let statistics = try store.load(bundle: der[0] + der[1] + der[1])
+        XCTAssertEqual(statistics.certificatesParsed, 3)
+        XCTAssertEqual(statistics.certificatesAdded, 1)
+        XCTAssertEqual(statistics.duplicates, 2)
+        XCTAssertEqual(store.certificateCount, 2)
+    }
+
+    func testLargeBundlesAreParsedOnSeveralThreads() throws {
+        let bundle = String(repeating: Self.firstCertificate + "\n" + Self.secondCertificate + "\n", count: 100)
+        let store = try _X509TrustStore()
+        let statistics = try store.load(bundle: Array(bundle.utf8), maximumThreads: 4)
+        XCTAssertEqual(statistics.certificatesParsed, 200)
+        XCTAssertEqual(statistics.certificatesAdded, 2)
+        XCTAssertEqual(statistics.duplicates, 198)
+        XCTAssertEqual(statistics.threadCount, 4)
+        XCTAssertEqual(store.certificateCount, 2)
+    }
+
+    func testMalformedBundleAddsNothing() throws {
+        var bundle = Array((Self.firstCertificate + "\n" + Self.secondCertificate).utf8)
+        let secondOffset = Self.firstCertificate.utf8.count + 1
+        bundle[secondOffset + 40] = UInt8(ascii: "!")
+
+        let store = try _X509TrustStore()
+        XCTAssertThrowsError(try store.load(bundle: bundle)) { error in
+            guard case _CryptoTrustStoreError.malformedBundle(let offset) = error else {
+                return XCTFail("Unexpected error \(error)")
+            }
+            XCTAssertEqual(offset, secondOffset)
+        }
+        XCTAssertThrowsError(try store.load(bundle: bundle.prefix(bundle.count - 10)))
+        XCTAssertEqual(store.certificateCount, 0)
+    }
+
+    func testSnapshotParsesCertificatesOnlyWhenNeeded() throws {
+        let der = try [Self.firstCertificate, Self.secondCertificate].map {
+            try Data(ASN1.PEMDocument(pemString: $0).derBytes)
+        }
+        let built = try _X509TrustStore()
+        try built.load(bundle: Array((Self.firstCertificate + "\n" + Self.secondCertificate).utf8))
+        let snapshot = try built.snapshotRepresentation()
+
+        let store = try _X509TrustStore(snapshot: snapshot)
+        XCTAssertEqual(store.certificateCount, 2)
+        XCTAssertEqual(store.snapshotCertificatesParsed, 0)
+
+        // Both certificates are self-signed, so each is its own issuer.
+        XCTAssertEqual(try store.issuer(of: der[0]), der[0])
+        XCTAssertEqual(store.snapshotCertificatesParsed, 1)
+        XCTAssertEqual(try store.issuer(of: der[0]), der[0])
+        XCTAssertEqual(store.snapshotCertificatesParsed, 1)
+        XCTAssertEqual(store.certificateCount, 2)
+
+        // Lookups by key identifier use the snapshot's index.
+        let keyIdentifier: [UInt8] = [
+            0x82, 0x23, 0xdf, 0x0b, 0x18, 0x3f, 0x55, 0x7b, 0xc7, 0x30, 0xad, 0x2a, 0xcd, 0xb9, 0x86, 0xf7, 0xd1, 0x34,
+            0x90, 0xa0,
+        ]
+        XCTAssertEqual(try store.certificate(withSubjectKeyIdentifier: keyIdentifier), der[0])
+        XCTAssertEqual(try built.certificate(withSubjectKeyIdentifier: keyIdentifier), der[0])
+        XCTAssertNil(try store.certificate(withSubjectKeyIdentifier: [1, 2, 3]))
+        XCTAssertEqual(store.snapshotCertificatesParsed, 1)
+
+        // A partly parsed store gives back the snapshot it was opened from.
+        XCTAssertEqual(try store.snapshotRepresentation(), snapshot)
+        XCTAssertEqual(try _X509TrustStore().issuer(of: der[1]), nil)
+        XCTAssertThrowsError(try store.issuer(of: [0x30, 0x00]))
+    }
+
+    func testPinnedAnchorsMatchTheStore() throws {
+        let der = try [Self.firstCertificate, Self.secondCertificate].map {
+            try Data(ASN1.PEMDocument(pemString: $0).derBytes)
+        }
+        let built = try _X509TrustStore()
+        try built.load(bundle: der[0])
+        // One certificate is parsed into the store and the other only in its snapshot, and both are pinned.
+        let store = try _X509TrustStore(snapshot: try {
+            try built.load(bundle: der[1])
+            return try built.snapshotRepresentation()
+        }())
+        XCTAssertEqual(try store.issuer(of: der[0]), der[0])
+        XCTAssertEqual(store.snapshotCertificatesParsed, 1)
+
+        let pinned = try store.pinnedAnchors()
+        XCTAssertEqual(pinned.certificateCount, 2)
+        XCTAssertEqual(store.snapshotCertificatesParsed, 1)
+        for certificate in der {
+            XCTAssertEqual(try pinned.issuer(of: certificate), certificate)
+            XCTAssertEqual(try pinned.issuer(of: certificate), try store.issuer(of: certificate))
+        }
+
+        // Later loads don't change what was pinned.
+        let empty = try _X509TrustStore()
+        let pinnedEmpty = try empty.pinnedAnchors()
+        try empty.load(bundle: der[0])
+        XCTAssertEqual(pinnedEmpty.certificateCount, 0)
+        XCTAssertNil(try pinnedEmpty.issuer(of: der[0]))
+        XCTAssertThrowsError(try pinned.issuer(of: [0x30, 0x00]))
+    }
+
+    func testSnapshotIsMappedFromFile() throws {
+        let store = try _X509TrustStore()
+        try store.load(bundle: Array(Self.secondCertificate.utf8))
+        let url = FileManager.default.temporaryDirectory.appendingPathComponent("trust-store-\(UUID()).bin")
+        defer {
+            try? FileManager.default.removeItem(at: url)
+        }
+        try store.snapshotRepresentation().write(to: url)
+
+        let reopened = try _X509TrustStore(contentsOfSnapshot: url)
+        let der = try Data(ASN1.PEMDocument(pemString: Self.secondCertificate).derBytes)
+        XCTAssertEqual(try reopened.issuer(of: der), der)
+    }
+
+    #if !os(Windows)
+    func testDirectoryIsIndexedOnce() throws {
+        let der = try [Self.firstCertificate, Self.secondCertificate].map {
+            try Data(ASN1.PEMDocument(pemString: $0).derBytes)
+        }
+        let directory = FileManager.default.temporaryDirectory.appendingPathComponent("trust-store-\(UUID())")
+        try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: false)
+        defer {
+            try? FileManager.default.removeItem(at: directory)
+        }
+        // Named by X509_NAME_hash of each subject, as `openssl rehash` names them.
+        try Self.firstCertificate.write(
+            to: directory.appendingPathComponent("8e9bdf61.0"),
+            atomically: true,
+            encoding: .utf8
+        )
+        try "Not a certificate".write(to: directory.appendingPathComponent("README"), atomically: true, encoding: .utf8)
+
+        let store = try _X509TrustStore()
+        try store.addCertificateDirectory(atPath: directory.path, refreshInterval: 0)
+        XCTAssertEqual(store.directoryStatistics, .init(filesIndexed: 1, filesLoaded: 0, scans: 1))
+        XCTAssertThrowsError(try store.addCertificateDirectory(atPath: directory.path))
+
+        XCTAssertEqual(try store.issuer(of: der[0]), der[0])
+        XCTAssertEqual(try store.issuer(of: der[0]), der[0])
+        // A subject the directory doesn't hold opens nothing.
+        XCTAssertNil(try store.issuer(of: der[1]))
+        XCTAssertEqual(store.directoryStatistics, .init(filesIndexed: 1, filesLoaded: 1, scans: 1))
+
+        // A file added later is found once the directory's modification time moves.
+        try Self.secondCertificate.write(
+            to: directory.appendingPathComponent("9c91e85c.0"),
+            atomically: true,
+            encoding: .utf8
+        )
+        try FileManager.default.setAttributes(
+            [.modificationDate: Date(timeIntervalSinceNow: 10)],
+            ofItemAtPath: directory.path
+        )
+        XCTAssertEqual(try store.issuer(of: der[1]), der[1])
+        XCTAssertEqual(store.directoryStatistics, .init(filesIndexed: 2, filesLoaded: 2, scans: 2))
+        XCTAssertEqual(try store.pinnedAnchors().certificateCount, 2)
+
+        let missing = directory.path + "-missing"
+        XCTAssertThrowsError(try _X509TrustStore().addCertificateDirectory(atPath: missing)) { error in
+            guard case _CryptoTrustStoreError.unreadableDirectory = error else {
+                return XCTFail("Unexpected error \(error)")
+            }
+        }
+    }
+
+    func testDirectoryIsLoadedForSnapshotsAndPins() throws {
+        let directory = FileManager.default.temporaryDirectory.appendingPathComponent("trust-store-\(UUID())")
+        try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: false)
+        defer {
+            try? FileManager.default.removeItem(at: directory)
+        }
+        try Self.firstCertificate.write(
+            to: directory.appendingPathComponent("8e9bdf61.0"),
+            atomically: true,
+            encoding: .utf8
+        )
+
+        let store = try _X509TrustStore()
+        try store.addCertificateDirectory(atPath: directory.path, refreshInterval: .infinity)
+        XCTAssertEqual(try store.pinnedAnchors().certificateCount, 1)
+        let reopened = try _X509TrustStore(snapshot: try store.snapshotRepresentation())
+        XCTAssertEqual(reopened.certificateCount, 1)
+        XCTAssertEqual(store.directoryStatistics.filesLoaded, 1)
+    }
+    #endif
+
+    func testCorruptedSnapshotIsRejected() throws {
+        let store = try _X509TrustStore()
+        try store.load(bundle: Array(Self.firstCertificate.utf8))
+        let snapshot = try store.snapshotRepresentation()
+
+        for offset in [0, 12, 40, snapshot.count / 2, snapshot.count - 1] {
+            var corrupted = snapshot
+            corrupted[offset] ^= 1
+            XCTAssertThrowsError(try _X509TrustStore(snapshot: corrupted), "offset \(offset)") { error in
+                guard case _CryptoTrustStoreError.malformedSnapshot = error else {
+                    return XCTFail("Unexpected error \(error)")
+                }
+            }
+        }
+        // Structural checks apply even without the digest.
+        XCTAssertThrowsError(try _X509TrustStore(snapshot: snapshot.dropLast(), verifyingIntegrity: false))
+        var outOfBounds = snapshot
+        outOfBounds[32 + 23] = 0xff
+        XCTAssertThrowsError(try _X509TrustStore(snapshot: outOfBounds, verifyingIntegrity: false))
+        XCTAssertThrowsError(try _X509TrustStore(snapshot: Data()))
+    }
+}
@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class VerificationResultCacheTests: XCTestCase {
+    func testSuccessfulVerificationIsCached() throws {
+        let cache = _VerificationResultCache(budget: nil)
+        let key = Curve25519.Signing.PrivateKey()
+        let message = Data("hello".utf8)
+        let signature = try key.signature(for: message)
+
+        XCTAssertTrue(cache.isValidSignature(signature, for: message, publicKey: key.publicKey))
+        XCTAssertTrue(cache.isValidSignature(signature, for: message, publicKey: key.publicKey))
+        let statistics = cache.statistics
+        XCTAssertEqual(statistics.resultCount, 1)
+        XCTAssertEqual(statistics.hits, 1)
+        XCTAssertEqual(statistics.misses, 1)
+    }
+
+    func testFailedVerificationIsNotCached() throws {
+        let cache = _VerificationResultCache(budget: nil)
+        let key = P256.Signing.PrivateKey()
+        let otherKey = P256.Signing.PrivateKey()
+        let message = Data("hello".utf8)
+        let signature = try key.signature(for: message)
+
+        for _ in 0..<2 {
+            XCTAssertFalse(cache.isValidSignature(signature, for: message, publicKey: otherKey.publicKey))
+        }
+        XCTAssertEqual(cache.statistics.resultCount, 0)
+        XCTAssertEqual(cache.statistics.hits, 0)
+    }
+
+    func testChangedPartsMiss() throws {
+        let cache = _VerificationResultCache(budget: nil)
+        let key = P384.Signing.PrivateKey()
+        let message = Data("hello".utf8)
+        let signature = try key.signature(for: message)
+        XCTAssertTrue(cache.isValidSignature(signature, for: message, publicKey: key.publicKey))
+
+        XCTAssertFalse(cache.isValidSignature(signature, for: Data("hellp".utf8), publicKey: key.publicKey))
+        XCTAssertFalse(cache.isValidSignature(signature, for: message, publicKey: P384.Signing.PrivateKey().publicKey))
+        var tampered = signature.rawRepresentation
+        tampered[0] ^= 1
+        XCTAssertFalse(
+            cache.isValidSignature(try P384.Signing.ECDSASignature(rawRepresentation: tampered), for: message, publicKey: key.publicKey)
+        )
+        let otherSignature = try key.signature(for: message)
+        XCTAssertTrue(cache.isValidSignature(otherSignature, for: message, publicKey: key.publicKey))
+        XCTAssertEqual(cache.statistics.hits, 0)
+        XCTAssertEqual(cache.statistics.resultCount, 2)
+    }
+
+    func testRSAPaddingsAreCachedSeparately() throws {
+        let cache = _VerificationResultCache(budget: nil)
+        let key = try _RSA.Signing.PrivateKey(keySize: .bits2048)
+        let message = Data("hello".utf8)
+        let signature = try key.signature(for: message, padding: .insecurePKCS1v1_5)
+
+        XCTAssertTrue(cache.isValidSignature(signature, for: message, padding: .insecurePKCS1v1_5, publicKey: key.publicKey))
+        XCTAssertFalse(cache.isValidSignature(signature, for: message, padding: .PSS, publicKey: key.publicKey))
+        XCTAssertTrue(cache.isValidSignature(signature, for: message, padding: .insecurePKCS1v1_5, publicKey: key.publicKey))
+        XCTAssertEqual(cache.statistics.hits, 1)
+    }
+
+    func testResultsExpire() throws {
+        let cache = _VerificationResultCache(timeToLive: 0.01, budget: nil)
+        let key = P521.Signing.PrivateKey()
+        let digest = SHA512.hash(data: Data("hello".utf8))
+        let signature = try key.signature(for: digest)
+
+        XCTAssertTrue(cache.isValidSignature(signature, for: digest, publicKey: key.publicKey))
+        Thread.sleep(forTimeInterval: 0.05)
+        XCTAssertTrue(cache.isValidSignature(signature, for: digest, publicKey: key.publicKey))
+        let statistics = cache.statistics
+        XCTAssertEqual(statistics.hits, 0)
+        XCTAssertEqual(statistics.misses, 2)
+        XCTAssertEqual(statistics.resultCount, 1)
+    }
+
+    func testLeastRecentlyUsedResultIsEvicted() throws {
+        let cache = _VerificationResultCache(capacity: 2, timeToLive: nil, shards: 1, budget: nil)
+        let key = Curve25519.Signing.PrivateKey()
+        let messages = (0..<3).map { Data([UInt8($0)]) }
+        let signatures = try messages.map { try key.signature(for: $0) }
+
+        for (message, signature) in zip(messages, signatures) {
+            XCTAssertTrue(cache.isValidSignature(signature, for: message, publicKey: key.publicKey))
+        }
+        XCTAssertEqual(cache.statistics.evictions, 1)
+        XCTAssertTrue(cache.isValidSignature(signatures[2], for: messages[2], publicKey: key.publicKey))
+        XCTAssertEqual(cache.statistics.hits, 1)
+
+        cache.removeAll()
+        XCTAssertEqual(cache.statistics.resultCount, 0)
+    }
+}
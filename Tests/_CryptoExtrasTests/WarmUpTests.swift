@@ -0,0 +1,40 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class WarmUpTests: XCTestCase {
+    func testWarmUpRunsEveryAlgorithm() {
+        let report = _CryptoWarmUp.warmUp(threads: 4)
+        XCTAssertGreaterThanOrEqual(report.threadCount, 1)
+        XCTAssertLessThanOrEqual(report.threadCount, 5)
+        XCTAssertGreaterThan(report.duration, 0)
+    }
+
+    func testWarmUpWithoutWorkerThreads() {
+        let report = _CryptoWarmUp.warmUp(algorithms: [], threads: 0)
+        XCTAssertEqual(report.threadCount, 1)
+    }
+
+    func testWarmUpIsRepeatable() throws {
+        _CryptoWarmUp.warmUp(algorithms: [.sha2, .p256], threads: 2)
+        _CryptoWarmUp.warmUp(algorithms: [.sha2, .p256], threads: 2)
+
+        let key = P256.Signing.PrivateKey()
+        let signature = try key.signature(for: Data("hello".utf8))
+        XCTAssertTrue(key.publicKey.isValidSignature(signature, for: Data("hello".utf8)))
+    }
+}
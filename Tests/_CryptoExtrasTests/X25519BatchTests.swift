@@ -0,0 +1,55 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class X25519BatchTests: XCTestCase {
+    func testBatchMatchesSingleKeyAgreement() throws {
+        let privateKey = Curve25519.KeyAgreement.PrivateKey()
+        let peers = (0..<17).map { _ in Curve25519.KeyAgreement.PrivateKey().publicKey }
+
+        let secrets = privateKey._sharedSecrets(with: peers)
+        XCTAssertEqual(secrets.count, peers.count)
+        for (peer, secret) in zip(peers, secrets) {
+            let expected = try privateKey.sharedSecretFromKeyAgreement(with: peer).withUnsafeBytes { Data($0) }
+            XCTAssertEqual(secret.withUnsafeBytes { Data($0) }, expected)
+        }
+    }
+
+    func testBatchHandlesLowOrderPeersAcrossChunks() throws {
+        let privateKey = Curve25519.KeyAgreement.PrivateKey()
+        let lowOrder = try Curve25519.KeyAgreement.PublicKey(rawRepresentation: Data(repeating: 0, count: 32))
+        var peers = (0..<70).map { _ in Curve25519.KeyAgreement.PrivateKey().publicKey }
+        peers[3] = lowOrder
+        peers[40] = lowOrder
+
+        let secrets = privateKey._sharedSecrets(with: peers)
+        XCTAssertEqual(secrets.count, peers.count)
+        for (index, (peer, secret)) in zip(peers, secrets).enumerated() {
+            if index == 3 || index == 40 {
+                XCTAssertEqual(secret.withUnsafeBytes { Data($0) }, Data(repeating: 0, count: 32))
+            } else {
+                let expected = try privateKey.sharedSecretFromKeyAgreement(with: peer).withUnsafeBytes { Data($0) }
+                XCTAssertEqual(secret.withUnsafeBytes { Data($0) }, expected)
+            }
+        }
+    }
+
+    func testEmptyBatch() {
+        XCTAssertTrue(Curve25519.KeyAgreement.PrivateKey()._sharedSecrets(with: []).isEmpty)
+    }
+}
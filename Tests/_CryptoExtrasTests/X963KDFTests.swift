@@ -0,0 +1,57 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the SwiftCrypto open source project
+//
+// Copyright (c) 2024 Apple Inc. and the SwiftCrypto project authors
+// Licensed under Apache License v2.0
+//
+// See LICENSE.txt for license information
+// See CONTRIBUTORS.md for the list of SwiftCrypto project authors
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+import Crypto
+import Foundation
+@testable import _CryptoExtras
+import XCTest
+
+final class X963KDFTests: XCTestCase {
+    func checkMatchesOneShot<H: HashFunction>(_: H.Type, sharedSecret: SharedSecret, file: StaticString = #filePath, line: UInt = #line) throws {
+        let sharedInfo = Array("ECIES shared info".utf8)
+        // Short, whole-block and partial-block outputs.
+        for outputByteCount in [0, 1, 16, H.Digest.byteCount, H.Digest.byteCount + 1, 3 * H.Digest.byteCount - 5] {
+            var derived = [UInt8](repeating: 0, count: outputByteCount)
+            try derived.withUnsafeMutableBytes {
+                try sharedSecret._x963DeriveKey(using: H.self, sharedInfo: sharedInfo, into: $0)
+            }
+            let expected = sharedSecret.x963DerivedSymmetricKey(using: H.self, sharedInfo: sharedInfo, outputByteCount: outputByteCount)
+            XCTAssertEqual(derived, expected.withUnsafeBytes { Array($0) }, "\(H.self), \(outputByteCount) bytes", file: file, line: line)
+        }
+    }
+
+    func testMatchesOneShot() throws {
+        // The P-521 secret is longer than a SHA-256 block, so the precomputed state covers a whole compression.
+        let secrets = [
+            try P256.KeyAgreement.PrivateKey().sharedSecretFromKeyAgreement(with: P256.KeyAgreement.PrivateKey().publicKey),
+            try P521.KeyAgreement.PrivateKey().sharedSecretFromKeyAgreement(with: P521.KeyAgreement.PrivateKey().publicKey),
+        ]
+        for secret in secrets {
+            try self.checkMatchesOneShot(SHA256.self, sharedSecret: secret)
+            try self.checkMatchesOneShot(SHA384.self, sharedSecret: secret)
+            try self.checkMatchesOneShot(SHA512.self, sharedSecret: secret)
+            try self.checkMatchesOneShot(Insecure.SHA1.self, sharedSecret: secret)
+        }
+    }
+
+    func testEmptySharedInfo() throws {
+        let secret = try P384.KeyAgreement.PrivateKey().sharedSecretFromKeyAgreement(with: P384.KeyAgreement.PrivateKey().publicKey)
+        var derived = [UInt8](repeating: 0, count: 48)
+        try derived.withUnsafeMutableBytes {
+            try secret._x963DeriveKey(using: SHA384.self, sharedInfo: [UInt8](), into: $0)
+        }
+        let expected = secret.x963DerivedSymmetricKey(using: SHA384.self, sharedInfo: [UInt8](), outputByteCount: 48)
+        XCTAssertEqual(derived, expected.withUnsafeBytes { Array($0) })
+    }
+}